@@ -51,6 +51,19 @@
 #define SP_UNLOCKED 0  /* The Un-locked state */
 #define SP_LOCKED   1  /* The Locked state */
 
+/* Memory barriers and event hints used by the spinlock logic (see
+ * include/nuttx/spinlock.h).  On ARMv7-A, a CPU waiting for a lock sleeps
+ * in WFE until the holder releases the lock and executes SEV.
+ */
+
+#if defined(CONFIG_ARCH_CORTEXA5) || defined(CONFIG_ARCH_CORTEXA8) || \
+    defined(CONFIG_ARCH_CORTEXA9)
+#  define SP_DMB()  __asm__ __volatile__ ("dmb" : : : "memory")
+#  define SP_DSB()  __asm__ __volatile__ ("dsb" : : : "memory")
+#  define SP_WFE()  __asm__ __volatile__ ("wfe" : : : "memory")
+#  define SP_SEV()  __asm__ __volatile__ ("sev" : : : "memory")
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -106,6 +106,10 @@
 
 #  define PTE_NPAGES            PTE_TINY_NPAGES
 
+   /* The type of the L2 descriptor for each page */
+
+#  define PG_L2_TYPE            PTE_TYPE_TINY
+
    /* Mask to get the page table physical address from an L1 entry */
 
 #  define PG_L1_PADDRMASK       PMD_FINE_TEX_MASK
@@ -134,6 +138,10 @@
 
 #  define PTE_NPAGES            PTE_SMALL_NPAGES
 
+   /* The type of the L2 descriptor for each page */
+
+#  define PG_L2_TYPE            PTE_TYPE_SMALL
+
    /* Mask to get the page table physical address from an L1 entry */
 
 #  define PG_L1_PADDRMASK       PMD_COARSE_TEX_MASK
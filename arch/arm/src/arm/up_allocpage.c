@@ -82,17 +82,23 @@ typedef uint32_t L1ndx_t;
  * Private Data
  ****************************************************************************/
 
-/* Free pages in memory are managed by indices ranging from up to
- * CONFIG_PAGING_NPAGED.  Initially all pages are free so the page can be
- * simply allocated in order: 0, 1, 2, ... .  After all CONFIG_PAGING_NPAGED
- * pages have be filled, then they are blindly freed and re-used in the
- * same order 0, 1, 2, ... because we don't know any better.  No smart "least
- * recently used" kind of logic is supported.
+/* Pages in memory are managed by indices ranging from up to
+ * CONFIG_PAGING_NPPAGED.  Initially all pages are free so the page can be
+ * simply allocated in order: 0, 1, 2, ... .  After all CONFIG_PAGING_NPPAGED
+ * pages have be filled, a page to be re-used is selected with the "clock"
+ * (second chance) algorithm:  g_pgndx is the clock hand.  The MMU does not
+ * provide a referenced bit so references are detected in software:  If the
+ * hand finds that the page is mapped, the page has been referenced since
+ * the hand last passed.  The page is spared, but its L2 entry is turned into
+ * a fault entry (keeping the rest of the descriptor).  The next reference
+ * to the page will then fault and up_checkmapping() will restore the
+ * mapping without a page fill.  A page that is still unmapped when the hand
+ * returns has not been referenced and is re-used.
  */
 
 static pgndx_t g_pgndx;
 
-/* After CONFIG_PAGING_NPAGED have been allocated, the pages will be re-used.
+/* After CONFIG_PAGING_NPPAGED have been allocated, the pages will be re-used.
  * In order to re-used the page, we will have un-map the page from its previous
  * mapping.  In order to that, we need to be able to map a physical address to
  * to an index into the PTE where it was mapped.  The following table supports
@@ -112,6 +118,130 @@ static bool g_pgwrap;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: up_pgvictim
+ *
+ * Description:
+ *  Select the physical page to be used for the next mapping with the clock
+ *  algorithm and, if it was in use, un-map it.
+ *
+ * Returned Value:
+ *   The index of the selected page.
+ *
+ ****************************************************************************/
+
+static unsigned int up_pgvictim(void)
+{
+  uintptr_t oldvaddr;
+  uint32_t *pte;
+  unsigned int pgndx;
+  bool inuse;
+
+  for (; ; )
+    {
+      /* Advance the clock hand */
+
+      pgndx = g_pgndx;
+      inuse = g_pgwrap;
+
+      if (++g_pgndx >= CONFIG_PAGING_NPPAGED)
+        {
+          g_pgndx  = 0;
+          g_pgwrap = true;
+        }
+
+      /* Pages are not in use until the hand has wrapped once */
+
+      if (!inuse)
+        {
+          return pgndx;
+        }
+
+      /* Get a pointer to the L2 entry corresponding to the current mapping
+       * of the page.
+       */
+
+      oldvaddr = PG_POOL_NDX2VA(g_ptemap[pgndx]);
+      pte      = up_va2pte(oldvaddr);
+
+      if ((*pte & PTE_TYPE_MASK) != PTE_TYPE_FAULT)
+        {
+          /* The page has been referenced since the hand last passed (or was
+           * just filled).  Give it a second chance, but remove the mapping
+           * so that the next reference will be noticed.
+           */
+
+          *pte &= ~PTE_TYPE_MASK;
+        }
+      else
+        {
+          /* The page has not been referenced.  Re-use it. */
+
+          *pte = 0;
+        }
+
+      /* Invalidate the TLBs corresponding to the virtual address.  The page
+       * may contain read-only data as well as instructions.
+       */
+
+      tlb_inst_invalidate_single(oldvaddr);
+      tlb_data_invalidate_single(oldvaddr);
+
+      /* I do not believe that it is necessary to flush the I-Cache in this
+       * case:  The I-Cache uses a virtual address index and, hence, since the
+       * NuttX address space is flat, the cached instruction value should be
+       * correct even if the page mapping is no longer in place.
+       */
+
+      if (*pte == 0)
+        {
+          return pgndx;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: up_mappage
+ *
+ * Description:
+ *  Set aside a page in memory and map it to the virtual address. See
+ *  up_allocpage().
+ *
+ ****************************************************************************/
+
+static void up_mappage(uintptr_t vaddr, FAR void **vpage)
+{
+  uintptr_t paddr;
+  uint32_t *pte;
+  unsigned int pgndx;
+
+  /* Allocate page memory to back up the mapping.  Start by getting the
+   * index of the next page that we are going to allocate (un-mapping it
+   * if it was in use).  Then convert the index to a (physical) page
+   * address.
+   */
+
+  pgndx = up_pgvictim();
+  paddr = PG_POOL_PGPADDR(pgndx);
+
+  /* Now setup up the new mapping.  Get a pointer to the L2 entry
+   * corresponding to the new mapping.  Then set it map to the newly
+   * allocated page address.  The inital mapping is read/write but
+   * non-cached (MMU_L2_ALLOCFLAGS)
+   */
+
+  pte = up_va2pte(vaddr);
+  *pte = (paddr | MMU_L2_ALLOCFLAGS);
+
+  /* And save the new L1 index */
+
+  g_ptemap[pgndx] = PG_POOL_VA2L2NDX(vaddr);
+
+  /* Finally, return the virtual address of allocated page */
+
+  *vpage = (void *)(vaddr & ~PAGEMASK);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -168,9 +298,6 @@ static bool g_pgwrap;
 int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
 {
   uintptr_t vaddr;
-  uintptr_t paddr;
-  uint32_t *pte;
-  unsigned int pgndx;
 
   /* Since interrupts are disabled, we don't need to anything special. */
 
@@ -181,63 +308,41 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage)
   vaddr = tcb->xcp.far;
   DEBUGASSERT(vaddr >= PG_PAGED_VBASE && vaddr < PG_PAGED_VEND);
 
-  /* Allocate page memory to back up the mapping.  Start by getting the
-   * index of the next page that we are going to allocate.
-   */
-
-  pgndx = g_pgndx++;
-  if (g_pgndx >= CONFIG_PAGING)
-    {
-      g_pgndx  = 0;
-      g_pgwrap = true;
-    }
-
-  /* Was this physical page previously mapped? If so, then we need to un-map
-   * it.
-   */
+  /* Allocate a page and map it to the fault address */
 
-  if (g_pgwrap)
-    {
-      /* Yes.. Get a pointer to the L2 entry corresponding to the previous
-       * mapping -- then zero it!
-       */
-
-       uintptr_t oldvaddr = PG_POOL_NDX2VA(g_ptemap[pgndx]);
-       pte = up_va2pte(oldvaddr);
-      *pte = 0;
+  up_mappage(vaddr, vpage);
+  return OK;
+}
 
-      /* Invalidate the instruction TLB corresponding to the virtual address */
+/****************************************************************************
+ * Name: up_prefetchpage()
+ *
+ * Description:
+ *  Set aside a page in memory and map it to the virtual address, vaddr, so
+ *  that it can be prefetched.  See include/nuttx/page.h.
+ *
+ ****************************************************************************/
 
-      tlb_inst_invalidate_single(oldvaddr);
+#ifdef CONFIG_PAGING_PREFETCH
+int up_prefetchpage(uintptr_t vaddr, FAR void **vpage)
+{
+  DEBUGASSERT(vpage);
 
-      /* I do not believe that it is necessary to flush the I-Cache in this
-       * case:  The I-Cache uses a virtual address index and, hence, since the
-       * NuttX address space is flat, the cached instruction value should be
-       * correct even if the page mapping is no longer in place.
-       */
+  if (vaddr < PG_PAGED_VBASE || vaddr >= PG_PAGED_VEND)
+    {
+      return -ERANGE;
     }
 
-  /* Then convert the index to a (physical) page address. */
-
-  paddr = PG_POOL_PGPADDR(pgndx);
+  /* Nothing to do if the page is already in memory (mapped or not) */
 
-  /* Now setup up the new mapping.  Get a pointer to the L2 entry
-   * corresponding to the new mapping.  Then set it map to the newly
-   * allocated page address.  The inital mapping is read/write but
-   * non-cached (MMU_L2_ALLOCFLAGS)
-   */
-
-  pte = up_va2pte(vaddr);
-  *pte = (paddr | MMU_L2_ALLOCFLAGS);
-
-  /* And save the new L1 index */
-
-  g_ptemap[pgndx] = PG_POOL_VA2L2NDX(vaddr);
-
-  /* Finally, return the virtual address of allocated page */
+  if (*up_va2pte(vaddr) != 0)
+    {
+      return -EEXIST;
+    }
 
-  *vpage = (void *)(vaddr & ~PAGEMASK);
+  up_mappage(vaddr, vpage);
   return OK;
 }
+#endif
 
 #endif /* CONFIG_PAGING */
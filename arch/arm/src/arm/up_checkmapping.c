@@ -47,6 +47,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/page.h>
 
+#include "pg_macros.h"
 #include "up_internal.h"
 
 #ifdef CONFIG_PAGING
@@ -76,6 +77,10 @@
  *  may occur on several threads and be queued multiple times. This function
  *  will prevent the same page from be filled multiple times.
  *
+ *  If the page is still in memory, but its mapping was removed by the page
+ *  replacement logic in up_allocpage(), the mapping is restored and true is
+ *  returned.
+ *
  * Input Parameters:
  *   tcb - A reference to the task control block of the task that we believe
  *         needs to have a page fill.  Architecture-specific logic can
@@ -90,10 +95,10 @@
  *   interpreted as fatal.
  *
  * Assumptions:
- *   - This function is called from the normal tasking context (but with
- *     interrupts disabled).  The implementation must take whatever actions
- *     are necessary to assure that the operation is safe within this
- *     context.
+ *   - This function is called with interrupts disabled, either from the
+ *     exception handler or from the normal tasking context.  The
+ *     implementation must take whatever actions are necessary to assure
+ *     that the operation is safe within these contexts.
  *
  ****************************************************************************/
 
@@ -117,7 +122,24 @@ bool up_checkmapping(FAR struct tcb_s *tcb)
 
   /* Return true if this virtual address is mapped. */
 
-  return (*pte != 0);
+  if ((*pte & PTE_TYPE_MASK) != PTE_TYPE_FAULT)
+    {
+      return true;
+    }
+
+  /* A fault entry that is not zero describes a page that is still in
+   * memory but whose mapping was removed by up_allocpage() in order to
+   * detect the next reference to it.  Just restore the mapping.  The MMU
+   * does not hold fault entries in the TLBs.
+   */
+
+  if (*pte != 0)
+    {
+      *pte |= PG_L2_TYPE;
+      return true;
+    }
+
+  return false;
 }
 
 #endif /* CONFIG_PAGING */
@@ -42,6 +42,7 @@
 #include <stdint.h>
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/sched.h>
 #include <assert.h>
 
 #include <nuttx/board.h>
@@ -76,6 +77,14 @@ uint32_t *arm_doirq(int irq, uint32_t *regs)
 
   irq_dispatch(irq, regs);
 
+#ifdef CONFIG_SMP_RESCHED_IPI
+  /* Perform any rescheduling requested by another CPU.  This may cause an
+   * interrupt level context switch, which is handled below.
+   */
+
+  sched_resched_process();
+#endif
+
 #if defined(CONFIG_ARCH_FPU) || defined(CONFIG_ARCH_ADDRENV)
   /* Check for a context switch.  If a context switch occurred, then
    * CURRENT_REGS will have a different value than it did on entry.  If an
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * arch/arm/src/armv7-a/arm_perf.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <arch/board/board.h>
+
+#include "up_internal.h"
+
+#ifdef CONFIG_ARMV7A_PERF_EVENTS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* PMCCNTR counts at the core clock frequency (the divide-by-64 option in
+ * the PMCR is left disabled).
+ */
+
+#if CONFIG_ARMV7A_PERF_FREQUENCY > 0
+#  define PERF_FREQUENCY CONFIG_ARMV7A_PERF_FREQUENCY
+#elif defined(BOARD_CPU_FREQUENCY)
+#  define PERF_FREQUENCY BOARD_CPU_FREQUENCY
+#else
+#  error CONFIG_ARMV7A_PERF_FREQUENCY must be provided
+#endif
+
+/* PMCR bits */
+
+#define PMCR_E              (1 << 0)  /* Bit 0: Enable all counters */
+#define PMCR_C              (1 << 2)  /* Bit 2: Cycle counter reset */
+#define PMCR_D              (1 << 3)  /* Bit 3: Cycle counter clock divider */
+
+/* PMCNTENSET bits */
+
+#define PMCNTENSET_C        (1 << 31) /* Bit 31: Cycle counter enable */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_perf_init
+ *
+ * Description:
+ *   Enable the PMU cycle counter of the calling CPU.  Each CPU has its own
+ *   PMU, so in an SMP configuration this must be called on every CPU.  The
+ *   counters of different CPUs are not synchronized.
+ *
+ ****************************************************************************/
+
+void up_perf_init(void)
+{
+  uint32_t pmcr;
+
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c12, 0\n" : "=r" (pmcr));
+  pmcr = (pmcr & ~PMCR_D) | PMCR_E | PMCR_C;
+  __asm__ __volatile__ ("\tmcr p15, 0, %0, c9, c12, 0\n" : : "r" (pmcr));
+  __asm__ __volatile__ ("\tmcr p15, 0, %0, c9, c12, 1\n"
+                        : : "r" (PMCNTENSET_C));
+}
+
+/****************************************************************************
+ * Name: up_perf_gettime
+ ****************************************************************************/
+
+uint32_t up_perf_gettime(void)
+{
+  uint32_t count;
+
+  __asm__ __volatile__ ("\tmrc p15, 0, %0, c9, c13, 0\n" : "=r" (count));
+  return count;
+}
+
+/****************************************************************************
+ * Name: up_perf_getfreq
+ ****************************************************************************/
+
+uint32_t up_perf_getfreq(void)
+{
+  return PERF_FREQUENCY;
+}
+
+#endif /* CONFIG_ARMV7A_PERF_EVENTS */
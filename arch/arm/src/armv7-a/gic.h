@@ -786,6 +786,26 @@ int arm_start_handler(int irq, FAR void *context);
 int arm_pause_handler(int irq, FAR void *context);
 #endif
 
+/****************************************************************************
+ * Name: arm_resched_handler
+ *
+ * Description:
+ *   This is the handler for SGI3.  It does nothing:  The need-resched flag
+ *   set by the CPU that sent the SGI is acted upon when arm_doirq() returns
+ *   from the interrupt.
+ *
+ * Input Parameters:
+ *   Standard interrupt handling
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SMP_RESCHED_IPI)
+int arm_resched_handler(int irq, FAR void *context);
+#endif
+
 /****************************************************************************
  * Name: arm_gic_dump
  *
@@ -0,0 +1,106 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/up_perf.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <arch/board/board.h>
+
+#include "up_arch.h"
+#include "up_internal.h"
+#include "nvic.h"
+#include "dwt.h"
+
+#ifdef CONFIG_ARMV7M_PERF_EVENTS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CYCCNT counts at the core clock frequency */
+
+#if CONFIG_ARMV7M_PERF_FREQUENCY > 0
+#  define PERF_FREQUENCY CONFIG_ARMV7M_PERF_FREQUENCY
+#elif defined(BOARD_CPU_FREQUENCY)
+#  define PERF_FREQUENCY BOARD_CPU_FREQUENCY
+#else
+#  error CONFIG_ARMV7M_PERF_FREQUENCY must be provided
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_perf_init
+ *
+ * Description:
+ *   Enable the DWT cycle counter.  The trace and debug blocks must be
+ *   enabled in the DEMCR before the DWT registers can be accessed.
+ *
+ ****************************************************************************/
+
+void up_perf_init(void)
+{
+  modifyreg32(NVIC_DEMCR, 0, NVIC_DEMCR_TRCENA);
+  putreg32(0, DWT_CYCCNT);
+  modifyreg32(DWT_CTRL, 0, DWT_CTRL_CYCCNTENA_Msk);
+}
+
+/****************************************************************************
+ * Name: up_perf_gettime
+ ****************************************************************************/
+
+uint32_t up_perf_gettime(void)
+{
+  return getreg32(DWT_CYCCNT);
+}
+
+/****************************************************************************
+ * Name: up_perf_getfreq
+ ****************************************************************************/
+
+uint32_t up_perf_getfreq(void)
+{
+  return PERF_FREQUENCY;
+}
+
+#endif /* CONFIG_ARMV7M_PERF_EVENTS */
@@ -92,7 +92,8 @@ static void _up_dumponexit(FAR struct tcb_s *tcb, FAR void *arg)
   filelist = tcb->group->tg_filelist;
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      struct inode *inode = filelist->fl_files[i].f_inode;
+      FAR struct file *filep = files_getfile(filelist, i);
+      struct inode *inode = filep ? filep->f_inode : NULL;
       if (inode)
         {
           sinfo("      fd=%d refcount=%d\n",
@@ -163,6 +164,10 @@ void _exit(int status)
 
   tcb = this_task();
 
+  /* Prepare the scheduler (and the thread pointer) for the new task */
+
+  sched_resume_scheduler(tcb);
+
 #ifdef CONFIG_ARCH_ADDRENV
   /* Make sure that the address environment for the previously running
    * task is closed down gracefully (data caches dump, MMU flushed) and
@@ -144,6 +144,10 @@ void up_initialize(void)
 
   CURRENT_REGS = NULL;
 
+  /* Start the cycle counter used by up_perf_gettime() */
+
+  up_perf_init();
+
   /* Calibrate the timing loop */
 
   up_calibratedelay();
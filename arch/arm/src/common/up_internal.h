@@ -362,6 +362,14 @@ void up_systemreset(void) noreturn_function;
 
 void up_irqinitialize(void);
 
+/* Cycle counter ************************************************************/
+
+#if defined(CONFIG_ARMV7M_PERF_EVENTS) || defined(CONFIG_ARMV7A_PERF_EVENTS)
+void up_perf_init(void);
+#else
+#  define up_perf_init()
+#endif
+
 /* Exception handling logic unique to the Cortex-M family */
 
 #if defined(CONFIG_ARCH_CORTEXM0) || defined(CONFIG_ARCH_CORTEXM3) || \
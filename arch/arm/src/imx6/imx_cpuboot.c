@@ -270,6 +270,10 @@ void arm_cpu_boot(int cpu)
 
   arm_gic_initialize();
 
+  /* Start the cycle counter of CPUn */
+
+  up_perf_init();
+
 #ifdef CONFIG_ARCH_LOWVECTORS
   /* If CONFIG_ARCH_LOWVECTORS is defined, then the vectors located at the
    * beginning of the .text region must appear at address at the address
@@ -962,6 +962,11 @@ static void can_interrupt(FAR struct can_dev_s *dev)
       hdr.ch_id     = rid;
       hdr.ch_rtr    = ((rfs & CAN_RFS_RTR) != 0);
       hdr.ch_dlc    = (rfs & CAN_RFS_DLC_MASK) >> CAN_RFS_DLC_SHIFT;
+#ifdef CONFIG_CAN_FD
+      hdr.ch_edl    = 0;
+      hdr.ch_brs    = 0;
+      hdr.ch_esi    = 0;
+#endif
 #ifdef CONFIG_CAN_ERRORS
       hdr.ch_error  = 0; /* Error reporting not supported */
 #endif
@@ -1321,6 +1321,11 @@ static inline void can_rxinterrupt(FAR struct can_dev_s *dev, int mbndx,
   hdr.ch_error  = 0; /* Error reporting not supported */
 #endif
   hdr.ch_unused = 0;
+#ifdef CONFIG_CAN_FD
+  hdr.ch_edl    = 0;
+  hdr.ch_brs    = 0;
+  hdr.ch_esi    = 0;
+#endif
 
   /* And provide the CAN message to the upper half logic */
 
@@ -946,6 +946,8 @@ static int mcan_del_extfilter(FAR struct sam_mcan_s *priv, int ndx);
 static int mcan_add_stdfilter(FAR struct sam_mcan_s *priv,
               FAR struct canioc_stdfilter_s *stdconfig);
 static int mcan_del_stdfilter(FAR struct sam_mcan_s *priv, int ndx);
+static int mcan_set_filters(FAR struct sam_mcan_s *priv,
+              FAR const struct canioc_filters_s *filters);
 
 /* CAN driver methods */
 
@@ -2200,6 +2202,108 @@ static int mcan_del_stdfilter(FAR struct sam_mcan_s *priv, int ndx)
   return OK;
 }
 
+/****************************************************************************
+ * Name: mcan_set_filters
+ *
+ * Description:
+ *   Replace all standard and extended address filters with a new bank of
+ *   filters.  The filters are assigned to the hardware filter elements in
+ *   order, so the filter IDs of the new filters are 0, 1, 2, ...
+ *
+ * Input Parameters:
+ *   priv    - An instance of the MCAN driver state structure.
+ *   filters - The new bank of filters
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int mcan_set_filters(FAR struct sam_mcan_s *priv,
+                            FAR const struct canioc_filters_s *filters)
+{
+  FAR const struct sam_config_s *config;
+  int ndx;
+  int ret;
+
+  DEBUGASSERT(priv != NULL && priv->config != NULL && filters != NULL);
+  config = priv->config;
+
+  /* Make sure that the hardware can hold the whole bank before removing
+   * the current filters.
+   */
+
+  if (filters->fl_nstd > config->nstdfilters)
+    {
+      return -ENOSPC;
+    }
+
+  if (filters->fl_nstd > 0 && filters->fl_std == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_CAN_EXTID
+  if (filters->fl_next > config->nextfilters)
+    {
+      return -ENOSPC;
+    }
+
+  if (filters->fl_next > 0 && filters->fl_ext == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Remove all of the current extended filters */
+
+  for (ndx = 0; ndx < config->nextfilters && priv->nextalloc > 0; ndx++)
+    {
+      if ((priv->extfilters[ndx >> 5] & (1 << (ndx & 0x1f))) != 0)
+        {
+          (void)mcan_del_extfilter(priv, ndx);
+        }
+    }
+#endif
+
+  /* Remove all of the current standard filters */
+
+  for (ndx = 0; ndx < config->nstdfilters && priv->nstdalloc > 0; ndx++)
+    {
+      if ((priv->stdfilters[ndx >> 5] & (1 << (ndx & 0x1f))) != 0)
+        {
+          (void)mcan_del_stdfilter(priv, ndx);
+        }
+    }
+
+  /* Then add the new filters.  All messages are accepted until the first
+   * filter of each kind has been added.
+   */
+
+  for (ndx = 0; ndx < filters->fl_nstd; ndx++)
+    {
+      ret = mcan_add_stdfilter(priv, (FAR struct canioc_stdfilter_s *)
+                                     &filters->fl_std[ndx]);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+#ifdef CONFIG_CAN_EXTID
+  for (ndx = 0; ndx < filters->fl_next; ndx++)
+    {
+      ret = mcan_add_extfilter(priv, (FAR struct canioc_extfilter_s *)
+                                     &filters->fl_ext[ndx]);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: mcan_reset
  *
@@ -2684,6 +2788,49 @@ static int mcan_ioctl(FAR struct can_dev_s *dev, int cmd, unsigned long arg)
         }
         break;
 
+      /* CANIOC_SET_FILTERS:
+       *   Description:    Replace all of the address filters with a new
+       *                   bank of standard and extended filters.
+       *   Argument:       A reference to struct canioc_filters_s
+       *   Returned Value: Zero (OK) is returned on success.  Otherwise -1
+       *                   (ERROR) is returned with the errno variable set
+       *                   to indicate the nature of the error.
+       */
+
+      case CANIOC_SET_FILTERS:
+        {
+          DEBUGASSERT(arg != 0);
+          ret = mcan_set_filters(priv,
+                                 (FAR const struct canioc_filters_s *)arg);
+        }
+        break;
+
+      /* CANIOC_GET_FILTERINFO:
+       *   Description:    Return the number of hardware address filters
+       *                   and the number that are currently unused.
+       *   Argument:       A reference to struct canioc_filterinfo_s
+       *   Returned Value: Zero (OK) is returned on success.
+       */
+
+      case CANIOC_GET_FILTERINFO:
+        {
+          FAR struct canioc_filterinfo_s *info =
+            (FAR struct canioc_filterinfo_s *)arg;
+
+          DEBUGASSERT(info != NULL);
+          info->fi_nstd     = priv->config->nstdfilters;
+          info->fi_nstdfree = priv->config->nstdfilters - priv->nstdalloc;
+#ifdef CONFIG_CAN_EXTID
+          info->fi_next     = priv->config->nextfilters;
+          info->fi_nextfree = priv->config->nextfilters - priv->nextalloc;
+#else
+          info->fi_next     = 0;
+          info->fi_nextfree = 0;
+#endif
+          ret = OK;
+        }
+        break;
+
       /* Unsupported/unrecognized command */
 
       default:
@@ -2833,18 +2980,39 @@ static int mcan_send(FAR struct can_dev_s *dev, FAR struct can_msg_s *msg)
 
   /* Format word T1:
    *   Data Length Code (DLC)            - Value from message structure
+   *   Extended Data Length (EDL)        - Value from message structure
+   *   Bit Rate Switch (BRS)             - Value from message structure
    *   Event FIFO Control (EFC)          - Do not store events.
    *   Message Marker (MM)               - Always zero
    */
 
-  txbuffer[1] = BUFFER_R1_DLC(msg->cm_hdr.ch_dlc);
+  regval = BUFFER_R1_DLC(msg->cm_hdr.ch_dlc);
+  nbytes = mcan_dlc2bytes(priv, msg->cm_hdr.ch_dlc);
+
+#ifdef CONFIG_CAN_FD
+  if (msg->cm_hdr.ch_edl && priv->config->mode != MCAN_ISO11898_1_MODE)
+    {
+      regval |= BUFFER_R1_EDL;
+      if (msg->cm_hdr.ch_brs)
+        {
+          regval |= BUFFER_R1_BRS;
+        }
+    }
+  else if (nbytes > 8)
+    {
+      /* DLC values greater than 8 are encoded only in CAN FD messages */
+
+      nbytes = 8;
+    }
+#endif
+
+  txbuffer[1] = regval;
   reginfo("T1: %08x\n", txbuffer[1]);
 
   /* Followed by the amount of data corresponding to the DLC (T2..) */
 
   dest   = (FAR uint8_t *)&txbuffer[2];
   src    = msg->cm_data;
-  nbytes = mcan_dlc2bytes(priv, msg->cm_hdr.ch_dlc);
 
   for (i = 0; i < nbytes; i++)
     {
@@ -3222,6 +3390,11 @@ static void mcan_error(FAR struct can_dev_s *dev, uint32_t status,
       hdr.ch_extid  = 0;
 #endif
       hdr.ch_unused = 0;
+#ifdef CONFIG_CAN_FD
+      hdr.ch_edl    = 0;
+      hdr.ch_brs    = 0;
+      hdr.ch_esi    = 0;
+#endif
 
       /* And provide the error report to the upper half logic */
 
@@ -3273,6 +3446,9 @@ static void mcan_receive(FAR struct can_dev_s *dev, FAR uint32_t *rxbuffer,
   hdr.ch_error  = 0;
 #endif
   hdr.ch_unused = 0;
+#ifdef CONFIG_CAN_FD
+  hdr.ch_esi    = ((regval & BUFFER_R0_ESI) != 0);
+#endif
 
   if ((regval & BUFFER_R0_RTR) != 0)
     {
@@ -3316,6 +3492,10 @@ static void mcan_receive(FAR struct can_dev_s *dev, FAR uint32_t *rxbuffer,
   reginfo("R1: %08x\n", regval);
 
   hdr.ch_dlc = (regval & BUFFER_R1_DLC_MASK) >> BUFFER_R1_DLC_SHIFT;
+#ifdef CONFIG_CAN_FD
+  hdr.ch_edl = ((regval & BUFFER_R1_EDL) != 0);
+  hdr.ch_brs = ((regval & BUFFER_R1_BRS) != 0);
+#endif
 
   /* And provide the CAN message to the upper half logic */
 
@@ -2082,9 +2082,9 @@ static void stm32_interrupt_work(FAR void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  state = net_lock();
+  state = netdev_lock(&priv->dev);
   stm32_interrupt_process(priv);
-  net_unlock(state);
+  netdev_unlock(&priv->dev, state);
 
   /* Re-enable Ethernet interrupts at the NVIC */
 
@@ -2217,9 +2217,9 @@ static void stm32_txtimeout_work(FAR void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  state = net_lock();
+  state = netdev_lock(&priv->dev);
   stm32_txtimeout_process(priv);
-  net_unlock(state);
+  netdev_unlock(&priv->dev, state);
 }
 #endif
 
@@ -2369,9 +2369,9 @@ static void stm32_poll_work(FAR void *arg)
 
   /* Perform the poll */
 
-  state = net_lock();
+  state = netdev_lock(&priv->dev);
   stm32_poll_process(priv);
-  net_unlock(state);
+  netdev_unlock(&priv->dev, state);
 }
 #endif
 
@@ -2582,9 +2582,9 @@ static void stm32_txavail_work(FAR void *arg)
 
   /* Perform the poll */
 
-  state = net_lock();
+  state = netdev_lock(&priv->dev);
   stm32_txavail_process(priv);
-  net_unlock(state);
+  netdev_unlock(&priv->dev, state);
 }
 #endif
 
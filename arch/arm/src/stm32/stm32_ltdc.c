@@ -654,6 +654,14 @@ static int stm32_fillarea(FAR struct ltdc_layer_s *layer,
 #endif
 #endif /* CONFIG_STM32_LTDC_INTERFACE */
 
+/* 2D acceleration of the framebuffer interface */
+
+#if defined(CONFIG_FB_ACCEL) && defined(CONFIG_STM32_DMA2D)
+static int stm32_accelfill(FAR const struct fb_planeinfo_s *pinfo,
+                           FAR const struct fb_area_s *area,
+                           uint32_t color);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -693,6 +701,17 @@ static const struct fb_vtable_s g_vtable =
 #endif
 };
 
+/* The DMA2D operations available to the users of the framebuffer
+ * interface
+ */
+
+#if defined(CONFIG_FB_ACCEL) && defined(CONFIG_STM32_DMA2D)
+static const struct fb_accelops_s g_accelops =
+{
+  .fillarea      = stm32_accelfill
+};
+#endif
+
 /* The LTDC semaphore that enforces mutually exclusive access */
 
 static sem_t g_lock;
@@ -2165,9 +2184,64 @@ static void stm32_ltdc_linit(int lid)
 
   layer->dma2d = stm32_dma2dinitltdc(state);
   DEBUGASSERT(layer->dma2d);
+
+#ifdef CONFIG_FB_ACCEL
+  /* Offer DMA2D fills to the framebuffer users */
+
+  state->pinfo.accel = &g_accelops;
+#endif
 #endif
 }
 
+/****************************************************************************
+ * Name: stm32_accelfill
+ *
+ * Description:
+ *   Fill an area of a layer's framebuffer with a color using the DMA2D.
+ *   This is the fillarea operation of the framebuffer interface.
+ *
+ * Parameter:
+ *   pinfo - The plane information of the layer to fill
+ *   area  - The area to fill
+ *   color - The color in the pixel format of the layer
+ *
+ * Return:
+ *   OK on success; a negated errno value if the area could not be filled.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FB_ACCEL) && defined(CONFIG_STM32_DMA2D)
+static int stm32_accelfill(FAR const struct fb_planeinfo_s *pinfo,
+                           FAR const struct fb_area_s *area,
+                           uint32_t color)
+{
+  FAR struct stm32_layer_s *layer;
+  struct ltdc_area_s ltdcarea;
+  int ret;
+  int i;
+
+  for (i = 0; i < LTDC_NLAYERS; i++)
+    {
+      layer = &LAYER(i);
+      if (layer->state.pinfo.fbmem == pinfo->fbmem)
+        {
+          ltdcarea.xpos = area->x;
+          ltdcarea.ypos = area->y;
+          ltdcarea.xres = area->w;
+          ltdcarea.yres = area->h;
+
+          sem_wait(layer->state.lock);
+          ret = layer->dma2d->fillarea(layer->dma2d, &ltdcarea, color);
+          sem_post(layer->state.lock);
+
+          return ret;
+        }
+    }
+
+  return -ENODEV;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,202 @@
+/****************************************************************************
+ * arch/arm/src/stm32f7/stm32_crc.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "up_arch.h"
+#include "chip/stm32_crc.h"
+
+#if defined(CONFIG_LIB_CRC32_ARCH) || defined(CONFIG_LIB_CRC16_ARCH)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The CRC unit is shared by all callers.  It is reprogrammed for each chunk
+ * of data (the running CRC is carried over in the INIT register) and the
+ * chunk size bounds how long interrupts are disabled.
+ */
+
+#define CRC_CHUNKSIZE     256
+
+/* Polynomials used by crc32part() and crc16part() */
+
+#define CRC32_POLYNOMIAL  0x04c11db7
+#define CRC16_POLYNOMIAL  0x1021
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stm32_bitreverse
+ ****************************************************************************/
+
+#ifdef CONFIG_LIB_CRC32_ARCH
+static inline uint32_t stm32_bitreverse(uint32_t value)
+{
+  uint32_t result;
+
+  __asm__ __volatile__ ("rbit %0, %1" : "=r" (result) : "r" (value));
+  return result;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_crc32part
+ *
+ * Description:
+ *   Continue the CRC32 calculation on a part of the buffer.  crc32part()
+ *   uses the reflected form of the 0x04c11db7 polynomial with no pre- or
+ *   post-inversion.  That is obtained from the CRC unit by reversing the
+ *   input and output bits and by loading the bit-reversed running CRC into
+ *   the INIT register.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIB_CRC32_ARCH
+uint32_t up_crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  irqstate_t flags;
+  size_t nbytes;
+
+  while (len > 0)
+    {
+      nbytes = len > CRC_CHUNKSIZE ? CRC_CHUNKSIZE : len;
+      len   -= nbytes;
+
+      flags = enter_critical_section();
+
+      putreg32(CRC32_POLYNOMIAL, STM32_CRC_POL);
+      putreg32(stm32_bitreverse(crc32val), STM32_CRC_INIT);
+      putreg32(CRC_CR_POLYSIZE_32 | CRC_CR_REV_IN_BYTE | CRC_CR_REV_OUT |
+               CRC_CR_RESET, STM32_CRC_CR);
+
+      /* Feed single bytes up to the first word boundary */
+
+      for (; nbytes > 0 && ((uintptr_t)src & 3) != 0; nbytes--)
+        {
+          putreg8(*src++, STM32_CRC_DR);
+        }
+
+      /* Then aligned words.  Reversing the bits of a whole little-endian
+       * word gives the same bit order as reversing each of its bytes in
+       * turn.
+       */
+
+      if (nbytes >= 4)
+        {
+          putreg32(CRC_CR_POLYSIZE_32 | CRC_CR_REV_IN_WORD | CRC_CR_REV_OUT,
+                   STM32_CRC_CR);
+
+          for (; nbytes >= 4; nbytes -= 4, src += 4)
+            {
+              putreg32(*(FAR const uint32_t *)src, STM32_CRC_DR);
+            }
+
+          putreg32(CRC_CR_POLYSIZE_32 | CRC_CR_REV_IN_BYTE | CRC_CR_REV_OUT,
+                   STM32_CRC_CR);
+        }
+
+      /* And any trailing bytes */
+
+      for (; nbytes > 0; nbytes--)
+        {
+          putreg8(*src++, STM32_CRC_DR);
+        }
+
+      crc32val = getreg32(STM32_CRC_DR);
+      leave_critical_section(flags);
+    }
+
+  return crc32val;
+}
+#endif
+
+/****************************************************************************
+ * Name: up_crc16part
+ *
+ * Description:
+ *   Continue the CRC16 calculation on a part of the buffer.  crc16part()
+ *   uses the non-reflected 0x1021 (CCITT) polynomial with no inversion,
+ *   which the CRC unit supports directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIB_CRC16_ARCH
+uint16_t up_crc16part(FAR const uint8_t *src, size_t len, uint16_t crc16val)
+{
+  irqstate_t flags;
+  size_t nbytes;
+
+  while (len > 0)
+    {
+      nbytes = len > CRC_CHUNKSIZE ? CRC_CHUNKSIZE : len;
+      len   -= nbytes;
+
+      flags = enter_critical_section();
+
+      putreg32(CRC16_POLYNOMIAL, STM32_CRC_POL);
+      putreg32(crc16val, STM32_CRC_INIT);
+      putreg32(CRC_CR_POLYSIZE_16 | CRC_CR_REV_IN_NONE | CRC_CR_RESET,
+               STM32_CRC_CR);
+
+      for (; nbytes > 0; nbytes--)
+        {
+          putreg8(*src++, STM32_CRC_DR);
+        }
+
+      crc16val = (uint16_t)getreg32(STM32_CRC_DR);
+      leave_critical_section(flags);
+    }
+
+  return crc16val;
+}
+#endif
+
+#endif /* CONFIG_LIB_CRC32_ARCH || CONFIG_LIB_CRC16_ARCH */
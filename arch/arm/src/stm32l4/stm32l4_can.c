@@ -1408,6 +1408,11 @@ static int stm32l4can_rxinterrupt(int irq, FAR void *context, int rxmb)
   hdr.ch_error  = 0; /* Error reporting not supported */
 #endif
   hdr.ch_unused = 0;
+#ifdef CONFIG_CAN_FD
+  hdr.ch_edl    = 0;
+  hdr.ch_brs    = 0;
+  hdr.ch_esi    = 0;
+#endif
 
   /* Extract the RTR bit */
 
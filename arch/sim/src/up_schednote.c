@@ -208,4 +208,50 @@ void sched_note_csection(FAR struct tcb_s *tcb, bool enter)
 }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+void sched_note_deadline(FAR struct tcb_s *tcb, uint32_t lateness)
+{
+#ifdef CONFIG_SMP
+#if CONFIG_TASK_NAME_SIZE > 0
+  syslog(LOG_INFO, "CPU%d: Task %s TCB@%p missed deadline by %lu ticks\n",
+         tcb->cpu, tcb->name, tcb, (unsigned long)lateness);
+#else
+  syslog(LOG_INFO, "CPU%d: TCB@%p missed deadline by %lu ticks\n",
+         tcb->cpu, tcb, (unsigned long)lateness);
+#endif
+#else
+#if CONFIG_TASK_NAME_SIZE > 0
+  syslog(LOG_INFO, "Task %s, TCB@%p missed deadline by %lu ticks\n",
+         tcb->name, tcb, (unsigned long)lateness);
+#else
+  syslog(LOG_INFO, "TCB@%p missed deadline by %lu ticks\n",
+         tcb, (unsigned long)lateness);
+#endif
+#endif
+}
+#endif
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+void sched_note_wakeup(FAR struct tcb_s *tcb, uint32_t latency)
+{
+#ifdef CONFIG_SMP
+#if CONFIG_TASK_NAME_SIZE > 0
+  syslog(LOG_INFO, "CPU%d: Task %s TCB@%p ran %lu counts after wake-up\n",
+         tcb->cpu, tcb->name, tcb, (unsigned long)latency);
+#else
+  syslog(LOG_INFO, "CPU%d: TCB@%p ran %lu counts after wake-up\n",
+         tcb->cpu, tcb, (unsigned long)latency);
+#endif
+#else
+#if CONFIG_TASK_NAME_SIZE > 0
+  syslog(LOG_INFO, "Task %s, TCB@%p ran %lu counts after wake-up\n",
+         tcb->name, tcb, (unsigned long)latency);
+#else
+  syslog(LOG_INFO, "TCB@%p ran %lu counts after wake-up\n",
+         tcb, (unsigned long)latency);
+#endif
+#endif
+}
+#endif
+
 #endif /* CONFIG_SCHED_INSTRUMENTATION && !CONFIG_SCHED_INSTRUMENTATION_BUFFER */
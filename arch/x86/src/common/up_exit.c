@@ -92,7 +92,8 @@ static void _up_dumponexit(FAR struct tcb_s *tcb, FAR void *arg)
   filelist = tcb->group->tg_filelist;
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      struct inode *inode = filelist->fl_files[i].f_inode;
+      FAR struct file *filep = files_getfile(filelist, i);
+      struct inode *inode = filep ? filep->f_inode : NULL;
       if (inode)
         {
           sinfo("      fd=%d refcount=%d\n",
@@ -76,6 +76,10 @@
 #  define CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO  1
 #endif
 
+#ifndef CONFIG_AUDIO_BUFFER_RING
+#  define CONFIG_AUDIO_BUFFER_RING 0
+#endif
+
 /****************************************************************************
  * Private Type Definitions
  ****************************************************************************/
@@ -89,6 +93,18 @@ struct audio_upperhalf_s
   sem_t             exclsem;  /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   mqd_t             usermq;   /* User mode app's message queue */
+
+#if CONFIG_AUDIO_BUFFER_RING > 0
+  /* Completed buffers are placed in this ring when no message queue is
+   * registered.  The lower half (perhaps from an interrupt handler) is the
+   * only producer and AUDIOIOC_DEQUEUEBUFFERS is the only consumer.
+   */
+
+  sem_t             ringsem;  /* Posted when the ring state changes */
+  volatile uint16_t ringhead; /* Producer index */
+  volatile uint16_t ringtail; /* Consumer index */
+  FAR struct ap_buffer_s *ring[CONFIG_AUDIO_BUFFER_RING];
+#endif
 };
 
 /****************************************************************************
@@ -109,6 +125,10 @@ static int      audio_start(FAR struct audio_upperhalf_s *upper);
 static void     audio_callback(FAR void *priv, uint16_t reason,
                     FAR struct ap_buffer_s *apb, uint16_t status);
 #endif /* CONFIG_AUDIO_MULTI_SESSION */
+#if CONFIG_AUDIO_BUFFER_RING > 0
+static int      audio_dequeuebuffers(FAR struct audio_upperhalf_s *upper,
+                    FAR struct audio_bufvec_desc_s *bufvec, bool nonblock);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -360,6 +380,20 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   audinfo("cmd: %d arg: %ld\n", cmd, arg);
 
+#if CONFIG_AUDIO_BUFFER_RING > 0
+  /* AUDIOIOC_DEQUEUEBUFFERS may wait for playback to progress, so it must
+   * not hold the device exclusively.  The ring needs no lock since this is
+   * its only consumer.
+   */
+
+  if (cmd == AUDIOIOC_DEQUEUEBUFFERS)
+    {
+      return audio_dequeuebuffers(upper,
+                                  (FAR struct audio_bufvec_desc_s *)arg,
+                                  (filep->f_oflags & O_NONBLOCK) != 0);
+    }
+#endif
+
   /* Get exclusive access to the device structures */
 
   ret = sem_wait(&upper->exclsem);
@@ -461,6 +495,12 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               ret = lower->ops->stop(lower);
 #endif
               upper->started = false;
+
+#if CONFIG_AUDIO_BUFFER_RING > 0
+              /* Wake up any thread waiting in AUDIOIOC_DEQUEUEBUFFERS */
+
+              sem_post(&upper->ringsem);
+#endif
             }
         }
         break;
@@ -578,6 +618,43 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* AUDIOIOC_ENQUEUEBUFFERS - Enqueue several audio buffers
+       *
+       *   ioctl argument:  pointer to an audio_bufvec_desc_s structure
+       */
+
+      case AUDIOIOC_ENQUEUEBUFFERS:
+        {
+          FAR struct audio_bufvec_desc_s *bufvec;
+          uint16_t i;
+
+          audinfo("AUDIOIOC_ENQUEUEBUFFERS\n");
+
+          DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
+
+          bufvec = (FAR struct audio_bufvec_desc_s *)arg;
+          ret    = OK;
+
+          for (i = 0; i < bufvec->nbuffers; i++)
+            {
+              ret = lower->ops->enqueuebuffer(lower, bufvec->buffers[i]);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          /* Report a partial success as success */
+
+          if (i > 0)
+            {
+              ret = OK;
+            }
+
+          bufvec->nbuffers = i;
+        }
+        break;
+
       /* AUDIOIOC_REGISTERMQ - Register a client Message Queue
        *
        * TODO:  This needs to have multi session support.
@@ -661,6 +738,74 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: audio_dequeuebuffers
+ *
+ * Description:
+ *   Handle the AUDIOIOC_DEQUEUEBUFFERS ioctl command:  Return up to
+ *   bufvec->nbuffers completed buffers from the dequeue ring, waiting for
+ *   the first one unless nonblocking.
+ *
+ ****************************************************************************/
+
+#if CONFIG_AUDIO_BUFFER_RING > 0
+static int audio_dequeuebuffers(FAR struct audio_upperhalf_s *upper,
+                                FAR struct audio_bufvec_desc_s *bufvec,
+                                bool nonblock)
+{
+  uint16_t tail;
+  uint16_t n = 0;
+
+  DEBUGASSERT(bufvec != NULL && bufvec->buffers != NULL);
+
+  /* Completed buffers go to the message queue instead if there is one */
+
+  if (upper->usermq != NULL)
+    {
+      return -EBUSY;
+    }
+
+  for (; ; )
+    {
+      tail = upper->ringtail;
+      while (tail != upper->ringhead && n < bufvec->nbuffers)
+        {
+          bufvec->buffers[n++] = upper->ring[tail];
+          if (++tail >= CONFIG_AUDIO_BUFFER_RING)
+            {
+              tail = 0;
+            }
+
+          /* Consume the wake-up count for the buffer, if any */
+
+          (void)sem_trywait(&upper->ringsem);
+        }
+
+      upper->ringtail = tail;
+
+      /* Return if we got something or if nothing more will come */
+
+      if (n > 0 || bufvec->nbuffers == 0 || !upper->started)
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      if (sem_wait(&upper->ringsem) < 0)
+        {
+          return -get_errno();
+        }
+    }
+
+  bufvec->nbuffers = n;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: audio_dequeuebuffer
  *
@@ -719,6 +864,30 @@ static inline void audio_dequeuebuffer(FAR struct audio_upperhalf_s *upper,
       mq_send(upper->usermq, (FAR const char *)&msg, sizeof(msg),
               CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO);
     }
+#if CONFIG_AUDIO_BUFFER_RING > 0
+  else
+    {
+      uint16_t head = upper->ringhead + 1;
+
+      /* Otherwise, put the buffer in the dequeue ring */
+
+      if (head >= CONFIG_AUDIO_BUFFER_RING)
+        {
+          head = 0;
+        }
+
+      if (head == upper->ringtail)
+        {
+          auderr("ERROR: Dequeue ring full, buffer lost\n");
+          return;
+        }
+
+      apb->flags |= AUDIO_APB_DEQUEUED;
+      upper->ring[upper->ringhead] = apb;
+      upper->ringhead = head;
+      sem_post(&upper->ringsem);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -757,6 +926,14 @@ static inline void audio_complete(FAR struct audio_upperhalf_s *upper,
       mq_send(upper->usermq, (FAR const char *)&msg, sizeof(msg),
               CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO);
     }
+#if CONFIG_AUDIO_BUFFER_RING > 0
+  else
+    {
+      /* Wake up any thread waiting in AUDIOIOC_DEQUEUEBUFFERS */
+
+      sem_post(&upper->ringsem);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -892,6 +1069,9 @@ int audio_register(FAR const char *name, FAR struct audio_lowerhalf_s *dev)
   /* Initialize the Audio device structure (it was already zeroed by kmm_zalloc()) */
 
   sem_init(&upper->exclsem, 0, 1);
+#if CONFIG_AUDIO_BUFFER_RING > 0
+  sem_init(&upper->ringsem, 0, 0);
+#endif
   upper->dev = dev;
 
 #ifdef CONFIG_AUDIO_CUSTOM_DEV_PATH
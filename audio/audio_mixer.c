@@ -0,0 +1,1270 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+#if defined(CONFIG_AUDIO) && defined(CONFIG_AUDIO_MIXER)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The mixed output is always 16-bit, little endian stereo */
+
+#define MIXER_NCHANNELS  2
+#define MIXER_FRAMESIZE  (MIXER_NCHANNELS * sizeof(int16_t))
+#define MIXER_BUFSIZE    (CONFIG_AUDIO_MIXER_PERIOD * MIXER_FRAMESIZE)
+
+/* Fixed point formats:  The sample rate conversion step and phase are Q16
+ * fractions of an input frame; stream volumes are Q15 gains.
+ */
+
+#define MIXER_ONE        (1 << 16)
+#define MIXER_UNITY_GAIN (1 << 15)
+
+/* Saturate a mixed sample to the 16-bit range */
+
+#define MIXER_CLIP16(s) \
+  ((s) > INT16_MAX ? INT16_MAX : (s) < INT16_MIN ? INT16_MIN : (s))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one client stream.  This is the lower half device that is
+ * registered with the upper half audio driver.
+ */
+
+struct mixer_stream_s
+{
+  struct audio_lowerhalf_s export; /* Must be first */
+  dq_queue_t pending;              /* Buffers enqueued by the client */
+  FAR struct ap_buffer_s *apb;     /* The buffer being consumed */
+  uint32_t step;                   /* Input frames per output frame (Q16) */
+  uint32_t phase;                  /* Position after s0 (Q16) */
+  int32_t gain;                    /* Stream volume (Q15) */
+  int16_t s0[MIXER_NCHANNELS];     /* Input frame at or before the phase */
+  int16_t s1[MIXER_NCHANNELS];     /* Input frame after the phase */
+  uint8_t nchannels;               /* Number of input channels (1 or 2) */
+  bool reserved;                   /* The stream is reserved by a client */
+  volatile bool started;           /* The stream is being mixed */
+  volatile bool paused;            /* The stream is paused */
+  volatile bool stopping;          /* A stop has been requested */
+  bool final;                      /* The last buffer has been consumed */
+};
+
+/* The state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The low-level audio device */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void *session;                   /* Our session with the device */
+#endif
+  sem_t wakeup;                        /* Wakes up the mixer thread */
+  dq_queue_t freeq;                    /* Output buffers available for mixing */
+  volatile bool complete;              /* The low-level device completed */
+  bool running;                        /* The low-level device is started */
+  bool final;                          /* The final output buffer is queued */
+
+  /* Client streams, output buffers and the mixing accumulator */
+
+  struct mixer_stream_s streams[CONFIG_AUDIO_MIXER_NSTREAMS];
+  FAR struct ap_buffer_s *outbufs[CONFIG_AUDIO_MIXER_NBUFFERS];
+  int32_t accum[CONFIG_AUDIO_MIXER_PERIOD * MIXER_NCHANNELS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Audio lower half methods of the client streams */
+
+static int      mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                  FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int      mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                  FAR void *session, FAR const struct audio_caps_s *caps);
+#else
+static int      mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                  FAR const struct audio_caps_s *caps);
+#endif
+static int      mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int      mixer_start(FAR struct audio_lowerhalf_s *dev,
+                  FAR void *session);
+#else
+static int      mixer_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int      mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                  FAR void *session);
+#else
+static int      mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int      mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                  FAR void *session);
+static int      mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                  FAR void *session);
+#else
+static int      mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int      mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int      mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                  FAR struct ap_buffer_s *apb);
+static int      mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                  FAR struct ap_buffer_s *apb);
+static int      mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                  unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int      mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                  FAR void **session);
+static int      mixer_release(FAR struct audio_lowerhalf_s *dev,
+                  FAR void *session);
+#else
+static int      mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int      mixer_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_mixer_ops =
+{
+  mixer_getcaps,       /* getcaps        */
+  mixer_configure,     /* configure      */
+  mixer_shutdown,      /* shutdown       */
+  mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  mixer_pause,         /* pause          */
+  mixer_resume,        /* resume         */
+#endif
+  NULL,                /* allocbuffer    */
+  NULL,                /* freebuffer     */
+  mixer_enqueuebuffer, /* enqueue_buffer */
+  mixer_cancelbuffer,  /* cancel_buffer  */
+  mixer_ioctl,         /* ioctl          */
+  NULL,                /* read           */
+  NULL,                /* write          */
+  mixer_reserve,       /* reserve        */
+  mixer_release        /* release        */
+};
+
+/* Only a single mixer instance is supported */
+
+static struct audio_mixer_s g_mixer;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mixer_apbentry
+ *
+ * Description:
+ *   Return the queue entry of an audio buffer.  struct ap_buffer_s is
+ *   packed, but every buffer comes from apb_alloc() so its leading dq_entry
+ *   is suitably aligned.  Going through a local void pointer avoids taking
+ *   the address of a packed member.
+ *
+ ****************************************************************************/
+
+static inline FAR dq_entry_t *mixer_apbentry(FAR struct ap_buffer_s *apb)
+{
+  FAR void *entry = apb;
+  return (FAR dq_entry_t *)entry;
+}
+
+/****************************************************************************
+ * Name: mixer_notify
+ *
+ * Description:
+ *   Forward an event for a client stream to the upper half driver.
+ *
+ ****************************************************************************/
+
+static void mixer_notify(FAR struct mixer_stream_s *stream, uint16_t reason,
+                         FAR struct ap_buffer_s *apb, uint16_t status)
+{
+  if (stream->export.upper != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      stream->export.upper(stream->export.priv, reason, apb, status,
+                           stream);
+#else
+      stream->export.upper(stream->export.priv, reason, apb, status);
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_retire
+ *
+ * Description:
+ *   Return a consumed buffer to the client and drop our reference to it.
+ *
+ ****************************************************************************/
+
+static void mixer_retire(FAR struct mixer_stream_s *stream,
+                         FAR struct ap_buffer_s *apb)
+{
+  apb->flags |= AUDIO_APB_DEQUEUED;
+  mixer_notify(stream, AUDIO_CALLBACK_DEQUEUE, apb, OK);
+  apb_free(apb);
+}
+
+/****************************************************************************
+ * Name: mixer_flush
+ *
+ * Description:
+ *   Return all of the buffers held by a stream to the client.  The stream
+ *   must not be mixed concurrently.
+ *
+ ****************************************************************************/
+
+static void mixer_flush(FAR struct mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  if (stream->apb != NULL)
+    {
+      apb         = stream->apb;
+      stream->apb = NULL;
+      mixer_retire(stream, apb);
+    }
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      apb   = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pending);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      mixer_retire(stream, apb);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_nextframe
+ *
+ * Description:
+ *   Get the next input frame of a stream, moving on to the next buffer
+ *   enqueued by the client when the current one has been consumed.  Mono
+ *   input is duplicated to both output channels.
+ *
+ * Returned Value:
+ *   True if a frame was returned; false on an underrun or at the end of the
+ *   stream (in which case stream->final is set).
+ *
+ ****************************************************************************/
+
+static bool mixer_nextframe(FAR struct mixer_stream_s *stream,
+                            FAR int16_t *frame)
+{
+  FAR struct ap_buffer_s *apb = stream->apb;
+  FAR const uint8_t *samp;
+  irqstate_t flags;
+
+  while (apb == NULL || apb->curbyte >= apb->nbytes)
+    {
+      if (apb != NULL)
+        {
+          stream->apb = NULL;
+          if ((apb->flags & AUDIO_APB_FINAL) != 0)
+            {
+              stream->final = true;
+            }
+
+          mixer_retire(stream, apb);
+          if (stream->final)
+            {
+              return false;
+            }
+        }
+
+      flags = enter_critical_section();
+      apb   = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pending);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          return false;
+        }
+
+      stream->apb = apb;
+    }
+
+  /* The buffer memory is not necessarily aligned (struct ap_buffer_s is
+   * packed), so assemble the little endian samples a byte at a time.
+   */
+
+  samp     = &apb->samp[apb->curbyte];
+  frame[0] = (int16_t)((uint16_t)samp[0] | ((uint16_t)samp[1] << 8));
+
+  if (stream->nchannels > 1)
+    {
+      frame[1] = (int16_t)((uint16_t)samp[2] | ((uint16_t)samp[3] << 8));
+    }
+  else
+    {
+      frame[1] = frame[0];
+    }
+
+  apb->curbyte += stream->nchannels * sizeof(int16_t);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mixer_addstream
+ *
+ * Description:
+ *   Convert one period of a stream to the output sample rate, scale it by
+ *   the stream volume and add it to the accumulator.
+ *
+ *   The phase accumulator selects the two input frames on either side of
+ *   each output frame and the fractional position between them, which is
+ *   then used to interpolate linearly.  Without conversion (step of one)
+ *   the phase is always zero and the input frames pass straight through.
+ *
+ ****************************************************************************/
+
+static void mixer_addstream(FAR struct audio_mixer_s *priv,
+                            FAR struct mixer_stream_s *stream)
+{
+  FAR int32_t *accum = priv->accum;
+  uint32_t step      = stream->step;
+  uint32_t phase     = stream->phase;
+  int32_t gain       = stream->gain;
+  int32_t frac;
+  int32_t left;
+  int32_t right;
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_PERIOD; i++)
+    {
+      /* Advance to the input frames on either side of this output frame */
+
+      while (phase >= MIXER_ONE)
+        {
+          phase        -= MIXER_ONE;
+          stream->s0[0] = stream->s1[0];
+          stream->s0[1] = stream->s1[1];
+
+          if (!mixer_nextframe(stream, stream->s1))
+            {
+              if (stream->final)
+                {
+                  stream->phase = phase;
+                  return;
+                }
+
+              /* Underrun.  Decay to silence until more data arrives. */
+
+              stream->s1[0] = 0;
+              stream->s1[1] = 0;
+            }
+        }
+
+      /* Interpolate.  The fraction is reduced to Q15 so that the product
+       * with the difference of two samples cannot overflow.
+       */
+
+      frac  = (int32_t)(phase >> 1);
+      left  = stream->s0[0] +
+              (((stream->s1[0] - stream->s0[0]) * frac) >> 15);
+      right = stream->s0[1] +
+              (((stream->s1[1] - stream->s0[1]) * frac) >> 15);
+
+      /* Apply the stream volume and mix */
+
+      *accum++ += (left * gain) >> 15;
+      *accum++ += (right * gain) >> 15;
+
+      phase += step;
+    }
+
+  stream->phase = phase;
+}
+
+/****************************************************************************
+ * Name: mixer_service
+ *
+ * Description:
+ *   Complete the streams that have been stopped or that have reached the
+ *   end of their data.
+ *
+ * Returned Value:
+ *   True if any stream is still started (possibly paused).
+ *
+ ****************************************************************************/
+
+static bool mixer_service(FAR struct audio_mixer_s *priv)
+{
+  FAR struct mixer_stream_s *stream;
+  bool active = false;
+  int i;
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NSTREAMS; i++)
+    {
+      stream = &priv->streams[i];
+      if (!stream->started)
+        {
+          continue;
+        }
+
+      if (stream->stopping || stream->final)
+        {
+          mixer_flush(stream);
+
+          stream->final    = false;
+          stream->stopping = false;
+          stream->started  = false;
+
+          mixer_notify(stream, AUDIO_CALLBACK_COMPLETE, NULL, OK);
+        }
+      else
+        {
+          active = true;
+        }
+    }
+
+  return active;
+}
+
+/****************************************************************************
+ * Name: mixer_mix
+ *
+ * Description:
+ *   Mix one period of all active streams into an output buffer.  If no
+ *   stream remains active afterward, the buffer is marked as the final one
+ *   so that the low-level device completes.
+ *
+ ****************************************************************************/
+
+static void mixer_mix(FAR struct audio_mixer_s *priv,
+                      FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_stream_s *stream;
+  FAR const int32_t *accum;
+  FAR uint8_t *dest;
+  int32_t samp;
+  int i;
+
+  memset(priv->accum, 0, sizeof(priv->accum));
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NSTREAMS; i++)
+    {
+      stream = &priv->streams[i];
+      if (stream->started && !stream->paused && !stream->stopping)
+        {
+          mixer_addstream(priv, stream);
+        }
+    }
+
+  /* Saturate the sum and store it in little endian order */
+
+  accum = priv->accum;
+  dest  = apb->samp;
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_PERIOD * MIXER_NCHANNELS; i++)
+    {
+      samp    = MIXER_CLIP16(*accum);
+      *dest++ = (uint8_t)samp;
+      *dest++ = (uint8_t)(samp >> 8);
+      accum++;
+    }
+
+  apb->nbytes     = MIXER_BUFSIZE;
+  apb->curbyte    = 0;
+  apb->flags      = 0;
+  apb->i.channels = MIXER_NCHANNELS;
+
+  if (!mixer_service(priv))
+    {
+      apb->flags |= AUDIO_APB_FINAL;
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_fillbuffers
+ *
+ * Description:
+ *   Mix into all free output buffers and pass them to the low-level device.
+ *
+ ****************************************************************************/
+
+static void mixer_fillbuffers(FAR struct audio_mixer_s *priv)
+{
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int ret;
+
+  while (!priv->final)
+    {
+      flags = enter_critical_section();
+      apb   = (FAR struct ap_buffer_s *)dq_remfirst(&priv->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      mixer_mix(priv, apb);
+      if ((apb->flags & AUDIO_APB_FINAL) != 0)
+        {
+          priv->final = true;
+        }
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: Lower enqueuebuffer() failed: %d\n", ret);
+
+          flags = enter_critical_section();
+          dq_addfirst(mixer_apbentry(apb), &priv->freeq);
+          leave_critical_section(flags);
+
+          priv->final = false;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_startlower
+ *
+ * Description:
+ *   Configure the low-level device for the mixed output format, prime it
+ *   with the output buffers and start it.
+ *
+ ****************************************************************************/
+
+static int mixer_startlower(FAR struct audio_mixer_s *priv)
+{
+  FAR struct audio_lowerhalf_s *lower = priv->lower;
+  struct audio_caps_s caps;
+  int ret;
+
+  memset(&caps, 0, sizeof(struct audio_caps_s));
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = MIXER_NCHANNELS;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_SAMPRATE;
+  caps.ac_controls.b[2]  = 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, priv->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Lower configure() failed: %d\n", ret);
+      return ret;
+    }
+
+  priv->final = false;
+  mixer_fillbuffers(priv);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->start(lower, priv->session);
+#else
+  ret = lower->ops->start(lower);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Lower start() failed: %d\n", ret);
+      return ret;
+    }
+
+  priv->running = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_thread
+ *
+ * Description:
+ *   The mixer thread.  It runs whenever the low-level device returns an
+ *   output buffer or a client stream changes state, so the latency from a
+ *   client buffer to the output is bounded by the output buffering:
+ *   CONFIG_AUDIO_MIXER_NBUFFERS periods of CONFIG_AUDIO_MIXER_PERIOD
+ *   frames.
+ *
+ ****************************************************************************/
+
+static int mixer_thread(int argc, FAR char *argv[])
+{
+  FAR struct audio_mixer_s *priv = &g_mixer;
+  FAR struct mixer_stream_s *stream;
+  bool active;
+  int ret;
+  int i;
+
+  for (; ; )
+    {
+      while (sem_wait(&priv->wakeup) < 0)
+        {
+          DEBUGASSERT(get_errno() == EINTR);
+        }
+
+      if (priv->complete)
+        {
+          priv->complete = false;
+          priv->running  = false;
+          priv->final    = false;
+        }
+
+      active = mixer_service(priv);
+
+      if (priv->running)
+        {
+          mixer_fillbuffers(priv);
+        }
+      else if (active)
+        {
+          ret = mixer_startlower(priv);
+          if (ret < 0)
+            {
+              /* The output cannot be started.  Terminate the streams. */
+
+              for (i = 0; i < CONFIG_AUDIO_MIXER_NSTREAMS; i++)
+                {
+                  stream = &priv->streams[i];
+                  if (stream->started)
+                    {
+                      mixer_notify(stream, AUDIO_CALLBACK_IOERR, NULL, ret);
+                      stream->stopping = true;
+                    }
+                }
+
+              (void)mixer_service(priv);
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_callback
+ *
+ * Description:
+ *   Events from the low-level device.  Returned output buffers are made
+ *   available for mixing again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status,
+                           FAR void *session)
+#else
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *priv = (FAR struct audio_mixer_s *)arg;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        DEBUGASSERT(apb != NULL);
+
+        flags = enter_critical_section();
+        dq_addlast(mixer_apbentry(apb), &priv->freeq);
+        leave_critical_section(flags);
+
+        sem_post(&priv->wakeup);
+        break;
+
+      case AUDIO_CALLBACK_COMPLETE:
+        priv->complete = true;
+        sem_post(&priv->wakeup);
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        auderr("ERROR: Lower I/O error: %d\n", status);
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_requeststop
+ *
+ * Description:
+ *   Ask the mixer thread to stop a started stream.  The mixer thread
+ *   returns the buffers and reports completion to the client.
+ *
+ ****************************************************************************/
+
+static void mixer_requeststop(FAR struct mixer_stream_s *stream)
+{
+  if (stream->started)
+    {
+      stream->stopping = true;
+      sem_post(&g_mixer.wakeup);
+    }
+  else
+    {
+      /* The stream is not being mixed, so the buffers may be returned
+       * directly.
+       */
+
+      mixer_flush(stream);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_getcaps
+ *
+ * Description:
+ *   Get the audio device capabilities.  These are those of the low-level
+ *   device, except that the streams accept only PCM.
+ *
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps)
+{
+  FAR struct audio_lowerhalf_s *lower = g_mixer.lower;
+  int ret;
+
+  DEBUGASSERT(lower && lower->ops->getcaps);
+
+  ret = lower->ops->getcaps(lower, type, caps);
+  if (ret < 0)
+    {
+      auderr("ERROR: Lower getcaps() failed: %d\n", ret);
+      return ret;
+    }
+
+  if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+    {
+      caps->ac_format.hw = (1 << (AUDIO_FMT_PCM - 1));
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: mixer_configure
+ *
+ * Description:
+ *   Configure the format and volume of a stream.  Any sample rate is
+ *   accepted and converted to CONFIG_AUDIO_MIXER_SAMPRATE.  The low-level
+ *   device is not affected.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR void *session,
+                           FAR const struct audio_caps_s *caps)
+#else
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  irqstate_t flags;
+  uint32_t samprate;
+
+  DEBUGASSERT(stream && caps);
+  audinfo("ac_type: %d\n", caps->ac_type);
+
+  switch (caps->ac_type)
+    {
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            /* The volume is in the range {0..1000} */
+
+            uint16_t volume = caps->ac_controls.hw[0];
+
+            audinfo("  Volume: %u\n", volume);
+            if (volume > 1000)
+              {
+                return -EDOM;
+              }
+
+            stream->gain = (int32_t)volume * MIXER_UNITY_GAIN / 1000;
+            return OK;
+          }
+
+        auderr("ERROR: Unrecognized feature unit\n");
+        return -ENOTTY;
+#endif
+
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0];
+
+        audinfo("  Number of channels: %u\n", caps->ac_channels);
+        audinfo("  Sample rate:        %u\n", (unsigned int)samprate);
+        audinfo("  Sample width:       %u\n", caps->ac_controls.b[2]);
+
+        if ((caps->ac_channels != 1 && caps->ac_channels != 2) ||
+            caps->ac_controls.b[2] != 16 || samprate == 0)
+          {
+            auderr("ERROR: Unsupported format\n");
+            return -ERANGE;
+          }
+
+        flags             = enter_critical_section();
+        stream->nchannels = caps->ac_channels;
+        stream->step      = (samprate << 16) / CONFIG_AUDIO_MIXER_SAMPRATE;
+        leave_critical_section(flags);
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_shutdown
+ *
+ * Description:
+ *   Shutdown a stream.  The low-level device is controlled by the mixer
+ *   thread.
+ *
+ ****************************************************************************/
+
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  mixer_requeststop((FAR struct mixer_stream_s *)dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_start
+ *
+ * Description:
+ *   Start mixing a stream.  The low-level device is started when the first
+ *   stream starts.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_start(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  if (stream->started)
+    {
+      return -EBUSY;
+    }
+
+  /* Start from silence so that the first input frame is faded in over one
+   * output frame.
+   */
+
+  stream->s0[0]    = 0;
+  stream->s0[1]    = 0;
+  stream->s1[0]    = 0;
+  stream->s1[1]    = 0;
+  stream->phase    = MIXER_ONE;
+  stream->paused   = false;
+  stream->stopping = false;
+  stream->final    = false;
+  stream->started  = true;
+
+  sem_post(&g_mixer.wakeup);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_stop
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  mixer_requeststop((FAR struct mixer_stream_s *)dev);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_pause
+ *
+ * Description:
+ *   Pause a stream.  The other streams continue to be mixed.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  stream->paused = true;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_resume
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev, FAR void *session)
+#else
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  stream->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_enqueuebuffer
+ *
+ * Description:
+ *   Enqueue a client buffer.  The buffer is returned when the mixer thread
+ *   has consumed it.
+ *
+ ****************************************************************************/
+
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  irqstate_t flags;
+
+  DEBUGASSERT(stream && apb);
+
+  apb_reference(apb);
+  apb->flags |= AUDIO_APB_OUTPUT_ENQUEUED;
+
+  flags = enter_critical_section();
+  dq_addlast(mixer_apbentry(apb), &stream->pending);
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_cancelbuffer
+ ****************************************************************************/
+
+static int mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                              FAR struct ap_buffer_s *apb)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_ioctl
+ ****************************************************************************/
+
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: mixer_reserve
+ *
+ * Description:
+ *   Reserve a stream.  Each stream may be used by one client at a time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                         FAR void **session)
+#else
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      stream->reserved = true;
+    }
+
+  leave_critical_section(flags);
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  if (ret == OK)
+    {
+      *session = (FAR void *)stream;
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_release
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int mixer_release(FAR struct audio_lowerhalf_s *dev,
+                         FAR void *session)
+#else
+static int mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct mixer_stream_s *stream = (FAR struct mixer_stream_s *)dev;
+
+  mixer_requeststop(stream);
+  stream->reserved = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Initialize the software audio mixer.  The mixer accepts and contains a
+ *   low-level audio DAC-type device.  It then returns
+ *   CONFIG_AUDIO_MIXER_NSTREAMS new audio lower half interfaces, each of
+ *   which may be registered with audio_register() as a separate device.
+ *
+ * Input Parameters:
+ *   dev     - A reference to the low-level audio DAC-type device to contain.
+ *   streams - The location to return CONFIG_AUDIO_MIXER_NSTREAMS stream
+ *             lower half interfaces.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR struct audio_lowerhalf_s *dev,
+                           FAR struct audio_lowerhalf_s **streams)
+{
+  FAR struct audio_mixer_s *priv = &g_mixer;
+  FAR struct mixer_stream_s *stream;
+  struct audio_buf_desc_s bufdesc;
+  pid_t pid;
+  int ret;
+  int i;
+
+  DEBUGASSERT(dev && dev->ops->configure && dev->ops->start &&
+              dev->ops->enqueuebuffer && streams);
+
+  if (priv->lower != NULL)
+    {
+      return -EBUSY;
+    }
+
+  sem_init(&priv->wakeup, 0, 0);
+  dq_init(&priv->freeq);
+
+  /* Reserve the low-level device for the exclusive use of the mixer and
+   * bind to its callback.
+   */
+
+  if (dev->ops->reserve != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = dev->ops->reserve(dev, &priv->session);
+#else
+      ret = dev->ops->reserve(dev);
+#endif
+      if (ret < 0)
+        {
+          auderr("ERROR: Lower reserve() failed: %d\n", ret);
+          return ret;
+        }
+    }
+
+  priv->lower = dev;
+  dev->upper  = mixer_callback;
+  dev->priv   = priv;
+
+  /* Allocate the output buffers, using the low-level device allocator if it
+   * has special requirements.
+   */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      bufdesc.session    = priv->session;
+#endif
+      bufdesc.numbytes   = MIXER_BUFSIZE;
+      bufdesc.u.ppBuffer = &priv->outbufs[i];
+
+      if (dev->ops->allocbuffer != NULL)
+        {
+          ret = dev->ops->allocbuffer(dev, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0 || priv->outbufs[i] == NULL)
+        {
+          auderr("ERROR: Failed to allocate output buffer %d\n", i);
+          ret = -ENOMEM;
+          goto errout_with_buffers;
+        }
+
+      dq_addlast(mixer_apbentry(priv->outbufs[i]), &priv->freeq);
+    }
+
+  /* Initialize the client streams */
+
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NSTREAMS; i++)
+    {
+      stream             = &priv->streams[i];
+      stream->export.ops = &g_mixer_ops;
+      stream->step       = MIXER_ONE;
+      stream->gain       = MIXER_UNITY_GAIN;
+      stream->nchannels  = MIXER_NCHANNELS;
+      dq_init(&stream->pending);
+
+      streams[i]         = &stream->export;
+    }
+
+  /* Start the mixer thread */
+
+  pid = kernel_thread("audio_mixer", CONFIG_AUDIO_MIXER_PRIORITY,
+                      CONFIG_AUDIO_MIXER_STACKSIZE, mixer_thread,
+                      (FAR char * const *)NULL);
+  if (pid < 0)
+    {
+      ret = -get_errno();
+      auderr("ERROR: Failed to start the mixer thread: %d\n", ret);
+      goto errout_with_buffers;
+    }
+
+  return OK;
+
+errout_with_buffers:
+  for (i = 0; i < CONFIG_AUDIO_MIXER_NBUFFERS; i++)
+    {
+      if (priv->outbufs[i] != NULL)
+        {
+          if (dev->ops->freebuffer != NULL)
+            {
+              bufdesc.u.pBuffer = priv->outbufs[i];
+              (void)dev->ops->freebuffer(dev, &bufdesc);
+            }
+          else
+            {
+              apb_free(priv->outbufs[i]);
+            }
+
+          priv->outbufs[i] = NULL;
+        }
+    }
+
+  if (dev->ops->release != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      (void)dev->ops->release(dev, priv->session);
+#else
+      (void)dev->ops->release(dev);
+#endif
+    }
+
+  sem_destroy(&priv->wakeup);
+  priv->lower = NULL;
+  return ret;
+}
+
+#endif /* CONFIG_AUDIO && CONFIG_AUDIO_MIXER */
@@ -133,6 +133,29 @@ int elf_findsection(FAR struct elf_loadinfo_s *loadinfo,
 
 int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_loadsymtab
+ *
+ * Description:
+ *   Bring the whole symbol table and its string table into memory (or just
+ *   locate them if the file is memory-mapped) so that elf_readsym() and
+ *   elf_symvalue() do not need to read the file for each symbol.  This is
+ *   only an optimization:  Nothing is done if there is not enough memory.
+ *
+ ****************************************************************************/
+
+void elf_loadsymtab(FAR struct elf_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: elf_freesymtab
+ *
+ * Description:
+ *   Release the memory allocated by elf_loadsymtab().
+ *
+ ****************************************************************************/
+
+void elf_freesymtab(FAR struct elf_loadinfo_s *loadinfo);
+
 /****************************************************************************
  * Name: elf_readsym
  *
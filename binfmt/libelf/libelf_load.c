@@ -40,8 +40,10 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/ioctl.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -51,6 +53,7 @@
 #include <debug.h>
 
 #include <nuttx/addrenv.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/binfmt/elf.h>
 
 #include "libelf.h"
@@ -79,6 +82,51 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: elf_sectionxip
+ *
+ * Description:
+ *   Return true if the section can be used in place (i.e., it is a read-
+ *   only section with data in a memory-mapped file, it is properly aligned
+ *   there, and no relocations apply to it).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static bool elf_sectionxip(FAR struct elf_loadinfo_s *loadinfo, int secidx)
+{
+  FAR Elf32_Shdr *shdr = &loadinfo->shdr[secidx];
+  uintptr_t addr;
+  int i;
+
+  if (loadinfo->xipbase == 0 || shdr->sh_type == SHT_NOBITS ||
+      (shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC)
+    {
+      return false;
+    }
+
+  addr = loadinfo->xipbase + shdr->sh_offset;
+  if (shdr->sh_addralign > 1 && (addr % shdr->sh_addralign) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      if ((loadinfo->shdr[i].sh_type == SHT_REL ||
+           loadinfo->shdr[i].sh_type == SHT_RELA) &&
+          loadinfo->shdr[i].sh_info == secidx)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#else
+#  define elf_sectionxip(l,i) false
+#endif
+
 /****************************************************************************
  * Name: elf_elfsize
  *
@@ -120,7 +168,7 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
             {
               datasize += ELF_ALIGNUP(shdr->sh_size);
             }
-          else
+          else if (!elf_sectionxip(loadinfo, i))
             {
               textsize += ELF_ALIGNUP(shdr->sh_size);
             }
@@ -172,6 +220,25 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
           continue;
         }
 
+#ifdef CONFIG_ELF_XIP
+      /* Read-only sections in a memory-mapped file may be used in place */
+
+      if (elf_sectionxip(loadinfo, i))
+        {
+          binfo("%d. %08lx->%08lx (XIP)\n", i,
+                (unsigned long)shdr->sh_addr,
+                (unsigned long)(loadinfo->xipbase + shdr->sh_offset));
+
+          shdr->sh_addr = loadinfo->xipbase + shdr->sh_offset;
+          if (loadinfo->textbase == 0)
+            {
+              loadinfo->textbase = shdr->sh_addr;
+            }
+
+          continue;
+        }
+#endif
+
       /* SHF_WRITE indicates that the section address space is write-
        * able
        */
@@ -216,12 +283,23 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
             (unsigned long)shdr->sh_addr, (unsigned long)*pptr);
 
       shdr->sh_addr = (uintptr_t)*pptr;
+      if (pptr == &text && loadinfo->textbase == 0)
+        {
+          loadinfo->textbase = shdr->sh_addr;
+        }
 
       /* Setup the memory pointer for the next time through the loop */
 
       *pptr += ELF_ALIGNUP(shdr->sh_size);
     }
 
+  /* The entry point is relative to the first read-only section */
+
+  if (loadinfo->textbase == 0)
+    {
+      loadinfo->textbase = loadinfo->textalloc;
+    }
+
   return OK;
 }
 
@@ -262,6 +340,18 @@ int elf_load(FAR struct elf_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+#ifdef CONFIG_ELF_XIP
+  /* Check if the file is mapped into memory so that its read-only sections
+   * can be used in place.
+   */
+
+  if (ioctl(loadinfo->filfd, FIOC_MMAP,
+            (unsigned long)((uintptr_t)&loadinfo->xipbase)) < 0)
+    {
+      loadinfo->xipbase = 0;
+    }
+#endif
+
   /* Determine total size to allocate */
 
   elf_elfsize(loadinfo);
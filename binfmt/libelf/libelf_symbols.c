@@ -45,6 +45,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -70,7 +71,9 @@
  * Name: elf_symname
  *
  * Description:
- *   Get the symbol name in loadinfo->iobuffer[].
+ *   Get the symbol name.  The name is returned from the string table in
+ *   memory if elf_loadsymtab() provided one.  Otherwise, it is read into
+ *   loadinfo->iobuffer[].
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -83,7 +86,7 @@
  ****************************************************************************/
 
 static int elf_symname(FAR struct elf_loadinfo_s *loadinfo,
-                       FAR const Elf32_Sym *sym)
+                       FAR const Elf32_Sym *sym, FAR const char **name)
 {
   FAR uint8_t *buffer;
   off_t  offset;
@@ -101,6 +104,20 @@ static int elf_symname(FAR struct elf_loadinfo_s *loadinfo,
       return -ESRCH;
     }
 
+  /* Is the string table in memory? */
+
+  if (loadinfo->strings != NULL)
+    {
+      if (sym->st_name >= loadinfo->shdr[loadinfo->strtabidx].sh_size)
+        {
+          berr("Bad symbol name offset: %lu\n", (unsigned long)sym->st_name);
+          return -EINVAL;
+        }
+
+      *name = &loadinfo->strings[sym->st_name];
+      return OK;
+    }
+
   offset = loadinfo->shdr[loadinfo->strtabidx].sh_offset + sym->st_name;
 
   /* Loop until we get the entire symbol name into memory */
@@ -141,6 +158,7 @@ static int elf_symname(FAR struct elf_loadinfo_s *loadinfo,
         {
           /* Yes, the buffer contains a NUL terminator. */
 
+          *name = (FAR const char *)loadinfo->iobuffer;
           return OK;
         }
 
@@ -202,6 +220,101 @@ int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: elf_loadsymtab
+ *
+ * Description:
+ *   Bring the whole symbol table and its string table into memory (or just
+ *   locate them if the file is memory-mapped) so that elf_readsym() and
+ *   elf_symvalue() do not need to read the file for each symbol.  This is
+ *   only an optimization:  Nothing is done if there is not enough memory.
+ *
+ ****************************************************************************/
+
+void elf_loadsymtab(FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf32_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  FAR uint8_t *buffer;
+  int ret;
+
+  if (loadinfo->strtabidx == 0 || loadinfo->strtabidx >= loadinfo->ehdr.e_shnum ||
+      strtab->sh_size == 0)
+    {
+      return;
+    }
+
+#ifdef CONFIG_ELF_XIP
+  /* If the file is memory-mapped, then the tables can be used in place */
+
+  if (loadinfo->xipbase != 0 &&
+      ((loadinfo->xipbase + symtab->sh_offset) & 3) == 0)
+    {
+      loadinfo->symbols = (FAR const Elf32_Sym *)
+        (loadinfo->xipbase + symtab->sh_offset);
+      loadinfo->strings = (FAR const char *)
+        (loadinfo->xipbase + strtab->sh_offset);
+    }
+  else
+#endif
+    {
+      /* Read both tables with one read each into a single allocation */
+
+      buffer = (FAR uint8_t *)kmm_malloc(symtab->sh_size + strtab->sh_size);
+      if (buffer == NULL)
+        {
+          binfo("Not enough memory to hold the symbol table\n");
+          return;
+        }
+
+      ret = elf_read(loadinfo, buffer, symtab->sh_size, symtab->sh_offset);
+      if (ret >= 0)
+        {
+          ret = elf_read(loadinfo, buffer + symtab->sh_size,
+                         strtab->sh_size, strtab->sh_offset);
+        }
+
+      if (ret < 0)
+        {
+          kmm_free(buffer);
+          return;
+        }
+
+      loadinfo->taballoc = buffer;
+      loadinfo->symbols  = (FAR const Elf32_Sym *)buffer;
+      loadinfo->strings  = (FAR const char *)(buffer + symtab->sh_size);
+    }
+
+  /* The names are only usable in place if the string table is properly
+   * terminated.
+   */
+
+  if (loadinfo->strings[strtab->sh_size - 1] != '\0')
+    {
+      loadinfo->strings = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: elf_freesymtab
+ *
+ * Description:
+ *   Release the memory allocated by elf_loadsymtab().
+ *
+ ****************************************************************************/
+
+void elf_freesymtab(FAR struct elf_loadinfo_s *loadinfo)
+{
+  if (loadinfo->taballoc != NULL)
+    {
+      kmm_free(loadinfo->taballoc);
+      loadinfo->taballoc = NULL;
+    }
+
+  loadinfo->symbols = NULL;
+  loadinfo->strings = NULL;
+}
+
 /****************************************************************************
  * Name: elf_readsym
  *
@@ -227,12 +340,20 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (symtab->sh_size / sizeof(Elf32_Sym)))
+  if (index < 0 || index >= (symtab->sh_size / sizeof(Elf32_Sym)))
     {
       berr("Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
+  /* Is the symbol table in memory? */
+
+  if (loadinfo->symbols != NULL)
+    {
+      memcpy(sym, &loadinfo->symbols[index], sizeof(Elf32_Sym));
+      return OK;
+    }
+
   /* Get the file offset to the symbol table entry */
 
   offset = symtab->sh_offset + sizeof(Elf32_Sym) * index;
@@ -269,6 +390,7 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
                  FAR const struct symtab_s *exports, int nexports)
 {
   FAR const struct symtab_s *symbol;
+  FAR const char *name;
   uintptr_t secbase;
   int ret;
 
@@ -294,7 +416,7 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
       {
         /* Get the name of the undefined symbol */
 
-        ret = elf_symname(loadinfo, sym);
+        ret = elf_symname(loadinfo, sym, &name);
         if (ret < 0)
           {
             /* There are a few relocations for a few architectures that do
@@ -309,21 +431,23 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym,
 
         /* Check if the base code exports a symbol of this name */
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-        symbol = symtab_findorderedbyname(exports, (FAR char *)loadinfo->iobuffer, nexports);
+#if defined(CONFIG_SYMTAB_ORDEREDBYNAME)
+        symbol = symtab_findorderedbyname(exports, name, nexports);
+#elif defined(CONFIG_SYMTAB_HASHED)
+        symbol = symtab_findhashedbyname(exports, name, nexports);
 #else
-        symbol = symtab_findbyname(exports, (FAR char *)loadinfo->iobuffer, nexports);
+        symbol = symtab_findbyname(exports, name, nexports);
 #endif
         if (!symbol)
           {
-            berr("SHN_UNDEF: Exported symbol \"%s\" not found\n", loadinfo->iobuffer);
+            berr("SHN_UNDEF: Exported symbol \"%s\" not found\n", name);
             return -ENOENT;
           }
 
         /* Yes... add the exported symbol value to the ELF symbol table entry */
 
         binfo("SHN_ABS: name=%s %08x+%08x=%08x\n",
-              loadinfo->iobuffer, sym->st_value, symbol->sym_value,
+              name, sym->st_value, symbol->sym_value,
               sym->st_value + symbol->sym_value);
 
         sym->st_value += (Elf32_Word)((uintptr_t)symbol->sym_value);
@@ -122,5 +122,14 @@ int elf_freebuffers(struct elf_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+  if (loadinfo->symcache)
+    {
+      kmm_free((FAR void *)loadinfo->symcache);
+      loadinfo->symcache  = NULL;
+      loadinfo->nsymcache = 0;
+    }
+
+  elf_freesymtab(loadinfo);
+
   return OK;
 }
@@ -466,8 +466,10 @@ static inline int nxflat_bindimports(FAR struct nxflat_loadinfo_s *loadinfo,
 
           /* Find the exported symbol value for this this symbol name. */
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_ORDEREDBYNAME)
           symbol = symtab_findorderedbyname(exports, symname, nexports);
+#elif defined(CONFIG_SYMTAB_HASHED)
+          symbol = symtab_findhashedbyname(exports, symname, nexports);
 #else
           symbol = symtab_findbyname(exports, symname, nexports);
 #endif
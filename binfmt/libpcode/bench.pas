@@ -0,0 +1,10 @@
+program bench(output);
+var
+    i, j, sum : integer;
+begin
+    sum := 0;
+    for i := 1 to 1000 do
+        for j := 1 to 100 do
+            sum := (sum + i * j) mod 1000;
+    writeln('bench: ', sum);
+end.
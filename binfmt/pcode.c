@@ -187,7 +187,7 @@ static int pcode_run(FAR char *exepath, size_t varsize, size_t strsize)
 
   /* Load the POFF file into memory */
 
-  st = pload(exepath, varsize, varsize);
+  st = pload(exepath, varsize, strsize);
   if (!st)
     {
       berr("ERROR: Could not load %s\n", exepath);
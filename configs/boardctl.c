@@ -49,6 +49,18 @@
 #include <nuttx/module.h>
 #include <nuttx/binfmt/symtab.h>
 
+#ifdef CONFIG_BOARDCTL_OS_BENCH
+#  include <nuttx/bench.h>
+#endif
+
+#ifdef CONFIG_BOARDCTL_NET_BENCH
+#  include <nuttx/net/bench.h>
+#endif
+
+#ifdef CONFIG_BOARDCTL_FS_BENCH
+#  include <nuttx/fs/bench.h>
+#endif
+
 #ifdef CONFIG_BOARDCTL_USBDEVCTRL
 #  include <nuttx/usb/cdcacm.h>
 #  include <nuttx/usb/pl2303.h>
@@ -475,6 +487,61 @@ int boardctl(unsigned int cmd, uintptr_t arg)
         break;
 #endif
 
+#ifdef CONFIG_BOARDCTL_OS_BENCH
+      /* CMD:           BOARDIOC_OS_BENCH
+       * DESCRIPTION:   Run one OS micro-benchmark
+       * ARG:           A pointer to an instance of struct boardioc_bench_s
+       * CONFIGURATION: CONFIG_LIB_BOARDCTL && CONFIG_BOARDCTL_OS_BENCH
+       * DEPENDENCIES:  None
+       */
+
+      case BOARDIOC_OS_BENCH:
+        {
+          FAR struct boardioc_bench_s *bench =
+            (FAR struct boardioc_bench_s *)arg;
+
+          DEBUGASSERT(bench != NULL);
+          ret = bench_run(bench->test, bench->nsamples, &bench->result);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_BOARDCTL_NET_BENCH
+      /* CMD:           BOARDIOC_NET_BENCH
+       * DESCRIPTION:   Run the network throughput benchmark
+       * ARG:           A pointer to an instance of struct netbench_s
+       * CONFIGURATION: CONFIG_LIB_BOARDCTL && CONFIG_BOARDCTL_NET_BENCH
+       * DEPENDENCIES:  None
+       */
+
+      case BOARDIOC_NET_BENCH:
+        {
+          FAR struct netbench_s *bench = (FAR struct netbench_s *)arg;
+
+          DEBUGASSERT(bench != NULL);
+          ret = netbench_run(bench);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_BOARDCTL_FS_BENCH
+      /* CMD:           BOARDIOC_FS_BENCH
+       * DESCRIPTION:   Run one file system or block device benchmark
+       * ARG:           A pointer to an instance of struct fsbench_s
+       * CONFIGURATION: CONFIG_LIB_BOARDCTL && CONFIG_BOARDCTL_FS_BENCH
+       * DEPENDENCIES:  None
+       */
+
+      case BOARDIOC_FS_BENCH:
+        {
+          FAR struct fsbench_s *bench = (FAR struct fsbench_s *)arg;
+
+          DEBUGASSERT(bench != NULL);
+          ret = fsbench_run(bench);
+        }
+        break;
+#endif
+
        default:
          {
 #ifdef CONFIG_BOARDCTL_IOCTL
@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -412,8 +413,9 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
   off_t   offset;
 #endif
 
-  pginfo("TCB: %p vpage: %p far: %08x\n", tcb, vpage, tcb->xcp.far);
-  DEBUGASSERT(tcb->xcp.far >= PG_PAGED_VBASE && tcb->xcp.far < PG_PAGED_VEND);
+  pginfo("TCB: %p vpage: %p\n", tcb, vpage);
+  DEBUGASSERT((uintptr_t)vpage >= PG_PAGED_VBASE &&
+              (uintptr_t)vpage < PG_PAGED_VEND);
 
   /* If BINPATH is defined, then it is the full path to a file on a mounted file
    * system.  In this case initialization will be deferred until the first
@@ -430,7 +432,7 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
    * virtual address.   File offset 0 corresponds to PG_LOCKED_VBASE.
    */
 
-  offset = (off_t)tcb->xcp.far - PG_LOCKED_VBASE;
+  offset = (off_t)((uintptr_t)vpage - PG_LOCKED_VBASE);
 
   /* Seek to that position */
 
@@ -453,7 +455,8 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
    * virtual address.   File offset 0 corresponds to PG_LOCKED_VBASE.
    */
 
-  offset = (off_t)tcb->xcp.far - PG_LOCKED_VBASE + CONFIG_EA3131_PAGING_BINOFFSET;
+  offset = (off_t)((uintptr_t)vpage - PG_LOCKED_VBASE) +
+           CONFIG_EA3131_PAGING_BINOFFSET;
 
   /* Read the page at the correct offset into the SPI FLASH device */
 
@@ -475,8 +478,9 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage)
 
 int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage, up_pgcallback_t pg_callback)
 {
-  pginfo("TCB: %p vpage: %d far: %08x\n", tcb, vpage, tcb->xcp.far);
-  DEBUGASSERT(tcb->xcp.far >= PG_PAGED_VBASE && tcb->xcp.far < PG_PAGED_VEND);
+  pginfo("TCB: %p vpage: %p\n", tcb, vpage);
+  DEBUGASSERT((uintptr_t)vpage >= PG_PAGED_VBASE &&
+              (uintptr_t)vpage < PG_PAGED_VEND);
 
 #if defined(CONFIG_PAGING_BINPATH)
 #  error "File system-based paging must always be implemented with blocking calls"
@@ -43,6 +43,7 @@
 
 #include <nuttx/userspace.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/vdso.h>
 #include <nuttx/mm/mm.h>
 
 #if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
@@ -123,6 +124,12 @@ const struct userspace_s userspace __attribute__ ((section (".userspace"))) =
 #ifdef CONFIG_LIB_USRWORK
   .work_usrstart    = work_usrstart,
 #endif
+
+  /* User-readable kernel data (declared in include/nuttx/vdso.h) */
+
+#ifdef CONFIG_LIB_SYSCALL_VDSO
+  .us_vdso          = &g_vdso,
+#endif
 };
 
 /****************************************************************************
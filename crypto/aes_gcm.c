@@ -0,0 +1,408 @@
+/****************************************************************************
+ * crypto/aes_gcm.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/crypto/aes.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Reduction terms for the four bits shifted out of the 128-bit value on
+ * each step of the table driven multiplication.
+ */
+
+static const uint64_t g_last4[16] =
+{
+  0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+  0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gcm_getu64 and gcm_putu64
+ ****************************************************************************/
+
+static uint64_t gcm_getu64(FAR const uint8_t *p)
+{
+  uint64_t value = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      value = (value << 8) | p[i];
+    }
+
+  return value;
+}
+
+static void gcm_putu64(FAR uint8_t *p, uint64_t value)
+{
+  int i;
+
+  for (i = 7; i >= 0; i--)
+    {
+      p[i] = (uint8_t)value;
+      value >>= 8;
+    }
+}
+
+/****************************************************************************
+ * Name: gcm_mult
+ *
+ * Description:
+ *   Multiply the running GHASH value by H in GF(2^128), four bits at a time
+ *   using the tables computed by aes_gcm_setkey() (Shoup's method).
+ *
+ ****************************************************************************/
+
+static void gcm_mult(FAR struct aes_gcm_s *gcm)
+{
+  FAR uint8_t *x = gcm->ghash;
+  uint64_t zh;
+  uint64_t zl;
+  uint8_t rem;
+  uint8_t lo;
+  uint8_t hi;
+  int i;
+
+  lo = x[15] & 0x0f;
+  zh = gcm->hh[lo];
+  zl = gcm->hl[lo];
+
+  for (i = 15; i >= 0; i--)
+    {
+      lo = x[i] & 0x0f;
+      hi = x[i] >> 4;
+
+      if (i != 15)
+        {
+          rem = (uint8_t)zl & 0x0f;
+          zl  = (zh << 60) | (zl >> 4);
+          zh  = (zh >> 4) ^ (g_last4[rem] << 48) ^ gcm->hh[lo];
+          zl ^= gcm->hl[lo];
+        }
+
+      rem = (uint8_t)zl & 0x0f;
+      zl  = (zh << 60) | (zl >> 4);
+      zh  = (zh >> 4) ^ (g_last4[rem] << 48) ^ gcm->hh[hi];
+      zl ^= gcm->hl[hi];
+    }
+
+  gcm_putu64(x, zh);
+  gcm_putu64(x + 8, zl);
+}
+
+/****************************************************************************
+ * Name: gcm_absorb
+ *
+ * Description:
+ *   Add data to the running GHASH value.  'total' is the number of bytes of
+ *   the same kind (additional data or cipher text) already absorbed, the
+ *   multiplication is done whenever a block is completed.
+ *
+ ****************************************************************************/
+
+static void gcm_absorb(FAR struct aes_gcm_s *gcm, FAR const uint8_t *data,
+                       size_t len, uint64_t total)
+{
+  size_t pos = (size_t)(total % AES_BLOCK_SIZE);
+
+  while (len-- > 0)
+    {
+      gcm->ghash[pos++] ^= *data++;
+      if (pos == AES_BLOCK_SIZE)
+        {
+          gcm_mult(gcm);
+          pos = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: gcm_padaad
+ *
+ * Description:
+ *   Complete a partial last block of additional data with zeroes before
+ *   the cipher text is absorbed.
+ *
+ ****************************************************************************/
+
+static void gcm_padaad(FAR struct aes_gcm_s *gcm)
+{
+  if (gcm->datalen == 0 && (gcm->aadlen % AES_BLOCK_SIZE) != 0)
+    {
+      gcm_mult(gcm);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_gcm_setkey
+ *
+ * Description:
+ *   Expand the key and compute the GHASH tables of an AES-GCM context.
+ *   hh/hl[i] hold the 4-bit value i (in GCM bit order) multiplied by H.
+ *
+ ****************************************************************************/
+
+int aes_gcm_setkey(FAR struct aes_gcm_s *gcm, FAR const uint8_t *key,
+                   size_t keylen)
+{
+  uint8_t h[AES_BLOCK_SIZE];
+  uint64_t vh;
+  uint64_t vl;
+  int ret;
+  int i;
+  int j;
+
+  ret = aes_setkey(&gcm->aes, key, keylen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* H = E(K, 0^128) */
+
+  memset(h, 0, AES_BLOCK_SIZE);
+  aes_encryptblock(&gcm->aes, h, h);
+
+  vh = gcm_getu64(h);
+  vl = gcm_getu64(h + 8);
+
+  gcm->hh[0] = 0;
+  gcm->hl[0] = 0;
+  gcm->hh[8] = vh;
+  gcm->hl[8] = vl;
+
+  /* The single bit entries are successive divisions of H by x */
+
+  for (i = 4; i > 0; i >>= 1)
+    {
+      uint64_t t = (vl & 1) ? 0xe100000000000000ull : 0;
+
+      vl = (vh << 63) | (vl >> 1);
+      vh = (vh >> 1) ^ t;
+
+      gcm->hh[i] = vh;
+      gcm->hl[i] = vl;
+    }
+
+  /* The others are sums of those */
+
+  for (i = 2; i <= 8; i <<= 1)
+    {
+      for (j = 1; j < i; j++)
+        {
+          gcm->hh[i + j] = gcm->hh[i] ^ gcm->hh[j];
+          gcm->hl[i + j] = gcm->hl[i] ^ gcm->hl[j];
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_start
+ *
+ * Description:
+ *   Begin a new message with the given IV.
+ *
+ ****************************************************************************/
+
+void aes_gcm_start(FAR struct aes_gcm_s *gcm, FAR const uint8_t *iv,
+                   size_t ivlen)
+{
+  uint8_t lenblock[AES_BLOCK_SIZE];
+  int i;
+
+  memset(gcm->ghash, 0, AES_BLOCK_SIZE);
+
+  /* J0 is IV || 0^31 || 1 for a 96-bit IV, else GHASH(IV || len(IV)) */
+
+  if (ivlen == 12)
+    {
+      memcpy(gcm->counter, iv, 12);
+      gcm->counter[12] = 0;
+      gcm->counter[13] = 0;
+      gcm->counter[14] = 0;
+      gcm->counter[15] = 1;
+    }
+  else
+    {
+      gcm_absorb(gcm, iv, ivlen, 0);
+      if ((ivlen % AES_BLOCK_SIZE) != 0)
+        {
+          gcm_mult(gcm);
+        }
+
+      memset(lenblock, 0, 8);
+      gcm_putu64(lenblock + 8, (uint64_t)ivlen * 8);
+      gcm_absorb(gcm, lenblock, AES_BLOCK_SIZE, 0);
+
+      memcpy(gcm->counter, gcm->ghash, AES_BLOCK_SIZE);
+      memset(gcm->ghash, 0, AES_BLOCK_SIZE);
+    }
+
+  aes_encryptblock(&gcm->aes, gcm->ek0, gcm->counter);
+
+  /* The payload starts with counter block J0 + 1 */
+
+  for (i = AES_BLOCK_SIZE - 1; i >= AES_BLOCK_SIZE - 4; i--)
+    {
+      if (++gcm->counter[i] != 0)
+        {
+          break;
+        }
+    }
+
+  gcm->aadlen  = 0;
+  gcm->datalen = 0;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_aad
+ *
+ * Description:
+ *   Add additional authenticated data.  Returns -EINVAL if the payload has
+ *   already been started.
+ *
+ ****************************************************************************/
+
+int aes_gcm_aad(FAR struct aes_gcm_s *gcm, FAR const uint8_t *aad,
+                size_t len)
+{
+  if (gcm->datalen != 0)
+    {
+      return -EINVAL;
+    }
+
+  gcm_absorb(gcm, aad, len, gcm->aadlen);
+  gcm->aadlen += len;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_update
+ *
+ * Description:
+ *   Encrypt (encrypt != 0) or decrypt a piece of the payload.  'in' and
+ *   'out' may refer to the same buffer.
+ *
+ ****************************************************************************/
+
+void aes_gcm_update(FAR struct aes_gcm_s *gcm, int encrypt, FAR uint8_t *out,
+                    FAR const uint8_t *in, size_t len)
+{
+  size_t offset;
+
+  if (len == 0)
+    {
+      return;
+    }
+
+  gcm_padaad(gcm);
+
+  /* The cipher text is authenticated:  Absorb it before it is overwritten
+   * when decrypting in place, or after it is produced when encrypting.
+   */
+
+  if (!encrypt)
+    {
+      gcm_absorb(gcm, in, len, gcm->datalen);
+    }
+
+  offset = (size_t)(gcm->datalen % AES_BLOCK_SIZE);
+  aes_ctr(&gcm->aes, &offset, gcm->counter, gcm->stream, out, in, len);
+
+  if (encrypt)
+    {
+      gcm_absorb(gcm, out, len, gcm->datalen);
+    }
+
+  gcm->datalen += len;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_finish
+ *
+ * Description:
+ *   Complete the message and return the first 'taglen' bytes of the
+ *   authentication tag.
+ *
+ ****************************************************************************/
+
+void aes_gcm_finish(FAR struct aes_gcm_s *gcm, FAR uint8_t *tag,
+                    size_t taglen)
+{
+  uint8_t lenblock[AES_BLOCK_SIZE];
+  int i;
+
+  gcm_padaad(gcm);
+  if ((gcm->datalen % AES_BLOCK_SIZE) != 0)
+    {
+      gcm_mult(gcm);
+    }
+
+  gcm_putu64(lenblock, gcm->aadlen * 8);
+  gcm_putu64(lenblock + 8, gcm->datalen * 8);
+  gcm_absorb(gcm, lenblock, AES_BLOCK_SIZE, 0);
+
+  if (taglen > AES_BLOCK_SIZE)
+    {
+      taglen = AES_BLOCK_SIZE;
+    }
+
+  for (i = 0; i < taglen; i++)
+    {
+      tag[i] = gcm->ghash[i] ^ gcm->ek0[i];
+    }
+}
@@ -0,0 +1,204 @@
+/****************************************************************************
+ * crypto/aes_modes.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/crypto/aes.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_xorblock
+ ****************************************************************************/
+
+static inline void aes_xorblock(FAR uint8_t *out, FAR const uint8_t *a,
+                                FAR const uint8_t *b)
+{
+  int i;
+
+  for (i = 0; i < AES_BLOCK_SIZE; i++)
+    {
+      out[i] = a[i] ^ b[i];
+    }
+}
+
+/****************************************************************************
+ * Name: aes_ctrincrement
+ *
+ * Description:
+ *   Increment the 32-bit big-endian block counter at the end of the counter
+ *   block.
+ *
+ ****************************************************************************/
+
+static inline void aes_ctrincrement(FAR uint8_t *counter)
+{
+  int i;
+
+  for (i = AES_BLOCK_SIZE - 1; i >= AES_BLOCK_SIZE - 4; i--)
+    {
+      if (++counter[i] != 0)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_cbc_encrypt
+ *
+ * Description:
+ *   Encrypt a multiple of 16 bytes in CBC mode.  The IV is updated so that
+ *   a following call continues the chain.
+ *
+ ****************************************************************************/
+
+int aes_cbc_encrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *iv,
+                    FAR uint8_t *out, FAR const uint8_t *in, size_t len)
+{
+  if ((len % AES_BLOCK_SIZE) != 0)
+    {
+      return -EINVAL;
+    }
+
+  for (; len > 0; len -= AES_BLOCK_SIZE)
+    {
+      aes_xorblock(out, in, iv);
+      aes_encryptblock(ctx, out, out);
+      memcpy(iv, out, AES_BLOCK_SIZE);
+
+      in  += AES_BLOCK_SIZE;
+      out += AES_BLOCK_SIZE;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_cbc_decrypt
+ *
+ * Description:
+ *   Decrypt a multiple of 16 bytes in CBC mode.  The IV is updated so that
+ *   a following call continues the chain.
+ *
+ ****************************************************************************/
+
+int aes_cbc_decrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *iv,
+                    FAR uint8_t *out, FAR const uint8_t *in, size_t len)
+{
+  uint8_t block[AES_BLOCK_SIZE];
+
+  if ((len % AES_BLOCK_SIZE) != 0)
+    {
+      return -EINVAL;
+    }
+
+  for (; len > 0; len -= AES_BLOCK_SIZE)
+    {
+      /* Keep the cipher text, it is the next IV and may be overwritten
+       * when decrypting in place.
+       */
+
+      memcpy(block, in, AES_BLOCK_SIZE);
+      aes_decryptblock(ctx, out, in);
+      aes_xorblock(out, out, iv);
+      memcpy(iv, block, AES_BLOCK_SIZE);
+
+      in  += AES_BLOCK_SIZE;
+      out += AES_BLOCK_SIZE;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_ctr
+ *
+ * Description:
+ *   Encrypt or decrypt any number of bytes in CTR mode.  The stream state
+ *   (offset, counter and stream block) is kept by the caller so that a
+ *   message may be processed in pieces of any size.
+ *
+ ****************************************************************************/
+
+void aes_ctr(FAR const struct aes_context_s *ctx, FAR size_t *offset,
+             FAR uint8_t *counter, FAR uint8_t *stream, FAR uint8_t *out,
+             FAR const uint8_t *in, size_t len)
+{
+  size_t n = *offset;
+
+  while (len > 0)
+    {
+      if (n == 0)
+        {
+          aes_encryptblock(ctx, stream, counter);
+          aes_ctrincrement(counter);
+
+          /* A whole block can be processed at once */
+
+          if (len >= AES_BLOCK_SIZE)
+            {
+              aes_xorblock(out, in, stream);
+              in  += AES_BLOCK_SIZE;
+              out += AES_BLOCK_SIZE;
+              len -= AES_BLOCK_SIZE;
+              continue;
+            }
+        }
+
+      /* Otherwise use the key stream one byte at a time */
+
+      *out++ = *in++ ^ stream[n];
+      n = (n + 1) % AES_BLOCK_SIZE;
+      len--;
+    }
+
+  *offset = n;
+}
@@ -42,31 +42,91 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <string.h>
+#include <semaphore.h>
 #include <poll.h>
+#include <assert.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/drivers/drivers.h>
 
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/crypto/cryptodev.h>
 
+#ifdef CONFIG_CRYPTO_SW_AES
+#  include <nuttx/crypto/aes.h>
+#endif
+
+#ifdef CONFIG_CRYPTO_SW_SHA
+#  include <nuttx/crypto/sha.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#ifdef CONFIG_CRYPTO_AES
-#  define AES_CYPHER(mode) \
-  aes_cypher(op->dst, op->src, op->len, op->iv, ses->key, ses->keylen, \
-             mode, encrypt)
+#define CRYPTODEV_MAXKEYLEN 32
+#define CRYPTODEV_MAXMACKEY 128
+
+#if defined(CONFIG_CRYPTO_SW_AES) || defined(CONFIG_CRYPTO_AES)
+#  define HAVE_SOFTWARE_AES 1
 #endif
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One session created by CIOCGSESSION.  The key is expanded only once, when
+ * the session is created.
+ */
+
+struct cryptodev_session_s
+{
+  FAR struct cryptodev_session_s *flink;
+  uint32_t id;                       /* Session ID returned to the user */
+  uint32_t cipher;                   /* CRYPTO_AES_ECB, ... */
+  uint32_t mac;                      /* CRYPTO_SHA1, ... */
+  FAR void *priv;                    /* Lower half session or NULL */
+  union
+  {
+#if defined(CONFIG_CRYPTO_SW_AES)
+    struct aes_context_s aes;        /* Expanded software key */
+#elif defined(CONFIG_CRYPTO_AES)
+    struct
+    {
+      uint32_t keylen;               /* Key for aes_cypher() */
+      uint8_t key[CRYPTODEV_MAXKEYLEN];
+    } k;
+#endif
+#ifdef CONFIG_CRYPTO_SW_SHA
+    struct sha1_context_s sha1;      /* Software hash state */
+    struct sha256_context_s sha256;
+    struct hmac_sha1_s hsha1;
+    struct hmac_sha256_s hsha256;
+#endif
+    uint8_t dummy;
+  } u;
+};
+
+/* The state of one open file */
+
+struct cryptodev_file_s
+{
+  sem_t exclsem;                     /* Serializes the session operations */
+  uint32_t nextid;                   /* Next session ID */
+  FAR struct cryptodev_lowerhalf_s *lower;
+  FAR struct cryptodev_session_s *sessions;
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 /* Character driver methods */
 
+static int cryptodev_open(FAR struct file *filep);
+static int cryptodev_close(FAR struct file *filep);
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len);
 static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
@@ -80,8 +140,8 @@ static int cryptodev_ioctl(FAR struct file *filep, int cmd,
 
 static const struct file_operations g_cryptodevops =
 {
-  0,                  /* open   */
-  0,                  /* close  */
+  cryptodev_open,     /* open   */
+  cryptodev_close,    /* close  */
   cryptodev_read,     /* read   */
   cryptodev_write,    /* write  */
   0,                  /* seek   */
@@ -98,6 +158,359 @@ static const struct file_operations g_cryptodevops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_findsession
+ ****************************************************************************/
+
+static FAR struct cryptodev_session_s *
+cryptodev_findsession(FAR struct cryptodev_file_s *priv, uint32_t id,
+                      FAR struct cryptodev_session_s **prev)
+{
+  FAR struct cryptodev_session_s *curr;
+
+  for (*prev = NULL, curr = priv->sessions; curr != NULL;
+       *prev = curr, curr = curr->flink)
+    {
+      if (curr->id == id)
+        {
+          return curr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: cryptodev_freesession
+ ****************************************************************************/
+
+static void cryptodev_freesession(FAR struct cryptodev_file_s *priv,
+                                  FAR struct cryptodev_session_s *session)
+{
+  if (session->priv != NULL)
+    {
+      (void)priv->lower->ops->freesession(priv->lower, session->priv);
+    }
+
+  /* Do not leave the key schedule behind in the heap */
+
+  memset(session, 0, sizeof(struct cryptodev_session_s));
+  kmm_free(session);
+}
+
+/****************************************************************************
+ * Name: cryptodev_hashinit
+ *
+ * Description:
+ *   Start the software hash of a hash session.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_SW_SHA
+static void cryptodev_hashinit(FAR struct cryptodev_session_s *session,
+                               FAR const uint8_t *key, size_t keylen)
+{
+  switch (session->mac)
+    {
+    case CRYPTO_SHA1:
+      sha1_init(&session->u.sha1);
+      break;
+
+    case CRYPTO_SHA2_256:
+      sha256_init(&session->u.sha256);
+      break;
+
+    case CRYPTO_SHA1_HMAC:
+      hmac_sha1_init(&session->u.hsha1, key, keylen);
+      break;
+
+    case CRYPTO_SHA2_256_HMAC:
+      hmac_sha256_init(&session->u.hsha256, key, keylen);
+      break;
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_hash
+ *
+ * Description:
+ *   Perform a CIOCCRYPT operation for a software hash session.  The HMAC
+ *   contexts restart themselves, so the key is not needed again.
+ *
+ ****************************************************************************/
+
+static int cryptodev_hash(FAR struct cryptodev_session_s *session,
+                          FAR struct crypt_op *op)
+{
+  FAR uint8_t *digest = NULL;
+
+  if ((op->flags & COP_F_UPDATE) == 0)
+    {
+      digest = (FAR uint8_t *)op->mac;
+      if (digest == NULL)
+        {
+          return -EINVAL;
+        }
+    }
+
+  switch (session->mac)
+    {
+    case CRYPTO_SHA1:
+      sha1_update(&session->u.sha1, op->src, op->len);
+      if (digest != NULL)
+        {
+          sha1_final(&session->u.sha1, digest);
+          sha1_init(&session->u.sha1);
+        }
+      break;
+
+    case CRYPTO_SHA2_256:
+      sha256_update(&session->u.sha256, op->src, op->len);
+      if (digest != NULL)
+        {
+          sha256_final(&session->u.sha256, digest);
+          sha256_init(&session->u.sha256);
+        }
+      break;
+
+    case CRYPTO_SHA1_HMAC:
+      hmac_sha1_update(&session->u.hsha1, op->src, op->len);
+      if (digest != NULL)
+        {
+          hmac_sha1_final(&session->u.hsha1, digest);
+        }
+      break;
+
+    case CRYPTO_SHA2_256_HMAC:
+      hmac_sha256_update(&session->u.hsha256, op->src, op->len);
+      if (digest != NULL)
+        {
+          hmac_sha256_final(&session->u.hsha256, digest);
+        }
+      break;
+
+    default:
+      return -EINVAL;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: cryptodev_newsession
+ ****************************************************************************/
+
+static int cryptodev_newsession(FAR struct cryptodev_file_s *priv,
+                                FAR struct session_op *ses)
+{
+  FAR struct cryptodev_session_s *session;
+  int ret;
+
+  if (ses->cipher != 0)
+    {
+      if (!CRYPTO_IS_CIPHER(ses->cipher) || ses->mac != 0 ||
+          ses->keylen > CRYPTODEV_MAXKEYLEN || ses->key == NULL)
+        {
+          return -EINVAL;
+        }
+    }
+  else if (!CRYPTO_IS_MAC(ses->mac) || ses->mackeylen < 0 ||
+           ses->mackeylen > CRYPTODEV_MAXMACKEY ||
+           (ses->mackeylen > 0 && ses->mackey == NULL))
+    {
+      return -EINVAL;
+    }
+
+  session = (FAR struct cryptodev_session_s *)
+    kmm_zalloc(sizeof(struct cryptodev_session_s));
+
+  if (session == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  session->cipher = ses->cipher;
+  session->mac    = ses->mac;
+
+  /* Prefer the hardware, if it supports this algorithm and key */
+
+  ret = -ENOSYS;
+  if (priv->lower != NULL &&
+      (ses->cipher != 0 || priv->lower->ops->hash != NULL))
+    {
+      ret = priv->lower->ops->newsession(priv->lower, ses, &session->priv);
+    }
+
+#ifdef CONFIG_CRYPTO_SW_SHA
+  if (ret == -ENOSYS && ses->mac != 0)
+    {
+      session->priv = NULL;
+      cryptodev_hashinit(session, (FAR const uint8_t *)ses->mackey,
+                         ses->mackeylen);
+      ret = OK;
+    }
+#endif
+
+#ifdef HAVE_SOFTWARE_AES
+  if (ret == -ENOSYS && ses->cipher != 0)
+    {
+      session->priv = NULL;
+
+#if defined(CONFIG_CRYPTO_SW_AES)
+      ret = aes_setkey(&session->u.aes, (FAR const uint8_t *)ses->key,
+                       ses->keylen);
+#else
+      memcpy(session->u.k.key, ses->key, ses->keylen);
+      session->u.k.keylen = ses->keylen;
+      ret = OK;
+#endif
+    }
+#endif
+
+  if (ret < 0)
+    {
+      kmm_free(session);
+      return ret;
+    }
+
+  session->id       = priv->nextid++;
+  session->flink    = priv->sessions;
+  priv->sessions    = session;
+
+  ses->ses = session->id;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_software
+ *
+ * Description:
+ *   Perform a CIOCCRYPT operation for a session without hardware support.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_SOFTWARE_AES
+static int cryptodev_software(FAR struct cryptodev_session_s *session,
+                              FAR struct crypt_op *op, bool encrypt)
+{
+#if defined(CONFIG_CRYPTO_SW_AES)
+  FAR const uint8_t *src = (FAR const uint8_t *)op->src;
+  FAR uint8_t *dst = (FAR uint8_t *)op->dst;
+  FAR uint8_t *iv = (FAR uint8_t *)op->iv;
+  uint8_t stream[AES_BLOCK_SIZE];
+  size_t offset;
+  size_t len;
+
+  if (session->cipher != CRYPTO_AES_ECB && iv == NULL)
+    {
+      return -EINVAL;
+    }
+
+  switch (session->cipher)
+    {
+    case CRYPTO_AES_ECB:
+      if ((op->len % AES_BLOCK_SIZE) != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (len = op->len; len > 0; len -= AES_BLOCK_SIZE)
+        {
+          if (encrypt)
+            {
+              aes_encryptblock(&session->u.aes, dst, src);
+            }
+          else
+            {
+              aes_decryptblock(&session->u.aes, dst, src);
+            }
+
+          src += AES_BLOCK_SIZE;
+          dst += AES_BLOCK_SIZE;
+        }
+
+      return OK;
+
+    case CRYPTO_AES_CBC:
+      return encrypt ?
+        aes_cbc_encrypt(&session->u.aes, iv, dst, src, op->len) :
+        aes_cbc_decrypt(&session->u.aes, iv, dst, src, op->len);
+
+    case CRYPTO_AES_CTR:
+
+      /* Each call starts on a block boundary of the counter */
+
+      offset = 0;
+      aes_ctr(&session->u.aes, &offset, iv, stream, dst, src, op->len);
+      return OK;
+
+    default:
+      return -EINVAL;
+    }
+
+#else
+  static const int modes[CRYPTO_ALGORITHM_MAX + 1] =
+  {
+    0, AES_MODE_ECB, AES_MODE_CBC, AES_MODE_CTR
+  };
+
+  return aes_cypher(op->dst, op->src, op->len, op->iv, session->u.k.key,
+                    session->u.k.keylen, modes[session->cipher],
+                    encrypt ? CYPHER_ENCRYPT : CYPHER_DECRYPT);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: cryptodev_open
+ ****************************************************************************/
+
+static int cryptodev_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct cryptodev_file_s *priv;
+
+  priv = (FAR struct cryptodev_file_s *)
+    kmm_zalloc(sizeof(struct cryptodev_file_s));
+
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  sem_init(&priv->exclsem, 0, 1);
+  priv->nextid   = 1;
+  priv->lower    = (FAR struct cryptodev_lowerhalf_s *)inode->i_private;
+  filep->f_priv  = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_close
+ ****************************************************************************/
+
+static int cryptodev_close(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *priv = filep->f_priv;
+  FAR struct cryptodev_session_s *session;
+
+  while ((session = priv->sessions) != NULL)
+    {
+      priv->sessions = session->flink;
+      cryptodev_freesession(priv, session);
+    }
+
+  sem_destroy(&priv->exclsem);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_read and cryptodev_write
+ ****************************************************************************/
+
 static ssize_t cryptodev_read(FAR struct file *filep, FAR char *buffer,
                               size_t len)
 {
@@ -110,70 +523,160 @@ static ssize_t cryptodev_write(FAR struct file *filep, FAR const char *buffer,
   return -EACCES;
 }
 
+/****************************************************************************
+ * Name: cryptodev_ioctl
+ ****************************************************************************/
+
 static int cryptodev_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct cryptodev_file_s *priv = filep->f_priv;
+  FAR struct cryptodev_session_s *session;
+  FAR struct cryptodev_session_s *prev;
+  int ret;
+
+  /* Get exclusive access to the sessions of this open file */
+
+  while (sem_wait(&priv->exclsem) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
   switch (cmd)
   {
   case CIOCGSESSION:
     {
-      FAR struct session_op *ses = (FAR struct session_op *)arg;
-      ses->ses = (uint32_t)ses;
-      return OK;
+      ret = cryptodev_newsession(priv, (FAR struct session_op *)arg);
     }
+    break;
 
   case CIOCFSESSION:
     {
-      return OK;
+      FAR uint32_t *ses = (FAR uint32_t *)arg;
+
+      session = cryptodev_findsession(priv, *ses, &prev);
+      if (session == NULL)
+        {
+          ret = -EINVAL;
+          break;
+        }
+
+      if (prev != NULL)
+        {
+          prev->flink = session->flink;
+        }
+      else
+        {
+          priv->sessions = session->flink;
+        }
+
+      cryptodev_freesession(priv, session);
+      ret = OK;
     }
+    break;
 
-#ifdef CONFIG_CRYPTO_AES
   case CIOCCRYPT:
     {
-      FAR struct crypt_op *op    = (FAR struct crypt_op *)arg;
-      FAR struct session_op *ses = (FAR struct session_op *)op->ses;
-      int encrypt;
+      FAR struct crypt_op *op = (FAR struct crypt_op *)arg;
+      bool encrypt;
 
       switch (op->op)
         {
         case COP_ENCRYPT:
-          encrypt = 1;
+          encrypt = true;
           break;
 
         case COP_DECRYPT:
-          encrypt = 0;
+          encrypt = false;
           break;
 
         default:
-          return -EINVAL;
+          ret = -EINVAL;
+          goto errout;
         }
 
-      switch (ses->cipher)
+      session = cryptodev_findsession(priv, op->ses, &prev);
+      if (session == NULL)
         {
-        case CRYPTO_AES_ECB:
-          return AES_CYPHER(AES_MODE_ECB);
-
-        case CRYPTO_AES_CBC:
-          return AES_CYPHER(AES_MODE_CBC);
-
-        case CRYPTO_AES_CTR:
-          return AES_CYPHER(AES_MODE_CTR);
+          ret = -EINVAL;
+        }
+      else if (session->mac != 0)
+        {
+          /* Hash sessions ignore the direction */
 
-        default:
-           return -EINVAL;
+          if (session->priv != NULL)
+            {
+              ret = priv->lower->ops->hash(priv->lower, session->priv,
+                                           (FAR const uint8_t *)op->src,
+                                           op->len,
+                                           (op->flags & COP_F_UPDATE) ?
+                                           NULL : (FAR uint8_t *)op->mac);
+            }
+          else
+            {
+#ifdef CONFIG_CRYPTO_SW_SHA
+              ret = cryptodev_hash(session, op);
+#else
+              ret = -ENOSYS;
+#endif
+            }
         }
-    }
+      else if (session->priv != NULL)
+        {
+          ret = priv->lower->ops->process(priv->lower, session->priv,
+                                          encrypt, (FAR uint8_t *)op->iv,
+                                          (FAR uint8_t *)op->dst,
+                                          (FAR const uint8_t *)op->src,
+                                          op->len);
+        }
+      else
+        {
+#ifdef HAVE_SOFTWARE_AES
+          ret = cryptodev_software(session, op, encrypt);
+#else
+          ret = -ENOSYS;
 #endif
+        }
+    }
+    break;
 
   default:
-    return -ENOTTY;
+    ret = -ENOTTY;
+    break;
   }
+
+errout:
+  sem_post(&priv->exclsem);
+  return ret;
 }
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_register
+ *
+ * Description:
+ *   Register a cryptodev character driver backed by the given lower half.
+ *
+ ****************************************************************************/
+
+int cryptodev_register(FAR const char *path,
+                       FAR struct cryptodev_lowerhalf_s *lower)
+{
+  return register_driver(path, &g_cryptodevops, 0666, lower);
+}
+
+/****************************************************************************
+ * Name: devcrypto_register
+ *
+ * Description:
+ *   Register /dev/crypto.  This does nothing if a hardware backed
+ *   /dev/crypto has already been registered.
+ *
+ ****************************************************************************/
+
 void devcrypto_register(void)
 {
-  (void)register_driver("/dev/crypto", &g_cryptodevops, 0666, NULL);
+  (void)cryptodev_register("/dev/crypto", NULL);
 }
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * crypto/hmac.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/crypto/sha.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HMAC_IPAD 0x36
+#define HMAC_OPAD 0x5c
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hmac_padkey
+ *
+ * Description:
+ *   XOR the block sized key with the pad value in place.
+ *
+ ****************************************************************************/
+
+static void hmac_padkey(FAR uint8_t *key, uint8_t pad, size_t len)
+{
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    {
+      key[i] ^= pad;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hmac_sha1_init
+ *
+ * Description:
+ *   Process the key:  Keys longer than the block size are hashed first,
+ *   shorter keys are padded with zeroes (RFC 2104).
+ *
+ ****************************************************************************/
+
+void hmac_sha1_init(FAR struct hmac_sha1_s *hmac, FAR const uint8_t *key,
+                    size_t keylen)
+{
+  uint8_t k0[SHA1_BLOCK_SIZE];
+
+  memset(k0, 0, SHA1_BLOCK_SIZE);
+  if (keylen > SHA1_BLOCK_SIZE)
+    {
+      sha1_init(&hmac->ctx);
+      sha1_update(&hmac->ctx, key, keylen);
+      sha1_final(&hmac->ctx, k0);
+    }
+  else
+    {
+      memcpy(k0, key, keylen);
+    }
+
+  hmac_padkey(k0, HMAC_IPAD, SHA1_BLOCK_SIZE);
+  sha1_init(&hmac->ipad);
+  sha1_update(&hmac->ipad, k0, SHA1_BLOCK_SIZE);
+
+  hmac_padkey(k0, HMAC_IPAD ^ HMAC_OPAD, SHA1_BLOCK_SIZE);
+  sha1_init(&hmac->opad);
+  sha1_update(&hmac->opad, k0, SHA1_BLOCK_SIZE);
+
+  memset(k0, 0, SHA1_BLOCK_SIZE);
+  hmac->ctx = hmac->ipad;
+}
+
+/****************************************************************************
+ * Name: hmac_sha1_update
+ ****************************************************************************/
+
+void hmac_sha1_update(FAR struct hmac_sha1_s *hmac, FAR const void *data,
+                      size_t len)
+{
+  sha1_update(&hmac->ctx, data, len);
+}
+
+/****************************************************************************
+ * Name: hmac_sha1_final
+ *
+ * Description:
+ *   Return the MAC and restart the context for the next message.
+ *
+ ****************************************************************************/
+
+void hmac_sha1_final(FAR struct hmac_sha1_s *hmac, FAR uint8_t *mac)
+{
+  uint8_t inner[SHA1_DIGEST_SIZE];
+
+  sha1_final(&hmac->ctx, inner);
+
+  hmac->ctx = hmac->opad;
+  sha1_update(&hmac->ctx, inner, SHA1_DIGEST_SIZE);
+  sha1_final(&hmac->ctx, mac);
+
+  hmac->ctx = hmac->ipad;
+}
+
+/****************************************************************************
+ * Name: hmac_sha256_init
+ ****************************************************************************/
+
+void hmac_sha256_init(FAR struct hmac_sha256_s *hmac, FAR const uint8_t *key,
+                      size_t keylen)
+{
+  uint8_t k0[SHA256_BLOCK_SIZE];
+
+  memset(k0, 0, SHA256_BLOCK_SIZE);
+  if (keylen > SHA256_BLOCK_SIZE)
+    {
+      sha256_init(&hmac->ctx);
+      sha256_update(&hmac->ctx, key, keylen);
+      sha256_final(&hmac->ctx, k0);
+    }
+  else
+    {
+      memcpy(k0, key, keylen);
+    }
+
+  hmac_padkey(k0, HMAC_IPAD, SHA256_BLOCK_SIZE);
+  sha256_init(&hmac->ipad);
+  sha256_update(&hmac->ipad, k0, SHA256_BLOCK_SIZE);
+
+  hmac_padkey(k0, HMAC_IPAD ^ HMAC_OPAD, SHA256_BLOCK_SIZE);
+  sha256_init(&hmac->opad);
+  sha256_update(&hmac->opad, k0, SHA256_BLOCK_SIZE);
+
+  memset(k0, 0, SHA256_BLOCK_SIZE);
+  hmac->ctx = hmac->ipad;
+}
+
+/****************************************************************************
+ * Name: hmac_sha256_update
+ ****************************************************************************/
+
+void hmac_sha256_update(FAR struct hmac_sha256_s *hmac, FAR const void *data,
+                        size_t len)
+{
+  sha256_update(&hmac->ctx, data, len);
+}
+
+/****************************************************************************
+ * Name: hmac_sha256_final
+ ****************************************************************************/
+
+void hmac_sha256_final(FAR struct hmac_sha256_s *hmac, FAR uint8_t *mac)
+{
+  uint8_t inner[SHA256_DIGEST_SIZE];
+
+  sha256_final(&hmac->ctx, inner);
+
+  hmac->ctx = hmac->opad;
+  sha256_update(&hmac->ctx, inner, SHA256_DIGEST_SIZE);
+  sha256_final(&hmac->ctx, mac);
+
+  hmac->ctx = hmac->ipad;
+}
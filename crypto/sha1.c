@@ -0,0 +1,233 @@
+/****************************************************************************
+ * crypto/sha1.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/crypto/sha.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha1_transform
+ *
+ * Description:
+ *   Process one 64 byte block (FIPS 180-4, section 6.1.2).  The message
+ *   schedule is kept in a 16 word circular buffer.
+ *
+ ****************************************************************************/
+
+static void sha1_transform(FAR uint32_t *state, FAR const uint8_t *block)
+{
+  uint32_t w[16];
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+  uint32_t d;
+  uint32_t e;
+  uint32_t f;
+  uint32_t k;
+  uint32_t t;
+  int i;
+
+  for (i = 0; i < 16; i++, block += 4)
+    {
+      w[i] = ((uint32_t)block[0] << 24) | ((uint32_t)block[1] << 16) |
+             ((uint32_t)block[2] << 8) | (uint32_t)block[3];
+    }
+
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+
+  for (i = 0; i < 80; i++)
+    {
+      if (i >= 16)
+        {
+          t = w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^
+              w[i & 15];
+          w[i & 15] = ROTL(t, 1);
+        }
+
+      if (i < 20)
+        {
+          f = (b & c) | (~b & d);
+          k = 0x5a827999;
+        }
+      else if (i < 40)
+        {
+          f = b ^ c ^ d;
+          k = 0x6ed9eba1;
+        }
+      else if (i < 60)
+        {
+          f = (b & c) | (b & d) | (c & d);
+          k = 0x8f1bbcdc;
+        }
+      else
+        {
+          f = b ^ c ^ d;
+          k = 0xca62c1d6;
+        }
+
+      t = ROTL(a, 5) + f + e + k + w[i & 15];
+      e = d;
+      d = c;
+      c = ROTL(b, 30);
+      b = a;
+      a = t;
+    }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha1_init
+ ****************************************************************************/
+
+void sha1_init(FAR struct sha1_context_s *ctx)
+{
+  ctx->state[0] = 0x67452301;
+  ctx->state[1] = 0xefcdab89;
+  ctx->state[2] = 0x98badcfe;
+  ctx->state[3] = 0x10325476;
+  ctx->state[4] = 0xc3d2e1f0;
+  ctx->count    = 0;
+}
+
+/****************************************************************************
+ * Name: sha1_update
+ ****************************************************************************/
+
+void sha1_update(FAR struct sha1_context_s *ctx, FAR const void *data,
+                 size_t len)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  size_t used = (size_t)(ctx->count % SHA1_BLOCK_SIZE);
+  size_t nbytes;
+
+  ctx->count += len;
+
+  /* Complete a partial block first */
+
+  if (used > 0)
+    {
+      nbytes = SHA1_BLOCK_SIZE - used;
+      if (nbytes > len)
+        {
+          nbytes = len;
+        }
+
+      memcpy(&ctx->buffer[used], src, nbytes);
+      src += nbytes;
+      len -= nbytes;
+
+      if (used + nbytes < SHA1_BLOCK_SIZE)
+        {
+          return;
+        }
+
+      sha1_transform(ctx->state, ctx->buffer);
+    }
+
+  /* Whole blocks are hashed in place */
+
+  for (; len >= SHA1_BLOCK_SIZE; len -= SHA1_BLOCK_SIZE)
+    {
+      sha1_transform(ctx->state, src);
+      src += SHA1_BLOCK_SIZE;
+    }
+
+  memcpy(ctx->buffer, src, len);
+}
+
+/****************************************************************************
+ * Name: sha1_final
+ ****************************************************************************/
+
+void sha1_final(FAR struct sha1_context_s *ctx, FAR uint8_t *digest)
+{
+  uint64_t nbits = ctx->count * 8;
+  size_t used = (size_t)(ctx->count % SHA1_BLOCK_SIZE);
+  int i;
+
+  /* Append the 1 bit, pad with zeroes and append the length in bits */
+
+  ctx->buffer[used++] = 0x80;
+  if (used > SHA1_BLOCK_SIZE - 8)
+    {
+      memset(&ctx->buffer[used], 0, SHA1_BLOCK_SIZE - used);
+      sha1_transform(ctx->state, ctx->buffer);
+      used = 0;
+    }
+
+  memset(&ctx->buffer[used], 0, SHA1_BLOCK_SIZE - 8 - used);
+  for (i = 0; i < 8; i++)
+    {
+      ctx->buffer[SHA1_BLOCK_SIZE - 1 - i] = (uint8_t)(nbits >> (8 * i));
+    }
+
+  sha1_transform(ctx->state, ctx->buffer);
+
+  for (i = 0; i < SHA1_DIGEST_SIZE; i++)
+    {
+      digest[i] = (uint8_t)(ctx->state[i >> 2] >> (24 - 8 * (i & 3)));
+    }
+}
@@ -0,0 +1,242 @@
+/****************************************************************************
+ * crypto/sha256.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/crypto/sha.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ROTR(v, n) (((v) >> (n)) | ((v) << (32 - (n))))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Round constants:  The first 32 bits of the fractional parts of the cube
+ * roots of the first 64 primes.
+ */
+
+static const uint32_t g_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+  0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+  0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+  0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+  0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+  0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_transform
+ *
+ * Description:
+ *   Process one 64 byte block (FIPS 180-4, section 6.2.2).  The message
+ *   schedule is kept in a 16 word circular buffer.
+ *
+ ****************************************************************************/
+
+static void sha256_transform(FAR uint32_t *state, FAR const uint8_t *block)
+{
+  uint32_t w[16];
+  uint32_t s[8];
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t x;
+  uint32_t y;
+  int i;
+
+  for (i = 0; i < 16; i++, block += 4)
+    {
+      w[i] = ((uint32_t)block[0] << 24) | ((uint32_t)block[1] << 16) |
+             ((uint32_t)block[2] << 8) | (uint32_t)block[3];
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      s[i] = state[i];
+    }
+
+  for (i = 0; i < 64; i++)
+    {
+      if (i >= 16)
+        {
+          x = w[(i + 1) & 15];
+          y = w[(i + 14) & 15];
+          w[i & 15] += (ROTR(x, 7) ^ ROTR(x, 18) ^ (x >> 3)) +
+                       (ROTR(y, 17) ^ ROTR(y, 19) ^ (y >> 10)) +
+                       w[(i + 9) & 15];
+        }
+
+      t1 = s[7] + (ROTR(s[4], 6) ^ ROTR(s[4], 11) ^ ROTR(s[4], 25)) +
+           ((s[4] & s[5]) ^ (~s[4] & s[6])) + g_k[i] + w[i & 15];
+      t2 = (ROTR(s[0], 2) ^ ROTR(s[0], 13) ^ ROTR(s[0], 22)) +
+           ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+
+      s[7] = s[6];
+      s[6] = s[5];
+      s[5] = s[4];
+      s[4] = s[3] + t1;
+      s[3] = s[2];
+      s[2] = s[1];
+      s[1] = s[0];
+      s[0] = t1 + t2;
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      state[i] += s[i];
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_init
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_context_s *ctx)
+{
+  ctx->state[0] = 0x6a09e667;
+  ctx->state[1] = 0xbb67ae85;
+  ctx->state[2] = 0x3c6ef372;
+  ctx->state[3] = 0xa54ff53a;
+  ctx->state[4] = 0x510e527f;
+  ctx->state[5] = 0x9b05688c;
+  ctx->state[6] = 0x1f83d9ab;
+  ctx->state[7] = 0x5be0cd19;
+  ctx->count    = 0;
+}
+
+/****************************************************************************
+ * Name: sha256_update
+ ****************************************************************************/
+
+void sha256_update(FAR struct sha256_context_s *ctx, FAR const void *data,
+                   size_t len)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)data;
+  size_t used = (size_t)(ctx->count % SHA256_BLOCK_SIZE);
+  size_t nbytes;
+
+  ctx->count += len;
+
+  /* Complete a partial block first */
+
+  if (used > 0)
+    {
+      nbytes = SHA256_BLOCK_SIZE - used;
+      if (nbytes > len)
+        {
+          nbytes = len;
+        }
+
+      memcpy(&ctx->buffer[used], src, nbytes);
+      src += nbytes;
+      len -= nbytes;
+
+      if (used + nbytes < SHA256_BLOCK_SIZE)
+        {
+          return;
+        }
+
+      sha256_transform(ctx->state, ctx->buffer);
+    }
+
+  /* Whole blocks are hashed in place */
+
+  for (; len >= SHA256_BLOCK_SIZE; len -= SHA256_BLOCK_SIZE)
+    {
+      sha256_transform(ctx->state, src);
+      src += SHA256_BLOCK_SIZE;
+    }
+
+  memcpy(ctx->buffer, src, len);
+}
+
+/****************************************************************************
+ * Name: sha256_final
+ ****************************************************************************/
+
+void sha256_final(FAR struct sha256_context_s *ctx, FAR uint8_t *digest)
+{
+  uint64_t nbits = ctx->count * 8;
+  size_t used = (size_t)(ctx->count % SHA256_BLOCK_SIZE);
+  int i;
+
+  /* Append the 1 bit, pad with zeroes and append the length in bits */
+
+  ctx->buffer[used++] = 0x80;
+  if (used > SHA256_BLOCK_SIZE - 8)
+    {
+      memset(&ctx->buffer[used], 0, SHA256_BLOCK_SIZE - used);
+      sha256_transform(ctx->state, ctx->buffer);
+      used = 0;
+    }
+
+  memset(&ctx->buffer[used], 0, SHA256_BLOCK_SIZE - 8 - used);
+  for (i = 0; i < 8; i++)
+    {
+      ctx->buffer[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(nbits >> (8 * i));
+    }
+
+  sha256_transform(ctx->state, ctx->buffer);
+
+  for (i = 0; i < SHA256_DIGEST_SIZE; i++)
+    {
+      digest[i] = (uint8_t)(ctx->state[i >> 2] >> (24 - 8 * (i & 3)));
+    }
+}
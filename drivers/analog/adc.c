@@ -57,7 +57,9 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/analog/adc.h>
 
 #include <nuttx/irq.h>
@@ -73,6 +75,17 @@ static ssize_t adc_read(FAR struct file *fielp, FAR char *buffer,
 static int     adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int     adc_receive(FAR struct adc_dev_s *dev, uint8_t ch,
                            int32_t data);
+#ifdef CONFIG_ADC_STREAM
+static int     adc_streamstart(FAR struct adc_dev_s *dev, size_t blksize);
+static void    adc_streamstop(FAR struct adc_dev_s *dev);
+static int     adc_streamwait(FAR struct file *filep,
+                              FAR struct adc_dev_s *dev);
+static ssize_t adc_streamread(FAR struct file *filep,
+                              FAR struct adc_dev_s *dev, FAR char *buffer,
+                              size_t buflen);
+static int     adc_receive_block(FAR struct adc_dev_s *dev,
+                                 FAR const void *block, size_t nbytes);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -94,6 +107,9 @@ static const struct file_operations g_adc_fops =
 static const struct adc_callback_s g_adc_callback =
 {
   adc_receive   /* au_receive */
+#ifdef CONFIG_ADC_STREAM
+  , adc_receive_block /* au_receive_block */
+#endif
 };
 
 /****************************************************************************
@@ -207,6 +223,12 @@ static int adc_close(FAR struct file *filep)
 
           dev->ad_ocount = 0;
 
+#ifdef CONFIG_ADC_STREAM
+          /* Stop streaming and free the block ring */
+
+          adc_streamstop(dev);
+#endif
+
           /* Free the IRQ and disable the ADC device */
 
           flags = enter_critical_section();       /* Disable interrupts */
@@ -235,6 +257,15 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
 
   ainfo("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_STREAM
+  /* In streaming mode, return whole blocks from the block ring */
+
+  if (dev->ad_sbuffer != NULL)
+    {
+      return adc_streamread(filep, dev, buffer, buflen);
+    }
+#endif
+
   if (buflen % 5 == 0)
     msglen = 5;
   else if (buflen % 4 == 0)
@@ -365,7 +396,130 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct adc_dev_s *dev = inode->i_private;
   int ret;
 
+#ifdef CONFIG_ADC_STREAM
+  switch (cmd)
+    {
+      /* Start streaming.  Arg: The block size in bytes (0 = default) */
+
+      case ANIOC_STREAM_START:
+        {
+          ret = sem_wait(&dev->ad_closesem);
+          if (ret < 0)
+            {
+              return -errno;
+            }
+
+          ret = adc_streamstart(dev, (size_t)arg);
+          sem_post(&dev->ad_closesem);
+        }
+        break;
+
+      /* Stop streaming.  Arg: None */
+
+      case ANIOC_STREAM_STOP:
+        {
+          ret = sem_wait(&dev->ad_closesem);
+          if (ret < 0)
+            {
+              return -errno;
+            }
+
+          adc_streamstop(dev);
+          sem_post(&dev->ad_closesem);
+        }
+        break;
+
+      /* Get the stream status.  Arg: struct adc_stream_status_s * */
+
+      case ANIOC_STREAM_STATUS:
+        {
+          FAR struct adc_stream_status_s *status =
+            (FAR struct adc_stream_status_s *)((uintptr_t)arg);
+          irqstate_t flags;
+
+          DEBUGASSERT(status != NULL);
+
+          flags = enter_critical_section();
+          status->as_blksize   = dev->ad_blksize;
+          status->as_nblocks   = CONFIG_ADC_STREAM_NBLOCKS;
+          status->as_navail    = dev->ad_scount;
+          status->as_nreceived = dev->ad_sreceived;
+          status->as_noverruns = dev->ad_soverruns;
+          leave_critical_section(flags);
+          ret = OK;
+        }
+        break;
+
+      /* Wait for the oldest block.  Arg: struct adc_block_s * */
+
+      case ANIOC_STREAM_GETBLOCK:
+        {
+          FAR struct adc_block_s *block =
+            (FAR struct adc_block_s *)((uintptr_t)arg);
+
+          DEBUGASSERT(block != NULL);
+
+          ret = adc_streamwait(filep, dev);
+          if (ret >= 0)
+            {
+              block->ab_offset = (uint32_t)dev->ad_shead * dev->ad_blksize;
+              block->ab_nbytes = dev->ad_slen[dev->ad_shead];
+            }
+        }
+        break;
+
+      /* Release the oldest block to the lower half.  Arg: None */
+
+      case ANIOC_STREAM_RELEASE:
+        {
+          irqstate_t flags = enter_critical_section();
+          if (dev->ad_sbuffer != NULL && dev->ad_scount > 0)
+            {
+              if (++dev->ad_shead >= CONFIG_ADC_STREAM_NBLOCKS)
+                {
+                  dev->ad_shead = 0;
+                }
+
+              dev->ad_scount--;
+              dev->ad_soffset = 0;
+              ret = OK;
+            }
+          else
+            {
+              ret = -EINVAL;
+            }
+
+          leave_critical_section(flags);
+        }
+        break;
+
+      /* Map the block ring.  Arg: void ** */
+
+      case FIOC_MMAP:
+        {
+          FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(ppv != NULL);
+          if (dev->ad_sbuffer == NULL)
+            {
+              ret = -ENXIO;
+            }
+          else
+            {
+              *ppv = dev->ad_sbuffer;
+              ret  = OK;
+            }
+        }
+        break;
+
+      default:
+        ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+        break;
+    }
+#else
   ret = dev->ad_ops->ao_ioctl(dev, cmd, arg);
+#endif
+
   return ret;
 }
 
@@ -413,6 +567,305 @@ static int adc_receive(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data)
   return errcode;
 }
 
+#ifdef CONFIG_ADC_STREAM
+/****************************************************************************
+ * Name: adc_streamstart
+ *
+ * Description:
+ *   Allocate the block ring and ask the lower half to start streaming.
+ *
+ * Assumptions:
+ *   The caller holds ad_closesem.
+ *
+ ****************************************************************************/
+
+static int adc_streamstart(FAR struct adc_dev_s *dev, size_t blksize)
+{
+  FAR uint8_t *sbuffer;
+  irqstate_t flags;
+  int ret;
+
+  if (dev->ad_ops->ao_stream == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (dev->ad_sbuffer != NULL)
+    {
+      return -EBUSY;
+    }
+
+  if (blksize == 0)
+    {
+      blksize = CONFIG_ADC_STREAM_BLOCKSIZE;
+    }
+
+  if (blksize > UINT16_MAX)
+    {
+      return -EINVAL;
+    }
+
+  sbuffer = (FAR uint8_t *)kmm_malloc(blksize * CONFIG_ADC_STREAM_NBLOCKS);
+  if (sbuffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Publish the empty ring before the lower half can deliver a block */
+
+  flags = enter_critical_section();
+  dev->ad_blksize   = (uint16_t)blksize;
+  dev->ad_soffset   = 0;
+  dev->ad_shead     = 0;
+  dev->ad_scount    = 0;
+  dev->ad_sreceived = 0;
+  dev->ad_soverruns = 0;
+  dev->ad_sbuffer   = sbuffer;
+  leave_critical_section(flags);
+
+  ret = dev->ad_ops->ao_stream(dev, blksize);
+  if (ret < 0)
+    {
+      aerr("ERROR: Failed to start streaming: %d\n", ret);
+
+      flags = enter_critical_section();
+      dev->ad_sbuffer = NULL;
+      leave_critical_section(flags);
+
+      kmm_free(sbuffer);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_streamstop
+ *
+ * Description:
+ *   Stop streaming and free the block ring.  Any waiting readers are woken
+ *   up and return end-of-file.
+ *
+ * Assumptions:
+ *   The caller holds ad_closesem.
+ *
+ ****************************************************************************/
+
+static void adc_streamstop(FAR struct adc_dev_s *dev)
+{
+  FAR uint8_t *sbuffer;
+  irqstate_t flags;
+  int i;
+
+  if (dev->ad_sbuffer == NULL)
+    {
+      return;
+    }
+
+  (void)dev->ad_ops->ao_stream(dev, 0);
+
+  flags = enter_critical_section();
+  sbuffer         = dev->ad_sbuffer;
+  dev->ad_sbuffer = NULL;
+  dev->ad_scount  = 0;
+
+  for (i = 0; i < dev->ad_nrxwaiters; i++)
+    {
+      sem_post(&dev->ad_recv.af_sem);
+    }
+
+  leave_critical_section(flags);
+
+  kmm_free(sbuffer);
+}
+
+/****************************************************************************
+ * Name: adc_streamwait
+ *
+ * Description:
+ *   Wait until the block ring holds at least one filled block.
+ *
+ * Returned Value:
+ *   Zero (OK) if a block is available; -EAGAIN in non-blocking mode if no
+ *   block is available; -ENXIO if streaming has been stopped; or another
+ *   negated errno value if the wait was interrupted.
+ *
+ ****************************************************************************/
+
+static int adc_streamwait(FAR struct file *filep, FAR struct adc_dev_s *dev)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  while (dev->ad_sbuffer != NULL && dev->ad_scount == 0)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      dev->ad_nrxwaiters++;
+      ret = sem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          ret = -errno;
+          goto errout;
+        }
+    }
+
+  if (dev->ad_sbuffer == NULL)
+    {
+      ret = -ENXIO;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_streamread
+ *
+ * Description:
+ *   Copy blocks from the block ring into the user buffer and release them.
+ *   Whole blocks are returned if the user buffer is large enough; otherwise
+ *   the remainder of the head block is returned by the next read.  There
+ *   must be only one reader while streaming, and streaming must not be
+ *   stopped by another thread while a read is in progress.
+ *
+ ****************************************************************************/
+
+static ssize_t adc_streamread(FAR struct file *filep,
+                              FAR struct adc_dev_s *dev, FAR char *buffer,
+                              size_t buflen)
+{
+  irqstate_t flags;
+  size_t nread = 0;
+  size_t ncopy;
+  size_t len;
+  int ret;
+
+  ret = adc_streamwait(filep, dev);
+  if (ret < 0)
+    {
+      /* End-of-file if streaming was stopped while waiting */
+
+      return ret == -ENXIO ? 0 : ret;
+    }
+
+  /* The filled blocks belong to the reader until they are released; the
+   * lower half only appends blocks behind them.  So the data may be
+   * copied with interrupts enabled.
+   */
+
+  while (nread < buflen && dev->ad_scount > 0)
+    {
+      len   = dev->ad_slen[dev->ad_shead] - dev->ad_soffset;
+      ncopy = buflen - nread;
+
+      /* Don't split a block unless nothing would be returned otherwise */
+
+      if (ncopy < len && nread > 0)
+        {
+          break;
+        }
+
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      memcpy(&buffer[nread],
+             &dev->ad_sbuffer[(size_t)dev->ad_shead * dev->ad_blksize +
+                              dev->ad_soffset],
+             ncopy);
+      nread += ncopy;
+
+      flags = enter_critical_section();
+      if (ncopy < len)
+        {
+          dev->ad_soffset += ncopy;
+        }
+      else
+        {
+          /* The block has been consumed; return it to the ring */
+
+          if (++dev->ad_shead >= CONFIG_ADC_STREAM_NBLOCKS)
+            {
+              dev->ad_shead = 0;
+            }
+
+          dev->ad_scount--;
+          dev->ad_soffset = 0;
+        }
+
+      leave_critical_section(flags);
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: adc_receive_block
+ *
+ * Description:
+ *   Called from the lower half (normally from the DMA half or full transfer
+ *   interrupt) with one completed half-buffer.
+ *
+ ****************************************************************************/
+
+static int adc_receive_block(FAR struct adc_dev_s *dev,
+                             FAR const void *block, size_t nbytes)
+{
+  irqstate_t flags;
+  int tail;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (dev->ad_sbuffer == NULL)
+    {
+      ret = -ENXIO;
+    }
+  else if (dev->ad_scount >= CONFIG_ADC_STREAM_NBLOCKS)
+    {
+      /* The ring is full.  Drop the new block so that the data already
+       * returned to the reader stays contiguous.
+       */
+
+      dev->ad_soverruns++;
+      ret = -ENOSPC;
+    }
+  else
+    {
+      tail = dev->ad_shead + dev->ad_scount;
+      if (tail >= CONFIG_ADC_STREAM_NBLOCKS)
+        {
+          tail -= CONFIG_ADC_STREAM_NBLOCKS;
+        }
+
+      if (nbytes > dev->ad_blksize)
+        {
+          nbytes = dev->ad_blksize;
+        }
+
+      memcpy(&dev->ad_sbuffer[(size_t)tail * dev->ad_blksize], block, nbytes);
+      dev->ad_slen[tail] = (uint16_t)nbytes;
+      dev->ad_scount++;
+      dev->ad_sreceived++;
+
+      if (dev->ad_nrxwaiters > 0)
+        {
+          sem_post(&dev->ad_recv.af_sem);
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_ADC_STREAM */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
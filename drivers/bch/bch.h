@@ -52,6 +52,35 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_BCH_CACHE_NSECTORS
+#  define CONFIG_BCH_CACHE_NSECTORS 1
+#endif
+
+#ifndef CONFIG_BCH_CACHE_NWAYS
+#  define CONFIG_BCH_CACHE_NWAYS 1
+#endif
+
+#ifndef CONFIG_BCH_CACHE_READAHEAD
+#  define CONFIG_BCH_CACHE_READAHEAD 0
+#endif
+
+#if CONFIG_BCH_CACHE_NWAYS < 1 || \
+    (CONFIG_BCH_CACHE_NSECTORS % CONFIG_BCH_CACHE_NWAYS) != 0
+#  error CONFIG_BCH_CACHE_NSECTORS must be a multiple of CONFIG_BCH_CACHE_NWAYS
+#endif
+
+/* Sector cache geometry.  Sector n may be held only in set (n % BCH_NSETS).
+ * The data for way w of set s lies at index (w * BCH_NSETS + s) in the cache
+ * memory so that the same way of consecutive sets is contiguous and may be
+ * filled by a single multi-sector read.
+ */
+
+#define BCH_NSETS         (CONFIG_BCH_CACHE_NSECTORS / CONFIG_BCH_CACHE_NWAYS)
+#define BCH_INDEX(s,w)    ((w) * BCH_NSETS + (s))
+#define BCH_BUFFER(b,i)   (&(b)->buffer[(size_t)(i) * (b)->sectsize])
+
 #define bchlib_semgive(d) sem_post(&(d)->sem)  /* To match bchlib_semtake */
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
 
@@ -59,18 +88,32 @@
  * Public Types
  ****************************************************************************/
 
+/* Describes one entry in the sector cache */
+
+struct bchlib_sector_s
+{
+  size_t sector;           /* The sector held in the entry or (size_t)-1 */
+  uint32_t lru;            /* Time of last use for LRU replacement */
+  bool dirty;              /* true: Data has been written to the entry */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t lastsector;       /* The last sector loaded into the cache */
+  uint32_t lru;            /* Counter used to age the cache entries */
   sem_t sem;               /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* Sector cache memory */
+  FAR struct bchlib_sector_s *current; /* Entry from bchlib_readsector() */
+
+  /* The sector cache */
+
+  struct bchlib_sector_s cache[CONFIG_BCH_CACHE_NSECTORS];
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -97,7 +140,13 @@ EXTERN const struct file_operations bch_fops;
 
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
-EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                              FAR uint8_t **buffer);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -74,10 +74,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -85,7 +86,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -104,45 +105,41 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_flushentry
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write one cache entry back to the media if it is dirty.
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bch_flushentry(FAR struct bchlib_s *bch, int ndx)
 {
+  FAR struct bchlib_sector_s *entry = &bch->cache[ndx];
   FAR struct inode *inode;
+  FAR uint8_t *buffer;
   ssize_t ret = OK;
 
   /* Check if the sector has been modified and is out of synch with the
    * media.
    */
 
-  if (bch->dirty)
+  if (entry->dirty)
     {
-      inode = bch->inode;
+      inode  = bch->inode;
+      buffer = BCH_BUFFER(bch, ndx);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, buffer, entry->sector, CYPHER_ENCRYPT);
 #endif
 
       /* Write the sector to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode, buffer, entry->sector, 1);
       if (ret < 0)
         {
-          ferr("Write failed: %d\n");
+          ferr("Write failed: %d\n", (int)ret);
         }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -150,50 +147,298 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, buffer, entry->sector, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
 
-      bch->dirty = false;
+      entry->dirty = false;
+    }
+
+  return ret < 0 ? (int)ret : OK;
+}
+
+/****************************************************************************
+ * Name: bch_findsector
+ *
+ * Description:
+ *   Return the index of the cache entry holding the sector or -1 if the
+ *   sector is not cached.
+ *
+ ****************************************************************************/
+
+static int bch_findsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  int set = sector % BCH_NSETS;
+  int way;
+
+  for (way = 0; way < CONFIG_BCH_CACHE_NWAYS; way++)
+    {
+      if (bch->cache[BCH_INDEX(set, way)].sector == sector)
+        {
+          return BCH_INDEX(set, way);
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: bch_victim
+ *
+ * Description:
+ *   Select the way in the set to be replaced:  An unused entry if there is
+ *   one, otherwise the least recently used entry.
+ *
+ ****************************************************************************/
+
+static int bch_victim(FAR struct bchlib_s *bch, int set)
+{
+  FAR struct bchlib_sector_s *entry;
+  uint32_t oldest = 0;
+  int victim = 0;
+  int way;
+
+  for (way = 0; way < CONFIG_BCH_CACHE_NWAYS; way++)
+    {
+      entry = &bch->cache[BCH_INDEX(set, way)];
+      if (entry->sector == (size_t)-1)
+        {
+          return way;
+        }
+
+      /* Compare ages relative to the current time so that the comparison
+       * still works after the counter wraps.
+       */
+
+      if ((uint32_t)(bch->lru - entry->lru) > oldest)
+        {
+          oldest = bch->lru - entry->lru;
+          victim = way;
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush the current contents of the sector cache (if dirty)
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsector(FAR struct bchlib_s *bch)
+{
+  int result = OK;
+  int ret;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_BCH_CACHE_NSECTORS; ndx++)
+    {
+      ret = bch_flushentry(bch, ndx);
+      if (ret < 0 && result == OK)
+        {
+          result = ret;
+        }
     }
 
-  return (int)ret;
+  return result;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Flush any dirty cache entries holding sectors in the range
+ *   sector .. sector + nsectors - 1.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors)
+{
+  FAR struct bchlib_sector_s *entry;
+  int ret;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_BCH_CACHE_NSECTORS; ndx++)
+    {
+      entry = &bch->cache[ndx];
+      if (entry->dirty && entry->sector >= sector &&
+          entry->sector - sector < nsectors)
+        {
+          ret = bch_flushentry(bch, ndx);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Discard any cache entries holding sectors in the range
+ *   sector .. sector + nsectors - 1.  Used when those sectors are written
+ *   directly to the media so that stale data is not returned (or written
+ *   back) later.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors)
+{
+  FAR struct bchlib_sector_s *entry;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_BCH_CACHE_NSECTORS; ndx++)
+    {
+      entry = &bch->cache[ndx];
+      if (entry->sector >= sector && entry->sector - sector < nsectors)
+        {
+          entry->sector = (size_t)-1;
+          entry->dirty  = false;
+        }
+    }
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make sure that the sector is in the sector cache, replacing the least
+ *   recently used entry in its set (after flushing it, if dirty) if
+ *   necessary.  When the sector immediately follows the previously accessed
+ *   sector, the next CONFIG_BCH_CACHE_READAHEAD sectors are read in the same
+ *   transfer.
+ *
+ *   On success, the address of the cached sector data is returned in
+ *   'buffer' and the entry becomes the one marked by bchlib_dirtysector().
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
  *
  ****************************************************************************/
 
-int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector,
+                      FAR uint8_t **buffer)
 {
   FAR struct inode *inode;
-  ssize_t ret = OK;
-
-  if (bch->sector != sector)
+  FAR struct bchlib_sector_s *entry;
+  ssize_t ret;
+  size_t nread;
+  size_t i;
+  int ndx;
+  int set;
+
+  ndx = bch_findsector(bch, sector);
+  if (ndx < 0)
     {
       inode = bch->inode;
+      set   = sector % BCH_NSETS;
+      ndx   = BCH_INDEX(set, bch_victim(bch, set));
+      nread = 1;
+
+#if CONFIG_BCH_CACHE_READAHEAD > 0
+      /* On sequential access, also read the following sectors into the
+       * same way of the following sets.  Stop at the end of the cache
+       * memory, the end of the media, or at a sector that is already
+       * cached.
+       */
 
-      (void)bchlib_flushsector(bch);
-      bch->sector = (size_t)-1;
+      if (sector == bch->lastsector + 1)
+        {
+          while (nread <= CONFIG_BCH_CACHE_READAHEAD &&
+                 set + nread < BCH_NSETS &&
+                 sector + nread < bch->nsectors &&
+                 bch_findsector(bch, sector + nread) < 0)
+            {
+              nread++;
+            }
+        }
+#endif
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
+      /* Write back any dirty data in the entries that will be replaced */
+
+      for (i = 0; i < nread; i++)
+        {
+          ret = bch_flushentry(bch, ndx + i);
+          if (ret < 0)
+            {
+              return (int)ret;
+            }
+
+          bch->cache[ndx + i].sector = (size_t)-1;
+        }
+
+      ret = inode->u.i_bops->read(inode, BCH_BUFFER(bch, ndx), sector,
+                                  nread);
+      if (ret <= 0)
         {
-          ferr("Read failed: %d\n");
+          ferr("Read failed: %d\n", (int)ret);
+          return ret < 0 ? (int)ret : -EIO;
         }
-      bch->sector = sector;
+
+      /* The driver may have returned fewer sectors than requested */
+
+      nread = ret;
+      for (i = 0; i < nread; i++)
+        {
+          entry         = &bch->cache[ndx + i];
+          entry->sector = sector + i;
+          entry->dirty  = false;
+          entry->lru    = bch->lru;
+
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+          bch_cypher(bch, BCH_BUFFER(bch, ndx + i), sector + i,
+                     CYPHER_DECRYPT);
 #endif
+        }
     }
-  return (int)ret;
+
+  entry           = &bch->cache[ndx];
+  entry->lru      = ++bch->lru;
+  bch->current    = entry;
+  bch->lastsector = sector;
+
+  *buffer = BCH_BUFFER(bch, ndx);
+  return OK;
 }
 
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark the sector most recently returned by bchlib_readsector() as
+ *   modified.  It will be written back when it is replaced in the cache or
+ *   when the cache is flushed.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch)
+{
+  DEBUGASSERT(bch->current != NULL);
+  bch->current->dirty = true;
+}
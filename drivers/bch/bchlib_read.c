@@ -85,6 +85,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   bytesread;
+  FAR uint8_t *data;
   int      ret;
 
   /* Get rid of this special case right away */
@@ -111,9 +112,13 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
   bytesread = 0;
   if (sectoffset > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &data);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector to the user buffer */
 
@@ -126,7 +131,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, &data[sectoffset], nbytes);
 
       /* Adjust pointers and counts */
 
@@ -154,6 +159,16 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
           nsectors = bch->nsectors - sector;
         }
 
+      /* Any modified copies of these sectors in the cache must reach the
+       * media first.
+       */
+
+      ret = bchlib_flushrange(bch, sector, nsectors);
+      if (ret < 0)
+        {
+          return bytesread > 0 ? (ssize_t)bytesread : ret;
+        }
+
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
       if (ret < 0)
@@ -181,13 +196,17 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset, size_t le
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &data);
+      if (ret < 0)
+        {
+          return bytesread > 0 ? (ssize_t)bytesread : ret;
+        }
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, data, len);
 
       /* Adjust counts */
 
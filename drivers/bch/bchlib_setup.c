@@ -72,6 +72,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   FAR struct bchlib_s *bch;
   struct geometry geo;
   int ret;
+  int i;
 
   DEBUGASSERT(blkdev);
 
@@ -121,12 +122,18 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   sem_init(&bch->sem, 0, 1);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
-  /* Allocate the sector I/O buffer */
+  bch->lastsector = (size_t)-1;
+  for (i = 0; i < CONFIG_BCH_CACHE_NSECTORS; i++)
+    {
+      bch->cache[i].sector = (size_t)-1;
+    }
+
+  /* Allocate the sector cache memory */
 
-  bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
+  bch->buffer = (FAR uint8_t *)
+    kmm_malloc((size_t)bch->sectsize * CONFIG_BCH_CACHE_NSECTORS);
   if (!bch->buffer)
     {
       ferr("ERROR: Failed to allocate sector buffer\n");
@@ -73,6 +73,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
   uint16_t sectoffset;
   size_t   nbytes;
   size_t   byteswritten;
+  FAR uint8_t *data;
   int      ret;
 
   /* Get rid of this special case right away */
@@ -97,9 +98,13 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
   byteswritten = 0;
   if (sectoffset > 0)
     {
-      /* Read the full sector into the sector buffer */
+      /* Read the full sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &data);
+      if (ret < 0)
+        {
+          return ret;
+        }
 
       /* Copy the tail end of the sector from the user buffer */
 
@@ -112,8 +117,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(&data[sectoffset], buffer, nbytes);
+      bchlib_dirtysector(bch);
 
       /* Adjust pointers and counts */
 
@@ -141,6 +146,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+      /* Any cached copies of these sectors are about to become stale */
+
+      bchlib_invalidate(bch, sector, nsectors);
+
       /* Write the contiguous sectors */
 
       ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
@@ -170,20 +179,25 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 
   if (len > 0)
     {
-      /* Read the sector into the sector buffer */
+      /* Read the sector into the sector cache */
 
-      bchlib_readsector(bch, sector);
+      ret = bchlib_readsector(bch, sector, &data);
+      if (ret < 0)
+        {
+          return byteswritten > 0 ? (ssize_t)byteswritten : ret;
+        }
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(data, buffer, len);
+      bchlib_dirtysector(bch);
 
       /* Adjust counts */
 
       byteswritten += len;
     }
 
+#ifndef CONFIG_BCH_CACHE_WRITEBACK
   /* Finally, flush any cached writes to the device as well */
 
   ret = bchlib_flushsector(bch);
@@ -192,6 +206,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       ferr("ERROR: Flush failed: %d\n", ret);
       return ret;
     }
+#endif
 
   return byteswritten;
 }
@@ -0,0 +1,502 @@
+/****************************************************************************
+ * drivers/bioqueue.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/drivers/bioqueue.h>
+
+#ifdef CONFIG_DRVR_BIOQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_SCHED_WORKQUEUE
+#  error "Worker thread support is required (CONFIG_SCHED_WORKQUEUE)"
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bioq_semtake
+ ****************************************************************************/
+
+static void bioq_semtake(FAR sem_t *sem)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(sem) != 0)
+    {
+      /* The only case that an error should occur here is if
+       * the wait was awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+}
+
+/****************************************************************************
+ * Name: bioq_semgive
+ ****************************************************************************/
+
+#define bioq_semgive(s) sem_post(s)
+
+/****************************************************************************
+ * Name: bioq_conflict
+ *
+ * Description:
+ *   Return true if a request that was submitted before 'bio' and is still
+ *   pending overlaps it on the media and at least one of the two is a
+ *   write.  Such a request must be performed first.
+ *
+ ****************************************************************************/
+
+static bool bioq_conflict(FAR struct bioqueue_s *bioq,
+                          FAR struct bio_s *bio)
+{
+  FAR struct bio_s *curr;
+
+  for (curr = bioq->head; curr != NULL; curr = curr->bio_flink)
+    {
+      if ((int32_t)(bio->bio_seqno - curr->bio_seqno) > 0 &&
+          (bio->bio_op == BIO_WRITE || curr->bio_op == BIO_WRITE) &&
+          curr->bio_sector < bio->bio_sector + bio->bio_nsectors &&
+          bio->bio_sector < curr->bio_sector + curr->bio_nsectors)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: bioq_remove
+ *
+ * Description:
+ *   Remove 'bio' which follows 'prev' (NULL for the head) from the queue.
+ *
+ ****************************************************************************/
+
+static inline void bioq_remove(FAR struct bioqueue_s *bioq,
+                               FAR struct bio_s *prev,
+                               FAR struct bio_s *bio)
+{
+  if (prev != NULL)
+    {
+      prev->bio_flink = bio->bio_flink;
+    }
+  else
+    {
+      bioq->head = bio->bio_flink;
+    }
+}
+
+/****************************************************************************
+ * Name: bioq_next
+ *
+ * Description:
+ *   Remove the next request to be performed from the queue, together with
+ *   any requests that can be merged with it.  The requests are returned as
+ *   a list linked through bio_flink.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
+ *
+ ****************************************************************************/
+
+static FAR struct bio_s *bioq_next(FAR struct bioqueue_s *bioq)
+{
+  FAR struct bio_s *first = NULL;
+  FAR struct bio_s *last;
+  FAR struct bio_s *prev;
+  FAR struct bio_s *curr;
+  size_t nsectors;
+  int pass;
+
+  /* Take the first request at or beyond the position of the last transfer
+   * or, if there is none, wrap around to the lowest sector.  Skip requests
+   * that must wait for an earlier, overlapping request.  The oldest
+   * request never has to wait, so something is always found.
+   */
+
+  for (pass = 0; pass < 2 && first == NULL; pass++)
+    {
+      for (prev = NULL, curr = bioq->head;
+           curr != NULL;
+           prev = curr, curr = curr->bio_flink)
+        {
+          if ((pass > 0 || curr->bio_sector >= bioq->position) &&
+              !bioq_conflict(bioq, curr))
+            {
+              first = curr;
+              break;
+            }
+        }
+    }
+
+  if (first == NULL)
+    {
+      return NULL;
+    }
+
+  bioq_remove(bioq, prev, first);
+
+  /* Merge the following requests for as long as they continue the
+   * transfer both on the media and in memory.
+   */
+
+  last     = first;
+  nsectors = first->bio_nsectors;
+  curr     = prev != NULL ? prev->bio_flink : bioq->head;
+
+  while (curr != NULL && curr->bio_op == first->bio_op &&
+         curr->bio_sector == last->bio_sector + last->bio_nsectors &&
+         curr->bio_buffer == last->bio_buffer +
+                             last->bio_nsectors * bioq->sectorsize &&
+         (bioq->maxsectors == 0 ||
+          nsectors + curr->bio_nsectors <= bioq->maxsectors) &&
+         !bioq_conflict(bioq, curr))
+    {
+      bioq_remove(bioq, prev, curr);
+
+      last->bio_flink = curr;
+      last            = curr;
+      nsectors       += curr->bio_nsectors;
+      curr            = prev != NULL ? prev->bio_flink : bioq->head;
+    }
+
+  last->bio_flink = NULL;
+  return first;
+}
+
+/****************************************************************************
+ * Name: bioq_worker
+ *
+ * Description:
+ *   Perform all queued requests.  Runs on the low priority work queue.
+ *
+ ****************************************************************************/
+
+static void bioq_worker(FAR void *arg)
+{
+  FAR struct bioqueue_s *bioq = (FAR struct bioqueue_s *)arg;
+  FAR struct inode *inode = bioq->inode;
+  FAR struct bio_s *bio;
+  FAR struct bio_s *next;
+  unsigned int nsectors;
+  ssize_t remaining;
+  ssize_t ret;
+
+  bioq_semtake(&bioq->exclsem);
+  while ((bio = bioq_next(bioq)) != NULL)
+    {
+      for (nsectors = 0, next = bio; next != NULL; next = next->bio_flink)
+        {
+          nsectors += next->bio_nsectors;
+        }
+
+      bioq->position = bio->bio_sector + nsectors;
+      bioq_semgive(&bioq->exclsem);
+
+      /* Perform the (possibly merged) transfer */
+
+      if (bio->bio_op == BIO_WRITE)
+        {
+          ret = inode->u.i_bops->write(inode, bio->bio_buffer,
+                                       bio->bio_sector, nsectors);
+        }
+      else
+        {
+          ret = inode->u.i_bops->read(inode, bio->bio_buffer,
+                                      bio->bio_sector, nsectors);
+        }
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Transfer of %u sectors at %lu failed: %d\n",
+               nsectors, (unsigned long)bio->bio_sector, (int)ret);
+        }
+
+      /* Distribute the result over the merged requests and notify the
+       * submitters.  A request lying beyond the end of a short transfer
+       * fails with -EIO.
+       */
+
+      for (remaining = ret; bio != NULL; bio = next)
+        {
+          next = bio->bio_flink;
+
+          if (remaining < 0)
+            {
+              bio->bio_result = remaining;
+            }
+          else if (remaining == 0)
+            {
+              bio->bio_result = -EIO;
+            }
+          else
+            {
+              bio->bio_result = remaining < bio->bio_nsectors ?
+                                remaining : bio->bio_nsectors;
+              remaining      -= bio->bio_result;
+            }
+
+          bio->bio_flink = NULL;
+          bio->bio_callback(bio);
+        }
+
+      bioq_semtake(&bioq->exclsem);
+    }
+
+  bioq->busy = false;
+  bioq_semgive(&bioq->exclsem);
+}
+
+/****************************************************************************
+ * Name: bioq_synccallback
+ ****************************************************************************/
+
+static void bioq_synccallback(FAR struct bio_s *bio)
+{
+  bioq_semgive((FAR sem_t *)bio->bio_arg);
+}
+
+/****************************************************************************
+ * Name: bioq_transfer
+ *
+ * Description:
+ *   Submit one request and wait for it to complete.
+ *
+ ****************************************************************************/
+
+static ssize_t bioq_transfer(FAR struct bioqueue_s *bioq, uint8_t op,
+                             FAR uint8_t *buffer, size_t startsector,
+                             unsigned int nsectors)
+{
+  struct bio_s bio;
+  sem_t waitsem;
+  int ret;
+
+  sem_init(&waitsem, 0, 0);
+
+  bio.bio_op       = op;
+  bio.bio_buffer   = buffer;
+  bio.bio_sector   = startsector;
+  bio.bio_nsectors = nsectors;
+  bio.bio_callback = bioq_synccallback;
+  bio.bio_arg      = &waitsem;
+
+  ret = bioq_submit(bioq, &bio);
+  if (ret >= 0)
+    {
+      bioq_semtake(&waitsem);
+    }
+
+  sem_destroy(&waitsem);
+  return ret < 0 ? ret : bio.bio_result;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bioq_initialize
+ ****************************************************************************/
+
+int bioq_initialize(FAR struct bioqueue_s *bioq, FAR struct inode *inode,
+                    uint16_t maxsectors)
+{
+  struct geometry geo;
+  int ret;
+
+  DEBUGASSERT(bioq != NULL && inode != NULL);
+
+  if (inode->u.i_bops == NULL || inode->u.i_bops->read == NULL ||
+      inode->u.i_bops->geometry == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!geo.geo_available)
+    {
+      return -ENODEV;
+    }
+
+  bioq->inode      = inode;
+  bioq->nsectors   = geo.geo_nsectors;
+  bioq->sectorsize = geo.geo_sectorsize;
+  bioq->maxsectors = maxsectors;
+  bioq->busy       = false;
+  bioq->seqno      = 0;
+  bioq->position   = 0;
+  bioq->head       = NULL;
+
+  sem_init(&bioq->exclsem, 0, 1);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bioq_uninitialize
+ ****************************************************************************/
+
+void bioq_uninitialize(FAR struct bioqueue_s *bioq)
+{
+  DEBUGASSERT(bioq != NULL && bioq->head == NULL && !bioq->busy);
+  sem_destroy(&bioq->exclsem);
+}
+
+/****************************************************************************
+ * Name: bioq_submit
+ ****************************************************************************/
+
+int bioq_submit(FAR struct bioqueue_s *bioq, FAR struct bio_s *bio)
+{
+  FAR struct bio_s *prev;
+  FAR struct bio_s *curr;
+  int ret;
+
+  DEBUGASSERT(bioq != NULL && bio != NULL && bio->bio_callback != NULL);
+
+  /* Verify the request */
+
+  if (bio->bio_buffer == NULL || bio->bio_nsectors == 0 ||
+      bio->bio_sector >= bioq->nsectors ||
+      bio->bio_nsectors > bioq->nsectors - bio->bio_sector)
+    {
+      return -EINVAL;
+    }
+
+  if (bio->bio_op == BIO_WRITE)
+    {
+      if (bioq->inode->u.i_bops->write == NULL)
+        {
+          return -EACCES;
+        }
+    }
+  else if (bio->bio_op != BIO_READ)
+    {
+      return -EINVAL;
+    }
+
+  bioq_semtake(&bioq->exclsem);
+
+  /* Make sure that the worker will run.  It cannot remove anything from
+   * the queue until we release exclsem.
+   */
+
+  if (!bioq->busy)
+    {
+      ret = work_queue(LPWORK, &bioq->work, bioq_worker, bioq, 0);
+      if (ret < 0)
+        {
+          bioq_semgive(&bioq->exclsem);
+          return ret;
+        }
+
+      bioq->busy = true;
+    }
+
+  /* Insert the request in sector order, after any requests for the same
+   * sector.
+   */
+
+  bio->bio_seqno = bioq->seqno++;
+
+  for (prev = NULL, curr = bioq->head;
+       curr != NULL && curr->bio_sector <= bio->bio_sector;
+       prev = curr, curr = curr->bio_flink);
+
+  bio->bio_flink = curr;
+  if (prev != NULL)
+    {
+      prev->bio_flink = bio;
+    }
+  else
+    {
+      bioq->head = bio;
+    }
+
+  bioq_semgive(&bioq->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bioq_read
+ ****************************************************************************/
+
+ssize_t bioq_read(FAR struct bioqueue_s *bioq, FAR uint8_t *buffer,
+                  size_t startsector, unsigned int nsectors)
+{
+  return bioq_transfer(bioq, BIO_READ, buffer, startsector, nsectors);
+}
+
+/****************************************************************************
+ * Name: bioq_write
+ ****************************************************************************/
+
+ssize_t bioq_write(FAR struct bioqueue_s *bioq, FAR const uint8_t *buffer,
+                   size_t startsector, unsigned int nsectors)
+{
+  return bioq_transfer(bioq, BIO_WRITE, (FAR uint8_t *)buffer, startsector,
+                       nsectors);
+}
+
+#endif /* CONFIG_DRVR_BIOQUEUE */
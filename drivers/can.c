@@ -54,6 +54,10 @@
 #include <errno.h>
 #include <debug.h>
 
+#ifdef CONFIG_CAN_TIMESTAMP
+#  include <time.h>
+#endif
+
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
 #include <nuttx/drivers/can.h>
@@ -105,6 +109,14 @@
 #define HALF_SECOND_MSEC 500
 #define HALF_SECOND_USEC 500000L
 
+/* The clock used for receive time stamps */
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+#  define CAN_TIMESTAMP_CLOCK CLOCK_MONOTONIC
+#else
+#  define CAN_TIMESTAMP_CLOCK CLOCK_REALTIME
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -122,9 +134,9 @@ static void           can_pollnotify(FAR struct can_dev_s *dev,
 
 /* CAN helpers */
 
-static uint8_t        can_dlc2bytes(uint8_t dlc);
-#if 0 /* Not used */
-static uint8_t        can_bytes2dlc(uint8_t nbytes);
+static inline uint8_t can_msgbytes(FAR const struct can_hdr_s *hdr);
+#ifdef CONFIG_CAN_TIMESTAMP
+static inline void    can_timestamp(FAR struct can_hdr_s *hdr);
 #endif
 #ifdef CONFIG_CAN_TXREADY
 static void           can_txready_work(FAR void *arg);
@@ -231,114 +243,48 @@ static void can_pollnotify(FAR struct can_dev_s *dev, pollevent_t eventset)
 #endif
 
 /****************************************************************************
- * Name: can_dlc2bytes
+ * Name: can_msgbytes
  *
  * Description:
- *   In the CAN FD format, the coding of the DLC differs from the standard
- *   CAN format. The DLC codes 0 to 8 have the same coding as in standard
- *   CAN.  But the codes 9 to 15 all imply a data field of 8 bytes with
- *   standard CAN.  In CAN FD mode, the values 9 to 15 are encoded to values
- *   in the range 12 to 64.
- *
- * Input Parameter:
- *   dlc    - the DLC value to convert to a byte count
- *
- * Returned Value:
- *   The number of bytes corresponding to the DLC value.
+ *   Return the size of the data field of a CAN message.  DLC values greater
+ *   than 8 are encoded only in CAN FD messages;  otherwise they imply a data
+ *   field of 8 bytes as in standard CAN.
  *
  ****************************************************************************/
 
-static uint8_t can_dlc2bytes(uint8_t dlc)
+static inline uint8_t can_msgbytes(FAR const struct can_hdr_s *hdr)
 {
-  if (dlc > 8)
-    {
 #ifdef CONFIG_CAN_FD
-      switch (dlc)
-        {
-          case 9:
-            return 12;
-          case 10:
-            return 16;
-          case 11:
-            return 20;
-          case 12:
-            return 24;
-          case 13:
-            return 32;
-          case 14:
-            return 48;
-          default:
-          case 15:
-            return 64;
-        }
-#else
+  if (!hdr->ch_edl && hdr->ch_dlc > 8)
+    {
       return 8;
-#endif
     }
+#endif
 
-  return dlc;
+  return can_dlc2bytes(hdr->ch_dlc);
 }
 
 /****************************************************************************
- * Name: can_bytes2dlc
+ * Name: can_timestamp
  *
  * Description:
- *   In the CAN FD format, the coding of the DLC differs from the standard
- *   CAN format. The DLC codes 0 to 8 have the same coding as in standard
- *   CAN.  But the codes 9 to 15 all imply a data field of 8 bytes with
- *   standard CAN.  In CAN FD mode, the values 9 to 15 are encoded to values
- *   in the range 12 to 64.
- *
- * Input Parameter:
- *   nbytes - the byte count to convert to a DLC value
- *
- * Returned Value:
- *   The encoded DLC value corresponding to at least that number of bytes.
+ *   Time stamp a received message.  This is called from the
+ *   CAN interrupt handler (via can_receive()).
  *
  ****************************************************************************/
 
-#if 0 /* Not used */
-static uint8_t can_bytes2dlc(FAR struct sam_can_s *priv, uint8_t nbytes)
+#ifdef CONFIG_CAN_TIMESTAMP
+static inline void can_timestamp(FAR struct can_hdr_s *hdr)
 {
-  if (nbytes <= 8)
-    {
-      return nbytes;
-    }
-#ifdef CONFIG_CAN_FD
-  else if (nbytes <= 12)
-    {
-      return 9;
-    }
-  else if (nbytes <= 16)
-    {
-      return 10;
-    }
-  else if (nbytes <= 20)
-    {
-      return 11;
-    }
-  else if (nbytes <= 24)
-    {
-      return 12;
-    }
-  else if (nbytes <= 32)
-    {
-      return 13;
-    }
-  else if (nbytes <= 48)
-    {
-      return 14;
-    }
-  else /* if (nbytes <= 64) */
-    {
-      return 15;
-    }
-#else
-  else
-    {
-      return 8;
-    }
-#endif
+  struct timespec ts;
+
+  /* The header is packed, so the time stamp may not be aligned.  Only
+   * access it through the header.
+   */
+
+  (void)clock_gettime(CAN_TIMESTAMP_CLOCK, &ts);
+  hdr->ch_ts.tv_sec  = ts.tv_sec;
+  hdr->ch_ts.tv_usec = ts.tv_nsec / 1000;
 }
 #endif
 
@@ -649,7 +595,7 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
           /* Will the next message in the FIFO fit into the user buffer? */
 
           FAR struct can_msg_s *msg = &dev->cd_recv.rx_buffer[dev->cd_recv.rx_head];
-          int nbytes = can_dlc2bytes(msg->cm_hdr.ch_dlc);
+          int nbytes = can_msgbytes(&msg->cm_hdr);
           int msglen = CAN_MSGLEN(nbytes);
 
           if (nread + msglen > buflen)
@@ -864,7 +810,7 @@ static ssize_t can_write(FAR struct file *filep, FAR const char *buffer,
        */
 
       msg    = (FAR struct can_msg_s *)&buffer[nsent];
-      nbytes = can_dlc2bytes(msg->cm_hdr.ch_dlc);
+      nbytes = can_msgbytes(&msg->cm_hdr);
       msglen = CAN_MSGLEN(nbytes);
       memcpy(&fifo->tx_buffer[fifo->tx_tail], msg, msglen);
 
@@ -1144,6 +1090,116 @@ errout:
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: can_dlc2bytes
+ *
+ * Description:
+ *   In the CAN FD format, the coding of the DLC differs from the standard
+ *   CAN format. The DLC codes 0 to 8 have the same coding as in standard
+ *   CAN.  But the codes 9 to 15 all imply a data field of 8 bytes with
+ *   standard CAN.  In CAN FD mode, the values 9 to 15 are encoded to values
+ *   in the range 12 to 64.
+ *
+ * Input Parameter:
+ *   dlc    - the DLC value to convert to a byte count
+ *
+ * Returned Value:
+ *   The number of bytes corresponding to the DLC value.
+ *
+ ****************************************************************************/
+
+uint8_t can_dlc2bytes(uint8_t dlc)
+{
+  if (dlc > 8)
+    {
+#ifdef CONFIG_CAN_FD
+      switch (dlc)
+        {
+          case 9:
+            return 12;
+          case 10:
+            return 16;
+          case 11:
+            return 20;
+          case 12:
+            return 24;
+          case 13:
+            return 32;
+          case 14:
+            return 48;
+          default:
+          case 15:
+            return 64;
+        }
+#else
+      return 8;
+#endif
+    }
+
+  return dlc;
+}
+
+/****************************************************************************
+ * Name: can_bytes2dlc
+ *
+ * Description:
+ *   In the CAN FD format, the coding of the DLC differs from the standard
+ *   CAN format. The DLC codes 0 to 8 have the same coding as in standard
+ *   CAN.  But the codes 9 to 15 all imply a data field of 8 bytes with
+ *   standard CAN.  In CAN FD mode, the values 9 to 15 are encoded to values
+ *   in the range 12 to 64.
+ *
+ * Input Parameter:
+ *   nbytes - the byte count to convert to a DLC value
+ *
+ * Returned Value:
+ *   The encoded DLC value corresponding to at least that number of bytes.
+ *
+ ****************************************************************************/
+
+uint8_t can_bytes2dlc(uint8_t nbytes)
+{
+  if (nbytes <= 8)
+    {
+      return nbytes;
+    }
+#ifdef CONFIG_CAN_FD
+  else if (nbytes <= 12)
+    {
+      return 9;
+    }
+  else if (nbytes <= 16)
+    {
+      return 10;
+    }
+  else if (nbytes <= 20)
+    {
+      return 11;
+    }
+  else if (nbytes <= 24)
+    {
+      return 12;
+    }
+  else if (nbytes <= 32)
+    {
+      return 13;
+    }
+  else if (nbytes <= 48)
+    {
+      return 14;
+    }
+  else /* if (nbytes <= 64) */
+    {
+      return 15;
+    }
+#else
+  else
+    {
+      return 8;
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: can_register
  *
@@ -1256,7 +1312,7 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
               memcpy(&msg->cm_hdr, hdr, sizeof(struct can_hdr_s));
 
-              nbytes = can_dlc2bytes(hdr->ch_dlc);
+              nbytes = can_msgbytes(hdr);
               for (i = 0, dest = msg->cm_data; i < nbytes; i++)
                 {
                   *dest++ = *data++;
@@ -1278,21 +1334,23 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
 
   if (nexttail != fifo->rx_head)
     {
+      bool wasempty = (fifo->rx_head == fifo->rx_tail);
       int nbytes;
 
-      /* Add the new, decoded CAN message at the tail of the FIFO.
-       *
-       * REVISIT:  In the CAN FD format, the coding of the DLC differs from
-       * the standard CAN format. The DLC codes 0 to 8 have the same coding
-       * as in standard CAN, the codes 9 to 15, which in standard CAN all
-       * code a data field of 8 bytes, are encoded:
-       *
-       *   9->12, 10->16, 11->20, 12->24, 13->32, 14->48, 15->64
+      /* Add the new, decoded CAN message at the tail of the FIFO.  In the
+       * CAN FD format, the DLC codes 9 to 15 are encoded (see
+       * can_msgbytes()).
        */
 
       memcpy(&fifo->rx_buffer[fifo->rx_tail].cm_hdr, hdr, sizeof(struct can_hdr_s));
 
-      nbytes = can_dlc2bytes(hdr->ch_dlc);
+#ifdef CONFIG_CAN_TIMESTAMP
+      /* Record the time of reception */
+
+      can_timestamp(&fifo->rx_buffer[fifo->rx_tail].cm_hdr);
+#endif
+
+      nbytes = can_msgbytes(hdr);
       for (i = 0, dest = fifo->rx_buffer[fifo->rx_tail].cm_data; i < nbytes; i++)
         {
           *dest++ = *data++;
@@ -1315,10 +1373,16 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
       errcode = OK;
 
       /* Notify all poll/select waiters that they can read from the
-       * cd_recv buffer
+       * cd_recv buffer.  A poll that is set up while the buffer is not
+       * empty returns immediately, so waiters need to be notified only
+       * when the buffer becomes non-empty.  This avoids scanning the poll
+       * waiters for every message of a burst.
        */
 
-      can_pollnotify(dev, POLLIN);
+      if (wasempty)
+        {
+          can_pollnotify(dev, POLLIN);
+        }
     }
 #ifdef CONFIG_CAN_ERRORS
   else
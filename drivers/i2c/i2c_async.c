@@ -0,0 +1,388 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/i2c/i2c_master.h>
+#include <nuttx/i2c/i2c_async.h>
+
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC_HPWORK
+#  define I2C_ASYNC_WORK HPWORK
+#else
+#  define I2C_ASYNC_WORK LPWORK
+#endif
+
+/* Get the request from its periodic schedule entry */
+
+#define I2C_SCHEDULE_REQ(e) \
+  ((FAR struct i2c_request_s *) \
+   ((FAR uint8_t *)(e) - offsetof(struct i2c_request_s, schedule)))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_complete
+ ****************************************************************************/
+
+static void i2c_async_complete(FAR struct i2c_request_s *req, int result)
+{
+  req->queued = false;
+  if (req->callback != NULL)
+    {
+      req->callback(req, result);
+    }
+}
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Transfer all pending requests.  Consecutive requests are merged into a
+ *   single I2C transfer as long as their messages fit in the merge buffer,
+ *   so the bus goes from one request to the next with a repeated START
+ *   rather than an idle gap.  If a merged transfer fails, the failing
+ *   request cannot be identified and all of the merged requests complete
+ *   with the error.
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_async_s *bus = (FAR struct i2c_async_s *)arg;
+  FAR struct i2c_request_s *req;
+  sq_queue_t batch;
+  irqstate_t flags;
+  int nmsgs;
+  int ret;
+
+  while (sem_wait(&bus->exclsem) < 0)
+    {
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+
+  for (; ; )
+    {
+      /* Take as many pending requests as fit into one transfer */
+
+      sq_init(&batch);
+      nmsgs = 0;
+
+      flags = enter_critical_section();
+      while ((req = (FAR struct i2c_request_s *)sq_peek(&bus->pending)) != NULL)
+        {
+          if (nmsgs > 0 && nmsgs + req->count > CONFIG_I2C_ASYNC_MAXMSGS)
+            {
+              break;
+            }
+
+          (void)sq_remfirst(&bus->pending);
+          sq_addlast(&req->entry, &batch);
+          nmsgs += req->count;
+        }
+
+      leave_critical_section(flags);
+
+      req = (FAR struct i2c_request_s *)sq_peek(&batch);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      if (sq_next(&req->entry) == NULL)
+        {
+          /* A single request is transferred directly */
+
+          ret = I2C_TRANSFER(bus->dev, req->msgs, req->count);
+        }
+      else
+        {
+          /* Merge the messages of all of the requests */
+
+          nmsgs = 0;
+          for (; req != NULL;
+               req = (FAR struct i2c_request_s *)sq_next(&req->entry))
+            {
+              memcpy(&bus->msgs[nmsgs], req->msgs,
+                     req->count * sizeof(struct i2c_msg_s));
+              nmsgs += req->count;
+            }
+
+          ret = I2C_TRANSFER(bus->dev, bus->msgs, nmsgs);
+        }
+
+      if (ret < 0)
+        {
+          i2cerr("ERROR: I2C transfer failed: %d\n", ret);
+        }
+      else
+        {
+          ret = OK;
+        }
+
+      /* Notify the requesters */
+
+      while ((req = (FAR struct i2c_request_s *)sq_remfirst(&batch)) != NULL)
+        {
+          i2c_async_complete(req, ret);
+        }
+    }
+
+  sem_post(&bus->exclsem);
+}
+
+/****************************************************************************
+ * Name: i2c_async_cycle
+ *
+ * Description:
+ *   Start a periodic bus cycle:  Queue the scheduled requests that are due
+ *   in this cycle and transfer them together with any other pending
+ *   requests.
+ *
+ ****************************************************************************/
+
+static void i2c_async_cycle(FAR void *arg)
+{
+  FAR struct i2c_async_s *bus = (FAR struct i2c_async_s *)arg;
+  FAR struct i2c_request_s *req;
+  FAR sq_entry_t *entry;
+  irqstate_t flags;
+  systime_t delay;
+  systime_t now;
+
+  flags = enter_critical_section();
+  for (entry = sq_peek(&bus->periodic); entry; entry = sq_next(entry))
+    {
+      req = I2C_SCHEDULE_REQ(entry);
+      if (--req->countdown == 0)
+        {
+          req->countdown = req->divider;
+
+          /* If the previous transfer of the request has not completed,
+           * this cycle is skipped for the request.
+           */
+
+          if (!req->queued)
+            {
+              req->queued = true;
+              sq_addlast(&req->entry, &bus->pending);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+
+  /* Schedule the next cycle relative to this one so that the cycles do not
+   * drift.  If we have fallen behind, start over from the current time.
+   */
+
+  if (bus->period > 0)
+    {
+      bus->next += bus->period;
+      now        = clock_systimer();
+
+      if ((int32_t)(bus->next - now) > 0)
+        {
+          delay = bus->next - now;
+        }
+      else
+        {
+          bus->next = now;
+          delay     = 0;
+        }
+
+      (void)work_queue(I2C_ASYNC_WORK, &bus->cycle, i2c_async_cycle, bus,
+                       delay);
+    }
+
+  i2c_async_worker(bus);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_initialize
+ *
+ * Description:
+ *   Initialize the asynchronous transfer state of an I2C bus.  There should
+ *   be one instance for each bus.
+ *
+ ****************************************************************************/
+
+void i2c_async_initialize(FAR struct i2c_async_s *bus,
+                          FAR struct i2c_master_s *dev)
+{
+  DEBUGASSERT(bus != NULL && dev != NULL);
+
+  memset(bus, 0, sizeof(struct i2c_async_s));
+  bus->dev = dev;
+  sq_init(&bus->pending);
+  sq_init(&bus->periodic);
+  sem_init(&bus->exclsem, 0, 1);
+}
+
+/****************************************************************************
+ * Name: i2c_async_transfer
+ *
+ * Description:
+ *   Queue a request for transfer.  This function does not wait for the
+ *   transfer; the callback of the request is called on the work queue when
+ *   the transfer has completed.
+ *
+ ****************************************************************************/
+
+int i2c_async_transfer(FAR struct i2c_async_s *bus,
+                       FAR struct i2c_request_s *req)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(bus != NULL && req != NULL && req->count > 0);
+
+  flags = enter_critical_section();
+  if (req->queued)
+    {
+      leave_critical_section(flags);
+      return -EBUSY;
+    }
+
+  req->queued = true;
+  sq_addlast(&req->entry, &bus->pending);
+  leave_critical_section(flags);
+
+  if (work_available(&bus->work))
+    {
+      return work_queue(I2C_ASYNC_WORK, &bus->work, i2c_async_worker, bus,
+                        0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: i2c_async_schedule
+ *
+ * Description:
+ *   Add a request to the periodic schedule of the bus.
+ *
+ ****************************************************************************/
+
+void i2c_async_schedule(FAR struct i2c_async_s *bus,
+                        FAR struct i2c_request_s *req)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(bus != NULL && req != NULL && req->divider > 0);
+
+  flags          = enter_critical_section();
+  req->countdown = req->divider;
+  sq_addlast(&req->schedule, &bus->periodic);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: i2c_async_unschedule
+ *
+ * Description:
+ *   Remove a request from the periodic schedule of the bus.
+ *
+ ****************************************************************************/
+
+void i2c_async_unschedule(FAR struct i2c_async_s *bus,
+                          FAR struct i2c_request_s *req)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(bus != NULL && req != NULL);
+
+  flags = enter_critical_section();
+  sq_rem(&req->schedule, &bus->periodic);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: i2c_async_start
+ *
+ * Description:
+ *   Start (or change the period of) the periodic bus cycles.  A period of
+ *   zero stops the cycles.
+ *
+ ****************************************************************************/
+
+int i2c_async_start(FAR struct i2c_async_s *bus, systime_t period)
+{
+  DEBUGASSERT(bus != NULL);
+
+  (void)work_cancel(I2C_ASYNC_WORK, &bus->cycle);
+
+  bus->period = period;
+  if (period == 0)
+    {
+      return OK;
+    }
+
+  /* The first cycle starts now */
+
+  bus->next = clock_systimer();
+  return work_queue(I2C_ASYNC_WORK, &bus->cycle, i2c_async_cycle, bus, 0);
+}
+
+#endif /* CONFIG_I2C_ASYNC */
@@ -0,0 +1,677 @@
+/****************************************************************************
+ * drivers/input/touchscreen_upper.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/* This file provides a common upper half for touchscreen drivers.  The
+ * lower half driver reports touch points with touch_event(); the upper half
+ * queues them and exports the standard touchscreen character driver
+ * interface described in include/nuttx/input/touchscreen.h.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/input/touchscreen.h>
+
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TOUCH_NEVENTS CONFIG_INPUT_TOUCHSCREEN_NEVENTS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure provides the state of one touchscreen upper half driver */
+
+struct touch_upperhalf_s
+{
+  /* Saved binding to the lower half touchscreen driver */
+
+  FAR struct touch_lowerhalf_s *tu_lower;
+
+  uint8_t tu_crefs;           /* Number of times the device has been opened */
+  uint8_t tu_nwaiters;        /* Number of threads waiting for events */
+  uint8_t tu_head;            /* Index of the next event to be queued */
+  uint8_t tu_tail;            /* Index of the oldest queued event */
+  uint8_t tu_nevents;         /* Number of queued events */
+  sem_t tu_exclsem;           /* Supports exclusive access to the device */
+  sem_t tu_waitsem;           /* Used to wait for the availability of events */
+
+  /* Queued touch events (a circular buffer) */
+
+  struct touch_point_s tu_events[TOUCH_NEVENTS];
+
+#ifndef CONFIG_DISABLE_POLL
+  /* The following is a list if poll structures of threads waiting for
+   * driver events.
+   */
+
+  FAR struct pollfd *tu_fds[CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Semaphore helpers */
+
+static inline int touch_takesem(sem_t *sem);
+#define touch_givesem(s) sem_post(s);
+
+static void    touch_notify(FAR struct touch_upperhalf_s *priv);
+
+/* Character driver methods */
+
+static int     touch_open(FAR struct file *filep);
+static int     touch_close(FAR struct file *filep);
+static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen);
+static int     touch_ioctl(FAR struct file *filep, int cmd,
+                           unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations touch_fops =
+{
+  touch_open,  /* open */
+  touch_close, /* close */
+  touch_read,  /* read */
+  0,           /* write */
+  0,           /* seek */
+  touch_ioctl  /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , touch_poll /* poll */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: touch_takesem
+ ****************************************************************************/
+
+static inline int touch_takesem(sem_t *sem)
+{
+  /* Take a count from the semaphore, possibly waiting */
+
+  if (sem_wait(sem) < 0)
+    {
+      /* EINTR is the only error that we expect */
+
+      int errcode = get_errno();
+      DEBUGASSERT(errcode == EINTR);
+      return -errcode;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: touch_notify
+ *
+ * Description:
+ *   Wake up readers and pollers when the event queue becomes non-empty.
+ *   Must be called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void touch_notify(FAR struct touch_upperhalf_s *priv)
+{
+#ifndef CONFIG_DISABLE_POLL
+  int i;
+#endif
+
+  /* If there are threads waiting for read data, then signal one of them
+   * that the read data is available.
+   */
+
+  if (priv->tu_nwaiters > 0)
+    {
+      touch_givesem(&priv->tu_waitsem);
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  /* If there are threads waiting on poll(), then wake them all up */
+
+  for (i = 0; i < CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS; i++)
+    {
+      FAR struct pollfd *fds = priv->tu_fds[i];
+      if (fds)
+        {
+          fds->revents |= (fds->events & POLLIN);
+          if (fds->revents != 0)
+            {
+              iinfo("Report events: %02x\n", fds->revents);
+              sem_post(fds->sem);
+            }
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: touch_open
+ ****************************************************************************/
+
+static int touch_open(FAR struct file *filep)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  FAR struct touch_lowerhalf_s *lower;
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(filep && filep->f_inode);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+
+  /* Get exclusive access to the driver structure */
+
+  ret = touch_takesem(&priv->tu_exclsem);
+  if (ret < 0)
+    {
+      ierr("ERROR: touch_takesem failed: %d\n", ret);
+      return ret;
+    }
+
+  if (priv->tu_crefs >= 255)
+    {
+      ret = -EMFILE;
+      goto errout_with_sem;
+    }
+
+  if (priv->tu_crefs == 0)
+    {
+      /* Discard any events queued while the device was closed */
+
+      flags = enter_critical_section();
+      priv->tu_head    = 0;
+      priv->tu_tail    = 0;
+      priv->tu_nevents = 0;
+      leave_critical_section(flags);
+
+      /* Let the lower half know that the device is in use */
+
+      lower = priv->tu_lower;
+      if (lower->tl_open)
+        {
+          ret = lower->tl_open(lower);
+          if (ret < 0)
+            {
+              goto errout_with_sem;
+            }
+        }
+    }
+
+  priv->tu_crefs++;
+  ret = OK;
+
+errout_with_sem:
+  touch_givesem(&priv->tu_exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_close
+ ****************************************************************************/
+
+static int touch_close(FAR struct file *filep)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  FAR struct touch_lowerhalf_s *lower;
+  int ret;
+
+  DEBUGASSERT(filep && filep->f_inode);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+
+  /* Get exclusive access to the driver structure */
+
+  ret = touch_takesem(&priv->tu_exclsem);
+  if (ret < 0)
+    {
+      ierr("ERROR: touch_takesem failed: %d\n", ret);
+      return ret;
+    }
+
+  DEBUGASSERT(priv->tu_crefs > 0);
+  if (--priv->tu_crefs == 0)
+    {
+      /* Let the lower half know that the device is no longer in use */
+
+      lower = priv->tu_lower;
+      if (lower->tl_close)
+        {
+          ret = lower->tl_close(lower);
+        }
+    }
+
+  touch_givesem(&priv->tu_exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_read
+ ****************************************************************************/
+
+static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  FAR struct touch_sample_s *report;
+  irqstate_t flags;
+  size_t nsamples;
+  size_t n;
+  int ret;
+
+  DEBUGASSERT(filep && filep->f_inode);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+
+  /* Make sure that the buffer is sufficiently large to hold at least one
+   * complete sample.  Each event is returned as a separate single point
+   * struct touch_sample_s.
+   */
+
+  nsamples = buflen / sizeof(struct touch_sample_s);
+  if (nsamples < 1)
+    {
+      ierr("ERROR: Unsupported read size: %lu\n", (unsigned long)buflen);
+      return -ENOSYS;
+    }
+
+  /* Interrupts are disabled so that the event queue does not change while
+   * it is examined.  If there are no events, then wait for one.
+   */
+
+  flags = enter_critical_section();
+  while (priv->tu_nevents == 0)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      priv->tu_nwaiters++;
+      ret = touch_takesem(&priv->tu_waitsem);
+      priv->tu_nwaiters--;
+
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  /* Return as many of the queued events as will fit in the user buffer */
+
+  report = (FAR struct touch_sample_s *)buffer;
+  for (n = 0; n < nsamples && priv->tu_nevents > 0; n++)
+    {
+      report[n].npoints = 1;
+      memcpy(&report[n].point[0], &priv->tu_events[priv->tu_tail],
+             sizeof(struct touch_point_s));
+
+      if (++priv->tu_tail >= TOUCH_NEVENTS)
+        {
+          priv->tu_tail = 0;
+        }
+
+      priv->tu_nevents--;
+    }
+
+  leave_critical_section(flags);
+  return (ssize_t)(n * sizeof(struct touch_sample_s));
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_ioctl
+ ****************************************************************************/
+
+static int touch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  FAR struct touch_lowerhalf_s *lower;
+  int ret;
+
+  DEBUGASSERT(filep && filep->f_inode);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+
+  /* Get exclusive access to the driver structure */
+
+  ret = touch_takesem(&priv->tu_exclsem);
+  if (ret < 0)
+    {
+      ierr("ERROR: touch_takesem failed: %d\n", ret);
+      return ret;
+    }
+
+  /* All ioctl commands are device specific and are forwarded to the lower
+   * half driver.
+   */
+
+  lower = priv->tu_lower;
+  if (lower->tl_control)
+    {
+      ret = lower->tl_control(lower, cmd, arg);
+    }
+  else
+    {
+      ret = -ENOTTY;
+    }
+
+  touch_givesem(&priv->tu_exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: touch_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode;
+  FAR struct touch_upperhalf_s *priv;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  DEBUGASSERT(filep && filep->f_inode);
+  inode = filep->f_inode;
+  DEBUGASSERT(inode->i_private);
+  priv  = (FAR struct touch_upperhalf_s *)inode->i_private;
+
+  /* Get exclusive access to the driver structure */
+
+  ret = touch_takesem(&priv->tu_exclsem);
+  if (ret < 0)
+    {
+      ierr("ERROR: touch_takesem failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Are we setting up the poll?  Or tearing it down? */
+
+  if (setup)
+    {
+      /* This is a request to set up the poll.  Find an available
+       * slot for the poll structure reference
+       */
+
+      for (i = 0; i < CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS; i++)
+        {
+          /* Find an available slot */
+
+          if (!priv->tu_fds[i])
+            {
+              /* Bind the poll structure and this slot */
+
+              priv->tu_fds[i] = fds;
+              fds->priv       = &priv->tu_fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_INPUT_TOUCHSCREEN_NPOLLWAITERS)
+        {
+          ierr("ERROR: Too many poll waiters\n");
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto errout_with_sem;
+        }
+
+      /* Should we immediately notify on any of the requested events? */
+
+      flags = enter_critical_section();
+      if (priv->tu_nevents > 0)
+        {
+          touch_notify(priv);
+        }
+
+      leave_critical_section(flags);
+    }
+  else if (fds->priv)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+      DEBUGASSERT(slot != NULL);
+
+      /* Remove all memory of the poll setup */
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+errout_with_sem:
+  touch_givesem(&priv->tu_exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: touch_event
+ *
+ * Description:
+ *   Queue one touch point reported by the lower half driver and notify any
+ *   waiting readers.  May be called from interrupt level.
+ *
+ *   If CONFIG_INPUT_TOUCHSCREEN_COALESCE is selected, a TOUCH_MOVE event
+ *   replaces a TOUCH_MOVE of the same contact that has not yet been read.
+ *   If the queue is full, the oldest event is discarded.
+ *
+ ****************************************************************************/
+
+void touch_event(FAR struct touch_lowerhalf_s *lower,
+                 FAR const struct touch_point_s *point)
+{
+  FAR struct touch_upperhalf_s *priv;
+  irqstate_t flags;
+
+  DEBUGASSERT(lower && lower->tl_priv && point);
+  priv = (FAR struct touch_upperhalf_s *)lower->tl_priv;
+
+  flags = enter_critical_section();
+
+#ifdef CONFIG_INPUT_TOUCHSCREEN_COALESCE
+  /* If the most recently queued event has not been read and is movement of
+   * the same contact, just update its position.  Readers have already been
+   * notified.
+   */
+
+  if (priv->tu_nevents > 0 && (point->flags & TOUCH_MOVE) != 0)
+    {
+      FAR struct touch_point_s *last;
+      int index;
+
+      index = (priv->tu_head > 0 ? priv->tu_head : TOUCH_NEVENTS) - 1;
+      last  = &priv->tu_events[index];
+
+      if ((last->flags & TOUCH_MOVE) != 0 && last->id == point->id)
+        {
+          memcpy(last, point, sizeof(struct touch_point_s));
+          leave_critical_section(flags);
+          return;
+        }
+    }
+#endif
+
+  /* If the queue is full, discard the oldest event */
+
+  if (priv->tu_nevents >= TOUCH_NEVENTS)
+    {
+      iwarn("WARNING: Touch event queue overrun\n");
+
+      if (++priv->tu_tail >= TOUCH_NEVENTS)
+        {
+          priv->tu_tail = 0;
+        }
+
+      priv->tu_nevents--;
+    }
+
+  /* Add the new event to the queue */
+
+  memcpy(&priv->tu_events[priv->tu_head], point,
+         sizeof(struct touch_point_s));
+
+  if (++priv->tu_head >= TOUCH_NEVENTS)
+    {
+      priv->tu_head = 0;
+    }
+
+  /* Readers only need to be woken when the queue becomes non-empty; once
+   * awake, a reader collects all queued events in one read().
+   */
+
+  if (++priv->tu_nevents == 1)
+    {
+      touch_notify(priv);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: touch_register
+ *
+ * Description:
+ *   Bind a touchscreen lower half driver to a new instance of the common
+ *   touchscreen upper half driver and register the composite character
+ *   driver at 'devpath' (for example, "/dev/input0").
+ *
+ * Input Parameters:
+ *   lower   - The lower half driver instance.  lower->tl_priv is set here.
+ *   devpath - The device path to register.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int touch_register(FAR struct touch_lowerhalf_s *lower,
+                   FAR const char *devpath)
+{
+  FAR struct touch_upperhalf_s *priv;
+  int ret;
+
+  DEBUGASSERT(lower && devpath);
+
+  /* Allocate a new touchscreen driver instance */
+
+  priv = (FAR struct touch_upperhalf_s *)
+    kmm_zalloc(sizeof(struct touch_upperhalf_s));
+
+  if (!priv)
+    {
+      ierr("ERROR: Failed to allocate device structure\n");
+      return -ENOMEM;
+    }
+
+  /* Initialize the new touchscreen driver instance */
+
+  priv->tu_lower = lower;
+  sem_init(&priv->tu_exclsem, 0, 1);
+  sem_init(&priv->tu_waitsem, 0, 0);
+
+  lower->tl_priv = priv;
+
+  /* And register the touchscreen driver */
+
+  ret = register_driver(devpath, &touch_fops, 0444, priv);
+  if (ret < 0)
+    {
+      ierr("ERROR: register_driver failed: %d\n", ret);
+      goto errout_with_priv;
+    }
+
+  return OK;
+
+errout_with_priv:
+  lower->tl_priv = NULL;
+  sem_destroy(&priv->tu_exclsem);
+  sem_destroy(&priv->tu_waitsem);
+  kmm_free(priv);
+  return ret;
+}
+
+#endif /* CONFIG_INPUT_TOUCHSCREEN */
@@ -49,6 +49,7 @@
 #include <debug.h>
 
 #include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/i2c/i2c_master.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/ioexpander/ioexpander.h>
@@ -65,6 +66,22 @@
 #  warning I2C support is required (CONFIG_I2C)
 #endif
 
+#ifndef CONFIG_PCA9555_INT_DEBOUNCE
+#  define CONFIG_PCA9555_INT_DEBOUNCE 0
+#endif
+
+/* Input states are sampled this long after an interrupt */
+
+#define PCA9555_DEBOUNCE_TICKS MSEC2TICK(CONFIG_PCA9555_INT_DEBOUNCE)
+
+/* Cached input states are only usable if the pin directions are shadowed
+ * and input changes are reported by interrupt.
+ */
+
+#if defined(CONFIG_IOEXPANDER_SHADOW_MODE) && defined(CONFIG_PCA9555_INT_ENABLE)
+#  define PCA9555_INPUT_CACHE 1
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -248,11 +265,29 @@ static int pca9555_setbit(FAR struct pca9555_dev_s *pca, uint8_t addr,
     }
 
 #ifdef CONFIG_IOEXPANDER_SHADOW_MODE
+  /* Nothing needs to be sent if the register value is unchanged */
+
+  if (buf[1] == pca->sreg[addr])
+    {
+      return OK;
+    }
+
   /* Save the new register value in the shadow register */
 
   pca->sreg[addr] = buf[1];
 #endif
 
+#ifdef PCA9555_INPUT_CACHE
+  /* Pin direction and polarity changes also change the input register
+   * without any interrupt.
+   */
+
+  if (addr != PCA9555_REG_OUTPUT && addr != PCA9555_REG_OUTPUT + 1)
+    {
+      pca->inputvalid = false;
+    }
+#endif
+
   ret = pca9555_write(pca, buf, 2);
 #ifdef CONFIG_IOEXPANDER_RETRY
   if (ret != OK)
@@ -306,6 +341,56 @@ static int pca9555_getbit(FAR struct pca9555_dev_s *pca, uint8_t addr,
   return OK;
 }
 
+/****************************************************************************
+ * Name: pca9555_shadow16
+ *
+ * Description:
+ *  Get a shadowed register pair as one 16-bit value (pin 0 in bit 0)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOEXPANDER_SHADOW_MODE
+static inline uint16_t pca9555_shadow16(FAR struct pca9555_dev_s *pca,
+                                        uint8_t addr)
+{
+  return (uint16_t)pca->sreg[addr] | ((uint16_t)pca->sreg[addr + 1] << 8);
+}
+#endif
+
+/****************************************************************************
+ * Name: pca9555_readshadow
+ *
+ * Description:
+ *  Initialize the shadow registers from the device.  The PCA9555 only
+ *  auto-increments within a register pair, so each pair is read
+ *  separately.  The power-on values are assumed for any pair that cannot
+ *  be read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOEXPANDER_SHADOW_MODE
+static void pca9555_readshadow(FAR struct pca9555_dev_s *pca)
+{
+  static const uint8_t defaults[8] =
+  {
+    0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff
+  };
+
+  uint8_t addr;
+  int ret;
+
+  for (addr = PCA9555_REG_INPUT; addr < 8; addr += 2)
+    {
+      ret = pca9555_writeread(pca, &addr, 1, &pca->sreg[addr], 2);
+      if (ret < 0)
+        {
+          pca->sreg[addr]     = defaults[addr];
+          pca->sreg[addr + 1] = defaults[addr + 1];
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: pca9555_direction
  *
@@ -395,6 +480,22 @@ static int pca9555_readpin(FAR struct ioexpander_dev_s *dev, uint8_t pin,
   /* Get exclusive access to the PCA555 */
 
   pca9555_lock(pca);
+
+#ifdef PCA9555_INPUT_CACHE
+  /* The input register only needs to be read if the pin is not an input
+   * (whose changes would be reported by interrupt) or if the cached input
+   * state is not valid.
+   */
+
+  if (pin < 16 && pca->inputvalid &&
+      (pca9555_shadow16(pca, PCA9555_REG_CONFIG) & (1 << pin)) != 0)
+    {
+      *value = (pca->input >> pin) & 1;
+      pca9555_unlock(pca);
+      return OK;
+    }
+#endif
+
   ret = pca9555_getbit(pca, PCA9555_REG_INPUT, pin, value);
   pca9555_unlock(pca);
   return ret;
@@ -417,7 +518,23 @@ static int pca9555_readbuf(FAR struct ioexpander_dev_s *dev, uint8_t pin,
   /* Get exclusive access to the PCA555 */
 
   pca9555_lock(pca);
+
+#ifdef CONFIG_IOEXPANDER_SHADOW_MODE
+  /* The output register is already known */
+
+  if (pin < 16)
+    {
+      *value = (pca9555_shadow16(pca, PCA9555_REG_OUTPUT) >> pin) & 1;
+      ret    = OK;
+    }
+  else
+    {
+      ret    = -ENXIO;
+    }
+#else
   ret = pca9555_getbit(pca, PCA9555_REG_OUTPUT, pin, value);
+#endif
+
   pca9555_unlock(pca);
   return ret;
 }
@@ -551,11 +668,29 @@ static int pca9555_multiwritepin(FAR struct ioexpander_dev_s *dev,
 
   buf[0] = addr;
 #ifdef CONFIG_IOEXPANDER_SHADOW_MODE
+  /* Nothing needs to be sent if the register values are unchanged */
+
+  if (buf[1] == pca->sreg[addr] && buf[2] == pca->sreg[addr + 1])
+    {
+      pca9555_unlock(pca);
+      return OK;
+    }
+
   /* Save the new register values in the shadow register */
-  pca->sreg[addr] = buf[1];
-  pca->sreg[addr+1] = buf[2];
+
+  pca->sreg[addr]     = buf[1];
+  pca->sreg[addr + 1] = buf[2];
 #endif
+
   ret = pca9555_write(pca, buf, 3);
+#ifdef CONFIG_IOEXPANDER_RETRY
+  if (ret != OK)
+    {
+      /* Try again (only once) */
+
+      ret = pca9555_write(pca, buf, 3);
+    }
+#endif
 
   pca9555_unlock(pca);
   return ret;
@@ -603,8 +738,31 @@ static int pca9555_multireadbuf(FAR struct ioexpander_dev_s *dev,
   /* Get exclusive access to the PCA555 */
 
   pca9555_lock(pca);
+
+#ifdef CONFIG_IOEXPANDER_SHADOW_MODE
+  /* The output registers are already known */
+
+  {
+    uint16_t outputs = pca9555_shadow16(pca, PCA9555_REG_OUTPUT);
+    int i;
+
+    ret = OK;
+    for (i = 0; i < count; i++)
+      {
+        if (pins[i] > 15)
+          {
+            ret = -ENXIO;
+            break;
+          }
+
+        values[i] = (outputs >> pins[i]) & 1;
+      }
+  }
+#else
   ret = pca9555_getmultibits(pca, PCA9555_REG_OUTPUT,
                              pins, values, count);
+#endif
+
   pca9555_unlock(pca);
   return ret;
 }
@@ -628,23 +786,39 @@ static void pca9555_irqworker(void *arg)
   uint8_t addr = PCA9555_REG_INPUT;
   uint8_t buf[2];
   unsigned int bits;
+  bool changed;
   int ret;
 
-  /* Read inputs */
+  /* Read inputs.  This also clears the PCA9555 interrupt.  Any bouncing
+   * that occurred since the interrupt (CONFIG_PCA9555_INT_DEBOUNCE msec
+   * ago) has been ignored because further interrupts were disabled.
+   */
 
+  pca9555_lock(pca);
   ret = pca9555_writeread(pca, &addr, 1, buf, 2);
   if (ret == OK)
     {
 #ifdef CONFIG_IOEXPANDER_SHADOW_MODE
       /* Don't forget to update the shadow registers at this point */
 
-      pca->sreg[addr] = buf;
+      pca->sreg[addr]     = buf[0];
+      pca->sreg[addr + 1] = buf[1];
 #endif
-      bits = ((unsigned int)buf[0] << 8) | buf[1];
+
+      /* Pin 0 is bit 0 of port 0 */
+
+      bits = (unsigned int)buf[0] | ((unsigned int)buf[1] << 8);
+
+      /* Only report input states that have actually changed */
+
+      changed = (!pca->inputvalid || bits != pca->input);
+      pca->input      = (uint16_t)bits;
+      pca->inputvalid = true;
+      pca9555_unlock(pca);
 
       /* If signal PID is registered, enqueue signal. */
 
-      if (pca->dev.sigpid)
+      if (changed && pca->dev.sigpid)
         {
 #ifdef CONFIG_CAN_PASS_STRUCTS
           union sigval value;
@@ -656,6 +830,10 @@ static void pca9555_irqworker(void *arg)
 #endif
         }
     }
+  else
+    {
+      pca9555_unlock(pca);
+    }
 
   /* Re-enable interrupts */
 
@@ -701,7 +879,7 @@ static int pca9555_interrupt(int irq, FAR void *context)
     {
       pca->config->enable(pca->config, FALSE);
       work_queue(HPWORK, &pca->dev.work, pca9555_irqworker,
-                 (FAR void *)pca, 0);
+                 (FAR void *)pca, PCA9555_DEBOUNCE_TICKS);
     }
 
   return OK;
@@ -758,12 +936,21 @@ FAR struct ioexpander_dev_s *pca9555_initialize(FAR struct i2c_master_s *i2cdev,
   pcadev->dev.ops = &g_pca9555_ops;
   pcadev->config  = config;
 
+  sem_init(&pcadev->exclsem, 0, 1);
+
+#ifdef CONFIG_IOEXPANDER_SHADOW_MODE
+  /* Start with the current register values so that pins that have not
+   * been configured yet are not disturbed.
+   */
+
+  pca9555_readshadow(pcadev);
+#endif
+
 #ifdef CONFIG_PCA9555_INT_ENABLE
   pcadev->config->attach(pcadev->config, pca9555_interrupt);
   pcadev->config->enable(pcadev->config, TRUE);
 #endif
 
-  sem_init(&pcadev->exclsem, 0, 1);
   return &pcadev->dev;
 }
 
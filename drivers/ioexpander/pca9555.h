@@ -128,6 +128,10 @@ struct pca9555_dev_s
   FAR struct pca9555_config_s *config;  /* Board configuration data */
   FAR struct i2c_master_s     *i2c;     /* Saved I2C driver instance */
   sem_t                        exclsem; /* Mutual exclusion */
+#ifdef CONFIG_PCA9555_INT_ENABLE
+  uint16_t                     input;   /* Input states read after the last interrupt */
+  bool                         inputvalid; /* True: input is current */
+#endif
 };
 
 #endif /* CONFIG_IOEXPANDER && CONFIG_IOEXPANDER_PCA9555 */
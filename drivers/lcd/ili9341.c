@@ -389,6 +389,12 @@ struct ili9341_dev_s
 
   int (*putrun)(fb_coord_t row, fb_coord_t col,
                 FAR const uint8_t * buffer, size_t npixels);
+
+  /* Driver specific putarea function */
+
+  int (*putarea)(fb_coord_t row_start, fb_coord_t row_end,
+                 fb_coord_t col_start, fb_coord_t col_end,
+                 FAR const uint8_t *buffer, size_t stride);
 #ifndef CONFIG_LCD_NOGETRUN
   /* Driver specific getrun function */
 
@@ -430,6 +436,10 @@ static inline uint16_t ili9341_getyres(FAR struct ili9341_dev_s *dev);
 
 static int ili9341_putrun(int devno, fb_coord_t row, fb_coord_t col,
                          FAR const uint8_t * buffer, size_t npixels);
+static int ili9341_putarea(int devno, fb_coord_t row_start,
+                           fb_coord_t row_end, fb_coord_t col_start,
+                           fb_coord_t col_end, FAR const uint8_t *buffer,
+                           size_t stride);
 #ifndef CONFIG_LCD_NOGETRUN
 static int ili9341_getrun(int devno, fb_coord_t row, fb_coord_t col,
                          FAR uint8_t * buffer, size_t npixels);
@@ -448,6 +458,17 @@ static int ili9341_putrun1(fb_coord_t row, fb_coord_t col,
                             FAR const uint8_t * buffer, size_t npixsels);
 #endif
 
+#ifdef CONFIG_LCD_ILI9341_IFACE0
+static int ili9341_putarea0(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride);
+#endif
+#ifdef CONFIG_LCD_ILI9341_IFACE1
+static int ili9341_putarea1(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride);
+#endif
+
 #ifndef CONFIG_LCD_NOGETRUN
 # ifdef CONFIG_LCD_ILI9341_IFACE0
 static int ili9341_getrun0(fb_coord_t row, fb_coord_t col,
@@ -492,6 +513,7 @@ static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] =
   {
     .lcd              = 0,
     .putrun           = ili9341_putrun0,
+    .putarea          = ili9341_putarea0,
 # ifndef CONFIG_LCD_NOGETRUN
     .getrun           = ili9341_getrun0,
 # endif
@@ -506,6 +528,7 @@ static struct ili9341_dev_s g_lcddev[CONFIG_LCD_ILI9341_NINTERFACES] =
   {
     .lcd              = 0,
     .putrun           = ili9341_putrun1,
+    .putarea          = ili9341_putarea1,
 # ifndef CONFIG_LCD_NOGETRUN
     .getrun           = ili9341_getrun1,
 # endif
@@ -673,6 +696,89 @@ static int ili9341_putrun(int devno, fb_coord_t row, fb_coord_t col,
   return OK;
 }
 
+/****************************************************************************
+ * Name:  ili9341_putarea
+ *
+ * Description:
+ *   Write a rectangular area to the LCD.  The area is selected once and
+ *   the pixels are then sent in one gram transfer if the buffer rows are
+ *   contiguous, or in one transfer per row otherwise.
+ *
+ * Parameters:
+ *   devno     - Number of lcd device
+ *   row_start - Starting row to write to (range: 0 <= row_start < yres)
+ *   row_end   - Ending row to write to (range: row_start <= row_end < yres)
+ *   col_start - Starting column to write to (range: 0 <= col_start < xres)
+ *   col_end   - Ending column to write to
+ *               (range: col_start <= col_end < xres)
+ *   buffer    - The buffer containing the area to be writen to the LCD
+ *   stride    - The length of one buffer row in bytes.  Zero if the same
+ *               row is to be written to each row of the area.
+ *
+ * Returned Value:
+ *
+ *   On success - OK
+ *   On error   - -EINVAL
+ *
+ ****************************************************************************/
+
+static int ili9341_putarea(int devno, fb_coord_t row_start,
+                           fb_coord_t row_end, fb_coord_t col_start,
+                           fb_coord_t col_end, FAR const uint8_t *buffer,
+                           size_t stride)
+{
+  FAR struct ili9341_dev_s *dev = &g_lcddev[devno];
+  FAR struct ili9341_lcd_s *lcd = dev->lcd;
+  FAR const uint16_t *src = (FAR const uint16_t *)buffer;
+  size_t npixels;
+  fb_coord_t row;
+
+  DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0 && (stride & 1) == 0);
+
+  /* Check if position outside of area */
+
+  if (row_start > row_end || col_start > col_end ||
+      col_end >= ili9341_getxres(dev) || row_end >= ili9341_getyres(dev))
+    {
+      return -EINVAL;
+    }
+
+  npixels = col_end - col_start + 1;
+
+  /* Select lcd driver */
+
+  lcd->select(lcd);
+
+  /* Select the area.  The LCD then advances through the area by itself */
+
+  ili9341_selectarea(lcd, col_start, row_start, col_end, row_end);
+
+  /* Send memory write cmd */
+
+  lcd->sendcmd(lcd, ILI9341_MEMORY_WRITE);
+
+  /* Send the pixels to gram */
+
+  if (stride == npixels * sizeof(uint16_t))
+    {
+      lcd->sendgram(lcd, src, npixels * (row_end - row_start + 1));
+    }
+  else
+    {
+      for (row = row_start; row <= row_end; row++)
+        {
+          lcd->sendgram(lcd, src, npixels);
+          src += stride / sizeof(uint16_t);
+        }
+    }
+
+  /* Deselect the lcd driver */
+
+  lcd->deselect(lcd);
+
+  return OK;
+}
+
 
 /****************************************************************************
  * Name:  ili9341_getrun
@@ -869,6 +975,34 @@ static int ili9341_putrun1(fb_coord_t row, fb_coord_t col,
 }
 #endif
 
+/****************************************************************************
+ * Name:  ili9341_putareax
+ *
+ * Description:
+ *   Write a rectangular area to the LCD.  See ili9341_putarea().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_ILI9341_IFACE0
+static int ili9341_putarea0(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride)
+{
+  return ili9341_putarea(0, row_start, row_end, col_start, col_end,
+                         buffer, stride);
+}
+#endif
+
+#ifdef CONFIG_LCD_ILI9341_IFACE1
+static int ili9341_putarea1(fb_coord_t row_start, fb_coord_t row_end,
+                            fb_coord_t col_start, fb_coord_t col_end,
+                            FAR const uint8_t *buffer, size_t stride)
+{
+  return ili9341_putarea(1, row_start, row_end, col_start, col_end,
+                         buffer, stride);
+}
+#endif
+
 
 /****************************************************************************
  * Name:  ili9341_getrunx
@@ -973,6 +1107,7 @@ static int ili9341_getplaneinfo(FAR struct lcd_dev_s *dev, unsigned int planeno,
       FAR struct ili9341_dev_s *priv = (FAR struct ili9341_dev_s *)dev;
 
       pinfo->putrun = priv->putrun;
+      pinfo->putarea = priv->putarea;
 #ifndef CONFIG_LCD_NOGETRUN
       pinfo->getrun = priv->getrun;
 #endif
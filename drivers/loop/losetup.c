@@ -67,6 +67,16 @@
 #define loop_semgive(d) sem_post(&(d)->sem)  /* To match loop_semtake */
 #define MAX_OPENCNT     (255)                /* Limit of uint8_t */
 
+#ifndef CONFIG_LOOP_BUFSECTORS
+#  define CONFIG_LOOP_BUFSECTORS 0
+#endif
+
+#if CONFIG_LOOP_BUFSECTORS > 0
+#  define loop_flush(d) loop_flushbuffer(d)
+#else
+#  define loop_flush(d) (OK)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -82,6 +92,15 @@ struct loop_struct_s
   bool         writeenabled; /* true: can write to device */
 #endif
   int          fd;           /* Descriptor of char device/file */
+  off_t        filepos;      /* File position of fd (-1 if unknown) */
+#if CONFIG_LOOP_BUFSECTORS > 0
+  FAR uint8_t *buffer;       /* Buffer of CONFIG_LOOP_BUFSECTORS sectors */
+  uint32_t     bufsector;    /* First sector in the buffer */
+  uint16_t     bufcount;     /* Number of valid sectors in the buffer */
+#ifdef CONFIG_LOOP_WRITEBEHIND
+  bool         dirty;        /* true: The buffered sectors must be written */
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -100,6 +119,8 @@ static ssize_t loop_write(FAR struct inode *inode,
 #endif
 static int     loop_geometry(FAR struct inode *inode,
                              FAR struct geometry *geometry);
+static int     loop_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -116,7 +137,7 @@ static const struct block_operations g_bops =
   NULL,          /* write */
 #endif
   loop_geometry, /* geometry */
-  NULL           /* ioctl */
+  loop_ioctl     /* ioctl */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL         /* unlink */
 #endif
@@ -152,6 +173,99 @@ static int loop_semtake(FAR struct loop_struct_s *dev)
   return OK;
 }
 
+/****************************************************************************
+ * Name: loop_transfer
+ *
+ * Description:
+ *   Read or write sectors of the backing file.  The file is repositioned
+ *   only if the transfer does not continue the previous one.
+ *
+ ****************************************************************************/
+
+static ssize_t loop_transfer(FAR struct loop_struct_s *dev,
+                             FAR uint8_t *buffer, size_t start_sector,
+                             unsigned int nsectors, bool writing)
+{
+  ssize_t nbytes;
+  off_t offset;
+
+  /* Calculate the offset of the sectors and seek to the position */
+
+  offset = start_sector * dev->sectsize + dev->offset;
+  if (offset != dev->filepos)
+    {
+      if (lseek(dev->fd, offset, SEEK_SET) == (off_t)-1)
+        {
+          _err("ERROR: Seek failed for offset=%d: %d\n", (int)offset,
+               get_errno());
+          dev->filepos = -1;
+          return -EIO;
+        }
+
+      dev->filepos = offset;
+    }
+
+  /* Then transfer the requested number of sectors at that position */
+
+  do
+    {
+      if (writing)
+        {
+          nbytes = write(dev->fd, buffer, nsectors * dev->sectsize);
+        }
+      else
+        {
+          nbytes = read(dev->fd, buffer, nsectors * dev->sectsize);
+        }
+
+      if (nbytes < 0 && get_errno() != EINTR)
+        {
+          _err("ERROR: %s failed: %d\n", writing ? "Write" : "Read",
+               get_errno());
+          dev->filepos = -1;
+          return -get_errno();
+        }
+    }
+  while (nbytes < 0);
+
+  dev->filepos += nbytes;
+
+  /* Return the number of sectors transferred */
+
+  return nbytes / dev->sectsize;
+}
+
+/****************************************************************************
+ * Name: loop_flushbuffer
+ *
+ * Description:
+ *   Write any sectors collected in the buffer to the backing file.
+ *
+ ****************************************************************************/
+
+#if CONFIG_LOOP_BUFSECTORS > 0
+static int loop_flushbuffer(FAR struct loop_struct_s *dev)
+{
+#ifdef CONFIG_LOOP_WRITEBEHIND
+  ssize_t nwritten;
+
+  if (dev->dirty)
+    {
+      nwritten = loop_transfer(dev, dev->buffer, dev->bufsector,
+                               dev->bufcount, true);
+      if (nwritten != dev->bufcount)
+        {
+          return nwritten < 0 ? (int)nwritten : -EIO;
+        }
+
+      dev->dirty = false;
+    }
+#endif
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: loop_open
  *
@@ -215,9 +329,14 @@ static int loop_close(FAR struct inode *inode)
         }
       else
         {
-          /* Decrement the open count */
-
-          dev->opencnt--;
+          /* Decrement the open count.  Write out any buffered data when
+           * the last reference is closed.
+           */
+
+          if (--dev->opencnt == 0)
+            {
+              ret = loop_flush(dev);
+            }
         }
 
       loop_semgive(dev);
@@ -237,9 +356,11 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
                          size_t start_sector, unsigned int nsectors)
 {
   FAR struct loop_struct_s *dev;
-  ssize_t nbytesread;
-  off_t offset;
-  int ret;
+  ssize_t ret;
+#if CONFIG_LOOP_BUFSECTORS > 0
+  unsigned int nread;
+  unsigned int count;
+#endif
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
@@ -250,32 +371,111 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
-  /* Calculate the offset to read the sectors and seek to the position */
-
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = lseek(dev->fd, offset, SEEK_SET);
-  if (ret == (off_t)-1)
+  ret = loop_semtake(dev);
+  if (ret < 0)
     {
-      _err("ERROR: Seek failed for offset=%d: %d\n", (int)offset, get_errno());
-      return -EIO;
+      return ret;
     }
 
-  /* Then read the requested number of sectors from that position */
+#if CONFIG_LOOP_BUFSECTORS > 0
+  /* Buffered data is only written back when it must be read */
 
-  do
+#ifdef CONFIG_LOOP_WRITEBEHIND
+  if (dev->dirty && start_sector < dev->bufsector + dev->bufcount &&
+      start_sector + nsectors > dev->bufsector)
     {
-      nbytesread = read(dev->fd, buffer, nsectors * dev->sectsize);
-      if (nbytesread < 0 && get_errno() != EINTR)
+      ret = loop_flushbuffer(dev);
+      if (ret < 0)
         {
-          _err("ERROR: Read failed: %d\n", get_errno());
-          return -get_errno();
+          goto errout_with_semaphore;
         }
     }
-  while (nbytesread < 0);
+#endif
 
-  /* Return the number of sectors read */
+  for (nread = 0; nread < nsectors; )
+    {
+      /* Copy any requested sectors that are in the buffer */
 
-  return nbytesread / dev->sectsize;
+      if (start_sector >= dev->bufsector &&
+          start_sector < dev->bufsector + dev->bufcount)
+        {
+          count = dev->bufsector + dev->bufcount - start_sector;
+          if (count > nsectors - nread)
+            {
+              count = nsectors - nread;
+            }
+
+          memcpy(buffer,
+                 &dev->buffer[(start_sector - dev->bufsector) * dev->sectsize],
+                 count * dev->sectsize);
+
+          buffer       += count * dev->sectsize;
+          start_sector += count;
+          nread        += count;
+          continue;
+        }
+
+      /* Large requests are read directly into the caller's buffer */
+
+      if (nsectors - nread >= CONFIG_LOOP_BUFSECTORS)
+        {
+          ret = loop_transfer(dev, buffer, start_sector, nsectors - nread,
+                              false);
+          if (ret > 0)
+            {
+              nread += ret;
+            }
+
+          break;
+        }
+
+      /* Small requests fill the whole buffer (if it holds no unwritten
+       * data).
+       */
+
+#ifdef CONFIG_LOOP_WRITEBEHIND
+      ret = loop_flushbuffer(dev);
+      if (ret < 0)
+        {
+          break;
+        }
+#endif
+
+      count = dev->nsectors - start_sector;
+      if (count > CONFIG_LOOP_BUFSECTORS)
+        {
+          count = CONFIG_LOOP_BUFSECTORS;
+        }
+
+      dev->bufcount = 0;
+      ret = loop_transfer(dev, dev->buffer, start_sector, count, false);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      dev->bufsector = start_sector;
+      dev->bufcount  = ret;
+    }
+
+  /* Return the number of sectors read or, if nothing was read, the
+   * error.
+   */
+
+  if (nread > 0 || ret >= 0)
+    {
+      ret = nread;
+    }
+
+#ifdef CONFIG_LOOP_WRITEBEHIND
+errout_with_semaphore:
+#endif
+#else
+  ret = loop_transfer(dev, buffer, start_sector, nsectors, false);
+#endif
+
+  loop_semgive(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -291,38 +491,88 @@ static ssize_t loop_write(FAR struct inode *inode,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct loop_struct_s *dev;
-  ssize_t nbyteswritten;
-  off_t offset;
-  int ret;
+  ssize_t ret;
 
   DEBUGASSERT(inode && inode->i_private);
   dev = (FAR struct loop_struct_s *)inode->i_private;
 
-  /* Calculate the offset to write the sectors and seek to the position */
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      _err("ERROR: Write past end of file\n");
+      return -EIO;
+    }
 
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = lseek(dev->fd, offset, SEEK_SET);
-  if (ret == (off_t)-1)
+  ret = loop_semtake(dev);
+  if (ret < 0)
     {
-      _err("ERROR: Seek failed for offset=%d: %d\n", (int)offset, get_errno());
+      return ret;
     }
 
-  /* Then write the requested number of sectors to that position */
+#ifdef CONFIG_LOOP_WRITEBEHIND
+  /* Collect small writes in the buffer.  A write may replace or extend the
+   * sectors already collected; otherwise they must be written out first.
+   */
 
-  do
+  if (nsectors < CONFIG_LOOP_BUFSECTORS)
     {
-      nbyteswritten = write(dev->fd, buffer, nsectors * dev->sectsize);
-      if (nbyteswritten < 0 && get_errno() != EINTR)
+      if (dev->dirty &&
+          (start_sector < dev->bufsector ||
+           start_sector > dev->bufsector + dev->bufcount ||
+           start_sector + nsectors > dev->bufsector + CONFIG_LOOP_BUFSECTORS))
         {
-          _err("ERROR: Write failed: %d\n", get_errno());
-          return -get_errno();
+          ret = loop_flushbuffer(dev);
+          if (ret < 0)
+            {
+              goto errout_with_semaphore;
+            }
         }
+
+      /* Any clean data in the buffer is discarded */
+
+      if (!dev->dirty)
+        {
+          dev->bufsector = start_sector;
+          dev->bufcount  = 0;
+          dev->dirty     = true;
+        }
+
+      memcpy(&dev->buffer[(start_sector - dev->bufsector) * dev->sectsize],
+             buffer, nsectors * dev->sectsize);
+
+      if (start_sector + nsectors > dev->bufsector + dev->bufcount)
+        {
+          dev->bufcount = start_sector + nsectors - dev->bufsector;
+        }
+
+      ret = nsectors;
+      goto errout_with_semaphore;
     }
-  while (nbyteswritten < 0);
 
-  /* Return the number of sectors written */
+  ret = loop_flushbuffer(dev);
+  if (ret < 0)
+    {
+      goto errout_with_semaphore;
+    }
+#endif
 
-  return nbyteswritten / dev->sectsize;
+#if CONFIG_LOOP_BUFSECTORS > 0
+  /* Discard any buffered copies of the sectors being written */
+
+  if (start_sector < dev->bufsector + dev->bufcount &&
+      start_sector + nsectors > dev->bufsector)
+    {
+      dev->bufcount = 0;
+    }
+#endif
+
+  ret = loop_transfer(dev, (FAR uint8_t *)buffer, start_sector, nsectors,
+                      true);
+
+#ifdef CONFIG_LOOP_WRITEBEHIND
+errout_with_semaphore:
+#endif
+  loop_semgive(dev);
+  return ret;
 }
 #endif
 
@@ -357,6 +607,38 @@ static int loop_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: loop_ioctl
+ *
+ * Description: Handle block driver ioctl commands
+ *
+ ****************************************************************************/
+
+static int loop_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct loop_struct_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct loop_struct_s *)inode->i_private;
+
+  /* Only one ioctl command is supported */
+
+  if (cmd == BIOC_FLUSH)
+    {
+      ret = loop_semtake(dev);
+      if (ret == OK)
+        {
+          ret = loop_flush(dev);
+          loop_semgive(dev);
+        }
+
+      return ret;
+    }
+
+  return -ENOTTY;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -417,6 +699,18 @@ int losetup(FAR const char *devname, FAR const char *filename,
   dev->nsectors  = (sb.st_size - offset) / sectsize;
   dev->sectsize  = sectsize;
   dev->offset    = offset;
+  dev->filepos   = -1;
+
+#if CONFIG_LOOP_BUFSECTORS > 0
+  /* Allocate the transfer buffer */
+
+  dev->buffer = (FAR uint8_t *)kmm_malloc(CONFIG_LOOP_BUFSECTORS * sectsize);
+  if (dev->buffer == NULL)
+    {
+      kmm_free(dev);
+      return -ENOMEM;
+    }
+#endif
 
   /* Open the file. */
 
@@ -442,7 +736,7 @@ int losetup(FAR const char *devname, FAR const char *filename,
     {
       /* If that fails, then try to open the device read-only */
 
-      dev->fd = open(filename, O_RDWR);
+      dev->fd = open(filename, O_RDONLY);
       if (dev->fd < 0)
         {
           _err("ERROR: Failed to open %s: %d\n", filename, get_errno());
@@ -465,6 +759,9 @@ int losetup(FAR const char *devname, FAR const char *filename,
 errout_with_fd:
   close(dev->fd);
 errout_with_dev:
+#if CONFIG_LOOP_BUFSECTORS > 0
+  kmm_free(dev->buffer);
+#endif
   kmm_free(dev);
   return ret;
 }
@@ -528,6 +825,9 @@ int loteardown(FAR const char *devname)
       (void)close(dev->fd);
     }
 
+#if CONFIG_LOOP_BUFSECTORS > 0
+  kmm_free(dev->buffer);
+#endif
   kmm_free(dev);
   return ret;
 }
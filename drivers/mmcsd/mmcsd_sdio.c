@@ -98,6 +98,15 @@
 #define MMCSD_BLOCK_RDATADELAY  (100)      /* Wait up to 100MS to get one data block */
 #define MMCSD_BLOCK_WDATADELAY  (200)      /* Wait up to 200MS to write one data block */
 
+/* While the card is busy programming after a write, CMD13 is polled
+ * continuously for up to MMCSD_BUSY_SPINTICKS, then the card is polled only
+ * once every MMCSD_BUSY_POLLDELAY so that other tasks can run during long
+ * programming times.
+ */
+
+#define MMCSD_BUSY_SPINTICKS    (1)
+#define MMCSD_BUSY_POLLDELAY    ((useconds_t)1000)
+
 #define IS_EMPTY(priv) (priv->type == MMCSD_CARDTYPE_UNKNOWN)
 
 /****************************************************************************
@@ -194,6 +203,10 @@ static int     mmcsd_eventwait(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #ifndef CONFIG_MMCSD_MULTIBLOCK_DISABLE
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
+#ifdef CONFIG_MMCSD_MMC_SETBLOCKCOUNT
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                 size_t nblocks);
+#endif
 #endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                  uint32_t blocklen);
@@ -1206,6 +1219,15 @@ static int mmcsd_transferready(FAR struct mmcsd_state_s *priv)
        */
 
       elapsed = clock_systimer() - starttime;
+
+      /* Stop spinning if the card has been busy for a while and give up
+       * the CPU between polls instead.
+       */
+
+      if (elapsed >= MMCSD_BUSY_SPINTICKS)
+        {
+          usleep(MMCSD_BUSY_POLLDELAY);
+        }
     }
   while (elapsed < TICK_PER_SEC);
 
@@ -1238,6 +1260,34 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 }
 #endif
 
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Send CMD23, SET_BLOCK_COUNT, to an MMC card before a multiple block
+ *   transfer.  The transfer then ends by itself after 'nblocks' blocks and
+ *   no STOP_TRANSMISSION is needed.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_MMCSD_MULTIBLOCK_DISABLE) && \
+    defined(CONFIG_MMCSD_MMC_SETBLOCKCOUNT)
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               size_t nblocks)
+{
+  int ret;
+
+  mmcsd_sendcmdpoll(priv, MMC_CMD23, (uint32_t)nblocks & 0xffff);
+  ret = mmcsd_recvR1(priv, MMC_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recvR1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_setblocklen
  *
@@ -1487,6 +1537,21 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
     return ret;
   }
 
+#ifdef CONFIG_MMCSD_MMC_SETBLOCKCOUNT
+  /* For MMC cards, pre-define the number of blocks so that the transfer
+   * ends without STOP_TRANSMISSION.
+   */
+
+  if (IS_MMC(priv->type))
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Configure SDIO controller hardware for the read transfer */
 
   SDIO_BLOCKSETUP(priv->dev, priv->blocksize, nblocks);
@@ -1532,12 +1597,17 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION (unless the block count was pre-defined) */
 
-  ret = mmcsd_stoptransmission(priv);
-  if (ret != OK)
+#ifdef CONFIG_MMCSD_MMC_SETBLOCKCOUNT
+  if (!IS_MMC(priv->type))
+#endif
     {
-      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+      ret = mmcsd_stoptransmission(priv);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+        }
     }
 
   /* On success, return the number of blocks read */
@@ -1836,10 +1906,10 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
-  /* If this is an SD card, then send ACMD23 (SET_WR_BLK_COUNT) just before
-   * sending CMD25 (WRITE_MULTIPLE_BLOCK).  This sets the number of write
-   * blocks to be pre-erased and might make the following multiple block write
-   * command faster.
+  /* If this is an SD card, then send ACMD23 (SET_WR_BLK_ERASE_COUNT) just
+   * before sending CMD25 (WRITE_MULTIPLE_BLOCK).  This sets the number of
+   * write blocks to be pre-erased and might make the following multiple
+   * block write command faster.
    */
 
   if (IS_SD(priv->type))
@@ -1854,9 +1924,11 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
           return ret;
         }
 
-      /* Send CMD23, SET_WR_BLK_COUNT, and verify that good R1 status is returned */
+      /* Send CMD23, SET_WR_BLK_ERASE_COUNT, with the number of blocks to be
+       * written and verify that good R1 status is returned
+       */
 
-      mmcsd_sendcmdpoll(priv, SD_ACMD23, 0);
+      mmcsd_sendcmdpoll(priv, SD_ACMD23, (uint32_t)nblocks & 0x007fffff);
       ret = mmcsd_recvR1(priv, SD_ACMD23);
       if (ret != OK)
         {
@@ -1864,6 +1936,21 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
           return ret;
         }
     }
+#ifdef CONFIG_MMCSD_MMC_SETBLOCKCOUNT
+
+  /* For MMC cards, pre-define the number of blocks so that the transfer
+   * ends without STOP_TRANSMISSION.
+   */
+
+  else if (IS_MMC(priv->type))
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          return ret;
+        }
+    }
+#endif
 
   /* Configure SDIO controller hardware for the write transfer */
 
@@ -1909,17 +1996,22 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
   ret = mmcsd_eventwait(priv, SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR, nblocks * MMCSD_BLOCK_WDATADELAY);
   if (ret != OK)
     {
-      ferr("ERROR: CMD18 transfer failed: %d\n", ret);
+      ferr("ERROR: CMD25 transfer failed: %d\n", ret);
       return ret;
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION (unless the block count was pre-defined) */
 
-  ret = mmcsd_stoptransmission(priv);
-  if (ret != OK)
+#ifdef CONFIG_MMCSD_MMC_SETBLOCKCOUNT
+  if (!IS_MMC(priv->type))
+#endif
     {
-      ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
-      return ret;
+      ret = mmcsd_stoptransmission(priv);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_stoptransmission failed: %d\n", ret);
+          return ret;
+        }
     }
 
   /* On success, return the number of blocks written */
@@ -0,0 +1,517 @@
+/****************************************************************************
+ * drivers/mtd/bchecc.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mtd/bchecc.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BCH_N         ((1 << BCHECC_M) - 1)   /* Elements in GF(2^13) - 1 */
+#define BCH_POLY      0x201b                  /* x^13 + x^4 + x^3 + x + 1 */
+#define BCH_T         CONFIG_MTD_NAND_BCH_STRENGTH
+#define BCH_NWORDS    ((BCHECC_ECCBITS + 31) / 32)
+#define BCH_DATABITS  (8 * BCHECC_STEPSIZE)
+
+#if BCH_T < 1 || BCH_T > 16
+#  error CONFIG_MTD_NAND_BCH_STRENGTH must be in the range 1-16
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static bool     g_bch_initialized;
+
+/* Galois field tables:  g_alpha_to[i] is alpha^i and g_index_of[x] is the
+ * logarithm of x.
+ */
+
+static uint16_t g_alpha_to[BCH_N + 1];
+static uint16_t g_index_of[BCH_N + 1];
+
+/* The ECC register is kept left-aligned in BCH_NWORDS words:  The
+ * coefficient of x^(ECCBITS-1) is the MSB of the first word.  g_enctab[v]
+ * is the remainder of v(x) * x^ECCBITS modulo the generator polynomial so
+ * that the data is encoded a byte at a time.
+ */
+
+static uint32_t g_enctab[256][BCH_NWORDS];
+
+/* XOR'ed into the ECC so that erased data has erased ECC bytes */
+
+static uint8_t  g_eccmask[BCHECC_ECCBYTES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bch_mul and bch_div
+ *
+ * Description:
+ *   Galois field multiplication and division
+ *
+ ****************************************************************************/
+
+static inline uint16_t bch_mul(uint16_t a, uint16_t b)
+{
+  if (a == 0 || b == 0)
+    {
+      return 0;
+    }
+
+  return g_alpha_to[(g_index_of[a] + g_index_of[b]) % BCH_N];
+}
+
+static inline uint16_t bch_div(uint16_t a, uint16_t b)
+{
+  if (a == 0)
+    {
+      return 0;
+    }
+
+  return g_alpha_to[(g_index_of[a] + BCH_N - g_index_of[b]) % BCH_N];
+}
+
+/****************************************************************************
+ * Name: bch_encode
+ *
+ * Description:
+ *   Compute the raw (unmasked) remainder of one step, MSB first.
+ *
+ ****************************************************************************/
+
+static void bch_encode(FAR const uint8_t *data, FAR uint8_t *ecc)
+{
+  FAR const uint32_t *tab;
+  uint32_t reg[BCH_NWORDS];
+  int i;
+  int w;
+
+  memset(reg, 0, sizeof(reg));
+
+  for (i = 0; i < BCHECC_STEPSIZE; i++)
+    {
+      tab = g_enctab[(reg[0] >> 24) ^ data[i]];
+
+      for (w = 0; w < BCH_NWORDS - 1; w++)
+        {
+          reg[w] = ((reg[w] << 8) | (reg[w + 1] >> 24)) ^ tab[w];
+        }
+
+      reg[w] = (reg[w] << 8) ^ tab[w];
+    }
+
+  for (i = 0; i < BCHECC_ECCBYTES; i++)
+    {
+      ecc[i] = (uint8_t)(reg[i >> 2] >> (24 - 8 * (i & 3)));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchecc_initialize
+ *
+ * Description:
+ *   Build the Galois field, generator polynomial and encoding tables.  This
+ *   must be called once before any other bchecc function is used; further
+ *   calls do nothing.
+ *
+ * Returned Values:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int bchecc_initialize(void)
+{
+  uint16_t gen[BCHECC_ECCBITS + 1];
+  uint32_t genw[BCH_NWORDS];
+  uint32_t reg[BCH_NWORDS];
+  uint8_t erased[BCHECC_STEPSIZE];
+  uint32_t x;
+  uint16_t root;
+  bool newcoset;
+  int deg;
+  int pos;
+  int i;
+  int j;
+  int k;
+  int w;
+  int v;
+
+  if (g_bch_initialized)
+    {
+      return OK;
+    }
+
+  /* Build the Galois field GF(2^13) */
+
+  for (i = 0, x = 1; i < BCH_N; i++)
+    {
+      g_alpha_to[i] = x;
+      g_index_of[x] = i;
+
+      x <<= 1;
+      if (x & (1 << BCHECC_M))
+        {
+          x ^= BCH_POLY;
+        }
+    }
+
+  g_alpha_to[BCH_N] = 1;
+  g_index_of[0]     = 0;
+
+  /* The generator polynomial is the product of the minimal polynomials of
+   * alpha^1 ... alpha^2t, i.e., of (x + alpha^e) for every e in the
+   * cyclotomic cosets of the odd numbers 1, 3, ... 2t-1.
+   */
+
+  memset(gen, 0, sizeof(gen));
+  gen[0] = 1;
+  deg    = 0;
+
+  for (i = 1; i < 2 * BCH_T; i += 2)
+    {
+      /* Skip cosets that are already included:  Those with an odd element
+       * smaller than i.
+       */
+
+      newcoset = true;
+      for (k = 1, x = (2 * i) % BCH_N; k < BCHECC_M; k++, x = (2 * x) % BCH_N)
+        {
+          if ((x & 1) != 0 && x < i)
+            {
+              newcoset = false;
+              break;
+            }
+        }
+
+      if (!newcoset)
+        {
+          continue;
+        }
+
+      for (k = 0, x = i; k < BCHECC_M; k++, x = (2 * x) % BCH_N)
+        {
+          if (deg >= BCHECC_ECCBITS)
+            {
+              return -EINVAL;
+            }
+
+          root = g_alpha_to[x];
+          for (j = deg + 1; j > 0; j--)
+            {
+              gen[j] = gen[j - 1] ^ bch_mul(gen[j], root);
+            }
+
+          gen[0] = bch_mul(gen[0], root);
+          deg++;
+        }
+    }
+
+  if (deg != BCHECC_ECCBITS)
+    {
+      ferr("ERROR: Generator polynomial degree %d\n", deg);
+      return -EINVAL;
+    }
+
+  /* Left-align the generator polynomial without its x^ECCBITS term */
+
+  memset(genw, 0, sizeof(genw));
+  for (j = 0; j < BCHECC_ECCBITS; j++)
+    {
+      DEBUGASSERT(gen[j] <= 1);
+      if (gen[j] != 0)
+        {
+          pos = BCHECC_ECCBITS - 1 - j;
+          genw[pos >> 5] |= 0x80000000 >> (pos & 31);
+        }
+    }
+
+  /* Build the byte-at-a-time encoding table */
+
+  for (v = 0; v < 256; v++)
+    {
+      memset(reg, 0, sizeof(reg));
+
+      for (k = 7; k >= 0; k--)
+        {
+          bool feedback = ((reg[0] >> 31) ^ (v >> k)) & 1;
+
+          for (w = 0; w < BCH_NWORDS - 1; w++)
+            {
+              reg[w] = (reg[w] << 1) | (reg[w + 1] >> 31);
+            }
+
+          reg[w] <<= 1;
+
+          if (feedback)
+            {
+              for (w = 0; w < BCH_NWORDS; w++)
+                {
+                  reg[w] ^= genw[w];
+                }
+            }
+        }
+
+      memcpy(g_enctab[v], reg, sizeof(reg));
+    }
+
+  /* The mask makes the ECC of erased data all 0xff */
+
+  memset(erased, 0xff, BCHECC_STEPSIZE);
+  bch_encode(erased, g_eccmask);
+  for (i = 0; i < BCHECC_ECCBYTES; i++)
+    {
+      g_eccmask[i] ^= 0xff;
+    }
+
+  g_bch_initialized = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchecc_calculate
+ *
+ * Description:
+ *   Compute the BCHECC_ECCBYTES ECC bytes of one BCHECC_STEPSIZE step of
+ *   data.  The ECC of erased (all 0xff) data is all 0xff.
+ *
+ ****************************************************************************/
+
+void bchecc_calculate(FAR const uint8_t *data, FAR uint8_t *ecc)
+{
+  int i;
+
+  DEBUGASSERT(g_bch_initialized);
+
+  bch_encode(data, ecc);
+  for (i = 0; i < BCHECC_ECCBYTES; i++)
+    {
+      ecc[i] ^= g_eccmask[i];
+    }
+}
+
+/****************************************************************************
+ * Name: bchecc_correct
+ *
+ * Description:
+ *   Correct the bit errors in one step of data.  The syndromes are computed
+ *   from the difference of the read and computed ECC, the error locator
+ *   polynomial is found with the Berlekamp-Massey algorithm and its roots
+ *   with a Chien search.
+ *
+ ****************************************************************************/
+
+int bchecc_correct(FAR uint8_t *data, FAR const uint8_t *readecc,
+                   FAR const uint8_t *calcecc)
+{
+  uint16_t syn[2 * BCH_T + 1];
+  uint16_t elp[2 * BCH_T + 1];
+  uint16_t prev[2 * BCH_T + 1];
+  uint16_t tmp[2 * BCH_T + 1];
+  uint16_t errloc[BCH_T];
+  uint16_t reg[BCH_T + 1];
+  uint16_t prevd;
+  uint16_t coef;
+  uint16_t d;
+  uint8_t diff;
+  bool error = false;
+  int nerr;
+  int len;
+  int gap;
+  int deg;
+  int n;
+  int i;
+  int j;
+
+  /* The syndromes of the received codeword equal those of the difference
+   * between the read and computed ECC, the remainder of the error
+   * polynomial.  Bit k of that remainder (from the LSB end) is the
+   * coefficient of x^k.
+   */
+
+  memset(syn, 0, sizeof(syn));
+  for (i = 0; i < BCHECC_ECCBYTES; i++)
+    {
+      diff = readecc[i] ^ calcecc[i];
+      for (j = 0; j < 8 && diff != 0; j++)
+        {
+          if ((diff & (0x80 >> j)) != 0 && 8 * i + j < BCHECC_ECCBITS)
+            {
+              deg = BCHECC_ECCBITS - 1 - (8 * i + j);
+              for (n = 1; n < 2 * BCH_T; n += 2)
+                {
+                  syn[n] ^= g_alpha_to[(n * deg) % BCH_N];
+                }
+
+              error = true;
+            }
+        }
+    }
+
+  if (!error)
+    {
+      return 0;
+    }
+
+  for (n = 2; n <= 2 * BCH_T; n += 2)
+    {
+      syn[n] = bch_mul(syn[n / 2], syn[n / 2]);
+    }
+
+  /* Berlekamp-Massey:  Find the error locator polynomial elp of degree
+   * len.
+   */
+
+  memset(elp, 0, sizeof(elp));
+  memset(prev, 0, sizeof(prev));
+  elp[0]  = 1;
+  prev[0] = 1;
+  prevd   = 1;
+  len     = 0;
+  gap     = 1;
+
+  for (n = 0; n < 2 * BCH_T; n++)
+    {
+      d = syn[n + 1];
+      for (i = 1; i <= len; i++)
+        {
+          d ^= bch_mul(elp[i], syn[n + 1 - i]);
+        }
+
+      if (d == 0)
+        {
+          gap++;
+          continue;
+        }
+
+      coef = bch_div(d, prevd);
+      if (2 * len <= n)
+        {
+          memcpy(tmp, elp, sizeof(elp));
+          for (i = 0; i + gap <= 2 * BCH_T; i++)
+            {
+              elp[i + gap] ^= bch_mul(coef, prev[i]);
+            }
+
+          len   = n + 1 - len;
+          memcpy(prev, tmp, sizeof(prev));
+          prevd = d;
+          gap   = 1;
+        }
+      else
+        {
+          for (i = 0; i + gap <= 2 * BCH_T; i++)
+            {
+              elp[i + gap] ^= bch_mul(coef, prev[i]);
+            }
+
+          gap++;
+        }
+    }
+
+  if (len > BCH_T)
+    {
+      return -EBADMSG;
+    }
+
+  /* Chien search:  An error at the codeword bit of degree k is a root
+   * alpha^-k of elp.  reg[i] holds the logarithm of the term elp[i] *
+   * alpha^(-i*k).
+   */
+
+  for (i = 1; i <= len; i++)
+    {
+      reg[i] = elp[i] != 0 ? g_index_of[elp[i]] : BCH_N;
+    }
+
+  nerr = 0;
+  for (deg = 0; deg < BCHECC_ECCBITS + BCH_DATABITS && nerr < len; deg++)
+    {
+      d = 1;
+      for (i = 1; i <= len; i++)
+        {
+          if (reg[i] != BCH_N)
+            {
+              d ^= g_alpha_to[reg[i]];
+              reg[i] = (reg[i] + BCH_N - i) % BCH_N;
+            }
+        }
+
+      if (d == 0)
+        {
+          errloc[nerr++] = deg;
+        }
+    }
+
+  if (nerr != len)
+    {
+      return -EBADMSG;
+    }
+
+  /* Correct the data bits.  Errors in the ECC bytes need no correction.
+   * The data is encoded MSB first, so the last data byte holds the lowest
+   * degrees.
+   */
+
+  for (i = 0; i < nerr; i++)
+    {
+      if (errloc[i] >= BCHECC_ECCBITS)
+        {
+          deg = errloc[i] - BCHECC_ECCBITS;
+          data[BCHECC_STEPSIZE - 1 - (deg >> 3)] ^= 1 << (deg & 7);
+        }
+    }
+
+  return nerr;
+}
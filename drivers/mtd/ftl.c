@@ -46,10 +46,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <semaphore.h>
+#include <assert.h>
 #include <debug.h>
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -63,67 +66,1246 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+#ifndef CONFIG_FS_WRITABLE
+#  undef CONFIG_FTL_WRITECACHE
+#  undef CONFIG_FTL_LOG
+#endif
+
+/* The write cache re-writes erase blocks in place and so cannot be used
+ * with the log-structured mode.
+ */
+
+#ifdef CONFIG_FTL_LOG
+#  undef CONFIG_FTL_WRITECACHE
+#else
+#  undef CONFIG_FTL_LOG_BGGC
+#endif
+
+#if defined(CONFIG_FTL_LOG_BGGC) && !defined(CONFIG_SCHED_LPWORK)
+#  undef CONFIG_FTL_LOG_BGGC
+#endif
+
+#if defined(CONFIG_FTL_WRITECACHE) || defined(CONFIG_FTL_LOG)
+#  define FTL_HAVE_EXCLSEM 1
+#endif
+
+#if defined(CONFIG_FS_WRITABLE) && !defined(CONFIG_FTL_LOG)
+#  define FTL_HAVE_EBLOCK 1
+#endif
+
+/* Log-structured mode.  The first page of each erase block holds a header
+ * with the erase count of the block.  Data pages are then written in order
+ * and, when the erase block is closed, they are followed by a summary that
+ * records the logical sector held in each data page.  Sectors are never
+ * re-written in place:  A write goes to the next free page and the
+ * logical-to-physical map is updated.  Superseded pages are reclaimed by
+ * garbage collection.
+ */
+
+#ifdef CONFIG_FTL_LOG
+#  ifndef CONFIG_FTL_LOG_NRESERVED
+#    define CONFIG_FTL_LOG_NRESERVED 4
+#  endif
+
+#  if CONFIG_FTL_LOG_NRESERVED < 3
+#    error CONFIG_FTL_LOG_NRESERVED must be at least 3
+#  endif
+
+#  ifndef CONFIG_FTL_LOG_GCFREE
+#    define CONFIG_FTL_LOG_GCFREE 2
+#  endif
+#endif
+
+#define FTL_LOG_HDRMAGIC  0x4c4f4746  /* Erase block header magic */
+#define FTL_LOG_SUMMAGIC  0x4c4f4753  /* Summary magic */
+#define FTL_LOG_UNMAPPED  0xffffffff  /* Logical sector not mapped */
+#define FTL_LOG_NOCOUNT   0xffffffff  /* Erase count not known */
+
+/* Garbage collection runs in the foreground when no more than this number
+ * of free erase blocks remain.  These are kept for the relocated pages.
+ */
+
+#define FTL_LOG_GCMIN     1
+
+/* Erase block states */
+
+#define FTL_LOG_FREE      0           /* Erased with the header written */
+#define FTL_LOG_OPEN      1           /* Currently being written */
+#define FTL_LOG_CLOSED    2           /* Full, the summary is written */
+#define FTL_LOG_PENDING   3           /* Collected, to be erased */
+#define FTL_LOG_BAD       4           /* Erase failed, not used */
+
+/* Size (in bytes and in pages) of the summary of n data pages */
+
+#define FTL_LOG_SUMSIZE(n) \
+  (sizeof(struct ftl_logsum_s) + (n) * sizeof(uint32_t))
+#define FTL_LOG_NSUM(d,n) \
+  ((FTL_LOG_SUMSIZE(n) + (d)->geo.blocksize - 1) / (d)->geo.blocksize)
+#define FTL_LOG_SECTORS(s) ((FAR uint32_t *)((FAR struct ftl_logsum_s *)(s) + 1))
+
+/* The value of an erased byte.  This is the erased state of NOR FLASH; a
+ * page that reads back as all erased bytes may be programmed without first
+ * erasing the erase block that contains it.
+ */
+
+#define FTL_ERASED_STATE 0xff
+
+/* Dirty page bitmap access */
+
+#define FTL_ISDIRTY(d,n)  (((d)->dirty[(n) >> 3] & (1 << ((n) & 7))) != 0)
+#define FTL_SETDIRTY(d,n) ((d)->dirty[(n) >> 3] |= (1 << ((n) & 7)))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+/* On-FLASH erase block header at the start of the first page */
+
+struct ftl_loghdr_s
+{
+  uint32_t magic;                /* FTL_LOG_HDRMAGIC */
+  uint32_t erasecount;           /* Times the erase block has been erased */
+};
+
+/* On-FLASH erase block summary.  It is followed by the logical sector
+ * number of each data page.
+ */
+
+struct ftl_logsum_s
+{
+  uint32_t magic;                /* FTL_LOG_SUMMAGIC */
+  uint32_t sequence;             /* Order in which erase blocks were closed */
+  uint32_t npages;               /* Number of data pages */
+  uint32_t check;                /* Check value of the summary */
+};
+
+/* In-memory state of one erase block */
+
+struct ftl_logblock_s
+{
+  uint32_t erasecount;           /* Times the erase block has been erased */
+  uint16_t nvalid;               /* Number of data pages still mapped */
+  uint16_t npages;               /* Number of data pages written */
+  uint8_t  state;                /* See FTL_LOG_* erase block states */
+};
+
+/* Used to replay the summaries in order at mount time */
+
+struct ftl_logseq_s
+{
+  uint32_t sequence;
+  uint32_t block;
+};
+#endif
+
+struct ftl_struct_s
+{
+  FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
+  struct mtd_geometry_s geo;     /* Device geometry */
+#ifdef FTL_HAVE_RWBUFFER
+  struct rwbuffer_s     rwb;     /* Read-ahead/write buffer support */
+#endif
+  uint16_t              blkper;  /* R/W blocks per erase block */
+#ifdef FTL_HAVE_EBLOCK
+  FAR uint8_t          *eblock;  /* One, in-memory erase block */
+#endif
+#ifdef FTL_HAVE_EXCLSEM
+  sem_t                 exclsem; /* Protects the cache or the log state */
+  FAR uint8_t          *page;    /* One page buffer */
+#endif
+#ifdef CONFIG_FTL_WRITECACHE
+  off_t                 cacheblock; /* Erase block in eblock (-1: none) */
+  uint16_t              ndirty;  /* Number of dirty pages in eblock */
+  FAR uint8_t          *dirty;   /* Bitmap of the dirty pages in eblock */
+#endif
+#ifdef CONFIG_FTL_LOG
+  FAR struct ftl_logblock_s *blocks; /* State of each erase block */
+  FAR uint32_t         *map;     /* Logical sector to physical page map */
+  FAR uint8_t          *summary; /* Summary of the open erase block */
+  FAR uint8_t          *gcsum;   /* Summary read for collection and mount */
+  uint32_t              nsectors; /* Number of logical sectors */
+  uint32_t              sequence; /* Sequence number of the next summary */
+  uint32_t              nfree;   /* Number of free erase blocks */
+  uint32_t              npending; /* Number of erase blocks to be erased */
+  off_t                 openblock; /* Erase block being written (-1: none) */
+  uint16_t              ndata;   /* Data pages per erase block */
+  uint16_t              nextpage; /* Next data page in the open block */
+  bool                  ingc;    /* Garbage collection in progress */
+#ifdef CONFIG_FTL_LOG_BGGC
+  struct work_s         gcwork;  /* Background garbage collection */
+#endif
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     ftl_open(FAR struct inode *inode);
+static int     ftl_close(FAR struct inode *inode);
+static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
+                 off_t startblock, size_t nblocks);
+static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+#ifdef FTL_HAVE_EXCLSEM
+static void    ftl_semtake(FAR struct ftl_struct_s *dev);
+static bool    ftl_isblank(FAR struct ftl_struct_s *dev, off_t block);
+#endif
+#ifdef CONFIG_FTL_WRITECACHE
+static int     ftl_cacheflush(FAR struct ftl_struct_s *dev);
+#endif
+#ifdef CONFIG_FTL_LOG
+static uint32_t ftl_logcheck(FAR const struct ftl_logsum_s *sum);
+static int     ftl_logreadsum(FAR struct ftl_struct_s *dev, off_t eblock,
+                 uint16_t npages, FAR uint8_t *buffer);
+static int     ftl_logerase(FAR struct ftl_struct_s *dev, off_t eblock);
+static int     ftl_logerasepending(FAR struct ftl_struct_s *dev);
+static int     ftl_logopen(FAR struct ftl_struct_s *dev);
+static int     ftl_logclose(FAR struct ftl_struct_s *dev);
+static int     ftl_logroom(FAR struct ftl_struct_s *dev);
+static int     ftl_logappend(FAR struct ftl_struct_s *dev, uint32_t sector,
+                 size_t nblocks, FAR const uint8_t *buffer);
+static int     ftl_loggc(FAR struct ftl_struct_s *dev, uint16_t maxvalid);
+#ifdef CONFIG_FTL_LOG_BGGC
+static void    ftl_loggcworker(FAR void *arg);
+#endif
+static ssize_t ftl_logread(FAR struct ftl_struct_s *dev, FAR uint8_t *buffer,
+                 off_t startblock, size_t nblocks);
+static ssize_t ftl_logwrite(FAR struct ftl_struct_s *dev,
+                 FAR const uint8_t *buffer, off_t startblock,
+                 size_t nblocks);
+static int     ftl_logcompare(FAR const void *a, FAR const void *b);
+static int     ftl_logmount(FAR struct ftl_struct_s *dev);
+static void    ftl_logfree(FAR struct ftl_struct_s *dev);
+#endif
+#ifdef CONFIG_FS_WRITABLE
+static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
+                 off_t startblock, size_t nblocks);
+static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+#endif
+static int     ftl_geometry(FAR struct inode *inode, struct geometry *geometry);
+static int     ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bops =
+{
+  ftl_open,     /* open     */
+  ftl_close,    /* close    */
+  ftl_read,     /* read     */
+#ifdef CONFIG_FS_WRITABLE
+  ftl_write,    /* write    */
+#else
+  NULL,         /* write    */
+#endif
+  ftl_geometry, /* geometry */
+  ftl_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , 0           /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_semtake
+ ****************************************************************************/
+
+#ifdef FTL_HAVE_EXCLSEM
+static void ftl_semtake(FAR struct ftl_struct_s *dev)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(&dev->exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+}
+
+#  define ftl_semgive(d) sem_post(&(d)->exclsem)
+#endif
+
+/****************************************************************************
+ * Name: ftl_isblank
+ *
+ * Description:
+ *   Return true if the R/W block on the FLASH is still in the erased state
+ *   and so can be programmed without erasing its erase block first.
+ *
+ ****************************************************************************/
+
+#ifdef FTL_HAVE_EXCLSEM
+static bool ftl_isblank(FAR struct ftl_struct_s *dev, off_t block)
+{
+  FAR const uint8_t *ptr;
+  ssize_t nxfrd;
+  int i;
+
+  nxfrd = MTD_BREAD(dev->mtd, block, 1, dev->page);
+  if (nxfrd != 1)
+    {
+      return false;
+    }
+
+  for (i = 0, ptr = dev->page; i < dev->geo.blocksize; i++, ptr++)
+    {
+      if (*ptr != FTL_ERASED_STATE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_cacheflush
+ *
+ * Description:
+ *   Write the dirty pages of the cached erase block back to FLASH.  If all
+ *   of the dirty pages are still erased on the FLASH, only the dirty pages
+ *   are programmed and no erase is needed.  Otherwise, the clean pages are
+ *   read into the cache, the erase block is erased and the whole erase
+ *   block is written.  Nothing needs to be read if every page is dirty.
+ *
+ * Assumptions:
+ *   The caller holds the exclsem semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_WRITECACHE
+static int ftl_cacheflush(FAR struct ftl_struct_s *dev)
+{
+  off_t  rwblock;
+  size_t nxfrd;
+  bool   blank;
+  int    start;
+  int    i;
+  int    ret = OK;
+
+  if (dev->cacheblock < 0 || dev->ndirty == 0)
+    {
+      dev->cacheblock = -1;
+      return OK;
+    }
+
+  rwblock = dev->cacheblock * dev->blkper;
+
+  /* Check if the dirty pages can be programmed in place */
+
+  blank = dev->ndirty < dev->blkper;
+  for (i = 0; blank && i < dev->blkper; i++)
+    {
+      if (FTL_ISDIRTY(dev, i))
+        {
+          blank = ftl_isblank(dev, rwblock + i);
+        }
+    }
+
+  if (blank)
+    {
+      /* Program each run of dirty pages */
+
+      for (i = 0; i < dev->blkper; )
+        {
+          if (!FTL_ISDIRTY(dev, i))
+            {
+              i++;
+              continue;
+            }
+
+          for (start = i; i < dev->blkper && FTL_ISDIRTY(dev, i); i++);
+
+          finfo("Program %d blocks at block=%ld\n",
+                i - start, (long)(rwblock + start));
+
+          nxfrd = MTD_BWRITE(dev->mtd, rwblock + start, i - start,
+                             dev->eblock + start * dev->geo.blocksize);
+          if (nxfrd != i - start)
+            {
+              ferr("ERROR: Write block %ld failed: %d\n",
+                   (long)(rwblock + start), (int)nxfrd);
+              ret = -EIO;
+              goto errout;
+            }
+        }
+    }
+  else
+    {
+      /* Read each run of clean pages into the cache */
+
+      for (i = 0; dev->ndirty < dev->blkper && i < dev->blkper; )
+        {
+          if (FTL_ISDIRTY(dev, i))
+            {
+              i++;
+              continue;
+            }
+
+          for (start = i; i < dev->blkper && !FTL_ISDIRTY(dev, i); i++);
+
+          nxfrd = MTD_BREAD(dev->mtd, rwblock + start, i - start,
+                            dev->eblock + start * dev->geo.blocksize);
+          if (nxfrd != i - start)
+            {
+              ferr("ERROR: Read block %ld failed: %d\n",
+                   (long)(rwblock + start), (int)nxfrd);
+              ret = -EIO;
+              goto errout;
+            }
+        }
+
+      /* Then erase the erase block and write it back to flash */
+
+      ret = MTD_ERASE(dev->mtd, dev->cacheblock, 1);
+      if (ret < 0)
+        {
+          ferr("ERROR: Erase block=%ld failed: %d\n",
+               (long)dev->cacheblock, ret);
+          goto errout;
+        }
+
+      finfo("Write %d bytes into erase block=%ld\n",
+            dev->geo.erasesize, (long)dev->cacheblock);
+
+      nxfrd = MTD_BWRITE(dev->mtd, rwblock, dev->blkper, dev->eblock);
+      if (nxfrd != dev->blkper)
+        {
+          ferr("ERROR: Write erase block %ld failed: %d\n",
+               (long)rwblock, (int)nxfrd);
+          ret = -EIO;
+        }
+    }
+
+errout:
+
+  /* The cache is discarded even on failure; retrying the same write back
+   * would fail in the same way.
+   */
+
+  memset(dev->dirty, 0, (dev->blkper + 7) >> 3);
+  dev->ndirty     = 0;
+  dev->cacheblock = -1;
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logcheck
+ *
+ * Description:
+ *   Compute the check value of a summary
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static uint32_t ftl_logcheck(FAR const struct ftl_logsum_s *sum)
+{
+  FAR const uint32_t *sector = FTL_LOG_SECTORS(sum);
+  uint32_t check;
+  uint32_t i;
+
+  check = sum->sequence + sum->npages;
+  for (i = 0; i < sum->npages; i++)
+    {
+      check += sector[i];
+    }
+
+  return ~check;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logreadsum
+ *
+ * Description:
+ *   Read and verify the summary of an erase block with npages data pages.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static int ftl_logreadsum(FAR struct ftl_struct_s *dev, off_t eblock,
+                          uint16_t npages, FAR uint8_t *buffer)
+{
+  FAR struct ftl_logsum_s *sum = (FAR struct ftl_logsum_s *)buffer;
+  size_t nsum = FTL_LOG_NSUM(dev, npages);
+  ssize_t nxfrd;
+
+  nxfrd = MTD_BREAD(dev->mtd, eblock * dev->blkper + 1 + npages, nsum,
+                    buffer);
+  if (nxfrd != nsum)
+    {
+      ferr("ERROR: Read summary of erase block %ld failed: %d\n",
+           (long)eblock, (int)nxfrd);
+      return -EIO;
+    }
+
+  if (sum->magic != FTL_LOG_SUMMAGIC || sum->npages != npages ||
+      sum->check != ftl_logcheck(sum))
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logerase
+ *
+ * Description:
+ *   Erase an erase block and write its header with the new erase count.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static int ftl_logerase(FAR struct ftl_struct_s *dev, off_t eblock)
+{
+  FAR struct ftl_logblock_s *blk = &dev->blocks[eblock];
+  FAR struct ftl_loghdr_s *hdr;
+  ssize_t nxfrd;
+  int ret;
+
+  ret = MTD_ERASE(dev->mtd, eblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%ld failed: %d\n", (long)eblock, ret);
+      return ret;
+    }
+
+  blk->erasecount++;
+
+  memset(dev->page, FTL_ERASED_STATE, dev->geo.blocksize);
+  hdr             = (FAR struct ftl_loghdr_s *)dev->page;
+  hdr->magic      = FTL_LOG_HDRMAGIC;
+  hdr->erasecount = blk->erasecount;
+
+  nxfrd = MTD_BWRITE(dev->mtd, eblock * dev->blkper, 1, dev->page);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write header of erase block %ld failed: %d\n",
+           (long)eblock, (int)nxfrd);
+      return -EIO;
+    }
+
+  blk->state  = FTL_LOG_FREE;
+  blk->nvalid = 0;
+  blk->npages = 0;
+  dev->nfree++;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logerasepending
+ *
+ * Description:
+ *   Erase all collected erase blocks.  This must only be done when the
+ *   pages relocated from them are safely on the FLASH, i.e., when there is
+ *   no open erase block holding pages without a summary.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static int ftl_logerasepending(FAR struct ftl_struct_s *dev)
+{
+  uint32_t eblock;
+  int ret;
+
+  for (eblock = 0; dev->npending > 0 && eblock < dev->geo.neraseblocks;
+       eblock++)
+    {
+      if (dev->blocks[eblock].state == FTL_LOG_PENDING)
+        {
+          dev->npending--;
+          ret = ftl_logerase(dev, eblock);
+          if (ret < 0)
+            {
+              /* Never use this erase block again */
+
+              dev->blocks[eblock].state = FTL_LOG_BAD;
+            }
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logopen
+ *
+ * Description:
+ *   Select the free erase block with the lowest erase count to be written
+ *   next (dynamic wear leveling).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static int ftl_logopen(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_logblock_s *blk;
+  uint32_t eblock;
+  off_t best = -1;
+
+  DEBUGASSERT(dev->openblock < 0);
+
+  /* There is no open erase block, so any collected erase blocks may be
+   * erased now.
+   */
+
+  ftl_logerasepending(dev);
+
+  for (eblock = 0; eblock < dev->geo.neraseblocks; eblock++)
+    {
+      blk = &dev->blocks[eblock];
+      if (blk->state == FTL_LOG_FREE &&
+          (best < 0 || blk->erasecount < dev->blocks[best].erasecount))
+        {
+          best = eblock;
+        }
+    }
+
+  if (best < 0)
+    {
+      ferr("ERROR: No free erase block\n");
+      return -ENOSPC;
+    }
+
+  dev->blocks[best].state = FTL_LOG_OPEN;
+  dev->nfree--;
+  dev->openblock = best;
+  dev->nextpage  = 0;
+  memset(dev->summary, FTL_ERASED_STATE,
+         FTL_LOG_NSUM(dev, dev->ndata) * dev->geo.blocksize);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logclose
+ *
+ * Description:
+ *   Write the summary of the open erase block.  The pages written to it
+ *   will then be found again on the next mount.  Erase blocks waiting for
+ *   their pages to reach the FLASH are then erased.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static int ftl_logclose(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_logsum_s *sum = (FAR struct ftl_logsum_s *)dev->summary;
+  FAR struct ftl_logblock_s *blk;
+  size_t nsum;
+  ssize_t nxfrd;
+
+  if (dev->openblock < 0 || dev->nextpage == 0)
+    {
+      return OK;
+    }
+
+  blk           = &dev->blocks[dev->openblock];
+  sum->magic    = FTL_LOG_SUMMAGIC;
+  sum->sequence = dev->sequence++;
+  sum->npages   = dev->nextpage;
+  sum->check    = ftl_logcheck(sum);
+
+  nsum  = FTL_LOG_NSUM(dev, dev->nextpage);
+  nxfrd = MTD_BWRITE(dev->mtd,
+                     dev->openblock * dev->blkper + 1 + dev->nextpage,
+                     nsum, dev->summary);
+  if (nxfrd != nsum)
+    {
+      ferr("ERROR: Write summary of erase block %ld failed: %d\n",
+           (long)dev->openblock, (int)nxfrd);
+      return -EIO;
+    }
+
+  finfo("Closed erase block %ld: %d pages, %d valid\n",
+        (long)dev->openblock, dev->nextpage, blk->nvalid);
+
+  blk->state     = FTL_LOG_CLOSED;
+  blk->npages    = dev->nextpage;
+  dev->openblock = -1;
+
+  return ftl_logerasepending(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logroom
+ *
+ * Description:
+ *   Make sure that there is an open erase block with at least one free
+ *   data page, closing the current one and garbage collecting as needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static int ftl_logroom(FAR struct ftl_struct_s *dev)
+{
+  int ret;
+
+  if (dev->openblock >= 0 && dev->nextpage < dev->ndata)
+    {
+      return OK;
+    }
+
+  ret = ftl_logclose(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Reclaim space before the last free erase blocks are used.  Pages
+   * relocated by the garbage collection never trigger another collection.
+   */
+
+  if (!dev->ingc)
+    {
+      while (dev->nfree + dev->npending <= FTL_LOG_GCMIN &&
+             ftl_loggc(dev, dev->ndata - 1) >= 0);
+
+      if (dev->openblock >= 0 && dev->nextpage < dev->ndata)
+        {
+          return OK;
+        }
+
+      ret = ftl_logclose(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return ftl_logopen(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logappend
+ *
+ * Description:
+ *   Write sectors to the next free pages of the open erase block and remap
+ *   them.  The caller must assure that they fit in the open erase block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static int ftl_logappend(FAR struct ftl_struct_s *dev, uint32_t sector,
+                         size_t nblocks, FAR const uint8_t *buffer)
+{
+  FAR uint32_t *entry = FTL_LOG_SECTORS(dev->summary);
+  uint32_t page;
+  uint32_t old;
+  ssize_t nxfrd;
+  size_t i;
+
+  DEBUGASSERT(dev->openblock >= 0 &&
+              dev->nextpage + nblocks <= dev->ndata);
+
+  page  = dev->openblock * dev->blkper + 1 + dev->nextpage;
+  nxfrd = MTD_BWRITE(dev->mtd, page, nblocks, buffer);
+  if (nxfrd != nblocks)
+    {
+      ferr("ERROR: Write %d blocks at block %lu failed: %d\n",
+           (int)nblocks, (unsigned long)page, (int)nxfrd);
+      return -EIO;
+    }
+
+  for (i = 0; i < nblocks; i++)
+    {
+      old = dev->map[sector + i];
+      if (old != FTL_LOG_UNMAPPED)
+        {
+          dev->blocks[old / dev->blkper].nvalid--;
+        }
+
+      dev->map[sector + i]     = page + i;
+      entry[dev->nextpage + i] = sector + i;
+      dev->blocks[dev->openblock].nvalid++;
+    }
+
+  dev->nextpage += nblocks;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_loggc
+ *
+ * Description:
+ *   Collect the closed erase block with the fewest valid pages (the least
+ *   worn of them on a tie) provided that it holds no more than maxvalid
+ *   valid pages.  The valid pages are relocated to the open erase block
+ *   and the erase block is erased when that erase block is closed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static int ftl_loggc(FAR struct ftl_struct_s *dev, uint16_t maxvalid)
+{
+  FAR struct ftl_logblock_s *blk;
+  FAR struct ftl_logblock_s *vblk;
+  FAR const uint32_t *entry;
+  uint32_t eblock;
+  uint32_t sector;
+  uint32_t page;
+  off_t victim = -1;
+  ssize_t nxfrd;
+  int ret = OK;
+  int i;
+
+  for (eblock = 0; eblock < dev->geo.neraseblocks; eblock++)
+    {
+      blk = &dev->blocks[eblock];
+      if (blk->state != FTL_LOG_CLOSED)
+        {
+          continue;
+        }
+
+      if (victim < 0 || blk->nvalid < dev->blocks[victim].nvalid ||
+          (blk->nvalid == dev->blocks[victim].nvalid &&
+           blk->erasecount < dev->blocks[victim].erasecount))
+        {
+          victim = eblock;
+        }
+    }
+
+  if (victim < 0 || dev->blocks[victim].nvalid > maxvalid)
+    {
+      return -ENOSPC;
+    }
+
+  vblk = &dev->blocks[victim];
+  finfo("Collect erase block %ld: %d valid pages\n",
+        (long)victim, vblk->nvalid);
+
+  if (vblk->nvalid > 0)
+    {
+      ret = ftl_logreadsum(dev, victim, vblk->npages, dev->gcsum);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      entry     = FTL_LOG_SECTORS(dev->gcsum);
+      dev->ingc = true;
+
+      for (i = 0; i < vblk->npages && vblk->nvalid > 0; i++)
+        {
+          sector = entry[i];
+          page   = victim * dev->blkper + 1 + i;
+          if (sector >= dev->nsectors || dev->map[sector] != page)
+            {
+              continue;
+            }
+
+          ret = ftl_logroom(dev);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nxfrd = MTD_BREAD(dev->mtd, page, 1, dev->page);
+          if (nxfrd != 1)
+            {
+              ret = -EIO;
+              break;
+            }
+
+          ret = ftl_logappend(dev, sector, 1, dev->page);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      dev->ingc = false;
+      if (ret < 0)
+        {
+          ferr("ERROR: Collect erase block %ld failed: %d\n",
+               (long)victim, ret);
+          return ret;
+        }
+    }
+
+  vblk->state = FTL_LOG_PENDING;
+  dev->npending++;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_loggcworker
+ *
+ * Description:
+ *   Garbage collect on the low priority work queue until there are
+ *   CONFIG_FTL_LOG_GCFREE free erase blocks.  Only erase blocks with at
+ *   most half of their pages valid are collected here; the rest is left to
+ *   the foreground collection when it is really needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG_BGGC
+static void ftl_loggcworker(FAR void *arg)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)arg;
+
+  ftl_semtake(dev);
+  while (dev->nfree + dev->npending < CONFIG_FTL_LOG_GCFREE &&
+         ftl_loggc(dev, dev->ndata / 2) >= 0);
+  ftl_semgive(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_logread
+ *
+ * Description:
+ *   Read logical sectors.  Sectors that have never been written read as
+ *   erased.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG
+static ssize_t ftl_logread(FAR struct ftl_struct_s *dev, FAR uint8_t *buffer,
+                           off_t startblock, size_t nblocks)
+{
+  uint32_t page;
+  ssize_t nxfrd;
+  size_t i;
+  size_t n;
+
+  if (startblock >= dev->nsectors)
+    {
+      return 0;
+    }
+
+  if (nblocks > dev->nsectors - startblock)
+    {
+      nblocks = dev->nsectors - startblock;
+    }
+
+  ftl_semtake(dev);
+  for (i = 0; i < nblocks; i += n, buffer += n * dev->geo.blocksize)
+    {
+      page = dev->map[startblock + i];
+      if (page == FTL_LOG_UNMAPPED)
+        {
+          memset(buffer, FTL_ERASED_STATE, dev->geo.blocksize);
+          n = 1;
+          continue;
+        }
+
+      /* Read all of the sectors that follow in the same order on FLASH in
+       * one transfer.
+       */
+
+      for (n = 1; i + n < nblocks && dev->map[startblock + i + n] == page + n;
+           n++);
+
+      nxfrd = MTD_BREAD(dev->mtd, page, n, buffer);
+      if (nxfrd != n)
+        {
+          ferr("ERROR: Read %d blocks at block %lu failed: %d\n",
+               (int)n, (unsigned long)page, (int)nxfrd);
+          ftl_semgive(dev);
+          return -EIO;
+        }
+    }
+
+  ftl_semgive(dev);
+  return nblocks;
+}
+#endif
+
 /****************************************************************************
- * Private Types
+ * Name: ftl_logwrite
+ *
+ * Description:
+ *   Write logical sectors out-of-place to the open erase block.
+ *
  ****************************************************************************/
 
-struct ftl_struct_s
+#ifdef CONFIG_FTL_LOG
+static ssize_t ftl_logwrite(FAR struct ftl_struct_s *dev,
+                            FAR const uint8_t *buffer, off_t startblock,
+                            size_t nblocks)
 {
-  FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
-  struct mtd_geometry_s geo;     /* Device geometry */
-#ifdef FTL_HAVE_RWBUFFER
-  struct rwbuffer_s     rwb;     /* Read-ahead/write buffer support */
+  size_t remaining;
+  size_t n;
+  int ret = OK;
+
+  if (startblock >= dev->nsectors || nblocks > dev->nsectors - startblock)
+    {
+      return -EINVAL;
+    }
+
+  ftl_semtake(dev);
+  for (remaining = nblocks; remaining > 0; remaining -= n)
+    {
+      ret = ftl_logroom(dev);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      n = dev->ndata - dev->nextpage;
+      if (n > remaining)
+        {
+          n = remaining;
+        }
+
+      ret = ftl_logappend(dev, startblock, n, buffer);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      startblock += n;
+      buffer     += n * dev->geo.blocksize;
+    }
+
+#ifdef CONFIG_FTL_LOG_BGGC
+  /* Start collecting in the background if free space is getting low */
+
+  if (dev->nfree + dev->npending < CONFIG_FTL_LOG_GCFREE &&
+      work_available(&dev->gcwork))
+    {
+      (void)work_queue(LPWORK, &dev->gcwork, ftl_loggcworker, dev, 0);
+    }
 #endif
-  uint16_t              blkper;  /* R/W blocks per erase block */
-#ifdef CONFIG_FS_WRITABLE
-  FAR uint8_t          *eblock;  /* One, in-memory erase block */
+
+  ftl_semgive(dev);
+  return ret < 0 ? ret : nblocks;
+}
 #endif
-};
 
 /****************************************************************************
- * Private Function Prototypes
+ * Name: ftl_logcompare
+ *
+ * Description:
+ *   qsort() comparison of summary sequence numbers
+ *
  ****************************************************************************/
 
-static int     ftl_open(FAR struct inode *inode);
-static int     ftl_close(FAR struct inode *inode);
-static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
-                 off_t startblock, size_t nblocks);
-static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
-                 size_t start_sector, unsigned int nsectors);
-#ifdef CONFIG_FS_WRITABLE
-static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
-                 off_t startblock, size_t nblocks);
-static ssize_t ftl_write(FAR struct inode *inode, const unsigned char *buffer,
-                 size_t start_sector, unsigned int nsectors);
+#ifdef CONFIG_FTL_LOG
+static int ftl_logcompare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct ftl_logseq_s *seqa = (FAR const struct ftl_logseq_s *)a;
+  FAR const struct ftl_logseq_s *seqb = (FAR const struct ftl_logseq_s *)b;
+
+  if (seqa->sequence < seqb->sequence)
+    {
+      return -1;
+    }
+
+  return seqa->sequence > seqb->sequence ? 1 : 0;
+}
 #endif
-static int     ftl_geometry(FAR struct inode *inode, struct geometry *geometry);
-static int     ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
 
 /****************************************************************************
- * Private Data
+ * Name: ftl_logmount
+ *
+ * Description:
+ *   Rebuild the logical-to-physical map by scanning the FLASH.  Summaries
+ *   are replayed in the order they were written so that the most recent
+ *   copy of each sector wins.  Erase blocks without a valid header and
+ *   erase blocks that were open (and so have no summary) are erased.  An
+ *   unformatted FLASH is thereby formatted.
+ *
  ****************************************************************************/
 
-static const struct block_operations g_bops =
+#ifdef CONFIG_FTL_LOG
+static int ftl_logmount(FAR struct ftl_struct_s *dev)
 {
-  ftl_open,     /* open     */
-  ftl_close,    /* close    */
-  ftl_read,     /* read     */
-#ifdef CONFIG_FS_WRITABLE
-  ftl_write,    /* write    */
-#else
-  NULL,         /* write    */
-#endif
-  ftl_geometry, /* geometry */
-  ftl_ioctl     /* ioctl    */
-#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , 0           /* unlink   */
+  FAR struct ftl_logseq_s *seqs;
+  FAR struct ftl_logblock_s *blk;
+  FAR struct ftl_loghdr_s *hdr;
+  FAR const uint32_t *entry;
+  uint32_t nclosed = 0;
+  uint32_t nknown  = 0;
+  uint32_t total   = 0;
+  uint32_t eblock;
+  uint32_t sector;
+  uint32_t page;
+  uint32_t i;
+  uint16_t npages;
+  uint16_t last;
+  ssize_t nxfrd;
+  int ret;
+
+  seqs = (FAR struct ftl_logseq_s *)
+    kmm_malloc(dev->geo.neraseblocks * sizeof(struct ftl_logseq_s));
+  if (!seqs)
+    {
+      return -ENOMEM;
+    }
+
+  memset(dev->map, 0xff, dev->nsectors * sizeof(uint32_t));
+  dev->nfree     = 0;
+  dev->npending  = 0;
+  dev->sequence  = 0;
+  dev->openblock = -1;
+  dev->ingc      = false;
+
+  for (eblock = 0; eblock < dev->geo.neraseblocks; eblock++)
+    {
+      blk = &dev->blocks[eblock];
+      memset(blk, 0, sizeof(struct ftl_logblock_s));
+
+      page  = eblock * dev->blkper;
+      nxfrd = MTD_BREAD(dev->mtd, page, 1, dev->page);
+      hdr   = (FAR struct ftl_loghdr_s *)dev->page;
+
+      if (nxfrd != 1 || hdr->magic != FTL_LOG_HDRMAGIC)
+        {
+          blk->erasecount = FTL_LOG_NOCOUNT;
+          blk->state      = FTL_LOG_PENDING;
+          dev->npending++;
+          continue;
+        }
+
+      blk->erasecount = hdr->erasecount;
+      total          += hdr->erasecount;
+      nknown++;
+
+      /* Data pages are written in order, so the erase block is free if the
+       * first data page is still erased.
+       */
+
+      if (ftl_isblank(dev, page + 1))
+        {
+          blk->state = FTL_LOG_FREE;
+          dev->nfree++;
+          continue;
+        }
+
+      /* Otherwise the summary ends at the last page that is written, if the
+       * erase block was closed.
+       */
+
+      for (last = dev->blkper - 1; last > 1 && ftl_isblank(dev, page + last);
+           last--);
+
+      blk->state = FTL_LOG_PENDING;
+      for (npages = last - 1; npages > 0; npages--)
+        {
+          if (npages + FTL_LOG_NSUM(dev, npages) < last)
+            {
+              break;
+            }
+
+          if (npages <= dev->ndata &&
+              npages + FTL_LOG_NSUM(dev, npages) == last &&
+              ftl_logreadsum(dev, eblock, npages, dev->gcsum) == OK)
+            {
+              blk->state  = FTL_LOG_CLOSED;
+              blk->npages = npages;
+
+              seqs[nclosed].sequence =
+                ((FAR struct ftl_logsum_s *)dev->gcsum)->sequence;
+              seqs[nclosed].block    = eblock;
+              nclosed++;
+              break;
+            }
+        }
+
+      if (blk->state == FTL_LOG_PENDING)
+        {
+          finfo("Erase block %lu was not closed\n", (unsigned long)eblock);
+          dev->npending++;
+        }
+    }
+
+  /* Erase blocks without a header get the average erase count */
+
+  for (eblock = 0; eblock < dev->geo.neraseblocks; eblock++)
+    {
+      if (dev->blocks[eblock].erasecount == FTL_LOG_NOCOUNT)
+        {
+          dev->blocks[eblock].erasecount = nknown > 0 ? total / nknown : 0;
+        }
+    }
+
+  /* Replay the summaries in the order they were written */
+
+  qsort(seqs, nclosed, sizeof(struct ftl_logseq_s), ftl_logcompare);
+  for (i = 0; i < nclosed; i++)
+    {
+      eblock = seqs[i].block;
+      blk    = &dev->blocks[eblock];
+      ret    = ftl_logreadsum(dev, eblock, blk->npages, dev->gcsum);
+      if (ret < 0)
+        {
+          kmm_free(seqs);
+          return ret;
+        }
+
+      entry = FTL_LOG_SECTORS(dev->gcsum);
+      for (npages = 0; npages < blk->npages; npages++)
+        {
+          sector = entry[npages];
+          if (sector >= dev->nsectors)
+            {
+              continue;
+            }
+
+          page = dev->map[sector];
+          if (page != FTL_LOG_UNMAPPED)
+            {
+              dev->blocks[page / dev->blkper].nvalid--;
+            }
+
+          dev->map[sector] = eblock * dev->blkper + 1 + npages;
+          blk->nvalid++;
+        }
+
+      dev->sequence = seqs[i].sequence + 1;
+    }
+
+  kmm_free(seqs);
+
+  finfo("%lu closed, %lu free and %lu pending erase blocks\n",
+        (unsigned long)nclosed, (unsigned long)dev->nfree,
+        (unsigned long)dev->npending);
+
+  return ftl_logerasepending(dev);
+}
 #endif
-};
 
 /****************************************************************************
- * Private Functions
+ * Name: ftl_logfree
+ *
+ * Description:
+ *   Free the memory used by the log-structured mode
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_LOG
+static void ftl_logfree(FAR struct ftl_struct_s *dev)
+{
+  kmm_free(dev->blocks);
+  kmm_free(dev->map);
+  kmm_free(dev->summary);
+  kmm_free(dev->gcsum);
+  kmm_free(dev->page);
+}
+#endif
+
 /****************************************************************************
  * Name: ftl_open
  *
@@ -163,15 +1345,50 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   ssize_t nread;
 
+#ifdef CONFIG_FTL_LOG
+  /* Find the sectors through the logical-to-physical map */
+
+  nread   = ftl_logread(dev, buffer, startblock, nblocks);
+#else
   /* Read the full erase block into the buffer */
 
   nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
+#endif
+
   if (nread != nblocks)
     {
       ferr("ERROR: Read %d blocks starting at block %d failed: %d\n",
             nblocks, startblock, nread);
     }
 
+#ifdef CONFIG_FTL_WRITECACHE
+  /* Replace any blocks that are newer in the write cache */
+
+  if (nread > 0)
+    {
+      off_t rwblock;
+      off_t block;
+
+      ftl_semtake(dev);
+      if (dev->cacheblock >= 0)
+        {
+          rwblock = dev->cacheblock * dev->blkper;
+          for (block = startblock; block < startblock + nread; block++)
+            {
+              if (block >= rwblock && block < rwblock + dev->blkper &&
+                  FTL_ISDIRTY(dev, block - rwblock))
+                {
+                  memcpy(buffer + (block - startblock) * dev->geo.blocksize,
+                         dev->eblock + (block - rwblock) * dev->geo.blocksize,
+                         dev->geo.blocksize);
+                }
+            }
+        }
+
+      ftl_semgive(dev);
+    }
+#endif
+
   return nread;
 }
 
@@ -206,7 +1423,89 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_FS_WRITABLE
+#if defined(CONFIG_FTL_LOG)
+static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
+                         off_t startblock, size_t nblocks)
+{
+  struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+
+  /* Write the sectors out-of-place */
+
+  return ftl_logwrite(dev, buffer, startblock, nblocks);
+}
+
+#elif defined(CONFIG_FTL_WRITECACHE)
+static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
+                         off_t startblock, size_t nblocks)
+{
+  struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
+  off_t  eraseblock;
+  size_t remaining;
+  int    offset;
+  int    nbytes;
+  int    count;
+  int    i;
+  int    ret;
+
+  /* Combine the writes in the cached erase block.  The cached erase block
+   * is written back when a write targets a different erase block or when
+   * every page of it has been written.
+   */
+
+  ftl_semtake(dev);
+  for (remaining = nblocks; remaining > 0; remaining -= count)
+    {
+      eraseblock = startblock / dev->blkper;
+      if (eraseblock != dev->cacheblock)
+        {
+          ret = ftl_cacheflush(dev);
+          if (ret < 0)
+            {
+              ftl_semgive(dev);
+              return ret;
+            }
+
+          dev->cacheblock = eraseblock;
+        }
+
+      offset = startblock - eraseblock * dev->blkper;
+      count  = dev->blkper - offset;
+      if (count > remaining)
+        {
+          count = remaining;
+        }
+
+      nbytes = count * dev->geo.blocksize;
+      memcpy(dev->eblock + offset * dev->geo.blocksize, buffer, nbytes);
+
+      for (i = offset; i < offset + count; i++)
+        {
+          if (!FTL_ISDIRTY(dev, i))
+            {
+              FTL_SETDIRTY(dev, i);
+              dev->ndirty++;
+            }
+        }
+
+      if (dev->ndirty >= dev->blkper)
+        {
+          ret = ftl_cacheflush(dev);
+          if (ret < 0)
+            {
+              ftl_semgive(dev);
+              return ret;
+            }
+        }
+
+      startblock += count;
+      buffer     += nbytes;
+    }
+
+  ftl_semgive(dev);
+  return nblocks;
+}
+
+#elif defined(CONFIG_FS_WRITABLE)
 static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
                          off_t startblock, size_t nblocks)
 {
@@ -425,7 +1724,11 @@ static int ftl_geometry(FAR struct inode *inode, struct geometry *geometry)
 #else
       geometry->geo_writeenabled  = false;
 #endif
+#ifdef CONFIG_FTL_LOG
+      geometry->geo_nsectors      = dev->nsectors;
+#else
       geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#endif
       geometry->geo_sectorsize    = dev->geo.blocksize;
 
       finfo("available: true mediachanged: false writeenabled: %s\n",
@@ -454,8 +1757,37 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   finfo("Entry\n");
   DEBUGASSERT(inode && inode->i_private);
 
-  /* Only one block driver ioctl command is supported by this driver (and
-   * that command is just passed on to the MTD driver in a slightly
+  dev = (struct ftl_struct_s *)inode->i_private;
+
+  /* BIOC_FLUSH writes back any data held in the write buffer and in the
+   * write cache or in the open erase block of the log.
+   */
+
+  if (cmd == BIOC_FLUSH)
+    {
+#ifdef CONFIG_FTL_WRITEBUFFER
+      (void)rwb_flush(&dev->rwb);
+#endif
+      ret = OK;
+#ifdef CONFIG_FTL_WRITECACHE
+      ftl_semtake(dev);
+      ret = ftl_cacheflush(dev);
+      ftl_semgive(dev);
+#endif
+#ifdef CONFIG_FTL_LOG
+      /* This closes the open erase block early so that the sectors written
+       * to it are found again after a reset.
+       */
+
+      ftl_semtake(dev);
+      ret = ftl_logclose(dev);
+      ftl_semgive(dev);
+#endif
+      return ret;
+    }
+
+  /* Only one other block driver ioctl command is supported by this driver
+   * (and that command is just passed on to the MTD driver in a slightly
    * different form).
    */
 
@@ -484,7 +1816,6 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
    * to the MTD driver (unchanged).
    */
 
-  dev = (struct ftl_struct_s *)inode->i_private;
   ret = MTD_IOCTL(dev->mtd, cmd, arg);
   if (ret < 0)
     {
@@ -550,7 +1881,7 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
 
       /* Allocate one, in-memory erase block buffer */
 
-#ifdef CONFIG_FS_WRITABLE
+#ifdef FTL_HAVE_EBLOCK
       dev->eblock  = (FAR uint8_t *)kmm_malloc(dev->geo.erasesize);
       if (!dev->eblock)
         {
@@ -565,11 +1896,101 @@ int ftl_initialize(int minor, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+      /* The erase block buffer is also the write cache.  Allocate the
+       * dirty page bitmap and a page buffer for blank checks.
+       */
+
+#ifdef CONFIG_FTL_WRITECACHE
+      dev->dirty = (FAR uint8_t *)kmm_zalloc((dev->blkper + 7) >> 3);
+      dev->page  = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+      if (!dev->dirty || !dev->page)
+        {
+          ferr("ERROR: Failed to allocate the write cache\n");
+          if (dev->dirty)
+            {
+              kmm_free(dev->dirty);
+            }
+
+          if (dev->page)
+            {
+              kmm_free(dev->page);
+            }
+
+          kmm_free(dev->eblock);
+          kmm_free(dev);
+          return -ENOMEM;
+        }
+
+      sem_init(&dev->exclsem, 0, 1);
+      dev->cacheblock = -1;
+      dev->ndirty     = 0;
+#endif
+
+      /* Set up the log-structured mode.  Each erase block holds a header
+       * page, ndata data pages and the summary of those pages.  Some erase
+       * blocks are reserved for garbage collection.
+       */
+
+#ifdef CONFIG_FTL_LOG
+      for (dev->ndata = dev->blkper - 2;
+           dev->ndata > 0 &&
+           1 + dev->ndata + FTL_LOG_NSUM(dev, dev->ndata) > dev->blkper;
+           dev->ndata--);
+
+      if (dev->ndata == 0 ||
+          dev->geo.neraseblocks <= CONFIG_FTL_LOG_NRESERVED)
+        {
+          ferr("ERROR: FLASH too small for the log-structured FTL\n");
+          kmm_free(dev);
+          return -EINVAL;
+        }
+
+      dev->nsectors = (dev->geo.neraseblocks - CONFIG_FTL_LOG_NRESERVED) *
+                      dev->ndata;
+
+      dev->blocks   = (FAR struct ftl_logblock_s *)
+        kmm_malloc(dev->geo.neraseblocks * sizeof(struct ftl_logblock_s));
+      dev->map      = (FAR uint32_t *)
+        kmm_malloc(dev->nsectors * sizeof(uint32_t));
+      dev->summary  = (FAR uint8_t *)
+        kmm_malloc(FTL_LOG_NSUM(dev, dev->ndata) * dev->geo.blocksize);
+      dev->gcsum    = (FAR uint8_t *)
+        kmm_malloc(FTL_LOG_NSUM(dev, dev->ndata) * dev->geo.blocksize);
+      dev->page     = (FAR uint8_t *)kmm_malloc(dev->geo.blocksize);
+
+      if (!dev->blocks || !dev->map || !dev->summary || !dev->gcsum ||
+          !dev->page)
+        {
+          ferr("ERROR: Failed to allocate the FTL map\n");
+          ftl_logfree(dev);
+          kmm_free(dev);
+          return -ENOMEM;
+        }
+
+      sem_init(&dev->exclsem, 0, 1);
+#ifdef CONFIG_FTL_LOG_BGGC
+      memset(&dev->gcwork, 0, sizeof(struct work_s));
+#endif
+
+      ret = ftl_logmount(dev);
+      if (ret < 0)
+        {
+          ferr("ERROR: ftl_logmount failed: %d\n", ret);
+          ftl_logfree(dev);
+          kmm_free(dev);
+          return ret;
+        }
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize   = dev->geo.blocksize;
+#ifdef CONFIG_FTL_LOG
+      dev->rwb.nblocks     = dev->nsectors;
+#else
       dev->rwb.nblocks     = dev->geo.neraseblocks * dev->blkper;
+#endif
       dev->rwb.dev         = (FAR void *)dev;
 
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
@@ -53,6 +53,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/mtd/spinor.h>
 
 /************************************************************************************
  * Pre-processor Definitions
@@ -78,6 +79,18 @@
  * International MX25 serial FLASH, the correct manufacturer ID would be 0xc2.
  */
 
+/* The Fast Read instruction adds one dummy byte after the address but may be
+ * clocked at higher SPI frequencies than the Read instruction.
+ */
+
+#ifdef CONFIG_M25P_FASTREAD
+#  define M25P_RDCMD     M25P_FAST_READ
+#  define M25P_RDDUMMY   1
+#else
+#  define M25P_RDCMD     M25P_READ
+#  define M25P_RDDUMMY   0
+#endif
+
 #ifndef CONFIG_M25P_MANUFACTURER
 #  define CONFIG_M25P_MANUFACTURER 0x20
 #endif
@@ -521,19 +534,10 @@ static void m25p_sectorerase(struct m25p_dev_s *priv, off_t sector, uint8_t type
   SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
   /* Send the "Sector Erase (SE)" or Sub-Sector Erase (SSE) instruction
-   * that was passed in as the erase type.
+   * that was passed in as the erase type, followed by the sector offset.
    */
 
-  (void)SPI_SEND(priv->dev, type);
-
-  /* Send the sector offset high byte first.  For all of the supported
-   * parts, the sector number is completely contained in the first byte
-   * and the values used in the following two bytes don't really matter.
-   */
-
-  (void)SPI_SEND(priv->dev, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->dev, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->dev, offset & 0xff);
+  spinor_command(priv->dev, type, offset, SPINOR_ADDR3, 0);
 
   /* Deselect the FLASH */
 
@@ -603,19 +607,12 @@ static inline void m25p_pagewrite(struct m25p_dev_s *priv, FAR const uint8_t *bu
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
-  /* Send "Page Program (PP)" command */
-
-  (void)SPI_SEND(priv->dev, M25P_PP);
-
-  /* Send the page offset high byte first. */
-
-  (void)SPI_SEND(priv->dev, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->dev, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->dev, offset & 0xff);
-
-  /* Then write the specified number of bytes */
+  /* Send "Page Program (PP)" command and the page offset, then write the
+   * page.
+   */
 
-  SPI_SNDBLOCK(priv->dev, buffer, 1 << priv->pageshift);
+  spinor_write(priv->dev, M25P_PP, offset, SPINOR_ADDR3, buffer,
+               1 << priv->pageshift);
 
   /* Deselect the FLASH: Chip Select high */
 
@@ -649,19 +646,11 @@ static inline void m25p_bytewrite(struct m25p_dev_s *priv, FAR const uint8_t *bu
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
-  /* Send "Page Program (PP)" command */
-
-  (void)SPI_SEND(priv->dev, M25P_PP);
-
-  /* Send the page offset high byte first. */
-
-  (void)SPI_SEND(priv->dev, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->dev, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->dev, offset & 0xff);
-
-  /* Then write the specified number of bytes */
+  /* Send "Page Program (PP)" command and the offset, then write the
+   * specified number of bytes.
+   */
 
-  SPI_SNDBLOCK(priv->dev, buffer, count);
+  spinor_write(priv->dev, M25P_PP, offset, SPINOR_ADDR3, buffer, count);
 
   /* Deselect the FLASH: Chip Select high */
 
@@ -811,19 +800,12 @@ static ssize_t m25p_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes,
   m25p_lock(priv->dev);
   SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
-  /* Send "Read from Memory " instruction */
-
-  (void)SPI_SEND(priv->dev, M25P_READ);
-
-  /* Send the page offset high byte first. */
-
-  (void)SPI_SEND(priv->dev, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->dev, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->dev, offset & 0xff);
-
-  /* Then read all of the requested bytes */
+  /* Send "Read from Memory " instruction and the offset, then read all of
+   * the requested bytes in one transfer.
+   */
 
-  SPI_RECVBLOCK(priv->dev, buffer, nbytes);
+  spinor_read(priv->dev, M25P_RDCMD, offset, SPINOR_ADDR3, M25P_RDDUMMY,
+              buffer, nbytes);
 
   /* Deselect the FLASH and unlock the SPI bus */
 
@@ -58,6 +58,9 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mtd/nand.h>
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+#  include <nuttx/mtd/bchecc.h>
+#endif
 #include <nuttx/mtd/onfi.h>
 #include <nuttx/mtd/nand_raw.h>
 #include <nuttx/mtd/nand_scheme.h>
@@ -950,6 +953,20 @@ FAR struct mtd_dev_s *nand_initialize(FAR struct nand_raw_s *raw)
       (void)onfi_embeddedecc(&onfi, cmdaddr, addraddr, dataaddr, false);
     }
 
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  /* Build the BCH tables before the first page is accessed */
+
+  if (raw->ecctype == NANDECC_SWECC)
+    {
+      ret = bchecc_initialize();
+      if (ret < 0)
+        {
+          ferr("ERROR: bchecc_initialize failed: %d\n", ret);
+          return NULL;
+        }
+    }
+#endif
+
   /* Allocate an NAND MTD device structure */
 
   nand = (FAR struct nand_dev_s *)kmm_zalloc(sizeof(struct nand_dev_s));
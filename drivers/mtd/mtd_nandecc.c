@@ -54,7 +54,11 @@
 #include <debug.h>
 
 #include <nuttx/mtd/nand.h>
-#include <nuttx/mtd/hamming.h>
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+#  include <nuttx/mtd/bchecc.h>
+#else
+#  include <nuttx/mtd/hamming.h>
+#endif
 #include <nuttx/mtd/nand_scheme.h>
 #include <nuttx/mtd/nand_ecc.h>
 
@@ -62,6 +66,48 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nandecc_bchlayout
+ *
+ * Description:
+ *   The BCH ECC is too large for the ECC byte positions of the Hamming
+ *   schemes.  It is stored instead as one contiguous run at the end of the
+ *   spare area, BCHECC_ECCBYTES for each BCHECC_STEPSIZE step of data.
+ *   Return the offset of the ECC in the spare area or a negated errno value
+ *   if the page does not have room for it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+static int nandecc_bchlayout(FAR struct nand_model_s *model,
+                             unsigned int pagesize, unsigned int sparesize)
+{
+  FAR const struct nand_scheme_s *scheme;
+  unsigned int eccbytes;
+
+  if (pagesize == 0 || (pagesize % BCHECC_STEPSIZE) != 0)
+    {
+      ferr("ERROR: Page size %u not supported by BCH\n", pagesize);
+      return -EINVAL;
+    }
+
+  scheme   = nandmodel_getscheme(model);
+  eccbytes = (pagesize / BCHECC_STEPSIZE) * BCHECC_ECCBYTES;
+
+  if (eccbytes >= sparesize || sparesize - eccbytes <= scheme->bbpos)
+    {
+      ferr("ERROR: No room for %u BCH ECC bytes in spare\n", eccbytes);
+      return -EINVAL;
+    }
+
+  return sparesize - eccbytes;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -92,7 +138,19 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
 {
   FAR struct nand_raw_s *raw;
   FAR struct nand_model_s *model;
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  uint8_t calcecc[BCHECC_ECCBYTES];
+  FAR uint8_t *readecc;
+  FAR uint8_t *step;
+  unsigned int nsteps;
+  unsigned int i;
+  int offset;
+#  ifdef CONFIG_MTD_NAND_ECCENGINE
+  FAR const struct nand_eccengine_s *engine;
+#  endif
+#else
   FAR const struct nand_scheme_s *scheme;
+#endif
   unsigned int pagesize;
   unsigned int sparesize;
   int ret;
@@ -110,6 +168,14 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
   pagesize  = nandmodel_getpagesize(model);
   sparesize = nandmodel_getsparesize(model);
 
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  offset = nandecc_bchlayout(model, pagesize, sparesize);
+  if (offset < 0)
+    {
+      return offset;
+    }
+#endif
+
   /* Store code in spare buffer, either the buffer provided by the caller or
    * the scatch buffer in the raw NAND structure.
    */
@@ -129,6 +195,16 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
       return ret;
     }
 
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+  /* Let the ECC engine compute the ECC while the data is transferred */
+
+  engine = raw->eccengine;
+  if (engine != NULL && engine->enable != NULL)
+    {
+      engine->enable(raw);
+    }
+#endif
+
   /* Then reading the data */
 
   ret = NAND_RAWREAD(nand->raw, block, page, data, 0);
@@ -138,6 +214,56 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
       return ret;
     }
 
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  /* Verify and correct each step of the page against the ECC in the spare */
+
+  if (data == NULL)
+    {
+      return OK;
+    }
+
+  nsteps  = pagesize / BCHECC_STEPSIZE;
+  readecc = (FAR uint8_t *)spare + offset;
+  step    = (FAR uint8_t *)data;
+
+  for (i = 0; i < nsteps; i++)
+    {
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+      if (engine != NULL)
+        {
+          ret = engine->calculate(raw, i, step, calcecc);
+          if (ret >= 0)
+            {
+              ret = engine->correct != NULL ?
+                    engine->correct(raw, i, step, readecc, calcecc) :
+                    bchecc_correct(step, readecc, calcecc);
+            }
+        }
+      else
+#endif
+        {
+          bchecc_calculate(step, calcecc);
+          ret = bchecc_correct(step, readecc, calcecc);
+        }
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Block=%d page=%d step=%u Unrecoverable error: %d\n",
+               block, page, i, ret);
+          return -EIO;
+        }
+      else if (ret > 0)
+        {
+          fwarn("WARNING: Block=%d page=%d step=%u corrected %d bits\n",
+                block, page, i, ret);
+        }
+
+      readecc += BCHECC_ECCBYTES;
+      step    += BCHECC_STEPSIZE;
+    }
+
+  return OK;
+#else
   /* Retrieve ECC information from page */
 
   scheme = nandmodel_getscheme(model);
@@ -154,6 +280,7 @@ int nandecc_readpage(FAR struct nand_dev_s *nand, off_t block,
     }
 
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -184,7 +311,18 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 {
   FAR struct nand_raw_s *raw;
   FAR struct nand_model_s *model;
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  FAR const uint8_t *step;
+  FAR uint8_t *ecc;
+  unsigned int nsteps;
+  unsigned int i;
+  int offset;
+#  ifdef CONFIG_MTD_NAND_ECCENGINE
+  FAR const struct nand_eccengine_s *engine;
+#  endif
+#else
   FAR const struct nand_scheme_s *scheme;
+#endif
   unsigned int pagesize;
   unsigned int sparesize;
   int ret;
@@ -202,6 +340,60 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
   pagesize  = nandmodel_getpagesize(model);
   sparesize = nandmodel_getsparesize(model);
 
+#ifdef CONFIG_MTD_NAND_SWECC_BCH
+  offset = nandecc_bchlayout(model, pagesize, sparesize);
+  if (offset < 0)
+    {
+      return offset;
+    }
+
+  if (!spare)
+    {
+      spare = raw->spare;
+      memset(spare, 0xff, sparesize);
+    }
+
+  /* Compute the ECC of each step of the new data directly into the spare.
+   * Without new data, the ECC bytes are left erased so that the existing
+   * ECC is not disturbed by programming the spare.
+   */
+
+  ecc = (FAR uint8_t *)spare + offset;
+  if (data)
+    {
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+      engine = raw->eccengine;
+#endif
+      nsteps = pagesize / BCHECC_STEPSIZE;
+      step   = (FAR const uint8_t *)data;
+
+      for (i = 0; i < nsteps; i++)
+        {
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+          if (engine != NULL)
+            {
+              ret = engine->calculate(raw, i, step, ecc);
+              if (ret < 0)
+                {
+                  ferr("ERROR: ECC engine failed: %d\n", ret);
+                  return ret;
+                }
+            }
+          else
+#endif
+            {
+              bchecc_calculate(step, ecc);
+            }
+
+          ecc  += BCHECC_ECCBYTES;
+          step += BCHECC_STEPSIZE;
+        }
+    }
+  else
+    {
+      memset(ecc, 0xff, sparesize - offset);
+    }
+#else
   /* Set hamming code set to 0xffff.. to keep existing bytes */
 
   memset(raw->ecc, 0xff, CONFIG_MTD_NAND_MAXSPAREECCBYTES);
@@ -229,6 +421,7 @@ int nandecc_writepage(FAR struct nand_dev_s *nand, off_t block,
 
   scheme = nandmodel_getscheme(model);
   nandscheme_writeecc(scheme, spare, raw->ecc);
+#endif
 
   /* Perform page write operation */
 
@@ -58,6 +58,8 @@
 #include <crc16.h>
 #include <crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -130,6 +132,51 @@
 #  define  CONFIG_MTD_SMART_SECTOR_SIZE 1024
 #endif
 
+/* Background garbage collection.  The worker tries to keep
+ * CONFIG_MTD_SMART_GC_FREEBLOCKS erase blocks worth of free sectors on top
+ * of the reserve that makes the foreground collector run, and only collects
+ * blocks in which at least a quarter of the sectors have been released.
+ */
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#  ifndef CONFIG_MTD_SMART_GC_FREEBLOCKS
+#    define CONFIG_MTD_SMART_GC_FREEBLOCKS 2
+#  endif
+#  define SMART_GC_WATERMARK(d) \
+     ((d)->sectorsPerBlk * (CONFIG_MTD_SMART_GC_FREEBLOCKS + 1) + 4)
+#  define SMART_GC_MINRELEASED(d) (((d)->sectorsPerBlk + 3) >> 2)
+#  define SMART_GC_DELAY        MSEC2TICK(10)
+#endif
+
+/* Mount snapshot.  The last CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS erase blocks
+ * are removed from the volume.  The sector map (with the free and release
+ * counts that follow it in memory) and the free sector bit-map are saved
+ * there when the device is closed, and the header, which is validated by a
+ * CRC and by a generation number that must match the one at the start of
+ * the data, is saved last in the final R/W block.
+ */
+
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+#  ifndef CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS
+#    define CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS 1
+#  endif
+#  define SMART_SNAP_MAGIC      "SMsn"
+#  define SMART_SNAP_MAPSIZE(d) \
+     ((d)->totalsectors * sizeof(uint16_t) + ((d)->neraseblocks << 1))
+#  ifdef CONFIG_MTD_SMART_FREEMAP
+#    define SMART_SNAP_FREEMAPSIZE(d) (((d)->totalsectors + 7) >> 3)
+#  else
+#    define SMART_SNAP_FREEMAPSIZE(d) 0
+#  endif
+#  define SMART_SNAP_DATALEN(d) \
+     (sizeof(uint32_t) + SMART_SNAP_MAPSIZE(d) + SMART_SNAP_FREEMAPSIZE(d))
+#  define SMART_SNAP_FIRSTBLOCK(d) \
+     ((off_t)(d)->snapblock * ((d)->geo.erasesize / (d)->geo.blocksize))
+#  define SMART_SNAP_HDRBLOCK(d) \
+     (SMART_SNAP_FIRSTBLOCK(d) + CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS * \
+      ((d)->geo.erasesize / (d)->geo.blocksize) - 1)
+#endif
+
 #ifndef offsetof
 #define offsetof(type, member) ( (size_t) &( ( (type *) 0)->member))
 #endif
@@ -213,6 +260,30 @@ struct smart_allocsector_s
 };
 #endif
 
+/* Mount snapshot header.  Saved in the last R/W block of the reserved
+ * erase blocks after the snapshot data.
+ */
+
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+struct smart_snaphdr_s
+{
+  uint8_t               magic[4];         /* SMART_SNAP_MAGIC */
+  uint32_t              generation;       /* Incremented by each snapshot */
+  uint32_t              datalen;          /* Number of bytes of snapshot data */
+  uint32_t              datacrc;          /* CRC-32 of the snapshot data */
+  uint16_t              sectorsize;       /* Sector size of the volume */
+  uint16_t              totalsectors;     /* Total number of sectors */
+  uint16_t              neraseblocks;     /* Number of erase blocks */
+  uint16_t              freesectors;      /* Total number of free sectors */
+  uint16_t              releasesectors;   /* Total number of released sectors */
+  uint16_t              lastallocblock;   /* Last block we allocated a sector from */
+  uint8_t               formatversion;    /* Format version on the device */
+  uint8_t               namesize;         /* Length of filenames on this device */
+  uint8_t               pad[2];
+  uint32_t              crc;              /* CRC-32 of the fields above */
+};
+#endif
+
 struct smart_struct_s
 {
   FAR struct mtd_dev_s *mtd;              /* Contained MTD interface */
@@ -264,9 +335,21 @@ struct smart_struct_s
   uint16_t              cache_lastphys;   /* Keep the physical sector number also */
   uint16_t              cache_nextbirth;  /* Sector cache aging value */
 #endif
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  FAR uint8_t          *freemap;          /* Physical sector known-free bit-map */
+#endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+  sem_t                 exclsem;          /* Serializes foreground and background access */
+  struct work_s         gcwork;           /* Background garbage collection work */
+#endif
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+  uint16_t              snapblock;        /* First snapshot erase block (0 = none) */
+  bool                  snapvalid;        /* True: The snapshot on the media is current */
+  uint32_t              snapgen;          /* Generation of the last snapshot */
+#endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
@@ -381,12 +464,34 @@ static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int smart_read_wearstatus(FAR struct smart_struct_s *dev);
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static int smart_write_wearstatus(FAR struct smart_struct_s *dev);
+#endif
 static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t block);
 #endif
 
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
                  uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+static int smart_snapload(FAR struct smart_struct_s *dev);
+static int smart_snapsave(FAR struct smart_struct_s *dev);
+static void smart_snapinvalidate(FAR struct smart_struct_s *dev);
+#else
+#  define smart_snapinvalidate(d)
+#endif
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_lock(FAR struct smart_struct_s *dev);
+static void smart_gcworker(FAR void *arg);
+static void smart_gcschedule(FAR struct smart_struct_s *dev);
+#  define smart_unlock(d) sem_post(&(d)->exclsem)
+#else
+#  define smart_lock(d)
+#  define smart_unlock(d)
+#  define smart_gcschedule(d)
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
@@ -454,10 +559,53 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+  FAR struct smart_struct_s *dev;
+#endif
+
   finfo("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+  /* Save the sector map so that the next smart_initialize() need not scan
+   * the media.  There is nothing to do if nothing has been written since
+   * the last snapshot was saved or loaded.
+   */
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct smart_struct_s *)inode->i_private;
+
+  smart_lock(dev);
+  (void)smart_snapsave(dev);
+  smart_unlock(dev);
+#endif
+
   return OK;
 }
 
+/****************************************************************************
+ * Name: smart_lock
+ *
+ * Description: Get exclusive access to the device.  Only needed when the
+ *              background garbage collector may run concurrently.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_lock(FAR struct smart_struct_s *dev)
+{
+  /* Take the semaphore (perhaps waiting) */
+
+  while (sem_wait(&dev->exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if
+       * the wait was awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_malloc
  *
@@ -649,6 +797,127 @@ static void smart_add_count(struct smart_struct_s *dev, uint8_t *pCount,
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_header_erased
+ *
+ * Description: Test if a sector header read from the media is still in the
+ *              erased state, i.e. the sector is available for allocation.
+ *
+ ****************************************************************************/
+
+static inline bool smart_header_erased(FAR struct smart_sect_header_s *header)
+{
+  return (*((FAR uint16_t *) header->logicalsector) == 0xffff) &&
+#if SMART_STATUS_VERSION == 1
+         (*((FAR uint16_t *) &header->seq) == 0xffff) &&
+#else
+         (header->seq == CONFIG_SMARTFS_ERASEDSTATE) &&
+#endif
+         ((header->status & SMART_STATUS_COMMITTED) ==
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED));
+}
+
+/****************************************************************************
+ * Name: smart_freemap_setblock
+ *
+ * Description: Mark all usable physical sectors of an erase block as free
+ *              (after an erase) or as unknown (after it was written behind
+ *              our back) in the free sector bitmap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_FREEMAP
+static void smart_freemap_setblock(FAR struct smart_struct_s *dev,
+                                   uint16_t block, bool isfree)
+{
+  uint32_t sector;
+  uint32_t end;
+
+  sector = (uint32_t)block * dev->sectorsPerBlk;
+  end    = sector + dev->availSectPerBlk;
+  if (end > dev->totalsectors)
+    {
+      end = dev->totalsectors;
+    }
+
+  for (; sector < end; sector++)
+    {
+      if (isfree)
+        {
+          dev->freemap[sector >> 3] |= (1 << (sector & 7));
+        }
+      else
+        {
+          dev->freemap[sector >> 3] &= ~(1 << (sector & 7));
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_freemap_alloc
+ *
+ * Description: Take the first sector of the erase block that is marked as
+ *              free in the free sector bitmap.  Its header is read back once
+ *              to make sure that it really is erased; stale entries are
+ *              dropped and the search continues.  Returns 0xffff if the
+ *              bitmap has no (more) free sectors for this block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_FREEMAP
+static uint16_t smart_freemap_alloc(FAR struct smart_struct_s *dev,
+                                    uint16_t block)
+{
+  struct   smart_sect_header_s header;
+  uint32_t readaddr;
+  uint32_t sector;
+  uint32_t end;
+  int      ret;
+
+  sector = (uint32_t)block * dev->sectorsPerBlk;
+  end    = sector + dev->availSectPerBlk;
+  if (end > dev->totalsectors)
+    {
+      end = dev->totalsectors;
+    }
+
+  while (sector < end)
+    {
+      /* Skip over whole bytes with no free sectors */
+
+      if ((sector & 7) == 0 && dev->freemap[sector >> 3] == 0)
+        {
+          sector += 8;
+          continue;
+        }
+
+      if ((dev->freemap[sector >> 3] & (1 << (sector & 7))) == 0)
+        {
+          sector++;
+          continue;
+        }
+
+      /* Either way, this sector is no longer available after this */
+
+      dev->freemap[sector >> 3] &= ~(1 << (sector & 7));
+
+      readaddr = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+      ret = MTD_READ(dev->mtd, readaddr, sizeof(struct smart_sect_header_s),
+                     (FAR uint8_t *) &header);
+      if (ret == sizeof(struct smart_sect_header_s) &&
+          smart_header_erased(&header))
+        {
+          return (uint16_t)sector;
+        }
+
+      sector++;
+    }
+
+  return 0xffff;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_checkfree
  *
@@ -801,6 +1070,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           size_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %d nsectors: %d\n", start_sector, nsectors);
 
@@ -810,7 +1080,11 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = (struct smart_struct_s *)inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  smart_lock(dev);
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -847,7 +1121,8 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  smart_lock(dev);
+  smart_snapinvalidate(dev);
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -886,11 +1161,20 @@ static ssize_t smart_write(FAR struct inode *inode,
           if (ret < 0)
             {
               ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
+              smart_unlock(dev);
+              return ret;
+            }
 
-              /* Unlock the mutex if we add one */
+#ifdef CONFIG_MTD_SMART_FREEMAP
+          /* The block is rewritten with raw data.  Forget about its free
+           * sectors so that the allocator re-reads their headers.
+           */
 
-              return ret;
+          if (dev->freemap != NULL)
+            {
+              smart_freemap_setblock(dev, eraseblock, false);
             }
+#endif
         }
 
       /* Calculate the number of blocks to write. */
@@ -915,9 +1199,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           /* The block is not empty!!  What to do? */
 
           ferr("ERROR: Write block %d failed: %d.\n", nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
+          smart_unlock(dev);
           return -EIO;
         }
 
@@ -929,6 +1211,7 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdBlksPerErase;
     }
 
+  smart_unlock(dev);
   return nsectors;
 }
 #endif /* CONFIG_FS_WRITABLE */
@@ -1084,6 +1367,14 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  if (dev->freemap != NULL)
+    {
+      smart_free(dev, dev->freemap);
+      dev->freemap = NULL;
+    }
+#endif
+
   /* Allocate a virtual to physical sector map buffer.  Also allocate
    * the storage space for releasecount and freecounts.
    */
@@ -1186,6 +1477,22 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 
 #endif  /* CONFIG_MTD_SMART_MINIMIZE_RAM */
 
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  /* Allocate the free physical sector bit-map.  It is filled in by
+   * smart_scan() or smart_llformat().
+   */
+
+  dev->freemap = (FAR uint8_t *) smart_malloc(dev, (totalsectors + 7) >> 3,
+                                              "Free map");
+  if (dev->freemap == NULL)
+    {
+      ferr("ERROR: Error allocating SMART free sector bit-map\n");
+      goto errexit;
+    }
+
+  memset(dev->freemap, 0, (totalsectors + 7) >> 3);
+#endif
+
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   /* Allocate a buffer to hold the erase counts */
 
@@ -1262,6 +1569,13 @@ errexit:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  if (dev->freemap)
+    {
+      smart_free(dev, dev->freemap);
+    }
+#endif
+
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   if (dev->erasecounts)
     {
@@ -1920,6 +2234,10 @@ static int smart_scan(FAR struct smart_struct_s *dev)
   memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
 #endif
 
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  memset(dev->freemap, 0, (dev->totalsectors + 7) >> 3);
+#endif
+
   /* Now scan the MTD device */
 
   for (sector = 0; sector < totalsectors; sector++)
@@ -1954,6 +2272,16 @@ static int smart_scan(FAR struct smart_struct_s *dev)
       if ((header.status & SMART_STATUS_COMMITTED) ==
               (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
         {
+#ifdef CONFIG_MTD_SMART_FREEMAP
+          /* Remember erased sectors so that they can be allocated without
+           * reading their headers again.
+           */
+
+          if (smart_header_erased(&header))
+            {
+              dev->freemap[sector >> 3] |= (1 << (sector & 7));
+            }
+#endif
           continue;
         }
 
@@ -2369,6 +2697,342 @@ err_out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_snapxfer
+ *
+ * Description:  Save or load the snapshot data (the generation number, the
+ *               sector map with the free and release counts, and the free
+ *               sector bit-map) one sector at a time through the rwbuffer,
+ *               beginning at the first snapshot erase block.  Returns the
+ *               CRC-32 of the data in *crc.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+static int smart_snapxfer(FAR struct smart_struct_s *dev,
+                          FAR uint32_t *generation, bool save,
+                          FAR uint32_t *crc)
+{
+  FAR uint8_t *segbuf[3];
+  size_t       seglen[3];
+  FAR uint8_t *buffer;
+  size_t       remaining;
+  size_t       nbytes;
+  size_t       pos;
+  off_t        block;
+  int          nsegs;
+  int          ret;
+  int          i;
+
+  segbuf[0] = (FAR uint8_t *)generation;
+  seglen[0] = sizeof(uint32_t);
+  segbuf[1] = (FAR uint8_t *)dev->sMap;
+  seglen[1] = SMART_SNAP_MAPSIZE(dev);
+  nsegs     = 2;
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  segbuf[2] = dev->freemap;
+  seglen[2] = SMART_SNAP_FREEMAPSIZE(dev);
+  nsegs     = 3;
+#endif
+
+  block = SMART_SNAP_FIRSTBLOCK(dev);
+  *crc  = 0;
+  pos   = 0;
+
+  for (i = 0; i < nsegs; i++)
+    {
+      buffer    = segbuf[i];
+      remaining = seglen[i];
+
+      while (remaining > 0)
+        {
+          if (pos == 0 && !save)
+            {
+              ret = MTD_BREAD(dev->mtd, block, dev->mtdBlksPerSector,
+                              (FAR uint8_t *)dev->rwbuffer);
+              if (ret != dev->mtdBlksPerSector)
+                {
+                  ferr("ERROR: Error reading snapshot block %d\n", block);
+                  return -EIO;
+                }
+            }
+
+          nbytes = dev->sectorsize - pos;
+          if (nbytes > remaining)
+            {
+              nbytes = remaining;
+            }
+
+          if (save)
+            {
+              memcpy(&dev->rwbuffer[pos], buffer, nbytes);
+            }
+          else
+            {
+              memcpy(buffer, &dev->rwbuffer[pos], nbytes);
+            }
+
+          *crc       = crc32part(buffer, nbytes, *crc);
+          buffer    += nbytes;
+          remaining -= nbytes;
+          pos       += nbytes;
+
+          /* Write the last sector even if it is only partially filled */
+
+          if (save && (pos == dev->sectorsize ||
+                       (remaining == 0 && i == nsegs - 1)))
+            {
+              memset(&dev->rwbuffer[pos], CONFIG_SMARTFS_ERASEDSTATE,
+                     dev->sectorsize - pos);
+
+              ret = MTD_BWRITE(dev->mtd, block, dev->mtdBlksPerSector,
+                               (FAR uint8_t *)dev->rwbuffer);
+              if (ret != dev->mtdBlksPerSector)
+                {
+                  ferr("ERROR: Error writing snapshot block %d\n", block);
+                  return -EIO;
+                }
+            }
+
+          if (pos == dev->sectorsize)
+            {
+              block += dev->mtdBlksPerSector;
+              pos    = 0;
+            }
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_snapload
+ *
+ * Description:  Restore the state that smart_scan() would rebuild from the
+ *               snapshot saved when the device was last closed.  Returns a
+ *               negated errno value if there is no current snapshot, in
+ *               which case the caller must scan the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+static int smart_snapload(FAR struct smart_struct_s *dev)
+{
+  struct smart_snaphdr_s hdr;
+  uint32_t generation;
+  uint32_t crc;
+  int ret;
+
+  if (dev->snapblock == 0)
+    {
+      return -ENOENT;
+    }
+
+  /* Read and validate the header */
+
+  ret = MTD_BREAD(dev->mtd, SMART_SNAP_HDRBLOCK(dev), 1,
+                  (FAR uint8_t *)dev->rwbuffer);
+  if (ret != 1)
+    {
+      ferr("ERROR: Error reading snapshot header: %d\n", ret);
+      return -EIO;
+    }
+
+  memcpy(&hdr, dev->rwbuffer, sizeof(struct smart_snaphdr_s));
+  if (memcmp(hdr.magic, SMART_SNAP_MAGIC, sizeof(hdr.magic)) != 0 ||
+      crc32((FAR const uint8_t *)&hdr,
+            offsetof(struct smart_snaphdr_s, crc)) != hdr.crc)
+    {
+      finfo("No snapshot\n");
+      return -ENOENT;
+    }
+
+  /* Set up the arrays for the saved sector size and make sure that the
+   * snapshot was taken of a volume with the same geometry.
+   */
+
+  ret = smart_setsectorsize(dev, hdr.sectorsize);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  if (hdr.totalsectors != dev->totalsectors ||
+      hdr.neraseblocks != dev->neraseblocks ||
+      hdr.datalen != SMART_SNAP_DATALEN(dev))
+    {
+      fwarn("WARNING: Snapshot geometry mismatch\n");
+      return -ESTALE;
+    }
+
+  /* Read the data.  The generation number at the beginning of the data
+   * must match the one in the header.
+   */
+
+  ret = smart_snapxfer(dev, &generation, false, &crc);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (generation != hdr.generation || crc != hdr.datacrc)
+    {
+      fwarn("WARNING: Snapshot %lu is incomplete\n",
+            (unsigned long)hdr.generation);
+      return -EBADMSG;
+    }
+
+  dev->freesectors    = hdr.freesectors;
+  dev->releasesectors = hdr.releasesectors;
+  dev->lastallocblock = hdr.lastallocblock;
+  dev->formatversion  = hdr.formatversion;
+  dev->namesize       = hdr.namesize;
+  dev->formatstatus   = SMART_FMT_STAT_FORMATTED;
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  /* Read the wear leveling status bits */
+
+  smart_read_wearstatus(dev);
+#endif
+
+  /* The snapshot stays on the media until the volume is modified */
+
+  dev->snapvalid = true;
+  dev->snapgen   = hdr.generation;
+
+  finfo("Loaded snapshot %lu: %d free, %d released sectors\n",
+        (unsigned long)hdr.generation, dev->freesectors,
+        dev->releasesectors);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_snapsave
+ *
+ * Description:  Save a snapshot of the sector map if the media has been
+ *               modified since the last snapshot was saved or loaded.  The
+ *               header is written last so that a snapshot interrupted by
+ *               a power loss is never used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+static int smart_snapsave(FAR struct smart_struct_s *dev)
+{
+  struct smart_snaphdr_s hdr;
+  uint32_t generation;
+  uint32_t datalen;
+  uint32_t crc;
+  int ret;
+
+  if (dev->snapblock == 0 || dev->snapvalid ||
+      dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return OK;
+    }
+
+  /* The data is written in whole sectors and must leave room for the
+   * header at the end.
+   */
+
+  datalen = SMART_SNAP_DATALEN(dev);
+  if ((datalen + 2 * dev->sectorsize - 1) / dev->sectorsize * dev->sectorsize >
+      CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS * dev->geo.erasesize)
+    {
+      fwarn("WARNING: Snapshot of %lu bytes does not fit\n",
+            (unsigned long)datalen);
+      return -ENOSPC;
+    }
+
+  ret = MTD_ERASE(dev->mtd, dev->snapblock,
+                  CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase of snapshot blocks failed: %d\n", ret);
+      return ret;
+    }
+
+  generation = dev->snapgen + 1;
+  ret = smart_snapxfer(dev, &generation, true, &crc);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Now commit the snapshot by writing the header */
+
+  memset(&hdr, 0, sizeof(struct smart_snaphdr_s));
+  memcpy(hdr.magic, SMART_SNAP_MAGIC, sizeof(hdr.magic));
+  hdr.generation     = generation;
+  hdr.datalen        = datalen;
+  hdr.datacrc        = crc;
+  hdr.sectorsize     = dev->sectorsize;
+  hdr.totalsectors   = dev->totalsectors;
+  hdr.neraseblocks   = dev->neraseblocks;
+  hdr.freesectors    = dev->freesectors;
+  hdr.releasesectors = dev->releasesectors;
+  hdr.lastallocblock = dev->lastallocblock;
+  hdr.formatversion  = dev->formatversion;
+  hdr.namesize       = dev->namesize;
+  hdr.crc            = crc32((FAR const uint8_t *)&hdr,
+                             offsetof(struct smart_snaphdr_s, crc));
+
+  memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+  memcpy(dev->rwbuffer, &hdr, sizeof(struct smart_snaphdr_s));
+
+  ret = MTD_BWRITE(dev->mtd, SMART_SNAP_HDRBLOCK(dev), 1,
+                   (FAR uint8_t *)dev->rwbuffer);
+  if (ret != 1)
+    {
+      ferr("ERROR: Error writing snapshot header: %d\n", ret);
+      return -EIO;
+    }
+
+  dev->snapvalid = true;
+  dev->snapgen   = generation;
+
+  finfo("Saved snapshot %lu\n", (unsigned long)generation);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_snapinvalidate
+ *
+ * Description:  Called before the media is modified.  Erases the snapshot
+ *               header so that the snapshot is not used if the device is
+ *               not closed again before it is next initialized.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+static void smart_snapinvalidate(FAR struct smart_struct_s *dev)
+{
+  int ret;
+
+  if (!dev->snapvalid)
+    {
+      return;
+    }
+
+  ret = MTD_ERASE(dev->mtd, dev->snapblock +
+                  CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS - 1, 1);
+  if (ret < 0)
+    {
+      /* Try to clear the header magic instead */
+
+      ferr("ERROR: Erase of snapshot header failed: %d\n", ret);
+      memset(dev->rwbuffer, 0, dev->geo.blocksize);
+      (void)MTD_BWRITE(dev->mtd, SMART_SNAP_HDRBLOCK(dev), 1,
+                       (FAR uint8_t *)dev->rwbuffer);
+    }
+
+  dev->snapvalid = false;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_getformat
  *
@@ -2475,6 +3139,9 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
       dev->blockerases++;
 #endif
       MTD_ERASE(dev->mtd, block, 1);
+#ifdef CONFIG_MTD_SMART_FREEMAP
+      smart_freemap_setblock(dev, block, true);
+#endif
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
       if (dev->erasecounts)
@@ -3021,6 +3688,17 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
   dev->freecount[0]--;
 #endif
 
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  /* Everything except the format sector is now erased */
+
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+      smart_freemap_setblock(dev, x, true);
+    }
+
+  dev->freemap[0] &= ~1;
+#endif
+
   /* Now initialize the logical to physical sector map */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
@@ -3347,6 +4025,9 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
   /* Now erase the erase block */
 
   MTD_ERASE(dev->mtd, block, 1);
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  smart_freemap_setblock(dev, block, true);
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   dev->unusedsectors += freecount;
   dev->blockerases++;
@@ -3596,6 +4277,19 @@ retry:
   /* Now find a free physical sector within this selected
    * erase block to allocate. */
 
+#ifdef CONFIG_MTD_SMART_FREEMAP
+  /* The free sector bitmap normally gives us the sector directly.  Fall
+   * back to scanning the sector headers only if it has nothing.
+   */
+
+  physicalsector = smart_freemap_alloc(dev, allocblock);
+  if (physicalsector != 0xffff)
+    {
+      dev->lastallocblock = allocblock;
+      return physicalsector;
+    }
+#endif
+
   for (x = allocblock * dev->sectorsPerBlk;
        x < allocblock * dev->sectorsPerBlk + dev->availSectPerBlk; x++)
     {
@@ -3639,17 +4333,13 @@ retry:
           return -1;
         }
 
-      if ((*((FAR uint16_t *) header.logicalsector) == 0xffff) &&
-#if SMART_STATUS_VERSION == 1
-          (*((FAR uint16_t *) &header.seq) == 0xffff) &&
-#else
-          (header.seq == CONFIG_SMARTFS_ERASEDSTATE) &&
-#endif
-          ((header.status & SMART_STATUS_COMMITTED) ==
-           (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED)))
+      if (smart_header_erased(&header))
         {
           physicalsector = x;
           dev->lastallocblock = allocblock;
+#ifdef CONFIG_MTD_SMART_FREEMAP
+          dev->freemap[x >> 3] &= ~(1 << (x & 7));
+#endif
           break;
         }
     }
@@ -3667,6 +4357,51 @@ retry:
   return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_findcollectblock
+ *
+ * Description:  Find the erase block with the most released sectors that
+ *               may be collected.  Returns 0xffff if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static uint16_t smart_findcollectblock(FAR struct smart_struct_s *dev,
+                                       FAR uint16_t *releasemax)
+{
+  uint16_t  collectblock;
+  uint16_t  count;
+  int       x;
+
+  collectblock = 0xffff;
+  *releasemax = 0;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+#else
+      count = dev->releasecount[x];
+#endif
+      if (count > *releasemax)
+        {
+          *releasemax = count;
+          collectblock = x;
+        }
+    }
+
+  return collectblock;
+}
+#endif /* CONFIG_FS_WRITABLE */
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -3682,11 +4417,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
   uint16_t  collectblock;
   uint16_t  releasemax;
   bool      collect = TRUE;
-  int       x;
   int       ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t   count;
-#endif
 
   while (collect)
     {
@@ -3715,37 +4446,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
-
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
-
-          //releasemax = smart_get_count(dev, dev->releasecount, collectblock);
-
+          collectblock = smart_findcollectblock(dev, &releasemax);
           if (collectblock == 0xffff)
             {
               /* Need to collect, but no sectors with released blocks! */
@@ -3796,6 +4497,94 @@ errout:
 }
 #endif /* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_gcworker
+ *
+ * Description:  Background garbage collection.  Runs on the low priority
+ *               work queue and relocates one erase block per invocation so
+ *               that the device lock is never held for longer than that.
+ *               It re-queues itself until the number of free sectors is
+ *               back above the watermark or no block is worth collecting.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gcworker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+  uint16_t  collectblock;
+  uint16_t  releasemax;
+  int       ret;
+
+  smart_lock(dev);
+
+  if (dev->formatstatus == SMART_FMT_STAT_FORMATTED &&
+      dev->freesectors < SMART_GC_WATERMARK(dev))
+    {
+      /* Don't bother with blocks that would mostly be copied; leave those
+       * to the foreground collector.
+       */
+
+      collectblock = smart_findcollectblock(dev, &releasemax);
+      if (collectblock != 0xffff &&
+          releasemax >= SMART_GC_MINRELEASED(dev))
+        {
+          finfo("Background collecting block %d, released=%d free=%d\n",
+                collectblock, releasemax, dev->freesectors);
+
+          smart_snapinvalidate(dev);
+
+          ret = smart_relocate_block(dev, collectblock);
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+          if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+            {
+              /* Write new wear status bits to the device */
+
+              smart_write_wearstatus(dev);
+            }
+#endif
+
+          if (ret == OK)
+            {
+              /* See if there is more to do */
+
+              smart_gcschedule(dev);
+            }
+          else
+            {
+              ferr("ERROR: Background collection of block %d failed: %d\n",
+                   collectblock, ret);
+            }
+        }
+    }
+
+  smart_unlock(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_gcschedule
+ *
+ * Description:  Schedule background garbage collection if the number of
+ *               free sectors fell below the watermark.  Called with the
+ *               device locked after each operation that consumes sectors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gcschedule(FAR struct smart_struct_s *dev)
+{
+  if (dev->freesectors < SMART_GC_WATERMARK(dev) &&
+      dev->releasesectors >= SMART_GC_MINRELEASED(dev) &&
+      work_available(&dev->gcwork))
+    {
+      (void)work_queue(LPWORK, &dev->gcwork, smart_gcworker, dev,
+                       SMART_GC_DELAY);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -5113,6 +5902,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = (FAR struct smart_struct_s *)inode->i_private;
 #endif
 
+  smart_lock(dev);
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5129,7 +5920,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       if (arg == 0)
         {
           ferr("ERROR: BIOC_XIPBASE argument is NULL\n");
-          return -EINVAL;
+          ret = -EINVAL;
+          goto ok_out;
         }
 #endif
 
@@ -5161,6 +5953,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       /* Perform a low-level format on the flash */
 
+      smart_snapinvalidate(dev);
       ret = smart_llformat(dev, arg);
       goto ok_out;
 
@@ -5175,20 +5968,25 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
       /* Allocate a logical sector for the upper layer file system */
 
+      smart_snapinvalidate(dev);
       ret = smart_allocsector(dev, arg);
+      smart_gcschedule(dev);
       goto ok_out;
 
     case BIOC_FREESECT:
 
       /* Free the specified logical sector */
 
+      smart_snapinvalidate(dev);
       ret = smart_freesector(dev, arg);
+      smart_gcschedule(dev);
       goto ok_out;
 
     case BIOC_WRITESECT:
 
       /* Write to the sector */
 
+      smart_snapinvalidate(dev);
       ret = smart_writesector(dev, arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
@@ -5200,6 +5998,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
         }
 #endif
 
+      smart_gcschedule(dev);
       goto ok_out;
 #endif /* CONFIG_FS_WRITABLE */
 
@@ -5271,6 +6070,7 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+  smart_unlock(dev);
   return ret;
 }
 
@@ -5333,6 +6133,20 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
           goto errout;
         }
 
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+      /* Remove the snapshot erase blocks from the end of the volume */
+
+      dev->snapblock = 0;
+      dev->snapvalid = false;
+      dev->snapgen   = 0;
+
+      if (dev->geo.neraseblocks > 2 * CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS)
+        {
+          dev->geo.neraseblocks -= CONFIG_MTD_SMART_SNAPSHOT_NBLOCKS;
+          dev->snapblock = dev->geo.neraseblocks;
+        }
+#endif
+
       /* Set the sector size to the default for now */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
@@ -5348,8 +6162,15 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
       dev->wearstatus = NULL;
 #endif
+#ifdef CONFIG_MTD_SMART_FREEMAP
+      dev->freemap = NULL;
+#endif
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
       dev->allocsector = NULL;
+#endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+      sem_init(&dev->exclsem, 0, 1);
+      memset(&dev->gcwork, 0, sizeof(struct work_s));
 #endif
       dev->sectorsize = 0;
       ret = smart_setsectorsize(dev, CONFIG_MTD_SMART_SECTOR_SIZE);
@@ -5394,13 +6215,21 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
       dev->minor = minor;
 #endif
 
-      /* Do a scan of the device */
+      /* Restore the state saved when the device was last closed or, if
+       * there is no current snapshot, do a scan of the device.
+       */
 
-      ret = smart_scan(dev);
+#ifdef CONFIG_MTD_SMART_SNAPSHOT
+      ret = smart_snapload(dev);
       if (ret < 0)
+#endif
         {
-          ferr("ERROR: smart_scan failed: %d\n", -ret);
-          goto errout;
+          ret = smart_scan(dev);
+          if (ret < 0)
+            {
+              ferr("ERROR: smart_scan failed: %d\n", -ret);
+              goto errout;
+            }
         }
 
       /* Create a MTD block device name */
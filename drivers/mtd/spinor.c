@@ -0,0 +1,135 @@
+/****************************************************************************
+ * drivers/mtd/spinor.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/spi/spi.h>
+#include <nuttx/mtd/spinor.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SPINOR_DUMMY  0xff
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spinor_command
+ *
+ * Description:
+ *   Send a SPI NOR FLASH instruction, its address (most significant byte
+ *   first) and any dummy bytes as one SPI block transfer.
+ *
+ ****************************************************************************/
+
+void spinor_command(FAR struct spi_dev_s *spi, uint8_t cmd, uint32_t addr,
+                    unsigned int addrlen, unsigned int ndummy)
+{
+  uint8_t hdr[1 + SPINOR_ADDR4 + SPINOR_MAXDUMMY];
+  unsigned int len;
+
+  DEBUGASSERT(addrlen <= SPINOR_ADDR4 && ndummy <= SPINOR_MAXDUMMY);
+
+  len = 0;
+  hdr[len++] = cmd;
+
+  if (addrlen >= SPINOR_ADDR4)
+    {
+      hdr[len++] = (addr >> 24) & 0xff;
+    }
+
+  if (addrlen >= SPINOR_ADDR3)
+    {
+      hdr[len++] = (addr >> 16) & 0xff;
+      hdr[len++] = (addr >> 8) & 0xff;
+      hdr[len++] = addr & 0xff;
+    }
+
+  memset(&hdr[len], SPINOR_DUMMY, ndummy);
+  len += ndummy;
+
+  if (len == 1)
+    {
+      (void)SPI_SEND(spi, cmd);
+    }
+  else
+    {
+      SPI_SNDBLOCK(spi, hdr, len);
+    }
+}
+
+/****************************************************************************
+ * Name: spinor_read
+ *
+ * Description:
+ *   Send a read instruction and receive all of the data in one block.
+ *
+ ****************************************************************************/
+
+void spinor_read(FAR struct spi_dev_s *spi, uint8_t cmd, uint32_t addr,
+                 unsigned int addrlen, unsigned int ndummy,
+                 FAR void *buffer, size_t nbytes)
+{
+  spinor_command(spi, cmd, addr, addrlen, ndummy);
+  SPI_RECVBLOCK(spi, buffer, nbytes);
+}
+
+/****************************************************************************
+ * Name: spinor_write
+ *
+ * Description:
+ *   Send a program instruction and send all of the data in one block.
+ *
+ ****************************************************************************/
+
+void spinor_write(FAR struct spi_dev_s *spi, uint8_t cmd, uint32_t addr,
+                  unsigned int addrlen, FAR const void *buffer,
+                  size_t nbytes)
+{
+  spinor_command(spi, cmd, addr, addrlen, 0);
+  SPI_SNDBLOCK(spi, buffer, nbytes);
+}
@@ -63,6 +63,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/mtd/spinor.h>
 
 /************************************************************************************
  * Pre-processor Definitions
@@ -502,19 +503,10 @@ static void sst26_sectorerase(struct sst26_dev_s *priv, off_t sector, uint8_t ty
   SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
   /* Send the "Sector Erase (SE)" or "Block Erase (BE)" instruction
-   * that was passed in as the erase type.
+   * that was passed in as the erase type, followed by the sector offset.
    */
 
-  (void)SPI_SEND(priv->dev, type);
-
-  /* Send the sector offset high byte first.  For all of the supported
-   * parts, the sector number is completely contained in the first byte
-   * and the values used in the following two bytes don't really matter.
-   */
-
-  (void)SPI_SEND(priv->dev, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->dev, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->dev, offset & 0xff);
+  spinor_command(priv->dev, type, offset, SPINOR_ADDR3, 0);
 
   /* Deselect the FLASH */
 
@@ -574,19 +566,12 @@ static inline void sst26_pagewrite(struct sst26_dev_s *priv,
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
-  /* Send "Page Program (PP)" command */
-
-  (void)SPI_SEND(priv->dev, SST26_PP);
-
-  /* Send the page offset high byte first. */
-
-  (void)SPI_SEND(priv->dev, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->dev, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->dev, offset & 0xff);
-
-  /* Then write the specified number of bytes */
+  /* Send "Page Program (PP)" command and the page offset, then write the
+   * page.
+   */
 
-  SPI_SNDBLOCK(priv->dev, buffer, 1 << priv->pageshift);
+  spinor_write(priv->dev, SST26_PP, offset, SPINOR_ADDR3, buffer,
+               1 << priv->pageshift);
 
   /* Deselect the FLASH: Chip Select high */
 
@@ -616,19 +601,11 @@ static inline void sst26_bytewrite(struct sst26_dev_s *priv,
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
-  /* Send "Page Program (PP)" command */
-
-  (void)SPI_SEND(priv->dev, SST26_PP);
-
-  /* Send the page offset high byte first. */
-
-  (void)SPI_SEND(priv->dev, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->dev, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->dev, offset & 0xff);
-
-  /* Then write the specified number of bytes */
+  /* Send "Page Program (PP)" command and the offset, then write the
+   * specified number of bytes.
+   */
 
-  SPI_SNDBLOCK(priv->dev, buffer, count);
+  spinor_write(priv->dev, SST26_PP, offset, SPINOR_ADDR3, buffer, count);
   priv->lastwaswrite = true;
 
   /* Deselect the FLASH: Chip Select high */
@@ -739,23 +716,12 @@ static ssize_t sst26_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes
   sst26_lock(priv->dev);
   SPI_SELECT(priv->dev, SPIDEV_FLASH, true);
 
-  /* Send "Read from Memory " instruction */
-
-  (void)SPI_SEND(priv->dev, SST26_FAST_READ);
-
-  /* Send the page offset high byte first. */
-
-  (void)SPI_SEND(priv->dev, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->dev, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->dev, offset & 0xff);
-
-  /* Dummy read */
-
-  (void)SPI_SEND(priv->dev, SST26_DUMMY);
-
-  /* Then read all of the requested bytes */
+  /* Send the "Fast Read" instruction, the offset and one dummy byte, then
+   * read all of the requested bytes in one transfer.
+   */
 
-  SPI_RECVBLOCK(priv->dev, buffer, nbytes);
+  spinor_read(priv->dev, SST26_FAST_READ, offset, SPINOR_ADDR3, 1,
+              buffer, nbytes);
 
   /* Deselect the FLASH and unlock the SPI bus */
 
@@ -55,6 +55,7 @@
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/mtd/spinor.h>
 
 /************************************************************************************
  * Pre-processor Definitions
@@ -96,6 +97,28 @@
 #define W25_RDMFID                 0x90    /* Read Manufacturer / Device            */
 #define W25_JEDEC_ID               0x9f    /* JEDEC ID read                         */
 
+/* 4-byte address instructions of the parts larger than 16MiB (W25Q256) */
+
+#define W25_RDDATA4                0x13    /* Read data bytes, 4-byte address       */
+#define W25_FRD4                   0x0c    /* Higher speed read, 4-byte address     */
+#define W25_PP4                    0x12    /* Program page, 4-byte address          */
+#define W25_SE4                    0x21    /* Sector erase (4KB), 4-byte address    */
+
+/* Read instruction and number of dummy bytes */
+
+#ifdef CONFIG_W25_SLOWREAD
+#  define W25_RDCMD(p) \
+     ((p)->addrlen == SPINOR_ADDR4 ? W25_RDDATA4 : W25_RDDATA)
+#  define W25_RDDUMMY              0
+#else
+#  define W25_RDCMD(p) \
+     ((p)->addrlen == SPINOR_ADDR4 ? W25_FRD4 : W25_FRD)
+#  define W25_RDDUMMY              1
+#endif
+
+#define W25_PPCMD(p)               ((p)->addrlen == SPINOR_ADDR4 ? W25_PP4 : W25_PP)
+#define W25_SECMD(p)               ((p)->addrlen == SPINOR_ADDR4 ? W25_SE4 : W25_SE)
+
 /* W25 Registers ********************************************************************/
 /* Read ID (RDID) register values */
 
@@ -117,12 +140,14 @@
 #define W25_JEDEC_CAPACITY_32MBIT  0x16  /* 1024x4096 = 32Mbit memory capacity */
 #define W25_JEDEC_CAPACITY_64MBIT  0x17  /* 2048x4096 = 64Mbit memory capacity */
 #define W25_JEDEC_CAPACITY_128MBIT 0x18  /* 4096x4096 = 128Mbit memory capacity */
+#define W25_JEDEC_CAPACITY_256MBIT 0x19  /* 8192x4096 = 256Mbit memory capacity */
 
 #define NSECTORS_8MBIT             256   /* 256 sectors x 4096 bytes/sector = 1Mb */
 #define NSECTORS_16MBIT            512   /* 512 sectors x 4096 bytes/sector = 2Mb */
 #define NSECTORS_32MBIT            1024  /* 1024 sectors x 4096 bytes/sector = 4Mb */
 #define NSECTORS_64MBIT            2048  /* 2048 sectors x 4096 bytes/sector = 8Mb */
 #define NSECTORS_128MBIT           4096  /* 4096 sectors x 4096 bytes/sector = 16Mb */
+#define NSECTORS_256MBIT           8192  /* 8192 sectors x 4096 bytes/sector = 32Mb */
 
 /* Status register bit definitions */
 
@@ -224,6 +249,7 @@ struct w25_dev_s
   struct mtd_dev_s      mtd;         /* MTD interface */
   FAR struct spi_dev_s *spi;         /* Saved SPI interface instance */
   uint16_t              nsectors;    /* Number of erase sectors */
+  uint8_t               addrlen;     /* SPINOR_ADDR3 or SPINOR_ADDR4 */
 
 #if defined(CONFIG_W25_SECTOR512) && !defined(CONFIG_W25_READONLY)
   uint8_t               flags;       /* Buffered sector flags */
@@ -367,6 +393,8 @@ static inline int w25_readid(struct w25_dev_s *priv)
        * the FLASH capacity.
        */
 
+      priv->addrlen = SPINOR_ADDR3;
+
       /* 8M-bit / 1M-byte
        *
        * W25Q80BV
@@ -416,6 +444,18 @@ static inline int w25_readid(struct w25_dev_s *priv)
         {
            priv->nsectors = NSECTORS_128MBIT;
         }
+
+      /* 256M-bit / 32M-byte (33,554,432)
+       *
+       * W25Q256FV, W25Q256JV.  The upper 16MiB can only be reached with
+       * the 4-byte address instructions.
+       */
+
+      else if (capacity == W25_JEDEC_CAPACITY_256MBIT)
+        {
+           priv->nsectors = NSECTORS_256MBIT;
+           priv->addrlen  = SPINOR_ADDR4;
+        }
       else
         {
           /* Nope.. we don't understand this capacity. */
@@ -571,17 +611,11 @@ static void w25_sectorerase(struct w25_dev_s *priv, off_t sector)
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH, true);
 
-  /* Send the "Sector Erase (SE)" instruction */
-
-  (void)SPI_SEND(priv->spi, W25_SE);
-
-  /* Send the sector address high byte first. Only the most significant bits (those
-   * corresponding to the sector) have any meaning.
+  /* Send the "Sector Erase (SE)" instruction and the sector address. Only the most
+   * significant bits (those corresponding to the sector) have any meaning.
    */
 
-  (void)SPI_SEND(priv->spi, (address >> 16) & 0xff);
-  (void)SPI_SEND(priv->spi, (address >> 8) & 0xff);
-  (void)SPI_SEND(priv->spi, address & 0xff);
+  spinor_command(priv->spi, W25_SECMD(priv), address, priv->addrlen, 0);
 
   /* Deselect the FLASH */
 
@@ -643,29 +677,12 @@ static void w25_byteread(FAR struct w25_dev_s *priv, FAR uint8_t *buffer,
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH, true);
 
-  /* Send "Read from Memory " instruction */
-
-#ifdef CONFIG_W25_SLOWREAD
-  (void)SPI_SEND(priv->spi, W25_RDDATA);
-#else
-  (void)SPI_SEND(priv->spi, W25_FRD);
-#endif
-
-  /* Send the address high byte first. */
-
-  (void)SPI_SEND(priv->spi, (address >> 16) & 0xff);
-  (void)SPI_SEND(priv->spi, (address >> 8) & 0xff);
-  (void)SPI_SEND(priv->spi, address & 0xff);
-
-  /* Send a dummy byte */
-
-#ifndef CONFIG_W25_SLOWREAD
-  (void)SPI_SEND(priv->spi, W25_DUMMY);
-#endif
-
-  /* Then read all of the requested bytes */
+  /* Send "Read from Memory " instruction, the address and any dummy byte, then
+   * read all of the requested bytes in one transfer.
+   */
 
-  SPI_RECVBLOCK(priv->spi, buffer, nbytes);
+  spinor_read(priv->spi, W25_RDCMD(priv), address, priv->addrlen, W25_RDDUMMY,
+              buffer, nbytes);
 
   /* Deselect the FLASH */
 
@@ -701,19 +718,12 @@ static void w25_pagewrite(struct w25_dev_s *priv, FAR const uint8_t *buffer,
 
       SPI_SELECT(priv->spi, SPIDEV_FLASH, true);
 
-      /* Send the "Page Program (W25_PP)" Command */
-
-      SPI_SEND(priv->spi, W25_PP);
-
-      /* Send the address high byte first. */
-
-      (void)SPI_SEND(priv->spi, (address >> 16) & 0xff);
-      (void)SPI_SEND(priv->spi, (address >> 8) & 0xff);
-      (void)SPI_SEND(priv->spi, address & 0xff);
-
-      /* Then send the page of data */
+      /* Send the "Page Program (W25_PP)" Command and the address, then send
+       * the page of data.
+       */
 
-      SPI_SNDBLOCK(priv->spi, buffer, W25_PAGE_SIZE);
+      spinor_write(priv->spi, W25_PPCMD(priv), address, priv->addrlen, buffer,
+                   W25_PAGE_SIZE);
 
       /* Deselect the FLASH and setup for the next pass through the loop */
 
@@ -757,19 +767,11 @@ static inline void w25_bytewrite(struct w25_dev_s *priv, FAR const uint8_t *buff
 
   SPI_SELECT(priv->spi, SPIDEV_FLASH, true);
 
-  /* Send "Page Program (PP)" command */
-
-  (void)SPI_SEND(priv->spi, W25_PP);
-
-  /* Send the page offset high byte first. */
-
-  (void)SPI_SEND(priv->spi, (offset >> 16) & 0xff);
-  (void)SPI_SEND(priv->spi, (offset >> 8) & 0xff);
-  (void)SPI_SEND(priv->spi, offset & 0xff);
-
-  /* Then write the specified number of bytes */
+  /* Send "Page Program (PP)" command and the offset, then write the specified
+   * number of bytes.
+   */
 
-  SPI_SNDBLOCK(priv->spi, buffer, count);
+  spinor_write(priv->spi, W25_PPCMD(priv), offset, priv->addrlen, buffer, count);
 
   /* Deselect the FLASH: Chip Select high */
 
@@ -83,6 +83,10 @@
 
 #define E1000_TXTIMEOUT (60*CLK_TCK)
 
+/* Receive interrupt causes */
+
+#define E1000_RXINTS    ((1 << 4) | (1 << 7)) /* RXDMT0 | RXT0 */
+
 /* This is a helper pointer for accessing the contents of the Ethernet header */
 
 #define BUF ((struct eth_hdr_s *)e1000->netdev.d_buf)
@@ -126,6 +130,9 @@ struct e1000_dev
   bool bifup;                 /* true:ifup false:ifdown */
   WDOG_ID txpoll;             /* TX poll timer */
   WDOG_ID txtimeout;          /* TX timeout timer */
+#ifdef CONFIG_NETDEV_NAPI
+  struct netdev_napi_s napi;  /* Budgeted receive polling */
+#endif
 
   /* This holds the information visible to the NuttX network */
 
@@ -157,7 +164,12 @@ static int  e1000_txpoll(struct net_driver_s *dev);
 
 /* Interrupt handling */
 
-static void e1000_receive(struct e1000_dev *e1000);
+static int  e1000_receive(struct e1000_dev *e1000, int budget);
+static void e1000_rxrelease(struct e1000_dev *e1000);
+#ifdef CONFIG_NETDEV_NAPI
+static int  e1000_napi_poll(FAR struct netdev_napi_s *napi, int budget);
+static void e1000_napi_irqctl(FAR struct netdev_napi_s *napi, bool enable);
+#endif
 
 /* Watchdog timer expirations */
 
@@ -544,23 +556,26 @@ static int e1000_txpoll(struct net_driver_s *dev)
  *
  * Parameters:
  *   e1000  - Reference to the driver state structure
+ *   budget - The maximum number of descriptors to process
  *
  * Returned Value:
- *   None
+ *   The number of descriptors processed
  *
  * Assumptions:
- *   Global interrupts are disabled by interrupt handling logic.
+ *   Global interrupts are disabled by interrupt handling logic or, with
+ *   CONFIG_NETDEV_NAPI, the network is locked.
  *
  ****************************************************************************/
 
-static void e1000_receive(struct e1000_dev *e1000)
+static int e1000_receive(struct e1000_dev *e1000, int budget)
 {
   int head = e1000->rx_ring.head;
   unsigned char *cp = (unsigned char *)
       (e1000->rx_ring.buf + head * CONFIG_E1000_BUFF_SIZE);
+  int nrecvd = 0;
   int cnt;
 
-  while (e1000->rx_ring.desc[head].desc_status)
+  while (nrecvd < budget && e1000->rx_ring.desc[head].desc_status)
     {
       /* Here we do not handle packets that exceed packet-buffer size */
 
@@ -698,9 +713,86 @@ next:
       e1000->rx_ring.free++;
       head = e1000->rx_ring.head;
       cp = (unsigned char *)(e1000->rx_ring.buf + head * CONFIG_E1000_BUFF_SIZE);
+      nrecvd++;
     }
+
+  return nrecvd;
 }
 
+/****************************************************************************
+ * Function: e1000_rxrelease
+ *
+ * Description:
+ *   Give the RX descriptors processed by e1000_receive() back to the
+ *   hardware.
+ *
+ * Parameters:
+ *   e1000  - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void e1000_rxrelease(struct e1000_dev *e1000)
+{
+  int tail;
+
+  tail = e1000->rx_ring.tail + e1000->rx_ring.free;
+  tail %= CONFIG_E1000_N_RX_DESC;
+  e1000->rx_ring.tail = tail;
+  e1000->rx_ring.free = 0;
+  e1000_outl(e1000, E1000_RDT, tail);
+}
+
+#ifdef CONFIG_NETDEV_NAPI
+/****************************************************************************
+ * Function: e1000_napi_poll
+ *
+ * Description:
+ *   Receive up to 'budget' packets from the work queue and give the
+ *   descriptors back to the hardware.
+ *
+ * Parameters:
+ *   napi   - The polling state of the driver
+ *   budget - The maximum number of descriptors to process
+ *
+ * Returned Value:
+ *   The number of descriptors processed
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int e1000_napi_poll(FAR struct netdev_napi_s *napi, int budget)
+{
+  struct e1000_dev *e1000 = (struct e1000_dev *)napi->n_arg;
+  int nrecvd;
+
+  nrecvd = e1000_receive(e1000, budget);
+  e1000_rxrelease(e1000);
+  return nrecvd;
+}
+
+/****************************************************************************
+ * Function: e1000_napi_irqctl
+ *
+ * Description:
+ *   Enable or disable the receive interrupts.  The interrupt cause bits
+ *   are latched, so a packet that arrived while the interrupts were
+ *   masked raises an interrupt as soon as they are unmasked.
+ *
+ ****************************************************************************/
+
+static void e1000_napi_irqctl(FAR struct netdev_napi_s *napi, bool enable)
+{
+  struct e1000_dev *e1000 = (struct e1000_dev *)napi->n_arg;
+
+  e1000_outl(e1000, enable ? E1000_IMS : E1000_IMC, E1000_RXINTS);
+}
+#endif
+
 /****************************************************************************
  * Function: e1000_txtimeout
  *
@@ -856,6 +948,12 @@ static int e1000_ifdown(struct net_driver_s *dev)
   wd_cancel(e1000->txpoll);
   wd_cancel(e1000->txtimeout);
 
+#ifdef CONFIG_NETDEV_NAPI
+  /* Stop receive polling */
+
+  netdev_napi_cancel(&e1000->napi);
+#endif
+
   /* Put the EMAC is its reset, non-operational state.  This should be
    * a known configuration that will guarantee the skel_ifup() always
    * successfully brings the interface back up.
@@ -1004,14 +1102,25 @@ static irqreturn_t e1000_interrupt_handler(int irq, void *dev_id)
         }
     }
 
+#ifdef CONFIG_NETDEV_NAPI
+  /* Received packets are handled from the work queue, a budget at a time,
+   * with the receive interrupts masked until the ring is empty.
+   */
+
+  if (intr_cause & E1000_RXINTS)
+    {
+      netdev_napi_schedule(&e1000->napi);
+    }
+#else
   /* Check if we received an incoming packet, if so, call skel_receive() */
 
   /* Rx-descriptor Timer expired */
 
   if (intr_cause & (1 << 7))
     {
-      e1000_receive(e1000);
+      e1000_receive(e1000, CONFIG_E1000_N_RX_DESC);
     }
+#endif
 
   /* Tx queue empty */
 
@@ -1027,18 +1136,14 @@ static irqreturn_t e1000_interrupt_handler(int irq, void *dev_id)
       devif_poll(&e1000->netdev, e1000_txpoll);
     }
 
+#ifndef CONFIG_NETDEV_NAPI
   /* Rx-Descriptors Low */
 
   if (intr_cause & (1 << 4))
     {
-      int tail;
-
-      tail = e1000->rx_ring.tail + e1000->rx_ring.free;
-      tail %= CONFIG_E1000_N_RX_DESC;
-      e1000->rx_ring.tail = tail;
-      e1000->rx_ring.free = 0;
-      e1000_outl(e1000, E1000_RDT, tail);
+      e1000_rxrelease(e1000);
     }
+#endif
 
   return IRQ_HANDLED;
 }
@@ -1194,6 +1299,11 @@ static int e1000_probe(uint16_t addr, pci_id_t id)
 #endif
   dev->netdev.d_private = dev;            /* Used to recover private state from dev */
 
+#ifdef CONFIG_NETDEV_NAPI
+  netdev_napi_init(&dev->napi, HPWORK, 0, e1000_napi_poll,
+                   e1000_napi_irqctl, dev);
+#endif
+
   /* Create a watchdog for timing polling for and timing of transmisstions */
 
   dev->txpoll       = wd_create();        /* Create periodic poll timer */
@@ -96,6 +96,10 @@ struct lo_driver_s
 {
   bool lo_bifup;               /* true:ifup false:ifdown */
   bool lo_txdone;              /* One RX packet was looped back */
+#ifdef CONFIG_NET_LOOPBACK_SYNC
+  bool lo_polling;             /* An out-of-cycle poll is in progress */
+  bool lo_pending;             /* TX data was announced during the poll */
+#endif
   WDOG_ID lo_polldog;          /* TX poll timer */
   struct work_s lo_work;       /* For deferring work to the work queue */
 
@@ -385,7 +389,8 @@ static int lo_ifdown(FAR struct net_driver_s *dev)
  *   None
  *
  * Assumptions:
- *   Called on the higher priority worker thread.
+ *   Called on the higher priority worker thread (or directly from
+ *   lo_txavail() if CONFIG_NET_LOOPBACK_SYNC is selected).
  *
  ****************************************************************************/
 
@@ -399,14 +404,26 @@ static void lo_txavail_work(FAR void *arg)
   state = net_lock();
   if (priv->lo_bifup)
     {
+#ifdef CONFIG_NET_LOOPBACK_SYNC
+      priv->lo_polling = true;
       do
         {
-          /* If so, then poll the network for new XMIT data */
-
-          priv->lo_txdone = false;
-          (void)devif_poll(&priv->lo_dev, lo_txpoll);
+          priv->lo_pending = false;
+#endif
+          do
+            {
+              /* If so, then poll the network for new XMIT data */
+
+              priv->lo_txdone = false;
+              (void)devif_poll(&priv->lo_dev, lo_txpoll);
+            }
+          while (priv->lo_txdone);
+#ifdef CONFIG_NET_LOOPBACK_SYNC
         }
-      while (priv->lo_txdone);
+      while (priv->lo_pending);
+
+      priv->lo_polling = false;
+#endif
     }
 
   net_unlock(state);
@@ -427,7 +444,8 @@ static void lo_txavail_work(FAR void *arg)
  *   None
  *
  * Assumptions:
- *   Called in normal user mode
+ *   Called in normal user mode.  With CONFIG_NET_LOOPBACK_SYNC, the poll is
+ *   performed before returning.
  *
  ****************************************************************************/
 
@@ -435,6 +453,31 @@ static int lo_txavail(FAR struct net_driver_s *dev)
 {
   FAR struct lo_driver_s *priv = (FAR struct lo_driver_s *)dev->d_private;
 
+#ifdef CONFIG_NET_LOOPBACK_SYNC
+  /* Loop the packets back now on the caller's thread, unless we are in an
+   * interrupt handler.  If the notification comes from within a poll that
+   * is already in progress (for example, from a callback run by the looped
+   * back packet), then just ask that poll to run once more.
+   */
+
+  if (!up_interrupt_context())
+    {
+      net_lock_t state = net_lock();
+
+      if (priv->lo_polling)
+        {
+          priv->lo_pending = true;
+        }
+      else
+        {
+          lo_txavail_work(priv);
+        }
+
+      net_unlock(state);
+      return OK;
+    }
+#endif
+
   /* Is our single work structure available?  It may not be if there are
    * pending interrupt actions and we will have to ignore the Tx
    * availability action.
@@ -572,9 +615,11 @@ int localhost_initialize(void)
   net_ipv6addr_copy(priv->lo_dev.d_ipv6netmask, g_ipv6_alloneaddr);
 #endif
 
-  /* Put the network in the UP state */
+  /* Put the network in the UP state.  Packets never leave memory, so there
+   * is no need to compute or verify checksums.
+   */
 
-  priv->lo_dev.d_flags = IFF_UP;
+  priv->lo_dev.d_flags = IFF_UP | IFF_TXCSUM | IFF_RXCSUM;
   return lo_ifup(&priv->lo_dev);
 }
 
@@ -211,6 +211,20 @@ static int skel_transmit(FAR struct skel_driver_s *priv)
 
   /* Send the packet: address=priv->sk_dev.d_buf, length=priv->sk_dev.d_len */
 
+#ifdef CONFIG_NET_IOBTX
+  /* Or, if the hardware supports gather-DMA and IFF_TXIOB was set in
+   * priv->sk_dev.d_flags, use devif_iob_txsegs() to get the segments of
+   * the packet, set up one TX descriptor for each, then set
+   * priv->sk_dev.d_sndiob to NULL.
+   */
+#endif
+
+  /* If the hardware inserts the IPv4, ICMP, TCP and UDP checksums, set
+   * IFF_TXCSUM in priv->sk_dev.d_flags and the network will leave them
+   * zero.  Similarly, set IFF_RXCSUM if the hardware drops received
+   * packets with bad checksums so that they are not verified again.
+   */
+
   /* Enable Tx interrupts */
 
   /* Setup the TX timeout watchdog (perhaps restarting the timer) */
@@ -323,6 +337,15 @@ static void skel_receive(FAR struct skel_driver_s *priv)
        * amount of data in priv->sk_dev.d_len
        */
 
+#ifdef CONFIG_NET_IOBRX
+      /* Or, with CONFIG_NET_IOBRX, the hardware may receive directly into
+       * the I/O buffer priv->sk_dev.d_iob (with priv->sk_dev.d_buf pointing
+       * at its io_data).  The network may keep that I/O buffer and replace
+       * it with another one, so d_iob and d_buf must be re-read before the
+       * buffer is returned to the hardware.
+       */
+#endif
+
 #ifdef CONFIG_NET_PKT
       /* When packet sockets are enabled, feed the frame into the packet tap */
 
@@ -542,9 +565,9 @@ static void skel_interrupt_work(FAR void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  state = net_lock();
+  state = netdev_lock(&priv->sk_dev);
   skel_interrupt_process(priv);
-  net_unlock(state);
+  netdev_unlock(&priv->sk_dev, state);
 
   /* Re-enable Ethernet interrupts */
 
@@ -664,9 +687,9 @@ static void skel_txtimeout_work(FAR void *arg)
 
   /* Process pending Ethernet interrupts */
 
-  state = net_lock();
+  state = netdev_lock(&priv->sk_dev);
   skel_txtimeout_process(priv);
-  net_unlock(state);
+  netdev_unlock(&priv->sk_dev, state);
 }
 #endif
 
@@ -778,9 +801,9 @@ static void skel_poll_work(FAR void *arg)
 
   /* Perform the poll */
 
-  state = net_lock();
+  state = netdev_lock(&priv->sk_dev);
   skel_poll_process(priv);
-  net_unlock(state);
+  netdev_unlock(&priv->sk_dev, state);
 }
 #endif
 
@@ -987,9 +1010,9 @@ static void skel_txavail_work(FAR void *arg)
 
   /* Perform the poll */
 
-  state = net_lock();
+  state = netdev_lock(&priv->sk_dev);
   skel_txavail_process(priv);
-  net_unlock(state);
+  netdev_unlock(&priv->sk_dev, state);
 }
 #endif
 
@@ -57,6 +57,7 @@
 #include <semaphore.h>
 #include <string.h>
 #include <poll.h>
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -76,7 +77,15 @@
 #endif
 
 #ifndef CONFIG_TELNET_TXBUFFER_SIZE
-#  define CONFIG_TELNET_TXBUFFER_SIZE 256
+#  define CONFIG_TELNET_TXBUFFER_SIZE 512
+#endif
+
+/* The largest expansion of a single user character ("\n" -> "\n\r\0") */
+
+#define TELNET_MAXEXPAND 3
+
+#if CONFIG_TELNET_TXBUFFER_SIZE < TELNET_MAXEXPAND
+#  error CONFIG_TELNET_TXBUFFER_SIZE is too small
 #endif
 
 /* Telnet protocol stuff ****************************************************/
@@ -115,9 +124,9 @@ struct telnet_dev_s
 {
   sem_t              td_exclsem; /* Enforces mutually exclusive access */
   uint8_t            td_state;   /* (See telnet_state_e) */
-  uint8_t            td_pending; /* Number of valid, pending bytes in the rxbuffer */
-  uint8_t            td_offset;  /* Offset to the valid, pending bytes in the rxbuffer */
   uint8_t            td_crefs;   /* The number of open references to the session */
+  uint16_t           td_pending; /* Number of valid, pending bytes in the rxbuffer */
+  uint16_t           td_offset;  /* Offset to the valid, pending bytes in the rxbuffer */
   int                td_minor;   /* Minor device number */
   FAR struct socket  td_psock;   /* A clone of the internal socket structure */
   char td_rxbuffer[CONFIG_TELNET_RXBUFFER_SIZE];
@@ -145,13 +154,14 @@ static inline void telnet_dumpbuffer(FAR const char *msg,
 #else
 # define telnet_dumpbuffer(msg,buffer,nbytes)
 #endif
-static void    telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                 FAR char *dest, int *nread);
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv,
                  FAR const char *src, size_t srclen, FAR char *dest,
                  size_t destlen);
-static bool    telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                 int *nwritten);
+static int     telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
+                 int index);
+static size_t  telnet_putspan(FAR struct telnet_dev_s *priv,
+                 FAR const char *src, size_t srclen, FAR int *index);
+static int     telnet_flush(FAR struct telnet_dev_s *priv, int ncopied);
 static void    telnet_sendopt(FAR struct telnet_dev_s *priv, uint8_t option,
                  uint8_t value);
 
@@ -238,31 +248,6 @@ static inline void telnet_dumpbuffer(FAR const char *msg,
 }
 #endif
 
-/****************************************************************************
- * Name: telnet_getchar
- *
- * Description:
- *   Get another character for the user received buffer from the RX buffer
- *
- ****************************************************************************/
-
-static void telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                           FAR char *dest, int *nread)
-{
-  register int index;
-
-  /* Ignore carriage returns */
-
-  if (ch != ISO_cr)
-    {
-      /* Add all other characters to the destination buffer */
-
-      index = *nread;
-      dest[index++] = ch;
-      *nread = index;
-    }
-}
-
 /****************************************************************************
  * Name: telnet_receive
  *
@@ -274,13 +259,42 @@ static void telnet_getchar(FAR struct telnet_dev_s *priv, uint8_t ch,
 static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src,
                               size_t srclen, FAR char *dest, size_t destlen)
 {
-  int nread;
+  FAR const char *end = src + srclen;
+  size_t nread = 0;
+  size_t maxspan;
+  size_t span;
   uint8_t ch;
 
   ninfo("srclen: %d destlen: %d\n", srclen, destlen);
 
-  for (nread = 0; srclen > 0 && nread < destlen; srclen--)
+  while (src < end && nread < destlen)
     {
+      if (priv->td_state == STATE_NORMAL)
+        {
+          /* Find the run of ordinary characters up to the next IAC or
+           * carriage return and copy it in one piece.
+           */
+
+          maxspan = end - src;
+          if (maxspan > destlen - nread)
+            {
+              maxspan = destlen - nread;
+            }
+
+          for (span = 0;
+               span < maxspan && (uint8_t)src[span] != TELNET_IAC &&
+               src[span] != ISO_cr;
+               span++);
+
+          if (span > 0)
+            {
+              memcpy(&dest[nread], src, span);
+              nread += span;
+              src   += span;
+              continue;
+            }
+        }
+
       ch = *src++;
       ninfo("ch=%02x state=%d\n", ch, priv->td_state);
 
@@ -289,7 +303,9 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
           case STATE_IAC:
             if (ch == TELNET_IAC)
               {
-                telnet_getchar(priv, ch, dest, &nread);
+                /* An escaped 0xff data byte */
+
+                dest[nread++] = ch;
                 priv->td_state = STATE_NORMAL;
              }
             else
@@ -348,14 +364,14 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
             break;
 
           case STATE_NORMAL:
+            /* Only IAC and carriage returns get here.  Carriage returns
+             * are ignored.
+             */
+
             if (ch == TELNET_IAC)
               {
                 priv->td_state = STATE_IAC;
               }
-            else
-              {
-                telnet_getchar(priv, ch, dest, &nread);
-              }
             break;
         }
     }
@@ -364,13 +380,13 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
    * (2) if the user's buffer has become full.
    */
 
-  if (srclen > 0)
+  if (src < end)
     {
       /* Remember where we left off.  These bytes will be returned the next
        * time that telnet_read() is called.
        */
 
-      priv->td_pending = srclen;
+      priv->td_pending = end - src;
       priv->td_offset = (src - priv->td_rxbuffer);
     }
   else
@@ -388,43 +404,104 @@ static ssize_t telnet_receive(FAR struct telnet_dev_s *priv, FAR const char *src
  * Name: telnet_putchar
  *
  * Description:
- *   Put another character from the user buffer to the TX buffer.
+ *   Put a character that needs translation from the user buffer into the
+ *   TX buffer at 'index'.  There must be room for TELNET_MAXEXPAND bytes.
+ *   Returns the new index into the TX buffer.
  *
  ****************************************************************************/
 
-static bool telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
-                           int *nread)
+static int telnet_putchar(FAR struct telnet_dev_s *priv, uint8_t ch,
+                          int index)
 {
-  register int index;
-  bool ret = false;
+  if (ch == ISO_nl)
+    {
+      /* Add the line feed, the carriage return and the NUL */
 
-  /* Ignore carriage returns (we will put these in automatically as necesary) */
+      priv->td_txbuffer[index++] = ISO_nl;
+      priv->td_txbuffer[index++] = ISO_cr;
+      priv->td_txbuffer[index++] = '\0';
+    }
+  else if (ch == TELNET_IAC)
+    {
+      /* A 0xff data byte must be escaped as IAC IAC */
 
-  if (ch != ISO_cr)
+      priv->td_txbuffer[index++] = TELNET_IAC;
+      priv->td_txbuffer[index++] = TELNET_IAC;
+    }
+  else if (ch != ISO_cr)
     {
-      /* Add all other characters to the destination buffer */
+      /* Ignore carriage returns (we put these in automatically as
+       * necessary).
+       */
 
-      index = *nread;
       priv->td_txbuffer[index++] = ch;
+    }
 
-      /* Check for line feeds */
+  return index;
+}
 
-      if (ch == ISO_nl)
-        {
-          /* Now add the carriage return */
+/****************************************************************************
+ * Name: telnet_putspan
+ *
+ * Description:
+ *   Copy the run of characters that need no translation from the start of
+ *   the user buffer into the TX buffer, as much as fits.  Returns the number
+ *   of user characters consumed.
+ *
+ ****************************************************************************/
 
-          priv->td_txbuffer[index++] = ISO_cr;
-          priv->td_txbuffer[index++] = '\0';
+static size_t telnet_putspan(FAR struct telnet_dev_s *priv,
+                             FAR const char *src, size_t srclen,
+                             FAR int *index)
+{
+  size_t maxspan = CONFIG_TELNET_TXBUFFER_SIZE - *index;
+  size_t span;
+  uint8_t ch;
 
-          /* End of line */
+  if (maxspan > srclen)
+    {
+      maxspan = srclen;
+    }
 
-          ret = true;
+  for (span = 0; span < maxspan; span++)
+    {
+      ch = (uint8_t)src[span];
+      if (ch == ISO_nl || ch == ISO_cr || ch == TELNET_IAC)
+        {
+          break;
         }
+    }
 
-      *nread = index;
+  if (span > 0)
+    {
+      memcpy(&priv->td_txbuffer[*index], src, span);
+      *index += span;
     }
 
-  return ret;
+  return span;
+}
+
+/****************************************************************************
+ * Name: telnet_flush
+ *
+ * Description:
+ *   Send the first 'ncopied' bytes of the TX buffer.
+ *
+ ****************************************************************************/
+
+static int telnet_flush(FAR struct telnet_dev_s *priv, int ncopied)
+{
+  ssize_t ret;
+
+  telnet_dumpbuffer("Send buffer", priv->td_txbuffer, ncopied);
+  ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
+  if (ret < 0)
+    {
+      nerr("ERROR: psock_send failed: %d\n", (int)ret);
+      return (int)ret;
+    }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -675,44 +752,45 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer, size
   FAR struct inode *inode = filep->f_inode;
   FAR struct telnet_dev_s *priv = inode->i_private;
   FAR const char *src = buffer;
-  ssize_t nsent;
-  ssize_t ret;
-  int ncopied;
-  char ch;
-  bool eol;
+  FAR const char *end = buffer + len;
+  int ncopied = 0;
+  int ret;
 
   ninfo("len: %d\n", len);
 
-  /* Process each character from the user buffer */
+  /* Collect the user data in the TX buffer, copying runs of characters that
+   * need no translation in one piece.  The buffer is only sent when it is
+   * full and at the end of the write so that the output goes out in as few
+   * TCP segments as possible.
+   */
 
-  for (nsent = 0, ncopied = 0; nsent < len; nsent++)
+  while (src < end)
     {
-      /* Get the next character from the user buffer */
-
-      ch = *src++;
-
-      /* Add the character to the TX buffer */
+      src += telnet_putspan(priv, src, end - src, &ncopied);
+      if (src < end)
+        {
+          /* The next character needs translation or the buffer is full.
+           * Is there room for the largest character sequence?
+           */
 
-      eol = telnet_putchar(priv, ch, &ncopied);
+          if (ncopied > CONFIG_TELNET_TXBUFFER_SIZE - TELNET_MAXEXPAND)
+            {
+              /* No... send the data now */
 
-      /* Was that the end of a line? Or is the buffer too full to hold the
-       * next largest character sequence ("\r\n\0")?
-       */
+              ret = telnet_flush(priv, ncopied);
+              if (ret < 0)
+                {
+                  return ret;
+                }
 
-      if (eol || ncopied > CONFIG_TELNET_TXBUFFER_SIZE-3)
-        {
-          /* Yes... send the data now */
+              /* Reset the index to the beginning of the TX buffer. */
 
-          ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
-          if (ret < 0)
+              ncopied = 0;
+            }
+          else
             {
-              nerr("ERROR: psock_send failed '%s': %d\n", priv->td_txbuffer, ret);
-              return ret;
+              ncopied = telnet_putchar(priv, *src++, ncopied);
             }
-
-          /* Reset the index to the beginning of the TX buffer. */
-
-          ncopied = 0;
         }
     }
 
@@ -720,10 +798,9 @@ static ssize_t telnet_write(FAR struct file *filep, FAR const char *buffer, size
 
   if (ncopied > 0)
     {
-      ret = psock_send(&priv->td_psock, priv->td_txbuffer, ncopied, 0);
+      ret = telnet_flush(priv, ncopied);
       if (ret < 0)
         {
-          nerr("ERROR: psock_send failed '%s': %d\n", priv->td_txbuffer, ret);
           return ret;
         }
     }
@@ -97,6 +97,20 @@
 
 #define TUN_WDDELAY   (1*CLK_TCK)
 
+#ifdef CONFIG_TUN_BATCH
+/* Each read buffer in the ring starts on a 4-byte boundary so that the IP
+ * headers built in place are aligned.
+ */
+
+#  define TUN_BATCH_STRIDE ((CONFIG_NET_TUN_MTU + 3) & ~3)
+#  define TUN_RXBUF(p,n) \
+     ((FAR uint8_t *)(p)->rx_buf + (n) * TUN_BATCH_STRIDE)
+
+/* Longest time that packets below the POLLIN watermark are held back */
+
+#  define TUN_FLUSHDELAY MSEC2TICK(CONFIG_TUN_BATCH_LATENCY)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -129,6 +143,22 @@ struct tun_device_s
   sem_t             waitsem;
   sem_t             read_wait_sem;
 
+#ifdef CONFIG_TUN_BATCH
+  /* Batched I/O (IFF_BATCH).  Packets for the application are queued in a
+   * ring of read buffers rather than in read_buf.
+   */
+
+  bool              batch;     /* Several packets per read/write */
+  bool              flushing;  /* The flush timer is running */
+  uint8_t           rx_head;   /* Next read buffer to be filled */
+  uint8_t           rx_tail;   /* Next read buffer to be returned */
+  uint8_t           rx_count;  /* Number of queued packets */
+  uint8_t           rx_lowat;  /* POLLIN low watermark (packets) */
+  WDOG_ID           flushdog;  /* Reports POLLIN below the watermark */
+  uint16_t          rx_len[CONFIG_TUN_BATCH_NBUFFERS];
+  uint32_t          rx_buf[CONFIG_TUN_BATCH_NBUFFERS * TUN_BATCH_STRIDE / 4];
+#endif
+
   /* This holds the information visible to the NuttX network */
 
   struct net_driver_s dev;     /* Interface understood by the network */
@@ -151,6 +181,10 @@ static void tun_unlock(FAR struct tun_device_s *priv);
 
 static int  tun_transmit(FAR struct tun_device_s *priv);
 static int  tun_txpoll(struct net_driver_s *dev);
+static bool tun_txbuffer(FAR struct tun_device_s *priv);
+#ifdef CONFIG_TUN_BATCH
+static void tun_rxcommit(FAR struct tun_device_s *priv);
+#endif
 
 /* Interrupt handling */
 
@@ -164,6 +198,9 @@ static inline void tun_poll_process(FAR struct tun_device_s *priv);
 static void tun_poll_work(FAR void *arg);
 #endif
 static void tun_poll_expiry(int argc, wdparm_t arg, ...);
+#if defined(CONFIG_TUN_BATCH) && !defined(CONFIG_DISABLE_POLL)
+static void tun_flush_expiry(int argc, wdparm_t arg, ...);
+#endif
 
 /* NuttX callback functions */
 
@@ -181,7 +218,8 @@ static void tun_ipv6multicast(FAR struct tun_device_s *priv);
 #endif
 
 static int tun_dev_init(FAR struct tun_device_s *priv,
-                        FAR struct file *filep, FAR const char *devfmt);
+                        FAR struct file *filep, FAR const char *devfmt,
+                        int flags);
 static int tun_dev_uninit(FAR struct tun_device_s *priv);
 
 /* File interface */
@@ -302,6 +340,46 @@ static void tun_pollnotify(FAR struct tun_device_s *priv, pollevent_t eventset)
 #  define tun_pollnotify(dev, event)
 #endif
 
+/****************************************************************************
+ * Name: tun_rxnotify
+ *
+ * Description:
+ *   Report POLLIN for a batched device after packets have been queued or
+ *   removed.  POLLIN is reported once the number of queued packets reaches
+ *   the low watermark; fewer packets are reported when the flush timer
+ *   expires.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_TUN_BATCH) && !defined(CONFIG_DISABLE_POLL)
+static void tun_rxnotify(FAR struct tun_device_s *priv)
+{
+  if (!priv->batch || priv->rx_count == 0)
+    {
+      return;
+    }
+
+  if (priv->rx_count >= priv->rx_lowat)
+    {
+      if (priv->flushing)
+        {
+          wd_cancel(priv->flushdog);
+          priv->flushing = false;
+        }
+
+      tun_pollnotify(priv, POLLIN);
+    }
+  else if (!priv->flushing)
+    {
+      priv->flushing = true;
+      (void)wd_start(priv->flushdog, TUN_FLUSHDELAY, tun_flush_expiry, 1,
+                     (wdparm_t)priv);
+    }
+}
+#else
+#  define tun_rxnotify(priv)
+#endif
+
 /****************************************************************************
  * Function: tun_transmit
  *
@@ -376,6 +454,18 @@ static int tun_txpoll(struct net_driver_s *dev)
 
   if (priv->dev.d_len > 0)
     {
+#ifdef CONFIG_TUN_BATCH
+      if (priv->batch)
+        {
+          /* Queue the packet and continue polling into the next free read
+           * buffer, if there is one.
+           */
+
+          tun_rxcommit(priv);
+          return tun_txbuffer(priv) ? 0 : 1;
+        }
+#endif
+
       /* Send the packet */
 
       priv->read_d_len = priv->dev.d_len;
@@ -391,6 +481,137 @@ static int tun_txpoll(struct net_driver_s *dev)
   return 0;
 }
 
+/****************************************************************************
+ * Function: tun_txbuffer
+ *
+ * Description:
+ *   Check if there is room to hold another packet for the application and,
+ *   if so, point d_buf at it.
+ *
+ * Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   true if the network may be polled for another packet
+ *
+ ****************************************************************************/
+
+static bool tun_txbuffer(FAR struct tun_device_s *priv)
+{
+#ifdef CONFIG_TUN_BATCH
+  if (priv->batch)
+    {
+      if (priv->rx_count >= CONFIG_TUN_BATCH_NBUFFERS)
+        {
+          return false;
+        }
+
+      priv->dev.d_buf = TUN_RXBUF(priv, priv->rx_head);
+      return true;
+    }
+#endif
+
+  if (priv->read_d_len != 0)
+    {
+      return false;
+    }
+
+  priv->dev.d_buf = priv->read_buf;
+  return true;
+}
+
+/****************************************************************************
+ * Function: tun_rxcommit
+ *
+ * Description:
+ *   Queue the d_len byte packet in the read buffer at rx_head for the
+ *   application of a batched device.
+ *
+ * Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TUN_BATCH
+static void tun_rxcommit(FAR struct tun_device_s *priv)
+{
+  NETDEV_TXPACKETS(&priv->dev);
+
+  priv->rx_len[priv->rx_head] = priv->dev.d_len;
+  priv->rx_head = (priv->rx_head + 1) % CONFIG_TUN_BATCH_NBUFFERS;
+  priv->rx_count++;
+
+  if (priv->read_wait)
+    {
+      priv->read_wait = false;
+      sem_post(&priv->read_wait_sem);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Function: tun_reply
+ *
+ * Description:
+ *   Handle the reply (if any) generated by the network while processing a
+ *   packet written by the application.
+ *
+ * Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
+static void tun_reply(FAR struct tun_device_s *priv)
+{
+#ifdef CONFIG_TUN_BATCH
+  if (priv->batch)
+    {
+      /* The packet was received into the next free read buffer, if there
+       * was one, so the reply is already in place.  Otherwise it has to be
+       * dropped.
+       */
+
+      if (priv->dev.d_len > 0)
+        {
+          if (priv->rx_count < CONFIG_TUN_BATCH_NBUFFERS &&
+              priv->dev.d_buf == TUN_RXBUF(priv, priv->rx_head))
+            {
+              tun_rxcommit(priv);
+            }
+          else
+            {
+              NETDEV_TXDROPPED(&priv->dev);
+            }
+        }
+
+      return;
+    }
+#endif
+
+  /* If the input resulted in data that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (priv->dev.d_len > 0)
+    {
+      priv->write_d_len = priv->dev.d_len;
+      tun_transmit(priv);
+    }
+  else
+    {
+      priv->write_d_len = 0;
+      tun_pollnotify(priv, POLLOUT);
+    }
+}
+#endif
+
 /****************************************************************************
  * Function: tun_receive
  *
@@ -432,20 +653,7 @@ static void tun_receive(FAR struct tun_device_s *priv)
 
   ipv4_input(&priv->dev);
 
-  /* If the above function invocation resulted in data that should be
-   * sent out on the network, the field  d_len will set to a value > 0.
-   */
-
-  if (priv->dev.d_len > 0)
-    {
-      priv->write_d_len = priv->dev.d_len;
-      tun_transmit(priv);
-    }
-  else
-    {
-      priv->write_d_len = 0;
-      tun_pollnotify(priv, POLLOUT);
-    }
+  tun_reply(priv);
 
 #elif defined(CONFIG_NET_IPv6)
   ninfo("Iv6 frame\n");
@@ -455,20 +663,7 @@ static void tun_receive(FAR struct tun_device_s *priv)
 
   ipv6_input(&priv->dev);
 
-  /* If the above function invocation resulted in data that should be
-   * sent out on the network, the field  d_len will set to a value > 0.
-   */
-
-  if (priv->dev.d_len > 0)
-    {
-      priv->write_d_len = priv->dev.d_len;
-      tun_transmit(priv);
-    }
-  else
-    {
-      priv->write_d_len = 0;
-      tun_pollnotify(priv, POLLOUT);
-    }
+  tun_reply(priv);
 
 #else
   NETDEV_RXDROPPED(&priv->dev);
@@ -500,8 +695,11 @@ static void tun_txdone(FAR struct tun_device_s *priv)
 
   /* Then poll the network for new XMIT data */
 
-  priv->dev.d_buf = priv->read_buf;
-  (void)devif_poll(&priv->dev, tun_txpoll);
+  if (tun_txbuffer(priv))
+    {
+      (void)devif_poll(&priv->dev, tun_txpoll);
+      tun_rxnotify(priv);
+    }
 }
 
 /****************************************************************************
@@ -527,12 +725,12 @@ static void tun_poll_process(FAR struct tun_device_s *priv)
    * the TX poll if he are unable to accept another packet for transmission.
    */
 
-  if (priv->read_d_len == 0)
+  if (tun_txbuffer(priv))
     {
       /* If so, poll the network for new XMIT data. */
 
-      priv->dev.d_buf = priv->read_buf;
       (void)devif_timer(&priv->dev, tun_txpoll);
+      tun_rxnotify(priv);
     }
 
   /* Setup the watchdog poll timer again */
@@ -624,6 +822,38 @@ static void tun_poll_expiry(int argc, wdparm_t arg, ...)
 #endif
 }
 
+/****************************************************************************
+ * Function: tun_flush_expiry
+ *
+ * Description:
+ *   The packets queued on a batched device have stayed below the POLLIN
+ *   low watermark for TUN_FLUSHDELAY.  Report them anyway.
+ *
+ * Parameters:
+ *   argc - The number of available arguments
+ *   arg  - The first argument
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Global interrupts are disabled by the watchdog logic.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_TUN_BATCH) && !defined(CONFIG_DISABLE_POLL)
+static void tun_flush_expiry(int argc, wdparm_t arg, ...)
+{
+  FAR struct tun_device_s *priv = (FAR struct tun_device_s *)arg;
+
+  priv->flushing = false;
+  if (priv->rx_count > 0)
+    {
+      tun_pollnotify(priv, POLLIN);
+    }
+}
+#endif
+
 /****************************************************************************
  * Function: tun_ifup
  *
@@ -700,6 +930,10 @@ static int tun_ifdown(struct net_driver_s *dev)
   /* Cancel the TX poll timer */
 
   wd_cancel(priv->txpoll);
+#ifdef CONFIG_TUN_BATCH
+  wd_cancel(priv->flushdog);
+  priv->flushing = false;
+#endif
 
   /* Mark the device "down" */
 
@@ -733,23 +967,16 @@ static int tun_txavail(struct net_driver_s *dev)
   net_lock_t state;
 
   tun_lock(priv);
+  state = net_lock();
 
   /* Check if there is room to hold another network packet. */
 
-  if (priv->read_d_len)
-    {
-      tun_unlock(priv);
-      return OK;
-    }
-
-  state = net_lock();
-
-  if (priv->bifup)
+  if (priv->bifup && tun_txbuffer(priv))
     {
       /* Poll the network for new XMIT data */
 
-      priv->dev.d_buf = priv->read_buf;
       (void)devif_poll(&priv->dev, tun_txpoll);
+      tun_rxnotify(priv);
     }
 
   net_unlock(state);
@@ -841,6 +1068,10 @@ static void tun_ipv6multicast(FAR struct tun_device_s *priv)
  *   Initialize the TUN device
  *
  * Parameters:
+ *   priv   - The TUN device to initialize
+ *   filep  - The file that the device is bound to
+ *   devfmt - The interface name (may be NULL)
+ *   flags  - The TUNSETIFF ifr flags
  *
  * Returned Value:
  *   OK on success; Negated errno on failure.
@@ -850,7 +1081,7 @@ static void tun_ipv6multicast(FAR struct tun_device_s *priv)
  ****************************************************************************/
 
 static int tun_dev_init(FAR struct tun_device_s *priv, FAR struct file *filep,
-                        FAR const char *devfmt)
+                        FAR const char *devfmt, int flags)
 {
   int ret;
 
@@ -874,11 +1105,18 @@ static int tun_dev_init(FAR struct tun_device_s *priv, FAR struct file *filep,
   /* Create a watchdog for timing polling for and timing of transmisstions */
 
   priv->txpoll        = wd_create();  /* Create periodic poll timer */
+#ifdef CONFIG_TUN_BATCH
+  priv->flushdog      = wd_create();  /* Create POLLIN flush timer */
+#endif
 
   /* Initialize other variables */
 
   priv->write_d_len   = 0;
   priv->read_wait     = false;
+#ifdef CONFIG_TUN_BATCH
+  priv->batch         = (flags & IFF_BATCH) != 0;
+  priv->rx_lowat      = 1;
+#endif
 
   /* Put the interface in the down state */
 
@@ -919,6 +1157,10 @@ static int tun_dev_uninit(FAR struct tun_device_s *priv)
 
   (void)netdev_unregister(&priv->dev);
 
+#ifdef CONFIG_TUN_BATCH
+  wd_delete(priv->flushdog);
+#endif
+
   sem_destroy(&priv->waitsem);
   sem_destroy(&priv->read_wait_sem);
 
@@ -963,6 +1205,145 @@ static int tun_close(FAR struct file *filep)
   return OK;
 }
 
+/****************************************************************************
+ * Name: tun_write_batch
+ *
+ * Description:
+ *   Give each length-framed packet in the buffer to the network.  Called
+ *   with the device and the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TUN_BATCH
+static ssize_t tun_write_batch(FAR struct tun_device_s *priv,
+                               FAR const char *buffer, size_t buflen)
+{
+  size_t offset = 0;
+  uint16_t pktlen;
+
+  while (buflen - offset > TUN_BATCH_HDRLEN)
+    {
+      memcpy(&pktlen, &buffer[offset], TUN_BATCH_HDRLEN);
+      if (pktlen == 0 || pktlen > CONFIG_NET_TUN_MTU ||
+          pktlen > buflen - offset - TUN_BATCH_HDRLEN)
+        {
+          break;
+        }
+
+      /* Receive into the next free read buffer so that a reply can be queued
+       * without another copy.
+       */
+
+      if (priv->rx_count < CONFIG_TUN_BATCH_NBUFFERS)
+        {
+          priv->dev.d_buf = TUN_RXBUF(priv, priv->rx_head);
+        }
+      else
+        {
+          priv->dev.d_buf = priv->write_buf;
+        }
+
+      memcpy(priv->dev.d_buf, &buffer[offset + TUN_BATCH_HDRLEN], pktlen);
+      priv->dev.d_len = pktlen;
+
+      tun_receive(priv);
+
+      /* The padding of the last record may be omitted */
+
+      offset += TUN_BATCH_RECLEN(pktlen);
+      if (offset > buflen)
+        {
+          offset = buflen;
+        }
+    }
+
+  tun_rxnotify(priv);
+  return offset > 0 ? (ssize_t)offset : -EINVAL;
+}
+#endif
+
+/****************************************************************************
+ * Name: tun_read_batch
+ *
+ * Description:
+ *   Return as many queued packets as fit in the buffer, each preceded by
+ *   its length.  Called with the device locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TUN_BATCH
+static ssize_t tun_read_batch(FAR struct tun_device_s *priv,
+                              FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  net_lock_t state;
+  size_t nread = 0;
+  uint16_t pktlen;
+  ssize_t ret;
+
+  if (priv->rx_count == 0)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          return -EAGAIN;
+        }
+
+      priv->read_wait = true;
+      tun_unlock(priv);
+      sem_wait(&priv->read_wait_sem);
+      tun_lock(priv);
+
+      if (priv->rx_count == 0)
+        {
+          return -EINTR;
+        }
+    }
+
+  state = net_lock();
+
+  while (priv->rx_count > 0)
+    {
+      pktlen = priv->rx_len[priv->rx_tail];
+      if (TUN_BATCH_HDRLEN + pktlen > buflen - nread)
+        {
+          break;
+        }
+
+      memcpy(&buffer[nread], &pktlen, TUN_BATCH_HDRLEN);
+      memcpy(&buffer[nread + TUN_BATCH_HDRLEN],
+             TUN_RXBUF(priv, priv->rx_tail), pktlen);
+
+      /* The padding of the last record may be omitted */
+
+      nread += TUN_BATCH_RECLEN(pktlen);
+      if (nread > buflen)
+        {
+          nread = buflen;
+        }
+
+      priv->rx_tail = (priv->rx_tail + 1) % CONFIG_TUN_BATCH_NBUFFERS;
+      priv->rx_count--;
+    }
+
+  if (nread == 0)
+    {
+      /* The buffer cannot hold even the first packet */
+
+      ret = -EINVAL;
+    }
+  else
+    {
+      /* Refill the read buffers that were just freed */
+
+      tun_txdone(priv);
+      ret = (ssize_t)nread;
+    }
+
+  net_unlock(state);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: tun_write
  ****************************************************************************/
@@ -981,6 +1362,17 @@ static ssize_t tun_write(FAR struct file *filep, FAR const char *buffer,
 
   tun_lock(priv);
 
+#ifdef CONFIG_TUN_BATCH
+  if (priv->batch)
+    {
+      state = net_lock();
+      ret = tun_write_batch(priv, buffer, buflen);
+      net_unlock(state);
+      tun_unlock(priv);
+      return ret;
+    }
+#endif
+
   if (priv->write_d_len > 0)
     {
       tun_unlock(priv);
@@ -1031,6 +1423,14 @@ static ssize_t tun_read(FAR struct file *filep, FAR char *buffer,
 
   tun_lock(priv);
 
+#ifdef CONFIG_TUN_BATCH
+  if (priv->batch)
+    {
+      ret = tun_read_batch(priv, filep, buffer, buflen);
+      goto out;
+    }
+#endif
+
   /* Check if there are data to read in write buffer */
 
   write_d_len = priv->write_d_len;
@@ -1125,6 +1525,27 @@ int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
 
       eventset = 0;
 
+#ifdef CONFIG_TUN_BATCH
+      if (priv->batch)
+        {
+          /* Writes are always accepted.  Packets below the low watermark
+           * are reported when the flush timer expires.
+           */
+
+          eventset |= (fds->events & POLLOUT);
+          if (priv->rx_count > 0 && priv->rx_count >= priv->rx_lowat)
+            {
+              eventset |= (fds->events & POLLIN);
+            }
+          else
+            {
+              tun_rxnotify(priv);
+            }
+
+          goto notify;
+        }
+#endif
+
       /* If write buffer is empty notify App.  */
 
       if (priv->write_d_len == 0)
@@ -1141,6 +1562,9 @@ int tun_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
           eventset |= (fds->events & POLLIN);
         }
 
+#ifdef CONFIG_TUN_BATCH
+notify:
+#endif
       if (eventset)
         {
           tun_pollnotify(priv, eventset);
@@ -1180,6 +1604,13 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           return -EINVAL;
         }
 
+#ifndef CONFIG_TUN_BATCH
+      if ((ifr->ifr_flags & IFF_BATCH) != 0)
+        {
+          return -EINVAL;
+        }
+#endif
+
       tundev_lock(tun);
 
       free_tuns = tun->free_tuns;
@@ -1195,7 +1626,8 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
            intf++, free_tuns >>= 1);
 
       ret = tun_dev_init(&g_tun_devices[intf], filep,
-                         *ifr->ifr_name ? ifr->ifr_name : 0);
+                         *ifr->ifr_name ? ifr->ifr_name : 0,
+                         ifr->ifr_flags);
       if (ret != OK)
         {
           tundev_unlock(tun);
@@ -1212,6 +1644,25 @@ static int tun_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return OK;
     }
 
+#ifdef CONFIG_TUN_BATCH
+  if (cmd == TUNSETLOWAT && priv)
+    {
+      if (!priv->batch || arg < 1 || arg > CONFIG_TUN_BATCH_NBUFFERS)
+        {
+          return -EINVAL;
+        }
+
+      tun_lock(priv);
+      priv->rx_lowat = (uint8_t)arg;
+
+      /* Re-evaluate POLLIN against the new watermark */
+
+      tun_rxnotify(priv);
+      tun_unlock(priv);
+      return OK;
+    }
+#endif
+
   return -EBADFD;
 }
 
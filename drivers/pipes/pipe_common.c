@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <unistd.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -53,9 +54,12 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/drivers/drivers.h>
 #ifdef CONFIG_DEBUG_FEATURES
 #  include <nuttx/arch.h>
 #endif
@@ -145,6 +149,478 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
 #  define pipecommon_pollnotify(dev,event)
 #endif
 
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all of the threads waiting on a pipe semaphore.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (sem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      sem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_nbytes
+ *
+ * Description:
+ *   Return the number of bytes buffered in the pipe.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+  else
+    {
+      return (dev->d_bufsize - dev->d_rdndx) + dev->d_wrndx;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_threshold
+ *
+ * Description:
+ *   Limit a wake-up threshold to what the pipe can actually hold so that a
+ *   full (or empty) pipe always wakes the other end.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_threshold(FAR struct pipe_dev_s *dev,
+                                   size_t threshold)
+{
+  if (threshold > (size_t)dev->d_bufsize - 1)
+    {
+      threshold = dev->d_bufsize - 1;
+    }
+
+  return threshold > 0 ? threshold : 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdwakeup
+ *
+ * Description:
+ *   Data was added to the pipe.  Wake up the waiting readers if the read
+ *   threshold has been reached.  If a read timeout is set, the readers are
+ *   also woken when the first data arrives in an empty pipe so that they
+ *   can start timing.
+ *
+ ****************************************************************************/
+
+static void pipecommon_rdwakeup(FAR struct pipe_dev_s *dev, bool wasempty)
+{
+  if (pipecommon_nbytes(dev) >= pipecommon_threshold(dev, dev->d_rdthresh) ||
+      (wasempty && dev->d_rdtimeo > 0))
+    {
+      pipecommon_wakeup(&dev->d_rdsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_wrwakeup
+ *
+ * Description:
+ *   Data was removed from the pipe.  Wake up the waiting writers if the
+ *   write threshold (the amount of free space) has been reached.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wrwakeup(FAR struct pipe_dev_s *dev)
+{
+  size_t nfree = (dev->d_bufsize - 1) - pipecommon_nbytes(dev);
+
+  if (nfree >= pipecommon_threshold(dev, dev->d_wrthresh))
+    {
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_resize
+ *
+ * Description:
+ *   Change the size of the pipe buffer.  Buffered data is preserved and
+ *   must fit in the new buffer.  Called with d_bfsem held.
+ *
+ ****************************************************************************/
+
+static int pipecommon_resize(FAR struct pipe_dev_s *dev, size_t bufsize)
+{
+  FAR uint8_t *buffer;
+  size_t nbytes;
+  size_t seg;
+
+  if (bufsize < 2 || bufsize > CONFIG_DEV_PIPE_MAXSIZE)
+    {
+      return -EINVAL;
+    }
+
+  /* If no buffer is allocated, it will be allocated with the new size on
+   * the next open.
+   */
+
+  if (dev->d_buffer == NULL)
+    {
+      dev->d_bufsize = bufsize;
+      return OK;
+    }
+
+  nbytes = pipecommon_nbytes(dev);
+  if (nbytes > bufsize - 1)
+    {
+      return -EBUSY;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(bufsize);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Move the buffered data to the start of the new buffer */
+
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], nbytes);
+    }
+  else
+    {
+      seg = dev->d_bufsize - dev->d_rdndx;
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], seg);
+      memcpy(&buffer[seg], dev->d_buffer, dev->d_wrndx);
+    }
+
+  kmm_free(dev->d_buffer);
+  dev->d_buffer  = buffer;
+  dev->d_bufsize = bufsize;
+  dev->d_rdndx   = 0;
+  dev->d_wrndx   = nbytes;
+
+  /* There may be more room for the writers now */
+
+  pipecommon_wrwakeup(dev);
+  pipecommon_pollnotify(dev, POLLOUT);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splicecheck
+ *
+ * Description:
+ *   Verify that the other end of a splice is not this same pipe.  The pipe
+ *   is locked during the transfer, so that would deadlock.
+ *
+ ****************************************************************************/
+
+static int pipecommon_splicecheck(FAR struct file *filep, int fd)
+{
+  FAR struct file *other;
+
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      other = fs_getfilep(fd);
+      if (other == NULL)
+        {
+          return -EBADF;
+        }
+
+      if (other->f_inode == filep->f_inode)
+        {
+          return -EINVAL;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pipecommon_spliceout
+ *
+ * Description:
+ *   Write data from the pipe buffer directly to another file or socket.
+ *   Waits for data like read().  If 'peek' is true, the data is left in
+ *   the pipe (tee()).
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_spliceout(FAR struct file *filep,
+                                    FAR struct pipe_splice_s *ps, bool peek)
+{
+  FAR struct inode      *inode = filep->f_inode;
+  FAR struct pipe_dev_s *dev   = inode->i_private;
+  ssize_t                nmoved;
+  ssize_t                ret;
+  size_t                 seg;
+  pipe_ndx_t             rdndx;
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = pipecommon_splicecheck(filep, ps->ps_fd);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ps->ps_len == 0)
+    {
+      return 0;
+    }
+
+  if (sem_wait(&dev->d_bfsem) < 0)
+    {
+      return -get_errno();
+    }
+
+  /* Wait for data to be written to the pipe, just as for read() */
+
+  while (dev->d_wrndx == dev->d_rdndx)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0 || ps->ps_nonblock)
+        {
+          sem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      if (dev->d_nwriters <= 0)
+        {
+          sem_post(&dev->d_bfsem);
+          return 0;
+        }
+
+      sched_lock();
+      sem_post(&dev->d_bfsem);
+      ret = sem_wait(&dev->d_rdsem);
+      sched_unlock();
+
+      if (ret < 0 || sem_wait(&dev->d_bfsem) < 0)
+        {
+          return -get_errno();
+        }
+    }
+
+  /* Write out the contiguous regions of buffered data, in place.  The pipe
+   * stays locked, so the regions cannot change underneath the write.
+   */
+
+  nmoved = 0;
+  rdndx  = dev->d_rdndx;
+
+  while ((size_t)nmoved < ps->ps_len && rdndx != dev->d_wrndx)
+    {
+      if (dev->d_wrndx > rdndx)
+        {
+          seg = dev->d_wrndx - rdndx;
+        }
+      else
+        {
+          seg = dev->d_bufsize - rdndx;
+        }
+
+      if (seg > ps->ps_len - nmoved)
+        {
+          seg = ps->ps_len - nmoved;
+        }
+
+      if (ps->ps_offset != NULL)
+        {
+          ret = pwrite(ps->ps_fd, &dev->d_buffer[rdndx], seg,
+                       *ps->ps_offset);
+        }
+      else
+        {
+          ret = write(ps->ps_fd, &dev->d_buffer[rdndx], seg);
+        }
+
+      if (ret <= 0)
+        {
+          if (nmoved == 0)
+            {
+              nmoved = ret < 0 ? -get_errno() : 0;
+            }
+
+          break;
+        }
+
+      if (ps->ps_offset != NULL)
+        {
+          *ps->ps_offset += ret;
+        }
+
+      rdndx += ret;
+      if (rdndx >= dev->d_bufsize)
+        {
+          rdndx = 0;
+        }
+
+      nmoved += ret;
+      if ((size_t)ret < seg)
+        {
+          break;
+        }
+    }
+
+  /* Consume the data unless this is tee() */
+
+  if (!peek && nmoved > 0)
+    {
+      dev->d_rdndx = rdndx;
+      pipecommon_wrwakeup(dev);
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
+
+  sem_post(&dev->d_bfsem);
+  return nmoved;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splicein
+ *
+ * Description:
+ *   Read data from another file or socket directly into the pipe buffer.
+ *   Waits for space like write(), but returns after the first short read
+ *   from the source.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splicein(FAR struct file *filep,
+                                   FAR struct pipe_splice_s *ps)
+{
+  FAR struct inode      *inode = filep->f_inode;
+  FAR struct pipe_dev_s *dev   = inode->i_private;
+  ssize_t                nmoved = 0;
+  ssize_t                ret;
+  size_t                 seg;
+  bool                   wasempty;
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  ret = pipecommon_splicecheck(filep, ps->ps_fd);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (sem_wait(&dev->d_bfsem) < 0)
+    {
+      return -get_errno();
+    }
+
+  while ((size_t)nmoved < ps->ps_len)
+    {
+      /* Get the contiguous free region following the write index.  One
+       * byte is always left unused so that a full buffer can be told from
+       * an empty one.
+       */
+
+      if (dev->d_wrndx >= dev->d_rdndx)
+        {
+          seg = dev->d_bufsize - dev->d_wrndx;
+          if (dev->d_rdndx == 0)
+            {
+              seg--;
+            }
+        }
+      else
+        {
+          seg = dev->d_rdndx - dev->d_wrndx - 1;
+        }
+
+      if (seg == 0)
+        {
+          /* The pipe is full.  Return what has been moved, or wait for
+           * data to be removed from the pipe.
+           */
+
+          if (nmoved > 0)
+            {
+              break;
+            }
+
+          if ((filep->f_oflags & O_NONBLOCK) != 0 || ps->ps_nonblock)
+            {
+              nmoved = -EAGAIN;
+              break;
+            }
+
+          sched_lock();
+          sem_post(&dev->d_bfsem);
+          pipecommon_semtake(&dev->d_wrsem);
+          sched_unlock();
+          pipecommon_semtake(&dev->d_bfsem);
+          continue;
+        }
+
+      if (seg > ps->ps_len - nmoved)
+        {
+          seg = ps->ps_len - nmoved;
+        }
+
+      wasempty = (dev->d_wrndx == dev->d_rdndx);
+      if (ps->ps_offset != NULL)
+        {
+          ret = pread(ps->ps_fd, &dev->d_buffer[dev->d_wrndx], seg,
+                      *ps->ps_offset);
+        }
+      else
+        {
+          ret = read(ps->ps_fd, &dev->d_buffer[dev->d_wrndx], seg);
+        }
+
+      if (ret <= 0)
+        {
+          if (nmoved == 0)
+            {
+              nmoved = ret < 0 ? -get_errno() : 0;
+            }
+
+          break;
+        }
+
+      if (ps->ps_offset != NULL)
+        {
+          *ps->ps_offset += ret;
+        }
+
+      dev->d_wrndx += ret;
+      if (dev->d_wrndx >= dev->d_bufsize)
+        {
+          dev->d_wrndx = 0;
+        }
+
+      nmoved += ret;
+
+      /* Notify the waiting readers that more data is available */
+
+      pipecommon_rdwakeup(dev, wasempty);
+      pipecommon_pollnotify(dev, POLLIN);
+
+      if ((size_t)ret < seg)
+        {
+          break;
+        }
+    }
+
+  sem_post(&dev->d_bfsem);
+  return nmoved;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -171,7 +647,9 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
       sem_init(&dev->d_rdsem, 0, 0);
       sem_init(&dev->d_wrsem, 0, 0);
 
-      dev->d_bufsize = bufsize;
+      dev->d_bufsize  = bufsize;
+      dev->d_rdthresh = 1;
+      dev->d_wrthresh = 1;
     }
 
   return dev;
@@ -419,7 +897,10 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
 #endif
   ssize_t                nread  = 0;
-  int                    sval;
+  systime_t              begin  = 0;
+  bool                   timing = false;
+  size_t                 nbytes;
+  size_t                 seg;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -436,31 +917,82 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ERROR;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* Wait until there is something in the pipe.  If a read threshold is set,
+   * wait until that many bytes are buffered (or the request can be
+   * satisfied), until the read timeout expires after the first byte
+   * arrived, or until there are no more writers.
+   */
 
-  while (dev->d_wrndx == dev->d_rdndx)
+  for (; ; )
     {
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
+      nbytes = pipecommon_nbytes(dev);
+      if (nbytes > 0 &&
+          ((filep->f_oflags & O_NONBLOCK) != 0 || dev->d_nwriters <= 0 ||
+           nbytes >= pipecommon_threshold(dev, dev->d_rdthresh) ||
+           nbytes >= len))
         {
-          sem_post(&dev->d_bfsem);
-          return -EAGAIN;
+          break;
         }
 
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
+      if (nbytes == 0)
         {
-          sem_post(&dev->d_bfsem);
-          return 0;
+          /* If O_NONBLOCK was set, then return EGAIN */
+
+          if (filep->f_oflags & O_NONBLOCK)
+            {
+              sem_post(&dev->d_bfsem);
+              return -EAGAIN;
+            }
+
+          /* If there are no writers on the pipe, then return end of file */
+
+          if (dev->d_nwriters <= 0)
+            {
+              sem_post(&dev->d_bfsem);
+              return 0;
+            }
         }
 
-      /* Otherwise, wait for something to be written to the pipe */
+      /* Otherwise, wait for something (more) to be written to the pipe */
 
       sched_lock();
       sem_post(&dev->d_bfsem);
-      ret = sem_wait(&dev->d_rdsem);
+
+      if (nbytes > 0 && dev->d_rdtimeo > 0)
+        {
+          /* Some data is buffered, but less than the threshold.  Wait no
+           * longer than the read timeout, measured from the time that the
+           * data was first seen.
+           */
+
+          if (!timing)
+            {
+              begin  = clock_systimer();
+              timing = true;
+            }
+
+          ret = sem_tickwait(&dev->d_rdsem, begin, dev->d_rdtimeo);
+          if (ret == -ETIMEDOUT)
+            {
+              sched_unlock();
+              if (sem_wait(&dev->d_bfsem) < 0)
+                {
+                  return ERROR;
+                }
+
+              break;
+            }
+          else if (ret < 0)
+            {
+              set_errno(-ret);
+              ret = ERROR;
+            }
+        }
+      else
+        {
+          ret = sem_wait(&dev->d_rdsem);
+        }
+
       sched_unlock();
 
       if (ret < 0 || sem_wait(&dev->d_bfsem) < 0)
@@ -469,27 +1001,42 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
         }
     }
 
-  /* Then return whatever is available in the pipe (which is at least one byte) */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte), copying each contiguous region in one piece.
+   */
 
   nread = 0;
   while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
+      if (dev->d_wrndx > dev->d_rdndx)
         {
-          dev->d_rdndx = 0;
+          seg = dev->d_wrndx - dev->d_rdndx;
+        }
+      else
+        {
+          seg = dev->d_bufsize - dev->d_rdndx;
         }
 
-      nread++;
-    }
+      if (seg > len - nread)
+        {
+          seg = len - nread;
+        }
 
-  /* Notify all waiting writers that bytes have been removed from the buffer */
+      memcpy(buffer, &dev->d_buffer[dev->d_rdndx], seg);
+      buffer += seg;
+      nread  += seg;
 
-  while (sem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
-    {
-      sem_post(&dev->d_wrsem);
+      dev->d_rdndx += seg;
+      if (dev->d_rdndx >= dev->d_bufsize)
+        {
+          dev->d_rdndx = 0;
+        }
     }
 
+  /* Notify the waiting writers that bytes have been removed from the buffer */
+
+  pipecommon_wrwakeup(dev);
+
   /* Notify all poll/select waiters that they can write to the FIFO */
 
   pipecommon_pollnotify(dev, POLLOUT);
@@ -510,8 +1057,8 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
+  size_t                 seg;
+  bool                   wasempty;
 
   DEBUGASSERT(dev);
   pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
@@ -544,39 +1091,57 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
+  last     = 0;
+  wasempty = (dev->d_wrndx == dev->d_rdndx);
+
   for (; ; )
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Get the contiguous free region following the write index.  One
+       * byte is always left unused so that a full buffer can be told from
+       * an empty one.
+       */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      if (dev->d_wrndx >= dev->d_rdndx)
         {
-          nxtwrndx = 0;
+          seg = dev->d_bufsize - dev->d_wrndx;
+          if (dev->d_rdndx == 0)
+            {
+              seg--;
+            }
+        }
+      else
+        {
+          seg = dev->d_rdndx - dev->d_wrndx - 1;
         }
 
-      /* Would the next write overflow the circular buffer? */
-
-      if (nxtwrndx != dev->d_rdndx)
+      if (seg > 0)
         {
-          /* No... copy the byte */
+          /* Copy as much as fits in the region */
+
+          if (seg > len - nwritten)
+            {
+              seg = len - nwritten;
+            }
+
+          memcpy(&dev->d_buffer[dev->d_wrndx], buffer, seg);
+          buffer   += seg;
+          nwritten += seg;
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+          dev->d_wrndx += seg;
+          if (dev->d_wrndx >= dev->d_bufsize)
+            {
+              dev->d_wrndx = 0;
+            }
 
           /* Is the write complete? */
 
-          nwritten++;
           if ((size_t)nwritten >= len)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+              /* Yes.. Notify the waiting readers that more data is available */
 
-              while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  sem_post(&dev->d_rdsem);
-                }
+              pipecommon_rdwakeup(dev, wasempty);
 
-              /* Notify all poll/select waiters that they can write to the FIFO */
+              /* Notify all poll/select waiters that they can read from the FIFO */
 
               pipecommon_pollnotify(dev, POLLIN);
 
@@ -592,13 +1157,11 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
           if (last < nwritten)
             {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+              /* Yes.. Notify the waiting readers that more data is available */
 
-              while (sem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  sem_post(&dev->d_rdsem);
-                }
+              pipecommon_rdwakeup(dev, wasempty);
             }
+
           last = nwritten;
 
           /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
@@ -609,6 +1172,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                 {
                   nwritten = -EAGAIN;
                 }
+
               sem_post(&dev->d_bfsem);
               return nwritten;
             }
@@ -620,6 +1184,8 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           pipecommon_semtake(&dev->d_wrsem);
           sched_unlock();
           pipecommon_semtake(&dev->d_bfsem);
+
+          wasempty = (dev->d_wrndx == dev->d_rdndx);
         }
     }
 }
@@ -766,6 +1332,31 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* The splice commands manage the device lock themselves */
+
+  switch (cmd)
+    {
+      case PIPEIOC_SPLICEOUT:
+      case PIPEIOC_TEE:
+        {
+          FAR struct pipe_splice_s *ps =
+            (FAR struct pipe_splice_s *)((uintptr_t)arg);
+
+          return pipecommon_spliceout(filep, ps, cmd == PIPEIOC_TEE);
+        }
+
+      case PIPEIOC_SPLICEIN:
+        {
+          FAR struct pipe_splice_s *ps =
+            (FAR struct pipe_splice_s *)((uintptr_t)arg);
+
+          return pipecommon_splicein(filep, ps);
+        }
+
+      default:
+        break;
+    }
+
   pipecommon_semtake(&dev->d_bfsem);
 
   switch (cmd)
@@ -785,6 +1376,59 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case PIPEIOC_SETSIZE:
+        {
+          ret = pipecommon_resize(dev, (size_t)arg);
+        }
+        break;
+
+      case PIPEIOC_GETSIZE:
+        {
+          *(FAR size_t *)((uintptr_t)arg) = dev->d_bufsize;
+          ret = OK;
+        }
+        break;
+
+      case PIPEIOC_RDTHRESH:
+        {
+          if (arg > CONFIG_DEV_PIPE_MAXSIZE)
+            {
+              break;
+            }
+
+          dev->d_rdthresh = arg > 0 ? arg : 1;
+          ret = OK;
+        }
+        break;
+
+      case PIPEIOC_RDTIMEOUT:
+        {
+          dev->d_rdtimeo = MSEC2TICK(arg);
+          if (arg > 0 && dev->d_rdtimeo == 0)
+            {
+              dev->d_rdtimeo = 1;
+            }
+
+          ret = OK;
+        }
+        break;
+
+      case PIPEIOC_WRTHRESH:
+        {
+          if (arg > CONFIG_DEV_PIPE_MAXSIZE)
+            {
+              break;
+            }
+
+          dev->d_wrthresh = arg > 0 ? arg : 1;
+
+          /* Writers may already have enough room */
+
+          pipecommon_wrwakeup(dev);
+          ret = OK;
+        }
+        break;
+
       case FIONREAD:
         {
           int count;
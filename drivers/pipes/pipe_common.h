@@ -135,6 +135,9 @@ struct pipe_dev_s
   pipe_ndx_t d_wrndx;       /* Index in d_buffer to save next byte written */
   pipe_ndx_t d_rdndx;       /* Index in d_buffer to return the next byte read */
   pipe_ndx_t d_bufsize;     /* allocated size of d_buffer in bytes */
+  pipe_ndx_t d_rdthresh;    /* Wake readers when this many bytes are buffered */
+  pipe_ndx_t d_wrthresh;    /* Wake writers when this many bytes are free */
+  uint32_t   d_rdtimeo;     /* Read timeout (ticks) after the first byte, 0=none */
   uint8_t    d_refs;        /* References counts on pipe (limited to 255) */
   uint8_t    d_nwriters;    /* Number of reference counts for write access */
   uint8_t    d_nreaders;    /* Number of reference counts for read access */
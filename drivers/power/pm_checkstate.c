@@ -43,12 +43,63 @@
 
 #include <nuttx/power/pm.h>
 #include <nuttx/clock.h>
+#include <nuttx/arch.h>
 #include <nuttx/irq.h>
 
 #include "pm.h"
 
 #ifdef CONFIG_PM
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Convert a wake-up latency in microseconds to clock ticks, rounding up */
+
+#define PM_LATENCY_TICKS(us) (((us) + USEC_PER_TICK - 1) / USEC_PER_TICK)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_deepeststate
+ *
+ * Description:
+ *   Return the deepest power management state that can be woken up from
+ *   before the next timer event.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM_TICKLESS
+static enum pm_state_e pm_deepeststate(void)
+{
+  unsigned int remaining;
+
+  /* Zero means that no timer event is pending:  Any state will do */
+
+  remaining = sched_timer_remaining();
+  if (remaining == 0 ||
+      remaining > PM_LATENCY_TICKS(CONFIG_PM_SLEEP_LATENCY))
+    {
+      return PM_SLEEP;
+    }
+  else if (remaining > PM_LATENCY_TICKS(CONFIG_PM_STANDBY_LATENCY))
+    {
+      return PM_STANDBY;
+    }
+  else if (remaining > PM_LATENCY_TICKS(CONFIG_PM_IDLE_LATENCY))
+    {
+      return PM_IDLE;
+    }
+
+  return PM_NORMAL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -87,6 +138,7 @@
 enum pm_state_e pm_checkstate(int domain)
 {
   FAR struct pm_domain_s *pdom;
+  enum pm_state_e state;
   systime_t now;
   irqstate_t flags;
 
@@ -132,15 +184,35 @@ enum pm_state_e pm_checkstate(int domain)
       (void)pm_update(domain, accum);
     }
 
-  leave_critical_section(flags);
-
-  /* Return the recommended state.  Assuming that we are called from the
+  /* Get the recommended state.  Assuming that we are called from the
    * IDLE thread at the lowest priority level, any updates scheduled on the
    * worker thread above should have already been peformed and the recommended
    * state should be current:
    */
 
-  return pdom->recommended;
+  state = (enum pm_state_e)pdom->recommended;
+
+#ifdef CONFIG_PM_TICKLESS
+  {
+    enum pm_state_e deepest = pm_deepeststate();
+
+    /* Never recommend a state that cannot be woken up from in time for
+     * the next timer event.  But if the domain is idle and there has been
+     * no activity in this time slice, the time until the next timer event
+     * is the best prediction of the length of the sleep, so go as deep as
+     * it permits.
+     */
+
+    if (state > deepest ||
+        (state >= PM_IDLE && pdom->accum == 0))
+      {
+        state = deepest;
+      }
+  }
+#endif
+
+  leave_critical_section(flags);
+  return state;
 }
 
 #endif /* CONFIG_PM */
@@ -922,6 +922,30 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
   return (ssize_t)ret;
 }
 
+/****************************************************************************
+ * Name: rwb_flush
+ *
+ * Description:
+ *   Write any data held in the write buffer to the media now instead of
+ *   waiting for the write buffer timeout.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+int rwb_flush(FAR struct rwbuffer_s *rwb)
+{
+  if (rwb->wrmaxblocks > 0)
+    {
+      rwb_semtake(&rwb->wrsem);
+      rwb_wrcanceltimeout(rwb);
+      rwb_wrflush(rwb);
+      rwb_semgive(&rwb->wrsem);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_readbytes
  *
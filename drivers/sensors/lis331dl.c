@@ -48,6 +48,9 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/i2c/i2c_master.h>
 #include <nuttx/sensors/lis331dl.h>
+#ifdef CONFIG_SENSORS_UPPERHALF
+#  include <nuttx/sensors/sensor.h>
+#endif
 
 #if defined(CONFIG_I2C) && defined(CONFIG_LIS331DL)
 
@@ -98,6 +101,11 @@
 
 struct lis331dl_dev_s
 {
+#ifdef CONFIG_SENSORS_UPPERHALF
+  struct sensor_lowerhalf_s lower;  /* Must be first */
+  bool                     full;    /* Selected full scale */
+  bool                     fast;    /* Selected data rate */
+#endif
   struct i2c_master_s     *i2c;
   uint8_t                  address;
   struct lis331dl_vector_s a;
@@ -106,6 +114,32 @@ struct lis331dl_dev_s
   uint8_t                  cr3;
 };
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+static int lis331dl_activate(FAR struct sensor_lowerhalf_s *lower,
+                             bool enable);
+static int lis331dl_setinterval(FAR struct sensor_lowerhalf_s *lower,
+                                FAR uint32_t *interval);
+static int lis331dl_fetch(FAR struct sensor_lowerhalf_s *lower);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+static const struct sensor_ops_s g_lis331dl_ops =
+{
+  lis331dl_activate,     /* activate */
+  lis331dl_setinterval,  /* set_interval */
+  lis331dl_fetch,        /* fetch */
+  NULL                   /* control */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -227,6 +261,95 @@ static int lis331dl_readregs(FAR struct lis331dl_dev_s *dev)
   return OK;
 }
 
+/****************************************************************************
+ * Name: lis331dl_activate
+ *
+ * Description:
+ *   Sensor upper half method: Power the device up with the selected
+ *   conversion settings, or power it down.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+static int lis331dl_activate(FAR struct sensor_lowerhalf_s *lower,
+                             bool enable)
+{
+  FAR struct lis331dl_dev_s *dev = (FAR struct lis331dl_dev_s *)lower;
+  int ret;
+
+  if (enable)
+    {
+      ret = lis331dl_setconversion(dev, dev->full, dev->fast);
+    }
+  else
+    {
+      ret = lis331dl_powerdown(dev);
+    }
+
+  return ret == OK ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: lis331dl_setinterval
+ *
+ * Description:
+ *   Sensor upper half method: Select the 400 Hz data rate for intervals
+ *   below 10 ms and the 100 Hz data rate otherwise.
+ *
+ ****************************************************************************/
+
+static int lis331dl_setinterval(FAR struct sensor_lowerhalf_s *lower,
+                                FAR uint32_t *interval)
+{
+  FAR struct lis331dl_dev_s *dev = (FAR struct lis331dl_dev_s *)lower;
+
+  dev->fast = *interval < 10000;
+  *interval = dev->fast ? 2500 : 10000;
+
+  /* Apply the data rate now if the device is powered up */
+
+  if ((dev->cr1 & ST_LIS331DL_CR1_PD) != 0 &&
+      lis331dl_setconversion(dev, dev->full, dev->fast) != OK)
+    {
+      return -EIO;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lis331dl_fetch
+ *
+ * Description:
+ *   Sensor upper half method: Read the acceleration and push it as an event
+ *   in units of milli-g.
+ *
+ ****************************************************************************/
+
+static int lis331dl_fetch(FAR struct sensor_lowerhalf_s *lower)
+{
+  FAR struct lis331dl_dev_s *dev = (FAR struct lis331dl_dev_s *)lower;
+  FAR const struct lis331dl_vector_s *a;
+  struct sensor_event_xyz_s event;
+  int precision;
+
+  a = lis331dl_getreadings(dev);
+  if (a == NULL)
+    {
+      return -get_errno();
+    }
+
+  precision       = lis331dl_getprecision(dev);
+  event.timestamp = sensor_timestamp();
+  event.x         = (int32_t)a->x * precision;
+  event.y         = (int32_t)a->y * precision;
+  event.z         = (int32_t)a->z * precision;
+
+  sensor_push(lower, &event, 1);
+  return OK;
+}
+#endif /* CONFIG_SENSORS_UPPERHALF */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -423,4 +546,24 @@ lis331dl_getreadings(FAR struct lis331dl_dev_s * dev)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: lis331dl_register
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+int lis331dl_register(FAR const char *devpath, FAR struct lis331dl_dev_s *dev)
+{
+  ASSERT(dev);
+
+  dev->lower.ops      = &g_lis331dl_ops;
+  dev->lower.esize    = sizeof(struct sensor_event_xyz_s);
+  dev->lower.interval = 10000;
+
+  /* The device is powered up again when it is first opened */
+
+  (void)lis331dl_powerdown(dev);
+  return sensor_register(devpath, &dev->lower);
+}
+#endif
+
 #endif /* CONFIG_I2C && CONFIG_LIS331DL */
@@ -0,0 +1,683 @@
+/****************************************************************************
+ * drivers/sensors/sensor.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/sensors/sensor.h>
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Sampling interval used if the lower half does not provide one */
+
+#define SENSOR_DEFAULT_INTERVAL 100000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the state of the upper half driver */
+
+struct sensor_upperhalf_s
+{
+  FAR struct sensor_lowerhalf_s *lower; /* The lower half */
+  FAR uint8_t *buffer;                  /* Events buffer */
+  uint32_t head;                        /* Events written (free running) */
+  uint32_t tail;                        /* Events read (free running) */
+  uint32_t interval;                    /* Sampling interval (microseconds) */
+  uint16_t nevents;                     /* Capacity of the buffer in events */
+  uint16_t watermark;                   /* Events needed to wake readers */
+  uint8_t crefs;                        /* Number of open references */
+  volatile uint8_t nwaiters;            /* Number of blocked readers */
+  volatile bool active;                 /* Sampling is enabled */
+  sem_t exclsem;                        /* Supports mutual exclusion */
+  sem_t waitsem;                        /* Used to wait for events */
+  struct work_s work;                   /* Periodic fetch() of polled sensors */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *fds[CONFIG_SENSORS_NPOLLWAITERS];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     sensor_open(FAR struct file *filep);
+static int     sensor_close(FAR struct file *filep);
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     sensor_ioctl(FAR struct file *filep, int cmd,
+                 unsigned long arg);
+#ifndef CONFIG_DISABLE_POLL
+static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                 bool setup);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_sensor_fops =
+{
+  sensor_open,   /* open */
+  sensor_close,  /* close */
+  sensor_read,   /* read */
+  0,             /* write */
+  0,             /* seek */
+  sensor_ioctl   /* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+  , sensor_poll  /* poll */
+#endif
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , 0            /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_takesem
+ ****************************************************************************/
+
+static int sensor_takesem(FAR sem_t *sem)
+{
+  /* Take a count from the semaphore, possibly waiting */
+
+  if (sem_wait(sem) < 0)
+    {
+      /* EINTR is the only error that we expect */
+
+      int errcode = get_errno();
+      DEBUGASSERT(errcode == EINTR);
+      return -errcode;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_pollnotify
+ *
+ * Description:
+ *   Wake up the poll waiters.  Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static void sensor_pollnotify(FAR struct sensor_upperhalf_s *priv)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+    {
+      fds = priv->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & POLLIN);
+          if (fds->revents != 0)
+            {
+              sninfo("Report events: %02x\n", fds->revents);
+              sem_post(fds->sem);
+            }
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: sensor_worker
+ *
+ * Description:
+ *   Periodically poll sensors that have no interrupt.
+ *
+ ****************************************************************************/
+
+static void sensor_worker(FAR void *arg)
+{
+  FAR struct sensor_upperhalf_s *priv = (FAR struct sensor_upperhalf_s *)arg;
+  FAR struct sensor_lowerhalf_s *lower = priv->lower;
+  systime_t delay;
+
+  if (!priv->active)
+    {
+      return;
+    }
+
+  (void)lower->ops->fetch(lower);
+
+  delay = USEC2TICK(priv->interval);
+  (void)work_queue(LPWORK, &priv->work, sensor_worker, priv,
+                   delay > 0 ? delay : 1);
+}
+
+/****************************************************************************
+ * Name: sensor_activate
+ ****************************************************************************/
+
+static int sensor_activate(FAR struct sensor_upperhalf_s *priv, bool enable)
+{
+  FAR struct sensor_lowerhalf_s *lower = priv->lower;
+  int ret;
+
+  if (priv->active == enable)
+    {
+      return OK;
+    }
+
+  ret = lower->ops->activate(lower, enable);
+  if (ret < 0)
+    {
+      snerr("ERROR: activate() failed: %d\n", ret);
+      return ret;
+    }
+
+  priv->active = enable;
+
+  if (lower->ops->fetch != NULL)
+    {
+      if (enable)
+        {
+          (void)work_queue(LPWORK, &priv->work, sensor_worker, priv, 0);
+        }
+      else
+        {
+          (void)work_cancel(LPWORK, &priv->work);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_open
+ *
+ * Description:
+ *   This function is called whenever the sensor device is opened.  Sampling
+ *   is enabled on the first open.
+ *
+ ****************************************************************************/
+
+static int sensor_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *priv = inode->i_private;
+  int ret;
+
+  ret = sensor_takesem(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (priv->crefs == UINT8_MAX)
+    {
+      ret = -EMFILE;
+    }
+  else if (priv->crefs == 0)
+    {
+      ret = sensor_activate(priv, true);
+    }
+
+  if (ret >= 0)
+    {
+      priv->crefs++;
+    }
+
+  sem_post(&priv->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_close
+ *
+ * Description:
+ *   This function is called when the sensor device is closed.  Sampling is
+ *   disabled on the last close.
+ *
+ ****************************************************************************/
+
+static int sensor_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *priv = inode->i_private;
+  int ret;
+
+  ret = sensor_takesem(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(priv->crefs > 0);
+  if (--priv->crefs == 0)
+    {
+      (void)sensor_activate(priv, false);
+    }
+
+  sem_post(&priv->exclsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sensor_read
+ *
+ * Description:
+ *   Return as many buffered events as fit in the user buffer.  If there are
+ *   no events, wait until the watermark is reached unless the device was
+ *   opened with O_NONBLOCK.
+ *
+ ****************************************************************************/
+
+static ssize_t sensor_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *priv = inode->i_private;
+  size_t esize = priv->lower->esize;
+  size_t nread = 0;
+  size_t max;
+  irqstate_t flags;
+  int ret;
+
+  max = buflen / esize;
+  if (max == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Interrupts are disabled so that the lower half cannot add (and
+   * possibly overwrite) events while they are copied.
+   */
+
+  flags = enter_critical_section();
+  while (priv->head == priv->tail)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      priv->nwaiters++;
+      ret = sem_wait(&priv->waitsem);
+      if (ret < 0)
+        {
+          if (priv->nwaiters > 0)
+            {
+              priv->nwaiters--;
+            }
+
+          leave_critical_section(flags);
+          return -EINTR;
+        }
+    }
+
+  while (priv->head != priv->tail && nread < max)
+    {
+      memcpy(buffer, &priv->buffer[(priv->tail % priv->nevents) * esize],
+             esize);
+      priv->tail++;
+      buffer += esize;
+      nread++;
+    }
+
+  leave_critical_section(flags);
+  return nread * esize;
+}
+
+/****************************************************************************
+ * Name: sensor_ioctl
+ ****************************************************************************/
+
+static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *priv = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = priv->lower;
+  irqstate_t flags;
+  int ret;
+
+  ret = sensor_takesem(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case SNIOC_ACTIVATE:
+        ret = sensor_activate(priv, arg != 0);
+        break;
+
+      case SNIOC_SET_INTERVAL:
+        {
+          FAR uint32_t *interval = (FAR uint32_t *)((uintptr_t)arg);
+
+          if (interval == NULL || *interval == 0)
+            {
+              ret = -EINVAL;
+            }
+          else if (lower->ops->set_interval == NULL)
+            {
+              ret = -ENOSYS;
+            }
+          else
+            {
+              ret = lower->ops->set_interval(lower, interval);
+              if (ret >= 0)
+                {
+                  /* A polled sensor picks up the new interval on its next
+                   * fetch.
+                   */
+
+                  priv->interval = *interval;
+                }
+            }
+        }
+        break;
+
+      case SNIOC_SET_WATERMARK:
+        if (arg < 1 || arg > priv->nevents)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            priv->watermark = (uint16_t)arg;
+          }
+        break;
+
+      case SNIOC_GET_INFO:
+        {
+          FAR struct sensor_info_s *info =
+            (FAR struct sensor_info_s *)((uintptr_t)arg);
+
+          if (info == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              info->esize    = lower->esize;
+              info->nevents  = priv->nevents;
+              info->interval = priv->interval;
+            }
+        }
+        break;
+
+      case SNIOC_FLUSH:
+        flags      = enter_critical_section();
+        priv->tail = priv->head;
+        leave_critical_section(flags);
+        break;
+
+      default:
+        if (lower->ops->control != NULL)
+          {
+            ret = lower->ops->control(lower, cmd, arg);
+          }
+        else
+          {
+            ret = -ENOTTY;
+          }
+        break;
+    }
+
+  sem_post(&priv->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sensor_poll
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+static int sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *priv = inode->i_private;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = sensor_takesem(&priv->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      /* Find an available slot for the poll structure reference */
+
+      for (i = 0; i < CONFIG_SENSORS_NPOLLWAITERS; i++)
+        {
+          if (priv->fds[i] == NULL)
+            {
+              priv->fds[i] = fds;
+              fds->priv    = &priv->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_SENSORS_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else
+        {
+          /* Report immediately if the watermark has already been reached */
+
+          flags = enter_critical_section();
+          if (priv->head - priv->tail >= priv->watermark)
+            {
+              sensor_pollnotify(priv);
+            }
+
+          leave_critical_section(flags);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      /* This is a request to tear down the poll */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  sem_post(&priv->exclsem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_push
+ *
+ * Description:
+ *   Add events to the buffer of a sensor.  If the buffer is full, the
+ *   oldest events are discarded.  This may be called from interrupt level.
+ *
+ ****************************************************************************/
+
+void sensor_push(FAR struct sensor_lowerhalf_s *lower,
+                 FAR const void *events, size_t nevents)
+{
+  FAR struct sensor_upperhalf_s *priv =
+    (FAR struct sensor_upperhalf_s *)lower->upper;
+  FAR const uint8_t *src = (FAR const uint8_t *)events;
+  size_t esize = lower->esize;
+  irqstate_t flags;
+
+  DEBUGASSERT(priv != NULL);
+
+  flags = enter_critical_section();
+  for (; nevents > 0; nevents--)
+    {
+      if (priv->head - priv->tail >= priv->nevents)
+        {
+          priv->tail++;
+        }
+
+      memcpy(&priv->buffer[(priv->head % priv->nevents) * esize], src,
+             esize);
+      priv->head++;
+      src += esize;
+    }
+
+  if (priv->head - priv->tail >= priv->watermark)
+    {
+#ifndef CONFIG_DISABLE_POLL
+      sensor_pollnotify(priv);
+#endif
+
+      while (priv->nwaiters > 0)
+        {
+          priv->nwaiters--;
+          sem_post(&priv->waitsem);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current system time in microseconds for use as an event
+ *   timestamp.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void)
+{
+  struct timespec ts;
+
+  (void)clock_systimespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Bind a sensor lower half to a new instance of the sensor upper half and
+ *   register the character driver as 'devpath'.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR const char *devpath,
+                    FAR struct sensor_lowerhalf_s *lower)
+{
+  FAR struct sensor_upperhalf_s *priv;
+  uint16_t nevents;
+  int ret;
+
+  DEBUGASSERT(devpath && lower && lower->ops && lower->ops->activate &&
+              lower->esize >= sizeof(struct sensor_event_s));
+
+  nevents = lower->nevents > 0 ? lower->nevents : CONFIG_SENSORS_NEVENTS;
+
+  /* Allocate the upper half state and the event buffer together */
+
+  priv = (FAR struct sensor_upperhalf_s *)
+    kmm_zalloc(sizeof(struct sensor_upperhalf_s) + nevents * lower->esize);
+  if (priv == NULL)
+    {
+      snerr("ERROR: Failed to allocate device structure\n");
+      return -ENOMEM;
+    }
+
+  priv->lower     = lower;
+  priv->buffer    = (FAR uint8_t *)(priv + 1);
+  priv->nevents   = nevents;
+  priv->watermark = 1;
+  priv->interval  = lower->interval > 0 ? lower->interval :
+                    SENSOR_DEFAULT_INTERVAL;
+
+  sem_init(&priv->exclsem, 0, 1);
+  sem_init(&priv->waitsem, 0, 0);
+
+  lower->upper = priv;
+
+  ret = register_driver(devpath, &g_sensor_fops, 0444, priv);
+  if (ret < 0)
+    {
+      snerr("ERROR: register_driver failed: %d\n", ret);
+      sem_destroy(&priv->exclsem);
+      sem_destroy(&priv->waitsem);
+      lower->upper = NULL;
+      kmm_free(priv);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_SENSORS_UPPERHALF */
@@ -68,6 +68,10 @@
 
 #define uart_putc(ch) up_putc(ch)
 
+#ifndef CONFIG_SERIAL_TXWATERMARK
+#  define CONFIG_SERIAL_TXWATERMARK 0
+#endif
+
 #define HALF_SECOND_MSEC 500
 #define HALF_SECOND_USEC 500000L
 
@@ -326,6 +330,178 @@ static int uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock)
   return OK;
 }
 
+/************************************************************************************
+ * Name: uart_putxmitbuf
+ *
+ * Description:
+ *   Copy as much of the caller's buffer as will fit into the TX circular buffer
+ *   without blocking.  At most two contiguous copies are needed; the free space
+ *   may only grow while this runs because the interrupt or DMA logic moves only
+ *   the tail index.
+ *
+ ************************************************************************************/
+
+static size_t uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                              size_t buflen)
+{
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+  size_t ncopied = 0;
+  size_t nbytes;
+  int16_t head;
+  int16_t tail;
+
+  while (ncopied < buflen)
+    {
+      head = txbuf->head;
+      tail = txbuf->tail;
+
+      /* Get the size of the contiguous free region at the head.  One byte
+       * is always left free so that a full buffer can be distinguished from
+       * an empty one.
+       */
+
+      if (head >= tail)
+        {
+          nbytes = txbuf->size - head;
+          if (tail == 0)
+            {
+              nbytes--;
+            }
+        }
+      else
+        {
+          nbytes = tail - head - 1;
+        }
+
+      if (nbytes == 0)
+        {
+          break;
+        }
+
+      if (nbytes > buflen - ncopied)
+        {
+          nbytes = buflen - ncopied;
+        }
+
+      memcpy(&txbuf->buffer[head], &buffer[ncopied], nbytes);
+
+      head += nbytes;
+      if (head >= txbuf->size)
+        {
+          head = 0;
+        }
+
+      txbuf->head = head;
+      ncopied    += nbytes;
+    }
+
+  return ncopied;
+}
+
+/************************************************************************************
+ * Name: uart_xmitrun
+ *
+ * Description:
+ *   Return the number of leading characters in the buffer that need no output
+ *   post-processing and so may be copied to the TX buffer as is.
+ *
+ ************************************************************************************/
+
+static size_t uart_xmitrun(FAR uart_dev_t *dev, FAR const char *buffer,
+                           size_t buflen)
+{
+  size_t nbytes;
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  bool crnl;
+  bool nlcr;
+
+  if ((dev->tc_oflag & OPOST) == 0)
+    {
+      return buflen;
+    }
+
+  crnl = (dev->tc_oflag & OCRNL) != 0;
+  nlcr = (dev->tc_oflag & (ONLCR | ONLRET)) != 0;
+
+  if (!crnl && !nlcr)
+    {
+      return buflen;
+    }
+
+  for (nbytes = 0; nbytes < buflen; nbytes++)
+    {
+      if ((buffer[nbytes] == '\r' && crnl) ||
+          (buffer[nbytes] == '\n' && nlcr))
+        {
+          break;
+        }
+    }
+
+#else
+  /* Only the console converts \n -> \r\n */
+
+  if (!dev->isconsole)
+    {
+      return buflen;
+    }
+
+  for (nbytes = 0; nbytes < buflen && buffer[nbytes] != '\n'; nbytes++)
+    {
+    }
+#endif
+
+  return nbytes;
+}
+
+/************************************************************************************
+ * Name: uart_getrecvbuf
+ *
+ * Description:
+ *   Copy the contiguous run of data at the tail of the RX circular buffer into
+ *   the caller's buffer.  Any data that wraps around the end of the RX buffer is
+ *   picked up by the next call.
+ *
+ ************************************************************************************/
+
+static size_t uart_getrecvbuf(FAR uart_dev_t *dev, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  int16_t head = rxbuf->head;
+  int16_t tail = rxbuf->tail;
+  size_t nbytes;
+
+  if (head >= tail)
+    {
+      nbytes = head - tail;
+    }
+  else
+    {
+      nbytes = rxbuf->size - tail;
+    }
+
+  if (nbytes > buflen)
+    {
+      nbytes = buflen;
+    }
+
+  memcpy(buffer, &rxbuf->buffer[tail], nbytes);
+
+  /* Update the tail index in one store; the RX interrupt and DMA logic only
+   * read it.
+   */
+
+  tail += nbytes;
+  if (tail >= rxbuf->size)
+    {
+      tail = 0;
+    }
+
+  rxbuf->tail = tail;
+  return nbytes;
+}
+
 /************************************************************************************
  * Name: uart_irqwrite
  ************************************************************************************/
@@ -366,6 +542,7 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  size_t            nbytes;
   bool              oktoblock;
   int               ret;
   char              ch;
@@ -444,8 +621,26 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
    */
 
   uart_disabletxint(dev);
-  for (; buflen; buflen--)
+  while (buflen > 0)
     {
+      /* Copy any run of characters that needs no output post-processing
+       * directly into the TX buffer.  Only fall back to the character at a
+       * time logic below for characters that must be translated or when the
+       * TX buffer is full and we may have to wait.
+       */
+
+      nbytes = uart_xmitrun(dev, buffer, buflen);
+      if (nbytes > 0)
+        {
+          nbytes = uart_putxmitbuf(dev, buffer, nbytes);
+          if (nbytes > 0)
+            {
+              buffer += nbytes;
+              buflen -= nbytes;
+              continue;
+            }
+        }
+
       ch  = *buffer++;
       ret = OK;
 
@@ -534,6 +729,8 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
 
           break;
         }
+
+      buflen--;
     }
 
   if (dev->xmit.head != dev->xmit.tail)
@@ -563,8 +760,11 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
+  size_t nbytes;
   int16_t tail;
+#ifdef CONFIG_SERIAL_TERMIOS
   char ch;
+#endif
   int ret;
 
   /* Only one user can access rxbuf->tail at a time */
@@ -617,27 +817,27 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
       tail = rxbuf->tail;
       if (rxbuf->head != tail)
         {
-          /* Take the next character from the tail of the buffer */
+#ifdef CONFIG_SERIAL_TERMIOS
+          /* Do input processing if any is enabled */
 
-          ch = rxbuf->buffer[tail];
+          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
+            {
+              /* Take the next character from the tail of the buffer */
 
-          /* Increment the tail index.  Most operations are done using the
-           * local variable 'tail' so that the final rxbuf->tail update
-           * is atomic.
-           */
+              ch = rxbuf->buffer[tail];
 
-          if (++tail >= rxbuf->size)
-            {
-              tail = 0;
-            }
+              /* Increment the tail index.  Most operations are done using
+               * the local variable 'tail' so that the final rxbuf->tail
+               * update is atomic.
+               */
 
-          rxbuf->tail = tail;
+              if (++tail >= rxbuf->size)
+                {
+                  tail = 0;
+                }
 
-#ifdef CONFIG_SERIAL_TERMIOS
-          /* Do input processing if any is enabled */
+              rxbuf->tail = tail;
 
-          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
-            {
               /* \n -> \r or \r -> \n translation? */
 
               if ((ch == '\n') && (dev->tc_iflag & INLCR))
@@ -655,6 +855,22 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                 {
                   continue;
                 }
+
+              /* Store the received character */
+
+              *buffer++ = ch;
+              recvd++;
+            }
+          else
+#endif
+            {
+              /* No input processing.  Copy the contiguous run of data at
+               * the tail of the buffer in one step.
+               */
+
+              nbytes  = uart_getrecvbuf(dev, buffer, buflen - recvd);
+              buffer += nbytes;
+              recvd  += nbytes;
             }
 
           /* Specifically not handled:
@@ -665,12 +881,6 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
            * IUCLC - Not Posix
            * IXON/OXOFF - no xon/xoff flow control.
            */
-#endif
-
-          /* Store the received character */
-
-          *buffer++ = ch;
-          recvd++;
         }
 
 #ifdef CONFIG_DEV_SERIAL_FULLBLOCKS
@@ -1438,6 +1648,35 @@ void uart_datareceived(FAR uart_dev_t *dev)
 
 void uart_datasent(FAR uart_dev_t *dev)
 {
+#if CONFIG_SERIAL_TXWATERMARK > 0
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+  unsigned int nbuffered;
+  unsigned int watermark;
+
+  /* How many bytes are still buffered */
+
+  if (txbuf->head >= txbuf->tail)
+    {
+      nbuffered = txbuf->head - txbuf->tail;
+    }
+  else
+    {
+      nbuffered = txbuf->size - txbuf->tail + txbuf->head;
+    }
+
+  /* Don't wake up the writer until there is enough free space for it to
+   * make worthwhile progress.  The wake-up is never deferred once the TX
+   * buffer is empty so it cannot be lost:  The lower half will call back
+   * again while there is still data to be sent.
+   */
+
+  watermark = ((100 - CONFIG_SERIAL_TXWATERMARK) * txbuf->size) / 100;
+  if (nbuffered > 0 && nbuffered > watermark)
+    {
+      return;
+    }
+#endif
+
   /* Is there a thread waiting for space in xmit.buffer?  */
 
   if (dev->xmitwaiting)
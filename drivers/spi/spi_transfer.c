@@ -0,0 +1,158 @@
+/****************************************************************************
+ * drivers/spi/spi_transfer.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/spi/spi.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_TRANSFER
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_sequence
+ *
+ * Description:
+ *   Perform one sequence with the select() and exchange() methods.
+ *
+ ****************************************************************************/
+
+static void spi_sequence(FAR struct spi_dev_s *spi,
+                         FAR struct spi_sequence_s *seq)
+{
+  FAR struct spi_trans_s *trans;
+  bool selected = false;
+  int i;
+
+  SPI_SETMODE(spi, (enum spi_mode_e)seq->mode);
+  SPI_SETBITS(spi, seq->nbits);
+  (void)SPI_SETFREQUENCY(spi, seq->frequency);
+
+  for (i = 0; i < seq->ntrans; i++)
+    {
+      trans = &seq->trans[i];
+
+      if (!selected)
+        {
+          SPI_SELECT(spi, seq->dev, true);
+          selected = true;
+        }
+
+#ifdef CONFIG_SPI_CMDDATA
+      (void)SPI_CMDDATA(spi, seq->dev, trans->cmd);
+#endif
+
+      SPI_EXCHANGE(spi, trans->txbuffer, trans->rxbuffer, trans->nwords);
+
+      if (trans->deselect)
+        {
+          SPI_SELECT(spi, seq->dev, false);
+          selected = false;
+        }
+
+      if (trans->delay > 0)
+        {
+          up_udelay(trans->delay);
+        }
+    }
+
+  if (selected)
+    {
+      SPI_SELECT(spi, seq->dev, false);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer
+ *
+ * Description:
+ *   Execute a chain of SPI sequences.  The bus is locked once for the whole
+ *   chain.  If the SPI lower half provides the transfer() method, then the
+ *   chain is passed to it so that it may run the segments back-to-back
+ *   (for example, as one chain of DMA descriptors).  Otherwise, each
+ *   segment is performed with the select() and exchange() methods.
+ *
+ * Input Parameters:
+ *   spi - The SPI bus
+ *   seq - The first sequence of the chain
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+{
+  int ret = OK;
+
+  DEBUGASSERT(spi != NULL && seq != NULL);
+
+  (void)SPI_LOCK(spi, true);
+
+  if (spi->ops->transfer != NULL)
+    {
+      ret = spi->ops->transfer(spi, seq);
+    }
+  else
+    {
+      for (; seq != NULL; seq = seq->flink)
+        {
+          spi_sequence(spi, seq);
+        }
+    }
+
+  (void)SPI_LOCK(spi, false);
+  return ret;
+}
+
+#endif /* CONFIG_SPI_TRANSFER */
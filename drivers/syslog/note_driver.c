@@ -40,10 +40,18 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <sched.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <fcntl.h>
 #include <assert.h>
+#include <debug.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kthread.h>
 #include <nuttx/sched_note.h>
 #include <nuttx/fs/fs.h>
 
@@ -55,7 +63,9 @@
  ****************************************************************************/
 
 static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
-                 size_t buflen);
+                         size_t buflen);
+static int     note_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -68,19 +78,53 @@ static const struct file_operations note_fops =
   note_read,     /* read */
   0,             /* write */
   0,             /* seek */
-  0              /* ioctl */
+  note_ioctl     /* ioctl */
 #ifndef CONFIG_DISABLE_POLL
   , 0            /* poll */
 #endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , 0            /* unlink */
-#endif 
+#endif
 };
 
+/* The note buffer supports only one consumer at a time.  This semaphore
+ * serializes readers of /dev/note and the streaming thread.
+ */
+
+static sem_t g_note_exclsem;
+
+#ifdef CONFIG_DRIVER_NOTE_STREAM
+/* The streaming thread drains the note buffer through this buffer */
+
+static uint8_t g_note_stream[CONFIG_DRIVER_NOTE_STREAM_BUFSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: note_takesem
+ ****************************************************************************/
+
+static int note_takesem(void)
+{
+  while (sem_wait(&g_note_exclsem) < 0)
+    {
+      int errcode = get_errno();
+
+      DEBUGASSERT(errcode == EINTR);
+      if (errcode != EINTR)
+        {
+          return -errcode;
+        }
+    }
+
+  return OK;
+}
+
+#define note_givesem() sem_post(&g_note_exclsem)
+
 /****************************************************************************
  * Name: note_read
  ****************************************************************************/
@@ -88,58 +132,135 @@ static const struct file_operations note_fops =
 static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
                          size_t buflen)
 {
-  ssize_t notelen;
-  ssize_t retlen ;
+  ssize_t retlen;
 
   DEBUGASSERT(filep != 0 && buffer != NULL && buflen > 0);
 
-  /* Then loop, adding as many notes as possible to the user buffer. */
+  retlen = note_takesem();
+  if (retlen < 0)
+    {
+      return retlen;
+    }
+
+  /* Add as many complete notes as possible to the user buffer */
+
+  retlen = sched_note_read((FAR uint8_t *)buffer, buflen);
+
+  note_givesem();
+  return retlen;
+}
+
+/****************************************************************************
+ * Name: note_ioctl
+ ****************************************************************************/
+
+static int note_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR uint32_t *value = (FAR uint32_t *)((uintptr_t)arg);
 
-  retlen = 0;
-  sched_lock();
-  do
+  switch (cmd)
     {
-     /* Get the next note (removing it from the buffer) */
+      /* Return the rate at which the note time stamps increment */
+
+      case NOTEIOC_GETFREQ:
+        if (value == NULL)
+          {
+            return -EINVAL;
+          }
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+        *value = up_perf_getfreq();
+#else
+        *value = CLK_TCK;
+#endif
+        return OK;
+
+      /* Return the number of notes dropped because the buffer was full */
+
+      case NOTEIOC_GETOVERRUN:
+        if (value == NULL)
+          {
+            return -EINVAL;
+          }
+
+        *value = sched_note_overrun();
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Name: note_stream
+ *
+ * Description:
+ *   Kernel thread that drains the note buffer to a character device (a
+ *   fast UART, a USB CDC/ACM device, an RTT channel, ...) so that a host
+ *   can capture the notes continuously.  The notes are written in the
+ *   same binary format as returned by read() of /dev/note.
+ *
+ ****************************************************************************/
 
-     notelen = sched_note_get((FAR uint8_t *)buffer, buflen);
-     if (notelen < 0)
-       {
-         /* We were unable to read the next note, probably because it will
-          * not fit into the user buffer.
-          */
+#ifdef CONFIG_DRIVER_NOTE_STREAM
+static int note_stream(int argc, FAR char *argv[])
+{
+  ssize_t nread;
+  ssize_t nwritten;
+  size_t offset;
+  int fd = -1;
 
-         if (retlen == 0)
-           {
-             /* If nothing was read then report the error.  Otherwise,
-              * just silently drop the note.
-              */
+  for (; ; )
+    {
+      /* The device may not be registered yet when the thread starts */
 
-             retlen = notelen;
-           }
+      if (fd < 0)
+        {
+          fd = open(CONFIG_DRIVER_NOTE_STREAM_DEVPATH, O_WRONLY);
+          if (fd < 0)
+            {
+              usleep(CONFIG_DRIVER_NOTE_STREAM_PERIOD * USEC_PER_MSEC);
+              continue;
+            }
+        }
 
-         break;
-       }
+      if (note_takesem() < 0)
+        {
+          continue;
+        }
 
-      /* Update pointers from the note that was transferred */
+      nread = sched_note_read(g_note_stream, sizeof(g_note_stream));
+      note_givesem();
 
-      retlen += notelen;
-      buffer += notelen;
-      buflen -= notelen;
+      if (nread <= 0)
+        {
+          /* Nothing to send (or a note too large to send was dropped) */
 
-      /* Will the next note fit?  There is a race here and even if the next
-       * note will fit, it may fail still when sched_note_get() is called.
-       *
-       * It won't fit (or an error occurred).  Return what we have without
-       * trying to get the next note (which would cause it to be deleted).
-       */
+          usleep(CONFIG_DRIVER_NOTE_STREAM_PERIOD * USEC_PER_MSEC);
+          continue;
+        }
 
-      notelen = sched_note_size();
+      for (offset = 0; offset < (size_t)nread; offset += nwritten)
+        {
+          nwritten = write(fd, &g_note_stream[offset], nread - offset);
+          if (nwritten < 0)
+            {
+              if (get_errno() == EINTR)
+                {
+                  nwritten = 0;
+                  continue;
+                }
+
+              serr("ERROR: write to %s failed: %d\n",
+                   CONFIG_DRIVER_NOTE_STREAM_DEVPATH, get_errno());
+              break;
+            }
+        }
     }
-  while (notelen > 0 && notelen <= buflen);
 
-  sched_unlock();
-  return retlen;
+  return OK;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -150,7 +271,9 @@ static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
  *
  * Description:
  *   Register a serial driver at /dev/note that can be used by an
- *   application to read data from the circular not buffer.
+ *   application to read data from the circular not buffer.  If
+ *   CONFIG_DRIVER_NOTE_STREAM is selected, also start the thread that
+ *   streams the notes to CONFIG_DRIVER_NOTE_STREAM_DEVPATH.
  *
  * Input Parameters:
  *   None.
@@ -163,7 +286,23 @@ static ssize_t note_read(FAR struct file *filep, FAR char *buffer,
 
 int note_register(void)
 {
+#ifdef CONFIG_DRIVER_NOTE_STREAM
+  int pid;
+#endif
+
+  sem_init(&g_note_exclsem, 0, 1);
+
+#ifdef CONFIG_DRIVER_NOTE_STREAM
+  pid = kernel_thread("note_stream", CONFIG_DRIVER_NOTE_STREAM_PRIORITY,
+                      CONFIG_DRIVER_NOTE_STREAM_STACKSIZE,
+                      note_stream, (FAR char * const *)NULL);
+  if (pid < 0)
+    {
+      serr("ERROR: Failed to start the note stream: %d\n", pid);
+    }
+#endif
+
   return register_driver("/dev/note", &note_fops, 0666, NULL);
 }
 
-#endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER && CONFIG_DRIVER_NOTE */
\ No newline at end of file
+#endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER && CONFIG_DRIVER_NOTE */
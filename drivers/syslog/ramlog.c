@@ -107,6 +107,7 @@ static int ramlog_flush(void);
 static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
                               pollevent_t eventset);
 #endif
+static int     ramlog_putbyte(FAR struct ramlog_dev_s *priv, char ch);
 static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
 
 /* Character driver methods */
@@ -129,7 +130,8 @@ static const struct syslog_channel_s g_ramlog_syslog_channel =
 {
   ramlog_putc,
   ramlog_putc,
-  ramlog_flush
+  ramlog_flush,
+  ramlog_syslog_write
 };
 #endif
 
@@ -230,18 +232,18 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
 #endif
 
 /****************************************************************************
- * Name: ramlog_addchar
+ * Name: ramlog_putbyte
+ *
+ * Description:
+ *   Add one byte to the circular buffer.  The caller must have entered a
+ *   critical section.
+ *
  ****************************************************************************/
 
-static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
+static int ramlog_putbyte(FAR struct ramlog_dev_s *priv, char ch)
 {
-  irqstate_t flags;
   size_t nexthead;
 
-  /* Disable interrupts (in case we are NOT called from interrupt handler) */
-
-  flags = enter_critical_section();
-
   /* Calculate the write index AFTER the next byte is written */
 
   nexthead = priv->rl_head + 1;
@@ -256,18 +258,33 @@ static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
     {
       /* Yes... Return an indication that nothing was saved in the buffer. */
 
-      leave_critical_section(flags);
       return -EBUSY;
     }
 
-  /* No... copy the byte and re-enable interrupts */
+  /* No... copy the byte */
 
   priv->rl_buffer[priv->rl_head] = ch;
   priv->rl_head = nexthead;
-  leave_critical_section(flags);
   return OK;
 }
 
+/****************************************************************************
+ * Name: ramlog_addchar
+ ****************************************************************************/
+
+static int ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
+{
+  irqstate_t flags;
+  int ret;
+
+  /* Disable interrupts (in case we are NOT called from interrupt handler) */
+
+  flags = enter_critical_section();
+  ret = ramlog_putbyte(priv, ch);
+  leave_critical_section(flags);
+  return ret;
+}
+
 /****************************************************************************
  * Name: ramlog_read
  ****************************************************************************/
@@ -817,4 +834,60 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Name: ramlog_syslog_write
+ *
+ * Description:
+ *   This is the low-level system logging interface for a buffer of data.
+ *   The whole buffer is added to the RAM log with interrupts disabled only
+ *   once.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
+ssize_t ramlog_syslog_write(FAR const char *buffer, size_t buflen)
+{
+  FAR struct ramlog_dev_s *priv = &g_sysdev;
+  irqstate_t flags;
+  size_t nwritten;
+  int ret = OK;
+
+  flags = enter_critical_section();
+
+  for (nwritten = 0; nwritten < buflen; nwritten++)
+    {
+#ifdef CONFIG_RAMLOG_CRLF
+      /* Ignore carriage returns and pre-pend a newline with a carriage
+       * return.
+       */
+
+      if (buffer[nwritten] == '\r')
+        {
+          continue;
+        }
+
+      if (buffer[nwritten] == '\n')
+        {
+          ret = ramlog_putbyte(priv, '\r');
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+#endif
+
+      ret = ramlog_putbyte(priv, buffer[nwritten]);
+      if (ret < 0)
+        {
+          /* The buffer is full.  The rest of the data is dropped. */
+
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return nwritten > 0 || buflen == 0 ? (ssize_t)nwritten : ret;
+}
+#endif
+
 #endif /* CONFIG_RAMLOG */
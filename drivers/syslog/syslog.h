@@ -42,7 +42,9 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdbool.h>
+#include <stdarg.h>
 
 /****************************************************************************
  * Public Data
@@ -253,6 +255,24 @@ int syslog_flush_intbuffer(FAR const struct syslog_channel_s *channel,
 
 int syslog_putc(int ch);
 
+/****************************************************************************
+ * Name: syslog_write
+ *
+ * Description:
+ *   This is the low-level system logging interface for a buffer of data.
+ *
+ * Input Parameters:
+ *   buffer - The data to add to the SYSLOG
+ *   buflen - The number of bytes in buffer
+ *
+ * Returned Value:
+ *   On success, the number of bytes written is returned.  A negated errno
+ *   value is returned on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t syslog_write(FAR const char *buffer, size_t buflen);
+
 /****************************************************************************
  * Name: syslog_force
  *
@@ -292,6 +312,27 @@ int syslog_force(int ch);
 int syslog_dev_putc(int ch);
 #endif
 
+/****************************************************************************
+ * Name: syslog_dev_write
+ *
+ * Description:
+ *   This is the low-level system logging interface provided for the
+ *   character driver interface.  It writes a buffer of data.
+ *
+ * Input Parameters:
+ *   buffer - The data to add to the SYSLOG
+ *   buflen - The number of bytes in buffer
+ *
+ * Returned Value:
+ *   On success, buflen is returned.  A negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t syslog_dev_write(FAR const char *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: syslog_dev_flush
  *
@@ -310,6 +351,44 @@ int syslog_dev_putc(int ch);
 int syslog_dev_flush(void);
 #endif
 
+/****************************************************************************
+ * Name: syslog_defer
+ *
+ * Description:
+ *   Store a message in the ring of the current CPU to be formatted later
+ *   by the deferred logging thread.
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   fmt      - The format string.  It must remain valid until the message
+ *              has been formatted.
+ *   ap       - The message arguments.  These are not consumed.
+ *
+ * Returned Value:
+ *   True if the message was deferred (or dropped because the ring was
+ *   full).  False if the message must be formatted immediately.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+bool syslog_defer(int priority, FAR const char *fmt, FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_defer_start
+ *
+ * Description:
+ *   Start the thread that formats the deferred messages.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_defer_start(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
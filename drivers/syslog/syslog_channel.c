@@ -81,7 +81,8 @@ const struct syslog_channel_s g_default_channel =
 {
   ramlog_putc,
   ramlog_putc,
-  syslog_default_flush
+  syslog_default_flush,
+  ramlog_syslog_write
 };
 #elif defined(HAVE_LOWPUTC)
 const struct syslog_channel_s g_default_channel =
@@ -0,0 +1,831 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <syslog.h>
+#include <time.h>
+#include <debug.h>
+
+#include <nuttx/init.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/circbuf.h>
+#include <nuttx/kthread.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SYSLOG_DEFERRED_BUFSIZE & (CONFIG_SYSLOG_DEFERRED_BUFSIZE - 1)) != 0
+#  error CONFIG_SYSLOG_DEFERRED_BUFSIZE must be a power of two
+#endif
+
+#if CONFIG_SYSLOG_DEFERRED_MAXRECORD > CONFIG_SYSLOG_DEFERRED_BUFSIZE
+#  error CONFIG_SYSLOG_DEFERRED_MAXRECORD exceeds the ring size
+#endif
+
+#ifdef CONFIG_SMP
+#  define NRINGS         CONFIG_SMP_NCPUS
+#  define this_ring()    (&g_syslog_defer[up_cpu_index()])
+#else
+#  define NRINGS         1
+#  define this_ring()    (&g_syslog_defer[0])
+#endif
+
+#define RING_MASK        (CONFIG_SYSLOG_DEFERRED_BUFSIZE - 1)
+
+/* The longest conversion specification that will be deferred, the number
+ * of '*' arguments that it may take, and the size of the buffer that
+ * holds it after the '*' arguments have been substituted.
+ */
+
+#define SPEC_MAXLEN      16
+#define SPEC_MAXSTAR     2
+#define SPEC_BUFSIZE     (SPEC_MAXLEN + SPEC_MAXSTAR * 12)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The type of the argument consumed by a conversion specification */
+
+enum syslog_arg_e
+{
+  SYSLOG_ARG_NONE = 0,          /* "%%" takes no argument */
+  SYSLOG_ARG_INT,               /* int (also %c) */
+  SYSLOG_ARG_LONG,              /* long */
+  SYSLOG_ARG_LONGLONG,          /* long long */
+  SYSLOG_ARG_PTR,               /* void * */
+  SYSLOG_ARG_DOUBLE,            /* double */
+  SYSLOG_ARG_STRING             /* char *, copied into the record */
+};
+
+/* One parsed conversion specification */
+
+struct syslog_spec_s
+{
+  uint8_t len;                  /* Length, from '%' to the conversion */
+  uint8_t nstar;                /* Number of '*' (int) arguments */
+  uint8_t type;                 /* See enum syslog_arg_e */
+};
+
+/* Each message is stored as this header followed by the raw values of its
+ * arguments in the order that they are consumed by the format string.
+ * The values are copied with memcpy() and need not be aligned.
+ */
+
+struct syslog_record_s
+{
+  uint16_t len;                 /* Size of the record, header included */
+  uint8_t priority;             /* The message priority */
+  uint8_t pad;
+  FAR const char *fmt;          /* The (static) format string */
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;           /* When the message was logged */
+#endif
+};
+
+/* A record is assembled in this buffer before it is copied into the ring */
+
+union syslog_recbuf_u
+{
+  struct syslog_record_s hdr;
+  uint8_t bytes[CONFIG_SYSLOG_DEFERRED_MAXRECORD];
+};
+
+/* One ring per CPU.  The writers on a CPU are serialized by disabling
+ * local interrupts so that no lock is shared between CPUs; the drain
+ * thread is the only reader.
+ */
+
+struct syslog_ring_s
+{
+  volatile unsigned int head;   /* Written only by the owning CPU */
+  volatile unsigned int tail;   /* Written only by the drain thread */
+  volatile uint32_t ndropped;   /* Records lost because the ring was full */
+  uint32_t nreported;           /* Drops already reported by the drain */
+  uint8_t buffer[CONFIG_SYSLOG_DEFERRED_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_defer[NRINGS];
+
+/* Messages are deferred only while the drain thread is running */
+
+static volatile bool g_syslog_defer_running;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_defer_parse
+ *
+ * Description:
+ *   Parse the conversion specification that begins with the '%' at fmt.
+ *   This must consume arguments exactly as lib_vsprintf() does.
+ *
+ * Returned Value:
+ *   A pointer to the character following the specification or NULL if the
+ *   specification cannot be deferred.
+ *
+ ****************************************************************************/
+
+static FAR const char *syslog_defer_parse(FAR const char *fmt,
+                                          FAR struct syslog_spec_s *spec)
+{
+  FAR const char *start = fmt;
+  bool islong = false;
+  bool islonglong = false;
+
+  spec->nstar = 0;
+
+  /* Skip over the flags, field width, and precision */
+
+  for (fmt++; *fmt != '\0' && strchr("diuxXpobeEfgGlLsc%", *fmt) == NULL;
+       fmt++)
+    {
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
+      if (*fmt == '*')
+        {
+          spec->nstar++;
+        }
+#endif
+    }
+
+  if (*fmt == '%')
+    {
+      spec->type = SYSLOG_ARG_NONE;
+    }
+  else if (*fmt == 's')
+    {
+      spec->type = SYSLOG_ARG_STRING;
+    }
+  else if (*fmt == 'c')
+    {
+      spec->type = SYSLOG_ARG_INT;
+    }
+  else
+    {
+      if (*fmt == 'L')
+        {
+          islonglong = true;
+          fmt++;
+        }
+      else if (*fmt == 'l')
+        {
+          islong = true;
+          fmt++;
+          if (*fmt == 'l')
+            {
+              islonglong = true;
+              fmt++;
+            }
+        }
+
+      if (*fmt == '\0')
+        {
+          return NULL;
+        }
+      else if (strchr("diuxXpob", *fmt) != NULL)
+        {
+          spec->type = SYSLOG_ARG_INT;
+
+#if defined(CONFIG_HAVE_LONG_LONG) && defined(CONFIG_LIBC_LONG_LONG)
+          if (islonglong && *fmt != 'p')
+            {
+              spec->type = SYSLOG_ARG_LONGLONG;
+            }
+          else
+#endif
+#ifdef CONFIG_LONG_IS_NOT_INT
+          if (islong && *fmt != 'p')
+            {
+              spec->type = SYSLOG_ARG_LONG;
+            }
+          else
+#endif
+#ifdef CONFIG_PTR_IS_NOT_INT
+          if (*fmt == 'p')
+            {
+              spec->type = SYSLOG_ARG_PTR;
+            }
+          else
+#endif
+            {
+              UNUSED(islong);
+              UNUSED(islonglong);
+            }
+        }
+      else if (strchr("eEfgG", *fmt) != NULL)
+        {
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          spec->type = SYSLOG_ARG_DOUBLE;
+#else
+          spec->type = SYSLOG_ARG_NONE;
+#endif
+        }
+      else
+        {
+          return NULL;
+        }
+    }
+
+  spec->len = fmt - start + 1;
+  if (spec->len > SPEC_MAXLEN || spec->nstar > SPEC_MAXSTAR)
+    {
+      return NULL;
+    }
+
+  return fmt + 1;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_putarg
+ *
+ * Description:
+ *   Append the raw value of one argument to the record being assembled.
+ *
+ ****************************************************************************/
+
+static bool syslog_defer_putarg(FAR union syslog_recbuf_u *rec,
+                                FAR size_t *len, FAR const void *value,
+                                size_t size)
+{
+  if (*len + size > CONFIG_SYSLOG_DEFERRED_MAXRECORD)
+    {
+      return false;
+    }
+
+  memcpy(&rec->bytes[*len], value, size);
+  *len += size;
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_capture
+ *
+ * Description:
+ *   Assemble the record for one message: Walk the format string and store
+ *   the raw value of each argument.  Strings are copied (and truncated if
+ *   the record would become too large).
+ *
+ * Returned Value:
+ *   The size of the record or zero if the message cannot be deferred.
+ *
+ ****************************************************************************/
+
+static size_t syslog_defer_capture(FAR union syslog_recbuf_u *rec,
+                                   FAR const char *fmt, va_list ap)
+{
+  struct syslog_spec_s spec;
+  FAR const char *str;
+  size_t len = sizeof(struct syslog_record_s);
+  size_t slen;
+  int i;
+
+  while ((fmt = strchr(fmt, '%')) != NULL)
+    {
+      fmt = syslog_defer_parse(fmt, &spec);
+      if (fmt == NULL)
+        {
+          return 0;
+        }
+
+      for (i = 0; i < spec.nstar; i++)
+        {
+          int star = va_arg(ap, int);
+          if (!syslog_defer_putarg(rec, &len, &star, sizeof(int)))
+            {
+              return 0;
+            }
+        }
+
+      switch (spec.type)
+        {
+          case SYSLOG_ARG_NONE:
+          default:
+            break;
+
+          case SYSLOG_ARG_INT:
+            {
+              int value = va_arg(ap, int);
+              if (!syslog_defer_putarg(rec, &len, &value, sizeof(value)))
+                {
+                  return 0;
+                }
+            }
+            break;
+
+#ifdef CONFIG_LONG_IS_NOT_INT
+          case SYSLOG_ARG_LONG:
+            {
+              long value = va_arg(ap, long);
+              if (!syslog_defer_putarg(rec, &len, &value, sizeof(value)))
+                {
+                  return 0;
+                }
+            }
+            break;
+#endif
+
+#if defined(CONFIG_HAVE_LONG_LONG) && defined(CONFIG_LIBC_LONG_LONG)
+          case SYSLOG_ARG_LONGLONG:
+            {
+              long long value = va_arg(ap, long long);
+              if (!syslog_defer_putarg(rec, &len, &value, sizeof(value)))
+                {
+                  return 0;
+                }
+            }
+            break;
+#endif
+
+#ifdef CONFIG_PTR_IS_NOT_INT
+          case SYSLOG_ARG_PTR:
+            {
+              FAR void *value = va_arg(ap, FAR void *);
+              if (!syslog_defer_putarg(rec, &len, &value, sizeof(value)))
+                {
+                  return 0;
+                }
+            }
+            break;
+#endif
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          case SYSLOG_ARG_DOUBLE:
+            {
+              double value = va_arg(ap, double);
+              if (!syslog_defer_putarg(rec, &len, &value, sizeof(value)))
+                {
+                  return 0;
+                }
+            }
+            break;
+#endif
+
+          case SYSLOG_ARG_STRING:
+            {
+              /* The string may not exist by the time that the record is
+               * formatted, so it is copied into the record.
+               */
+
+              str = va_arg(ap, FAR const char *);
+              if (str == NULL)
+                {
+                  str = "(null)";
+                }
+
+              if (len >= CONFIG_SYSLOG_DEFERRED_MAXRECORD)
+                {
+                  return 0;
+                }
+
+              slen = strlen(str);
+              if (len + slen + 1 > CONFIG_SYSLOG_DEFERRED_MAXRECORD)
+                {
+                  slen = CONFIG_SYSLOG_DEFERRED_MAXRECORD - len - 1;
+                }
+
+              memcpy(&rec->bytes[len], str, slen);
+              rec->bytes[len + slen] = '\0';
+              len += slen + 1;
+            }
+            break;
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_format
+ *
+ * Description:
+ *   Format one record to the SYSLOG stream.
+ *
+ ****************************************************************************/
+
+static void syslog_defer_format(FAR struct lib_outstream_s *stream,
+                                FAR union syslog_recbuf_u *rec)
+{
+  struct syslog_spec_s spec;
+  FAR const char *fmt = rec->hdr.fmt;
+  FAR const char *next;
+  FAR const uint8_t *arg = &rec->bytes[sizeof(struct syslog_record_s)];
+  char buffer[SPEC_BUFSIZE];
+  int nstar;
+  int star;
+  int len;
+  int i;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  (void)lib_sprintf(stream, "[%6d.%06d]", rec->hdr.ts.tv_sec,
+                    rec->hdr.ts.tv_nsec / 1000);
+#endif
+
+  while (*fmt != '\0')
+    {
+      if (*fmt != '%')
+        {
+          stream->put(stream, *fmt++);
+          continue;
+        }
+
+      /* The format was parsed successfully when the record was captured */
+
+      next = syslog_defer_parse(fmt, &spec);
+      DEBUGASSERT(next != NULL);
+
+      /* Copy the specification, replacing each '*' with its value */
+
+      for (i = 0, len = 0, nstar = 0; i < spec.len; i++)
+        {
+          if (fmt[i] == '*' && nstar < spec.nstar)
+            {
+              memcpy(&star, arg, sizeof(int));
+              arg += sizeof(int);
+              nstar++;
+
+              len += snprintf(&buffer[len], SPEC_BUFSIZE - len, "%d", star);
+            }
+          else
+            {
+              buffer[len++] = fmt[i];
+            }
+        }
+
+      buffer[len] = '\0';
+      fmt = next;
+
+      switch (spec.type)
+        {
+          case SYSLOG_ARG_NONE:
+          default:
+            (void)lib_sprintf(stream, buffer);
+            break;
+
+          case SYSLOG_ARG_INT:
+            {
+              int value;
+
+              memcpy(&value, arg, sizeof(value));
+              arg += sizeof(value);
+              (void)lib_sprintf(stream, buffer, value);
+            }
+            break;
+
+#ifdef CONFIG_LONG_IS_NOT_INT
+          case SYSLOG_ARG_LONG:
+            {
+              long value;
+
+              memcpy(&value, arg, sizeof(value));
+              arg += sizeof(value);
+              (void)lib_sprintf(stream, buffer, value);
+            }
+            break;
+#endif
+
+#if defined(CONFIG_HAVE_LONG_LONG) && defined(CONFIG_LIBC_LONG_LONG)
+          case SYSLOG_ARG_LONGLONG:
+            {
+              long long value;
+
+              memcpy(&value, arg, sizeof(value));
+              arg += sizeof(value);
+              (void)lib_sprintf(stream, buffer, value);
+            }
+            break;
+#endif
+
+#ifdef CONFIG_PTR_IS_NOT_INT
+          case SYSLOG_ARG_PTR:
+            {
+              FAR void *value;
+
+              memcpy(&value, arg, sizeof(value));
+              arg += sizeof(value);
+              (void)lib_sprintf(stream, buffer, value);
+            }
+            break;
+#endif
+
+#ifdef CONFIG_LIBC_FLOATINGPOINT
+          case SYSLOG_ARG_DOUBLE:
+            {
+              double value;
+
+              memcpy(&value, arg, sizeof(value));
+              arg += sizeof(value);
+              (void)lib_sprintf(stream, buffer, value);
+            }
+            break;
+#endif
+
+          case SYSLOG_ARG_STRING:
+            (void)lib_sprintf(stream, buffer, (FAR const char *)arg);
+            arg += strlen((FAR const char *)arg) + 1;
+            break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_defer_drain
+ *
+ * Description:
+ *   Format and output all of the records in one ring.
+ *
+ * Returned Value:
+ *   The number of records output.
+ *
+ ****************************************************************************/
+
+static int syslog_defer_drain(FAR struct syslog_ring_s *ring)
+{
+  struct lib_syslogstream_s stream;
+  union syslog_recbuf_u rec;
+  unsigned int tail;
+  unsigned int offset;
+  unsigned int n;
+  uint32_t ndropped;
+  uint16_t len;
+  int nrecords = 0;
+
+  syslogstream(&stream);
+
+  for (tail = ring->tail; tail != ring->head; tail += len)
+    {
+      /* Make sure that the record is read after the head index */
+
+      CIRCBUF_BARRIER();
+
+      /* Copy the record out of the ring.  It may wrap around the end. */
+
+      offset = tail & RING_MASK;
+      n      = CONFIG_SYSLOG_DEFERRED_BUFSIZE - offset;
+
+      memcpy(&rec.bytes[0], &ring->buffer[offset], n < 2 ? n : 2);
+      if (n < 2)
+        {
+          memcpy(&rec.bytes[n], &ring->buffer[0], 2 - n);
+        }
+
+      len = rec.hdr.len;
+      DEBUGASSERT(len >= sizeof(struct syslog_record_s) &&
+                  len <= CONFIG_SYSLOG_DEFERRED_MAXRECORD);
+
+      if (n >= len)
+        {
+          memcpy(&rec.bytes[0], &ring->buffer[offset], len);
+        }
+      else
+        {
+          memcpy(&rec.bytes[0], &ring->buffer[offset], n);
+          memcpy(&rec.bytes[n], &ring->buffer[0], len - n);
+        }
+
+      /* Release the space to the writers before formatting */
+
+      CIRCBUF_BARRIER();
+      ring->tail = tail + len;
+
+      syslog_defer_format(&stream.public, &rec);
+      syslogstream_flush(&stream);
+      nrecords++;
+    }
+
+  /* Report any messages that were lost since the last time */
+
+  ndropped = ring->ndropped;
+  if (ndropped != ring->nreported)
+    {
+      (void)lib_sprintf(&stream.public, "[%lu syslog messages dropped]\n",
+                        (unsigned long)(ndropped - ring->nreported));
+      syslogstream_flush(&stream);
+      ring->nreported = ndropped;
+    }
+
+  return nrecords;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_thread
+ *
+ * Description:
+ *   The low priority kernel thread that formats the deferred messages.
+ *
+ ****************************************************************************/
+
+static int syslog_defer_thread(int argc, FAR char *argv[])
+{
+  int i;
+
+  for (; ; )
+    {
+      for (i = 0; i < NRINGS; i++)
+        {
+          (void)syslog_defer_drain(&g_syslog_defer[i]);
+        }
+
+      usleep(CONFIG_SYSLOG_DEFERRED_PERIOD * USEC_PER_MSEC);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_defer
+ *
+ * Description:
+ *   Store the format string pointer and the raw argument values of a
+ *   message in the ring of the current CPU.  The message will be formatted
+ *   later by the drain thread.
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   fmt      - The format string.  It must remain valid (normally, a string
+ *              constant) until the message has been formatted.
+ *   ap       - The message arguments
+ *
+ * Returned Value:
+ *   True if the message was deferred (or dropped because the ring was
+ *   full).  False if the message must be formatted immediately: The drain
+ *   thread is not running or the format cannot be deferred.
+ *
+ * Assumptions:
+ *   May be called from interrupt handlers.
+ *
+ ****************************************************************************/
+
+bool syslog_defer(int priority, FAR const char *fmt, FAR va_list *ap)
+{
+  FAR struct syslog_ring_s *ring;
+  union syslog_recbuf_u rec;
+  irqstate_t flags;
+  unsigned int offset;
+  unsigned int n;
+  va_list copy;
+  size_t len;
+
+  if (!g_syslog_defer_running)
+    {
+      return false;
+    }
+
+  /* Assemble the record on the stack.  The arguments must be left intact
+   * in case the message has to be formatted immediately after all.
+   */
+
+  va_copy(copy, *ap);
+  len = syslog_defer_capture(&rec, fmt, copy);
+  va_end(copy);
+
+  if (len == 0)
+    {
+      return false;
+    }
+
+  rec.hdr.len      = len;
+  rec.hdr.priority = priority;
+  rec.hdr.pad      = 0;
+  rec.hdr.fmt      = fmt;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  if (clock_systimespec(&rec.hdr.ts) < 0)
+    {
+      rec.hdr.ts.tv_sec  = 0;
+      rec.hdr.ts.tv_nsec = 0;
+    }
+#endif
+
+  /* Disabling local interrupts serializes the writers on this CPU and
+   * keeps the thread from migrating to another CPU.
+   */
+
+  flags = up_irq_save();
+  ring  = this_ring();
+
+  if (CONFIG_SYSLOG_DEFERRED_BUFSIZE - (ring->head - ring->tail) < len)
+    {
+      ring->ndropped++;
+    }
+  else
+    {
+      offset = ring->head & RING_MASK;
+      n      = CONFIG_SYSLOG_DEFERRED_BUFSIZE - offset;
+
+      if (n >= len)
+        {
+          memcpy(&ring->buffer[offset], rec.bytes, len);
+        }
+      else
+        {
+          memcpy(&ring->buffer[offset], rec.bytes, n);
+          memcpy(&ring->buffer[0], &rec.bytes[n], len - n);
+        }
+
+      /* Publish the record only after it is complete */
+
+      CIRCBUF_BARRIER();
+      ring->head += len;
+    }
+
+  up_irq_restore(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_start
+ *
+ * Description:
+ *   Start the thread that formats the deferred messages.  Messages are
+ *   formatted immediately until then.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int syslog_defer_start(void)
+{
+  int pid;
+
+  if (g_syslog_defer_running)
+    {
+      return OK;
+    }
+
+  pid = kernel_thread("syslog_defer", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                      CONFIG_SYSLOG_DEFERRED_STACKSIZE, syslog_defer_thread,
+                      (FAR char * const *)NULL);
+  if (pid < 0)
+    {
+      return -get_errno();
+    }
+
+  g_syslog_defer_running = true;
+  return OK;
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
@@ -81,6 +81,7 @@ static const struct syslog_channel_s g_syslog_dev_channel =
 #endif
   syslog_devchan_force,
   syslog_dev_flush,
+  syslog_dev_write
 };
 
 /****************************************************************************
@@ -53,6 +53,8 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/syslog/syslog.h>
 
@@ -75,6 +77,18 @@
 
 #define NO_HOLDER     ((pid_t)-1)
 
+/* Output to a file in a mounted file system is collected in a RAM buffer
+ * and written to the file a block at a time.
+ */
+
+#if defined(CONFIG_SYSLOG_FILE) && !defined(CONFIG_DISABLE_MOUNTPOINT) && \
+    CONFIG_SYSLOG_FILE_BUFSIZE > 0
+#  define HAVE_FILEBUFFER
+#  if defined(CONFIG_SCHED_WORKQUEUE) && CONFIG_SYSLOG_FILE_FLUSHDELAY > 0
+#    define HAVE_FLUSHWORK
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -101,6 +115,14 @@ struct syslog_dev_s
   pid_t        sl_holder;   /* PID of the thread that holds the semaphore */
   struct file  sl_file;     /* The syslog file structure */
   FAR char    *sl_devpath;  /* Full path to the character device */
+#ifdef HAVE_FILEBUFFER
+  bool         sl_buffered; /* Output is collected in sl_buffer */
+  size_t       sl_nbuf;     /* Number of bytes in sl_buffer */
+#ifdef HAVE_FLUSHWORK
+  struct work_s sl_work;    /* Writes sl_buffer after a delay */
+#endif
+  char         sl_buffer[CONFIG_SYSLOG_FILE_BUFSIZE];
+#endif
 };
 
 /****************************************************************************
@@ -184,6 +206,224 @@ static inline void syslog_dev_givesem(void)
   sem_post(&g_syslog_dev.sl_sem);
 }
 
+/****************************************************************************
+ * Name: syslog_dev_outputready
+ *
+ * Description:
+ *   Check if the SYSLOG device is ready for output, re-opening it if
+ *   necessary.
+ *
+ * Returned Value:
+ *   Zero (OK) if output may be attempted; a negated errno value if the
+ *   output must be ignored.
+ *
+ ****************************************************************************/
+
+static int syslog_dev_outputready(void)
+{
+  int ret;
+
+  /* Ignore any output:
+   *
+   * (1) Before the SYSLOG device has been initialized.  This could happen
+   *     from debug output that occurs early in the boot sequence before
+   *     syslog_dev_initialize() is called (SYSLOG_UNINITIALIZED).
+   * (2) While the device is being initialized.  The case could happen if
+   *     debug output is generated while syslog_dev_initialize() executes
+   *     (SYSLOG_INITIALIZING).
+   * (3) While we are generating SYSLOG output.  The case could happen if
+   *     debug output is generated while syslog_dev_write() executes
+   *     (This case is actually handled inside of syslog_semtake()).
+   * (4) Any debug output generated from interrupt handlers.  A disadvantage
+   *     of using the generic character device for the SYSLOG is that it
+   *     cannot handle debug output generated from interrupt level handlers.
+   * (5) Any debug output generated from the IDLE loop.  The character
+   *     driver interface is blocking and the IDLE thread is not permitted
+   *     to block.
+   * (6) If an irrecoverable failure occurred during initialization.  In
+   *     this case, we won't ever bother to try again (ever).
+   *
+   * NOTE: That the third case is different.  It applies only to the thread
+   * that currently holds the sl_sem sempaphore.  Other threads should wait.
+   * that is why that case is handled in syslog_semtake().
+   */
+
+  /* Cases (4) and (5) */
+
+  if (up_interrupt_context() || getpid() == 0)
+    {
+      return -ENOSYS;
+    }
+
+  /* We can save checks in the usual case:  That after the SYSLOG device
+   * has been successfully opened.
+   */
+
+  if (g_syslog_dev.sl_state != SYSLOG_OPENED)
+    {
+      /* Case (1) and (2) */
+
+      if (g_syslog_dev.sl_state == SYSLOG_UNINITIALIZED ||
+          g_syslog_dev.sl_state == SYSLOG_INITIALIZING)
+       {
+         return -EAGAIN; /* Can't access the SYSLOG now... maybe next time? */
+       }
+
+      /* Case (6) */
+
+      if (g_syslog_dev.sl_state == SYSLOG_FAILURE)
+        {
+          return -ENXIO;  /* There is no SYSLOG device */
+        }
+
+      /* syslog_dev_initialize() is called as soon as enough of the operating
+       * system is in place to support the open operation... but it is
+       * possible that the SYSLOG device is not yet registered at that time.
+       * In this case, we know that the system is sufficiently initialized
+       * to support an attempt to re-open the SYSLOG device.
+       *
+       * NOTE that the scheduler is locked.  That is because we do not have
+       * fully initialized semaphore capability until the SYSLOG device is
+       * successfully initialized
+       */
+
+      sched_lock();
+      if (g_syslog_dev.sl_state == SYSLOG_REOPEN)
+        {
+          /* Try again to initialize the device.  We may do this repeatedly
+           * because the log device might be something that was not ready
+           * the first time that syslog_dev_initializee() was called (such as a
+           * USB serial device that has not yet been connected or a file in
+           * an NFS mounted file system that has not yet been mounted).
+           */
+
+          DEBUGASSERT(g_syslog_dev.sl_devpath != NULL);
+          ret = syslog_dev_initialize(g_syslog_dev.sl_devpath,
+                                      (int)g_syslog_dev.sl_oflags,
+                                      (int)g_syslog_dev.sl_mode);
+          if (ret < 0)
+            {
+              sched_unlock();
+              return ret;
+            }
+        }
+
+      sched_unlock();
+      DEBUGASSERT(g_syslog_dev.sl_state == SYSLOG_OPENED);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_dev_drain
+ *
+ * Description:
+ *   Write the data collected in the RAM buffer to the file.  The caller
+ *   must hold the semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_FILEBUFFER
+static int syslog_dev_drain(void)
+{
+  ssize_t nwritten;
+  size_t offset;
+  int ret = OK;
+
+  for (offset = 0; offset < g_syslog_dev.sl_nbuf; offset += nwritten)
+    {
+      nwritten = file_write(&g_syslog_dev.sl_file,
+                            &g_syslog_dev.sl_buffer[offset],
+                            g_syslog_dev.sl_nbuf - offset);
+      if (nwritten <= 0)
+        {
+          /* The rest of the data is lost */
+
+          ret = nwritten < 0 ? (int)nwritten : -EIO;
+          break;
+        }
+    }
+
+  g_syslog_dev.sl_nbuf = 0;
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_dev_flushwork
+ *
+ * Description:
+ *   Write the RAM buffer to the file some time after data was added to it
+ *   so that the file does not lag far behind when the logging stops.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_FLUSHWORK
+static void syslog_dev_flushwork(FAR void *arg)
+{
+  (void)syslog_dev_flush();
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_dev_output
+ *
+ * Description:
+ *   Output data to the SYSLOG device or, for a file in a mounted file
+ *   system, to the RAM buffer.  The caller must hold the semaphore.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_dev_output(FAR const char *buffer, size_t buflen)
+{
+#ifdef HAVE_FILEBUFFER
+  if (g_syslog_dev.sl_buffered)
+    {
+      size_t nwritten;
+      size_t ncopy;
+      int ret;
+
+      for (nwritten = 0; nwritten < buflen; nwritten += ncopy)
+        {
+          if (g_syslog_dev.sl_nbuf >= CONFIG_SYSLOG_FILE_BUFSIZE)
+            {
+              ret = syslog_dev_drain();
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          ncopy = CONFIG_SYSLOG_FILE_BUFSIZE - g_syslog_dev.sl_nbuf;
+          if (ncopy > buflen - nwritten)
+            {
+              ncopy = buflen - nwritten;
+            }
+
+          memcpy(&g_syslog_dev.sl_buffer[g_syslog_dev.sl_nbuf],
+                 &buffer[nwritten], ncopy);
+          g_syslog_dev.sl_nbuf += ncopy;
+        }
+
+#ifdef HAVE_FLUSHWORK
+      /* Make sure that the data does not stay in RAM indefinitely */
+
+      if (g_syslog_dev.sl_nbuf > 0 && work_available(&g_syslog_dev.sl_work))
+        {
+          (void)work_queue(LPWORK, &g_syslog_dev.sl_work,
+                           syslog_dev_flushwork, NULL,
+                           MSEC2TICK(CONFIG_SYSLOG_FILE_FLUSHDELAY));
+        }
+#endif
+
+      return buflen;
+    }
+#endif
+
+  return file_write(&g_syslog_dev.sl_file, buffer, buflen);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -295,6 +535,15 @@ int syslog_dev_initialize(FAR const char *devpath, int oflags, int mode)
       return ret;
     }
 
+#ifdef HAVE_FILEBUFFER
+  /* Use the RAM buffer for a file in a mounted file system, but not for
+   * a character device.
+   */
+
+  g_syslog_dev.sl_buffered = INODE_IS_MOUNTPT(g_syslog_dev.sl_file.f_inode);
+  g_syslog_dev.sl_nbuf     = 0;
+#endif
+
   /* The SYSLOG device is open and ready for writing. */
 
   sem_init(&g_syslog_dev.sl_sem, 0, 1);
@@ -329,6 +578,9 @@ int syslog_dev_uninitialize(void)
   /* Attempt to flush any buffered data */
 
   sched_lock();
+#ifdef HAVE_FLUSHWORK
+  (void)work_cancel(LPWORK, &g_syslog_dev.sl_work);
+#endif
   (void)syslog_dev_flush();
 
   /* Close the detached file instance */
@@ -355,126 +607,35 @@ int syslog_dev_uninitialize(void)
 #endif /* CONFIG_SYSLOG_FILE */
 
 /****************************************************************************
- * Name: syslog_dev_putc
+ * Name: syslog_dev_write
  *
  * Description:
  *   This is the low-level system logging interface provided for the
- *   character driver interface.
+ *   character driver interface.  Carriage returns are dropped and each
+ *   newline is expanded to a CR-LF sequence.
  *
  * Input Parameters:
- *   ch - The character to add to the SYSLOG (must be positive).
+ *   buffer - The data to add to the SYSLOG
+ *   buflen - The number of bytes in buffer
  *
  * Returned Value:
- *   On success, the character is echoed back to the caller.  A negated
- *   errno value is returned on any failure.
+ *   On success, buflen is returned.  A negated errno value is returned on
+ *   any failure.
  *
  ****************************************************************************/
 
-int syslog_dev_putc(int ch)
+ssize_t syslog_dev_write(FAR const char *buffer, size_t buflen)
 {
-  ssize_t nbytes;
-  uint8_t uch;
-  int errcode;
+  FAR const char *endptr;
+  FAR const char *end = buffer + buflen;
+  ssize_t nwritten;
+  bool newline = false;
   int ret;
 
-  /* Ignore any output:
-   *
-   * (1) Before the SYSLOG device has been initialized.  This could happen
-   *     from debug output that occurs early in the boot sequence before
-   *     syslog_dev_initialize() is called (SYSLOG_UNINITIALIZED).
-   * (2) While the device is being initialized.  The case could happen if
-   *     debug output is generated while syslog_dev_initialize() executes
-   *     (SYSLOG_INITIALIZING).
-   * (3) While we are generating SYSLOG output.  The case could happen if
-   *     debug output is generated while syslog_dev_putc() executes
-   *     (This case is actually handled inside of syslog_semtake()).
-   * (4) Any debug output generated from interrupt handlers.  A disadvantage
-   *     of using the generic character device for the SYSLOG is that it
-   *     cannot handle debug output generated from interrupt level handlers.
-   * (5) Any debug output generated from the IDLE loop.  The character
-   *     driver interface is blocking and the IDLE thread is not permitted
-   *     to block.
-   * (6) If an irrecoverable failure occurred during initialization.  In
-   *     this case, we won't ever bother to try again (ever).
-   *
-   * NOTE: That the third case is different.  It applies only to the thread
-   * that currently holds the sl_sem sempaphore.  Other threads should wait.
-   * that is why that case is handled in syslog_semtake().
-   */
-
-  /* Cases (4) and (5) */
-
-  if (up_interrupt_context() || getpid() == 0)
-    {
-      errcode = ENOSYS;
-      goto errout_with_errcode;
-    }
-
-  /* We can save checks in the usual case:  That after the SYSLOG device
-   * has been successfully opened.
-   */
-
-  if (g_syslog_dev.sl_state != SYSLOG_OPENED)
-    {
-      /* Case (1) and (2) */
-
-      if (g_syslog_dev.sl_state == SYSLOG_UNINITIALIZED ||
-          g_syslog_dev.sl_state == SYSLOG_INITIALIZING)
-       {
-         errcode = EAGAIN; /* Can't access the SYSLOG now... maybe next time? */
-         goto errout_with_errcode;
-       }
-
-      /* Case (6) */
-
-      if (g_syslog_dev.sl_state == SYSLOG_FAILURE)
-        {
-          errcode = ENXIO;  /* There is no SYSLOG device */
-          goto errout_with_errcode;
-        }
-
-      /* syslog_dev_initialize() is called as soon as enough of the operating
-       * system is in place to support the open operation... but it is
-       * possible that the SYSLOG device is not yet registered at that time.
-       * In this case, we know that the system is sufficiently initialized
-       * to support an attempt to re-open the SYSLOG device.
-       *
-       * NOTE that the scheduler is locked.  That is because we do not have
-       * fully initialized semaphore capability until the SYSLOG device is
-       * successfully initialized
-       */
-
-      sched_lock();
-      if (g_syslog_dev.sl_state == SYSLOG_REOPEN)
-        {
-          /* Try again to initialize the device.  We may do this repeatedly
-           * because the log device might be something that was not ready
-           * the first time that syslog_dev_initializee() was called (such as a
-           * USB serial device that has not yet been connected or a file in
-           * an NFS mounted file system that has not yet been mounted).
-           */
-
-          DEBUGASSERT(g_syslog_dev.sl_devpath != NULL);
-          ret = syslog_dev_initialize(g_syslog_dev.sl_devpath,
-                                      (int)g_syslog_dev.sl_oflags,
-                                      (int)g_syslog_dev.sl_mode);
-          if (ret < 0)
-            {
-              sched_unlock();
-              errcode = -ret;
-              goto errout_with_errcode;
-            }
-        }
-
-      sched_unlock();
-      DEBUGASSERT(g_syslog_dev.sl_state == SYSLOG_OPENED);
-    }
-
-  /* Ignore carriage returns */
-
-  if (ch == '\r')
+  ret = syslog_dev_outputready();
+  if (ret < 0)
     {
-      return ch;
+      return ret;
     }
 
   /* The syslog device is ready for writing and we have something of
@@ -490,54 +651,103 @@ int syslog_dev_putc(int ch)
        * way, we are outta here.
        */
 
-      errcode = -ret;
-      goto errout_with_errcode;
+      return ret;
     }
 
-  /* Pre-pend a newline with a carriage return. */
-
-  if (ch == '\n')
+  while (buffer < end)
     {
-      /* Write the CR-LF sequence */
+      /* Write the run of characters up to the next carriage return or
+       * newline in one operation.
+       */
 
-      nbytes = file_write(&g_syslog_dev.sl_file, g_syscrlf, 2);
+      for (endptr = buffer;
+           endptr < end && *endptr != '\r' && *endptr != '\n';
+           endptr++);
 
-      /* Synchronize the file when each CR-LF is encountered (i.e.,
-       * implements line buffering always).
-       */
+      if (endptr > buffer)
+        {
+          nwritten = syslog_dev_output(buffer, endptr - buffer);
+          if (nwritten < 0)
+            {
+              ret = (int)nwritten;
+              break;
+            }
+        }
 
-#ifndef CONFIG_DISABLE_MOUNTPOINT
-      if (nbytes > 0)
+      if (endptr < end)
         {
-          (void)syslog_dev_flush();
+          /* Ignore carriage returns and write each newline as CR-LF */
+
+          if (*endptr == '\n')
+            {
+              nwritten = syslog_dev_output((FAR const char *)g_syscrlf, 2);
+              if (nwritten < 0)
+                {
+                  ret = (int)nwritten;
+                  break;
+                }
+
+              newline = true;
+            }
+
+          endptr++;
         }
-#endif
-    }
-  else
-    {
-      /* Write the non-newline character (and don't flush) */
 
-      uch = (uint8_t)ch;
-      nbytes = file_write(&g_syslog_dev.sl_file, &uch, 1);
+      buffer = endptr;
     }
 
   syslog_dev_givesem();
 
-  /* Check if the write was successful.  If not, nbytes will be
-   * a negated errno value.
+  /* Synchronize the file when each CR-LF is encountered (i.e., implements
+   * line buffering always) unless the output is collected in the RAM
+   * buffer.
    */
 
-  if (nbytes < 0)
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (newline && ret >= 0
+#ifdef HAVE_FILEBUFFER
+      && !g_syslog_dev.sl_buffered
+#endif
+     )
     {
-      errcode = -ret;
-      goto errout_with_errcode;
+      (void)syslog_dev_flush();
     }
+#else
+  UNUSED(newline);
+#endif
 
-  return ch;
+  return ret < 0 ? ret : (ssize_t)buflen;
+}
+
+/****************************************************************************
+ * Name: syslog_dev_putc
+ *
+ * Description:
+ *   This is the low-level system logging interface provided for the
+ *   character driver interface.
+ *
+ * Input Parameters:
+ *   ch - The character to add to the SYSLOG (must be positive).
+ *
+ * Returned Value:
+ *   On success, the character is echoed back to the caller.  A negated
+ *   errno value is returned on any failure.
+ *
+ ****************************************************************************/
 
-errout_with_errcode:
-  set_errno(errcode);
-  return EOF;
+int syslog_dev_putc(int ch)
+{
+  char uch = (char)ch;
+  ssize_t ret;
+
+  ret = syslog_dev_write(&uch, 1);
+  if (ret < 0)
+    {
+      set_errno((int)-ret);
+      return EOF;
+    }
+
+  return ch;
 }
 
 /****************************************************************************
@@ -556,6 +766,18 @@ errout_with_errcode:
 
 int syslog_dev_flush(void)
 {
+#ifdef HAVE_FILEBUFFER
+  /* Write the RAM buffer to the file.  This is skipped if the caller
+   * already holds the semaphore.
+   */
+
+  if (g_syslog_dev.sl_buffered && syslog_dev_takesem() == OK)
+    {
+      (void)syslog_dev_drain();
+      syslog_dev_givesem();
+    }
+#endif
+
 #if defined(CONFIG_SYSLOG_FILE) && !defined(CONFIG_DISABLE_MOUNTPOINT)
   /* Ignore return value, always return success.  file_fsync() could fail
    * because the file is not open, the inode is not a mountpoint, or the
@@ -75,6 +75,7 @@ static const struct syslog_channel_s g_syslog_file_channel =
   syslog_dev_putc,
   syslog_file_force,
   syslog_dev_flush,
+  syslog_dev_write
 };
 
 /****************************************************************************
@@ -109,6 +109,19 @@ int syslog_initialize(enum syslog_init_e phase)
 
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  if (phase == SYSLOG_INIT_LATE)
+    {
+      /* Start formatting messages in the deferred logging thread */
+
+      int errcode = syslog_defer_start();
+      if (errcode < 0 && ret == OK)
+        {
+          ret = errcode;
+        }
+    }
+#endif
+
   return ret;
 }
 
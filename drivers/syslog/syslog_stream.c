@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <assert.h>
 #include <errno.h>
@@ -57,6 +58,61 @@
  * Name: syslogstream_putc
  ****************************************************************************/
 
+#ifdef CONFIG_SYSLOG_BUFFER
+static void syslogstream_putc(FAR struct lib_outstream_s *this, int ch)
+{
+  FAR struct lib_syslogstream_s *stream =
+    (FAR struct lib_syslogstream_s *)this;
+
+  /* Add the character to the buffer and pass the buffer to the channel
+   * when it becomes full.
+   */
+
+  stream->buffer[stream->nbuf++] = ch;
+  if (stream->nbuf >= CONFIG_SYSLOG_BUFSIZE)
+    {
+      syslogstream_flush(stream);
+    }
+
+  this->nput++;
+}
+
+/****************************************************************************
+ * Name: syslogstream_puts
+ ****************************************************************************/
+
+static void syslogstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const char *buf, int len)
+{
+  FAR struct lib_syslogstream_s *stream =
+    (FAR struct lib_syslogstream_s *)this;
+  int ncopy;
+
+  /* Copy the run into the buffer, passing the buffer to the channel each
+   * time that it becomes full.
+   */
+
+  this->nput += len;
+  while (len > 0)
+    {
+      ncopy = CONFIG_SYSLOG_BUFSIZE - stream->nbuf;
+      if (ncopy > len)
+        {
+          ncopy = len;
+        }
+
+      memcpy(&stream->buffer[stream->nbuf], buf, ncopy);
+      stream->nbuf += ncopy;
+      buf          += ncopy;
+      len          -= ncopy;
+
+      if (stream->nbuf >= CONFIG_SYSLOG_BUFSIZE)
+        {
+          syslogstream_flush(stream);
+        }
+    }
+}
+#else
 static void syslogstream_putc(FAR struct lib_outstream_s *this, int ch)
 {
   int ret;
@@ -85,6 +141,7 @@ static void syslogstream_putc(FAR struct lib_outstream_s *this, int ch)
     }
   while (errno == -EINTR);
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -106,11 +163,66 @@ static void syslogstream_putc(FAR struct lib_outstream_s *this, int ch)
  *
  ****************************************************************************/
 
-void syslogstream(FAR struct lib_outstream_s *stream)
+void syslogstream(FAR struct lib_syslogstream_s *stream)
 {
-  stream->put   = syslogstream_putc;
+  stream->public.put   = syslogstream_putc;
+#ifdef CONFIG_SYSLOG_BUFFER
+  stream->public.puts  = syslogstream_puts;
+#else
+  stream->public.puts  = NULL;
+#endif
 #ifdef CONFIG_STDIO_LINEBUFFER
-  stream->flush = lib_noflush;
+  stream->public.flush = lib_noflush;
 #endif
-  stream->nput  = 0;
+  stream->public.nput  = 0;
+#ifdef CONFIG_SYSLOG_BUFFER
+  stream->nbuf         = 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: syslogstream_flush
+ *
+ * Description:
+ *   Pass any output buffered in the SYSLOG stream to the SYSLOG channel.
+ *   This must be called when the caller has finished with the stream.
+ *
+ * Input parameters:
+ *   stream - The SYSLOG stream to be flushed
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BUFFER
+void syslogstream_flush(FAR struct lib_syslogstream_s *stream)
+{
+  ssize_t nwritten;
+  int offset;
+
+  /* Try writing until all of the data has been written or until an
+   * irrecoverable error occurs.  -EINTR means that the write was awakened
+   * by a signal.  This is not a real error and must be ignored in this
+   * context.
+   */
+
+  for (offset = 0; offset < stream->nbuf; offset += nwritten)
+    {
+      nwritten = syslog_write(&stream->buffer[offset],
+                              stream->nbuf - offset);
+      if (nwritten < 0)
+        {
+          if (nwritten == -EINTR)
+            {
+              nwritten = 0;
+              continue;
+            }
+
+          break;
+        }
+    }
+
+  stream->nbuf = 0;
 }
+#endif
@@ -0,0 +1,106 @@
+/****************************************************************************
+ * drivers/syslog/syslog_write.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_write
+ *
+ * Description:
+ *   This is the low-level system logging interface for a buffer of data.
+ *   The buffer is passed to the sc_write() method of the SYSLOG channel in
+ *   one call.  Output from interrupt handlers, or to channels that do not
+ *   provide sc_write(), is passed one character at a time to
+ *   syslog_putc().
+ *
+ * Input Parameters:
+ *   buffer - The data to add to the SYSLOG
+ *   buflen - The number of bytes in buffer
+ *
+ * Returned Value:
+ *   On success, the number of bytes written is returned.  A negated errno
+ *   value is returned on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t syslog_write(FAR const char *buffer, size_t buflen)
+{
+  size_t nwritten;
+
+  DEBUGASSERT(g_syslog_channel != NULL);
+
+  if (g_syslog_channel->sc_write != NULL && !up_interrupt_context() &&
+      !sched_idletask())
+    {
+#ifdef CONFIG_SYSLOG_INTBUFFER
+      /* Flush any characters that may have been added to the interrupt
+       * buffer.
+       */
+
+      (void)syslog_flush_intbuffer(g_syslog_channel, false);
+#endif
+
+      return g_syslog_channel->sc_write(buffer, buflen);
+    }
+
+  for (nwritten = 0; nwritten < buflen; nwritten++)
+    {
+      if (syslog_putc(buffer[nwritten]) == EOF)
+        {
+          return nwritten > 0 ? (ssize_t)nwritten : -get_errno();
+        }
+    }
+
+  return nwritten;
+}
@@ -48,6 +48,8 @@
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
+#include "syslog.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -67,7 +69,8 @@
 
 int _vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 {
-  struct lib_outstream_s stream;
+  struct lib_syslogstream_s stream;
+  int ret;
 #ifdef CONFIG_SYSLOG_TIMESTAMP
   struct timespec ts;
 
@@ -85,6 +88,17 @@ int _vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     }
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Let the deferred logging thread format the message, if possible.
+   * Emergency output must not be delayed.
+   */
+
+  if (priority != LOG_EMERG && syslog_defer(priority, fmt, ap))
+    {
+      return 0;
+    }
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.  NOTE that emergency priority output is handled
    * differently.. it will use the SYSLOG emergency stream.
@@ -100,7 +114,7 @@ int _vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     {
       /* Use the normal SYSLOG stream */
 
-      syslogstream((FAR struct lib_outstream_s *)&stream);
+      syslogstream(&stream);
     }
 
 #if defined(CONFIG_SYSLOG_TIMESTAMP)
@@ -110,5 +124,14 @@ int _vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
                     "[%6d.%06d]", ts.tv_sec, ts.tv_nsec/1000);
 #endif
 
-  return lib_vsprintf((FAR struct lib_outstream_s *)&stream, fmt, *ap);
+  ret = lib_vsprintf((FAR struct lib_outstream_s *)&stream, fmt, *ap);
+
+  /* Pass any buffered output to the SYSLOG channel */
+
+  if (priority != LOG_EMERG)
+    {
+      syslogstream_flush(&stream);
+    }
+
+  return ret;
 }
@@ -47,6 +47,7 @@
 #include <unistd.h>
 #include <semaphore.h>
 #include <string.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <queue.h>
 #include <debug.h>
@@ -79,6 +80,9 @@ struct cdcacm_req_s
 {
   FAR struct cdcacm_req_s *flink;      /* Implements a singly linked list */
   FAR struct usbdev_req_s *req;        /* The contained request */
+#ifdef CONFIG_CDCACM_BULKMODE
+  bool held;                           /* Read request owned by the application */
+#endif
 };
 
 /* This structure describes the internal state of the driver */
@@ -105,6 +109,20 @@ struct cdcacm_dev_s
   FAR struct usbdev_req_s *ctrlreq;    /* Allocated control request */
   struct sq_queue_s        reqlist;    /* List of write request containers */
 
+#ifdef CONFIG_CDCACM_BULKMODE
+  /* Bulk mode.  Completed read requests are held in rxlist until the
+   * application takes them with CAIOC_RXPACKET.
+   */
+
+  bool                     bulkmode;   /* true: Bulk mode enabled */
+  uint8_t                  nrxwaiters; /* Number of threads waiting for a read request */
+  uint8_t                  ntxwaiters; /* Number of threads waiting for a write request */
+  uint16_t                 wrreqlen;   /* Size of one write request buffer */
+  sem_t                    rxsem;      /* Wakes threads waiting for a read request */
+  sem_t                    txsem;      /* Wakes threads waiting for a write request */
+  struct sq_queue_s        rxlist;     /* List of completed read request containers */
+#endif
+
   /* Pre-allocated write request containers.  The write requests will
    * be linked in a free list (reqlist), and used to send requests to
    * EPBULKIN; Read requests will be queued in the EBULKOUT.
@@ -147,6 +165,28 @@ static int     cdcacm_sndpacket(FAR struct cdcacm_dev_s *priv);
 static inline int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
                  uint8_t *reqbuf, uint16_t reqlen);
 
+/* Bulk mode ****************************************************************/
+
+#ifdef CONFIG_CDCACM_BULKMODE
+static int     cdcacm_rdsubmit(FAR struct cdcacm_dev_s *priv,
+                 FAR struct usbdev_req_s *req);
+static void    cdcacm_bulkwakeup(FAR struct cdcacm_dev_s *priv);
+static int     cdcacm_bulkwait(FAR struct file *filep,
+                 FAR struct cdcacm_dev_s *priv, FAR struct sq_queue_s *list,
+                 FAR sem_t *sem, FAR uint8_t *nwaiters);
+static int     cdcacm_bulkmode(FAR struct cdcacm_dev_s *priv, bool enable);
+static int     cdcacm_rxpacket(FAR struct file *filep,
+                 FAR struct cdcacm_dev_s *priv,
+                 FAR struct cdcacm_packet_s *pkt);
+static int     cdcacm_rxrelease(FAR struct cdcacm_dev_s *priv,
+                 FAR struct cdcacm_packet_s *pkt);
+static int     cdcacm_txpacket(FAR struct file *filep,
+                 FAR struct cdcacm_dev_s *priv,
+                 FAR struct cdcacm_packet_s *pkt);
+static int     cdcacm_txsubmit(FAR struct cdcacm_dev_s *priv,
+                 FAR struct cdcacm_packet_s *pkt);
+#endif
+
 /* Request helpers *********************************************************/
 
 static struct usbdev_req_s *cdcacm_allocreq(FAR struct usbdev_ep_s *ep,
@@ -524,6 +564,321 @@ static inline int cdcacm_recvpacket(FAR struct cdcacm_dev_s *priv,
   return OK;
 }
 
+#ifdef CONFIG_CDCACM_BULKMODE
+/****************************************************************************
+ * Name: cdcacm_rdsubmit
+ *
+ * Description:
+ *   Queue one read request on the bulk OUT endpoint.  In bulk mode, the
+ *   whole request buffer is used so that several packets complete in one
+ *   request; otherwise only one packet is accepted as in serial mode.
+ *
+ ****************************************************************************/
+
+static int cdcacm_rdsubmit(FAR struct cdcacm_dev_s *priv,
+                           FAR struct usbdev_req_s *req)
+{
+  req->len = priv->bulkmode ? CONFIG_CDCACM_BULKOUT_REQLEN :
+                              priv->epbulkout->maxpacket;
+  return EP_SUBMIT(priv->epbulkout, req);
+}
+
+/****************************************************************************
+ * Name: cdcacm_bulkwakeup
+ *
+ * Description:
+ *   Wake up all threads waiting for bulk mode requests so that they can
+ *   see that the device is no longer configured.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void cdcacm_bulkwakeup(FAR struct cdcacm_dev_s *priv)
+{
+  int i;
+
+  for (i = 0; i < priv->nrxwaiters; i++)
+    {
+      sem_post(&priv->rxsem);
+    }
+
+  for (i = 0; i < priv->ntxwaiters; i++)
+    {
+      sem_post(&priv->txsem);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcacm_bulkwait
+ *
+ * Description:
+ *   Wait until a request container is available in the list.
+ *
+ * Returned Value:
+ *   Zero (OK) if the list is not empty; -ENOTCONN if the device is not
+ *   configured; -EAGAIN in non-blocking mode; or -EINTR.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static int cdcacm_bulkwait(FAR struct file *filep,
+                           FAR struct cdcacm_dev_s *priv,
+                           FAR struct sq_queue_s *list, FAR sem_t *sem,
+                           FAR uint8_t *nwaiters)
+{
+  int ret;
+
+  while (sq_empty(list))
+    {
+      if (priv->config == CDCACM_CONFIGIDNONE)
+        {
+          return -ENOTCONN;
+        }
+
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          return -EAGAIN;
+        }
+
+      (*nwaiters)++;
+      ret = sem_wait(sem);
+      (*nwaiters)--;
+
+      if (ret < 0)
+        {
+          return -get_errno();
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cdcacm_bulkmode
+ *
+ * Description:
+ *   Enable or disable bulk mode.  When bulk mode is disabled, read requests
+ *   that were received but not yet taken by the application are returned
+ *   to the bulk OUT endpoint and their data is discarded.
+ *
+ ****************************************************************************/
+
+static int cdcacm_bulkmode(FAR struct cdcacm_dev_s *priv, bool enable)
+{
+  FAR struct cdcacm_req_s *reqcontainer;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  priv->bulkmode = enable;
+
+  if (!enable)
+    {
+      while (!sq_empty(&priv->rxlist))
+        {
+          reqcontainer = (FAR struct cdcacm_req_s *)sq_remfirst(&priv->rxlist);
+          if (priv->config != CDCACM_CONFIGIDNONE)
+            {
+              ret = cdcacm_rdsubmit(priv, reqcontainer->req);
+              if (ret != OK)
+                {
+                  usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDSUBMIT),
+                           (uint16_t)-ret);
+                  break;
+                }
+
+              priv->nrdq++;
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_rxpacket
+ *
+ * Description:
+ *   Hand the oldest completed read request to the application.
+ *
+ ****************************************************************************/
+
+static int cdcacm_rxpacket(FAR struct file *filep,
+                           FAR struct cdcacm_dev_s *priv,
+                           FAR struct cdcacm_packet_s *pkt)
+{
+  FAR struct cdcacm_req_s *reqcontainer;
+  irqstate_t flags;
+  int ret;
+
+  if (!priv->bulkmode)
+    {
+      return -EPERM;
+    }
+
+  flags = enter_critical_section();
+  ret   = cdcacm_bulkwait(filep, priv, &priv->rxlist, &priv->rxsem,
+                          &priv->nrxwaiters);
+  if (ret == OK)
+    {
+      reqcontainer       = (FAR struct cdcacm_req_s *)sq_remfirst(&priv->rxlist);
+      reqcontainer->held = true;
+
+      pkt->buf    = reqcontainer->req->buf;
+      pkt->len    = reqcontainer->req->xfrd;
+      pkt->handle = reqcontainer;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_rxrelease
+ *
+ * Description:
+ *   Return a read request obtained by cdcacm_rxpacket() to the bulk OUT
+ *   endpoint.
+ *
+ ****************************************************************************/
+
+static int cdcacm_rxrelease(FAR struct cdcacm_dev_s *priv,
+                            FAR struct cdcacm_packet_s *pkt)
+{
+  FAR struct cdcacm_req_s *reqcontainer;
+  irqstate_t flags;
+  int ret = OK;
+
+  reqcontainer = (FAR struct cdcacm_req_s *)pkt->handle;
+  if (reqcontainer < &priv->rdreqs[0] ||
+      reqcontainer >= &priv->rdreqs[CONFIG_CDCACM_NRDREQS] ||
+      !reqcontainer->held)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  reqcontainer->held = false;
+
+  /* If the device is not configured, the request will be queued when the
+   * device is next configured.
+   */
+
+  if (priv->config != CDCACM_CONFIGIDNONE)
+    {
+      ret = cdcacm_rdsubmit(priv, reqcontainer->req);
+      if (ret == OK)
+        {
+          priv->nrdq++;
+        }
+      else
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDSUBMIT),
+                   (uint16_t)-ret);
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_txpacket
+ *
+ * Description:
+ *   Hand a free write request to the application.
+ *
+ ****************************************************************************/
+
+static int cdcacm_txpacket(FAR struct file *filep,
+                           FAR struct cdcacm_dev_s *priv,
+                           FAR struct cdcacm_packet_s *pkt)
+{
+  FAR struct cdcacm_req_s *reqcontainer;
+  irqstate_t flags;
+  int ret;
+
+  if (!priv->bulkmode)
+    {
+      return -EPERM;
+    }
+
+  flags = enter_critical_section();
+  ret   = cdcacm_bulkwait(filep, priv, &priv->reqlist, &priv->txsem,
+                          &priv->ntxwaiters);
+  if (ret == OK)
+    {
+      reqcontainer = (FAR struct cdcacm_req_s *)sq_remfirst(&priv->reqlist);
+      priv->nwrq--;
+
+      pkt->buf    = reqcontainer->req->buf;
+      pkt->len    = priv->wrreqlen;
+      pkt->handle = reqcontainer;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_txsubmit
+ *
+ * Description:
+ *   Send a write request obtained by cdcacm_txpacket().  The request is
+ *   returned to the free list by cdcacm_wrcomplete().
+ *
+ ****************************************************************************/
+
+static int cdcacm_txsubmit(FAR struct cdcacm_dev_s *priv,
+                           FAR struct cdcacm_packet_s *pkt)
+{
+  FAR struct cdcacm_req_s *reqcontainer;
+  FAR struct usbdev_req_s *req;
+  irqstate_t flags;
+  int ret = -ENOTCONN;
+
+  reqcontainer = (FAR struct cdcacm_req_s *)pkt->handle;
+  if (reqcontainer < &priv->wrreqs[0] ||
+      reqcontainer >= &priv->wrreqs[CONFIG_CDCACM_NWRREQS] ||
+      pkt->len > priv->wrreqlen)
+    {
+      return -EINVAL;
+    }
+
+  req   = reqcontainer->req;
+  flags = enter_critical_section();
+
+  if (priv->config != CDCACM_CONFIGIDNONE)
+    {
+      req->len   = pkt->len;
+      req->priv  = reqcontainer;
+      req->flags = USBDEV_REQFLAGS_NULLPKT;
+      ret        = EP_SUBMIT(priv->epbulkin, req);
+      if (ret != OK)
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_SUBMITFAIL),
+                   (uint16_t)-ret);
+        }
+    }
+
+  /* Return the request to the free list if it could not be sent */
+
+  if (ret != OK)
+    {
+      sq_addlast((FAR sq_entry_t *)reqcontainer, &priv->reqlist);
+      priv->nwrq++;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_CDCACM_BULKMODE */
+
 /****************************************************************************
  * Name: cdcacm_allocreq
  *
@@ -606,6 +961,12 @@ static void cdcacm_resetconfig(FAR struct cdcacm_dev_s *priv)
       EP_DISABLE(priv->epintin);
       EP_DISABLE(priv->epbulkin);
       EP_DISABLE(priv->epbulkout);
+
+#ifdef CONFIG_CDCACM_BULKMODE
+      /* Wake up bulk mode waiters so that they report the lost connection */
+
+      cdcacm_bulkwakeup(priv);
+#endif
     }
 }
 
@@ -751,11 +1112,30 @@ static int cdcacm_setconfig(FAR struct cdcacm_dev_s *priv, uint8_t config)
   /* Queue read requests in the bulk OUT endpoint */
 
   DEBUGASSERT(priv->nrdq == 0);
+
+#ifdef CONFIG_CDCACM_BULKMODE
+  /* Data received in the previous configuration and not yet taken by the
+   * application is discarded.  Requests still held by the application are
+   * queued when they are released.
+   */
+
+  sq_init(&priv->rxlist);
+#endif
+
   for (i = 0; i < CONFIG_CDCACM_NRDREQS; i++)
     {
       req           = priv->rdreqs[i].req;
       req->callback = cdcacm_rdcomplete;
+#ifdef CONFIG_CDCACM_BULKMODE
+      if (priv->rdreqs[i].held)
+        {
+          continue;
+        }
+
+      ret           = cdcacm_rdsubmit(priv, req);
+#else
       ret           = EP_SUBMIT(priv->epbulkout, req);
+#endif
       if (ret != OK)
         {
           usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDSUBMIT), (uint16_t)-ret);
@@ -836,6 +1216,26 @@ static void cdcacm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
     case 0: /* Normal completion */
       usbtrace(TRACE_CLASSRDCOMPLETE, priv->nrdq);
+#ifdef CONFIG_CDCACM_BULKMODE
+      if (priv->bulkmode)
+        {
+          /* Hold the request for the application instead of copying the
+           * data into the serial RX buffer.
+           */
+
+          sq_addlast((FAR sq_entry_t *)req->priv, &priv->rxlist);
+          priv->nrdq--;
+
+          if (priv->nrxwaiters > 0)
+            {
+              sem_post(&priv->rxsem);
+            }
+
+          leave_critical_section(flags);
+          return;
+        }
+#endif
+
       cdcacm_recvpacket(priv, req->buf, req->xfrd);
       break;
 
@@ -852,8 +1252,12 @@ static void cdcacm_rdcomplete(FAR struct usbdev_ep_s *ep,
 
   /* Requeue the read request */
 
+#ifdef CONFIG_CDCACM_BULKMODE
+  ret      = cdcacm_rdsubmit(priv, req);
+#else
   req->len = ep->maxpacket;
   ret      = EP_SUBMIT(ep, req);
+#endif
   if (ret != OK)
     {
       usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_RDSUBMIT), (uint16_t)-req->result);
@@ -898,6 +1302,14 @@ static void cdcacm_wrcomplete(FAR struct usbdev_ep_s *ep,
   flags = enter_critical_section();
   sq_addlast((FAR sq_entry_t *)reqcontainer, &priv->reqlist);
   priv->nwrq++;
+
+#ifdef CONFIG_CDCACM_BULKMODE
+  if (priv->ntxwaiters > 0)
+    {
+      sem_post(&priv->txsem);
+    }
+#endif
+
   leave_critical_section(flags);
 
   /* Send the next packet unless this was some unusual termination
@@ -1028,6 +1440,15 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver,
   reqlen = CONFIG_CDCACM_EPBULKOUT_FSSIZE;
 #endif
 
+#ifdef CONFIG_CDCACM_BULKMODE
+  /* In bulk mode, read requests may span several packets */
+
+  if (CONFIG_CDCACM_BULKOUT_REQLEN > reqlen)
+    {
+      reqlen = CONFIG_CDCACM_BULKOUT_REQLEN;
+    }
+#endif
+
   for (i = 0; i < CONFIG_CDCACM_NRDREQS; i++)
     {
       reqcontainer      = &priv->rdreqs[i];
@@ -1062,6 +1483,10 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver,
       reqlen = CONFIG_CDCACM_BULKIN_REQLEN;
     }
 
+#ifdef CONFIG_CDCACM_BULKMODE
+  priv->wrreqlen = reqlen;
+#endif
+
   for (i = 0; i < CONFIG_CDCACM_NWRREQS; i++)
     {
       reqcontainer      = &priv->wrreqs[i];
@@ -1944,6 +2369,54 @@ static int cdcuart_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       }
       break;
 
+#ifdef CONFIG_CDCACM_BULKMODE
+    /* CAIOC_BULKMODE
+     *   Enable or disable bulk mode.  Argument: int.
+     */
+
+    case CAIOC_BULKMODE:
+      {
+        ret = cdcacm_bulkmode(priv, arg != 0);
+      }
+      break;
+
+    /* CAIOC_RXPACKET, CAIOC_RXRELEASE, CAIOC_TXPACKET, and CAIOC_TXSUBMIT
+     *   Exchange bulk mode requests with the application.  Argument:
+     *   struct cdcacm_packet_s*.
+     */
+
+    case CAIOC_RXPACKET:
+    case CAIOC_RXRELEASE:
+    case CAIOC_TXPACKET:
+    case CAIOC_TXSUBMIT:
+      {
+        FAR struct cdcacm_packet_s *pkt =
+          (FAR struct cdcacm_packet_s *)((uintptr_t)arg);
+
+        if (pkt == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else if (cmd == CAIOC_RXPACKET)
+          {
+            ret = cdcacm_rxpacket(filep, priv, pkt);
+          }
+        else if (cmd == CAIOC_RXRELEASE)
+          {
+            ret = cdcacm_rxrelease(priv, pkt);
+          }
+        else if (cmd == CAIOC_TXPACKET)
+          {
+            ret = cdcacm_txpacket(filep, priv, pkt);
+          }
+        else
+          {
+            ret = cdcacm_txsubmit(priv, pkt);
+          }
+      }
+      break;
+#endif
+
 #ifdef CONFIG_SERIAL_TERMIOS
     case TCGETS:
       {
@@ -2301,6 +2774,11 @@ int cdcacm_classobject(int minor, FAR struct usbdevclass_driver_s **classdev)
 
   memset(priv, 0, sizeof(struct cdcacm_dev_s));
   sq_init(&priv->reqlist);
+#ifdef CONFIG_CDCACM_BULKMODE
+  sq_init(&priv->rxlist);
+  sem_init(&priv->rxsem, 0, 0);
+  sem_init(&priv->txsem, 0, 0);
+#endif
 
   priv->minor              = minor;
 
@@ -175,6 +175,7 @@ static inline int usbmsc_setupcmd(FAR struct usbmsc_dev_s *priv,
 static int    usbmsc_idlestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv);
+static int    usbmsc_writesectors(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdfinishstate(FAR struct usbmsc_dev_s *priv);
 static int    usbmsc_cmdstatusstate(FAR struct usbmsc_dev_s *priv);
@@ -1806,6 +1807,7 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
   /* No data is buffered */
 
   priv->nsectbytes   = 0;
+  priv->niobytes     = 0;
   priv->nreqbytes    = 0;
 
   /* Get exclusive access to the block driver */
@@ -2085,10 +2087,17 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   niobytes   - holds the number of bytes read into the I/O buffer
+ *   nsectbytes - holds the number of those bytes not yet copied into a
+ *                request
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
+ *   Up to CONFIG_USBMSC_IOSECTORS sectors are read from the block driver at
+ *   a time.  Because the data is copied into the write requests, the next
+ *   sectors are read while the previous requests are still being sent to
+ *   the host.
+ *
  ****************************************************************************/
 
 static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
@@ -2098,6 +2107,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbdev_req_s *req;
   irqstate_t flags;
   ssize_t nread;
+  uint32_t nsectors;
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
@@ -2116,10 +2126,12 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. read as many of the next sectors as will fit */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
-          if (nread < 0)
+          nsectors = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize);
+          nread    = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                      nsectors);
+          if (nread <= 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL), -nread);
               lun->sd     = SCSI_KCQME_UNRRE1;
@@ -2127,9 +2139,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->niobytes   = nread * lun->sectorsize;
+          priv->nsectbytes = priv->niobytes;
+          priv->u.xfrlen  -= nread;
+          priv->sector    += nread;
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2157,7 +2170,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->niobytes - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
       nbytes = MIN(CONFIG_USBMSC_BULKINREQLEN - priv->nreqbytes, priv->nsectbytes);
@@ -2213,6 +2226,42 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   return OK;
 }
 
+/****************************************************************************
+ * Name: usbmsc_writesectors
+ *
+ * Description:
+ *   Write the complete sectors collected in the I/O buffer to the block
+ *   driver.  Any partial sector is discarded.
+ *
+ ****************************************************************************/
+
+static int usbmsc_writesectors(FAR struct usbmsc_dev_s *priv)
+{
+  FAR struct usbmsc_lun_s *lun = priv->lun;
+  uint32_t nsectors = priv->nsectbytes / lun->sectorsize;
+  ssize_t nwritten;
+
+  priv->nsectbytes = 0;
+  if (nsectors == 0)
+    {
+      return OK;
+    }
+
+  nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, nsectors);
+  if (nwritten < (ssize_t)nsectors)
+    {
+      usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
+      lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
+      lun->sdinfo = priv->sector + (nwritten > 0 ? nwritten : 0);
+      return nwritten < 0 ? (int)nwritten : -EIO;
+    }
+
+  priv->residue  -= nsectors * lun->sectorsize;
+  priv->u.xfrlen -= nsectors;
+  priv->sector   += nsectors;
+  return OK;
+}
+
 /****************************************************************************
  * Name: usbmsc_cmdwritestate
  *
@@ -2232,10 +2281,15 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be written.
  *   sector     - holds the sector number of the next sector to write
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes buffered in the I/O buffer
  *   nreqbytes  - holds the number of untransferred bytes currently in the
  *                request at the head of the rdreqlist.
  *
+ *   Up to CONFIG_USBMSC_IOSECTORS sectors are collected in the I/O buffer
+ *   and written to the block driver at a time.  The read requests are
+ *   returned to the endpoint as soon as their data has been copied so that
+ *   the host can send more data while the sectors are being written.
+ *
  ****************************************************************************/
 
 static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
@@ -2243,7 +2297,7 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbmsc_lun_s *lun = priv->lun;
   FAR struct usbmsc_req_s *privreq;
   FAR struct usbdev_req_s *req;
-  ssize_t nwritten;
+  uint32_t nsectors;
   uint16_t xfrd;
   uint8_t *src;
   uint8_t *dest;
@@ -2293,7 +2347,11 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
           src  = &req->buf[xfrd - priv->nreqbytes];
           dest = &priv->iobuffer[priv->nsectbytes];
 
-          nbytes = MIN(lun->sectorsize - priv->nsectbytes, priv->nreqbytes);
+          /* Collect as many of the remaining sectors as will fit */
+
+          nsectors = MIN(priv->u.xfrlen, priv->iosize / lun->sectorsize);
+          nbytes   = MIN(nsectors * lun->sectorsize - priv->nsectbytes,
+                         priv->nreqbytes);
 
           /* Copy the data from the sector buffer to the USB request and update counts */
 
@@ -2303,23 +2361,15 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
           /* Is the I/O buffer full? */
 
-          if (priv->nsectbytes >= lun->sectorsize)
+          if (priv->nsectbytes >= nsectors * lun->sectorsize)
             {
-              /* Yes.. Write the next sector */
+              /* Yes.. Write the buffered sectors */
 
-              nwritten = USBMSC_DRVR_WRITE(lun, priv->iobuffer, priv->sector, 1);
-              if (nwritten < 0)
+              ret = usbmsc_writesectors(priv);
+              if (ret < 0)
                 {
-                  usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDWRITEWRITEFAIL), -nwritten);
-                  lun->sd     = SCSI_KCQME_WRITEFAULTAUTOREALLOCFAILED;
-                  lun->sdinfo = priv->sector;
                   goto errout;
                 }
-
-              priv->nsectbytes = 0;
-              priv->residue   -= lun->sectorsize;
-              priv->u.xfrlen--;
-              priv->sector++;
             }
         }
 
@@ -2342,6 +2392,9 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
 
       if (xfrd != CONFIG_USBMSC_BULKOUTREQLEN)
         {
+          /* Write any complete sectors that are still buffered */
+
+          (void)usbmsc_writesectors(priv);
           priv->shortpacket = 1;
           goto errout;
         }
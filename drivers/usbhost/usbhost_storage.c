@@ -108,6 +108,18 @@
 #define USBHOST_MAX_RETRIES 100        /* Give up after 5 seconds */
 #define USBHOST_MAX_CREFS   INT16_MAX  /* Max cref count before signed overflow */
 
+/* The READ10/WRITE10 transfer length is 16 bits */
+
+#define USBHOST_MAX_SECTORS 0xffff
+
+#ifndef CONFIG_USBHOST_MSC_READAHEAD
+#  define CONFIG_USBHOST_MSC_READAHEAD 0
+#endif
+
+#if defined(CONFIG_USBHOST_MSC_ASYNCH) && !defined(CONFIG_USBHOST_ASYNCH)
+#  undef CONFIG_USBHOST_MSC_ASYNCH
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -136,6 +148,15 @@ struct usbhost_state_s
   size_t                  tbuflen;      /* Size of the allocated transfer buffer */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+  FAR uint8_t            *rabuffer;     /* Read-ahead buffer (may be NULL) */
+  size_t                  rastart;      /* First sector in the read-ahead buffer */
+  uint16_t                ranvalid;     /* Number of valid sectors in rabuffer */
+#endif
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+  sem_t                   asynchsem;    /* Signals completion of an asynchronous transfer */
+  volatile ssize_t        asynchresult; /* The result of the asynchronous transfer */
+#endif
 };
 
 /* This is how struct usbhost_state_s looks to the free list logic */
@@ -223,6 +244,19 @@ static inline int usbhost_talloc(FAR struct usbhost_state_s *priv);
 static inline int usbhost_tfree(FAR struct usbhost_state_s *priv);
 static FAR struct usbmsc_cbw_s *usbhost_cbwalloc(FAR struct usbhost_state_s *priv);
 
+/* Block transfer helpers */
+
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+static void usbhost_asynchcallback(FAR void *arg, ssize_t result);
+static ssize_t usbhost_asynchwait(FAR struct usbhost_state_s *priv);
+#endif
+static ssize_t usbhost_command(FAR struct usbhost_state_s *priv,
+                               FAR struct usbmsc_cbw_s *cbw,
+                               FAR uint8_t *buffer, size_t buflen, bool in);
+static ssize_t usbhost_blkxfer(FAR struct usbhost_state_s *priv,
+                               FAR uint8_t *buffer, size_t startsector,
+                               unsigned int nsectors, bool in);
+
 /* struct usbhost_registry_s methods */
 
 static struct usbhost_class_s *
@@ -947,9 +981,20 @@ static void usbhost_destroy(FAR void *arg)
 
   usbhost_tfree(priv);
 
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+  if (priv->rabuffer)
+    {
+      (void)DRVR_IOFREE(hport->drvr, priv->rabuffer);
+      priv->rabuffer = NULL;
+    }
+#endif
+
   /* Destroy the semaphores */
 
   sem_destroy(&priv->exclsem);
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+  sem_destroy(&priv->asynchsem);
+#endif
 
   /* Disconnect the USB host device */
 
@@ -1334,6 +1379,26 @@ static inline int usbhost_initvolume(FAR struct usbhost_state_s *priv)
         }
     }
 
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+  /* Allocate the read-ahead buffer.  Small reads are then satisfied from
+   * the buffer.  This is not fatal:  Without the buffer, every read goes
+   * to the device.
+   */
+
+  if (ret >= 0)
+    {
+      FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+
+      priv->ranvalid = 0;
+      if (DRVR_IOALLOC(hport->drvr, &priv->rabuffer,
+                       CONFIG_USBHOST_MSC_READAHEAD * priv->blocksize) < 0)
+        {
+          uwarn("WARNING: No read-ahead buffer\n");
+          priv->rabuffer = NULL;
+        }
+    }
+#endif
+
   /* Register the block driver */
 
   if (ret >= 0)
@@ -1643,6 +1708,222 @@ static FAR struct usbmsc_cbw_s *usbhost_cbwalloc(FAR struct usbhost_state_s *pri
   return cbw;
 }
 
+/****************************************************************************
+ * Name: usbhost_asynchcallback and usbhost_asynchwait
+ *
+ * Description:
+ *   Completion of an asynchronous transfer started by usbhost_command().
+ *   The callback runs in the context of the host controller driver and
+ *   simply wakes up the waiting thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+static void usbhost_asynchcallback(FAR void *arg, ssize_t result)
+{
+  FAR struct usbhost_state_s *priv = (FAR struct usbhost_state_s *)arg;
+
+  priv->asynchresult = result;
+  sem_post(&priv->asynchsem);
+}
+
+static ssize_t usbhost_asynchwait(FAR struct usbhost_state_s *priv)
+{
+  usbhost_takesem(&priv->asynchsem);
+  return priv->asynchresult;
+}
+#endif
+
+/****************************************************************************
+ * Name: usbhost_command
+ *
+ * Description:
+ *   Perform the CBW, data, and CSW stages of one bulk-only transport
+ *   command and check the CSW status.
+ *
+ *   With CONFIG_USBHOST_MSC_ASYNCH, the IN transfer that follows the OUT
+ *   transfer is queued asynchronously before the OUT transfer is started:
+ *   The data IN stage before the CBW of a read, and the CSW before the data
+ *   OUT stage of a write.  The device NAKs the IN transfer until it is
+ *   ready, so the host controller moves to the next stage without waiting
+ *   for this thread to run again.
+ *
+ * Input Parameters:
+ *   priv   - A reference to the class instance.
+ *   cbw    - The formatted CBW (in the transfer buffer).
+ *   buffer - The data buffer.
+ *   buflen - The size of the data stage in bytes.
+ *   in     - True: The data stage is IN (device to host).
+ *
+ * Returned Values:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_command(FAR struct usbhost_state_s *priv,
+                               FAR struct usbmsc_cbw_s *cbw,
+                               FAR uint8_t *buffer, size_t buflen, bool in)
+{
+  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
+  FAR struct usbmsc_csw_s *csw;
+  ssize_t nbytes;
+
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+  if (in)
+    {
+      /* Queue the data IN stage, then send the CBW */
+
+      nbytes = DRVR_ASYNCH(hport->drvr, priv->bulkin, buffer, buflen,
+                           usbhost_asynchcallback, priv);
+      if (nbytes < 0)
+        {
+          return nbytes;
+        }
+
+      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                             (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+      if (nbytes < 0)
+        {
+          /* The cancellation completes the data stage with an error */
+
+          (void)DRVR_CANCEL(hport->drvr, priv->bulkin);
+          (void)usbhost_asynchwait(priv);
+          return nbytes;
+        }
+
+      nbytes = usbhost_asynchwait(priv);
+      if (nbytes >= 0)
+        {
+          /* Receive the CSW */
+
+          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                 priv->tbuffer, USBMSC_CSW_SIZEOF);
+        }
+    }
+  else
+    {
+      /* Send the CBW.  Then queue the CSW and send the data OUT stage. */
+
+      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                             (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+      if (nbytes < 0)
+        {
+          return nbytes;
+        }
+
+      nbytes = DRVR_ASYNCH(hport->drvr, priv->bulkin, priv->tbuffer,
+                           USBMSC_CSW_SIZEOF, usbhost_asynchcallback, priv);
+      if (nbytes < 0)
+        {
+          return nbytes;
+        }
+
+      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout, buffer, buflen);
+      if (nbytes < 0)
+        {
+          (void)DRVR_CANCEL(hport->drvr, priv->bulkin);
+          (void)usbhost_asynchwait(priv);
+          return nbytes;
+        }
+
+      nbytes = usbhost_asynchwait(priv);
+    }
+#else
+  /* Send the CBW */
+
+  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
+                         (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+  if (nbytes >= 0)
+    {
+      /* Transfer the user data */
+
+      nbytes = DRVR_TRANSFER(hport->drvr, in ? priv->bulkin : priv->bulkout,
+                             buffer, buflen);
+      if (nbytes >= 0)
+        {
+          /* Receive the CSW */
+
+          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
+                                 priv->tbuffer, USBMSC_CSW_SIZEOF);
+        }
+    }
+#endif
+
+  if (nbytes >= 0)
+    {
+      /* Check the CSW status */
+
+      csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
+      if (csw->status != 0)
+        {
+          uerr("ERROR: CSW status error: %d\n", csw->status);
+          nbytes = -ENODEV;
+        }
+    }
+
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: usbhost_blkxfer
+ *
+ * Description:
+ *   Read or write a range of sectors.  The range is transferred with as
+ *   few READ10/WRITE10 commands as the 16-bit transfer length allows.
+ *
+ * Assumptions:
+ *   The caller holds exclsem.
+ *
+ ****************************************************************************/
+
+static ssize_t usbhost_blkxfer(FAR struct usbhost_state_s *priv,
+                               FAR uint8_t *buffer, size_t startsector,
+                               unsigned int nsectors, bool in)
+{
+  FAR struct usbmsc_cbw_s *cbw;
+  unsigned int nxfr;
+  ssize_t nbytes = OK;
+
+  while (nsectors > 0)
+    {
+      nxfr = nsectors > USBHOST_MAX_SECTORS ? USBHOST_MAX_SECTORS : nsectors;
+
+      /* Loop in the event that EAGAIN is returned (mean that the
+       * transaction was NAKed and we should try again.
+       */
+
+      do
+        {
+          /* Initialize a CBW (re-using the allocated transfer buffer) */
+
+          cbw = usbhost_cbwalloc(priv);
+          if (in)
+            {
+              usbhost_readcbw(startsector, priv->blocksize, nxfr, cbw);
+            }
+          else
+            {
+              usbhost_writecbw(startsector, priv->blocksize, nxfr, cbw);
+            }
+
+          nbytes = usbhost_command(priv, cbw, buffer,
+                                   (size_t)priv->blocksize * nxfr, in);
+        }
+      while (nbytes == -EAGAIN);
+
+      if (nbytes < 0)
+        {
+          return nbytes;
+        }
+
+      buffer      += (size_t)priv->blocksize * nxfr;
+      startsector += nxfr;
+      nsectors    -= nxfr;
+    }
+
+  return nbytes;
+}
+
 /****************************************************************************
  * struct usbhost_registry_s methods
  ****************************************************************************/
@@ -1704,6 +1985,9 @@ usbhost_create(FAR struct usbhost_hubport_s *hport,
           /* Initialize semaphores (this works okay in the interrupt context) */
 
           sem_init(&priv->exclsem, 0, 1);
+#ifdef CONFIG_USBHOST_MSC_ASYNCH
+          sem_init(&priv->asynchsem, 0, 0);
+#endif
 
           /* NOTE: We do not yet know the geometry of the USB mass storage device */
 
@@ -1977,14 +2261,12 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
                             size_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
   ssize_t nbytes = 0;
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct usbhost_state_s *)inode->i_private;
 
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   uinfo("startsector: %d nsectors: %d sectorsize: %d\n",
         startsector, nsectors, priv->blocksize);
@@ -2002,63 +2284,53 @@ static ssize_t usbhost_read(FAR struct inode *inode, unsigned char *buffer,
     }
   else if (nsectors > 0)
     {
-      FAR struct usbmsc_cbw_s *cbw;
-
       usbhost_takesem(&priv->exclsem);
 
-      /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
-
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+      /* Small reads are satisfied from the read-ahead buffer.  On a miss,
+       * the buffer is refilled with the following sectors in one command so
+       * that sequential small reads do not each cost a CBW/data/CSW
+       * sequence.  Large reads go directly to the caller's buffer.
+       */
 
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
+      if (priv->rabuffer != NULL && nsectors < CONFIG_USBHOST_MSC_READAHEAD)
         {
-          /* Loop in the event that EAGAIN is returned (mean that the
-           * transaction was NAKed and we should try again.
-           */
-
-          do
+          if (startsector < priv->rastart ||
+              startsector + nsectors > priv->rastart + priv->ranvalid)
             {
-              /* Assume some device failure */
+              unsigned int nra = CONFIG_USBHOST_MSC_READAHEAD;
 
-              nbytes = -ENODEV;
+              /* Don't read ahead past the end of the media */
 
-              /* Construct and send the CBW */
+              if (startsector + nra > priv->nblocks &&
+                  startsector + nsectors <= priv->nblocks)
+                {
+                  nra = priv->nblocks - startsector;
+                }
 
-              usbhost_readcbw(startsector, priv->blocksize, nsectors, cbw);
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
+              priv->ranvalid = 0;
+              nbytes = usbhost_blkxfer(priv, priv->rabuffer, startsector,
+                                       nra, true);
               if (nbytes >= 0)
                 {
-                  /* Receive the user data */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         buffer, priv->blocksize * nsectors);
-                  if (nbytes >= 0)
-                    {
-                      /* Receive the CSW */
-
-                      nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                             priv->tbuffer, USBMSC_CSW_SIZEOF);
-                      if (nbytes >= 0)
-                        {
-                          FAR struct usbmsc_csw_s *csw;
-
-                          /* Check the CSW status */
-
-                          csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                          if (csw->status != 0)
-                            {
-                              uerr("ERROR: CSW status error: %d\n", csw->status);
-                              nbytes = -ENODEV;
-                            }
-                        }
-                    }
+                  priv->rastart  = startsector;
+                  priv->ranvalid = nra;
                 }
             }
-          while (nbytes == -EAGAIN);
+
+          if (priv->ranvalid > 0)
+            {
+              memcpy(buffer,
+                     &priv->rabuffer[(startsector - priv->rastart) *
+                                     priv->blocksize],
+                     (size_t)nsectors * priv->blocksize);
+            }
+        }
+      else
+#endif
+        {
+          nbytes = usbhost_blkxfer(priv, buffer, startsector, nsectors,
+                                   true);
         }
 
       usbhost_givesem(&priv->exclsem);
@@ -2083,8 +2355,7 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
                            size_t startsector, unsigned int nsectors)
 {
   FAR struct usbhost_state_s *priv;
-  FAR struct usbhost_hubport_s *hport;
-  ssize_t nbytes;
+  ssize_t nbytes = 0;
 
   uinfo("sector: %d nsectors: %d sectorsize: %d\n");
 
@@ -2092,7 +2363,6 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
   priv = (FAR struct usbhost_state_s *)inode->i_private;
 
   DEBUGASSERT(priv->usbclass.hport);
-  hport = priv->usbclass.hport;
 
   /* Check if the mass storage device is still connected */
 
@@ -2105,59 +2375,22 @@ static ssize_t usbhost_write(FAR struct inode *inode, const unsigned char *buffe
 
       nbytes = -ENODEV;
     }
-  else
+  else if (nsectors > 0)
     {
-      FAR struct usbmsc_cbw_s *cbw;
-
       usbhost_takesem(&priv->exclsem);
 
-     /* Assume allocation failure */
-
-      nbytes = -ENOMEM;
+#if CONFIG_USBHOST_MSC_READAHEAD > 0
+      /* Discard the read-ahead data if it overlaps the written sectors */
 
-      /* Initialize a CBW (re-using the allocated transfer buffer) */
-
-      cbw = usbhost_cbwalloc(priv);
-      if (cbw)
+      if (startsector < priv->rastart + priv->ranvalid &&
+          startsector + nsectors > priv->rastart)
         {
-          /* Assume some device failure */
-
-          nbytes = -ENODEV;
-
-          /* Construct and send the CBW */
-
-          usbhost_writecbw(startsector, priv->blocksize, nsectors, cbw);
-          nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                 (FAR uint8_t *)cbw, USBMSC_CBW_SIZEOF);
-          if (nbytes >= 0)
-            {
-              /* Send the user data */
-
-              nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkout,
-                                     (FAR uint8_t *)buffer, priv->blocksize * nsectors);
-              if (nbytes >= 0)
-                {
-                  /* Receive the CSW */
-
-                  nbytes = DRVR_TRANSFER(hport->drvr, priv->bulkin,
-                                         priv->tbuffer, USBMSC_CSW_SIZEOF);
-                  if (nbytes >= 0)
-                    {
-                      FAR struct usbmsc_csw_s *csw;
-
-                      /* Check the CSW status */
-
-                      csw = (FAR struct usbmsc_csw_s *)priv->tbuffer;
-                      if (csw->status != 0)
-                        {
-                          uerr("ERROR: CSW status error: %d\n", csw->status);
-                          nbytes = -ENODEV;
-                        }
-                    }
-                }
-            }
+          priv->ranvalid = 0;
         }
+#endif
 
+      nbytes = usbhost_blkxfer(priv, (FAR uint8_t *)buffer, startsector,
+                               nsectors, false);
       usbhost_givesem(&priv->exclsem);
     }
 
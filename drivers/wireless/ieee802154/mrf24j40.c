@@ -49,6 +49,7 @@
 #include <semaphore.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
@@ -79,6 +80,17 @@
 #  error CONFIG_SPI_EXCHANGE required for this driver
 #endif
 
+#ifndef CONFIG_IEEE802154_MRF24J40_NRXFRAMES
+#  define CONFIG_IEEE802154_MRF24J40_NRXFRAMES 4
+#endif
+
+#define MRF24J40_NRXFRAMES CONFIG_IEEE802154_MRF24J40_NRXFRAMES
+
+/* Long address of the FIFOs */
+
+#define MRF24J40_TXNORM_FIFO    0x80000000
+#define MRF24J40_RXBUF_FIFO     0x80000300
+
 /* Definitions for the device structure */
 
 #define MRF24J40_RXMODE_NORMAL  0
@@ -113,6 +125,15 @@ struct mrf24j40_dev_s
   uint8_t                           rxmode;    /* Reception mode: Main, no CRC, promiscuous */
   int32_t                           txpower;   /* TX power in mBm = dBm/100 */
   struct ieee802154_cca_s           cca;       /* Clear channel assessement method */
+  uint8_t                           txstat;    /* TXSTAT of the last transmission */
+
+  /* Frames received while no receive buffer was provided (a circular
+   * queue).
+   */
+
+  uint8_t                           rxhead;    /* Index of the oldest queued frame */
+  uint8_t                           nrxq;      /* Number of queued frames */
+  struct ieee802154_packet_s        rxq[MRF24J40_NRXFRAMES];
 };
 
 /****************************************************************************
@@ -125,6 +146,11 @@ static void    mrf24j40_lock      (FAR struct spi_dev_s *spi);
 
 static void    mrf24j40_setreg    (FAR struct spi_dev_s *spi, uint32_t addr, uint8_t val);
 static uint8_t mrf24j40_getreg    (FAR struct spi_dev_s *spi, uint32_t addr);
+static void    mrf24j40_setregs   (FAR struct spi_dev_s *spi, uint32_t addr,
+                                   FAR const uint8_t *hdr, int hlen,
+                                   FAR const uint8_t *buf, int len);
+static void    mrf24j40_getregs   (FAR struct spi_dev_s *spi, uint32_t addr,
+                                   FAR uint8_t *buf, int len);
 
 static int     mrf24j40_resetrfsm (FAR struct mrf24j40_dev_s *dev);
 static int     mrf24j40_pacontrol (FAR struct mrf24j40_dev_s *dev, int mode);
@@ -307,6 +333,79 @@ static uint8_t mrf24j40_getreg(FAR struct spi_dev_s *spi, uint32_t addr)
   return rx[len-1];
 }
 
+/****************************************************************************
+ * Name: mrf24j40_setregs
+ *
+ * Description:
+ *   Write consecutive long address registers (i.e., the FIFOs) in a single
+ *   SPI transfer.  The device increments the address after each byte.  The
+ *   data is taken from 'hdr' and then from 'buf' so that a frame and its
+ *   FIFO header can be written without first copying them together.
+ *
+ ****************************************************************************/
+
+static void mrf24j40_setregs(FAR struct spi_dev_s *spi, uint32_t addr,
+                             FAR const uint8_t *hdr, int hlen,
+                             FAR const uint8_t *buf, int len)
+{
+  uint8_t cmd[2];
+
+  DEBUGASSERT((addr & 0x80000000) != 0);
+
+  addr  &= 0x3FF; /* 10-bit address */
+  addr <<= 5;
+  addr  |= 0x8010; /* writing long */
+  cmd[0] = (addr >>   8);
+  cmd[1] = (addr & 0xFF);
+
+  mrf24j40_lock(spi);
+  SPI_SELECT(spi, SPIDEV_IEEE802154, true);
+  SPI_SNDBLOCK(spi, cmd, 2);
+
+  if (hlen > 0)
+    {
+      SPI_SNDBLOCK(spi, hdr, hlen);
+    }
+
+  if (len > 0)
+    {
+      SPI_SNDBLOCK(spi, buf, len);
+    }
+
+  SPI_SELECT(spi, SPIDEV_IEEE802154, false);
+  mrf24j40_unlock(spi);
+}
+
+/****************************************************************************
+ * Name: mrf24j40_getregs
+ *
+ * Description:
+ *   Read consecutive long address registers (i.e., the FIFOs) in a single
+ *   SPI transfer.
+ *
+ ****************************************************************************/
+
+static void mrf24j40_getregs(FAR struct spi_dev_s *spi, uint32_t addr,
+                             FAR uint8_t *buf, int len)
+{
+  uint8_t cmd[2];
+
+  DEBUGASSERT((addr & 0x80000000) != 0);
+
+  addr  &= 0x3FF; /* 10-bit address */
+  addr <<= 5;
+  addr  |= 0x8000; /* reading long */
+  cmd[0] = (addr >>   8);
+  cmd[1] = (addr & 0xFF);
+
+  mrf24j40_lock(spi);
+  SPI_SELECT(spi, SPIDEV_IEEE802154, true);
+  SPI_SNDBLOCK(spi, cmd, 2);
+  SPI_RECVBLOCK(spi, buf, len);
+  SPI_SELECT(spi, SPIDEV_IEEE802154, false);
+  mrf24j40_unlock(spi);
+}
+
 /****************************************************************************
  * Name: mrf24j40_resetrfsm
  *
@@ -1022,15 +1121,17 @@ static int mrf24j40_energydetect(FAR struct ieee802154_dev_s *ieee,
 static int mrf24j40_transmit(FAR struct ieee802154_dev_s *ieee, FAR struct ieee802154_packet_s *packet)
 {
   FAR struct mrf24j40_dev_s *dev = (FAR struct mrf24j40_dev_s *)ieee;
-  uint32_t addr;
+  uint8_t  hdr[2];
   uint8_t  reg;
-  int      ret;
   int      hlen = 3; /* include frame control and seq number */
   uint8_t  fc1, fc2;
 
-  mrf24j40_pacontrol(dev, MRF24J40_PA_AUTO);
+  if (packet->len > sizeof(packet->data))
+    {
+      return -EINVAL;
+    }
 
-  addr = 0x80000000;
+  mrf24j40_pacontrol(dev, MRF24J40_PA_AUTO);
 
   /* Enable tx int */
 
@@ -1075,24 +1176,22 @@ static int mrf24j40_transmit(FAR struct ieee802154_dev_s *ieee, FAR struct ieee8
 
 //  winfo("hlen %d\n",hlen);
 
-  /* Header len, 0, TODO for security modes */
-
-  mrf24j40_setreg(dev->spi, addr++, hlen);
-
-  /* Frame length */
-
-  mrf24j40_setreg(dev->spi, addr++, packet->len);
+  /* Write the header length (TODO for security modes), the frame length
+   * and the frame data to the TX FIFO in one SPI transfer, directly from
+   * the caller's packet.
+   */
 
-  /* Frame data */
-
-  for (ret = 0; ret < packet->len; ret++) /* this sets the correct val for ret */
-    {
-      mrf24j40_setreg(dev->spi, addr++, packet->data[ret]);
-    }
+  hdr[0] = hlen;
+  hdr[1] = packet->len;
+  mrf24j40_setregs(dev->spi, MRF24J40_TXNORM_FIFO, hdr, 2,
+                   packet->data, packet->len);
 
   /* If the frame control field contains
    * an acknowledgment request, set the TXNACKREQ bit.
    * See IEEE 802.15.4/2003 7.2.1.1 page 112 for info.
+   *
+   * The device then waits for the ACK and retransmits by itself (up to
+   * three times), so the frame is only handed over once.
    */
 
   reg = MRF24J40_TXNCON_TXNTRIG;
@@ -1107,7 +1206,23 @@ static int mrf24j40_transmit(FAR struct ieee802154_dev_s *ieee, FAR struct ieee8
 
   /* Suspend calling thread until transmit is complete */
 
-  return sem_wait(&ieee->txsem);
+  while (sem_wait(&ieee->txsem) < 0)
+    {
+      /* EINTR is the only expected error from sem_wait().  The
+       * transmission is in progress and the completion must be consumed.
+       */
+
+      DEBUGASSERT(errno == EINTR);
+    }
+
+  /* Report the outcome of the transmission (including any retries) */
+
+  if ((dev->txstat & MRF24J40_TXSTAT_TXNSTAT) != 0)
+    {
+      return (dev->txstat & MRF24J40_TXSTAT_CCAFAIL) != 0 ? -EBUSY : -ECOMM;
+    }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -1125,15 +1240,14 @@ static void mrf24j40_irqwork_tx(FAR struct mrf24j40_dev_s *dev)
 
   txstat = mrf24j40_getreg(dev->spi, MRF24J40_TXSTAT);
 
-  /* 1 means it failed, we want 1 to mean it worked.
-   * tx_ok = !(tmp & ~(1 << TXNSTAT));
-   * retries = tmp >> 6;
-   * channel_busy = (tmp & (1 << CCAFAIL));
+  /* TXNSTAT set means that the transmission failed, either because the
+   * channel was busy (CCAFAIL) or because no ACK was received after all
+   * retries.  The status is returned to the transmitting thread.
    */
 
-  //winfo("TXSTAT%02X!\n", txstat);
-#warning TODO report errors
-  UNUSED(txstat);
+  winfo("TXSTAT %02X retries %d\n", txstat,
+        (txstat & MRF24J40_TXSTAT_TXNRETRY_MASK) >> MRF24J40_TXSTAT_TXNRETRY_SHIFT);
+  dev->txstat = txstat;
 
   /* Disable tx int */
 
@@ -1158,18 +1272,37 @@ static int mrf24j40_rxenable(FAR struct ieee802154_dev_s *ieee, bool state,
                              FAR struct ieee802154_packet_s *packet)
 {
   FAR struct mrf24j40_dev_s *dev = (FAR struct mrf24j40_dev_s *)ieee;
-  uint8_t reg;
+  irqstate_t flags;
 
   if (state)
     {
       mrf24j40_pacontrol(dev, MRF24J40_PA_AUTO);
-      ieee->rxbuf = packet;
 
-      /* Enable rx int */
+      /* If a frame has already been queued, return it immediately.
+       * Otherwise, the next frame will be read directly into this buffer.
+       */
+
+      flags = enter_critical_section();
+      if (dev->nrxq > 0)
+        {
+          memcpy(packet, &dev->rxq[dev->rxhead],
+                 sizeof(struct ieee802154_packet_s));
+
+          if (++dev->rxhead >= MRF24J40_NRXFRAMES)
+            {
+              dev->rxhead = 0;
+            }
 
-      reg = mrf24j40_getreg(dev->spi, MRF24J40_INTCON);
-      reg &= ~MRF24J40_INTCON_RXIE;
-      mrf24j40_setreg(dev->spi, MRF24J40_INTCON, reg);
+          dev->nrxq--;
+          ieee->rxbuf = NULL;
+          sem_post(&ieee->rxsem);
+        }
+      else
+        {
+          ieee->rxbuf = packet;
+        }
+
+      leave_critical_section(flags);
     }
   else
     {
@@ -1189,40 +1322,83 @@ static int mrf24j40_rxenable(FAR struct ieee802154_dev_s *ieee, bool state,
 
 static void mrf24j40_irqwork_rx(FAR struct mrf24j40_dev_s *dev)
 {
-  uint32_t addr;
-  uint32_t index;
-  uint8_t  reg;
+  FAR struct ieee802154_packet_s *rxbuf;
+  irqstate_t flags;
+  uint8_t  trailer[2];
+  uint8_t  len;
+  int      slot;
 
-  /*winfo("!\n");*/
+  /* Disable packet reception */
 
-  /* Disable rx int */
+  mrf24j40_setreg(dev->spi, MRF24J40_BBREG1, MRF24J40_BBREG1_RXDECINV);
 
-  reg  = mrf24j40_getreg(dev->spi, MRF24J40_INTCON);
-  reg |= MRF24J40_INTCON_RXIE;
-  mrf24j40_setreg(dev->spi, MRF24J40_INTCON, reg);
+  /* Read the frame length (including the 2 byte FCS) */
 
-  /* Disable packet reception */
+  len = mrf24j40_getreg(dev->spi, MRF24J40_RXBUF_FIFO);
 
-  mrf24j40_setreg(dev->spi, MRF24J40_BBREG1, MRF24J40_BBREG1_RXDECINV);
+  /* Pick the destination for the frame:  The buffer provided with
+   * rxenable() if there is one and no earlier frames are queued, otherwise
+   * the next free entry of the receive queue.
+   */
 
-  /* Read packet */
+  flags = enter_critical_section();
+  rxbuf = dev->ieee.rxbuf;
+  slot  = -1;
 
-  addr = 0x80000300;
-  dev->ieee.rxbuf->len = mrf24j40_getreg(dev->spi, addr++);
-  /*winfo("len %3d\n", dev->ieee.rxbuf->len);*/
+  if (rxbuf == NULL || dev->nrxq > 0)
+    {
+      rxbuf = NULL;
+      if (dev->nrxq < MRF24J40_NRXFRAMES)
+        {
+          slot = dev->rxhead + dev->nrxq;
+          if (slot >= MRF24J40_NRXFRAMES)
+            {
+              slot -= MRF24J40_NRXFRAMES;
+            }
 
-  for (index = 0; index < dev->ieee.rxbuf->len; index++)
+          rxbuf = &dev->rxq[slot];
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (rxbuf == NULL || len < 2 || len > sizeof(rxbuf->data))
     {
-      dev->ieee.rxbuf->data[index] = mrf24j40_getreg(dev->spi, addr++);
+      winfo("Frame dropped, len=%d\n", len);
+      goto flush;
     }
 
-  dev->ieee.rxbuf->lqi  = mrf24j40_getreg(dev->spi, addr++);
-  dev->ieee.rxbuf->rssi = mrf24j40_getreg(dev->spi, addr++);
+  /* Read the frame, then the LQI and RSSI, with one SPI transfer each */
+
+  mrf24j40_getregs(dev->spi, MRF24J40_RXBUF_FIFO + 1, rxbuf->data, len);
+  mrf24j40_getregs(dev->spi, MRF24J40_RXBUF_FIFO + 1 + len, trailer, 2);
+
+  /* Reduce len by 2, we only receive frames with correct crc, no check
+   * required.
+   */
+
+  rxbuf->len  = len - 2;
+  rxbuf->lqi  = trailer[0];
+  rxbuf->rssi = trailer[1];
 
-  /* Reduce len by 2, we only receive frames with correct crc, no check required */
+  /* Hand the frame over */
 
-  dev->ieee.rxbuf->len -= 2;
+  flags = enter_critical_section();
+  if (slot < 0)
+    {
+      /* It was read directly into the waiting thread's buffer */
+
+      dev->ieee.rxbuf = NULL;
+      sem_post(&dev->ieee.rxsem);
+    }
+  else
+    {
+      dev->nrxq++;
+    }
+
+  leave_critical_section(flags);
 
+flush:
   /* Enable reception of next packet by flushing the fifo.
    * This is an MRF24J40 errata (no. 1).
    */
@@ -1232,8 +1408,6 @@ static void mrf24j40_irqwork_rx(FAR struct mrf24j40_dev_s *dev)
   /* Enable packet reception */
 
   mrf24j40_setreg(dev->spi, MRF24J40_BBREG1, 0);
-
-  sem_post(&dev->ieee.rxsem);
 }
 
 /****************************************************************************
@@ -1347,6 +1521,7 @@ FAR struct ieee802154_dev_s *mrf24j40_init(FAR struct spi_dev_s *spi,
 {
   FAR struct mrf24j40_dev_s *dev;
   struct ieee802154_cca_s   cca;
+  uint8_t                   reg;
 
 #if 0
   dev = kmm_zalloc(sizeof(struct mrf24j40_dev_s));
@@ -1396,6 +1571,14 @@ FAR struct ieee802154_dev_s *mrf24j40_init(FAR struct spi_dev_s *spi,
 
   mrf24j40_pacontrol(dev, MRF24J40_PA_AUTO);
 
+  /* Reception is interrupt driven and stays enabled; frames that arrive
+   * while no buffer has been provided with rxenable() are queued.
+   */
+
+  reg  = mrf24j40_getreg(dev->spi, MRF24J40_INTCON);
+  reg &= ~MRF24J40_INTCON_RXIE;
+  mrf24j40_setreg(dev->spi, MRF24J40_INTCON, reg);
+
   dev->lower->enable(dev->lower, TRUE);
 
   return &dev->ieee;
@@ -186,6 +186,13 @@
 #define MRF24J40_INTCON_TXG1IE     0x02
 #define MRF24J40_INTCON_TXNIE      0x01
 
+/* TXSTAT bits */
+
+#define MRF24J40_TXSTAT_TXNSTAT    0x01 /* Transmission failed (no ACK after retries) */
+#define MRF24J40_TXSTAT_CCAFAIL    0x20 /* Channel busy (CSMA-CA failed) */
+#define MRF24J40_TXSTAT_TXNRETRY_SHIFT 6 /* Number of retries of the last frame */
+#define MRF24J40_TXSTAT_TXNRETRY_MASK  (3 << MRF24J40_TXSTAT_TXNRETRY_SHIFT)
+
 /* BBREG1 bits */
 
 #define MRF24J40_BBREG1_RXDECINV   0x04 /* Enable/Disable packet reception */
@@ -63,6 +63,31 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+/* Dedicated AIO worker threads (zero to use the low priority work queue) */
+
+#ifndef CONFIG_FS_AIO_NTHREADS
+#  define CONFIG_FS_AIO_NTHREADS 0
+#endif
+
+#if CONFIG_FS_AIO_NTHREADS > 0
+#  ifndef CONFIG_FS_AIO_PRIORITY
+#    define CONFIG_FS_AIO_PRIORITY 100
+#  endif
+#  ifndef CONFIG_FS_AIO_STACKSIZE
+#    define CONFIG_FS_AIO_STACKSIZE 2048
+#  endif
+#endif
+
+/* The dedicated AIO threads run at a fixed priority.  Only the work queue
+ * priority is boosted on behalf of the waiting task.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && CONFIG_FS_AIO_NTHREADS == 0
+#  define aio_restorepriority(p) lpwork_restorepriority(p)
+#else
+#  define aio_restorepriority(p) ((void)(p))
+#endif
+
 #undef AIO_HAVE_FILEP
 #undef AIO_HAVE_PSOCK
 
@@ -101,7 +126,12 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
+#if CONFIG_FS_AIO_NTHREADS > 0
+  dq_entry_t aioc_qlink;           /* Link in the AIO submission queue */
+  worker_t aioc_worker;            /* The I/O to be performed */
+#else
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+#endif
   pid_t aioc_pid;                  /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
@@ -244,7 +274,9 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_NTHREADS > 0, on the AIO submission queue served by the
+ *   dedicated AIO worker threads.
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -258,6 +290,24 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove an asynchronous I/O that has not yet been started from the
+ *   queue.  The caller must hold the AIO lock.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed; -ENOENT if it has already been
+ *   started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -39,26 +39,156 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <sched.h>
+#include <semaphore.h>
+#include <queue.h>
 #include <aio.h>
 #include <errno.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kthread.h>
 #include <nuttx/wqueue.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_NTHREADS > 0
+/* The AIO submission queue.  Protected by the AIO lock. */
+
+static dq_queue_t g_aio_submit;
+
+/* Counts the I/O operations in the submission queue */
+
+static sem_t g_aio_submitsem;
+
+/* True when the AIO worker threads have been started */
+
+static bool g_aio_started;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_thread
+ *
+ * Description:
+ *   One of the dedicated AIO worker threads.  Each thread takes the oldest
+ *   I/O operation from the submission queue and performs it, so up to
+ *   CONFIG_FS_AIO_NTHREADS operations are in progress at any time
+ *   regardless of the number of work queue threads.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_NTHREADS > 0
+static int aio_thread(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *aioc;
+  FAR dq_entry_t *entry;
+
+  for (; ; )
+    {
+      /* Wait for an I/O operation to be submitted */
+
+      while (sem_wait(&g_aio_submitsem) < 0)
+        {
+          DEBUGASSERT(get_errno() == EINTR);
+        }
+
+      /* Take the oldest I/O from the queue.  It may have been cancelled
+       * already.
+       */
+
+      aio_lock();
+      entry = dq_remfirst(&g_aio_submit);
+      aio_unlock();
+
+      if (entry != NULL)
+        {
+          aioc = (FAR struct aio_container_s *)
+            ((uintptr_t)entry - offsetof(struct aio_container_s, aioc_qlink));
+
+          /* Perform the I/O.  The worker frees the container. */
+
+          aioc->aioc_worker(aioc);
+        }
+    }
+
+  return OK; /* Not reachable */
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Start the dedicated AIO worker threads when the first I/O is queued.
+ *   Called with the AIO lock held.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_NTHREADS > 0
+static int aio_start(void)
+{
+  int ret;
+  int i;
+
+  if (g_aio_started)
+    {
+      return OK;
+    }
+
+  dq_init(&g_aio_submit);
+  (void)sem_init(&g_aio_submitsem, 0, 0);
+
+  for (i = 0; i < CONFIG_FS_AIO_NTHREADS; i++)
+    {
+      ret = kernel_thread("aio", CONFIG_FS_AIO_PRIORITY,
+                          CONFIG_FS_AIO_STACKSIZE, (main_t)aio_thread,
+                          (FAR char * const *)NULL);
+      if (ret < 0)
+        {
+          int errcode = get_errno();
+
+          ferr("ERROR: Failed to start AIO thread: %d\n", errcode);
+
+          /* Fail only if no thread could be started */
+
+          if (i == 0)
+            {
+              sem_destroy(&g_aio_submitsem);
+              return -errcode;
+            }
+
+          break;
+        }
+    }
+
+  g_aio_started = true;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, if
+ *   CONFIG_FS_AIO_NTHREADS > 0, on the AIO submission queue served by the
+ *   dedicated AIO worker threads.
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -74,6 +204,23 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
   int ret;
 
+#if CONFIG_FS_AIO_NTHREADS > 0
+  /* Add the I/O to the end of the submission queue and wake up one of the
+   * AIO worker threads.
+   */
+
+  aio_lock();
+  ret = aio_start();
+  if (ret >= 0)
+    {
+      aioc->aioc_worker = worker;
+      dq_addlast(&aioc->aioc_qlink, &g_aio_submit);
+      sem_post(&g_aio_submitsem);
+    }
+
+  aio_unlock();
+
+#else
 #ifdef CONFIG_PRIORITY_INHERITANCE
   /* Prohibit context switches until we complete the queuing */
 
@@ -89,6 +236,8 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   /* Schedule the work on the low priority worker thread */
 
   ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
+#endif
+
   if (ret < 0)
     {
       FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
@@ -99,7 +248,7 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
       ret = ERROR;
     }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#if defined(CONFIG_PRIORITY_INHERITANCE) && CONFIG_FS_AIO_NTHREADS == 0
   /* Now the low-priority work queue might run at its new priority */
 
   sched_unlock();
@@ -107,4 +256,40 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   return ret;
 }
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove an asynchronous I/O that has not yet been started from the
+ *   queue.  The caller must hold the AIO lock.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed; -ENOENT if it has already been
+ *   started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+#if CONFIG_FS_AIO_NTHREADS > 0
+  FAR dq_entry_t *entry;
+
+  for (entry = dq_peek(&g_aio_submit); entry != NULL; entry = dq_next(entry))
+    {
+      if (entry == &aioc->aioc_qlink)
+        {
+          dq_rem(entry, &g_aio_submit);
+          return OK;
+        }
+    }
+
+  return -ENOENT;
+#else
+  return work_cancel(LPWORK, &aioc->aioc_work);
+#endif
+}
+
 #endif /* CONFIG_FS_AIO */
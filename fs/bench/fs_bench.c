@@ -0,0 +1,709 @@
+/****************************************************************************
+ * fs/bench/fs_bench.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mount.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/bench.h>
+
+#ifdef CONFIG_FS_BENCHMARK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The test file and the name prefix of the create/unlink files */
+
+#define FSBENCH_FILE     "fsbench.dat"
+#define FSBENCH_PREFIX   "fsb"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fsbench_priv_s
+{
+  FAR struct fsbench_s *bench;       /* The run in progress */
+  FAR uint8_t *buffer;               /* I/O buffer of bench->bufsize bytes */
+  uint32_t seed;                     /* Random offset generator */
+  FAR struct inode *inode;           /* The block driver (blockdev only) */
+  size_t nsectors;                   /* Sectors per operation (blockdev) */
+  size_t nblocks;                    /* Operations in the region (blockdev) */
+  char path[CONFIG_PATH_MAX];        /* Path of a test file */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fsbench_start and fsbench_usec
+ *
+ * Description:
+ *   Time one operation:  fsbench_start() returns the start time and
+ *   fsbench_usec() the microseconds since the start time.  The performance
+ *   counter is used if there is one.
+ *
+ ****************************************************************************/
+
+static uint32_t fsbench_start(void)
+{
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  return up_perf_gettime();
+#else
+  return (uint32_t)clock_systimer();
+#endif
+}
+
+static uint32_t fsbench_usec(uint32_t start)
+{
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  return (uint32_t)((uint64_t)(up_perf_gettime() - start) * USEC_PER_SEC /
+                    up_perf_getfreq());
+#else
+  return TICK2USEC((uint32_t)clock_systimer() - start);
+#endif
+}
+
+/****************************************************************************
+ * Name: fsbench_sample
+ *
+ * Description:
+ *   Account one timed operation.
+ *
+ ****************************************************************************/
+
+static void fsbench_sample(FAR struct fsbench_s *bench, uint32_t usec)
+{
+  uint32_t value = usec;
+  int bucket = 0;
+
+  while (value > 0 && bucket < FSBENCH_NBUCKETS - 1)
+    {
+      value >>= 1;
+      bucket++;
+    }
+
+  bench->hist[bucket]++;
+
+  if (bench->nops == 0 || usec < bench->min)
+    {
+      bench->min = usec;
+    }
+
+  if (usec > bench->max)
+    {
+      bench->max = usec;
+    }
+
+  bench->nops++;
+}
+
+/****************************************************************************
+ * Name: fsbench_percentile
+ *
+ * Description:
+ *   Return the upper bound of the histogram bucket that holds the given
+ *   percentile, but not more than the maximum.
+ *
+ ****************************************************************************/
+
+static uint32_t fsbench_percentile(FAR const struct fsbench_s *bench,
+                                   uint32_t percent)
+{
+  uint32_t target = (uint32_t)(((uint64_t)bench->nops * percent + 99) / 100);
+  uint32_t count = 0;
+  uint32_t bound;
+  int bucket;
+
+  for (bucket = 0; bucket < FSBENCH_NBUCKETS - 1; bucket++)
+    {
+      count += bench->hist[bucket];
+      if (count >= target)
+        {
+          break;
+        }
+    }
+
+  bound = bucket > 0 ? ((uint32_t)1 << bucket) - 1 : 0;
+  return bound < bench->max ? bound : bench->max;
+}
+
+/****************************************************************************
+ * Name: fsbench_offset
+ *
+ * Description:
+ *   Return the index of a pseudo-random, bufsize-aligned block (the same
+ *   sequence on every run).
+ *
+ ****************************************************************************/
+
+static uint32_t fsbench_offset(FAR struct fsbench_priv_s *priv,
+                               uint32_t nblocks)
+{
+  priv->seed = priv->seed * 1103515245 + 12345;
+  return (priv->seed >> 8) % nblocks;
+}
+
+/****************************************************************************
+ * Name: fsbench_xfer
+ *
+ * Description:
+ *   Read or write the whole buffer.
+ *
+ ****************************************************************************/
+
+static int fsbench_xfer(FAR struct fsbench_priv_s *priv, int fd, bool wr)
+{
+  size_t len = priv->bench->bufsize;
+  ssize_t nbytes;
+
+  if (wr)
+    {
+      nbytes = write(fd, priv->buffer, len);
+    }
+  else
+    {
+      nbytes = read(fd, priv->buffer, len);
+    }
+
+  if (nbytes < 0)
+    {
+      return -get_errno();
+    }
+
+  return (size_t)nbytes == len ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: fsbench_prepare
+ *
+ * Description:
+ *   Write the test file (untimed) and leave it open as requested.
+ *
+ ****************************************************************************/
+
+static int fsbench_prepare(FAR struct fsbench_priv_s *priv, int oflags)
+{
+  FAR struct fsbench_s *bench = priv->bench;
+  uint32_t nblocks = bench->filesize / bench->bufsize;
+  uint32_t i;
+  int ret;
+  int fd;
+
+  fd = open(priv->path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0)
+    {
+      return -get_errno();
+    }
+
+  for (i = 0; i < nblocks; i++)
+    {
+      ret = fsbench_xfer(priv, fd, true);
+      if (ret < 0)
+        {
+          close(fd);
+          return ret;
+        }
+    }
+
+  close(fd);
+
+  fd = open(priv->path, oflags);
+  return fd < 0 ? -get_errno() : fd;
+}
+
+/****************************************************************************
+ * Name: fsbench_file
+ *
+ * Description:
+ *   The read and write tests on a file.
+ *
+ ****************************************************************************/
+
+static int fsbench_file(FAR struct fsbench_priv_s *priv, bool wr,
+                        bool random)
+{
+  FAR struct fsbench_s *bench = priv->bench;
+  uint32_t nblocks = bench->filesize / bench->bufsize;
+  uint32_t nops = random ? bench->count : nblocks;
+  uint32_t start;
+  uint32_t i;
+  off_t offset;
+  int ret = OK;
+  int fd;
+
+  if (wr && !random)
+    {
+      /* Sequential writes create the file */
+
+      fd = open(priv->path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (fd < 0)
+        {
+          return -get_errno();
+        }
+    }
+  else
+    {
+      fd = fsbench_prepare(priv, wr ? O_WRONLY : O_RDONLY);
+      if (fd < 0)
+        {
+          return fd;
+        }
+    }
+
+  for (i = 0; i < nops; i++)
+    {
+      start = fsbench_start();
+
+      if (random)
+        {
+          offset = (off_t)fsbench_offset(priv, nblocks) * bench->bufsize;
+          if (lseek(fd, offset, SEEK_SET) < 0)
+            {
+              ret = -get_errno();
+              break;
+            }
+        }
+
+      ret = fsbench_xfer(priv, fd, wr);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      fsbench_sample(bench, fsbench_usec(start));
+      bench->bytes += bench->bufsize;
+    }
+
+  close(fd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_fsync
+ *
+ * Description:
+ *   Time fsync() after each sequential write.  The file wraps around at
+ *   filesize.
+ *
+ ****************************************************************************/
+
+static int fsbench_fsync(FAR struct fsbench_priv_s *priv)
+{
+  FAR struct fsbench_s *bench = priv->bench;
+  uint32_t nblocks = bench->filesize / bench->bufsize;
+  uint32_t start;
+  uint32_t i;
+  int ret = OK;
+  int fd;
+
+  fd = open(priv->path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0)
+    {
+      return -get_errno();
+    }
+
+  for (i = 0; i < bench->count; i++)
+    {
+      if (i % nblocks == 0 && lseek(fd, 0, SEEK_SET) < 0)
+        {
+          ret = -get_errno();
+          break;
+        }
+
+      ret = fsbench_xfer(priv, fd, true);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      start = fsbench_start();
+      if (fsync(fd) < 0)
+        {
+          ret = -get_errno();
+          break;
+        }
+
+      fsbench_sample(bench, fsbench_usec(start));
+      bench->bytes += bench->bufsize;
+    }
+
+  close(fd);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_files
+ *
+ * Description:
+ *   Create and then remove count empty files.  Either the creations or the
+ *   removals are timed.
+ *
+ ****************************************************************************/
+
+static int fsbench_files(FAR struct fsbench_priv_s *priv, bool unlinks)
+{
+  FAR struct fsbench_s *bench = priv->bench;
+  uint32_t ncreated;
+  uint32_t start;
+  uint32_t i;
+  int ret = OK;
+  int fd;
+
+  for (ncreated = 0; ncreated < bench->count; ncreated++)
+    {
+      snprintf(priv->path, CONFIG_PATH_MAX, "%s/" FSBENCH_PREFIX "%05lu",
+               bench->path, (unsigned long)ncreated);
+
+      start = fsbench_start();
+      fd = open(priv->path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (fd < 0)
+        {
+          ret = -get_errno();
+          break;
+        }
+
+      close(fd);
+      if (!unlinks)
+        {
+          fsbench_sample(bench, fsbench_usec(start));
+        }
+    }
+
+  for (i = 0; i < ncreated; i++)
+    {
+      snprintf(priv->path, CONFIG_PATH_MAX, "%s/" FSBENCH_PREFIX "%05lu",
+               bench->path, (unsigned long)i);
+
+      start = fsbench_start();
+      if (unlink(priv->path) < 0)
+        {
+          if (ret == OK)
+            {
+              ret = -get_errno();
+            }
+
+          continue;
+        }
+
+      if (unlinks)
+        {
+          fsbench_sample(bench, fsbench_usec(start));
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fsbench_blockdev
+ *
+ * Description:
+ *   The read and write tests directly on a block device.
+ *
+ ****************************************************************************/
+
+static int fsbench_blockdev(FAR struct fsbench_priv_s *priv, bool wr,
+                            bool random)
+{
+  FAR struct fsbench_s *bench = priv->bench;
+  FAR struct inode *inode = priv->inode;
+  uint32_t nops = random ? bench->count : priv->nblocks;
+  uint32_t start;
+  uint32_t i;
+  size_t sector;
+  ssize_t nxfrd;
+
+  if (wr && inode->u.i_bops->write == NULL)
+    {
+      return -EACCES;
+    }
+
+  for (i = 0; i < nops; i++)
+    {
+      sector = (random ? fsbench_offset(priv, priv->nblocks) : i) *
+               priv->nsectors;
+
+      start = fsbench_start();
+      if (wr)
+        {
+          nxfrd = inode->u.i_bops->write(inode, priv->buffer, sector,
+                                         priv->nsectors);
+        }
+      else
+        {
+          nxfrd = inode->u.i_bops->read(inode, priv->buffer, sector,
+                                        priv->nsectors);
+        }
+
+      if (nxfrd < 0)
+        {
+          return (int)nxfrd;
+        }
+
+      fsbench_sample(bench, fsbench_usec(start));
+      bench->bytes += bench->bufsize;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fsbench_openblock
+ *
+ * Description:
+ *   Open the block device and size the transfers in whole sectors.
+ *
+ ****************************************************************************/
+
+static int fsbench_openblock(FAR struct fsbench_priv_s *priv)
+{
+  FAR struct fsbench_s *bench = priv->bench;
+  struct geometry geo;
+  size_t nsectors;
+  int ret;
+
+  ret = open_blockdriver(bench->path, 0, &priv->inode);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (priv->inode->u.i_bops->geometry == NULL ||
+      priv->inode->u.i_bops->geometry(priv->inode, &geo) < 0 ||
+      !geo.geo_available || geo.geo_sectorsize == 0)
+    {
+      ret = -ENODEV;
+      goto errout_with_inode;
+    }
+
+  priv->nsectors = bench->bufsize / geo.geo_sectorsize;
+  if (priv->nsectors == 0)
+    {
+      priv->nsectors = 1;
+    }
+
+  bench->bufsize = priv->nsectors * geo.geo_sectorsize;
+
+  nsectors = bench->filesize / geo.geo_sectorsize;
+  if (nsectors > geo.geo_nsectors)
+    {
+      nsectors = geo.geo_nsectors;
+    }
+
+  priv->nblocks = nsectors / priv->nsectors;
+  if (priv->nblocks == 0)
+    {
+      ret = -ENOSPC;
+      goto errout_with_inode;
+    }
+
+  return OK;
+
+errout_with_inode:
+  close_blockdriver(priv->inode);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fsbench_run
+ *
+ * Description:
+ *   Run one file system or block device benchmark.  See
+ *   include/nuttx/fs/bench.h.
+ *
+ ****************************************************************************/
+
+int fsbench_run(FAR struct fsbench_s *bench)
+{
+  FAR struct fsbench_priv_s *priv;
+  systime_t start;
+  uint64_t usec;
+  bool wr;
+  bool random;
+  int ret;
+
+  if (bench == NULL || bench->path == NULL || bench->test >= FSBENCH_NTESTS)
+    {
+      return -EINVAL;
+    }
+
+  if (bench->blockdev && bench->test > FSBENCH_RANDREAD)
+    {
+      return -ENOTDIR;
+    }
+
+  /* Apply the defaults */
+
+  if (bench->bufsize == 0)
+    {
+      bench->bufsize = CONFIG_FS_BENCHMARK_BUFSIZE;
+    }
+
+  if (bench->filesize == 0)
+    {
+      bench->filesize = CONFIG_FS_BENCHMARK_FILESIZE;
+    }
+
+  if (bench->count == 0)
+    {
+      bench->count = CONFIG_FS_BENCHMARK_COUNT;
+    }
+
+  if (bench->filesize < bench->bufsize)
+    {
+      return -EINVAL;
+    }
+
+  bench->nops    = 0;
+  bench->bytes   = 0;
+  bench->elapsed = 0;
+  bench->bps     = 0;
+  bench->min     = 0;
+  bench->p50     = 0;
+  bench->p99     = 0;
+  bench->max     = 0;
+  memset(bench->hist, 0, sizeof(bench->hist));
+
+  priv = (FAR struct fsbench_priv_s *)
+    kmm_zalloc(sizeof(struct fsbench_priv_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->bench = bench;
+  priv->seed  = 1;
+
+  if (bench->blockdev)
+    {
+      ret = fsbench_openblock(priv);
+      if (ret < 0)
+        {
+          goto errout_with_priv;
+        }
+    }
+
+  priv->buffer = (FAR uint8_t *)kmm_malloc(bench->bufsize);
+  if (priv->buffer == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_inode;
+    }
+
+  memset(priv->buffer, 0xa5, bench->bufsize);
+  snprintf(priv->path, CONFIG_PATH_MAX, "%s/" FSBENCH_FILE, bench->path);
+
+  wr     = (bench->test == FSBENCH_SEQWRITE ||
+            bench->test == FSBENCH_RANDWRITE);
+  random = (bench->test == FSBENCH_RANDWRITE ||
+            bench->test == FSBENCH_RANDREAD);
+
+  start = clock_systimer();
+  switch (bench->test)
+    {
+      case FSBENCH_CREATE:
+      case FSBENCH_UNLINK:
+        ret = fsbench_files(priv, bench->test == FSBENCH_UNLINK);
+        break;
+
+      case FSBENCH_FSYNC:
+        ret = fsbench_fsync(priv);
+        break;
+
+      default:
+        if (bench->blockdev)
+          {
+            ret = fsbench_blockdev(priv, wr, random);
+          }
+        else
+          {
+            ret = fsbench_file(priv, wr, random);
+          }
+        break;
+    }
+
+  usec = TICK2USEC((uint64_t)(clock_systimer() - start));
+  bench->elapsed = (uint32_t)usec;
+  bench->bps     = usec > 0 ?
+                   (uint32_t)(bench->bytes * USEC_PER_SEC / usec) : 0;
+  bench->p50     = fsbench_percentile(bench, 50);
+  bench->p99     = fsbench_percentile(bench, 99);
+
+  /* Leave nothing behind on the file system */
+
+  if (!bench->blockdev && bench->test != FSBENCH_CREATE &&
+      bench->test != FSBENCH_UNLINK)
+    {
+      (void)unlink(priv->path);
+    }
+
+  kmm_free(priv->buffer);
+
+errout_with_inode:
+  if (priv->inode != NULL)
+    {
+      close_blockdriver(priv->inode);
+    }
+
+errout_with_priv:
+  kmm_free(priv);
+  return ret;
+}
+
+#endif /* CONFIG_FS_BENCHMARK */
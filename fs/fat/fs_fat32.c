@@ -60,6 +60,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 #include <nuttx/fs/dirent.h>
@@ -109,6 +110,13 @@ static int     fat_rename(FAR struct inode *mountpt,
 static int     fat_stat(struct inode *mountpt, const char *relpath,
                  FAR struct stat *buf);
 
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static int     fat_contiguous(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff, off_t position,
+                 unsigned int nsectors, bool extend,
+                 FAR uint32_t *lastcluster);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -150,6 +158,61 @@ const struct mountpt_operations fat_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_contiguous
+ *
+ * Description:
+ *   Determine how many of the next 'nsectors' sectors of the file, starting
+ *   at the current sector (at file offset 'position'), lie in physically
+ *   contiguous clusters so that they can be transferred with a single
+ *   multi-sector request.  If 'extend' is true, the cluster chain is
+ *   extended as necessary (for writes).  The file structure is not
+ *   modified; the last cluster of the run is returned in 'lastcluster'.
+ *
+ * Returned Value:
+ *   The number of contiguous sectors (at least the sectors remaining in
+ *   the current cluster), or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static int fat_contiguous(FAR struct fat_mountpt_s *fs,
+                          FAR struct fat_file_s *ff, off_t position,
+                          unsigned int nsectors, bool extend,
+                          FAR uint32_t *lastcluster)
+{
+  unsigned int nrun = ff->ff_sectorsincluster;
+  uint32_t last = ff->ff_currentcluster;
+  int32_t next;
+
+  while (nrun < nsectors)
+    {
+      next = extend ? fat_extendchain(fs, last) : fat_getcluster(fs, last);
+      if (next < 0)
+        {
+          return next;
+        }
+
+      /* Stop at the end of the chain or at the first discontinuity */
+
+      if ((uint32_t)next != last + 1 || (uint32_t)next >= fs->fs_nclusters)
+        {
+          break;
+        }
+
+#if CONFIG_FAT_NEXTENTS > 0
+      fat_extentadd(fs, ff, position + nrun * fs->fs_hwsectorsize, next);
+#endif
+
+      last  = next;
+      nrun += fs->fs_fatsecperclus;
+    }
+
+  *lastcluster = last;
+  return nrun;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_open
  ****************************************************************************/
@@ -447,6 +510,14 @@ static int fat_close(FAR struct file *filep)
       fat_io_free(ff->ff_buffer, fs->fs_hwsectorsize);
     }
 
+#if CONFIG_FAT_READAHEAD > 0
+  if (ff->ff_rabuffer)
+    {
+      fat_io_free(ff->ff_rabuffer,
+                  CONFIG_FAT_READAHEAD * fs->fs_hwsectorsize);
+    }
+#endif
+
   /* Then free the file structure itself. */
 
   kmm_free(ff);
@@ -473,7 +544,9 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
   int ret;
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
+  uint32_t lastcluster;
   unsigned int nsectors;
+  int nrun;
   bool force_indirect = false;
 #endif
 
@@ -569,6 +642,10 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
               goto errout_with_semaphore;
             }
 
+#if CONFIG_FAT_NEXTENTS > 0
+          fat_extentadd(fs, ff, filep->f_pos, cluster);
+#endif
+
           /* Setup to read the first sector from the new cluster */
 
           ff->ff_currentcluster   = cluster;
@@ -593,13 +670,27 @@ fat_read_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we read on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the contiguous sectors in this and
+           * any physically adjacent following clusters.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          nrun        = ff->ff_sectorsincluster;
+          lastcluster = ff->ff_currentcluster;
+
+          if (nsectors > nrun)
             {
-              nsectors = ff->ff_sectorsincluster;
+              nrun = fat_contiguous(fs, ff, filep->f_pos, nsectors, false,
+                                    &lastcluster);
+              if (nrun < 0)
+                {
+                  ret = nrun;
+                  goto errout_with_semaphore;
+                }
+
+              if (nsectors > (unsigned int)nrun)
+                {
+                  nsectors = nrun;
+                }
             }
 
           /* We are not sure of the state of the file buffer so
@@ -633,7 +724,8 @@ fat_read_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentcluster    = lastcluster;
+          ff->ff_sectorsincluster  = nrun - nsectors;
           ff->ff_currentsector    += nsectors;
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
@@ -646,7 +738,12 @@ fat_read_restart:
            * it is already there then all is well.
            */
 
+#if CONFIG_FAT_READAHEAD > 0
+          ret = fat_ffcachereadahead(fs, ff, ff->ff_currentsector,
+                                     ff->ff_sectorsincluster);
+#else
           ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
+#endif
           if (ret < 0)
             {
               goto errout_with_semaphore;
@@ -707,7 +804,9 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
   int ret;
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
+  uint32_t lastcluster;
   unsigned int nsectors;
+  int nrun;
   bool force_indirect = false;
 #endif
 
@@ -768,6 +867,12 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
       goto errout_with_semaphore;
     }
 
+#if CONFIG_FAT_READAHEAD > 0
+  /* Any data read ahead may be made stale by this write */
+
+  ff->ff_ransectors = 0;
+#endif
+
   /* Get the first sector to write to. */
 
   if (!ff->ff_currentsector)
@@ -829,6 +934,10 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
               goto errout_with_semaphore;
             }
 
+#if CONFIG_FAT_NEXTENTS > 0
+          fat_extentadd(fs, ff, filep->f_pos, cluster);
+#endif
+
           /* Setup to write the first sector from the new cluster */
 
           ff->ff_currentcluster   = cluster;
@@ -852,13 +961,28 @@ fat_write_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we write on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the contiguous sectors in this and
+           * any physically adjacent following clusters (extending the
+           * cluster chain as necessary).
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          nrun        = ff->ff_sectorsincluster;
+          lastcluster = ff->ff_currentcluster;
+
+          if (nsectors > nrun)
             {
-              nsectors = ff->ff_sectorsincluster;
+              nrun = fat_contiguous(fs, ff, filep->f_pos, nsectors, true,
+                                    &lastcluster);
+              if (nrun < 0)
+                {
+                  ret = nrun;
+                  goto errout_with_semaphore;
+                }
+
+              if (nsectors > (unsigned int)nrun)
+                {
+                  nsectors = nrun;
+                }
             }
 
           /* We are not sure of the state of the sector cache so the
@@ -893,7 +1017,8 @@ fat_write_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentcluster    = lastcluster;
+          ff->ff_sectorsincluster  = nrun - nsectors;
           ff->ff_currentsector    += nsectors;
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
@@ -1006,6 +1131,9 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   FAR struct fat_mountpt_s *fs;
   FAR struct fat_file_s *ff;
   int32_t cluster;
+#if CONFIG_FAT_NEXTENTS > 0
+  uint32_t extcluster;
+#endif
   off_t position;
   unsigned int clustersize;
   int ret;
@@ -1118,6 +1246,19 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#if CONFIG_FAT_NEXTENTS > 0
+      /* Skip directly to the nearest known cluster at or before the
+       * requested position rather than following the chain from its
+       * beginning.
+       */
+
+      filep->f_pos = (off_t)fat_extentfind(fs, ff, position, &extcluster) *
+                     clustersize;
+      position    -= filep->f_pos;
+      cluster      = extcluster;
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1188,6 +1329,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
 
           filep->f_pos += clustersize;
           position     -= clustersize;
+
+#if CONFIG_FAT_NEXTENTS > 0
+          fat_extentadd(fs, ff, filep->f_pos, cluster);
+#endif
         }
 
       /* We get here after we have found the sector containing
@@ -1378,6 +1523,13 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+  /* Then make sure that the block driver does not retain the data */
+
+  if (ret == OK)
+    {
+      ret = fat_hwflush(fs);
+    }
+
 errout_with_semaphore:
   fat_semgive(fs);
   return ret;
@@ -1480,6 +1632,14 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#if CONFIG_FAT_NEXTENTS > 0
+  newff->ff_nextextent       = oldff->ff_nextextent;       /* Next extent to replace */
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
+#if CONFIG_FAT_READAHEAD > 0
+  newff->ff_ransectors       = 0;                          /* Read-ahead buffer is empty */
+  newff->ff_rabuffer         = NULL;                       /* Allocated on first use */
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1859,6 +2019,9 @@ static int fat_bind(FAR struct inode *blkdriver, FAR const void *data,
 
   fs->fs_blkdriver = blkdriver;  /* Save the block driver reference */
   sem_init(&fs->fs_sem, 0, 0);   /* Initialize the semaphore that controls access */
+#ifdef CONFIG_SCHED_LOCKSTAT
+  (void)sem_setname(&fs->fs_sem, "fat");
+#endif
 
   /* Then get information about the FAT32 filesystem on the devices managed
    * by this block driver.
@@ -1964,6 +2127,25 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+  if (fs->fs_fatbuffer)
+    {
+      fat_io_free(fs->fs_fatbuffer,
+                  fs->fs_hwsectorsize * CONFIG_FAT_FATCACHE_NSECTORS);
+    }
+#endif
+
+#ifdef CONFIG_FAT_FREEBITMAP
+  if (fs->fs_freemap)
+    {
+      kmm_free(fs->fs_freemap);
+    }
+#endif
+
+#ifdef CONFIG_FAT_DIRCACHE
+  fat_dircache_release(fs);
+#endif
+
   sem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
@@ -2339,6 +2521,9 @@ int fat_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   FAR struct fat_mountpt_s *fs;
   FAR struct fat_dirinfo_s dirinfo;
   FAR struct fat_dirseq_s dirseq;
+#ifdef CONFIG_FAT_DIRCACHE
+  off_t dircluster;
+#endif
   uint8_t *direntry;
   uint8_t dirstate[DIR_SIZE-DIR_ATTRIBUTES];
   int ret;
@@ -2389,6 +2574,9 @@ int fat_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
    */
 
   memcpy(&dirseq, &dirinfo.fd_seq, sizeof(struct fat_dirseq_s));
+#ifdef CONFIG_FAT_DIRCACHE
+  dircluster = dirinfo.dir.fd_startcluster;
+#endif
 
   /* Save the non-name-related portion of the directory entry intact */
 
@@ -2451,6 +2639,10 @@ int fat_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
    */
 
   ret = fat_freedirentry(fs, &dirseq);
+#ifdef CONFIG_FAT_DIRCACHE
+  fat_dircache_freed(fs, dircluster, &dirseq, ret);
+#endif
+
   if (ret < 0)
     {
       goto errout_with_semaphore;
@@ -55,6 +55,47 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+/* Number of FAT table sectors cached per mountpoint (0: FAT sectors share
+ * the single fs_buffer with directory sectors).
+ */
+
+#ifndef CONFIG_FAT_FATCACHE_NSECTORS
+#  define CONFIG_FAT_FATCACHE_NSECTORS 0
+#endif
+
+/* Number of cluster chain extents cached per open file (0: disabled) */
+
+#ifndef CONFIG_FAT_NEXTENTS
+#  define CONFIG_FAT_NEXTENTS 0
+#endif
+
+/* Number of sectors read ahead per open file on sequential reads through
+ * the file buffer (0: disabled).
+ */
+
+#ifndef CONFIG_FAT_READAHEAD
+#  define CONFIG_FAT_READAHEAD 0
+#endif
+
+/* The directory lookup cache records the positions of long file name
+ * sequences and so requires long file name support.
+ */
+
+#ifndef CONFIG_FAT_LFN
+#  undef CONFIG_FAT_DIRCACHE
+#endif
+
+#ifdef CONFIG_FAT_DIRCACHE
+#  ifndef CONFIG_FAT_DIRCACHE_NDIRS
+#    define CONFIG_FAT_DIRCACHE_NDIRS 4
+#  endif
+#  ifndef CONFIG_FAT_DIRCACHE_MAXSLOTS
+#    define CONFIG_FAT_DIRCACHE_MAXSLOTS 4096
+#  endif
+#endif
+
 /****************************************************************************
  * These offsets describes the master boot record.
  *
@@ -713,6 +754,61 @@
  * Public Types
  ****************************************************************************/
 
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+/* This structure describes one sector in the FAT table cache */
+
+struct fat_fatcache_s
+{
+  off_t    fc_sector;              /* The FAT sector in the entry (0: unused) */
+  uint32_t fc_lru;                 /* Time of last use for LRU replacement */
+  bool     fc_dirty;               /* true: The entry must be written back */
+};
+#endif
+
+#if CONFIG_FAT_NEXTENTS > 0
+/* This structure describes a run of physically contiguous clusters in the
+ * cluster chain of an open file.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* Cluster number of the first cluster */
+  uint32_t fe_count;               /* Number of clusters in the run (0: unused) */
+};
+#endif
+
+#ifdef CONFIG_FAT_DIRCACHE
+/* One entry of a directory lookup cache hash table.  It maps the hash of a
+ * name to the position of the first directory entry of that name:  The
+ * "last" long file name entry for a long file name or the short file name
+ * entry itself for a short file name.  An entry with a zero hash is unused;
+ * an entry with a zero sector held a name that has since been removed.
+ */
+
+struct fat_dcentry_s
+{
+  uint32_t de_hash;                /* Hash of the name (0: unused) */
+  uint16_t de_index;               /* Directory index, as in fs_fatdir_s fd_index */
+  off_t    de_sector;              /* Sector of the entry (0: removed) */
+  off_t    de_cluster;             /* Cluster containing de_sector */
+};
+
+/* The lookup cache of one directory, built by scanning the directory the
+ * first time a name is looked up in it.
+ */
+
+struct fat_dircache_s
+{
+  FAR struct fat_dircache_s *dc_flink; /* Next cache in MRU order */
+  off_t    dc_startcluster;        /* First cluster of the directory (0: FAT12/16 root) */
+  uint16_t dc_nslots;              /* Size of dc_table (a power of two) */
+  uint16_t dc_nused;               /* Table entries that are not unused */
+  bool     dc_complete;            /* true: Every name in the directory is cached */
+  FAR struct fat_dcentry_s *dc_table; /* Open addressed hash table */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a fat32 filesystem.
@@ -747,6 +843,19 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+  uint8_t *fs_xipbase;             /* Base address of directly accessible media */
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+  uint32_t fs_fatlru;              /* Counter used to age the FAT cache entries */
+  uint8_t  fs_fatcurrent;          /* FAT cache entry of the last fat_fatcacheread() */
+  uint8_t *fs_fatbuffer;           /* FAT cache memory */
+  struct fat_fatcache_s fs_fatcache[CONFIG_FAT_FATCACHE_NSECTORS];
+#endif
+#ifdef CONFIG_FAT_FREEBITMAP
+  uint8_t *fs_freemap;             /* Free cluster bitmap (1: free), built on first use */
+#endif
+#ifdef CONFIG_FAT_DIRCACHE
+  struct fat_dircache_s *fs_dircache; /* Directory lookup caches, MRU first */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -768,6 +877,15 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_NEXTENTS > 0
+  uint8_t  ff_nextextent;          /* Next extent to be replaced */
+  struct fat_extent_s ff_extents[CONFIG_FAT_NEXTENTS];
+#endif
+#if CONFIG_FAT_READAHEAD > 0
+  uint8_t  ff_ransectors;          /* Number of valid sectors in ff_rabuffer */
+  off_t    ff_rasector;            /* First sector in the read-ahead buffer */
+  uint8_t *ff_rabuffer;            /* Read-ahead buffer (allocated on first use) */
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -890,6 +1008,7 @@ EXTERN int    fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,
                          off_t sector, unsigned int nsectors);
 EXTERN int    fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
+EXTERN int    fat_hwflush(struct fat_mountpt_s *fs);
 
 /* Cluster / cluster chain access helpers */
 
@@ -902,8 +1021,20 @@ EXTERN int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster);
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+/* Cluster chain extent cache (for seeking within large files) */
+
+#if CONFIG_FAT_NEXTENTS > 0
+EXTERN void   fat_extentadd(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                            off_t position, uint32_t cluster);
+EXTERN uint32_t fat_extentfind(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                               off_t position, uint32_t *cluster);
+#endif
+
 /* Help for traversing directory trees and accessing directory entries */
 
+#ifdef CONFIG_FAT_LFN
+EXTERN uint8_t fat_lfnchecksum(const uint8_t *sfname);
+#endif
 EXTERN int    fat_nextdirentry(struct fat_mountpt_s *fs, struct fs_fatdir_s *dir);
 EXTERN int    fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
                                const char *path);
@@ -913,6 +1044,20 @@ EXTERN int    fat_dirwrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirin
 EXTERN int    fat_allocatedirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo);
 EXTERN int    fat_freedirentry(struct fat_mountpt_s *fs, struct fat_dirseq_s *seq);
 EXTERN int    fat_dirname2path(struct fat_mountpt_s *fs, struct fs_dirent_s *dir);
+EXTERN int    fat_findentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
+                            bool probe);
+
+/* Directory lookup cache */
+
+#ifdef CONFIG_FAT_DIRCACHE
+EXTERN int    fat_dircache_find(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo);
+EXTERN void   fat_dircache_written(struct fat_mountpt_s *fs,
+                                   struct fat_dirinfo_s *dirinfo, int result);
+EXTERN void   fat_dircache_freed(struct fat_mountpt_s *fs, off_t startcluster,
+                                 struct fat_dirseq_s *seq, int result);
+EXTERN void   fat_dircache_invalidate(struct fat_mountpt_s *fs, off_t startcluster);
+EXTERN void   fat_dircache_release(struct fat_mountpt_s *fs);
+#endif
 
 /* File creation and removal helpers */
 
@@ -927,6 +1072,17 @@ EXTERN int    fat_fscacheread(struct fat_mountpt_s *fs, off_t sector);
 EXTERN int    fat_ffcacheflush(struct fat_mountpt_s *fs, struct fat_file_s *ff);
 EXTERN int    fat_ffcacheread(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t sector);
 EXTERN int    fat_ffcacheinvalidate(struct fat_mountpt_s *fs, struct fat_file_s *ff);
+#if CONFIG_FAT_READAHEAD > 0
+EXTERN int    fat_ffcachereadahead(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                                   off_t sector, unsigned int nsectors);
+#endif
+
+/* FAT table sector cache */
+
+EXTERN int    fat_fatcacheread(struct fat_mountpt_s *fs, off_t sector,
+                               uint8_t **buffer);
+EXTERN void   fat_fatcachedirty(struct fat_mountpt_s *fs);
+EXTERN int    fat_fatcacheflush(struct fat_mountpt_s *fs);
 
 /* FSINFO sector support */
 
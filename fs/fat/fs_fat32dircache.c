@@ -0,0 +1,827 @@
+/****************************************************************************
+ * fs/fat/fs_fat32dircache.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/fat.h>
+
+#include "inode/inode.h"
+#include "fs_fat32.h"
+
+#ifdef CONFIG_FAT_DIRCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initial number of hash table entries for a directory */
+
+#define DIRCACHE_INITSLOTS  64
+
+/* Multiplier of the polynomial name hash */
+
+#define DIRCACHE_HASHMULT   0x01000193
+
+/* Seed that keeps short names apart from long names with the same bytes */
+
+#define DIRCACHE_SFNSEED    0x5f5f5f5f
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_dircache_power
+ *
+ * Description:
+ *   Return DIRCACHE_HASHMULT raised to the power n.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_dircache_power(unsigned int n)
+{
+  uint32_t base   = DIRCACHE_HASHMULT;
+  uint32_t result = 1;
+
+  while (n > 0)
+    {
+      if ((n & 1) != 0)
+        {
+          result *= base;
+        }
+
+      base *= base;
+      n >>= 1;
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Name: fat_dircache_accumulate
+ *
+ * Description:
+ *   Add the characters at positions 'offset' through 'offset' + nchars - 1
+ *   of a name to its hash.  The hash is the sum of each character times
+ *   DIRCACHE_HASHMULT to the power of its position, so the pieces of a long
+ *   file name can be added in any order.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_dircache_accumulate(uint32_t sum, const uint8_t *chars,
+                                        int nchars, int offset)
+{
+  uint32_t weight = fat_dircache_power(offset);
+  int i;
+
+  for (i = 0; i < nchars; i++)
+    {
+      sum    += chars[i] * weight;
+      weight *= DIRCACHE_HASHMULT;
+    }
+
+  return sum;
+}
+
+/****************************************************************************
+ * Name: fat_dircache_finish
+ *
+ * Description:
+ *   Mix the bits of a hash sum so that the low bits can be used as the
+ *   table index.  Zero marks an unused table entry and is never returned.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_dircache_finish(uint32_t hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  hash ^= hash >> 16;
+
+  return hash != 0 ? hash : 1;
+}
+
+/****************************************************************************
+ * Name: fat_dircache_lfnhash and fat_dircache_sfnhash
+ *
+ * Description:
+ *   Hash a long file name (a NUL terminated string) or a short file name
+ *   (DIR_MAXFNAME bytes, as in the directory entry).
+ *
+ ****************************************************************************/
+
+static uint32_t fat_dircache_lfnhash(const uint8_t *lfname)
+{
+  return fat_dircache_finish(
+           fat_dircache_accumulate(0, lfname, strlen((FAR const char *)lfname),
+                                   0));
+}
+
+static uint32_t fat_dircache_sfnhash(const uint8_t *sfname)
+{
+  return fat_dircache_finish(
+           fat_dircache_accumulate(DIRCACHE_SFNSEED, sfname, DIR_MAXFNAME, 0));
+}
+
+/****************************************************************************
+ * Name: fat_dircache_lfnchunk and fat_dircache_lfnchars
+ *
+ * Description:
+ *   Extract the characters of an LFN directory entry.  Like the lookup in
+ *   fat_findlfnentry(), only the low byte of each character is used.
+ *   Returns the number of characters before the NUL terminator, if any.
+ *
+ ****************************************************************************/
+
+static void fat_dircache_lfnchunk(uint8_t *chunk, uint8_t *chars,
+                                  int nchunk)
+{
+  int i;
+
+  for (i = 0; i < nchunk; i++)
+    {
+      chars[i] = fat_getuint16(chunk) & 0xff;
+      chunk   += sizeof(uint16_t);
+    }
+}
+
+static int fat_dircache_lfnchars(uint8_t *direntry, uint8_t *chars)
+{
+  int i;
+
+  fat_dircache_lfnchunk(LDIR_PTRWCHAR1_5(direntry), chars, 5);
+  fat_dircache_lfnchunk(LDIR_PTRWCHAR6_11(direntry), &chars[5], 6);
+  fat_dircache_lfnchunk(LDIR_PTRWCHAR12_13(direntry), &chars[11], 2);
+
+  for (i = 0; i < LDIR_MAXLFNCHARS && chars[i] != '\0'; i++);
+  return i;
+}
+
+/****************************************************************************
+ * Name: fat_dircache_index
+ *
+ * Description:
+ *   Convert the sector and byte offset of a directory entry, as kept in
+ *   struct fat_dirseq_s, into the directory index kept in fs_fatdir_s.
+ *
+ ****************************************************************************/
+
+static uint16_t fat_dircache_index(FAR struct fat_mountpt_s *fs,
+                                   off_t cluster, off_t sector,
+                                   uint16_t offset)
+{
+  off_t first;
+
+  /* The FAT12/16 root directory is indexed from its first sector; any
+   * other directory from the first sector of the current cluster.
+   */
+
+  first = cluster != 0 ? fat_cluster2sector(fs, cluster) : fs->fs_rootbase;
+  return (uint16_t)((sector - first) * DIRSEC_NDIRS(fs) + offset / DIR_SIZE);
+}
+
+/****************************************************************************
+ * Name: fat_dircache_free
+ *
+ * Description:
+ *   Free the lookup cache of one directory.
+ *
+ ****************************************************************************/
+
+static void fat_dircache_free(FAR struct fat_dircache_s *dc)
+{
+  if (dc->dc_table != NULL)
+    {
+      kmm_free(dc->dc_table);
+    }
+
+  kmm_free(dc);
+}
+
+/****************************************************************************
+ * Name: fat_dircache_get
+ *
+ * Description:
+ *   Return the lookup cache of the directory that begins at startcluster,
+ *   moving it to the head of the MRU list, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_dircache_s *
+fat_dircache_get(FAR struct fat_mountpt_s *fs, off_t startcluster)
+{
+  FAR struct fat_dircache_s *prev = NULL;
+  FAR struct fat_dircache_s *dc;
+
+  for (dc = fs->fs_dircache; dc != NULL; prev = dc, dc = dc->dc_flink)
+    {
+      if (dc->dc_startcluster == startcluster)
+        {
+          if (prev != NULL)
+            {
+              prev->dc_flink  = dc->dc_flink;
+              dc->dc_flink    = fs->fs_dircache;
+              fs->fs_dircache = dc;
+            }
+
+          return dc;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: fat_dircache_resize
+ *
+ * Description:
+ *   Re-hash the table into one of nslots entries, dropping the entries of
+ *   removed names.
+ *
+ ****************************************************************************/
+
+static int fat_dircache_resize(FAR struct fat_dircache_s *dc,
+                               unsigned int nslots)
+{
+  FAR struct fat_dcentry_s *table;
+  FAR struct fat_dcentry_s *entry;
+  unsigned int nused = 0;
+  unsigned int mask = nslots - 1;
+  unsigned int ndx;
+  int i;
+
+  table = (FAR struct fat_dcentry_s *)
+    kmm_zalloc(nslots * sizeof(struct fat_dcentry_s));
+
+  if (table == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < dc->dc_nslots; i++)
+    {
+      entry = &dc->dc_table[i];
+      if (entry->de_hash != 0 && entry->de_sector != 0)
+        {
+          for (ndx = entry->de_hash & mask;
+               table[ndx].de_hash != 0;
+               ndx = (ndx + 1) & mask);
+
+          table[ndx] = *entry;
+          nused++;
+        }
+    }
+
+  if (dc->dc_table != NULL)
+    {
+      kmm_free(dc->dc_table);
+    }
+
+  dc->dc_table  = table;
+  dc->dc_nslots = nslots;
+  dc->dc_nused  = nused;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_dircache_insert
+ *
+ * Description:
+ *   Add a name to the table, growing the table as needed.  If the table
+ *   cannot hold the name, it is marked incomplete so that names not found
+ *   in it are searched for on the media.
+ *
+ ****************************************************************************/
+
+static int fat_dircache_insert(FAR struct fat_dircache_s *dc, uint32_t hash,
+                               off_t cluster, off_t sector, uint16_t index)
+{
+  FAR struct fat_dcentry_s *entry;
+  unsigned int nslots;
+  unsigned int nlive;
+  unsigned int mask;
+  unsigned int ndx;
+  int i;
+
+  /* Keep the table at most three quarters full, so that the probe
+   * sequences stay short and always end at an unused entry.
+   */
+
+  if (4 * (dc->dc_nused + 1) > 3 * dc->dc_nslots)
+    {
+      for (nlive = 0, i = 0; i < dc->dc_nslots; i++)
+        {
+          if (dc->dc_table[i].de_hash != 0 && dc->dc_table[i].de_sector != 0)
+            {
+              nlive++;
+            }
+        }
+
+      for (nslots = dc->dc_nslots; 4 * (nlive + 1) > 3 * nslots; nslots <<= 1);
+      if (nslots > CONFIG_FAT_DIRCACHE_MAXSLOTS ||
+          fat_dircache_resize(dc, nslots) < 0)
+        {
+          dc->dc_complete = false;
+          return -ENOSPC;
+        }
+    }
+
+  mask = dc->dc_nslots - 1;
+  for (ndx = hash & mask; ; ndx = (ndx + 1) & mask)
+    {
+      entry = &dc->dc_table[ndx];
+      if (entry->de_hash == 0 || entry->de_sector == 0)
+        {
+          break;
+        }
+    }
+
+  if (entry->de_hash == 0)
+    {
+      dc->dc_nused++;
+    }
+
+  entry->de_hash    = hash;
+  entry->de_index   = index;
+  entry->de_sector  = sector;
+  entry->de_cluster = cluster;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_dircache_build
+ *
+ * Description:
+ *   Scan a directory, beginning at the position in 'start', and build its
+ *   lookup cache.  Every short file name entry is added under its short
+ *   name and every complete long file name sequence under its long name.
+ *   Returns NULL if the cache could not be built.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_dircache_s *
+fat_dircache_build(FAR struct fat_mountpt_s *fs,
+                   FAR const struct fs_fatdir_s *start)
+{
+  FAR struct fat_dircache_s *dc;
+  FAR struct fat_dircache_s *prev;
+  struct fs_fatdir_s dir;
+  uint8_t  chars[LDIR_MAXLFNCHARS];
+  uint8_t *direntry;
+  uint32_t sum = 0;
+  off_t    lfnsector = 0;
+  off_t    lfncluster = 0;
+  uint16_t lfnindex = 0;
+  uint8_t  checksum = 0;
+  uint8_t  seqno;
+  int      expected = -1;
+  int      ndirs;
+  int      nchars;
+  int      ret;
+
+  /* Discard the least recently used cache if there are too many */
+
+  for (ndirs = 1, prev = NULL, dc = fs->fs_dircache;
+       dc != NULL && dc->dc_flink != NULL;
+       ndirs++, prev = dc, dc = dc->dc_flink);
+
+  if (dc != NULL && ndirs >= CONFIG_FAT_DIRCACHE_NDIRS)
+    {
+      if (prev != NULL)
+        {
+          prev->dc_flink = NULL;
+        }
+      else
+        {
+          fs->fs_dircache = NULL;
+        }
+
+      fat_dircache_free(dc);
+    }
+
+  dc = (FAR struct fat_dircache_s *)kmm_zalloc(sizeof(struct fat_dircache_s));
+  if (dc == NULL)
+    {
+      return NULL;
+    }
+
+  dc->dc_startcluster = start->fd_startcluster;
+  if (fat_dircache_resize(dc, DIRCACHE_INITSLOTS) < 0)
+    {
+      fat_dircache_free(dc);
+      return NULL;
+    }
+
+  memcpy(&dir, start, sizeof(struct fs_fatdir_s));
+  dc->dc_complete = true;
+
+  for (; ; )
+    {
+      ret = fat_fscacheread(fs, dir.fd_currsector);
+      if (ret < 0)
+        {
+          fat_dircache_free(dc);
+          return NULL;
+        }
+
+      direntry = &fs->fs_buffer[DIRSEC_BYTENDX(fs, dir.fd_index)];
+      if (direntry[DIR_NAME] == DIR0_ALLEMPTY)
+        {
+          break;
+        }
+
+      seqno = LDIR_GETSEQ(direntry);
+      if (LDIR_GETATTRIBUTES(direntry) == LDDIR_LFNATTR)
+        {
+          if ((seqno & ~(LDIR0_LAST | LDIR0_SEQ_MASK)) != 0 ||
+              (seqno & LDIR0_SEQ_MASK) < 1 ||
+              (seqno & LDIR0_SEQ_MASK) > LDIR_MAXLFNS)
+            {
+              /* Deleted or invalid */
+
+              expected = -1;
+            }
+          else if ((seqno & LDIR0_LAST) != 0)
+            {
+              /* The "last" entry begins a new long file name.  Only its
+               * characters up to the NUL terminator are part of the name.
+               */
+
+              seqno      &= LDIR0_SEQ_MASK;
+              nchars      = fat_dircache_lfnchars(direntry, chars);
+              sum         = fat_dircache_accumulate(0, chars, nchars,
+                                                    (seqno - 1) *
+                                                    LDIR_MAXLFNCHARS);
+              checksum    = LDIR_GETCHECKSUM(direntry);
+              lfnsector   = dir.fd_currsector;
+              lfncluster  = dir.fd_currcluster;
+              lfnindex    = dir.fd_index;
+              expected    = seqno - 1;
+            }
+          else if (expected > 0 && seqno == expected &&
+                   LDIR_GETCHECKSUM(direntry) == checksum)
+            {
+              (void)fat_dircache_lfnchars(direntry, chars);
+              sum = fat_dircache_accumulate(sum, chars, LDIR_MAXLFNCHARS,
+                                            (seqno - 1) * LDIR_MAXLFNCHARS);
+              expected--;
+            }
+          else
+            {
+              expected = -1;
+            }
+        }
+      else
+        {
+          /* A short file name entry.  Does it complete a long file name? */
+
+          if (expected == 0 &&
+              fat_lfnchecksum(&direntry[DIR_NAME]) == checksum)
+            {
+              ret = fat_dircache_insert(dc, fat_dircache_finish(sum),
+                                        lfncluster, lfnsector, lfnindex);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          if (direntry[DIR_NAME] != DIR0_EMPTY &&
+              !(DIR_GETATTRIBUTES(direntry) & FATATTR_VOLUMEID))
+            {
+              ret = fat_dircache_insert(dc,
+                                        fat_dircache_sfnhash(&direntry[DIR_NAME]),
+                                        dir.fd_currcluster, dir.fd_currsector,
+                                        dir.fd_index);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          expected = -1;
+        }
+
+      if (fat_nextdirentry(fs, &dir) != OK)
+        {
+          break;
+        }
+    }
+
+  finfo("Directory %ld: %u names%s\n", (long)dc->dc_startcluster,
+        dc->dc_nused, dc->dc_complete ? "" : " (incomplete)");
+
+  dc->dc_flink    = fs->fs_dircache;
+  fs->fs_dircache = dc;
+  return dc;
+}
+
+/****************************************************************************
+ * Name: fat_dircache_unlink
+ *
+ * Description:
+ *   Remove a directory cache from the MRU list and free it.
+ *
+ ****************************************************************************/
+
+static void fat_dircache_unlink(FAR struct fat_mountpt_s *fs,
+                                FAR struct fat_dircache_s *dc)
+{
+  FAR struct fat_dircache_s **pprev;
+
+  for (pprev = &fs->fs_dircache; *pprev != NULL; pprev = &(*pprev)->dc_flink)
+    {
+      if (*pprev == dc)
+        {
+          *pprev = dc->dc_flink;
+          fat_dircache_free(dc);
+          return;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fat_dircache_find
+ *
+ * Description:
+ *   Look up the long or short file name in dirinfo in the directory whose
+ *   position is in dirinfo->dir, like fat_findentry(), but using (and, on
+ *   the first lookup in the directory, building) the lookup cache of the
+ *   directory.  Returns OK if the name was found, -ENOENT if it does not
+ *   exist, or another negated errno value on failure.
+ *
+ * NOTE: As a side effect, this function returns with the sector containing
+ *   the short file name directory entry in the cache.
+ *
+ ****************************************************************************/
+
+int fat_dircache_find(FAR struct fat_mountpt_s *fs,
+                      FAR struct fat_dirinfo_s *dirinfo)
+{
+  FAR struct fat_dircache_s *dc;
+  FAR struct fat_dcentry_s *entry;
+  struct fs_fatdir_s start;
+  uint32_t hash;
+  unsigned int mask;
+  unsigned int ndx;
+  int ret;
+
+  memcpy(&start, &dirinfo->dir, sizeof(struct fs_fatdir_s));
+
+  dc = fat_dircache_get(fs, start.fd_startcluster);
+  if (dc == NULL)
+    {
+      dc = fat_dircache_build(fs, &start);
+      if (dc == NULL)
+        {
+          return fat_findentry(fs, dirinfo, false);
+        }
+    }
+
+  if (dirinfo->fd_lfname[0] != '\0')
+    {
+      hash = fat_dircache_lfnhash(dirinfo->fd_lfname);
+    }
+  else
+    {
+      hash = fat_dircache_sfnhash(dirinfo->fd_name);
+    }
+
+  /* Check each entry with the same hash at the position it records */
+
+  mask = dc->dc_nslots - 1;
+  for (ndx = hash & mask; dc->dc_table[ndx].de_hash != 0;
+       ndx = (ndx + 1) & mask)
+    {
+      entry = &dc->dc_table[ndx];
+      if (entry->de_hash != hash || entry->de_sector == 0)
+        {
+          continue;
+        }
+
+      dirinfo->dir.fd_currcluster = entry->de_cluster;
+      dirinfo->dir.fd_currsector  = entry->de_sector;
+      dirinfo->dir.fd_index       = entry->de_index;
+
+      ret = fat_findentry(fs, dirinfo, true);
+      if (ret == OK)
+        {
+          /* The search would have started at the beginning of the
+           * directory.
+           */
+
+          dirinfo->fd_seq.ds_startsector = start.fd_currsector;
+          return OK;
+        }
+      else if (ret != -ENOENT)
+        {
+          return ret;
+        }
+    }
+
+  /* Not in the table.  If the table holds every name in the directory,
+   * then the name does not exist.  Otherwise, search the media.
+   */
+
+  memcpy(&dirinfo->dir, &start, sizeof(struct fs_fatdir_s));
+  if (dc->dc_complete)
+    {
+      return -ENOENT;
+    }
+
+  return fat_findentry(fs, dirinfo, false);
+}
+
+/****************************************************************************
+ * Name: fat_dircache_written
+ *
+ * Description:
+ *   Add the name just written to the directory by fat_dirwrite() or
+ *   fat_dirnamewrite() to the lookup cache of the directory.  'result' is
+ *   the result of the write; if it failed, the state of the directory is
+ *   unknown and its cache is discarded.
+ *
+ ****************************************************************************/
+
+void fat_dircache_written(FAR struct fat_mountpt_s *fs,
+                          FAR struct fat_dirinfo_s *dirinfo, int result)
+{
+  FAR struct fat_dirseq_s *seq = &dirinfo->fd_seq;
+  FAR struct fat_dircache_s *dc;
+
+  dc = fat_dircache_get(fs, dirinfo->dir.fd_startcluster);
+  if (dc == NULL)
+    {
+      return;
+    }
+
+  if (result < 0)
+    {
+      fat_dircache_unlink(fs, dc);
+      return;
+    }
+
+  (void)fat_dircache_insert(dc, fat_dircache_sfnhash(dirinfo->fd_name),
+                            seq->ds_cluster, seq->ds_sector,
+                            fat_dircache_index(fs, seq->ds_cluster,
+                                               seq->ds_sector,
+                                               seq->ds_offset));
+
+  if (dirinfo->fd_lfname[0] != '\0')
+    {
+      (void)fat_dircache_insert(dc, fat_dircache_lfnhash(dirinfo->fd_lfname),
+                                seq->ds_lfncluster, seq->ds_lfnsector,
+                                fat_dircache_index(fs, seq->ds_lfncluster,
+                                                   seq->ds_lfnsector,
+                                                   seq->ds_lfnoffset));
+    }
+}
+
+/****************************************************************************
+ * Name: fat_dircache_freed
+ *
+ * Description:
+ *   Remove the names of the directory entries just freed by
+ *   fat_freedirentry() from the lookup cache of the directory that begins
+ *   at startcluster.  'result' is the result of fat_freedirentry(); if it
+ *   failed, the cache is discarded.
+ *
+ ****************************************************************************/
+
+void fat_dircache_freed(FAR struct fat_mountpt_s *fs, off_t startcluster,
+                        FAR struct fat_dirseq_s *seq, int result)
+{
+  FAR struct fat_dircache_s *dc;
+  FAR struct fat_dcentry_s *entry;
+  uint16_t sfnindex;
+  uint16_t lfnindex;
+  int i;
+
+  dc = fat_dircache_get(fs, startcluster);
+  if (dc == NULL)
+    {
+      return;
+    }
+
+  if (result < 0)
+    {
+      fat_dircache_unlink(fs, dc);
+      return;
+    }
+
+  sfnindex = fat_dircache_index(fs, seq->ds_cluster, seq->ds_sector,
+                                seq->ds_offset);
+  lfnindex = fat_dircache_index(fs, seq->ds_lfncluster, seq->ds_lfnsector,
+                                seq->ds_lfnoffset);
+
+  /* The entries are found by position, since the names are not known
+   * here.  Removed entries keep their hash so that the probe sequences
+   * through them are not broken.
+   */
+
+  for (i = 0; i < dc->dc_nslots; i++)
+    {
+      entry = &dc->dc_table[i];
+      if ((entry->de_sector == seq->ds_sector &&
+           entry->de_index == sfnindex) ||
+          (entry->de_sector == seq->ds_lfnsector &&
+           entry->de_index == lfnindex))
+        {
+          entry->de_sector = 0;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_dircache_invalidate
+ *
+ * Description:
+ *   Discard the lookup cache of the directory that begins at startcluster,
+ *   if any.  Called when the directory is removed, since its clusters may
+ *   then be reused for a different directory.
+ *
+ ****************************************************************************/
+
+void fat_dircache_invalidate(FAR struct fat_mountpt_s *fs, off_t startcluster)
+{
+  FAR struct fat_dircache_s *dc;
+
+  dc = fat_dircache_get(fs, startcluster);
+  if (dc != NULL)
+    {
+      fat_dircache_unlink(fs, dc);
+    }
+}
+
+/****************************************************************************
+ * Name: fat_dircache_release
+ *
+ * Description:
+ *   Discard all directory lookup caches of the volume.  Called when the
+ *   volume is unmounted or the media is found to have changed.
+ *
+ ****************************************************************************/
+
+void fat_dircache_release(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_dircache_s *dc;
+
+  while ((dc = fs->fs_dircache) != NULL)
+    {
+      fs->fs_dircache = dc->dc_flink;
+      fat_dircache_free(dc);
+    }
+}
+
+#endif /* CONFIG_FAT_DIRCACHE */
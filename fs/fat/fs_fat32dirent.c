@@ -101,9 +101,6 @@ enum fat_case_e
  * Private Function Prototypes
  ****************************************************************************/
 
-#ifdef CONFIG_FAT_LFN
-static uint8_t fat_lfnchecksum(const uint8_t *sfname);
-#endif
 static inline int fat_parsesfname(const char **path,
                                   struct fat_dirinfo_s *dirinfo,
                                   char *terminator);
@@ -120,12 +117,12 @@ static inline int fat_uniquealias(struct fat_mountpt_s *fs,
 static int fat_path2dirname(const char **path, struct fat_dirinfo_s *dirinfo,
                             char *terminator);
 static int fat_findsfnentry(struct fat_mountpt_s *fs,
-                            struct fat_dirinfo_s *dirinfo);
+                            struct fat_dirinfo_s *dirinfo, bool probe);
 #ifdef CONFIG_FAT_LFN
 static bool fat_cmplfnchunk(uint8_t *chunk, const uint8_t *substr, int nchunk);
 static bool fat_cmplfname(const uint8_t *direntry, const uint8_t *substr);
 static inline int fat_findlfnentry(struct fat_mountpt_s *fs,
-                                   struct fat_dirinfo_s *dirinfo);
+                                   struct fat_dirinfo_s *dirinfo, bool probe);
 
 #endif
 static inline int fat_allocatesfnentry(struct fat_mountpt_s *fs,
@@ -155,30 +152,6 @@ static int fat_putsfdirentry(struct fat_mountpt_s *fs,
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: fat_lfnchecksum
- *
- * Description:
- *   Verify that the checksum of the short file name matches the checksum
- *   that we found in the long file name entries.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_FAT_LFN
-static uint8_t fat_lfnchecksum(const uint8_t *sfname)
-{
-  uint8_t sum = 0;
-  int i;
-
-  for (i = DIR_MAXFNAME; i; i--)
-    {
-      sum = ((sum & 1) << 7) + (sum >> 1) + *sfname++;
-    }
-
-  return sum;
-}
-#endif
-
 /****************************************************************************
  * Name: fat_parsesfname
  *
@@ -793,7 +766,14 @@ static inline int fat_findalias(struct fat_mountpt_s *fs,
 
   /* Search for the single short file name directory entry in this directory */
 
-  return fat_findsfnentry(fs, &tmpinfo);
+#ifdef CONFIG_FAT_DIRCACHE
+  tmpinfo.dir.fd_startcluster = dirinfo->dir.fd_startcluster;
+  tmpinfo.dir.fd_currcluster  = dirinfo->dir.fd_startcluster;
+  tmpinfo.fd_lfname[0]        = '\0';
+  return fat_dircache_find(fs, &tmpinfo);
+#else
+  return fat_findsfnentry(fs, &tmpinfo, false);
+#endif
 }
 #endif
 
@@ -952,12 +932,13 @@ static int fat_path2dirname(const char **path, struct fat_dirinfo_s *dirinfo,
  * Name: fat_findsfnentry
  *
  * Desciption: Find a short file name directory entry.  Returns OK if the
- *  directory exists; -ENOENT if it does not.
+ *  directory exists; -ENOENT if it does not.  If probe is true, only the
+ *  entry at the current position is checked.
  *
  ****************************************************************************/
 
 static int fat_findsfnentry(struct fat_mountpt_s *fs,
-                            struct fat_dirinfo_s *dirinfo)
+                            struct fat_dirinfo_s *dirinfo, bool probe)
 {
   uint16_t diroffset;
   uint8_t *direntry;
@@ -1028,7 +1009,7 @@ static int fat_findsfnentry(struct fat_mountpt_s *fs,
 
       /* No... get the next directory index and try again */
 
-      if (fat_nextdirentry(fs, &dirinfo->dir) != OK)
+      if (probe || fat_nextdirentry(fs, &dirinfo->dir) != OK)
         {
           return -ENOENT;
         }
@@ -1146,7 +1127,8 @@ static bool fat_cmplfname(const uint8_t *direntry, const uint8_t *substr)
 /****************************************************************************
  * Name: fat_findlfnentry
  *
- * Desciption: Find a sequence of long file name directory entries.
+ * Desciption: Find a sequence of long file name directory entries.  If
+ *   probe is true, only the sequence at the current position is checked.
  *
  * NOTE: As a side effect, this function returns with the sector containing
  *   the short file name directory entry in the cache.
@@ -1155,7 +1137,7 @@ static bool fat_cmplfname(const uint8_t *direntry, const uint8_t *substr)
 
 #ifdef CONFIG_FAT_LFN
 static inline int fat_findlfnentry(struct fat_mountpt_s *fs,
-                                   struct fat_dirinfo_s *dirinfo)
+                                   struct fat_dirinfo_s *dirinfo, bool probe)
 {
   uint16_t diroffset;
   uint8_t *direntry;
@@ -1336,6 +1318,11 @@ static inline int fat_findlfnentry(struct fat_mountpt_s *fs,
                */
 
               seqno = lastseq;
+              if (probe)
+                {
+                  return -ENOENT;
+                }
+
               continue;
             }
 
@@ -1354,10 +1341,13 @@ static inline int fat_findlfnentry(struct fat_mountpt_s *fs,
           seqno = lastseq;
         }
 
-      /* Continue at the next directory entry */
+      /* Continue at the next directory entry.  A probe ends as soon as the
+       * sequence at the starting position fails to match.
+       */
 
 next_entry:
-      if (fat_nextdirentry(fs, &dirinfo->dir) != OK)
+      if ((probe && seqno == lastseq) ||
+          fat_nextdirentry(fs, &dirinfo->dir) != OK)
         {
           return -ENOENT;
         }
@@ -2233,6 +2223,30 @@ static int fat_putsfdirentry(struct fat_mountpt_s *fs,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_lfnchecksum
+ *
+ * Description:
+ *   Verify that the checksum of the short file name matches the checksum
+ *   that we found in the long file name entries.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_LFN
+uint8_t fat_lfnchecksum(const uint8_t *sfname)
+{
+  uint8_t sum = 0;
+  int i;
+
+  for (i = DIR_MAXFNAME; i; i--)
+    {
+      sum = ((sum & 1) << 7) + (sum >> 1) + *sfname++;
+    }
+
+  return sum;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_finddirentry
  *
@@ -2318,28 +2332,16 @@ int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
           return ret;
         }
 
-      /* Is this a path segment a long or a short file.  Was a long file
-       * name parsed?
+      /* Search the directory for the name.  NOTE: As a side effect, this
+       * returns with the sector containing the short file name directory
+       * entry in the cache.
        */
 
-#ifdef CONFIG_FAT_LFN
-      if (dirinfo->fd_lfname[0] != '\0')
-        {
-          /* Yes.. Search for the sequence of long file name directory
-           * entries. NOTE: As a side effect, this function returns with
-           * the sector containing the short file name directory entry
-           * in the cache.
-           */
-
-          ret = fat_findlfnentry(fs, dirinfo);
-        }
-      else
+#ifdef CONFIG_FAT_DIRCACHE
+      ret = fat_dircache_find(fs, dirinfo);
+#else
+      ret = fat_findentry(fs, dirinfo, false);
 #endif
-        {
-          /* No.. Search for the single short file name directory entry */
-
-          ret = fat_findsfnentry(fs, dirinfo);
-        }
 
       /* Did we find the directory entries? */
 
@@ -2404,6 +2406,42 @@ int fat_finddirentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
     }
 }
 
+/****************************************************************************
+ * Name: fat_findentry
+ *
+ * Desciption: Search the directory, beginning at the current position in
+ *   dirinfo->dir, for the long or short file name in dirinfo.  If probe is
+ *   true, only the entry (or sequence of entries) at the current position
+ *   is checked.
+ *
+ * NOTE: As a side effect, this function returns with the sector containing
+ *   the short file name directory entry in the cache.
+ *
+ ****************************************************************************/
+
+int fat_findentry(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
+                  bool probe)
+{
+  /* Is this a path segment a long or a short file.  Was a long file
+   * name parsed?
+   */
+
+#ifdef CONFIG_FAT_LFN
+  if (dirinfo->fd_lfname[0] != '\0')
+    {
+      /* Yes.. Search for the sequence of long file name directory
+       * entries.
+       */
+
+      return fat_findlfnentry(fs, dirinfo, probe);
+    }
+#endif
+
+  /* No.. Search for the single short file name directory entry */
+
+  return fat_findsfnentry(fs, dirinfo, probe);
+}
+
 /****************************************************************************
  * Name: fat_allocatedirentry
  *
@@ -2725,7 +2763,13 @@ int fat_dirnamewrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo)
    */
 #endif
 
+#ifdef CONFIG_FAT_DIRCACHE
+  ret = fat_putsfname(fs, dirinfo);
+  fat_dircache_written(fs, dirinfo, ret);
+  return ret;
+#else
   return fat_putsfname(fs, dirinfo);
+#endif
 }
 
 /****************************************************************************
@@ -2771,7 +2815,13 @@ int fat_dirwrite(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo,
 
   /* Put the short file name entry data */
 
+#ifdef CONFIG_FAT_DIRCACHE
+  ret = fat_putsfdirentry(fs, dirinfo, attributes, fattime);
+  fat_dircache_written(fs, dirinfo, ret);
+  return ret;
+#else
   return fat_putsfdirentry(fs, dirinfo, attributes, fattime);
+#endif
 }
 
 /****************************************************************************
@@ -2953,6 +3003,16 @@ int fat_remove(struct fat_mountpt_s *fs, const char *relpath, bool directory)
    */
 
   ret = fat_freedirentry(fs, &dirinfo.fd_seq);
+#ifdef CONFIG_FAT_DIRCACHE
+  fat_dircache_freed(fs, dirinfo.dir.fd_startcluster, &dirinfo.fd_seq, ret);
+  if (directory)
+    {
+      /* The clusters of the directory may be reused for another one */
+
+      fat_dircache_invalidate(fs, dircluster);
+    }
+#endif
+
   if (ret < 0)
     {
       return ret;
@@ -59,6 +59,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
@@ -266,6 +267,193 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fatcacheflushentry
+ *
+ * Description:
+ *   Write one FAT cache entry back to each copy of the FAT if it is dirty
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+static int fat_fatcacheflushentry(struct fat_mountpt_s *fs, int ndx)
+{
+  struct fat_fatcache_s *entry = &fs->fs_fatcache[ndx];
+  uint8_t *buffer;
+  off_t sector;
+  int ret;
+  int i;
+
+  if (entry->fc_dirty)
+    {
+      buffer = &fs->fs_fatbuffer[ndx * fs->fs_hwsectorsize];
+      sector = entry->fc_sector;
+
+      for (i = fs->fs_fatnumfats; i >= 1; i--)
+        {
+          ret = fat_hwwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          sector += fs->fs_nfatsects;
+        }
+
+      /* No longer dirty */
+
+      entry->fc_dirty = false;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_fsbufferflush
+ *
+ * Description:
+ *   Flush the sector in fs_buffer if it is dirty
+ *
+ ****************************************************************************/
+
+static int fat_fsbufferflush(struct fat_mountpt_s *fs)
+{
+  int ret;
+
+  /* Check if the fs_buffer is dirty.  In this case, we will write back the
+   * contents of fs_buffer.
+   */
+
+  if (fs->fs_dirty)
+    {
+      /* Write the dirty sector */
+
+      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* Does the sector lie in the FAT region? */
+
+      if (fs->fs_currentsector >= fs->fs_fatbase &&
+          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
+        {
+          /* Yes, then make the change in the FAT copy as well */
+          int i;
+
+          for (i = fs->fs_fatnumfats; i >= 2; i--)
+            {
+              fs->fs_currentsector += fs->fs_nfatsects;
+              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+        }
+
+      /* No longer dirty */
+
+      fs->fs_dirty = false;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Build the free cluster bitmap by scanning the FAT, if that has not
+ *   already been done.  The free cluster count is updated as a side
+ *   effect.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEBITMAP
+static int fat_freemapbuild(struct fat_mountpt_s *fs)
+{
+  uint32_t nfreeclusters;
+  uint32_t cluster;
+  off_t next;
+
+  if (fs->fs_freemap != NULL)
+    {
+      return OK;
+    }
+
+  fs->fs_freemap = (FAR uint8_t *)kmm_zalloc((fs->fs_nclusters + 7) >> 3);
+  if (fs->fs_freemap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nfreeclusters = 0;
+  for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          kmm_free(fs->fs_freemap);
+          fs->fs_freemap = NULL;
+          return (int)next;
+        }
+
+      if (next == 0)
+        {
+          fs->fs_freemap[cluster >> 3] |= (1 << (cluster & 7));
+          nfreeclusters++;
+        }
+    }
+
+  fs->fs_fsifreecount = nfreeclusters;
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_fsidirty = true;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapscan
+ *
+ * Description:
+ *   Return the first free cluster in the range first .. end - 1 according
+ *   to the free cluster bitmap, or zero if there is none.  Bytes of the
+ *   bitmap with no free clusters are skipped as a whole.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEBITMAP
+static uint32_t fat_freemapscan(struct fat_mountpt_s *fs, uint32_t first,
+                                uint32_t end)
+{
+  uint32_t cluster = first;
+
+  while (cluster < end)
+    {
+      if ((cluster & 7) == 0 && fs->fs_freemap[cluster >> 3] == 0)
+        {
+          cluster += 8;
+          continue;
+        }
+
+      if ((fs->fs_freemap[cluster >> 3] & (1 << (cluster & 7))) != 0)
+        {
+          return cluster;
+        }
+
+      cluster++;
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -532,6 +720,19 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
+  /* Determine if the media is directly accessible (such as a RAM disk).
+   * Sectors are then copied to and from the media without calling the
+   * block driver.
+   */
+
+  fs->fs_xipbase = NULL;
+  if (inode->u.i_bops->ioctl == NULL ||
+      inode->u.i_bops->ioctl(inode, BIOC_XIPBASE,
+                             (unsigned long)((uintptr_t)&fs->fs_xipbase)) < 0)
+    {
+      fs->fs_xipbase = NULL;
+    }
+
   /* Allocate a buffer to hold one hardware sector */
 
   fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
@@ -541,6 +742,18 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+  /* Allocate the FAT table cache */
+
+  fs->fs_fatbuffer = (FAR uint8_t *)
+    fat_io_alloc(fs->fs_hwsectorsize * CONFIG_FAT_FATCACHE_NSECTORS);
+  if (!fs->fs_fatbuffer)
+    {
+      ret = -ENOMEM;
+      goto errout_with_buffer;
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check at sector zero.  This
    * could be either the boot record or a partition that refers to the boot
    * record.
@@ -664,6 +877,15 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+  if (fs->fs_fatbuffer)
+    {
+      fat_io_free(fs->fs_fatbuffer,
+                  fs->fs_hwsectorsize * CONFIG_FAT_FATCACHE_NSECTORS);
+      fs->fs_fatbuffer = 0;
+    }
+#endif
+
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = 0;
 
@@ -711,6 +933,12 @@ int fat_checkmount(struct fat_mountpt_s *fs)
       /* If we get here, the mount is NOT healthy */
 
       fs->fs_mounted = false;
+
+#ifdef CONFIG_FAT_DIRCACHE
+      /* Whatever is in the drive now is not what was cached */
+
+      fat_dircache_release(fs);
+#endif
     }
 
   return -ENODEV;
@@ -728,6 +956,19 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                unsigned int nsectors)
 {
   int ret = -ENODEV;
+
+  if (fs && fs->fs_xipbase)
+    {
+      if (sector < 0 || sector + nsectors > fs->fs_hwnsectors)
+        {
+          return -EIO;
+        }
+
+      memcpy(buffer, &fs->fs_xipbase[sector * fs->fs_hwsectorsize],
+             nsectors * fs->fs_hwsectorsize);
+      return OK;
+    }
+
   if (fs && fs->fs_blkdriver)
     {
       struct inode *inode = fs->fs_blkdriver;
@@ -761,6 +1002,21 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
                 unsigned int nsectors)
 {
   int ret = -ENODEV;
+
+  if (fs && fs->fs_xipbase)
+    {
+      /* The mount has already verified that the media is write-able */
+
+      if (sector < 0 || sector + nsectors > fs->fs_hwnsectors)
+        {
+          return -EIO;
+        }
+
+      memcpy(&fs->fs_xipbase[sector * fs->fs_hwsectorsize], buffer,
+             nsectors * fs->fs_hwsectorsize);
+      return OK;
+    }
+
   if (fs && fs->fs_blkdriver)
     {
       struct inode *inode = fs->fs_blkdriver;
@@ -783,6 +1039,32 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_hwflush
+ *
+ * Description:
+ *   Ask the block driver to write any data that it has cached back to the
+ *   media.  Drivers that do not cache data do not support BIOC_FLUSH.
+ *
+ ****************************************************************************/
+
+int fat_hwflush(struct fat_mountpt_s *fs)
+{
+  struct inode *inode = fs->fs_blkdriver;
+  int ret = OK;
+
+  if (inode && inode->u.i_bops && inode->u.i_bops->ioctl)
+    {
+      ret = inode->u.i_bops->ioctl(inode, BIOC_FLUSH, 0);
+      if (ret == -ENOTTY || ret == -EINVAL)
+        {
+          ret = OK;
+        }
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: fat_cluster2sector
  *
@@ -813,6 +1095,8 @@ off_t fat_cluster2sector(FAR struct fat_mountpt_s *fs,  uint32_t cluster)
 
 off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
 {
+  uint8_t *fatbuffer;
+
   /* Verify that the cluster number is within range */
 
   if (clusterno >= 2 && clusterno < fs->fs_nclusters)
@@ -839,7 +1123,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
 
               /* Read the sector at this offset */
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatcacheread(fs, fatsector, &fatbuffer) < 0)
                 {
                   /* Read error */
 
@@ -849,7 +1133,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               /* Get the first, LS byte of the cluster from the FAT */
 
               fatindex = fatoffset & SEC_NDXMASK(fs);
-              cluster  = fs->fs_buffer[fatindex];
+              cluster  = fatbuffer[fatindex];
 
               /* With FAT12, the second byte of the cluster number may lie in
                * a different sector than the first byte.
@@ -861,7 +1145,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
                   fatsector++;
                   fatindex = 0;
 
-                  if (fat_fscacheread(fs, fatsector) < 0)
+                  if (fat_fatcacheread(fs, fatsector, &fatbuffer) < 0)
                     {
                       /* Read error */
 
@@ -874,7 +1158,7 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
                * on the fact that the byte stream is little-endian.
                */
 
-              cluster |= (unsigned int)fs->fs_buffer[fatindex] << 8;
+              cluster |= (unsigned int)fatbuffer[fatindex] << 8;
 
               /* Now, pick out the correct 12 bit cluster start sector value */
 
@@ -900,14 +1184,14 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               off_t        fatsector = fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatcacheread(fs, fatsector, &fatbuffer) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              return FAT_GETFAT16(fs->fs_buffer, fatindex);
+              return FAT_GETFAT16(fatbuffer, fatindex);
             }
 
           case FSTYPE_FAT32 :
@@ -916,14 +1200,14 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
               off_t        fatsector = fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatcacheread(fs, fatsector, &fatbuffer) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              return FAT_GETFAT32(fs->fs_buffer, fatindex) & 0x0fffffff;
+              return FAT_GETFAT32(fatbuffer, fatindex) & 0x0fffffff;
             }
 
           default:
@@ -947,6 +1231,8 @@ off_t fat_getcluster(struct fat_mountpt_s *fs, uint32_t clusterno)
 int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                    off_t nextcluster)
 {
+  uint8_t *fatbuffer;
+
   /* Verify that the cluster number is within range.  Zero erases the cluster. */
 
   if (clusterno == 0 || (clusterno >= 2 && clusterno < fs->fs_nclusters))
@@ -973,7 +1259,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 
               /* Make sure that the sector at this offset is in the cache */
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatcacheread(fs, fatsector, &fatbuffer) < 0)
                 {
                   /* Read error */
 
@@ -989,7 +1275,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                 {
                   /* Save the LS four bits of the next cluster */
 
-                  value = (fs->fs_buffer[fatindex] & 0x0f) | nextcluster << 4;
+                  value = (fatbuffer[fatindex] & 0x0f) | nextcluster << 4;
                 }
               else
                 {
@@ -998,7 +1284,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                   value = (uint8_t)nextcluster;
                 }
 
-              fs->fs_buffer[fatindex] = value;
+              fatbuffer[fatindex] = value;
 
               /* With FAT12, the second byte of the cluster number may lie in
                * a different sector than the first byte.
@@ -1016,8 +1302,8 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                    * just modified is written out.
                    */
 
-                  fs->fs_dirty = true;
-                  if (fat_fscacheread(fs, fatsector) < 0)
+                  fat_fatcachedirty(fs);
+                  if (fat_fatcacheread(fs, fatsector, &fatbuffer) < 0)
                     {
                       /* Read error */
 
@@ -1039,10 +1325,10 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
                 {
                   /* Save the MS four bits of the next cluster */
 
-                  value = (fs->fs_buffer[fatindex] & 0xf0) | ((nextcluster >> 8) & 0x0f);
+                  value = (fatbuffer[fatindex] & 0xf0) | ((nextcluster >> 8) & 0x0f);
                 }
 
-              fs->fs_buffer[fatindex] = value;
+              fatbuffer[fatindex] = value;
             }
           break;
 
@@ -1052,14 +1338,14 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
               off_t        fatsector = fs->fs_fatbase + SEC_NSECTORS(fs, fatoffset);
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatcacheread(fs, fatsector, &fatbuffer) < 0)
                 {
                   /* Read error */
 
                   break;
                 }
 
-              FAT_PUTFAT16(fs->fs_buffer, fatindex, nextcluster & 0xffff);
+              FAT_PUTFAT16(fatbuffer, fatindex, nextcluster & 0xffff);
             }
           break;
 
@@ -1070,7 +1356,7 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
               unsigned int fatindex  = fatoffset & SEC_NDXMASK(fs);
               uint32_t     val;
 
-              if (fat_fscacheread(fs, fatsector) < 0)
+              if (fat_fatcacheread(fs, fatsector, &fatbuffer) < 0)
                 {
                   /* Read error */
 
@@ -1079,8 +1365,8 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 
               /* Keep the top 4 bits */
 
-              val = FAT_GETFAT32(fs->fs_buffer, fatindex) & 0xf0000000;
-              FAT_PUTFAT32(fs->fs_buffer, fatindex, val | (nextcluster & 0x0fffffff));
+              val = FAT_GETFAT32(fatbuffer, fatindex) & 0xf0000000;
+              FAT_PUTFAT32(fatbuffer, fatindex, val | (nextcluster & 0x0fffffff));
             }
           break;
 
@@ -1088,9 +1374,25 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
+#ifdef CONFIG_FAT_FREEBITMAP
+      /* Keep the free cluster bitmap in sync with the FAT */
+
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          if (nextcluster == 0)
+            {
+              fs->fs_freemap[clusterno >> 3] |= (1 << (clusterno & 7));
+            }
+          else
+            {
+              fs->fs_freemap[clusterno >> 3] &= ~(1 << (clusterno & 7));
+            }
+        }
+#endif
+
       /* Mark the modified sector as "dirty" and return success */
 
-      fs->fs_dirty = true;
+      fat_fatcachedirty(fs);
       return OK;
     }
 
@@ -1213,6 +1515,28 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
+#ifdef CONFIG_FAT_FREEBITMAP
+  /* If the free cluster bitmap is available, search it instead of the FAT.
+   * As below, search from the cluster after the start cluster to the end
+   * of the FAT, then wrap back to the beginning.
+   */
+
+  if (fat_freemapbuild(fs) == OK)
+    {
+      newcluster = fat_freemapscan(fs, startcluster + 1, fs->fs_nclusters);
+      if (newcluster == 0)
+        {
+          newcluster = fat_freemapscan(fs, 2, startcluster + 1);
+          if (newcluster == 0)
+            {
+              return 0;
+            }
+        }
+
+      goto found;
+    }
+#endif
+
   /* Loop until (1) we discover that there are not free clusters
    * (return 0), an errors occurs (return -errno), or (3) we find
    * the next cluster (return the new cluster number).
@@ -1275,6 +1599,10 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
    * number in 'newcluster'  Now mark that cluster as in-use.
    */
 
+#ifdef CONFIG_FAT_FREEBITMAP
+found:
+#endif
+
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
   if (ret < 0)
     {
@@ -1310,6 +1638,119 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that the cluster holding the file data at 'position' is
+ *   'cluster'.  The cluster is merged into an extent if it continues one;
+ *   otherwise a new extent is started, replacing the oldest one.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NEXTENTS > 0
+void fat_extentadd(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                   off_t position, uint32_t cluster)
+{
+  struct fat_extent_s *extent;
+  uint32_t index;
+  int ndx;
+
+  index = SEC_NSECTORS(fs, position) / fs->fs_fatsecperclus;
+
+  for (ndx = 0; ndx < CONFIG_FAT_NEXTENTS; ndx++)
+    {
+      extent = &ff->ff_extents[ndx];
+      if (extent->fe_count > 0 && index >= extent->fe_index &&
+          index <= extent->fe_index + extent->fe_count)
+        {
+          /* Is the cluster already in this extent? */
+
+          if (index < extent->fe_index + extent->fe_count)
+            {
+              return;
+            }
+
+          /* Does it continue the extent? */
+
+          if (cluster == extent->fe_cluster + extent->fe_count)
+            {
+              extent->fe_count++;
+              return;
+            }
+        }
+    }
+
+  /* Start a new extent */
+
+  extent = &ff->ff_extents[ff->ff_nextextent];
+  extent->fe_index   = index;
+  extent->fe_cluster = cluster;
+  extent->fe_count   = 1;
+
+  if (++ff->ff_nextextent >= CONFIG_FAT_NEXTENTS)
+    {
+      ff->ff_nextextent = 0;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_extentfind
+ *
+ * Description:
+ *   Find the known cluster nearest to, but not beyond, the cluster holding
+ *   the file data at 'position'.  The cluster number is returned in
+ *   'cluster' and the index of the cluster within the file is returned as
+ *   the function value.  The start cluster of the file (index zero) is
+ *   returned if nothing better is known.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NEXTENTS > 0
+uint32_t fat_extentfind(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                        off_t position, uint32_t *cluster)
+{
+  struct fat_extent_s *extent;
+  uint32_t index;
+  uint32_t best;
+  uint32_t last;
+  int ndx;
+
+  index    = SEC_NSECTORS(fs, position) / fs->fs_fatsecperclus;
+  best     = 0;
+  *cluster = ff->ff_startcluster;
+
+  for (ndx = 0; ndx < CONFIG_FAT_NEXTENTS; ndx++)
+    {
+      extent = &ff->ff_extents[ndx];
+      if (extent->fe_count == 0 || extent->fe_index > index)
+        {
+          continue;
+        }
+
+      /* Does this extent hold the cluster itself? */
+
+      if (index < extent->fe_index + extent->fe_count)
+        {
+          *cluster = extent->fe_cluster + (index - extent->fe_index);
+          return index;
+        }
+
+      /* No.. but its last cluster may be the closest known one */
+
+      last = extent->fe_index + extent->fe_count - 1;
+      if (last > best)
+        {
+          best     = last;
+          *cluster = extent->fe_cluster + extent->fe_count - 1;
+        }
+    }
+
+  return best;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -1476,7 +1917,8 @@ int  fat_dirtruncate(struct fat_mountpt_s *fs, struct fat_dirinfo_s *dirinfo)
  * Name: fat_fscacheflush
  *
  * Description:
- *   Flush any dirty sector if fs_buffer as necessary
+ *   Flush any dirty sector in fs_buffer and in the FAT table cache as
+ *   necessary
  *
  ****************************************************************************/
 
@@ -1484,45 +1926,13 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 {
   int ret;
 
-  /* Check if the fs_buffer is dirty.  In this case, we will write back the
-   * contents of fs_buffer.
-   */
-
-  if (fs->fs_dirty)
+  ret = fat_fsbufferflush(fs);
+  if (ret < 0)
     {
-      /* Write the dirty sector */
-
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Does the sector lie in the FAT region? */
-
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
-        {
-          /* Yes, then make the change in the FAT copy as well */
-          int i;
-
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
-            {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
-            }
-        }
-
-      /* No longer dirty */
-
-      fs->fs_dirty = false;
+      return ret;
     }
 
-  return OK;
+  return fat_fatcacheflush(fs);
 }
 
 /****************************************************************************
@@ -1549,7 +1959,7 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
        * sector if it is dirty.
        */
 
-      ret = fat_fscacheflush(fs);
+      ret = fat_fsbufferflush(fs);
       if (ret < 0)
         {
           return ret;
@@ -1571,6 +1981,145 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fatcacheread
+ *
+ * Description:
+ *   Make sure that the specified FAT table sector is in the FAT cache and
+ *   return the address of the cached data.  If there is no free entry in
+ *   the cache, the least recently used entry is replaced (after writing it
+ *   back, if dirty).  Without a separate FAT cache, the sector is read into
+ *   fs_buffer.
+ *
+ ****************************************************************************/
+
+int fat_fatcacheread(struct fat_mountpt_s *fs, off_t sector,
+                     uint8_t **buffer)
+{
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+  struct fat_fatcache_s *entry;
+  uint32_t age;
+  uint32_t oldest;
+  int victim;
+  int ndx;
+  int ret;
+
+  /* Is the sector already in the cache?  Keep track of the best
+   * replacement candidate at the same time.
+   */
+
+  victim = 0;
+  oldest = 0;
+
+  for (ndx = 0; ndx < CONFIG_FAT_FATCACHE_NSECTORS; ndx++)
+    {
+      entry = &fs->fs_fatcache[ndx];
+      if (entry->fc_sector == sector)
+        {
+          break;
+        }
+
+      /* An unused entry is always the best choice.  Otherwise, prefer the
+       * entry that has gone unused the longest.
+       */
+
+      age = entry->fc_sector == 0 ? UINT32_MAX : fs->fs_fatlru - entry->fc_lru;
+      if (age > oldest)
+        {
+          oldest = age;
+          victim = ndx;
+        }
+    }
+
+  if (ndx >= CONFIG_FAT_FATCACHE_NSECTORS)
+    {
+      /* No.. write back and replace the victim */
+
+      ndx   = victim;
+      entry = &fs->fs_fatcache[ndx];
+
+      ret = fat_fatcacheflushentry(fs, ndx);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      entry->fc_sector = 0;
+      ret = fat_hwread(fs, &fs->fs_fatbuffer[ndx * fs->fs_hwsectorsize],
+                       sector, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      entry->fc_sector = sector;
+    }
+
+  entry->fc_lru     = ++fs->fs_fatlru;
+  fs->fs_fatcurrent = ndx;
+
+  *buffer = &fs->fs_fatbuffer[ndx * fs->fs_hwsectorsize];
+  return OK;
+
+#else
+  int ret;
+
+  ret = fat_fscacheread(fs, sector);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *buffer = fs->fs_buffer;
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: fat_fatcachedirty
+ *
+ * Description:
+ *   Mark the FAT sector most recently returned by fat_fatcacheread() as
+ *   modified.
+ *
+ ****************************************************************************/
+
+void fat_fatcachedirty(struct fat_mountpt_s *fs)
+{
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+  fs->fs_fatcache[fs->fs_fatcurrent].fc_dirty = true;
+#else
+  fs->fs_dirty = true;
+#endif
+}
+
+/****************************************************************************
+ * Name: fat_fatcacheflush
+ *
+ * Description:
+ *   Write all dirty FAT table sectors back to each copy of the FAT
+ *
+ ****************************************************************************/
+
+int fat_fatcacheflush(struct fat_mountpt_s *fs)
+{
+#if CONFIG_FAT_FATCACHE_NSECTORS > 0
+  int ndx;
+  int ret;
+
+  for (ndx = 0; ndx < CONFIG_FAT_FATCACHE_NSECTORS; ndx++)
+    {
+      ret = fat_fatcacheflushentry(fs, ndx);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: fat_ffcacheflush
  *
@@ -1654,6 +2203,99 @@ int fat_ffcacheread(struct fat_mountpt_s *fs, struct fat_file_s *ff, off_t secto
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_ffcachereadahead
+ *
+ * Description:
+ *   Like fat_ffcacheread(), but when the sector is not already buffered,
+ *   read up to 'nsectors' contiguous sectors (limited to
+ *   CONFIG_FAT_READAHEAD) starting at 'sector' into the per-file read-ahead
+ *   buffer in one transfer.  Subsequent sequential sectors are then copied
+ *   from the read-ahead buffer rather than read from the media.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_READAHEAD > 0
+int fat_ffcachereadahead(struct fat_mountpt_s *fs, struct fat_file_s *ff,
+                         off_t sector, unsigned int nsectors)
+{
+  int ret;
+
+  /* Nothing needs to be done if the sector is already in the file buffer */
+
+  if (ff->ff_cachesector == sector && (ff->ff_bflags & FFBUFF_VALID) != 0)
+    {
+      return OK;
+    }
+
+  /* Is the sector in the read-ahead buffer? */
+
+  if (ff->ff_ransectors == 0 || sector < ff->ff_rasector ||
+      sector >= ff->ff_rasector + ff->ff_ransectors)
+    {
+      /* No.. is it worth reading ahead? */
+
+      if (nsectors > CONFIG_FAT_READAHEAD)
+        {
+          nsectors = CONFIG_FAT_READAHEAD;
+        }
+
+      if (nsectors < 2)
+        {
+          return fat_ffcacheread(fs, ff, sector);
+        }
+
+      /* Allocate the read-ahead buffer on first use */
+
+      if (ff->ff_rabuffer == NULL)
+        {
+          ff->ff_rabuffer = (FAR uint8_t *)
+            fat_io_alloc(CONFIG_FAT_READAHEAD * fs->fs_hwsectorsize);
+          if (ff->ff_rabuffer == NULL)
+            {
+              return fat_ffcacheread(fs, ff, sector);
+            }
+        }
+
+      /* Flush any dirty sector first so that the media is up to date, then
+       * read all of the sectors in one transfer.
+       */
+
+      ret = fat_ffcacheflush(fs, ff);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ff->ff_ransectors = 0;
+      ret = fat_hwread(fs, ff->ff_rabuffer, sector, nsectors);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ff->ff_rasector   = sector;
+      ff->ff_ransectors = nsectors;
+    }
+
+  /* Copy the sector from the read-ahead buffer into the file buffer */
+
+  ret = fat_ffcacheflush(fs, ff);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(ff->ff_buffer,
+         &ff->ff_rabuffer[(sector - ff->ff_rasector) * fs->fs_hwsectorsize],
+         fs->fs_hwsectorsize);
+
+  ff->ff_cachesector = sector;
+  ff->ff_bflags |= FFBUFF_VALID;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_ffcacheread
  *
@@ -1757,6 +2399,18 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
       return OK;
     }
 
+#ifdef CONFIG_FAT_FREEBITMAP
+  /* Building the free cluster bitmap also counts the free clusters and
+   * the count is kept up to date from then on.
+   */
+
+  if (fat_freemapbuild(fs) == OK)
+    {
+      *pfreeclusters = fs->fs_fsifreecount;
+      return OK;
+    }
+#endif
+
   /* Otherwise, we will have to count the number of free clusters */
 
   nfreeclusters = 0;
@@ -1782,6 +2436,7 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
       unsigned int cluster;
       off_t        fatsector;
       unsigned int offset;
+      uint8_t     *fatbuffer = NULL;
       int          ret;
 
       fatsector    = fs->fs_fatbase;
@@ -1791,11 +2446,13 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
 
       for (cluster = fs->fs_nclusters; cluster > 0; cluster--)
         {
-          /* If we are starting a new sector, then read the new sector in fs_buffer */
+          /* If we are starting a new sector, then read the new sector into
+           * the FAT cache
+           */
 
           if (offset >= fs->fs_hwsectorsize)
             {
-              ret = fat_fscacheread(fs, fatsector++);
+              ret = fat_fatcacheread(fs, fatsector, &fatbuffer);
               if (ret < 0)
                 {
                   return ret;
@@ -1815,7 +2472,7 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
 
           if (fs->fs_type == FSTYPE_FAT16)
             {
-              if (FAT_GETFAT16(fs->fs_buffer, offset) == 0)
+              if (FAT_GETFAT16(fatbuffer, offset) == 0)
                 {
                   nfreeclusters++;
                 }
@@ -1823,7 +2480,7 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
             }
           else
             {
-              if (FAT_GETFAT32(fs->fs_buffer, offset) == 0)
+              if (FAT_GETFAT32(fatbuffer, offset) == 0)
                 {
                   nfreeclusters++;
                 }
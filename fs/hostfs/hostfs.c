@@ -61,6 +61,14 @@
 
 #include "hostfs.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_HOSTFS_ATTRCACHE
+#  define HOSTFS_ATTRCACHE_TICKS MSEC2TICK(CONFIG_FS_HOSTFS_ATTRCACHE_TTL)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -244,6 +252,181 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+/****************************************************************************
+ * Name: hostfs_hostseek
+ *
+ * Description: Position the host file before a transfer.  The host
+ *   position is tracked so that sequential transfers need no seek.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+static int hostfs_hostseek(FAR struct hostfs_ofile_s *hf, off_t pos)
+{
+  if (hf->hostpos != pos)
+    {
+      if (host_lseek(hf->fd, pos, SEEK_SET) < 0)
+        {
+          hf->hostpos = -1;
+          return -EIO;
+        }
+
+      hf->hostpos = pos;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_flush
+ *
+ * Description: Write any data collected in the file buffer to the host.
+ *   The buffer then holds valid clean data.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+static int hostfs_flush(FAR struct hostfs_ofile_s *hf)
+{
+  ssize_t nwritten;
+  int ret;
+
+  if (!hf->dirty)
+    {
+      return OK;
+    }
+
+  ret = hostfs_hostseek(hf, hf->bufpos);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nwritten = host_write(hf->fd, hf->buffer, hf->buflen);
+  if (nwritten != (ssize_t)hf->buflen)
+    {
+      hf->hostpos = -1;
+      return -EIO;
+    }
+
+  hf->hostpos += nwritten;
+  hf->dirty    = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_flushall
+ *
+ * Description: Write the buffered data of all open files to the host so
+ *   that the host reports the correct file sizes.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+static void hostfs_flushall(FAR struct hostfs_mountpt_s *fs)
+{
+  FAR struct hostfs_ofile_s *hf;
+
+  for (hf = fs->fs_head; hf != NULL; hf = hf->fnext)
+    {
+      if (hf->buffer != NULL)
+        {
+          (void)hostfs_flush(hf);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_attrfind
+ *
+ * Description: Return the cached attributes of a host path if there is an
+ *   unexpired entry for it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_HOSTFS_ATTRCACHE
+static bool hostfs_attrfind(FAR struct hostfs_mountpt_s *fs,
+                            FAR const char *path, FAR struct stat *buf)
+{
+  FAR struct hostfs_attrcache_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE_NENTRIES; i++)
+    {
+      entry = &fs->fs_attrcache[i];
+      if (entry->path[0] != '\0' && strcmp(entry->path, path) == 0)
+        {
+          if ((systime_t)(clock_systimer() - entry->time) >=
+              HOSTFS_ATTRCACHE_TICKS)
+            {
+              /* The entry has expired */
+
+              entry->path[0] = '\0';
+              return false;
+            }
+
+          memcpy(buf, &entry->buf, sizeof(struct stat));
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_attradd
+ *
+ * Description: Save the attributes of a host path in the cache, replacing
+ *   the entries in round-robin order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_HOSTFS_ATTRCACHE
+static void hostfs_attradd(FAR struct hostfs_mountpt_s *fs,
+                           FAR const char *path, FAR const struct stat *buf)
+{
+  FAR struct hostfs_attrcache_s *entry;
+
+  entry = &fs->fs_attrcache[fs->fs_attrnext];
+  if (++fs->fs_attrnext >= CONFIG_FS_HOSTFS_ATTRCACHE_NENTRIES)
+    {
+      fs->fs_attrnext = 0;
+    }
+
+  entry->time = clock_systimer();
+  memcpy(&entry->buf, buf, sizeof(struct stat));
+  strncpy(entry->path, path, HOSTFS_MAX_PATH);
+  entry->path[HOSTFS_MAX_PATH - 1] = '\0';
+}
+#endif
+
+/****************************************************************************
+ * Name: hostfs_attrinvalidate
+ *
+ * Description: Discard all cached attributes.  Called whenever something
+ *   is modified through the mount:  The same host file may be reached by
+ *   several different paths, so all entries are discarded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_HOSTFS_ATTRCACHE
+static void hostfs_attrinvalidate(FAR struct hostfs_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTRCACHE_NENTRIES; i++)
+    {
+      fs->fs_attrcache[i].path[0] = '\0';
+    }
+}
+#else
+#  define hostfs_attrinvalidate(fs)
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -299,6 +482,35 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* Buffer the file unless the host file position cannot be tracked:  Each
+   * write to a file opened with O_APPEND moves to the end of the file and
+   * host files like FIFOs cannot seek at all.  The file can still be used
+   * (unbuffered) if the buffer cannot be allocated.
+   */
+
+  hf->buffer  = NULL;
+  hf->buflen  = 0;
+  hf->dirty   = false;
+
+  if ((oflags & O_APPEND) == 0)
+    {
+      hf->pos = host_lseek(hf->fd, 0, SEEK_CUR);
+      if (hf->pos >= 0)
+        {
+          hf->hostpos = hf->pos;
+          hf->buffer  = (FAR uint8_t *)kmm_malloc(CONFIG_FS_HOSTFS_BUFSIZE);
+        }
+    }
+#endif
+
+  /* Opening for write may create or truncate the file */
+
+  if ((oflags & (O_WROK | O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_attrinvalidate(fs);
+    }
+
   /* Attach the private date to the struct file instance */
 
   filep->f_priv = hf;
@@ -398,6 +610,16 @@ static int hostfs_close(FAR struct file *filep)
         }
     }
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* Write out any buffered data */
+
+  if (hf->buffer != NULL)
+    {
+      (void)hostfs_flush(hf);
+      kmm_free(hf->buffer);
+    }
+#endif
+
   /* Close the host file */
 
   host_close(hf->fd);
@@ -422,6 +644,11 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR struct hostfs_mountpt_s *fs;
   FAR struct hostfs_ofile_s *hf;
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  size_t nread;
+  size_t remaining;
+  ssize_t nbytes;
+#endif
   int ret = OK;
 
   /* Sanity checks */
@@ -440,10 +667,100 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      /* Write out any buffered data first.  The buffer then holds valid
+       * data that may satisfy the read.
+       */
+
+      ret = hostfs_flush(hf);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+
+      for (nread = 0; nread < buflen; )
+        {
+          remaining = buflen - nread;
+
+          /* Copy any part of the request that is in the buffer */
+
+          if (hf->pos >= hf->bufpos && hf->pos < hf->bufpos + hf->buflen)
+            {
+              nbytes = MIN(remaining, hf->bufpos + hf->buflen - hf->pos);
+              memcpy(buffer + nread, hf->buffer + (hf->pos - hf->bufpos),
+                     nbytes);
+
+              hf->pos += nbytes;
+              nread   += nbytes;
+              continue;
+            }
+
+          ret = hostfs_hostseek(hf, hf->pos);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          if (remaining >= CONFIG_FS_HOSTFS_BUFSIZE)
+            {
+              /* Large reads go directly to the user buffer */
+
+              nbytes = host_read(hf->fd, buffer + nread, remaining);
+              if (nbytes < 0)
+                {
+                  hf->hostpos = -1;
+                  ret = nbytes;
+                  break;
+                }
+
+              hf->hostpos += nbytes;
+              hf->pos     += nbytes;
+              nread       += nbytes;
+              break;
+            }
+
+          /* Small reads fill the whole buffer */
+
+          hf->buflen = 0;
+          nbytes = host_read(hf->fd, hf->buffer, CONFIG_FS_HOSTFS_BUFSIZE);
+          if (nbytes <= 0)
+            {
+              /* Error or end of file */
+
+              if (nbytes < 0)
+                {
+                  hf->hostpos = -1;
+                }
+
+              ret = nbytes;
+              break;
+            }
+
+          hf->hostpos += nbytes;
+          hf->bufpos   = hf->pos;
+          hf->buflen   = nbytes;
+        }
+
+      /* Return an error only if nothing was read */
+
+      if (nread > 0 || ret >= 0)
+        {
+          ret = nread;
+        }
+
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Call the host to perform the read */
 
   ret = host_read(hf->fd, buffer, buflen);
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+errout_with_semaphore:
+#endif
   hostfs_semgive(fs);
   return ret;
 }
@@ -498,6 +815,76 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
+  hostfs_attrinvalidate(fs);
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      if (buflen < CONFIG_FS_HOSTFS_BUFSIZE)
+        {
+          /* Collect small writes in the buffer.  The buffered data must be
+           * written out first if this write does not continue it or does
+           * not fit.
+           */
+
+          if (hf->dirty &&
+              (hf->pos != hf->bufpos + hf->buflen ||
+               hf->buflen + buflen > CONFIG_FS_HOSTFS_BUFSIZE))
+            {
+              ret = hostfs_flush(hf);
+              if (ret < 0)
+                {
+                  goto errout_with_semaphore;
+                }
+            }
+
+          /* Any clean data in the buffer is discarded */
+
+          if (!hf->dirty)
+            {
+              hf->bufpos = hf->pos;
+              hf->buflen = 0;
+              hf->dirty  = true;
+            }
+
+          memcpy(hf->buffer + hf->buflen, buffer, buflen);
+          hf->buflen += buflen;
+          hf->pos    += buflen;
+          ret         = buflen;
+          goto errout_with_semaphore;
+        }
+
+      /* The data bypasses the buffer.  Write out any buffered data first
+       * and discard the buffer contents which might become stale.
+       */
+
+      ret = hostfs_flush(hf);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+
+      hf->buflen = 0;
+
+      ret = hostfs_hostseek(hf, hf->pos);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+
+      ret = host_write(hf->fd, buffer, buflen);
+      if (ret < 0)
+        {
+          hf->hostpos = -1;
+          goto errout_with_semaphore;
+        }
+
+      hf->hostpos += ret;
+      hf->pos     += ret;
+      goto errout_with_semaphore;
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = host_write(hf->fd, buffer, buflen);
@@ -534,6 +921,51 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      /* The host file is positioned lazily by the next transfer.  Only
+       * the end of the file must be obtained from the host.
+       */
+
+      switch (whence)
+        {
+        case SEEK_SET:
+          ret = offset;
+          break;
+
+        case SEEK_CUR:
+          ret = hf->pos + offset;
+          break;
+
+        case SEEK_END:
+          ret = hostfs_flush(hf);
+          if (ret >= 0)
+            {
+              ret = host_lseek(hf->fd, offset, whence);
+              hf->hostpos = ret;
+            }
+          break;
+
+        default:
+          ret = -EINVAL;
+          break;
+        }
+
+      if (ret >= 0)
+        {
+          hf->pos = ret;
+        }
+      else if (whence != SEEK_END)
+        {
+          ret = -EINVAL;
+        }
+
+      hostfs_semgive(fs);
+      return ret;
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, offset, whence);
@@ -569,6 +1001,16 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* The ioctl may depend on the data or the position of the host file */
+
+  if (hf->buffer != NULL)
+    {
+      (void)hostfs_flush(hf);
+      (void)hostfs_hostseek(hf, hf->pos);
+    }
+#endif
+
   /* Call our internal routine to perform the ioctl */
 
   ret = host_ioctl(hf->fd, cmd, arg);
@@ -607,6 +1049,13 @@ static int hostfs_sync(FAR struct file *filep)
 
   hostfs_semtake(fs);
 
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  if (hf->buffer != NULL)
+    {
+      (void)hostfs_flush(hf);
+    }
+#endif
+
   host_sync(hf->fd);
 
   hostfs_semgive(fs);
@@ -983,6 +1432,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_attrinvalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1019,6 +1469,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_attrinvalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1056,6 +1507,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_attrinvalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1096,6 +1548,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_attrinvalidate(fs);
 
   hostfs_semgive(fs);
   return ret;
@@ -1129,10 +1582,33 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
 
+#ifdef CONFIG_FS_HOSTFS_ATTRCACHE
+  /* Check for recently cached attributes first */
+
+  if (hostfs_attrfind(fs, path, buf))
+    {
+      hostfs_semgive(fs);
+      return OK;
+    }
+#endif
+
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  /* The path may refer to an open file with buffered data */
+
+  hostfs_flushall(fs);
+#endif
+
   /* Call the host FS to do the stat operation */
 
   ret = host_stat(path, buf);
 
+#ifdef CONFIG_FS_HOSTFS_ATTRCACHE
+  if (ret == 0)
+    {
+      hostfs_attradd(fs, path, buf);
+    }
+#endif
+
   hostfs_semgive(fs);
   return ret;
 }
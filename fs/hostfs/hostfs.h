@@ -43,10 +43,13 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <semaphore.h>
 
+#include <nuttx/clock.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -63,6 +66,12 @@
 
 #define HOSTFS_MAX_PATH     256
 
+/* Size of the per-file read-ahead/write-behind buffer (zero: unbuffered) */
+
+#ifndef CONFIG_FS_HOSTFS_BUFSIZE
+#  define CONFIG_FS_HOSTFS_BUFSIZE 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -77,7 +86,28 @@ struct hostfs_ofile_s
   int16_t                   crefs;      /* Reference count */
   mode_t                    oflags;     /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BUFSIZE > 0
+  FAR uint8_t              *buffer;     /* Read-ahead/write-behind buffer */
+  off_t                     bufpos;     /* File position of the buffered data */
+  size_t                    buflen;     /* Number of bytes in the buffer */
+  bool                      dirty;      /* Buffer holds data not yet written */
+  off_t                     pos;        /* Current file position */
+  off_t                     hostpos;    /* Position of the host file (-1: unknown) */
+#endif
+};
+
+#ifdef CONFIG_FS_HOSTFS_ATTRCACHE
+/* One entry of the attribute cache:  The result of a recent host_stat().
+ * The entry is unused if the path is empty.
+ */
+
+struct hostfs_attrcache_s
+{
+  systime_t                 time;       /* Time when the entry was filled */
+  struct stat               buf;        /* The attributes of the file */
+  char                      path[HOSTFS_MAX_PATH];
 };
+#endif
 
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
@@ -89,6 +119,10 @@ struct hostfs_mountpt_s
   sem_t                      *fs_sem;       /* Used to assure thread-safe access */
   FAR struct hostfs_ofile_s  *fs_head;      /* A singly-linked list of open files */
   char                        fs_root[HOSTFS_MAX_PATH];
+#ifdef CONFIG_FS_HOSTFS_ATTRCACHE
+  uint8_t                     fs_attrnext;  /* Next attribute cache entry to replace */
+  struct hostfs_attrcache_s   fs_attrcache[CONFIG_FS_HOSTFS_ATTRCACHE_NENTRIES];
+#endif
 };
 
 /****************************************************************************
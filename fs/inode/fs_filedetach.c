@@ -128,8 +128,13 @@ int file_detach(int fd, FAR struct file *filep)
 
   /* If the file was properly opened, there should be an inode assigned */
 
+  parent = files_getfile(list, fd);
+  if (parent == NULL)
+    {
+      return -EBADF;
+    }
+
   _files_semtake(list);
-  parent = &list->fl_files[fd];
   if (parent->f_inode == NULL)
     {
       /* File is not open */
@@ -156,6 +161,7 @@ int file_detach(int fd, FAR struct file *filep)
   parent->f_pos    = 0;
   parent->f_inode  = NULL;
   parent->f_priv   = NULL;
+  files_clrinuse(list, fd);
 
   _files_semgive(list);
   return OK;
@@ -79,6 +79,38 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) sem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_extend
+ *
+ * Description:
+ *   Return the struct file of 'fd', allocating its block if necessary.
+ *
+ * Assumuptions:
+ *   Caller holds the list semaphore and 'fd' is in range.
+ *
+ ****************************************************************************/
+
+static FAR struct file *_files_extend(FAR struct filelist *list, int fd)
+{
+  int block = fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+
+  if (list->fl_blocks[block] == NULL)
+    {
+      /* The block is zeroed before it is made visible to lock-free
+       * readers in files_getfile().
+       */
+
+      list->fl_blocks[block] = (FAR struct file *)
+        kmm_zalloc(CONFIG_NFILE_DESCRIPTORS_PER_BLOCK * sizeof(struct file));
+      if (list->fl_blocks[block] == NULL)
+        {
+          return NULL;
+        }
+    }
+
+  return &list->fl_blocks[block][fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -149,6 +181,11 @@ void files_initlist(FAR struct filelist *list)
 {
   DEBUGASSERT(list);
 
+  /* No file descriptors are allocated yet */
+
+  memset(list->fl_inuse, 0, sizeof(list->fl_inuse));
+  memset(list->fl_blocks, 0, sizeof(list->fl_blocks));
+
   /* Initialize the list access mutex */
 
   (void)sem_init(&list->fl_sem, 0, 1);
@@ -164,6 +201,7 @@ void files_initlist(FAR struct filelist *list)
 
 void files_releaselist(FAR struct filelist *list)
 {
+  FAR struct file *filep;
   int i;
 
   DEBUGASSERT(list);
@@ -175,14 +213,90 @@ void files_releaselist(FAR struct filelist *list)
 
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
-      (void)_files_close(&list->fl_files[i]);
+      filep = files_getfile(list, i);
+      if (filep != NULL)
+        {
+          (void)_files_close(filep);
+        }
+    }
+
+  /* Free the blocks of files */
+
+  for (i = 0; i < FILELIST_NBLOCKS; i++)
+    {
+      if (list->fl_blocks[i] != NULL)
+        {
+          sched_kfree(list->fl_blocks[i]);
+          list->fl_blocks[i] = NULL;
+        }
     }
 
+  memset(list->fl_inuse, 0, sizeof(list->fl_inuse));
+
   /* Destroy the semaphore */
 
   (void)sem_destroy(&list->fl_sem);
 }
 
+/****************************************************************************
+ * Name: files_getfile
+ *
+ * Description:
+ *   Return the struct file instance of the file descriptor 'fd' in 'list'
+ *   or NULL if 'fd' is out of range or its block has not been allocated
+ *   (in which case the descriptor cannot be open).  This does not take the
+ *   list semaphore:  Blocks are never freed while the list is in use.
+ *
+ ****************************************************************************/
+
+FAR struct file *files_getfile(FAR struct filelist *list, int fd)
+{
+  FAR struct file *block;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  block = list->fl_blocks[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+  if (block == NULL)
+    {
+      return NULL;
+    }
+
+  return &block[fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+}
+
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Like files_getfile(), but allocate the block that holds the file
+ *   descriptor 'fd' if it does not yet exist.  NULL is returned if 'fd' is
+ *   out of range or if the block cannot be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct file *files_extend(FAR struct filelist *list, int fd)
+{
+  FAR struct file *filep;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  filep = files_getfile(list, fd);
+  if (filep == NULL)
+    {
+      _files_semtake(list);
+      filep = _files_extend(list, fd);
+      _files_semgive(list);
+    }
+
+  return filep;
+}
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -306,32 +420,74 @@ errout:
  *   Allocate a struct files instance and associate it with an inode instance.
  *   Returns the file descriptor == index into the files array.
  *
+ *   The lowest free descriptor is found with the fl_inuse bitmap, 32
+ *   descriptors at a time.  A descriptor made open by file_dup2() without
+ *   going through this function (dup2() or a new task inheriting its
+ *   parent's descriptors) may not be marked yet; it is marked when found
+ *   here.
+ *
  ****************************************************************************/
 
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
-  int i;
+  FAR struct file *filep;
+  uint32_t inuse;
+  int word;
+  int fd;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
 
   list = sched_getfiles();
   DEBUGASSERT(list != NULL);
 
+  if (minfd < 0)
+    {
+      minfd = 0;
+    }
+
   _files_semtake(list);
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  for (word = minfd >> 5; word < FILELIST_NWORDS; word++)
     {
-      if (!list->fl_files[i].f_inode)
+      /* Ignore the descriptors below minfd */
+
+      inuse = list->fl_inuse[word];
+      if (word == (minfd >> 5))
+        {
+          inuse |= FILES_INUSE_BIT(minfd) - 1;
+        }
+
+      for (fd = word << 5;
+           inuse != UINT32_MAX && fd < CONFIG_NFILE_DESCRIPTORS;
+           fd++)
         {
-           list->fl_files[i].f_oflags = oflags;
-           list->fl_files[i].f_pos    = pos;
-           list->fl_files[i].f_inode  = inode;
-           list->fl_files[i].f_priv   = NULL;
-           _files_semgive(list);
-           return i;
+          if ((inuse & FILES_INUSE_BIT(fd)) != 0)
+            {
+              continue;
+            }
+
+          inuse |= FILES_INUSE_BIT(fd);
+
+          filep = _files_extend(list, fd);
+          if (filep == NULL)
+            {
+              goto errout;
+            }
+
+          files_setinuse(list, fd);
+          if (filep->f_inode == NULL)
+            {
+              filep->f_oflags = oflags;
+              filep->f_pos    = pos;
+              filep->f_inode  = inode;
+              filep->f_priv   = NULL;
+              _files_semgive(list);
+              return fd;
+            }
         }
     }
 
+errout:
   _files_semgive(list);
   return ERROR;
 }
@@ -350,6 +506,7 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 int files_close(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file     *filep;
   int                  ret;
 
   /* Get the thread-specific file list.  It should never be NULL in this
@@ -361,7 +518,8 @@ int files_close(int fd)
 
   /* If the file was properly opened, there should be an inode assigned */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS || !list->fl_files[fd].f_inode)
+  filep = files_getfile(list, fd);
+  if (filep == NULL || !filep->f_inode)
     {
       return -EBADF;
     }
@@ -369,7 +527,8 @@ int files_close(int fd)
   /* Perform the protected close operation */
 
   _files_semtake(list);
-  ret = _files_close(&list->fl_files[fd]);
+  ret = _files_close(filep);
+  files_clrinuse(list, fd);
   _files_semgive(list);
   return ret;
 }
@@ -386,16 +545,19 @@ int files_close(int fd)
 void files_release(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
 
   list = sched_getfiles();
   DEBUGASSERT(list);
 
-  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS)
+  filep = files_getfile(list, fd);
+  if (filep != NULL)
     {
       _files_semtake(list);
-      list->fl_files[fd].f_oflags  = 0;
-      list->fl_files[fd].f_pos     = 0;
-      list->fl_files[fd].f_inode = NULL;
+      filep->f_oflags  = 0;
+      filep->f_pos     = 0;
+      filep->f_inode = NULL;
+      files_clrinuse(list, fd);
       _files_semgive(list);
     }
 }
@@ -166,8 +166,8 @@ static int foreach_inodelevel(FAR struct inode *node, struct inode_path_s *info)
  *   when the callback 'handler' returns a non-zero value, or when all of
  *   the inodes have been visited.
  *
- *   NOTE 1: Use with caution... The pseudo-file system is locked throughout
- *   the traversal.
+ *   NOTE 1: Use with caution... The pseudo-file system is locked (shared)
+ *   throughout the traversal.  The handler must not add or remove inodes.
  *   NOTE 2: The search algorithm is recursive and could, in principle, use
  *   an indeterminant amount of stack space.  This will not usually be a
  *   real work issue.
@@ -196,9 +196,9 @@ int foreach_inode(foreach_inode_t handler, FAR void *arg)
 
   /* Start the recursion at the root inode */
 
-  inode_semtake();
+  inode_rdtake();
   ret = foreach_inodelevel(g_root_inode, info);
-  inode_semgive();
+  inode_rdgive();
 
   /* Free the info structure and return the result */
 
@@ -217,9 +217,9 @@ int foreach_inode(foreach_inode_t handler, FAR void *arg)
 
   /* Start the recursion at the root inode */
 
-  inode_semtake();
+  inode_rdtake();
   ret = foreach_inodelevel(g_root_inode, &info);
-  inode_semgive();
+  inode_rdgive();
 
   return ret;
 
@@ -39,11 +39,15 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <string.h>
 #include <assert.h>
 #include <semaphore.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
@@ -52,26 +56,62 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define NO_HOLDER (pid_t)-1;
+#define NO_HOLDER ((pid_t)-1)
+
+#ifdef CONFIG_FS_INODECACHE
+#  ifndef CONFIG_FS_INODECACHE_NENTRIES
+#    define CONFIG_FS_INODECACHE_NENTRIES 16
+#  endif
+#  ifndef CONFIG_FS_INODECACHE_PATHLEN
+#    define CONFIG_FS_INODECACHE_PATHLEN 32
+#  endif
+#endif
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* Implements a re-entrant mutex for inode access.  This must be re-entrant
- * because there can be cycles.  For example, it may be necessary to destroy
- * a block driver inode on umount() after a removable block device has been
- * removed.  In that case umount() hold the inode semaphore, but the block
- * driver may callback to unregister_blockdriver() after the un-mount,
- * requiring the seamphore again.
+/* Implements a re-entrant reader-writer lock for inode access.  Any number
+ * of readers may search the tree at the same time, but a writer has
+ * exclusive access.  The writer side must be re-entrant because there can
+ * be cycles.  For example, it may be necessary to destroy a block driver
+ * inode on umount() after a removable block device has been removed.  In
+ * that case umount() hold the inode semaphore, but the block driver may
+ * callback to unregister_blockdriver() after the un-mount, requiring the
+ * seamphore again.
+ *
+ * The lock state is protected by a critical section.  Tasks that cannot get
+ * the lock wait on rdsem or wrsem and re-check when they are awakened.
+ * Readers are admitted whenever no writer holds the lock, even if a writer
+ * is waiting, so that a reader may safely nest read locks.
  */
 
 struct inode_sem_s
 {
-  sem_t   sem;     /* The semaphore */
-  pid_t   holder;  /* The current holder of the semaphore */
-  int16_t count;   /* Number of counts held */
+  sem_t   rdsem;   /* Readers wait here while a writer holds the lock */
+  sem_t   wrsem;   /* Writers wait here while the lock is held */
+  pid_t   holder;  /* The writer holding the lock */
+  int16_t count;   /* Number of counts held by the writer */
+  int16_t readers; /* Number of read locks held */
+  int16_t rdwait;  /* Number of readers waiting on rdsem */
+  int16_t wrwait;  /* Number of writers waiting on wrsem */
+};
+
+/* One entry in the path lookup cache.  An entry is valid only if it was
+ * filled in the current generation of the inode tree.
+ */
+
+#ifdef CONFIG_FS_INODECACHE
+struct inode_cache_s
+{
+  FAR struct inode *node;    /* The inode found */
+  FAR struct inode *peer;    /* The peer to its left (may be NULL) */
+  FAR struct inode *parent;  /* Its parent (may be NULL) */
+  uint32_t gen;              /* Tree generation of this entry */
+  uint16_t end;              /* Offset to the returned (empty) path remainder */
+  char path[CONFIG_FS_INODECACHE_PATHLEN];
 };
+#endif
 
 /****************************************************************************
  * Private Data
@@ -79,6 +119,11 @@ struct inode_sem_s
 
 static struct inode_sem_s g_inode_sem;
 
+#ifdef CONFIG_FS_INODECACHE
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODECACHE_NENTRIES];
+static uint32_t g_inode_gen = 1;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -167,128 +212,60 @@ static int _inode_compare(FAR const char *fname,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: inode_initialize
+ * Name: _inode_semwait
  *
  * Description:
- *   This is called from the OS initialization logic to configure the file
- *   system.
+ *   Wait on one of the inode lock semaphores.
  *
  ****************************************************************************/
 
-void inode_initialize(void)
+static void _inode_semwait(FAR sem_t *sem)
 {
-  /* Initialize the semaphore to one (to support one-at-a-time access to the
-   * inode tree).
-   */
-
-  (void)sem_init(&g_inode_sem.sem, 0, 1);
-  g_inode_sem.holder = NO_HOLDER;
-  g_inode_sem.count  = 0;
-
-  /* Initialize files array (if it is used) */
-
-#ifdef CONFIG_HAVE_WEAKFUNCTIONS
-  if (files_initialize != NULL)
-#endif
+  while (sem_wait(sem) != 0)
     {
-      files_initialize();
-    }
-}
-
-/****************************************************************************
- * Name: inode_semtake
- *
- * Description:
- *   Get exclusive access to the in-memory inode tree (g_inode_sem).
- *
- ****************************************************************************/
-
-void inode_semtake(void)
-{
-  pid_t me;
-
-  /* Do we already hold the semaphore? */
-
-  me = getpid();
-  if (me == g_inode_sem.holder)
-    {
-      /* Yes... just increment the count */
-
-      g_inode_sem.count++;
-      DEBUGASSERT(g_inode_sem.count > 0);
-    }
-
-  /* Take the semaphore (perhaps waiting) */
-
-  else
-    {
-      while (sem_wait(&g_inode_sem.sem) != 0)
-        {
-          /* The only case that an error should occr here is if
-           * the wait was awakened by a signal.
-           */
-
-          ASSERT(get_errno() == EINTR);
-        }
-
-      /* No we hold the semaphore */
+      /* The only case that an error should occr here is if
+       * the wait was awakened by a signal.
+       */
 
-      g_inode_sem.holder = me;
-      g_inode_sem.count  = 1;
+      ASSERT(get_errno() == EINTR);
     }
 }
 
 /****************************************************************************
- * Name: inode_semgive
+ * Name: _inode_wakeup
  *
  * Description:
- *   Relinquish exclusive access to the in-memory inode tree (g_inode_sem).
+ *   Wake up all of the tasks waiting for the inode lock so that they can
+ *   try again.  Called from within a critical section.
  *
  ****************************************************************************/
 
-void inode_semgive(void)
+static void _inode_wakeup(void)
 {
-  DEBUGASSERT(g_inode_sem.holder == getpid());
-
-  /* Is this our last count on the semaphore? */
-
-  if (g_inode_sem.count > 1)
+  for (; g_inode_sem.rdwait > 0; g_inode_sem.rdwait--)
     {
-      /* No.. just decrement the count */
-
-      g_inode_sem.count--;
+      sem_post(&g_inode_sem.rdsem);
     }
 
-  /* Yes.. then we can really release the semaphore */
-
-  else
+  for (; g_inode_sem.wrwait > 0; g_inode_sem.wrwait--)
     {
-      g_inode_sem.holder = NO_HOLDER;
-      g_inode_sem.count  = 0;
-      sem_post(&g_inode_sem.sem);
+      sem_post(&g_inode_sem.wrsem);
     }
 }
 
 /****************************************************************************
- * Name: inode_search
+ * Name: _inode_walk
  *
  * Description:
- *   Find the inode associated with 'path' returning the inode references
- *   and references to its companion nodes.
- *
- * Assumptions:
- *   The caller holds the g_inode_sem semaphore
+ *   Walk the inode tree to find the inode associated with 'path'.  This is
+ *   the uncached part of inode_search().
  *
  ****************************************************************************/
 
-FAR struct inode *inode_search(FAR const char **path,
-                               FAR struct inode **peer,
-                               FAR struct inode **parent,
-                               FAR const char **relpath)
+static FAR struct inode *_inode_walk(FAR const char **path,
+                                     FAR struct inode **peer,
+                                     FAR struct inode **parent,
+                                     FAR const char **relpath)
 {
   FAR const char   *name  = *path + 1; /* Skip over leading '/' */
   FAR struct inode *node  = g_root_inode;
@@ -387,6 +364,357 @@ FAR struct inode *inode_search(FAR const char **path,
   return node;
 }
 
+/****************************************************************************
+ * Name: _inode_hash
+ *
+ * Description:
+ *   Hash a path for the lookup cache (FNV-1a).  Returns the length of the
+ *   path in 'len'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODECACHE
+static unsigned int _inode_hash(FAR const char *path, FAR size_t *len)
+{
+  FAR const char *ptr;
+  uint32_t hash = 2166136261u;
+
+  for (ptr = path; *ptr != '\0'; ptr++)
+    {
+      hash = (hash ^ (uint8_t)*ptr) * 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash % CONFIG_FS_INODECACHE_NENTRIES;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_initialize
+ *
+ * Description:
+ *   This is called from the OS initialization logic to configure the file
+ *   system.
+ *
+ ****************************************************************************/
+
+void inode_initialize(void)
+{
+  /* Initialize the lock.  The wait semaphores start at zero; they are only
+   * posted to wake up waiting tasks.
+   */
+
+  (void)sem_init(&g_inode_sem.rdsem, 0, 0);
+  (void)sem_init(&g_inode_sem.wrsem, 0, 0);
+#ifdef CONFIG_SCHED_LOCKSTAT
+  (void)sem_setname(&g_inode_sem.rdsem, "inode_rd");
+  (void)sem_setname(&g_inode_sem.wrsem, "inode_wr");
+#endif
+  g_inode_sem.holder  = NO_HOLDER;
+  g_inode_sem.count   = 0;
+  g_inode_sem.readers = 0;
+  g_inode_sem.rdwait  = 0;
+  g_inode_sem.wrwait  = 0;
+
+  /* Initialize files array (if it is used) */
+
+#ifdef CONFIG_HAVE_WEAKFUNCTIONS
+  if (files_initialize != NULL)
+#endif
+    {
+      files_initialize();
+    }
+}
+
+/****************************************************************************
+ * Name: inode_semtake
+ *
+ * Description:
+ *   Get exclusive access to the in-memory inode tree (g_inode_sem).
+ *
+ ****************************************************************************/
+
+void inode_semtake(void)
+{
+  irqstate_t flags;
+  pid_t me = getpid();
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+
+      /* Do we already hold the lock? */
+
+      if (me == g_inode_sem.holder)
+        {
+          /* Yes... just increment the count */
+
+          g_inode_sem.count++;
+          DEBUGASSERT(g_inode_sem.count > 0);
+          break;
+        }
+
+      /* Is the lock free of both the writer and all readers? */
+
+      if (g_inode_sem.holder == NO_HOLDER && g_inode_sem.readers == 0)
+        {
+          /* Yes.. now we hold the lock */
+
+          g_inode_sem.holder = me;
+          g_inode_sem.count  = 1;
+          break;
+        }
+
+      /* No.. wait until the lock is released and try again */
+
+      g_inode_sem.wrwait++;
+      leave_critical_section(flags);
+      _inode_semwait(&g_inode_sem.wrsem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_semgive
+ *
+ * Description:
+ *   Relinquish exclusive access to the in-memory inode tree (g_inode_sem).
+ *
+ ****************************************************************************/
+
+void inode_semgive(void)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(g_inode_sem.holder == getpid());
+
+  flags = enter_critical_section();
+
+  /* Is this our last count on the lock? */
+
+  if (g_inode_sem.count > 1)
+    {
+      /* No.. just decrement the count */
+
+      g_inode_sem.count--;
+    }
+
+  /* Yes.. then we can really release the lock */
+
+  else
+    {
+      g_inode_sem.holder = NO_HOLDER;
+      g_inode_sem.count  = 0;
+      _inode_wakeup();
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_rdtake
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (g_inode_sem).  Any
+ *   number of tasks may hold shared access at the same time, but not while
+ *   another task holds exclusive access.  A task that already holds
+ *   exclusive access just takes another count on it.
+ *
+ ****************************************************************************/
+
+void inode_rdtake(void)
+{
+  irqstate_t flags;
+  pid_t me = getpid();
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+
+      /* Do we hold exclusive access? */
+
+      if (me == g_inode_sem.holder)
+        {
+          g_inode_sem.count++;
+          DEBUGASSERT(g_inode_sem.count > 0);
+          break;
+        }
+
+      /* Is there no writer? */
+
+      if (g_inode_sem.holder == NO_HOLDER)
+        {
+          g_inode_sem.readers++;
+          DEBUGASSERT(g_inode_sem.readers > 0);
+          break;
+        }
+
+      /* No.. wait for the writer to release the lock and try again */
+
+      g_inode_sem.rdwait++;
+      leave_critical_section(flags);
+      _inode_semwait(&g_inode_sem.rdsem);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_rdgive
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (g_inode_sem).
+ *
+ ****************************************************************************/
+
+void inode_rdgive(void)
+{
+  irqstate_t flags;
+
+  if (g_inode_sem.holder == getpid())
+    {
+      /* The read lock was nested within exclusive access */
+
+      inode_semgive();
+      return;
+    }
+
+  flags = enter_critical_section();
+  DEBUGASSERT(g_inode_sem.readers > 0);
+
+  /* Wake up any waiting writer when the last reader leaves */
+
+  if (--g_inode_sem.readers == 0)
+    {
+      _inode_wakeup();
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: inode_search
+ *
+ * Description:
+ *   Find the inode associated with 'path' returning the inode references
+ *   and references to its companion nodes.
+ *
+ * Assumptions:
+ *   The caller holds either shared or exclusive access to the g_inode_sem
+ *   semaphore
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_search(FAR const char **path,
+                               FAR struct inode **peer,
+                               FAR struct inode **parent,
+                               FAR const char **relpath)
+{
+#ifdef CONFIG_FS_INODECACHE
+  FAR struct inode_cache_s *entry;
+  FAR struct inode *node;
+  FAR struct inode *left;
+  FAR struct inode *above;
+  FAR const char *start = *path;
+  irqstate_t flags;
+  size_t len;
+
+  /* Is the result of this lookup already in the cache?  Several readers
+   * may search the tree at once, so the cache entries are accessed within
+   * a critical section.
+   */
+
+  entry = &g_inode_cache[_inode_hash(start, &len)];
+  flags = enter_critical_section();
+  if (len < CONFIG_FS_INODECACHE_PATHLEN && entry->gen == g_inode_gen &&
+      strcmp(entry->path, start) == 0)
+    {
+      node  = entry->node;
+      left  = entry->peer;
+      above = entry->parent;
+      *path = start + entry->end;
+      leave_critical_section(flags);
+
+      if (relpath)
+        {
+          *relpath = *path;
+        }
+
+      goto found;
+    }
+
+  leave_critical_section(flags);
+
+  /* No.. walk the tree */
+
+  node = _inode_walk(path, &left, &above, relpath);
+
+  /* Only cache lookups that consumed the whole path.  Paths into a mounted
+   * volume would just push the device nodes out of the cache.
+   */
+
+  if (node != NULL && **path == '\0' &&
+      len < CONFIG_FS_INODECACHE_PATHLEN)
+    {
+      flags         = enter_critical_section();
+      entry->node   = node;
+      entry->peer   = left;
+      entry->parent = above;
+      entry->gen    = g_inode_gen;
+      entry->end    = *path - start;
+      strcpy(entry->path, start);
+      leave_critical_section(flags);
+    }
+
+found:
+  if (peer)
+    {
+      *peer = left;
+    }
+
+  if (parent)
+    {
+      *parent = above;
+    }
+
+  return node;
+#else
+  return _inode_walk(path, peer, parent, relpath);
+#endif
+}
+
+/****************************************************************************
+ * Name: inode_invalidate
+ *
+ * Description:
+ *   Discard the inode path lookup cache.  Must be called whenever the shape
+ *   of the inode tree changes.
+ *
+ * Assumptions:
+ *   The caller holds exclusive access to the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODECACHE
+void inode_invalidate(void)
+{
+  /* Advancing the generation invalidates every entry at once.  Clear the
+   * table when the generation wraps so that no ancient entry can match.
+   */
+
+  if (++g_inode_gen == 0)
+    {
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_gen = 1;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: inode_free
  *
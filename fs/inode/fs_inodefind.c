@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <errno.h>
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
@@ -60,6 +61,7 @@
 FAR struct inode *inode_find(FAR const char *path, FAR const char **relpath)
 {
   FAR struct inode *node;
+  irqstate_t flags;
 
   if (path == NULL || path[0] == '\0' || path[0] != '/')
     {
@@ -67,17 +69,20 @@ FAR struct inode *inode_find(FAR const char *path, FAR const char **relpath)
     }
 
   /* Find the node matching the path.  If found, increment the count of
-   * references on the node.
+   * references on the node.  Only shared access to the tree is needed, but
+   * other readers may be updating the reference count at the same time.
    */
 
-  inode_semtake();
+  inode_rdtake();
   node = inode_search(&path, (FAR struct inode**)NULL, (FAR struct inode**)NULL, relpath);
   if (node)
     {
+      flags = enter_critical_section();
       node->i_crefs++;
+      leave_critical_section(flags);
     }
 
-  inode_semgive();
+  inode_rdgive();
   return node;
 }
 
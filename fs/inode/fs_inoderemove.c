@@ -108,6 +108,7 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+      inode_invalidate();
     }
 
   return node;
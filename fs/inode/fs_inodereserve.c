@@ -131,6 +131,8 @@ static void inode_insert(FAR struct inode *node,
       node->i_peer = g_root_inode;
       g_root_inode = node;
     }
+
+  inode_invalidate();
 }
 
 /****************************************************************************
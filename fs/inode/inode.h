@@ -49,6 +49,22 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/compiler.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Mark the file descriptor 'fd' of 'list' as allocated or as free in the
+ * free descriptor bitmap.  The caller holds the list semaphore.
+ */
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+#  define FILES_INUSE_BIT(fd) ((uint32_t)1 << ((fd) & 31))
+#  define files_setinuse(list,fd) \
+     ((list)->fl_inuse[(fd) >> 5] |= FILES_INUSE_BIT(fd))
+#  define files_clrinuse(list,fd) \
+     ((list)->fl_inuse[(fd) >> 5] &= ~FILES_INUSE_BIT(fd))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -111,6 +127,28 @@ void inode_semtake(void);
 
 void inode_semgive(void);
 
+/****************************************************************************
+ * Name: inode_rdtake
+ *
+ * Description:
+ *   Get shared access to the in-memory inode tree (tree_sem) for searching
+ *   or traversing it without modifying it.  A task holding shared access
+ *   must not request exclusive access with inode_semtake().
+ *
+ ****************************************************************************/
+
+void inode_rdtake(void);
+
+/****************************************************************************
+ * Name: inode_rdgive
+ *
+ * Description:
+ *   Relinquish shared access to the in-memory inode tree (tree_sem).
+ *
+ ****************************************************************************/
+
+void inode_rdgive(void);
+
 /****************************************************************************
  * Name: inode_search
  *
@@ -119,7 +157,7 @@ void inode_semgive(void);
  *   and references to its companion nodes.
  *
  * Assumptions:
- *   The caller holds the tree_sem
+ *   The caller holds the tree_sem, shared or exclusive
  *
  ****************************************************************************/
 
@@ -138,6 +176,24 @@ FAR struct inode *inode_search(FAR const char **path,
 
 void inode_free(FAR struct inode *node);
 
+/****************************************************************************
+ * Name: inode_invalidate
+ *
+ * Description:
+ *   Discard the inode path lookup cache.  Must be called whenever the shape
+ *   of the inode tree changes.
+ *
+ * Assumptions:
+ *   The caller holds the tree_sem
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODECACHE
+void inode_invalidate(void);
+#else
+#  define inode_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_nextname
  *
@@ -244,8 +300,8 @@ void inode_release(FAR struct inode *inode);
  *   when the callback 'handler' returns a non-zero value, or when all of
  *   the inodes have been visited.
  *
- *   NOTE 1: Use with caution... The pseudo-file system is locked throughout
- *   the traversal.
+ *   NOTE 1: Use with caution... The pseudo-file system is locked (shared)
+ *   throughout the traversal.  The handler must not add or remove inodes.
  *   NOTE 2: The search algorithm is recursive and could, in principle, use
  *   an indeterminant amount of stack space.  This will not usually be a
  *   real work issue.
@@ -299,6 +355,35 @@ int files_close(int fd);
 
 void files_release(int fd);
 
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read from a file through the VFS page cache.  Returns -ENOSYS if the
+ *   file cannot be cached.  Defined in fs/vfs/fs_pagecache.c.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PAGECACHE
+ssize_t pagecache_read(FAR struct file *filep, FAR char *buffer,
+                       size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Discard the cached pages of the file 'filep' or, if 'filep' is NULL,
+ *   all cached pages of the mountpoint.  Defined in fs/vfs/fs_pagecache.c.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PAGECACHE
+void pagecache_invalidate(FAR struct inode *mountpt, FAR struct file *filep);
+#else
+#  define pagecache_invalidate(m,f)
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,147 @@
+/****************************************************************************
+ * fs/mmap/fs_msync.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msync
+ *
+ * Description:
+ *   Write the changes made to a memory mapped file back to the file.  Only
+ *   files mapped by the CONFIG_FS_RAMMAP emulation with PROT_WRITE (and
+ *   opened for writing) are affected.  The in-memory image is always
+ *   current, so msync() of other mappings does nothing.
+ *
+ * Parameters:
+ *   addr   The start of the range to be written back.  Must lie within a
+ *          region returned by mmap().
+ *   len    The length of the range.  The range is clipped to the end of
+ *          the region.
+ *   flags  MS_SYNC or MS_ASYNC, optionally with MS_INVALIDATE.  With
+ *          MS_SYNC, the file is also flushed to the media.  MS_ASYNC is
+ *          treated as MS_SYNC except that the media is not flushed.
+ *          MS_INVALIDATE is ignored since there is only one copy of the
+ *          mapped data.
+ *
+ * Returned Value:
+ *   On success, msync() returns 0, on failure -1, and errno is set.
+ *
+ *     EINVAL
+ *       Both MS_SYNC and MS_ASYNC are set.
+ *     EIO
+ *       The data could not be written to the file.
+ *
+ ****************************************************************************/
+
+int msync(FAR void *addr, size_t len, int flags)
+{
+  FAR struct fs_rammap_s *map;
+  size_t offset;
+  int errcode;
+  int ret;
+
+  if ((flags & (MS_SYNC | MS_ASYNC)) == (MS_SYNC | MS_ASYNC))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  rammap_initialize();
+  ret = sem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      return ERROR;
+    }
+
+  map = rammap_find(addr, NULL);
+  if (map == NULL)
+    {
+      /* Mappings of XIP media are the media itself */
+
+      sem_post(&g_rammaps.exclsem);
+      return OK;
+    }
+
+  offset = (FAR uint8_t *)addr - (FAR uint8_t *)map->addr;
+  if (len > map->length - offset)
+    {
+      len = map->length - offset;
+    }
+
+  ret = rammap_writeback(map, offset, len);
+  if (ret >= 0 && map->writeback && (flags & MS_SYNC) != 0)
+    {
+      ret = file_fsync(&map->file);
+      if (ret < 0)
+        {
+          ret = -get_errno();
+        }
+    }
+
+  sem_post(&g_rammaps.exclsem);
+
+  if (ret < 0)
+    {
+      errcode = -ret;
+      set_errno(errcode);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_FS_RAMMAP */
@@ -93,7 +93,10 @@
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
  *      into RAM.  munmap() is required in this case to free the allocated
- *      memory holding the shared copy of the file.
+ *      memory holding the shared copy of the file.  If the file was mapped
+ *      for writing, the unmapped part of the region is first written back
+ *      to the file.  A region shared by several mappings is freed when the
+ *      last of them is removed.
  *
  * Parameters:
  *   start   The start address of the mapping to delete.  For this
@@ -126,18 +129,9 @@ int munmap(FAR void *start, size_t length)
       return ERROR;
     }
 
-  /* Seach the list of regions */
+  /* Find the region containing the start address */
 
-  for (prev = NULL, curr = g_rammaps.head; curr; prev = curr, curr = curr->flink)
-    {
-      /* Does this region include any part of the specified range? */
-
-      if ((uintptr_t)start < (uintptr_t)curr->addr + curr->length &&
-          (uintptr_t)start + length >= (uintptr_t)curr->addr)
-        {
-          break;
-        }
-    }
+  curr = rammap_find(start, &prev);
 
   /* Did we find the region */
 
@@ -148,6 +142,17 @@ int munmap(FAR void *start, size_t length)
       goto errout_with_semaphore;
     }
 
+  /* If the region is shared with other mappings, just drop this reference.
+   * The region persists until the last mapping is removed.
+   */
+
+  if (curr->crefs > 1)
+    {
+      curr->crefs--;
+      sem_post(&g_rammaps.exclsem);
+      return OK;
+    }
+
   /* Get the offset from the beginning of the region and the actual number
    * of bytes to "unmap".  All mappings must extend to the end of the region.
    * There is no support for free a block of memory but leaving a block of
@@ -155,7 +160,7 @@ int munmap(FAR void *start, size_t length)
    * simulate the unmapping.
    */
 
-  offset = start - curr->addr;
+  offset = (FAR uint8_t *)start - (FAR uint8_t *)curr->addr;
   if (offset + length < curr->length)
     {
       ferr("ERROR: Cannot umap without unmapping to the end\n");
@@ -169,9 +174,18 @@ int munmap(FAR void *start, size_t length)
 
   length = curr->length - offset;
 
+  /* Write back the part of the region being removed */
+
+  ret = rammap_writeback(curr, offset, length);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_semaphore;
+    }
+
   /* Are we unmapping the entire region (offset == 0)? */
 
-  if (length >= curr->length)
+  if (offset == 0)
     {
       /* Yes.. remove the mapping from the list */
 
@@ -184,20 +198,28 @@ int munmap(FAR void *start, size_t length)
           g_rammaps.head = curr->flink;
         }
 
+      /* Release the reference to the file */
+
+      if (curr->file.f_inode != NULL)
+        {
+          (void)file_close_detached(&curr->file);
+        }
+
       /* Then free the region */
 
       kumm_free(curr);
     }
 
   /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
+   * (offset > 0).  Keep the first 'offset' bytes of the region.
    */
 
   else
     {
-      newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
-      curr->length = length;
+      newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + offset);
+      DEBUGASSERT(newaddr == (FAR void *)curr);
+      UNUSED(newaddr);
+      curr->length = offset;
     }
 
   sem_post(&g_rammaps.exclsem);
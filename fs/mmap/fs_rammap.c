@@ -43,6 +43,7 @@
 #include <sys/mman.h>
 
 #include <string.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
 #include <debug.h>
@@ -100,6 +101,8 @@ void rammap_initialize(void)
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    The requested protection.  With PROT_WRITE, changes are written
+ *           back to the file if it was opened for writing.
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
@@ -114,29 +117,54 @@ void rammap_initialize(void)
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset)
+FAR void *rammap(int fd, size_t length, off_t offset, int prot)
 {
   FAR struct fs_rammap_s *map;
+  FAR struct file *filep;
   FAR uint8_t *alloc;
   FAR uint8_t *rdbuffer;
   ssize_t nread;
-  off_t fpos;
+  size_t remaining;
+  bool writeback;
   int errcode;
   int ret;
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+  filep = fs_getfilep(fd);
+  if (filep == NULL)
+    {
+      /* errno has already been set */
+
+      return MAP_FAILED;
+    }
+
+  writeback = (prot & PROT_WRITE) != 0 && (filep->f_oflags & O_WROK) != 0;
+
+  rammap_initialize();
+  ret = sem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      return MAP_FAILED;
+    }
+
+  /* Different file descriptors opened on the same file are recognized by
+   * the inode.  If this part of the file is already mapped in the same
+   * way, then share that region.
    */
 
+  for (map = g_rammaps.head; map != NULL; map = map->flink)
+    {
+      if (map->file.f_inode == filep->f_inode &&
+          map->writeback == writeback &&
+          offset >= map->offset &&
+          offset + length <= map->offset + map->length &&
+          map->crefs < UINT16_MAX)
+        {
+          map->crefs++;
+          sem_post(&g_rammaps.exclsem);
+          return (FAR uint8_t *)map->addr + (offset - map->offset);
+        }
+    }
+
   /* Allocate a region of memory of the specified size */
 
   alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
@@ -144,7 +172,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
     {
       ferr("ERROR: Region allocation failed, length: %d\n", (int)length);
       errcode = ENOMEM;
-      goto errout;
+      goto errout_with_semaphore;
     }
 
   /* Initialize the region */
@@ -154,27 +182,33 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   map->addr   = alloc + sizeof(struct fs_rammap_s);
   map->length = length;
   map->offset = offset;
+  map->crefs  = 1;
 
-  /* Seek to the specified file offset */
+  /* Keep a reference to the file.  This is what allows the region to be
+   * shared and written back after the caller closes the file descriptor.
+   * If the file system cannot duplicate the open file, the region is
+   * private and read-only as before.
+   */
 
-  fpos = lseek(fd, offset,  SEEK_SET);
-  if (fpos == (off_t)-1)
+  if (file_dup2(filep, &map->file) == OK)
     {
-      /* Seek failed... errno has already been set, but EINVAL is probably
-       * the correct response.
-       */
-
-      ferr("ERROR: Seek to position %d failed\n", (int)offset);
-      errcode = EINVAL;
-      goto errout_with_region;
+      map->writeback = writeback;
+    }
+  else
+    {
+      memset(&map->file, 0, sizeof(struct file));
     }
 
-  /* Read the file data into the memory region */
+  /* Read the file data into the memory region.  The file position of the
+   * caller's file descriptor is not changed.
+   */
 
-  rdbuffer = map->addr;
-  while (length > 0)
+  rdbuffer  = map->addr;
+  remaining = length;
+  while (remaining > 0)
     {
-      nread = read(fd, rdbuffer, length);
+      nread = file_pread(filep, rdbuffer, remaining,
+                         offset + (rdbuffer - (FAR uint8_t *)map->addr));
       if (nread < 0)
         {
           /* Handle the special case where the read was interrupted by a
@@ -184,20 +218,16 @@ FAR void *rammap(int fd, size_t length, off_t offset)
           errcode = get_errno();
           if (errcode != EINTR)
             {
-              /* All other read errors are bad.  errno is already set.
-               * (but maybe should be forced to EINVAL?).  NOTE that if
-               * FS DEBUG is enabled, then the following ferr() macro will
-               * destroy the errno value.
+              /* All other read errors are bad.  A seek beyond the end of
+               * the file means that the offset is invalid.
                */
 
               ferr("ERROR: Read failed: offset=%d errno=%d\n",
                    (int)offset, errcode);
-#ifdef CONFIG_DEBUG_FS
               goto errout_with_region;
-#else
-              goto errout_with_errno;
-#endif
-             }
+            }
+
+          continue;
         }
 
       /* Check for end of file. */
@@ -209,38 +239,114 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
       /* Increment number of bytes read */
 
-      rdbuffer += nread;
-      length   -= nread;
+      rdbuffer  += nread;
+      remaining -= nread;
     }
 
   /* Zero any memory beyond the amount read from the file */
 
-  memset(rdbuffer, 0, length);
+  memset(rdbuffer, 0, remaining);
 
   /* Add the buffer to the list of regions */
 
-  rammap_initialize();
-  ret = sem_wait(&g_rammaps.exclsem);
-  if (ret < 0)
-    {
-      goto errout_with_errno;
-    }
-
-  map->flink  = g_rammaps.head;
+  map->flink     = g_rammaps.head;
   g_rammaps.head = map;
 
   sem_post(&g_rammaps.exclsem);
   return map->addr;
 
 errout_with_region:
+  if (map->file.f_inode != NULL)
+    {
+      (void)file_close_detached(&map->file);
+    }
+
   kumm_free(alloc);
-errout:
+
+errout_with_semaphore:
+  sem_post(&g_rammaps.exclsem);
   set_errno(errcode);
   return MAP_FAILED;
+}
 
-errout_with_errno:
-  kumm_free(alloc);
-  return MAP_FAILED;
+/****************************************************************************
+ * Name: rammap_find
+ *
+ * Description:
+ *   Find the region that contains the address.  The caller must hold
+ *   g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+FAR struct fs_rammap_s *rammap_find(FAR const void *addr,
+                                    FAR struct fs_rammap_s **prev)
+{
+  FAR struct fs_rammap_s *last = NULL;
+  FAR struct fs_rammap_s *curr;
+
+  for (curr = g_rammaps.head; curr; last = curr, curr = curr->flink)
+    {
+      if ((uintptr_t)addr >= (uintptr_t)curr->addr &&
+          (uintptr_t)addr < (uintptr_t)curr->addr + curr->length)
+        {
+          break;
+        }
+    }
+
+  if (prev != NULL)
+    {
+      *prev = last;
+    }
+
+  return curr;
+}
+
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of a region back to the file.  Does nothing if the region
+ *   is not write-back.  The caller must hold g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t offset,
+                     size_t length)
+{
+  FAR const uint8_t *wrbuffer;
+  ssize_t nwritten;
+  int errcode;
+
+  if (!map->writeback)
+    {
+      return OK;
+    }
+
+  DEBUGASSERT(offset + length <= map->length);
+
+  wrbuffer = (FAR const uint8_t *)map->addr + offset;
+  while (length > 0)
+    {
+      nwritten = file_pwrite(&map->file, wrbuffer, length,
+                             map->offset + offset);
+      if (nwritten < 0)
+        {
+          errcode = get_errno();
+          if (errcode != EINTR)
+            {
+              ferr("ERROR: Write back failed: errno=%d\n", errcode);
+              return -errcode;
+            }
+
+          continue;
+        }
+
+      wrbuffer += nwritten;
+      offset   += nwritten;
+      length   -= nwritten;
+    }
+
+  return OK;
 }
 
 #endif /* CONFIG_FS_RAMMAP */
@@ -45,8 +45,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
+#include <nuttx/fs/fs.h>
+
 #ifdef CONFIG_FS_RAMMAP
 
 /****************************************************************************
@@ -65,9 +68,14 @@
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - Changes to the in-memory image are written back to the file only by
+ *   msync() and munmap(), and only if the file was opened for writing and
+ *   mapped with PROT_WRITE.
  * - There are not access privileges.
+ *
+ * A detached copy of the open file is kept with the region.  It identifies
+ * the file so that further mappings of the same part of the same file share
+ * the region, and it is used to write the region back.
  */
 
 struct fs_rammap_s
@@ -76,6 +84,9 @@ struct fs_rammap_s
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
   off_t               offset;      /* File offset */
+  uint16_t            crefs;       /* Number of mmap() references to the region */
+  bool                writeback;   /* True: Write changes back to the file */
+  struct file         file;        /* Detached reference to the file (may be unused) */
 };
 
 /* This structure defines all "mapped" files */
@@ -126,6 +137,8 @@ void rammap_initialize(void);
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    The requested protection.  With PROT_WRITE, changes are written
+ *           back to the file if it was opened for writing.
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
@@ -140,7 +153,47 @@ void rammap_initialize(void);
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset);
+FAR void *rammap(int fd, size_t length, off_t offset, int prot);
+
+/****************************************************************************
+ * Name: rammap_find
+ *
+ * Description:
+ *   Find the region that contains the address.  The caller must hold
+ *   g_rammaps.exclsem.
+ *
+ * Input Parameters:
+ *   addr  - The address within the region
+ *   prev  - The location to return the previous region in the list (may be
+ *           NULL)
+ *
+ * Returned Value:
+ *   The region or NULL if the address is not mapped.
+ *
+ ****************************************************************************/
+
+FAR struct fs_rammap_s *rammap_find(FAR const void *addr,
+                                    FAR struct fs_rammap_s **prev);
+
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of a region back to the file.  Does nothing if the region
+ *   is not write-back.  The caller must hold g_rammaps.exclsem.
+ *
+ * Input Parameters:
+ *   map    - The region
+ *   offset - Offset of the first byte to write, relative to map->addr
+ *   length - Number of bytes to write
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t offset,
+                     size_t length);
 
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
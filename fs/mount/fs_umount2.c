@@ -134,6 +134,10 @@ int umount2(FAR const char *target, unsigned int flags)
       goto errout_with_semaphore;
     }
 
+  /* Discard any cached file data from the volume */
+
+  pagecache_invalidate(mountpt_inode, NULL);
+
   /* Successfully unbound.  Convert the mountpoint inode to regular
    * pseudo-file inode.
    */
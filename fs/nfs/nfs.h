@@ -74,6 +74,12 @@
 
 #define NFS_DIRBLKSIZ      1024           /* Must be a multiple of DIRBLKSIZ */
 
+/* Discard cached LOOKUP results */
+
+#ifndef CONFIG_NFS_ATTRCACHE
+#  define nfs_attrinvalidate(n,h,l)
+#endif
+
 /* Increment NFS statistics */
 
 #ifdef CONFIG_NFS_STATISTICS
@@ -123,6 +129,7 @@ EXTERN int  nfs_fsinfo(FAR struct nfsmount *nmp);
 EXTERN int nfs_request(struct nfsmount *nmp, int procnum,
                 FAR void *request, size_t reqlen,
                 FAR void *response, size_t resplen);
+EXTERN int  nfs_checkreply(FAR void *response);
 EXTERN int  nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
               FAR struct file_handle *fhandle,
               FAR struct nfs_fattr *obj_attributes,
@@ -136,6 +143,10 @@ EXTERN int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
               FAR struct nfs_fattr *attributes, FAR char *filename);
 EXTERN void nfs_attrupdate(FAR struct nfsnode *np,
               FAR struct nfs_fattr *attributes);
+#ifdef CONFIG_NFS_ATTRCACHE
+EXTERN void nfs_attrinvalidate(FAR struct nfsmount *nmp,
+              FAR const void *handle, int length);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
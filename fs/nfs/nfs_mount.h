@@ -50,6 +50,8 @@
 
 #include <sys/socket.h>
 
+#include <nuttx/clock.h>
+
 #include "rpc.h"
 
 /****************************************************************************
@@ -60,6 +62,23 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_NFS_ATTRCACHE
+/* One entry of the lookup cache:  The result of a LOOKUP of ac_name in the
+ * directory ac_dirfh.  The entry is unused if ac_dirlen is zero.
+ */
+
+struct nfs_attrcache_s
+{
+  systime_t        ac_time;                   /* Time when the entry was filled */
+  uint8_t          ac_dirlen;                 /* Size of the directory file handle */
+  uint8_t          ac_fhlen;                  /* Size of the object file handle */
+  nfsfh_t          ac_dirfh;                  /* File handle of the directory */
+  nfsfh_t          ac_fh;                     /* File handle of the object */
+  struct nfs_fattr ac_attr;                   /* Attributes of the object */
+  char             ac_name[CONFIG_NFS_ATTRCACHE_NAMELEN + 1];
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -84,6 +103,12 @@ struct nfsmount
   uint16_t         nm_readdirsize;            /* Size of a readdir RPC */
   uint16_t         nm_buflen;                 /* Size of I/O buffer */
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Cached results of recent LOOKUP RPCs */
+
+  struct nfs_attrcache_s nm_attrcache[CONFIG_NFS_ATTRCACHE_NENTRIES];
+#endif
+
   /* Set aside memory on the stack to hold the largest call message.  NOTE
    * that for the case of the write call message, it is the reply message that
    * is in this union.
@@ -104,6 +129,7 @@ struct nfsmount
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fs;
+    struct rpc_call_commit  commit;
     struct rpc_reply_write  write;
   } nm_msgbuffer;
 
@@ -58,6 +58,15 @@
 
 #define NFSNODE_OPEN           (1 << 0) /* File is still open */
 #define NFSNODE_MODIFIED       (1 << 1) /* Might have a modified buffer */
+#define NFSNODE_DIRTY          (1 << 2) /* n_buffer holds unwritten data */
+#define NFSNODE_UNSTABLE       (1 << 3) /* UNSTABLE writes need a COMMIT */
+#define NFSNODE_VERFCHANGED    (1 << 4) /* Write verifier changed (server reboot) */
+
+/* Read-ahead and write-behind share one buffer per open file */
+
+#if defined(CONFIG_NFS_READAHEAD) || defined(CONFIG_NFS_WRITEBEHIND)
+#  define NFS_HAVE_FILEBUFFER  1
+#endif
 
 /****************************************************************************
  * Public Types
@@ -78,6 +87,14 @@ struct nfsnode
   time_t             n_ctime;       /* File creation time (see NOTE) */
   nfsfh_t            n_fhandle;     /* NFS File Handle */
   uint64_t           n_size;        /* Current size of file (see NOTE) */
+#ifdef NFS_HAVE_FILEBUFFER
+  FAR uint8_t       *n_buffer;      /* Read-ahead/write-behind buffer */
+  off_t              n_bufpos;      /* File offset of the buffered data */
+  uint16_t           n_buflen;      /* Number of bytes in n_buffer */
+#endif
+#ifdef CONFIG_NFS_WRITEBEHIND
+  uint8_t            n_verf[NFSX_V3WRITEVERF]; /* Verifier of UNSTABLE writes */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
@@ -529,6 +529,19 @@ struct RMDIR3resok
   struct wcc_data    dir_wcc;
 };
 
+struct COMMIT3args
+{
+  struct file_handle fhandle;                  /* Variable length */
+  uint64_t           offset;
+  uint32_t           count;
+};
+
+struct COMMIT3resok
+{
+  struct wcc_data    file_wcc;
+  uint8_t            verf[NFSX_V3WRITEVERF];
+};
+
 /* The actual size of the lookup argument is variable.  This structures is, therefore,
  * only useful in setting aside maximum memory usage for the LOOKUP arguments.
  */
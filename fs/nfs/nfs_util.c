@@ -51,6 +51,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/dirent.h>
 
 #include "rpc.h"
@@ -60,6 +61,14 @@
 #include "nfs_node.h"
 #include "xdr_subs.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+#  define NFS_ATTRCACHE_TICKS SEC2TICK(CONFIG_NFS_ATTRCACHE_TTL)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -116,6 +125,114 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_cachefind
+ *
+ * Desciption:
+ *   Look for an unexpired lookup cache entry for filename in the directory
+ *   fhandle.  If one is found, replace fhandle with the file handle of the
+ *   object and return its attributes.
+ *
+ * Return Value:
+ *   true if the lookup was satisfied from the cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+static bool nfs_cachefind(FAR struct nfsmount *nmp, FAR const char *filename,
+                          FAR struct file_handle *fhandle,
+                          FAR struct nfs_fattr *obj_attributes)
+{
+  FAR struct nfs_attrcache_s *entry;
+  systime_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      entry = &nmp->nm_attrcache[i];
+      if (entry->ac_dirlen == fhandle->length &&
+          strcmp(entry->ac_name, filename) == 0 &&
+          memcmp(&entry->ac_dirfh, &fhandle->handle, entry->ac_dirlen) == 0)
+        {
+          if ((systime_t)(now - entry->ac_time) >= NFS_ATTRCACHE_TICKS)
+            {
+              /* The entry has expired */
+
+              entry->ac_dirlen = 0;
+              return false;
+            }
+
+          fhandle->length = entry->ac_fhlen;
+          memcpy(&fhandle->handle, &entry->ac_fh, entry->ac_fhlen);
+
+          if (obj_attributes)
+            {
+              memcpy(obj_attributes, &entry->ac_attr,
+                     sizeof(struct nfs_fattr));
+            }
+
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_cacheadd
+ *
+ * Desciption:
+ *   Save the result of a LOOKUP of filename in the directory dirhandle,
+ *   replacing an unused or the oldest entry of the lookup cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+static void nfs_cacheadd(FAR struct nfsmount *nmp, FAR const char *filename,
+                         int namelen, FAR const struct file_handle *dirhandle,
+                         FAR const struct file_handle *fhandle,
+                         FAR const struct nfs_fattr *obj_attributes)
+{
+  FAR struct nfs_attrcache_s *entry;
+  systime_t now = clock_systimer();
+  systime_t age = 0;
+  int victim = 0;
+  int i;
+
+  if (namelen > CONFIG_NFS_ATTRCACHE_NAMELEN)
+    {
+      return;
+    }
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      entry = &nmp->nm_attrcache[i];
+      if (entry->ac_dirlen == 0)
+        {
+          victim = i;
+          break;
+        }
+
+      if ((systime_t)(now - entry->ac_time) > age)
+        {
+          age    = now - entry->ac_time;
+          victim = i;
+        }
+    }
+
+  entry            = &nmp->nm_attrcache[victim];
+  entry->ac_time   = now;
+  entry->ac_dirlen = (uint8_t)dirhandle->length;
+  entry->ac_fhlen  = (uint8_t)fhandle->length;
+
+  memcpy(&entry->ac_dirfh, &dirhandle->handle, dirhandle->length);
+  memcpy(&entry->ac_fh, &fhandle->handle, fhandle->length);
+  memcpy(&entry->ac_attr, obj_attributes, sizeof(struct nfs_fattr));
+  memcpy(entry->ac_name, filename, namelen + 1);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -209,24 +326,14 @@ tryagain:
       return error;
     }
 
-  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
-
-  if (replyh.nfs_status != 0)
+  error = nfs_checkreply(response);
+  if (error != OK)
     {
-      if (fxdr_unsigned(uint32_t, replyh.nfs_status) > 32)
-        {
-          error = EOPNOTSUPP;
-        }
-      else
-        {
-          /* NFS_ERRORS are the same as NuttX errno values */
-
-          error = fxdr_unsigned(uint32_t, replyh.nfs_status);
-        }
-
       return error;
     }
 
+  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
+
   if (replyh.rpc_verfi.authtype != 0)
     {
       error = fxdr_unsigned(int, replyh.rpc_verfi.authtype);
@@ -245,6 +352,41 @@ tryagain:
   return OK;
 }
 
+/****************************************************************************
+ * Name: nfs_checkreply
+ *
+ * Desciption:
+ *   Verify the NFS status of a reply that has already passed the RPC level
+ *   checks.
+ *
+ * Return Value:
+ *   Zero on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_checkreply(FAR void *response)
+{
+  struct nfs_reply_header replyh;
+  uint32_t status;
+
+  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
+
+  if (replyh.nfs_status != 0)
+    {
+      status = fxdr_unsigned(uint32_t, replyh.nfs_status);
+      if (status > 32)
+        {
+          return EOPNOTSUPP;
+        }
+
+      /* NFS_ERRORS are the same as NuttX errno values */
+
+      return (int)status;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: nfs_lookup
  *
@@ -264,6 +406,9 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
                FAR struct nfs_fattr *obj_attributes,
                FAR struct nfs_fattr *dir_attributes)
 {
+#ifdef CONFIG_NFS_ATTRCACHE
+  struct file_handle dirhandle;
+#endif
   FAR uint32_t *ptr;
   uint32_t value;
   int reqlen;
@@ -281,6 +426,25 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
       return E2BIG;
     }
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* The cache does not hold directory attributes.  Otherwise, try to
+   * satisfy the lookup without a round trip to the server.
+   */
+
+  if (dir_attributes == NULL)
+    {
+      if (nfs_cachefind(nmp, filename, fhandle, obj_attributes))
+        {
+          return OK;
+        }
+
+      /* Remember the directory handle:  fhandle is overwritten below */
+
+      dirhandle.length = fhandle->length;
+      memcpy(&dirhandle.handle, &fhandle->handle, fhandle->length);
+    }
+#endif
+
   /* Initialize the request */
 
   ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.lookup.lookup;
@@ -350,6 +514,17 @@ int nfs_lookup(struct nfsmount *nmp, FAR const char *filename,
         {
           memcpy(obj_attributes, ptr, sizeof(struct nfs_fattr));
         }
+
+#ifdef CONFIG_NFS_ATTRCACHE
+      /* Cache the result (only if the object attributes are known) */
+
+      if (dir_attributes == NULL)
+        {
+          nfs_cacheadd(nmp, filename, namelen, &dirhandle, fhandle,
+                       (FAR struct nfs_fattr *)ptr);
+        }
+#endif
+
       ptr += uint32_increment(sizeof(struct nfs_fattr));
     }
 
@@ -584,3 +759,36 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime)
   np->n_ctime  = fxdr_hyper(&attributes->fa_ctime);
 }
+
+/****************************************************************************
+ * Name: nfs_attrinvalidate
+ *
+ * Desciption:
+ *   Discard the lookup cache entries of the object with the file handle
+ *   'handle' when the object is modified, or all entries when handle is
+ *   NULL (when a name space operation may have changed any directory).
+ *
+ * Return Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+void nfs_attrinvalidate(FAR struct nfsmount *nmp, FAR const void *handle,
+                        int length)
+{
+  FAR struct nfs_attrcache_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      entry = &nmp->nm_attrcache[i];
+      if (handle == NULL ||
+          (entry->ac_fhlen == length &&
+           memcmp(&entry->ac_fh, handle, length) == 0))
+        {
+          entry->ac_dirlen = 0;
+        }
+    }
+}
+#endif
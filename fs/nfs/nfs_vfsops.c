@@ -103,6 +103,37 @@
 #  error "Length of cookie verify in fs_dirent_s is incorrect"
 #endif
 
+/* Write data UNSTABLE (to be committed later) in the write-behind case */
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+#  define NFS_WRITE_STABLE    NFSV3WRITE_UNSTABLE
+#else
+#  define NFS_WRITE_STABLE    NFSV3WRITE_FILESYNC
+#endif
+
+/* The size of the per-file read-ahead/write-behind buffer */
+
+#define NFS_FILEBUFSIZE(n) \
+  ((n)->nm_rsize > (n)->nm_wsize ? (n)->nm_rsize : (n)->nm_wsize)
+
+#ifndef MIN
+#  define MIN(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One outstanding READ or WRITE call of a pipelined transfer */
+
+struct nfs_rpcslot_s
+{
+  uint32_t     xid;             /* xid of the call (zero if the slot is free) */
+  off_t        offset;          /* File offset of the data */
+  size_t       len;             /* Requested size of the data */
+  FAR uint8_t *buffer;          /* Location of the data in the caller's buffer */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -126,10 +157,36 @@ static int     nfs_fileopen(FAR struct nfsmount *nmp, struct nfsnode *np,
                    FAR const char *relpath, int oflags, mode_t mode);
 static int     nfs_open(FAR struct file *filep, const char *relpath,
                    int oflags, mode_t mode);
+static int     nfs_sendcall(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, FAR struct nfs_rpcslot_s *slot,
+                   bool write);
+static int     nfs_readreply(FAR struct nfsmount *nmp,
+                   FAR struct nfs_rpcslot_s *slot, FAR size_t *nread);
+static int     nfs_writereply(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, FAR struct nfs_rpcslot_s *slot,
+                   FAR size_t *nwritten);
+static int     nfs_transfer(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                   off_t offset, FAR uint8_t *buffer, size_t buflen,
+                   bool write, FAR size_t *nxfrd);
+static int     nfs_readdata(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                   off_t offset, FAR uint8_t *buffer, size_t buflen,
+                   FAR size_t *nread);
+static int     nfs_writedata(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR const uint8_t *buffer, size_t buflen);
+#ifdef NFS_HAVE_FILEBUFFER
+static int     nfs_flushbuffer(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+#endif
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int     nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+#endif
+static int     nfs_syncnode(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
 static int     nfs_close(FAR struct file *filep);
 static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
                    size_t buflen);
+static int     nfs_sync(FAR struct file *filep);
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     nfs_opendir(struct inode *mountpt, const char *relpath,
                    struct fs_dirent_s *dir);
@@ -166,7 +223,7 @@ const struct mountpt_operations nfs_operations =
   NULL,                         /* seek */
   NULL,                         /* ioctl */
 
-  NULL,                         /* sync */
+  nfs_sync,                     /* sync */
   nfs_dup,                      /* dup */
 
   nfs_opendir,                  /* opendir */
@@ -327,6 +384,10 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, struct nfsnode *np,
   while (((mode & O_CREAT) != 0) && error == EOPNOTSUPP);
 #endif
 
+  /* An existing file may have been re-created */
+
+  nfs_attrinvalidate(nmp, NULL, 0);
+
   /* Check for success */
 
   if (error == OK)
@@ -434,6 +495,7 @@ static int nfs_filetruncate(FAR struct nfsmount *nmp, struct nfsnode *np)
   /* Indicate that the file now has zero length */
 
   np->n_size = 0;
+  nfs_attrinvalidate(nmp, &np->n_fhandle, np->n_fhsize);
   return OK;
 }
 
@@ -457,79 +519,718 @@ static int nfs_fileopen(FAR struct nfsmount *nmp, struct nfsnode *np,
   uint32_t           tmp;
   int                error = 0;
 
-  /* Find the NFS node associate with the path */
+  /* Find the NFS node associate with the path */
+
+  error = nfs_findnode(nmp, relpath, &fhandle, &fattr, NULL);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_findnode returned: %d\n", error);
+      return error;
+    }
+
+  /* Check if the object is a directory */
+
+  tmp = fxdr_unsigned(uint32_t, fattr.fa_type);
+  if (tmp == NFDIR)
+    {
+      /* Exit with EISDIR if we attempt to open a directory */
+
+      ferr("ERROR: Path is a directory\n");
+      return EISDIR;
+    }
+
+  /* Check if the caller has sufficient privileges to open the file */
+
+  if ((oflags & O_WRONLY) != 0)
+    {
+      /* Check if anyone has priveleges to write to the file -- owner,
+       * group, or other (we are probably "other" and may still not be
+       * able to write).
+       */
+
+      tmp = fxdr_unsigned(uint32_t, fattr.fa_mode);
+      if ((tmp & (NFSMODE_IWOTH | NFSMODE_IWGRP | NFSMODE_IWUSR)) == 0)
+        {
+          ferr("ERROR: File is read-only: %08x\n", tmp);
+          return EACCES;
+        }
+    }
+
+  /* It would be an error if we are asked to create the file exclusively */
+
+  if ((oflags & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+    {
+      /* Already exists -- can't create it exclusively */
+
+      ferr("ERROR: File exists\n");
+      return EEXIST;
+    }
+
+  /* Initialize the file private data */
+  /* Copy the file handle */
+
+  np->n_fhsize      = (uint8_t)fhandle.length;
+  memcpy(&np->n_fhandle, &fhandle.handle, fhandle.length);
+
+  /* Save the file attributes */
+
+  nfs_attrupdate(np, &fattr);
+
+  /* If O_TRUNC is specified and the file is opened for writing,
+   * then truncate the file.  This operation requires that the file is
+   * writable, but we have already checked that. O_TRUNC without write
+   * access is ignored.
+   */
+
+  if ((oflags & (O_TRUNC | O_WRONLY)) == (O_TRUNC | O_WRONLY))
+    {
+      /* Truncate the file to zero length.  I think we can do this with
+       * the SETATTR call by setting the length to zero.
+       */
+
+      return nfs_filetruncate(nmp, np);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_sendcall
+ *
+ * Description:
+ *   Format and send the READ or WRITE call described by one slot of a
+ *   pipelined transfer.  For a retransmission, the xid in the slot is
+ *   re-used.  The READ call message is built in the message buffer; the
+ *   WRITE call message, which contains the data, is built in the I/O
+ *   buffer.  Neither must be preserved after the call has been sent.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_sendcall(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        FAR struct nfs_rpcslot_s *slot, bool write)
+{
+  FAR void     *request;
+  FAR uint32_t *ptr;
+  size_t        reqlen;
+  int           procnum;
+
+  if (write)
+    {
+      request = (FAR void *)nmp->nm_iobuffer;
+      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)request)->write;
+      procnum = NFSPROC_WRITE;
+    }
+  else
+    {
+      request = (FAR void *)&nmp->nm_msgbuffer.read;
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+      procnum = NFSPROC_READ;
+    }
+
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)slot->offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the count */
+
+  *ptr++  = txdr_unsigned(slot->len);
+  reqlen += sizeof(uint32_t);
+
+  if (write)
+    {
+      /* Copy the stable value and the data to be written */
+
+      *ptr++  = txdr_unsigned(NFS_WRITE_STABLE);
+      *ptr++  = txdr_unsigned(slot->len);
+      reqlen += 2*sizeof(uint32_t);
+
+      memcpy(ptr, slot->buffer, slot->len);
+      reqlen += uint32_alignup(slot->len);
+    }
+
+  nfs_statistics(procnum);
+  return rpcclnt_sendcall(nmp->nm_rpcclnt, procnum, NFS_PROG, NFS_VER3,
+                          request, reqlen, &slot->xid);
+}
+
+/****************************************************************************
+ * Name: nfs_readreply
+ *
+ * Description:
+ *   Parse the READ reply in the I/O buffer and copy the data to the
+ *   caller's buffer.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_readreply(FAR struct nfsmount *nmp,
+                         FAR struct nfs_rpcslot_s *slot, FAR size_t *nread)
+{
+  FAR uint32_t *ptr;
+  uint32_t      tmp;
+
+  /* Get a pointer to the beginning of the NFS response data. */
+
+  ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes... just skip over the attributes for now */
+
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* This is followed by the count of data read and an EOF indication.
+   * Just skip over them:  The EOF is signalled by a short read.
+   */
+
+  ptr += 2;
+
+  /* Then the length of the read data followed by the read data itself */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp > slot->len)
+    {
+      ferr("ERROR: Bad read size: %d\n", tmp);
+      return EIO;
+    }
+
+  /* Copy the read data into the caller's buffer */
+
+  memcpy(slot->buffer, ptr, tmp);
+  *nread = tmp;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_writereply
+ *
+ * Description:
+ *   Parse the WRITE reply in the message buffer.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_writereply(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                          FAR struct nfs_rpcslot_s *slot,
+                          FAR size_t *nwritten)
+{
+  FAR uint32_t *ptr;
+  uint32_t      tmp;
+
+  /* Get a pointer to the WRITE reply data */
+
+  ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Get the count of bytes actually written */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp < 1 || tmp > slot->len)
+    {
+      ferr("ERROR: Bad write size: %d\n", tmp);
+      return EIO;
+    }
+
+  *nwritten = tmp;
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+  /* Data that the server did not write to stable storage must be committed
+   * later.  The write verifier identifies the server instance that holds
+   * the data:  If it changes, the server has rebooted and may have lost the
+   * uncommitted data of earlier writes.
+   */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp != NFSV3WRITE_FILESYNC)
+    {
+      if ((np->n_flags & NFSNODE_UNSTABLE) == 0)
+        {
+          np->n_flags |= NFSNODE_UNSTABLE;
+        }
+      else if (memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+        {
+          fwarn("WARNING: Write verifier changed\n");
+          np->n_flags |= NFSNODE_VERFCHANGED;
+        }
+
+      memcpy(np->n_verf, ptr, NFSX_V3WRITEVERF);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_transfer
+ *
+ * Description:
+ *   Read or write a range of the file.  The range is split into calls no
+ *   larger than the negotiated rsize/wsize (and the I/O buffer) and up to
+ *   CONFIG_NFS_PIPELINE_DEPTH of them are kept outstanding at a time.
+ *   Replies are matched to the outstanding calls by their xids; late
+ *   replies to calls that are no longer outstanding are discarded.  If no
+ *   reply arrives in time, all outstanding calls are retransmitted.
+ *
+ *   The server may transfer fewer bytes than requested.  nxfrd returns the
+ *   number of bytes at the beginning of the range that were transferred.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_transfer(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        off_t offset, FAR uint8_t *buffer, size_t buflen,
+                        bool write, FAR size_t *nxfrd)
+{
+  struct nfs_rpcslot_s      slots[CONFIG_NFS_PIPELINE_DEPTH];
+  FAR struct nfs_rpcslot_s *slot;
+  FAR void                 *reply;
+  size_t                    replylen;
+  size_t                    maxsize;
+  size_t                    overhead;
+  size_t                    nbytes;
+  size_t                    limit;
+  size_t                    next;
+  uint32_t                  xid;
+  int                       nactive;
+  int                       retries;
+  int                       error;
+  int                       i;
+
+  /* Make sure that the size of one call does not exceed the RPC maximum or
+   * the I/O buffer size.  Get the location to receive the replies.
+   */
+
+  if (write)
+    {
+      maxsize  = nmp->nm_wsize;
+      overhead = SIZEOF_rpc_call_write(0);
+      reply    = (FAR void *)&nmp->nm_msgbuffer.write;
+      replylen = sizeof(struct rpc_reply_write);
+    }
+  else
+    {
+      maxsize  = nmp->nm_rsize;
+      overhead = SIZEOF_rpc_reply_read(0);
+      reply    = (FAR void *)nmp->nm_iobuffer;
+      replylen = nmp->nm_buflen;
+    }
+
+  if (maxsize + overhead > nmp->nm_buflen)
+    {
+      maxsize = (nmp->nm_buflen - overhead) & ~3;
+    }
+
+  memset(slots, 0, sizeof(slots));
+  limit   = buflen;
+  next    = 0;
+  nactive = 0;
+  retries = 0;
+
+  for (; ; )
+    {
+      /* Keep the pipeline full */
+
+      for (i = 0; i < CONFIG_NFS_PIPELINE_DEPTH && next < limit; i++)
+        {
+          slot = &slots[i];
+          if (slot->xid == 0)
+            {
+              slot->offset = offset + next;
+              slot->buffer = buffer + next;
+              slot->len    = MIN(maxsize, limit - next);
+
+              finfo("%s %d bytes at %d\n", write ? "Writing" : "Reading",
+                    slot->len, slot->offset);
+
+              error = nfs_sendcall(nmp, np, slot, write);
+              if (error != OK)
+                {
+                  return error;
+                }
+
+              next += slot->len;
+              nactive++;
+            }
+        }
+
+      if (nactive == 0)
+        {
+          break;
+        }
+
+      /* Wait for the next reply */
+
+      error = rpcclnt_getreply(nmp->nm_rpcclnt, reply, replylen, &xid);
+      if (nmp->nm_rpcclnt->rc_timeout)
+        {
+          if (++retries > nmp->nm_retry)
+            {
+              ferr("ERROR: No reply from the server: %d\n", error);
+              return error;
+            }
+
+          /* Retransmit all outstanding calls */
+
+          for (i = 0; i < CONFIG_NFS_PIPELINE_DEPTH; i++)
+            {
+              if (slots[i].xid != 0)
+                {
+                  error = nfs_sendcall(nmp, np, &slots[i], write);
+                  if (error != OK)
+                    {
+                      return error;
+                    }
+                }
+            }
+
+          continue;
+        }
+
+      /* Find the call that this is the reply to */
+
+      for (slot = NULL, i = 0; i < CONFIG_NFS_PIPELINE_DEPTH; i++)
+        {
+          if (xid != 0 && slots[i].xid == xid)
+            {
+              slot = &slots[i];
+              break;
+            }
+        }
+
+      if (slot == NULL)
+        {
+          if (xid == 0 && error != EPROTO)
+            {
+              ferr("ERROR: rpcclnt_getreply failed: %d\n", error);
+              return error;
+            }
+
+          finfo("Discarding reply with xid %08x\n", xid);
+          continue;
+        }
+
+      slot->xid = 0;
+      nactive--;
+      retries = 0;
+
+      if (error == OK)
+        {
+          error = nfs_checkreply(reply);
+        }
+
+      if (error == OK)
+        {
+          error = write ? nfs_writereply(nmp, np, slot, &nbytes) :
+                          nfs_readreply(nmp, slot, &nbytes);
+        }
+
+      if (error != OK)
+        {
+          ferr("ERROR: %s failed: %d\n", write ? "WRITE" : "READ", error);
+          return error;
+        }
+
+      /* A short transfer ends the range of contiguous data.  Calls beyond
+       * that point that were already sent are still waited for.
+       */
+
+      if (nbytes < slot->len)
+        {
+          nbytes += slot->offset - offset;
+          if (nbytes < limit)
+            {
+              limit = nbytes;
+            }
+        }
+    }
+
+  *nxfrd = limit;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_readdata
+ *
+ * Description:
+ *   Read a range of the file into a buffer.  Fewer bytes are read only at
+ *   the end of the file.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_readdata(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                        off_t offset, FAR uint8_t *buffer, size_t buflen,
+                        FAR size_t *nread)
+{
+  size_t nbytes;
+  int    error;
+
+  for (*nread = 0; *nread < buflen; *nread += nbytes)
+    {
+      error = nfs_transfer(nmp, np, offset + *nread, buffer + *nread,
+                           buflen - *nread, false, &nbytes);
+      if (error != OK)
+        {
+          return error;
+        }
+
+      /* Check if we hit the end of file */
+
+      if (nbytes == 0)
+        {
+          break;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_writedata
+ *
+ * Description:
+ *   Write a buffer to a range of the file.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_writedata(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                         off_t offset, FAR const uint8_t *buffer,
+                         size_t buflen)
+{
+  size_t nwritten;
+  size_t pos;
+  int    error;
+
+  for (pos = 0; pos < buflen; pos += nwritten)
+    {
+      error = nfs_transfer(nmp, np, offset + pos, (FAR uint8_t *)buffer + pos,
+                           buflen - pos, true, &nwritten);
+      if (error != OK)
+        {
+          return error;
+        }
+    }
+
+  /* The replies may have arrived out of order, so the file size reported
+   * by the last one does not necessarily include all of the data.
+   */
+
+  if (offset + buflen > np->n_size)
+    {
+      np->n_size = offset + buflen;
+    }
+
+  nfs_attrinvalidate(nmp, &np->n_fhandle, np->n_fhsize);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nfs_flushbuffer
+ *
+ * Description:
+ *   Write out the data collected in the write-behind buffer.  The buffer
+ *   then holds valid clean data.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef NFS_HAVE_FILEBUFFER
+static int nfs_flushbuffer(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  int error;
+
+  if ((np->n_flags & NFSNODE_DIRTY) == 0)
+    {
+      return OK;
+    }
+
+  error = nfs_writedata(nmp, np, np->n_bufpos, np->n_buffer, np->n_buflen);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_writedata failed: %d\n", error);
+      return error;
+    }
+
+  np->n_flags &= ~NFSNODE_DIRTY;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_commit
+ *
+ * Description:
+ *   Commit the data of UNSTABLE writes to stable storage on the server.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.  EIO is returned if
+ *   the server rebooted and may have lost some of the uncommitted data.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_WRITEBEHIND
+static int nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  uint32_t      tmp;
+  int           reqlen;
+  int           error;
+
+  if ((np->n_flags & NFSNODE_UNSTABLE) == 0)
+    {
+      return OK;
+    }
+
+  /* Create the COMMIT RPC call arguments */
+
+  ptr    = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  reqlen = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += (int)np->n_fhsize;
+  ptr    += uint32_increment((int)np->n_fhsize);
 
-  error = nfs_findnode(nmp, relpath, &fhandle, &fattr, NULL);
+  /* Commit the whole file:  Offset and count are zero */
+
+  *ptr++  = 0;
+  *ptr++  = 0;
+  *ptr++  = 0;
+  reqlen += 3*sizeof(uint32_t);
+
+  /* Perform the COMMIT RPC */
+
+  nfs_statistics(NFSPROC_COMMIT);
+  error = nfs_request(nmp, NFSPROC_COMMIT,
+                      (FAR void *)&nmp->nm_msgbuffer.commit, reqlen,
+                      (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
   if (error != OK)
     {
-      ferr("ERROR: nfs_findnode returned: %d\n", error);
+      ferr("ERROR: nfs_request failed: %d\n", error);
       return error;
     }
 
-  /* Check if the object is a directory */
+  /* Skip over the file_wcc data to get to the verifier */
 
-  tmp = fxdr_unsigned(uint32_t, fattr.fa_type);
-  if (tmp == NFDIR)
-    {
-      /* Exit with EISDIR if we attempt to open a directory */
+  ptr = (FAR uint32_t *)&((FAR struct rpc_reply_commit *)nmp->nm_iobuffer)->commit;
 
-      ferr("ERROR: Path is a directory\n");
-      return EISDIR;
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      ptr += uint32_increment(sizeof(struct wcc_attr));
     }
 
-  /* Check if the caller has sufficient privileges to open the file */
-
-  if ((oflags & O_WRONLY) != 0)
+  tmp = *ptr++;
+  if (tmp != 0)
     {
-      /* Check if anyone has priveleges to write to the file -- owner,
-       * group, or other (we are probably "other" and may still not be
-       * able to write).
-       */
-
-      tmp = fxdr_unsigned(uint32_t, fattr.fa_mode);
-      if ((tmp & (NFSMODE_IWOTH | NFSMODE_IWGRP | NFSMODE_IWUSR)) == 0)
-        {
-          ferr("ERROR: File is read-only: %08x\n", tmp);
-          return EACCES;
-        }
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
     }
 
-  /* It would be an error if we are asked to create the file exclusively */
+  /* The data is lost if the server rebooted after any of the writes */
 
-  if ((oflags & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+  if ((np->n_flags & NFSNODE_VERFCHANGED) != 0 ||
+      memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
     {
-      /* Already exists -- can't create it exclusively */
-
-      ferr("ERROR: File exists\n");
-      return EEXIST;
+      ferr("ERROR: Server rebooted, uncommitted data was lost\n");
+      error = EIO;
     }
 
-  /* Initialize the file private data */
-  /* Copy the file handle */
-
-  np->n_fhsize      = (uint8_t)fhandle.length;
-  memcpy(&np->n_fhandle, &fhandle.handle, fhandle.length);
+  np->n_flags &= ~(NFSNODE_UNSTABLE | NFSNODE_VERFCHANGED);
+  return error;
+}
+#endif
 
-  /* Save the file attributes */
+/****************************************************************************
+ * Name: nfs_syncnode
+ *
+ * Description:
+ *   Write out any buffered data of the file and commit it to stable storage
+ *   on the server.
+ *
+ * Returned Value:
+ *   0 on success; a positive errno value on failure.
+ *
+ ****************************************************************************/
 
-  nfs_attrupdate(np, &fattr);
+static int nfs_syncnode(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  int error = OK;
 
-  /* If O_TRUNC is specified and the file is opened for writing,
-   * then truncate the file.  This operation requires that the file is
-   * writable, but we have already checked that. O_TRUNC without write
-   * access is ignored.
-   */
+#ifdef NFS_HAVE_FILEBUFFER
+  error = nfs_flushbuffer(nmp, np);
+#endif
 
-  if ((oflags & (O_TRUNC | O_WRONLY)) == (O_TRUNC | O_WRONLY))
+#ifdef CONFIG_NFS_WRITEBEHIND
+  if (error == OK)
     {
-      /* Truncate the file to zero length.  I think we can do this with
-       * the SETATTR call by setting the length to zero.
-       */
-
-      return nfs_filetruncate(nmp, np);
+      error = nfs_commit(nmp, np);
     }
+#endif
 
-  return OK;
+  return error;
 }
 
 /****************************************************************************
@@ -630,6 +1331,18 @@ static int nfs_open(FAR struct file *filep, FAR const char *relpath,
 
   np->n_crefs = 1;
 
+#ifdef NFS_HAVE_FILEBUFFER
+  /* Allocate the read-ahead/write-behind buffer.  The file can still be
+   * used (unbuffered) if this fails.
+   */
+
+  np->n_buffer = (FAR uint8_t *)kmm_malloc(NFS_FILEBUFSIZE(nmp));
+  if (!np->n_buffer)
+    {
+      fwarn("WARNING: Failed to allocate file buffer\n");
+    }
+#endif
+
   /* Attach the private data to the struct file instance */
 
   filep->f_priv = np;
@@ -674,6 +1387,7 @@ static int nfs_close(FAR struct file *filep)
   FAR struct nfsnode  *np;
   FAR struct nfsnode  *prev;
   FAR struct nfsnode  *curr;
+  int error;
   int ret;
 
   /* Sanity checks */
@@ -710,6 +1424,14 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+      /* Write back any buffered data and commit it */
+
+      error = nfs_syncnode(nmp, np);
+      if (error != OK)
+        {
+          ferr("ERROR: nfs_syncnode failed: %d\n", error);
+        }
+
       /* Assume file structure will not be found.  This should never happen. */
 
       ret = -EINVAL;
@@ -737,10 +1459,19 @@ static int nfs_close(FAR struct file *filep)
                   nmp->nm_head = np->n_next;
                 }
 
-              /* Then deallocate the file structure and return success */
+              /* Then deallocate the file structure and return the result
+               * of writing back the data.
+               */
+
+#ifdef NFS_HAVE_FILEBUFFER
+              if (np->n_buffer)
+                {
+                  kmm_free(np->n_buffer);
+                }
+#endif
 
               kmm_free(np);
-              ret = OK;
+              ret = -error;
               break;
             }
         }
@@ -764,11 +1495,9 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 {
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
-  ssize_t                    readsize;
-  ssize_t                    tmp;
-  ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  size_t                     bytesread;
+  size_t                     remaining;
+  size_t                     nread;
   int                        error = 0;
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
@@ -798,120 +1527,103 @@ static ssize_t nfs_read(FAR struct file *filep, char *buffer, size_t buflen)
    * it does not exceed the number of bytes left in the file.
    */
 
-  tmp = np->n_size - filep->f_pos;
-  if (buflen > tmp)
+  if (filep->f_pos >= np->n_size)
     {
-      buflen = tmp;
+      buflen = 0;
+    }
+  else if (buflen > np->n_size - filep->f_pos)
+    {
+      buflen = np->n_size - filep->f_pos;
       finfo("Read size truncated to %d\n", buflen);
     }
 
-  /* Now loop until we fill the user buffer (or hit the end of the file) */
+#ifdef NFS_HAVE_FILEBUFFER
+  /* Write out any buffered data first.  The buffer then holds valid data
+   * that may satisfy the read.
+   */
 
-  for (bytesread = 0; bytesread < buflen; )
+  if (np->n_buffer)
     {
-      /* Make sure that the attempted read size does not exceed the RPC maximum */
-
-      readsize = buflen;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
-
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
-
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
-
-      /* Perform the read */
-
-      finfo("Reading %d bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      error = nfs_request(nmp, NFSPROC_READ,
-                          (FAR void *)&nmp->nm_msgbuffer.read, reqlen,
-                          (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
-      if (error)
+      error = nfs_flushbuffer(nmp, np);
+      if (error != OK)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
           goto errout_with_semaphore;
         }
+    }
+#endif
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
+  /* Now loop until we fill the user buffer (or hit the end of the file) */
 
-      ptr = (FAR uint32_t *)&((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+  for (bytesread = 0; bytesread < buflen; )
+    {
+      remaining = buflen - bytesread;
 
-      /* Check if attributes are included in the responses */
+#ifdef NFS_HAVE_FILEBUFFER
+      /* Copy any part of the request that is in the buffer */
 
-      tmp = *ptr++;
-      if (*ptr != 0)
+      if (np->n_buffer && np->n_buflen > 0 &&
+          filep->f_pos >= np->n_bufpos &&
+          filep->f_pos < np->n_bufpos + np->n_buflen)
         {
-          /* Yes... just skip over the attributes for now */
-
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          nread = MIN(remaining,
+                      np->n_bufpos + np->n_buflen - filep->f_pos);
+          memcpy(buffer, np->n_buffer + (filep->f_pos - np->n_bufpos),
+                 nread);
         }
+      else
+#endif
+#ifdef CONFIG_NFS_READAHEAD
+      if (np->n_buffer && remaining < NFS_FILEBUFSIZE(nmp))
+        {
+          /* Small reads fill the whole buffer so that following sequential
+           * reads need no RPCs.
+           */
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
+          error = nfs_readdata(nmp, np, filep->f_pos, np->n_buffer,
+                               MIN(NFS_FILEBUFSIZE(nmp),
+                                   np->n_size - filep->f_pos),
+                               &nread);
+          if (error != OK)
+            {
+              np->n_buflen = 0;
+              goto errout_with_semaphore;
+            }
 
-      /* Next comes an EOF indication.  Save that in tmp for now. */
+          np->n_bufpos = filep->f_pos;
+          np->n_buflen = nread;
 
-      tmp = *ptr++;
+          if (nread == 0)
+            {
+              break;
+            }
 
-      /* Then the length of the read data followed by the read data itself */
+          continue;
+        }
+      else
+#endif
+        {
+          /* Read directly into the user buffer */
 
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+          error = nfs_readdata(nmp, np, filep->f_pos, (FAR uint8_t *)buffer,
+                               remaining, &nread);
+          if (error != OK)
+            {
+              goto errout_with_semaphore;
+            }
 
-      /* Copy the read data into the user buffer */
+          /* Check if we hit the end of file */
 
-      memcpy(buffer, ptr, readsize);
+          if (nread < remaining)
+            {
+              buflen = bytesread + nread;
+            }
+        }
 
       /* Update the read state data */
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
-
-      /* Check if we hit the end of file */
-
-      if (tmp != 0)
-        {
-          break;
-        }
+      filep->f_pos += nread;
+      bytesread    += nread;
+      buffer       += nread;
     }
 
   finfo("Read %d bytes\n", bytesread);
@@ -937,14 +1649,6 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
 {
   struct nfsmount       *nmp;
   struct nfsnode        *np;
-  ssize_t                writesize;
-  ssize_t                bufsize;
-  ssize_t                byteswritten;
-  size_t                 reqlen;
-  FAR uint32_t          *ptr;
-  uint32_t               tmp;
-  int                    commit = 0;
-  int                    committed = NFSV3WRITE_FILESYNC;
   int                    error;
 
   finfo("Write %d bytes to offset %d\n", buflen, filep->f_pos);
@@ -978,137 +1682,123 @@ static ssize_t nfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_semaphore;
     }
 
-  /* Now loop until we send the entire user buffer */
-
-  writesize = 0;
-  for (byteswritten = 0; byteswritten < buflen; )
+#ifdef NFS_HAVE_FILEBUFFER
+  if (np->n_buffer)
     {
-      /* Make sure that the attempted write size does not exceed the RPC maximum */
-
-      writesize = buflen;
-      if (writesize > nmp->nm_wsize)
+#ifdef CONFIG_NFS_WRITEBEHIND
+      if (buflen < NFS_FILEBUFSIZE(nmp))
         {
-          writesize = nmp->nm_wsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer size */
-
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
-        {
-          writesize -= (bufsize - nmp->nm_buflen);
-        }
-
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls messasge lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += (int)np->n_fhsize;
-      ptr    += uint32_increment((int)np->n_fhsize);
+          /* Collect small writes in the buffer.  The buffered data must be
+           * written out first if this write does not continue it or does
+           * not fit.
+           */
 
-      /* Copy the file offset */
+          if ((np->n_flags & NFSNODE_DIRTY) != 0 &&
+              (filep->f_pos != np->n_bufpos + np->n_buflen ||
+               np->n_buflen + buflen > NFS_FILEBUFSIZE(nmp)))
+            {
+              error = nfs_flushbuffer(nmp, np);
+              if (error != OK)
+                {
+                  goto errout_with_semaphore;
+                }
+            }
 
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
+          /* Any clean data in the buffer is discarded */
 
-      /* Copy the count and stable values */
+          if ((np->n_flags & NFSNODE_DIRTY) == 0)
+            {
+              np->n_bufpos   = filep->f_pos;
+              np->n_buflen   = 0;
+              np->n_flags   |= NFSNODE_DIRTY;
+            }
 
-      *ptr++  = txdr_unsigned(buflen);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
+          memcpy(np->n_buffer + np->n_buflen, buffer, buflen);
+          np->n_buflen += buflen;
+          filep->f_pos += buflen;
 
-      /* Copy a chunk of the user data into the I/O buffer */
+          if (filep->f_pos > np->n_size)
+            {
+              np->n_size = filep->f_pos;
+            }
 
-      *ptr++  = txdr_unsigned(buflen);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
+          nfs_semgive(nmp);
+          return buflen;
+        }
+#endif
 
-      /* Perform the write */
+      /* The data bypasses the buffer.  Write out any buffered data first
+       * and discard the buffer contents which might become stale.
+       */
 
-      nfs_statistics(NFSPROC_WRITE);
-      error = nfs_request(nmp, NFSPROC_WRITE,
-                          (FAR void *)nmp->nm_iobuffer, reqlen,
-                          (FAR void *)&nmp->nm_msgbuffer.write, sizeof(struct rpc_reply_write));
-      if (error)
+      error = nfs_flushbuffer(nmp, np);
+      if (error != OK)
         {
-          ferr("ERROR: nfs_request failed: %d\n", error);
           goto errout_with_semaphore;
         }
 
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+      np->n_buflen = 0;
+    }
+#endif
 
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
+  /* Send the entire user buffer */
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
+  error = nfs_writedata(nmp, np, filep->f_pos, (FAR const uint8_t *)buffer,
+                        buflen);
+  if (error != OK)
+    {
+      ferr("ERROR: nfs_writedata failed: %d\n", error);
+      goto errout_with_semaphore;
+    }
 
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
+  filep->f_pos += buflen;
 
-      /* Check if normal file attributes follow */
+  nfs_semgive(nmp);
+  return buflen;
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+errout_with_semaphore:
+  nfs_semgive(nmp);
+  return -error;
+}
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+/****************************************************************************
+ * Name: nfs_sync
+ *
+ * Description:
+ *   Write out any buffered data of the file and commit it to stable
+ *   storage on the server.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
 
-      /* Get the count of bytes actually written */
+static int nfs_sync(FAR struct file *filep)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int error;
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+  /* Sanity checks */
 
-      if (tmp < 1 || tmp > writesize)
-        {
-           error = EIO;
-           goto errout_with_semaphore;
-        }
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-      writesize = tmp;
+  /* Recover our private data from the struct file instance */
 
-      /* Determine the lowest committment level obtained by any of the RPCs. */
+  nmp = (FAR struct nfsmount *)filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+  DEBUGASSERT(nmp != NULL);
 
-      /* Update the read state data */
+  /* Make sure that the mount is still healthy */
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+  nfs_semtake(nmp);
+  error = nfs_checkmount(nmp);
+  if (error == OK)
+    {
+      error = nfs_syncnode(nmp, np);
     }
 
-  nfs_semgive(nmp);
-  return writesize;
-
-errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
 }
@@ -2168,6 +2858,10 @@ static int nfs_remove(struct inode *mountpt, const char *relpath)
                       (FAR void *)&nmp->nm_msgbuffer.removef, reqlen,
                       (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
 
+  /* Cached lookups in the affected directories are no longer valid */
+
+  nfs_attrinvalidate(nmp, NULL, 0);
+
 errout_with_semaphore:
    nfs_semgive(nmp);
    return -error;
@@ -2380,6 +3074,10 @@ static int nfs_rmdir(struct inode *mountpt, const char *relpath)
                           (FAR void *)&nmp->nm_msgbuffer.rmdir, reqlen,
                           (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
 
+  /* Cached lookups in the affected directories are no longer valid */
+
+  nfs_attrinvalidate(nmp, NULL, 0);
+
 errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
@@ -2497,6 +3195,10 @@ static int nfs_rename(struct inode *mountpt, const char *oldrelpath,
                       (FAR void *)&nmp->nm_msgbuffer.renamef, reqlen,
                       (FAR void *)nmp->nm_iobuffer, nmp->nm_buflen);
 
+  /* Cached lookups in the affected directories are no longer valid */
+
+  nfs_attrinvalidate(nmp, NULL, 0);
+
 errout_with_semaphore:
   nfs_semgive(nmp);
   return -error;
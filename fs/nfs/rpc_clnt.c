@@ -142,6 +142,7 @@ static int rpcclnt_reply(FAR struct rpcclnt *rpc, int procid, int prog,
 static uint32_t rpcclnt_newxid(void);
 static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
                               uint32_t xid, int procid, int prog, int vers);
+static int rpcclnt_checkreply(FAR struct rpc_reply_header *replymsg);
 
 /****************************************************************************
  * Private Functions
@@ -323,6 +324,64 @@ static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
   ch->rpc_verf.authlen   = 0;
 }
 
+/****************************************************************************
+ * Name: rpcclnt_checkreply
+ *
+ * Description:
+ *   Verify the RPC level of the returned values.  (There may still be be
+ *   NFS layer errors that will be detected by calling logic).
+ *
+ * Returned Value:
+ *   Returns zero on success or a (positive) errno value on failure.
+ *
+ ****************************************************************************/
+
+static int rpcclnt_checkreply(FAR struct rpc_reply_header *replymsg)
+{
+  uint32_t tmp;
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->type);
+  if (tmp == RPC_MSGDENIED)
+    {
+      tmp = fxdr_unsigned(uint32_t, replymsg->status);
+      switch (tmp)
+        {
+        case RPC_MISMATCH:
+          ferr("ERROR: RPC_MSGDENIED: RPC_MISMATCH error\n");
+          return EOPNOTSUPP;
+
+        case RPC_AUTHERR:
+          ferr("ERROR: RPC_MSGDENIED: RPC_AUTHERR error\n");
+          return EACCES;
+
+        default:
+          return EOPNOTSUPP;
+        }
+    }
+  else if (tmp != RPC_MSGACCEPTED)
+    {
+      return EOPNOTSUPP;
+    }
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->status);
+  if (tmp == RPC_SUCCESS)
+    {
+      finfo("RPC_SUCCESS\n");
+    }
+  else if (tmp == RPC_PROGMISMATCH)
+    {
+      ferr("ERROR: RPC_MSGACCEPTED: RPC_PROGMISMATCH error\n");
+      return EOPNOTSUPP;
+    }
+  else if (tmp > 5)
+    {
+      ferr("ERROR: Unsupported RPC type: %d\n", tmp);
+      return EOPNOTSUPP;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -673,14 +732,133 @@ bad:
   return error;
 }
 
+/****************************************************************************
+ * Name: rpcclnt_sendcall
+ *
+ * Description:
+ *   Format the RPC CALL message header and send the CALL message without
+ *   waiting for the reply.  Together with rpcclnt_getreply(), this permits
+ *   the caller to keep several calls outstanding at the same time, matching
+ *   the replies to the calls by their transaction IDs.
+ *
+ * Input Parameters:
+ *   rpc     - The RPC client state
+ *   procnum - The procedure number
+ *   prog    - The program number
+ *   version - The program version
+ *   request - The CALL message.  Space for the RPC header must be reserved
+ *             at the beginning of the message.
+ *   reqlen  - The size of the CALL message, excluding the RPC header
+ *   xid     - On entry, the xid of the call to be retransmitted or zero
+ *             for a new call.  On return, the xid of the CALL message.
+ *
+ * Returned Value:
+ *   Returns zero on success or a (positive) errno value on failure.
+ *
+ ****************************************************************************/
+
+int rpcclnt_sendcall(FAR struct rpcclnt *rpc, int procnum, int prog,
+                     int version, FAR void *request, size_t reqlen,
+                     FAR uint32_t *xid)
+{
+  int error;
+
+  if (*xid == 0)
+    {
+      /* Get a new (non-zero) xid */
+
+      do
+        {
+          *xid = rpcclnt_newxid();
+        }
+      while (*xid == 0);
+    }
+  else
+    {
+      rpc_statistics(rpcretries);
+    }
+
+  /* Initialize the RPC header fields.  The header is formatted again even
+   * for a retransmission because the caller may have re-used the message
+   * buffer for other calls in the meantime.
+   */
+
+  rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
+                    *xid, prog, version, procnum);
+
+  /* Send the RPC call message, including the header */
+
+  rpc_statistics(rpcrequests);
+  error = rpcclnt_send(rpc, procnum, prog, request,
+                       reqlen + sizeof(struct rpc_call_header));
+  if (error != OK)
+    {
+      finfo("ERROR rpcclnt_send failed: %d\n", error);
+    }
+
+  return error;
+}
+
+/****************************************************************************
+ * Name: rpcclnt_getreply
+ *
+ * Description:
+ *   Receive the next RPC REPLY message from the socket and verify its RPC
+ *   level values.  The reply may belong to any outstanding call:  It is the
+ *   responsibility of the caller to match the returned xid against its
+ *   outstanding calls and to discard replies to calls that it no longer
+ *   waits for.
+ *
+ *   If the receive timed out, rc_timeout is set in the RPC client state and
+ *   the caller should retransmit its outstanding calls.
+ *
+ * Input Parameters:
+ *   rpc      - The RPC client state
+ *   response - The location to return the REPLY message
+ *   resplen  - The size of the response buffer
+ *   xid      - The location to return the xid of the REPLY message.  Zero is
+ *              returned if no valid REPLY message was received.
+ *
+ * Returned Value:
+ *   Returns zero on success or a (positive) errno value on failure.
+ *
+ ****************************************************************************/
+
+int rpcclnt_getreply(FAR struct rpcclnt *rpc, FAR void *response,
+                     size_t resplen, FAR uint32_t *xid)
+{
+  FAR struct rpc_reply_header *replymsg;
+  int error;
+
+  *xid = 0;
+  rpc->rc_timeout = false;
+
+  /* Wait for the next reply */
+
+  error = rpcclnt_reply(rpc, 0, 0, response, resplen);
+  if (error != OK)
+    {
+      finfo("ERROR rpcclnt_reply failed: %d\n", error);
+      return error;
+    }
+
+  /* Return the xid and break down the RPC header */
+
+  replymsg = (FAR struct rpc_reply_header *)response;
+  *xid     = fxdr_unsigned(uint32_t, replymsg->rp_xid);
+
+  return rpcclnt_checkreply(replymsg);
+}
+
 /****************************************************************************
  * Name: rpcclnt_request
  *
  * Description:
  *   Perform the RPC request.  Logic formats the RPC CALL message and calls
- *   rpcclnt_send to send the RPC CALL message.  It then calls rpcclnt_reply()
- *   to get the response.  It may attempt to re-send the CALL message on
- *   certain errors.
+ *   rpcclnt_sendcall to send the RPC CALL message.  It then calls
+ *   rpcclnt_getreply() to get the response, discarding any late replies to
+ *   earlier calls.  It may attempt to re-send the CALL message on response
+ *   timeouts.
  *
  *   On successful receipt, it verifies the RPC level of the returned values.
  *   (There may still be be NFS layer errors that will be deted by calling
@@ -692,56 +870,43 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                     int version, FAR void *request, size_t reqlen,
                     FAR void *response, size_t resplen)
 {
-  struct rpc_reply_header *replymsg;
-  uint32_t tmp;
+  uint32_t rxid;
   uint32_t xid;
   int retries;
   int error = 0;
 
-  /* Get a new (non-zero) xid */
-
-  xid = rpcclnt_newxid();
-
-  /* Initialize the RPC header fields */
-
-  rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
-                    xid, prog, version, procnum);
-
-  /* Get the full size of the message (the size of variable data plus the size of
-   * the messages header).
-   */
-
-  reqlen += sizeof(struct rpc_call_header);
-
   /* Send the RPC call messsages and receive the RPC response.  A limited
    * number of re-tries will be attempted, but only for the case of response
    * timeouts.
    */
 
+  xid     = 0;
   retries = 0;
+
   do
     {
-      /* Do the client side RPC. */
+      /* Send the RPC CALL message (the same xid is used for re-tries) */
 
-      rpc_statistics(rpcrequests);
       rpc->rc_timeout = false;
 
-      /* Send the RPC CALL message */
-
-      error = rpcclnt_send(rpc, procnum, prog, request, reqlen);
-      if (error != OK)
+      error = rpcclnt_sendcall(rpc, procnum, prog, version, request, reqlen,
+                               &xid);
+      if (error == OK)
         {
-          finfo("ERROR rpcclnt_send failed: %d\n", error);
-        }
-
-      /* Wait for the reply from our send */
+          /* Wait for the reply from our send.  Replies with another xid
+           * are late replies to earlier calls and are ignored.
+           */
 
-      else
-        {
-          error = rpcclnt_reply(rpc, procnum, prog, response, resplen);
-          if (error != OK)
+          for (; ; )
             {
-              finfo("ERROR rpcclnt_reply failed: %d\n", error);
+              error = rpcclnt_getreply(rpc, response, resplen, &rxid);
+              if (rxid == xid || (rxid == 0 && error != EPROTO))
+                {
+                  break;
+                }
+
+              finfo("Discarding reply with xid %08x\n", rxid);
+              rpc_statistics(rpcinvalid);
             }
         }
 
@@ -751,51 +916,13 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
 
   if (error != OK)
     {
-      ferr("ERROR: RPC failed: %d\n", error);
-      return error;
-    }
-
-  /* Break down the RPC header and check if it is OK */
-
-  replymsg = (FAR struct rpc_reply_header *)response;
-
-  tmp = fxdr_unsigned(uint32_t, replymsg->type);
-  if (tmp == RPC_MSGDENIED)
-    {
-      tmp = fxdr_unsigned(uint32_t, replymsg->status);
-      switch (tmp)
+      if (rpc->rc_timeout)
         {
-        case RPC_MISMATCH:
-          ferr("ERROR: RPC_MSGDENIED: RPC_MISMATCH error\n");
-          return EOPNOTSUPP;
-
-        case RPC_AUTHERR:
-          ferr("ERROR: RPC_MSGDENIED: RPC_AUTHERR error\n");
-          return EACCES;
-
-        default:
-          return EOPNOTSUPP;
+          rpc_statistics(rpctimeouts);
         }
-    }
-  else if (tmp != RPC_MSGACCEPTED)
-    {
-      return EOPNOTSUPP;
-    }
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->status);
-  if (tmp == RPC_SUCCESS)
-    {
-      finfo("RPC_SUCCESS\n");
-    }
-  else if (tmp == RPC_PROGMISMATCH)
-    {
-      ferr("ERROR: RPC_MSGACCEPTED: RPC_PROGMISMATCH error\n");
-      return EOPNOTSUPP;
-    }
-  else if (tmp > 5)
-    {
-      ferr("ERROR: Unsupported RPC type: %d\n", tmp);
-      return EOPNOTSUPP;
+      ferr("ERROR: RPC failed: %d\n", error);
+      return error;
     }
 
   return OK;
@@ -52,6 +52,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/nxffs.h>
 
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -184,6 +188,21 @@
 
 #define NXFFS_NERASED             128
 
+/* The in-memory inode index grows in steps of this many entries */
+
+#define NXFFS_INDEX_INCR          16
+
+/* Background packing */
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+#  ifndef CONFIG_NXFFS_BGPACK_FREEPCT
+#    define CONFIG_NXFFS_BGPACK_FREEPCT 25
+#  endif
+#  ifndef CONFIG_NXFFS_BGPACK_DELAY
+#    define CONFIG_NXFFS_BGPACK_DELAY 1000
+#  endif
+#endif
+
 /* Quasi-standard definitions */
 
 #ifndef MIN
@@ -255,6 +274,18 @@ struct nxffs_blkentry_s
   uint16_t                  foffset;  /* Offset to start of data */
 };
 
+/* One entry in the in-memory inode index:  The hash of the inode name and
+ * the FLASH offset to its inode header.
+ */
+
+#ifdef CONFIG_NXFFS_INDEX
+struct nxffs_index_s
+{
+  uint32_t                  hash;     /* Hash of the inode name */
+  off_t                     hoffset;  /* Offset to the inode header */
+};
+#endif
+
 /* This structure describes the state of one open file.  This structure
  * is protected by the volume semaphore.
  */
@@ -301,6 +332,21 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+  bool                      dirty;     /* True: deleted inodes since last pack */
+  struct work_s             packwork;  /* Background packing work */
+#endif
+#ifdef CONFIG_NXFFS_INDEX
+  bool                      idxvalid;  /* True: index holds every valid inode */
+  uint16_t                  nindex;    /* Number of entries in the index */
+  uint16_t                  maxindex;  /* Number of entries allocated */
+  FAR struct nxffs_index_s *index;     /* In-memory inode index */
+#endif
+#ifdef CONFIG_NXFFS_SNAPSHOT
+  bool                      snapvalid; /* True: The snapshot on FLASH is current */
+  off_t                     snapblock; /* Snapshot erase block (0 = none) */
+  uint32_t                  snapgen;   /* Generation of the last snapshot */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -639,6 +685,132 @@ int nxffs_nextentry(FAR struct nxffs_volume_s *volume, off_t offset,
 int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
                     FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_idxfind
+ *
+ * Description:
+ *   Look up an inode by name in the in-memory inode index, building the
+ *   index first if it is not valid.  Stale index entries found along the
+ *   way are discarded.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success; -ENOENT if there is no such inode.  Any
+ *   other negated errno value means that the index could not be used and
+ *   the caller must fall back to searching the FLASH.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_idxfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  FAR struct nxffs_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_idxadd and nxffs_idxremove
+ *
+ * Description:
+ *   Keep the in-memory inode index up to date when an inode header is
+ *   written or an inode is deleted.  Does nothing if the index is not valid.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   name    - The name of the inode
+ *   hoffset - FLASH offset to the inode header
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_idxadd(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  off_t hoffset);
+void nxffs_idxremove(FAR struct nxffs_volume_s *volume, off_t hoffset);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_idxinvalidate
+ *
+ * Description:
+ *   Discard the contents of the in-memory inode index.  Called when inodes
+ *   are moved on the FLASH (packing, re-formatting).  The index will be
+ *   rebuilt on the next look-up.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_idxinvalidate(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_idxinvalidate(v)
+#endif
+
+/****************************************************************************
+ * Name: nxffs_snapload and nxffs_snapsave
+ *
+ * Description:
+ *   The mount snapshot lets nxffs_initialize() skip the scan of the FLASH
+ *   after a clean unmount.  nxffs_snapsave() saves the FLASH limits and the
+ *   inode index in the reserved last erase block when the volume is
+ *   unmounted; nxffs_snapload() restores them when the volume is next
+ *   initialized.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success.  nxffs_snapload() returns a negated errno value if
+ *   there is no current snapshot; the FLASH must then be scanned.
+ *
+ * Defined in nxffs_snapshot.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_SNAPSHOT
+int nxffs_snapload(FAR struct nxffs_volume_s *volume);
+int nxffs_snapsave(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_snapinvalidate
+ *
+ * Description:
+ *   Erase the snapshot.  Must be called before anything is written to the
+ *   FLASH so that a stale snapshot is never used.  Does nothing if the
+ *   snapshot has already been erased.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_snapshot.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_SNAPSHOT
+void nxffs_snapinvalidate(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_snapinvalidate(v)
+#endif
+
 /****************************************************************************
  * Name: nxffs_inodeend
  *
@@ -1059,6 +1231,35 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_schedpack
+ *
+ * Description:
+ *   Schedule packing of the volume on the low priority work queue if inodes
+ *   have been deleted and the free FLASH at the end of the volume has
+ *   dropped below CONFIG_NXFFS_BGPACK_FREEPCT percent.  Packing starts
+ *   when the volume has been idle for CONFIG_NXFFS_BGPACK_DELAY
+ *   milliseconds and is skipped while a file is open for writing.  This
+ *   way the write that runs out of space rarely has to pack the volume.
+ *
+ *   Must be called with the volume exclsem held.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Values:
+ *   None
+ *
+ * Defined in nxffs_pack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+void nxffs_schedpack(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_schedpack(v)
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
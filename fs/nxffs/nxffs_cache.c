@@ -128,6 +128,8 @@ int nxffs_wrcache(FAR struct nxffs_volume_s *volume)
 {
   size_t nxfrd;
 
+  nxffs_snapinvalidate(volume);
+
   /* Write the current block from the cache */
 
   nxfrd = MTD_BWRITE(volume->mtd, volume->cblock, 1, volume->cache);
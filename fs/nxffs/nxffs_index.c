@@ -0,0 +1,315 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_idxhash
+ *
+ * Description:
+ *   Return a 32-bit FNV-1a hash of the inode name.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_idxhash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxappend
+ *
+ * Description:
+ *   Add one entry to the index, growing it if necessary.  If memory cannot
+ *   be allocated, the index is discarded and -ENOMEM is returned.
+ *
+ ****************************************************************************/
+
+static int nxffs_idxappend(FAR struct nxffs_volume_s *volume,
+                           FAR const char *name, off_t hoffset)
+{
+  FAR struct nxffs_index_s *index;
+
+  if (volume->nindex >= volume->maxindex)
+    {
+      if (volume->maxindex > UINT16_MAX - NXFFS_INDEX_INCR)
+        {
+          nxffs_idxinvalidate(volume);
+          return -ENOMEM;
+        }
+
+      index = (FAR struct nxffs_index_s *)
+        kmm_realloc(volume->index, (volume->maxindex + NXFFS_INDEX_INCR) *
+                    sizeof(struct nxffs_index_s));
+      if (index == NULL)
+        {
+          ferr("ERROR: Failed to grow the inode index\n");
+          nxffs_idxinvalidate(volume);
+          return -ENOMEM;
+        }
+
+      volume->index     = index;
+      volume->maxindex += NXFFS_INDEX_INCR;
+    }
+
+  volume->index[volume->nindex].hash    = nxffs_idxhash(name);
+  volume->index[volume->nindex].hoffset = hoffset;
+  volume->nindex++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxbuild
+ *
+ * Description:
+ *   Scan the FLASH once, from the first valid inode to the end of the
+ *   written data, and add every valid inode to the index.
+ *
+ ****************************************************************************/
+
+static int nxffs_idxbuild(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  volume->nindex = 0;
+  offset = volume->inoffset;
+
+  for (; ; )
+    {
+      ret = nxffs_nextentry(volume, offset, &entry);
+      if (ret == -ENOENT)
+        {
+          break;
+        }
+      else if (ret < 0)
+        {
+          ferr("ERROR: nxffs_nextentry failed: %d\n", -ret);
+          nxffs_idxinvalidate(volume);
+          return ret;
+        }
+
+      ret = nxffs_idxappend(volume, entry.name, entry.hoffset);
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  finfo("Indexed %d inodes\n", volume->nindex);
+  volume->idxvalid = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_idxfind
+ *
+ * Description:
+ *   Look up an inode by name in the in-memory inode index, building the
+ *   index first if it is not valid.  Stale index entries found along the
+ *   way are discarded.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success; -ENOENT if there is no such inode.  Any
+ *   other negated errno value means that the index could not be used and
+ *   the caller must fall back to searching the FLASH.
+ *
+ ****************************************************************************/
+
+int nxffs_idxfind(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  FAR struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_index_s *index;
+  uint32_t hash;
+  int ret;
+  int i;
+
+  if (!volume->idxvalid)
+    {
+      ret = nxffs_idxbuild(volume);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  hash = nxffs_idxhash(name);
+  for (i = 0; i < volume->nindex; )
+    {
+      index = &volume->index[i];
+      if (index->hash != hash)
+        {
+          i++;
+          continue;
+        }
+
+      /* Re-read the inode header.  If the inode is no longer valid, the
+       * search continues with the next valid inode on FLASH, so anything
+       * other than an exact match at this offset means that the entry is
+       * stale.
+       */
+
+      ret = nxffs_nextentry(volume, index->hoffset, entry);
+      if (ret < 0 && ret != -ENOENT)
+        {
+          return ret;
+        }
+      else if (ret == OK)
+        {
+          if (entry->hoffset == index->hoffset)
+            {
+              if (strcmp(name, entry->name) == 0)
+                {
+                  return OK;
+                }
+
+              /* Just a hash collision with another valid inode */
+
+              nxffs_freeentry(entry);
+              i++;
+              continue;
+            }
+
+          nxffs_freeentry(entry);
+        }
+
+      finfo("Dropping stale index entry, offset: %d\n", index->hoffset);
+      *index = volume->index[--volume->nindex];
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nxffs_idxadd
+ *
+ * Description:
+ *   Add a newly written inode header to the index.
+ *
+ ****************************************************************************/
+
+void nxffs_idxadd(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                  off_t hoffset)
+{
+  if (volume->idxvalid)
+    {
+      (void)nxffs_idxappend(volume, name, hoffset);
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_idxremove
+ *
+ * Description:
+ *   Remove a deleted inode from the index.
+ *
+ ****************************************************************************/
+
+void nxffs_idxremove(FAR struct nxffs_volume_s *volume, off_t hoffset)
+{
+  int i;
+
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hoffset == hoffset)
+        {
+          volume->index[i] = volume->index[--volume->nindex];
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_idxinvalidate
+ *
+ * Description:
+ *   Discard the contents of the in-memory inode index.
+ *
+ ****************************************************************************/
+
+void nxffs_idxinvalidate(FAR struct nxffs_volume_s *volume)
+{
+  if (volume->index != NULL)
+    {
+      kmm_free(volume->index);
+    }
+
+  volume->index    = NULL;
+  volume->nindex   = 0;
+  volume->maxindex = 0;
+  volume->idxvalid = false;
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
@@ -194,6 +194,16 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
       goto errout_with_volume;
     }
 
+#ifdef CONFIG_NXFFS_SNAPSHOT
+  /* Remove the snapshot erase block from the end of the volume */
+
+  if (volume->geo.neraseblocks > 2)
+    {
+      volume->geo.neraseblocks--;
+      volume->snapblock = volume->geo.neraseblocks;
+    }
+#endif
+
   /* Allocate one I/O block buffer to general files system access */
 
   volume->cache = (FAR uint8_t *)kmm_malloc(volume->geo.blocksize);
@@ -225,6 +235,17 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   volume->nblocks = volume->geo.neraseblocks * volume->blkper;
   DEBUGASSERT((off_t)volume->blkper * volume->geo.blocksize == volume->geo.erasesize);
 
+#ifdef CONFIG_NXFFS_SNAPSHOT
+  /* If the volume was cleanly unmounted, then the snapshot saved at that
+   * time makes the scan of the FLASH unnecessary.
+   */
+
+  if (nxffs_snapload(volume) == OK)
+    {
+      return OK;
+    }
+#endif
+
 #ifdef CONFIG_NXFFS_SCAN_VOLUME
   /* Check if there is a valid NXFFS file system on the flash */
 
@@ -558,6 +579,25 @@ int nxffs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return -ENOSYS;
     }
 
-  return g_volume.ofiles ? -EBUSY : OK;
+  if (g_volume.ofiles)
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+  (void)work_cancel(LPWORK, &g_volume.packwork);
+#endif
+
+#ifdef CONFIG_NXFFS_SNAPSHOT
+  /* Save the mount snapshot for the next nxffs_initialize() */
+
+  if (sem_wait(&g_volume.exclsem) == OK)
+    {
+      (void)nxffs_snapsave(&g_volume);
+      sem_post(&g_volume.exclsem);
+    }
+#endif
+
+  return OK;
 #endif
 }
@@ -1171,6 +1171,10 @@ int nxffs_close(FAR struct file *filep)
       if ((ofile->oflags & O_WROK) != 0)
         {
           ret = nxffs_wrclose(volume, (FAR struct nxffs_wrfile_s *)ofile);
+
+          /* The file may have replaced an older one */
+
+          nxffs_schedpack(volume);
         }
 
       /* Release all resouces held by the open file */
@@ -1272,6 +1276,12 @@ int nxffs_wrinode(FAR struct nxffs_volume_s *volume,
       ferr("ERROR: Failed to write inode header block %d: %d\n",
            volume->ioblock, -ret);
     }
+#ifdef CONFIG_NXFFS_INDEX
+  else
+    {
+      nxffs_idxadd(volume, entry->name, entry->hoffset);
+    }
+#endif
 
   /* The volume is now available for other writers */
 
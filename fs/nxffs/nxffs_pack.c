@@ -42,12 +42,14 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <assert.h>
 #include <crc32.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 
 #include "nxffs.h"
 
@@ -1268,12 +1270,32 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
   struct nxffs_pack_s pack;
   FAR struct nxffs_wrfile_s *wrfile;
   off_t iooffset;
+  off_t endoffset;
   off_t eblock;
   off_t block;
   bool packed;
   int i;
   int ret = OK;
 
+  /* Inodes are about to move.  The inode index will be rebuilt on the next
+   * look-up.
+   */
+
+  nxffs_idxinvalidate(volume);
+  nxffs_snapinvalidate(volume);
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+  /* This removes all of the deleted inodes */
+
+  volume->dirty = false;
+#endif
+
+  /* Remember where the written data ends.  Erase blocks beyond that hold
+   * nothing but block headers and do not need to be re-written.
+   */
+
+  endoffset = volume->froffset;
+
   /* Get the offset to the first valid inode entry */
 
   wrfile = NULL;
@@ -1409,6 +1431,16 @@ start_pack:
 
       pack.block0 = eblock * volume->blkper;
 
+      /* If everything has been packed and the rest of the FLASH was never
+       * written since the last time it was erased, then we are done.
+       */
+
+      if (packed && wrfile == NULL &&
+          (off_t)pack.block0 * volume->geo.blocksize >= endoffset)
+        {
+          break;
+        }
+
 #ifndef CONFIG_NXFFS_NAND
       /* Read the erase block into the pack buffer.  We need to do this even
        * if we are overwriting the entire block so that we skip over
@@ -1601,3 +1633,82 @@ errout_with_pack:
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxffs_packworker
+ *
+ * Description:
+ *   Pack the volume from the low priority work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+static void nxffs_packworker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  FAR struct nxffs_ofile_s *ofile;
+  int ret;
+
+  ret = sem_wait(&volume->exclsem);
+  if (ret != OK)
+    {
+      ferr("ERROR: sem_wait failed: %d\n", get_errno());
+      return;
+    }
+
+  /* Leave the volume alone while it is being written; the writer will
+   * reschedule packing when it is closed.
+   */
+
+  for (ofile = volume->ofiles; ofile != NULL; ofile = ofile->flink)
+    {
+      if ((ofile->oflags & O_WROK) != 0)
+        {
+          goto errout_with_semaphore;
+        }
+    }
+
+  if (volume->dirty)
+    {
+      finfo("Background packing, froffset: %d\n", volume->froffset);
+
+      ret = nxffs_pack(volume);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to pack the volume: %d\n", -ret);
+        }
+    }
+
+errout_with_semaphore:
+  sem_post(&volume->exclsem);
+}
+#endif
+
+/****************************************************************************
+ * Name: nxffs_schedpack
+ *
+ * Description:
+ *   Schedule packing of the volume on the low priority work queue if
+ *   inodes have been deleted and the free FLASH at the end of the volume
+ *   has dropped below the threshold.
+ *
+ *   Must be called with the volume exclsem held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+void nxffs_schedpack(FAR struct nxffs_volume_s *volume)
+{
+  off_t volsize = volume->nblocks * volume->geo.blocksize;
+
+  if (volume->dirty &&
+      (volsize - volume->froffset) < volsize / 100 * CONFIG_NXFFS_BGPACK_FREEPCT)
+    {
+      /* (Re-)start the idle timer */
+
+      (void)work_cancel(LPWORK, &volume->packwork);
+      (void)work_queue(LPWORK, &volume->packwork, nxffs_packworker, volume,
+                       MSEC2TICK(CONFIG_NXFFS_BGPACK_DELAY));
+    }
+}
+#endif
@@ -280,6 +280,8 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
 
   /* Erase and reformat the entire volume */
 
+  nxffs_idxinvalidate(volume);
+  nxffs_snapinvalidate(volume);
   ret = nxffs_format(volume);
   if (ret < 0)
     {
@@ -0,0 +1,347 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_snapshot.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <crc32.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mtd/mtd.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_SNAPSHOT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* nindex value used when the snapshot does not include the inode index */
+
+#define NXFFS_SNAP_NOINDEX  0xffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The snapshot erase block holds this header, then the inode index entries
+ * (if the index was valid) and, in the last four bytes of the erase block,
+ * a copy of the generation number.  That copy is written last, so the
+ * snapshot is complete only if it matches the generation in the header.
+ */
+
+struct nxffs_snaphdr_s
+{
+  uint8_t  magic[NXFFS_MAGICSIZE]; /* g_snapmagic */
+  uint32_t generation;             /* Incremented by each snapshot */
+  uint32_t nblocks;                /* Number of R/W blocks on the volume */
+  uint32_t inoffset;               /* Offset to the first valid inode header */
+  uint32_t froffset;               /* Offset to the first free byte */
+  uint16_t nindex;                 /* Number of index entries that follow */
+  uint16_t entsize;                /* Size of one index entry */
+  uint32_t crc;                    /* CRC-32 of the header and entries */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint8_t g_snapmagic[NXFFS_MAGICSIZE] =
+{
+  'S', 'n', 'a', 'p'
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_snapcrc
+ *
+ * Description:
+ *   Return the CRC-32 of the snapshot header (up to the crc field) and of
+ *   the index entries that follow it in the volume->pack buffer.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_snapcrc(FAR struct nxffs_volume_s *volume,
+                              FAR const struct nxffs_snaphdr_s *hdr)
+{
+  size_t nbytes = 0;
+  uint32_t crc;
+
+  crc = crc32((FAR const uint8_t *)hdr,
+              offsetof(struct nxffs_snaphdr_s, crc));
+
+  if (hdr->nindex != NXFFS_SNAP_NOINDEX)
+    {
+      nbytes = (size_t)hdr->nindex * hdr->entsize;
+    }
+
+  return crc32part(&volume->pack[sizeof(struct nxffs_snaphdr_s)], nbytes,
+                   crc);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_snapload
+ *
+ * Description:
+ *   Restore the FLASH limits (and the inode index) from the snapshot saved
+ *   when the volume was last unmounted.
+ *
+ ****************************************************************************/
+
+int nxffs_snapload(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_snaphdr_s hdr;
+  uint32_t commit;
+  size_t maxbytes;
+  int nxfrd;
+
+  if (volume->snapblock == 0)
+    {
+      return -ENOENT;
+    }
+
+  /* Read the whole snapshot erase block into the pack buffer */
+
+  nxfrd = MTD_BREAD(volume->mtd, volume->snapblock * volume->blkper,
+                    volume->blkper, volume->pack);
+  if (nxfrd != volume->blkper)
+    {
+      ferr("ERROR: Read snapshot block %d failed: %d\n",
+           volume->snapblock, nxfrd);
+      return -EIO;
+    }
+
+  memcpy(&hdr, volume->pack, sizeof(struct nxffs_snaphdr_s));
+  memcpy(&commit, &volume->pack[volume->geo.erasesize - sizeof(uint32_t)],
+         sizeof(uint32_t));
+
+  if (memcmp(hdr.magic, g_snapmagic, NXFFS_MAGICSIZE) != 0)
+    {
+      finfo("No snapshot\n");
+      return -ENOENT;
+    }
+
+  maxbytes = volume->geo.erasesize - sizeof(struct nxffs_snaphdr_s) -
+             sizeof(uint32_t);
+
+  if (commit != hdr.generation ||
+      (hdr.nindex != NXFFS_SNAP_NOINDEX &&
+       (size_t)hdr.nindex * hdr.entsize > maxbytes) ||
+      nxffs_snapcrc(volume, &hdr) != hdr.crc)
+    {
+      fwarn("WARNING: Snapshot %lu is incomplete\n",
+            (unsigned long)hdr.generation);
+      return -EBADMSG;
+    }
+
+  if (hdr.nblocks != volume->nblocks ||
+      hdr.inoffset > hdr.froffset ||
+      hdr.froffset > volume->nblocks * volume->geo.blocksize)
+    {
+      fwarn("WARNING: Snapshot geometry mismatch\n");
+      return -ESTALE;
+    }
+
+  volume->inoffset = hdr.inoffset;
+  volume->froffset = hdr.froffset;
+
+#ifdef CONFIG_NXFFS_INDEX
+  /* Restore the inode index.  If there is not enough memory, it will be
+   * rebuilt on the first look-up.
+   */
+
+  nxffs_idxinvalidate(volume);
+  if (hdr.nindex != NXFFS_SNAP_NOINDEX &&
+      hdr.entsize == sizeof(struct nxffs_index_s))
+    {
+      uint16_t maxindex = (hdr.nindex + NXFFS_INDEX_INCR) &
+                          ~(NXFFS_INDEX_INCR - 1);
+
+      volume->index = (FAR struct nxffs_index_s *)
+        kmm_malloc(maxindex * sizeof(struct nxffs_index_s));
+
+      if (volume->index != NULL)
+        {
+          memcpy(volume->index, &volume->pack[sizeof(struct nxffs_snaphdr_s)],
+                 hdr.nindex * sizeof(struct nxffs_index_s));
+
+          volume->nindex   = hdr.nindex;
+          volume->maxindex = maxindex;
+          volume->idxvalid = true;
+        }
+    }
+#endif
+
+  /* The snapshot stays on the FLASH until the volume is modified */
+
+  volume->snapvalid = true;
+  volume->snapgen   = hdr.generation;
+
+  finfo("Loaded snapshot %lu: inoffset %d froffset %d\n",
+        (unsigned long)hdr.generation, volume->inoffset, volume->froffset);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_snapsave
+ *
+ * Description:
+ *   Save the FLASH limits (and the inode index, if it is valid and fits)
+ *   if the volume has been modified since the last snapshot was saved or
+ *   loaded.
+ *
+ ****************************************************************************/
+
+int nxffs_snapsave(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_snaphdr_s hdr;
+  uint32_t generation;
+  int nxfrd;
+  int ret;
+
+  if (volume->snapblock == 0 || volume->snapvalid)
+    {
+      return OK;
+    }
+
+  generation = volume->snapgen + 1;
+
+  memset(volume->pack, CONFIG_NXFFS_ERASEDSTATE, volume->geo.erasesize);
+  memset(&hdr, 0, sizeof(struct nxffs_snaphdr_s));
+  memcpy(hdr.magic, g_snapmagic, NXFFS_MAGICSIZE);
+  hdr.generation = generation;
+  hdr.nblocks    = volume->nblocks;
+  hdr.inoffset   = volume->inoffset;
+  hdr.froffset   = volume->froffset;
+  hdr.nindex     = NXFFS_SNAP_NOINDEX;
+
+#ifdef CONFIG_NXFFS_INDEX
+  hdr.entsize    = sizeof(struct nxffs_index_s);
+  if (volume->idxvalid &&
+      sizeof(struct nxffs_snaphdr_s) +
+      volume->nindex * sizeof(struct nxffs_index_s) + sizeof(uint32_t) <=
+      volume->geo.erasesize)
+    {
+      memcpy(&volume->pack[sizeof(struct nxffs_snaphdr_s)], volume->index,
+             volume->nindex * sizeof(struct nxffs_index_s));
+      hdr.nindex = volume->nindex;
+    }
+#endif
+
+  hdr.crc = nxffs_snapcrc(volume, &hdr);
+  memcpy(volume->pack, &hdr, sizeof(struct nxffs_snaphdr_s));
+  memcpy(&volume->pack[volume->geo.erasesize - sizeof(uint32_t)],
+         &generation, sizeof(uint32_t));
+
+  ret = MTD_ERASE(volume->mtd, volume->snapblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase snapshot block %d failed: %d\n",
+           volume->snapblock, ret);
+      return ret;
+    }
+
+  nxfrd = MTD_BWRITE(volume->mtd, volume->snapblock * volume->blkper,
+                     volume->blkper, volume->pack);
+  if (nxfrd != volume->blkper)
+    {
+      ferr("ERROR: Write snapshot block %d failed: %d\n",
+           volume->snapblock, nxfrd);
+      return -EIO;
+    }
+
+  volume->snapvalid = true;
+  volume->snapgen   = generation;
+
+  finfo("Saved snapshot %lu\n", (unsigned long)generation);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_snapinvalidate
+ *
+ * Description:
+ *   Erase the snapshot before the volume is first modified after the
+ *   snapshot was saved or loaded.
+ *
+ ****************************************************************************/
+
+void nxffs_snapinvalidate(FAR struct nxffs_volume_s *volume)
+{
+#ifdef CONFIG_MTD_BYTE_WRITE
+  uint8_t zeros[NXFFS_MAGICSIZE];
+#endif
+  int ret;
+
+  if (volume->snapvalid)
+    {
+      ret = MTD_ERASE(volume->mtd, volume->snapblock, 1);
+      if (ret < 0)
+        {
+          ferr("ERROR: Erase snapshot block %d failed: %d\n",
+               volume->snapblock, ret);
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+          /* Try to clear the snapshot magic instead */
+
+          memset(zeros, 0, NXFFS_MAGICSIZE);
+          (void)MTD_WRITE(volume->mtd,
+                          volume->snapblock * volume->geo.erasesize,
+                          NXFFS_MAGICSIZE, zeros);
+#endif
+        }
+
+      volume->snapvalid = false;
+    }
+}
+
+#endif /* CONFIG_NXFFS_SNAPSHOT */
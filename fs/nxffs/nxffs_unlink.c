@@ -129,6 +129,17 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       ferr("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+#if defined(CONFIG_NXFFS_INDEX) || defined(CONFIG_NXFFS_BACKGROUND_PACK)
+  else
+    {
+#ifdef CONFIG_NXFFS_INDEX
+      nxffs_idxremove(volume, entry.hoffset);
+#endif
+#ifdef CONFIG_NXFFS_BACKGROUND_PACK
+      volume->dirty = true;
+#endif
+    }
+#endif
 
 errout_with_entry:
   nxffs_freeentry(&entry);
@@ -166,6 +177,10 @@ int nxffs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Then remove the NXFFS inode */
 
   ret = nxffs_rminode(volume, relpath);
+  if (ret == OK)
+    {
+      nxffs_schedpack(volume);
+    }
 
   sem_post(&volume->exclsem);
 errout:
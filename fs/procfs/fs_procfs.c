@@ -79,6 +79,7 @@ extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations kmm_operations;
 extern const struct procfs_operations module_operations;
 extern const struct procfs_operations uptime_operations;
+extern const struct procfs_operations taskstats_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
  * deal with them here is not a good coupling. What is really needed is a
@@ -86,6 +87,10 @@ extern const struct procfs_operations uptime_operations;
  * configuration.
  */
 
+extern const struct procfs_operations critmon_procfsoperations;
+extern const struct procfs_operations irq_procfsoperations;
+extern const struct procfs_operations lockstat_procfsoperations;
+extern const struct procfs_operations wakelat_procfsoperations;
 extern const struct procfs_operations net_procfsoperations;
 extern const struct procfs_operations mtd_procfsoperations;
 extern const struct procfs_operations part_procfsoperations;
@@ -120,10 +125,22 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "cpuload",          &cpuload_operations },
 #endif
 
+#if defined(CONFIG_SCHED_CRITMONITOR) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CRITMON)
+  { "critmon",          &critmon_procfsoperations },
+#endif
+
+#if defined(CONFIG_SCHED_IRQMONITOR) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IRQ)
+  { "irqs",             &irq_procfsoperations },
+#endif
+
 #if defined(CONFIG_MM_KERNEL_HEAP) && !defined(CONFIG_FS_PROCFS_EXCLUDE_KMM)
   { "kmm",              &kmm_operations },
 #endif
 
+#if defined(CONFIG_SCHED_LOCKSTAT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+  { "locks",            &lockstat_procfsoperations },
+#endif
+
 #if defined(CONFIG_MODULE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   { "modules",          &module_operations },
 #endif
@@ -146,9 +163,18 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "partitions",       &part_procfsoperations },
 #endif
 
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_PROCESS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_TASKSTATS)
+  { "taskstats",        &taskstats_operations },
+#endif
+
 #if !defined(CONFIG_FS_PROCFS_EXCLUDE_UPTIME)
   { "uptime",           &uptime_operations },
 #endif
+
+#if defined(CONFIG_SCHED_WAKEUPLAT) && !defined(CONFIG_FS_PROCFS_EXCLUDE_WAKEUPLAT)
+  { "wakelat",          &wakelat_procfsoperations },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
@@ -69,7 +69,13 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CPULOAD_LINELEN 16
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
+/* The total load followed by one line per CPU */
+
+#  define CPULOAD_LINELEN (16 + 16 * CONFIG_SMP_NCPUS)
+#else
+#  define CPULOAD_LINELEN 16
+#endif
 
 /****************************************************************************
  * Private Types
@@ -226,13 +232,31 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
       struct cpuload_s cpuload;
       uint32_t intpart;
       uint32_t fracpart;
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
+      struct cpuload_s idle[CONFIG_SMP_NCPUS];
+      int cpu;
+
+      /* Every CPU is accounted.  The IDLE thread of CPU n has PID n; the
+       * system is idle for the sum of their times.
+       */
+
+      cpuload.total  = 0;
+      cpuload.active = 0;
 
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          DEBUGVERIFY(clock_cpuload(cpu, &idle[cpu]));
+          cpuload.total   = idle[cpu].total;
+          cpuload.active += idle[cpu].active;
+        }
+#else
       /* Sample the counts for the IDLE thread.  clock_cpuload should only
        * fail if the PID is not valid.  This, however, should never happen
        * for the IDLE thread.
        */
 
       DEBUGVERIFY(clock_cpuload(0, &cpuload));
+#endif
 
       /* On the simulator, you may hit cpuload.total == 0, but probably never on
        * real hardware.
@@ -242,7 +266,10 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
         {
           uint32_t tmp;
 
-          tmp      = 1000 - (1000 * cpuload.active) / cpuload.total;
+          /* The counts may be large with a high resolution clock */
+
+          tmp      = 1000 - (uint32_t)(((uint64_t)1000 * cpuload.active) /
+                                       cpuload.total);
           intpart  = tmp / 10;
           fracpart = tmp - 10 * intpart;
         }
@@ -255,6 +282,35 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
       linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%",
                           intpart, fracpart);
 
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
+      /* Then the load of each CPU.  Each CPU accounts for its share of
+       * the total.
+       */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          uint32_t share = cpuload.total / CONFIG_SMP_NCPUS;
+          uint32_t tmp;
+
+          if (share > 0 && idle[cpu].active <= share)
+            {
+              tmp      = 1000 - (uint32_t)(((uint64_t)1000 *
+                                            idle[cpu].active) / share);
+              intpart  = tmp / 10;
+              fracpart = tmp - 10 * intpart;
+            }
+          else
+            {
+              intpart  = 0;
+              fracpart = 0;
+            }
+
+          linesize += snprintf(&attr->line[linesize],
+                               CPULOAD_LINELEN - linesize,
+                               "\nCPU%d: %3d.%01d%%", cpu, intpart, fracpart);
+        }
+#endif
+
       /* Save the linesize in case we are re-entered with f_pos > 0 */
 
       attr->linesize = linesize;
@@ -105,6 +105,9 @@ enum proc_node_e
   PROC_LOADAVG,                       /* Average CPU utilization */
 #endif
   PROC_STACK,                         /* Task stack info */
+#ifdef CONFIG_MM_TRACE
+  PROC_HEAP,                          /* Task heap usage */
+#endif
   PROC_GROUP,                         /* Group directory */
   PROC_GROUP_STATUS,                  /* Task group status */
   PROC_GROUP_FD                       /* Group file descriptors */
@@ -145,9 +148,9 @@ struct proc_dir_s
  * Private Data
  ****************************************************************************/
 
-static FAR const char *g_policy[4] =
+static FAR const char *g_policy[5] =
 {
-  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER"
+  "SCHED_FIFO", "SCHED_RR", "SCHED_SPORADIC", "SCHED_OTHER", "SCHED_DEADLINE"
 };
 
 /****************************************************************************
@@ -171,6 +174,11 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
 static ssize_t proc_stack(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
+#ifdef CONFIG_MM_TRACE
+static ssize_t proc_heap(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
@@ -255,6 +263,13 @@ static const struct proc_node_s g_stack =
   "stack",        "stack",   (uint8_t)PROC_STACK,        DTYPE_FILE        /* Task stack info */
 };
 
+#ifdef CONFIG_MM_TRACE
+static const struct proc_node_s g_heap =
+{
+  "heap",         "heap",    (uint8_t)PROC_HEAP,         DTYPE_FILE        /* Task heap usage */
+};
+#endif
+
 static const struct proc_node_s g_group =
 {
   "group",        "group",   (uint8_t)PROC_GROUP,        DTYPE_DIRECTORY   /* Group directory */
@@ -280,6 +295,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
   &g_loadavg,      /* Average CPU utilization */
 #endif
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_MM_TRACE
+  &g_heap,         /* Task heap usage */
+#endif
   &g_group,        /* Group directory */
   &g_groupstatus,  /* Task group status */
   &g_groupfd       /* Group file descriptors */
@@ -296,6 +314,9 @@ static const struct proc_node_s * const g_level0info[] =
   &g_loadavg,      /* Average CPU utilization */
 #endif
   &g_stack,        /* Task stack info */
+#ifdef CONFIG_MM_TRACE
+  &g_heap,         /* Task heap usage */
+#endif
   &g_group,        /* Group directory */
 };
 #define PROC_NLEVEL0NODES (sizeof(g_level0info)/sizeof(FAR const struct proc_node_s * const))
@@ -380,7 +401,8 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
  *                                  {Unlock, Semaphore, Signal, MQ empty, MQ full}
  *   Flags:      xxx                N,P,X
  *   Priority:   nnn                Decimal, 0-255
- *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC, SCHED_OTHER}
+ *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC, SCHED_OTHER,
+ *                                   SCHED_DEADLINE}
  *   Sigmask:    nnnnnnnn           Hexadecimal, 32-bit
  *
  ****************************************************************************/
@@ -681,7 +703,10 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
     {
       uint32_t tmp;
 
-      tmp      = (1000 * cpuload.active) / cpuload.total;
+      /* The counts may be large with a high resolution clock */
+
+      tmp      = (uint32_t)(((uint64_t)1000 * cpuload.active) /
+                            cpuload.total);
       intpart  = tmp / 10;
       fracpart = tmp - 10 * intpart;
     }
@@ -760,6 +785,64 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: proc_heap
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TRACE
+static ssize_t proc_heap(FAR struct proc_file_s *procfile,
+                         FAR struct tcb_s *tcb, FAR char *buffer,
+                         size_t buflen, off_t offset)
+{
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Show the heap memory currently allocated by the thread */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "HeapLive:", (unsigned long)tcb->heap_live);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the peak heap usage */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "HeapPeak:", (unsigned long)tcb->heap_peak);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of allocations */
+
+  linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%lu\n",
+                        "HeapAllocs:", (unsigned long)tcb->heap_nallocs);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining, &offset);
+
+  totalsize += copysize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_groupstatus
  ****************************************************************************/
@@ -934,11 +1017,12 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile,
 
   /* Examine each open file descriptor */
 
-  for (i = 0, file = group->tg_filelist.fl_files; i < CONFIG_NFILE_DESCRIPTORS; i++, file++)
+  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       /* Is there an inode associated with the file descriptor? */
 
-      if (file->f_inode)
+      file = files_getfile(&group->tg_filelist, i);
+      if (file != NULL && file->f_inode)
         {
           linesize   = snprintf(procfile->line, STATUS_LINELEN, "%3d %8ld %04x\n",
                                 i, (long)file->f_pos, file->f_oflags);
@@ -1177,6 +1261,12 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_stack(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 
+#ifdef CONFIG_MM_TRACE
+    case PROC_HEAP: /* Task heap usage */
+      ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+
     case PROC_GROUP_STATUS: /* Task group status */
       ret = proc_groupstatus(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
@@ -0,0 +1,403 @@
+/****************************************************************************
+ * fs/procfs/fs_procfstaskstats.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_PROCESS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_TASKSTATS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct taskstats_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+};
+
+/* This structure describes the state of one snapshot */
+
+struct taskstats_snapshot_s
+{
+  FAR char *buffer;                  /* User buffer that receives the records */
+  unsigned int nrecords;             /* Number of records sampled */
+  unsigned int maxrecords;           /* Number of records that fit in the buffer */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     taskstats_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     taskstats_close(FAR struct file *filep);
+static ssize_t taskstats_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     taskstats_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     taskstats_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations taskstats_operations =
+{
+  taskstats_open,    /* open */
+  taskstats_close,   /* close */
+  taskstats_read,    /* read */
+  NULL,              /* write */
+  taskstats_dup,     /* dup */
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+  taskstats_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: taskstats_sample
+ *
+ * Description:
+ *   sched_foreach() callback.  Sample the TCB fields of one task.  This runs
+ *   inside a critical section so only the inexpensive fields are sampled
+ *   here.
+ *
+ ****************************************************************************/
+
+static void taskstats_sample(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct taskstats_snapshot_s *snapshot =
+    (FAR struct taskstats_snapshot_s *)arg;
+  struct procfs_taskstats_s record;
+
+  if (snapshot->nrecords >= snapshot->maxrecords)
+    {
+      return;
+    }
+
+  memset(&record, 0, sizeof(struct procfs_taskstats_s));
+  record.pid       = tcb->pid;
+  record.flags     = tcb->flags;
+  record.state     = tcb->task_state;
+  record.priority  = tcb->sched_priority;
+  record.stacksize = tcb->adj_stack_size;
+#ifdef CONFIG_MM_TRACE
+  record.heaplive  = tcb->heap_live;
+  record.heappeak  = tcb->heap_peak;
+#endif
+
+  /* The user buffer may not be aligned */
+
+  memcpy(&snapshot->buffer[snapshot->nrecords *
+                           sizeof(struct procfs_taskstats_s)],
+         &record, sizeof(struct procfs_taskstats_s));
+  snapshot->nrecords++;
+}
+
+/****************************************************************************
+ * Name: taskstats_complete
+ *
+ * Description:
+ *   Add the CPU load and the stack usage to a sampled record.  These take
+ *   longer to obtain so they are not sampled inside the critical section.
+ *   Pre-emption is still disabled, so the set of tasks does not change.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_STACK_COLORATION)
+static void taskstats_complete(FAR char *buffer)
+{
+  struct procfs_taskstats_s record;
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+#endif
+#ifdef CONFIG_STACK_COLORATION
+  FAR struct tcb_s *tcb;
+#endif
+
+  memcpy(&record, buffer, sizeof(struct procfs_taskstats_s));
+
+#ifdef CONFIG_SCHED_CPULOAD
+  if (clock_cpuload(record.pid, &cpuload) == OK)
+    {
+      record.cpuactive = cpuload.active;
+      record.cputotal  = cpuload.total;
+    }
+#endif
+
+#ifdef CONFIG_STACK_COLORATION
+  tcb = sched_gettcb(record.pid);
+  if (tcb != NULL)
+    {
+      record.stackused = up_check_tcbstack(tcb);
+    }
+#endif
+
+  memcpy(buffer, &record, sizeof(struct procfs_taskstats_s));
+}
+#endif
+
+/****************************************************************************
+ * Name: taskstats_open
+ ****************************************************************************/
+
+static int taskstats_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct taskstats_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "taskstats" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "taskstats") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = (FAR struct taskstats_file_s *)
+    kmm_zalloc(sizeof(struct taskstats_file_s));
+
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: taskstats_close
+ ****************************************************************************/
+
+static int taskstats_close(FAR struct file *filep)
+{
+  FAR struct taskstats_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct taskstats_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: taskstats_read
+ *
+ * Description:
+ *   Sample all tasks directly into the user buffer.  Only whole records are
+ *   returned; if the buffer is completely filled, there may have been more
+ *   tasks and the caller should retry with a larger buffer.  The whole
+ *   snapshot is returned by the first read(); subsequent reads return
+ *   end-of-file.
+ *
+ ****************************************************************************/
+
+static ssize_t taskstats_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  struct taskstats_snapshot_s snapshot;
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_STACK_COLORATION)
+  unsigned int i;
+#endif
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  if (filep->f_pos > 0)
+    {
+      return 0;
+    }
+
+  snapshot.buffer     = buffer;
+  snapshot.nrecords   = 0;
+  snapshot.maxrecords = buflen / sizeof(struct procfs_taskstats_s);
+
+  if (snapshot.maxrecords == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Keep the set of tasks stable for the whole snapshot */
+
+  sched_lock();
+  sched_foreach(taskstats_sample, &snapshot);
+
+#if defined(CONFIG_SCHED_CPULOAD) || defined(CONFIG_STACK_COLORATION)
+  for (i = 0; i < snapshot.nrecords; i++)
+    {
+      taskstats_complete(&buffer[i * sizeof(struct procfs_taskstats_s)]);
+    }
+#endif
+
+  sched_unlock();
+
+  ret = snapshot.nrecords * sizeof(struct procfs_taskstats_s);
+  filep->f_pos += ret;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: taskstats_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int taskstats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct taskstats_file_s *oldattr;
+  FAR struct taskstats_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct taskstats_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the attributes */
+
+  newattr = (FAR struct taskstats_file_s *)
+    kmm_malloc(sizeof(struct taskstats_file_s));
+
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct taskstats_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: taskstats_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int taskstats_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "taskstats" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "taskstats") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "taskstats" is the name for a read-only file */
+
+  buf->st_mode    = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  buf->st_size    = 0;
+  buf->st_blksize = 0;
+  buf->st_blocks  = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_FS_PROCFS_EXCLUDE_PROCESS && !CONFIG_FS_PROCFS_EXCLUDE_TASKSTATS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -95,6 +95,9 @@ static int     romfs_statfs(FAR struct inode *mountpt,
 
 static int     romfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                           FAR struct stat *buf);
+#ifdef CONFIG_FS_PAGECACHE
+static int     romfs_cachekey(FAR struct file *filep, FAR uintptr_t *key);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -130,7 +133,10 @@ const struct mountpt_operations romfs_operations =
   NULL,            /* mkdir */
   NULL,            /* rmdir */
   NULL,            /* rename */
-  romfs_stat       /* stat */
+  romfs_stat,      /* stat */
+#ifdef CONFIG_FS_PAGECACHE
+  romfs_cachekey   /* cachekey */
+#endif
 };
 
 /****************************************************************************
@@ -586,6 +592,38 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return -ENOTTY;
 }
 
+/****************************************************************************
+ * Name: romfs_cachekey
+ *
+ * Description:
+ *   The offset to the file data uniquely identifies a file on the volume.
+ *   There is no point in caching data from an XIP volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PAGECACHE
+static int romfs_cachekey(FAR struct file *filep, FAR uintptr_t *key)
+{
+  FAR struct romfs_mountpt_s *rm;
+  FAR struct romfs_file_s    *rf;
+
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
+
+  rf = filep->f_priv;
+  rm = filep->f_inode->i_private;
+
+  DEBUGASSERT(rm != NULL);
+
+  if (rm->rm_xipbase != NULL)
+    {
+      return -ENOSYS;
+    }
+
+  *key = rf->rf_startoffset;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_dup
  ****************************************************************************/
@@ -952,10 +990,7 @@ static int romfs_bind(FAR struct inode *blkdriver, FAR const void *data,
   return OK;
 
 errout_with_buffer:
-  if (!rm->rm_xipbase)
-    {
-      kmm_free(rm->rm_buffer);
-    }
+  romfs_hwunconfigure(rm);
 
 errout_with_sem:
   sem_destroy(&rm->rm_sem);
@@ -1030,10 +1065,7 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
       /* Release the mountpoint private data */
 
-      if (!rm->rm_xipbase && rm->rm_buffer)
-        {
-          kmm_free(rm->rm_buffer);
-        }
+      romfs_hwunconfigure(rm);
 
       sem_destroy(&rm->rm_sem);
       kmm_free(rm);
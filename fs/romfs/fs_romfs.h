@@ -119,6 +119,21 @@
 #define SEC_NSECTORS(r,o)    ((o) / (r)->rm_hwsectorsize)
 #define SEC_ALIGN(r,o)       ((o) & ~SEC_NDXMASK(r))
 
+/* Sector cache for volumes that are not directly accessible (non-XIP) */
+
+#ifndef CONFIG_FS_ROMFS_CACHE_NSECTORS
+#  define CONFIG_FS_ROMFS_CACHE_NSECTORS 0
+#endif
+
+#ifndef CONFIG_FS_ROMFS_READAHEAD
+#  define CONFIG_FS_ROMFS_READAHEAD 0
+#endif
+
+#if CONFIG_FS_ROMFS_READAHEAD >= CONFIG_FS_ROMFS_CACHE_NSECTORS && \
+    CONFIG_FS_ROMFS_CACHE_NSECTORS > 0
+#  error CONFIG_FS_ROMFS_READAHEAD must be less than CONFIG_FS_ROMFS_CACHE_NSECTORS
+#endif
+
 /* Maximum numbr of links that will be followed before we decide that there
  * is a problem.
  */
@@ -134,6 +149,14 @@
  * mounted with a fat32 filesystem.
  */
 
+#if CONFIG_FS_ROMFS_CACHE_NSECTORS > 0
+struct romfs_cachetag_s
+{
+  uint32_t ct_sector;               /* Sector held in this cache slot */
+  uint32_t ct_age;                  /* Value of rm_cacheage when last used */
+};
+#endif
+
 struct romfs_file_s;
 struct romfs_mountpt_s
 {
@@ -149,6 +172,12 @@ struct romfs_mountpt_s
   uint32_t rm_cachesector;          /* Current sector in the rm_buffer */
   uint8_t *rm_xipbase;              /* Base address of directly accessible media */
   uint8_t *rm_buffer;               /* Device sector buffer, allocated if rm_xipbase==0 */
+#if CONFIG_FS_ROMFS_CACHE_NSECTORS > 0
+  uint32_t rm_cacheage;             /* Incremented on each cache access */
+  uint32_t rm_lastsector;           /* Last sector read through the cache */
+  uint8_t *rm_cache;                /* Sector cache memory, allocated if rm_xipbase==0 */
+  struct romfs_cachetag_s rm_tags[CONFIG_FS_ROMFS_CACHE_NSECTORS];
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -208,6 +237,7 @@ int  romfs_hwread(FAR struct romfs_mountpt_s *rm, FAR uint8_t *buffer,
 int  romfs_filecacheread(FAR struct romfs_mountpt_s *rm,
        FAR struct romfs_file_s *rf, uint32_t sector);
 int  romfs_hwconfigure(FAR struct romfs_mountpt_s *rm);
+void romfs_hwunconfigure(FAR struct romfs_mountpt_s *rm);
 int  romfs_fsconfigure(FAR struct romfs_mountpt_s *rm);
 int  romfs_fileconfigure(FAR struct romfs_mountpt_s *rm,
        FAR struct romfs_file_s *rf);
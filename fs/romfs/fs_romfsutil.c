@@ -61,6 +61,106 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: romfs_cacheread
+ *
+ * Desciption:
+ *   Copy one sector into the caller's buffer through the sector cache.  On
+ *   a miss, the least recently used slot is replaced.  If the access is
+ *   sequential, up to CONFIG_FS_ROMFS_READAHEAD following sectors are read
+ *   into the following slots by the same device read.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_ROMFS_CACHE_NSECTORS > 0
+static int romfs_cacheread(FAR struct romfs_mountpt_s *rm,
+                           FAR uint8_t *buffer, uint32_t sector)
+{
+  uint32_t oldest;
+  uint32_t nread;
+  uint32_t i;
+  int slot;
+  int ret;
+
+  /* Look for the sector in the cache while picking the oldest slot */
+
+  oldest = 0;
+  slot   = 0;
+
+  for (i = 0; i < CONFIG_FS_ROMFS_CACHE_NSECTORS; i++)
+    {
+      if (rm->rm_tags[i].ct_sector == sector)
+        {
+          slot = i;
+          goto hit;
+        }
+
+      if ((uint32_t)(rm->rm_cacheage - rm->rm_tags[i].ct_age) > oldest)
+        {
+          oldest = rm->rm_cacheage - rm->rm_tags[i].ct_age;
+          slot   = i;
+        }
+    }
+
+  /* Miss.  Read ahead on sequential access, but never beyond the end of
+   * the cache memory or of the device.
+   */
+
+  nread = 1;
+
+#if CONFIG_FS_ROMFS_READAHEAD > 0
+  if (sector == rm->rm_lastsector + 1)
+    {
+      nread += CONFIG_FS_ROMFS_READAHEAD;
+      if (nread > CONFIG_FS_ROMFS_CACHE_NSECTORS - slot)
+        {
+          nread = CONFIG_FS_ROMFS_CACHE_NSECTORS - slot;
+        }
+
+      if (nread > rm->rm_hwnsectors - sector)
+        {
+          nread = rm->rm_hwnsectors - sector;
+        }
+    }
+#endif
+
+  /* Invalidate any slots that will be overwritten, and any other copies of
+   * the sectors being read.
+   */
+
+  for (i = 0; i < CONFIG_FS_ROMFS_CACHE_NSECTORS; i++)
+    {
+      if ((i >= slot && i < slot + nread) ||
+          (rm->rm_tags[i].ct_sector - sector) < nread)
+        {
+          rm->rm_tags[i].ct_sector = (uint32_t)-1;
+        }
+    }
+
+  ret = romfs_hwread(rm, &rm->rm_cache[slot * rm->rm_hwsectorsize],
+                     sector, nread);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nread; i++)
+    {
+      rm->rm_tags[slot + i].ct_sector = sector + i;
+      rm->rm_tags[slot + i].ct_age    = rm->rm_cacheage;
+    }
+
+hit:
+  rm->rm_tags[slot].ct_age = ++rm->rm_cacheage;
+  rm->rm_lastsector = sector;
+  memcpy(buffer, &rm->rm_cache[slot * rm->rm_hwsectorsize],
+         rm->rm_hwsectorsize);
+  return OK;
+}
+#else
+#  define romfs_cacheread(rm,b,s) romfs_hwread(rm,b,s,1)
+#endif
+
 /****************************************************************************
  * Name: romfs_swap32
  *
@@ -214,7 +314,7 @@ int16_t romfs_devcacheread(struct romfs_mountpt_s *rm, uint32_t offset)
         {
           /* In non-XIP mode, we will have to read the new sector. */
 
-          ret = romfs_hwread(rm, rm->rm_buffer, sector, 1);
+          ret = romfs_cacheread(rm, rm->rm_buffer, sector);
           if (ret < 0)
             {
                return (int16_t)ret;
@@ -463,8 +563,8 @@ int romfs_filecacheread(struct romfs_mountpt_s *rm, struct romfs_file_s *rf,
         {
           /* In non-XIP mode, we will have to read the new sector. */
 
-          finfo("Calling romfs_hwread\n");
-          ret = romfs_hwread(rm, rf->rf_buffer, sector, 1);
+          finfo("Calling romfs_cacheread\n");
+          ret = romfs_cacheread(rm, rf->rf_buffer, sector);
           if (ret < 0)
             {
               ferr("ERROR: romfs_hwread failed: %d\n", ret);
@@ -550,9 +650,54 @@ int romfs_hwconfigure(struct romfs_mountpt_s *rm)
       return -ENOMEM;
     }
 
+#if CONFIG_FS_ROMFS_CACHE_NSECTORS > 0
+  /* Allocate the sector cache.  Nothing is cached yet. */
+
+  rm->rm_cache = (FAR uint8_t *)
+    kmm_malloc(CONFIG_FS_ROMFS_CACHE_NSECTORS * rm->rm_hwsectorsize);
+  if (!rm->rm_cache)
+    {
+      kmm_free(rm->rm_buffer);
+      rm->rm_buffer = NULL;
+      return -ENOMEM;
+    }
+
+  memset(rm->rm_tags, 0xff, sizeof(rm->rm_tags));
+  rm->rm_cacheage   = 0;
+  rm->rm_lastsector = (uint32_t)-1;
+#endif
+
   return OK;
 }
 
+/****************************************************************************
+ * Name: romfs_hwunconfigure
+ *
+ * Desciption:
+ *   Free the buffers allocated by romfs_hwconfigure().
+ *
+ ****************************************************************************/
+
+void romfs_hwunconfigure(struct romfs_mountpt_s *rm)
+{
+  if (!rm->rm_xipbase)
+    {
+      if (rm->rm_buffer)
+        {
+          kmm_free(rm->rm_buffer);
+          rm->rm_buffer = NULL;
+        }
+
+#if CONFIG_FS_ROMFS_CACHE_NSECTORS > 0
+      if (rm->rm_cache)
+        {
+          kmm_free(rm->rm_cache);
+          rm->rm_cache = NULL;
+        }
+#endif
+    }
+}
+
 /****************************************************************************
  * Name: romfs_fsconfigure
  *
@@ -220,6 +220,25 @@
 #define CONFIG_SMARTFS_USE_SECTOR_BUFFER
 #endif
 
+/* Directory cache configuration */
+
+#ifdef CONFIG_SMARTFS_DIRCACHE
+#  ifndef CONFIG_SMARTFS_DIRCACHE_NDIRS
+#    define CONFIG_SMARTFS_DIRCACHE_NDIRS 8
+#  endif
+#  ifndef CONFIG_SMARTFS_DIRCACHE_MAXENTRIES
+#    define CONFIG_SMARTFS_DIRCACHE_MAXENTRIES 128
+#  endif
+
+/* Marks a cached file length that must be recomputed from the chain */
+
+#  define SMARTFS_DCLEN_UNKNOWN   0xffffffff
+#endif
+
+/* Sector map entries are allocated in groups of this size */
+
+#define SMARTFS_SMAP_INCR         16
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -307,8 +326,48 @@ struct smartfs_ofile_s
                                           * used field until the file is closed,
                                           * a seek, or more data is written that
                                           * causes the sector to change. */
+#ifdef CONFIG_SMARTFS_SECTORMAP
+  FAR uint16_t             *smap;       /* smap[n] holds file data starting at
+                                         * n * (availbytes - chain header) */
+  uint16_t                  smapcount;  /* Number of valid entries in smap */
+  uint16_t                  smapsize;   /* Number of allocated entries in smap */
+#endif
+};
+
+#ifdef CONFIG_SMARTFS_DIRCACHE
+/* This structure describes one active entry of a cached directory.  The
+ * entry name is held separately in the directory's name table.
+ */
+
+struct smartfs_dcentry_s
+{
+  uint16_t          firstsector;  /* Sector number of the name */
+  uint16_t          dsector;      /* Sector number of the directory entry */
+  uint16_t          doffset;      /* Offset of the directory entry */
+  uint16_t          flags;        /* Flags, including mode */
+  uint32_t          utc;          /* Time stamp */
+  uint32_t          datlen;       /* File length or SMARTFS_DCLEN_UNKNOWN */
 };
 
+/* This structure holds all of the active entries found in one directory
+ * sector chain.  A directory with more than
+ * CONFIG_SMARTFS_DIRCACHE_MAXENTRIES entries is represented by a
+ * placeholder with dc_overflow set so that it is not rescanned on each
+ * lookup.
+ */
+
+struct smartfs_dircache_s
+{
+  FAR struct smartfs_dircache_s *dc_flink;   /* Next in MRU order */
+  uint16_t                  dc_dirsector;    /* First sector of the directory */
+  uint16_t                  dc_nentries;     /* Number of entries in use */
+  uint16_t                  dc_nalloc;       /* Number of entries allocated */
+  bool                      dc_overflow;     /* Directory too large to cache */
+  FAR struct smartfs_dcentry_s *dc_entries;  /* Cached entries */
+  FAR char                 *dc_names;        /* namesize bytes per entry */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a smartfs filesystem.
@@ -327,6 +386,10 @@ struct smartfs_mountpt_s
   char                       *fs_rwbuffer;  /* Read/Write working buffer */
   char                       *fs_workbuffer;/* Working buffer */
   uint8_t                     fs_rootsector;/* Root directory sector num */
+#ifdef CONFIG_SMARTFS_DIRCACHE
+  FAR struct smartfs_dircache_s *fs_dircache; /* Cached directories, MRU first */
+  uint8_t                     fs_ndircache; /* Number of cached directories */
+#endif
 };
 
 /****************************************************************************
@@ -379,6 +442,31 @@ uint32_t smartfs_rdle32(FAR const void *val);
 
 void smartfs_wrle32(uint8_t *dest, uint32_t val);
 
+#ifdef CONFIG_SMARTFS_DIRCACHE
+/* Directory cache (smartfs_dircache.c) */
+
+FAR struct smartfs_dircache_s *smartfs_dircache_get(
+        FAR struct smartfs_mountpt_s *fs, uint16_t dirsector);
+
+FAR struct smartfs_dcentry_s *smartfs_dircache_lookup(
+        FAR struct smartfs_mountpt_s *fs, FAR struct smartfs_dircache_s *dc,
+        FAR const char *name);
+
+void smartfs_dircache_add(FAR struct smartfs_mountpt_s *fs,
+        uint16_t dirsector, FAR const struct smartfs_entry_s *entry);
+
+void smartfs_dircache_remove(FAR struct smartfs_mountpt_s *fs,
+        uint16_t dirsector, uint16_t dsector, uint16_t doffset);
+
+void smartfs_dircache_drop(FAR struct smartfs_mountpt_s *fs,
+        uint16_t dirsector);
+
+void smartfs_dircache_lenchanged(FAR struct smartfs_mountpt_s *fs,
+        uint16_t firstsector);
+
+void smartfs_dircache_release(FAR struct smartfs_mountpt_s *fs);
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 struct smartfs_mountpt_s* smartfs_get_first_mount(void);
 #endif
@@ -0,0 +1,571 @@
+/****************************************************************************
+ * fs/smartfs/smartfs_dircache.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "smartfs.h"
+
+#ifdef CONFIG_SMARTFS_DIRCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Cached entries are allocated in groups of this size */
+
+#define SMARTFS_DCENTRY_INCR 8
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smartfs_dircache_free
+ *
+ * Description: Free a cached directory and all of its entries.
+ *
+ ****************************************************************************/
+
+static void smartfs_dircache_free(FAR struct smartfs_dircache_s *dc)
+{
+  if (dc->dc_entries != NULL)
+    {
+      kmm_free(dc->dc_entries);
+    }
+
+  if (dc->dc_names != NULL)
+    {
+      kmm_free(dc->dc_names);
+    }
+
+  kmm_free(dc);
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_overflow
+ *
+ * Description: Discard the entries of a cached directory that cannot be
+ *   held in memory, leaving a placeholder that tells lookups to use the
+ *   FLASH copy instead.
+ *
+ ****************************************************************************/
+
+static void smartfs_dircache_overflow(FAR struct smartfs_dircache_s *dc)
+{
+  if (dc->dc_entries != NULL)
+    {
+      kmm_free(dc->dc_entries);
+      dc->dc_entries = NULL;
+    }
+
+  if (dc->dc_names != NULL)
+    {
+      kmm_free(dc->dc_names);
+      dc->dc_names = NULL;
+    }
+
+  dc->dc_nentries = 0;
+  dc->dc_nalloc   = 0;
+  dc->dc_overflow = true;
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_append
+ *
+ * Description: Append one entry to a cached directory.  Returns false if
+ *   the directory has grown too large or memory is exhausted.
+ *
+ ****************************************************************************/
+
+static bool smartfs_dircache_append(FAR struct smartfs_mountpt_s *fs,
+                                    FAR struct smartfs_dircache_s *dc,
+                                    FAR const struct smartfs_dcentry_s *dce,
+                                    FAR const char *name)
+{
+  FAR struct smartfs_dcentry_s *entries;
+  FAR char *names;
+  uint16_t namesize = fs->fs_llformat.namesize;
+  uint16_t nalloc;
+
+  if (dc->dc_nentries >= CONFIG_SMARTFS_DIRCACHE_MAXENTRIES)
+    {
+      return false;
+    }
+
+  if (dc->dc_nentries >= dc->dc_nalloc)
+    {
+      nalloc = MIN(dc->dc_nalloc + SMARTFS_DCENTRY_INCR,
+                   CONFIG_SMARTFS_DIRCACHE_MAXENTRIES);
+
+      entries = (FAR struct smartfs_dcentry_s *)
+        kmm_realloc(dc->dc_entries, nalloc * sizeof(struct smartfs_dcentry_s));
+      if (entries == NULL)
+        {
+          return false;
+        }
+
+      dc->dc_entries = entries;
+
+      names = (FAR char *)kmm_realloc(dc->dc_names, nalloc * namesize);
+      if (names == NULL)
+        {
+          return false;
+        }
+
+      dc->dc_names  = names;
+      dc->dc_nalloc = nalloc;
+    }
+
+  /* Names are held exactly as they are on FLASH:  namesize bytes, zero
+   * padded but not necessarily NUL terminated.
+   */
+
+  memcpy(&dc->dc_entries[dc->dc_nentries], dce,
+         sizeof(struct smartfs_dcentry_s));
+  strncpy(&dc->dc_names[dc->dc_nentries * namesize], name, namesize);
+  dc->dc_nentries++;
+  return true;
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_build
+ *
+ * Description: Read every sector of a directory chain and cache its active
+ *   entries.  This costs the same FLASH reads as one unsuccessful lookup.
+ *
+ ****************************************************************************/
+
+static FAR struct smartfs_dircache_s *
+smartfs_dircache_build(FAR struct smartfs_mountpt_s *fs, uint16_t dirsector)
+{
+  FAR struct smartfs_dircache_s *dc;
+  FAR struct smartfs_entry_header_s *entry;
+  FAR struct smartfs_chain_header_s *header;
+  struct smart_read_write_s readwrite;
+  struct smartfs_dcentry_s dce;
+  uint16_t entrysize;
+  uint16_t offset;
+  uint16_t sector;
+  int ret;
+
+  dc = (FAR struct smartfs_dircache_s *)
+    kmm_zalloc(sizeof(struct smartfs_dircache_s));
+  if (dc == NULL)
+    {
+      return NULL;
+    }
+
+  dc->dc_dirsector = dirsector;
+  entrysize = sizeof(struct smartfs_entry_header_s) + fs->fs_llformat.namesize;
+  header = (FAR struct smartfs_chain_header_s *)fs->fs_rwbuffer;
+
+  sector = dirsector;
+  while (sector != SMARTFS_ERASEDSTATE_16BIT && !dc->dc_overflow)
+    {
+      readwrite.logsector = sector;
+      readwrite.offset    = 0;
+      readwrite.count     = fs->fs_llformat.availbytes;
+      readwrite.buffer    = (uint8_t *)fs->fs_rwbuffer;
+      ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+      if (ret < 0)
+        {
+          ferr("ERROR: Error %d reading directory sector %d\n", ret, sector);
+          smartfs_dircache_free(dc);
+          return NULL;
+        }
+
+      offset = sizeof(struct smartfs_chain_header_s);
+      while (offset + entrysize < readwrite.count)
+        {
+          entry = (FAR struct smartfs_entry_header_s *)&fs->fs_rwbuffer[offset];
+
+          /* Only active entries are cached */
+
+#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
+          dce.flags = smartfs_rdle16(&entry->flags);
+#else
+          dce.flags = entry->flags;
+#endif
+          if (((dce.flags & SMARTFS_DIRENT_EMPTY) !=
+               (SMARTFS_ERASEDSTATE_16BIT & SMARTFS_DIRENT_EMPTY)) &&
+              ((dce.flags & SMARTFS_DIRENT_ACTIVE) ==
+               (SMARTFS_ERASEDSTATE_16BIT & SMARTFS_DIRENT_ACTIVE)))
+            {
+#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
+              dce.firstsector = smartfs_rdle16(&entry->firstsector);
+              dce.utc         = smartfs_rdle32(&entry->utc);
+#else
+              dce.firstsector = entry->firstsector;
+              dce.utc         = entry->utc;
+#endif
+              dce.dsector     = sector;
+              dce.doffset     = offset;
+              dce.datlen      = SMARTFS_DCLEN_UNKNOWN;
+
+              if (!smartfs_dircache_append(fs, dc, &dce, entry->name))
+                {
+                  smartfs_dircache_overflow(dc);
+                  break;
+                }
+            }
+
+          offset += entrysize;
+        }
+
+      sector = SMARTFS_NEXTSECTOR(header);
+    }
+
+  return dc;
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_find
+ *
+ * Description: Find a cached directory by its first sector.  The entry
+ *   that precedes it in the MRU list is returned in *prev.
+ *
+ ****************************************************************************/
+
+static FAR struct smartfs_dircache_s *
+smartfs_dircache_find(FAR struct smartfs_mountpt_s *fs, uint16_t dirsector,
+                      FAR struct smartfs_dircache_s **prev)
+{
+  FAR struct smartfs_dircache_s *dc;
+
+  *prev = NULL;
+  for (dc = fs->fs_dircache; dc != NULL; dc = dc->dc_flink)
+    {
+      if (dc->dc_dirsector == dirsector)
+        {
+          return dc;
+        }
+
+      *prev = dc;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_unlink
+ *
+ * Description: Remove a cached directory from the MRU list and free it.
+ *
+ ****************************************************************************/
+
+static void smartfs_dircache_unlink(FAR struct smartfs_mountpt_s *fs,
+                                    FAR struct smartfs_dircache_s *dc,
+                                    FAR struct smartfs_dircache_s *prev)
+{
+  if (prev == NULL)
+    {
+      fs->fs_dircache = dc->dc_flink;
+    }
+  else
+    {
+      prev->dc_flink = dc->dc_flink;
+    }
+
+  fs->fs_ndircache--;
+  smartfs_dircache_free(dc);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smartfs_dircache_get
+ *
+ * Description: Return the cached copy of the directory whose chain begins
+ *   at dirsector, reading the directory from FLASH if it is not already
+ *   cached.  NULL is returned if the directory cannot be cached; the
+ *   caller must then search the directory on FLASH.
+ *
+ *   This function uses fs->fs_rwbuffer.  The caller should hold the
+ *   mountpoint semaphore.
+ *
+ ****************************************************************************/
+
+FAR struct smartfs_dircache_s *smartfs_dircache_get(
+        FAR struct smartfs_mountpt_s *fs, uint16_t dirsector)
+{
+  FAR struct smartfs_dircache_s *dc;
+  FAR struct smartfs_dircache_s *prev;
+
+  dc = smartfs_dircache_find(fs, dirsector, &prev);
+  if (dc != NULL)
+    {
+      /* Make this the most recently used directory */
+
+      if (prev != NULL)
+        {
+          prev->dc_flink  = dc->dc_flink;
+          dc->dc_flink    = fs->fs_dircache;
+          fs->fs_dircache = dc;
+        }
+    }
+  else
+    {
+      dc = smartfs_dircache_build(fs, dirsector);
+      if (dc == NULL)
+        {
+          return NULL;
+        }
+
+      /* Evict the least recently used directory if the cache is full */
+
+      if (fs->fs_ndircache >= CONFIG_SMARTFS_DIRCACHE_NDIRS)
+        {
+          FAR struct smartfs_dircache_s *last = fs->fs_dircache;
+
+          prev = NULL;
+          while (last->dc_flink != NULL)
+            {
+              prev = last;
+              last = last->dc_flink;
+            }
+
+          smartfs_dircache_unlink(fs, last, prev);
+        }
+
+      dc->dc_flink    = fs->fs_dircache;
+      fs->fs_dircache = dc;
+      fs->fs_ndircache++;
+    }
+
+  return dc->dc_overflow ? NULL : dc;
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_lookup
+ *
+ * Description: Search a cached directory for name.  Names are compared
+ *   exactly as smartfs_finddirentry() compares them on FLASH.
+ *
+ ****************************************************************************/
+
+FAR struct smartfs_dcentry_s *smartfs_dircache_lookup(
+        FAR struct smartfs_mountpt_s *fs, FAR struct smartfs_dircache_s *dc,
+        FAR const char *name)
+{
+  uint16_t namesize = fs->fs_llformat.namesize;
+  uint16_t i;
+
+  for (i = 0; i < dc->dc_nentries; i++)
+    {
+      if (strncmp(&dc->dc_names[i * namesize], name, namesize) == 0)
+        {
+          return &dc->dc_entries[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_add
+ *
+ * Description: Record an entry just written to the directory whose chain
+ *   begins at dirsector.  Nothing is done if that directory is not cached.
+ *
+ ****************************************************************************/
+
+void smartfs_dircache_add(FAR struct smartfs_mountpt_s *fs,
+        uint16_t dirsector, FAR const struct smartfs_entry_s *entry)
+{
+  FAR struct smartfs_dircache_s *dc;
+  FAR struct smartfs_dircache_s *prev;
+  struct smartfs_dcentry_s dce;
+
+  dc = smartfs_dircache_find(fs, dirsector, &prev);
+  if (dc == NULL || dc->dc_overflow)
+    {
+      return;
+    }
+
+  /* The entry may refer to an existing sector chain (rename), so its
+   * length is not known here.
+   */
+
+  dce.firstsector = entry->firstsector;
+  dce.dsector     = entry->dsector;
+  dce.doffset     = entry->doffset;
+  dce.flags       = entry->flags;
+  dce.utc         = entry->utc;
+  dce.datlen      = SMARTFS_DCLEN_UNKNOWN;
+
+  if (!smartfs_dircache_append(fs, dc, &dce, entry->name))
+    {
+      smartfs_dircache_overflow(dc);
+    }
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_remove
+ *
+ * Description: Forget the entry at dsector/doffset in the directory whose
+ *   chain begins at dirsector, after it has been marked inactive on FLASH.
+ *
+ ****************************************************************************/
+
+void smartfs_dircache_remove(FAR struct smartfs_mountpt_s *fs,
+        uint16_t dirsector, uint16_t dsector, uint16_t doffset)
+{
+  FAR struct smartfs_dircache_s *dc;
+  FAR struct smartfs_dircache_s *prev;
+  uint16_t namesize = fs->fs_llformat.namesize;
+  uint16_t last;
+  uint16_t i;
+
+  dc = smartfs_dircache_find(fs, dirsector, &prev);
+  if (dc == NULL)
+    {
+      return;
+    }
+
+  /* An overflowed directory may fit now that it has shrunk */
+
+  if (dc->dc_overflow)
+    {
+      smartfs_dircache_unlink(fs, dc, prev);
+      return;
+    }
+
+  for (i = 0; i < dc->dc_nentries; i++)
+    {
+      if (dc->dc_entries[i].dsector == dsector &&
+          dc->dc_entries[i].doffset == doffset)
+        {
+          /* Entry order does not matter.  Move the last entry here. */
+
+          last = dc->dc_nentries - 1;
+          if (i != last)
+            {
+              memcpy(&dc->dc_entries[i], &dc->dc_entries[last],
+                     sizeof(struct smartfs_dcentry_s));
+              memcpy(&dc->dc_names[i * namesize],
+                     &dc->dc_names[last * namesize], namesize);
+            }
+
+          dc->dc_nentries--;
+          return;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_drop
+ *
+ * Description: Discard the cached copy of a directory that is being
+ *   deleted.
+ *
+ ****************************************************************************/
+
+void smartfs_dircache_drop(FAR struct smartfs_mountpt_s *fs,
+        uint16_t dirsector)
+{
+  FAR struct smartfs_dircache_s *dc;
+  FAR struct smartfs_dircache_s *prev;
+
+  dc = smartfs_dircache_find(fs, dirsector, &prev);
+  if (dc != NULL)
+    {
+      smartfs_dircache_unlink(fs, dc, prev);
+    }
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_lenchanged
+ *
+ * Description: Forget the cached length of the file whose chain begins at
+ *   firstsector.  Called when the file is opened or closed for writing.
+ *
+ ****************************************************************************/
+
+void smartfs_dircache_lenchanged(FAR struct smartfs_mountpt_s *fs,
+        uint16_t firstsector)
+{
+  FAR struct smartfs_dircache_s *dc;
+  uint16_t i;
+
+  for (dc = fs->fs_dircache; dc != NULL; dc = dc->dc_flink)
+    {
+      for (i = 0; i < dc->dc_nentries; i++)
+        {
+          if (dc->dc_entries[i].firstsector == firstsector)
+            {
+              dc->dc_entries[i].datlen = SMARTFS_DCLEN_UNKNOWN;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: smartfs_dircache_release
+ *
+ * Description: Free every cached directory.  Called on unmount.
+ *
+ ****************************************************************************/
+
+void smartfs_dircache_release(FAR struct smartfs_mountpt_s *fs)
+{
+  FAR struct smartfs_dircache_s *dc;
+
+  while ((dc = fs->fs_dircache) != NULL)
+    {
+      fs->fs_dircache = dc->dc_flink;
+      smartfs_dircache_free(dc);
+    }
+
+  fs->fs_ndircache = 0;
+}
+
+#endif /* CONFIG_SMARTFS_DIRCACHE */
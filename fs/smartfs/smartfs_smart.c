@@ -101,6 +101,13 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs,
                         struct smartfs_ofile_s *sf,
                         off_t offset, int whence);
 
+#ifdef CONFIG_SMARTFS_SECTORMAP
+static void  smartfs_smap_extend(struct smartfs_ofile_s *sf,
+                        uint16_t sector, uint16_t nextsector);
+static void  smartfs_smap_reset(struct smartfs_mountpt_s *fs,
+                        uint16_t firstsector);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -254,6 +261,12 @@ static int smartfs_open(FAR struct file *filep, const char *relpath,
                 {
                   goto errout_with_buffer;
                 }
+
+#ifdef CONFIG_SMARTFS_SECTORMAP
+              /* Other open instances can no longer trust their maps */
+
+              smartfs_smap_reset(fs, sf->entry.firstsector);
+#endif
             }
         }
     }
@@ -304,6 +317,11 @@ static int smartfs_open(FAR struct file *filep, const char *relpath,
   sf->curroffset = sizeof(struct smartfs_chain_header_s);
   sf->currsector = sf->entry.firstsector;
   sf->byteswritten = 0;
+#ifdef CONFIG_SMARTFS_SECTORMAP
+  sf->smap = NULL;
+  sf->smapcount = 0;
+  sf->smapsize = 0;
+#endif
 
   /* Test if we opened for APPEND mode.  If we did, then seek to the
    * end of the file.
@@ -329,6 +347,15 @@ static int smartfs_open(FAR struct file *filep, const char *relpath,
   sf->fnext = fs->fs_head;
   fs->fs_head = sf;
 
+#ifdef CONFIG_SMARTFS_DIRCACHE
+  /* The length of a file open for writing may change at any time */
+
+  if ((oflags & O_WROK) != 0)
+    {
+      smartfs_dircache_lenchanged(fs, sf->entry.firstsector);
+    }
+#endif
+
   ret = OK;
   goto errout_with_semaphore;
 
@@ -443,6 +470,22 @@ static int smartfs_close(FAR struct file *filep)
     }
 #endif
 
+#ifdef CONFIG_SMARTFS_SECTORMAP
+  if (sf->smap)
+    {
+      kmm_free(sf->smap);
+    }
+#endif
+
+#ifdef CONFIG_SMARTFS_DIRCACHE
+  /* Forget any length cached while the file was being written */
+
+  if ((sf->oflags & O_WROK) != 0)
+    {
+      smartfs_dircache_lenchanged(fs, sf->entry.firstsector);
+    }
+#endif
+
   kmm_free(sf);
 
 okout:
@@ -551,6 +594,17 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 
       if ((bytestoread == 0) || (sf->curroffset == fs->fs_llformat.availbytes))
         {
+#ifdef CONFIG_SMARTFS_SECTORMAP
+          /* Record the next sector if this one is full */
+
+          if (bytesinsector == fs->fs_llformat.availbytes -
+              sizeof(struct smartfs_chain_header_s))
+            {
+              smartfs_smap_extend(sf, sf->currsector,
+                                  SMARTFS_NEXTSECTOR(header));
+            }
+#endif
+
           /* Set the next sector as the current sector */
 
           sf->currsector = SMARTFS_NEXTSECTOR(header);
@@ -902,6 +956,9 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
               ferr("ERROR: Duplicate logical sector %d\n", sf->currsector);
             }
 
+#ifdef CONFIG_SMARTFS_SECTORMAP
+          smartfs_smap_extend(sf, sf->currsector, SMARTFS_NEXTSECTOR(header));
+#endif
           sf->bflags = SMARTFS_BFLAG_DIRTY;
           sf->currsector = SMARTFS_NEXTSECTOR(header);
           sf->curroffset = sizeof(struct smartfs_chain_header_s);
@@ -959,6 +1016,10 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer,
                   ferr("ERROR: Duplicate logical sector %d\n", sf->currsector);
                 }
 
+#ifdef CONFIG_SMARTFS_SECTORMAP
+              smartfs_smap_extend(sf, sf->currsector,
+                                  SMARTFS_NEXTSECTOR(header));
+#endif
               sf->currsector = SMARTFS_NEXTSECTOR(header);
               sf->curroffset = sizeof(struct smartfs_chain_header_s);
             }
@@ -973,6 +1034,103 @@ errout_with_semaphore:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smartfs_smap_extend
+ *
+ * Description: Record that nextsector follows sector in the file's sector
+ *              chain.  The caller must know that sector is full, so that
+ *              map entry n always holds the data beginning at file position
+ *              n * (availbytes - sizeof(struct smartfs_chain_header_s)).
+ *              Links that do not continue the map are ignored.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_SECTORMAP
+static void smartfs_smap_extend(struct smartfs_ofile_s *sf,
+                                uint16_t sector, uint16_t nextsector)
+{
+  uint16_t *smap;
+  uint16_t  needed;
+
+  if (nextsector == SMARTFS_ERASEDSTATE_16BIT)
+    {
+      return;
+    }
+
+  /* Map entry zero is always the first sector of the file */
+
+  if (sf->smapcount == 0)
+    {
+      if (sector != sf->entry.firstsector)
+        {
+          return;
+        }
+
+      needed = 2;
+    }
+  else
+    {
+      if (sf->smap[sf->smapcount - 1] != sector)
+        {
+          return;
+        }
+
+      needed = sf->smapcount + 1;
+    }
+
+  /* Grow the map if necessary.  If we run out of memory, then the map
+   * just stops growing and seeks walk the chain beyond it.
+   */
+
+  if (needed > sf->smapsize)
+    {
+      if (sf->smapsize > UINT16_MAX - SMARTFS_SMAP_INCR)
+        {
+          return;
+        }
+
+      smap = (uint16_t *)kmm_realloc(sf->smap, (sf->smapsize +
+                                     SMARTFS_SMAP_INCR) * sizeof(uint16_t));
+      if (smap == NULL)
+        {
+          return;
+        }
+
+      sf->smap = smap;
+      sf->smapsize += SMARTFS_SMAP_INCR;
+    }
+
+  if (sf->smapcount == 0)
+    {
+      sf->smap[sf->smapcount++] = sector;
+    }
+
+  sf->smap[sf->smapcount++] = nextsector;
+}
+
+/****************************************************************************
+ * Name: smartfs_smap_reset
+ *
+ * Description: Discard the sector maps of all open instances of the file
+ *              whose chain begins at firstsector.
+ *
+ ****************************************************************************/
+
+static void smartfs_smap_reset(struct smartfs_mountpt_s *fs,
+                               uint16_t firstsector)
+{
+  struct smartfs_ofile_s *sf;
+
+  for (sf = fs->fs_head; sf != NULL; sf = sf->fnext)
+    {
+      if (sf->entry.firstsector == firstsector)
+        {
+          sf->smapcount = 0;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_seek_internal
  *
@@ -992,6 +1150,10 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs,
   int                       ret;
   off_t                     newpos;
   off_t                     sectorstartpos;
+#ifdef CONFIG_SMARTFS_SECTORMAP
+  off_t                     datasize;
+  uint16_t                  index;
+#endif
 
   /* Test if this is a seek to get the current file pos */
 
@@ -1071,6 +1233,23 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs,
       sf->filepos = 0;
     }
 
+#ifdef CONFIG_SMARTFS_SECTORMAP
+  /* Use the sector map to skip as much of the chain as possible */
+
+  if (sf->smapcount > 0)
+    {
+      datasize = fs->fs_llformat.availbytes -
+                 sizeof(struct smartfs_chain_header_s);
+      index = MIN((newpos > 0 ? (newpos - 1) / datasize : 0),
+                  sf->smapcount - 1);
+      if (index * datasize >= sf->filepos)
+        {
+          sf->currsector = sf->smap[index];
+          sf->filepos = index * datasize;
+        }
+    }
+#endif
+
   header = (struct smartfs_chain_header_s *) fs->fs_rwbuffer;
   while ((sf->currsector != SMARTFS_ERASEDSTATE_16BIT) &&
       (sf->filepos + fs->fs_llformat.availbytes -
@@ -1090,6 +1269,14 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs,
           goto errout;
         }
 
+#ifdef CONFIG_SMARTFS_SECTORMAP
+      if (SMARTFS_USED(header) == fs->fs_llformat.availbytes -
+          sizeof(struct smartfs_chain_header_s))
+        {
+          smartfs_smap_extend(sf, sf->currsector, SMARTFS_NEXTSECTOR(header));
+        }
+#endif
+
       /* Point to next sector and update filepos */
 
       sf->currsector = SMARTFS_NEXTSECTOR(header);
@@ -2049,6 +2236,11 @@ int smartfs_rename(struct inode *mountpt, const char *oldrelpath,
                ret, readwrite.logsector);
           goto errout_with_semaphore;
         }
+
+#ifdef CONFIG_SMARTFS_DIRCACHE
+      smartfs_dircache_remove(fs, oldentry.dfirst, oldentry.dsector,
+                              oldentry.doffset);
+#endif
     }
   else
     {
@@ -45,6 +45,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <fcntl.h>
 #include <semaphore.h>
 #include <assert.h>
 #include <errno.h>
@@ -65,6 +66,84 @@
 static struct smartfs_mountpt_s *g_mounthead = NULL;
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: smartfs_chainlength
+ *
+ * Description: Scan a file's sectors to calculate its length and perform
+ *              a rudimentary check of the sector chain.
+ *
+ ****************************************************************************/
+
+static uint32_t smartfs_chainlength(struct smartfs_mountpt_s *fs,
+                                    uint16_t sector)
+{
+  struct smartfs_chain_header_s *header;
+  struct smart_read_write_s readwrite;
+  uint32_t datlen = 0;
+  int ret;
+
+  header = (struct smartfs_chain_header_s *) fs->fs_rwbuffer;
+  readwrite.count = sizeof(struct smartfs_chain_header_s);
+  readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+  readwrite.offset = 0;
+
+  while (sector != SMARTFS_ERASEDSTATE_16BIT)
+    {
+      /* Read the next sector of the file */
+
+      readwrite.logsector = sector;
+      ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long) &readwrite);
+      if (ret < 0)
+        {
+          ferr("ERROR: Error in sector chain at %d!\n", sector);
+          break;
+        }
+
+      /* Add used bytes to the total and point to next sector */
+
+      if (*((uint16_t *) header->used) != SMARTFS_ERASEDSTATE_16BIT)
+        {
+          datlen += *((uint16_t *) header->used);
+        }
+
+      sector = SMARTFS_NEXTSECTOR(header);
+    }
+
+  return datlen;
+}
+
+/****************************************************************************
+ * Name: smartfs_writeropen
+ *
+ * Description: Test if the file whose chain begins at firstsector is open
+ *              for writing.  The length of such a file may change at any
+ *              time and must not be taken from the directory cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_DIRCACHE
+static bool smartfs_writeropen(struct smartfs_mountpt_s *fs,
+                               uint16_t firstsector)
+{
+  struct smartfs_ofile_s *sf;
+
+  for (sf = fs->fs_head; sf != NULL; sf = sf->fnext)
+    {
+      if (sf->entry.firstsector == firstsector &&
+          (sf->oflags & O_WROK) != 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -350,6 +429,12 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
   int           found = FALSE;
 #endif
 
+#ifdef CONFIG_SMARTFS_DIRCACHE
+  /* Discard the cached directories */
+
+  smartfs_dircache_release(fs);
+#endif
+
 #if defined(CONFIG_SMARTFS_MULTI_ROOT_DIRS) || \
   (defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS))
   /* Start at the head of the mounts and search for our entry.  Also
@@ -494,6 +579,10 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
   struct      smartfs_chain_header_s *header;
   struct      smart_read_write_s readwrite;
   struct      smartfs_entry_header_s *entry;
+#ifdef CONFIG_SMARTFS_DIRCACHE
+  struct      smartfs_dircache_s *dc;
+  struct      smartfs_dcentry_s *dce;
+#endif
 
   /* Initialize directory level zero as the root sector */
 
@@ -577,6 +666,109 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
 
           dirsector = dirstack[depth];
 
+#ifdef CONFIG_SMARTFS_DIRCACHE
+          /* Search the cached copy of the directory if there is one */
+
+          dc = smartfs_dircache_get(fs, dirsector);
+          if (dc != NULL)
+            {
+              dce = smartfs_dircache_lookup(fs, dc, fs->fs_workbuffer);
+              if (dce == NULL)
+                {
+                  /* Entry not found!  Report the error the same way as the
+                   * search of the FLASH copy below.
+                   */
+
+                  if (*ptr == '\0')
+                    {
+                      *parentdirsector = dirsector;
+                      *filename = segment;
+                    }
+                  else
+                    {
+                      *parentdirsector = 0xFFFF;
+                      *filename = NULL;
+                    }
+
+                  ret = -ENOENT;
+                  goto errout;
+                }
+
+              if (*ptr == '\0')
+                {
+                  /* We are at the last segment.  Report the entry */
+
+                  direntry->firstsector = dce->firstsector;
+                  direntry->flags = dce->flags;
+                  direntry->utc = dce->utc;
+                  direntry->dsector = dce->dsector;
+                  direntry->doffset = dce->doffset;
+                  direntry->dfirst = dirsector;
+                  if (direntry->name == NULL)
+                    {
+                      direntry->name = (char *) kmm_malloc(fs->fs_llformat.namesize+1);
+                    }
+
+                  memset(direntry->name, 0, fs->fs_llformat.namesize + 1);
+                  strncpy(direntry->name,
+                          &dc->dc_names[(dce - dc->dc_entries) *
+                                        fs->fs_llformat.namesize],
+                          fs->fs_llformat.namesize);
+                  direntry->datlen = 0;
+
+                  /* The cached length of a file may only be used (or set)
+                   * when nobody can be changing it.
+                   */
+
+                  if ((dce->flags & SMARTFS_DIRENT_TYPE) ==
+                      SMARTFS_DIRENT_TYPE_FILE)
+                    {
+                      if (smartfs_writeropen(fs, dce->firstsector))
+                        {
+                          direntry->datlen =
+                            smartfs_chainlength(fs, dce->firstsector);
+                        }
+                      else
+                        {
+                          if (dce->datlen == SMARTFS_DCLEN_UNKNOWN)
+                            {
+                              dce->datlen =
+                                smartfs_chainlength(fs, dce->firstsector);
+                            }
+
+                          direntry->datlen = dce->datlen;
+                        }
+                    }
+
+                  *parentdirsector = dirsector;
+                  *filename = segment;
+                  ret = OK;
+                  goto errout;
+                }
+
+              /* Validate it's a directory */
+
+              if ((dce->flags & SMARTFS_DIRENT_TYPE) != SMARTFS_DIRENT_TYPE_DIR)
+                {
+                  ret = -ENOTDIR;
+                  goto errout;
+                }
+
+              /* "Push" the directory and continue searching */
+
+              if (depth >= CONFIG_SMARTFS_DIRDEPTH - 1)
+                {
+                  ret = -ENAMETOOLONG;
+                  goto errout;
+                }
+
+              dirstack[++depth] = dce->firstsector;
+              segment = ptr + 1;
+              ret = OK;
+              continue;
+            }
+#endif
+
           /* Read the directory */
 
           offset = 0xFFFF;
@@ -675,44 +867,11 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs,
                            * a rudimentary check.
                            */
 
-#ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
-                          if ((smartfs_rdle16(&entry->flags) & SMARTFS_DIRENT_TYPE) ==
+                          if ((direntry->flags & SMARTFS_DIRENT_TYPE) ==
                               SMARTFS_DIRENT_TYPE_FILE)
                             {
-                              dirsector = smartfs_rdle16(&entry->firstsector);
-#else
-                          if ((entry->flags & SMARTFS_DIRENT_TYPE) ==
-                              SMARTFS_DIRENT_TYPE_FILE)
-                            {
-                              dirsector = entry->firstsector;
-#endif
-                              readwrite.count = sizeof(struct smartfs_chain_header_s);
-                              readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
-                              readwrite.offset = 0;
-
-                              while (dirsector != SMARTFS_ERASEDSTATE_16BIT)
-                                {
-                                  /* Read the next sector of the file */
-
-                                  readwrite.logsector = dirsector;
-                                  ret = FS_IOCTL(fs, BIOC_READSECT,
-                                                 (unsigned long) &readwrite);
-                                  if (ret < 0)
-                                    {
-                                      ferr("ERROR: Error in sector chain at %d!\n",
-                                           dirsector);
-                                      break;
-                                    }
-
-                                  /* Add used bytes to the total and point to next sector */
-
-                                  if (*((uint16_t *) header->used) != SMARTFS_ERASEDSTATE_16BIT)
-                                    {
-                                      direntry->datlen += *((uint16_t *) header->used);
-                                    }
-
-                                  dirsector = SMARTFS_NEXTSECTOR(header);
-                                }
+                              direntry->datlen =
+                                smartfs_chainlength(fs, direntry->firstsector);
                             }
 
                           *parentdirsector = dirstack[depth];
@@ -1058,6 +1217,7 @@ int smartfs_createentry(FAR struct smartfs_mountpt_s *fs,
   direntry->firstsector = nextsector;
   direntry->dsector = psector;
   direntry->doffset = offset;
+  direntry->dfirst = parentdirsector;
 #ifdef CONFIG_SMARTFS_ALIGNED_ACCESS
   direntry->flags = smartfs_rdle16(&entry->flags);
   direntry->utc = smartfs_rdle32(&entry->utc);
@@ -1074,6 +1234,10 @@ int smartfs_createentry(FAR struct smartfs_mountpt_s *fs,
   memset(direntry->name, 0, fs->fs_llformat.namesize+1);
   strncpy(direntry->name, filename, fs->fs_llformat.namesize);
 
+#ifdef CONFIG_SMARTFS_DIRCACHE
+  smartfs_dircache_add(fs, parentdirsector, direntry);
+#endif
+
   ret = OK;
 
 errout:
@@ -1185,6 +1349,16 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs,
       goto errout;
     }
 
+#ifdef CONFIG_SMARTFS_DIRCACHE
+  /* Remove the entry from the directory cache */
+
+  smartfs_dircache_remove(fs, entry->dfirst, entry->dsector, entry->doffset);
+  if ((entry->flags & SMARTFS_DIRENT_TYPE) == SMARTFS_DIRENT_TYPE_DIR)
+    {
+      smartfs_dircache_drop(fs, entry->firstsector);
+    }
+#endif
+
   /* Test if any entries in this sector are being used */
 
   if ((entry->dsector != fs->fs_rootsector) &&
@@ -71,6 +71,23 @@
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+#ifndef CONFIG_FS_TMPFS_FILE_GROWTH
+#  define CONFIG_FS_TMPFS_FILE_GROWTH 0
+#endif
+
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+#  ifndef CONFIG_FS_TMPFS_DIRHASH_MINENTRIES
+#    define CONFIG_FS_TMPFS_DIRHASH_MINENTRIES 8
+#  endif
+
+   /* The initial size of a directory hash table and the average number of
+    * entries per hash chain that will cause the table to be doubled.
+    */
+
+#  define TMPFS_DIRHASH_MINBUCKETS 8
+#  define TMPFS_DIRHASH_LOAD       2
+#endif
+
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
 #define tmpfs_lock_directory(tdo) \
@@ -95,6 +112,20 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
             unsigned int nentries);
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
             size_t newsize);
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+static uint32_t tmpfs_dirhash_name(FAR const char *name);
+static void tmpfs_dirhash_link(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_dirhash_unlink(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_dirhash_grow(FAR struct tmpfs_directory_s *tdo);
+static void tmpfs_dirhash_free(FAR struct tmpfs_directory_s *tdo);
+#else
+#  define tmpfs_dirhash_unlink(tdo,index)
+#  define tmpfs_dirhash_free(tdo)
+#endif
+static void tmpfs_move_dirent(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index, unsigned int last);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -387,7 +418,12 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
            */
 
           delta = oldtfo->tfo_alloc - objsize;
+#if CONFIG_FS_TMPFS_FILE_GROWTH > 0
+          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD ||
+              delta <= newsize / 100 * (2 * CONFIG_FS_TMPFS_FILE_GROWTH))
+#else
           if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+#endif
             {
               /* Hasn't shrunk enough.. Return doing nothing for now */
 
@@ -398,10 +434,21 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
     }
 
   /* Added some additional amount to the new size to account frequent
-   * reallocations.
+   * reallocations.  When growing, the amount is scaled with the size of the
+   * file so that a file built up by many small appends is not copied in its
+   * entirety on every reallocation.
    */
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  delta = CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+#if CONFIG_FS_TMPFS_FILE_GROWTH > 0
+  if (objsize > oldtfo->tfo_alloc &&
+      newsize / 100 * CONFIG_FS_TMPFS_FILE_GROWTH > delta)
+    {
+      delta = newsize / 100 * CONFIG_FS_TMPFS_FILE_GROWTH;
+    }
+#endif
+
+  allocsize = objsize + delta;
 
   /* Realloc the file object */
 
@@ -424,6 +471,208 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_dirhash_name
+ *
+ * Description:
+ *   Hash a directory entry name (32-bit FNV-1a).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+static uint32_t tmpfs_dirhash_name(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_dirhash_link
+ *
+ * Description:
+ *   Add a directory entry to the head of its hash chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+static void tmpfs_dirhash_link(FAR struct tmpfs_directory_s *tdo,
+                               unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *bucket;
+
+  if (tdo->tdo_hash != NULL)
+    {
+      bucket        = &tdo->tdo_hash[tde->tde_hash & (tdo->tdo_nbuckets - 1)];
+      tde->tde_next = *bucket;
+      *bucket       = index;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_dirhash_unlink
+ *
+ * Description:
+ *   Remove a directory entry from its hash chain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+static void tmpfs_dirhash_unlink(FAR struct tmpfs_directory_s *tdo,
+                                 unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[index];
+  FAR uint16_t *link;
+
+  if (tdo->tdo_hash != NULL)
+    {
+      link = &tdo->tdo_hash[tde->tde_hash & (tdo->tdo_nbuckets - 1)];
+      while (*link != TMPFS_DIRHASH_NONE)
+        {
+          if (*link == index)
+            {
+              *link = tde->tde_next;
+              break;
+            }
+
+          link = &tdo->tdo_entry[*link].tde_next;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_dirhash_grow
+ *
+ * Description:
+ *   Called after a directory entry has been added at the end of the
+ *   directory.  Creates or doubles the hash table if the directory has
+ *   become too large for the current table and adds the new entry to the
+ *   table.  Failure to allocate a new table is not an error; lookups just
+ *   fall back to longer chains or to a linear search.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+static void tmpfs_dirhash_grow(FAR struct tmpfs_directory_s *tdo)
+{
+  FAR uint16_t *hash;
+  unsigned int nentries = tdo->tdo_nentries;
+  unsigned int nbuckets;
+  unsigned int i;
+
+  if (nentries < CONFIG_FS_TMPFS_DIRHASH_MINENTRIES ||
+      nentries <= TMPFS_DIRHASH_LOAD * (unsigned int)tdo->tdo_nbuckets ||
+      tdo->tdo_nbuckets >= 0x8000)
+    {
+      /* Just add the new entry to the existing table (if any) */
+
+      tmpfs_dirhash_link(tdo, nentries - 1);
+      return;
+    }
+
+  nbuckets = TMPFS_DIRHASH_MINBUCKETS;
+  while (TMPFS_DIRHASH_LOAD * nbuckets < nentries && nbuckets < 0x8000)
+    {
+      nbuckets <<= 1;
+    }
+
+  hash = (FAR uint16_t *)kmm_malloc(nbuckets * sizeof(uint16_t));
+  if (hash == NULL)
+    {
+      tmpfs_dirhash_link(tdo, nentries - 1);
+      return;
+    }
+
+  /* Replace the old table and re-hash all of the entries */
+
+  if (tdo->tdo_hash != NULL)
+    {
+      kmm_free(tdo->tdo_hash);
+    }
+
+  for (i = 0; i < nbuckets; i++)
+    {
+      hash[i] = TMPFS_DIRHASH_NONE;
+    }
+
+  tdo->tdo_hash     = hash;
+  tdo->tdo_nbuckets = nbuckets;
+
+  for (i = 0; i < nentries; i++)
+    {
+      tmpfs_dirhash_link(tdo, i);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_dirhash_free
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+static void tmpfs_dirhash_free(FAR struct tmpfs_directory_s *tdo)
+{
+  if (tdo->tdo_hash != NULL)
+    {
+      kmm_free(tdo->tdo_hash);
+      tdo->tdo_hash     = NULL;
+      tdo->tdo_nbuckets = 0;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_move_dirent
+ *
+ * Description:
+ *   Remove the directory entry at 'index' by replacing it with the final
+ *   directory entry at 'last'.  The name of the removed entry must already
+ *   have been freed.  The caller decrements the count of entries.
+ *
+ ****************************************************************************/
+
+static void tmpfs_move_dirent(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index, unsigned int last)
+{
+  FAR struct tmpfs_dirent_s *newtde;
+  FAR struct tmpfs_dirent_s *oldtde;
+  FAR struct tmpfs_object_s *to;
+
+  tmpfs_dirhash_unlink(tdo, index);
+
+  if (index != last)
+    {
+      tmpfs_dirhash_unlink(tdo, last);
+
+      /* Move the directory entry */
+
+      newtde             = &tdo->tdo_entry[index];
+      oldtde             = &tdo->tdo_entry[last];
+      to                 = oldtde->tde_object;
+
+      newtde->tde_object = to;
+      newtde->tde_name   = oldtde->tde_name;
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+      newtde->tde_hash   = oldtde->tde_hash;
+      tmpfs_dirhash_link(tdo, index);
+#endif
+
+      /* Reset the backward link to the directory entry */
+
+      to->to_dirent      = newtde;
+    }
+}
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -481,12 +730,45 @@ static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
 {
   int i;
 
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+  FAR struct tmpfs_dirent_s *tde;
+  uint32_t hash = tmpfs_dirhash_name(name);
+
+  /* Search only the hash chain if the directory has a hash table */
+
+  if (tdo->tdo_hash != NULL)
+    {
+      for (i = tdo->tdo_hash[hash & (tdo->tdo_nbuckets - 1)];
+           i != TMPFS_DIRHASH_NONE;
+           i = tde->tde_next)
+        {
+          tde = &tdo->tdo_entry[i];
+          if (tde->tde_hash == hash && strcmp(tde->tde_name, name) == 0)
+            {
+              return i;
+            }
+        }
+
+      return -ENOENT;
+    }
+
+  /* Otherwise, search the list of directory entries comparing the hashes
+   * before the names.
+   */
+
+  for (i = 0;
+       i < tdo->tdo_nentries &&
+       (tdo->tdo_entry[i].tde_hash != hash ||
+        strcmp(tdo->tdo_entry[i].tde_name, name) != 0);
+       i++);
+#else
   /* Search the list of directory entries for a match */
 
   for (i = 0;
        i < tdo->tdo_nentries &&
        strcmp(tdo->tdo_entry[i].tde_name, name) != 0;
        i++);
+#endif
 
   /* Return what we found, if anything */
 
@@ -521,25 +803,7 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
   /* Remove by replacing this entry with the final directory entry */
 
   last = tdo->tdo_nentries - 1;
-  if (index != last)
-    {
-      FAR struct tmpfs_dirent_s *newtde;
-      FAR struct tmpfs_dirent_s *oldtde;
-      FAR struct tmpfs_object_s *to;
-
-      /* Move the directory entry */
-
-      newtde             = &tdo->tdo_entry[index];
-      oldtde             = &tdo->tdo_entry[last];
-      to                 = oldtde->tde_object;
-
-      newtde->tde_object = to;
-      newtde->tde_name   = oldtde->tde_name;
-
-      /* Reset the backward link to the directory entry */
-
-      to->to_dirent      = newtde;
-    }
+  tmpfs_move_dirent(tdo, index, last);
 
   /* And decrement the count of directory entries */
 
@@ -593,6 +857,13 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
   tde->tde_object = to;
   tde->tde_name   = newname;
 
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+  /* Add the new entry to the hash table, resizing the table if needed */
+
+  tde->tde_hash   = tmpfs_dirhash_name(newname);
+  tmpfs_dirhash_grow(newtdo);
+#endif
+
   /* Add backward link to the directory entry to the object */
 
   to->to_dirent  = tde;
@@ -784,6 +1055,10 @@ static FAR struct tmpfs_directory_s *tmpfs_alloc_directory(void)
   tdo->tdo_type     = TMPFS_DIRECTORY;
   tdo->tdo_refs     = 0;
   tdo->tdo_nentries = 0;
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+  tdo->tdo_nbuckets = 0;
+  tdo->tdo_hash     = NULL;
+#endif
 
   tdo->tdo_exclsem.ts_holder = TMPFS_NO_HOLDER;
   tdo->tdo_exclsem.ts_count  = 0;
@@ -1222,23 +1497,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
   to   = tde->tde_object;
   last = tdo->tdo_nentries - 1;
 
-  if (index != last)
-    {
-      FAR struct tmpfs_dirent_s *oldtde;
-      FAR struct tmpfs_object_s *oldto;
-
-      /* Move the directory entry */
-
-      oldtde           = &tdo->tdo_entry[last];
-      oldto            = oldtde->tde_object;
-
-      tde->tde_object  = oldto;
-      tde->tde_name    = oldtde->tde_name;
-
-      /* Reset the backward link to the directory entry */
-
-      oldto->to_dirent = tde;
-    }
+  tmpfs_move_dirent(tdo, index, last);
 
   /* And decrement the count of directory entries */
 
@@ -1263,6 +1522,11 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
 
   /* Free the object now */
 
+  if (to->to_type == TMPFS_DIRECTORY)
+    {
+      tmpfs_dirhash_free((FAR struct tmpfs_directory_s *)to);
+    }
+
   sem_destroy(&to->to_exclsem.ts_sem);
   kmm_free(to);
   return TMPFS_DELETED;
@@ -2006,6 +2270,7 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Now we can destroy the root file system and the file system itself. */
 
+  tmpfs_dirhash_free(tdo);
   sem_destroy(&tdo->tdo_exclsem.ts_sem);
   kmm_free(tdo);
 
@@ -2291,6 +2556,7 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Free the directory object */
 
+  tmpfs_dirhash_free(tdo);
   sem_destroy(&tdo->tdo_exclsem.ts_sem);
   kmm_free(tdo);
 
@@ -58,6 +58,10 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* Marks the end of a directory hash chain */
+
+#define TMPFS_DIRHASH_NONE 0xffff
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -95,6 +99,10 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+  uint32_t tde_hash;     /* Hash of tde_name */
+  uint16_t tde_next;     /* Next entry in the same hash chain */
+#endif
 };
 
 /* The generic form of a TMPFS memory object */
@@ -125,6 +133,10 @@ struct tmpfs_directory_s
   /* Remaining fields are unique to a directory object */
 
   uint16_t tdo_nentries; /* Number of directory entries */
+#ifdef CONFIG_FS_TMPFS_DIRHASH
+  uint16_t tdo_nbuckets; /* Number of hash buckets (power of 2, 0=none) */
+  FAR uint16_t *tdo_hash; /* Index of the first entry in each hash chain */
+#endif
   struct tmpfs_dirent_s tdo_entry[1];
 };
 
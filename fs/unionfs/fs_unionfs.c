@@ -75,6 +75,32 @@
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 
+#ifndef CONFIG_FS_UNIONFS_LOOKUP_NENTRIES
+#  define CONFIG_FS_UNIONFS_LOOKUP_NENTRIES 0
+#endif
+
+#ifndef CONFIG_FS_UNIONFS_LOOKUP_NAMELEN
+#  define CONFIG_FS_UNIONFS_LOOKUP_NAMELEN 64
+#endif
+
+#ifndef CONFIG_FS_UNIONFS_DIRCACHE_NENTRIES
+#  define CONFIG_FS_UNIONFS_DIRCACHE_NENTRIES 32
+#endif
+
+/* Results of a lookup cache search (in addition to the file system index) */
+
+#define UNIONFS_LOOKUP_NONE  -1   /* The path is on neither file system */
+#define UNIONFS_LOOKUP_MISS  -2   /* The path is not in the cache */
+
+/* Directory entries are collected in chunks of this many entries */
+
+#define UNIONFS_DIRCACHE_CHUNK 8
+
+#if CONFIG_FS_UNIONFS_LOOKUP_NENTRIES < 1
+#  define unionfs_lookupfind(ui,p)     UNIONFS_LOOKUP_MISS
+#  define unionfs_lookupadd(ui,p,n)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -86,6 +112,31 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+/* This structure describes one cached lookup:  Which of the contained file
+ * systems holds the relative path.
+ */
+
+#if CONFIG_FS_UNIONFS_LOOKUP_NENTRIES > 0
+struct unionfs_lookup_s
+{
+  int8_t ul_ndx;                     /* File system index or UNIONFS_LOOKUP_NONE */
+  char ul_path[CONFIG_FS_UNIONFS_LOOKUP_NAMELEN];
+};
+#endif
+
+/* This structure describes the cached, merged listing of one directory */
+
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+struct unionfs_dircache_s
+{
+  FAR char *dc_relpath;              /* Directory path (NULL for the root) */
+  FAR struct dirent *dc_entries;     /* The merged directory entries */
+  uint16_t dc_nentries;              /* Number of directory entries */
+  uint16_t dc_crefs;                 /* Number of open directories using it */
+  bool dc_stale;                     /* True: Free when no longer used */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
@@ -94,6 +145,14 @@ struct unionfs_inode_s
   sem_t ui_exclsem;                  /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#if CONFIG_FS_UNIONFS_LOOKUP_NENTRIES > 0
+  uint8_t ui_lookupnext;             /* Next lookup cache entry to replace */
+  struct unionfs_lookup_s ui_lookup[CONFIG_FS_UNIONFS_LOOKUP_NENTRIES];
+#endif
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  uint32_t ui_generation;            /* Incremented when the caches are discarded */
+  FAR struct unionfs_dircache_s *ui_dircache; /* Most recent directory listing */
+#endif
 };
 
 /* This structure descries one opened file */
@@ -141,6 +200,23 @@ static int     unionfs_trystatfile(FAR struct inode *inode,
                  FAR const char *relpath, FAR const char *prefix);
 static FAR char *unionfs_relpath(FAR const char *path,
                  FAR const char *name);
+#if CONFIG_FS_UNIONFS_LOOKUP_NENTRIES > 0
+static int     unionfs_lookupfind(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath);
+static void    unionfs_lookupadd(FAR struct unionfs_inode_s *ui,
+                 FAR const char *relpath, int ndx);
+#endif
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+static void    unionfs_dirfree(FAR struct unionfs_dircache_s *dc);
+static void    unionfs_dirdiscard(FAR struct unionfs_inode_s *ui);
+static void    unionfs_dircollect(FAR struct fs_unionfsdir_s *fu,
+                 FAR const struct dirent *entry);
+static void    unionfs_dirpublish(FAR struct unionfs_inode_s *ui,
+                 FAR struct fs_unionfsdir_s *fu);
+#endif
+static void    unionfs_invalidate(FAR struct unionfs_inode_s *ui);
+static bool    unionfs_isduplicate(FAR struct unionfs_inode_s *ui,
+                 FAR struct fs_unionfsdir_s *fu, FAR const char *name);
 
 static int     unionfs_unbind_child(FAR struct unionfs_mountpt_s *um);
 static void    unionfs_destroy(FAR struct unionfs_inode_s *ui);
@@ -729,6 +805,361 @@ static FAR char *unionfs_relpath(FAR const char *path, FAR const char *name)
     }
 }
 
+/****************************************************************************
+ * Name: unionfs_lookupfind
+ *
+ * Description:
+ *   Return the index of the contained file system that holds the relative
+ *   path, UNIONFS_LOOKUP_NONE if the path is known to exist on neither, or
+ *   UNIONFS_LOOKUP_MISS if the path is not in the lookup cache.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUP_NENTRIES > 0
+static int unionfs_lookupfind(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath)
+{
+  int i;
+
+  if (relpath == NULL)
+    {
+      relpath = "";
+    }
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_NENTRIES; i++)
+    {
+      if (ui->ui_lookup[i].ul_ndx != UNIONFS_LOOKUP_MISS &&
+          strcmp(ui->ui_lookup[i].ul_path, relpath) == 0)
+        {
+          return ui->ui_lookup[i].ul_ndx;
+        }
+    }
+
+  return UNIONFS_LOOKUP_MISS;
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_lookupadd
+ *
+ * Description:
+ *   Remember the result of a lookup, replacing the cache entries in
+ *   round-robin order.  Paths too long for the cache are not remembered.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUP_NENTRIES > 0
+static void unionfs_lookupadd(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath, int ndx)
+{
+  FAR struct unionfs_lookup_s *entry;
+  int i;
+
+  if (relpath == NULL)
+    {
+      relpath = "";
+    }
+
+  if (strlen(relpath) >= CONFIG_FS_UNIONFS_LOOKUP_NAMELEN)
+    {
+      return;
+    }
+
+  /* Update an existing entry for the path or replace the oldest entry */
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_NENTRIES; i++)
+    {
+      entry = &ui->ui_lookup[i];
+      if (entry->ul_ndx != UNIONFS_LOOKUP_MISS &&
+          strcmp(entry->ul_path, relpath) == 0)
+        {
+          entry->ul_ndx = ndx;
+          return;
+        }
+    }
+
+  entry = &ui->ui_lookup[ui->ui_lookupnext];
+  if (++ui->ui_lookupnext >= CONFIG_FS_UNIONFS_LOOKUP_NENTRIES)
+    {
+      ui->ui_lookupnext = 0;
+    }
+
+  strcpy(entry->ul_path, relpath);
+  entry->ul_ndx = ndx;
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_dirfree
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+static void unionfs_dirfree(FAR struct unionfs_dircache_s *dc)
+{
+  if (dc->dc_relpath != NULL)
+    {
+      kmm_free(dc->dc_relpath);
+    }
+
+  if (dc->dc_entries != NULL)
+    {
+      kmm_free(dc->dc_entries);
+    }
+
+  kmm_free(dc);
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_dirdiscard
+ *
+ * Description:
+ *   Discard the cached directory listing.  If the listing is still being
+ *   returned to an open directory, it is freed when that directory is
+ *   closed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+static void unionfs_dirdiscard(FAR struct unionfs_inode_s *ui)
+{
+  FAR struct unionfs_dircache_s *dc = ui->ui_dircache;
+
+  if (dc != NULL)
+    {
+      ui->ui_dircache = NULL;
+      dc->dc_stale    = true;
+
+      if (dc->dc_crefs == 0)
+        {
+          unionfs_dirfree(dc);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_dircollect
+ *
+ * Description:
+ *   Save a copy of a directory entry returned by readdir().  The
+ *   collection is abandoned if the directory has too many entries or if
+ *   memory cannot be allocated for them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+static void unionfs_dircollect(FAR struct fs_unionfsdir_s *fu,
+                               FAR const struct dirent *entry)
+{
+  FAR struct dirent *entries;
+
+  if (fu->fu_nentries >= CONFIG_FS_UNIONFS_DIRCACHE_NENTRIES)
+    {
+      fu->fu_collect = false;
+      return;
+    }
+
+  if ((fu->fu_nentries % UNIONFS_DIRCACHE_CHUNK) == 0)
+    {
+      entries = (FAR struct dirent *)
+        kmm_realloc(fu->fu_entries, (fu->fu_nentries + UNIONFS_DIRCACHE_CHUNK) *
+                    sizeof(struct dirent));
+      if (entries == NULL)
+        {
+          fu->fu_collect = false;
+          return;
+        }
+
+      fu->fu_entries = entries;
+    }
+
+  memcpy(&fu->fu_entries[fu->fu_nentries], entry, sizeof(struct dirent));
+  fu->fu_nentries++;
+
+  if (fu->fu_ndx == 0)
+    {
+      fu->fu_nlower0++;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_dirpublish
+ *
+ * Description:
+ *   The enumeration of a directory has completed.  Make the collected
+ *   entries the cached listing of the union file system, unless something
+ *   was modified through the union file system in the meantime.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+static void unionfs_dirpublish(FAR struct unionfs_inode_s *ui,
+                               FAR struct fs_unionfsdir_s *fu)
+{
+  FAR struct unionfs_dircache_s *dc;
+
+  /* Don't publish the same collection twice */
+
+  fu->fu_collect = false;
+
+  (void)unionfs_semtake(ui, true);
+
+  if (fu->fu_generation != ui->ui_generation)
+    {
+      goto errout_with_semaphore;
+    }
+
+  dc = (FAR struct unionfs_dircache_s *)
+    kmm_zalloc(sizeof(struct unionfs_dircache_s));
+  if (dc == NULL)
+    {
+      goto errout_with_semaphore;
+    }
+
+  if (fu->fu_relpath != NULL)
+    {
+      dc->dc_relpath = strdup(fu->fu_relpath);
+      if (dc->dc_relpath == NULL)
+        {
+          kmm_free(dc);
+          goto errout_with_semaphore;
+        }
+    }
+
+  /* The cache takes over the collected entries */
+
+  dc->dc_entries  = fu->fu_entries;
+  dc->dc_nentries = fu->fu_nentries;
+  fu->fu_entries  = NULL;
+
+  unionfs_dirdiscard(ui);
+  ui->ui_dircache = dc;
+
+errout_with_semaphore:
+  unionfs_semgive(ui);
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_invalidate
+ *
+ * Description:
+ *   Discard the cached lookups and directory listing.  Called whenever a
+ *   path is created, removed or renamed through the union file system.
+ *
+ * Assumptions:
+ *   Caller holds the union file system semaphore.
+ *
+ ****************************************************************************/
+
+static void unionfs_invalidate(FAR struct unionfs_inode_s *ui)
+{
+#if CONFIG_FS_UNIONFS_LOOKUP_NENTRIES > 0
+  int i;
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_NENTRIES; i++)
+    {
+      ui->ui_lookup[i].ul_ndx = UNIONFS_LOOKUP_MISS;
+    }
+#endif
+
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  ui->ui_generation++;
+  unionfs_dirdiscard(ui);
+#endif
+}
+
+/****************************************************************************
+ * Name: unionfs_isduplicate
+ *
+ * Description:
+ *   Check if a directory entry on file system 2 is occluded by something of
+ *   the same name on file system 1.  On any failures, we just assume that
+ *   the entry is not a duplicate.
+ *
+ ****************************************************************************/
+
+static bool unionfs_isduplicate(FAR struct unionfs_inode_s *ui,
+                                FAR struct fs_unionfsdir_s *fu,
+                                FAR const char *name)
+{
+  FAR struct unionfs_mountpt_s *um0;
+  FAR char *relpath;
+  struct stat buf;
+  bool duplicate = false;
+  int ndx;
+  int ret;
+
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  /* If all of the entries of file system 1 were collected, then just
+   * search them.
+   */
+
+  if (fu->fu_collect && fu->fu_generation == ui->ui_generation)
+    {
+      int i;
+
+      for (i = 0; i < fu->fu_nlower0; i++)
+        {
+          if (strcmp(fu->fu_entries[i].d_name, name) == 0)
+            {
+              return true;
+            }
+        }
+
+      return false;
+    }
+#endif
+
+  /* Get the relative path to the same file on file system 1. */
+
+  relpath = unionfs_relpath(fu->fu_relpath, name);
+  if (relpath)
+    {
+      /* Check if anything exists at this path on file system 1.  readdir()
+       * is called without the semaphore, so get it for the lookup cache.
+       */
+
+      (void)unionfs_semtake(ui, true);
+
+      ndx = unionfs_lookupfind(ui, relpath);
+      if (ndx != UNIONFS_LOOKUP_MISS)
+        {
+          duplicate = (ndx == 0);
+        }
+      else
+        {
+          um0 = &ui->ui_fs[0];
+          ret = unionfs_trystat(um0->um_node, relpath, um0->um_prefix, &buf);
+          if (ret >= 0)
+            {
+              /* There is something there!
+               * REVISIT: We could allow files and directories to
+               * have duplicat names.
+               */
+
+              duplicate = true;
+            }
+          else if (ret == -ENOENT)
+            {
+              /* The entry just read from file system 2 is visible */
+
+              unionfs_lookupadd(ui, relpath, 1);
+            }
+        }
+
+      unionfs_semgive(ui);
+
+      /* Free the allocated relpath */
+
+      kmm_free(relpath);
+    }
+
+  return duplicate;
+}
+
 /****************************************************************************
  * Name: unionfs_unbind_child
  ****************************************************************************/
@@ -820,6 +1251,12 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
       kmm_free(ui->ui_fs[1].um_prefix);
     }
 
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  /* Free any cached directory listing */
+
+  unionfs_dirdiscard(ui);
+#endif
+
   /* And finally free the allocated unionfs state structure as well */
 
   sem_destroy(&ui->ui_exclsem);
@@ -836,6 +1273,8 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
   FAR struct unionfs_mountpt_s *um;
+  int ndx = UNIONFS_LOOKUP_MISS;
+  int ret0;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -853,6 +1292,24 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       return ret;
     }
 
+  /* Creating a file changes the results of lookups.  Otherwise, a cached
+   * lookup tells which file system holds the file.
+   */
+
+  if ((oflags & O_CREAT) != 0)
+    {
+      unionfs_invalidate(ui);
+    }
+  else
+    {
+      ndx = unionfs_lookupfind(ui, relpath);
+      if (ndx == UNIONFS_LOOKUP_NONE)
+        {
+          ret = -ENOENT;
+          goto errout_with_semaphore;
+        }
+    }
+
   /* Allocate a container to hold the open file system information */
 
   uf = (FAR struct unionfs_file_s *)kmm_malloc(sizeof(struct unionfs_file_s));
@@ -862,7 +1319,9 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_semaphore;
     }
 
-  /* Try to open the file on file system 1 */
+  /* Try to open the file on file system 1 (unless it is known to be only
+   * on file system 2).
+   */
 
   um = &ui->ui_fs[0];
   DEBUGASSERT(um != NULL && um->um_node != NULL && um->um_node->u.i_mops != NULL);
@@ -872,8 +1331,14 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   uf->uf_file.f_inode  = um->um_node;
   uf->uf_file.f_priv   = NULL;
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
-  if (ret >= 0)
+  ret0 = -ENOENT;
+  if (ndx != 1)
+    {
+      ret0 = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
+                             mode);
+    }
+
+  if (ret0 >= 0)
     {
       /* Successfully opened on file system 1 */
 
@@ -893,6 +1358,12 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
       if (ret < 0)
         {
+          if (ret == -ENOENT && ret0 == -ENOENT && (oflags & O_CREAT) == 0)
+            {
+              unionfs_lookupadd(ui, relpath, UNIONFS_LOOKUP_NONE);
+            }
+
+          kmm_free(uf);
           goto errout_with_semaphore;
         }
 
@@ -901,6 +1372,16 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       uf->uf_ndx = 1;
     }
 
+  /* Remember where the file was found.  If file system 1 failed to open
+   * an existing file (say, because it is read-only), the file on file
+   * system 2 must not be remembered as the visible one.
+   */
+
+  if (uf->uf_ndx == 0 || ret0 == -ENOENT)
+    {
+      unionfs_lookupadd(ui, relpath, uf->uf_ndx);
+    }
+
   /* Increment the open reference count */
 
   ui->ui_nopen++;
@@ -1321,6 +1802,9 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
   FAR struct fs_unionfsdir_s *fu;
   FAR const struct mountpt_operations *ops;
   FAR struct fs_dirent_s *lowerdir;
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  FAR struct unionfs_dircache_s *dc;
+#endif
   int ret;
 
   finfo("relpath: \"%s\"\n", relpath ? relpath : "NULL");
@@ -1341,6 +1825,29 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
   DEBUGASSERT(dir);
   fu = &dir->u.unionfs;
 
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  /* If the merged listing of this directory is cached, then return that
+   * without opening the directory on the contained file systems.
+   */
+
+  dc = ui->ui_dircache;
+  if (dc != NULL &&
+      (relpath == NULL || relpath[0] == '\0' ?
+       dc->dc_relpath == NULL :
+       dc->dc_relpath != NULL && strcmp(dc->dc_relpath, relpath) == 0))
+    {
+      dc->dc_crefs++;
+      fu->fu_cache    = dc;
+      fu->fu_nentries = 0;
+
+      ui->ui_nopen++;
+      DEBUGASSERT(ui->ui_nopen > 0);
+
+      unionfs_semgive(ui);
+      return OK;
+    }
+#endif
+
   /* Clone the path.  We will need this when we traverse file system 2 to
    * omit duplicates on file system 1.
    */
@@ -1443,6 +1950,15 @@ static int unionfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
         }
     }
 
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  /* Collect the entries for the directory cache.  Directories faked from
+   * the prefixes are not cached.
+   */
+
+  fu->fu_generation = ui->ui_generation;
+  fu->fu_collect    = !fu->fu_prefix[0] && !fu->fu_prefix[1];
+#endif
+
   /* Increment the number of open references and return success */
 
   ui->ui_nopen++;
@@ -1533,6 +2049,29 @@ static int unionfs_closedir(FAR struct inode *mountpt,
       kmm_free(fu->fu_relpath);
     }
 
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  /* Release the cached listing and free any collected entries */
+
+  if (fu->fu_cache != NULL)
+    {
+      FAR struct unionfs_dircache_s *dc =
+        (FAR struct unionfs_dircache_s *)fu->fu_cache;
+
+      if (--dc->dc_crefs == 0 && dc->dc_stale)
+        {
+          unionfs_dirfree(dc);
+        }
+
+      fu->fu_cache = NULL;
+    }
+
+  if (fu->fu_entries != NULL)
+    {
+      kmm_free(fu->fu_entries);
+      fu->fu_entries = NULL;
+    }
+#endif
+
   fu->fu_ndx      = 0;
   fu->fu_relpath  = NULL;
   fu->fu_lower[0] = NULL;
@@ -1579,6 +2118,28 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
   DEBUGASSERT(dir);
   fu = &dir->u.unionfs;
 
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  /* Return the next entry of a cached listing.  The listing cannot be
+   * freed while we hold a reference to it.
+   */
+
+  if (fu->fu_cache != NULL)
+    {
+      FAR struct unionfs_dircache_s *dc =
+        (FAR struct unionfs_dircache_s *)fu->fu_cache;
+
+      if (fu->fu_nentries >= dc->dc_nentries)
+        {
+          return -ENOENT;
+        }
+
+      memcpy(&dir->fd_dir, &dc->dc_entries[fu->fu_nentries],
+             sizeof(struct dirent));
+      dir->fd_position = ++fu->fu_nentries;
+      return OK;
+    }
+#endif
+
   /* Check if we are at the end of the the directory listing. */
 
   if (fu->fu_eod)
@@ -1762,36 +2323,8 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
           duplicate = false;
           if (ret >= 0 && fu->fu_ndx == 1 && fu->fu_lower[0] != NULL)
             {
-              /* Get the relative path to the same file on file system 1.
-               * NOTE: the on any failures we just assume that the filep
-               * is not a duplicate.
-               */
-
-              relpath = unionfs_relpath(fu->fu_relpath,
-                                        fu->fu_lower[1]->fd_dir.d_name);
-              if (relpath)
-                {
-                  int tmp;
-
-                  /* Check if anything exists at this path on file system 1 */
-
-                  um0 = &ui->ui_fs[0];
-                  tmp = unionfs_trystat(um0->um_node, relpath,
-                                        um0->um_prefix, &buf);
-                  if (tmp >= 0)
-                    {
-                      /* There is something there!
-                       * REVISIT: We could allow files and directories to
-                       * have duplicat names.
-                       */
-
-                      duplicate = true;
-                    }
-
-                  /* Free the allocated relpath */
-
-                  kmm_free(relpath);
-                }
+              duplicate =
+                unionfs_isduplicate(ui, fu, fu->fu_lower[1]->fd_dir.d_name);
             }
         }
       while (duplicate);
@@ -1804,6 +2337,22 @@ static int unionfs_readdir(struct inode *mountpt, struct fs_dirent_s *dir)
       memcpy(&dir->fd_dir, &fu->fu_lower[fu->fu_ndx]->fd_dir, sizeof(struct dirent));
     }
 
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  /* Collect the entry or, at the end of the directory, cache the listing */
+
+  if (fu->fu_collect)
+    {
+      if (ret >= 0)
+        {
+          unionfs_dircollect(fu, &dir->fd_dir);
+        }
+      else if (ret == -ENOENT)
+        {
+          unionfs_dirpublish(ui, fu);
+        }
+    }
+#endif
+
   return ret;
 }
 
@@ -1837,6 +2386,26 @@ static int unionfs_rewinddir(struct inode *mountpt, struct fs_dirent_s *dir)
   DEBUGASSERT(dir);
   fu = &dir->u.unionfs;
 
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  /* Rewinding a cached listing just returns to its first entry */
+
+  if (fu->fu_cache != NULL)
+    {
+      fu->fu_nentries  = 0;
+      dir->fd_position = 0;
+
+      unionfs_semgive(ui);
+      return OK;
+    }
+
+  /* Otherwise, start collecting the entries again */
+
+  fu->fu_nentries   = 0;
+  fu->fu_nlower0    = 0;
+  fu->fu_generation = ui->ui_generation;
+  fu->fu_collect    = !fu->fu_prefix[0] && !fu->fu_prefix[1];
+#endif
+
   /* Were we currently enumerating on file system 1?  If not, is an
    * enumeration possible on file system 1?
    */
@@ -2080,6 +2649,10 @@ static int unionfs_unlink(FAR struct inode *mountpt,
       return ret;
     }
 
+  /* The lookups and directory listings will change */
+
+  unionfs_invalidate(ui);
+
   /* Check if some exists at this path on file system 1.  This might be
    * a file or a directory
    */
@@ -2152,6 +2725,10 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
+  /* The lookups and directory listings will change */
+
+  unionfs_invalidate(ui);
+
   /* Is there anything with this name on either file system? */
 
   um  = &ui->ui_fs[0];
@@ -2225,6 +2802,10 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
       return ret;
     }
 
+  /* The lookups and directory listings will change */
+
+  unionfs_invalidate(ui);
+
   ret = -ENOENT;
 
   /* We really don't know any better so we will try to remove the directory
@@ -2300,6 +2881,10 @@ static int unionfs_rename(FAR struct inode *mountpt,
       return ret;
     }
 
+  /* The lookups and directory listings will change */
+
+  unionfs_invalidate(ui);
+
   DEBUGASSERT(oldrelpath != NULL && oldrelpath != NULL);
 
   /* Is there a file with this name on file system 1 */
@@ -2357,6 +2942,7 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+  int ndx;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2374,6 +2960,25 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
+  /* Check for a cached lookup of this path */
+
+  ndx = unionfs_lookupfind(ui, relpath);
+  if (ndx == 0 || ndx == 1)
+    {
+      um  = &ui->ui_fs[ndx];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          unionfs_semgive(ui);
+          return OK;
+        }
+    }
+  else if (ndx == UNIONFS_LOOKUP_NONE)
+    {
+      ret = -ENOENT;
+      goto check_prefix;
+    }
+
   /* stat this path on file system 1 */
 
   um  = &ui->ui_fs[0];
@@ -2384,6 +2989,7 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
        * shadow the second anyway.
        */
 
+      unionfs_lookupadd(ui, relpath, 0);
       unionfs_semgive(ui);
       return OK;
     }
@@ -2398,10 +3004,17 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
        * shadow the second anyway.
        */
 
+      unionfs_lookupadd(ui, relpath, 1);
       unionfs_semgive(ui);
       return OK;
     }
 
+  if (ret == -ENOENT)
+    {
+      unionfs_lookupadd(ui, relpath, UNIONFS_LOOKUP_NONE);
+    }
+
+check_prefix:
   /* Special case the unionfs root directory when both file systems are offset.
    * In that case, both of the above trystat calls will fail.
    */
@@ -2518,6 +3131,10 @@ int unionfs_mount(FAR const char *fspath1, FAR const char *prefix1,
 
   sem_init(&ui->ui_exclsem, 0, 1);
 
+  /* Start with empty caches */
+
+  unionfs_invalidate(ui);
+
   /* Get the inodes associated with fspath1 and fspath2 */
 
   ret = unionfs_getmount(fspath1, &ui->ui_fs[0].um_node);
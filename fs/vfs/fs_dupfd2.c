@@ -78,21 +78,38 @@ int fs_dupfd2(int fd1, int fd2)
 int dup2(int fd1, int fd2)
 #endif
 {
+  FAR struct filelist *list;
   FAR struct file *filep1;
   FAR struct file *filep2;
 
   /* Get the file structures corresponding to the file descriptors. */
 
   filep1 = fs_getfilep(fd1);
-  filep2 = fs_getfilep(fd2);
-
-  if (!filep1 || !filep2)
+  if (!filep1)
     {
       /* The errno value has already been set */
 
       return ERROR;
     }
 
+  /* fd2 need not be open, so its block of files may not exist yet */
+
+  list = sched_getfiles();
+  DEBUGASSERT(list != NULL);
+
+  if ((unsigned int)fd2 >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  filep2 = files_extend(list, fd2);
+  if (!filep2)
+    {
+      set_errno(EMFILE);
+      return ERROR;
+    }
+
   /* Verify that fd1 is a valid, open file descriptor */
 
   if (!DUP_ISOPEN(filep1))
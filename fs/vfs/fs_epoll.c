@@ -42,190 +42,605 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <queue.h>
 #include <errno.h>
-#include <string.h>
+#include <assert.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
 
 #ifndef CONFIG_DISABLE_POLL
 
 /****************************************************************************
- * Public Functions
+ * Private Types
+ ****************************************************************************/
+
+/* One file descriptor in the interest list.  The pollfd stays set up with
+ * the driver for as long as the descriptor is in the interest list:  The
+ * driver posts the epoll semaphore and sets revents when an event occurs.
+ * The node memory must therefore not move while it is registered.
+ */
+
+struct epoll_node_s
+{
+  FAR struct epoll_node_s *flink; /* Supports a singly linked list */
+  struct pollfd pfd;              /* The persistent poll registration */
+  epoll_data_t data;              /* User data returned by epoll_wait() */
+  pollevent_t  flags;             /* EPOLLET and/or EPOLLONESHOT */
+  bool         armed;             /* True: pfd is set up with the driver */
+};
+
+/* The state of one epoll instance.  This is the private data of the inode
+ * behind the epoll file descriptor.
+ */
+
+struct epoll_head_s
+{
+  sem_t exclsem;                  /* Exclusive access to the interest list */
+  sem_t waitsem;                  /* Posted by the drivers on events */
+  sq_queue_t nodes;               /* The interest list */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
  ****************************************************************************/
 
+static int epoll_fclose(FAR struct file *filep);
+
 /****************************************************************************
- * Name: epoll_create
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_epoll_ops =
+{
+  NULL,          /* open */
+  epoll_fclose,  /* close */
+  NULL,          /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  NULL,          /* ioctl */
+  NULL           /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL         /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR sem_t *sem)
+{
+  while (sem_wait(sem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+}
+
+#define epoll_semgive(sem) sem_post(sem)
+
+/****************************************************************************
+ * Name: epoll_gethead
  *
  * Description:
+ *   Return the epoll instance behind a file descriptor or NULL (with errno
+ *   set) if the descriptor does not refer to an epoll instance.
  *
- * Input Parameters:
+ ****************************************************************************/
+
+static FAR struct epoll_head_s *epoll_gethead(int epfd)
+{
+  FAR struct file *filep;
+
+  filep = fs_getfilep(epfd);
+  if (filep == NULL)
+    {
+      /* The errno value has already been set */
+
+      return NULL;
+    }
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_epoll_ops)
+    {
+      set_errno(EINVAL);
+      return NULL;
+    }
+
+  return (FAR struct epoll_head_s *)filep->f_inode->i_private;
+}
+
+/****************************************************************************
+ * Name: epoll_arm
  *
- * Returned Value:
+ * Description:
+ *   Set up (or tear down) the persistent poll on one file or socket
+ *   descriptor.
  *
  ****************************************************************************/
 
-int epoll_create(int size)
+static int epoll_arm(FAR struct epoll_node_s *node, bool setup)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  int fd = node->pfd.fd;
+  int ret;
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  if (setup == node->armed)
+    {
+      return OK;
+    }
 
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  if (setup)
+    {
+      node->pfd.revents = 0;
+      node->pfd.priv    = NULL;
+    }
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      ret = net_poll(fd, &node->pfd, setup);
+    }
+  else
+#endif
+    {
+      ret = fdesc_poll(fd, &node->pfd, setup);
+    }
+
+  if (ret >= 0 || !setup)
+    {
+      node->armed = setup;
+    }
 
-  return (int)((intptr_t)eph);
+  return ret;
 }
 
 /****************************************************************************
- * Name: epoll_close
+ * Name: epoll_find
+ ****************************************************************************/
+
+static FAR struct epoll_node_s *epoll_find(FAR struct epoll_head_s *eph,
+                                           int fd)
+{
+  FAR struct epoll_node_s *node;
+
+  for (node = (FAR struct epoll_node_s *)sq_peek(&eph->nodes);
+       node != NULL;
+       node = node->flink)
+    {
+      if (node->pfd.fd == fd)
+        {
+          return node;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Return the events that the drivers have posted since the last call.
+ *   No driver is called for descriptors without events, except that a
+ *   level-triggered descriptor that was reported is set up again so that
+ *   the driver reports it again if it is still ready.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_node_s *node;
+  pollevent_t revents;
+  irqstate_t flags;
+  int count = 0;
+
+  for (node = (FAR struct epoll_node_s *)sq_peek(&eph->nodes);
+       node != NULL && count < maxevents;
+       node = node->flink)
+    {
+      if (!node->armed)
+        {
+          continue;
+        }
+
+      /* Claim the events posted by the driver (perhaps from an interrupt
+       * handler).
+       */
+
+      flags             = enter_critical_section();
+      revents           = node->pfd.revents & node->pfd.events;
+      node->pfd.revents = 0;
+      leave_critical_section(flags);
+
+      if (revents == 0)
+        {
+          continue;
+        }
+
+      evs[count].data   = node->data;
+      evs[count].events = revents;
+      count++;
+
+      if ((node->flags & EPOLLONESHOT) != 0)
+        {
+          /* Disabled until re-armed with EPOLL_CTL_MOD */
+
+          (void)epoll_arm(node, false);
+        }
+      else if ((node->flags & EPOLLET) == 0)
+        {
+          /* Level-triggered:  Let the driver re-evaluate the state */
+
+          (void)epoll_arm(node, false);
+          (void)epoll_arm(node, true);
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: epoll_fclose
+ *
+ * Description:
+ *   Called when an epoll file descriptor is closed.  The instance is
+ *   destroyed when its last descriptor is closed; the inode itself is then
+ *   freed by inode_release().
+ *
+ ****************************************************************************/
+
+static int epoll_fclose(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+
+  DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+  if (inode->i_crefs > 1)
+    {
+      return OK;
+    }
+
+  eph = (FAR struct epoll_head_s *)inode->i_private;
+  while ((node = (FAR struct epoll_node_s *)sq_remfirst(&eph->nodes)) != NULL)
+    {
+      (void)epoll_arm(node, false);
+      kmm_free(node);
+    }
+
+  sem_destroy(&eph->waitsem);
+  sem_destroy(&eph->exclsem);
+  kmm_free(eph);
+
+  inode->i_private = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_create
  *
  * Description:
+ *   Create a new epoll instance and return a file descriptor referring to
+ *   it.
  *
  * Input Parameters:
+ *   size - Ignored, but must be greater than zero (as on Linux).
  *
  * Returned Value:
+ *   The new file descriptor on success; -1 (ERROR) on failure with errno
+ *   set appropriately.
  *
  ****************************************************************************/
 
-void epoll_close(int epfd)
+int epoll_create(int size)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+  FAR struct epoll_head_s *eph;
+  FAR struct inode *inode;
+  int errcode;
+  int fd;
+
+  if (size <= 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  /* The inode is not part of the inode tree.  It is marked deleted so that
+   * inode_release() frees it when the last file descriptor is closed.
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  inode = (FAR struct inode *)kmm_zalloc(FSNODE_SIZE(0));
+  if (inode == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout_with_eph;
+    }
+
+  sem_init(&eph->exclsem, 0, 1);
+  sem_init(&eph->waitsem, 0, 0);
+  sq_init(&eph->nodes);
+
+  inode->i_crefs    = 1;
+  inode->i_flags    = FSNODEFLAG_TYPE_DRIVER | FSNODEFLAG_DELETED;
+  inode->u.i_ops    = &g_epoll_ops;
+  inode->i_private  = eph;
+
+  fd = files_allocate(inode, O_RDOK, 0, 0);
+  if (fd < 0)
+    {
+      errcode = EMFILE;
+      goto errout_with_inode;
+    }
+
+  return fd;
 
-  kmm_free(eph->evs);
+errout_with_inode:
+  sem_destroy(&eph->waitsem);
+  sem_destroy(&eph->exclsem);
+  kmm_free(inode);
+errout_with_eph:
   kmm_free(eph);
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Close an epoll file descriptor.  Retained for compatibility; this is
+ *   the same as close(epfd).
+ *
+ ****************************************************************************/
+
+void epoll_close(int epfd)
+{
+  (void)close(epfd);
 }
 
 /****************************************************************************
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove a file descriptor in the interest list of an
+ *   epoll instance.  The descriptor is set up with its driver once, when it
+ *   is added, and torn down when it is removed.  A descriptor must be
+ *   removed before it is closed.
  *
  * Input Parameters:
+ *   epfd - The epoll file descriptor
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The events of interest (plus EPOLLET and/or EPOLLONESHOT) and
+ *          the user data to return with them.  Not used with EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with errno set
+ *   appropriately.
  *
  ****************************************************************************/
 
 int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  FAR struct epoll_node_s *node;
+  int ret;
+
+  eph = epoll_gethead(epfd);
+  if (eph == NULL)
+    {
+      return ERROR;
+    }
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  if (fd < 0 || fd == epfd || (op != EPOLL_CTL_DEL && ev == NULL))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  epoll_semtake(&eph->exclsem);
+  node = epoll_find(eph, fd);
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
+        finfo("%d CTL ADD: fd=%d ev=%02x\n", epfd, fd, ev->events);
+
+        if (node != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
+
+        node = (FAR struct epoll_node_s *)
+          kmm_zalloc(sizeof(struct epoll_node_s));
+        if (node == NULL)
+          {
+            ret = -ENOMEM;
+            break;
+          }
+
+        node->pfd.fd     = fd;
+        node->pfd.sem    = &eph->waitsem;
+        node->pfd.events = (ev->events & ~(EPOLLET | EPOLLONESHOT)) |
+                           POLLERR | POLLHUP;
+        node->flags      = ev->events & (EPOLLET | EPOLLONESHOT);
+        node->data       = ev->data;
+
+        ret = epoll_arm(node, true);
+        if (ret < 0)
+          {
+            kmm_free(node);
+            break;
+          }
+
+        sq_addlast((FAR sq_entry_t *)node, &eph->nodes);
+        break;
 
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+      case EPOLL_CTL_MOD:
+        finfo("%d CTL MOD: fd=%d ev=%02x\n", epfd, fd, ev->events);
 
-      case EPOLL_CTL_DEL:
-        {
-          int i;
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied-1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        /* Tear down and set up again so that the driver sees the new
+         * events.  This also re-arms an EPOLLONESHOT descriptor.
+         */
 
-          return -ENOENT;
-        }
+        (void)epoll_arm(node, false);
 
-      case EPOLL_CTL_MOD:
-        {
-          int i;
+        node->pfd.events = (ev->events & ~(EPOLLET | EPOLLONESHOT)) |
+                           POLLERR | POLLHUP;
+        node->flags      = ev->events & (EPOLLET | EPOLLONESHOT);
+        node->data       = ev->data;
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+        ret = epoll_arm(node, true);
+        break;
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
+      case EPOLL_CTL_DEL:
+        finfo("%d CTL DEL: fd=%d\n", epfd, fd);
+
+        if (node == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        (void)epoll_arm(node, false);
+        sq_rem((FAR sq_entry_t *)node, &eph->nodes);
+        kmm_free(node);
+        ret = OK;
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-          return -ENOENT;
-        }
+  epoll_semgive(&eph->exclsem);
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the descriptors in the interest list of an epoll
+ *   instance.  The drivers post the events to the instance as they occur,
+ *   so no poll set up or tear down is done here except to re-arm
+ *   level-triggered descriptors that were reported.
  *
  * Input Parameters:
+ *   epfd      - The epoll file descriptor
+ *   evs       - The location to return the events
+ *   maxevents - The maximum number of events to return
+ *   timeout   - The maximum time to wait in milliseconds.  Zero means do
+ *               not wait; a negative value means wait forever.
  *
  * Returned Value:
+ *   The number of events returned, zero on a timeout, or -1 (ERROR) on
+ *   failure with errno set appropriately.
  *
  ****************************************************************************/
 
 int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
-  /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
-   */
+  FAR struct epoll_head_s *eph;
+  systime_t start;
+  int count;
+  int ret;
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int rc;
-  int i;
+  eph = epoll_gethead(epfd);
+  if (eph == NULL)
+    {
+      return ERROR;
+    }
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  if (evs == NULL || maxevents <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
 
-  if (rc <= 0)
+  start = clock_systimer();
+  for (; ; )
     {
-      if (rc < 0)
+      epoll_semtake(&eph->exclsem);
+      count = epoll_collect(eph, evs, maxevents);
+      epoll_semgive(&eph->exclsem);
+
+      if (count > 0 || timeout == 0)
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          return count;
+        }
+
+      /* Wait for the next event.  The semaphore may have been posted for
+       * events already collected, so there may be nothing to return after
+       * waking up.
+       */
 
-          for (i = 0; i < eph->occupied; i++)
+      if (timeout > 0)
+        {
+          ret = sem_tickwait(&eph->waitsem, start, MSEC2TICK(timeout));
+          if (ret == -ETIMEDOUT)
             {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
+              return 0;
             }
         }
+      else
+        {
+          ret = sem_wait(&eph->waitsem) < 0 ? -get_errno() : OK;
+        }
 
-      return rc;
-    }
-
-  for (i = 0; i < rc; i++)
-    {
-      evs[i].data.fd = (pollevent_t)eph->evs[i].data.fd;
-      evs[i].events = (pollevent_t)eph->evs[i].revents;
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
     }
-
-  return rc;
 }
 
 #endif /* CONFIG_DISABLE_POLL */
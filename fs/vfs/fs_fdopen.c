@@ -249,8 +249,18 @@ FAR struct file_struct *fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb)
 
           stream->fs_bufend  = &stream->fs_bufstart[CONFIG_STDIO_BUFFER_SIZE];
           stream->fs_bufpos  = stream->fs_bufstart;
-          stream->fs_bufpos  = stream->fs_bufstart;
           stream->fs_bufread = stream->fs_bufstart;
+
+#ifdef CONFIG_STDIO_LINEBUFFER
+          /* Text streams are line buffered by default.  In binary mode, the
+           * newline has no special meaning.
+           */
+
+          if ((oflags & O_BINARY) == 0)
+            {
+              stream->fs_flags = __FS_FLAG_LBF;
+            }
+#endif
 #endif
           /* Save the file description and open flags.  Setting the
            * file descriptor locks this stream.
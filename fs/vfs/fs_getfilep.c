@@ -77,6 +77,7 @@
 FAR struct file *fs_getfilep(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
   int errcode;
 
   if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
@@ -104,9 +105,19 @@ FAR struct file *fs_getfilep(int fd)
       goto errout;
     }
 
-  /* And return the file pointer from the list */
+  /* And return the file pointer from the list.  No lock is needed:  The
+   * block holding the file is never freed while the list is in use.  If
+   * the block was never allocated, then the descriptor is not open.
+   */
+
+  filep = files_getfile(list, fd);
+  if (filep == NULL)
+    {
+      errcode = EBADF;
+      goto errout;
+    }
 
-  return &list->fl_files[fd];
+  return filep;
 
 errout:
   set_errno(errcode);
@@ -233,6 +233,17 @@ int open(const char *path, int oflags, ...)
       goto errout_with_fd;
     }
 
+#ifdef CONFIG_FS_PAGECACHE
+  /* Opening a file for writing may truncate it or may create a new file
+   * that re-uses the key of a deleted file.
+   */
+
+  if (INODE_IS_MOUNTPT(inode) && (oflags & O_WROK) != 0)
+    {
+      pagecache_invalidate(inode, filep);
+    }
+#endif
+
 #ifdef CONFIG_PSEUDOTERM_SUSV1
   /* If the return value from the open method is > 0, then it may actually
    * be an encoded file descriptor.  This kind of logic is currently only
@@ -0,0 +1,410 @@
+/****************************************************************************
+ * fs/vfs/fs_pagecache.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_PAGECACHE_NPAGES
+#  define CONFIG_FS_PAGECACHE_NPAGES 8
+#endif
+
+#ifndef CONFIG_FS_PAGECACHE_PAGESIZE
+#  define CONFIG_FS_PAGECACHE_PAGESIZE 512
+#endif
+
+#define PAGECACHE_BUFFER(n) \
+  (&g_pagecache.pc_buffer[(n) * CONFIG_FS_PAGECACHE_PAGESIZE])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Describes the contents of one page of the cache */
+
+struct pagecache_page_s
+{
+  FAR struct inode *pg_inode;   /* Mountpoint inode (NULL if unused) */
+  uintptr_t pg_key;             /* File key returned by cachekey() */
+  off_t     pg_offset;          /* File offset of the page */
+  uint32_t  pg_age;             /* Time of last access (for LRU) */
+  uint16_t  pg_nbytes;          /* Valid bytes (< page size at end-of-file) */
+};
+
+/* The state of the page cache */
+
+struct pagecache_s
+{
+  sem_t     pc_exclsem;         /* Exclusive access to the cache */
+  uint32_t  pc_age;             /* Current access time */
+  FAR uint8_t *pc_buffer;       /* Page memory (allocated on first use) */
+  struct pagecache_page_s pc_pages[CONFIG_FS_PAGECACHE_NPAGES];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pagecache_s g_pagecache =
+{
+  SEM_INITIALIZER(1)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_semtake and pagecache_semgive
+ ****************************************************************************/
+
+static void pagecache_semtake(void)
+{
+  while (sem_wait(&g_pagecache.pc_exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      ASSERT(get_errno() == EINTR);
+    }
+}
+
+#define pagecache_semgive() sem_post(&g_pagecache.pc_exclsem)
+
+/****************************************************************************
+ * Name: pagecache_getkey
+ *
+ * Description:
+ *   Ask the file system for the key that identifies the data of the open
+ *   file.  Returns -ENOSYS if the file system does not participate in the
+ *   page cache or cannot provide a key for this file.
+ *
+ ****************************************************************************/
+
+static int pagecache_getkey(FAR struct file *filep, FAR uintptr_t *key)
+{
+  FAR struct inode *inode = filep->f_inode;
+  int ret;
+
+  if (inode == NULL || !INODE_IS_MOUNTPT(inode) || inode->u.i_mops == NULL ||
+      inode->u.i_mops->cachekey == NULL || inode->u.i_mops->seek == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  ret = inode->u.i_mops->cachekey(filep, key);
+  return ret < 0 ? -ENOSYS : OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_find
+ *
+ * Description:
+ *   Return the index of the page holding the file data at 'offset' or -1
+ *   if the data is not cached.
+ *
+ ****************************************************************************/
+
+static int pagecache_find(FAR struct inode *inode, uintptr_t key,
+                          off_t offset)
+{
+  FAR struct pagecache_page_s *page;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_FS_PAGECACHE_NPAGES; ndx++)
+    {
+      page = &g_pagecache.pc_pages[ndx];
+      if (page->pg_inode == inode && page->pg_key == key &&
+          page->pg_offset == offset)
+        {
+          return ndx;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: pagecache_fill
+ *
+ * Description:
+ *   Replace an unused or the least recently used page with the page of
+ *   file data at 'offset', read using the file system's own seek and read
+ *   methods.  The file position is left wherever the read stopped.
+ *
+ ****************************************************************************/
+
+static int pagecache_fill(FAR struct file *filep, uintptr_t key,
+                          off_t offset)
+{
+  FAR const struct mountpt_operations *mops = filep->f_inode->u.i_mops;
+  FAR struct pagecache_page_s *page;
+  FAR uint8_t *buffer;
+  uint32_t oldest = 0;
+  ssize_t nread;
+  size_t nbytes;
+  off_t pos;
+  int victim = 0;
+  int ndx;
+
+  /* Select the page to be replaced */
+
+  for (ndx = 0; ndx < CONFIG_FS_PAGECACHE_NPAGES; ndx++)
+    {
+      page = &g_pagecache.pc_pages[ndx];
+      if (page->pg_inode == NULL)
+        {
+          victim = ndx;
+          break;
+        }
+
+      if ((uint32_t)(g_pagecache.pc_age - page->pg_age) > oldest)
+        {
+          oldest = g_pagecache.pc_age - page->pg_age;
+          victim = ndx;
+        }
+    }
+
+  page = &g_pagecache.pc_pages[victim];
+  page->pg_inode = NULL;
+
+  /* Read the page of file data */
+
+  pos = mops->seek(filep, offset, SEEK_SET);
+  if (pos < 0)
+    {
+      return (int)pos;
+    }
+
+  buffer = PAGECACHE_BUFFER(victim);
+  nbytes = 0;
+
+  while (nbytes < CONFIG_FS_PAGECACHE_PAGESIZE)
+    {
+      nread = mops->read(filep, (FAR char *)&buffer[nbytes],
+                         CONFIG_FS_PAGECACHE_PAGESIZE - nbytes);
+      if (nread < 0)
+        {
+          return (int)nread;
+        }
+      else if (nread == 0)
+        {
+          break;
+        }
+
+      nbytes += nread;
+    }
+
+  page->pg_inode  = filep->f_inode;
+  page->pg_key    = key;
+  page->pg_offset = offset;
+  page->pg_nbytes = nbytes;
+  return victim;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_read
+ *
+ * Description:
+ *   Read from a regular file on a mounted volume through the page cache.
+ *   The file position is advanced as by the file system's read method.
+ *
+ * Returned Value:
+ *   The number of bytes read, zero at end-of-file, or a negated errno value
+ *   on failure.  -ENOSYS means that the file cannot be cached and must be
+ *   read from the file system directly.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_read(FAR struct file *filep, FAR char *buffer,
+                       size_t buflen)
+{
+  FAR const struct mountpt_operations *mops;
+  FAR struct pagecache_page_s *page;
+  uintptr_t key;
+  size_t nread;
+  size_t skip;
+  size_t ncopy;
+  off_t offset;
+  off_t pos;
+  int ret;
+  int ndx;
+
+  ret = pagecache_getkey(filep, &key);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  pagecache_semtake();
+  if (g_pagecache.pc_buffer == NULL)
+    {
+      g_pagecache.pc_buffer = (FAR uint8_t *)
+        kmm_malloc(CONFIG_FS_PAGECACHE_NPAGES * CONFIG_FS_PAGECACHE_PAGESIZE);
+
+      if (g_pagecache.pc_buffer == NULL)
+        {
+          pagecache_semgive();
+          return -ENOSYS;
+        }
+    }
+
+  mops  = filep->f_inode->u.i_mops;
+  pos   = filep->f_pos;
+  nread = 0;
+
+  while (nread < buflen)
+    {
+      offset = pos - pos % CONFIG_FS_PAGECACHE_PAGESIZE;
+      ndx    = pagecache_find(filep->f_inode, key, offset);
+      if (ndx < 0)
+        {
+          ndx = pagecache_fill(filep, key, offset);
+          if (ndx < 0)
+            {
+              ret = ndx;
+              break;
+            }
+        }
+
+      page         = &g_pagecache.pc_pages[ndx];
+      page->pg_age = ++g_pagecache.pc_age;
+
+      skip = pos - offset;
+      if (skip >= page->pg_nbytes)
+        {
+          /* End of file */
+
+          break;
+        }
+
+      ncopy = page->pg_nbytes - skip;
+      if (ncopy > buflen - nread)
+        {
+          ncopy = buflen - nread;
+        }
+
+      memcpy(&buffer[nread], PAGECACHE_BUFFER(ndx) + skip, ncopy);
+      nread += ncopy;
+      pos   += ncopy;
+
+      if (page->pg_nbytes < CONFIG_FS_PAGECACHE_PAGESIZE)
+        {
+          /* A partial page is the last page of the file */
+
+          break;
+        }
+    }
+
+  /* Leave the file system positioned just after the data returned.  That
+   * is only necessary if pages had to be read from the file system.
+   */
+
+  if (filep->f_pos != pos)
+    {
+      offset = mops->seek(filep, pos, SEEK_SET);
+      if (offset < 0 && ret == OK)
+        {
+          ret = (int)offset;
+        }
+    }
+
+  pagecache_semgive();
+  return nread > 0 ? (ssize_t)nread : ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Discard cached pages after the data of a file may have changed.  If
+ *   'filep' is NULL, all pages belonging to the mountpoint are discarded
+ *   (as when the volume is unmounted).
+ *
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR struct inode *mountpt, FAR struct file *filep)
+{
+  FAR struct pagecache_page_s *page;
+  uintptr_t key = 0;
+  int ndx;
+
+  if (filep != NULL && pagecache_getkey(filep, &key) < 0)
+    {
+      /* Nothing from this file can be in the cache */
+
+      return;
+    }
+
+  pagecache_semtake();
+  for (ndx = 0; ndx < CONFIG_FS_PAGECACHE_NPAGES; ndx++)
+    {
+      page = &g_pagecache.pc_pages[ndx];
+      if (page->pg_inode == mountpt && (filep == NULL || page->pg_key == key))
+        {
+          page->pg_inode = NULL;
+        }
+    }
+
+  pagecache_semgive();
+}
+
+#endif /* CONFIG_FS_PAGECACHE */
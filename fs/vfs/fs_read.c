@@ -101,7 +101,21 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes)
        * signature and position in the operations vtable.
        */
 
-      ret = (int)inode->u.i_ops->read(filep, (FAR char *)buf, (size_t)nbytes);
+#ifdef CONFIG_FS_PAGECACHE
+      /* Try the page cache first if this is a file on a mounted volume */
+
+      ret = -ENOSYS;
+      if (INODE_IS_MOUNTPT(inode))
+        {
+          ret = (int)pagecache_read(filep, (FAR char *)buf, nbytes);
+        }
+
+      if (ret == -ENOSYS)
+#endif
+        {
+          ret = (int)inode->u.i_ops->read(filep, (FAR char *)buf,
+                                          (size_t)nbytes);
+        }
     }
 
   /* If an error occurred, set errno and return -1 (ERROR) */
@@ -218,6 +218,7 @@ int rename(FAR const char *oldpath, FAR const char *newpath)
       /* Remove all of the children from the unlinked inode */
 
       oldinode->i_child = NULL;
+      inode_invalidate();
       inode_semgive();
     }
 #else
@@ -0,0 +1,179 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/drivers/drivers.h>
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_ioctl
+ *
+ * Description:
+ *   Send a splice command to 'pipefd'.  Returns the number of bytes moved,
+ *   or -1 with errno set.  errno is ENOTTY if 'pipefd' is not a pipe.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_ioctl(int pipefd, int cmd, int fd, FAR off_t *offset,
+                            size_t len, unsigned int flags)
+{
+  struct pipe_splice_s ps;
+  int ret;
+
+  ps.ps_fd       = fd;
+  ps.ps_nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+  ps.ps_len      = len;
+  ps.ps_offset   = offset;
+
+  ret = ioctl(pipefd, cmd, (unsigned long)((uintptr_t)&ps));
+  if (ret < 0 && get_errno() == EINVAL)
+    {
+      /* Drivers other than pipes return EINVAL (or ENOTTY) for commands
+       * they do not recognize.
+       */
+
+      set_errno(ENOTTY);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   Move up to 'len' bytes between two descriptors, at least one of which
+ *   must be a pipe.  The data is transferred directly between the pipe's
+ *   buffer and the other file or socket; it is not copied through a user
+ *   buffer.
+ *
+ * Input Parameters:
+ *   fd_in   - The source descriptor
+ *   off_in  - If fd_in is a file, an optional offset to read at.  The
+ *             offset is updated and the file position is not changed.
+ *             Must be NULL for a pipe.
+ *   fd_out  - The destination descriptor
+ *   off_out - Likewise for fd_out
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK: Do not block on the pipe
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of input, or -1 on failure with
+ *   errno set appropriately.  EINVAL means neither descriptor is a pipe (or
+ *   both refer to the same pipe).
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags)
+{
+  ssize_t ret;
+
+  /* Is the source a pipe? */
+
+  if (off_in == NULL)
+    {
+      ret = splice_ioctl(fd_in, PIPEIOC_SPLICEOUT, fd_out, off_out, len,
+                         flags);
+      if (ret >= 0 || get_errno() != ENOTTY)
+        {
+          return ret;
+        }
+    }
+
+  /* No.. then the destination must be a pipe */
+
+  if (off_out == NULL)
+    {
+      ret = splice_ioctl(fd_out, PIPEIOC_SPLICEIN, fd_in, off_in, len,
+                         flags);
+      if (ret >= 0 || get_errno() != ENOTTY)
+        {
+          return ret;
+        }
+    }
+
+  set_errno(EINVAL);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   Copy up to 'len' bytes from the pipe 'fd_in' to 'fd_out' without
+ *   consuming them, so that they can still be read from fd_in.  Unlike
+ *   Linux, fd_out may be a file or socket as well as another pipe.
+ *
+ * Returned Value:
+ *   The number of bytes copied, or -1 on failure with errno set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  ssize_t ret;
+
+  ret = splice_ioctl(fd_in, PIPEIOC_TEE, fd_out, NULL, len, flags);
+  if (ret < 0 && get_errno() == ENOTTY)
+    {
+      set_errno(EINVAL);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_PIPES */
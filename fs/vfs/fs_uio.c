@@ -0,0 +1,512 @@
+/****************************************************************************
+ * fs/vfs/fs_uio.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+#  include <sys/socket.h>
+#endif
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uio_check
+ *
+ * Description:
+ *   Verify the I/O vector and return the total size of the transfer.
+ *
+ ****************************************************************************/
+
+static ssize_t uio_check(FAR const struct iovec *iov, int iovcnt)
+{
+  ssize_t total = 0;
+  int i;
+
+  if (iov == NULL || iovcnt < 0 || iovcnt > IOV_MAX)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if ((ssize_t)iov[i].iov_len < 0 ||
+          (ssize_t)(total + iov[i].iov_len) < total)
+        {
+          return -EINVAL;
+        }
+
+      total += iov[i].iov_len;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: uio_ops
+ *
+ * Description:
+ *   Return the driver's vectored I/O method, if it has one.  Mountpoints
+ *   have no vectored I/O methods:  The mountpoint operations only match
+ *   the driver operations up to the ioctl method.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+static FAR const struct file_operations *uio_ops(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  if (inode == NULL || inode->u.i_ops == NULL
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+      || INODE_IS_MOUNTPT(inode)
+#endif
+     )
+    {
+      return NULL;
+    }
+
+  return inode->u.i_ops;
+}
+#endif
+
+/****************************************************************************
+ * Name: sock_readv and sock_writev
+ *
+ * Description:
+ *   Vectored I/O on a socket.  The socket layer has no vectored entry
+ *   point.  Each buffer is sent in turn, stopping at the first short send.
+ *   Since recv() does not honor MSG_DONTWAIT, a further recv() could block
+ *   with data already in hand, so sock_readv() receives only into the first
+ *   non-empty buffer; a short read is always permitted by readv().
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+static ssize_t sock_readv(int sockfd, FAR const struct iovec *iov,
+                          int iovcnt)
+{
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len > 0)
+        {
+          return recv(sockfd, iov[i].iov_base, iov[i].iov_len, 0);
+        }
+    }
+
+  return 0;
+}
+#endif
+
+#if defined(CONFIG_NET_TCP) && CONFIG_NSOCKET_DESCRIPTORS > 0
+static ssize_t sock_writev(int sockfd, FAR const struct iovec *iov,
+                           int iovcnt)
+{
+  ssize_t total = 0;
+  ssize_t nwritten;
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nwritten = send(sockfd, iov[i].iov_base, iov[i].iov_len, 0);
+      if (nwritten < 0)
+        {
+          return total > 0 ? total : ERROR;
+        }
+
+      total += nwritten;
+      if ((size_t)nwritten < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return total;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   Equivalent to the standard readv() function except that is accepts a
+ *   struct file instance instead of a file descriptor.  The transfer is
+ *   passed to the driver's readv method if it has one; otherwise each
+ *   buffer is read in turn with file_read(), stopping at the first short
+ *   read.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt)
+{
+  FAR const struct file_operations *ops;
+  ssize_t total;
+  ssize_t nread;
+  int i;
+
+  total = uio_check(iov, iovcnt);
+  if (total < 0)
+    {
+      set_errno(-total);
+      return ERROR;
+    }
+
+  ops = uio_ops(filep);
+  if (ops != NULL && ops->readv != NULL)
+    {
+      if ((filep->f_oflags & O_RDOK) == 0)
+        {
+          set_errno(EACCES);
+          return ERROR;
+        }
+
+      nread = ops->readv(filep, iov, iovcnt);
+      if (nread < 0)
+        {
+          set_errno(-nread);
+          return ERROR;
+        }
+
+      return nread;
+    }
+
+  for (i = 0, total = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nread = file_read(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nread < 0)
+        {
+          /* The errno is set.  Return the data already read, if any. */
+
+          return total > 0 ? total : ERROR;
+        }
+
+      total += nread;
+      if ((size_t)nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return total;
+}
+#endif
+
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   Equivalent to the standard writev() function except that is accepts a
+ *   struct file instance instead of a file descriptor.  The transfer is
+ *   passed to the driver's writev method if it has one; otherwise each
+ *   buffer is written in turn with file_write(), stopping at the first
+ *   short write.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt)
+{
+  FAR const struct file_operations *ops;
+  ssize_t total;
+  ssize_t nwritten;
+  int i;
+
+  total = uio_check(iov, iovcnt);
+  if (total < 0)
+    {
+      set_errno(-total);
+      return ERROR;
+    }
+
+  ops = uio_ops(filep);
+  if (ops != NULL && ops->writev != NULL)
+    {
+      if ((filep->f_oflags & O_WROK) == 0)
+        {
+          set_errno(EBADF);
+          return ERROR;
+        }
+
+      nwritten = ops->writev(filep, iov, iovcnt);
+      if (nwritten < 0)
+        {
+          set_errno(-nwritten);
+          return ERROR;
+        }
+
+      return nwritten;
+    }
+
+  for (i = 0, total = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nwritten = file_write(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nwritten < 0)
+        {
+          return total > 0 ? total : ERROR;
+        }
+
+      total += nwritten;
+      if ((size_t)nwritten < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return total;
+}
+#endif
+
+/****************************************************************************
+ * Name: readv
+ *
+ * Description:
+ *   The standard, POSIX readv interface:  Read into the iovcnt buffers
+ *   described by iov, in order.
+ *
+ * Returned Value:
+ *   The number of bytes read, zero at end-of-file, or -1 on failure with
+ *   errno set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  FAR struct file *filep;
+
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      filep = fs_getfilep(fd);
+      if (filep == NULL)
+        {
+          /* The errno value has already been set */
+
+          return ERROR;
+        }
+
+      return file_readv(filep, iov, iovcnt);
+    }
+#endif
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (uio_check(iov, iovcnt) < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  return sock_readv(fd, iov, iovcnt);
+#else
+  set_errno(EBADF);
+  return ERROR;
+#endif
+}
+
+/****************************************************************************
+ * Name: writev
+ *
+ * Description:
+ *   The standard, POSIX writev interface:  Write the iovcnt buffers
+ *   described by iov, in order.
+ *
+ * Returned Value:
+ *   The number of bytes written or -1 on failure with errno set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  FAR struct file *filep;
+
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      filep = fs_getfilep(fd);
+      if (filep == NULL)
+        {
+          /* The errno value has already been set */
+
+          return ERROR;
+        }
+
+      return file_writev(filep, iov, iovcnt);
+    }
+#endif
+
+#if defined(CONFIG_NET_TCP) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if (uio_check(iov, iovcnt) < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  return sock_writev(fd, iov, iovcnt);
+#else
+  set_errno(EBADF);
+  return ERROR;
+#endif
+}
+
+/****************************************************************************
+ * Name: preadv and pwritev
+ *
+ * Description:
+ *   Like readv() and writev() but at the given file offset, without
+ *   changing the file position.  Not supported on sockets (ESPIPE).
+ *
+ ****************************************************************************/
+
+ssize_t preadv(int fd, FAR const struct iovec *iov, int iovcnt,
+               off_t offset)
+{
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  FAR struct file *filep;
+  ssize_t ret;
+  off_t savepos;
+  int errcode;
+
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      filep = fs_getfilep(fd);
+      if (filep == NULL)
+        {
+          return ERROR;
+        }
+
+      savepos = file_seek(filep, 0, SEEK_CUR);
+      if (savepos == (off_t)-1 ||
+          file_seek(filep, offset, SEEK_SET) == (off_t)-1)
+        {
+          return ERROR;
+        }
+
+      ret     = file_readv(filep, iov, iovcnt);
+      errcode = get_errno();
+
+      if (file_seek(filep, savepos, SEEK_SET) == (off_t)-1 && ret >= 0)
+        {
+          return ERROR;
+        }
+
+      set_errno(errcode);
+      return ret;
+    }
+#endif
+
+  set_errno(ESPIPE);
+  return ERROR;
+}
+
+ssize_t pwritev(int fd, FAR const struct iovec *iov, int iovcnt,
+                off_t offset)
+{
+#if CONFIG_NFILE_DESCRIPTORS > 0
+  FAR struct file *filep;
+  ssize_t ret;
+  off_t savepos;
+  int errcode;
+
+  if ((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      filep = fs_getfilep(fd);
+      if (filep == NULL)
+        {
+          return ERROR;
+        }
+
+      savepos = file_seek(filep, 0, SEEK_CUR);
+      if (savepos == (off_t)-1 ||
+          file_seek(filep, offset, SEEK_SET) == (off_t)-1)
+        {
+          return ERROR;
+        }
+
+      ret     = file_writev(filep, iov, iovcnt);
+      errcode = get_errno();
+
+      if (file_seek(filep, savepos, SEEK_SET) == (off_t)-1 && ret >= 0)
+        {
+          return ERROR;
+        }
+
+      set_errno(errcode);
+      return ret;
+    }
+#endif
+
+  set_errno(ESPIPE);
+  return ERROR;
+}
@@ -95,6 +95,18 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes)
   /* Yes, then let the driver perform the write */
 
   ret = inode->u.i_ops->write(filep, buf, nbytes);
+
+#ifdef CONFIG_FS_PAGECACHE
+  /* Any cached pages of the file are now stale (even after a failed
+   * write, some of the data may have been written).
+   */
+
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      pagecache_invalidate(inode, filep);
+    }
+#endif
+
   if (ret < 0)
     {
       errcode = -ret;
@@ -61,6 +61,18 @@
 #define NX_CLIPORDER_BRLT    (3)   /* Bottom-right-left-top */
 #define NX_CLIPORDER_DEFAULT NX_CLIPORDER_TLRB
 
+/* Report an updated region of the display to external logic.  With
+ * CONFIG_NX_UPDATE_BATCH, the region is added to the damage list of the
+ * plane and reported when the NX server flushes the list.
+ */
+
+#if defined(CONFIG_NX_UPDATE_BATCH)
+#  define nxbe_notify_rectangle(plane,rect) nxbe_update_add(plane,rect)
+#elif defined(CONFIG_NX_UPDATE)
+#  define nxbe_notify_rectangle(plane,rect) \
+     nx_notify_rectangle(&(plane)->pinfo,rect)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -100,6 +112,13 @@ struct nxbe_plane_s
   /* Framebuffer plane info describing destination video plane */
 
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+  /* Updated regions not yet reported to nx_notify_rectangle() */
+
+  uint8_t ndamage;
+  struct nxgl_rect_s damage[CONFIG_NX_UPDATE_NRECTS];
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -386,12 +405,49 @@ void nxbe_bitmap(FAR struct nxbe_window_s *wnd,
                  FAR const struct nxgl_point_s *origin,
                  unsigned int stride);
 
+/****************************************************************************
+ * Name: nxbe_rambacked_resize
+ *
+ * Description:
+ *   Resize the off-screen copy of a window after its size changed.  The
+ *   contents common to the old and the new sizes are kept.  The client is
+ *   asked to redraw the rest of the window, or the whole window if there is
+ *   not enough memory for the new copy (the window is then no longer RAM
+ *   backed).
+ *
+ * Input Parameters:
+ *   wnd    - The window whose bounds have just changed
+ *   before - The bounds of the window before the change
+ *
+ * Return:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_RAMBACKED
+void nxbe_rambacked_resize(FAR struct nxbe_window_s *wnd,
+                           FAR const struct nxgl_rect_s *before);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_rambacked_free
+ *
+ * Description:
+ *   Release the off-screen copy of a window (if any).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_RAMBACKED
+void nxbe_rambacked_free(FAR struct nxbe_window_s *wnd);
+#endif
+
 /****************************************************************************
  * Name: nxbe_redraw
  *
  * Description:
  *   Re-draw the visible portions of the rectangular region for the
- *   specified window
+ *   specified window.  RAM backed windows are restored from their
+ *   off-screen copy; the clients of other windows are asked to redraw.
  *
  ****************************************************************************/
 
@@ -399,6 +455,24 @@ void nxbe_redraw(FAR struct nxbe_state_s *be,
                  FAR struct nxbe_window_s *wnd,
                  FAR const struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: nxbe_update_add, nxbe_update_pending, and nxbe_update_flush
+ *
+ * Description:
+ *   Accumulate updated regions of the display in the damage list of each
+ *   plane, coalescing overlapping and adjacent regions.  The NX server
+ *   reports the accumulated damage, at most once every
+ *   CONFIG_NX_UPDATE_INTERVAL milliseconds, with nxbe_update_flush().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+void nxbe_update_add(FAR struct nxbe_plane_s *plane,
+                     FAR const struct nxgl_rect_s *rect);
+bool nxbe_update_pending(FAR struct nxbe_state_s *be);
+void nxbe_update_flush(FAR struct nxbe_state_s *be);
+#endif
+
 /****************************************************************************
  * Name: nxbe_redrawbelow
  *
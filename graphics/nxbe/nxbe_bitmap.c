@@ -84,7 +84,7 @@ static void nxs_clipcopy(FAR struct nxbe_clipops_s *cops,
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
 
-  nx_notify_rectangle(&plane->pinfo, rect);
+  nxbe_notify_rectangle(plane, rect);
 #endif
 }
 
@@ -153,6 +153,30 @@ void nxbe_bitmap(FAR struct nxbe_window_s *wnd, FAR const struct nxgl_rect_s *de
       return;
     }
 
+#ifdef CONFIG_NX_RAMBACKED
+  /* Copy the image into the off-screen copy of the window */
+
+  if (NXBE_ISRAMBACKED(wnd))
+    {
+      nxgl_rectoffset(&remaining, &wnd->bounds, -wnd->bounds.pt1.x,
+                      -wnd->bounds.pt1.y);
+      nxgl_rectintersect(&remaining, &remaining, dest);
+
+      if (!nxgl_nullrect(&remaining))
+        {
+#if CONFIG_NX_NPLANES > 1
+          for (i = 0; i < wnd->be->vinfo.nplanes; i++)
+#else
+          i = 0;
+#endif
+            {
+              wnd->be->plane[i].copyrectangle(&wnd->wpinfo[i], &remaining,
+                                              src[i], origin, stride);
+            }
+        }
+    }
+#endif
+
   /* Offset the rectangle and image origin by the window origin */
 
   nxgl_rectoffset(&bounds, dest, wnd->bounds.pt1.x, wnd->bounds.pt1.y);
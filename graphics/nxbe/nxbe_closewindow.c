@@ -113,6 +113,12 @@ void nxbe_closewindow(struct nxbe_window_s *wnd)
 
   nxbe_redrawbelow(be, wnd->below, &wnd->bounds);
 
+#ifdef CONFIG_NX_RAMBACKED
+  /* Release the off-screen copy of the window */
+
+  nxbe_rambacked_free(wnd);
+#endif
+
   /* Then discard the window structure.  Here we assume that the user-space
    * allocator was used.
    */
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stddef.h>
+#include <string.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -117,6 +118,14 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
 
   for (i = 0; i < be->vinfo.nplanes; i++)
     {
+#if defined(CONFIG_FB_ACCEL) || defined(CONFIG_NX_LCDDRIVER)
+      /* Drivers need not set the optional members of the plane information
+       * (pinfo.accel or pinfo.putarea) that they do not support.
+       */
+
+      memset(&be->plane[i].pinfo, 0, sizeof(NX_PLANEINFOTYPE));
+#endif
+
       ret = dev->getplaneinfo(dev, i, &be->plane[i].pinfo);
       if (ret < 0)
         {
@@ -80,7 +80,7 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
 
-  nx_notify_rectangle(&plane->pinfo, rect);
+  nxbe_notify_rectangle(plane, rect);
 #endif
 }
 
@@ -119,6 +119,30 @@ void nxbe_fill(FAR struct nxbe_window_s *wnd,
     }
 #endif
 
+#ifdef CONFIG_NX_RAMBACKED
+  /* Fill the off-screen copy of the window, including hidden parts */
+
+  if (NXBE_ISRAMBACKED(wnd))
+    {
+      nxgl_rectoffset(&remaining, &wnd->bounds, -wnd->bounds.pt1.x,
+                      -wnd->bounds.pt1.y);
+      nxgl_rectintersect(&remaining, &remaining, rect);
+
+      if (!nxgl_nullrect(&remaining))
+        {
+#if CONFIG_NX_NPLANES > 1
+          for (i = 0; i < wnd->be->vinfo.nplanes; i++)
+#else
+          i = 0;
+#endif
+            {
+              wnd->be->plane[i].fillrectangle(&wnd->wpinfo[i], &remaining,
+                                              color[i]);
+            }
+        }
+    }
+#endif
+
   /* Offset the rectangle by the window origin to convert it into a
    * bounding box
    */
@@ -103,7 +103,7 @@ static void nxbe_clipfilltrapezoid(FAR struct nxbe_clipops_s *cops,
                      MIN(fillinfo->trap.bot.x2, rect->pt2.x));
   update.pt2.y = MIN(fillinfo->trap.bot.y, rect->pt2.y);
 
-  nx_notify_rectangle(&plane->pinfo, &update);
+  nxbe_notify_rectangle(plane, &update);
 #endif
 }
 
@@ -144,6 +144,33 @@ void nxbe_filltrapezoid(FAR struct nxbe_window_s *wnd,
     }
 #endif
 
+#ifdef CONFIG_NX_RAMBACKED
+  /* Render the trapezoid into the off-screen copy of the window */
+
+  if (NXBE_ISRAMBACKED(wnd))
+    {
+      nxgl_rectoffset(&remaining, &wnd->bounds, -wnd->bounds.pt1.x,
+                      -wnd->bounds.pt1.y);
+      if (clip)
+        {
+          nxgl_rectintersect(&remaining, &remaining, clip);
+        }
+
+      if (!nxgl_nullrect(&remaining))
+        {
+#if CONFIG_NX_NPLANES > 1
+          for (i = 0; i < wnd->be->vinfo.nplanes; i++)
+#else
+          i = 0;
+#endif
+            {
+              wnd->be->plane[i].filltrapezoid(&wnd->wpinfo[i], trap,
+                                              &remaining, color[i]);
+            }
+        }
+    }
+#endif
+
   /* Offset the trapezoid by the window origin to position it within
    * the framebuffer region
    */
@@ -95,6 +95,27 @@ void nxbe_getrectangle(FAR struct nxbe_window_s *wnd,
     }
 #endif
 
+#ifdef CONFIG_NX_RAMBACKED
+  /* A RAM backed window returns its own contents from its off-screen copy,
+   * even where it is hidden by other windows.
+   */
+
+  if (NXBE_ISRAMBACKED(wnd))
+    {
+      nxgl_rectoffset(&remaining, &wnd->bounds, -wnd->bounds.pt1.x,
+                      -wnd->bounds.pt1.y);
+      nxgl_rectintersect(&remaining, &remaining, rect);
+
+      if (!nxgl_nullrect(&remaining))
+        {
+          wnd->be->plane[plane].getrectangle(&wnd->wpinfo[plane],
+                                             &remaining, dest, deststride);
+        }
+
+      return;
+    }
+#endif
+
   /* Offset the rectangle by the window origin to convert it into a
    * bounding box
    */
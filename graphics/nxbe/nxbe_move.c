@@ -101,7 +101,7 @@ static void nxbe_clipmovesrc(FAR struct nxbe_clipops_s *cops,
       update.pt2.x = rect->pt2.x + info->offset.x;
       update.pt2.y = rect->pt2.y + info->offset.y;
 
-      nx_notify_rectangle(&plane->pinfo, &update);
+      nxbe_notify_rectangle(plane, &update);
 #endif
     }
 }
@@ -182,6 +182,63 @@ static void nxbe_clipmovedest(FAR struct nxbe_clipops_s *cops,
    }
 }
 
+/****************************************************************************
+ * Name: nxbe_move_rambacked
+ *
+ * Description:
+ *  Move a rectangular region within a RAM backed window.  The region is
+ *  moved in the off-screen copy of the window, then the visible portions
+ *  of the destination are copied to the display.  The client never needs
+ *  to redraw any part of the destination.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_RAMBACKED
+static void nxbe_move_rambacked(FAR struct nxbe_window_s *wnd,
+                                FAR const struct nxgl_rect_s *rect,
+                                FAR const struct nxgl_point_s *offset)
+{
+  struct nxgl_rect_s wrect;
+  struct nxgl_rect_s srcrect;
+  struct nxgl_rect_s dstrect;
+  struct nxgl_point_s destpos;
+  int i;
+
+  /* Clip the source and the destination to the window */
+
+  nxgl_rectoffset(&wrect, &wnd->bounds, -wnd->bounds.pt1.x,
+                  -wnd->bounds.pt1.y);
+  nxgl_rectintersect(&srcrect, rect, &wrect);
+  nxgl_rectoffset(&dstrect, &srcrect, offset->x, offset->y);
+  nxgl_rectintersect(&dstrect, &dstrect, &wrect);
+
+  if (nxgl_nullrect(&dstrect))
+    {
+      return;
+    }
+
+  /* Move the part of the source that lands inside of the window */
+
+  nxgl_rectoffset(&srcrect, &dstrect, -offset->x, -offset->y);
+  destpos.x = dstrect.pt1.x;
+  destpos.y = dstrect.pt1.y;
+
+#if CONFIG_NX_NPLANES > 1
+  for (i = 0; i < wnd->be->vinfo.nplanes; i++)
+#else
+  i = 0;
+#endif
+    {
+      wnd->be->plane[i].moverectangle(&wnd->wpinfo[i], &srcrect, &destpos);
+    }
+
+  /* Then update the visible parts of the destination on the display */
+
+  nxgl_rectoffset(&dstrect, &dstrect, wnd->bounds.pt1.x, wnd->bounds.pt1.y);
+  nxbe_redraw(wnd->be, wnd, &dstrect);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -215,6 +272,14 @@ void nxbe_move(FAR struct nxbe_window_s *wnd, FAR const struct nxgl_rect_s *rect
     }
 #endif
 
+#ifdef CONFIG_NX_RAMBACKED
+  if (NXBE_ISRAMBACKED(wnd))
+    {
+      nxbe_move_rambacked(wnd, rect, offset);
+      return;
+    }
+#endif
+
   /* Offset the rectangle by the window origin to create a bounding box */
 
   nxgl_rectoffset(&info.srcrect, rect, wnd->bounds.pt1.x, wnd->bounds.pt1.y);
@@ -96,5 +96,13 @@ void nxbe_raise(FAR struct nxbe_window_s *wnd)
    * it is not obscured by another window
    */
 
+#ifdef CONFIG_NX_RAMBACKED
+  if (NXBE_ISRAMBACKED(wnd))
+    {
+      nxbe_redraw(be, wnd, &wnd->bounds);
+      return;
+    }
+#endif
+
   nxfe_redrawreq(wnd, &wnd->bounds);
 }
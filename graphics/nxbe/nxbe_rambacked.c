@@ -0,0 +1,213 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_rambacked.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+#include "nxfe.h"
+
+#ifdef CONFIG_NX_RAMBACKED
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_rambacked_free
+ *
+ * Description:
+ *   Release the off-screen copy of a window (if any).
+ *
+ ****************************************************************************/
+
+void nxbe_rambacked_free(FAR struct nxbe_window_s *wnd)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      if (wnd->wpinfo[i].fbmem != NULL)
+        {
+          kmm_free(wnd->wpinfo[i].fbmem);
+        }
+
+      memset(&wnd->wpinfo[i], 0, sizeof(NX_PLANEINFOTYPE));
+    }
+}
+
+/****************************************************************************
+ * Name: nxbe_rambacked_resize
+ *
+ * Description:
+ *   Resize the off-screen copy of a window after its size changed.  The
+ *   contents common to the old and the new sizes are kept.  The client is
+ *   asked to redraw the rest of the window, or the whole window if there is
+ *   not enough memory for the new copy (the window is then no longer RAM
+ *   backed).
+ *
+ * Input Parameters:
+ *   wnd    - The window whose bounds have just changed
+ *   before - The bounds of the window before the change
+ *
+ ****************************************************************************/
+
+void nxbe_rambacked_resize(FAR struct nxbe_window_s *wnd,
+                           FAR const struct nxgl_rect_s *before)
+{
+  FAR struct nxbe_state_s *be = wnd->be;
+  NX_PLANEINFOTYPE newinfo[CONFIG_NX_NPLANES];
+  struct nxgl_rect_s keep;
+  struct nxgl_rect_s rect;
+  struct nxgl_rect_s nonintersecting[4];
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  unsigned int copylen;
+  unsigned int nrows;
+  unsigned int row;
+  int nplanes;
+  int i;
+
+#if CONFIG_NX_NPLANES > 1
+  nplanes = be->vinfo.nplanes;
+#else
+  nplanes = 1;
+#endif
+
+  width  = wnd->bounds.pt2.x - wnd->bounds.pt1.x + 1;
+  height = wnd->bounds.pt2.y - wnd->bounds.pt1.y + 1;
+
+  /* The part of the window, in window relative coordinates, that the old
+   * copy holds and that is still in the window.
+   */
+
+  keep.pt1.x = 0;
+  keep.pt1.y = 0;
+  keep.pt2.x = before->pt2.x - before->pt1.x;
+  keep.pt2.y = before->pt2.y - before->pt1.y;
+
+  if (!NXBE_ISRAMBACKED(wnd))
+    {
+      keep.pt2.x = -1;
+      keep.pt2.y = -1;
+    }
+
+  /* Allocate the new copies */
+
+  memset(newinfo, 0, sizeof(newinfo));
+  if (width > 0 && height > 0)
+    {
+      for (i = 0; i < nplanes; i++)
+        {
+          newinfo[i].bpp     = be->plane[i].pinfo.bpp;
+          newinfo[i].display = be->plane[i].pinfo.display;
+          newinfo[i].stride  = (width * newinfo[i].bpp + 7) >> 3;
+          newinfo[i].fblen   = (uint32_t)newinfo[i].stride * height;
+          newinfo[i].fbmem   = kmm_zalloc(newinfo[i].fblen);
+
+          if (newinfo[i].fbmem == NULL)
+            {
+              gwarn("WARNING: No memory for a %dx%d window copy\n",
+                    width, height);
+
+              while (i-- > 0)
+                {
+                  kmm_free(newinfo[i].fbmem);
+                }
+
+              memset(newinfo, 0, sizeof(newinfo));
+              keep.pt2.x = -1;
+              keep.pt2.y = -1;
+              break;
+            }
+        }
+    }
+
+  /* Keep the contents common to the old and new copies */
+
+  if (newinfo[0].fbmem != NULL && NXBE_ISRAMBACKED(wnd))
+    {
+      nrows = ngl_min(height, keep.pt2.y + 1);
+
+      for (i = 0; i < nplanes; i++)
+        {
+          copylen = ngl_min(newinfo[i].stride, wnd->wpinfo[i].stride);
+          for (row = 0; row < nrows; row++)
+            {
+              memcpy((FAR uint8_t *)newinfo[i].fbmem +
+                       row * newinfo[i].stride,
+                     (FAR const uint8_t *)wnd->wpinfo[i].fbmem +
+                       row * wnd->wpinfo[i].stride,
+                     copylen);
+            }
+        }
+    }
+
+  /* Replace the old copies */
+
+  nxbe_rambacked_free(wnd);
+  memcpy(wnd->wpinfo, newinfo, sizeof(newinfo));
+
+  /* Ask the client to draw everything that was not kept */
+
+  if (width > 0 && height > 0)
+    {
+      nxgl_rectoffset(&rect, &wnd->bounds, -wnd->bounds.pt1.x,
+                      -wnd->bounds.pt1.y);
+      nxgl_rectintersect(&keep, &keep, &rect);
+      nxgl_nonintersecting(nonintersecting, &rect, &keep);
+
+      for (i = 0; i < 4; i++)
+        {
+          if (!nxgl_nullrect(&nonintersecting[i]))
+            {
+              nxgl_rectoffset(&rect, &nonintersecting[i],
+                              wnd->bounds.pt1.x, wnd->bounds.pt1.y);
+              nxfe_redrawreq(wnd, &rect);
+            }
+        }
+    }
+}
+
+#endif /* CONFIG_NX_RAMBACKED */
@@ -70,6 +70,28 @@ static void nxbe_clipredraw(FAR struct nxbe_clipops_s *cops,
                            FAR const struct nxgl_rect_s *rect)
 {
   FAR struct nxbe_window_s *wnd = ((struct nxbe_redraw_s *)cops)->wnd;
+
+#ifdef CONFIG_NX_RAMBACKED
+  /* Restore the region of a RAM backed window from its off-screen copy
+   * rather than asking the client to redraw it.
+   */
+
+  if (wnd && NXBE_ISRAMBACKED(wnd))
+    {
+      int i = plane - &wnd->be->plane[0];
+
+      plane->copyrectangle(&plane->pinfo, rect, wnd->wpinfo[i].fbmem,
+                           &wnd->bounds.pt1, wnd->wpinfo[i].stride);
+
+#ifdef CONFIG_NX_UPDATE
+      /* Notify external logic that the display has been updated */
+
+      nxbe_notify_rectangle(plane, rect);
+#endif
+      return;
+    }
+#endif
+
   if (wnd)
     {
       nxfe_redrawreq(wnd, rect);
@@ -85,7 +107,8 @@ static void nxbe_clipredraw(FAR struct nxbe_clipops_s *cops,
  *
  * Descripton:
  *   Re-draw the visible portions of the rectangular region for the
- *   specified window
+ *   specified window.  RAM backed windows are restored from their
+ *   off-screen copy; the clients of other windows are asked to redraw.
  *
  ****************************************************************************/
 
@@ -80,7 +80,7 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
 
-  nx_notify_rectangle(&plane->pinfo, rect);
+  nxbe_notify_rectangle(plane, rect);
 #endif
 }
 
@@ -119,6 +119,28 @@ void nxbe_setpixel(FAR struct nxbe_window_s *wnd,
     }
 #endif
 
+#ifdef CONFIG_NX_RAMBACKED
+  /* Set the pixel in the off-screen copy of the window */
+
+  if (NXBE_ISRAMBACKED(wnd))
+    {
+      nxgl_rectoffset(&rect, &wnd->bounds, -wnd->bounds.pt1.x,
+                      -wnd->bounds.pt1.y);
+
+      if (nxgl_rectinside(&rect, pos))
+        {
+#if CONFIG_NX_NPLANES > 1
+          for (i = 0; i < wnd->be->vinfo.nplanes; i++)
+#else
+          i = 0;
+#endif
+            {
+              wnd->be->plane[i].setpixel(&wnd->wpinfo[i], pos, color[i]);
+            }
+        }
+    }
+#endif
+
   /* Offset the position by the window origin */
 
   nxgl_vectoradd(&rect.pt1, pos, &wnd->bounds.pt1);
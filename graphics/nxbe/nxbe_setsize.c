@@ -61,6 +61,9 @@ void nxbe_setsize(FAR struct nxbe_window_s *wnd,
                   FAR const struct nxgl_size_s *size)
 {
   struct nxgl_rect_s bounds;
+#ifdef CONFIG_NX_RAMBACKED
+  struct nxgl_rect_s before;
+#endif
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!wnd)
@@ -72,6 +75,9 @@ void nxbe_setsize(FAR struct nxbe_window_s *wnd,
   /* Save the before size of the window's bounding box */
 
   nxgl_rectcopy(&bounds, &wnd->bounds);
+#ifdef CONFIG_NX_RAMBACKED
+  nxgl_rectcopy(&before, &wnd->bounds);
+#endif
 
   /* Add the window origin to the supplied size get the new window bounding box */
 
@@ -92,6 +98,14 @@ void nxbe_setsize(FAR struct nxbe_window_s *wnd,
 
   nxfe_reportposition(wnd);
 
+#ifdef CONFIG_NX_RAMBACKED
+  /* Resize the off-screen copy of the window.  The client is asked to draw
+   * the parts of the window that the copy did not hold.
+   */
+
+  nxbe_rambacked_resize(wnd, &before);
+#endif
+
   /* Then redraw this window AND all windows below it. Having resized the
    * window, we may have exposed previoulsy obscured portions of windows
    * below this one.
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_update.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_rectarea
+ ****************************************************************************/
+
+static uint32_t nxbe_rectarea(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: nxbe_recttouch
+ *
+ * Description:
+ *   Return true if the two rectangles overlap or are adjacent.
+ *
+ ****************************************************************************/
+
+static bool nxbe_recttouch(FAR const struct nxgl_rect_s *rect1,
+                           FAR const struct nxgl_rect_s *rect2)
+{
+  return rect1->pt1.x <= rect2->pt2.x + 1 &&
+         rect2->pt1.x <= rect1->pt2.x + 1 &&
+         rect1->pt1.y <= rect2->pt2.y + 1 &&
+         rect2->pt1.y <= rect1->pt2.y + 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_update_add
+ *
+ * Description:
+ *   Add a rectangle to the damage list of the plane.  Rectangles that
+ *   overlap or touch one already in the list are merged with it.  When the
+ *   list is full, the rectangle is merged with the entry whose bounding
+ *   rectangle grows the least.
+ *
+ ****************************************************************************/
+
+void nxbe_update_add(FAR struct nxbe_plane_s *plane,
+                     FAR const struct nxgl_rect_s *rect)
+{
+  struct nxgl_rect_s damage;
+  struct nxgl_rect_s merged;
+  uint32_t growth;
+  uint32_t best;
+  int bestndx;
+  int ndx;
+
+  nxgl_rectcopy(&damage, rect);
+
+  /* Merge with every entry that the (growing) rectangle touches.  Each
+   * merged entry is removed from the list; the result is added at the end.
+   */
+
+  for (ndx = 0; ndx < plane->ndamage; )
+    {
+      if (nxbe_recttouch(&damage, &plane->damage[ndx]))
+        {
+          nxgl_rectunion(&damage, &damage, &plane->damage[ndx]);
+          plane->damage[ndx] = plane->damage[--plane->ndamage];
+
+          /* The larger rectangle may now touch entries already checked */
+
+          ndx = 0;
+        }
+      else
+        {
+          ndx++;
+        }
+    }
+
+  if (plane->ndamage < CONFIG_NX_UPDATE_NRECTS)
+    {
+      plane->damage[plane->ndamage++] = damage;
+      return;
+    }
+
+  /* The list is full.  Merge with the entry that costs the fewest extra
+   * pixels.
+   */
+
+  best    = UINT32_MAX;
+  bestndx = 0;
+
+  for (ndx = 0; ndx < plane->ndamage; ndx++)
+    {
+      nxgl_rectunion(&merged, &damage, &plane->damage[ndx]);
+      growth = nxbe_rectarea(&merged) - nxbe_rectarea(&plane->damage[ndx]);
+      if (growth < best)
+        {
+          best    = growth;
+          bestndx = ndx;
+        }
+    }
+
+  nxgl_rectunion(&plane->damage[bestndx], &damage, &plane->damage[bestndx]);
+}
+
+/****************************************************************************
+ * Name: nxbe_update_pending
+ *
+ * Description:
+ *   Return true if any plane has damage that has not yet been flushed.
+ *
+ ****************************************************************************/
+
+bool nxbe_update_pending(FAR struct nxbe_state_s *be)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      if (be->plane[i].ndamage > 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxbe_update_flush
+ *
+ * Description:
+ *   Report the accumulated damage of each plane to nx_notify_rectangle()
+ *   and empty the damage lists.
+ *
+ ****************************************************************************/
+
+void nxbe_update_flush(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  int i;
+  int ndx;
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      plane = &be->plane[i];
+      for (ndx = 0; ndx < plane->ndamage; ndx++)
+        {
+          nx_notify_rectangle(&plane->pinfo, &plane->damage[ndx]);
+        }
+
+      plane->ndamage = 0;
+    }
+}
+
+#endif /* CONFIG_NX_UPDATE_BATCH */
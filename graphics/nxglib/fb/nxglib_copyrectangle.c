@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <nuttx/video/fb.h>
@@ -132,6 +133,21 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   /* Then copy the image */
 
   sline = (FAR const uint8_t *)src + NXGL_SCALEX(dest->pt1.x - origin->x) + (dest->pt1.y - origin->y) * srcstride;
+
+#ifdef NXGL_HAVE_ACCEL
+  /* Let the 2D graphics engine do the copy if there is one */
+
+  if (pinfo->accel != NULL && pinfo->accel->copyarea != NULL)
+    {
+      struct fb_area_s area;
+
+      NXGL_RECT2AREA(&area, dest);
+      if (pinfo->accel->copyarea(pinfo, &area, sline, srcstride) >= 0)
+        {
+          return;
+        }
+    }
+#endif
   dline = pinfo->fbmem + dest->pt1.y * deststride + NXGL_SCALEX(dest->pt1.x);
 
   while (rows--)
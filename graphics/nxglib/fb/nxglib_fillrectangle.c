@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <nuttx/video/fb.h>
@@ -101,6 +102,21 @@ void NXGL_FUNCNAME(nxgl_fillrectangle, NXGLIB_SUFFIX)
   int lnlen;
 #endif
 
+#ifdef NXGL_HAVE_ACCEL
+  /* Let the 2D graphics engine do the fill if there is one */
+
+  if (pinfo->accel != NULL && pinfo->accel->fillarea != NULL)
+    {
+      struct fb_area_s area;
+
+      NXGL_RECT2AREA(&area, rect);
+      if (pinfo->accel->fillarea(pinfo, &area, color) >= 0)
+        {
+          return;
+        }
+    }
+#endif
+
   /* Get the width of the framebuffer in bytes */
 
   stride = pinfo->stride;
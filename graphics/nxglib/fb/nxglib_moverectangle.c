@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <nuttx/video/fb.h>
@@ -144,6 +145,21 @@ void NXGL_FUNCNAME(nxgl_moverectangle,NXGLIB_SUFFIX)
   uint8_t tailmask;
 #endif
 
+#ifdef NXGL_HAVE_ACCEL
+  /* Let the 2D graphics engine do the move if there is one */
+
+  if (pinfo->accel != NULL && pinfo->accel->movearea != NULL)
+    {
+      struct fb_area_s area;
+
+      NXGL_RECT2AREA(&area, rect);
+      if (pinfo->accel->movearea(pinfo, &area, offset->x, offset->y) >= 0)
+        {
+          return;
+        }
+    }
+#endif
+
   /* Get the width of the framebuffer in bytes */
 
   stride = pinfo->stride;
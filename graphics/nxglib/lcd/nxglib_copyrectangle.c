@@ -108,6 +108,23 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   remainder = NXGL_REMAINDERX(xoffset);
 #endif
 
+  /* If the image data is byte aligned and the driver supports it, write the
+   * whole rectangle directly from the image memory at once.
+   */
+
+#if NXGLIB_BITSPERPIXEL < 8
+  if (remainder == 0 && pinfo->putarea != NULL)
+#else
+  if (pinfo->putarea != NULL)
+#endif
+    {
+      if (pinfo->putarea(dest->pt1.y, dest->pt2.y, dest->pt1.x, dest->pt2.x,
+                         sline, srcstride) >= 0)
+        {
+          return;
+        }
+    }
+
   /* Copy the image, one row at a time */
 
   for (row = dest->pt1.y; row <= dest->pt2.y; row++)
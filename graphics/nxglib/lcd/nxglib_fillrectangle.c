@@ -100,7 +100,16 @@ void NXGL_FUNCNAME(nxgl_fillrectangle, NXGLIB_SUFFIX)
 
   NXGL_FUNCNAME(nxgl_fillrun, NXGLIB_SUFFIX)((NXGLIB_RUNTYPE *)pinfo->buffer, color, ncols);
 
-  /* Then fill the rectangle line-by-line */
+  /* Write the whole rectangle at once if the driver supports that */
+
+  if (pinfo->putarea != NULL &&
+      pinfo->putarea(rect->pt1.y, rect->pt2.y, rect->pt1.x, rect->pt2.x,
+                     pinfo->buffer, 0) >= 0)
+    {
+      return;
+    }
+
+  /* Otherwise, fill the rectangle line-by-line */
 
   for (row = rect->pt1.y; row <= rect->pt2.y; row++)
     {
@@ -113,6 +113,22 @@
 
 #endif
 
+/* 2D acceleration is used only for whole-byte pixels */
+
+#if defined(CONFIG_FB_ACCEL) && NXGLIB_BITSPERPIXEL >= 8 && \
+   !defined(CONFIG_NX_LCDDRIVER)
+#  define NXGL_HAVE_ACCEL 1
+#  define NXGL_RECT2AREA(a,r) \
+     do \
+       { \
+         (a)->x = (r)->pt1.x; \
+         (a)->y = (r)->pt1.y; \
+         (a)->w = (r)->pt2.x - (r)->pt1.x + 1; \
+         (a)->h = (r)->pt2.y - (r)->pt1.y + 1; \
+       } \
+     while (0)
+#endif
+
 #if NXGLIB_BITSPERPIXEL < 8
 
 #  define NXGL_SCALEX(x)           ((x) >> NXGL_PIXELSHIFT)
@@ -257,6 +257,23 @@ int nxmu_mousein(FAR struct nxfe_state_s *fe,
                  FAR const struct nxgl_point_s *pos, int button);
 #endif
 
+/****************************************************************************
+ * Name: nxmu_mousebatch and nxmu_mouseflush
+ *
+ * Description:
+ *   nxmu_mousebatch() is like nxmu_mousein() except that movement with no
+ *   button change is deferred while 'more' messages are queued for the
+ *   server.  nxmu_mouseflush() forwards any deferred movement.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_XYINPUT_BATCH
+int nxmu_mousebatch(FAR struct nxfe_state_s *fe,
+                    FAR const struct nxgl_point_s *pos, int buttons,
+                    bool more);
+void nxmu_mouseflush(FAR struct nxfe_state_s *fe);
+#endif
+
 /****************************************************************************
  * Name: nxmu_kbdin
  *
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -66,6 +67,11 @@ static struct nxgl_point_s   g_mrange;
 static uint8_t               g_mbutton;
 static struct nxbe_window_s *g_mwnd;
 
+#ifdef CONFIG_NX_XYINPUT_BATCH
+static struct nxgl_point_s   g_mpending; /* Deferred mouse position */
+static bool                  g_mdefer;   /* True: g_mpending is valid */
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -232,4 +238,62 @@ int nxmu_mousein(FAR struct nxfe_state_s *fe,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxmu_mousebatch
+ *
+ * Description:
+ *   Like nxmu_mousein() except that a report that only moves the mouse is
+ *   deferred if 'more' indicates that further messages are already queued
+ *   for the server.  A burst of movement reports is then forwarded to the
+ *   window client as the single, most recent position.  Reports that
+ *   change the button state are always forwarded immediately (along with
+ *   their position).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_XYINPUT_BATCH
+int nxmu_mousebatch(FAR struct nxfe_state_s *fe,
+                    FAR const struct nxgl_point_s *pos, int buttons,
+                    bool more)
+{
+  if (more && buttons == g_mbutton)
+    {
+      /* Just remember the latest position.  The next message will either
+       * replace it or cause it to be flushed.
+       */
+
+      g_mpending.x = pos->x;
+      g_mpending.y = pos->y;
+      g_mdefer     = true;
+      return OK;
+    }
+
+  /* Any deferred movement is superseded by this report */
+
+  g_mdefer = false;
+  return nxmu_mousein(fe, pos, buttons);
+}
+#endif
+
+/****************************************************************************
+ * Name: nxmu_mouseflush
+ *
+ * Description:
+ *   Forward any mouse movement deferred by nxmu_mousebatch().  This must be
+ *   called before any other message is processed so that the movement is
+ *   reported in order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_XYINPUT_BATCH
+void nxmu_mouseflush(FAR struct nxfe_state_s *fe)
+{
+  if (g_mdefer)
+    {
+      g_mdefer = false;
+      (void)nxmu_mousein(fe, &g_mpending, g_mbutton);
+    }
+}
+#endif
+
 #endif /* CONFIG_NX_XYINPUT */
@@ -42,6 +42,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <semaphore.h>
 #include <mqueue.h>
 #include <fcntl.h>
@@ -55,6 +56,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NX_UPDATE_BATCH
+#  define UPDATE_INTERVAL_NSEC (CONFIG_NX_UPDATE_INTERVAL * 1000000L)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -265,6 +270,44 @@ static inline int nxmu_setup(FAR const char *mqname, FAR NX_DRIVERTYPE *dev,
   return OK;
 }
 
+/****************************************************************************
+ * Name: nxmu_setdeadline
+ *
+ * Description:
+ *   Set the time by which the pending display updates must be reported.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+static inline void nxmu_setdeadline(FAR struct timespec *deadline)
+{
+  (void)clock_gettime(CLOCK_REALTIME, deadline);
+
+  deadline->tv_sec  += UPDATE_INTERVAL_NSEC / 1000000000L;
+  deadline->tv_nsec += UPDATE_INTERVAL_NSEC % 1000000000L;
+  if (deadline->tv_nsec >= 1000000000L)
+    {
+      deadline->tv_sec++;
+      deadline->tv_nsec -= 1000000000L;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: nxmu_deadlinepassed
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+static inline bool nxmu_deadlinepassed(FAR const struct timespec *deadline)
+{
+  struct timespec now;
+
+  (void)clock_gettime(CLOCK_REALTIME, &now);
+  return now.tv_sec > deadline->tv_sec ||
+         (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -294,6 +337,10 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
   struct nxfe_state_s    fe;
   FAR struct nxsvrmsg_s *msg;
   char                   buffer[NX_MXSVRMSGLEN];
+#ifdef CONFIG_NX_UPDATE_BATCH
+  struct timespec        deadline;
+  bool                   armed = false;
+#endif
   int                    nbytes;
   int                    ret;
 
@@ -327,12 +374,45 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   for (; ; )
     {
-       /* Receive the next server message */
+#ifdef CONFIG_NX_UPDATE_BATCH
+       /* Display updates are held until CONFIG_NX_UPDATE_INTERVAL msec
+        * after the first of them so that the damage from many drawing
+        * operations is reported together.  Until then, wait for the next
+        * message only until the updates are due.
+        */
+
+       if (nxbe_update_pending(&fe.be))
+         {
+           if (!armed)
+             {
+               nxmu_setdeadline(&deadline);
+               armed = true;
+             }
+           else if (nxmu_deadlinepassed(&deadline))
+             {
+               nxbe_update_flush(&fe.be);
+               armed = false;
+               continue;
+             }
+
+           nbytes = mq_timedreceive(fe.conn.crdmq, buffer, NX_MXSVRMSGLEN,
+                                    0, &deadline);
+         }
+       else
+#endif
+         {
+           /* Receive the next server message */
+
+           nbytes = mq_receive(fe.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
+         }
 
-       nbytes = mq_receive(fe.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
        if (nbytes < 0)
          {
+#ifdef CONFIG_NX_UPDATE_BATCH
+           if (errno != EINTR && errno != ETIMEDOUT)
+#else
            if (errno != EINTR)
+#endif
              {
                gerr("ERROR: mq_receive failed: %d\n", errno);
                goto errout; /* mq_receive sets errno */
@@ -346,6 +426,16 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
        msg = (FAR struct nxsvrmsg_s *)buffer;
 
        ginfo("Received opcode=%d nbytes=%d\n", msg->msgid, nbytes);
+
+#ifdef CONFIG_NX_XYINPUT_BATCH
+       /* Forward any deferred mouse movement before anything else happens */
+
+       if (msg->msgid != NX_SVRMSG_MOUSEIN)
+         {
+           nxmu_mouseflush(&fe);
+         }
+#endif
+
        switch (msg->msgid)
          {
          /* Messages sent from clients to the NX server *********************/
@@ -505,7 +595,17 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
          case NX_SVRMSG_MOUSEIN: /* New mouse report from mouse client */
            {
              FAR struct nxsvrmsg_mousein_s *mousemsg = (FAR struct nxsvrmsg_mousein_s *)buffer;
+#ifdef CONFIG_NX_XYINPUT_BATCH
+             struct mq_attr attr;
+
+             /* Movement may be deferred if more messages are waiting */
+
+             (void)mq_getattr(fe.conn.crdmq, &attr);
+             nxmu_mousebatch(&fe, &mousemsg->pt, mousemsg->buttons,
+                             attr.mq_curmsgs > 0);
+#else
              nxmu_mousein(&fe, &mousemsg->pt, mousemsg->buttons);
+#endif
            }
            break;
 #endif
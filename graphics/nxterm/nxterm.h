@@ -64,6 +64,17 @@
 /* Sizes and maximums */
 
 #define MAX_USECNT         255  /* Limit to range of a uint8_t */
+#define NO_GLYPH           255  /* End of a glyph hash chain */
+
+/* Glyph cache hashing.  There is one hash chain per cache entry. */
+
+#define GLYPH_HASH(ch)     ((ch) % CONFIG_NXTERM_CACHESIZE)
+
+/* Batched text output needs directly addressable pixels */
+
+#if defined(CONFIG_NXTERM_BATCH) && CONFIG_NXTERM_BPP >= 8
+#  define NXTERM_HAVE_BATCH 1
+#endif
 
 /* Device path formats */
 
@@ -120,6 +131,8 @@ struct nxterm_glyph_s
   uint8_t width;                       /* Width of this glyph (in pixels) */
   uint8_t stride;                      /* Width of the glyph row (in bytes) */
   uint8_t usecnt;                      /* Use count */
+  uint8_t hnext;                       /* Next glyph in the hash chain */
+  uint16_t bmsize;                     /* Size of the bitmap allocation */
   FAR uint8_t *bitmap;                 /* Allocated bitmap memory */
 };
 
@@ -171,6 +184,17 @@ struct nxterm_state_s
   /* Glyph cache data storage */
 
   struct nxterm_glyph_s  glyph[CONFIG_NXTERM_CACHESIZE];
+  uint8_t ghash[CONFIG_NXTERM_CACHESIZE];   /* Heads of the hash chains */
+
+#ifdef NXTERM_HAVE_BATCH
+  /* Batched text output.  Characters bm[runstart] through bm[nchars-1]
+   * have been added to the current line but not yet drawn.
+   */
+
+  uint16_t runstart;                        /* First undrawn character */
+  uint16_t runstride;                       /* Width of runbuf (in bytes) */
+  FAR uint8_t *runbuf;                      /* One line of rendered text */
+#endif
 
   /* Keyboard input support */
 
@@ -243,6 +267,13 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv);
 void nxterm_fillchar(FAR struct nxterm_state_s *priv,
     FAR const struct nxgl_rect_s *rect, FAR const struct nxterm_bitmap_s *bm);
 
+void nxterm_initglyphs(FAR struct nxterm_state_s *priv);
+#ifdef NXTERM_HAVE_BATCH
+void nxterm_flush(FAR struct nxterm_state_s *priv);
+#else
+#  define nxterm_flush(p)
+#endif
+
 void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch);
 void nxterm_showcursor(FAR struct nxterm_state_s *priv);
 void nxterm_hidecursor(FAR struct nxterm_state_s *priv);
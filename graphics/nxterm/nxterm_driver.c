@@ -244,8 +244,9 @@ static ssize_t nxterm_write(FAR struct file *filep, FAR const char *buffer,
       while (state == VT100_ABORT);
     }
 
-  /* Show the cursor at its new position */
+  /* Draw any text not yet drawn and show the cursor at its new position */
 
+  nxterm_flush(priv);
   nxterm_showcursor(priv);
   nxterm_sempost(priv);
   return (ssize_t)buflen;
@@ -74,6 +74,14 @@
 #  error "Unsupported CONFIG_NXTERM_BPP"
 #endif
 
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifndef MAX
+#  define MAX(a,b) ((a) > (b) ? (a) : (b))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -95,16 +103,32 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxterm_freeglyph
+ * Name: nxterm_unlinkglyph
+ *
+ * Description:
+ *   Remove a glyph from its hash chain.
+ *
  ****************************************************************************/
 
-static void nxterm_freeglyph(FAR struct nxterm_glyph_s *glyph)
+static void nxterm_unlinkglyph(FAR struct nxterm_state_s *priv,
+                               FAR struct nxterm_glyph_s *glyph)
 {
-  if (glyph->bitmap)
+  FAR uint8_t *link = &priv->ghash[GLYPH_HASH(glyph->code)];
+  uint8_t ndx = (uint8_t)(glyph - priv->glyph);
+
+  while (*link != NO_GLYPH)
     {
-      kmm_free(glyph->bitmap);
+      if (*link == ndx)
+        {
+          *link = glyph->hnext;
+          break;
+        }
+
+      link = &priv->glyph[*link].hnext;
     }
-  memset(glyph, 0, sizeof(struct nxterm_glyph_s));
+
+  glyph->hnext  = NO_GLYPH;
+  glyph->usecnt = 0;
 }
 
 /****************************************************************************
@@ -146,11 +170,12 @@ nxterm_allocglyph(FAR struct nxterm_state_s *priv)
     }
 
   /* If we get here, the glyph cache is full.  We replace the least used
-   * glyph with the one we need now. (luglyph can't be NULL).
+   * glyph with the one we need now. (luglyph can't be NULL).  Its bitmap
+   * memory is kept for re-use.
    */
 
   luusecnt = luglyph->usecnt;
-  nxterm_freeglyph(luglyph);
+  nxterm_unlinkglyph(priv, luglyph);
 
   /* But lets decrement all of the usecnts so that the new one one be so
    * far behind in the counts as the older ones.
@@ -185,14 +210,15 @@ nxterm_allocglyph(FAR struct nxterm_state_s *priv)
 static FAR struct nxterm_glyph_s *
 nxterm_findglyph(FAR struct nxterm_state_s *priv, uint8_t ch)
 {
-  int i;
+  FAR struct nxterm_glyph_s *glyph;
+  uint8_t ndx;
 
   /* First, try to find the glyph in the cache of pre-rendered glyphs */
 
-   for (i = 0; i < priv->maxglyphs; i++)
+  for (ndx = priv->ghash[GLYPH_HASH(ch)]; ndx != NO_GLYPH; ndx = glyph->hnext)
     {
-      FAR struct nxterm_glyph_s *glyph = &priv->glyph[i];
-      if (glyph->usecnt > 0 && glyph->code == ch)
+      glyph = &priv->glyph[ndx];
+      if (glyph->code == ch)
         {
           /* Increment the use count (unless it is already at the max) */
 
@@ -206,6 +232,7 @@ nxterm_findglyph(FAR struct nxterm_state_s *priv, uint8_t ch)
           return glyph;
         }
     }
+
   return NULL;
 }
 
@@ -241,10 +268,22 @@ nxterm_renderglyph(FAR struct nxterm_state_s *priv,
 
   glyph->stride = (glyph->width * CONFIG_NXTERM_BPP + 7) / 8;
 
-  /* Allocate memory to hold the glyph with its offsets */
+  /* Allocate memory to hold the glyph with its offsets, re-using the
+   * memory left by the previous glyph in this entry if it is big enough.
+   */
 
   bmsize        =  glyph->stride * glyph->height;
-  glyph->bitmap = (FAR uint8_t *)kmm_malloc(bmsize);
+  if (glyph->bitmap != NULL && glyph->bmsize < bmsize)
+    {
+      kmm_free(glyph->bitmap);
+      glyph->bitmap = NULL;
+    }
+
+  if (glyph->bitmap == NULL)
+    {
+      glyph->bitmap = (FAR uint8_t *)kmm_malloc(bmsize);
+      glyph->bmsize = glyph->bitmap != NULL ? bmsize : 0;
+    }
 
   if (glyph->bitmap)
     {
@@ -319,12 +358,19 @@ nxterm_renderglyph(FAR struct nxterm_state_s *priv,
           /* Actually, the RENDERER never returns a failure */
 
           gerr("ERROR: nxterm_renderglyph: RENDERER failed\n");
-          nxterm_freeglyph(glyph);
-          glyph = NULL;
+          glyph->usecnt = 0;
+          return NULL;
         }
+
+      /* Make the glyph visible to nxterm_findglyph() */
+
+      glyph->hnext = priv->ghash[GLYPH_HASH(ch)];
+      priv->ghash[GLYPH_HASH(ch)] = (uint8_t)(glyph - priv->glyph);
+      return glyph;
     }
 
-  return glyph;
+  glyph->usecnt = 0;
+  return NULL;
 }
 
 /****************************************************************************
@@ -387,6 +433,145 @@ nxterm_getglyph(NXHANDLE hfont, FAR struct nxterm_state_s *priv, uint8_t ch)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxterm_initglyphs
+ *
+ * Description:
+ *   Initialize the (empty) glyph cache.
+ *
+ ****************************************************************************/
+
+void nxterm_initglyphs(FAR struct nxterm_state_s *priv)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NXTERM_CACHESIZE; i++)
+    {
+      priv->ghash[i]       = NO_GLYPH;
+      priv->glyph[i].hnext = NO_GLYPH;
+    }
+}
+
+/****************************************************************************
+ * Name: nxterm_flush
+ *
+ * Description:
+ *   Draw the characters that have been added to the current line but not
+ *   yet drawn.  The glyphs are composed into one line buffer and sent to
+ *   the window with a single bitmap operation.  This must be called before
+ *   anything that moves the display position or changes the display.
+ *
+ ****************************************************************************/
+
+#ifdef NXTERM_HAVE_BATCH
+void nxterm_flush(FAR struct nxterm_state_s *priv)
+{
+  FAR const struct nxterm_bitmap_s *bm;
+  FAR struct nxterm_glyph_s *glyph;
+  FAR const uint8_t *src;
+  FAR uint8_t *dest;
+  FAR const void *runsrc;
+  struct nxgl_rect_s bounds;
+  struct nxgl_point_s origin;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  int offset;
+  int ndx;
+  int row;
+  int col;
+  int ret;
+
+  if (priv->runstart >= priv->nchars)
+    {
+      priv->runstart = priv->nchars;
+      return;
+    }
+
+  bm       = &priv->bm[priv->runstart];
+  origin.x = bm->pos.x;
+  origin.y = bm->pos.y;
+  width    = priv->fpos.x - origin.x;
+
+  /* Draw the characters one at a time if the line buffer is not available
+   * or is too small (if the window has grown, for example).
+   */
+
+  if (priv->runbuf == NULL || width <= 0 ||
+      width * (CONFIG_NXTERM_BPP >> 3) > priv->runstride)
+    {
+      for (ndx = priv->runstart; ndx < priv->nchars; ndx++)
+        {
+          nxterm_fillchar(priv, NULL, &priv->bm[ndx]);
+        }
+
+      priv->runstart = priv->nchars;
+      return;
+    }
+
+  /* Clear the line buffer to the background color */
+
+  for (row = 0; row < priv->fheight; row++)
+    {
+      FAR nxgl_mxpixel_t *ptr = (FAR nxgl_mxpixel_t *)
+        &priv->runbuf[row * priv->runstride];
+
+      for (col = 0; col < width; col++)
+        {
+          *ptr++ = priv->wndo.wcolor[0];
+        }
+    }
+
+  /* Copy each glyph into place */
+
+  height = 0;
+  for (ndx = priv->runstart; ndx < priv->nchars; ndx++)
+    {
+      bm = &priv->bm[ndx];
+      if (BM_ISSPACE(bm))
+        {
+          continue;
+        }
+
+      glyph = nxterm_getglyph(priv->font, priv, bm->code);
+      if (!glyph)
+        {
+          continue;
+        }
+
+      offset = (bm->pos.x - origin.x) * (CONFIG_NXTERM_BPP >> 3);
+      src    = glyph->bitmap;
+      dest   = &priv->runbuf[offset];
+
+      for (row = 0; row < glyph->height && row < priv->fheight; row++)
+        {
+          memcpy(dest, src, MIN(glyph->stride, priv->runstride - offset));
+          src  += glyph->stride;
+          dest += priv->runstride;
+        }
+
+      height = MAX(height, row);
+    }
+
+  /* Then send the whole run to the window */
+
+  if (height > 0)
+    {
+      bounds.pt1.x = origin.x;
+      bounds.pt1.y = origin.y;
+      bounds.pt2.x = origin.x + width - 1;
+      bounds.pt2.y = origin.y + height - 1;
+
+      runsrc = (FAR const void *)priv->runbuf;
+      ret    = priv->ops->bitmap(priv, &bounds, &runsrc, &origin,
+                                 (unsigned int)priv->runstride);
+      DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
+    }
+
+  priv->runstart = priv->nchars;
+}
+#endif
+
 /****************************************************************************
  * Name: nxterm_addchar
  *
@@ -498,6 +683,10 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv)
   int ndx;
   int ret = -ENOENT;
 
+  /* Draw any pending characters before erasing one of them */
+
+  nxterm_flush(priv);
+
   /* Is there a character on the display? */
 
   if (priv->nchars > 0)
@@ -519,6 +708,9 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv)
       /* Decrement nchars to discard this character */
 
       priv->nchars = ndx;
+#ifdef NXTERM_HAVE_BATCH
+      priv->runstart = ndx;
+#endif
     }
 
   return ret;
@@ -534,6 +726,8 @@ int nxterm_backspace(FAR struct nxterm_state_s *priv)
 
 void nxterm_home(FAR struct nxterm_state_s *priv)
 {
+  nxterm_flush(priv);
+
   /* The first character is one space from the left */
 
   priv->fpos.x = priv->spwidth;
@@ -553,6 +747,8 @@ void nxterm_home(FAR struct nxterm_state_s *priv)
 
 void nxterm_newline(FAR struct nxterm_state_s *priv)
 {
+  nxterm_flush(priv);
+
   /* Carriage return: The first character is one space from the left */
 
   priv->fpos.x = priv->spwidth;
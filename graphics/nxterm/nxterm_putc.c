@@ -139,14 +139,19 @@ void nxterm_putc(FAR struct nxterm_state_s *priv, uint8_t ch)
     }
 
   /* Find the glyph associated with the character and render it onto the
-   * display.
+   * display.  When text output is batched, this is deferred until the
+   * whole run of characters on the line is drawn by nxterm_flush().
    */
 
   bm = nxterm_addchar(priv->font, priv, ch);
+#ifndef NXTERM_HAVE_BATCH
   if (bm)
     {
       nxterm_fillchar(priv, NULL, bm);
     }
+#else
+  UNUSED(bm);
+#endif
 }
 
 /****************************************************************************
@@ -134,6 +134,16 @@ FAR struct nxterm_state_s *
   /* Set up the font glyph bitmap cache */
 
   priv->maxglyphs = CONFIG_NXTERM_CACHESIZE;
+  nxterm_initglyphs(priv);
+
+#ifdef NXTERM_HAVE_BATCH
+  /* Allocate the line buffer for batched text output.  If this fails,
+   * characters are just drawn one at a time.
+   */
+
+  priv->runstride = wndo->wsize.w * (CONFIG_NXTERM_BPP >> 3);
+  priv->runbuf    = (FAR uint8_t *)kmm_malloc(priv->runstride * priv->fheight);
+#endif
 
   /* Set the initial display position */
 
@@ -155,6 +165,13 @@ FAR struct nxterm_state_s *
   return (NXTERM)priv;
 
 errout:
+#ifdef NXTERM_HAVE_BATCH
+  if (priv->runbuf)
+    {
+      kmm_free(priv->runbuf);
+    }
+#endif
+
   kmm_free(priv);
   return NULL;
 }
@@ -205,44 +205,43 @@ void nxterm_scroll(FAR struct nxterm_state_s *priv, int scrollheight)
   int i;
   int j;
 
-  /* Adjust the vertical position of each character */
+  /* Draw any pending characters before they are moved */
 
-  for (i = 0; i < priv->nchars; )
+  nxterm_flush(priv);
+
+  /* Adjust the vertical position of each character, compacting the
+   * characters that remain in a single pass.
+   */
+
+  for (i = 0, j = 0; i < priv->nchars; i++)
     {
       FAR struct nxterm_bitmap_s *bm = &priv->bm[i];
 
-      /* Has any part of this character scrolled off the screen? */
+      /* Has any part of this character scrolled off the screen?  If so,
+       * just drop it.
+       */
 
-      if (bm->pos.y < scrollheight + CONFIG_NXTERM_LINESEPARATION)
+      if (bm->pos.y >= scrollheight + CONFIG_NXTERM_LINESEPARATION)
         {
-          /* Yes... Delete the character by moving all of the data */
-
-          for (j = i; j < priv->nchars-1; j++)
-            {
-              memcpy(&priv->bm[j], &priv->bm[j+1], sizeof(struct nxterm_bitmap_s));
-            }
-
-          /* Decrement the number of cached characters ('i' is not incremented
-           * in this case because it already points to the next character)
+          /* No.. just decrement its vertical position (moving it "up" the
+           * display by one line) and keep it.
            */
 
-          priv->nchars--;
-        }
-
-      /* No.. just decrement its vertical position (moving it "up" the
-       * display by one line).
-       */
-
-      else
-        {
           bm->pos.y -= scrollheight;
+          if (j != i)
+            {
+              memcpy(&priv->bm[j], bm, sizeof(struct nxterm_bitmap_s));
+            }
 
-          /* We are keeping this one so increment to the next character */
-
-          i++;
+          j++;
         }
     }
 
+  priv->nchars = j;
+#ifdef NXTERM_HAVE_BATCH
+  priv->runstart = j;
+#endif
+
   /* And move the next display position up by one line as well */
 
   priv->fpos.y -= scrollheight;
@@ -112,6 +112,15 @@ void nxterm_unregister(NXTERM handle)
         }
     }
 
+#ifdef NXTERM_HAVE_BATCH
+  /* Free the line buffer */
+
+  if (priv->runbuf)
+    {
+      kmm_free(priv->runbuf);
+    }
+#endif
+
   /* Unregister the driver */
 
   snprintf(devname, NX_DEVNAME_SIZE, NX_DEVNAME_FORMAT, priv->minor);
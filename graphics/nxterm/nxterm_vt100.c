@@ -193,8 +193,9 @@ static enum nxterm_vt100state_e nxterm_vt100seq(FAR struct nxterm_state_s *priv,
 
       if (seq->size == seqsize)
         {
-          /* Process the VT100 sequence */
+          /* Process the VT100 sequence (after drawing any pending text) */
 
+          nxterm_flush(priv);
           seq->handler(priv);
           priv->nseq = 0;
           return VT100_PROCESSED;
@@ -0,0 +1,558 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_hextile.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_FEATURES
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  define CONFIG_DEBUG_FEATURES 1
+#  define CONFIG_DEBUG_ERROR    1
+#  define CONFIG_DEBUG_WARN     1
+#  define CONFIG_DEBUG_INFO     1
+#  define CONFIG_DEBUG_GRAPHICS 1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest possible encoding of one tile:  The subencoding byte followed
+ * by the raw pixel data.
+ */
+
+#define HEXTILE_MAXTILE(bpp) (1 + VNC_TILESIZE * VNC_TILESIZE * ((bpp) >> 3))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State that is carried from one tile to the next within a rectangle */
+
+struct hextile_state_s
+{
+  FAR struct vnc_session_s *session;
+  union
+  {
+    vnc_convert8_t  convert8;  /* Color conversion for 8-bit pixels */
+    vnc_convert16_t convert16; /* Color conversion for 16-bit pixels */
+    vnc_convert32_t convert32; /* Color conversion for 32-bit pixels */
+  } u;
+  uint8_t bpp;                 /* Remote bits per pixel */
+  bool bigendian;              /* True: Remote expects big-endian pixels */
+  bool bgvalid;                /* True: bgcolor may be carried over */
+  bool fgvalid;                /* True: fgcolor may be carried over */
+  lfb_color_t bgcolor;         /* Background of the previous tile */
+  lfb_color_t fgcolor;         /* Foreground of the previous tile */
+  size_t nbytes;               /* Number of bytes buffered in outbuf */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_pixel
+ *
+ * Description:
+ *   Convert one local framebuffer pixel to the remote color format and add
+ *   it to the update buffer.
+ *
+ * Returned Value:
+ *   The number of bytes added to the update buffer.
+ *
+ ****************************************************************************/
+
+static size_t vnc_hextile_pixel(FAR struct hextile_state_s *state,
+                                FAR uint8_t *dest, lfb_color_t color)
+{
+  switch (state->bpp)
+    {
+      case 8:
+        *dest = state->u.convert8(color);
+        return 1;
+
+      case 16:
+        if (state->bigendian)
+          {
+            rfb_putbe16(dest, state->u.convert16(color));
+          }
+        else
+          {
+            rfb_putle16(dest, state->u.convert16(color));
+          }
+
+        return 2;
+
+      case 32:
+      default:
+        if (state->bigendian)
+          {
+            rfb_putbe32(dest, state->u.convert32(color));
+          }
+        else
+          {
+            rfb_putle32(dest, state->u.convert32(color));
+          }
+
+        return 4;
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_flush
+ *
+ * Description:
+ *   Send all of the data buffered in the update buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on a network failure.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_flush(FAR struct hextile_state_s *state)
+{
+  FAR struct vnc_session_s *session = state->session;
+  FAR const uint8_t *src = session->outbuf;
+  size_t size = state->nbytes;
+  ssize_t nsent;
+
+  /* Send until all of the bytes are out.  This may loop for the case where
+   * TCP write buffering is enabled and there are a limited number of IOBs
+   * available.
+   */
+
+  while (size > 0)
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          int errcode = get_errno();
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               errcode);
+          DEBUGASSERT(errcode > 0);
+          return -errcode;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src  += nsent;
+      size -= nsent;
+    }
+
+  state->nbytes = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_raw
+ *
+ * Description:
+ *   Encode one tile using the Raw subencoding.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_raw(FAR struct hextile_state_s *state,
+                            FAR const lfb_color_t *srcleft,
+                            nxgl_coord_t width, nxgl_coord_t height)
+{
+  FAR uint8_t *dest = &state->session->outbuf[state->nbytes];
+  FAR const lfb_color_t *src;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+
+  *dest++ = RFB_SUBENCODING_RAW;
+
+  for (y = 0; y < height; y++)
+    {
+      src = srcleft;
+      for (x = 0; x < width; x++)
+        {
+          dest += vnc_hextile_pixel(state, dest, *src++);
+        }
+
+      srcleft = (FAR const lfb_color_t *)((uintptr_t)srcleft + RFB_STRIDE);
+    }
+
+  state->nbytes = (size_t)(dest - state->session->outbuf);
+
+  /* Neither color may be carried over a Raw tile */
+
+  state->bgvalid = false;
+  state->fgvalid = false;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile.  Tiles of one color are sent as a background color
+ *   only; tiles of two colors are sent as a background with foreground
+ *   subrectangles.  Anything else, or any two color tile whose subrectangles
+ *   would be larger than the raw pixels, is sent Raw.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_tile(FAR struct hextile_state_s *state,
+                             nxgl_coord_t col, nxgl_coord_t row,
+                             nxgl_coord_t width, nxgl_coord_t height)
+{
+  FAR const lfb_color_t *srcleft;
+  FAR const lfb_color_t *src;
+  FAR uint8_t *dest;
+  FAR uint8_t *subenc;
+  FAR uint8_t *pnsubrects;
+  uint16_t fgmap[VNC_TILESIZE];
+  lfb_color_t bgcolor;
+  lfb_color_t fgcolor;
+  unsigned int nfg;
+  unsigned int nsubrects;
+  unsigned int maxsubrects;
+  unsigned int bytespp;
+  unsigned int rawsize;
+  uint16_t mask;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  nxgl_coord_t w;
+  nxgl_coord_t h;
+
+  srcleft = (FAR const lfb_color_t *)
+    (state->session->fb + RFB_STRIDE * row +
+     RFB_BYTESPERPIXEL * col);
+
+  /* Classify the tile:  Build a bit map of the pixels that differ from the
+   * color of the first pixel, giving up if a third color is found.
+   */
+
+  bgcolor = *srcleft;
+  fgcolor = bgcolor;
+  nfg     = 0;
+
+  for (y = 0, src = srcleft; y < height; y++)
+    {
+      fgmap[y] = 0;
+      for (x = 0; x < width; x++)
+        {
+          lfb_color_t color = src[x];
+
+          if (color != bgcolor)
+            {
+              if (nfg == 0)
+                {
+                  fgcolor = color;
+                }
+              else if (color != fgcolor)
+                {
+                  vnc_hextile_raw(state, srcleft, width, height);
+                  return;
+                }
+
+              fgmap[y] |= (1 << x);
+              nfg++;
+            }
+        }
+
+      src = (FAR const lfb_color_t *)((uintptr_t)src + RFB_STRIDE);
+    }
+
+  /* Use the more frequent color as the background:  There will usually be
+   * fewer subrectangles that way.
+   */
+
+  if (nfg > (unsigned int)(width * height) / 2)
+    {
+      lfb_color_t tmp = bgcolor;
+      bgcolor = fgcolor;
+      fgcolor = tmp;
+
+      for (y = 0; y < height; y++)
+        {
+          fgmap[y] ^= (uint16_t)((1 << width) - 1);
+        }
+    }
+
+  /* Encode the subencoding mask and the colors */
+
+  dest    = &state->session->outbuf[state->nbytes];
+  subenc  = dest++;
+  *subenc = 0;
+
+  if (!state->bgvalid || bgcolor != state->bgcolor)
+    {
+      *subenc |= RFB_SUBENCODING_BACK;
+      dest    += vnc_hextile_pixel(state, dest, bgcolor);
+    }
+
+  state->bgcolor = bgcolor;
+  state->bgvalid = true;
+
+  if (nfg == 0)
+    {
+      /* A solid tile.  The foreground, if any, still carries over */
+
+      state->nbytes = (size_t)(dest - state->session->outbuf);
+      return;
+    }
+
+  if (!state->fgvalid || fgcolor != state->fgcolor)
+    {
+      *subenc |= RFB_SUBENCODING_FORE;
+      dest    += vnc_hextile_pixel(state, dest, fgcolor);
+    }
+
+  *subenc   |= RFB_SUBENCODING_ANY;
+  pnsubrects = dest++;
+
+  /* Limit the subrectangles so that the encoding never gets larger than a
+   * Raw tile would be.
+   */
+
+  bytespp   = state->bpp >> 3;
+  rawsize   = 1 + width * height * bytespp;
+  nsubrects = 0;
+
+  if ((unsigned int)(dest - subenc) >= rawsize)
+    {
+      vnc_hextile_raw(state, srcleft, width, height);
+      return;
+    }
+
+  maxsubrects = (rawsize - (unsigned int)(dest - subenc)) / 2;
+
+  /* Cover the foreground pixels with subrectangles:  Take the longest run
+   * starting at the first remaining pixel and extend it down for as long
+   * as the rows below contain the same run.
+   */
+
+  for (y = 0; y < height; y++)
+    {
+      while (fgmap[y] != 0)
+        {
+          x = 0;
+          while ((fgmap[y] & (1 << x)) == 0)
+            {
+              x++;
+            }
+
+          w = 1;
+          while (x + w < width && (fgmap[y] & (1 << (x + w))) != 0)
+            {
+              w++;
+            }
+
+          mask = (uint16_t)(((1 << w) - 1) << x);
+
+          h = 1;
+          while (y + h < height && (fgmap[y + h] & mask) == mask)
+            {
+              h++;
+            }
+
+          if (++nsubrects > maxsubrects)
+            {
+              vnc_hextile_raw(state, srcleft, width, height);
+              return;
+            }
+
+          *dest++ = (uint8_t)((x << 4) | y);
+          *dest++ = (uint8_t)(((w - 1) << 4) | (h - 1));
+
+          while (h-- > 0)
+            {
+              fgmap[y + h] &= ~mask;
+            }
+        }
+    }
+
+  *pnsubrects    = (uint8_t)nsubrects;
+  state->fgcolor = fgcolor;
+  state->fgvalid = true;
+  state->nbytes  = (size_t)(dest - state->session->outbuf);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error
+ *   was encountered).  Otherwise, the size of the framebuffer update
+ *   message is returned on success or a negated errno value is returned on
+ *   failure that indicates the the nature of the failure.  A failure is
+ *   only returned in cases of a network failure and unexpected internal
+ *   failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  FAR struct rfb_rectangle_s *hrect;
+  struct hextile_state_s state;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  size_t maxtile;
+  size_t total;
+  int ret;
+
+  /* Check if the client supports the Hextile encoding and that a whole
+   * Raw tile of the remote pixel depth will fit in the update buffer.
+   */
+
+  maxtile = HEXTILE_MAXTILE(session->bpp);
+  if (!session->hextile ||
+      maxtile + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0)) >
+      VNCSERVER_UPDATE_BUFSIZE)
+    {
+      return 0;
+    }
+
+  state.session   = session;
+  state.bpp       = session->bpp;
+  state.bigendian = session->bigendian;
+  state.bgvalid   = false;
+  state.fgvalid   = false;
+
+  switch (session->colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        state.u.convert8 = vnc_convert_rgb8_222;
+        break;
+
+      case FB_FMT_RGB8_332:
+        state.u.convert8 = vnc_convert_rgb8_332;
+        break;
+
+      case FB_FMT_RGB16_555:
+        state.u.convert16 = vnc_convert_rgb16_555;
+        break;
+
+      case FB_FMT_RGB16_565:
+        state.u.convert16 = vnc_convert_rgb16_565;
+        break;
+
+      case FB_FMT_RGB32:
+        state.u.convert32 = vnc_convert_rgb32_888;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  width  = rect->pt2.x - rect->pt1.x + 1;
+  height = rect->pt2.y - rect->pt1.y + 1;
+
+  /* Format the FrameBuffer Update with a single Hextile encoded
+   * rectangle.  The tile data is streamed behind it, flushing the update
+   * buffer whenever it cannot hold another tile.
+   */
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect,       1);
+
+  hrect           = (FAR struct rfb_rectangle_s *)&update->rect;
+  rfb_putbe16(hrect->xpos,         rect->pt1.x);
+  rfb_putbe16(hrect->ypos,         rect->pt1.y);
+  rfb_putbe16(hrect->width,        width);
+  rfb_putbe16(hrect->height,       height);
+  rfb_putbe32(hrect->encoding,     RFB_ENCODING_HEXTILE);
+
+  state.nbytes = SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
+  total        = 0;
+
+  for (y = rect->pt1.y; y <= rect->pt2.y; y += VNC_TILESIZE)
+    {
+      for (x = rect->pt1.x; x <= rect->pt2.x; x += VNC_TILESIZE)
+        {
+          if (state.nbytes + maxtile > VNCSERVER_UPDATE_BUFSIZE)
+            {
+              total += state.nbytes;
+              ret    = vnc_hextile_flush(&state);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          vnc_hextile_tile(&state, x, y,
+                           MIN(VNC_TILESIZE, rect->pt2.x - x + 1),
+                           MIN(VNC_TILESIZE, rect->pt2.y - y + 1));
+        }
+    }
+
+  total += state.nbytes;
+  ret    = vnc_hextile_flush(&state);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+  return (int)total;
+}
+
+#endif /* CONFIG_VNCSERVER_HEXTILE */
@@ -474,6 +474,9 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  session->hextile = false;
+#endif
 
   /* Loop for each client supported encoding */
 
@@ -490,6 +493,13 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      else if (encoding == RFB_ENCODING_HEXTILE)
+        {
+          session->hextile = true;
+        }
+#endif
     }
 
   session->change = true;
@@ -172,6 +172,14 @@
 #define RFB_MAX_DISPLAYS    CONFIG_VNCSERVER_NDISPLAYS
 #define RFB_DISPLAY_PORT(d) (RFB_PORT_BASE + (d))
 
+/* Hextile encoding tiles and change detection tiles are both 16x16 pixels */
+
+#define VNC_TILESIZE        16
+#define VNC_NTILES_X \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + VNC_TILESIZE - 1) / VNC_TILESIZE)
+#define VNC_NTILES_Y \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + VNC_TILESIZE - 1) / VNC_TILESIZE)
+
 /* Miscellaneous */
 
 #ifndef MIN
@@ -231,6 +239,7 @@ struct vnc_fbupdate_s
 {
   FAR struct vnc_fbupdate_s *flink;
   bool whupd;                  /* True: whole screen update */
+  bool change;                 /* True: Framebuffer data change */
   struct nxgl_rect_s rect;     /* The enqueued update rectangle */
 };
 
@@ -251,6 +260,9 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -271,6 +283,12 @@ struct vnc_session_s
   sem_t freesem;
   sem_t queuesem;
 
+#ifdef CONFIG_VNCSERVER_TILEHASH
+  /* Hash of the content of each tile when it was last sent */
+
+  uint32_t tilehash[VNC_NTILES_Y][VNC_NTILES_X];
+#endif
+
   /* I/O buffers for misc network send/receive */
 
   uint8_t inbuf[CONFIG_VNCSERVER_INBUFFER_SIZE];
@@ -498,6 +516,32 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.  Tiles of one or
+ *  two colors are sent as subrectangles; all others are sent raw.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error
+ *   was encountered).  Otherwise, the size of the framebuffer update
+ *   message is returned on success or a negated errno value is returned on
+ *   failure that indicates the the nature of the failure.  A failure is
+ *   only returned in cases of a network failure and unexpected internal
+ *   failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect);
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -71,6 +71,12 @@
 #undef VNCSERVER_SEM_DEBUG          /* Define to dump queue/semaphore state */
 #undef VNCSERVER_SEM_DEBUG_SILENT   /* Define to dump only suspicious conditions */
 
+/* The area of a rectangle in pixels */
+
+#define VNC_RECTAREA(r) \
+  ((uint32_t)((r)->pt2.x - (r)->pt1.x + 1) * \
+   (uint32_t)((r)->pt2.y - (r)->pt1.y + 1))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -351,6 +357,252 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: vnc_merge_queue
+ *
+ * Description:
+ *   Try to merge a new update rectangle into a rectangle that is already in
+ *   the queue.  The rectangles are merged only if they overlap or abut and
+ *   their bounding rectangle is no larger than the two rectangles were
+ *   separately.  The caller must have the scheduler locked.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The new update rectangle.
+ *   change  - True: Frame buffer data has changed
+ *
+ * Returned Value:
+ *   True if the update was merged and need not be queued.
+ *
+ ****************************************************************************/
+
+static bool vnc_merge_queue(FAR struct vnc_session_s *session,
+                            FAR const struct nxgl_rect_s *rect, bool change)
+{
+  FAR struct vnc_fbupdate_s *curr;
+  struct nxgl_rect_s bounds;
+  struct nxgl_rect_s grown;
+  uint32_t area;
+
+  /* Grow the new rectangle by one pixel so that abutting rectangles are
+   * found as well as overlapping ones.
+   */
+
+  grown.pt1.x = rect->pt1.x - 1;
+  grown.pt1.y = rect->pt1.y - 1;
+  grown.pt2.x = rect->pt2.x + 1;
+  grown.pt2.y = rect->pt2.y + 1;
+
+  area = VNC_RECTAREA(rect);
+
+  for (curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+       curr != NULL;
+       curr = curr->flink)
+    {
+      if (!curr->whupd && nxgl_rectoverlap(&grown, &curr->rect))
+        {
+          nxgl_rectunion(&bounds, rect, &curr->rect);
+          if (VNC_RECTAREA(&bounds) <= area + VNC_RECTAREA(&curr->rect))
+            {
+              /* The merged update may skip unchanged regions only if both
+               * of the original updates could.
+               */
+
+              nxgl_rectcopy(&curr->rect, &bounds);
+              curr->change &= change;
+
+              updinfo("Merged {(%d, %d),(%d, %d)}\n",
+                      bounds.pt1.x, bounds.pt1.y,
+                      bounds.pt2.x, bounds.pt2.y);
+              return true;
+            }
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: vnc_encode
+ *
+ * Description:
+ *   Send one rectangle from the local framebuffer using the best encoding
+ *   that the client supports.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to be sent.
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int vnc_encode(FAR struct vnc_session_s *session,
+                      FAR struct nxgl_rect_s *rect)
+{
+  int ret;
+
+  /* Attempt to use RRE encoding */
+
+  ret = vnc_rre(session, rect);
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  if (ret == 0)
+    {
+      /* Not a single color.  Try the Hextile encoding */
+
+      ret = vnc_hextile(session, rect);
+    }
+#endif
+
+  if (ret == 0)
+    {
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: vnc_tile_hash
+ *
+ * Description:
+ *   Return a hash of the pixels in one change detection tile.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+static uint32_t vnc_tile_hash(FAR struct vnc_session_s *session,
+                              nxgl_coord_t col, nxgl_coord_t row,
+                              nxgl_coord_t width, nxgl_coord_t height)
+{
+  FAR const lfb_color_t *src;
+  uint32_t hash = 2166136261u;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+
+  src = (FAR const lfb_color_t *)
+    (session->fb + RFB_STRIDE * row + RFB_BYTESPERPIXEL * col);
+
+  /* FNV-1a, one pixel at a time */
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          hash = (hash ^ src[x]) * 16777619u;
+        }
+
+      src = (FAR const lfb_color_t *)((uintptr_t)src + RFB_STRIDE);
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: vnc_update_tiles
+ *
+ * Description:
+ *   Send only the change detection tiles touched by the rectangle whose
+ *   content differs from what was last sent.  Runs of adjacent changed
+ *   tiles in a row are sent as one rectangle.  Each tile is hashed before
+ *   it is sent so that a change made while the tile is being sent will
+ *   still be detected by the next update.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle that was reported as changed.
+ *   force   - True: Send the rectangle even if nothing changed (but still
+ *             update the tile hashes).
+ *
+ * Returned Value:
+ *   A non-negative value on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_TILEHASH
+static int vnc_update_tiles(FAR struct vnc_session_s *session,
+                            FAR struct nxgl_rect_s *rect, bool force)
+{
+  struct nxgl_rect_s run;
+  uint32_t hash;
+  nxgl_coord_t width;
+  bool inrun;
+  int tx;
+  int ty;
+  int ret;
+
+  for (ty = rect->pt1.y / VNC_TILESIZE;
+       ty <= rect->pt2.y / VNC_TILESIZE;
+       ty++)
+    {
+      run.pt1.y = ty * VNC_TILESIZE;
+      run.pt2.y = MIN(run.pt1.y + VNC_TILESIZE,
+                      CONFIG_VNCSERVER_SCREENHEIGHT) - 1;
+      inrun     = false;
+
+      for (tx = rect->pt1.x / VNC_TILESIZE;
+           tx <= rect->pt2.x / VNC_TILESIZE;
+           tx++)
+        {
+          width = MIN(VNC_TILESIZE,
+                      CONFIG_VNCSERVER_SCREENWIDTH - tx * VNC_TILESIZE);
+          hash  = vnc_tile_hash(session, tx * VNC_TILESIZE, run.pt1.y,
+                                width, run.pt2.y - run.pt1.y + 1);
+
+          if (hash != session->tilehash[ty][tx])
+            {
+              session->tilehash[ty][tx] = hash;
+            }
+          else if (!force)
+            {
+              /* Unchanged.  Send the run of changed tiles to the left */
+
+              if (inrun)
+                {
+                  ret = vnc_encode(session, &run);
+                  if (ret < 0)
+                    {
+                      return ret;
+                    }
+
+                  inrun = false;
+                }
+
+              continue;
+            }
+
+          if (!inrun)
+            {
+              run.pt1.x = tx * VNC_TILESIZE;
+              inrun     = true;
+            }
+
+          run.pt2.x = tx * VNC_TILESIZE + width - 1;
+        }
+
+      if (inrun && !force)
+        {
+          ret = vnc_encode(session, &run);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  /* A forced update is sent as it is, now that all of its tiles have been
+   * hashed.
+   */
+
+  return force ? vnc_encode(session, rect) : OK;
+}
+#endif
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -394,14 +646,20 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.pt1.x, srcrect->rect.pt1.y,
               srcrect->rect.pt2.x, srcrect->rect.pt2.y);
 
-      /* Attempt to use RRE encoding */
+#ifdef CONFIG_VNCSERVER_TILEHASH
+      /* Framebuffer changes are filtered by the change detection tiles.  A
+       * whole screen update is always sent but refreshes all of the tiles.
+       * Other client requests are sent as they are.
+       */
 
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
+      if (srcrect->change || srcrect->whupd)
         {
-          /* Perform the framebuffer update using the default RAW encoding */
-
-          ret = vnc_raw(session, &srcrect->rect);
+          ret = vnc_update_tiles(session, &srcrect->rect, srcrect->whupd);
+        }
+      else
+#endif
+        {
+          ret = vnc_encode(session, &srcrect->rect);
         }
 
       /* Release the update structure */
@@ -607,6 +865,14 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                */
 
               session->change |= change;
+
+              /* Try to fold the update into one that is already queued */
+
+              if (vnc_merge_queue(session, &intersection, change))
+                {
+                  sched_unlock();
+                  return OK;
+                }
             }
 
           /* Allocate an update structure... waiting if necessary */
@@ -616,7 +882,8 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
           /* Copy the clipped rectangle into the update structure */
 
-          update->whupd = whupd;
+          update->whupd  = whupd;
+          update->change = change;
           nxgl_rectcopy(&update->rect, &intersection);
 
           /* Add the upate to the end of the update queue. */
@@ -128,6 +128,13 @@
 #define DN_RENAME   4  /* A file was renamed */
 #define DN_ATTRIB   5  /* Attributes of a file were changed */
 
+/* splice() and tee() flags (linux) */
+
+#define SPLICE_F_MOVE     (1 << 0) /* Ignored: Pages are never moved */
+#define SPLICE_F_NONBLOCK (1 << 1) /* Do not block on the pipe */
+#define SPLICE_F_MORE     (1 << 2) /* Ignored: More data will follow */
+#define SPLICE_F_GIFT     (1 << 3) /* Ignored: Used only with vmsplice() */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -172,6 +179,14 @@ extern "C"
 int open(const char *path, int oflag, ...);
 int fcntl(int fd, int cmd, ...);
 
+/* Linux-like zero-copy pipe interfaces */
+
+#ifdef CONFIG_PIPES
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
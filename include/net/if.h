@@ -41,6 +41,8 @@
  *******************************************************************************************/
 
 #include <sys/socket.h>
+#include <stdint.h>
+#include <time.h>
 
 /*******************************************************************************************
  * Pre-processor Definitions
@@ -58,6 +60,9 @@
 #define IFF_UP             (1 << 1) /* Interface is up */
 #define IFF_RUNNING        (1 << 2) /* Carrier is available */
 #define IFF_IPv6           (1 << 3) /* Configured for IPv6 packet (vs ARP or IPv4) */
+#define IFF_TXIOB          (1 << 4) /* Driver can gather TX data from I/O buffers */
+#define IFF_TXCSUM         (1 << 5) /* Hardware inserts IPv4/ICMP/TCP/UDP checksums */
+#define IFF_RXCSUM         (1 << 6) /* Hardware verifies IPv4/ICMP/TCP/UDP checksums */
 #define IFF_NOARP          (1 << 7) /* ARP is not required for this packet */
 
 /* Interface flag helpers */
@@ -76,6 +81,9 @@
 #define IFF_IS_UP(f)       (((f) & IFF_UP) != 0)
 #define IFF_IS_RUNNING(f)  (((f) & IFF_RUNNING) != 0)
 #define IFF_IS_NOARP(f)    (((f) & IFF_NOARP) != 0)
+#define IFF_IS_TXIOB(f)    (((f) & IFF_TXIOB) != 0)
+#define IFF_IS_TXCSUM(f)   (((f) & IFF_TXCSUM) != 0)
+#define IFF_IS_RXCSUM(f)   (((f) & IFF_RXCSUM) != 0)
 
 /* We only need to manage the IPv6 bit if both IPv6 and IPv4 are supported.  Otherwise,
  * we can save a few bytes by ignoring it.
@@ -136,6 +144,28 @@ struct mii_ioctl_data_s
   uint16_t val_out;     /* PHY output data */
 };
 
+/* Structure passed with the SIOCxHWTSTAMP ioctl commands to configure hardware time
+ * stamping.
+ */
+
+struct hwtstamp_config
+{
+  int flags;            /* Reserved, must be zero */
+  int tx_type;          /* HWTSTAMP_TX_* */
+  int rx_filter;        /* HWTSTAMP_FILTER_* */
+};
+
+/* Values of hwtstamp_config tx_type */
+
+#define HWTSTAMP_TX_OFF            0 /* No transmit time stamps */
+#define HWTSTAMP_TX_ON             1 /* Time stamp frames that request it */
+
+/* Values of hwtstamp_config rx_filter */
+
+#define HWTSTAMP_FILTER_NONE       0 /* No receive time stamps */
+#define HWTSTAMP_FILTER_ALL        1 /* Time stamp all received frames */
+#define HWTSTAMP_FILTER_PTP_V2_EVENT 12 /* Time stamp PTPv2 event messages only */
+
 /* There are two forms of the I/F request structure.  One for IPv6 and one for IPv4.
  * Notice that they are (and must be) cast compatible and really different only
  * in the size of the structure allocation.
@@ -194,6 +224,9 @@ struct ifreq
     uint8_t                   ifru_flags;               /* Interface flags */
     struct mii_iotcl_notify_s ifru_mii_notify;          /* PHY event notification */
     struct mii_ioctl_data_s   ifru_mii_data;            /* MII request data */
+    struct hwtstamp_config    ifru_hwtstamp;            /* Time stamping config */
+    struct timespec           ifru_phctime;             /* PHC time or offset */
+    int32_t                   ifru_phcppb;              /* PHC frequency offset */
   } ifr_ifru;
 };
 
@@ -212,6 +245,9 @@ struct ifreq
 #define ifr_mii_reg_num       ifr_ifru.ifru_mii_data.reg_num /* PHY register address */
 #define ifr_mii_val_in        ifr_ifru.ifru_mii_data.val_in  /* PHY input data */
 #define ifr_mii_val_out       ifr_ifru.ifru_mii_data.val_out /* PHY output data */
+#define ifr_hwtstamp          ifr_ifru.ifru_hwtstamp    /* Time stamping config */
+#define ifr_phctime           ifr_ifru.ifru_phctime     /* PHC time or offset */
+#define ifr_phcppb            ifr_ifru.ifru_phcppb      /* PHC frequency offset (ppb) */
 
 /*******************************************************************************************
  * Public Function Prototypes
@@ -82,6 +82,16 @@
 #define IPPROTO_UDPLITE       136  /* UDP-Lite (RFC 3828) */
 #define IPPROTO_RAW           255  /* Raw IP packets */
 
+/* Socket options at the IPPROTO_IP level.  NOTE: IPPROTO_IP has the same
+ * value as SOL_SOCKET so these option values must not overlap the SO_
+ * definitions in sys/socket.h.
+ */
+
+#define IP_ADD_SOURCE_MEMBERSHIP  39 /* Join a group and accept datagrams from
+                                      * one source.  arg: struct ip_mreq_source */
+#define IP_DROP_SOURCE_MEMBERSHIP 40 /* Stop accepting datagrams from the
+                                      * source.  arg: struct ip_mreq_source */
+
 /* Values used with SIOCSIFMCFILTER and SIOCGIFMCFILTER ioctl's */
 
 #define MCAST_EXCLUDE         0
@@ -158,6 +168,15 @@ struct sockaddr_in
   struct in_addr  sin_addr;    /* Internet address */
 };
 
+/* Argument of IP_ADD_SOURCE_MEMBERSHIP and IP_DROP_SOURCE_MEMBERSHIP */
+
+struct ip_mreq_source
+{
+  struct in_addr  imr_multiaddr;  /* IP multicast address of group */
+  struct in_addr  imr_interface;  /* Local IP address of interface */
+  struct in_addr  imr_sourceaddr; /* IP address of source */
+};
+
 /* IPv6 Internet address */
 
 struct in6_addr
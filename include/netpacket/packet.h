@@ -47,6 +47,33 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet socket options (level SOL_PACKET) */
+
+#define SOL_PACKET        263
+#define PACKET_RX_RING    5   /* Set up a receive ring. arg: struct tpacket_req */
+
+/* Values of tpacket_hdr tp_status.  A frame belongs to the kernel while its
+ * status is TP_STATUS_KERNEL and to the application while TP_STATUS_USER is
+ * set.  The application returns the frame by writing TP_STATUS_KERNEL.
+ */
+
+#define TP_STATUS_KERNEL  0
+#define TP_STATUS_USER    (1 << 0)
+#define TP_STATUS_COPY    (1 << 1)  /* The frame was truncated to tp_snaplen */
+#define TP_STATUS_LOSING  (1 << 2)  /* Frames were dropped before this one */
+
+/* Each ring frame starts with a struct tpacket_hdr.  The captured frame
+ * follows at offset tp_mac (TPACKET_HDRLEN).
+ */
+
+#define TPACKET_ALIGNMENT 16
+#define TPACKET_ALIGN(x)  (((x) + TPACKET_ALIGNMENT - 1) & ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN    TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -58,4 +85,31 @@ struct sockaddr_ll
   int16_t  sll_ifindex;
 };
 
+/* PACKET_RX_RING geometry.  The ring is tp_block_nr contiguous blocks of
+ * tp_block_size bytes, each holding tp_block_size / tp_frame_size frames.
+ * The ring is obtained with mmap(NULL, tp_block_size * tp_block_nr,
+ * PROT_READ | PROT_WRITE, MAP_SHARED, sockfd, 0).
+ */
+
+struct tpacket_req
+{
+  unsigned int tp_block_size;  /* Minimal size of a contiguous block */
+  unsigned int tp_block_nr;    /* Number of blocks */
+  unsigned int tp_frame_size;  /* Size of a frame */
+  unsigned int tp_frame_nr;    /* Total number of frames */
+};
+
+/* Header at the beginning of each ring frame */
+
+struct tpacket_hdr
+{
+  unsigned long  tp_status;    /* TP_STATUS_* */
+  unsigned int   tp_len;       /* Length of the frame on the wire */
+  unsigned int   tp_snaplen;   /* Length of the captured data */
+  unsigned short tp_mac;       /* Offset of the frame from the header */
+  unsigned short tp_net;       /* Offset of the network header */
+  unsigned int   tp_sec;       /* Time of capture (CLOCK_REALTIME) */
+  unsigned int   tp_usec;
+};
+
 #endif  /* __INCLUDE_NETPACKET_PACKET_H */
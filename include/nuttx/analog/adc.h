@@ -72,6 +72,15 @@
 #  define CONFIG_ADC_FIFOSIZE 255
 #endif
 
+#ifdef CONFIG_ADC_STREAM
+#  ifndef CONFIG_ADC_STREAM_NBLOCKS
+#    define CONFIG_ADC_STREAM_NBLOCKS 4
+#  endif
+#  ifndef CONFIG_ADC_STREAM_BLOCKSIZE
+#    define CONFIG_ADC_STREAM_BLOCKSIZE 512
+#  endif
+#endif
+
 #define ADC_RESET(dev)         ((dev)->ad_ops->ao_reset((dev)))
 #define ADC_SETUP(dev)         ((dev)->ad_ops->ao_setup((dev)))
 #define ADC_SHUTDOWN(dev)      ((dev)->ad_ops->ao_shutdown((dev)))
@@ -99,6 +108,26 @@ struct adc_callback_s
    */
 
   CODE int (*au_receive)(FAR struct adc_dev_s *dev, uint8_t ch, int32_t data);
+
+#ifdef CONFIG_ADC_STREAM
+  /* This method is called from the lower half when streaming is enabled and
+   * one DMA half-buffer has been filled.  The data is copied into the stream
+   * ring so the half-buffer may be refilled as soon as this returns.
+   *
+   * Input Parameters:
+   *   dev    - The ADC device structure that was previously registered by
+   *            adc_register()
+   *   block  - The completed half-buffer
+   *   nbytes - The number of valid bytes in the half-buffer
+   *
+   * Returned Value:
+   *   Zero on success; -ENOSPC if the block was dropped because the ring was
+   *   full (an overrun).
+   */
+
+  CODE int (*au_receive_block)(FAR struct adc_dev_s *dev,
+                               FAR const void *block, size_t nbytes);
+#endif
 };
 
 /* This describes on ADC message */
@@ -120,6 +149,29 @@ struct adc_fifo_s
   struct adc_msg_s af_buffer[CONFIG_ADC_FIFOSIZE];
 };
 
+#ifdef CONFIG_ADC_STREAM
+/* Returned by ANIOC_STREAM_STATUS */
+
+struct adc_stream_status_s
+{
+  uint16_t     as_blksize;               /* Block size in bytes */
+  uint8_t      as_nblocks;               /* Number of blocks in the ring */
+  uint8_t      as_navail;                /* Number of filled blocks in the ring */
+  uint32_t     as_nreceived;             /* Blocks received since streaming started */
+  uint32_t     as_noverruns;             /* Blocks dropped since streaming started */
+};
+
+/* Returned by ANIOC_STREAM_GETBLOCK.  The offset is relative to the address
+ * returned by mmap().
+ */
+
+struct adc_block_s
+{
+  uint32_t     ab_offset;                /* Offset of the block in the ring */
+  uint16_t     ab_nbytes;                /* Number of valid bytes in the block */
+};
+#endif
+
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
  * caller of can_register().
@@ -162,6 +214,17 @@ struct adc_ops_s
   /* All ioctl calls will be routed through this method */
 
   CODE int (*ao_ioctl)(FAR struct adc_dev_s *dev, int cmd, unsigned long arg);
+
+#ifdef CONFIG_ADC_STREAM
+  /* Start or stop streaming.  When blksize is non-zero, the lower half
+   * should start continuous DMA conversions into a double buffer of two
+   * blksize halves and pass each half to au_receive_block() as it completes.
+   * When blksize is zero, streaming should be stopped.  This method is
+   * optional.
+   */
+
+  CODE int (*ao_stream)(FAR struct adc_dev_s *dev, size_t blksize);
+#endif
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -183,6 +246,20 @@ struct adc_dev_s
   sem_t                       ad_closesem;   /* Locks out new opens while close is in progress */
   sem_t                       ad_recvsem;    /* Used to wakeup user waiting for space in ad_recv.buffer */
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
+#ifdef CONFIG_ADC_STREAM
+  /* Block stream ring.  ad_recv.af_sem and ad_nrxwaiters are used to wait
+   * for blocks.
+   */
+
+  FAR uint8_t                *ad_sbuffer;    /* Block storage (NULL if not streaming) */
+  uint16_t                    ad_blksize;    /* Size of one block */
+  uint16_t                    ad_soffset;    /* Bytes already read from the head block */
+  volatile uint8_t            ad_shead;      /* Index of the oldest filled block */
+  volatile uint8_t            ad_scount;     /* Number of filled blocks */
+  uint32_t                    ad_sreceived;  /* Blocks received */
+  uint32_t                    ad_soverruns;  /* Blocks dropped because the ring was full */
+  uint16_t                    ad_slen[CONFIG_ADC_STREAM_NBLOCKS];
+#endif
 #endif
 
   /* Fields provided by lower half ADC logic */
@@ -1676,6 +1676,27 @@ int up_timer_start(FAR const struct timespec *ts);
  */
 #endif
 
+/****************************************************************************
+ * Name: up_tls_setpointer
+ *
+ * Description:
+ *   Set the thread pointer register of the current CPU.  With compiler
+ *   thread local storage (__thread), the compiler generates code that
+ *   reads this register to locate the TLS block of the running thread.
+ *   This is called by the scheduler whenever a thread is resumed.
+ *
+ * Input Parameters:
+ *   tp - The thread pointer of the thread that is about to run
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+void up_tls_setpointer(FAR void *tp);
+#endif
+
 /****************************************************************************
  * Multiple CPU support
  ****************************************************************************/
@@ -1845,6 +1866,28 @@ int up_cpu_pause(int cpu);
 int up_cpu_resume(int cpu);
 #endif
 
+/****************************************************************************
+ * Name: up_cpu_resched
+ *
+ * Description:
+ *   Send a "reschedule" inter-processor interrupt to another CPU.  Unlike
+ *   up_cpu_pause(), this does not wait for the other CPU:  The interrupt
+ *   handler does nothing itself.  The caller will already have set the
+ *   need-resched flag of the CPU and that flag is acted upon by
+ *   sched_resched_process() when the CPU returns from the interrupt.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU to be interrupted.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_RESCHED_IPI
+int up_cpu_resched(int cpu);
+#endif
+
 /****************************************************************************
  * Name: up_romgetc
  *
@@ -1896,6 +1939,24 @@ char up_romgetc(FAR const char *ptr);
 void up_mdelay(unsigned int milliseconds);
 void up_udelay(useconds_t microseconds);
 
+/****************************************************************************
+ * Name: up_perf_gettime and up_perf_getfreq
+ *
+ * Description:
+ *   If CONFIG_ARCH_HAVE_PERF_EVENTS is selected, then the platform-specific
+ *   logic must provide a free-running, high resolution counter (typically
+ *   a CPU cycle counter) for use by instrumentation.  up_perf_gettime()
+ *   returns the current, 32-bit count; the count wraps around silently.
+ *   up_perf_getfreq() returns the rate at which the count increments in
+ *   Hz.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+uint32_t up_perf_gettime(void);
+uint32_t up_perf_getfreq(void);
+#endif
+
 /****************************************************************************
  * Name: up_cxxinitialize
  *
@@ -1985,6 +2046,31 @@ void sched_timer_expiration(void);
 void sched_alarm_expiration(FAR const struct timespec *ts);
 #endif
 
+/****************************************************************************
+ * Name:  sched_timer_remaining
+ *
+ * Description:
+ *   if CONFIG_SCHED_TICKLESS is defined, then this function is provided by
+ *   the RTOS base code and may be called from the platform-specific IDLE
+ *   loop (or the power management logic) to learn how long the CPU may
+ *   sleep before the next timer event.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The number of ticks until the next timer event (at least one if an
+ *   event is pending) or zero if no timer event is pending.
+ *
+ * Assumptions/Limitations:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int sched_timer_remaining(void);
+#endif
+
 /****************************************************************************
  * Name: sched_process_cpuload
  *
@@ -2265,6 +2351,24 @@ int up_getc(void);
 
 void up_puts(FAR const char *str);
 
+/****************************************************************************
+ * Name: up_crc32part and up_crc16part
+ *
+ * Description:
+ *   Hardware implementations of crc32part() and crc16part().  These must
+ *   return exactly the same value as the software implementations in
+ *   libc/misc and must be callable from any context.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIB_CRC32_ARCH
+uint32_t up_crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val);
+#endif
+
+#ifdef CONFIG_LIB_CRC16_ARCH
+uint16_t up_crc16part(FAR const uint8_t *src, size_t len, uint16_t crc16val);
+#endif
+
 /********************************************************************************
  * Name: arch_sporadic_*
  *
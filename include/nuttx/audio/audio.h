@@ -103,6 +103,23 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_ENQUEUEBUFFERS - Enqueue several audio buffers at once
+ *
+ *   ioctl argument:  Pointer to an audio_bufvec_desc_s structure listing
+ *                    the buffers.  On return, nbuffers holds the number of
+ *                    buffers that were enqueued.
+ *
+ * AUDIOIOC_DEQUEUEBUFFERS - Take completed buffers from the dequeue ring
+ *
+ *   ioctl argument:  Pointer to an audio_bufvec_desc_s structure to receive
+ *                    up to nbuffers completed buffers.  Waits for at least
+ *                    one buffer unless the device was opened O_NONBLOCK.
+ *                    nbuffers is zero on return when playback has
+ *                    completed (or was never started) and all completed
+ *                    buffers have been taken.  Only available with
+ *                    CONFIG_AUDIO_BUFFER_RING > 0 and only used when no
+ *                    message queue is registered.
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -121,6 +138,8 @@
 #define AUDIOIOC_REGISTERMQ         _AUDIOIOC(14)
 #define AUDIOIOC_UNREGISTERMQ       _AUDIOIOC(15)
 #define AUDIOIOC_HWRESET            _AUDIOIOC(16)
+#define AUDIOIOC_ENQUEUEBUFFERS     _AUDIOIOC(17)
+#define AUDIOIOC_DEQUEUEBUFFERS     _AUDIOIOC(18)
 
 /* Audio Device Types *******************************************************/
 /* The NuttX audio interface support different types of audio devices for
@@ -430,6 +449,20 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* Structure for enqueueing and dequeueing several audio pipeline buffers
+ * at once via the AUDIOIOC_ENQUEUEBUFFERS and AUDIOIOC_DEQUEUEBUFFERS
+ * ioctls.
+ */
+
+struct audio_bufvec_desc_s
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void            *session;           /* Associated channel */
+#endif
+  uint16_t            nbuffers;           /* Number of entries in buffers[] */
+  FAR struct ap_buffer_s **buffers;       /* The buffers */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_mixer.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/audio/audio.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************
+ * CONFIG_AUDIO_MIXER - Enables the software audio mixer
+ * CONFIG_AUDIO_MIXER_NSTREAMS - The number of client streams
+ * CONFIG_AUDIO_MIXER_SAMPRATE - The sample rate of the mixed output
+ * CONFIG_AUDIO_MIXER_PERIOD - The number of frames in each output buffer
+ * CONFIG_AUDIO_MIXER_NBUFFERS - The number of output buffers
+ * CONFIG_AUDIO_MIXER_PRIORITY - The priority of the mixer thread
+ * CONFIG_AUDIO_MIXER_STACKSIZE - The stack size of the mixer thread
+ */
+
+#ifndef CONFIG_AUDIO_MIXER_NSTREAMS
+#  define CONFIG_AUDIO_MIXER_NSTREAMS 2
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_SAMPRATE
+#  define CONFIG_AUDIO_MIXER_SAMPRATE 48000
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_PERIOD
+#  define CONFIG_AUDIO_MIXER_PERIOD 256
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_NBUFFERS
+#  define CONFIG_AUDIO_MIXER_NBUFFERS 2
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_PRIORITY
+#  define CONFIG_AUDIO_MIXER_PRIORITY 250
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_STACKSIZE
+#  define CONFIG_AUDIO_MIXER_STACKSIZE 1024
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Initialize the software audio mixer.  The mixer accepts and contains a
+ *   low-level audio DAC-type device.  It then returns
+ *   CONFIG_AUDIO_MIXER_NSTREAMS new audio lower half interfaces, each of
+ *   which may be registered with audio_register() as a separate device.
+ *
+ *   Each stream accepts 16-bit PCM at its own sample rate and number of
+ *   channels and has its own volume setting.  A dedicated mixer thread
+ *   converts all active streams to the output sample rate, mixes them and
+ *   passes the result to the low-level device.
+ *
+ *   Only one mixer instance is supported.
+ *
+ * Input Parameters:
+ *   dev     - A reference to the low-level audio DAC-type device to contain.
+ *   streams - The location to return CONFIG_AUDIO_MIXER_NSTREAMS stream
+ *             lower half interfaces.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR struct audio_lowerhalf_s *dev,
+                           FAR struct audio_lowerhalf_s **streams);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_MIXER */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H */
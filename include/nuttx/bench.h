@@ -0,0 +1,126 @@
+/****************************************************************************
+ * include/nuttx/bench.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_BENCH_H
+#define __INCLUDE_NUTTX_BENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The benchmarks */
+
+enum bench_e
+{
+  BENCH_CTXSWITCH = 0,  /* sched_yield() between two threads to the other
+                         * thread running */
+  BENCH_SEMWAKE,        /* sem_post() to the higher priority waiter
+                         * returning from sem_wait() */
+  BENCH_MQROUNDTRIP,    /* mq_send() of a request to mq_receive() of the
+                         * reply from a server thread */
+  BENCH_MUTEX,          /* pthread_mutex_unlock() to the higher priority
+                         * waiter returning from pthread_mutex_lock() */
+  BENCH_MALLOC,         /* One kmm_free() and kmm_malloc() pair */
+  BENCH_WDOG,           /* One wd_start() and wd_cancel() pair */
+  BENCH_WORKQUEUE,      /* work_queue() to the worker running */
+  BENCH_TIMERJITTER,    /* Deviation of the period of a one tick watchdog
+                         * from one tick */
+  BENCH_NTESTS
+};
+
+/* The result of one benchmark.  All times are in counts of
+ * up_perf_getfreq() Hz.
+ */
+
+struct bench_result_s
+{
+  uint32_t freq;        /* Frequency of the time counts (Hz) */
+  uint32_t nsamples;    /* Number of samples taken */
+  uint32_t min;         /* Shortest sample */
+  uint32_t max;         /* Longest sample */
+  uint64_t total;       /* Sum of all samples */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: bench_run
+ *
+ * Description:
+ *   Run one OS micro-benchmark.  Only one benchmark runs at a time; a
+ *   concurrent caller waits.  The benchmark threads run at
+ *   CONFIG_SCHED_BENCHMARK_PRIORITY and, under SMP, are kept on the CPU of
+ *   the caller.
+ *
+ * Input Parameters:
+ *   test     - The benchmark to run (see enum bench_e)
+ *   nsamples - The number of samples to take.  Zero selects
+ *              CONFIG_SCHED_BENCHMARK_NSAMPLES.
+ *   result   - The location to return the result
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  -ENOSYS is
+ *   returned if the benchmark depends on a feature that is not enabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_BENCHMARK
+int bench_run(int test, uint32_t nsamples, FAR struct bench_result_s *result);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_BENCH_H */
@@ -109,10 +109,20 @@ struct elf_loadinfo_s
   uintptr_t         dataalloc;   /* .bss/.data memory allocated when ELF file was loaded */
   size_t            textsize;    /* Size of the ELF .text memory allocation */
   size_t            datasize;    /* Size of the ELF .bss/.data memory allocation */
+  uintptr_t         textbase;    /* Address of the first read-only section */
+#ifdef CONFIG_ELF_XIP
+  uintptr_t         xipbase;     /* Address of the file in memory (or 0) */
+#endif
   off_t             filelen;     /* Length of the entire ELF file */
   Elf32_Ehdr        ehdr;        /* Buffered ELF file header */
   FAR Elf32_Shdr    *shdr;       /* Buffered ELF section headers */
   uint8_t           *iobuffer;   /* File I/O buffer */
+  FAR uintptr_t     *symcache;   /* Exported values of undefined symbols
+                                  * (by symbol index) while binding */
+  int                nsymcache;  /* Number of entries in symcache[] */
+  FAR const Elf32_Sym *symbols;  /* Symbol table in memory (or NULL) */
+  FAR const char    *strings;    /* Symbol string table in memory (or NULL) */
+  FAR void          *taballoc;   /* Memory holding symbols[] and strings[] */
 
   /* Constructors and destructors */
 
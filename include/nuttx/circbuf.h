@@ -0,0 +1,241 @@
+/****************************************************************************
+ * include/nuttx/circbuf.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CIRCBUF_H
+#define __INCLUDE_NUTTX_CIRCBUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Memory barrier.  The producer must make the data visible before it
+ * publishes the new head index, and the consumer must finish with the data
+ * before it publishes the new tail index.  On a single CPU, where the
+ * producer and consumer are an interrupt handler and a task, only the
+ * compiler must be prevented from re-ordering the accesses.
+ */
+
+#ifndef CIRCBUF_BARRIER
+#  if defined(CONFIG_SMP) && defined(__GNUC__)
+#    define CIRCBUF_BARRIER() __sync_synchronize()
+#  elif defined(__GNUC__)
+#    define CIRCBUF_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#  else
+#    define CIRCBUF_BARRIER()
+#  endif
+#endif
+
+/* Inline queries.  The head and tail indices run freely and are reduced
+ * modulo the (power of two) buffer size only when the buffer is accessed.
+ * The number of bytes held is then just their difference.
+ */
+
+#define circbuf_used(c)     ((size_t)((c)->head - (c)->tail))
+#define circbuf_space(c)    ((c)->size - circbuf_used(c))
+#define circbuf_is_empty(c) ((c)->head == (c)->tail)
+#define circbuf_is_full(c)  (circbuf_used(c) >= (c)->size)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one single-producer, single-consumer circular
+ * buffer.  Only the producer modifies head and only the consumer modifies
+ * tail, so no lock is needed as long as there is only one of each.
+ */
+
+struct circbuf_s
+{
+  FAR uint8_t *base;        /* The buffer memory */
+  size_t size;              /* Size of the buffer (a power of two) */
+  volatile size_t head;     /* Producer index (free running) */
+  volatile size_t tail;     /* Consumer index (free running) */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: circbuf_init
+ *
+ * Description:
+ *   Initialize a circular buffer to use the caller provided memory.
+ *
+ * Input Parameters:
+ *   circ - The circular buffer to be initialized
+ *   base - The buffer memory
+ *   size - The size of the buffer memory.  Must be a power of two.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the size is not a power of two.
+ *
+ ****************************************************************************/
+
+int circbuf_init(FAR struct circbuf_s *circ, FAR void *base, size_t size);
+
+/****************************************************************************
+ * Name: circbuf_reset
+ *
+ * Description:
+ *   Discard all buffered data.  This must not run concurrently with either
+ *   the producer or the consumer.
+ *
+ ****************************************************************************/
+
+void circbuf_reset(FAR struct circbuf_s *circ);
+
+/****************************************************************************
+ * Name: circbuf_write
+ *
+ * Description:
+ *   Copy data into the circular buffer.  Called only by the producer.
+ *
+ * Input Parameters:
+ *   circ - The circular buffer
+ *   src  - The data to be written
+ *   len  - The number of bytes to write
+ *
+ * Returned Value:
+ *   The number of bytes actually written.  This is less than len if the
+ *   buffer became full.
+ *
+ ****************************************************************************/
+
+size_t circbuf_write(FAR struct circbuf_s *circ, FAR const void *src,
+                     size_t len);
+
+/****************************************************************************
+ * Name: circbuf_read
+ *
+ * Description:
+ *   Copy data out of the circular buffer.  Called only by the consumer.
+ *
+ * Input Parameters:
+ *   circ - The circular buffer
+ *   dest - The location to return the data
+ *   len  - The maximum number of bytes to read
+ *
+ * Returned Value:
+ *   The number of bytes actually read.  This is less than len if the
+ *   buffer became empty.
+ *
+ ****************************************************************************/
+
+size_t circbuf_read(FAR struct circbuf_s *circ, FAR void *dest, size_t len);
+
+/****************************************************************************
+ * Name: circbuf_peekwrite
+ *
+ * Description:
+ *   Get the largest contiguous free region of the circular buffer so that
+ *   the producer may fill it in place (for example, by DMA).  The region is
+ *   not visible to the consumer until circbuf_writecommit() is called.
+ *
+ * Input Parameters:
+ *   circ - The circular buffer
+ *   ptr  - The location to return the address of the free region
+ *
+ * Returned Value:
+ *   The size of the contiguous free region.  Zero if the buffer is full.
+ *
+ ****************************************************************************/
+
+size_t circbuf_peekwrite(FAR struct circbuf_s *circ, FAR void **ptr);
+
+/****************************************************************************
+ * Name: circbuf_writecommit
+ *
+ * Description:
+ *   Publish len bytes written in place after circbuf_peekwrite().
+ *
+ ****************************************************************************/
+
+void circbuf_writecommit(FAR struct circbuf_s *circ, size_t len);
+
+/****************************************************************************
+ * Name: circbuf_peekread
+ *
+ * Description:
+ *   Get the largest contiguous region of buffered data so that the
+ *   consumer may use it in place (for example, by DMA).  The region is not
+ *   released to the producer until circbuf_readcommit() is called.
+ *
+ * Input Parameters:
+ *   circ - The circular buffer
+ *   ptr  - The location to return the address of the buffered data
+ *
+ * Returned Value:
+ *   The size of the contiguous region.  Zero if the buffer is empty.
+ *
+ ****************************************************************************/
+
+size_t circbuf_peekread(FAR struct circbuf_s *circ, FAR void **ptr);
+
+/****************************************************************************
+ * Name: circbuf_readcommit
+ *
+ * Description:
+ *   Release len bytes consumed in place after circbuf_peekread().
+ *
+ ****************************************************************************/
+
+void circbuf_readcommit(FAR struct circbuf_s *circ, size_t len);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_CIRCBUF_H */
@@ -42,6 +42,8 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -49,9 +51,45 @@
  ****************************************************************************/
 
 #define AES128_KEY_SIZE    16
+#define AES192_KEY_SIZE    24
+#define AES256_KEY_SIZE    32
+
+#define AES_BLOCK_SIZE     16
+#define AES_MAXROUNDS      14
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* An expanded AES key.  The key schedule is computed once by aes_setkey()
+ * and may then be used for any number of blocks.  The context is not
+ * modified by the cipher functions so it may be shared by several threads.
+ */
+
+struct aes_context_s
+{
+  uint32_t ek[4 * (AES_MAXROUNDS + 1)];  /* Encryption round keys */
+  uint32_t dk[4 * (AES_MAXROUNDS + 1)];  /* Decryption round keys */
+  int nrounds;                           /* 10, 12 or 14 */
+};
+
+/* The state of one AES-GCM operation.  See aes_gcm_start() */
+
+struct aes_gcm_s
+{
+  struct aes_context_s aes;              /* The expanded key */
+  uint64_t hl[16];                       /* 4-bit multiplication table for */
+  uint64_t hh[16];                       /* the hash subkey H */
+  uint8_t ek0[AES_BLOCK_SIZE];           /* E(K, J0), masks the tag */
+  uint8_t counter[AES_BLOCK_SIZE];       /* Current counter block */
+  uint8_t stream[AES_BLOCK_SIZE];        /* Key stream for the counter block */
+  uint8_t ghash[AES_BLOCK_SIZE];         /* Running GHASH value */
+  uint64_t aadlen;                       /* Bytes of additional data */
+  uint64_t datalen;                      /* Bytes of plain text */
+};
 
 /****************************************************************************
- * Public Data
+ * Public Function Prototypes
  ****************************************************************************/
 
 #ifdef  __cplusplus
@@ -60,8 +98,110 @@ extern "C"
 #endif
 
 /****************************************************************************
- * Public Function Prototypes
+ * Name: aes_setkey
+ *
+ * Description:
+ *   Expand an AES key into the encryption and decryption key schedules.
+ *
+ * Input Parameters:
+ *   ctx    - The context to be initialized
+ *   key    - The AES key
+ *   keylen - The size of the key in bytes:  16, 24 or 32
+ *
+ * Returned Value
+ *   Zero (OK) on success; -EINVAL if the key size is not supported.
+ *
+ ****************************************************************************/
+
+int aes_setkey(FAR struct aes_context_s *ctx, FAR const uint8_t *key,
+               size_t keylen);
+
 /****************************************************************************
+ * Name: aes_encryptblock and aes_decryptblock
+ *
+ * Description:
+ *   Encrypt or decrypt one 16 byte block (ECB).  'in' and 'out' may refer
+ *   to the same buffer.
+ *
+ ****************************************************************************/
+
+void aes_encryptblock(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+                      FAR const uint8_t *in);
+void aes_decryptblock(FAR const struct aes_context_s *ctx, FAR uint8_t *out,
+                      FAR const uint8_t *in);
+
+/****************************************************************************
+ * Name: aes_cbc_encrypt and aes_cbc_decrypt
+ *
+ * Description:
+ *   Encrypt or decrypt a multiple of 16 bytes in CBC mode.  The IV is
+ *   updated so that a following call continues the chain.  'in' and 'out'
+ *   may refer to the same buffer.
+ *
+ * Returned Value
+ *   Zero (OK) on success; -EINVAL if len is not a multiple of the block
+ *   size.
+ *
+ ****************************************************************************/
+
+int aes_cbc_encrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *iv,
+                    FAR uint8_t *out, FAR const uint8_t *in, size_t len);
+int aes_cbc_decrypt(FAR const struct aes_context_s *ctx, FAR uint8_t *iv,
+                    FAR uint8_t *out, FAR const uint8_t *in, size_t len);
+
+/****************************************************************************
+ * Name: aes_ctr
+ *
+ * Description:
+ *   Encrypt or decrypt any number of bytes in CTR mode.  The last 32 bits
+ *   of the counter block are incremented (big-endian) for each block.
+ *
+ *   The stream state is kept by the caller so that a message may be
+ *   processed in pieces of any size:  'offset' must be zero at the start
+ *   of a message and the counter, stream block and offset must be passed
+ *   back unchanged on the following calls.
+ *
+ ****************************************************************************/
+
+void aes_ctr(FAR const struct aes_context_s *ctx, FAR size_t *offset,
+             FAR uint8_t *counter, FAR uint8_t *stream, FAR uint8_t *out,
+             FAR const uint8_t *in, size_t len);
+
+/****************************************************************************
+ * Name: aes_gcm_setkey
+ *
+ * Description:
+ *   Expand the key and compute the GHASH tables of an AES-GCM context.
+ *   The key may then be used for any number of messages.
+ *
+ ****************************************************************************/
+
+int aes_gcm_setkey(FAR struct aes_gcm_s *gcm, FAR const uint8_t *key,
+                   size_t keylen);
+
+/****************************************************************************
+ * Name: aes_gcm_start, aes_gcm_aad, aes_gcm_update and aes_gcm_finish
+ *
+ * Description:
+ *   Process one AES-GCM message:  aes_gcm_start() sets the IV (any length,
+ *   12 bytes is recommended), aes_gcm_aad() adds the additional
+ *   authenticated data and aes_gcm_update() encrypts or decrypts the
+ *   payload.  Both may be called several times with pieces of any size,
+ *   but all additional data must precede the payload.  aes_gcm_finish()
+ *   returns the authentication tag (up to 16 bytes).  On decryption the
+ *   caller must compare the tag in constant time and discard the plain
+ *   text if it does not match.
+ *
+ ****************************************************************************/
+
+void aes_gcm_start(FAR struct aes_gcm_s *gcm, FAR const uint8_t *iv,
+                   size_t ivlen);
+int aes_gcm_aad(FAR struct aes_gcm_s *gcm, FAR const uint8_t *aad,
+                size_t len);
+void aes_gcm_update(FAR struct aes_gcm_s *gcm, int encrypt, FAR uint8_t *out,
+                    FAR const uint8_t *in, size_t len);
+void aes_gcm_finish(FAR struct aes_gcm_s *gcm, FAR uint8_t *tag,
+                    size_t taglen);
 
 /****************************************************************************
  * Name: aes_encrypt
@@ -71,6 +211,9 @@ extern "C"
  *   text of 16 bytes is computed. The AES implementation is in mode ECB
  *   (Electronic Code Book).
  *
+ *   The key is expanded on every call.  Use aes_setkey() and
+ *   aes_encryptblock() to encrypt more than one block with the same key.
+ *
  * Input Parameters:
  *  key   AES128 key of size 16 bytes
  *  state 16 bytes of plain text and cipher text
@@ -90,6 +233,9 @@ void aes_encrypt(FAR uint8_t *state, FAR const uint8_t *key);
  *   text of 16 bytes is computed The AES implementation is in mode ECB
  *   (Electronic Code Book).
  *
+ *   The key is expanded on every call.  Use aes_setkey() and
+ *   aes_decryptblock() to decrypt more than one block with the same key.
+ *
  * Input Parameters:
  *  key   AES128 key of size 16 bytes
  *  state 16 bytes of plain text and cipher text
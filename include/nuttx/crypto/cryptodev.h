@@ -42,6 +42,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -53,7 +57,14 @@
 #define CRYPTO_AES_ECB          1
 #define CRYPTO_AES_CBC          2
 #define CRYPTO_AES_CTR          3
-#define CRYPTO_ALGORITHM_MAX    1
+#define CRYPTO_SHA1             4  /* Hashes and MACs, in session_op.mac */
+#define CRYPTO_SHA2_256         5
+#define CRYPTO_SHA1_HMAC        6
+#define CRYPTO_SHA2_256_HMAC    7
+#define CRYPTO_ALGORITHM_MAX    7
+
+#define CRYPTO_IS_CIPHER(a)     ((a) >= CRYPTO_AES_ECB && (a) <= CRYPTO_AES_CTR)
+#define CRYPTO_IS_MAC(a)        ((a) >= CRYPTO_SHA1 && (a) <= CRYPTO_SHA2_256_HMAC)
 
 #define CRYPTO_FLAG_HARDWARE    0x01000000 /* hardware accelerated */
 #define CRYPTO_FLAG_SOFTWARE    0x02000000 /* software implementation */
@@ -61,6 +72,7 @@
 #define COP_ENCRYPT             1
 #define COP_DECRYPT             2
 #define COP_F_BATCH             0x0008 /* Batch op if possible */
+#define COP_F_UPDATE            0x0010 /* Hash only, more data follows */
 
 #define CIOCGSESSION            101
 #define CIOCFSESSION            102
@@ -68,10 +80,17 @@
 
 typedef char* caddr_t;
 
+/* A session is either a cipher session (cipher set, mac zero) or a hash
+ * session (cipher zero, mac set).  For a hash session, each CIOCCRYPT adds
+ * 'len' bytes at 'src' to the message.  The digest (or MAC) is stored at
+ * 'mac' and the session restarts when COP_F_UPDATE is not set, so large or
+ * scattered messages may be hashed in any number of calls.
+ */
+
 struct session_op
 {
   uint32_t cipher;    /* ie. CRYPTO_AES_EBC */
-  uint32_t mac;
+  uint32_t mac;       /* ie. CRYPTO_SHA2_256 */
 
   uint32_t keylen;    /* cipher key */
   caddr_t key;
@@ -89,7 +108,98 @@ struct crypt_op
   unsigned len;
   caddr_t src, dst;   /* become iov[] inside kernel */
   caddr_t mac;        /* must be big enough for chosen MAC */
-  caddr_t iv;
+  caddr_t iv;         /* Updated so that the next call continues the stream */
+};
+
+/* The cryptodev lower half interface.  A crypto accelerator registers a
+ * lower half with cryptodev_register() to provide the cipher operations
+ * behind a /dev/crypto device.
+ *
+ * newsession() is called by CIOCGSESSION.  It may return -ENOSYS for an
+ * algorithm or key size that the hardware does not support; the session
+ * then falls back to the software implementation (if any).  On success, it
+ * returns a lower half session reference in 'priv' that is passed to the
+ * other methods.
+ *
+ * process() is called by CIOCCRYPT to encrypt or decrypt 'len' bytes for a
+ * cipher session.  It must update the IV as the software implementation
+ * does.
+ *
+ * hash() is called by CIOCCRYPT for a hash session.  It adds 'len' bytes
+ * to the message and, if 'digest' is not NULL, stores the digest and
+ * restarts.  It may be NULL if the hardware supports no hashes.
+ *
+ * The whole user buffer is passed in one call so that the hardware may
+ * chain DMA transfers over it.  The methods may block waiting for the
+ * transfers to complete.  Calls for the same open file are serialized by
+ * the upper half.
+ */
+
+struct cryptodev_lowerhalf_s;
+struct cryptodev_ops_s
+{
+  CODE int (*newsession)(FAR struct cryptodev_lowerhalf_s *lower,
+                         FAR const struct session_op *ses, FAR void **priv);
+  CODE int (*freesession)(FAR struct cryptodev_lowerhalf_s *lower,
+                          FAR void *priv);
+  CODE int (*process)(FAR struct cryptodev_lowerhalf_s *lower,
+                      FAR void *priv, bool encrypt, FAR uint8_t *iv,
+                      FAR uint8_t *dst, FAR const uint8_t *src, size_t len);
+  CODE int (*hash)(FAR struct cryptodev_lowerhalf_s *lower, FAR void *priv,
+                   FAR const uint8_t *src, size_t len, FAR uint8_t *digest);
+};
+
+struct cryptodev_lowerhalf_s
+{
+  /* This is the contained reference to the read-only, lower-half
+   * operations vtable (which may lie in FLASH or ROM)
+   */
+
+  FAR const struct cryptodev_ops_s *ops;
+
+  /* Data following this can vary from driver-to-driver */
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __KERNEL__
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: cryptodev_register
+ *
+ * Description:
+ *   Register a cryptodev character driver at 'path' backed by the given
+ *   lower half.  devcrypto_register() registers /dev/crypto with no lower
+ *   half (software only), so an accelerator that should back /dev/crypto
+ *   must be registered before that, for example from up_aesinitialize().
+ *
+ * Input Parameters:
+ *   path  - The full path to the driver, for example "/dev/crypto"
+ *   lower - The lower half driver or NULL for software only.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int cryptodev_register(FAR const char *path,
+                       FAR struct cryptodev_lowerhalf_s *lower);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __KERNEL__ */
 #endif /* __INCLUDE_NUTTX_CRYPTO_CRYPTODEV_H */
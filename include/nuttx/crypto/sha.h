@@ -0,0 +1,175 @@
+/****************************************************************************
+ * include/nuttx/crypto/sha.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CRYPTO_SHA_H
+#define __INCLUDE_NUTTX_CRYPTO_SHA_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHA1_BLOCK_SIZE      64
+#define SHA1_DIGEST_SIZE     20
+#define SHA256_BLOCK_SIZE    64
+#define SHA256_DIGEST_SIZE   32
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The state of an incremental SHA-1 or SHA-256 computation */
+
+struct sha1_context_s
+{
+  uint32_t state[5];                 /* Intermediate hash value */
+  uint64_t count;                    /* Number of bytes hashed */
+  uint8_t buffer[SHA1_BLOCK_SIZE];   /* Partial block */
+};
+
+struct sha256_context_s
+{
+  uint32_t state[8];                 /* Intermediate hash value */
+  uint64_t count;                    /* Number of bytes hashed */
+  uint8_t buffer[SHA256_BLOCK_SIZE]; /* Partial block */
+};
+
+/* The state of an incremental HMAC computation.  The hash states after the
+ * inner and outer padded keys are kept so that the key is processed only
+ * once, however many messages are authenticated with it.
+ */
+
+struct hmac_sha1_s
+{
+  struct sha1_context_s ctx;         /* The current message */
+  struct sha1_context_s ipad;        /* After the inner padded key */
+  struct sha1_context_s opad;        /* After the outer padded key */
+};
+
+struct hmac_sha256_s
+{
+  struct sha256_context_s ctx;       /* The current message */
+  struct sha256_context_s ipad;      /* After the inner padded key */
+  struct sha256_context_s opad;      /* After the outer padded key */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sha1_init, sha1_update and sha1_final
+ *
+ * Description:
+ *   Compute a SHA-1 digest incrementally:  sha1_init() starts a message,
+ *   sha1_update() may then be called any number of times with pieces of
+ *   any size and sha1_final() returns the 20 byte digest.  The context
+ *   must be initialized again before it is reused.
+ *
+ ****************************************************************************/
+
+void sha1_init(FAR struct sha1_context_s *ctx);
+void sha1_update(FAR struct sha1_context_s *ctx, FAR const void *data,
+                 size_t len);
+void sha1_final(FAR struct sha1_context_s *ctx, FAR uint8_t *digest);
+
+/****************************************************************************
+ * Name: sha256_init, sha256_update and sha256_final
+ *
+ * Description:
+ *   Compute a SHA-256 digest incrementally, as for SHA-1.  sha256_final()
+ *   returns the 32 byte digest.
+ *
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_context_s *ctx);
+void sha256_update(FAR struct sha256_context_s *ctx, FAR const void *data,
+                   size_t len);
+void sha256_final(FAR struct sha256_context_s *ctx, FAR uint8_t *digest);
+
+/****************************************************************************
+ * Name: hmac_sha1_init, hmac_sha1_update and hmac_sha1_final
+ *
+ * Description:
+ *   Compute an HMAC-SHA1 incrementally.  hmac_sha1_init() processes the key
+ *   (of any length).  hmac_sha1_final() returns the 20 byte MAC and leaves
+ *   the context ready for the next message with the same key.
+ *
+ ****************************************************************************/
+
+void hmac_sha1_init(FAR struct hmac_sha1_s *hmac, FAR const uint8_t *key,
+                    size_t keylen);
+void hmac_sha1_update(FAR struct hmac_sha1_s *hmac, FAR const void *data,
+                      size_t len);
+void hmac_sha1_final(FAR struct hmac_sha1_s *hmac, FAR uint8_t *mac);
+
+/****************************************************************************
+ * Name: hmac_sha256_init, hmac_sha256_update, hmac_sha256_final
+ *
+ * Description:
+ *   Compute an HMAC-SHA256 incrementally, as for HMAC-SHA1.
+ *   hmac_sha256_final() returns the 32 byte MAC.
+ *
+ ****************************************************************************/
+
+void hmac_sha256_init(FAR struct hmac_sha256_s *hmac, FAR const uint8_t *key,
+                      size_t keylen);
+void hmac_sha256_update(FAR struct hmac_sha256_s *hmac, FAR const void *data,
+                        size_t len);
+void hmac_sha256_final(FAR struct hmac_sha256_s *hmac, FAR uint8_t *mac);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_CRYPTO_SHA_H */
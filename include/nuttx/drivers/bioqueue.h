@@ -0,0 +1,217 @@
+/****************************************************************************
+ * include/nuttx/drivers/bioqueue.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_BIOQUEUE_H
+#define __INCLUDE_NUTTX_DRIVERS_BIOQUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_DRVR_BIOQUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of the bio_op field */
+
+#define BIO_READ  0               /* Read sectors from the device */
+#define BIO_WRITE 1               /* Write sectors to the device */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Completion callout.  This is called on the work queue thread when the
+ * request has completed.  It may submit new requests.
+ */
+
+struct bio_s;
+typedef CODE void (*bio_callback_t)(FAR struct bio_s *bio);
+
+/* This structure describes one asynchronous block I/O request.  The caller
+ * provides the memory and fills in the first group of fields before
+ * calling bioq_submit().  The structure must not be modified or reused
+ * until the completion callout has been called.
+ */
+
+struct bio_s
+{
+  /* These values must be provided by the caller */
+
+  uint8_t        bio_op;          /* BIO_READ or BIO_WRITE */
+  FAR uint8_t   *bio_buffer;      /* Data to be written or read */
+  size_t         bio_sector;      /* First sector to be transferred */
+  unsigned int   bio_nsectors;    /* Number of sectors to be transferred */
+  bio_callback_t bio_callback;    /* Called when the request completes */
+  FAR void      *bio_arg;         /* Argument for use by the callout */
+
+  /* On completion, the number of sectors transferred or a negated errno */
+
+  ssize_t        bio_result;
+
+  /* The caller should never modify the remaining fields */
+
+  FAR struct bio_s *bio_flink;    /* Supports a singly linked list */
+  uint32_t       bio_seqno;       /* Order of submission */
+};
+
+/* This structure holds the state of one request queue.  In typical usage,
+ * an instance of this structure is declared within the state structure of
+ * the logic that drives the block device, for example:
+ *
+ *   struct foo_dev_s
+ *   {
+ *     ...
+ *     struct bioqueue_s bioq;
+ *     ...
+ *   };
+ *
+ * Requests are queued in sector order and are performed one at a time on
+ * the low priority work queue using the block driver's synchronous read()
+ * and write() methods.  The queue is served in one direction (C-LOOK), and
+ * requests that continue each other both on the media and in memory are
+ * merged into a single transfer.  Requests are never re-ordered in a way
+ * that would change the data seen by an overlapping read or written by an
+ * overlapping write.
+ */
+
+struct bioqueue_s
+{
+  FAR struct inode *inode;        /* The block driver */
+  size_t         nsectors;        /* Number of sectors on the device */
+  uint16_t       sectorsize;      /* Size of one sector */
+  uint16_t       maxsectors;      /* Limit on merged transfers (0: none) */
+  bool           busy;            /* True: The worker has been scheduled */
+  uint32_t       seqno;           /* Sequence number of the next request */
+  size_t         position;        /* Sector following the last transfer */
+  sem_t          exclsem;         /* Enforces exclusive access to the queue */
+  FAR struct bio_s *head;         /* Pending requests in sector order */
+  struct work_s  work;            /* Work queue support */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: bioq_initialize
+ *
+ * Description:
+ *   Initialize a request queue for the block driver 'inode'.  The driver
+ *   must already be open.  'maxsectors' limits the size of a merged
+ *   transfer (zero for no limit).
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int bioq_initialize(FAR struct bioqueue_s *bioq, FAR struct inode *inode,
+                    uint16_t maxsectors);
+
+/****************************************************************************
+ * Name: bioq_uninitialize
+ *
+ * Description:
+ *   Release the resources of a request queue.  There must be no pending
+ *   requests.
+ *
+ ****************************************************************************/
+
+void bioq_uninitialize(FAR struct bioqueue_s *bioq);
+
+/****************************************************************************
+ * Name: bioq_submit
+ *
+ * Description:
+ *   Queue an asynchronous request.  The request's callout will be called
+ *   when the transfer has completed.  Must not be called from an interrupt
+ *   handler.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value if it was
+ *   rejected (the callout will then not be called).
+ *
+ ****************************************************************************/
+
+int bioq_submit(FAR struct bioqueue_s *bioq, FAR struct bio_s *bio);
+
+/****************************************************************************
+ * Name: bioq_read and bioq_write
+ *
+ * Description:
+ *   Perform a transfer through the request queue and wait for it to
+ *   complete.  These have the same semantics as the block driver read()
+ *   and write() methods and allow synchronous users to share the device
+ *   with asynchronous ones.
+ *
+ *   These must not be called from a completion callout or from any other
+ *   logic running on the low priority work queue.
+ *
+ ****************************************************************************/
+
+ssize_t bioq_read(FAR struct bioqueue_s *bioq, FAR uint8_t *buffer,
+                  size_t startsector, unsigned int nsectors);
+ssize_t bioq_write(FAR struct bioqueue_s *bioq, FAR const uint8_t *buffer,
+                   size_t startsector, unsigned int nsectors);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_DRVR_BIOQUEUE */
+#endif /* __INCLUDE_NUTTX_DRIVERS_BIOQUEUE_H */
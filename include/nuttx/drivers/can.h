@@ -48,6 +48,10 @@
 #include <stdbool.h>
 #include <semaphore.h>
 
+#ifdef CONFIG_CAN_TIMESTAMP
+#  include <sys/time.h>
+#endif
+
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -68,7 +72,10 @@
  * CONFIG_CAN_EXTID - Enables support for the 29-bit extended ID.  Default
  *   Standard 11-bit IDs.
  * CONFIG_CAN_FD - Enable support for CAN FD mode.  For the upper half driver, this
- *   just means handling encoded DLC values (for values of DLC > 9).
+ *   means handling encoded DLC values (for values of DLC > 8) of messages with the
+ *   ch_edl bit set and reserving space for 64 byte payloads in the FIFOs.
+ * CONFIG_CAN_TIMESTAMP - Record the time that each message was received in the
+ *   ch_ts field of the message header.
  * CONFIG_CAN_FIFOSIZE - The size of the circular buffer of CAN messages.
  *   Default: 8
  * CONFIG_CAN_NPENDINGRTR - The size of the list of pending RTR requests.
@@ -185,6 +192,33 @@
  *                   is returned with the errno variable set to indicate the
  *                   nature of the error.
  *   Dependencies:   None
+ *
+ * CANIOC_SET_FILTERS:
+ *   Description:    Replace all of the address filters with a new bank of
+ *                   standard and extended filters.  The lower half maps the
+ *                   bank onto the hardware acceptance filters so that
+ *                   messages that do not match are never delivered to
+ *                   software.  An empty bank removes all filters so that
+ *                   all messages are accepted.  Filters previously added
+ *                   with CANIOC_ADD_STDFILTER or CANIOC_ADD_EXTFILTER are
+ *                   also removed.
+ *   Argument:       A pointer to a read-able instance of struct
+ *                   canioc_filters_s
+ *   Returned Value: Zero (OK) is returned on success.  Otherwise -1 (ERROR)
+ *                   is returned with the errno variable set to indicate the
+ *                   nature of the error.  ENOSPC means that the hardware
+ *                   cannot hold that many filters.
+ *   Dependencies:   None
+ *
+ * CANIOC_GET_FILTERINFO:
+ *   Description:    Return the number of hardware address filters and the
+ *                   number that are currently unused.
+ *   Argument:       A pointer to a write-able instance of struct
+ *                   canioc_filterinfo_s
+ *   Returned Value: Zero (OK) is returned on success.  Otherwise -1 (ERROR)
+ *                   is returned with the errno variable set to indicate the
+ *                   nature of the error.
+ *   Dependencies:   None
  */
 
 #define CANIOC_RTR                _CANIOC(1)
@@ -196,12 +230,14 @@
 #define CANIOC_DEL_EXTFILTER      _CANIOC(7)
 #define CANIOC_GET_CONNMODES      _CANIOC(8)
 #define CANIOC_SET_CONNMODES      _CANIOC(9)
+#define CANIOC_SET_FILTERS        _CANIOC(10)
+#define CANIOC_GET_FILTERINFO     _CANIOC(11)
 
 /* CANIOC_USER: Device specific ioctl calls can be supported with cmds greater
  * than this value
  */
 
-#define CANIOC_USER               _CANIOC(10)
+#define CANIOC_USER               _CANIOC(12)
 
 /* Convenience macros ***************************************************************/
 
@@ -375,6 +411,15 @@
  *               Bit 7:      Unused
  *   Bytes 5-12: CAN data    Size determined by DLC
  *
+ * CAN FD messages (CONFIG_CAN_FD=y) are marked with the ch_edl bit.  Only for such
+ * messages are DLC values greater than 8 encoded as defined by can_dlc2bytes();
+ * otherwise they imply a data field of 8 bytes as in standard CAN.  ch_brs requests
+ * (or reports) the switch to the data phase bit rate and ch_esi reports the error
+ * state of the transmitting node.
+ *
+ * If CONFIG_CAN_TIMESTAMP=y, then ch_ts holds the time at which a received message
+ * was passed to the upper half driver.  It is ignored on transmission.
+ *
  * NOTE: The error indication if valid only on message reports received from the
  * CAN driver; it is ignored on transmission.  When the error bit is set, the
  * message ID is an encoded set of error indications (see CAN_ERROR_* definitions).
@@ -384,7 +429,9 @@
  * The struct can_msg_s holds this information in a user-friendly, unpacked form.
  * This is the form that is used at the read() and write() driver interfaces.  The
  * message structure is actually variable length -- the true length is given by
- * the CAN_MSGLEN macro.
+ * the CAN_MSGLEN macro.  A single read() returns as many buffered messages as fit
+ * in the user buffer, packed back-to-back, and a single write() queues all of the
+ * packed messages in the user buffer.
  */
 
 #ifdef CONFIG_CAN_EXTID
@@ -398,6 +445,15 @@ struct can_hdr_s
 #endif
   uint8_t      ch_extid  : 1; /* Extended ID indication */
   uint8_t      ch_unused : 1; /* Unused */
+#ifdef CONFIG_CAN_FD
+  uint8_t      ch_edl    : 1; /* Extended data length (CAN FD message) */
+  uint8_t      ch_brs    : 1; /* Bit rate switch */
+  uint8_t      ch_esi    : 1; /* Error state indicator */
+  uint8_t      ch_fdunused : 5; /* Unused */
+#endif
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time when the message was received */
+#endif
 } packed_struct;
 #else
 struct can_hdr_s
@@ -409,6 +465,15 @@ struct can_hdr_s
   uint8_t      ch_error  : 1; /* 1=ch_id is an error report */
 #endif
   uint8_t      ch_unused : 2; /* Unused */
+#ifdef CONFIG_CAN_FD
+  uint8_t      ch_edl    : 1; /* Extended data length (CAN FD message) */
+  uint8_t      ch_brs    : 1; /* Bit rate switch */
+  uint8_t      ch_esi    : 1; /* Error state indicator */
+  uint8_t      ch_fdunused : 5; /* Unused */
+#endif
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timeval ch_ts;       /* Time when the message was received */
+#endif
 } packed_struct;
 #endif
 
@@ -610,6 +675,28 @@ struct canioc_stdfilter_s
   uint8_t               sf_prio;         /* See CAN_MSGPRIO_* definitions */
 };
 
+/* CANIOC_SET_FILTERS: */
+
+struct canioc_filters_s
+{
+  FAR const struct canioc_stdfilter_s *fl_std; /* Array of standard filters */
+#ifdef CONFIG_CAN_EXTID
+  FAR const struct canioc_extfilter_s *fl_ext; /* Array of extended filters */
+  uint8_t               fl_next;         /* Number of extended filters */
+#endif
+  uint8_t               fl_nstd;         /* Number of standard filters */
+};
+
+/* CANIOC_GET_FILTERINFO: */
+
+struct canioc_filterinfo_s
+{
+  uint8_t               fi_nstd;         /* Number of standard filters */
+  uint8_t               fi_nstdfree;     /* Number of unused standard filters */
+  uint8_t               fi_next;         /* Number of extended filters */
+  uint8_t               fi_nextfree;     /* Number of unused extended filters */
+};
+
 /************************************************************************************
  * Public Data
  ************************************************************************************/
@@ -637,6 +724,45 @@ extern "C"
 
 int can_register(FAR const char *path, FAR struct can_dev_s *dev);
 
+/************************************************************************************
+ * Name: can_dlc2bytes
+ *
+ * Description:
+ *   In the CAN FD format, the coding of the DLC differs from the standard CAN
+ *   format. The DLC codes 0 to 8 have the same coding as in standard CAN.  But the
+ *   codes 9 to 15 all imply a data field of 8 bytes with standard CAN.  In CAN FD
+ *   mode, the values 9 to 15 are encoded to values in the range 12 to 64.
+ *
+ *   This is used by the upper half driver for messages with the ch_edl bit set
+ *   and may also be used by lower half drivers.
+ *
+ * Input Parameters:
+ *   dlc - The DLC value to convert to a byte count
+ *
+ * Returned Value:
+ *   The number of bytes corresponding to the DLC value.
+ *
+ ************************************************************************************/
+
+uint8_t can_dlc2bytes(uint8_t dlc);
+
+/************************************************************************************
+ * Name: can_bytes2dlc
+ *
+ * Description:
+ *   The inverse of can_dlc2bytes():  Return the (possibly CAN FD encoded) DLC
+ *   value for a data field of at least the provided number of bytes.
+ *
+ * Input Parameters:
+ *   nbytes - The byte count to convert to a DLC value
+ *
+ * Returned Value:
+ *   The encoded DLC value corresponding to at least that number of bytes.
+ *
+ ************************************************************************************/
+
+uint8_t can_bytes2dlc(uint8_t nbytes);
+
 /************************************************************************************
  * Name: can_receive
  *
@@ -242,6 +242,28 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 int pipe2(int fd[2], size_t bufsize);
 #endif
 
+/****************************************************************************
+ * Name: struct pipe_splice_s
+ *
+ * Description:
+ *   The argument of the PIPEIOC_SPLICEOUT, PIPEIOC_SPLICEIN and PIPEIOC_TEE
+ *   ioctl commands.  These move data directly between the pipe's buffer and
+ *   the file or socket 'ps_fd' without an intermediate user buffer.  They
+ *   are used to implement splice() and tee().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+struct pipe_splice_s
+{
+  int ps_fd;              /* The file or socket at the other end */
+  bool ps_nonblock;       /* Do not wait on the pipe */
+  size_t ps_len;          /* Maximum number of bytes to move */
+  FAR off_t *ps_offset;   /* If non-NULL, the file offset for ps_fd.  It is
+                           * updated, and the file position is not changed */
+};
+#endif
+
 /****************************************************************************
  * Name: mkfifo2
  *
@@ -0,0 +1,144 @@
+/****************************************************************************
+ * include/nuttx/fs/bench.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BENCH_H
+#define __INCLUDE_NUTTX_FS_BENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of latency histogram buckets.  Bucket 0 counts operations that
+ * took less than 1 microsecond; bucket n > 0 counts operations that took
+ * 2^(n-1) up to 2^n - 1 microseconds.  The last bucket also counts all
+ * longer operations.
+ */
+
+#define FSBENCH_NBUCKETS 24
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The tests */
+
+enum fsbench_e
+{
+  FSBENCH_SEQWRITE = 0, /* Sequential writes of a new file */
+  FSBENCH_SEQREAD,      /* Sequential reads of the file */
+  FSBENCH_RANDWRITE,    /* Writes at random, aligned offsets */
+  FSBENCH_RANDREAD,     /* Reads at random, aligned offsets */
+  FSBENCH_CREATE,       /* Creation of empty files */
+  FSBENCH_UNLINK,       /* Removal of the empty files */
+  FSBENCH_FSYNC,        /* fsync() after each sequential write */
+  FSBENCH_NTESTS
+};
+
+/* Describes one run and receives its results.  The file tests use the
+ * directory 'path' on a mounted file system and remove their files when
+ * done.  If 'blockdev' is true, 'path' is a block device that the read and
+ * write tests access directly, in whole sectors, through the block driver.
+ * The write tests destroy the data on the device!
+ *
+ * The percentiles are the upper bounds of the histogram buckets that hold
+ * them.
+ */
+
+struct fsbench_s
+{
+  uint8_t  test;        /* IN: The test (enum fsbench_e) */
+  bool     blockdev;    /* IN: 'path' is a block device */
+  FAR const char *path; /* IN: Directory or block device */
+  uint32_t bufsize;     /* IN: Bytes per read or write (0: default) */
+  uint32_t filesize;    /* IN: Bytes in the file or region (0: default) */
+  uint32_t count;       /* IN: Operations of the random, create, unlink
+                         * and fsync tests (0: default) */
+
+  uint32_t nops;        /* OUT: Number of operations timed */
+  uint64_t bytes;       /* OUT: Bytes read or written */
+  uint32_t elapsed;     /* OUT: Microseconds for the whole run */
+  uint32_t bps;         /* OUT: Bytes per second */
+  uint32_t min;         /* OUT: Shortest operation (microseconds) */
+  uint32_t p50;         /* OUT: Median operation (microseconds) */
+  uint32_t p99;         /* OUT: 99th percentile (microseconds) */
+  uint32_t max;         /* OUT: Longest operation (microseconds) */
+  uint32_t hist[FSBENCH_NBUCKETS]; /* OUT: Latency histogram */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: fsbench_run
+ *
+ * Description:
+ *   Run one file system or block device benchmark.
+ *
+ * Input Parameters:
+ *   bench - Describes the run and receives the results
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BENCHMARK
+int fsbench_run(FAR struct fsbench_s *bench);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_FS_BENCH_H */
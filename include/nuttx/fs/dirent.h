@@ -174,6 +174,14 @@ struct fs_unionfsdir_s
   bool fu_prefix[2];                          /* True: Fake directory in prefix */
   FAR char *fu_relpath;                       /* Path being enumerated */
   FAR struct fs_dirent_s *fu_lower[2];        /* dirent struct used by contained file system */
+#ifdef CONFIG_FS_UNIONFS_DIRCACHE
+  FAR void *fu_cache;                         /* Cached listing being returned */
+  FAR struct dirent *fu_entries;              /* Entries collected during the enumeration */
+  uint32_t fu_generation;                     /* Union cache generation at open */
+  uint16_t fu_nentries;                       /* Entries collected or returned from the cache */
+  uint16_t fu_nlower0;                        /* Entries collected from file system 1 */
+  bool fu_collect;                            /* True: Collected entries are complete */
+#endif
 };
 #endif
 
@@ -63,8 +63,11 @@
 
 /* Stream flags for the fs_flags field of in struct file_struct */
 
-#define __FS_FLAG_EOF   (1 << 0) /* EOF detected by a read operation */
-#define __FS_FLAG_ERROR (1 << 1) /* Error detected by any operation */
+#define __FS_FLAG_EOF    (1 << 0) /* EOF detected by a read operation */
+#define __FS_FLAG_ERROR  (1 << 1) /* Error detected by any operation */
+#define __FS_FLAG_NOLOCK (1 << 2) /* Locking is done by the caller */
+#define __FS_FLAG_LBF    (1 << 3) /* Line buffered:  Flush on newline */
+#define __FS_FLAG_UBF    (1 << 4) /* Buffer provided by the user (setvbuf) */
 
 /* Inode i_flag values */
 
@@ -152,6 +155,7 @@
 struct file;   /* Forward reference */
 struct pollfd; /* Forward reference */
 struct inode;  /* Forward reference */
+struct iovec;  /* Forward reference */
 
 struct file_operations
 {
@@ -178,6 +182,15 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional scatter/gather I/O.  If NULL, readv() and writev() fall back to
+   * calling read() or write() once per buffer.
+   */
+
+  ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt);
+  ssize_t (*writev)(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt);
 };
 
 /* This structure provides information about the state of a block driver */
@@ -287,6 +300,17 @@ struct mountpt_operations
   int     (*stat)(FAR struct inode *mountpt, FAR const char *relpath,
             FAR struct stat *buf);
 
+#ifdef CONFIG_FS_PAGECACHE
+  /* Optional page cache support.  A file system opts in to the VFS page
+   * cache by providing this method.  It returns (in 'key') a value that
+   * identifies the data of the open file on the volume:  All open files
+   * with the same key on the same mountpoint share cached pages.  A
+   * negated errno value means that the file must not be cached.
+   */
+
+  int     (*cachekey)(FAR struct file *filep, FAR uintptr_t *key);
+#endif
+
   /* NOTE:  More operations will be needed here to support:  disk usage
    * stats file stat(), file attributes, file truncation, etc.
    */
@@ -352,13 +376,29 @@ struct file
   void             *f_priv;     /* Per file driver private data */
 };
 
-/* This defines a list of files indexed by the file descriptor */
+/* This defines a list of files indexed by the file descriptor.  The files
+ * are allocated in blocks of CONFIG_NFILE_DESCRIPTORS_PER_BLOCK when a
+ * descriptor in the block is first used.  A block, once allocated, is not
+ * freed until the list is released so that a file can be looked up without
+ * taking fl_sem (see files_getfile()).  fl_inuse has one bit set for each
+ * descriptor that is allocated.
+ */
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
+#ifndef CONFIG_NFILE_DESCRIPTORS_PER_BLOCK
+#  define CONFIG_NFILE_DESCRIPTORS_PER_BLOCK 8
+#endif
+
+#define FILELIST_NBLOCKS \
+  ((CONFIG_NFILE_DESCRIPTORS + CONFIG_NFILE_DESCRIPTORS_PER_BLOCK - 1) / \
+   CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+#define FILELIST_NWORDS   ((CONFIG_NFILE_DESCRIPTORS + 31) >> 5)
+
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
-  struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
+  uint32_t fl_inuse[FILELIST_NWORDS]; /* Bitmap of allocated descriptors */
+  FAR struct file *fl_blocks[FILELIST_NBLOCKS]; /* Blocks of files */
 };
 #endif
 
@@ -585,6 +625,35 @@ void files_initlist(FAR struct filelist *list);
 void files_releaselist(FAR struct filelist *list);
 #endif
 
+/****************************************************************************
+ * Name: files_getfile
+ *
+ * Description:
+ *   Return the struct file instance of the file descriptor 'fd' in 'list'
+ *   or NULL if 'fd' is out of range or its block has not been allocated
+ *   (in which case the descriptor cannot be open).  This does not take the
+ *   list semaphore.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+FAR struct file *files_getfile(FAR struct filelist *list, int fd);
+#endif
+
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Like files_getfile(), but allocate the block that holds the file
+ *   descriptor 'fd' if it does not yet exist.  NULL is returned if 'fd' is
+ *   out of range or if the block cannot be allocated.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+FAR struct file *files_extend(FAR struct filelist *list, int fd);
+#endif
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -868,6 +937,22 @@ ssize_t file_read(FAR struct file *filep, FAR void *buf, size_t nbytes);
 ssize_t file_write(FAR struct file *filep, FAR const void *buf, size_t nbytes);
 #endif
 
+/****************************************************************************
+ * Name: file_readv and file_writev
+ *
+ * Description:
+ *   Equivalent to the standard readv() and writev() functions except that
+ *   they accept a struct file instance instead of a file descriptor.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+ssize_t file_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                   int iovcnt);
+ssize_t file_writev(FAR struct file *filep, FAR const struct iovec *iov,
+                    int iovcnt);
+#endif
+
 /****************************************************************************
  * Name: file_pread
  *
@@ -84,6 +84,7 @@
 #define _MODEMBASE      (0x1f00) /* Modem ioctl commands */
 #define _I2CBASE        (0x2000) /* I2C driver commands */
 #define _GPIOBASE       (0x2100) /* GPIO driver commands */
+#define _NOTEIOCBASE    (0x2200) /* Scheduler note driver ioctl commands */
 
 /* boardctl commands share the same number space */
 
@@ -221,6 +222,11 @@
                                            *      the block with specific debug
                                            *      command and data.
                                            * OUT: None.  */
+#define BIOC_FLUSH      _BIOC(0x000C)     /* Write any cached data back to the
+                                           * media.
+                                           * IN:  None
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -251,6 +257,25 @@
                                            * IN: None
                                            * OUT: None */
 
+/* ADC block streaming commands (see nuttx/analog/adc.h) */
+
+#define ANIOC_STREAM_START     _ANIOC(0x0010) /* Start block streaming
+                                               * IN: Block size in bytes
+                                               *     (0 = default)
+                                               * OUT: None */
+#define ANIOC_STREAM_STOP      _ANIOC(0x0011) /* Stop block streaming
+                                               * IN: None
+                                               * OUT: None */
+#define ANIOC_STREAM_STATUS    _ANIOC(0x0012) /* Get stream status
+                                               * IN: struct adc_stream_status_s*
+                                               * OUT: Stream status */
+#define ANIOC_STREAM_GETBLOCK  _ANIOC(0x0013) /* Wait for the oldest block
+                                               * IN: struct adc_block_s*
+                                               * OUT: Block offset and size */
+#define ANIOC_STREAM_RELEASE   _ANIOC(0x0014) /* Release the oldest block
+                                               * IN: None
+                                               * OUT: None */
+
 /* NuttX PWM ioctl definitions (see nuttx/drivers/pwm.h) ****************************/
 
 #define _PWMIOCVALID(c)   (_IOC_TYPE(c)==_PWMIOCBASE)
@@ -327,6 +352,41 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SPLICEOUT _PIPEIOC(0x0002)  /* Move data from the pipe to
+                                             * another file or socket
+                                             * IN: FAR struct pipe_splice_s *
+                                             * OUT: Returns bytes moved */
+#define PIPEIOC_SPLICEIN  _PIPEIOC(0x0003)  /* Move data into the pipe from
+                                             * another file or socket
+                                             * IN: FAR struct pipe_splice_s *
+                                             * OUT: Returns bytes moved */
+#define PIPEIOC_TEE       _PIPEIOC(0x0004)  /* Like PIPEIOC_SPLICEOUT but
+                                             * leave the data in the pipe
+                                             * IN: FAR struct pipe_splice_s *
+                                             * OUT: Returns bytes copied */
+#define PIPEIOC_SETSIZE   _PIPEIOC(0x0005)  /* Resize the pipe buffer.
+                                             * Buffered data is preserved.
+                                             * IN: size_t buffer size
+                                             * OUT: None */
+#define PIPEIOC_GETSIZE   _PIPEIOC(0x0006)  /* Get the pipe buffer size
+                                             * IN: FAR size_t *
+                                             * OUT: Buffer size */
+#define PIPEIOC_RDTHRESH  _PIPEIOC(0x0007)  /* Wake blocked readers only
+                                             * when this many bytes are
+                                             * buffered (default 1)
+                                             * IN: size_t byte count
+                                             * OUT: None */
+#define PIPEIOC_RDTIMEOUT _PIPEIOC(0x0008)  /* Wake blocked readers this
+                                             * long after the first byte
+                                             * even if below RDTHRESH
+                                             * IN: unsigned long msec,
+                                             *     0=no timeout (default)
+                                             * OUT: None */
+#define PIPEIOC_WRTHRESH  _PIPEIOC(0x0009)  /* Wake blocked writers only
+                                             * when this many bytes are
+                                             * free (default 1)
+                                             * IN: size_t byte count
+                                             * OUT: None */
 
 /* RTC driver ioctl definitions *********************************************/
 /* (see nuttx/include/rtc.h */
@@ -387,6 +447,12 @@
 #define _GPIOCVALID(c)     (_IOC_TYPE(c)==_GPIOBASE)
 #define _GPIOC(nr)         _IOC(_GPIOBASE,nr)
 
+/* Scheduler note driver ioctl definitions **********************************/
+/* see nuttx/include/nuttx/sched_note.h */
+
+#define _NOTEIOCVALID(c)   (_IOC_TYPE(c)==_NOTEIOCBASE)
+#define _NOTEIOC(nr)       _IOC(_NOTEIOCBASE,nr)
+
 /* boardctl() command definitions *******************************************/
 
 #define _BOARDIOCVALID(c) (_IOC_TYPE(c)==_BOARDBASE)
@@ -123,6 +123,25 @@ struct procfs_dir_priv_s
   FAR const struct procfs_entry_s *procfsentry; /* Pointer to procfs handler entry */
 };
 
+/* Reading /proc/taskstats returns an array of these fixed-layout binary
+ * records, one per task/thread, all sampled at the same time.  Fields that
+ * depend on a disabled feature are zero.
+ */
+
+struct procfs_taskstats_s
+{
+  pid_t    pid;                                 /* Task/thread ID */
+  uint16_t flags;                               /* TCB flags (see TCB_FLAG_*) */
+  uint8_t  state;                               /* Task state (see enum tstate_e) */
+  uint8_t  priority;                            /* Current priority */
+  uint32_t cpuactive;                           /* CPU load: Ticks while running (CONFIG_SCHED_CPULOAD) */
+  uint32_t cputotal;                            /* CPU load: Total ticks in the same interval */
+  uint32_t stacksize;                           /* Stack size in bytes */
+  uint32_t stackused;                           /* Stack bytes used (CONFIG_STACK_COLORATION) */
+  uint32_t heaplive;                            /* Heap bytes allocated (CONFIG_MM_TRACE) */
+  uint32_t heappeak;                            /* Peak of heaplive (CONFIG_MM_TRACE) */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -0,0 +1,139 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+struct hrtimer_s;
+
+/* This is the form of the function that is called when a high resolution
+ * timer expires.  It is called from the timer interrupt handler and is
+ * subject to all ISR restrictions.
+ */
+
+typedef CODE void (*hrtimer_entry_t)(FAR struct hrtimer_s *hrtimer,
+                                     FAR void *arg);
+
+/* This structure describes one high resolution timer.  The structure is
+ * provided by the caller and must persist for as long as the timer is
+ * active.  The content of the structure is private to the OS.
+ */
+
+struct hrtimer_s
+{
+  FAR struct hrtimer_s *flink;   /* Supports a singly linked list */
+  struct timespec expiry;        /* Expiration time (up_timer_gettime() base) */
+  hrtimer_entry_t func;          /* Function to execute on expiration */
+  FAR void *arg;                 /* Argument passed to func */
+  bool active;                   /* True: The timer is in the active list */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a high resolution timer.  The function 'func' will be called
+ *   from the timer interrupt handler when the 'delay' has elapsed.  Unlike
+ *   watchdog timers, the delay is not rounded to system clock ticks; the
+ *   resolution is limited only by the underlying alarm hardware.  If the
+ *   timer is already active, it is first cancelled.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer to start
+ *   delay   - The relative delay.  This must be greater than zero.
+ *   func    - The function to call when the delay expires
+ *   arg     - An argument that will be passed to func
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer,
+                  FAR const struct timespec *delay, hrtimer_entry_t func,
+                  FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Cancel a high resolution timer.  Nothing happens if the timer is not
+ *   active.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) if the timer was cancelled; -EINVAL if it was not active.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *hrtimer);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
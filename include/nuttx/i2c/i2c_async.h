@@ -0,0 +1,238 @@
+/****************************************************************************
+ * include/nuttx/i2c/i2c_async.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_I2C_I2C_ASYNC_H
+#define __INCLUDE_NUTTX_I2C_I2C_ASYNC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <queue.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************
+ * CONFIG_I2C_ASYNC - Enables asynchronous I2C transfers
+ * CONFIG_I2C_ASYNC_HPWORK - Complete transfers on the high priority work
+ *   queue.  The low priority work queue is used by default.
+ * CONFIG_I2C_ASYNC_MAXMSGS - The maximum number of messages that may be
+ *   merged into a single transfer.
+ */
+
+#ifndef CONFIG_SCHED_WORKQUEUE
+#  error Work queue support is required (CONFIG_SCHED_WORKQUEUE)
+#endif
+
+#ifndef CONFIG_I2C_ASYNC_MAXMSGS
+#  define CONFIG_I2C_ASYNC_MAXMSGS 16
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The type of the completion callback.  This is called on the work queue
+ * with the request and the result of its transfer (zero or a negated errno
+ * value).
+ */
+
+struct i2c_request_s;
+typedef CODE void (*i2c_callback_t)(FAR struct i2c_request_s *req,
+                                    int result);
+
+/* One asynchronous transfer:  A list of messages that are transferred as
+ * with I2C_TRANSFER.  The request and the messages must remain valid until
+ * the callback is called.  Since requests may be merged, the first message
+ * of a request must not have the I2C_M_NORESTART flag.
+ */
+
+struct i2c_request_s
+{
+  sq_entry_t entry;              /* Used internally to queue the request */
+  sq_entry_t schedule;           /* Used internally for the schedule */
+  FAR struct i2c_msg_s *msgs;    /* The messages to transfer */
+  int count;                     /* The number of messages */
+  i2c_callback_t callback;       /* Completion callback */
+  FAR void *arg;                 /* Argument for use by the callback */
+
+  /* If the request is added to the periodic schedule of the bus, it is
+   * queued every 'divider' bus cycles.
+   */
+
+  uint16_t divider;              /* Bus cycles between transfers */
+  uint16_t countdown;            /* Bus cycles until the next transfer */
+  bool queued;                   /* The request is queued for transfer */
+};
+
+/* The state of the asynchronous transfers on one I2C bus.  Queued requests
+ * are transferred back-to-back by a single worker.  Requests are merged
+ * into a single I2C transfer when possible.
+ */
+
+struct i2c_async_s
+{
+  FAR struct i2c_master_s *dev;  /* The I2C bus */
+  sq_queue_t pending;            /* Requests waiting to be transferred */
+  sq_queue_t periodic;           /* The periodic schedule */
+  sem_t exclsem;                 /* Serializes the workers */
+  struct work_s work;            /* Transfers the pending requests */
+  struct work_s cycle;           /* Starts each periodic bus cycle */
+  systime_t period;              /* Bus cycle period (ticks, 0: stopped) */
+  systime_t next;                /* Time of the last bus cycle */
+  struct i2c_msg_s msgs[CONFIG_I2C_ASYNC_MAXMSGS]; /* Merged transfer */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: i2c_async_initialize
+ *
+ * Description:
+ *   Initialize the asynchronous transfer state of an I2C bus.  There should
+ *   be one instance for each bus.
+ *
+ * Input Parameters:
+ *   bus - The asynchronous transfer state to be initialized
+ *   dev - The I2C bus
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void i2c_async_initialize(FAR struct i2c_async_s *bus,
+                          FAR struct i2c_master_s *dev);
+
+/****************************************************************************
+ * Name: i2c_async_transfer
+ *
+ * Description:
+ *   Queue a request for transfer.  This function does not wait for the
+ *   transfer; the callback of the request is called on the work queue when
+ *   the transfer has completed.
+ *
+ * Input Parameters:
+ *   bus - The asynchronous transfer state of the I2C bus
+ *   req - The request to transfer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if the request is already queued.
+ *
+ ****************************************************************************/
+
+int i2c_async_transfer(FAR struct i2c_async_s *bus,
+                       FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_async_schedule
+ *
+ * Description:
+ *   Add a request to the periodic schedule of the bus.  The request is
+ *   transferred every req->divider bus cycles, together with all other
+ *   requests that are due in the same cycle.
+ *
+ * Input Parameters:
+ *   bus - The asynchronous transfer state of the I2C bus
+ *   req - The request to add.  req->divider must be non-zero.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void i2c_async_schedule(FAR struct i2c_async_s *bus,
+                        FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_async_unschedule
+ *
+ * Description:
+ *   Remove a request from the periodic schedule of the bus.  A transfer of
+ *   the request that has already been queued still completes.
+ *
+ ****************************************************************************/
+
+void i2c_async_unschedule(FAR struct i2c_async_s *bus,
+                          FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_async_start
+ *
+ * Description:
+ *   Start (or change the period of) the periodic bus cycles.
+ *
+ * Input Parameters:
+ *   bus    - The asynchronous transfer state of the I2C bus
+ *   period - The bus cycle period in clock ticks.  Zero stops the cycles.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_async_start(FAR struct i2c_async_s *bus, systime_t period);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_I2C_ASYNC */
+#endif /* __INCLUDE_NUTTX_I2C_I2C_ASYNC_H */
@@ -45,6 +45,10 @@
 
 #include <stdint.h>
 
+#ifdef CONFIG_SCHED_INITCALL
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -57,6 +61,15 @@
 #define OSINIT_OS_READY()        (g_os_initstate >= OSINIT_OSREADY)
 #define OSINIT_OS_INITIALIZING() (g_os_initstate  < OSINIT_OSREADY)
 
+/* Boot phase time stamps are recorded only if CONFIG_SCHED_BOOTLOG is
+ * selected.
+ */
+
+#ifndef CONFIG_SCHED_BOOTLOG
+#  define os_bootmark(p)
+#  define os_bootlog()
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -83,6 +96,26 @@ enum os_initstate_e
                           * active. */
 };
 
+#ifdef CONFIG_SCHED_INITCALL
+/* An initialization function registered with os_initcall_register().  The
+ * caller provides the memory and initializes name, func and level; the
+ * remaining fields are private to the OS.
+ */
+
+struct initcall_s
+{
+  FAR struct initcall_s *flink;  /* Supports a singly linked list */
+  FAR const char *name;          /* Name used in the boot log */
+  CODE int (*func)(void);        /* The initialization function */
+  uint8_t level;                 /* Runs after all lower levels complete */
+
+  /* Private */
+
+  int result;                    /* Return value of func */
+  struct work_s work;            /* Used to run func on the work queue */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -115,6 +148,23 @@ int CONFIG_USER_ENTRYPOINT(int argc, char *argv[]);
 
 void os_start(void) noreturn_function;
 
+/* Functions contained in os_bootlog.c **************************************/
+/* Record the completion of a boot phase and write the boot log */
+
+#ifdef CONFIG_SCHED_BOOTLOG
+void os_bootmark(FAR const char *phase);
+void os_bootlog(void);
+#endif
+
+/* Functions contained in os_initcall.c *************************************/
+/* Register a board initialization function to be run concurrently with the
+ * other initialization functions of the same level.
+ */
+
+#ifdef CONFIG_SCHED_INITCALL
+int os_initcall_register(FAR struct initcall_s *call);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
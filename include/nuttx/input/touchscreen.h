@@ -122,6 +122,32 @@ struct touch_sample_s
 };
 #define SIZEOF_TOUCH_SAMPLE_S(n) (sizeof(struct touch_sample_s) + ((n)-1)*sizeof(struct touch_point_s))
 
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+/* This structure is the interface between the common touchscreen upper half
+ * driver (drivers/input/touchscreen_upper.c) and a touchscreen lower half
+ * driver.  The lower half driver reports each touch point with
+ * touch_event().  The upper half queues the events and provides the
+ * character driver interface.  A read() from such a driver returns as many
+ * single point struct touch_sample_s events as are queued and fit in the
+ * caller's buffer.
+ */
+
+struct touch_lowerhalf_s
+{
+  FAR void *tl_priv;  /* Reserved for use by the upper half driver */
+
+  /* Optional:  Called on the first open and on the last close */
+
+  CODE int (*tl_open)(FAR struct touch_lowerhalf_s *lower);
+  CODE int (*tl_close)(FAR struct touch_lowerhalf_s *lower);
+
+  /* Optional:  Called for ioctl commands not handled by the upper half */
+
+  CODE int (*tl_control)(FAR struct touch_lowerhalf_s *lower, int cmd,
+                         unsigned long arg);
+};
+#endif
+
 /************************************************************************************
  * Public Function Prototypes
  ************************************************************************************/
@@ -134,6 +160,45 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_INPUT_TOUCHSCREEN
+/************************************************************************************
+ * Name: touch_register
+ *
+ * Description:
+ *   Bind a touchscreen lower half driver to a new instance of the common
+ *   touchscreen upper half driver and register the composite character
+ *   driver at 'devpath' (for example, "/dev/input0").
+ *
+ * Input Parameters:
+ *   lower   - The lower half driver instance.  lower->tl_priv is set here.
+ *   devpath - The device path to register.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ************************************************************************************/
+
+int touch_register(FAR struct touch_lowerhalf_s *lower,
+                   FAR const char *devpath);
+
+/************************************************************************************
+ * Name: touch_event
+ *
+ * Description:
+ *   Queue one touch point reported by the lower half driver and notify any
+ *   waiting readers.  May be called from interrupt level.
+ *
+ *   If CONFIG_INPUT_TOUCHSCREEN_COALESCE is selected, a TOUCH_MOVE event
+ *   replaces a TOUCH_MOVE of the same contact that has not yet been read.
+ *   If the queue is full, the oldest event is discarded.
+ *
+ ************************************************************************************/
+
+void touch_event(FAR struct touch_lowerhalf_s *lower,
+                 FAR const struct touch_point_s *point);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -221,7 +221,7 @@
  ****************************************************************************/
 
 #define IOEXP_MULTIREADBUF(dev,pins,vals,count) \
-                          ((dev)->ops->ioe_multireadbuf(dev,pin,vals,count))
+                          ((dev)->ops->ioe_multireadbuf(dev,pins,vals,count))
 
 #endif /* CONFIG_IOEXPANDER_MULTIPIN */
 
@@ -68,6 +68,16 @@
 typedef int (*xcpt_t)(int irq, FAR void *context);
 #endif
 
+/* Named critical section domains.  See enter_critical_domain(). */
+
+#ifndef __ASSEMBLY__
+enum csdomain_e
+{
+  CSDOMAIN_WDOG = 0,            /* Watchdog timer list */
+  CSDOMAIN_NDOMAINS             /* Number of domains */
+};
+#endif
+
 /* Now include architecture-specific types */
 
 #include <arch/irq.h>
@@ -113,7 +123,8 @@ int irq_attach(int irq, xcpt_t isr);
  *
  ****************************************************************************/
 
-#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION)
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 irqstate_t enter_critical_section(void);
 #else
 #  define enter_critical_section(f) up_irq_save(f)
@@ -131,12 +142,52 @@ irqstate_t enter_critical_section(void);
  *
  ****************************************************************************/
 
-#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION)
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 void leave_critical_section(irqstate_t flags);
 #else
 #  define leave_critical_section(f) up_irq_restore(f)
 #endif
 
+/****************************************************************************
+ * Name: enter_critical_domain
+ *
+ * Description:
+ *   If CONFIG_SMP_CSECTION_DOMAINS is enabled:
+ *     Disable interrupts on this CPU and take the spinlock associated with
+ *     'domain'.  Nested calls from the same CPU are supported.  A domain
+ *     protects only the data associated with it and does not exclude other
+ *     CPUs from the global critical section.  The global critical section
+ *     must never be entered while a domain is held.
+ *   Otherwise:
+ *     This function is equivalent to enter_critical_section().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CSECTION_DOMAINS
+irqstate_t enter_critical_domain(enum csdomain_e domain);
+#else
+#  define enter_critical_domain(d) enter_critical_section()
+#endif
+
+/****************************************************************************
+ * Name: leave_critical_domain
+ *
+ * Description:
+ *   If CONFIG_SMP_CSECTION_DOMAINS is enabled:
+ *     Decrement the nesting count for 'domain' and, if it decrements to
+ *     zero, release the domain spinlock.  Then restore the interrupt state.
+ *   Otherwise:
+ *     This function is equivalent to leave_critical_section().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CSECTION_DOMAINS
+void leave_critical_domain(enum csdomain_e domain, irqstate_t flags);
+#else
+#  define leave_critical_domain(d,f) leave_critical_section(f)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
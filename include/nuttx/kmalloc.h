@@ -95,6 +95,18 @@ extern "C"
 #define kumm_memalign(a,s)       memalign(a,s)
 #define kumm_free(p)             free(p)
 
+/* Region attributes are not passed through the user-space interface of
+ * the protected build:  There, kumm_malloc_attr() is only a kumm_malloc().
+ */
+
+#if defined(CONFIG_BUILD_PROTECTED) && defined(__KERNEL__)
+#  define kumm_regionattr(m,a)   (0)
+#  define kumm_malloc_attr(s,a)  kumm_malloc(s)
+#else
+#  define kumm_regionattr(m,a)   umm_regionattr(m,a)
+#  define kumm_malloc_attr(s,a)  malloc_attr(s,a)
+#endif
+
 /* This family of allocators is used to manage kernel protected memory */
 
 #if !defined(CONFIG_BUILD_PROTECTED) && !defined(CONFIG_MM_KERNEL_HEAP)
@@ -107,7 +119,9 @@ extern "C"
 # define kmm_trysemaphore()     umm_trysemaphore()
 # define kmm_givesemaphore()    umm_givesemaphore()
 
+# define kmm_regionattr(m,a)    umm_regionattr(m,a)
 # define kmm_malloc(s)          malloc(s)
+# define kmm_malloc_attr(s,a)   malloc_attr(s,a)
 # define kmm_zalloc(s)          zalloc(s)
 # define kmm_realloc(p,s)       realloc(p,s)
 # define kmm_memalign(a,s)      memalign(a,s)
@@ -124,7 +138,9 @@ extern "C"
 # define kmm_trysemaphore()     umm_trysemaphore()
 # define kmm_givesemaphore()    umm_givesemaphore()
 
+# define kmm_regionattr(m,a)    (0)
 # define kmm_malloc(s)          umm_malloc(s)
+# define kmm_malloc_attr(s,a)   umm_malloc(s)
 # define kmm_zalloc(s)          umm_zalloc(s)
 # define kmm_realloc(p,s)       umm_realloc(p,s)
 # define kmm_memalign(a,s)      umm_memalign(a,s)
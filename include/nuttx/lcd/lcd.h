@@ -94,6 +94,25 @@ struct lcd_planeinfo_s
   int (*getrun)(fb_coord_t row, fb_coord_t col, FAR uint8_t *buffer,
                 size_t npixels);
 
+  /* This optional method can be used to write a rectangular area to the
+   * LCD in a single transfer.  It may be NULL if the driver does not
+   * support it; putrun() is then used for each row.
+   *
+   *  row_start - Starting row to write to (range: 0 <= row_start < yres)
+   *  row_end   - Ending row to write to (range: row_start <= row_end < yres)
+   *  col_start - Starting column to write to (range: 0 <= col_start < xres)
+   *  col_end   - Ending column to write to
+   *              (range: col_start <= col_end < xres)
+   *  buffer    - The buffer containing the area to be written to the LCD
+   *  stride    - The length of one row of the buffer in bytes.  Zero means
+   *              that the buffer holds one row that is written to every row
+   *              of the area (used to fill the area with a color).
+   */
+
+  int (*putarea)(fb_coord_t row_start, fb_coord_t row_end,
+                 fb_coord_t col_start, fb_coord_t col_end,
+                 FAR const uint8_t *buffer, size_t stride);
+
   /* Plane color characteristics ********************************************/
 
   /* This is working memory allocated by the LCD driver for each LCD device
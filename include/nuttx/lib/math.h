@@ -83,6 +83,10 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#ifdef CONFIG_LIBM_VECTOR
+#  include <stddef.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -401,6 +405,20 @@ long double truncl (long double x);
 #define nanl(x) ((long double)(NAN))
 #endif
 
+/* Array versions of the single precision functions:  y[i] = f(x[i]) for
+ * i = 0 .. n-1.  The input and output arrays may be the same.  These use
+ * the polynomial kernels of CONFIG_LIBM_FASTFLOAT (and NEON, if enabled)
+ * and do not set errno.
+ */
+
+#ifdef CONFIG_LIBM_VECTOR
+void        sinf_v (FAR float *y, FAR const float *x, size_t n);
+void        cosf_v (FAR float *y, FAR const float *x, size_t n);
+void        expf_v (FAR float *y, FAR const float *x, size_t n);
+void        logf_v (FAR float *y, FAR const float *x, size_t n);
+void        sqrtf_v(FAR float *y, FAR const float *x, size_t n);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,203 @@
+/****************************************************************************
+ * include/nuttx/mm/mempool.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_MEMPOOL_H
+#define __INCLUDE_NUTTX_MM_MEMPOOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <queue.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one pool of fixed size memory blocks.  Blocks
+ * are allocated from and freed to a singly linked list of free blocks in
+ * constant time.  The structure should be considered opaque by users of
+ * the pool.
+ */
+
+struct mempool_s
+{
+  sq_queue_t freelist;  /* List of free blocks */
+  sq_queue_t chunks;    /* List of expansion chunks allocated from the heap */
+  size_t     blocksize; /* Size of one block */
+  uint16_t   nreserve;  /* Number of blocks reserved for interrupt handlers */
+  uint16_t   nexpand;   /* Number of blocks to add when the pool expands */
+  uint16_t   nblocks;   /* Total number of blocks in the pool */
+  uint16_t   nfree;     /* Number of blocks in the free list */
+  uint16_t   peak;      /* Largest number of blocks in use at any time */
+  uint16_t   nfail;     /* Number of failed allocations */
+};
+
+/* This structure is used to return pool statistics */
+
+struct mempoolinfo_s
+{
+  size_t   blocksize;   /* Size of one block */
+  uint16_t nblocks;     /* Total number of blocks in the pool */
+  uint16_t nfree;       /* Number of free blocks */
+  uint16_t nused;       /* Number of blocks in use */
+  uint16_t peak;        /* Largest number of blocks in use at any time */
+  uint16_t nchunks;     /* Number of expansion chunks */
+  uint16_t nfail;       /* Number of failed allocations */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Set up a pool of fixed size memory blocks.  The initial blocks of the
+ *   pool may be provided by the caller (for example, as a statically
+ *   allocated array of structures) or will be allocated from the kernel
+ *   heap.
+ *
+ *   General Usage Summary:
+ *
+ *     static struct mempool_s g_mypool;
+ *     static struct my_s g_myobjs[NOBJS];
+ *
+ *     mempool_initialize(&g_mypool, sizeof(struct my_s), g_myobjs, NOBJS,
+ *                        0, 4);
+ *
+ *     FAR struct my_s *obj = (FAR struct my_s *)mempool_alloc(&g_mypool);
+ *     ...
+ *     mempool_free(&g_mypool, obj);
+ *
+ * Input Parameters:
+ *   pool      - The pool instance to be initialized
+ *   blocksize - The size of one block.  This will be rounded up so that
+ *               it is at least the size of an sq_entry_t and a multiple of
+ *               the pointer size.
+ *   pbuffer   - Memory to hold the initial blocks.  If NULL, then memory
+ *               for the initial blocks will be allocated from the heap.
+ *   ninitial  - The number of initial blocks.  May be zero.
+ *   nreserve  - The number of blocks that are reserved for use by
+ *               interrupt handlers.  In a task context, the pool will be
+ *               expanded rather than allocating one of the the last
+ *               nreserve free blocks.
+ *   nexpand   - The number of blocks to allocate from the heap whenever
+ *               the pool must be expanded.  Zero means that the pool has a
+ *               fixed size.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, size_t blocksize,
+                       FAR void *pbuffer, unsigned int ninitial,
+                       unsigned int nreserve, unsigned int nexpand);
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from the pool.  This function may be called from an
+ *   interrupt handler.  In that case, the reserved blocks are available
+ *   but the pool will never be expanded.
+ *
+ * Input Parameters:
+ *   pool - The pool from which to allocate the block
+ *
+ * Returned Value:
+ *   The allocated block or NULL if no block is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool);
+
+/****************************************************************************
+ * Name: mempool_free
+ *
+ * Description:
+ *   Return one block to the pool.  Blocks allocated to expand the pool are
+ *   never returned to the heap.  This function may be called from an
+ *   interrupt handler.
+ *
+ * Input Parameters:
+ *   pool - The pool from which the block was allocated
+ *   blk  - The block to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_free(FAR struct mempool_s *pool, FAR void *blk);
+
+/****************************************************************************
+ * Name: mempool_info
+ *
+ * Description:
+ *   Return statistics for the pool.
+ *
+ * Input Parameters:
+ *   pool - The pool of interest
+ *   info - The location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mempool_info(FAR struct mempool_s *pool,
+                  FAR struct mempoolinfo_s *info);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_MM_MEMPOOL_H */
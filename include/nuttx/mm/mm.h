@@ -66,6 +66,12 @@
 #  define CONFIG_MM_SMALL 1
 #endif
 
+/* Allocation tracing requires the larger chunk header */
+
+#if defined(CONFIG_MM_TRACE) && defined(CONFIG_MM_SMALL)
+#  undef CONFIG_MM_TRACE
+#endif
+
 /* Terminology:
  *
  * - Flat Build: In the flat build (CONFIG_BUILD_FLAT=y), there is only a
@@ -154,6 +160,16 @@
 #  define MM_MAX_SHIFT   22  /*  4 Mb */
 #endif
 
+/* With CONFIG_MM_TRACE, the allocated chunk header grows to 16 bytes.  The
+ * minimum chunk size must then be increased so that every chunk can still
+ * hold a free node.
+ */
+
+#if defined(CONFIG_MM_TRACE) && MM_MIN_SHIFT < 5
+#  undef  MM_MIN_SHIFT
+#  define MM_MIN_SHIFT    5  /* 32 bytes */
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
@@ -164,6 +180,48 @@
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
 
+/* Segregated-fit free lists.  Normally, there is one free list for each
+ * power-of-two size class (MM_NNODES lists).  If CONFIG_MM_TLSF is
+ * selected, each of these first-level size classes is further subdivided
+ * into MM_NSUBLISTS linear second-level size classes.  Occupancy of the
+ * lists is then tracked by a two-level bitmap so that a suitable free list
+ * can be found in constant time.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  ifndef CONFIG_MM_TLSF_SLSHIFT
+#    define CONFIG_MM_TLSF_SLSHIFT 3
+#  endif
+
+#  define MM_SLSHIFT     CONFIG_MM_TLSF_SLSHIFT
+#  define MM_NSUBLISTS   (1 << MM_SLSHIFT)
+#  define MM_NLISTS      (MM_NNODES << MM_SLSHIFT)
+#else
+#  define MM_NLISTS      MM_NNODES
+#endif
+
+/* Per-CPU small object caches.  If CONFIG_MM_CPUCACHE is selected, small
+ * chunks are freed into and allocated from a per-CPU cache without
+ * taking the heap semaphore.  There is one cache for each power-of-two
+ * chunk size from MM_MIN_CHUNK up to 2^CONFIG_MM_CPUCACHE_MAXSHIFT.  The
+ * caches are refilled from and drained to the heap in batches of
+ * MM_CACHE_BATCH chunks.
+ */
+
+#ifdef CONFIG_MM_CPUCACHE
+#  ifndef CONFIG_MM_CPUCACHE_MAXSHIFT
+#    define CONFIG_MM_CPUCACHE_MAXSHIFT 9
+#  endif
+
+#  ifndef CONFIG_MM_CPUCACHE_DEPTH
+#    define CONFIG_MM_CPUCACHE_DEPTH 16
+#  endif
+
+#  define MM_CACHE_NCLASSES  (CONFIG_MM_CPUCACHE_MAXSHIFT - MM_MIN_SHIFT + 1)
+#  define MM_CACHE_MAXCHUNK  (1 << CONFIG_MM_CPUCACHE_MAXSHIFT)
+#  define MM_CACHE_BATCH     ((CONFIG_MM_CPUCACHE_DEPTH + 1) >> 1)
+#endif
+
 /* An allocated chunk is distinguished from a free chunk by bit 31 (or 15)
  * of the 'preceding' chunk size.  If set, then this is an allocated chunk.
  */
@@ -176,6 +234,17 @@
 #define MM_IS_ALLOCATED(n) \
   ((int)((struct mm_allocnode_s*)(n)->preceding) < 0))
 
+/* Heap region attributes.  A board that adds several kinds of memory to
+ * one heap may describe each region with mm_regionattr().  Memory of a
+ * particular class can then be requested with mm_malloc_attr() (or
+ * malloc_attr(), kmm_malloc_attr(), ...).  Regions that were never
+ * described have no attributes.
+ */
+
+#define MM_REGION_FAST      (1 << 0) /* Fast memory (internal SRAM, TCM, ...) */
+#define MM_REGION_DMA       (1 << 1) /* Accessible by DMA */
+#define MM_REGION_CACHEABLE (1 << 2) /* Accessed through the data cache */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -199,12 +268,19 @@ struct mm_allocnode_s
 {
   mmsize_t size;           /* Size of this chunk */
   mmsize_t preceding;      /* Size of the preceding chunk */
+#ifdef CONFIG_MM_TRACE
+  pid_t    pid;            /* ID of the thread that allocated the chunk */
+  uint16_t reserved;
+  uint32_t seqno;          /* Allocation sequence number */
+#endif
 };
 
 /* What is the size of the allocnode? */
 
 #ifdef CONFIG_MM_SMALL
 # define SIZEOF_MM_ALLOCNODE   4
+#elif defined(CONFIG_MM_TRACE)
+# define SIZEOF_MM_ALLOCNODE   16
 #else
 # define SIZEOF_MM_ALLOCNODE   8
 #endif
@@ -218,6 +294,11 @@ struct mm_freenode_s
 {
   mmsize_t size;                   /* Size of this chunk */
   mmsize_t preceding;              /* Size of the preceding chunk */
+#ifdef CONFIG_MM_TRACE
+  pid_t    pid;                    /* Unused in a free chunk */
+  uint16_t reserved;
+  uint32_t seqno;
+#endif
   FAR struct mm_freenode_s *flink; /* Supports a doubly linked list */
   FAR struct mm_freenode_s *blink;
 };
@@ -230,6 +311,17 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+/* This describes the small object cache of one CPU */
+
+#ifdef CONFIG_MM_CPUCACHE
+struct mm_cpucache_s
+{
+  size_t    mc_cached;                       /* Total size of cached chunks */
+  uint8_t   mc_count[MM_CACHE_NCLASSES];     /* Number of chunks in each cache */
+  FAR void *mc_mem[MM_CACHE_NCLASSES][CONFIG_MM_CPUCACHE_DEPTH];
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -251,16 +343,44 @@ struct mm_heap_s
   FAR struct mm_allocnode_s *mm_heapstart[CONFIG_MM_REGIONS];
   FAR struct mm_allocnode_s *mm_heapend[CONFIG_MM_REGIONS];
 
+  /* The attributes of each region (MM_REGION_* bits) */
+
+  uint8_t mm_heapattr[CONFIG_MM_REGIONS];
+
 #if CONFIG_MM_REGIONS > 1
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TRACE
+  /* Sequence number assigned to the next allocation */
+
+  uint32_t mm_seqno;
+#endif
+
+#ifdef CONFIG_MM_TLSF
+  /* Each free node is maintained in a doubly linked list for its size
+   * class.  Bit n of mm_flbitmap is set if any of the second-level lists
+   * of first-level size class n are non-empty;  bit m of mm_slbitmap[n]
+   * is set if list (n << MM_SLSHIFT) + m is non-empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_NNODES];
+  struct mm_freenode_s mm_nodelist[MM_NLISTS];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* Small object caches, one per CPU */
+
+  struct mm_cpucache_s mm_cpucache[CONFIG_SMP_NCPUS];
+#endif
 };
 
 /****************************************************************************
@@ -323,6 +443,8 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heap_start,
                    size_t heap_size);
 void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                   size_t heapsize);
+int  mm_regionattr(FAR struct mm_heap_s *heap, FAR void *mem,
+                   uint8_t attr);
 
 /* Functions contained in umm_initialize.c **********************************/
 
@@ -337,11 +459,13 @@ void kmm_initialize(FAR void *heap_start, size_t heap_size);
 /* Functions contained in umm_addregion.c ***********************************/
 
 void umm_addregion(FAR void *heapstart, size_t heapsize);
+int  umm_regionattr(FAR void *mem, uint8_t attr);
 
 /* Functions contained in kmm_addregion.c ***********************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 void kmm_addregion(FAR void *heapstart, size_t heapsize);
+int  kmm_regionattr(FAR void *mem, uint8_t attr);
 #endif
 
 /* Functions contained in mm_sem.c ******************************************/
@@ -366,16 +490,30 @@ void kmm_givesemaphore(void);
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size);
+FAR void *mm_malloc_attr(FAR struct mm_heap_s *heap, size_t size,
+                         uint8_t attr);
+
+#ifdef CONFIG_MM_CPUCACHE
+FAR void *mm_heapmalloc(FAR struct mm_heap_s *heap, size_t size);
+#endif
+
+/* Functions contained in umm_malloc.c **************************************/
+
+FAR void *malloc_attr(size_t size, uint8_t attr);
 
 /* Functions contained in kmm_malloc.c **************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 FAR void *kmm_malloc(size_t size);
+FAR void *kmm_malloc_attr(size_t size, uint8_t attr);
 #endif
 
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+#ifdef CONFIG_MM_CPUCACHE
+void mm_heapfree(FAR struct mm_heap_s *heap, FAR void *mem);
+#endif
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -504,9 +642,37 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_remfreechunk.c *********************************/
+
+void mm_remfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_cpucache.c *************************************/
+
+#ifdef CONFIG_MM_CPUCACHE
+FAR void *mm_cpucache_alloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_cpucache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+size_t mm_cpucache_size(FAR struct mm_heap_s *heap);
+#endif
+
+/* Functions contained in mm_trace.c ****************************************/
+
+#ifdef CONFIG_MM_TRACE
+void mm_trace_alloc(FAR struct mm_heap_s *heap,
+                    FAR struct mm_allocnode_s *node);
+void mm_trace_free(FAR struct mm_heap_s *heap,
+                   FAR struct mm_allocnode_s *node);
+#else
+#  define mm_trace_alloc(heap,node)
+#  define mm_trace_free(heap,node)
+#endif
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
+#ifdef CONFIG_MM_TLSF
+int mm_size2searchndx(size_t size);
+#endif
 
 #undef EXTERN
 #ifdef __cplusplus
@@ -0,0 +1,204 @@
+/****************************************************************************
+ * include/nuttx/mm/shmring.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_SHMRING_H
+#define __INCLUDE_NUTTX_MM_SHMRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_MM_SHM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHMRING_MAGIC 0x52474e52 /* Marks a formatted ring */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A shared memory ring is a bounded, multi-producer/single-consumer queue
+ * of fixed size message slots that is formatted in a shared memory
+ * segment (see shmget() and shmat()).  Producers and the consumer may be
+ * in different processes and may attach the segment at different
+ * addresses; nothing in the ring holds a pointer.
+ *
+ * Messages are written and read in place, without copying, and without
+ * any system call as long as the ring is neither empty nor full.  Only a
+ * consumer that finds the ring empty, or a producer that finds it full,
+ * blocks in shmwait() on one of the doorbell words below;  the other side
+ * calls shmwake() only if it sees that someone may be waiting.
+ *
+ * Each slot carries a sequence number.  A slot at ring position 'pos' is
+ * free for a producer when its sequence is 'pos', holds a message when its
+ * sequence is 'pos + 1' and is free again for position 'pos + nslots'
+ * after the consumer has released it.
+ */
+
+struct shmring_slot_s
+{
+  volatile uint32_t seq;       /* Sequence number, see above */
+  uint32_t len;                /* Length of the message in the slot */
+  /* Followed by the message data */
+};
+
+struct shmring_s
+{
+  volatile uint32_t magic;     /* SHMRING_MAGIC when formatted */
+  uint32_t nslots;             /* Number of slots (a power of two) */
+  uint32_t slotsize;           /* Maximum message size */
+  uint32_t stride;             /* Distance between slots in bytes */
+
+  volatile uint32_t head;      /* Next position to be reserved */
+  volatile uint32_t tail;      /* Next position to be consumed */
+
+  volatile uint32_t rbell;     /* Consumer doorbell, bumped by producers */
+  volatile uint32_t rwait;     /* Non-zero:  The consumer may be waiting */
+  volatile uint32_t wbell;     /* Producer doorbell, bumped by consumer */
+  volatile uint32_t wwait;     /* Number of producers that may be waiting */
+
+  /* Followed by the slots, 8-byte aligned */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: shmring_format
+ *
+ * Description:
+ *   Format a ring in 'size' bytes of shared memory at 'mem' for messages of
+ *   up to 'slotsize' bytes.  As many slots as fit are used, rounded down to
+ *   a power of two.  The ring must be formatted (normally by the consumer)
+ *   before any producer uses it.
+ *
+ * Returned Value:
+ *   The number of slots on success; -EINVAL if fewer than two slots fit.
+ *
+ ****************************************************************************/
+
+int shmring_format(FAR void *mem, size_t size, size_t slotsize);
+
+/****************************************************************************
+ * Name: shmring_reserve
+ *
+ * Description:
+ *   Reserve the next free slot of the ring for a message.  The producer
+ *   then writes up to slotsize bytes at '*data' and calls shmring_commit().
+ *   Any number of producers may reserve slots concurrently.
+ *
+ * Input Parameters:
+ *   ring - The formatted ring
+ *   data - Location to return the address of the message data
+ *   wait - True:  Wait while the ring is full
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if the ring is full and 'wait' is false;
+ *   -EINTR if a signal interrupted the wait.
+ *
+ ****************************************************************************/
+
+int shmring_reserve(FAR struct shmring_s *ring, FAR void **data, bool wait);
+
+/****************************************************************************
+ * Name: shmring_commit
+ *
+ * Description:
+ *   Publish a message that was written in a slot from shmring_reserve().
+ *   Messages become visible to the consumer in the order that their slots
+ *   were reserved.
+ *
+ ****************************************************************************/
+
+void shmring_commit(FAR struct shmring_s *ring, FAR void *data, size_t len);
+
+/****************************************************************************
+ * Name: shmring_peek
+ *
+ * Description:
+ *   Return the oldest message of the ring in place.  The consumer calls
+ *   shmring_release() when it is done with the message.  Only one thread
+ *   may consume from a ring.
+ *
+ * Input Parameters:
+ *   ring - The formatted ring
+ *   data - Location to return the address of the message data
+ *   len  - Location to return the length of the message
+ *   wait - True:  Wait while the ring is empty
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if the ring is empty and 'wait' is false;
+ *   -EINTR if a signal interrupted the wait.
+ *
+ ****************************************************************************/
+
+int shmring_peek(FAR struct shmring_s *ring, FAR void **data,
+                 FAR size_t *len, bool wait);
+
+/****************************************************************************
+ * Name: shmring_release
+ *
+ * Description:
+ *   Return the slot of the message from shmring_peek() to the producers.
+ *
+ ****************************************************************************/
+
+void shmring_release(FAR struct shmring_s *ring);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_SHM */
+#endif /* __INCLUDE_NUTTX_MM_SHMRING_H */
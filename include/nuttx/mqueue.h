@@ -56,18 +56,33 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_MQ_PRIOBUCKETS
+/* Message priorities are grouped in buckets of 8 priorities each.  The
+ * messages in one bucket are contiguous in the prioritized message list.
+ */
+
+#  define MQ_NBUCKETS        32
+#  define MQ_BUCKET(prio)    ((prio) >> 3)
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
 
 /* This structure defines a message queue */
 
-struct mq_des; /* forward reference */
+struct mq_des;       /* forward reference */
+struct mqueue_msg_s; /* forward reference */
 
 struct mqueue_inode_s
 {
   FAR struct inode *inode;    /* Containing inode */
   sq_queue_t msglist;         /* Prioritized message list */
+#ifdef CONFIG_MQ_PRIOBUCKETS
+  uint32_t bucketset;         /* Set of non-empty priority buckets */
+  FAR struct mqueue_msg_s *buckethead[MQ_NBUCKETS];
+  FAR struct mqueue_msg_s *buckettail[MQ_NBUCKETS];
+#endif
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
   int16_t nwaitnotfull;       /* Number tasks waiting for not full */
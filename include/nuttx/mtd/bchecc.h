@@ -0,0 +1,144 @@
+/****************************************************************************
+ * include/nuttx/mtd/bchecc.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MTD_BCHECC_H
+#define __INCLUDE_NUTTX_MTD_BCHECC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of bit errors that can be corrected in each step */
+
+#ifndef CONFIG_MTD_NAND_BCH_STRENGTH
+#  define CONFIG_MTD_NAND_BCH_STRENGTH 4
+#endif
+
+/* The BCH code works on steps of 512 data bytes over GF(2^13).  Each step
+ * is protected by 13 ECC bits for each bit error that can be corrected.
+ */
+
+#define BCHECC_STEPSIZE  512
+#define BCHECC_M         13
+#define BCHECC_ECCBITS   (BCHECC_M * CONFIG_MTD_NAND_BCH_STRENGTH)
+#define BCHECC_ECCBYTES  ((BCHECC_ECCBITS + 7) / 8)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bchecc_initialize
+ *
+ * Description:
+ *   Build the Galois field, generator polynomial and encoding tables.  This
+ *   must be called once before any other bchecc function is used; further
+ *   calls do nothing.
+ *
+ * Returned Values:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int bchecc_initialize(void);
+
+/****************************************************************************
+ * Name: bchecc_calculate
+ *
+ * Description:
+ *   Compute the BCHECC_ECCBYTES ECC bytes of one BCHECC_STEPSIZE step of
+ *   data.  The ECC of erased (all 0xff) data is all 0xff.
+ *
+ * Input Parameters:
+ *   data - The data of one step
+ *   ecc  - The location to return the ECC bytes
+ *
+ * Returned Values:
+ *   None
+ *
+ ****************************************************************************/
+
+void bchecc_calculate(FAR const uint8_t *data, FAR uint8_t *ecc);
+
+/****************************************************************************
+ * Name: bchecc_correct
+ *
+ * Description:
+ *   Correct the bit errors in one step of data.
+ *
+ * Input Parameters:
+ *   data    - The data of one step as read.  Corrected in place.
+ *   readecc - The ECC bytes read from the FLASH.
+ *   calcecc - The ECC bytes computed over the data as read.
+ *
+ * Returned Values:
+ *   The number of bit errors corrected (including errors in the ECC bytes)
+ *   or -EBADMSG if the errors cannot be corrected.  The data is not
+ *   modified in that case.
+ *
+ ****************************************************************************/
+
+int bchecc_correct(FAR uint8_t *data, FAR const uint8_t *readecc,
+                   FAR const uint8_t *calcecc);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __INCLUDE_NUTTX_MTD_BCHECC_H */
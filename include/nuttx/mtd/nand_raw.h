@@ -236,6 +236,36 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+/* An ECC engine that a lower-half driver may provide to offload the
+ * software BCH code (see include/nuttx/mtd/bchecc.h).  The engine must
+ * generate exactly the same ECC bytes as bchecc_calculate() for each
+ * BCHECC_STEPSIZE step of the page.
+ *
+ *   enable    - Optional.  Called before the data area of a page is read
+ *               so that the engine can compute the ECC while the data is
+ *               moved (by DMA, for example).  The ECC of written data is
+ *               computed before the transfer.
+ *   calculate - Return the ECC of one step.  If the engine was enabled for
+ *               the transfer, this is the value computed during the
+ *               transfer; otherwise it is computed over 'data'.
+ *   correct   - Optional.  Correct one step in place and return the number
+ *               of corrected bits or -EBADMSG.  If NULL, the correction is
+ *               done by bchecc_correct().
+ */
+
+struct nand_raw_s;
+struct nand_eccengine_s
+{
+  CODE void (*enable)(FAR struct nand_raw_s *raw);
+  CODE int (*calculate)(FAR struct nand_raw_s *raw, unsigned int step,
+                        FAR const uint8_t *data, FAR uint8_t *ecc);
+  CODE int (*correct)(FAR struct nand_raw_s *raw, unsigned int step,
+                      FAR uint8_t *data, FAR const uint8_t *readecc,
+                      FAR const uint8_t *calcecc);
+};
+#endif
+
 /* This type represents the visible portion of the lower-half, raw NAND MTD
  * device.  The lower-half driver may freely append additional information
  * after this required header information.
@@ -268,6 +298,12 @@ struct nand_raw_s
                         FAR const void *spare);
 #endif
 
+#ifdef CONFIG_MTD_NAND_ECCENGINE
+  /* Optional ECC engine.  NULL selects the software BCH code */
+
+  FAR const struct nand_eccengine_s *eccengine;
+#endif
+
 #if defined(CONFIG_MTD_NAND_SWECC) || defined(CONFIG_MTD_NAND_HWECC)
   /* ECC working buffers*/
 
@@ -0,0 +1,131 @@
+/****************************************************************************
+ * include/nuttx/mtd/spinor.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MTD_SPINOR_H
+#define __INCLUDE_NUTTX_MTD_SPINOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/spi/spi.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Address widths.  Parts larger than 16MiB need 4-byte addresses */
+
+#define SPINOR_ADDR3         3
+#define SPINOR_ADDR4         4
+
+/* The largest number of dummy bytes supported after the address */
+
+#define SPINOR_MAXDUMMY      4
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: spinor_command
+ *
+ * Description:
+ *   Send a SPI NOR FLASH instruction, its address (most significant byte
+ *   first) and any dummy bytes as one SPI block transfer rather than a byte
+ *   at a time.  The caller must hold the SPI bus lock and have selected
+ *   the part.
+ *
+ * Input Parameters:
+ *   spi     - The SPI bus of the FLASH part
+ *   cmd     - The instruction
+ *   addr    - The FLASH address
+ *   addrlen - The number of address bytes:  0, SPINOR_ADDR3 or
+ *             SPINOR_ADDR4
+ *   ndummy  - The number of dummy bytes after the address (at most
+ *             SPINOR_MAXDUMMY)
+ *
+ ****************************************************************************/
+
+void spinor_command(FAR struct spi_dev_s *spi, uint8_t cmd, uint32_t addr,
+                    unsigned int addrlen, unsigned int ndummy);
+
+/****************************************************************************
+ * Name: spinor_read
+ *
+ * Description:
+ *   Send a read instruction with spinor_command() and then receive all of
+ *   the data in one SPI_RECVBLOCK() so that the SPI driver can use DMA for
+ *   the whole transfer.
+ *
+ ****************************************************************************/
+
+void spinor_read(FAR struct spi_dev_s *spi, uint8_t cmd, uint32_t addr,
+                 unsigned int addrlen, unsigned int ndummy,
+                 FAR void *buffer, size_t nbytes);
+
+/****************************************************************************
+ * Name: spinor_write
+ *
+ * Description:
+ *   Send a program instruction with spinor_command() and then send all of
+ *   the data in one SPI_SNDBLOCK().
+ *
+ ****************************************************************************/
+
+void spinor_write(FAR struct spi_dev_s *spi, uint8_t cmd, uint32_t addr,
+                  unsigned int addrlen, FAR const void *buffer,
+                  size_t nbytes);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_MTD_SPINOR_H */
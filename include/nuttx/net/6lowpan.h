@@ -45,12 +45,57 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 #include <nuttx/net/netconfig.h>
 
+#ifdef CONFIG_NET_6LOWPAN
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* 6LoWPAN dispatch values (RFC 4944 and RFC 6282) */
+
+#define SIXLOWPAN_DISPATCH_IPV6      0x41 /* 01000001: Uncompressed IPv6 */
+#define SIXLOWPAN_DISPATCH_IPHC      0x60 /* 011xxxxx: IPHC compressed IPv6 */
+#define SIXLOWPAN_DISPATCH_IPHC_MASK 0xe0
+#define SIXLOWPAN_DISPATCH_FRAG1     0xc0 /* 11000xxx: First fragment */
+#define SIXLOWPAN_DISPATCH_FRAGN     0xe0 /* 11100xxx: Subsequent fragment */
+#define SIXLOWPAN_DISPATCH_FRAG_MASK 0xf8
+
+#define SIXLOWPAN_FRAG1_HDRLEN       4
+#define SIXLOWPAN_FRAGN_HDRLEN       5
+
+/* IEEE 802.15.4 link-layer address sizes */
+
+#define SIXLOWPAN_SADDRSIZE          2    /* Short (16-bit) address */
+#define SIXLOWPAN_EADDRSIZE          8    /* Extended (EUI-64) address */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* An IEEE 802.15.4 link-layer address.  The bytes are held most significant
+ * byte first, the order in which they appear in the IPv6 interface
+ * identifier (IEEE 802.15.4 frames carry them in the reverse order).
+ */
+
+struct sixlowpan_addr_s
+{
+  uint8_t len;                      /* SIXLOWPAN_SADDRSIZE or _EADDRSIZE */
+  uint8_t u8[SIXLOWPAN_EADDRSIZE];  /* The address */
+};
+
+/* The radio driver callback that sends one 6LoWPAN frame payload (the MAC
+ * header and FCS are added by the driver).
+ */
+
+struct net_driver_s; /* Forward reference */
+typedef CODE int (*sixlowpan_sendframe_t)(FAR struct net_driver_s *dev,
+                                          FAR const uint8_t *frame,
+                                          uint16_t framelen, FAR void *arg);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -59,4 +104,68 @@
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Function: sixlowpan_send
+ *
+ * Description:
+ *   Compress the IPv6 packet in dev->d_buf (d_len bytes) and send it as one
+ *   or more 6LoWPAN frames of at most CONFIG_NET_6LOWPAN_FRAMELEN bytes,
+ *   fragmenting it if necessary.  This is called by the radio driver for
+ *   each packet from devif_poll() in place of a hardware transmission.
+ *
+ * Parameters:
+ *   dev       - The network device holding the packet
+ *   srcaddr   - The link-layer source address (the radio's own address)
+ *   destaddr  - The link-layer address of the next hop (or NULL for a
+ *               multicast destination)
+ *   sendframe - Called to send each frame
+ *   arg       - Passed to sendframe
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure, including any error
+ *   returned by sendframe.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int sixlowpan_send(FAR struct net_driver_s *dev,
+                   FAR const struct sixlowpan_addr_s *srcaddr,
+                   FAR const struct sixlowpan_addr_s *destaddr,
+                   sixlowpan_sendframe_t sendframe, FAR void *arg);
+
+/****************************************************************************
+ * Function: sixlowpan_input
+ *
+ * Description:
+ *   Handle one received 6LoWPAN frame payload (without the MAC header and
+ *   FCS).  Compressed headers are expanded and fragments are reassembled.
+ *   When an IPv6 packet is complete, it is placed in dev->d_buf with d_len
+ *   set and the driver should then pass it to ipv6_input().
+ *
+ * Parameters:
+ *   dev      - The network device that received the frame
+ *   frame    - The frame payload
+ *   framelen - The size of the frame payload
+ *   srcaddr  - The link-layer source address of the frame
+ *   destaddr - The link-layer destination address of the frame
+ *
+ * Returned Value:
+ *   OK if an IPv6 packet is now in dev->d_buf; -EAGAIN if the frame was a
+ *   fragment of a datagram that is not yet complete; another negated errno
+ *   value if the frame was dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int sixlowpan_input(FAR struct net_driver_s *dev, FAR const uint8_t *frame,
+                    uint16_t framelen,
+                    FAR const struct sixlowpan_addr_s *srcaddr,
+                    FAR const struct sixlowpan_addr_s *destaddr);
+
+#endif /* CONFIG_NET_6LOWPAN */
+
 #endif /* __INCLUDE_NUTTX_NET_6LOWPAN_H */
@@ -81,7 +81,11 @@ struct arp_entry
 {
   in_addr_t         at_ipaddr;   /* IP address */
   struct ether_addr at_ethaddr;  /* Hardware address */
-  uint8_t           at_time;     /* Time of last usage */
+  uint8_t           at_time;     /* Time of last update */
+#ifdef CONFIG_NET_ARP_HASH
+  uint16_t          at_lru;      /* Time of last usage (for replacement) */
+  FAR struct arp_entry *at_next; /* Next entry in the hash chain */
+#endif
 };
 
 /* Used with the SIOCSARP, SIOCDARP, and SIOCGARP IOCTL commands to set,
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * include/nuttx/net/bench.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_BENCH_H
+#define __INCLUDE_NUTTX_NET_BENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <netinet/in.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Protocols */
+
+#define NETBENCH_TCP       0
+#define NETBENCH_UDP       1
+
+/* Modes */
+
+#define NETBENCH_LOOPBACK  0  /* Both ends, receiver in a kernel thread */
+#define NETBENCH_SERVER    1  /* Receive from a client on another host */
+#define NETBENCH_CLIENT    2  /* Send to a server on another host */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Describes one run of the benchmark.  The rates are computed from the
+ * time between the first and the last packet sent or received.  The
+ * receiving end stops on end of file (TCP), on an empty datagram (UDP) or
+ * when no data has been received for one second.
+ */
+
+struct netbench_s
+{
+  uint8_t   proto;      /* IN: NETBENCH_TCP or NETBENCH_UDP */
+  uint8_t   mode;       /* IN: NETBENCH_LOOPBACK, _SERVER or _CLIENT */
+  uint16_t  port;       /* IN: Port (0: CONFIG_NET_BENCHMARK_PORT) */
+  in_addr_t addr;       /* IN: Server address, network order (0: 127.0.0.1
+                         * in loopback mode, any address in server mode) */
+  uint16_t  bufsize;    /* IN: Bytes per send (0: default) */
+  uint16_t  duration;   /* IN: Seconds of sending (0: default) */
+
+  uint64_t  txbytes;    /* OUT: Bytes sent */
+  uint32_t  txpackets;  /* OUT: Number of sends */
+  uint32_t  txbps;      /* OUT: Bytes sent per second */
+  uint32_t  txpps;      /* OUT: Sends per second */
+  uint64_t  rxbytes;    /* OUT: Bytes received */
+  uint32_t  rxpackets;  /* OUT: Number of receives */
+  uint32_t  rxbps;      /* OUT: Bytes received per second */
+  uint32_t  rxpps;      /* OUT: Receives per second */
+  uint16_t  cpuload;    /* OUT: CPU load at the end in units of 0.1%
+                         * (0 without CONFIG_SCHED_CPULOAD) */
+  uint16_t  iobhwm;     /* OUT: Most I/O buffers in use during the run
+                         * (0 without CONFIG_NET_IOB) */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: netbench_run
+ *
+ * Description:
+ *   Run the network throughput benchmark.  Only one run may be in progress
+ *   at a time; a concurrent caller waits.
+ *
+ * Input Parameters:
+ *   bench - Describes the run and receives the results
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BENCHMARK
+int netbench_run(FAR struct netbench_s *bench);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_NET_BENCH_H */
@@ -44,6 +44,9 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#ifdef CONFIG_NET_TIMESTAMP
+#  include <time.h>
+#endif
 
 #include <nuttx/net/iob.h>
 
@@ -88,6 +91,30 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+#if defined(CONFIG_IOB_GROWTH) && CONFIG_IOB_MAXBUFFERS < CONFIG_IOB_NBUFFERS
+#  error CONFIG_IOB_MAXBUFFERS < CONFIG_IOB_NBUFFERS
+#endif
+
+/* I/O buffer users.  With CONFIG_IOB_QUOTA, the I/O buffers held by each
+ * user are counted and may be limited (CONFIG_IOB_QUOTA_*) and reserved
+ * (CONFIG_IOB_RESERVE_*).  Buffers added to a chain belong to the user of
+ * the buffer at the head of the chain.
+ */
+
+#define IOBUSER_OTHER    0  /* None of the following */
+#define IOBUSER_TCP_RX   1  /* TCP read-ahead */
+#define IOBUSER_TCP_TX   2  /* TCP write buffers */
+#define IOBUSER_UDP_RX   3  /* UDP read-ahead */
+#define IOBUSER_UDP_TX   4  /* UDP write buffers */
+#define IOBUSER_NETDEV   5  /* Network drivers and forwarded packets */
+#define IOBUSER_NUSERS   6
+
+#ifdef CONFIG_IOB_QUOTA
+#  define IOB_USER(p)    ((p)->io_user)
+#else
+#  define IOB_USER(p)    IOBUSER_OTHER
+#endif
+
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
@@ -125,6 +152,13 @@ struct iob_s
   uint16_t io_offset;   /* Data begins at this offset */
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
+#ifdef CONFIG_IOB_QUOTA
+  uint8_t  io_user;     /* The user the buffer is accounted to */
+#endif
+#ifdef CONFIG_NET_TIMESTAMP
+  struct timespec io_swtime; /* Software receive time (head of chain only) */
+  struct timespec io_hwtime; /* Hardware receive time (head of chain only) */
+#endif
 
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
 };
@@ -184,6 +218,46 @@ void iob_initialize(void);
 
 FAR struct iob_s *iob_alloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_user
+ *
+ * Description:
+ *   Allocate an I/O buffer on behalf of one of the IOBUSER_* users.  With
+ *   CONFIG_IOB_QUOTA, the allocation may wait (or fail, if called from an
+ *   interrupt handler) because the user has reached its quota or because
+ *   the remaining free buffers are reserved for other users.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_user(bool throttled, uint8_t user);
+
+/****************************************************************************
+ * Name: iob_usage
+ *
+ * Description:
+ *   Return the number of I/O buffers currently held by one of the
+ *   IOBUSER_* users.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+int iob_usage(uint8_t user);
+#endif
+
+/****************************************************************************
+ * Name: iob_highwater
+ *
+ * Description:
+ *   Return the largest number of I/O buffers that were in use at any time
+ *   since the last reset.  If 'reset' is true, the mark is then reset to
+ *   the number of I/O buffers currently in use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_HIGHWATER
+int iob_highwater(bool reset);
+#endif
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -325,6 +399,18 @@ int iob_copyout(FAR uint8_t *dest, FAR const struct iob_s *iob,
 
 int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryclone
+ *
+ * Description:
+ *   Duplicate (and pack) the data in iob1 in iob2 BUT without waiting if
+ *   buffers are not available.  iob2 must be empty.
+ *
+ ****************************************************************************/
+
+int iob_tryclone(FAR struct iob_s *iob1, FAR struct iob_s *iob2,
+                 bool throttled);
+
 /****************************************************************************
  * Name: iob_concat
  *
@@ -189,6 +189,17 @@
 #define SIOCTELNET       _SIOC(0x0054)  /* Create a Telnet sessions.
                                          * See include/nuttx/net/telnet.h */
 
+/* Hardware time stamping and the PTP hardware clock ************************/
+
+#define SIOCSHWTSTAMP    _SIOC(0x0055)  /* Set hardware time stamping config */
+#define SIOCGHWTSTAMP    _SIOC(0x0056)  /* Get hardware time stamping config */
+#define SIOCGPHCTIME     _SIOC(0x0057)  /* Get the PTP hardware clock time */
+#define SIOCSPHCTIME     _SIOC(0x0058)  /* Set the PTP hardware clock time */
+#define SIOCADJPHCTIME   _SIOC(0x0059)  /* Step the PTP hardware clock by an
+                                         * offset */
+#define SIOCADJPHCFREQ   _SIOC(0x005a)  /* Adjust the PTP hardware clock
+                                         * frequency (in ppb) */
+
 /****************************************************************************
  * Pulbic Type Definitions
  ****************************************************************************/
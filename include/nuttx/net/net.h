@@ -48,6 +48,7 @@
 #include <stdbool.h>
 #include <stdarg.h>
 #include <semaphore.h>
+#include <time.h>
 
 #ifndef CONFIG_NET_NOINTS
 #  include <nuttx/irq.h>
@@ -84,7 +85,7 @@ enum net_lltype_e
 
 /* This defines a bitmap big enough for one bit for each socket option */
 
-typedef uint16_t sockopt_t;
+typedef uint32_t sockopt_t;
 
 /* This defines the storage size of a timeout value.  This effects only
  * range of supported timeout values.  With an LSB in seciseconds, the
@@ -116,6 +117,14 @@ struct socket
 #ifdef CONFIG_NET_SOLINGER
   socktimeo_t   s_linger;    /* Linger timeout value (in deciseconds) */
 #endif
+#ifdef CONFIG_NET_TIMESTAMP
+  uint8_t       s_tsflags;   /* SO_TIMESTAMPING flags (SOF_TIMESTAMPING_*) */
+  struct timespec s_rxswtime; /* Software receive time of the last datagram */
+  struct timespec s_rxhwtime; /* Hardware receive time of the last datagram */
+#endif
+#ifdef CONFIG_NET_TXPENDING
+  uint8_t       s_priority;  /* SO_PRIORITY value */
+#endif
 #endif
 
   FAR void     *s_conn;      /* Connection: struct tcp_conn_s or udp_conn_s */
@@ -160,6 +169,19 @@ typedef uint8_t net_lock_t; /* Not really used */
 #  define net_lock_t        irqstate_t
 #endif
 
+#ifdef CONFIG_NET_FINELOCK
+/* A re-entrant lock.  Used for the lock of each network device and for the
+ * protocol locks of the stack (CONFIG_NET_FINELOCK).
+ */
+
+struct net_rlock_s
+{
+  sem_t        rl_sem;      /* Mutual exclusion */
+  pid_t        rl_holder;   /* Thread that holds the lock */
+  unsigned int rl_count;    /* Number of times the holder took the lock */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -242,6 +264,13 @@ void net_initialize(void);
  *   net_unlock()        - Conditionally restores interrupts.
  *   net_lockedwait()    - Just wait for the semaphore.
  *
+ * With CONFIG_NET_FINELOCK, drivers may use netdev_lock() and
+ * netdev_unlock() in place of net_lock() and net_unlock().  These lock
+ * only one device; the stack then locks only the protocol that it works
+ * on.  net_lock() still locks the whole network.  A thread that holds a
+ * device lock must never block:  net_lockedwait() and net_timedwait()
+ * cannot release a device lock while they wait.
+ *
  ****************************************************************************/
 
 /****************************************************************************
@@ -319,6 +348,39 @@ int net_lockedwait(sem_t *sem);
 #  define net_lockedwait(s) sem_wait(s)
 #endif
 
+/****************************************************************************
+ * Function: netdev_lock
+ *
+ * Description:
+ *   Lock the network for the receive processing or the polling of one
+ *   device.  With CONFIG_NET_FINELOCK, this locks only the device so that
+ *   other devices can be serviced at the same time.  Otherwise, it is the
+ *   same as net_lock().
+ *
+ *   A thread must not lock a second device while it holds a device lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINELOCK
+net_lock_t netdev_lock(FAR struct net_driver_s *dev);
+#else
+#  define netdev_lock(d) net_lock()
+#endif
+
+/****************************************************************************
+ * Function: netdev_unlock
+ *
+ * Description:
+ *   Release the lock taken with netdev_lock().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINELOCK
+void netdev_unlock(FAR struct net_driver_s *dev, net_lock_t flags);
+#else
+#  define netdev_unlock(d,f) net_unlock(f)
+#endif
+
 /****************************************************************************
  * Function: net_setipid
  *
@@ -875,6 +937,28 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Function: psock_recvmsg
+ *
+ * Description:
+ *   Receive one message into the buffer described by a msghdr structure,
+ *   including any ancillary data (see recvmsg()).
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to be received
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received.  On failure, -1 is
+ *   returned and errno is set appropriately (see psock_recvfrom()).
+ *
+ ****************************************************************************/
+
+struct msghdr;
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags);
+
 /****************************************************************************
  * Function: psock_getsockopt
  *
@@ -133,7 +133,10 @@
 #    define _MAX_ETH_MTU   0
 #  endif
 
-#  ifdef CONFIG_NET_LOOPBACK
+#  if defined(CONFIG_NET_LOOPBACK_MTU) && CONFIG_NET_LOOPBACK_MTU > 0
+#    define _MIN_LO_MTU    MIN(_MIN_ETH_MTU,CONFIG_NET_LOOPBACK_MTU)
+#    define _MAX_LO_MTU    MAX(_MAX_ETH_MTU,CONFIG_NET_LOOPBACK_MTU)
+#  elif defined(CONFIG_NET_LOOPBACK)
 #    define _MIN_LO_MTU    MIN(_MIN_ETH_MTU,1518)
 #    define _MAX_LO_MTU    MAX(_MAX_ETH_MTU,574)
 #  else
@@ -152,9 +155,15 @@
 #  define MIN_NET_DEV_MTU  _MIN_SLIP_MTU
 #  define MAX_NET_DEV_MTU  _MAX_SLIP_MTU
 
-/* For the loopback device, we will use the largest MTU */
+/* For the loopback device, we will use the configured MTU or, by default,
+ * the largest MTU.
+ */
 
-#  define NET_LO_MTU        MAX_NET_DEV_MTU
+#  if defined(CONFIG_NET_LOOPBACK_MTU) && CONFIG_NET_LOOPBACK_MTU > 0
+#    define NET_LO_MTU      CONFIG_NET_LOOPBACK_MTU
+#  else
+#    define NET_LO_MTU      MAX_NET_DEV_MTU
+#  endif
 
 #elif defined(CONFIG_NET_SLIP)
    /* There is no link layer header with SLIP */
@@ -181,7 +190,11 @@
    * The case where the local loopback device is the only device is very unusal.
    */
 
-#  define NET_LO_MTU        1518
+#  if defined(CONFIG_NET_LOOPBACK_MTU) && CONFIG_NET_LOOPBACK_MTU > 0
+#    define NET_LO_MTU      CONFIG_NET_LOOPBACK_MTU
+#  else
+#    define NET_LO_MTU      1518
+#  endif
 
    /* Assume standard Ethernet link layer header */
 
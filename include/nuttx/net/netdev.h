@@ -51,6 +51,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <net/if.h>
 
 #include <net/ethernet.h>
@@ -63,22 +64,61 @@
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
 
+#ifdef CONFIG_NET_IPFORWARD
+#  include <nuttx/net/iob.h>
+#endif
+
+#if defined(CONFIG_NETDEV_MULTIQUEUE) || defined(CONFIG_NETDEV_NAPI) || \
+    defined(CONFIG_NET_FINELOCK)
+#  include <nuttx/wqueue.h>
+#endif
+
+#ifdef CONFIG_NET_FINELOCK
+#  include <nuttx/net/net.h>
+#endif
+
+#ifdef CONFIG_NET_TXPENDING
+#  include <queue.h>
+#endif
+
+#if defined(CONFIG_NET_TXPENDING) && !defined(CONFIG_NET_TXPRIO_NCLASSES)
+#  define CONFIG_NET_TXPRIO_NCLASSES 1
+#endif
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_SMP)
+#  include <nuttx/arch.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* Helper macros for network device statistics */
+/* Helper macros for network device statistics.
+ *
+ * In the SMP case, the driver's receive and transmit paths may run at the
+ * same time on different CPUs.  Rather than making every increment atomic,
+ * each CPU then updates its own copy of the counters and the copies are
+ * added together only when the statistics are read.
+ */
 
 #ifdef CONFIG_NETDEV_STATISTICS
+#  ifdef CONFIG_SMP
+#    define NETDEV_STATS_NSLOTS CONFIG_SMP_NCPUS
+#    define NETDEV_STATS(dev)   ((dev)->d_statistics[up_cpu_index()])
+#  else
+#    define NETDEV_STATS_NSLOTS 1
+#    define NETDEV_STATS(dev)   ((dev)->d_statistics[0])
+#  endif
+
 #  define NETDEV_RESET_STATISTICS(dev) \
-     memset(&(dev)->d_statistics, 0, sizeof(struct netdev_statistics_s))
+     memset((dev)->d_statistics, 0, sizeof((dev)->d_statistics))
 
-#  define _NETDEV_STATISTIC(dev,name) ((dev)->d_statistics.name++)
+#  define _NETDEV_STATISTIC(dev,name) (NETDEV_STATS(dev).name++)
 #  define _NETDEV_ERROR(dev,name) \
      do \
        { \
-         (dev)->d_statistics.name++; \
-         (dev)->d_statistics.errors++; \
+         NETDEV_STATS(dev).name++; \
+         NETDEV_STATS(dev).errors++; \
        } \
      while (0)
 
@@ -101,11 +141,13 @@
 #    define NETDEV_RXARP(dev)
 #  endif
 #  define NETDEV_RXDROPPED(dev)   _NETDEV_STATISTIC(dev,rx_dropped)
+#  define NETDEV_RXNOBUFS(dev)    _NETDEV_STATISTIC(dev,rx_nobufs)
 
 #  define NETDEV_TXPACKETS(dev)   _NETDEV_STATISTIC(dev,tx_packets)
 #  define NETDEV_TXDONE(dev)      _NETDEV_STATISTIC(dev,tx_done)
 #  define NETDEV_TXERRORS(dev)    _NETDEV_ERROR(dev,tx_errors)
 #  define NETDEV_TXTIMEOUTS(dev)  _NETDEV_ERROR(dev,tx_timeouts)
+#  define NETDEV_TXDROPPED(dev)   _NETDEV_STATISTIC(dev,tx_dropped)
 
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
@@ -118,11 +160,13 @@
 #  define NETDEV_RXIPV6(dev)
 #  define NETDEV_RXARP(dev)
 #  define NETDEV_RXDROPPED(dev)
+#  define NETDEV_RXNOBUFS(dev)
 
 #  define NETDEV_TXPACKETS(dev)
 #  define NETDEV_TXDONE(dev)
 #  define NETDEV_TXERRORS(dev)
 #  define NETDEV_TXTIMEOUTS(dev)
+#  define NETDEV_TXDROPPED(dev)
 
 #  define NETDEV_ERRORS(dev)
 #endif
@@ -154,6 +198,7 @@ struct netdev_statistics_s
   uint32_t rx_arp;         /* Number of Rx ARP packets received */
 #endif
   uint32_t rx_dropped;     /* Unsupported Rx packets received */
+  uint32_t rx_nobufs;      /* Rx packets dropped for lack of buffers */
 
   /* Tx Status */
 
@@ -161,6 +206,7 @@ struct netdev_statistics_s
   uint32_t tx_done;        /* Number of packets completed */
   uint32_t tx_errors;      /* Number of receive errors (incl timeouts) */
   uint32_t tx_timeouts;    /* Number of Tx timeout errors */
+  uint32_t tx_dropped;     /* Tx packets discarded before sending */
 
   /* Other status */
 
@@ -174,6 +220,89 @@ struct netdev_statistics_s
  */
 
 struct devif_callback_s; /* Forward reference */
+struct iob_s;            /* Forward reference */
+
+#ifdef CONFIG_NET_TXPENDING
+/* Each connection that can be polled for TX data contains one of these.
+ * While the connection has data to send, it is queued in d_txpend of the
+ * device that will send it, so devif_poll() need not visit every
+ * connection.  See devif_txpend_add().
+ */
+
+struct devif_txpend_s
+{
+  sq_entry_t tp_node;             /* Supports a singly linked list */
+  FAR struct net_driver_s *tp_dev; /* Queued in this device (NULL: none) */
+  uint8_t tp_type;                /* Connection type: DEVIF_TXPEND_* */
+  uint8_t tp_prio;                /* Priority class (see SO_PRIORITY) */
+};
+#endif
+
+#ifdef CONFIG_NETDEV_NAPI
+/* State of the budgeted receive polling of one device (or of one receive
+ * ring of a device).  See netdev_napi_schedule().
+ */
+
+struct netdev_napi_s;    /* Forward reference */
+
+/* Receive up to 'budget' frames and return the number received */
+
+typedef CODE int (*netdev_napi_poll_t)(FAR struct netdev_napi_s *napi,
+                                       int budget);
+
+/* Enable (true) or disable (false) the receive interrupt */
+
+typedef CODE void (*netdev_napi_irqctl_t)(FAR struct netdev_napi_s *napi,
+                                          bool enable);
+
+struct netdev_napi_s
+{
+  struct work_s n_work;           /* Work item that runs n_poll */
+  netdev_napi_poll_t n_poll;      /* Driver receive function */
+  netdev_napi_irqctl_t n_irqctl;  /* Driver RX interrupt control */
+  FAR void *n_arg;                /* Driver private data */
+  uint16_t n_budget;              /* Frames per work queue activation */
+  uint8_t n_qid;                  /* Work queue (HPWORK or LPWORK) */
+  volatile bool n_scheduled;      /* RX interrupt off, polling active */
+};
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* Describes one receive queue of a multi-queue network device.  The driver
+ * owns the queue structures and their packet buffers; they are registered
+ * with netdev_queue_setup().  Each queue is serviced by the high priority
+ * work queue of one CPU (q_cpu).
+ */
+
+struct net_driver_s;     /* Forward reference */
+struct netdev_queue_s;   /* Forward reference */
+
+typedef CODE void (*netdev_qinput_t)(FAR struct netdev_queue_s *queue);
+
+struct netdev_queue_s
+{
+  FAR struct net_driver_s *q_dev; /* The device that owns the queue */
+  FAR uint8_t *q_buf;             /* Packet buffer of this queue */
+  netdev_qinput_t q_input;        /* Driver receive handler of the queue */
+  FAR void *q_priv;               /* Driver private data of the queue */
+  struct work_s q_work;           /* Work item run on CPU q_cpu */
+  uint16_t q_len;                 /* Length of the packet in q_buf */
+  uint8_t q_index;                /* Index of the queue in d_queues[] */
+  uint8_t q_cpu;                  /* CPU that processes this queue */
+};
+#endif
+
+#ifdef CONFIG_NET_IOBTX
+/* Describes one segment of an outgoing packet for gather-DMA transmission.
+ * See devif_iob_txsegs().
+ */
+
+struct netdev_txseg_s
+{
+  FAR const uint8_t *ts_data;   /* Start of the segment */
+  uint16_t ts_len;              /* Length of the segment in bytes */
+};
+#endif
 
 struct net_driver_s
 {
@@ -227,6 +356,59 @@ struct net_driver_s
   net_ipv6addr_t d_ipv6netmask; /* Network IPv6 subnet mask */
 #endif
 
+#ifdef CONFIG_NET_IPFORWARD
+  /* Packets received on other devices waiting to be forwarded through
+   * this device.
+   */
+
+  struct iob_queue_s d_fwdq;
+#endif
+
+#ifdef CONFIG_NET_TXPENDING
+  /* Connections that have requested to send through this device, one
+   * queue per priority class.  d_txprio is the class of the connection
+   * whose packet is in d_buf when devif_poll() calls back into the driver
+   * (zero if the packet does not come from a queued connection); a driver
+   * for hardware with several transmit queues may use it to select one.
+   */
+
+  sq_queue_t d_txpend[CONFIG_NET_TXPRIO_NCLASSES];
+#if CONFIG_NET_TXPRIO_NCLASSES > 1
+  uint8_t d_txcredit[CONFIG_NET_TXPRIO_NCLASSES - 1]; /* Weighted classes */
+#endif
+  uint8_t d_txprio;
+#endif
+
+#ifdef CONFIG_NET_ROUTE_CACHE
+  /* The last route selected by netdev_ipv4_router()/netdev_ipv6_router().
+   * An entry is valid only while its generation matches the routing
+   * table's.
+   */
+
+#ifdef CONFIG_NET_IPv4
+  in_addr_t      d_rtdest;      /* Destination IPv4 address */
+  in_addr_t      d_rtrouter;    /* Router used to reach d_rtdest */
+  uint16_t       d_rtgen;       /* Generation of the IPv4 entry */
+#endif
+#ifdef CONFIG_NET_IPv6
+  uint16_t       d_rtgen6;      /* Generation of the IPv6 entry */
+  net_ipv6addr_t d_rtdest6;     /* Destination IPv6 address */
+  net_ipv6addr_t d_rtrouter6;   /* Router used to reach d_rtdest6 */
+#endif
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Receive queues registered by netdev_queue_setup() and the indirection
+   * table used to steer flows to them.  d_rxqueue is the queue whose packet
+   * is currently in d_buf (NULL if none).
+   */
+
+  FAR struct netdev_queue_s *d_queues;
+  FAR struct netdev_queue_s *d_rxqueue;
+  uint8_t d_nqueues;
+  uint8_t d_rsstable[CONFIG_NETDEV_RSS_TABLESIZE];
+#endif
+
   /* The d_buf array is used to hold incoming and outgoing packets. The device
    * driver should place incoming data into this buffer. When sending data,
    * the device driver should read the link level headers and the TCP/IP
@@ -251,6 +433,19 @@ struct net_driver_s
 
   uint8_t *d_appdata;
 
+#ifdef CONFIG_NET_IOBRX
+  /* If the driver received the packet into an I/O buffer, then d_iob refers
+   * to that buffer and d_buf must point to d_iob->io_data.  Otherwise,
+   * d_iob must be NULL.  The network may take ownership of the buffer by
+   * replacing d_iob (and d_buf) with a new I/O buffer that holds a copy of
+   * the packet headers.  The driver is responsible for the I/O buffer
+   * referenced by d_iob and must re-read d_iob and d_buf after calling into
+   * the network.
+   */
+
+  FAR struct iob_s *d_iob;
+#endif
+
 #ifdef CONFIG_NET_TCPURGDATA
   /* This pointer points to any urgent TCP data that has been received. Only
    * present if compiled with support for urgent data (CONFIG_NET_TCPURGDATA).
@@ -284,6 +479,50 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_IOBTX
+  /* If the driver sets IFF_TXIOB in d_flags, then the payload of an
+   * outgoing packet may be left in an I/O buffer chain rather than copied
+   * into d_buf.  In that case, d_sndiob is non-NULL and d_buf holds only
+   * the first d_len - d_sndioblen bytes of the packet (the headers); the
+   * remaining d_sndioblen bytes begin at offset d_sndioboffs in d_sndiob.
+   * The driver must set d_sndiob to NULL after the packet has been sent.
+   */
+
+  FAR struct iob_s *d_sndiob;   /* I/O buffer chain holding the payload */
+  uint16_t d_sndioboffs;        /* Offset to the payload in d_sndiob */
+  uint16_t d_sndioblen;         /* Length of the payload in d_sndiob */
+#endif
+
+#ifdef CONFIG_NET_TCP_TSO
+  /* A driver for hardware that supports TCP segmentation offload sets
+   * d_tsomax to the largest TCP payload that it can accept in one packet
+   * (the complete packet must still fit in 16 bits).  It sets d_tsomax to
+   * zero if it does not support TSO.  An outgoing TCP packet must be
+   * segmented by the hardware if d_tsomss is non-zero and less than
+   * d_sndlen; each segment then carries at most d_tsomss bytes of payload.
+   */
+
+  uint16_t d_tsomax;            /* Maximum TSO payload (0: no TSO) */
+  uint16_t d_tsomss;            /* Segment size for this packet */
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMP
+  /* Packet time stamps.  A driver for hardware with a PTP hardware clock
+   * sets d_rxtime to the time that the frame in d_buf was received before
+   * passing it to the network.  It is zero if there is no hardware time
+   * stamp.
+   *
+   * If d_txtsreq is non-NULL when an outgoing frame is handed to the
+   * driver, then the sender asked for a hardware transmit time stamp.
+   * The driver saves and clears d_txtsreq and, when the hardware reports
+   * the transmit time of the frame, passes it back with
+   * netdev_txtimestamp().
+   */
+
+  struct timespec d_rxtime;     /* Hardware receive time of d_buf */
+  FAR void *d_txtsreq;          /* Transmit time stamp request */
+#endif
+
 #ifdef CONFIG_NET_IGMP
   /* IGMP group list */
 
@@ -293,10 +532,10 @@ struct net_driver_s
 #ifdef CONFIG_NETDEV_STATISTICS
   /* If CONFIG_NETDEV_STATISTICS is enabled and if the driver supports
    * statistics, then this structure holds the counts of network driver
-   * events.
+   * events.  There is one copy per CPU in the SMP case.
    */
 
-  struct netdev_statistics_s d_statistics;
+  struct netdev_statistics_s d_statistics[NETDEV_STATS_NSLOTS];
 #endif
 
   /* Application callbacks:
@@ -322,6 +561,16 @@ struct net_driver_s
   FAR struct devif_callback_s *d_conncb;
   FAR struct devif_callback_s *d_devcb;
 
+#ifdef CONFIG_NET_FINELOCK
+  /* d_lock is the lock taken by netdev_lock().  d_txwork defers a call of
+   * d_txavail() that is requested while some device is locked with
+   * netdev_lock() (see netdev_txnotify_dev()).
+   */
+
+  struct net_rlock_s d_lock;
+  struct work_s d_txwork;
+#endif
+
   /* Driver callbacks */
 
   int (*d_ifup)(FAR struct net_driver_s *dev);
@@ -334,7 +583,7 @@ struct net_driver_s
   int (*d_addmac)(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
   int (*d_rmmac)(FAR struct net_driver_s *dev, FAR const uint8_t *mac);
 #endif
-#ifdef CONFIG_NETDEV_PHY_IOCTL
+#if defined(CONFIG_NETDEV_PHY_IOCTL) || defined(CONFIG_NET_TIMESTAMP)
   int (*d_ioctl)(FAR struct net_driver_s *dev, int cmd, long arg);
 #endif
 
@@ -478,6 +727,36 @@ int ipv6_input(FAR struct net_driver_s *dev);
 int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
 int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback);
 
+/****************************************************************************
+ * Function: devif_iob_txsegs
+ *
+ * Description:
+ *   Drivers that set IFF_TXIOB may call this function from their transmit
+ *   logic to get the list of segments that make up the outgoing packet:
+ *   The headers in d_buf followed by the pieces of the payload in the I/O
+ *   buffer chain d_sndiob (if any).  Each segment may then be assigned to
+ *   one transmit descriptor.
+ *
+ *   The I/O buffers remain owned by the TCP write buffer logic.  They will
+ *   not be released until the data is ACKed, which cannot happen before the
+ *   packet has been transmitted.
+ *
+ * Parameters:
+ *   dev   - The device driver structure holding the outgoing packet
+ *   segs  - The array of segment descriptions to be filled in
+ *   nsegs - The number of entries in segs
+ *
+ * Return:
+ *   The number of segments on success; -E2BIG if the packet requires more
+ *   than nsegs segments.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IOBTX
+int devif_iob_txsegs(FAR struct net_driver_s *dev,
+                     FAR struct netdev_txseg_s *segs, int nsegs);
+#endif
+
 /****************************************************************************
  * Name: neighbor_out
  *
@@ -523,6 +802,82 @@ void neighbor_out(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/****************************************************************************
+ * Multi-queue receive
+ *
+ * A driver for hardware with several receive queues calls
+ * netdev_queue_setup() once, before netdev_register(), to register its
+ * queues.  Queue i is serviced on CPU (i % CONFIG_SMP_NCPUS).
+ *
+ * When a queue has received a packet into its q_buf, the driver sets q_len
+ * and calls netdev_queue_rxavail() (typically from its interrupt handler).
+ * The queue's q_input handler is then called on the queue's CPU with the
+ * network locked and with d_buf/d_len of the device referring to the
+ * queue's packet.  q_input passes the packet to the network (ipv4_input(),
+ * etc.) and sends any response left in d_buf, just as the single-queue
+ * receive path does.  The work item is free again when q_input returns.
+ *
+ * Hardware without an RSS hash may use netdev_flowhash() on the packet in
+ * d_buf and netdev_queue_select() to choose the queue in software.
+ *
+ ****************************************************************************/
+
+int netdev_queue_setup(FAR struct net_driver_s *dev,
+                       FAR struct netdev_queue_s *queues, int nqueues);
+int netdev_queue_rxavail(FAR struct netdev_queue_s *queue);
+uint32_t netdev_flowhash(FAR struct net_driver_s *dev);
+FAR struct netdev_queue_s *netdev_queue_select(FAR struct net_driver_s *dev,
+                                               uint32_t hash);
+#endif
+
+#ifdef CONFIG_NETDEV_NAPI
+/****************************************************************************
+ * Budgeted receive polling
+ *
+ * Instead of handling every received frame from its own interrupt, the
+ * driver's receive interrupt handler calls netdev_napi_schedule().  This
+ * disables the receive interrupt (through n_irqctl) and schedules n_poll
+ * on the work queue.  n_poll is called with the network locked and
+ * receives at most 'budget' frames.  If it used its whole budget, the
+ * work is queued again behind other pending work; otherwise the ring is
+ * empty and the receive interrupt is enabled again.
+ *
+ * The hardware must raise the receive interrupt when it is enabled while
+ * a frame is already pending (as level or latched status interrupts do),
+ * otherwise a frame arriving just before the interrupt is enabled again
+ * is not handled until the next one arrives.
+ *
+ * netdev_napi_init() takes a budget of zero to mean
+ * CONFIG_NETDEV_NAPI_BUDGET.  netdev_napi_cancel() stops the polling, for
+ * example when the interface is taken down, and leaves the receive
+ * interrupt disabled.
+ *
+ ****************************************************************************/
+
+void netdev_napi_init(FAR struct netdev_napi_s *napi, int qid, int budget,
+                      netdev_napi_poll_t poll, netdev_napi_irqctl_t irqctl,
+                      FAR void *arg);
+int netdev_napi_schedule(FAR struct netdev_napi_s *napi);
+void netdev_napi_cancel(FAR struct netdev_napi_s *napi);
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMP
+/****************************************************************************
+ * Name: netdev_txtimestamp
+ *
+ * Description:
+ *   Report the hardware transmit time of a frame.  'req' is the value of
+ *   d_txtsreq that the driver saved when it took the frame.  The time is
+ *   then returned to the sender by recvmsg() with MSG_ERRQUEUE.
+ *
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void netdev_txtimestamp(FAR void *req, FAR const struct timespec *ts);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -53,6 +53,7 @@
  ****************************************************************************/
 
 #define TUNSETIFF        _SIOC(0x1001)
+#define TUNSETLOWAT      _SIOC(0x1002)  /* arg: POLLIN low watermark (packets) */
 
 /* TUNSETIFF ifr flags */
 
@@ -60,6 +61,16 @@
 #define IFF_TAP          0x02
 #define IFF_MASK         0x7f
 #define IFF_NO_PI        0x80
+#define IFF_BATCH        0x0100 /* Multiple packets per read/write */
+
+/* Batched I/O (IFF_BATCH, CONFIG_TUN_BATCH).  Each packet in a read() or
+ * write() buffer is preceded by its length as a 16-bit value in host byte
+ * order and padded so that the next record starts on a 4-byte boundary.
+ * TUN_BATCH_RECLEN gives the size of the record holding an n-byte packet.
+ */
+
+#define TUN_BATCH_HDRLEN 2
+#define TUN_BATCH_RECLEN(n) (((n) + TUN_BATCH_HDRLEN + 3) & ~3)
 
 /****************************************************************************
  * Public Type Definitions
@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -70,6 +71,14 @@
 #define NXBE_ISBLOCKED(wnd)  (((wnd)->flags & NXBE_WINDOW_BLOCKED) != 0)
 #define NXBE_SETBLOCKED(wnd) do { (wnd)->flags |= NXBE_WINDOW_BLOCKED; } while (0)
 
+/* A window is RAM backed if it has an off-screen copy (CONFIG_NX_RAMBACKED) */
+
+#ifdef CONFIG_NX_RAMBACKED
+#  define NXBE_ISRAMBACKED(wnd) ((wnd)->wpinfo[0].fbmem != NULL)
+#else
+#  define NXBE_ISRAMBACKED(wnd) (false)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -107,6 +116,15 @@ struct nxbe_window_s
 
   struct nxgl_rect_s bounds;          /* The bounding rectangle of window */
 
+#ifdef CONFIG_NX_RAMBACKED
+  /* The off-screen copy of the window, one per color plane.  These
+   * describe memory the size of the window that is drawn with window
+   * relative coordinates.  fbmem is NULL if the window has no copy.
+   */
+
+  NX_PLANEINFOTYPE wpinfo[CONFIG_NX_NPLANES];
+#endif
+
   /* Window flags (see the NXBE_* bit definitions above) */
 
 #ifdef CONFIG_NX_MULTIUSER            /* Currently used only in multi-user mode */
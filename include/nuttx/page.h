@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <stdint.h>
 #  include <stdbool.h>
 #  include <nuttx/sched.h>
 #endif
@@ -221,8 +222,17 @@
  *   the (asynchronous) page fill logic.  If the fill takes longer than this
  *   number if microseconds, then a fatal error will be declared.
  *   Default: No timeouts monitored.
+ * CONFIG_PAGING_PREFETCH - If page faults occur on consecutive pages, also
+ *   fill the following pages when there are no other pending page fills.
+ *   Requires CONFIG_PAGING_BLOCKINGFILL.  Default: Undefined.
+ * CONFIG_PAGING_PREFETCH_NPAGES - The number of pages to prefetch.
+ *   Default: 2.
  */
 
+#if defined(CONFIG_PAGING_PREFETCH) && !defined(CONFIG_PAGING_PREFETCH_NPAGES)
+#  define CONFIG_PAGING_PREFETCH_NPAGES 2
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -256,6 +266,9 @@ extern "C"
  *        thread.  The page fill worker thread is how the page fault
  *        is resolved and all logic associated with the page fill worker
  *        must be "locked" and always present in memory.
+ *      - Call up_checkmapping() to see if the mapping is already in place
+ *        (or can be restored without a fill).  If so, just return so that
+ *        the faulting instruction is retried.
  *   2) Block the currently executing task.
  *      - Call up_block_task() to block the task at the head of the ready-
  *        to-run list.  This should cause an interrupt level context switch
@@ -325,6 +338,12 @@ void pg_miss(void);
  *  may occur on several threads and be queued multiple times. This function
  *  will prevent the same page from be filled multiple times.
  *
+ *  If the page replacement logic removes the mapping of resident pages in
+ *  order to detect references to them, this function should also restore
+ *  such a mapping (and note the reference) and return true.  No page fill
+ *  is then needed.  This function is called from pg_miss() at the level of
+ *  the exception handler as well as from the page fill worker thread.
+ *
  * Input Parameters:
  *   tcb - A reference to the task control block of the task that we believe
  *         needs to have a page fill.  Architecture-specific logic can
@@ -339,10 +358,10 @@ void pg_miss(void);
  *   interpreted as fatal.
  *
  * Assumptions:
- *   - This function is called from the normal tasking context (but with
- *     interrupts disabled).  The implementation must take whatever actions
- *     are necessary to assure that the operation is safe within this
- *     context.
+ *   - This function is called with interrupts disabled, either from the
+ *     exception handler or from the normal tasking context.  The
+ *     implementation must take whatever actions are necessary to assure
+ *     that the operation is safe within these contexts.
  *
  ****************************************************************************/
 
@@ -399,6 +418,35 @@ bool up_checkmapping(FAR struct tcb_s *tcb);
 
 int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage);
 
+/****************************************************************************
+ * Name: up_prefetchpage()
+ *
+ * Description:
+ *  This function is the same as up_allocpage() except that the page is
+ *  set aside and mapped for the virtual address, vaddr, rather than for the
+ *  miss address of a task.  It is used to prefetch the pages following a
+ *  sequential page fault.  The page is then filled by up_fillpage() with a
+ *  NULL TCB.
+ *
+ * Input Parameters:
+ *   vaddr - The virtual address to be mapped
+ *   vpage - The location to return the virtual address of the allocated
+ *           page
+ *
+ * Returned Value:
+ *   Zero (OK) if a page was allocated and must be filled.  -EEXIST if the
+ *   page is already mapped and -ERANGE if vaddr does not lie in the paged
+ *   text region.  In these cases, no page is allocated.
+ *
+ * Assumptions:
+ *   - Same as for up_allocpage().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_PREFETCH
+int up_prefetchpage(uintptr_t vaddr, FAR void **vpage);
+#endif
+
 /****************************************************************************
  * Name: up_fillpage()
  *
@@ -429,7 +477,12 @@ int up_allocpage(FAR struct tcb_s *tcb, FAR void **vpage);
  *   tcb - A reference to the task control block of the task that needs to
  *         have a page fill.  Architecture-specific logic can retrieve page
  *         fault information from the architecture-specific context
- *         information in this TCB to perform the fill.
+ *         information in this TCB to perform the fill.  If
+ *         CONFIG_PAGING_PREFETCH is selected, tcb will be NULL when the page
+ *         is being prefetched.  The data to be loaded should therefore be
+ *         determined from vpage.
+ *   vpage - The virtual address of the page to be filled (as returned by
+ *         up_allocpage() or up_prefetchpage()).
  *   pg_callbck - The function to be called when the page fill is complete.
  *
  * Returned Value:
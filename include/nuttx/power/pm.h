@@ -226,6 +226,20 @@
                                              */
 #endif
 
+/* Wake-up latencies of the reduced power states (in microseconds) */
+
+#ifndef CONFIG_PM_IDLE_LATENCY
+#  define CONFIG_PM_IDLE_LATENCY        0
+#endif
+
+#ifndef CONFIG_PM_STANDBY_LATENCY
+#  define CONFIG_PM_STANDBY_LATENCY     1000
+#endif
+
+#ifndef CONFIG_PM_SLEEP_LATENCY
+#  define CONFIG_PM_SLEEP_LATENCY       10000
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -127,6 +127,59 @@ EXTERN const pthread_attr_t g_default_pthread_attr;
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Block the calling thread if, and only if, the word at 'uaddr' still
+ *   holds the value 'val'.  The test and the start of the wait are atomic
+ *   with respect to futex_wake().  This is the blocking half of the
+ *   user-space pthread mutexes and condition variables.
+ *
+ * Input Parameters:
+ *   uaddr   - The address of the futex word
+ *   val     - The value that the caller last saw in the word
+ *   abstime - If non-NULL, the CLOCK_REALTIME time at which to give up
+ *
+ * Returned Value:
+ *   Zero (OK) if awakened by futex_wake().  Otherwise -1 (ERROR) with errno
+ *   set to EAGAIN (the word no longer holds 'val'), EINTR or ETIMEDOUT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_FUTEX
+int futex_wait(FAR volatile int *uaddr, int val,
+               FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake up to 'nwake' threads blocked in futex_wait() on 'uaddr'.
+ *
+ * Returned Value:
+ *   The number of threads awakened.
+ *
+ ****************************************************************************/
+
+int futex_wake(FAR volatile int *uaddr, int nwake);
+
+/****************************************************************************
+ * Name: futex_requeue
+ *
+ * Description:
+ *   Wake up to 'nwake' threads blocked in futex_wait() on 'uaddr' and move
+ *   up to 'nrequeue' of the others so that they wait on 'uaddr2' instead.
+ *
+ * Returned Value:
+ *   The number of threads awakened or requeued.
+ *
+ ****************************************************************************/
+
+int futex_requeue(FAR volatile int *uaddr, int nwake,
+                  FAR volatile int *uaddr2, int nrequeue);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
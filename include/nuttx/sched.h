@@ -142,15 +142,17 @@
 #  define TCB_FLAG_TTYPE_KERNEL    (2 << TCB_FLAG_TTYPE_SHIFT)  /* Kernel thread */
 #define TCB_FLAG_NONCANCELABLE     (1 << 2) /* Bit 2: Pthread is non-cancelable */
 #define TCB_FLAG_CANCEL_PENDING    (1 << 3) /* Bit 3: Pthread cancel is pending */
-#define TCB_FLAG_POLICY_SHIFT      (4) /* Bit 4-5: Scheduling policy */
-#define TCB_FLAG_POLICY_MASK       (3 << TCB_FLAG_POLICY_SHIFT)
+#define TCB_FLAG_POLICY_SHIFT      (4) /* Bit 4-6: Scheduling policy */
+#define TCB_FLAG_POLICY_MASK       (7 << TCB_FLAG_POLICY_SHIFT)
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT) /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT) /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT) /* Sporadic scheding policy */
 #  define TCB_FLAG_SCHED_OTHER     (3 << TCB_FLAG_POLICY_SHIFT) /* Other scheding policy */
-#define TCB_FLAG_CPU_LOCKED        (1 << 6) /* Bit 6: Locked to this CPU */
-#define TCB_FLAG_EXIT_PROCESSING   (1 << 7) /* Bit 7: Exitting */
-                                            /* Bits 8-15: Available */
+#  define TCB_FLAG_SCHED_DEADLINE  (4 << TCB_FLAG_POLICY_SHIFT) /* Deadline scheding policy */
+#define TCB_FLAG_CPU_LOCKED        (1 << 7) /* Bit 7: Locked to this CPU */
+#define TCB_FLAG_EXIT_PROCESSING   (1 << 8) /* Bit 8: Exitting */
+#define TCB_FLAG_SEM_REQUEUED      (1 << 9) /* Bit 9: Semaphore wait was requeued */
+                                            /* Bits 10-15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -175,6 +177,13 @@
 #define SPORADIC_FLAG_ALLOCED      (1 << 0)  /* Bit 0: Timer is allocated */
 #define SPORADIC_FLAG_MAIN         (1 << 1)  /* Bit 1: The main timer */
 #define SPORADIC_FLAG_REPLENISH    (1 << 2)  /* Bit 2: Replenishment cycle */
+
+/* Values for struct deadline_s flags */
+
+#define DEADLINE_FLAG_DONE         (1 << 0)  /* Bit 0: Job completed */
+#define DEADLINE_FLAG_THROTTLED    (1 << 1)  /* Bit 1: Budget exhausted */
+#define DEADLINE_FLAG_MISSED       (1 << 2)  /* Bit 2: Deadline miss reported */
+#define DEADLINE_FLAG_RELEASE      (1 << 3)  /* Bit 3: Timer set for next release */
                                              /* Bits 3-7: Available */
 
 /********************************************************************************
@@ -306,6 +315,54 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s *************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure.  It is
+ * allocated when the deadline scheduling policy is assigned to a thread.  The
+ * thread executes as a sequence of jobs.  A new job is released each period
+ * and must complete (by calling sched_yield()) before its deadline.
+ */
+
+struct deadline_s
+{
+  FAR struct tcb_s *tcb;            /* The parent TCB structure                 */
+  struct wdog_s timer;              /* Deadline and release timer               */
+  sem_t     waitsem;                /* Completed job waits here for release     */
+  uint8_t   priority;               /* Priority while budget remains            */
+  uint8_t   flags;                  /* See DEADLINE_FLAG_* definitions          */
+  uint16_t  util;                   /* Admitted utilization (per mille)         */
+  uint32_t  runtime;                /* Execution budget of each job             */
+  uint32_t  deadline;               /* Relative deadline of each job            */
+  uint32_t  period;                 /* Job release period                       */
+  int32_t   budget;                 /* Budget remaining in the current job      */
+  systime_t release;                /* Release time of the current job          */
+  systime_t abstime;                /* Absolute deadline of the current job     */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
+/* struct wakelat_hist_s *********************************************************/
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+
+/* This structure holds a histogram of wake-up latencies:  The time from when a
+ * thread is made ready-to-run until it runs, in units of up_perf_gettime().
+ * Bucket n counts the latencies below 2^n microseconds (and at least 2^(n-1));
+ * the last bucket counts all longer latencies.
+ */
+
+struct wakelat_hist_s
+{
+  uint32_t  count;                  /* Number of wake-ups measured              */
+  uint32_t  maxtime;                /* Longest latency                          */
+  uint64_t  total;                  /* Sum of all latencies                     */
+  uint32_t  bucket[CONFIG_SCHED_WAKEUPLAT_NBUCKETS];
+};
+
+#endif /* CONFIG_SCHED_WAKEUPLAT */
+
 /* struct child_status_s *********************************************************/
 /* This structure is used to maintain information about child tasks.  pthreads
  * work differently, they have join information.  This is only for child tasks.
@@ -451,6 +508,10 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+  sigset_t   tg_sigpendset;         /* Set of signals in tg_sigpendingq         */
+#ifdef CONFIG_SIG_ACTIONTABLE
+  FAR struct sigactq *tg_sigaction[MAX_SIGNO + 1]; /* Actions by signal number */
+#endif
 #endif
 
 #ifndef CONFIG_DISABLE_ENVIRON
@@ -520,6 +581,9 @@ struct task_group_s
  */
 
 FAR struct wdog_s;                       /* Forward reference                   */
+#ifdef CONFIG_HRTIMER
+FAR struct hrtimer_s;                    /* Forward reference                   */
+#endif
 
 struct tcb_s
 {
@@ -557,6 +621,7 @@ struct tcb_s
   uint8_t  pend_reprios[CONFIG_SEM_NNESTPRIO];
 #endif
   uint8_t  base_priority;                /* "Normal" priority of the thread     */
+  FAR struct semholder_s *holdsem;       /* List of semaphores held            */
 #endif
 
   uint8_t  task_state;                   /* Current state of the thread         */
@@ -566,9 +631,27 @@ struct tcb_s
 #endif
   uint16_t flags;                        /* Misc. general status flags          */
   int16_t  lockcount;                    /* 0=preemptable (not-locked)          */
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_CRITMONITOR)
   int16_t  irqcount;                     /* 0=interrupts enabled                */
 #endif
+#ifdef CONFIG_NET_FINELOCK
+  uint8_t  netshared;                    /* Nesting count of netdev_lock()      */
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  uint32_t premp_start;                  /* Time when preemption disabled       */
+  uint32_t crit_start;                   /* Time critical section entered       */
+  FAR void *premp_caller;                /* Caller of outermost sched_lock()    */
+  FAR void *crit_caller;                 /* Caller of outermost csection entry  */
+#endif
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+  uint32_t wake_start;                   /* Time when made ready-to-run         */
+  pid_t    wake_runner;                  /* Thread running at that time         */
+  bool     wake_pending;                 /* Waiting to run after a wake-up      */
+  bool     wake_locked;                  /* Runner had pre-emption disabled     */
+  struct wakelat_hist_s wake_hist;       /* Wake-up latencies of this thread    */
+#endif
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
   int32_t  timeslice;                    /* RR timeslice OR Sporadic budget     */
@@ -577,8 +660,14 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters      */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters      */
+#endif
 
   FAR struct wdog_s *waitdog;            /* All timed waits use this timer      */
+#ifdef CONFIG_HRTIMER
+  FAR struct hrtimer_s *waithrtimer;     /* sigtimedwait() uses this timer      */
+#endif
 
   /* Stack-Related Fields *******************************************************/
 
@@ -589,6 +678,23 @@ struct tcb_s
                                          /* Need to deallocate stack            */
   FAR void *adj_stack_ptr;               /* Adjusted stack_alloc_ptr for HW     */
                                          /* The initial stack pointer value     */
+#ifdef CONFIG_SCHED_TCBPOOL
+  size_t    pool_stacksize;              /* Requested stack size (TCB pool)     */
+#endif
+
+  /* Thread Local Storage *******************************************************/
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+  FAR void *tls_pointer;                 /* Thread pointer: TLS block (__thread)*/
+#endif
+
+  /* Heap Accounting Fields *****************************************************/
+
+#ifdef CONFIG_MM_TRACE
+  size_t    heap_live;                   /* Heap memory currently allocated     */
+  size_t    heap_peak;                   /* Peak value of heap_live             */
+  uint32_t  heap_nallocs;                /* Number of allocations made          */
+#endif
 
   /* External Module Support ****************************************************/
 
@@ -599,6 +705,9 @@ struct tcb_s
   /* POSIX Semaphore Control Fields *********************************************/
 
   sem_t *waitsem;                        /* Semaphore ID waiting on             */
+#ifndef CONFIG_DISABLE_PTHREAD
+  sem_t *condmutex;                      /* Mutex released by pthread_cond_wait */
+#endif
 
   /* POSIX Signal Control Fields ************************************************/
 
@@ -614,6 +723,11 @@ struct tcb_s
 
 #ifndef CONFIG_DISABLE_MQUEUE
   FAR struct mqueue_inode_s *msgwaitq;   /* Waiting for this message queue      */
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  FAR char *msgbuffer;                   /* Receive buffer for direct hand-off  */
+  ssize_t msglen;                        /* Length of message handed off or -1  */
+  uint8_t msgprio;                       /* Priority of message handed off      */
+#endif
 #endif
 
   /* Library related fields *****************************************************/
@@ -816,7 +930,9 @@ void task_vforkabort(FAR struct task_tcb_s *child, int errcode);
  ********************************************************************************/
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
-    defined(CONFIG_SCHED_INSTRUMENTATION)
+    defined(CONFIG_SCHED_INSTRUMENTATION) || defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_CPULOAD_PERFCOUNT) || defined(CONFIG_LIB_SYSCALL_VDSO) || \
+    defined(CONFIG_SCHED_THREAD_LOCAL) || defined(CONFIG_SCHED_WAKEUPLAT)
 void sched_resume_scheduler(FAR struct tcb_s *tcb);
 #else
 #  define sched_resume_scheduler(tcb)
@@ -838,12 +954,35 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb);
  *
  ********************************************************************************/
 
-#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION)
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION) || \
+    defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
 void sched_suspend_scheduler(FAR struct tcb_s *tcb);
 #else
 #  define sched_suspend_scheduler(tcb)
 #endif
 
+/********************************************************************************
+ * Name: sched_resched_process
+ *
+ * Description:
+ *   Called by architecture specific interrupt handling logic just before
+ *   returning from each interrupt.  If another CPU has requested that this
+ *   CPU reschedule (see up_cpu_resched()), then pull the highest priority,
+ *   ready-to-run task that may run on this CPU onto this CPU, performing
+ *   an interrupt level context switch if necessary.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ********************************************************************************/
+
+#ifdef CONFIG_SMP_RESCHED_IPI
+void sched_resched_process(void);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -47,9 +47,30 @@
 #include <stdbool.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/fs/ioctl.h>
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL commands supported by the /dev/note driver.  Note time stamps are
+ * in units of up_perf_gettime() if the architecture provides that counter
+ * (CONFIG_ARCH_HAVE_PERF_EVENTS) or of system timer ticks otherwise.
+ *
+ * NOTEIOC_GETFREQ    - Get the rate of the note time stamps in Hz.
+ *                      Argument: A reference to a uint32_t value.
+ * NOTEIOC_GETOVERRUN - Get the number of notes dropped because the buffer
+ *                      was full.
+ *                      Argument: A reference to a uint32_t value.
+ */
+
+#ifdef CONFIG_DRIVER_NOTE
+#  define NOTEIOC_GETFREQ    _NOTEIOC(0x0001)
+#  define NOTEIOC_GETOVERRUN _NOTEIOC(0x0002)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -74,6 +95,19 @@ enum note_type_e
   NOTE_CSECTION_ENTER,
   NOTE_CSECTION_LEAVE
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  ,
+  NOTE_DEADLINE_MISS
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+  ,
+  NOTE_IRQ_ENTER,
+  NOTE_IRQ_LEAVE
+#endif
+#ifdef CONFIG_SCHED_WAKEUPLAT
+  ,
+  NOTE_WAKEUP_LATENCY
+#endif
 };
 
 /* This structure provides the common header of each note */
@@ -143,6 +177,40 @@ struct note_csection_s
 #endif
 };
 #endif /* CONFIG_SCHED_INSTRUMENTATION_CSECTION */
+
+#ifdef CONFIG_SCHED_DEADLINE
+/* This is the specific form of the NOTE_DEADLINE_MISS note */
+
+struct note_deadline_s
+{
+  struct note_common_s ndl_cmn; /* Common note parameters */
+  uint8_t ndl_lateness[4];      /* Ticks past the deadline */
+};
+#endif /* CONFIG_SCHED_DEADLINE */
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+/* This is the specific form of the NOTE_IRQ_ENTER/LEAVE note.  The common
+ * parameters describe the task that was interrupted.
+ */
+
+struct note_irqhandler_s
+{
+  struct note_common_s nih_cmn; /* Common note parameters */
+  uint8_t nih_irq[2];           /* IRQ number */
+};
+#endif /* CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER */
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+/* This is the specific form of the NOTE_WAKEUP_LATENCY note.  The common
+ * parameters describe the task that was woken up.
+ */
+
+struct note_wakeup_s
+{
+  struct note_common_s nwu_cmn; /* Common note parameters */
+  uint8_t nwu_latency[4];       /* In units of up_perf_gettime() */
+};
+#endif /* CONFIG_SCHED_WAKEUPLAT */
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
 
 /****************************************************************************
@@ -182,12 +250,29 @@ void sched_note_premption(FAR struct tcb_s *tcb, bool locked);
 void sched_note_csection(FAR struct tcb_s *tcb, bool enter);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+void sched_note_deadline(FAR struct tcb_s *tcb, uint32_t lateness);
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+void sched_note_irqhandler(int irq, FAR void *handler, bool enter);
+#endif
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+void sched_note_wakeup(FAR struct tcb_s *tcb, uint32_t latency);
+#endif
+
 /****************************************************************************
  * Name: sched_note_get
  *
  * Description:
  *   Remove the next note from the tail of the circular buffer.  The note
  *   is also removed from the circular buffer to make room for futher notes.
+ *   In SMP, there is one circular buffer per CPU and the oldest note of
+ *   all CPUs is returned.
+ *
+ *   Only one consumer may use sched_note_get(), sched_note_size() and
+ *   sched_note_read() at a time; the caller must serialize them.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -223,6 +308,39 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen);
 ssize_t sched_note_size(void);
 #endif
 
+/****************************************************************************
+ * Name: sched_note_read
+ *
+ * Description:
+ *   Remove as many complete notes as will fit into the user buffer.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the notes
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   The number of bytes returned; zero if the circular buffer is empty.
+ *   -EFBIG is returned if the first note does not fit into the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_BUFFER
+ssize_t sched_note_read(FAR uint8_t *buffer, size_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: sched_note_overrun
+ *
+ * Description:
+ *   Return the number of notes that were dropped because the circular
+ *   buffer was full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_BUFFER
+uint32_t sched_note_overrun(void);
+#endif
+
 /****************************************************************************
  * Name: note_register
  *
@@ -252,6 +370,9 @@ int note_register(void);
 #  define sched_note_resume(t)
 #  define sched_note_premption(t,l)
 #  define sched_note_csection(t,e)
+#  define sched_note_deadline(t,l)
+#  define sched_note_irqhandler(i,h,e)
+#  define sched_note_wakeup(t,l)
 
 #endif /* CONFIG_SCHED_INSTRUMENTATION */
 #endif /* __INCLUDE_NUTTX_SCHED_NOTE_H */
@@ -133,6 +133,31 @@ int sem_tickwait(FAR sem_t *sem, systime_t start, uint32_t delay);
 
 int sem_reset(FAR sem_t *sem, int16_t count);
 
+/****************************************************************************
+ * Name: sem_setname
+ *
+ * Description:
+ *   Give a name to a semaphore and start collecting its contention
+ *   statistics (see /proc/locks).  Naming a semaphore that already has a
+ *   name renames it and clears its statistics.  The name is not copied and
+ *   must persist for as long as the semaphore.  The statistics are
+ *   released by sem_destroy().  A pthread mutex is named by naming the
+ *   semaphore within it.
+ *
+ * Parameters:
+ *   sem  - Semaphore descriptor
+ *   name - The name to report the statistics under
+ *
+ * Return Value:
+ *   0 (OK) or a negated errno value if unsuccessful.  -ENOMEM is returned
+ *   if CONFIG_SCHED_LOCKSTAT_NLOCKS semaphores are already named.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+int sem_setname(FAR sem_t *sem, FAR const char *name);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
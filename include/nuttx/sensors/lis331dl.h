@@ -202,6 +202,27 @@ int lis331dl_getsamplerate(FAR struct lis331dl_dev_s * dev);
 FAR const struct lis331dl_vector_s *
   lis331dl_getreadings(FAR struct lis331dl_dev_s * dev);
 
+/************************************************************************************
+ * Name: lis331dl_register
+ *
+ * Description:
+ *   Register the device with the common sensor upper half as 'devpath'.  read()
+ *   then returns timestamped struct sensor_event_xyz_s events in units of [mg],
+ *   sampled at the interval selected by SNIOC_SET_INTERVAL.
+ *
+ * Input Parameters:
+ *   devpath - The full path to the driver to register, e.g., "/dev/accel0"
+ *   dev     - Device to LIS331DL device structure, as returned by lis331dl_init()
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+int lis331dl_register(FAR const char *devpath, FAR struct lis331dl_dev_s *dev);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,275 @@
+/****************************************************************************
+ * include/nuttx/sensors/sensor.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SENSORS_SENSOR_H
+#define __INCLUDE_NUTTX_SENSORS_SENSOR_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifdef CONFIG_SENSORS_UPPERHALF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************
+ * CONFIG_SENSORS_UPPERHALF - Enables the common sensor upper half
+ * CONFIG_SENSORS_NEVENTS - Default size of the event buffer of a sensor
+ * CONFIG_SENSORS_NPOLLWAITERS - Maximum number of threads that can be
+ *   waiting on poll() for a sensor
+ */
+
+#ifndef CONFIG_SENSORS_NEVENTS
+#  define CONFIG_SENSORS_NEVENTS 16
+#endif
+
+#ifndef CONFIG_SENSORS_NPOLLWAITERS
+#  define CONFIG_SENSORS_NPOLLWAITERS 2
+#endif
+
+/* IOCTL commands common to all sensors that use the sensor upper half.
+ * These are numbered above the driver specific commands.  Any other
+ * command is passed to the control() method of the lower half.
+ */
+
+/* Command:     SNIOC_ACTIVATE
+ * Description: Enable or disable sampling.  Sampling is also enabled when
+ *              the device is first opened and disabled when it is last
+ *              closed.
+ * Argument:    true to enable; false to disable
+ */
+
+#define SNIOC_ACTIVATE      _SNIOC(0x0080)
+
+/* Command:     SNIOC_SET_INTERVAL
+ * Description: Set the sampling interval (the inverse of the output data
+ *              rate).  The lower half may adjust the interval to the
+ *              nearest one supported and returns the actual interval.
+ * Argument:    A pointer to a uint32_t interval in microseconds
+ */
+
+#define SNIOC_SET_INTERVAL  _SNIOC(0x0081)
+
+/* Command:     SNIOC_SET_WATERMARK
+ * Description: Set the number of buffered events at which poll() reports
+ *              the device as readable and blocked readers are woken up.
+ * Argument:    The number of events (1 .. the buffer size)
+ */
+
+#define SNIOC_SET_WATERMARK _SNIOC(0x0082)
+
+/* Command:     SNIOC_GET_INFO
+ * Description: Get the event size, buffer size and sampling interval.
+ * Argument:    A pointer to an instance of struct sensor_info_s
+ */
+
+#define SNIOC_GET_INFO      _SNIOC(0x0083)
+
+/* Command:     SNIOC_FLUSH
+ * Description: Discard all buffered events.
+ * Argument:    None
+ */
+
+#define SNIOC_FLUSH         _SNIOC(0x0084)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Every event begins with a timestamp in microseconds of system time (as
+ * returned by sensor_timestamp()).  Events with a FIFO are timestamped
+ * individually by the lower half, usually by working back from the time of
+ * the FIFO interrupt using the sampling interval.
+ */
+
+struct sensor_event_s
+{
+  uint64_t timestamp;         /* Time of the sample (microseconds) */
+};
+
+/* Common event formats.  The units are defined by the sensor type, e.g.
+ * milli-g for accelerometers.
+ */
+
+struct sensor_event_xyz_s
+{
+  uint64_t timestamp;         /* Time of the sample (microseconds) */
+  int32_t x;                  /* X axis */
+  int32_t y;                  /* Y axis */
+  int32_t z;                  /* Z axis */
+};
+
+struct sensor_event_scalar_s
+{
+  uint64_t timestamp;         /* Time of the sample (microseconds) */
+  int32_t value;              /* The measurement */
+};
+
+/* Returned by SNIOC_GET_INFO */
+
+struct sensor_info_s
+{
+  uint16_t esize;             /* Size of one event in bytes */
+  uint16_t nevents;           /* Number of events that can be buffered */
+  uint32_t interval;          /* Sampling interval (microseconds) */
+};
+
+/* This is the interface between the sensor upper half and the sensor
+ * specific lower half.  The lower half delivers samples by calling
+ * sensor_push(), from interrupt level or from a work queue, with one or
+ * more events (for example, the whole content of the hardware FIFO).
+ * Sensors without an interrupt instead provide the fetch() method, which
+ * the upper half calls periodically while sampling is enabled.
+ */
+
+struct sensor_lowerhalf_s;
+struct sensor_ops_s
+{
+  /* Enable or disable sampling (required) */
+
+  CODE int (*activate)(FAR struct sensor_lowerhalf_s *lower, bool enable);
+
+  /* Set the sampling interval in microseconds and return the actual
+   * interval (optional).
+   */
+
+  CODE int (*set_interval)(FAR struct sensor_lowerhalf_s *lower,
+                           FAR uint32_t *interval);
+
+  /* Read the hardware and push any new events (optional) */
+
+  CODE int (*fetch)(FAR struct sensor_lowerhalf_s *lower);
+
+  /* Sensor specific IOCTL commands (optional) */
+
+  CODE int (*control)(FAR struct sensor_lowerhalf_s *lower, int cmd,
+                      unsigned long arg);
+};
+
+/* The lower half state.  Normally the lower half has its own, custom state
+ * structure that begins with this one.
+ */
+
+struct sensor_lowerhalf_s
+{
+  FAR const struct sensor_ops_s *ops; /* Lower half methods */
+  uint16_t esize;             /* Size of one event in bytes */
+  uint16_t nevents;           /* Buffer size in events (0: default) */
+  uint32_t interval;          /* Initial sampling interval (microseconds) */
+
+  /* Set by the upper half when the sensor is registered */
+
+  FAR void *upper;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: sensor_register
+ *
+ * Description:
+ *   Bind a sensor lower half to a new instance of the sensor upper half and
+ *   register the character driver as 'devpath'.
+ *
+ * Input Parameters:
+ *   devpath - The full path to the driver to register, e.g., "/dev/accel0"
+ *   lower   - An instance of the lower half interface
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sensor_register(FAR const char *devpath,
+                    FAR struct sensor_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: sensor_push
+ *
+ * Description:
+ *   Add events to the buffer of a sensor.  If the buffer is full, the
+ *   oldest events are discarded.  This may be called from interrupt level.
+ *
+ * Input Parameters:
+ *   lower   - The lower half that produced the events
+ *   events  - The events, each lower->esize bytes and beginning with a
+ *             struct sensor_event_s
+ *   nevents - The number of events
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sensor_push(FAR struct sensor_lowerhalf_s *lower,
+                 FAR const void *events, size_t nevents);
+
+/****************************************************************************
+ * Name: sensor_timestamp
+ *
+ * Description:
+ *   Return the current system time in microseconds for use as an event
+ *   timestamp.
+ *
+ ****************************************************************************/
+
+uint64_t sensor_timestamp(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SENSORS_UPPERHALF */
+#endif /* __INCLUDE_NUTTX_SENSORS_SENSOR_H */
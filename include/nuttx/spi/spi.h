@@ -463,6 +463,12 @@ enum spi_mode_e
 typedef uint8_t spi_hwfeatures_t;
 #endif
 
+#ifdef CONFIG_SPI_TRANSFER
+/* See include/nuttx/spi/spi_transfer.h */
+
+struct spi_sequence_s;
+#endif
+
 /* The SPI vtable */
 
 struct spi_dev_s;
@@ -500,6 +506,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_TRANSFER
+  CODE int      (*transfer)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_sequence_s *seq);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
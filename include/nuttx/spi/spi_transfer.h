@@ -0,0 +1,135 @@
+/****************************************************************************
+ * include/nuttx/spi/spi_transfer.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SPI_SPI_TRANSFER_H
+#define __INCLUDE_NUTTX_SPI_SPI_TRANSFER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/spi/spi.h>
+
+#ifdef CONFIG_SPI_TRANSFER
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This describes one segment of a transfer: A single exchange with the
+ * selected device, optionally followed by a de-selection of the device and
+ * a delay.
+ */
+
+struct spi_trans_s
+{
+  FAR const void *txbuffer;   /* Data to send (NULL: send dummy words) */
+  FAR void *rxbuffer;         /* Location to receive data (NULL: discard) */
+  size_t nwords;              /* Number of words to exchange */
+  useconds_t delay;           /* Microsecond delay after the segment */
+#ifdef CONFIG_SPI_CMDDATA
+  bool cmd;                   /* true=command; false=data */
+#endif
+  bool deselect;              /* De-select the device after the segment */
+};
+
+/* This describes a sequence of segments with one device.  All segments use
+ * the same mode, word width and frequency.  Sequences for several devices
+ * on the same bus may be linked through the flink field and are then
+ * executed back-to-back while the bus is locked once.
+ */
+
+struct spi_sequence_s
+{
+  FAR struct spi_sequence_s *flink; /* Next sequence on the bus or NULL */
+  FAR struct spi_trans_s *trans;    /* Array of segments */
+  uint32_t dev;                     /* Device ID (enum spi_dev_e) */
+  uint32_t frequency;               /* SPI frequency (Hz) */
+  uint8_t mode;                     /* Mode (enum spi_mode_e) */
+  uint8_t nbits;                    /* Number of bits per word */
+  uint8_t ntrans;                   /* Number of segments */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: spi_transfer
+ *
+ * Description:
+ *   Execute a chain of SPI sequences.  The bus is locked once for the whole
+ *   chain.  If the SPI lower half provides the transfer() method, then the
+ *   chain is passed to it so that it may run the segments back-to-back
+ *   (for example, as one chain of DMA descriptors).  Otherwise, each
+ *   segment is performed with the select() and exchange() methods.
+ *
+ *   The device is selected at the beginning of each sequence and
+ *   de-selected at the end of the sequence and after each segment that
+ *   has the deselect flag set.
+ *
+ * Input Parameters:
+ *   spi - The SPI bus
+ *   seq - The first sequence of the chain
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SPI_TRANSFER */
+#endif /* __INCLUDE_NUTTX_SPI_SPI_TRANSFER_H */
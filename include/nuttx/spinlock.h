@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef CONFIG_SPINLOCK
 
@@ -59,10 +60,99 @@
 
 #include <arch/spinlock.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The architecture specific spinlock.h header file may also provide these
+ * hints which are used while spinning:
+ *
+ *   SP_DMB() - A data memory barrier.  Required before a lock is released
+ *              on architectures with weakly ordered memory.
+ *   SP_DSB() - A data synchronization barrier.  Completes the release of a
+ *              lock before SP_SEV().
+ *   SP_WFE() - Wait (in a low power state) for an event signalled by
+ *              SP_SEV() on another CPU.
+ *   SP_SEV() - Signal an event to all CPUs.  Executed after a lock has been
+ *              released.
+ */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+#ifndef SP_DSB
+#  define SP_DSB()
+#endif
+
+#ifndef SP_WFE
+#  define SP_WFE()
+#endif
+
+#ifndef SP_SEV
+#  define SP_SEV()
+#endif
+
+/* Initial values of the fair locks */
+
+#define SP_TICKET_INITIALIZER { 0, 0 }
+#define SP_MCS_INITIALIZER    { NULL }
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* There are three kinds of spinlocks which may be selected for each lock:
+ *
+ * - spinlock_t is a simple test-and-set lock (spin_lock()/spin_unlock()).
+ *   It is the smallest and fastest when it is not contended, but it is
+ *   not fair:  Under contention, any waiting CPU may get the lock next.
+ * - struct spinlock_ticket_s is a ticket lock (spin_lock_ticket()/
+ *   spin_unlock_ticket()).  The CPUs get the lock in the order that they
+ *   asked for it, but all waiting CPUs still poll the same cache line.
+ * - struct spinlock_mcs_s is an MCS queue lock (spin_lock_mcs()/
+ *   spin_unlock_mcs()).  It is fair and each waiting CPU polls only its
+ *   own queue node, so it scales to many CPUs.  The caller provides the
+ *   node and must pass the same node when it releases the lock.
+ *
+ * The ticket and MCS locks are available only if CONFIG_SPINLOCK_TICKET or
+ * CONFIG_SPINLOCK_MCS is selected.
+ */
+
+#ifdef CONFIG_SPINLOCK_TICKET
+struct spinlock_ticket_s
+{
+  volatile uint16_t sp_next;    /* The next ticket to be taken */
+  volatile uint16_t sp_owner;   /* The ticket that holds the lock */
+};
+#endif
+
+#ifdef CONFIG_SPINLOCK_MCS
+struct spinlock_mcsnode_s
+{
+  FAR struct spinlock_mcsnode_s *volatile sp_next; /* Next waiting CPU */
+  volatile uint8_t sp_wait;     /* Non-zero while waiting for the lock */
+};
+
+struct spinlock_mcs_s
+{
+  FAR struct spinlock_mcsnode_s *volatile sp_tail; /* Last queued node */
+};
+#endif
+
+/* The lock that protects a CPU set updated by spin_setbit() and
+ * spin_clrbit().  Every CPU takes these locks whenever it enters a
+ * critical section or locks the scheduler, so they are ticket locks if
+ * CONFIG_SPINLOCK_TICKET is selected.  Zero is the unlocked state of
+ * either kind.
+ */
+
+#ifdef CONFIG_SPINLOCK_TICKET
+typedef struct spinlock_ticket_s spinlock_set_t;
+#else
+typedef spinlock_t spinlock_set_t;
+#endif
+
 struct spinlock_s
 {
   volatile spinlock_t sp_lock;  /* Indicates if the spinlock is locked or
@@ -116,7 +206,7 @@ spinlock_t up_testset(volatile FAR spinlock_t *lock);
  ****************************************************************************/
 
 /* void spin_initialize(FAR spinlock_t *lock); */
-#define spin_initialize(i) do { (l) = SPI_UNLOCKED; } while (0)
+#define spin_initialize(l) do { *(l) = SP_UNLOCKED; } while (0)
 
 /****************************************************************************
  * Name: spin_initializer
@@ -204,7 +294,15 @@ void spin_lockr(FAR struct spinlock_s *lock);
  ****************************************************************************/
 
 /* void spin_unlock(FAR spinlock_t *lock); */
-#define spin_unlock(l)  do { *(l) = SP_UNLOCKED; } while (0)
+#define spin_unlock(l) \
+  do \
+    { \
+      SP_DMB(); \
+      *(l) = SP_UNLOCKED; \
+      SP_DSB(); \
+      SP_SEV(); \
+    } \
+  while (0)
 
 /****************************************************************************
  * Name: spin_unlockr
@@ -259,6 +357,92 @@ void spin_unlockr(FAR struct spinlock_s *lock);
 /* bool spin_islockedr(FAR struct spinlock_s *lock); */
 #define spin_islockedr(l) ((l)->sp_lock == SP_LOCKED)
 
+/****************************************************************************
+ * Name: spin_lock_ticket
+ *
+ * Description:
+ *   Take a ticket and loop until the ticket holds the lock.  CPUs get the
+ *   lock in the order that they called spin_lock_ticket().
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock object to lock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_TICKET
+void spin_lock_ticket(FAR volatile struct spinlock_ticket_s *lock);
+
+/****************************************************************************
+ * Name: spin_trylock_ticket
+ *
+ * Description:
+ *   Take the ticket lock only if that is possible without waiting.
+ *
+ * Returned Value:
+ *   true if the lock was taken.
+ *
+ ****************************************************************************/
+
+bool spin_trylock_ticket(FAR volatile struct spinlock_ticket_s *lock);
+
+/****************************************************************************
+ * Name: spin_unlock_ticket
+ *
+ * Description:
+ *   Release a ticket lock, passing it to the next waiting ticket.
+ *
+ ****************************************************************************/
+
+void spin_unlock_ticket(FAR volatile struct spinlock_ticket_s *lock);
+
+/* bool spin_islocked_ticket(FAR struct spinlock_ticket_s *lock); */
+#define spin_islocked_ticket(l) ((l)->sp_next != (l)->sp_owner)
+#endif
+
+/****************************************************************************
+ * Name: spin_lock_mcs
+ *
+ * Description:
+ *   Queue the caller's node on the MCS lock and loop until the lock is
+ *   passed to it.  The node must remain valid (and must not be used for
+ *   any other lock) until spin_unlock_mcs() is called with it.  Typically
+ *   it is a local variable of the caller or a per-CPU object.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of the caller.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+void spin_lock_mcs(FAR volatile struct spinlock_mcs_s *lock,
+                   FAR struct spinlock_mcsnode_s *node);
+
+/****************************************************************************
+ * Name: spin_unlock_mcs
+ *
+ * Description:
+ *   Release an MCS lock, passing it to the next queued node (if any).
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to unlock.
+ *   node - The same queue node that was passed to spin_lock_mcs().
+ *
+ ****************************************************************************/
+
+void spin_unlock_mcs(FAR volatile struct spinlock_mcs_s *lock,
+                     FAR struct spinlock_mcsnode_s *node);
+
+/* bool spin_islocked_mcs(FAR struct spinlock_mcs_s *lock); */
+#define spin_islocked_mcs(l) ((l)->sp_tail != NULL)
+#endif
+
 /****************************************************************************
  * Name: spin_setbit
  *
@@ -277,7 +461,7 @@ void spin_unlockr(FAR struct spinlock_s *lock);
  ****************************************************************************/
 
 void spin_setbit(FAR volatile cpu_set_t *set, unsigned int cpu,
-                 FAR volatile spinlock_t *setlock,
+                 FAR volatile spinlock_set_t *setlock,
                  FAR volatile spinlock_t *orlock);
 
 /****************************************************************************
@@ -298,7 +482,7 @@ void spin_setbit(FAR volatile cpu_set_t *set, unsigned int cpu,
  ****************************************************************************/
 
 void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
-                 FAR volatile spinlock_t *setlock,
+                 FAR volatile spinlock_set_t *setlock,
                  FAR volatile spinlock_t *orlock);
 
 #endif /* CONFIG_SPINLOCK */
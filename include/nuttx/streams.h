@@ -58,6 +58,8 @@ typedef int  (*lib_getc_t)(FAR struct lib_instream_s *this);
 
 struct lib_outstream_s;
 typedef void (*lib_putc_t)(FAR struct lib_outstream_s *this, int ch);
+typedef void (*lib_puts_t)(FAR struct lib_outstream_s *this,
+                           FAR const char *buf, int len);
 typedef int  (*lib_flush_t)(FAR struct lib_outstream_s *this);
 
 struct lib_instream_s
@@ -70,6 +72,8 @@ struct lib_instream_s
 struct lib_outstream_s
 {
   lib_putc_t             put;     /* Put one character to the outstream */
+  lib_puts_t             puts;    /* Put a run of characters to the outstream.
+                                   * Optional, may be NULL */
 #ifdef CONFIG_STDIO_LINEBUFFER
   lib_flush_t            flush;   /* Flush any buffered characters in the outstream */
 #endif
@@ -193,6 +197,20 @@ struct lib_rawsostream_s
   int                    fd;
 };
 
+/* This is the stream that operates on the SYSLOG.  With
+ * CONFIG_SYSLOG_BUFFER, output is collected in a small buffer and passed
+ * to the SYSLOG channel a block at a time.
+ */
+
+struct lib_syslogstream_s
+{
+  struct lib_outstream_s public;
+#ifdef CONFIG_SYSLOG_BUFFER
+  int                    nbuf;    /* Number of bytes in the buffer */
+  char                   buffer[CONFIG_SYSLOG_BUFSIZE];
+#endif
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -362,14 +380,35 @@ void lib_nulloutstream(FAR struct lib_outstream_s *nulloutstream);
  *
  * Input parameters:
  *   stream - User allocated, uninitialized instance of struct
- *            lib_lowoutstream_s to be initialized.
+ *            lib_syslogstream_s to be initialized.
  *
  * Returned Value:
  *   None (User allocated instance initialized).
  *
  ****************************************************************************/
 
-void syslogstream(FAR struct lib_outstream_s *stream);
+void syslogstream(FAR struct lib_syslogstream_s *stream);
+
+/****************************************************************************
+ * Name: syslogstream_flush
+ *
+ * Description:
+ *   Pass any output buffered in the SYSLOG stream to the SYSLOG channel.
+ *   This must be called when the caller has finished with the stream.
+ *
+ * Input parameters:
+ *   stream - The SYSLOG stream to be flushed
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BUFFER
+void syslogstream_flush(FAR struct lib_syslogstream_s *stream);
+#else
+#  define syslogstream_flush(s)
+#endif
 
 /****************************************************************************
  * Name: emergstream
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -118,6 +120,40 @@ FAR const struct symtab_s *
 symtab_findorderedbyname(FAR const struct symtab_s *symtab,
                          FAR const char *name, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name used to place symbols in hashed symbol
+ *   tables.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHED
+uint32_t symtab_hash(FAR const char *name);
+#endif
+
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.
+ *   This version assumes that the table was generated with 'mksymtab -H'
+ *   so that the symbols are placed according to the hash of their names.
+ *   nsyms is the size of the table, including the unused entries.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHED
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms);
+#endif
+
 /****************************************************************************
  * Name: symtab_findbyvalue
  *
@@ -190,6 +190,20 @@ int ramlog_syslog_channel(void);
 int ramlog_putc(int ch);
 #endif
 
+/****************************************************************************
+ * Name: ramlog_syslog_write
+ *
+ * Description:
+ *   This is the low-level system logging interface for a buffer of data.
+ *   The whole buffer is added to the RAM log with interrupts disabled only
+ *   once.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_RAMLOG_CONSOLE) || defined(CONFIG_RAMLOG_SYSLOG)
+ssize_t ramlog_syslog_write(FAR const char *buffer, size_t buflen);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -43,6 +43,8 @@
 
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
+
+#include <sys/types.h>
 #include <stdarg.h>
 
 /****************************************************************************
@@ -106,6 +108,8 @@ enum syslog_init_e
 
 typedef CODE int (*syslog_putc_t)(int ch);
 typedef CODE int (*syslog_flush_t)(void);
+typedef CODE ssize_t (*syslog_write_t)(FAR const char *buffer,
+                                       size_t buflen);
 
 struct syslog_channel_s
 {
@@ -114,6 +118,7 @@ struct syslog_channel_s
   syslog_putc_t sc_putc;    /* Normal buffered output */
   syslog_putc_t sc_force;   /* Low-level output for interrupt handlers */
   syslog_flush_t sc_flush;  /* Flush buffered output (on crash) */
+  syslog_write_t sc_write;  /* Normal output of a buffer (may be NULL) */
 
   /* Implementation specific logic may follow */
 };
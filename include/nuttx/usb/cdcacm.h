@@ -94,6 +94,11 @@
  *   default PID.
  * CONFIG_CDCACM_RXBUFSIZE and CONFIG_CDCACM_TXBUFSIZE
  *   Size of the serial receive/transmit buffers. Default 256.
+ * CONFIG_CDCACM_BULKMODE
+ *   Support the packetized, zero-copy bulk mode IOCTLs described below.
+ * CONFIG_CDCACM_BULKOUT_REQLEN
+ *   Size of one read request buffer in bulk mode.  Should be a multiple of
+ *   the bulk OUT maxpacket size.  Default 2048 (high speed) or 512.
  */
 
 /* EP0 max packet size */
@@ -181,6 +186,18 @@
 #  define CONFIG_CDCACM_NRDREQS 4
 #endif
 
+/* Size of one read request buffer in bulk mode */
+
+#ifdef CONFIG_CDCACM_BULKMODE
+#  ifndef CONFIG_CDCACM_BULKOUT_REQLEN
+#    ifdef CONFIG_USBDEV_DUALSPEED
+#      define CONFIG_CDCACM_BULKOUT_REQLEN 2048
+#    else
+#      define CONFIG_CDCACM_BULKOUT_REQLEN 512
+#    endif
+#  endif
+#endif
+
 /* TX/RX buffer sizes */
 
 #ifndef CONFIG_CDCACM_RXBUFSIZE
@@ -261,12 +278,43 @@
  *   Argument: int.  This includes the current state of the carrier detect,
  *   DSR, break, and ring signal.  See "Table 69: UART State Bitmap Values"
  *   and CDC_UART_definitions in include/nuttx/usb/cdc.h.
+ *
+ * If CONFIG_CDCACM_BULKMODE is selected, these IOCTL commands are also
+ * supported.  They exchange whole USB requests with the application so that
+ * data is never copied through the serial driver's circular buffers.  The
+ * buffers returned are the request buffers themselves, so this is only
+ * possible in the FLAT build.
+ *
+ * CAIOC_BULKMODE
+ *   Enable (1) or disable (0) bulk mode.  Argument: int.  In bulk mode,
+ *   completed bulk OUT requests are held for CAIOC_RXPACKET instead of
+ *   being copied into the serial RX buffer, and each is re-queued with
+ *   CONFIG_CDCACM_BULKOUT_REQLEN bytes so that several maxpacket-sized
+ *   packets complete in one request.
+ * CAIOC_RXPACKET
+ *   Wait for the oldest received request.  Argument: struct
+ *   cdcacm_packet_s*.  Returns the request buffer, the number of bytes
+ *   received, and a handle.  Honors O_NONBLOCK.
+ * CAIOC_RXRELEASE
+ *   Return a request obtained by CAIOC_RXPACKET to the bulk OUT endpoint.
+ *   Argument: struct cdcacm_packet_s*.
+ * CAIOC_TXPACKET
+ *   Wait for a free write request.  Argument: struct cdcacm_packet_s*.
+ *   Returns the request buffer, its size, and a handle.  Honors O_NONBLOCK.
+ * CAIOC_TXSUBMIT
+ *   Send a request obtained by CAIOC_TXPACKET.  Argument: struct
+ *   cdcacm_packet_s* with len set to the number of bytes to send.
  */
 
 #define CAIOC_REGISTERCB    _CAIOC(0x0001)
 #define CAIOC_GETLINECODING _CAIOC(0x0002)
 #define CAIOC_GETCTRLLINE   _CAIOC(0x0003)
 #define CAIOC_NOTIFY        _CAIOC(0x0004)
+#define CAIOC_BULKMODE      _CAIOC(0x0005)
+#define CAIOC_RXPACKET      _CAIOC(0x0006)
+#define CAIOC_RXRELEASE     _CAIOC(0x0007)
+#define CAIOC_TXPACKET      _CAIOC(0x0008)
+#define CAIOC_TXSUBMIT      _CAIOC(0x0009)
 
 /****************************************************************************
  * Public Types
@@ -302,6 +350,17 @@ enum cdcacm_event_e
 
 typedef FAR void (*cdcacm_callback_t)(enum cdcacm_event_e event);
 
+#ifdef CONFIG_CDCACM_BULKMODE
+/* Describes one request exchanged by the bulk mode IOCTL commands */
+
+struct cdcacm_packet_s
+{
+  FAR uint8_t *buf;      /* The request buffer */
+  size_t       len;      /* Bytes received, buffer size, or bytes to send */
+  FAR void    *handle;   /* Identifies the request; do not modify */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
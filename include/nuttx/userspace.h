@@ -88,6 +88,7 @@
  ****************************************************************************/
 
 struct mm_heaps_s; /* Forward reference */
+struct vdso_s;     /* Forward reference */
 
  /* Every user-space blob starts with a header that provides information about
  * the blob.  The form of that header is provided by struct userspace_s.  An
@@ -132,6 +133,12 @@ struct userspace_s
 #ifdef CONFIG_LIB_USRWORK
   int (*work_usrstart)(void);
 #endif
+
+  /* User-readable kernel data */
+
+#ifdef CONFIG_LIB_SYSCALL_VDSO
+  FAR struct vdso_s *us_vdso;
+#endif
 };
 
 /****************************************************************************
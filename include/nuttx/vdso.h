@@ -0,0 +1,157 @@
+/****************************************************************************
+ * include/nuttx/vdso.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VDSO_H
+#define __INCLUDE_NUTTX_VDSO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+
+#ifdef CONFIG_LIB_SYSCALL_VDSO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The structure is written by the kernel from interrupt handlers or with
+ * interrupts disabled and read by user tasks on the same CPU (SMP is not
+ * supported).  Only the compiler must be prevented from re-ordering the
+ * accesses to it.
+ */
+
+#ifdef __GNUC__
+#  define VDSO_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#else
+#  define VDSO_BARRIER()
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This is the kernel data that user space may read without a system call.
+ * The time fields are protected by a sequence count:  The kernel makes the
+ * count odd before it modifies them and even again afterward, so a reader
+ * retries if the count was odd or changed while it was reading.  A count of
+ * zero means that the kernel has not published any data yet.
+ *
+ * The PID is rewritten every time a task is resumed, so the value read by a
+ * running task is always its own.
+ */
+
+struct vdso_s
+{
+  volatile uint32_t seq;         /* Sequence count for the time fields */
+  volatile systime_t systimer;   /* Value of clock_systimer() */
+  volatile time_t basesec;       /* Time-of-day base time (seconds) */
+  volatile long basensec;        /* Time-of-day base time (nanoseconds) */
+  volatile pid_t pid;            /* PID of the running task */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* The instance in user memory.  Its address is passed to the kernel in the
+ * us_vdso field of struct userspace_s.
+ */
+
+#ifndef __KERNEL__
+EXTERN struct vdso_s g_vdso;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __KERNEL__
+struct tcb_s; /* Forward reference */
+
+/****************************************************************************
+ * Name: sched_vdso_clock
+ *
+ * Description:
+ *   Publish the current system timer and time-of-day base time.  Called on
+ *   every timer tick and whenever the base time changes.
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler or with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_vdso_clock(void);
+
+/****************************************************************************
+ * Name: sched_vdso_resume
+ *
+ * Description:
+ *   Publish the PID of the task that is about to run.  Called from
+ *   sched_resume_scheduler().
+ *
+ ****************************************************************************/
+
+void sched_vdso_resume(FAR struct tcb_s *tcb);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#else /* CONFIG_LIB_SYSCALL_VDSO */
+
+#  define sched_vdso_clock()
+#  define sched_vdso_resume(tcb)
+
+#endif /* CONFIG_LIB_SYSCALL_VDSO */
+#endif /* __INCLUDE_NUTTX_VDSO_H */
@@ -210,6 +210,48 @@ struct fb_videoinfo_s
  uint8_t    nplanes;      /* Number of color planes supported */
 };
 
+/* 2D acceleration **********************************************************/
+
+#ifdef CONFIG_FB_ACCEL
+/* A rectangular area of a color plane */
+
+struct fb_area_s
+{
+  fb_coord_t x;           /* X position of the upper left pixel */
+  fb_coord_t y;           /* Y position of the upper left pixel */
+  fb_coord_t w;           /* Width of the area in pixels */
+  fb_coord_t h;           /* Height of the area in pixel rows */
+};
+
+/* Video hardware with a 2D graphics engine (such as DMA2D) may provide
+ * these operations on the framebuffer memory of a color plane.  A NULL
+ * entry means that the operation is not supported.  Each operation must
+ * complete before it returns.  It may return a negated errno value to
+ * decline the request, for example because of the alignment or the size
+ * of the area; the caller then performs the operation in software.
+ *
+ * fillarea - Fill the area with a pixel value in the plane's format.
+ * copyarea - Copy an image in memory into the area.  src is the address of
+ *            the pixel to be copied to the upper left pixel of the area;
+ *            srcstride is the length of one image row in bytes.
+ * movearea - Move the area to the position (destx, desty) in the same
+ *            plane.  The source and the destination may overlap.
+ */
+
+struct fb_planeinfo_s;
+struct fb_accelops_s
+{
+  int (*fillarea)(FAR const struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, uint32_t color);
+  int (*copyarea)(FAR const struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, FAR const void *src,
+                  fb_coord_t srcstride);
+  int (*movearea)(FAR const struct fb_planeinfo_s *pinfo,
+                  FAR const struct fb_area_s *area, fb_coord_t destx,
+                  fb_coord_t desty);
+};
+#endif
+
 /* This structure describes one color plane.  Some YUV formats may support
  * up to 4 planes
  */
@@ -221,6 +263,9 @@ struct fb_planeinfo_s
   fb_coord_t stride;      /* Length of a line in bytes */
   uint8_t    display;     /* Display number */
   uint8_t    bpp;         /* Bits per pixel */
+#ifdef CONFIG_FB_ACCEL
+  FAR const struct fb_accelops_s *accel; /* 2D acceleration (may be NULL) */
+#endif
 };
 
 /* On video controllers that support mapping of a pixel palette value
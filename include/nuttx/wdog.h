@@ -92,10 +92,18 @@
 #define wd_static(w) \
   do { (w)->next = NULL; (w)->flags = WDOGF_STATIC; } while (0)
 
-#ifdef CONFIG_PIC
-#  define WDOG_INITIAILIZER { NULL, NULL, NULL, 0, WDOGF_STATIC, 0 }
+#ifdef CONFIG_WDOG_TIMERWHEEL
+#  ifdef CONFIG_PIC
+#    define WDOG_INITIAILIZER { NULL, NULL, NULL, NULL, 0, WDOGF_STATIC, 0 }
+#  else
+#    define WDOG_INITIAILIZER { NULL, NULL, NULL, 0, WDOGF_STATIC, 0 }
+#  endif
 #else
-#  define WDOG_INITIAILIZER { NULL, NULL, 0, WDOGF_STATIC, 0 }
+#  ifdef CONFIG_PIC
+#    define WDOG_INITIAILIZER { NULL, NULL, NULL, 0, WDOGF_STATIC, 0 }
+#  else
+#    define WDOG_INITIAILIZER { NULL, NULL, 0, WDOGF_STATIC, 0 }
+#  endif
 #endif
 
 /****************************************************************************
@@ -130,11 +138,18 @@ typedef CODE void (*wdentry_t)(int argc, wdparm_t arg1, ...);
 
 /* This is the internal representation of the watchdog timer structure.  The
  * WDOG_ID is a pointer to a watchdog structure.
+ *
+ * If CONFIG_WDOG_TIMERWHEEL is selected, then 'next' and 'prev' link the
+ * watchdog into a doubly linked timer wheel slot, 'lag' holds the absolute
+ * expiration time in ticks, and 'slot' is the index of that slot.
  */
 
 struct wdog_s
 {
   FAR struct wdog_s *next;       /* Support for singly linked lists. */
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  FAR struct wdog_s *prev;       /* Support for doubly linked lists. */
+#endif
   wdentry_t          func;       /* Function to execute when delay expires */
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
@@ -142,6 +157,9 @@ struct wdog_s
   int                lag;        /* Timer associated with the delay */
   uint8_t            flags;      /* See WDOGF_* definitions above */
   uint8_t            argc;       /* The number of parameters to pass */
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  uint8_t            slot;       /* Timer wheel slot index */
+#endif
   wdparm_t           parm[CONFIG_MAX_WDOGPARMS];
 };
 
@@ -74,6 +74,11 @@
  *   collection, the default is 100*1000.
  * CONFIG_SCHED_HPWORKSTACKSIZE - The stack size allocated for the worker
  *   thread.  Default: 2048.
+ * CONFIG_SCHED_HPNTHREADS - The number of thread in the high-priority
+ *   queue's thread pool.  Default: 1
+ * CONFIG_SCHED_HPWORK_PERCPU - Create one high-priority work queue and
+ *   worker thread for each CPU (SMP only).  Work is performed on the CPU
+ *   where it was queued.
  * CONFIG_SIG_SIGWORK - The signal number that will be used to wake-up
  *   the worker thread.  Default: 17
  *
@@ -162,6 +167,15 @@
 #    define CONFIG_SCHED_HPWORKSTACKSIZE CONFIG_IDLETHREAD_STACKSIZE
 #  endif
 
+#  ifndef CONFIG_SMP
+#    undef CONFIG_SCHED_HPWORK_PERCPU
+#  endif
+
+#  if defined(CONFIG_SCHED_HPWORK_PERCPU) || !defined(CONFIG_SCHED_HPNTHREADS)
+#    undef CONFIG_SCHED_HPNTHREADS
+#    define CONFIG_SCHED_HPNTHREADS 1
+#  endif
+
 #endif /* CONFIG_SCHED_HPWORK */
 
 /* Low priority kernel work queue configuration *****************************/
@@ -294,6 +308,10 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   systime_t qtime;       /* Time work queued */
   systime_t delay;       /* Delay until work performed */
+  systime_t slack;       /* Additional delay permitted to batch work */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  uint8_t   cpu;         /* CPU of the high priority queue holding the work */
+#endif
 };
 
 /****************************************************************************
@@ -363,6 +381,61 @@ int work_usrstart(void);
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, systime_t delay);
 
+/****************************************************************************
+ * Name: work_queue_slack
+ *
+ * Description:
+ *   Queue work exactly as work_queue() does, but permit the worker thread
+ *   to defer the work by up to 'slack' clock ticks beyond its delay.  The
+ *   worker thread uses the slack to perform pending delayed work together
+ *   after a single wake-up rather than waking up separately for each
+ *   piece of work.  work_queue() is equivalent to a slack of zero.
+ *
+ * Input parameters:
+ *   qid    - The work queue ID
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will invoked
+ *            on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   slack  - Additional clock ticks that the work may be deferred.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_slack(int qid, FAR struct work_s *work, worker_t worker,
+                     FAR void *arg, systime_t delay, systime_t slack);
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue high priority work to be performed by the worker thread of a
+ *   specific CPU (CONFIG_SCHED_HPWORK_PERCPU only).  Otherwise the same as
+ *   work_queue(HPWORK, ...).  work_cancel(HPWORK, work) cancels the work.
+ *
+ * Input parameters:
+ *   cpu    - The CPU whose high priority work queue will perform the work
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_cpu(int cpu, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, systime_t delay);
+#endif
+
 /****************************************************************************
  * Name: work_cancel
  *
@@ -199,15 +199,26 @@ typedef pid_t pthread_t;
 typedef int pthread_condattr_t;
 #define __PTHREAD_CONDATTR_T_DEFINED 1
 
+struct pthread_mutex_s;
+
 struct pthread_cond_s
 {
   sem_t sem;
+#ifdef CONFIG_PTHREAD_FUTEX
+  volatile int seq;      /* Incremented by each signal or broadcast */
+  volatile int nwaiters; /* Number of threads waiting in user space */
+  FAR struct pthread_mutex_s *volatile mutex; /* Mutex of the waiters */
+#endif
 };
 
 typedef struct pthread_cond_s pthread_cond_t;
 #define __PTHREAD_COND_T_DEFINED 1
 
-#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0)}
+#ifdef CONFIG_PTHREAD_FUTEX
+#  define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), 0, 0, NULL}
+#else
+#  define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0)}
+#endif
 
 struct pthread_mutexattr_s
 {
@@ -228,13 +239,19 @@ struct pthread_mutex_s
   uint8_t type;   /* Type of the mutex.  See PTHREAD_MUTEX_* definitions */
   int   nlocks;   /* The number of recursive locks held */
 #endif
+#ifdef CONFIG_PTHREAD_FUTEX
+  volatile int futex; /* User-space lock: 0=unlocked, 1=locked,
+                       * 2=locked and there may be waiters */
+#endif
 };
 
 typedef struct pthread_mutex_s pthread_mutex_t;
 #define __PTHREAD_MUTEX_T_DEFINED 1
 
-#ifdef CONFIG_MUTEX_TYPES
+#if defined(CONFIG_MUTEX_TYPES)
 #  define PTHREAD_MUTEX_INITIALIZER {-1, SEM_INITIALIZER(1), PTHREAD_MUTEX_DEFAULT, 0}
+#elif defined(CONFIG_PTHREAD_FUTEX)
+#  define PTHREAD_MUTEX_INITIALIZER {-1, SEM_INITIALIZER(1), 0}
 #else
 #  define PTHREAD_MUTEX_INITIALIZER {-1, SEM_INITIALIZER(1)}
 #endif
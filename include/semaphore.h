@@ -61,26 +61,36 @@ extern "C"
  * Public Type Declarations
  ****************************************************************************/
 
-/* This structure contains information about the holder of a semaphore */
+/* This structure contains information about the holder of a semaphore.
+ * Each holder is in two lists:  The list of holders of the semaphore and
+ * the list of semaphores held by the holder thread.
+ */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 struct tcb_s; /* Forward reference */
+struct sem_s; /* Forward reference */
 struct semholder_s
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   struct semholder_s *flink;     /* Implements singly linked list */
 #endif
+  FAR struct semholder_s *tlink; /* Next holder of the same thread */
+  FAR struct sem_s *sem;         /* The semaphore that is held */
   FAR struct tcb_s *htcb;        /* Holder TCB */
   int16_t counts;                /* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEMHOLDER_INITIALIZER {NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, NULL, 0}
 #else
-#  define SEMHOLDER_INITIALIZER {NULL, 0}
+#  define SEMHOLDER_INITIALIZER {NULL, NULL, NULL, 0}
 #endif
 #endif /* CONFIG_PRIORITY_INHERITANCE */
 
+#ifdef CONFIG_SCHED_LOCKSTAT
+struct sem_lockstat_s; /* Forward reference */
+#endif
+
 /* This is the generic semaphore structure. */
 
 struct sem_s
@@ -98,6 +108,10 @@ struct sem_s
   struct semholder_s holder;     /* Single holder */
 # endif
 #endif
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+  FAR struct sem_lockstat_s *lockstat; /* Contention statistics, if named */
+#endif
 };
 
 typedef struct sem_s sem_t;
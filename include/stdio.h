@@ -64,6 +64,12 @@
 #  define BUFSIZ CONFIG_STDIO_BUFFER_SIZE
 #endif
 
+/* The buffering modes of setvbuf() */
+
+#define _IOFBF     0               /* Fully buffered */
+#define _IOLBF     1               /* Line buffered */
+#define _IONBF     2               /* Unbuffered */
+
 /* File system error values */
 
 #define EOF        (-1)
@@ -82,6 +88,8 @@
 #define putchar(c) fputc(c, stdout)
 #define getc(s)    fgetc(s)
 #define getchar()  fgetc(stdin)
+#define getchar_unlocked()  getc_unlocked(stdin)
+#define putchar_unlocked(c) putc_unlocked((c), stdout)
 #define rewind(s)  ((void)fseek((s),0,SEEK_SET))
 
 /* Path to the directory where temporary files can be created */
@@ -155,9 +163,19 @@ long   ftell(FAR FILE *stream);
 size_t fwrite(FAR const void *ptr, size_t size, size_t n_items,
          FAR FILE *stream);
 FAR char *gets(FAR char *s);
+void   setbuf(FAR FILE *stream, FAR char *buf);
+int    setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size);
 FAR char *gets_s(FAR char *s, rsize_t n);
 int    ungetc(int c, FAR FILE *stream);
 
+/* POSIX stream locking and the unlocked character I/O that depends on it */
+
+void   flockfile(FAR FILE *stream);
+int    ftrylockfile(FAR FILE *stream);
+void   funlockfile(FAR FILE *stream);
+int    getc_unlocked(FAR FILE *stream);
+int    putc_unlocked(int c, FAR FILE *stream);
+
 /* Operations on the stdout stream, buffers, paths, and the whole printf-family */
 
 int    printf(FAR const IPTR char *format, ...);
@@ -45,6 +45,18 @@
 
 #include <nuttx/fs/ioctl.h>
 
+#ifdef CONFIG_BOARDCTL_OS_BENCH
+#  include <nuttx/bench.h>
+#endif
+
+#ifdef CONFIG_BOARDCTL_NET_BENCH
+#  include <nuttx/net/bench.h>
+#endif
+
+#ifdef CONFIG_BOARDCTL_FS_BENCH
+#  include <nuttx/fs/bench.h>
+#endif
+
 #ifdef CONFIG_LIB_BOARDCTL
 
 /****************************************************************************
@@ -145,6 +157,24 @@
  * ARG:           A pointer to an instance of struct boardioc_graphics_s
  * CONFIGURATION: CONFIG_LIB_BOARDCTL && CONFIG_BOARDCTL_GRAPHICS
  * DEPENDENCIES:  Board logic must provide board_adc_setup()
+ *
+ * CMD:           BOARDIOC_OS_BENCH
+ * DESCRIPTION:   Run one OS micro-benchmark
+ * ARG:           A pointer to an instance of struct boardioc_bench_s
+ * CONFIGURATION: CONFIG_LIB_BOARDCTL && CONFIG_BOARDCTL_OS_BENCH
+ * DEPENDENCIES:  None
+ *
+ * CMD:           BOARDIOC_NET_BENCH
+ * DESCRIPTION:   Run the network throughput benchmark
+ * ARG:           A pointer to an instance of struct netbench_s
+ * CONFIGURATION: CONFIG_LIB_BOARDCTL && CONFIG_BOARDCTL_NET_BENCH
+ * DEPENDENCIES:  None
+ *
+ * CMD:           BOARDIOC_FS_BENCH
+ * DESCRIPTION:   Run one file system or block device benchmark
+ * ARG:           A pointer to an instance of struct fsbench_s
+ * CONFIGURATION: CONFIG_LIB_BOARDCTL && CONFIG_BOARDCTL_FS_BENCH
+ * DEPENDENCIES:  None
  */
 
 #define BOARDIOC_INIT              _BOARDIOC(0x0001)
@@ -160,6 +190,9 @@
 #define BOARDIOC_PWMTEST_SETUP     _BOARDIOC(0x000b)
 #define BOARDIOC_CAN_INITIALIZE    _BOARDIOC(0x000c)
 #define BOARDIOC_GRAPHICS_SETUP    _BOARDIOC(0x000d)
+#define BOARDIOC_OS_BENCH          _BOARDIOC(0x000e)
+#define BOARDIOC_NET_BENCH         _BOARDIOC(0x000f)
+#define BOARDIOC_FS_BENCH          _BOARDIOC(0x0010)
 
 /* If CONFIG_BOARDCTL_IOCTL=y, then boad-specific commands will be support.
  * In this case, all commands not recognized by boardctl() will be forwarded
@@ -168,7 +201,7 @@
  * User defined board commands may begin with this value:
  */
 
-#define BOARDIOC_USER              _BOARDIOC(0x000d)
+#define BOARDIOC_USER              _BOARDIOC(0x0011)
 
 /****************************************************************************
  * Public Type Definitions
@@ -206,6 +239,19 @@ struct boardioc_symtab_s
   int nsymbols;
 };
 
+#ifdef CONFIG_BOARDCTL_OS_BENCH
+/* Structure used to pass arguments and get returned values from the
+ * BOARDIOC_OS_BENCH command.
+ */
+
+struct boardioc_bench_s
+{
+  int test;                      /* IN: The benchmark (enum bench_e) */
+  uint32_t nsamples;             /* IN: Number of samples (0: default) */
+  struct bench_result_s result;  /* OUT: The result */
+};
+#endif
+
 #ifdef CONFIG_BOARDCTL_USBDEVCTRL
 /* This structure provides the argument BOARDIOC_USBDEV_CONTROL and
  * describes which device should be controlled and what should be
@@ -74,6 +74,15 @@ enum EPOLL_EVENTS
 #define EPOLLERR EPOLLERR
     EPOLLHUP = POLLHUP,
 #define EPOLLHUP EPOLLHUP
+
+    /* Flags (pollevent_t is only 8 bits wide, so these do not have the
+     * Linux values).
+     */
+
+    EPOLLONESHOT = 0x40,
+#define EPOLLONESHOT EPOLLONESHOT
+    EPOLLET = 0x80,
+#define EPOLLET EPOLLET
   };
 
 typedef union poll_data
@@ -90,13 +99,6 @@ struct epoll_event
   FAR void    *priv;     /* For use by drivers */
 };
 
-struct epoll_head
-{
-  int size;
-  int occupied;
-  FAR struct epoll_event *evs;
-};
-
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -105,6 +106,7 @@
 #define MSG_ERRQUEUE   0x2000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000 /* recvmmsg(): Block only for the first message. */
 
 /* Socket options */
 
@@ -140,6 +142,32 @@
 #define SO_SNDTIMEO    15 /* Sets the timeout value specifying the amount of time that an
                            * output function blocks because flow control prevents data from
                            * being sent(get/set). arg: struct timeval */
+#define SO_REUSEPORT   16 /* Allow several sockets to bind the same UDP port (get/set).
+                           * arg: pointer to integer containing a boolean value */
+#define SO_TIMESTAMP   17 /* Report the receive time of each datagram in an SCM_TIMESTAMP
+                           * control message (get/set).
+                           * arg: pointer to integer containing a boolean value */
+#define SO_TIMESTAMPING 18 /* Select the software and hardware time stamps that are
+                           * reported in SCM_TIMESTAMPING control messages (get/set).
+                           * arg: integer value, see SOF_TIMESTAMPING_* */
+#define SO_PRIORITY    19 /* Sets the transmit priority of the socket; higher values
+                           * are sent first (get/set).  arg: integer value */
+
+/* Control message types at the SOL_SOCKET level (see recvmsg()) */
+
+#define SCM_TIMESTAMP   SO_TIMESTAMP    /* struct timeval */
+#define SCM_TIMESTAMPING SO_TIMESTAMPING /* struct timespec[3]: software, (unused)
+                                         * and raw hardware time stamp */
+
+/* SO_TIMESTAMPING flags */
+
+#define SOF_TIMESTAMPING_TX_HARDWARE  (1 << 0) /* Time stamp sent frames in hardware */
+#define SOF_TIMESTAMPING_TX_SOFTWARE  (1 << 1) /* Time stamp sent frames in software */
+#define SOF_TIMESTAMPING_RX_HARDWARE  (1 << 2) /* Time stamp received frames in hardware */
+#define SOF_TIMESTAMPING_RX_SOFTWARE  (1 << 3) /* Time stamp received frames in software */
+#define SOF_TIMESTAMPING_SOFTWARE     (1 << 4) /* Report software time stamps */
+#define SOF_TIMESTAMPING_RAW_HARDWARE (1 << 6) /* Report hardware time stamps */
+#define SOF_TIMESTAMPING_MASK         0x5f
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -187,6 +215,55 @@ struct sockaddr
   char        sa_data[14];     /* 14-bytes of address data */
 };
 
+/* Describes one message for recvmsg(), recvmmsg() and sendmmsg() */
+
+struct msghdr
+{
+  FAR void         *msg_name;       /* Optional address */
+  socklen_t         msg_namelen;    /* Size of the address */
+  FAR struct iovec *msg_iov;        /* Scatter/gather array */
+  int               msg_iovlen;     /* Number of elements in msg_iov */
+  FAR void         *msg_control;    /* Ancillary data (see recvmsg()) */
+  socklen_t         msg_controllen; /* Size of the ancillary data */
+  int               msg_flags;      /* Flags on received message */
+};
+
+struct mmsghdr
+{
+  struct msghdr     msg_hdr;        /* The message */
+  unsigned int      msg_len;        /* Number of bytes transferred */
+};
+
+/* Header of one control message in the msg_control buffer of a msghdr */
+
+struct cmsghdr
+{
+  socklen_t         cmsg_len;       /* Length including this header */
+  int               cmsg_level;     /* Originating protocol */
+  int               cmsg_type;      /* Protocol-specific type */
+};
+
+/* Control message access, see RFC 3542 */
+
+#define CMSG_ALIGN(len) \
+  (((len) + sizeof(long) - 1) & ~(sizeof(long) - 1))
+#define CMSG_DATA(cmsg) \
+  ((FAR unsigned char *)(cmsg) + CMSG_ALIGN(sizeof(struct cmsghdr)))
+#define CMSG_SPACE(len) \
+  (CMSG_ALIGN(sizeof(struct cmsghdr)) + CMSG_ALIGN(len))
+#define CMSG_LEN(len) \
+  (CMSG_ALIGN(sizeof(struct cmsghdr)) + (len))
+#define CMSG_FIRSTHDR(msg) \
+  ((size_t)(msg)->msg_controllen >= sizeof(struct cmsghdr) ? \
+   (FAR struct cmsghdr *)(msg)->msg_control : (FAR struct cmsghdr *)0)
+#define CMSG_NXTHDR(msg, cmsg) \
+  ((FAR unsigned char *)(cmsg) + CMSG_ALIGN((cmsg)->cmsg_len) + \
+   sizeof(struct cmsghdr) > \
+   (FAR unsigned char *)(msg)->msg_control + (msg)->msg_controllen ? \
+   (FAR struct cmsghdr *)0 : \
+   (FAR struct cmsghdr *)((FAR unsigned char *)(cmsg) + \
+                          CMSG_ALIGN((cmsg)->cmsg_len)))
+
 /* Used with the SO_LINGER socket option */
 
 struct linger
@@ -223,6 +300,14 @@ ssize_t recv(int sockfd, FAR void *buf, size_t len, int flags);
 ssize_t recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
                  FAR struct sockaddr *from, FAR socklen_t *fromlen);
 
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
+
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 int shutdown(int sockfd, int how);
 
 int setsockopt(int sockfd, int level, int option,
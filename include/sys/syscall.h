@@ -215,7 +215,13 @@
 #define SYS_clock_getres               (__SYS_clock+1)
 #define SYS_clock_gettime              (__SYS_clock+2)
 #define SYS_clock_settime              (__SYS_clock+3)
-#define __SYS_timers                   (__SYS_clock+4)
+
+#ifdef CONFIG_CLOCK_ADJTIME
+#  define SYS_clock_adjtime            (__SYS_clock+4)
+#  define __SYS_timers                 (__SYS_clock+5)
+#else
+#  define __SYS_timers                 (__SYS_clock+4)
+#endif
 
 /* The following are defined only if POSIX timers are supported */
 
@@ -255,14 +261,18 @@
 #  define SYS_write                    (__SYS_descriptors+3)
 #  define SYS_pread                    (__SYS_descriptors+4)
 #  define SYS_pwrite                   (__SYS_descriptors+5)
+#  define SYS_readv                    (__SYS_descriptors+6)
+#  define SYS_writev                   (__SYS_descriptors+7)
+#  define SYS_preadv                   (__SYS_descriptors+8)
+#  define SYS_pwritev                  (__SYS_descriptors+9)
 #  ifdef CONFIG_FS_AIO
-#    define SYS_aio_read               (__SYS_descriptors+6)
-#    define SYS_aio_write              (__SYS_descriptors+7)
-#    define SYS_aio_fsync              (__SYS_descriptors+8)
-#    define SYS_aio_cancel             (__SYS_descriptors+9)
-#    define __SYS_poll                 (__SYS_descriptors+10)
+#    define SYS_aio_read               (__SYS_descriptors+10)
+#    define SYS_aio_write              (__SYS_descriptors+11)
+#    define SYS_aio_fsync              (__SYS_descriptors+12)
+#    define SYS_aio_cancel             (__SYS_descriptors+13)
+#    define __SYS_poll                 (__SYS_descriptors+14)
 #  else
-#    define __SYS_poll                 (__SYS_descriptors+6)
+#    define __SYS_poll                 (__SYS_descriptors+10)
 #  endif
 #  ifndef CONFIG_DISABLE_POLL
 #    define SYS_poll                   __SYS_poll
@@ -357,7 +367,9 @@
 #    define SYS_shmat                  (__SYS_shm+1)
 #    define SYS_shmctl                 (__SYS_shm+2)
 #    define SYS_shmdt                  (__SYS_shm+3)
-#    define __SYS_pthread              (__SYS_shm+4)
+#    define SYS_shmwait                (__SYS_shm+4)
+#    define SYS_shmwake                (__SYS_shm+5)
+#    define __SYS_pthread              (__SYS_shm+6)
 #else
 #  define __SYS_pthread                __SYS_shm
 #endif
@@ -369,44 +381,61 @@
 #  define SYS_pthread_barrier_init     (__SYS_pthread+1)
 #  define SYS_pthread_barrier_wait     (__SYS_pthread+2)
 #  define SYS_pthread_cancel           (__SYS_pthread+3)
-#  define SYS_pthread_cond_broadcast   (__SYS_pthread+4)
-#  define SYS_pthread_cond_destroy     (__SYS_pthread+5)
-#  define SYS_pthread_cond_init        (__SYS_pthread+6)
-#  define SYS_pthread_cond_signal      (__SYS_pthread+7)
-#  define SYS_pthread_cond_wait        (__SYS_pthread+8)
-#  define SYS_pthread_create           (__SYS_pthread+9)
-#  define SYS_pthread_detach           (__SYS_pthread+10)
-#  define SYS_pthread_exit             (__SYS_pthread+11)
-#  define SYS_pthread_getschedparam    (__SYS_pthread+12)
-#  define SYS_pthread_getspecific      (__SYS_pthread+13)
-#  define SYS_pthread_join             (__SYS_pthread+14)
-#  define SYS_pthread_key_create       (__SYS_pthread+15)
-#  define SYS_pthread_key_delete       (__SYS_pthread+16)
-#  define SYS_pthread_mutex_destroy    (__SYS_pthread+17)
-#  define SYS_pthread_mutex_init       (__SYS_pthread+18)
-#  define SYS_pthread_mutex_lock       (__SYS_pthread+19)
-#  define SYS_pthread_mutex_trylock    (__SYS_pthread+20)
-#  define SYS_pthread_mutex_unlock     (__SYS_pthread+21)
-#  define SYS_pthread_once             (__SYS_pthread+22)
-#  define SYS_pthread_setcancelstate   (__SYS_pthread+23)
-#  define SYS_pthread_setschedparam    (__SYS_pthread+24)
-#  define SYS_pthread_setschedprio     (__SYS_pthread+25)
-#  define SYS_pthread_setspecific      (__SYS_pthread+26)
-#  define SYS_pthread_yield            (__SYS_pthread+27)
-
-#  ifndef CONFIG_SMP
-#    define SYS_pthread_setaffinity_np (__SYS_pthread+28)
-#    define SYS_pthread_getaffinity_np (__SYS_pthread+29)
-#    define __SYS_pthread_signals      (__SYS_pthread+30)
+#  define SYS_pthread_cond_destroy     (__SYS_pthread+4)
+#  define SYS_pthread_cond_init        (__SYS_pthread+5)
+#  define SYS_pthread_create           (__SYS_pthread+6)
+#  define SYS_pthread_detach           (__SYS_pthread+7)
+#  define SYS_pthread_exit             (__SYS_pthread+8)
+#  define SYS_pthread_getschedparam    (__SYS_pthread+9)
+#  define SYS_pthread_getspecific      (__SYS_pthread+10)
+#  define SYS_pthread_join             (__SYS_pthread+11)
+#  define SYS_pthread_key_create       (__SYS_pthread+12)
+#  define SYS_pthread_key_delete       (__SYS_pthread+13)
+#  define SYS_pthread_mutex_destroy    (__SYS_pthread+14)
+#  define SYS_pthread_mutex_init       (__SYS_pthread+15)
+#  define SYS_pthread_once             (__SYS_pthread+16)
+#  define SYS_pthread_setcancelstate   (__SYS_pthread+17)
+#  define SYS_pthread_setschedparam    (__SYS_pthread+18)
+#  define SYS_pthread_setschedprio     (__SYS_pthread+19)
+#  define SYS_pthread_setspecific      (__SYS_pthread+20)
+#  define SYS_pthread_yield            (__SYS_pthread+21)
+
+/* With CONFIG_PTHREAD_FUTEX, mutexes and condition variables are
+ * implemented in user space and only block and wake through the kernel.
+ */
+
+#  ifdef CONFIG_PTHREAD_FUTEX
+#    define SYS_futex_wait             (__SYS_pthread+22)
+#    define SYS_futex_wake             (__SYS_pthread+23)
+#    define SYS_futex_requeue          (__SYS_pthread+24)
+#    define __SYS_pthread_smp          (__SYS_pthread+25)
+#  else
+#    define SYS_pthread_cond_broadcast (__SYS_pthread+22)
+#    define SYS_pthread_cond_signal    (__SYS_pthread+23)
+#    define SYS_pthread_cond_wait      (__SYS_pthread+24)
+#    define SYS_pthread_mutex_lock     (__SYS_pthread+25)
+#    define SYS_pthread_mutex_trylock  (__SYS_pthread+26)
+#    define SYS_pthread_mutex_unlock   (__SYS_pthread+27)
+#    define __SYS_pthread_smp          (__SYS_pthread+28)
+#  endif
+
+#  ifdef CONFIG_SMP
+#    define SYS_pthread_setaffinity_np (__SYS_pthread_smp+0)
+#    define SYS_pthread_getaffinity_np (__SYS_pthread_smp+1)
+#    define __SYS_pthread_signals      (__SYS_pthread_smp+2)
 #  else
-#    define __SYS_pthread_signals      (__SYS_pthread+28)
+#    define __SYS_pthread_signals      __SYS_pthread_smp
 #  endif
 
 #  ifndef CONFIG_DISABLE_SIGNALS
-#    define SYS_pthread_cond_timedwait (__SYS_pthread_signals+0)
-#    define SYS_pthread_kill           (__SYS_pthread_signals+1)
-#    define SYS_pthread_sigmask        (__SYS_pthread_signals+2)
-#    define __SYS_mqueue               (__SYS_pthread_signals+3)
+#    define SYS_pthread_kill           (__SYS_pthread_signals+0)
+#    define SYS_pthread_sigmask        (__SYS_pthread_signals+1)
+#    ifdef CONFIG_PTHREAD_FUTEX
+#      define __SYS_mqueue             (__SYS_pthread_signals+2)
+#    else
+#      define SYS_pthread_cond_timedwait (__SYS_pthread_signals+2)
+#      define __SYS_mqueue             (__SYS_pthread_signals+3)
+#    endif
 #  else
 #    define __SYS_mqueue               __SYS_pthread_signals
 #  endif
@@ -469,7 +498,10 @@
 #  define SYS_sendto                   (__SYS_network+8)
 #  define SYS_setsockopt               (__SYS_network+9)
 #  define SYS_socket                   (__SYS_network+10)
-#  define SYS_nnetsocket               (__SYS_network+11)
+#  define SYS_recvmmsg                 (__SYS_network+11)
+#  define SYS_sendmmsg                 (__SYS_network+12)
+#  define SYS_recvmsg                  (__SYS_network+13)
+#  define SYS_nnetsocket               (__SYS_network+14)
 #else
 #  define SYS_nnetsocket               __SYS_network
 #endif
@@ -478,9 +510,18 @@
 
 #if CONFIG_TASK_NAME_SIZE > 0
 #  define SYS_prctl                    (SYS_nnetsocket+0)
-#  define SYS_maxsyscall               (SYS_nnetsocket+1)
+#  define __SYS_batch                  (SYS_nnetsocket+1)
+#else
+#  define __SYS_batch                  SYS_nnetsocket
+#endif
+
+/* The following is defined only if CONFIG_LIB_SYSCALL_BATCH is selected */
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+#  define SYS_syscall_batch            (__SYS_batch+0)
+#  define SYS_maxsyscall               (__SYS_batch+1)
 #else
-#  define SYS_maxsyscall               SYS_nnetsocket
+#  define SYS_maxsyscall               __SYS_batch
 #endif
 
 /* Note that the reported number of system calls does *NOT* include the
@@ -494,12 +535,23 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifndef __ASSEMBLY__
+
+/* One system call in the array passed to syscall_batch() */
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+struct syscall_batch_s
+{
+  unsigned int nbr;          /* System call number (SYS_xxx) */
+  uintptr_t parm[6];         /* System call parameters */
+  uintptr_t result;          /* Returned value of the system call */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-#ifndef __ASSEMBLY__
-
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -536,9 +588,35 @@ EXTERN const uintptr_t g_stublookup[SYS_nsyscalls];
 EXTERN const uint8_t g_funcnparms[SYS_nsyscalls];
 
 /****************************************************************************
- * Public Functions
+ * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Execute an array of system calls in one trap into the kernel.  The
+ *   calls are executed in order and the returned value of each is stored
+ *   in its 'result' field.  Use get_errno() after a call that may fail to
+ *   be the last one in the batch, since each call may overwrite the errno
+ *   value set by the previous one.
+ *
+ * Input Parameters:
+ *   calls  - The array of system calls
+ *   ncalls - The number of system calls in the array
+ *
+ * Returned Value:
+ *   The number of system calls executed.  This is less than ncalls if an
+ *   invalid system call number (or syscall_batch() itself) is found.  If
+ *   the first entry is invalid, -1 (ERROR) is returned and the errno value
+ *   is set to EINVAL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+int syscall_batch(FAR struct syscall_batch_s *calls, int ncalls);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
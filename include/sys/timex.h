@@ -0,0 +1,121 @@
+/****************************************************************************
+ * include/sys/timex.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_TIMEX_H
+#define __INCLUDE_SYS_TIMEX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/time.h>
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of struct timex modes.  Only these are supported. */
+
+#define ADJ_OFFSET        0x0001 /* Slew the clock by 'offset' */
+#define ADJ_FREQUENCY     0x0002 /* Set the frequency offset 'freq' */
+#define ADJ_SETOFFSET     0x0100 /* Step the clock by 'time' */
+#define ADJ_NANO          0x2000 /* 'offset' and 'time' are in nanoseconds */
+
+/* Return value of clock_adjtime() */
+
+#define TIME_OK           0      /* Clock synchronized */
+
+/* adjtimex() adjusts the system (CLOCK_REALTIME) clock */
+
+#define adjtimex(buf)     clock_adjtime(CLOCK_REALTIME, buf)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* Describes a clock adjustment.  This is a subset of the Linux structure:
+ * the fields of the NTP kernel PLL that are not implemented are always
+ * returned as zero.
+ */
+
+struct timex
+{
+  unsigned int modes;    /* Mode selector (ADJ_*) */
+  long offset;           /* Remaining slew (usec, or nsec with ADJ_NANO) */
+  long freq;             /* Frequency offset (ppm with 16 bit fraction) */
+  long maxerror;         /* Maximum error (usec) */
+  long esterror;         /* Estimated error (usec) */
+  int status;            /* Clock status */
+  long constant;         /* PLL time constant */
+  long precision;        /* Clock precision (usec, read-only) */
+  long tolerance;        /* Maximum 'freq' (read-only) */
+  struct timeval time;   /* Current time, or the step with ADJ_SETOFFSET
+                          * (tv_usec holds nsec with ADJ_NANO) */
+  long tick;             /* Microseconds between clock ticks (read-only) */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: clock_adjtime
+ *
+ * Description:
+ *   Adjust the frequency of a clock, slew it gradually by an offset or step
+ *   it, and return its current state.  Only CLOCK_REALTIME is supported.
+ *
+ ****************************************************************************/
+
+int clock_adjtime(clockid_t clk_id, FAR struct timex *buf);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_SYS_TIMEX_H */
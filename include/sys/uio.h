@@ -36,6 +36,22 @@
 #ifndef __INCLUDE_SYS_UIO_H
 #define __INCLUDE_SYS_UIO_H
 
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The maximum number of I/O vectors in one readv() or writev() call */
+
+#ifndef IOV_MAX
+#  define IOV_MAX 16
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -50,9 +66,25 @@ struct iovec
  * Public Function Prototypes
  ****************************************************************************/
 
-#if 0 /* Not implemented */
-ssize_t readv(int, const struct iovec *, int);
-ssize_t writev(int, const struct iovec *, int);
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+ssize_t readv(int fd, FAR const struct iovec *iov, int iovcnt);
+ssize_t writev(int fd, FAR const struct iovec *iov, int iovcnt);
+ssize_t preadv(int fd, FAR const struct iovec *iov, int iovcnt,
+               off_t offset);
+ssize_t pwritev(int fd, FAR const struct iovec *iov, int iovcnt,
+                off_t offset);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
 #endif
 
 #endif /* __INCLUDE_SYS_UIO_H */
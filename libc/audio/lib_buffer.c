@@ -62,6 +62,45 @@
 
 /* Configuration ************************************************************/
 
+#ifdef CONFIG_AUDIO_BUFFER_POOL
+#  ifndef CONFIG_AUDIO_BUFFER_POOL_NBUFFERS
+#    define CONFIG_AUDIO_BUFFER_POOL_NBUFFERS CONFIG_AUDIO_NUM_BUFFERS
+#  endif
+#  ifndef CONFIG_AUDIO_BUFFER_POOL_BUFSIZE
+#    define CONFIG_AUDIO_BUFFER_POOL_BUFSIZE CONFIG_AUDIO_BUFFER_NUMBYTES
+#  endif
+#  ifndef CONFIG_AUDIO_BUFFER_POOL_ALIGN
+#    define CONFIG_AUDIO_BUFFER_POOL_ALIGN 32
+#  endif
+
+/* Each pool slot holds one buffer.  The buffer header is placed at the end
+ * of the first aligned block of the slot so that the sample data that
+ * follows it begins on an alignment boundary (normally a cache line, to
+ * simplify DMA cache maintenance).
+ */
+
+#  define APB_ALIGNUP(n) \
+     (((n) + CONFIG_AUDIO_BUFFER_POOL_ALIGN - 1) & \
+      ~(CONFIG_AUDIO_BUFFER_POOL_ALIGN - 1))
+#  define APB_HDRSIZE    APB_ALIGNUP(sizeof(struct ap_buffer_s))
+#  define APB_SLOTSIZE   (APB_HDRSIZE + APB_ALIGNUP(CONFIG_AUDIO_BUFFER_POOL_BUFSIZE))
+#  define APB_SLOT(n)    (&g_apbpool[(n) * APB_SLOTSIZE])
+#  define APB_HEADER(n) \
+     ((FAR struct ap_buffer_s *)(APB_SLOT(n) + APB_HDRSIZE - \
+                                 sizeof(struct ap_buffer_s)))
+
+/* The pool may be placed in a specific (for example, non-cached or DMA
+ * capable) memory region by the linker script.
+ */
+
+#  ifdef CONFIG_AUDIO_BUFFER_POOL_SECTION
+#    define APB_POOL_SECTION \
+       __attribute__((section(CONFIG_AUDIO_BUFFER_POOL_SECTION)))
+#  else
+#    define APB_POOL_SECTION
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,6 +109,16 @@
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_AUDIO_BUFFER_POOL
+/* The buffer pool memory and the in-use state of each slot */
+
+static uint8_t g_apbpool[CONFIG_AUDIO_BUFFER_POOL_NBUFFERS * APB_SLOTSIZE]
+  APB_POOL_SECTION
+  __attribute__((aligned(CONFIG_AUDIO_BUFFER_POOL_ALIGN)));
+static bool g_apbinuse[CONFIG_AUDIO_BUFFER_POOL_NBUFFERS];
+static sem_t g_apbpoolsem = SEM_INITIALIZER(1);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -105,6 +154,77 @@ static void apb_semtake(FAR struct ap_buffer_s *apb)
 
 #define apb_semgive(b) sem_post(&b->sem)
 
+/****************************************************************************
+ * Name: apb_pool_alloc
+ *
+ * Take a free buffer from the buffer pool.  Returns NULL if the requested
+ * size is too large for the pool or if there is no free buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_BUFFER_POOL
+static FAR struct ap_buffer_s *apb_pool_alloc(uint32_t numbytes)
+{
+  FAR struct ap_buffer_s *apb = NULL;
+  int i;
+
+  if (numbytes > CONFIG_AUDIO_BUFFER_POOL_BUFSIZE)
+    {
+      return NULL;
+    }
+
+  while (sem_wait(&g_apbpoolsem) != 0)
+    {
+      ASSERT(errno == EINTR);
+    }
+
+  for (i = 0; i < CONFIG_AUDIO_BUFFER_POOL_NBUFFERS; i++)
+    {
+      if (!g_apbinuse[i])
+        {
+          g_apbinuse[i] = true;
+          apb = APB_HEADER(i);
+          break;
+        }
+    }
+
+  sem_post(&g_apbpoolsem);
+  return apb;
+}
+#endif
+
+/****************************************************************************
+ * Name: apb_pool_free
+ *
+ * Return a buffer to the buffer pool.  Returns false if the buffer does not
+ * belong to the pool.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_BUFFER_POOL
+static bool apb_pool_free(FAR struct ap_buffer_s *apb)
+{
+  uintptr_t offset = (uintptr_t)apb - (uintptr_t)g_apbpool;
+
+  if ((uintptr_t)apb < (uintptr_t)g_apbpool ||
+      offset >= sizeof(g_apbpool))
+    {
+      return false;
+    }
+
+  DEBUGASSERT(APB_HEADER(offset / APB_SLOTSIZE) == apb);
+
+  while (sem_wait(&g_apbpoolsem) != 0)
+    {
+      ASSERT(errno == EINTR);
+    }
+
+  g_apbinuse[offset / APB_SLOTSIZE] = false;
+  sem_post(&g_apbpoolsem);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: apb_alloc
  *
@@ -122,10 +242,20 @@ int apb_alloc(FAR struct audio_buf_desc_s *bufdesc)
 
   DEBUGASSERT(bufdesc->u.ppBuffer != NULL);
 
-  /* Perform a user mode allocation */
-
   bufsize = sizeof(struct ap_buffer_s) + bufdesc->numbytes;
-  apb = lib_umalloc(bufsize);
+
+#ifdef CONFIG_AUDIO_BUFFER_POOL
+  /* Take the buffer from the pool if possible */
+
+  apb = apb_pool_alloc(bufdesc->numbytes);
+  if (apb == NULL)
+#endif
+    {
+      /* Perform a user mode allocation */
+
+      apb = lib_umalloc(bufsize);
+    }
+
   *bufdesc->u.ppBuffer = apb;
 
   /* Test if the allocation was successful or not */
@@ -175,7 +305,13 @@ void apb_free(FAR struct ap_buffer_s *apb)
   if (refcount <= 1)
     {
       audinfo("Freeing %p\n", apb);
-      lib_ufree(apb);
+
+#ifdef CONFIG_AUDIO_BUFFER_POOL
+      if (!apb_pool_free(apb))
+#endif
+        {
+          lib_ufree(apb);
+        }
     }
 }
 
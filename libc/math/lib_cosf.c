@@ -29,13 +29,24 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <math.h>
 
+#include "lib_fastmathf.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FASTFLOAT
+float cosf(float x)
+{
+  return lib_fastsincosf(x, 1);
+}
+#else
 float cosf(float x)
 {
   return sinf(x + M_PI_2_F);
 }
+#endif
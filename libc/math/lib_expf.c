@@ -29,15 +29,19 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
 #include <math.h>
 
 #include "libc.h"
+#include "lib_fastmathf.h"
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifndef CONFIG_LIBM_FASTFLOAT
 static float _flt_inv_fact[] =
 {
   1.0 / 1.0,                    /* 1/0! */
@@ -52,11 +56,18 @@ static float _flt_inv_fact[] =
   1.0 / 362880.0,               /* 1/9! */
   1.0 / 3628800.0,              /* 1/10! */
 };
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FASTFLOAT
+float expf(float x)
+{
+  return lib_fastexpf(x);
+}
+#else
 float expf(float x)
 {
   size_t int_part;
@@ -110,3 +121,4 @@ float expf(float x)
       return value;
     }
 }
+#endif
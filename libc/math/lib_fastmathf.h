@@ -0,0 +1,375 @@
+/****************************************************************************
+ * libc/math/lib_fastmathf.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_MATH_LIB_FASTMATHF_H
+#define __LIBC_MATH_LIB_FASTMATHF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <math.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* These are single precision polynomial approximations in the style of the
+ * Cephes library.  The argument is reduced to a small range with a few
+ * multiplies and adds, and there are no data dependent loops, so the same
+ * steps can be used lane by lane in the vector functions.  The error is
+ * within 2.5 ulp over the ranges described below.
+ */
+
+/* sinf/cosf:  Reduction to [-pi/4, pi/4] by multiples of pi/2 with a four
+ * part (Cody-Waite) pi/2.  The leading parts have short mantissas so that
+ * their products with the multiple are exact for |x| < 8192; larger
+ * arguments are first reduced with fmodf().
+ */
+
+#define FASTF_TWO_OVER_PI  0.636619772367581343f
+#define FASTF_PIO2_1       1.5703125f
+#define FASTF_PIO2_2       4.8351287841796875e-4f
+#define FASTF_PIO2_3       3.1385570764541625977e-7f
+#define FASTF_PIO2_4       6.077094383272197e-11f
+#define FASTF_TRIG_MAX     8192.0f
+
+#define FASTF_SIN_1       -1.6666654611e-1f
+#define FASTF_SIN_2        8.3321608736e-3f
+#define FASTF_SIN_3       -1.9515295891e-4f
+
+#define FASTF_COS_1        4.166664568298827e-2f
+#define FASTF_COS_2       -1.388731625493765e-3f
+#define FASTF_COS_3        2.443315711809948e-5f
+
+/* expf:  Reduction to [-ln2/2, ln2/2] by multiples of ln2 */
+
+#define FASTF_LOG2E        1.44269504088896341f
+#define FASTF_LN2_HI       0.693359375f
+#define FASTF_LN2_LO      -2.12194440e-4f
+#define FASTF_EXP_MAX      88.72283935546875f
+#define FASTF_EXP_MIN     -103.972084045410f
+
+#define FASTF_EXP_0        1.9875691500e-4f
+#define FASTF_EXP_1        1.3981999507e-3f
+#define FASTF_EXP_2        8.3334519073e-3f
+#define FASTF_EXP_3        4.1665795894e-2f
+#define FASTF_EXP_4        1.6666665459e-1f
+#define FASTF_EXP_5        5.0000001201e-1f
+
+/* logf:  The mantissa is reduced to [sqrt(1/2), sqrt(2)) */
+
+#define FASTF_SQRTHF       0.707106781186547524f
+
+#define FASTF_LOG_0        7.0376836292e-2f
+#define FASTF_LOG_1       -1.1514610310e-1f
+#define FASTF_LOG_2        1.1676998740e-1f
+#define FASTF_LOG_3       -1.2420140846e-1f
+#define FASTF_LOG_4        1.4249322787e-1f
+#define FASTF_LOG_5       -1.6668057665e-1f
+#define FASTF_LOG_6        2.0000714765e-1f
+#define FASTF_LOG_7       -2.4999993993e-1f
+#define FASTF_LOG_8        3.3333331174e-1f
+
+/* Use the FPU square root instruction when the toolchain targets an ARM FPU
+ * with single precision support.
+ */
+
+#if defined(__GNUC__) && defined(__ARM_FP) && (__ARM_FP & 4) != 0 && \
+    !defined(__SOFTFP__)
+#  define FASTF_HAVE_VSQRT 1
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+union fastf_u
+{
+  float    f;
+  uint32_t i;
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_fastfbits, lib_fastffloat
+ *
+ * Description:
+ *   Access the representation of a float.
+ *
+ ****************************************************************************/
+
+static inline uint32_t lib_fastfbits(float x)
+{
+  union fastf_u u;
+  u.f = x;
+  return u.i;
+}
+
+static inline float lib_fastffloat(uint32_t i)
+{
+  union fastf_u u;
+  u.i = i;
+  return u.f;
+}
+
+/****************************************************************************
+ * Name: lib_fastfround
+ *
+ * Description:
+ *   Round to the nearest integer, halfway cases away from zero.
+ *
+ ****************************************************************************/
+
+static inline int32_t lib_fastfround(float x)
+{
+  return (int32_t)(x >= 0.0f ? x + 0.5f : x - 0.5f);
+}
+
+/****************************************************************************
+ * Name: lib_fastsincosf
+ *
+ * Description:
+ *   sin(x + offset * pi/2).  An offset of zero gives sinf(), an offset of
+ *   one gives cosf().
+ *
+ ****************************************************************************/
+
+static inline float lib_fastsincosf(float x, int offset)
+{
+  float k;
+  float r;
+  float r2;
+  float y;
+  int32_t q;
+
+  /* This also catches NaN */
+
+  if (!(x > -FASTF_TRIG_MAX && x < FASTF_TRIG_MAX))
+    {
+      if (isinf_f(x) || isnan(x))
+        {
+          return NAN_F;
+        }
+
+      x = fmodf(x, 2 * M_PI_F);
+    }
+
+  /* x = q * pi/2 + r */
+
+  q = lib_fastfround(x * FASTF_TWO_OVER_PI);
+  k = (float)q;
+  r = x - k * FASTF_PIO2_1;
+  r = r - k * FASTF_PIO2_2;
+  r = r - k * FASTF_PIO2_3;
+  r = r - k * FASTF_PIO2_4;
+  r2 = r * r;
+  q += offset;
+
+  if ((q & 1) != 0)
+    {
+      y = r2 * r2 * ((FASTF_COS_3 * r2 + FASTF_COS_2) * r2 + FASTF_COS_1) -
+          0.5f * r2 + 1.0f;
+    }
+  else
+    {
+      y = r + r * r2 * ((FASTF_SIN_3 * r2 + FASTF_SIN_2) * r2 + FASTF_SIN_1);
+    }
+
+  return (q & 2) != 0 ? -y : y;
+}
+
+/****************************************************************************
+ * Name: lib_fastexpf
+ ****************************************************************************/
+
+static inline float lib_fastexpf(float x)
+{
+  float k;
+  float r;
+  float p;
+  int32_t q;
+  int32_t q1;
+
+  if (isnan(x))
+    {
+      return x;
+    }
+  else if (x > FASTF_EXP_MAX)
+    {
+      return INFINITY_F;
+    }
+  else if (x < FASTF_EXP_MIN)
+    {
+      return 0.0f;
+    }
+
+  /* x = q * ln2 + r */
+
+  q = lib_fastfround(x * FASTF_LOG2E);
+  k = (float)q;
+  r = (x - k * FASTF_LN2_HI) - k * FASTF_LN2_LO;
+
+  p = ((((FASTF_EXP_0 * r + FASTF_EXP_1) * r + FASTF_EXP_2) * r +
+        FASTF_EXP_3) * r + FASTF_EXP_4) * r + FASTF_EXP_5;
+  p = p * r * r + r + 1.0f;
+
+  /* Scale by 2^q in two steps so that neither factor leaves the range of
+   * normal numbers.
+   */
+
+  q1 = q / 2;
+  p *= lib_fastffloat((uint32_t)(q1 + 127) << 23);
+  p *= lib_fastffloat((uint32_t)(q - q1 + 127) << 23);
+  return p;
+}
+
+/****************************************************************************
+ * Name: lib_fastlogf
+ ****************************************************************************/
+
+static inline float lib_fastlogf(float x)
+{
+  uint32_t bits = lib_fastfbits(x);
+  int32_t e;
+  float f;
+  float m;
+  float y;
+  float z;
+
+  if (isnan(x) || x == INFINITY_F)
+    {
+      return x;
+    }
+  else if (x < 0.0f)
+    {
+      return NAN_F;
+    }
+  else if (x == 0.0f)
+    {
+      return -INFINITY_F;
+    }
+
+  /* Split x into m * 2^e with m in [0.5, 1).  Subnormals are first scaled
+   * up to normal numbers.
+   */
+
+  e = -126;
+  if ((bits & 0x7f800000) == 0)
+    {
+      bits = lib_fastfbits(x * 8388608.0f);
+      e   -= 23;
+    }
+
+  e += (int32_t)(bits >> 23);
+  m  = lib_fastffloat((bits & 0x007fffff) | 0x3f000000);
+
+  /* Then to m in [sqrt(1/2), sqrt(2)) and f = m - 1 */
+
+  if (m < FASTF_SQRTHF)
+    {
+      e--;
+      f = m + m - 1.0f;
+    }
+  else
+    {
+      f = m - 1.0f;
+    }
+
+  z = f * f;
+  y = ((((((((FASTF_LOG_0 * f + FASTF_LOG_1) * f + FASTF_LOG_2) * f +
+             FASTF_LOG_3) * f + FASTF_LOG_4) * f + FASTF_LOG_5) * f +
+          FASTF_LOG_6) * f + FASTF_LOG_7) * f + FASTF_LOG_8) * f * z;
+
+  y += (float)e * FASTF_LN2_LO;
+  y -= 0.5f * z;
+  return f + y + (float)e * FASTF_LN2_HI;
+}
+
+/****************************************************************************
+ * Name: lib_fastsqrtf
+ ****************************************************************************/
+
+static inline float lib_fastsqrtf(float x)
+{
+#ifdef FASTF_HAVE_VSQRT
+  float y;
+
+  __asm__ ("vsqrt.f32 %0, %1" : "=t" (y) : "t" (x));
+  return y;
+#else
+  float scale = 1.0f;
+  float y;
+  float r;
+
+  if (isnan(x) || x == INFINITY_F || x == 0.0f)
+    {
+      return x;
+    }
+  else if (x < 0.0f)
+    {
+      return NAN_F;
+    }
+
+  /* Scale subnormals up to normal numbers: sqrt(x * 2^24) = sqrt(x) * 2^12 */
+
+  if ((lib_fastfbits(x) & 0x7f800000) == 0)
+    {
+      x    *= 16777216.0f;
+      scale = 1.0f / 4096.0f;
+    }
+
+  /* Estimate 1/sqrt(x) and refine it with Newton-Raphson steps, then
+   * refine sqrt(x) = x * (1/sqrt(x)) once more.
+   */
+
+  y = lib_fastffloat(0x5f3759df - (lib_fastfbits(x) >> 1));
+  y = y * (1.5f - 0.5f * x * y * y);
+  y = y * (1.5f - 0.5f * x * y * y);
+  y = y * (1.5f - 0.5f * x * y * y);
+
+  r = x * y;
+  r = r + 0.5f * y * (x - r * r);
+  return r * scale;
+#endif
+}
+
+#endif /* __LIBC_MATH_LIB_FASTMATHF_H */
@@ -29,15 +29,25 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <math.h>
 #include <float.h>
 
+#include "lib_fastmathf.h"
+
 #define FLT_MAX_EXP_X   88.0F
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FASTFLOAT
+float logf(float x)
+{
+  return lib_fastlogf(x);
+}
+#else
 float logf(float x)
 {
   float y, y_old, ey, epsilon;
@@ -77,3 +87,4 @@ float logf(float x)
 
   return y;
 }
+#endif
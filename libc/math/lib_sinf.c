@@ -29,13 +29,18 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
 #include <math.h>
 
+#include "lib_fastmathf.h"
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifndef CONFIG_LIBM_FASTFLOAT
 static float _flt_inv_fact[] =
 {
   1.0 / 1.0,                    /* 1 / 1! */
@@ -45,11 +50,18 @@ static float _flt_inv_fact[] =
   1.0 / 362880.0,               /* 1 / 9! */
   1.0 / 39916800.0,             /* 1 / 11! */
 };
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FASTFLOAT
+float sinf(float x)
+{
+  return lib_fastsincosf(x, 0);
+}
+#else
 float sinf(float x)
 {
   float x_squared;
@@ -102,3 +114,4 @@ float sinf(float x)
 
   return sin_x;
 }
+#endif
@@ -36,11 +36,24 @@
 #include <errno.h>
 
 #include "libc.h"
+#include "lib_fastmathf.h"
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBM_FASTFLOAT
+float sqrtf(float x)
+{
+  if (x < 0.0F)
+    {
+      set_errno(EDOM);
+      return NAN_F;
+    }
+
+  return lib_fastsqrtf(x);
+}
+#else
 float sqrtf(float x)
 {
   float y;
@@ -82,3 +95,4 @@ float sqrtf(float x)
 
   return y;
 }
+#endif
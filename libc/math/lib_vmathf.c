@@ -0,0 +1,432 @@
+/****************************************************************************
+ * libc/math/lib_vmathf.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#ifdef CONFIG_LIBM_NEON
+#  ifndef __ARM_NEON
+#    error CONFIG_LIBM_NEON requires a toolchain generating NEON code
+#  endif
+#  include <arm_neon.h>
+#endif
+
+#include "lib_fastmathf.h"
+
+#ifdef CONFIG_LIBM_VECTOR
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBM_NEON
+/****************************************************************************
+ * Name: vmath_allq
+ *
+ * Description:
+ *   True if all four lanes of the comparison mask are set.
+ *
+ ****************************************************************************/
+
+static inline bool vmath_allq(uint32x4_t mask)
+{
+  uint32x2_t t = vand_u32(vget_low_u32(mask), vget_high_u32(mask));
+  return (vget_lane_u32(t, 0) & vget_lane_u32(t, 1)) != 0;
+}
+
+/****************************************************************************
+ * Name: vmath_roundq
+ *
+ * Description:
+ *   Four lane lib_fastfround():  Add +/-0.5 with the sign of x, then
+ *   truncate.
+ *
+ ****************************************************************************/
+
+static inline int32x4_t vmath_roundq(float32x4_t x)
+{
+  uint32x4_t half;
+
+  half = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000));
+  half = vorrq_u32(half, vreinterpretq_u32_f32(vdupq_n_f32(0.5f)));
+  return vcvtq_s32_f32(vaddq_f32(x, vreinterpretq_f32_u32(half)));
+}
+
+/****************************************************************************
+ * Name: vmath_normalq
+ *
+ * Description:
+ *   Lanes holding positive, normal, finite numbers.
+ *
+ ****************************************************************************/
+
+static inline uint32x4_t vmath_normalq(float32x4_t x)
+{
+  uint32x4_t bits = vreinterpretq_u32_f32(x);
+
+  return vandq_u32(vcgeq_u32(bits, vdupq_n_u32(0x00800000)),
+                   vcltq_u32(bits, vdupq_n_u32(0x7f800000)));
+}
+
+/****************************************************************************
+ * Name: vmath_sincosq
+ *
+ * Description:
+ *   Four lane lib_fastsincosf() for |x| < FASTF_TRIG_MAX.
+ *
+ ****************************************************************************/
+
+static inline float32x4_t vmath_sincosq(float32x4_t x, int32_t offset)
+{
+  float32x4_t k;
+  float32x4_t r;
+  float32x4_t r2;
+  float32x4_t s;
+  float32x4_t c;
+  float32x4_t y;
+  uint32x4_t neg;
+  int32x4_t q;
+
+  q  = vmath_roundq(vmulq_n_f32(x, FASTF_TWO_OVER_PI));
+  k  = vcvtq_f32_s32(q);
+  r  = vmlsq_n_f32(x, k, FASTF_PIO2_1);
+  r  = vmlsq_n_f32(r, k, FASTF_PIO2_2);
+  r  = vmlsq_n_f32(r, k, FASTF_PIO2_3);
+  r  = vmlsq_n_f32(r, k, FASTF_PIO2_4);
+  r2 = vmulq_f32(r, r);
+  q  = vaddq_s32(q, vdupq_n_s32(offset));
+
+  /* Evaluate both polynomials and select by quadrant */
+
+  s = vmlaq_n_f32(vdupq_n_f32(FASTF_SIN_2), r2, FASTF_SIN_3);
+  s = vmlaq_f32(vdupq_n_f32(FASTF_SIN_1), s, r2);
+  s = vmlaq_f32(r, vmulq_f32(r, r2), s);
+
+  c = vmlaq_n_f32(vdupq_n_f32(FASTF_COS_2), r2, FASTF_COS_3);
+  c = vmlaq_f32(vdupq_n_f32(FASTF_COS_1), c, r2);
+  c = vmulq_f32(vmulq_f32(r2, r2), c);
+  c = vmlsq_n_f32(c, r2, 0.5f);
+  c = vaddq_f32(c, vdupq_n_f32(1.0f));
+
+  y   = vbslq_f32(vtstq_s32(q, vdupq_n_s32(1)), c, s);
+  neg = vshlq_n_u32(vandq_u32(vreinterpretq_u32_s32(q), vdupq_n_u32(2)), 30);
+  return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(y), neg));
+}
+
+
+/****************************************************************************
+ * Name: vmath_expq
+ *
+ * Description:
+ *   Four lane lib_fastexpf() for FASTF_EXP_MIN <= x <= FASTF_EXP_MAX.
+ *
+ ****************************************************************************/
+
+static inline float32x4_t vmath_expq(float32x4_t x)
+{
+  float32x4_t k;
+  float32x4_t r;
+  float32x4_t p;
+  int32x4_t q;
+  int32x4_t q1;
+
+  q = vmath_roundq(vmulq_n_f32(x, FASTF_LOG2E));
+  k = vcvtq_f32_s32(q);
+  r = vmlsq_n_f32(x, k, FASTF_LN2_HI);
+  r = vmlsq_n_f32(r, k, FASTF_LN2_LO);
+
+  p = vmlaq_n_f32(vdupq_n_f32(FASTF_EXP_1), r, FASTF_EXP_0);
+  p = vmlaq_f32(vdupq_n_f32(FASTF_EXP_2), p, r);
+  p = vmlaq_f32(vdupq_n_f32(FASTF_EXP_3), p, r);
+  p = vmlaq_f32(vdupq_n_f32(FASTF_EXP_4), p, r);
+  p = vmlaq_f32(vdupq_n_f32(FASTF_EXP_5), p, r);
+  p = vmlaq_f32(r, vmulq_f32(p, r), r);
+  p = vaddq_f32(p, vdupq_n_f32(1.0f));
+
+  /* Scale by 2^q in two steps */
+
+  q1 = vshrq_n_s32(q, 1);
+  q  = vsubq_s32(q, q1);
+  q1 = vshlq_n_s32(vaddq_s32(q1, vdupq_n_s32(127)), 23);
+  q  = vshlq_n_s32(vaddq_s32(q, vdupq_n_s32(127)), 23);
+  p  = vmulq_f32(p, vreinterpretq_f32_s32(q1));
+  return vmulq_f32(p, vreinterpretq_f32_s32(q));
+}
+
+/****************************************************************************
+ * Name: vmath_logq
+ *
+ * Description:
+ *   Four lane lib_fastlogf() for positive, normal, finite x.
+ *
+ ****************************************************************************/
+
+static inline float32x4_t vmath_logq(float32x4_t x)
+{
+  uint32x4_t bits = vreinterpretq_u32_f32(x);
+  uint32x4_t lt;
+  float32x4_t ef;
+  float32x4_t m;
+  float32x4_t f;
+  float32x4_t y;
+  float32x4_t z;
+  int32x4_t e;
+
+  e  = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)),
+                 vdupq_n_s32(126));
+  bits = vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)),
+                   vdupq_n_u32(0x3f000000));
+  m  = vreinterpretq_f32_u32(bits);
+
+  lt = vcltq_f32(m, vdupq_n_f32(FASTF_SQRTHF));
+  e  = vaddq_s32(e, vreinterpretq_s32_u32(lt));
+  f  = vbslq_f32(lt, vaddq_f32(m, m), m);
+  f  = vsubq_f32(f, vdupq_n_f32(1.0f));
+  ef = vcvtq_f32_s32(e);
+
+  z = vmulq_f32(f, f);
+  y = vmlaq_n_f32(vdupq_n_f32(FASTF_LOG_1), f, FASTF_LOG_0);
+  y = vmlaq_f32(vdupq_n_f32(FASTF_LOG_2), y, f);
+  y = vmlaq_f32(vdupq_n_f32(FASTF_LOG_3), y, f);
+  y = vmlaq_f32(vdupq_n_f32(FASTF_LOG_4), y, f);
+  y = vmlaq_f32(vdupq_n_f32(FASTF_LOG_5), y, f);
+  y = vmlaq_f32(vdupq_n_f32(FASTF_LOG_6), y, f);
+  y = vmlaq_f32(vdupq_n_f32(FASTF_LOG_7), y, f);
+  y = vmlaq_f32(vdupq_n_f32(FASTF_LOG_8), y, f);
+  y = vmulq_f32(vmulq_f32(y, f), z);
+
+  y = vmlaq_n_f32(y, ef, FASTF_LN2_LO);
+  y = vmlsq_n_f32(y, z, 0.5f);
+  return vmlaq_n_f32(vaddq_f32(f, y), ef, FASTF_LN2_HI);
+}
+
+/****************************************************************************
+ * Name: vmath_sqrtq
+ *
+ * Description:
+ *   Four lane square root for positive, normal, finite x.  The reciprocal
+ *   square root estimate is refined with two Newton-Raphson steps, then
+ *   sqrt(x) = x * (1/sqrt(x)) once more.
+ *
+ ****************************************************************************/
+
+static inline float32x4_t vmath_sqrtq(float32x4_t x)
+{
+  float32x4_t e;
+  float32x4_t r;
+
+  e = vrsqrteq_f32(x);
+  e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(x, e), e));
+  e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(x, e), e));
+
+  r = vmulq_f32(x, e);
+  return vmlaq_f32(r, vmulq_n_f32(e, 0.5f), vmlsq_f32(x, r, r));
+}
+
+/****************************************************************************
+ * Name: vmath_sincos
+ ****************************************************************************/
+
+static void vmath_sincos(FAR float *y, FAR const float *x, size_t n,
+                         int32_t offset)
+{
+  float32x4_t v;
+  int i;
+
+  for (; n >= 4; n -= 4, x += 4, y += 4)
+    {
+      v = vld1q_f32(x);
+      if (vmath_allq(vcaltq_f32(v, vdupq_n_f32(FASTF_TRIG_MAX))))
+        {
+          vst1q_f32(y, vmath_sincosq(v, offset));
+        }
+      else
+        {
+          for (i = 0; i < 4; i++)
+            {
+              y[i] = lib_fastsincosf(x[i], offset);
+            }
+        }
+    }
+
+  for (; n > 0; n--)
+    {
+      *y++ = lib_fastsincosf(*x++, offset);
+    }
+}
+#else
+/****************************************************************************
+ * Name: vmath_sincos
+ ****************************************************************************/
+
+static void vmath_sincos(FAR float *y, FAR const float *x, size_t n,
+                         int32_t offset)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      y[i] = lib_fastsincosf(x[i], offset);
+    }
+}
+#endif /* CONFIG_LIBM_NEON */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sinf_v, cosf_v
+ ****************************************************************************/
+
+void sinf_v(FAR float *y, FAR const float *x, size_t n)
+{
+  vmath_sincos(y, x, n, 0);
+}
+
+void cosf_v(FAR float *y, FAR const float *x, size_t n)
+{
+  vmath_sincos(y, x, n, 1);
+}
+
+/****************************************************************************
+ * Name: expf_v
+ ****************************************************************************/
+
+void expf_v(FAR float *y, FAR const float *x, size_t n)
+{
+#ifdef CONFIG_LIBM_NEON
+  float32x4_t v;
+  int i;
+
+  for (; n >= 4; n -= 4, x += 4, y += 4)
+    {
+      v = vld1q_f32(x);
+      if (vmath_allq(vandq_u32(vcgeq_f32(v, vdupq_n_f32(FASTF_EXP_MIN)),
+                               vcleq_f32(v, vdupq_n_f32(FASTF_EXP_MAX)))))
+        {
+          vst1q_f32(y, vmath_expq(v));
+        }
+      else
+        {
+          for (i = 0; i < 4; i++)
+            {
+              y[i] = lib_fastexpf(x[i]);
+            }
+        }
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *y++ = lib_fastexpf(*x++);
+    }
+}
+
+/****************************************************************************
+ * Name: logf_v
+ ****************************************************************************/
+
+void logf_v(FAR float *y, FAR const float *x, size_t n)
+{
+#ifdef CONFIG_LIBM_NEON
+  float32x4_t v;
+  int i;
+
+  for (; n >= 4; n -= 4, x += 4, y += 4)
+    {
+      v = vld1q_f32(x);
+      if (vmath_allq(vmath_normalq(v)))
+        {
+          vst1q_f32(y, vmath_logq(v));
+        }
+      else
+        {
+          for (i = 0; i < 4; i++)
+            {
+              y[i] = lib_fastlogf(x[i]);
+            }
+        }
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *y++ = lib_fastlogf(*x++);
+    }
+}
+
+/****************************************************************************
+ * Name: sqrtf_v
+ ****************************************************************************/
+
+void sqrtf_v(FAR float *y, FAR const float *x, size_t n)
+{
+#ifdef CONFIG_LIBM_NEON
+  float32x4_t v;
+  int i;
+
+  for (; n >= 4; n -= 4, x += 4, y += 4)
+    {
+      v = vld1q_f32(x);
+      if (vmath_allq(vmath_normalq(v)))
+        {
+          vst1q_f32(y, vmath_sqrtq(v));
+        }
+      else
+        {
+          for (i = 0; i < 4; i++)
+            {
+              y[i] = lib_fastsqrtf(x[i]);
+            }
+        }
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *y++ = lib_fastsqrtf(*x++);
+    }
+}
+
+#endif /* CONFIG_LIBM_VECTOR */
@@ -0,0 +1,249 @@
+/****************************************************************************
+ * libc/misc/lib_circbuf.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/circbuf.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: circbuf_init
+ *
+ * Description:
+ *   Initialize a circular buffer to use the caller provided memory.
+ *
+ ****************************************************************************/
+
+int circbuf_init(FAR struct circbuf_s *circ, FAR void *base, size_t size)
+{
+  DEBUGASSERT(circ != NULL && base != NULL);
+
+  /* The size must be a power of two so that the free running indices
+   * remain correct when they wrap.
+   */
+
+  if (size == 0 || (size & (size - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  circ->base = (FAR uint8_t *)base;
+  circ->size = size;
+  circ->head = 0;
+  circ->tail = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: circbuf_reset
+ *
+ * Description:
+ *   Discard all buffered data.
+ *
+ ****************************************************************************/
+
+void circbuf_reset(FAR struct circbuf_s *circ)
+{
+  circ->head = 0;
+  circ->tail = 0;
+}
+
+/****************************************************************************
+ * Name: circbuf_write
+ *
+ * Description:
+ *   Copy data into the circular buffer.  Called only by the producer.
+ *
+ ****************************************************************************/
+
+size_t circbuf_write(FAR struct circbuf_s *circ, FAR const void *src,
+                     size_t len)
+{
+  FAR const uint8_t *data = (FAR const uint8_t *)src;
+  FAR void *ptr;
+  size_t total = 0;
+  size_t nbytes;
+
+  /* There are at most two contiguous free regions */
+
+  while (total < len && (nbytes = circbuf_peekwrite(circ, &ptr)) > 0)
+    {
+      if (nbytes > len - total)
+        {
+          nbytes = len - total;
+        }
+
+      memcpy(ptr, &data[total], nbytes);
+      circbuf_writecommit(circ, nbytes);
+      total += nbytes;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: circbuf_read
+ *
+ * Description:
+ *   Copy data out of the circular buffer.  Called only by the consumer.
+ *
+ ****************************************************************************/
+
+size_t circbuf_read(FAR struct circbuf_s *circ, FAR void *dest, size_t len)
+{
+  FAR uint8_t *data = (FAR uint8_t *)dest;
+  FAR void *ptr;
+  size_t total = 0;
+  size_t nbytes;
+
+  /* There are at most two contiguous data regions */
+
+  while (total < len && (nbytes = circbuf_peekread(circ, &ptr)) > 0)
+    {
+      if (nbytes > len - total)
+        {
+          nbytes = len - total;
+        }
+
+      memcpy(&data[total], ptr, nbytes);
+      circbuf_readcommit(circ, nbytes);
+      total += nbytes;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: circbuf_peekwrite
+ *
+ * Description:
+ *   Get the largest contiguous free region of the circular buffer.
+ *
+ ****************************************************************************/
+
+size_t circbuf_peekwrite(FAR struct circbuf_s *circ, FAR void **ptr)
+{
+  size_t head  = circ->head;
+  size_t space = circ->size - (size_t)(head - circ->tail);
+  size_t offset;
+  size_t nbytes;
+
+  /* Don't touch the free space until we know that the consumer is done
+   * with it.
+   */
+
+  CIRCBUF_BARRIER();
+
+  offset = head & (circ->size - 1);
+  nbytes = circ->size - offset;
+
+  *ptr = &circ->base[offset];
+  return nbytes < space ? nbytes : space;
+}
+
+/****************************************************************************
+ * Name: circbuf_writecommit
+ *
+ * Description:
+ *   Publish len bytes written in place after circbuf_peekwrite().
+ *
+ ****************************************************************************/
+
+void circbuf_writecommit(FAR struct circbuf_s *circ, size_t len)
+{
+  DEBUGASSERT(len <= circbuf_space(circ));
+
+  /* The data must be visible before the new head index */
+
+  CIRCBUF_BARRIER();
+  circ->head += len;
+}
+
+/****************************************************************************
+ * Name: circbuf_peekread
+ *
+ * Description:
+ *   Get the largest contiguous region of buffered data.
+ *
+ ****************************************************************************/
+
+size_t circbuf_peekread(FAR struct circbuf_s *circ, FAR void **ptr)
+{
+  size_t tail = circ->tail;
+  size_t used = (size_t)(circ->head - tail);
+  size_t offset;
+  size_t nbytes;
+
+  /* Don't read the data until we have seen the new head index */
+
+  CIRCBUF_BARRIER();
+
+  offset = tail & (circ->size - 1);
+  nbytes = circ->size - offset;
+
+  *ptr = &circ->base[offset];
+  return nbytes < used ? nbytes : used;
+}
+
+/****************************************************************************
+ * Name: circbuf_readcommit
+ *
+ * Description:
+ *   Release len bytes consumed in place after circbuf_peekread().
+ *
+ ****************************************************************************/
+
+void circbuf_readcommit(FAR struct circbuf_s *circ, size_t len)
+{
+  DEBUGASSERT(len <= circbuf_used(circ));
+
+  /* We must be done with the data before the free space is released */
+
+  CIRCBUF_BARRIER();
+  circ->tail += len;
+}
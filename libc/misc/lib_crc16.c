@@ -53,17 +53,24 @@
  * Included Files
  ************************************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
 #include <stdint.h>
 #include <crc16.h>
 
+#ifdef CONFIG_LIB_CRC16_ARCH
+#  include <nuttx/arch.h>
+#endif
+
 /************************************************************************************************
  * Private Data
  ************************************************************************************************/
 
 /* crc16_tab calculated by Mark G. Mendel, Network Systems Corporation */
 
-static uint16_t crc16_tab[256] =
+#ifndef CONFIG_LIB_CRC16_ARCH
+static const uint16_t crc16_tab[256] =
 {
   0x0000,  0x1021,  0x2042,  0x3063,  0x4084,  0x50a5,  0x60c6,  0x70e7,
   0x8108,  0x9129,  0xa14a,  0xb16b,  0xc18c,  0xd1ad,  0xe1ce,  0xf1ef,
@@ -98,6 +105,7 @@ static uint16_t crc16_tab[256] =
   0xef1f,  0xff3e,  0xcf5d,  0xdf7c,  0xaf9b,  0xbfba,  0x8fd9,  0x9ff8,
   0x6e17,  0x7e36,  0x4e55,  0x5e74,  0x2e93,  0x3eb2,  0x0ed1,  0x1ef0
 };
+#endif
 
 /************************************************************************************************
  * Public Functions
@@ -112,6 +120,9 @@ static uint16_t crc16_tab[256] =
 
 uint16_t crc16part(FAR const uint8_t *src, size_t len, uint16_t crc16val)
 {
+#ifdef CONFIG_LIB_CRC16_ARCH
+  return up_crc16part(src, len, crc16val);
+#else
   size_t i;
 
   for (i = 0; i < len; i++)
@@ -120,6 +131,7 @@ uint16_t crc16part(FAR const uint8_t *src, size_t len, uint16_t crc16val)
     }
 
   return crc16val;
+#endif
 }
 
 /************************************************************************************************
@@ -40,10 +40,10 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
-#include <unistd.h>
+#include <stdio.h>
 #include <semaphore.h>
-#include <errno.h>
-#include <assert.h>
+
+#include <nuttx/fs/fs.h>
 
 #include "libc.h"
 
@@ -79,37 +79,18 @@ void lib_sem_initialize(FAR struct file_struct *stream)
 
 /****************************************************************************
  * lib_take_semaphore
+ *
+ * Description:
+ *   Take the stream lock on behalf of a stdio function, unless the caller
+ *   has taken over responsibility for locking with __fsetlocking().
+ *
  ****************************************************************************/
 
 void lib_take_semaphore(FAR struct file_struct *stream)
 {
-  pid_t my_pid = getpid();
-
-  /* Do I already have the semaphore? */
-
-  if (stream->fs_holder == my_pid)
+  if ((stream->fs_flags & __FS_FLAG_NOLOCK) == 0)
     {
-      /* Yes, just increment the number of references that I have */
-
-      stream->fs_counts++;
-    }
-  else
-    {
-      /* Take the semaphore (perhaps waiting) */
-
-      while (sem_wait(&stream->fs_sem) != 0)
-        {
-          /* The only case that an error should occr here is if the wait
-           * was awakened by a signal.
-           */
-
-          ASSERT(get_errno() == EINTR);
-        }
-
-      /* We have it.  Claim the stak and return */
-
-      stream->fs_holder = my_pid;
-      stream->fs_counts = 1;
+      flockfile(stream);
     }
 }
 
@@ -119,27 +100,9 @@ void lib_take_semaphore(FAR struct file_struct *stream)
 
 void lib_give_semaphore(FAR struct file_struct *stream)
 {
-  pid_t my_pid = getpid();
-
-  /* I better be holding at least one reference to the semaphore */
-
-  ASSERT(stream->fs_holder == my_pid);
-
-  /* Do I hold multiple references to the semphore */
-
-  if (stream->fs_counts > 1)
+  if ((stream->fs_flags & __FS_FLAG_NOLOCK) == 0)
     {
-      /* Yes, just release one count and return */
-
-      stream->fs_counts--;
-    }
-  else
-    {
-      /* Nope, this is the last reference I have */
-
-      stream->fs_holder = -1;
-      stream->fs_counts = 0;
-      ASSERT(sem_post(&stream->fs_sem) == 0);
+      funlockfile(stream);
     }
 }
 #endif /* CONFIG_STDIO_BUFFER_SIZE */
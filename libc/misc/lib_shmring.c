@@ -0,0 +1,345 @@
+/****************************************************************************
+ * libc/misc/lib_shmring.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/shm.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <errno.h>
+
+#include <nuttx/mm/shmring.h>
+
+#ifdef CONFIG_MM_SHM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHMRING_ALIGN(n)   (((n) + 7) & ~7)
+#define SHMRING_HDRSIZE    SHMRING_ALIGN(sizeof(struct shmring_s))
+#define SHMRING_SLOTHDR    SHMRING_ALIGN(sizeof(struct shmring_slot_s))
+
+#define shmring_barrier()  __sync_synchronize()
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmring_slot
+ *
+ * Description:
+ *   Return the slot that holds ring position 'pos'.
+ *
+ ****************************************************************************/
+
+static inline FAR struct shmring_slot_s *
+shmring_slot(FAR struct shmring_s *ring, uint32_t pos)
+{
+  return (FAR struct shmring_slot_s *)
+    ((FAR uint8_t *)ring + SHMRING_HDRSIZE +
+     (pos & (ring->nslots - 1)) * ring->stride);
+}
+
+/****************************************************************************
+ * Name: shmring_data2slot
+ *
+ * Description:
+ *   Return the slot that contains the message data at 'data'.
+ *
+ ****************************************************************************/
+
+static inline FAR struct shmring_slot_s *shmring_data2slot(FAR void *data)
+{
+  return (FAR struct shmring_slot_s *)((FAR uint8_t *)data - SHMRING_SLOTHDR);
+}
+
+/****************************************************************************
+ * Name: shmring_waitbell
+ *
+ * Description:
+ *   Wait on a doorbell.  'nwait' announces the waiter to the other side.
+ *   'ready' re-checks the condition after the announcement so that a
+ *   doorbell rung in between is not missed:  Either the condition is seen
+ *   to be true or the other side sees the announcement and changes the
+ *   doorbell word, so that shmwait() does not block.
+ *
+ * Returned Value:
+ *   Zero (OK) if the caller should re-check its condition; -EINTR if a
+ *   signal interrupted the wait.
+ *
+ ****************************************************************************/
+
+static int shmring_waitbell(FAR struct shmring_s *ring,
+                            FAR volatile uint32_t *bell,
+                            FAR volatile uint32_t *nwait,
+                            CODE bool (*ready)(FAR struct shmring_s *ring))
+{
+  uint32_t val = *bell;
+  int ret = OK;
+
+  (void)__sync_fetch_and_add(nwait, 1);
+  shmring_barrier();
+
+  if (!ready(ring) && shmwait(bell, val, NULL) < 0 && errno == EINTR)
+    {
+      ret = -EINTR;
+    }
+
+  (void)__sync_fetch_and_sub(nwait, 1);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: shmring_ringbell
+ *
+ * Description:
+ *   Ring a doorbell if anyone may be waiting on it.
+ *
+ ****************************************************************************/
+
+static void shmring_ringbell(FAR volatile uint32_t *bell,
+                             FAR volatile uint32_t *nwait)
+{
+  shmring_barrier();
+  if (*nwait != 0)
+    {
+      (void)__sync_fetch_and_add(bell, 1);
+      (void)shmwake(bell, INT_MAX);
+    }
+}
+
+/****************************************************************************
+ * Name: shmring_notfull and shmring_notempty
+ *
+ * Description:
+ *   Conditions for shmring_waitbell()
+ *
+ ****************************************************************************/
+
+static bool shmring_notfull(FAR struct shmring_s *ring)
+{
+  uint32_t pos = ring->head;
+
+  return (int32_t)(shmring_slot(ring, pos)->seq - pos) >= 0;
+}
+
+static bool shmring_notempty(FAR struct shmring_s *ring)
+{
+  uint32_t pos = ring->tail;
+
+  return shmring_slot(ring, pos)->seq == pos + 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmring_format
+ ****************************************************************************/
+
+int shmring_format(FAR void *mem, size_t size, size_t slotsize)
+{
+  FAR struct shmring_s *ring = (FAR struct shmring_s *)mem;
+  uint32_t stride;
+  uint32_t nslots;
+  uint32_t i;
+
+  stride = SHMRING_SLOTHDR + SHMRING_ALIGN(slotsize);
+  if (mem == NULL || slotsize == 0 || size < SHMRING_HDRSIZE + 2 * stride)
+    {
+      return -EINVAL;
+    }
+
+  /* Use the largest power of two number of slots that fits */
+
+  nslots = (size - SHMRING_HDRSIZE) / stride;
+  while ((nslots & (nslots - 1)) != 0)
+    {
+      nslots &= nslots - 1;
+    }
+
+  ring->magic    = 0;
+  ring->nslots   = nslots;
+  ring->slotsize = slotsize;
+  ring->stride   = stride;
+  ring->head     = 0;
+  ring->tail     = 0;
+  ring->rbell    = 0;
+  ring->rwait    = 0;
+  ring->wbell    = 0;
+  ring->wwait    = 0;
+
+  for (i = 0; i < nslots; i++)
+    {
+      shmring_slot(ring, i)->seq = i;
+    }
+
+  shmring_barrier();
+  ring->magic = SHMRING_MAGIC;
+  return nslots;
+}
+
+/****************************************************************************
+ * Name: shmring_reserve
+ ****************************************************************************/
+
+int shmring_reserve(FAR struct shmring_s *ring, FAR void **data, bool wait)
+{
+  FAR struct shmring_slot_s *slot;
+  uint32_t pos;
+  int32_t diff;
+  int ret;
+
+  for (; ; )
+    {
+      pos  = ring->head;
+      slot = shmring_slot(ring, pos);
+      diff = (int32_t)(slot->seq - pos);
+
+      if (diff == 0)
+        {
+          /* The slot is free.  Claim the position unless another producer
+           * got there first.
+           */
+
+          if (__sync_bool_compare_and_swap(&ring->head, pos, pos + 1))
+            {
+              *data = (FAR uint8_t *)slot + SHMRING_SLOTHDR;
+              return OK;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* The slot still holds a message from the previous lap:  The ring
+           * is full.
+           */
+
+          if (!wait)
+            {
+              return -EAGAIN;
+            }
+
+          ret = shmring_waitbell(ring, &ring->wbell, &ring->wwait,
+                                 shmring_notfull);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      /* Otherwise, another producer claimed the position.  Try again. */
+    }
+}
+
+/****************************************************************************
+ * Name: shmring_commit
+ ****************************************************************************/
+
+void shmring_commit(FAR struct shmring_s *ring, FAR void *data, size_t len)
+{
+  FAR struct shmring_slot_s *slot = shmring_data2slot(data);
+
+  slot->len = len;
+
+  /* The message must be complete before the sequence number says so.  The
+   * slot's sequence is still its position.
+   */
+
+  shmring_barrier();
+  slot->seq = slot->seq + 1;
+
+  shmring_ringbell(&ring->rbell, &ring->rwait);
+}
+
+/****************************************************************************
+ * Name: shmring_peek
+ ****************************************************************************/
+
+int shmring_peek(FAR struct shmring_s *ring, FAR void **data,
+                 FAR size_t *len, bool wait)
+{
+  FAR struct shmring_slot_s *slot;
+  int ret;
+
+  slot = shmring_slot(ring, ring->tail);
+  while (!shmring_notempty(ring))
+    {
+      if (!wait)
+        {
+          return -EAGAIN;
+        }
+
+      ret = shmring_waitbell(ring, &ring->rbell, &ring->rwait,
+                             shmring_notempty);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Do not read the message before the sequence number said it is there */
+
+  shmring_barrier();
+  *data = (FAR uint8_t *)slot + SHMRING_SLOTHDR;
+  *len  = slot->len;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmring_release
+ ****************************************************************************/
+
+void shmring_release(FAR struct shmring_s *ring)
+{
+  uint32_t pos = ring->tail;
+
+  /* Finish with the message before handing the slot to the next lap */
+
+  shmring_barrier();
+  shmring_slot(ring, pos)->seq = pos + ring->nslots;
+  ring->tail = pos + 1;
+
+  shmring_ringbell(&ring->wbell, &ring->wwait);
+}
+
+#endif /* CONFIG_MM_SHM */
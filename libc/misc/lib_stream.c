@@ -160,7 +160,8 @@ void lib_stream_release(FAR struct task_group_s *group)
 
       /* Release the IO buffer */
 
-      if (list->sl_streams[i].fs_bufstart)
+      if (list->sl_streams[i].fs_bufstart &&
+          (list->sl_streams[i].fs_flags & __FS_FLAG_UBF) == 0)
         {
 #ifndef CONFIG_BUILD_KERNEL
           /* Release memory from the user heap */
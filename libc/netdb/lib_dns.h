@@ -45,6 +45,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <stdbool.h>
 
 #include <sys/socket.h>
@@ -76,10 +77,29 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGLIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGLIFESEC 60
+#endif
+
+#ifndef CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT
+#  define CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT 30
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
 
+/* The maximum number of name servers that are queried together */
+
+#ifdef CONFIG_NETDB_RESOLVCONF
+#  ifndef CONFIG_NETDB_RESOLVCONF_NSERVERS
+#    define CONFIG_NETDB_RESOLVCONF_NSERVERS 4
+#  endif
+#  define DNS_MAX_SERVERS CONFIG_NETDB_RESOLVCONF_NSERVERS
+#else
+#  define DNS_MAX_SERVERS 1
+#endif
+
 #define DNS_MAX_ADDRSTR   48
 #define DNS_MAX_LINE      64
 #define NETDB_DNS_KEYWORD "nameserver"
@@ -179,7 +199,9 @@ int dns_bind(void);
  *
  * Description:
  *   Using the DNS resolver socket (sd), look up the the 'hostname', and
- *   return its IP address in 'ipaddr'
+ *   return its IP address in 'ipaddr'.  The A and AAAA queries are sent to
+ *   all name servers together and the first address received is returned.
+ *   Concurrent look-ups of the same hostname share a single query.
  *
  * Input Parameters:
  *   sd       - The socket descriptor previously initialized by dsn_bind().
@@ -191,7 +213,8 @@ int dns_bind(void);
  *     the returned address.
  *
  * Returned Value:
- *   Returns zero (OK) if the query was successful.
+ *   Returns zero (OK) if the query was successful.  -EADDRNOTAVAIL is
+ *   returned if the name servers report that the hostname has no address.
  *
  ****************************************************************************/
 
@@ -202,12 +225,15 @@ int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr,
  * Name: dns_save_answer
  *
  * Description:
- *   Same the last resolved hostname in the DNS cache
+ *   Save the last resolved hostname in the DNS cache
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
- *   addr     - The IP address associated with the hostname
+ *   addr     - The IP address associated with the hostname.  NULL records
+ *              that the hostname could not be resolved (negative caching).
  *   addrlen  - The size of the of the IP address.
+ *   ttl      - The time to live of the answer (seconds) reported by the
+ *              name server.  Zero means unknown.
  *
  * Returned Value:
  *   None
@@ -216,7 +242,8 @@ int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr,
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 void dns_save_answer(FAR const char *hostname,
-                     FAR const struct sockaddr *addr, socklen_t addrlen);
+                     FAR const struct sockaddr *addr, socklen_t addrlen,
+                     uint32_t ttl);
 #endif
 
 /****************************************************************************
@@ -237,7 +264,8 @@ void dns_save_answer(FAR const char *hostname,
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache.  -EADDRNOTAVAIL is returned if the cache
+ *   records that the hostname could not be resolved recently.
  *
  ****************************************************************************/
 
@@ -40,9 +40,12 @@
 #include <nuttx/config.h>
 
 #include <sys/time.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <time.h>
 #include <errno.h>
+#include <assert.h>
 #include <debug.h>
 
 #include "netdb/lib_dns.h"
@@ -61,6 +64,15 @@
 #  define DNS_CLOCK CLOCK_REALTIME
 #endif
 
+/* The cache entries are kept on hash chains.  There are as many chains as
+ * entries, so that the chains remain short.  Entries are linked by index;
+ * DNS_NOENTRY terminates a chain (CONFIG_NETDB_DNSCLIENT_ENTRIES is at
+ * most 255).
+ */
+
+#define DNS_NBUCKETS   CONFIG_NETDB_DNSCLIENT_ENTRIES
+#define DNS_NOENTRY    0xff
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -69,28 +81,209 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  time_t              ctime;      /* Creation time */
-#endif
+  time_t              expire;     /* Expiration time (zero: unused) */
+  uint8_t             next;       /* Next entry in the hash chain */
   char                name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
-  union dns_server_u  addr;       /* Resolved address */
+  union dns_server_u  addr;       /* Resolved address (AF_UNSPEC: negative) */
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
-
-/* This is the DNS resolver cache */
+/* This is the DNS resolver cache and the heads of its hash chains */
 
 static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
+static uint8_t g_dns_bucket[DNS_NBUCKETS];
+static bool g_dns_cacheinit;
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_now
+ *
+ * Description:
+ *   Return the current time in seconds, never zero.
+ *
+ ****************************************************************************/
+
+static time_t dns_now(void)
+{
+  struct timespec now;
+
+  /* Get the current time, using CLOCK_MONOTONIC if possible */
+
+  if (clock_gettime(DNS_CLOCK, &now) < 0 || now.tv_sec <= 0)
+    {
+      return 1;
+    }
+
+  return now.tv_sec;
+}
+
+/****************************************************************************
+ * Name: dns_hash
+ *
+ * Description:
+ *   Return the hash chain for a host name.  Only the part of the name that
+ *   is kept in the cache is hashed.
+ *
+ ****************************************************************************/
+
+static int dns_hash(FAR const char *hostname)
+{
+  uint32_t hash = 5381;
+  int i;
+
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_NAMESIZE && hostname[i] != '\0';
+       i++)
+    {
+      hash = (hash << 5) + hash + (uint8_t)hostname[i];
+    }
+
+  return hash % DNS_NBUCKETS;
+}
+
+/****************************************************************************
+ * Name: dns_cache_init
+ *
+ * Description:
+ *   Empty all hash chains on first use.
+ *
+ ****************************************************************************/
+
+static void dns_cache_init(void)
+{
+  if (!g_dns_cacheinit)
+    {
+      memset(g_dns_bucket, DNS_NOENTRY, sizeof(g_dns_bucket));
+      g_dns_cacheinit = true;
+    }
+}
+
+/****************************************************************************
+ * Name: dns_cache_remove
+ *
+ * Description:
+ *   Remove an entry from its hash chain and mark it unused.  'prev' is the
+ *   index of the preceding entry in the chain or DNS_NOENTRY if the entry
+ *   is at the head of the chain.
+ *
+ ****************************************************************************/
+
+static void dns_cache_remove(int bucket, int prev, int ndx)
+{
+  FAR struct dns_cache_s *entry = &g_dns_cache[ndx];
+
+  if (prev == DNS_NOENTRY)
+    {
+      g_dns_bucket[bucket] = entry->next;
+    }
+  else
+    {
+      g_dns_cache[prev].next = entry->next;
+    }
+
+  entry->expire = 0;
+  entry->next   = DNS_NOENTRY;
+}
+
+/****************************************************************************
+ * Name: dns_cache_lookup
+ *
+ * Description:
+ *   Find the entry for a host name, removing any expired entries found on
+ *   its hash chain along the way.  Returns the entry index or DNS_NOENTRY.
+ *
+ ****************************************************************************/
+
+static int dns_cache_lookup(FAR const char *hostname, int bucket,
+                            time_t now)
+{
+  FAR struct dns_cache_s *entry;
+  int prev = DNS_NOENTRY;
+  int next;
+  int ndx;
+
+  for (ndx = g_dns_bucket[bucket]; ndx != DNS_NOENTRY; ndx = next)
+    {
+      entry = &g_dns_cache[ndx];
+      next  = entry->next;
+
+      /* Compare as signed so that the test survives wrapping of time_t */
+
+      if ((long)(entry->expire - now) <= 0)
+        {
+          dns_cache_remove(bucket, prev, ndx);
+          continue;
+        }
+
+      /* Notice that because the names are truncated to
+       * CONFIG_NETDB_DNSCLIENT_NAMESIZE, this has the possibility of
+       * aliasing two names and returning the wrong entry from the cache.
+       */
+
+      if (strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
+        {
+          return ndx;
+        }
+
+      prev = ndx;
+    }
+
+  return DNS_NOENTRY;
+}
+
+/****************************************************************************
+ * Name: dns_cache_alloc
+ *
+ * Description:
+ *   Return the index of an unused entry.  If the cache is full, the entry
+ *   that would expire first is evicted.
+ *
+ ****************************************************************************/
+
+static int dns_cache_alloc(time_t now)
+{
+  FAR struct dns_cache_s *entry;
+  int victim = 0;
+  int bucket;
+  int prev;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_NETDB_DNSCLIENT_ENTRIES; ndx++)
+    {
+      entry = &g_dns_cache[ndx];
+      if (entry->expire == 0)
+        {
+          return ndx;
+        }
+
+      if ((long)(entry->expire - g_dns_cache[victim].expire) < 0)
+        {
+          victim = ndx;
+        }
+    }
+
+  /* Find the victim's predecessor on its hash chain and remove it */
+
+  entry  = &g_dns_cache[victim];
+  bucket = dns_hash(entry->name);
+  prev   = DNS_NOENTRY;
+
+  for (ndx = g_dns_bucket[bucket]; ndx != victim; ndx = g_dns_cache[ndx].next)
+    {
+      DEBUGASSERT(ndx != DNS_NOENTRY);
+      prev = ndx;
+    }
+
+  dns_cache_remove(bucket, prev, victim);
+  return victim;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,12 +292,15 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Name: dns_save_answer
  *
  * Description:
- *   Same the last resolved hostname in the DNS cache
+ *   Save the last resolved hostname in the DNS cache
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
- *   addr     - The IP address associated with the hostname
+ *   addr     - The IP address associated with the hostname.  NULL records
+ *              that the hostname could not be resolved (negative caching).
  *   addrlen  - The size of the of the IP address.
+ *   ttl      - The time to live of the answer (seconds) reported by the
+ *              name server.  Zero means unknown.
  *
  * Returned Value:
  *   None
@@ -112,60 +308,72 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  ****************************************************************************/
 
 void dns_save_answer(FAR const char *hostname,
-                     FAR const struct sockaddr *addr, socklen_t addrlen)
+                     FAR const struct sockaddr *addr, socklen_t addrlen,
+                     uint32_t ttl)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
-  int next;
+  uint32_t maxttl;
+  time_t now;
+  int bucket;
   int ndx;
 
-  /* Get exclusive access to the DNS cache */
-
-  dns_semtake();
+  /* Limit the lifetime of the entry */
 
-  /* Get the index to the new head of the list */
+  maxttl = addr != NULL ? CONFIG_NETDB_DNSCLIENT_LIFESEC :
+                          CONFIG_NETDB_DNSCLIENT_NEGLIFESEC;
+  if (maxttl > 0 && (ttl == 0 || ttl > maxttl))
+    {
+      ttl = maxttl;
+    }
 
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+  if (ttl == 0)
     {
-      next = 0;
+      /* Not to be cached at all */
+
+      return;
     }
 
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
+  /* Get exclusive access to the DNS cache */
+
+  dns_semtake();
+  dns_cache_init();
+
+  now    = dns_now();
+  bucket = dns_hash(hostname);
+
+  /* Replace any existing entry for the name; otherwise add a new entry at
+   * the head of the hash chain.
    */
 
-  if (next == g_dns_tail)
+  ndx = dns_cache_lookup(hostname, bucket, now);
+  if (ndx == DNS_NOENTRY)
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
-        {
-          tmp = 0;
-        }
-
-      g_dns_tail = tmp;
+      ndx                  = dns_cache_alloc(now);
+      entry                = &g_dns_cache[ndx];
+      entry->next          = g_dns_bucket[bucket];
+      g_dns_bucket[bucket] = ndx;
     }
 
-  /* Save the answer in the cache */
-
   entry = &g_dns_cache[ndx];
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
+  /* Save the answer in the cache */
 
-  (void)clock_settime(DNS_CLOCK, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
+  entry->expire = now + ttl;
+  if (entry->expire == 0)
+    {
+      entry->expire = 1;
+    }
 
   strncpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
-  memcpy(&entry->addr.addr, addr, addrlen);
-
-  /* Save the updated head index */
+  if (addr != NULL)
+    {
+      memcpy(&entry->addr.addr, addr, addrlen);
+    }
+  else
+    {
+      entry->addr.addr.sa_family = AF_UNSPEC;
+    }
 
-  g_dns_head = next;
   dns_semgive();
 }
 
@@ -187,7 +395,8 @@ void dns_save_answer(FAR const char *hostname,
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache.  -EADDRNOTAVAIL is returned if the cache
+ *   records that the hostname could not be resolved recently.
  *
  ****************************************************************************/
 
@@ -195,12 +404,8 @@ int dns_find_answer(FAR const char *hostname, FAR struct sockaddr *addr,
                     FAR socklen_t *addrlen)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
+  socklen_t inlen;
   int ret;
-#endif
-  int next;
   int ndx;
 
   /* If DNS not initialized, no need to proceed */
@@ -214,98 +419,53 @@ int dns_find_answer(FAR const char *hostname, FAR struct sockaddr *addr,
   /* Get exclusive access to the DNS cache */
 
   dns_semtake();
+  dns_cache_init();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time, using CLOCK_MONOTONIC if possible */
-
-  ret = clock_settime(DNS_CLOCK, &now);
-#endif
-
-  /* REVISIT: This is not thread safe */
-
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  ndx = dns_cache_lookup(hostname, dns_hash(hostname), dns_now());
+  if (ndx == DNS_NOENTRY)
     {
-      entry = &g_dns_cache[ndx];
-
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
-       */
-
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
-        {
-          next = 0;
-        }
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
-       */
-
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 && elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC)
-        {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
-
-          g_dns_tail = next;
-        }
-      else
-#endif
-        {
-          /* The entry has not expired, check for a name match.  Notice that
-           * because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
-           */
+      ret = -ENOENT;
+      goto errout_with_sem;
+    }
 
-          if (strncmp(hostname, entry->name, CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              socklen_t inlen;
+  entry = &g_dns_cache[ndx];
 
-              /* We have a match.  Return the resolved host address */
+  /* We have a match.  Return the resolved host address */
 
 #ifdef CONFIG_NET_IPv4
-              if (entry->addr.addr.sa_family == AF_INET)
-#ifdef CONFIG_NET_IPv6
-#endif
-                {
-                   inlen = sizeof(struct sockaddr_in);
-                }
+  if (entry->addr.addr.sa_family == AF_INET)
+    {
+      inlen = sizeof(struct sockaddr_in);
+    }
+  else
 #endif
-
 #ifdef CONFIG_NET_IPv6
-              else
-#ifdef CONFIG_NET_IPv4
-#endif
-                {
-                   inlen = sizeof(struct sockaddr_in6);
-                }
+  if (entry->addr.addr.sa_family == AF_INET6)
+    {
+      inlen = sizeof(struct sockaddr_in6);
+    }
+  else
 #endif
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              if (*addrlen < inlen)
-                {
-                  ret = -ERANGE;
-                  goto errout_with_sem;
-                }
+    {
+      /* A negative entry:  The name did not resolve */
 
-              /* Return the address information */
+      ret = -EADDRNOTAVAIL;
+      goto errout_with_sem;
+    }
 
-              memcpy(addr, &entry->addr.addr, inlen);
-              *addrlen = inlen;
+  /* Make sure that the address will fit in the caller-provided buffer. */
 
-              dns_semgive();
-              return OK;
-            }
-        }
+  if (*addrlen < inlen)
+    {
+      ret = -ERANGE;
+      goto errout_with_sem;
     }
 
-  ret = -ENOENT;
+  /* Return the address information */
+
+  memcpy(addr, &entry->addr.addr, inlen);
+  *addrlen = inlen;
+  ret = OK;
 
 errout_with_sem:
   dns_semgive();
@@ -313,4 +473,3 @@ errout_with_sem:
 }
 
 #endif /* CONFIG_NETDB_DNSCLIENT_ENTRIES > 0 */
-
@@ -40,14 +40,18 @@
  *
  ****************************************************************************/
 
+
 /****************************************************************************
  * Included Files
  ****************************************************************************/
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
+#include <semaphore.h>
 #include <errno.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <arpa/inet.h>
@@ -55,14 +59,17 @@
 #include <nuttx/net/dns.h>
 
 #include "netdb/lib_dns.h"
+#include "libc.h"
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* The maximum number of retries when asking for a name */
+/* The maximum number of times that the queries are sent to the name
+ * servers when no answer is received.
+ */
 
-#define MAX_RETRIES      8
+#define MAX_RETRIES      3
 
 /* Buffer sizes */
 
@@ -73,20 +80,40 @@
  * Private Types
  ****************************************************************************/
 
+/* The list of name servers to be queried */
+
 struct dns_query_s
 {
-  int sd;                         /* DNS server socket */
-  int result;                     /* Explanation of the failure */
-  FAR const char *hostname;       /* Hostname to lookup */
-  FAR struct sockaddr *addr;      /* Location to return host address */
-  FAR socklen_t *addrlen;         /* Length of the address */
+  int nservers;                   /* Number of name servers */
+  union dns_server_u servers[DNS_MAX_SERVERS];
 };
 
+/* This describes one look-up in progress.  Other look-ups of the same
+ * hostname wait for its result rather than sending their own queries.
+ */
+
+struct dns_inflight_s
+{
+  FAR struct dns_inflight_s *flink;
+  sem_t waitsem;                  /* Concurrent look-ups wait here */
+  int refs;                       /* Number of look-ups using the result */
+  int result;                     /* Result of the look-up */
+  socklen_t addrlen;              /* Size of the resolved address */
+  union dns_server_u addr;        /* The resolved address */
+  char hostname[1];               /* Hostname (allocated with the struct) */
+};
+
+#define SIZEOF_DNS_INFLIGHT_S(n) (sizeof(struct dns_inflight_s) + (n))
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_seqno;           /* Sequence number of the next request */
+static uint16_t g_seqno;          /* Sequence number of the next request */
+
+/* The list of look-ups in progress, protected by the DNS semaphore */
+
+static FAR struct dns_inflight_s *g_dns_inflight;
 
 /****************************************************************************
  * Private Functions
@@ -123,36 +150,38 @@ static FAR uint8_t *dns_parse_name(FAR uint8_t *query)
  * Name: dns_send_query
  *
  * Description:
- *   Runs through the list of names to see if there are any that have
- *   not yet been queried and, if so, sends out a query.
+ *   Send one query for the 'name' with the record type 'rectype' to the
+ *   name server at 'uaddr'.  All queries of one look-up use the same 'id'.
  *
  ****************************************************************************/
 
 static int dns_send_query(int sd, FAR const char *name,
-                          FAR union dns_server_u *uaddr, uint16_t rectype)
+                          FAR union dns_server_u *uaddr, uint16_t rectype,
+                          uint16_t id)
 {
   register FAR struct dns_header_s *hdr;
   FAR uint8_t *dest;
   FAR uint8_t *nptr;
   FAR const char *src;
   uint8_t buffer[SEND_BUFFER_SIZE];
-  uint8_t seqno;
   socklen_t addrlen;
   int errcode;
   int ret;
   int n;
 
-  /* Increment the sequence number */
+  /* Make sure that the encoded name and the trailer will fit */
 
-  dns_semtake();
-  seqno = g_seqno++;
-  dns_semgive();
+  if (strlen(name) + 12 + 6 > SEND_BUFFER_SIZE)
+    {
+      nerr("ERROR: Hostname too long: %s\n", name);
+      return -ENAMETOOLONG;
+    }
 
   /* Initialize the request header */
 
   hdr               = (FAR struct dns_header_s *)buffer;
   memset(hdr, 0, sizeof(struct dns_header_s));
-  hdr->id           = htons(seqno);
+  hdr->id           = htons(id);
   hdr->flags1       = DNS_FLAG1_RD;
   hdr->numquestions = HTONS(1);
   dest              = buffer + 12;
@@ -224,20 +253,27 @@ static int dns_send_query(int sd, FAR const char *name,
  * Name: dns_recv_response
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Receive one response and extract the first address from it.
+ *
+ * Returned Value:
+ *   Zero (OK) if an address was returned in 'addr' with its time to live
+ *   in 'ttl'.  Otherwise a negated errno value:
+ *
+ *   -EAGAIN        - No response was received before the timeout.
+ *   -EBADMSG       - Not a response to this look-up; it should be ignored.
+ *   -ENOENT        - The name server reports that the name does not exist.
+ *   -EADDRNOTAVAIL - The response holds no address.
  *
  ****************************************************************************/
 
-static int dns_recv_response(int sd, FAR struct sockaddr *addr,
-                             FAR socklen_t *addrlen)
+static int dns_recv_response(int sd, uint16_t id, FAR struct sockaddr *addr,
+                             FAR socklen_t *addrlen, FAR uint32_t *ttl)
 {
   FAR uint8_t *nameptr;
+  FAR uint8_t *endptr;
   char buffer[RECV_BUFFER_SIZE];
   FAR struct dns_answer_s *ans;
   FAR struct dns_header_s *hdr;
-#if 0 /* Not used */
-  uint8_t nquestions;
-#endif
   uint8_t nanswers;
   int errcode;
   int ret;
@@ -252,10 +288,21 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
       return -errcode;
     }
 
-  hdr = (FAR struct dns_header_s *)buffer;
+  hdr    = (FAR struct dns_header_s *)buffer;
+  endptr = (FAR uint8_t *)buffer + ret;
+
+  /* Discard anything that is not a response to this look-up, such as a
+   * late response to an earlier query.
+   */
+
+  if (ret < 12 || (hdr->flags1 & DNS_FLAG1_RESPONSE) == 0 ||
+      htons(hdr->id) != id)
+    {
+      ninfo("Ignoring response: ID %d\n", ret < 12 ? -1 : htons(hdr->id));
+      return -EBADMSG;
+    }
 
   ninfo("ID %d\n", htons(hdr->id));
-  ninfo("Query %d\n", hdr->flags1 & DNS_FLAG1_RESPONSE);
   ninfo("Error %d\n", hdr->flags2 & DNS_FLAG2_ERR_MASK);
   ninfo("Num questions %d, answers %d, authrr %d, extrarr %d\n",
         htons(hdr->numquestions), htons(hdr->numanswers),
@@ -263,7 +310,12 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
 
   /* Check for error */
 
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME)
+    {
+      ninfo("Name does not exist\n");
+      return -ENOENT;
+    }
+  else if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
     {
       nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
       return -EPROTO;
@@ -273,37 +325,13 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
    * and the extrarr are simply discarded.
    */
 
-#if 0 /* Not used */
-  nquestions = htons(hdr->numquestions);
-#endif
-  nanswers   = htons(hdr->numanswers);
+  nanswers = htons(hdr->numanswers);
 
   /* Skip the name in the question. TODO: This should really be
    * checked against the name in the question, to be sure that they
    * match.
    */
 
-#if defined(CONFIG_DEBUG_NET) && defined(CONFIG_DEBUG_INFO)
-  {
-    int d = 64;
-    nameptr = dns_parse_name((uint8_t *)buffer + 12) + 4;
-
-    for (; ; )
-      {
-        ninfo("%02X %02X %02X %02X %02X %02X %02X %02X \n",
-              nameptr[0], nameptr[1], nameptr[2], nameptr[3],
-              nameptr[4], nameptr[5], nameptr[6], nameptr[7]);
-
-        nameptr += 8;
-        d -= 8;
-        if (d < 0)
-          {
-            break;
-          }
-      }
-  }
-#endif
-
   nameptr = dns_parse_name((uint8_t *)buffer + 12) + 4;
 
   for (; nanswers > 0; nanswers--)
@@ -326,6 +354,13 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
           nameptr = dns_parse_name(nameptr);
         }
 
+      /* Don't read beyond the end of a truncated response */
+
+      if (nameptr + 10 > endptr)
+        {
+          break;
+        }
+
       ans = (FAR struct dns_answer_s *)nameptr;
 
       ninfo("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x \n",
@@ -333,6 +368,11 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
             (htons(ans->ttl[0]) << 16) | htons(ans->ttl[1]),
             htons(ans->len));
 
+      if (nameptr + 10 + htons(ans->len) > endptr)
+        {
+          break;
+        }
+
       /* Check for IPv4/6 address type and Internet class. Others are discarded. */
 
 #ifdef CONFIG_NET_IPv4
@@ -358,6 +398,8 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
               inaddr->sin_addr.s_addr = ans->u.ipv4.s_addr;
 
               *addrlen = sizeof(struct sockaddr_in);
+              *ttl     = ((uint32_t)htons(ans->ttl[0]) << 16) |
+                         htons(ans->ttl[1]);
               return OK;
             }
           else
@@ -385,11 +427,13 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
               FAR struct sockaddr_in6 *inaddr;
 
               inaddr                  = (FAR struct sockaddr_in6 *)addr;
-              inaddr->sin6_family      = AF_INET;
-              inaddr->sin6_port        = 0;
+              inaddr->sin6_family     = AF_INET6;
+              inaddr->sin6_port       = 0;
               memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
               *addrlen = sizeof(struct sockaddr_in6);
+              *ttl     = ((uint32_t)htons(ans->ttl[0]) << 16) |
+                         htons(ans->ttl[1]);
               return OK;
             }
           else
@@ -408,212 +452,292 @@ static int dns_recv_response(int sd, FAR struct sockaddr *addr,
 }
 
 /****************************************************************************
- * Name: dns_query_callback
+ * Name: dns_query_server
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the the
- *   hostname.
+ *   dns_foreach_nameserver() callback that adds one name server address to
+ *   the list of name servers to be queried.
  *
  * Input Parameters:
- *   arg      - Query arguements
+ *   arg      - The name server list
  *   addr     - DNS name server address
  *   addrlen  - Length of the DNS name server address.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   Returns one (1) to stop the traversal when the list is full.  Zero is
+ *   returned in all other cases.
  *
  ****************************************************************************/
 
-static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
+static int dns_query_server(FAR void *arg, FAR struct sockaddr *addr,
                               FAR socklen_t addrlen)
 {
   FAR struct dns_query_s *query = (FAR struct dns_query_s *)arg;
+
+#ifdef CONFIG_NET_IPv4
+  if (addr->sa_family == AF_INET && addrlen >= sizeof(struct sockaddr_in))
+    {
+      memcpy(&query->servers[query->nservers], addr,
+             sizeof(struct sockaddr_in));
+      query->nservers++;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (addr->sa_family == AF_INET6 && addrlen >= sizeof(struct sockaddr_in6))
+    {
+      memcpy(&query->servers[query->nservers], addr,
+             sizeof(struct sockaddr_in6));
+      query->nservers++;
+    }
+  else
+#endif
+    {
+      /* Skip this address and continue with the next nameserver address
+       * in resolv.conf.
+       */
+
+      nerr("ERROR: Invalid name server address: family=%d size=%d\n",
+           addr->sa_family, addrlen);
+      return 0;
+    }
+
+  return query->nservers >= DNS_MAX_SERVERS ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: dns_lookup
+ *
+ * Description:
+ *   Send the A and AAAA queries for the 'hostname' to all name servers,
+ *   then collect the responses until one of them provides an address.  The
+ *   queries are sent again if no response is received before the timeout.
+ *   Both positive and negative results are saved in the DNS cache.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EADDRNOTAVAIL if the name servers report that
+ *   the hostname has no address; some other negated errno value if the
+ *   name servers could not be reached.
+ *
+ ****************************************************************************/
+
+static int dns_lookup(int sd, FAR const char *hostname,
+                      FAR struct sockaddr *addr, FAR socklen_t *addrlen)
+{
+  struct dns_query_s query;
+  uint32_t ttl;
+  uint16_t id;
   int retries;
+  int pending;
+  int nsent;
+  int nodata;
+  int result;
   int ret;
+  int i;
 
-  /* Loop while receive timeout errors occur and there are remaining retries */
+  /* Get the list of name servers */
 
-  for (retries = 0; retries < 3; retries++)
+  query.nservers = 0;
+  ret = dns_foreach_nameserver(dns_query_server, &query);
+  if (ret < 0)
     {
-#ifdef CONFIG_NET_IPv4
-      /* Is this an IPv4 address? */
+      return ret;
+    }
 
-      if (addr->sa_family == AF_INET)
-        {
-          /* Yes.. verify the address size */
+  if (query.nservers == 0)
+    {
+      nerr("ERROR: No name server address\n");
+      return -EADDRNOTAVAIL;
+    }
 
-          if (addrlen < sizeof(struct sockaddr_in))
-            {
-              /* Return zero to skip this address and try the next
-               * namserver address in resolv.conf.
-               */
+  /* All queries of this look-up share one sequence number */
 
-              nerr("ERROR: Invalid IPv4 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
-            }
+  dns_semtake();
+  id = g_seqno++;
+  dns_semgive();
 
-          /* Send the IPv4 query */
+  result = -ETIMEDOUT;
+  for (retries = 0; retries < MAX_RETRIES; retries++)
+    {
+      /* Send the queries to all name servers */
 
-          ret = dns_send_query(query->sd, query->hostname,
-                               (FAR union dns_server_u *)addr,
-                               DNS_RECTYPE_A);
-          if (ret < 0)
+      nsent = 0;
+      for (i = 0; i < query.nservers; i++)
+        {
+#ifdef CONFIG_NET_IPv4
+          ret = dns_send_query(sd, hostname, &query.servers[i],
+                               DNS_RECTYPE_A, id);
+          if (ret >= 0)
             {
-              /* Return zero to skip this address and try the next
-               * namserver address in resolv.conf.
-               */
+              nsent++;
+            }
+          else
+            {
+              result = ret;
+            }
+#endif
 
-              nerr("ERROR: IPv4 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
+#ifdef CONFIG_NET_IPv6
+          ret = dns_send_query(sd, hostname, &query.servers[i],
+                               DNS_RECTYPE_AAAA, id);
+          if (ret >= 0)
+            {
+              nsent++;
+            }
+          else
+            {
+              result = ret;
             }
+#endif
+        }
+
+      if (nsent == 0)
+        {
+          /* Could not send to any name server */
 
-          /* Obtain the IPv4 response */
+          return result;
+        }
+
+      /* Collect responses until the first address is received, all
+       * queries have been answered or the receive timeout expires.
+       */
 
-          ret = dns_recv_response(query->sd, query->addr, query->addrlen);
+      nodata = 0;
+      for (pending = nsent; pending > 0; )
+        {
+          ret = dns_recv_response(sd, id, addr, addrlen, &ttl);
           if (ret >= 0)
             {
-              /* IPv4 response received successfully */
-
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
               /* Save the answer in the DNS cache */
 
-              dns_save_answer(query->hostname, query->addr, *query->addrlen);
+              dns_save_answer(hostname, addr, *addrlen, ttl);
 #endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
-
-              return 1;
+              return OK;
             }
-
-          /* Handle errors */
-
-          nerr("ERROR: IPv4 dns_recv_response failed: %d\n", ret);
-
-          if (ret != -EADDRNOTAVAIL)
+          else if (ret == -EBADMSG)
             {
-              /* The IPv4 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
+              /* Not a response to one of our queries */
 
-              query->result = -EADDRNOTAVAIL;
-              return 0;
+              continue;
             }
-          else if (ret != -EAGAIN)
+          else if (ret == -EAGAIN)
             {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next namserver
-               * address in resolv.conf.
-               */
+              /* Timed out.  Send the queries again. */
 
-              query->result = ret;
-              return 0;
+              result = -ETIMEDOUT;
+              break;
             }
-        }
-      else
-#endif /* CONFIG_NET_IPv4 */
-
-#ifdef CONFIG_NET_IPv6
-      /* Is this an IPv4 address? */
-
-      if (query->addr->sa_family == AF_INET6)
-        {
-          /* Yes.. verify the address size */
-
-          if (addrlen < sizeof(struct sockaddr_in6))
+          else if (ret == -ENOENT)
             {
-              /* Return zero to skip this address and try the next
-               * namserver address in resolv.conf.
+              /* The name does not exist.  No need to wait for any other
+               * response.
                */
 
-              nerr("ERROR: Invalid IPv6 address size: %d\n", addrlen);
-              query->result = -EINVAL;
-              return 0;
+              nodata = nsent;
+              break;
             }
-
-          /* Send the IPv6 query */
-
-          ret = dns_send_query(query->sd, query->hostname,
-                              (FAR union dns_server_u *)addr,
-                               DNS_RECTYPE_AAAA);
-          if (ret < 0)
+          else if (ret == -EADDRNOTAVAIL)
             {
-              /* Return zero to skip this address and try the next
-               * namserver address in resolv.conf.
-               */
-
-              nerr("ERROR: IPv6 dns_send_query failed: %d\n", ret);
-              query->result = ret;
-              return 0;
+              nodata++;
             }
-
-          /* Obtain the IPv6 response */
-
-          ret = dns_recv_response(query->sd, query->addr, query->addrlen);
-          if (ret >= 0)
+          else
             {
-              /* IPv6 response received successfully */
+              result = ret;
+            }
+
+          pending--;
+        }
 
+      if (nodata > 0)
+        {
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-              /* Save the answer in the DNS cache */
+          /* Remember a definitive negative answer so that repeated
+           * look-ups of the bad name do not cause more network traffic.
+           */
 
-              dns_save_answer(query->hostname, query->addr, *query->addrlen);
+          if (nodata >= nsent)
+            {
+              dns_save_answer(hostname, NULL, 0, 0);
+            }
 #endif
-              /* Return 1 to indicate to (1) stop the traversal, and (2)
-               * indicate that the address was found.
-               */
+          return -EADDRNOTAVAIL;
+        }
 
-              return 1;
-            }
+      if (pending == 0 && result != -ETIMEDOUT)
+        {
+          /* Every name server reported a failure */
 
-          /* Handle errors */
+          return result;
+        }
+    }
 
-          nerr("ERROR: IPv6 dns_recv_response failed: %d\n", ret);
+  return result;
+}
 
-          if (ret != -EADDRNOTAVAIL)
-            {
-              /* The IPv6 address is not available.  Return zero to
-               * continue the tranversal with the next nameserver
-               * address in resolv.conf.
-               */
+/****************************************************************************
+ * Name: dns_inflight_wait
+ *
+ * Description:
+ *   Wait for the result of a look-up in progress, ignoring errors due to
+ *   the receipt of signals.
+ *
+ ****************************************************************************/
 
-              query->result = -EADDRNOTAVAIL;
-              return 0;
-            }
-          else if (ret != -EAGAIN)
-            {
-              /* Some failure other than receive timeout occurred.  Return
-               * zero to skip this address and try the next namserver
-               * address in resolv.conf.
-               */
+static void dns_inflight_wait(FAR struct dns_inflight_s *req)
+{
+  int errcode = 0;
+  int ret;
 
-              query->result = ret;
-              return 0;
-            }
+  do
+    {
+       ret = sem_wait(&req->waitsem);
+       if (ret < 0)
+         {
+           errcode = get_errno();
+           DEBUGASSERT(errcode == EINTR);
+         }
+    }
+  while (ret < 0 && errcode == EINTR);
+}
+
+/****************************************************************************
+ * Name: dns_inflight_release
+ *
+ * Description:
+ *   Copy the result of a look-up to the caller and drop one reference to
+ *   the look-up, freeing it with the last reference.  The caller must hold
+ *   the DNS semaphore.
+ *
+ ****************************************************************************/
+
+static int dns_inflight_release(FAR struct dns_inflight_s *req,
+                                FAR struct sockaddr *addr,
+                                FAR socklen_t *addrlen)
+{
+  int ret = req->result;
+
+  if (ret >= 0)
+    {
+      if (*addrlen < req->addrlen)
+        {
+          ret = -ERANGE;
         }
       else
-#endif
         {
-           /* Unsupported address family. Return zero to continue the
-            * tranversal with the next nameserver address in resolv.conf.
-            */
-
-           return 0;
+          memcpy(addr, &req->addr, req->addrlen);
+          *addrlen = req->addrlen;
         }
     }
 
-  /* We tried three times and could not communicate with this nameserver.
-   * Perhaps it is down?  Return zero to continue with the next address
-   * in the resolv.conf file.
-   */
+  DEBUGASSERT(req->refs > 0);
+  if (--req->refs == 0)
+    {
+      sem_destroy(&req->waitsem);
+      lib_free(req);
+    }
 
-  query->result = -ETIMEDOUT;
-  return 0;
+  return ret;
 }
 
 /****************************************************************************
@@ -625,7 +749,9 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  *
  * Description:
  *   Using the DNS resolver socket (sd), look up the the 'hostname', and
- *   return its IP address in 'ipaddr'
+ *   return its IP address in 'ipaddr'.  The A and AAAA queries are sent to
+ *   all name servers together and the first address received is returned.
+ *   Concurrent look-ups of the same hostname share a single query.
  *
  * Input Parameters:
  *   sd       - The socket descriptor previously initialized by dsn_bind().
@@ -637,42 +763,94 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  *     the returned address.
  *
  * Returned Value:
- *   Returns zero (OK) if the query was successful.
+ *   Returns zero (OK) if the query was successful.  -EADDRNOTAVAIL is
+ *   returned if the name servers report that the hostname has no address.
  *
  ****************************************************************************/
 
 int dns_query(int sd, FAR const char *hostname, FAR struct sockaddr *addr,
               FAR socklen_t *addrlen)
 {
-  FAR struct dns_query_s query;
+  FAR struct dns_inflight_s *req;
+  FAR struct dns_inflight_s *prev;
   int ret;
+  int i;
 
-  /* Set up the query info structure */
+  /* Is the same hostname already being looked up? */
 
-  query.sd       = sd;
-  query.result   = -EADDRNOTAVAIL;
-  query.hostname = hostname;
-  query.addr     = addr;
-  query.addrlen  = addrlen;
+  dns_semtake();
+  for (req = g_dns_inflight; req != NULL; req = req->flink)
+    {
+      if (strcmp(req->hostname, hostname) == 0)
+        {
+          break;
+        }
+    }
+
+  if (req != NULL)
+    {
+      /* Yes.. wait for the result of that look-up */
+
+      req->refs++;
+      dns_semgive();
+
+      dns_inflight_wait(req);
+
+      dns_semtake();
+      ret = dns_inflight_release(req, addr, addrlen);
+      dns_semgive();
+      return ret;
+    }
+
+  /* No.. Register this look-up so that others can share its result */
+
+  req = (FAR struct dns_inflight_s *)
+    lib_malloc(SIZEOF_DNS_INFLIGHT_S(strlen(hostname)));
+  if (req == NULL)
+    {
+      /* Just perform the look-up without sharing it */
+
+      dns_semgive();
+      return dns_lookup(sd, hostname, addr, addrlen);
+    }
 
-  /* Perform the query. dns_foreach_nameserver() will return:
-   *
-   *  1 - The query was successful.
-   *  0 - Look up failed
-   * <0 - Some other failure (?, shouldn't happen)
+  sem_init(&req->waitsem, 0, 0);
+  strcpy(req->hostname, hostname);
+  req->refs       = 1;
+  req->addrlen    = sizeof(union dns_server_u);
+  req->flink      = g_dns_inflight;
+  g_dns_inflight  = req;
+  dns_semgive();
+
+  /* Perform the look-up */
+
+  req->result = dns_lookup(sd, hostname, &req->addr.addr, &req->addrlen);
+
+  /* Remove the look-up from the list and wake up all look-ups waiting for
+   * its result.
    */
 
-  ret = dns_foreach_nameserver(dns_query_callback, &query);
-  if (ret > 0)
+  dns_semtake();
+  if (g_dns_inflight == req)
+    {
+      g_dns_inflight = req->flink;
+    }
+  else
     {
-      /* The lookup was successful */
+      for (prev = g_dns_inflight; prev->flink != req; prev = prev->flink)
+        {
+          DEBUGASSERT(prev->flink != NULL);
+        }
 
-      ret = OK;
+      prev->flink = req->flink;
     }
-  else if (ret == 0)
+
+  for (i = 1; i < req->refs; i++)
     {
-      ret = query.result;
+      sem_post(&req->waitsem);
     }
 
+  ret = dns_inflight_release(req, addr, addrlen);
+  dns_semgive();
   return ret;
 }
@@ -763,14 +763,21 @@ int gethostbyname_r(FAR const char *name, FAR struct hostent *host,
     }
 #endif
 
-  /* Try to get the host address using the DNS name server */
+  /* Try to get the host address using the DNS name server, unless the
+   * cache records that the name servers recently failed to resolve it.
+   */
 
-  ret = lib_dns_lookup(name, host, buf, buflen);
-  if (ret >= 0)
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  if (ret != -EADDRNOTAVAIL)
+#endif
     {
-      /* Successful DNS lookup! */
+      ret = lib_dns_lookup(name, host, buf, buflen);
+      if (ret >= 0)
+        {
+          /* Successful DNS lookup! */
 
-      return OK;
+          return OK;
+        }
     }
 #endif /* CONFIG_NETDB_DNSCLIENT */
 
@@ -0,0 +1,101 @@
+/****************************************************************************
+ * libc/pthread/pthread_condbroadcast.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+#include <limits.h>
+#include <errno.h>
+
+#include <nuttx/pthread.h>
+
+#if defined(CONFIG_PTHREAD_FUTEX) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function:  pthread_cond_broadcast
+ *
+ * Description:
+ *   Wake all threads waiting on a user-space condition variable.  The
+ *   kernel is entered only if there is a waiter.  The waiters are moved
+ *   onto the mutex rather than all being awakened to contend for it.
+ *
+ * Parameters:
+ *   cond - The condition variable to broadcast
+ *
+ * Return Value:
+ *   0 on success or EINVAL.
+ *
+ ****************************************************************************/
+
+int pthread_cond_broadcast(FAR pthread_cond_t *cond)
+{
+  FAR pthread_mutex_t *mutex;
+
+  if (cond == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* Wake only one waiter and requeue the others onto the mutex.  The
+   * awakened thread marks the mutex contended when it locks it, so each
+   * unlock passes the mutex on to the next of the requeued waiters.
+   */
+
+  (void)__sync_fetch_and_add(&cond->seq, 1);
+  if (cond->nwaiters > 0)
+    {
+      mutex = cond->mutex;
+      if (mutex != NULL)
+        {
+          (void)futex_requeue(&cond->seq, 1, &mutex->futex, INT_MAX);
+        }
+      else
+        {
+          (void)futex_wake(&cond->seq, INT_MAX);
+        }
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_PTHREAD_FUTEX && !__KERNEL__ */
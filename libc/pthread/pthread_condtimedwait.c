@@ -0,0 +1,115 @@
+/****************************************************************************
+ * libc/pthread/pthread_condtimedwait.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/pthread.h>
+
+#if defined(CONFIG_PTHREAD_FUTEX) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function:  pthread_cond_timedwait
+ *
+ * Description:
+ *   Wait on a user-space condition variable.  The caller notes the signal
+ *   sequence number before unlocking the mutex and then blocks only if no
+ *   signal has been sent since.  A NULL abstime (used by pthread_cond_wait)
+ *   waits forever.
+ *
+ * Parameters:
+ *   cond    - The condition variable to wait on
+ *   mutex   - The mutex held by the caller
+ *   abstime - The CLOCK_REALTIME time at which to give up
+ *
+ * Return Value:
+ *   0 on success (including spurious wake-ups), ETIMEDOUT, or EINVAL.
+ *
+ ****************************************************************************/
+
+int pthread_cond_timedwait(FAR pthread_cond_t *cond,
+                           FAR pthread_mutex_t *mutex,
+                           FAR const struct timespec *abstime)
+{
+  int ret = OK;
+  int seq;
+
+  if (cond == NULL || mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* Announce the waiter before sampling the sequence number so that a
+   * signaller that does not see us cannot have sent its signal after the
+   * sample.
+   */
+
+  (void)__sync_fetch_and_add(&cond->nwaiters, 1);
+  seq = cond->seq;
+  cond->mutex = mutex;
+
+  (void)pthread_mutex_unlock(mutex);
+
+  if (futex_wait(&cond->seq, seq, abstime) < 0 && get_errno() == ETIMEDOUT)
+    {
+      ret = ETIMEDOUT;
+    }
+
+  (void)__sync_fetch_and_sub(&cond->nwaiters, 1);
+
+  /* Relock the mutex.  pthread_cond_broadcast() may have requeued other
+   * waiters onto the mutex, so always mark it contended so that they are
+   * awakened when we unlock it.
+   */
+
+  while (__sync_lock_test_and_set(&mutex->futex, 2) != 0)
+    {
+      (void)futex_wait(&mutex->futex, 2, NULL);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_PTHREAD_FUTEX && !__KERNEL__ */
@@ -0,0 +1,106 @@
+/****************************************************************************
+ * libc/pthread/pthread_mutexlock.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/pthread.h>
+
+#if defined(CONFIG_PTHREAD_FUTEX) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function:  pthread_mutex_lock
+ *
+ * Description:
+ *   Lock a user-space mutex.  An uncontended lock is a single atomic
+ *   compare-and-swap of the futex word from 0 (unlocked) to 1 (locked).
+ *   Otherwise, the word is set to 2 (locked with waiters) and the caller
+ *   blocks in the kernel until the holder unlocks the mutex.
+ *
+ * Parameters:
+ *   mutex - The mutex to be locked
+ *
+ * Return Value:
+ *   0 on success or an error code.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
+{
+  int state;
+
+  if (mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* The fast path:  The mutex was unlocked */
+
+  state = __sync_val_compare_and_swap(&mutex->futex, 0, 1);
+  if (state == 0)
+    {
+      return OK;
+    }
+
+  /* The slow path:  Mark the mutex contended, then wait until we are the
+   * one that changed it from unlocked.  Since we cannot know whether other
+   * threads are still waiting, we always leave it marked contended.
+   */
+
+  if (state != 2)
+    {
+      state = __sync_lock_test_and_set(&mutex->futex, 2);
+    }
+
+  while (state != 0)
+    {
+      (void)futex_wait(&mutex->futex, 2, NULL);
+      state = __sync_lock_test_and_set(&mutex->futex, 2);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_PTHREAD_FUTEX && !__KERNEL__ */
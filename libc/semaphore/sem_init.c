@@ -114,6 +114,12 @@ int sem_init(FAR sem_t *sem, int pshared, unsigned int value)
       sem->holder.htcb   = NULL;
       sem->holder.counts = 0;
 #  endif
+#endif
+
+      /* The semaphore has no name (and no statistics) until sem_setname() */
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+      sem->lockstat      = NULL;
 #endif
       return OK;
     }
@@ -114,7 +114,8 @@ int fclose(FAR FILE *stream)
 
       /* Release the buffer */
 
-      if (stream->fs_bufstart)
+      if (stream->fs_bufstart &&
+          (stream->fs_flags & __FS_FLAG_UBF) == 0)
         {
           lib_free(stream->fs_bufstart);
         }
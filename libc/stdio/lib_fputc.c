@@ -92,18 +92,6 @@ int fputc(int c, FAR FILE *stream)
   ret = lib_fwrite(&buf, 1, stream);
   if (ret > 0)
     {
-      /* Flush the buffer if a newline is output */
-
-#ifdef CONFIG_STDIO_LINEBUFFER
-      if (c == '\n')
-        {
-          ret = lib_fflush(stream, true);
-          if (ret < 0)
-            {
-              return EOF;
-            }
-        }
-#endif
       return c;
     }
   else
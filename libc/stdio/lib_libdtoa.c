@@ -44,6 +44,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 
 #include "libc.h"
@@ -54,6 +56,16 @@
 
 #define MAX_PREC 16
 
+/* The exact fixed point conversion in lib_fixeddtoa() handles values whose
+ * fraction fits in 124 bits (i.e., about 1e-21 and larger), integer parts
+ * that fit in 64 bits and up to FIX_MAXPREC digits after the decimal point.
+ * Anything else is left to __dtoa().
+ */
+
+#define FIX_MAXPREC  40
+#define FIX_MAXFRAC  124
+#define FIX_BUFSIZE  (1 + 20 + FIX_MAXPREC + 1)
+
 #ifndef MIN
 #  define MIN(a,b) (a < b ? a : b)
 #endif
@@ -66,6 +78,16 @@
  * Private Type Declarations
  ****************************************************************************/
 
+#ifdef CONFIG_HAVE_LONG_LONG
+/* A 128-bit fixed point fraction */
+
+struct fix128_s
+{
+  uint64_t hi;
+  uint64_t lo;
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -90,6 +112,260 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fix128_mul10
+ *
+ * Description:
+ *   Multiply the fraction by ten and return the integer digit that moves
+ *   above the binary point at 'point'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HAVE_LONG_LONG
+static int fix128_mul10(FAR struct fix128_s *v, int point)
+{
+  uint64_t hi;
+  uint64_t lo;
+  uint64_t lo2;
+  int digit;
+
+  /* v * 10 = (v << 3) + (v << 1) */
+
+  hi  = (v->hi << 3) | (v->lo >> 61);
+  lo  = v->lo << 3;
+  lo2 = v->lo << 1;
+  hi += (v->hi << 1) | (v->lo >> 63);
+  lo += lo2;
+  if (lo < lo2)
+    {
+      hi++;
+    }
+
+  if (point >= 64)
+    {
+      digit = (int)(hi >> (point - 64));
+      hi   &= ((uint64_t)1 << (point - 64)) - 1;
+    }
+  else
+    {
+      digit = (int)((hi << (64 - point)) | (lo >> point));
+      hi    = 0;
+      lo   &= ((uint64_t)1 << point) - 1;
+    }
+
+  v->hi = hi;
+  v->lo = lo;
+  return digit;
+}
+
+/****************************************************************************
+ * Name: fix128_cmphalf
+ *
+ * Description:
+ *   Compare the fraction with one half:  Returns a value less than, equal
+ *   to or greater than zero.
+ *
+ ****************************************************************************/
+
+static int fix128_cmphalf(FAR const struct fix128_s *v, int point)
+{
+  struct fix128_s half;
+
+  half.hi = point > 64 ? (uint64_t)1 << (point - 65) : 0;
+  half.lo = point > 64 ? 0 : (uint64_t)1 << (point - 1);
+
+  if (v->hi != half.hi)
+    {
+      return v->hi < half.hi ? -1 : 1;
+    }
+
+  if (v->lo != half.lo)
+    {
+      return v->lo < half.lo ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lib_fixeddtoa
+ *
+ * Description:
+ *   Exact equivalent of __dtoa(value, 3, prec, ...) for the common case of
+ *   moderately sized values and precisions.  The value is split into a
+ *   64-bit integer part and a 128-bit binary fraction, and the fraction
+ *   digits are produced by multiplying by ten.  All arithmetic is exact, so
+ *   the result (including round-half-even on exact ties) is the same as
+ *   the big number conversion, but without any heap allocation.
+ *
+ * Input Parameters:
+ *   value - The positive, finite value to convert.
+ *   prec  - The number of digits to the right of the decimal point.
+ *   buf   - A buffer of FIX_BUFSIZE bytes to receive the digits.
+ *   decpt - Location to return the position of the decimal point.
+ *
+ * Returned Value:
+ *   A pointer to the NUL terminated digits, without trailing zeroes, or
+ *   NULL if the value cannot be handled here.
+ *
+ ****************************************************************************/
+
+static FAR char *lib_fixeddtoa(double value, int prec, FAR char *buf,
+                               FAR int *decpt)
+{
+  union
+  {
+    double   d;
+    uint64_t u;
+  } bits;
+
+  struct fix128_s frac;
+  FAR char *digits;
+  FAR char *end;
+  FAR char *ptr;
+  uint64_t ipart;
+  uint64_t mant;
+  int point;
+  int expo;
+  int ndigits;
+  int cmp;
+  int i;
+
+  if (prec < 0 || prec > FIX_MAXPREC)
+    {
+      return NULL;
+    }
+
+  bits.d = value;
+  mant   = bits.u & (((uint64_t)1 << 52) - 1);
+  expo   = (int)((bits.u >> 52) & 0x7ff);
+
+  if (expo == 0)
+    {
+      if (mant == 0)
+        {
+          /* This is what __dtoa() returns for zero */
+
+          *decpt = 1;
+          buf[0] = '0';
+          buf[1] = '\0';
+          return buf;
+        }
+
+      expo = -1074;
+    }
+  else
+    {
+      mant |= (uint64_t)1 << 52;
+      expo -= 1075;
+    }
+
+  if (expo > 11 || expo < -FIX_MAXFRAC)
+    {
+      return NULL;
+    }
+
+  /* value = ipart + frac / 2^point */
+
+  frac.hi = 0;
+  point   = expo < 0 ? -expo : 0;
+
+  if (expo >= 0)
+    {
+      ipart   = mant << expo;
+      frac.lo = 0;
+    }
+  else if (point < 64)
+    {
+      ipart   = mant >> point;
+      frac.lo = mant & (((uint64_t)1 << point) - 1);
+    }
+  else
+    {
+      ipart   = 0;
+      frac.lo = mant;
+    }
+
+  /* Integer digits, in buf[1..] so that buf[0] is left for a carry */
+
+  buf[0] = '0';
+  ptr    = &buf[FIX_BUFSIZE - 1];
+  *ptr   = '\0';
+  for (; ipart > 0; ipart /= 10)
+    {
+      *--ptr = '0' + (int)(ipart % 10);
+    }
+
+  ndigits = &buf[FIX_BUFSIZE - 1] - ptr;
+  memmove(&buf[1], ptr, ndigits);
+  *decpt  = ndigits;
+  end     = &buf[1 + ndigits];
+
+  /* Fraction digits up to the requested precision */
+
+  for (i = 0; i < prec && (frac.hi | frac.lo) != 0; i++)
+    {
+      *end++ = '0' + fix128_mul10(&frac, point);
+    }
+
+  /* Round the remainder, half to even */
+
+  if ((frac.hi | frac.lo) != 0)
+    {
+      cmp = fix128_cmphalf(&frac, point);
+      if (cmp > 0 ||
+          (cmp == 0 && end > &buf[1] && ((end[-1] - '0') & 1) != 0))
+        {
+          for (ptr = end - 1; ptr >= &buf[1] && *ptr == '9'; ptr--)
+            {
+              *ptr = '0';
+            }
+
+          if (ptr >= &buf[1])
+            {
+              (*ptr)++;
+            }
+          else
+            {
+              /* Carry out of the first digit, including "nothing" rounded
+               * up to one in the last place.
+               */
+
+              *ptr = '1';
+              (*decpt)++;
+            }
+        }
+    }
+
+  /* Drop trailing and leading zeroes */
+
+  digits = buf[0] == '1' ? &buf[0] : &buf[1];
+  while (end > digits && end[-1] == '0')
+    {
+      end--;
+    }
+
+  *end = '\0';
+  while (*digits == '0')
+    {
+      digits++;
+      (*decpt)--;
+    }
+
+  /* Like __dtoa(), return "0" if nothing is left at this precision */
+
+  if (*digits == '\0')
+    {
+      *decpt    = 1;
+      digits    = &buf[1];
+      digits[0] = '0';
+      digits[1] = '\0';
+    }
+
+  return digits;
+}
+#endif
+
 /****************************************************************************
  * Name: zeroes
  *
@@ -149,6 +425,9 @@ static void lib_dtoa_string(FAR struct lib_outstream_s *obj, const char *str)
 static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
                      uint8_t flags, double value)
 {
+#ifdef CONFIG_HAVE_LONG_LONG
+  char fixbuf[FIX_BUFSIZE];
+#endif
   FAR char *digits;     /* String returned by __dtoa */
   FAR char *rve;        /* Points to the end of the return value */
   int  expt;            /* Integer value of exponent */
@@ -184,10 +463,22 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
       SET_NEGATE(flags);
     }
 
-  /* Perform the conversion */
+  /* Perform the conversion.  Try the exact fixed point conversion first and
+   * fall back to the big number __dtoa() for values that it cannot handle.
+   */
 
-  digits   = __dtoa(value, 3, prec, &expt, &dsgn, &rve);
-  numlen   = rve - digits;
+#ifdef CONFIG_HAVE_LONG_LONG
+  digits = lib_fixeddtoa(value, prec, fixbuf, &expt);
+  if (digits != NULL)
+    {
+      numlen = strlen(digits);
+    }
+  else
+#endif
+    {
+      digits = __dtoa(value, 3, prec, &expt, &dsgn, &rve);
+      numlen = rve - digits;
+    }
 
   /* Avoid precision error from missing trailing zeroes */
 
@@ -261,20 +552,14 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
 
       else
         {
-          /* Print the integer part to the left of the decimal point */
+          /* Print the integer part to the left of the decimal point,
+           * padding with zeroes if the digits run out.
+           */
 
-          for (i = expt; i > 0; i--)
-            {
-              if (*digits != '\0')
-                {
-                  obj->put(obj, *digits);
-                  digits++;
-                }
-              else
-                {
-                  obj->put(obj, '0');
-                }
-            }
+          for (i = 0; i < expt && digits[i] != '\0'; i++);
+          putrun(obj, digits, i);
+          digits += i;
+          zeroes(obj, expt - i);
 
           /* Get the length of the fractional part */
 
@@ -314,11 +599,7 @@ static void lib_dtoa(FAR struct lib_outstream_s *obj, int fmt, int prec,
 
       /* Print the fractional part to the right of the decimal point */
 
-      for (i = nchars; i > 0; i--)
-        {
-          obj->put(obj, *digits);
-          digits++;
-        }
+      putrun(obj, digits, nchars);
 
       /* Decrement to get the number of trailing zeroes to print */
 
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -128,6 +129,24 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
       size_t gulp_size = stream->fs_bufend - stream->fs_bufpos;
 
+      /* If the buffer is empty and the remaining data would fill it
+       * anyway, then write the data directly from the caller's memory.
+       * This also handles unbuffered streams which have no buffer.
+       */
+
+      if (stream->fs_bufpos == stream->fs_bufstart && count >= gulp_size)
+        {
+          ssize_t nwritten = write(stream->fs_fd, src, count);
+          if (nwritten <= 0)
+            {
+              goto errout_with_semaphore;
+            }
+
+          src   += nwritten;
+          count -= nwritten;
+          continue;
+        }
+
       /* Will the user data fit into the amount of buffer space
        * that we have left?
        */
@@ -168,6 +187,19 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
         }
     }
 
+  /* Flush the buffer if the stream is line buffered and a newline was
+   * written.
+   */
+
+  if ((stream->fs_flags & __FS_FLAG_LBF) != 0 &&
+      memchr(start, '\n', src - start) != NULL)
+    {
+      if (lib_fflush(stream, true) < 0)
+        {
+          goto errout_with_semaphore;
+        }
+    }
+
   /* Return the number of bytes written */
 
   ret = src - start;
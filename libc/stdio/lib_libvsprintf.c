@@ -126,6 +126,21 @@
 #  define FMT_PREV     src--                        /* Backup to the previous character */
 #endif
 
+/* Integer conversions are first made into a small buffer on the stack so
+ * that the converted value can be measured for field justification and then
+ * passed to the output stream as a single run.  The largest conversion is
+ * binary with one digit per bit.  Floating point conversions use the same
+ * buffer when they fit.
+ */
+
+#if defined(CONFIG_HAVE_LONG_LONG) && defined(CONFIG_LIBC_LONG_LONG)
+#  define NUMBUF_SIZE (8 * sizeof(unsigned long long) + 4)
+#elif defined(CONFIG_LONG_IS_NOT_INT)
+#  define NUMBUF_SIZE (8 * sizeof(unsigned long) + 4)
+#else
+#  define NUMBUF_SIZE (8 * sizeof(unsigned int) + 4)
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -142,6 +157,11 @@ enum
  * Private Function Prototypes
  ****************************************************************************/
 
+/* Output a run of characters */
+
+static void putrun(FAR struct lib_outstream_s *obj, FAR const char *buf,
+                   int len);
+
 /* Pointer to ASCII conversion */
 
 #ifdef CONFIG_PTR_IS_NOT_INT
@@ -164,7 +184,6 @@ static void utoascii(FAR struct lib_outstream_s *obj, uint8_t fmt,
 
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
 static void fixup(uint8_t fmt, FAR uint8_t *flags, int *n);
-static int  getusize(uint8_t fmt, uint8_t flags, unsigned int lln);
 #endif
 
 /* Unsigned long int to ASCII conversion */
@@ -179,7 +198,6 @@ static void lutoascii(FAR struct lib_outstream_s *obj, uint8_t fmt,
                       uint8_t flags, unsigned long ln);
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
 static void lfixup(uint8_t fmt, FAR uint8_t *flags, long *ln);
-static int  getlusize(uint8_t fmt, FAR uint8_t flags, unsigned long ln);
 #endif
 #endif
 
@@ -195,8 +213,6 @@ static void llutoascii(FAR struct lib_outstream_s *obj, uint8_t fmt,
                        uint8_t flags, unsigned long long lln);
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
 static void llfixup(uint8_t fmt, FAR uint8_t *flags, FAR long long *lln);
-static int  getllusize(uint8_t fmt, FAR uint8_t flags,
-                       FAR unsigned long long lln);
 #endif
 #endif
 
@@ -229,6 +245,32 @@ static const char g_nullstring[] = "(null)";
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: putrun
+ *
+ * Description:
+ *   Pass a run of characters to the output stream with one call to its
+ *   puts method, if it has one.  Otherwise, fall back to one call to the
+ *   put method per character.
+ *
+ ****************************************************************************/
+
+static void putrun(FAR struct lib_outstream_s *obj, FAR const char *buf,
+                   int len)
+{
+  if (obj->puts != NULL)
+    {
+      obj->puts(obj, buf, len);
+    }
+  else
+    {
+      for (; len > 0; len--)
+        {
+          obj->put(obj, *buf++);
+        }
+    }
+}
+
 /* Include floating point functions */
 
 #ifdef CONFIG_LIBC_FLOATINGPOINT
@@ -534,19 +576,6 @@ static void fixup(uint8_t fmt, FAR uint8_t *flags, FAR int *n)
     }
 }
 
-/****************************************************************************
- * Name: getusize
- ****************************************************************************/
-
-static int getusize(uint8_t fmt, uint8_t flags, unsigned int n)
-{
-  struct lib_outstream_s nulloutstream;
-  lib_nulloutstream(&nulloutstream);
-
-  utoascii(&nulloutstream, fmt, flags, n);
-  return nulloutstream.nput;
-}
-
 /****************************************************************************
  * Name: getdblsize
  ****************************************************************************/
@@ -798,20 +827,6 @@ static void lfixup(uint8_t fmt, FAR uint8_t *flags, FAR long *ln)
         break;
     }
 }
-
-/****************************************************************************
- * Name: getlusize
- ****************************************************************************/
-
-static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
-{
-  struct lib_outstream_s nulloutstream;
-  lib_nulloutstream(&nulloutstream);
-
-  lutoascii(&nulloutstream, fmt, flags, ln);
-  return nulloutstream.nput;
-}
-
 #endif /* CONFIG_NOPRINTF_FIELDWIDTH */
 #endif /* CONFIG_LONG_IS_NOT_INT */
 
@@ -1050,21 +1065,6 @@ static void llfixup(uint8_t fmt, FAR uint8_t *flags, FAR long long *lln)
         break;
     }
 }
-
-/****************************************************************************
- * Name: getllusize
- ****************************************************************************/
-
-static int getllusize(uint8_t fmt, uint8_t flags, unsigned long long lln)
-{
-  struct lib_outstream_s nulloutstream;
-  lib_nulloutstream(&nulloutstream);
-
-
-  llutoascii(&nulloutstream, fmt, flags, lln);
-  return nulloutstream.nput;
-}
-
 #endif /* CONFIG_NOPRINTF_FIELDWIDTH */
 #endif /* CONFIG_HAVE_LONG_LONG */
 
@@ -1179,6 +1179,8 @@ static void postjustify(FAR struct lib_outstream_s *obj, uint8_t fmt,
 int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
                  va_list ap)
 {
+  struct lib_memoutstream_s numstream;
+  char            numbuf[NUMBUF_SIZE];
   FAR char        *ptmp;
 #ifndef CONFIG_NOPRINTF_FIELDWIDTH
   int             width;
@@ -1198,9 +1200,28 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 
       if (FMT_CHAR != '%')
         {
+#ifdef CONFIG_ARCH_ROMGETC
            /* Output the character */
 
            obj->put(obj, FMT_CHAR);
+#else
+           /* Output the whole run of regular characters up to the next
+            * format specifier (or through the next newline) at once.
+            */
+
+           for (ptmp = (FAR char *)src; src[1] != '\0' && src[1] != '%';
+                src++)
+             {
+#ifdef CONFIG_STDIO_LINEBUFFER
+               if (*src == '\n')
+                 {
+                   break;
+                 }
+#endif
+             }
+
+           putrun(obj, ptmp, src - ptmp + 1);
+#endif
 
            /* Flush the buffer if a newline is encountered */
 
@@ -1371,9 +1392,8 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 
       if (FMT_CHAR == 's')
         {
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
           int swidth;
-#endif
+
           /* Get the string to output */
 
           ptmp = va_arg(ap, FAR char *);
@@ -1386,17 +1406,13 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
            * operations.
            */
 
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
           swidth = strlen(ptmp);
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
           prejustify(obj, fmt, 0, width, swidth);
 #endif
           /* Concatenate the string into the output */
 
-          while (*ptmp)
-            {
-              obj->put(obj, *ptmp);
-              ptmp++;
-            }
+          putrun(obj, ptmp, swidth);
 
           /* Perform left-justification operations. */
 
@@ -1443,37 +1459,36 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
           if (IS_LONGLONGPRECISION(flags) && FMT_CHAR != 'p')
             {
               long long lln;
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
-              int lluwidth;
-#endif
               /* Extract the long long value. */
 
               lln = va_arg(ap, long long);
 
-#ifdef CONFIG_NOPRINTF_FIELDWIDTH
-              /* Output the number */
-
-              llutoascii(obj, FMT_CHAR, flags, (unsigned long long)lln);
-#else
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Resolve sign-ness and format issues */
 
               llfixup(FMT_CHAR, &flags, &lln);
+#endif
+              /* Convert the number into the local buffer.  This also
+               * gives the width of the output.
+               */
 
-              /* Get the width of the output */
-
-              lluwidth = getllusize(FMT_CHAR, flags, lln);
+              lib_memoutstream(&numstream, numbuf, NUMBUF_SIZE);
+              llutoascii(&numstream.public, FMT_CHAR, flags,
+                         (unsigned long long)lln);
 
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Perform left field justification actions */
 
-              prejustify(obj, fmt, flags, width, lluwidth);
-
+              prejustify(obj, fmt, flags, width, numstream.public.nput);
+#endif
               /* Output the number */
 
-              llutoascii(obj, FMT_CHAR, flags, (unsigned long long)lln);
+              putrun(obj, numbuf, numstream.public.nput);
 
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Perform right field justification actions */
 
-              postjustify(obj, fmt, flags, width, lluwidth);
+              postjustify(obj, fmt, flags, width, numstream.public.nput);
 #endif
             }
           else
@@ -1482,37 +1497,36 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
           if (IS_LONGPRECISION(flags) && FMT_CHAR != 'p')
             {
               long ln;
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
-              int luwidth;
-#endif
               /* Extract the long value. */
 
               ln = va_arg(ap, long);
 
-#ifdef CONFIG_NOPRINTF_FIELDWIDTH
-              /* Output the number */
-
-              lutoascii(obj, FMT_CHAR, flags, (unsigned long)ln);
-#else
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Resolve sign-ness and format issues */
 
               lfixup(FMT_CHAR, &flags, &ln);
+#endif
+              /* Convert the number into the local buffer.  This also
+               * gives the width of the output.
+               */
 
-              /* Get the width of the output */
-
-              luwidth = getlusize(FMT_CHAR, flags, ln);
+              lib_memoutstream(&numstream, numbuf, NUMBUF_SIZE);
+              lutoascii(&numstream.public, FMT_CHAR, flags,
+                        (unsigned long)ln);
 
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Perform left field justification actions */
 
-              prejustify(obj, fmt, flags, width, luwidth);
-
+              prejustify(obj, fmt, flags, width, numstream.public.nput);
+#endif
               /* Output the number */
 
-              lutoascii(obj, FMT_CHAR, flags, (unsigned long)ln);
+              putrun(obj, numbuf, numstream.public.nput);
 
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Perform right field justification actions */
 
-              postjustify(obj, fmt, flags, width, luwidth);
+              postjustify(obj, fmt, flags, width, numstream.public.nput);
 #endif
             }
           else
@@ -1558,37 +1572,36 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 #endif
             {
               int n;
-#ifndef CONFIG_NOPRINTF_FIELDWIDTH
-              int uwidth;
-#endif
               /* Extract the long long value. */
 
               n = va_arg(ap, int);
 
-#ifdef CONFIG_NOPRINTF_FIELDWIDTH
-              /* Output the number */
-
-              utoascii(obj, FMT_CHAR, flags, (unsigned int)n);
-#else
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Resolve sign-ness and format issues */
 
               fixup(FMT_CHAR, &flags, &n);
+#endif
+              /* Convert the number into the local buffer.  This also
+               * gives the width of the output.
+               */
 
-              /* Get the width of the output */
-
-              uwidth = getusize(FMT_CHAR, flags, n);
+              lib_memoutstream(&numstream, numbuf, NUMBUF_SIZE);
+              utoascii(&numstream.public, FMT_CHAR, flags,
+                       (unsigned int)n);
 
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Perform left field justification actions */
 
-              prejustify(obj, fmt, flags, width, uwidth);
-
+              prejustify(obj, fmt, flags, width, numstream.public.nput);
+#endif
               /* Output the number */
 
-              utoascii(obj, FMT_CHAR, flags, (unsigned int)n);
+              putrun(obj, numbuf, numstream.public.nput);
 
+#ifndef CONFIG_NOPRINTF_FIELDWIDTH
               /* Perform right field justification actions */
 
-              postjustify(obj, fmt, flags, width, uwidth);
+              postjustify(obj, fmt, flags, width, numstream.public.nput);
 #endif
             }
         }
@@ -1602,21 +1615,39 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
           double dblval = va_arg(ap, double);
           int dblsize;
 
-          /* Get the width of the output */
+          /* Convert the number once into the number buffer so that its
+           * width is known.  Only if it does not fit is it converted twice:
+           * Once to get the width and once more to output it.
+           */
 
-          dblsize = getdblsize(FMT_CHAR, trunc, flags, dblval);
+          lib_memoutstream(&numstream, numbuf, NUMBUF_SIZE);
+          lib_dtoa(&numstream.public, FMT_CHAR, trunc, flags, dblval);
+          dblsize = numstream.public.nput;
 
-          /* Perform left field justification actions */
+          if (dblsize < NUMBUF_SIZE - 1)
+            {
+              prejustify(obj, fmt, 0, width, dblsize);
+              putrun(obj, numbuf, dblsize);
+              postjustify(obj, fmt, 0, width, dblsize);
+            }
+          else
+            {
+              /* Get the width of the output */
+
+              dblsize = getdblsize(FMT_CHAR, trunc, flags, dblval);
 
-          prejustify(obj, fmt, 0, width, dblsize);
+              /* Perform left field justification actions */
 
-          /* Output the number */
+              prejustify(obj, fmt, 0, width, dblsize);
 
-          lib_dtoa(obj, FMT_CHAR, trunc, flags, dblval);
+              /* Output the number */
 
-          /* Perform right field justification actions */
+              lib_dtoa(obj, FMT_CHAR, trunc, flags, dblval);
 
-          postjustify(obj, fmt, 0, width, dblsize);
+              /* Perform right field justification actions */
+
+              postjustify(obj, fmt, 0, width, dblsize);
+            }
 #else
           /* Output the number with a fixed precision */
 
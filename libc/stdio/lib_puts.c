@@ -111,16 +111,6 @@ int puts(FAR const char *s)
       if (ret > 0)
         {
           nput = nwritten + 1;
-
-          /* Flush the buffer after the newline is output. */
-
-#ifdef CONFIG_STDIO_LINEBUFFER
-          ret = lib_fflush(stream, true);
-          if (ret < 0)
-            {
-              nput = EOF;
-            }
-#endif
         }
     }
 
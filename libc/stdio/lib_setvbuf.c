@@ -0,0 +1,230 @@
+/****************************************************************************
+ * libc/stdio/lib_setvbuf.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: setvbuf
+ *
+ * Description:
+ *   Select the buffering mode and the buffer of a stream.  mode is one of:
+ *
+ *   _IOFBF - Fully buffered.  Data is passed to the file only when the
+ *            buffer fills or the stream is flushed.
+ *   _IOLBF - Line buffered.  In addition, the buffer is flushed each time
+ *            that a newline is written.
+ *   _IONBF - Unbuffered.  All data is passed directly to the file.
+ *
+ *   If buffer is not NULL, the size bytes at buffer are used as the stream
+ *   buffer.  The memory must remain valid until the stream is closed.  If
+ *   buffer is NULL and size is not zero, then a buffer of that size is
+ *   allocated.  Otherwise, the stream keeps the buffer that it has.
+ *
+ *   setvbuf() may be used only before any I/O has been performed on the
+ *   stream.
+ *
+ * Returned Value:
+ *   Zero on success; on failure, a non-zero value is returned and errno is
+ *   set appropriately.
+ *
+ ****************************************************************************/
+
+int setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size)
+{
+#if CONFIG_STDIO_BUFFER_SIZE > 0
+  FAR unsigned char *newbuf;
+  uint8_t flags;
+  int errcode;
+
+  DEBUGASSERT(stream != NULL);
+
+  /* Check the mode and determine the new buffer flags */
+
+  switch (mode)
+    {
+      case _IOFBF:
+        flags = 0;
+        break;
+
+      case _IOLBF:
+        flags = __FS_FLAG_LBF;
+        break;
+
+      case _IONBF:
+        flags  = 0;
+        buffer = NULL;
+        size   = 0;
+        break;
+
+      default:
+        errcode = EINVAL;
+        goto errout;
+    }
+
+  lib_take_semaphore(stream);
+
+  /* The buffer cannot be changed once it holds any data */
+
+  if (stream->fs_bufpos != stream->fs_bufstart ||
+      stream->fs_bufread != stream->fs_bufstart
+#if CONFIG_NUNGET_CHARS > 0
+      || stream->fs_nungotten > 0
+#endif
+     )
+    {
+      errcode = EBUSY;
+      goto errout_with_semaphore;
+    }
+
+  /* Select the new buffer */
+
+  if (buffer != NULL)
+    {
+      /* Use the caller's buffer */
+
+      if (size == 0)
+        {
+          errcode = EINVAL;
+          goto errout_with_semaphore;
+        }
+
+      newbuf = (FAR unsigned char *)buffer;
+      flags |= __FS_FLAG_UBF;
+    }
+  else if (mode == _IONBF)
+    {
+      newbuf = NULL;
+    }
+  else if ((size == 0 ||
+            size == (size_t)(stream->fs_bufend - stream->fs_bufstart)) &&
+           stream->fs_bufstart != NULL)
+    {
+      /* Keep the buffer that we already have */
+
+      newbuf = stream->fs_bufstart;
+      size   = stream->fs_bufend - stream->fs_bufstart;
+      flags |= stream->fs_flags & __FS_FLAG_UBF;
+    }
+  else
+    {
+      /* Allocate a new buffer */
+
+      if (size == 0)
+        {
+          size = CONFIG_STDIO_BUFFER_SIZE;
+        }
+
+      newbuf = (FAR unsigned char *)lib_malloc(size);
+      if (newbuf == NULL)
+        {
+          errcode = ENOMEM;
+          goto errout_with_semaphore;
+        }
+    }
+
+  /* Release the old buffer if we allocated it and it is being replaced */
+
+  if (stream->fs_bufstart != NULL && stream->fs_bufstart != newbuf &&
+      (stream->fs_flags & __FS_FLAG_UBF) == 0)
+    {
+      lib_free(stream->fs_bufstart);
+    }
+
+  /* Install the new buffer and mode */
+
+  stream->fs_bufstart = newbuf;
+  stream->fs_bufend   = newbuf + size;
+  stream->fs_bufpos   = newbuf;
+  stream->fs_bufread  = newbuf;
+
+  stream->fs_flags   &= ~(__FS_FLAG_LBF | __FS_FLAG_UBF);
+  stream->fs_flags   |= flags;
+
+  lib_give_semaphore(stream);
+  return OK;
+
+errout_with_semaphore:
+  lib_give_semaphore(stream);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+
+#else
+  /* Without stream buffers, all streams are unbuffered */
+
+  if (mode != _IONBF)
+    {
+      set_errno(ENOSYS);
+      return ERROR;
+    }
+
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: setbuf
+ *
+ * Description:
+ *   Equivalent to setvbuf() with a BUFSIZ-byte, fully buffered buffer, or
+ *   with no buffering at all if buffer is NULL.
+ *
+ ****************************************************************************/
+
+void setbuf(FAR FILE *stream, FAR char *buffer)
+{
+#if CONFIG_STDIO_BUFFER_SIZE > 0
+  (void)setvbuf(stream, buffer, buffer != NULL ? _IOFBF : _IONBF, BUFSIZ);
+#else
+  (void)setvbuf(stream, NULL, _IONBF, 0);
+#endif
+}
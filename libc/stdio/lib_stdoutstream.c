@@ -79,16 +79,35 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 }
 
 /****************************************************************************
- * Name: stdoutstream_flush
+ * Name: stdoutstream_puts
  ****************************************************************************/
 
-#if defined(CONFIG_STDIO_LINEBUFFER) && CONFIG_STDIO_BUFFER_SIZE > 0
-static int stdoutstream_flush(FAR struct lib_outstream_s *this)
+static void stdoutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const char *buf, int len)
 {
   FAR struct lib_stdoutstream_s *sthis = (FAR struct lib_stdoutstream_s *)this;
-  return lib_fflush(sthis->stream, true);
+  size_t nwritten;
+
+  DEBUGASSERT(this && sthis->stream);
+
+  /* Write the whole run with one fwrite() so that the stream is locked and
+   * the buffer is checked only once.  As for stdoutstream_putc(), EINTR is
+   * the only recoverable error.
+   */
+
+  while (len > 0)
+    {
+      nwritten = fwrite(buf, 1, len, sthis->stream);
+      this->nput += nwritten;
+      buf        += nwritten;
+      len        -= nwritten;
+
+      if (len > 0 && get_errno() != EINTR)
+        {
+          break;
+        }
+    }
 }
-#endif
 
 /****************************************************************************
  * Public Functions
@@ -116,26 +135,17 @@ void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream,
 {
   /* Select the put operation */
 
-  outstream->public.put = stdoutstream_putc;
+  outstream->public.put  = stdoutstream_putc;
+  outstream->public.puts = stdoutstream_puts;
 
-  /* Select the correct flush operation.  This flush is only called when
-   * a newline is encountered in the output stream.  However, we do not
-   * want to support this line buffering behavior if the stream was
-   * opened in binary mode.  In binary mode, the newline has no special
-   * meaning.
+  /* Select the flush operation.  This flush is only called when a newline
+   * is encountered in the output stream.  Nothing needs to be done here:
+   * lib_fwrite() already flushes the buffer of a line buffered stream when
+   * a newline is written.
    */
 
 #ifdef CONFIG_STDIO_LINEBUFFER
-#if CONFIG_STDIO_BUFFER_SIZE > 0
-  if ((stream->fs_oflags & O_BINARY) == 0)
-    {
-      outstream->public.flush = stdoutstream_flush;
-    }
-  else
-#endif
-    {
-      outstream->public.flush = lib_noflush;
-    }
+  outstream->public.flush = lib_noflush;
 #endif
 
   /* Set the number of bytes put to zero and remember the stream */
@@ -78,18 +78,6 @@ static void stdsostream_putc(FAR struct lib_sostream_s *this, int ch)
   while (get_errno() == EINTR);
 }
 
-/****************************************************************************
- * Name: stdsostream_flush
- ****************************************************************************/
-
-#if defined(CONFIG_STDIO_LINEBUFFER) && CONFIG_STDIO_BUFFER_SIZE > 0
-static int stdsostream_flush(FAR struct lib_sostream_s *this)
-{
-  FAR struct lib_stdsostream_s *sthis = (FAR struct lib_stdsostream_s *)this;
-  return lib_fflush(sthis->stream, true);
-}
-#endif
-
 /****************************************************************************
  * Name: stdsostream_seek
  ****************************************************************************/
@@ -131,24 +119,14 @@ void lib_stdsostream(FAR struct lib_stdsostream_s *outstream,
 
   outstream->public.put = stdsostream_putc;
 
-  /* Select the correct flush operation.  This flush is only called when
-   * a newline is encountered in the output stream.  However, we do not
-   * want to support this line buffering behavior if the stream was
-   * opened in binary mode.  In binary mode, the newline has no special
-   * meaning.
+  /* Select the flush operation.  This flush is only called when a newline
+   * is encountered in the output stream.  Nothing needs to be done here:
+   * lib_fwrite() already flushes the buffer of a line buffered stream when
+   * a newline is written.
    */
 
 #ifdef CONFIG_STDIO_LINEBUFFER
-#if CONFIG_STDIO_BUFFER_SIZE > 0
-  if ((stream->fs_oflags & O_BINARY) == 0)
-    {
-      outstream->public.flush = stdsostream_flush;
-    }
-  else
-#endif
-    {
-      outstream->public.flush = lib_snoflush;
-    }
+  outstream->public.flush = lib_snoflush;
 #endif
 
   /* Select the seek operation */
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * libc/stdio/lib_unlocked.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <fcntl.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getc_unlocked
+ *
+ * Description:
+ *   Equivalent to getc() but the caller is responsible for locking the
+ *   stream (see flockfile()).  The character is taken directly from the
+ *   stream buffer when read-ahead data is available.  Otherwise, this
+ *   falls back to fgetc() to refill the buffer.
+ *
+ ****************************************************************************/
+
+int getc_unlocked(FAR FILE *stream)
+{
+#if CONFIG_STDIO_BUFFER_SIZE > 0
+  if (stream->fs_bufpos < stream->fs_bufread
+#if CONFIG_NUNGET_CHARS > 0
+      && stream->fs_nungotten == 0
+#endif
+     )
+    {
+      return *stream->fs_bufpos++;
+    }
+#endif
+
+  return fgetc(stream);
+}
+
+/****************************************************************************
+ * Name: putc_unlocked
+ *
+ * Description:
+ *   Equivalent to putc() but the caller is responsible for locking the
+ *   stream (see flockfile()).  The character is placed directly in the
+ *   stream buffer when the buffer is being used for writing and will not
+ *   have to be flushed.  Otherwise, this falls back to fputc().
+ *
+ ****************************************************************************/
+
+int putc_unlocked(int c, FAR FILE *stream)
+{
+#if CONFIG_STDIO_BUFFER_SIZE > 0
+  if ((stream->fs_oflags & O_WROK) != 0 &&
+      stream->fs_bufread == stream->fs_bufstart &&
+      stream->fs_bufpos + 1 < stream->fs_bufend &&
+      (c != '\n' || (stream->fs_flags & __FS_FLAG_LBF) == 0))
+    {
+      *stream->fs_bufpos++ = (unsigned char)c;
+      return (unsigned char)c;
+    }
+#endif
+
+  return fputc(c, stream);
+}
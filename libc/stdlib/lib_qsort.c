@@ -47,69 +47,176 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define min(a, b)  (a) < (b) ? a : b
-
-#define swapcode(TYPE, parmi, parmj, n) \
-  { \
-    long i = (n) / sizeof (TYPE); \
-    register TYPE *pi = (TYPE *)(parmi); \
-    register TYPE *pj = (TYPE *)(parmj); \
-    do { \
-      register TYPE  t = *pi; \
-      *pi++ = *pj; \
-      *pj++ = t; \
-    } while (--i > 0); \
-  }
-
-#define SWAPINIT(a, width) \
-  swaptype = ((FAR char *)a - (FAR char *)0) % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long)? 0 : 1;
-
-#define swap(a, b) \
-  if (swaptype == 0) \
-    { \
-      long t = *(long *)(a); \
-      *(long *)(a) = *(long *)(b); \
-      *(long *)(b) = t; \
-    } \
-  else \
-    { \
-      swapfunc(a, b, width, swaptype); \
-    }
+/* Partitions with fewer elements than this are finished with an insertion
+ * sort.
+ */
+
+#define QSORT_INSERTION_MAX 12
+
+/* Arrays larger than this use the ninther (the median of three medians of
+ * three) as the partitioning element instead of a simple median of three.
+ */
+
+#define QSORT_NINTHER_MIN   40
 
-#define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
+/* The way that two elements are exchanged.  This is selected once per call
+ * from the element size and the alignment of the array.
+ */
+
+#define SWAP_U32            0   /* One aligned 32-bit word */
+#define SWAP_U64            1   /* One aligned 64-bit word */
+#define SWAP_LONG           2   /* Several aligned long words */
+#define SWAP_BYTE           3   /* Byte by byte */
+
+#define swap(a, b)          qsort_swap(a, b, width, swaptype)
 
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
+static int qsort_swaptype(FAR const void *base, size_t width);
+static inline void qsort_swap(FAR char *a, FAR char *b, size_t width,
+                              int swaptype);
+static void qsort_vecswap(FAR char *a, FAR char *b, size_t n, size_t width,
+                          int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
                              CODE int (*compar)(FAR const void *,
                              FAR const void *));
+static void qsort_insertion(FAR char *base, size_t nel, size_t width,
+                            CODE int (*compar)(FAR const void *,
+                            FAR const void *), int swaptype);
+static void qsort_heapsort(FAR char *base, size_t nel, size_t width,
+                           CODE int (*compar)(FAR const void *,
+                           FAR const void *), int swaptype);
+static void qsort_intro(FAR char *base, size_t nel, size_t width,
+                        CODE int (*compar)(FAR const void *,
+                        FAR const void *), int swaptype, int depth);
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+/****************************************************************************
+ * Name: qsort_swaptype
+ *
+ * Description:
+ *   Select the fastest way to exchange two elements.  Elements of 4 or 8
+ *   bytes in a suitably aligned array are exchanged as a single word.
+ *   Larger elements are exchanged one long word at a time if the size and
+ *   alignment permit, otherwise one byte at a time.
+ *
+ ****************************************************************************/
+
+static int qsort_swaptype(FAR const void *base, size_t width)
 {
-  if (swaptype <= 1)
+  uintptr_t addr = (uintptr_t)base;
+
+  if (width == sizeof(uint32_t) && (addr % sizeof(uint32_t)) == 0)
     {
-      swapcode(long, a, b, n)
+      return SWAP_U32;
+    }
+  else if (width == sizeof(uint64_t) && (addr % sizeof(uint64_t)) == 0)
+    {
+      return SWAP_U64;
+    }
+  else if ((width % sizeof(long)) == 0 && (addr % sizeof(long)) == 0)
+    {
+      return SWAP_LONG;
     }
   else
     {
-      swapcode(char, a, b, n)
+      return SWAP_BYTE;
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_swap
+ *
+ * Description:
+ *   Exchange two elements.
+ *
+ ****************************************************************************/
+
+static inline void qsort_swap(FAR char *a, FAR char *b, size_t width,
+                              int swaptype)
+{
+  switch (swaptype)
+    {
+      case SWAP_U32:
+        {
+          uint32_t t = *(FAR uint32_t *)a;
+          *(FAR uint32_t *)a = *(FAR uint32_t *)b;
+          *(FAR uint32_t *)b = t;
+        }
+        break;
+
+      case SWAP_U64:
+        {
+          uint64_t t = *(FAR uint64_t *)a;
+          *(FAR uint64_t *)a = *(FAR uint64_t *)b;
+          *(FAR uint64_t *)b = t;
+        }
+        break;
+
+      case SWAP_LONG:
+        {
+          FAR long *pa = (FAR long *)a;
+          FAR long *pb = (FAR long *)b;
+          size_t i;
+
+          for (i = width / sizeof(long); i > 0; i--)
+            {
+              long t = *pa;
+              *pa++  = *pb;
+              *pb++  = t;
+            }
+        }
+        break;
+
+      default:
+        {
+          size_t i;
+
+          for (i = width; i > 0; i--)
+            {
+              char t = *a;
+              *a++   = *b;
+              *b++   = t;
+            }
+        }
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_vecswap
+ *
+ * Description:
+ *   Exchange two non-overlapping runs of n bytes.  n is a multiple of the
+ *   element size.
+ *
+ ****************************************************************************/
+
+static void qsort_vecswap(FAR char *a, FAR char *b, size_t n, size_t width,
+                          int swaptype)
+{
+  for (; n > 0; n -= width, a += width, b += width)
+    {
+      qsort_swap(a, b, width, swaptype);
     }
 }
 
+/****************************************************************************
+ * Name: med3
+ ****************************************************************************/
+
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
                              CODE int (*compar)(FAR const void *,
                              FAR const void *))
@@ -120,50 +227,105 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: qsort_insertion
+ *
+ * Description:
+ *   Insertion sort.  Used for small partitions where it is faster than
+ *   further partitioning.
+ *
  ****************************************************************************/
 
+static void qsort_insertion(FAR char *base, size_t nel, size_t width,
+                            CODE int (*compar)(FAR const void *,
+                            FAR const void *), int swaptype)
+{
+  FAR char *end = base + nel * width;
+  FAR char *pm;
+  FAR char *pl;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+        }
+    }
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: qsort_heapsort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
+ *   Heap sort.  Used when the partitioning does not make enough progress
+ *   so that the total time remains O(n log n) for any input.
  *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
- *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void qsort_heapsort(FAR char *base, size_t nel, size_t width,
+                           CODE int (*compar)(FAR const void *,
+                           FAR const void *), int swaptype)
+{
+  size_t start;
+  size_t root;
+  size_t child;
+  size_t end;
+
+  /* Build the heap, then repeatedly move the largest remaining element to
+   * the end of the array.
+   */
+
+  start = nel / 2;
+  end   = nel;
+
+  while (end > 1)
+    {
+      if (start > 0)
+        {
+          start--;
+        }
+      else
+        {
+          end--;
+          swap(base, base + end * width);
+        }
+
+      /* Sift the element at 'start' down into the heap of 'end' elements */
+
+      for (root = start; (child = 2 * root + 1) < end; root = child)
+        {
+          if (child + 1 < end &&
+              compar(base + child * width, base + (child + 1) * width) < 0)
+            {
+              child++;
+            }
+
+          if (compar(base + root * width, base + child * width) >= 0)
+            {
+              break;
+            }
+
+          swap(base + root * width, base + child * width);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_intro
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Introspective sort.  The array is partitioned as in Bentley & McIlroy's
+ *   "Engineering a Sort Function":  Elements equal to the partitioning
+ *   element are gathered in the middle and are excluded from further
+ *   sorting.  Only the smaller side is sorted recursively and the larger
+ *   side is sorted by iteration, so the recursion is never more than
+ *   log2(nel) deep.  If the number of partitioning passes exceeds 'depth',
+ *   the remainder is heap sorted.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void qsort_intro(FAR char *base, size_t nel, size_t width,
+                        CODE int (*compar)(FAR const void *,
+                        FAR const void *), int swaptype, int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -172,38 +334,27 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
-  int swap_cnt;
-  int d;
-  int r;
+  size_t nleft;
+  size_t nright;
+  size_t d;
+  size_t r;
+  int result;
 
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
-
-  if (nel < 7)
+  while (nel >= QSORT_INSERTION_MAX)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (depth-- <= 0)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          qsort_heapsort(base, nel, width, compar, swaptype);
+          return;
         }
 
-      return;
-  }
+      /* Select the partitioning element and move it to the beginning */
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
-    {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
+      pm = base + (nel / 2) * width;
+      pn = base + (nel - 1) * width;
+
+      if (nel > QSORT_NINTHER_MIN)
         {
           d  = (nel / 8) * width;
           pl = med3(pl, pl + d, pl + 2 * d, compar);
@@ -212,86 +363,157 @@ loop:
         }
 
       pm = med3(pl, pm, pn, compar);
-    }
+      swap(base, pm);
 
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+      /* Partition:  Elements equal to the partitioning element collect at
+       * both ends ([base, pa) and (pd, end)), smaller elements in [pa, pb)
+       * and larger elements in (pc, pd].
+       */
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
-    {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      pa = pb = base + width;
+      pc = pd = base + (nel - 1) * width;
+
+      for (; ; )
         {
-          if (r == 0)
+          while (pb <= pc && (result = compar(pb, base)) <= 0)
             {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
+              if (result == 0)
+                {
+                  swap(pa, pb);
+                  pa += width;
+                }
+
+              pb += width;
             }
 
-          pb += width;
-        }
+          while (pb <= pc && (result = compar(pc, base)) >= 0)
+            {
+              if (result == 0)
+                {
+                  swap(pc, pd);
+                  pd -= width;
+                }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
-        {
-          if (r == 0)
+              pc -= width;
+            }
+
+          if (pb > pc)
             {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
+              break;
             }
 
+          swap(pb, pc);
+          pb += width;
           pc -= width;
         }
 
-      if (pb > pc)
+      /* Move the equal elements from the ends to the middle */
+
+      pn = base + nel * width;
+
+      r = pa - base;
+      if (r > (size_t)(pb - pa))
         {
-          break;
+          r = pb - pa;
         }
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
-    }
+      qsort_vecswap(base, pb - r, r, width, swaptype);
 
-  if (swap_cnt == 0)
-    {
-      /* Switch to insertion sort */
-
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      r = pd - pc;
+      if (r > (size_t)(pn - pd) - width)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          r = (pn - pd) - width;
         }
 
-      return;
+      qsort_vecswap(pb, pn - r, r, width, swaptype);
+
+      /* Recurse into the smaller partition and iterate on the larger */
+
+      nleft  = (pb - pa) / width;
+      nright = (pd - pc) / width;
+
+      if (nleft < nright)
+        {
+          qsort_intro(base, nleft, width, compar, swaptype, depth);
+          base = pn - nright * width;
+          nel  = nright;
+        }
+      else
+        {
+          qsort_intro(pn - nright * width, nright, width, compar, swaptype,
+                      depth);
+          nel  = nleft;
+        }
     }
 
-  pn = (FAR char *)base + nel * width;
-  r  = min(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+  qsort_insertion(base, nel, width, compar, swaptype);
+}
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes:
+ *   This is an introsort built on the partitioning of the original BSD
+ *   qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   The run time is O(n log n) and the stack usage O(log n) for any input.
+ *
+ ****************************************************************************/
 
-  r  = min(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int depth;
 
-  if ((r = pb - pa) > width)
+  if (nel < 2 || width == 0)
     {
-      qsort(base, r / width, width, compar);
+      return;
     }
 
-  if ((r = pd - pc) > width)
-    {
-      /* Iterate rather than recurse to save stack space */
+  /* Allow 2 * log2(nel) partitioning passes before switching to heap
+   * sort.
+   */
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  for (depth = 0, n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
     }
+
+  qsort_intro((FAR char *)base, nel, width, compar,
+              qsort_swaptype(base, width), depth);
 }
@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <errno.h>
@@ -50,168 +52,1019 @@
  * Pre-processor definitions
  ****************************************************************************/
 
-/* These are predefined with GCC, but could be issues for other compilers. If
- * not defined, an arbitrary big number is put in for now.  These should be
- * added to nuttx/compiler for your compiler.
+#define STRTOD_INFINITY       (1.0 / 0.0)
+
+/* The largest power of ten that is exact in a double */
+
+#define EXACT_POW10_MAX       22
+
+/* Any value with more decimal digits than this is above (below) the
+ * largest (smallest) double.
+ */
+
+#define STRTOD_MAX_DECPT      310
+#define STRTOD_MIN_DECPT      (-324)
+
+/* The significant digits beyond STRTOD_MAX_DIGITS can only decide a tie
+ * between two doubles.  Since trailing zeroes are dropped, they are then
+ * replaced by a single non-zero digit.
+ */
+
+#define STRTOD_MAX_DIGITS     780
+
+#ifdef CONFIG_HAVE_LONG_LONG
+
+/* The number of decimal digits that always fit in 64 bits */
+
+#define STRTOD_U64_DIGITS     19
+
+/* IEEE doubles and 64-bit "do it yourself" floating point numbers */
+
+#define IEEE_SIGNIFICAND_SIZE 53
+#define IEEE_HIDDEN_BIT       ((uint64_t)1 << 52)
+#define IEEE_SIGNIFICAND_MASK (IEEE_HIDDEN_BIT - 1)
+#define IEEE_EXPONENT_BIAS    1075
+#define IEEE_DENORMAL_EXP     (1 - IEEE_EXPONENT_BIAS)
+#define IEEE_MAX_EXP          (0x7ff - IEEE_EXPONENT_BIAS)
+
+#define DIYFP_SIZE            64
+
+/* The error of the DIY-FP estimate is kept in 1/8 ulp */
+
+#define DIYFP_DENOM_LOG       3
+#define DIYFP_DENOM           (1 << DIYFP_DENOM_LOG)
+
+/* The cached powers of ten cover 10^-348 .. 10^340 in steps of eight */
+
+#define CACHED_POWERS_OFFSET  348
+#define CACHED_POWERS_STEP    8
+
+/* Big numbers for the exact comparison.  They must hold the digits scaled
+ * by the largest power of ten and of two that can be needed.
  */
 
-#if !defined(__DBL_MIN_EXP__) || !defined(__DBL_MAX_EXP__)
-#  ifdef CONFIG_CPP_HAVE_WARNING
-#    warning "Size of exponent is unknown"
-#  endif
-#  undef  __DBL_MIN_EXP__
-#  define __DBL_MIN_EXP__ (-1021)
-#  undef  __DBL_MAX_EXP__
-#  define __DBL_MAX_EXP__ (1024)
+#define BIGNUM_WORDS          120
+#define BIGNUM_CHUNK          9
+#define BIGNUM_POW10_CHUNK    1000000000
+#define BIGNUM_POW5_13        1220703125
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A "do it yourself" floating point number f * 2^e */
+
+struct diyfp_s
+{
+  uint64_t f;
+  int e;
+};
+
+/* A cached power of ten:  10^dexp ~= f * 2^e */
+
+struct cached_power_s
+{
+  uint64_t f;
+  int16_t e;
+  int16_t dexp;
+};
+
+/* An unsigned big number */
+
+struct bignum_s
+{
+  uint32_t word[BIGNUM_WORDS];
+  int nwords;
+};
+
+#endif /* CONFIG_HAVE_LONG_LONG */
+
+/* The result of scanning the input string.  The value is the integer
+ * formed by the 'ndigits' significant digits starting at 'digits'
+ * (skipping any decimal point) times 10^dexp.
+ */
+
+struct strtod_scan_s
+{
+  FAR const char *digits;
+  int ndigits;
+  int dexp;
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t u64;           /* The first (up to) 19 significant digits */
+  char next;              /* The 20th significant digit */
 #endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_HAVE_LONG_LONG
+/* The powers of ten that are exact in a double */
+
+static const double g_exact_pow10[] =
+{
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Normalized 10^1 .. 10^7 (exact) for the steps between cached powers */
+
+static const struct diyfp_s g_adjust_pow10[] =
+{
+  { 0xa000000000000000ull, -60 },
+  { 0xc800000000000000ull, -57 },
+  { 0xfa00000000000000ull, -54 },
+  { 0x9c40000000000000ull, -50 },
+  { 0xc350000000000000ull, -47 },
+  { 0xf424000000000000ull, -44 },
+  { 0x9896800000000000ull, -40 }
+};
+
+/* 10^dexp rounded to 64 bits */
+
+static const struct cached_power_s g_cached_pow10[] =
+{
+  { 0xfa8fd5a0081c0288ull, -1220, -348 },
+  { 0xbaaee17fa23ebf76ull, -1193, -340 },
+  { 0x8b16fb203055ac76ull, -1166, -332 },
+  { 0xcf42894a5dce35eaull, -1140, -324 },
+  { 0x9a6bb0aa55653b2dull, -1113, -316 },
+  { 0xe61acf033d1a45dfull, -1087, -308 },
+  { 0xab70fe17c79ac6caull, -1060, -300 },
+  { 0xff77b1fcbebcdc4full, -1034, -292 },
+  { 0xbe5691ef416bd60cull, -1007, -284 },
+  { 0x8dd01fad907ffc3cull,  -980, -276 },
+  { 0xd3515c2831559a83ull,  -954, -268 },
+  { 0x9d71ac8fada6c9b5ull,  -927, -260 },
+  { 0xea9c227723ee8bcbull,  -901, -252 },
+  { 0xaecc49914078536dull,  -874, -244 },
+  { 0x823c12795db6ce57ull,  -847, -236 },
+  { 0xc21094364dfb5637ull,  -821, -228 },
+  { 0x9096ea6f3848984full,  -794, -220 },
+  { 0xd77485cb25823ac7ull,  -768, -212 },
+  { 0xa086cfcd97bf97f4ull,  -741, -204 },
+  { 0xef340a98172aace5ull,  -715, -196 },
+  { 0xb23867fb2a35b28eull,  -688, -188 },
+  { 0x84c8d4dfd2c63f3bull,  -661, -180 },
+  { 0xc5dd44271ad3cdbaull,  -635, -172 },
+  { 0x936b9fcebb25c996ull,  -608, -164 },
+  { 0xdbac6c247d62a584ull,  -582, -156 },
+  { 0xa3ab66580d5fdaf6ull,  -555, -148 },
+  { 0xf3e2f893dec3f126ull,  -529, -140 },
+  { 0xb5b5ada8aaff80b8ull,  -502, -132 },
+  { 0x87625f056c7c4a8bull,  -475, -124 },
+  { 0xc9bcff6034c13053ull,  -449, -116 },
+  { 0x964e858c91ba2655ull,  -422, -108 },
+  { 0xdff9772470297ebdull,  -396, -100 },
+  { 0xa6dfbd9fb8e5b88full,  -369,  -92 },
+  { 0xf8a95fcf88747d94ull,  -343,  -84 },
+  { 0xb94470938fa89bcfull,  -316,  -76 },
+  { 0x8a08f0f8bf0f156bull,  -289,  -68 },
+  { 0xcdb02555653131b6ull,  -263,  -60 },
+  { 0x993fe2c6d07b7facull,  -236,  -52 },
+  { 0xe45c10c42a2b3b06ull,  -210,  -44 },
+  { 0xaa242499697392d3ull,  -183,  -36 },
+  { 0xfd87b5f28300ca0eull,  -157,  -28 },
+  { 0xbce5086492111aebull,  -130,  -20 },
+  { 0x8cbccc096f5088ccull,  -103,  -12 },
+  { 0xd1b71758e219652cull,   -77,   -4 },
+  { 0x9c40000000000000ull,   -50,    4 },
+  { 0xe8d4a51000000000ull,   -24,   12 },
+  { 0xad78ebc5ac620000ull,     3,   20 },
+  { 0x813f3978f8940984ull,    30,   28 },
+  { 0xc097ce7bc90715b3ull,    56,   36 },
+  { 0x8f7e32ce7bea5c70ull,    83,   44 },
+  { 0xd5d238a4abe98068ull,   109,   52 },
+  { 0x9f4f2726179a2245ull,   136,   60 },
+  { 0xed63a231d4c4fb27ull,   162,   68 },
+  { 0xb0de65388cc8ada8ull,   189,   76 },
+  { 0x83c7088e1aab65dbull,   216,   84 },
+  { 0xc45d1df942711d9aull,   242,   92 },
+  { 0x924d692ca61be758ull,   269,  100 },
+  { 0xda01ee641a708deaull,   295,  108 },
+  { 0xa26da3999aef774aull,   322,  116 },
+  { 0xf209787bb47d6b85ull,   348,  124 },
+  { 0xb454e4a179dd1877ull,   375,  132 },
+  { 0x865b86925b9bc5c2ull,   402,  140 },
+  { 0xc83553c5c8965d3dull,   428,  148 },
+  { 0x952ab45cfa97a0b3ull,   455,  156 },
+  { 0xde469fbd99a05fe3ull,   481,  164 },
+  { 0xa59bc234db398c25ull,   508,  172 },
+  { 0xf6c69a72a3989f5cull,   534,  180 },
+  { 0xb7dcbf5354e9beceull,   561,  188 },
+  { 0x88fcf317f22241e2ull,   588,  196 },
+  { 0xcc20ce9bd35c78a5ull,   614,  204 },
+  { 0x98165af37b2153dfull,   641,  212 },
+  { 0xe2a0b5dc971f303aull,   667,  220 },
+  { 0xa8d9d1535ce3b396ull,   694,  228 },
+  { 0xfb9b7cd9a4a7443cull,   720,  236 },
+  { 0xbb764c4ca7a44410ull,   747,  244 },
+  { 0x8bab8eefb6409c1aull,   774,  252 },
+  { 0xd01fef10a657842cull,   800,  260 },
+  { 0x9b10a4e5e9913129ull,   827,  268 },
+  { 0xe7109bfba19c0c9dull,   853,  276 },
+  { 0xac2820d9623bf429ull,   880,  284 },
+  { 0x80444b5e7aa7cf85ull,   907,  292 },
+  { 0xbf21e44003acdd2dull,   933,  300 },
+  { 0x8e679c2f5e44ff8full,   960,  308 },
+  { 0xd433179d9c8cb841ull,   986,  316 },
+  { 0x9e19db92b4e31ba9ull,  1013,  324 },
+  { 0xeb96bf6ebadf77d9ull,  1039,  332 },
+  { 0xaf87023b9bf0ee6bull,  1066,  340 }
+};
+#endif /* CONFIG_HAVE_LONG_LONG */
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline int is_real(double x)
+/****************************************************************************
+ * Name: strtod_match
+ *
+ * Description:
+ *   Case insensitive match of a lower case word at the start of a string.
+ *
+ ****************************************************************************/
+
+static bool strtod_match(FAR const char *str, FAR const char *word)
 {
-  const double_t infinite = 1.0/0.0;
-  return (x < infinite) && (x >= -infinite);
+  for (; *word != '\0'; str++, word++)
+    {
+      if (tolower(*str) != *word)
+        {
+          return false;
+        }
+    }
+
+  return true;
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: strtod_run
+ *
+ * Description:
+ *   Scan a run of digits, adding them to the significant digits.
+ *
  ****************************************************************************/
 
-/***************************************************(************************
- * Name: strtod
+static inline FAR const char *strtod_run(FAR const char *p,
+                                         FAR struct strtod_scan_s *scan)
+{
+  for (; isdigit(*p); p++)
+    {
+#ifdef CONFIG_HAVE_LONG_LONG
+      if (scan->ndigits < STRTOD_U64_DIGITS)
+        {
+          scan->u64 = scan->u64 * 10 + (*p - '0');
+        }
+      else if (scan->ndigits == STRTOD_U64_DIGITS)
+        {
+          scan->next = *p;
+        }
+#endif
+
+      scan->ndigits++;
+    }
+
+  return p;
+}
+
+/****************************************************************************
+ * Name: strtod_scan
  *
  * Description:
- *   Convert a string to a double value
+ *   Scan the digits, decimal point and exponent of a number.  Leading
+ *   zeroes are not counted as significant digits; trailing zeroes are.
+ *
+ * Returned Value:
+ *   A pointer to the first character after the number, or NULL if there
+ *   were no digits.
  *
  ****************************************************************************/
 
-double_t strtod(FAR const char *str, FAR char **endptr)
+static FAR const char *strtod_scan(FAR const char *p,
+                                   FAR struct strtod_scan_s *scan)
 {
-  double_t number;
-  int exponent;
-  int negative;
-  char *p = (char *) str;
-  double p10;
+  FAR const char *q;
+  bool havezeroes = false;
+  int decpt;
   int n;
-  int num_digits;
-  int num_decimals;
-  const double_t infinite = 1.0/0.0;
 
-  /* Skip leading whitespace */
+  scan->ndigits = 0;
+#ifdef CONFIG_HAVE_LONG_LONG
+  scan->u64     = 0;
+  scan->next    = '0';
+#endif
 
-  while (isspace(*p))
+  /* The integer part.  Leading zeroes are skipped. */
+
+  for (; *p == '0'; p++)
     {
-      p++;
+      havezeroes = true;
     }
 
-  /* Handle optional sign */
+  scan->digits = p;
+  p     = strtod_run(p, scan);
+  decpt = scan->ndigits;
+
+  /* The fractional part.  Zeroes that are still leading zeroes move the
+   * decimal point down.
+   */
 
-  negative = 0;
-  switch (*p)
+  if (*p == '.')
     {
-    case '-':
-      negative = 1; /* Fall through to increment position */
-    case '+':
       p++;
+      if (scan->ndigits == 0)
+        {
+          for (; *p == '0'; p++)
+            {
+              havezeroes = true;
+              decpt--;
+            }
+
+          scan->digits = p;
+        }
+
+      p = strtod_run(p, scan);
     }
 
-  number       = 0.;
-  exponent     = 0;
-  num_digits   = 0;
-  num_decimals = 0;
+  if (scan->ndigits == 0 && !havezeroes)
+    {
+      return NULL;
+    }
 
-  /* Process string of digits */
+  /* Process an exponent string.  It is only part of the number if there is
+   * at least one digit.
+   */
 
-  while (isdigit(*p))
+  if (*p == 'e' || *p == 'E')
     {
-      number = number * 10. + (*p - '0');
-      p++;
-      num_digits++;
+      bool negexp = false;
+
+      q = p + 1;
+      if (*q == '+' || *q == '-')
+        {
+          negexp = (*q == '-');
+          q++;
+        }
+
+      if (isdigit(*q))
+        {
+          for (n = 0; isdigit(*q); q++)
+            {
+              if (n < 100000)
+                {
+                  n = n * 10 + (*q - '0');
+                }
+            }
+
+          decpt += negexp ? -n : n;
+          p = q;
+        }
     }
 
-  /* Process decimal part */
+  scan->dexp = decpt - scan->ndigits;
+  return p;
+}
 
-  if (*p == '.')
+#ifdef CONFIG_HAVE_LONG_LONG
+/****************************************************************************
+ * Name: diyfp_multiply
+ *
+ * Description:
+ *   x = x * y, keeping the most significant 64 bits (rounded) of the
+ *   128-bit product.
+ *
+ ****************************************************************************/
+
+static void diyfp_multiply(FAR struct diyfp_s *x,
+                           FAR const struct diyfp_s *y)
+{
+  uint64_t a = x->f >> 32;
+  uint64_t b = x->f & 0xffffffff;
+  uint64_t c = y->f >> 32;
+  uint64_t d = y->f & 0xffffffff;
+  uint64_t ac = a * c;
+  uint64_t bc = b * c;
+  uint64_t ad = a * d;
+  uint64_t bd = b * d;
+  uint64_t tmp;
+
+  tmp  = (bd >> 32) + (ad & 0xffffffff) + (bc & 0xffffffff);
+  tmp += (uint64_t)1 << 31;
+
+  x->f  = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  x->e += y->e + 64;
+}
+
+/****************************************************************************
+ * Name: diyfp_normalize
+ *
+ * Description:
+ *   Shift the significand up until its most significant bit is set and
+ *   return the number of bits shifted.
+ *
+ ****************************************************************************/
+
+static int diyfp_normalize(FAR struct diyfp_s *x)
+{
+  int shift = 0;
+
+  while ((x->f & 0xffc0000000000000ull) == 0)
     {
-      p++;
+      x->f  <<= 10;
+      shift  += 10;
+    }
+
+  while ((x->f & 0x8000000000000000ull) == 0)
+    {
+      x->f <<= 1;
+      shift++;
+    }
 
-      while (isdigit(*p))
-      {
-        number = number * 10. + (*p - '0');
-        p++;
-        num_digits++;
-        num_decimals++;
-      }
+  x->e -= shift;
+  return shift;
+}
 
-      exponent -= num_decimals;
+/****************************************************************************
+ * Name: diyfp_todouble
+ *
+ * Description:
+ *   Convert f * 2^e, where f has at most 54 significant bits, to the
+ *   nearest double by truncation.
+ *
+ ****************************************************************************/
+
+static double diyfp_todouble(uint64_t f, int e)
+{
+  union
+  {
+    double   d;
+    uint64_t u;
+  } bits;
+
+  uint64_t biased;
+
+  while (f > IEEE_HIDDEN_BIT + IEEE_SIGNIFICAND_MASK)
+    {
+      f >>= 1;
+      e++;
+    }
+
+  if (e >= IEEE_MAX_EXP)
+    {
+      return STRTOD_INFINITY;
     }
 
-  if (num_digits == 0)
+  if (e < IEEE_DENORMAL_EXP)
     {
-      set_errno(ERANGE);
       return 0.0;
     }
 
-  /* Correct for sign */
+  while (e > IEEE_DENORMAL_EXP && (f & IEEE_HIDDEN_BIT) == 0)
+    {
+      f <<= 1;
+      e--;
+    }
 
-  if (negative)
+  if (e == IEEE_DENORMAL_EXP && (f & IEEE_HIDDEN_BIT) == 0)
     {
-      number = -number;
+      biased = 0;
+    }
+  else
+    {
+      biased = (uint64_t)(e + IEEE_EXPONENT_BIAS);
     }
 
-  /* Process an exponent string */
+  bits.u = (f & IEEE_SIGNIFICAND_MASK) | (biased << 52);
+  return bits.d;
+}
 
-  if (*p == 'e' || *p == 'E')
+/****************************************************************************
+ * Name: double_todiyfp
+ *
+ * Description:
+ *   Split a positive, finite double into f * 2^e.
+ *
+ ****************************************************************************/
+
+static void double_todiyfp(double d, FAR struct diyfp_s *x)
+{
+  union
+  {
+    double   d;
+    uint64_t u;
+  } bits;
+
+  int biased;
+
+  bits.d = d;
+  biased = (int)(bits.u >> 52) & 0x7ff;
+  x->f   = bits.u & IEEE_SIGNIFICAND_MASK;
+
+  if (biased == 0)
+    {
+      x->e = IEEE_DENORMAL_EXP;
+    }
+  else
     {
-      /* Handle optional sign */
+      x->f |= IEEE_HIDDEN_BIT;
+      x->e  = biased - IEEE_EXPONENT_BIAS;
+    }
+}
+
+/****************************************************************************
+ * Name: strtod_exact
+ *
+ * Description:
+ *   The common case:  When the digits and the power of ten are both exact
+ *   doubles, a single correctly rounded multiplication or division gives
+ *   the correctly rounded result.
+ *
+ ****************************************************************************/
+
+static bool strtod_exact(FAR const struct strtod_scan_s *scan,
+                         FAR double *result)
+{
+  int dexp = scan->dexp;
+  double d;
+
+  if (scan->ndigits > 15)
+    {
+      return false;
+    }
+
+  d = (double)scan->u64;
+  if (dexp < 0 && -dexp <= EXACT_POW10_MAX)
+    {
+      *result = d / g_exact_pow10[-dexp];
+      return true;
+    }
+
+  if (dexp >= 0 && dexp <= EXACT_POW10_MAX)
+    {
+      *result = d * g_exact_pow10[dexp];
+      return true;
+    }
+
+  /* Digits that leave room below 10^15 can absorb part of the exponent */
+
+  if (dexp > EXACT_POW10_MAX &&
+      dexp <= EXACT_POW10_MAX + 15 - scan->ndigits)
+    {
+      d *= g_exact_pow10[dexp - EXACT_POW10_MAX];
+      *result = d * g_exact_pow10[EXACT_POW10_MAX];
+      return true;
+    }
+
+  return false;
+}
 
-      negative = 0;
-      switch (*++p)
+/****************************************************************************
+ * Name: strtod_diyfp
+ *
+ * Description:
+ *   Multiply the (first 19) digits by a cached 64-bit power of ten while
+ *   keeping track of the error.  This gives the correctly rounded result
+ *   unless the product is too close to halfway between two doubles.
+ *
+ * Returned Value:
+ *   True if the result is correctly rounded.  Otherwise the result is
+ *   either the correct double or the one just below it.
+ *
+ ****************************************************************************/
+
+static bool strtod_diyfp(FAR const struct strtod_scan_s *scan,
+                         FAR double *result)
+{
+  FAR const struct cached_power_s *cached;
+  struct diyfp_s input;
+  struct diyfp_s power;
+  uint64_t error;
+  uint64_t mask;
+  uint64_t bits;
+  uint64_t halfway;
+  uint64_t f;
+  int dexp = scan->dexp;
+  int magnitude;
+  int precision;
+  int sigsize;
+  int adjust;
+  int shift;
+
+  /* Digits that do not fit in 64 bits contribute up to 1/2 ulp of error */
+
+  input.f = scan->u64;
+  input.e = 0;
+  error   = 0;
+
+  if (scan->ndigits > STRTOD_U64_DIGITS)
+    {
+      if (scan->next >= '5')
         {
-        case '-':
-          negative = 1;   /* Fall through to increment pos */
-        case '+':
-          p++;
+          input.f++;
         }
 
-      /* Process string of digits */
+      dexp += scan->ndigits - STRTOD_U64_DIGITS;
+      error = DIYFP_DENOM / 2;
+    }
+
+  error <<= diyfp_normalize(&input);
+
+  if (dexp < -CACHED_POWERS_OFFSET)
+    {
+      *result = 0.0;
+      return true;
+    }
 
-      n = 0;
-      while (isdigit(*p))
+  cached = &g_cached_pow10[(dexp + CACHED_POWERS_OFFSET) /
+                           CACHED_POWERS_STEP];
+  adjust = dexp - cached->dexp;
+
+  if (adjust > 0)
+    {
+      /* The adjustment powers are exact.  The product is exact too if it
+       * still fits in 64 bits.
+       */
+
+      diyfp_multiply(&input, &g_adjust_pow10[adjust - 1]);
+      if (STRTOD_U64_DIGITS - scan->ndigits < adjust)
         {
-          n = n * 10 + (*p - '0');
-          p++;
+          error += DIYFP_DENOM / 2;
         }
+    }
+
+  /* The cached power is within 1/2 ulp, the multiplication adds 1/2 ulp
+   * and the cross term of the errors is less than one.
+   */
+
+  power.f = cached->f;
+  power.e = cached->e;
+  diyfp_multiply(&input, &power);
+
+  error += DIYFP_DENOM / 2 + (error == 0 ? 0 : 1) + DIYFP_DENOM / 2;
+  error <<= diyfp_normalize(&input);
 
-      if (negative)
+  /* The number of bits below the double's significand.  This is larger for
+   * denormals.
+   */
+
+  magnitude = DIYFP_SIZE + input.e;
+  if (magnitude >= IEEE_DENORMAL_EXP + IEEE_SIGNIFICAND_SIZE)
+    {
+      sigsize = IEEE_SIGNIFICAND_SIZE;
+    }
+  else if (magnitude <= IEEE_DENORMAL_EXP)
+    {
+      sigsize = 0;
+    }
+  else
+    {
+      sigsize = magnitude - IEEE_DENORMAL_EXP;
+    }
+
+  precision = DIYFP_SIZE - sigsize;
+  if (precision + DIYFP_DENOM_LOG >= DIYFP_SIZE)
+    {
+      /* Very small denormals:  Make room for the denominator */
+
+      shift      = precision + DIYFP_DENOM_LOG - DIYFP_SIZE + 1;
+      input.f  >>= shift;
+      input.e   += shift;
+      error      = (error >> shift) + 1 + DIYFP_DENOM;
+      precision -= shift;
+    }
+
+  mask    = ((uint64_t)1 << precision) - 1;
+  bits    = (input.f & mask) * DIYFP_DENOM;
+  halfway = ((uint64_t)1 << (precision - 1)) * DIYFP_DENOM;
+
+  f = input.f >> precision;
+  if (bits >= halfway + error)
+    {
+      f++;
+    }
+
+  *result = diyfp_todouble(f, input.e + precision);
+  return !(halfway - error < bits && bits < halfway + error);
+}
+
+/****************************************************************************
+ * Name: bignum_muladd
+ *
+ * Description:
+ *   x = x * m + a
+ *
+ ****************************************************************************/
+
+static void bignum_muladd(FAR struct bignum_s *x, uint32_t m, uint32_t a)
+{
+  uint64_t carry = a;
+  uint64_t prod;
+  int i;
+
+  for (i = 0; i < x->nwords; i++)
+    {
+      prod       = (uint64_t)x->word[i] * m + carry;
+      x->word[i] = (uint32_t)prod;
+      carry      = prod >> 32;
+    }
+
+  if (carry != 0 && x->nwords < BIGNUM_WORDS)
+    {
+      x->word[x->nwords++] = (uint32_t)carry;
+    }
+}
+
+/****************************************************************************
+ * Name: bignum_shiftleft
+ ****************************************************************************/
+
+static void bignum_shiftleft(FAR struct bignum_s *x, int shift)
+{
+  int words = shift / 32;
+  int bits  = shift % 32;
+  int i;
+
+  if (x->nwords == 0)
+    {
+      return;
+    }
+
+  if (bits != 0)
+    {
+      uint32_t carry = 0;
+
+      for (i = 0; i < x->nwords; i++)
         {
-          exponent -= n;
+          uint32_t w = x->word[i];
+
+          x->word[i] = (w << bits) | carry;
+          carry      = w >> (32 - bits);
         }
-      else
+
+      if (carry != 0 && x->nwords < BIGNUM_WORDS)
+        {
+          x->word[x->nwords++] = carry;
+        }
+    }
+
+  if (words > 0)
+    {
+      if (x->nwords + words > BIGNUM_WORDS)
+        {
+          words = BIGNUM_WORDS - x->nwords;
+        }
+
+      for (i = x->nwords - 1; i >= 0; i--)
+        {
+          x->word[i + words] = x->word[i];
+        }
+
+      for (i = 0; i < words; i++)
+        {
+          x->word[i] = 0;
+        }
+
+      x->nwords += words;
+    }
+}
+
+/****************************************************************************
+ * Name: bignum_mulpow10
+ *
+ * Description:
+ *   x = x * 10^n, computed as x * 5^n * 2^n.
+ *
+ ****************************************************************************/
+
+static void bignum_mulpow10(FAR struct bignum_s *x, int n)
+{
+  int shift = n;
+  uint32_t m;
+
+  for (; n >= 13; n -= 13)
+    {
+      bignum_muladd(x, BIGNUM_POW5_13, 0);
+    }
+
+  for (m = 1; n > 0; n--)
+    {
+      m *= 5;
+    }
+
+  bignum_muladd(x, m, 0);
+  bignum_shiftleft(x, shift);
+}
+
+/****************************************************************************
+ * Name: bignum_cmp
+ ****************************************************************************/
+
+static int bignum_cmp(FAR const struct bignum_s *x,
+                      FAR const struct bignum_s *y)
+{
+  int i;
+
+  if (x->nwords != y->nwords)
+    {
+      return x->nwords < y->nwords ? -1 : 1;
+    }
+
+  for (i = x->nwords - 1; i >= 0; i--)
+    {
+      if (x->word[i] != y->word[i])
         {
-          exponent += n;
+          return x->word[i] < y->word[i] ? -1 : 1;
         }
     }
 
-  if (exponent < __DBL_MIN_EXP__ ||
-      exponent > __DBL_MAX_EXP__)
+  return 0;
+}
+
+/****************************************************************************
+ * Name: strtod_bignum
+ *
+ * Description:
+ *   Decide between the estimate and the next double up by comparing the
+ *   exact decimal value with the halfway point between them.  This is only
+ *   needed for inputs very close to a halfway case.
+ *
+ ****************************************************************************/
+
+static noinline_function double strtod_bignum(FAR const struct
+                                              strtod_scan_s *scan,
+                                              double guess)
+{
+  struct bignum_s input;
+  struct bignum_s boundary;
+  struct diyfp_s upper;
+  FAR const char *p;
+  uint32_t chunk;
+  bool truncated;
+  int ndigits;
+  int dexp = scan->dexp;
+  int nchunk;
+  int cmp;
+  int i;
+
+  if (guess == STRTOD_INFINITY)
     {
-      set_errno(ERANGE);
-      return infinite;
+      return guess;
     }
 
-  /* Scale the result */
+  /* The halfway point to the next double: (2f + 1) * 2^(e - 1) */
+
+  double_todiyfp(guess, &upper);
+  upper.f = upper.f * 2 + 1;
+  upper.e--;
+
+  /* Drop the trailing zeroes.  Any digits beyond STRTOD_MAX_DIGITS are
+   * then replaced by a single, non-zero digit.
+   */
 
-  p10 = 10.;
-  n = exponent;
-  if (n < 0) n = -n;
-  while (n)
+  for (p = scan->digits, i = 0, ndigits = 0; i < scan->ndigits; p++)
     {
-      if (n & 1)
+      if (*p != '.' && *p != '0')
+        {
+          ndigits = i + 1;
+        }
+
+      if (*p != '.')
         {
-          if (exponent < 0)
+          i++;
+        }
+    }
+
+  dexp     += scan->ndigits - ndigits;
+  truncated = ndigits > STRTOD_MAX_DIGITS;
+  if (truncated)
+    {
+      dexp   += ndigits - STRTOD_MAX_DIGITS;
+      ndigits = STRTOD_MAX_DIGITS;
+    }
+
+  /* The digits as a big number */
+
+  input.nwords = 0;
+  chunk        = 0;
+  nchunk       = 0;
+
+  for (p = scan->digits, i = 0; i < ndigits; p++)
+    {
+      if (*p == '.')
+        {
+          continue;
+        }
+
+      i++;
+      chunk = chunk * 10 +
+              (i == STRTOD_MAX_DIGITS && truncated ? 1 : *p - '0');
+
+      if (++nchunk == BIGNUM_CHUNK)
+        {
+          bignum_muladd(&input, BIGNUM_POW10_CHUNK, chunk);
+          chunk  = 0;
+          nchunk = 0;
+        }
+    }
+
+  if (nchunk > 0)
+    {
+      bignum_muladd(&input, (uint32_t)g_exact_pow10[nchunk], chunk);
+    }
+
+  boundary.word[0] = (uint32_t)upper.f;
+  boundary.word[1] = (uint32_t)(upper.f >> 32);
+  boundary.nwords  = boundary.word[1] != 0 ? 2 : 1;
+
+  /* Scale both to integers */
+
+  if (dexp >= 0)
+    {
+      bignum_mulpow10(&input, dexp);
+    }
+  else
+    {
+      bignum_mulpow10(&boundary, -dexp);
+    }
+
+  if (upper.e > 0)
+    {
+      bignum_shiftleft(&boundary, upper.e);
+    }
+  else
+    {
+      bignum_shiftleft(&input, -upper.e);
+    }
+
+  /* Round to the nearer double, to the even one on a tie */
+
+  cmp = bignum_cmp(&input, &boundary);
+  if (cmp < 0 || (cmp == 0 && ((upper.f >> 1) & 1) == 0))
+    {
+      return guess;
+    }
+
+  double_todiyfp(guess, &upper);
+  return diyfp_todouble(upper.f + 1, upper.e);
+}
+
+/****************************************************************************
+ * Name: strtod_convert
+ *
+ * Description:
+ *   Convert the scanned digits to the nearest double.
+ *
+ ****************************************************************************/
+
+static double strtod_convert(FAR const struct strtod_scan_s *scan)
+{
+  double result;
+
+  if (strtod_exact(scan, &result) || strtod_diyfp(scan, &result))
+    {
+      return result;
+    }
+
+  return strtod_bignum(scan, result);
+}
+
+#else /* CONFIG_HAVE_LONG_LONG */
+/****************************************************************************
+ * Name: strtod_convert
+ *
+ * Description:
+ *   Convert the scanned digits without 64-bit integers:  Accumulate the
+ *   digits in a double and scale by a power of ten.  This may be off by
+ *   a few ulp.
+ *
+ ****************************************************************************/
+
+static double strtod_convert(FAR const struct strtod_scan_s *scan)
+{
+  FAR const char *p;
+  double number = 0.0;
+  double p10 = 10.0;
+  int dexp = scan->dexp;
+  int n;
+  int i;
+
+  for (p = scan->digits, i = 0; i < scan->ndigits; p++)
+    {
+      if (*p != '.')
+        {
+          number = number * 10.0 + (*p - '0');
+          i++;
+        }
+    }
+
+  for (n = dexp < 0 ? -dexp : dexp; n != 0; n >>= 1, p10 *= p10)
+    {
+      if ((n & 1) != 0)
+        {
+          if (dexp < 0)
             {
               number /= p10;
             }
@@ -220,21 +1073,107 @@ double_t strtod(FAR const char *str, FAR char **endptr)
               number *= p10;
             }
         }
-      n >>= 1;
-      p10 *= p10;
     }
 
-  if (!is_real(number))
+  return number;
+}
+#endif /* CONFIG_HAVE_LONG_LONG */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: strtod
+ *
+ * Description:
+ *   Convert a string to a double value.  The result is correctly rounded:
+ *   Most inputs need only one floating point operation or one 64-bit
+ *   scaled multiplication; only inputs very close to halfway between two
+ *   doubles are decided with big number arithmetic.
+ *
+ ****************************************************************************/
+
+double_t strtod(FAR const char *str, FAR char **endptr)
+{
+  struct strtod_scan_s scan;
+  FAR const char *p = str;
+  FAR const char *end;
+  bool negative = false;
+  double_t number;
+
+  /* Skip leading whitespace */
+
+  while (isspace(*p))
+    {
+      p++;
+    }
+
+  /* Handle optional sign */
+
+  if (*p == '-' || *p == '+')
+    {
+      negative = (*p == '-');
+      p++;
+    }
+
+  /* Infinity and NaN */
+
+  if (strtod_match(p, "inf"))
     {
-      set_errno(ERANGE);
+      end    = p + (strtod_match(p, "infinity") ? 8 : 3);
+      number = STRTOD_INFINITY;
+    }
+  else if (strtod_match(p, "nan"))
+    {
+      end    = p + 3;
+      number = 0.0 / 0.0;
+    }
+  else
+    {
+      end = strtod_scan(p, &scan);
+      if (end == NULL)
+        {
+          /* No conversion could be performed */
+
+          if (endptr)
+            {
+              *endptr = (FAR char *)str;
+            }
+
+          return 0.0;
+        }
+
+      if (scan.ndigits == 0)
+        {
+          number = 0.0;
+        }
+      else if (scan.dexp + scan.ndigits > STRTOD_MAX_DECPT)
+        {
+          number = STRTOD_INFINITY;
+          set_errno(ERANGE);
+        }
+      else if (scan.dexp + scan.ndigits < STRTOD_MIN_DECPT)
+        {
+          number = 0.0;
+          set_errno(ERANGE);
+        }
+      else
+        {
+          number = strtod_convert(&scan);
+          if (number == STRTOD_INFINITY || number == 0.0)
+            {
+              set_errno(ERANGE);
+            }
+        }
     }
 
   if (endptr)
     {
-      *endptr = p;
+      *endptr = (FAR char *)end;
     }
 
-  return number;
+  return negative ? -number : number;
 }
 
 #endif /* CONFIG_HAVE_DOUBLE */
@@ -43,8 +43,22 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The optimized copy moves data in units of uintptr_t, the natural word
+ * size of the architecture.  MEMCPY_BLOCK is the number of bytes moved by
+ * each pass of the unrolled inner loop.
+ */
+
+#define MEMCPY_WORDSIZE  sizeof(uintptr_t)
+#define MEMCPY_WORDMASK  (MEMCPY_WORDSIZE - 1)
+#define MEMCPY_BLOCK     (4 * MEMCPY_WORDSIZE)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -58,6 +72,58 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+#ifdef CONFIG_MEMCPY_OPTSPEED
+  /* Word copies are only possible if the source and destination can be
+   * brought to a word boundary at the same time.  Otherwise, fall through
+   * to the byte-by-byte copy.
+   */
+
+  if (n >= MEMCPY_WORDSIZE &&
+      (((uintptr_t)pout ^ (uintptr_t)pin) & MEMCPY_WORDMASK) == 0)
+    {
+      FAR uintptr_t *wout;
+      FAR const uintptr_t *win;
+
+      /* Copy the unaligned head one byte at a time */
+
+      while (((uintptr_t)pout & MEMCPY_WORDMASK) != 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout = (FAR uintptr_t *)pout;
+      win  = (FAR const uintptr_t *)pin;
+
+      /* Copy blocks of four words */
+
+      while (n >= MEMCPY_BLOCK)
+        {
+          wout[0] = win[0];
+          wout[1] = win[1];
+          wout[2] = win[2];
+          wout[3] = win[3];
+          wout   += 4;
+          win    += 4;
+          n      -= MEMCPY_BLOCK;
+        }
+
+      /* Copy any remaining whole words */
+
+      while (n >= MEMCPY_WORDSIZE)
+        {
+          *wout++ = *win++;
+          n      -= MEMCPY_WORDSIZE;
+        }
+
+      pout = (FAR unsigned char *)wout;
+      pin  = (FAR unsigned char *)win;
+    }
+#endif
+
+  /* Copy the tail (or everything if optimization is not selected) */
+
   while (n-- > 0) *pout++ = *pin++;
   return dest;
 }
@@ -43,8 +43,16 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MEMMOVE_WORDSIZE  sizeof(uintptr_t)
+#define MEMMOVE_WORDMASK  (MEMMOVE_WORDSIZE - 1)
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -60,6 +68,38 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest;
       s   = (FAR char *) src;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+      /* Copy forward a word at a time if the source and destination share
+       * the same alignment.  Copying forward is safe even if the regions
+       * overlap because the destination is below the source.
+       */
+
+      if (count >= MEMMOVE_WORDSIZE &&
+          (((uintptr_t)tmp ^ (uintptr_t)s) & MEMMOVE_WORDMASK) == 0)
+        {
+          FAR uintptr_t *wtmp;
+          FAR const uintptr_t *ws;
+
+          while (((uintptr_t)tmp & MEMMOVE_WORDMASK) != 0)
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          wtmp = (FAR uintptr_t *)tmp;
+          ws   = (FAR const uintptr_t *)s;
+
+          while (count >= MEMMOVE_WORDSIZE)
+            {
+              *wtmp++ = *ws++;
+              count  -= MEMMOVE_WORDSIZE;
+            }
+
+          tmp = (FAR char *)wtmp;
+          s   = (FAR char *)ws;
+        }
+#endif
+
       while (count--)
         {
           *tmp++ = *s++;
@@ -70,6 +110,35 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest + count;
       s   = (FAR char *) src + count;
 
+#ifdef CONFIG_MEMMOVE_OPTSPEED
+      /* Same as above, but copying backward from the end of the regions */
+
+      if (count >= MEMMOVE_WORDSIZE &&
+          (((uintptr_t)tmp ^ (uintptr_t)s) & MEMMOVE_WORDMASK) == 0)
+        {
+          FAR uintptr_t *wtmp;
+          FAR const uintptr_t *ws;
+
+          while (((uintptr_t)tmp & MEMMOVE_WORDMASK) != 0)
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          wtmp = (FAR uintptr_t *)tmp;
+          ws   = (FAR const uintptr_t *)s;
+
+          while (count >= MEMMOVE_WORDSIZE)
+            {
+              *--wtmp = *--ws;
+              count  -= MEMMOVE_WORDSIZE;
+            }
+
+          tmp = (FAR char *)wtmp;
+          s   = (FAR char *)ws;
+        }
+#endif
+
       while (count--)
         {
           *--tmp = *--s;
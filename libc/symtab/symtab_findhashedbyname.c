@@ -0,0 +1,131 @@
+/****************************************************************************
+ * libc/symtab/symtab_findhashedbyname.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/symtab.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name.  This is the same hash that
+ *   tools/mksymtab uses to place the symbols when the -H option is given.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_findhashedbyname
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name.  This
+ *   version assumes that the table was generated by 'mksymtab -H':  Each
+ *   symbol is at the index given by its name hash modulo nsyms or, if
+ *   that entry was already taken, at one of the following entries (wrapping
+ *   around at the end of the table).  Unused entries have a NULL name and
+ *   terminate the search.  Entries for symbols that were conditionally
+ *   excluded from the build have an empty name; these do not match any
+ *   name but do not terminate the search.
+ *
+ *   Because the tables are generated with no more than half of the entries
+ *   used, the access time is nearly constant.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findhashedbyname(FAR const struct symtab_s *symtab,
+                        FAR const char *name, int nsyms)
+{
+  FAR const char *symname;
+  int ndx;
+  int i;
+
+  DEBUGASSERT(symtab != NULL && name != NULL);
+
+  if (nsyms <= 0)
+    {
+      return NULL;
+    }
+
+  ndx = symtab_hash(name) % (uint32_t)nsyms;
+  for (i = 0; i < nsyms; i++)
+    {
+      symname = symtab[ndx].sym_name;
+      if (symname == NULL)
+        {
+          break;
+        }
+
+      if (strcmp(name, symname) == 0)
+        {
+          return &symtab[ndx];
+        }
+
+      if (++ndx >= nsyms)
+        {
+          ndx = 0;
+        }
+    }
+
+  return NULL;
+}
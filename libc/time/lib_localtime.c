@@ -56,6 +56,7 @@
 #include <string.h>
 #include <limits.h>
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <errno.h>
 
 /****************************************************************************
@@ -70,6 +71,12 @@
 #  define TZDIR "/etc/zoneinfo"
 #endif
 
+/* Interval (in seconds) between checks for a replaced TZif file */
+
+#ifndef CONFIG_LIBC_TZ_RECHECK
+#  define CONFIG_LIBC_TZ_RECHECK 0
+#endif
+
 /* Time definitions *********************************************************/
 
 /* Time zone files */
@@ -281,6 +288,9 @@ struct state_s
   char chars[BIGGEST(BIGGEST(TZ_MAX_CHARS + 1, GMTLEN), (2 * (MY_TZNAME_MAX + 1)))];
   struct lsinfo_s lsis[TZ_MAX_LEAPS];
   int defaulttype;            /* For early times or if no transitions */
+  time_t cstart;              /* Start of the last interval looked up */
+  time_t cend;                /* End (exclusive) of that interval */
+  int ctype;                  /* Time type used in that interval */
 };
 
 struct rule_s
@@ -314,6 +324,15 @@ static char g_lcl_tzname[MY_TZNAME_MAX + 1];
 static int g_lcl_isset;
 static int g_gmt_isset;
 
+#if CONFIG_LIBC_TZ_RECHECK > 0
+/* Modification time of the TZif file that the local zone was loaded from
+ * (zero if it was not loaded from a file) and the time of the last check.
+ */
+
+static time_t g_lcl_mtime;
+static time_t g_lcl_checked;
+#endif
+
 /* Section 4.12.3 of X3.159-1989 requires that
  *    Except for the strftime function, these functions [asctime,
  *    ctime, gmtime, localtime] return values in one of two static
@@ -393,6 +412,9 @@ static int  tmcomp(FAR const struct tm *atmp, FAR const struct tm *btmp);
 static int_fast32_t transtime(int year, FAR const struct rule_s *rulep,
               int_fast32_t offset);
 static int  typesequiv(FAR const struct state_s *sp, int a, int b);
+static FAR const char *tzfilename(FAR const char *name, FAR char *fullname);
+static void tzloaded(FAR const char *name, int fromfile);
+static int  tzchanged(FAR const char *name);
 static int  tzload(FAR const char *name, FAR struct state_s *sp,
               int doextend);
 static int  tzparse(FAR const char *name, FAR struct state_s *sp,
@@ -494,6 +516,116 @@ static int differ_by_repeat(const time_t t1, const time_t t0)
   return t1 - t0 == SECSPERREPEAT;
 }
 
+/* Resolve the name of a time zone to the path of its TZif file.  Names
+ * that are not absolute are relative to TZDIR.  fullname must provide
+ * FILENAME_MAX + 1 bytes of storage.
+ */
+
+static FAR const char *tzfilename(FAR const char *name, FAR char *fullname)
+{
+  FAR const char *p;
+
+  if (!name)
+    {
+      name = TZDEFAULT;
+    }
+
+  if (name[0] == ':')
+    {
+      ++name;
+    }
+
+  if (name[0] == '/')
+    {
+      return name;
+    }
+
+  p = TZDIR;
+  if (!p || FILENAME_MAX <= strlen(p) + strlen(name))
+    {
+      return NULL;
+    }
+
+  strcpy(fullname, p);
+  strcat(fullname, "/");
+  strcat(fullname, name);
+  return fullname;
+}
+
+#if CONFIG_LIBC_TZ_RECHECK > 0
+/* Return the modification time of the TZif file for name, or zero if the
+ * file cannot be found.
+ */
+
+static time_t tzmtime(FAR const char *name)
+{
+  struct stat buf;
+  FAR char *fullname;
+  time_t mtime = 0;
+
+  fullname = malloc(FILENAME_MAX + 1);
+  if (fullname != NULL)
+    {
+      name = tzfilename(name, fullname);
+      if (name != NULL && stat(name, &buf) == 0)
+        {
+          mtime = buf.st_mtime;
+        }
+
+      free(fullname);
+    }
+
+  return mtime;
+}
+#endif
+
+/* Called after the local zone has been (re-)loaded.  Discard the cached
+ * lookup and, if the zone came from a TZif file, remember the file's
+ * modification time so that tzchanged() can detect a replaced file.
+ */
+
+static void tzloaded(FAR const char *name, int fromfile)
+{
+  if (lclptr != NULL)
+    {
+      lclptr->cstart = 0;
+      lclptr->cend   = 0;
+    }
+
+#if CONFIG_LIBC_TZ_RECHECK > 0
+  g_lcl_mtime   = fromfile ? tzmtime(name) : 0;
+  g_lcl_checked = time(NULL);
+#endif
+}
+
+/* Return TRUE if the TZif file that the local zone was loaded from has been
+ * replaced since it was loaded.  The file is checked at most once every
+ * CONFIG_LIBC_TZ_RECHECK seconds.
+ */
+
+static int tzchanged(FAR const char *name)
+{
+#if CONFIG_LIBC_TZ_RECHECK > 0
+  time_t now;
+
+  if (g_lcl_mtime == 0)
+    {
+      return FALSE;
+    }
+
+  now = time(NULL);
+  if (now >= g_lcl_checked && now - g_lcl_checked < CONFIG_LIBC_TZ_RECHECK)
+    {
+      return FALSE;
+    }
+
+  g_lcl_checked = now;
+  return tzmtime(name) != g_lcl_mtime;
+#else
+  return FALSE;
+#endif
+}
+
 static int tzload(FAR const char *name,
                   FAR struct state_s *const sp, const int doextend)
 {
@@ -548,10 +680,6 @@ static int tzload(FAR const char *name,
   if (!name)
     {
       name = TZDEFAULT;
-      if (!name)
-        {
-          goto oops;
-        }
     }
 
   if (name[0] == ':')
@@ -559,27 +687,15 @@ static int tzload(FAR const char *name,
       ++name;
     }
 
-  doaccess = name[0] == '/';
-  if (!doaccess)
-    {
-      p = TZDIR;
-      if (!p || sizeof lsp->fullname - 1 <= strlen(p) + strlen(name))
-        {
-          goto oops;
-        }
-
-      strcpy(fullname, p);
-      strcat(fullname, "/");
-      strcat(fullname, name);
-
-      /* Set doaccess if '.' (as in "../") shows up in name.  */
-
-      if (strchr(name, '.'))
-        {
-          doaccess = TRUE;
-        }
+  /* Check access if the name is absolute or if '.' (as in "../") shows up
+   * in name.
+   */
 
-      name = fullname;
+  doaccess = name[0] == '/' || strchr(name, '.') != NULL;
+  name = tzfilename(name, fullname);
+  if (name == NULL)
+    {
+      goto oops;
     }
 
   if (doaccess && access(name, R_OK) != 0)
@@ -1612,7 +1728,9 @@ static void gmtload(FAR struct state_s *const sp)
 
 static void tzsetwall(void)
 {
-  if (g_lcl_isset < 0)
+  int fromfile;
+
+  if (g_lcl_isset < 0 && !tzchanged(NULL))
     {
       return;
     }
@@ -1629,11 +1747,13 @@ static void tzsetwall(void)
         }
     }
 
-  if (tzload(NULL, lclptr, TRUE) != 0)
+  fromfile = tzload(NULL, lclptr, TRUE) == 0;
+  if (!fromfile)
     {
       gmtload(lclptr);
     }
 
+  tzloaded(NULL, fromfile);
   settzname();
 }
 
@@ -1660,8 +1780,16 @@ static struct tm *localsub(FAR const time_t * const timep,
       return gmtsub(timep, offset, tmp);
     }
 
-  if ((sp->goback && t < sp->ats[0]) ||
-      (sp->goahead && t > sp->ats[sp->timecnt - 1]))
+  /* Successive lookups are usually for nearby times, so first check if the
+   * time lies in the same interval between transitions as the last lookup.
+   */
+
+  if (t >= sp->cstart && t < sp->cend)
+    {
+      i = sp->ctype;
+    }
+  else if ((sp->goback && t < sp->ats[0]) ||
+           (sp->goahead && t > sp->ats[sp->timecnt - 1]))
     {
       time_t newt = t;
       time_t seconds;
@@ -1717,10 +1845,12 @@ static struct tm *localsub(FAR const time_t * const timep,
 
       return result;
     }
-
-  if (sp->timecnt == 0 || t < sp->ats[0])
+  else if (sp->timecnt == 0 || t < sp->ats[0])
     {
       i = sp->defaulttype;
+      sp->cstart = g_min_timet;
+      sp->cend = sp->timecnt == 0 ? g_max_timet : sp->ats[0];
+      sp->ctype = i;
     }
   else
     {
@@ -1742,6 +1872,23 @@ static struct tm *localsub(FAR const time_t * const timep,
         }
 
       i = (int)sp->types[lo - 1];
+
+      /* Remember the interval up to the next transition.  Times after the
+       * last transition are handled above if goahead is set, so then only
+       * the time of the last transition itself can be cached.
+       */
+
+      sp->cstart = sp->ats[lo - 1];
+      if (lo < sp->timecnt)
+        {
+          sp->cend = sp->ats[lo];
+        }
+      else
+        {
+          sp->cend = sp->goahead ? sp->cstart + 1 : g_max_timet;
+        }
+
+      sp->ctype = i;
     }
 
   ttisp = &sp->ttis[i];
@@ -2457,6 +2604,7 @@ static time_t time1(FAR struct tm *const tmp,
 void tzset(void)
 {
   FAR const char *name;
+  int fromfile = FALSE;
 
   name = getenv("TZ");
   if (name == NULL)
@@ -2465,7 +2613,8 @@ void tzset(void)
       return;
     }
 
-  if (g_lcl_isset > 0 && strcmp(g_lcl_tzname, name) == 0)
+  if (g_lcl_isset > 0 && strcmp(g_lcl_tzname, name) == 0 &&
+      !tzchanged(name))
     {
       return;
     }
@@ -2498,14 +2647,16 @@ void tzset(void)
       lclptr->ttis[0].tt_abbrind = 0;
       (void)strcpy(lclptr->chars, GMT);
     }
-  else if (tzload(name, lclptr, TRUE) != 0)
+  else if (tzload(name, lclptr, TRUE) == 0)
     {
-      if (name[0] == ':' || tzparse(name, lclptr, FALSE) != 0)
-        {
-          (void)gmtload(lclptr);
-        }
+      fromfile = TRUE;
+    }
+  else if (name[0] == ':' || tzparse(name, lclptr, FALSE) != 0)
+    {
+      (void)gmtload(lclptr);
     }
 
+  tzloaded(name, fromfile);
   settzname();
 }
 
@@ -56,6 +56,45 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_insert
+ *
+ * Description:
+ *   Insert work into the work queue list, keeping the list sorted by the
+ *   time remaining until each entry is due.  Entries with the same due
+ *   time stay in the order that they were queued.
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+static void work_insert(FAR dq_queue_t *q, FAR struct work_s *work)
+{
+  FAR struct work_s *prev;
+  systime_t elapsed;
+
+  for (prev = (FAR struct work_s *)q->tail;
+       prev != NULL;
+       prev = (FAR struct work_s *)prev->dq.blink)
+    {
+      elapsed = work->qtime - prev->qtime;
+      if (elapsed >= prev->delay || prev->delay - elapsed <= work->delay)
+        {
+          break;
+        }
+    }
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)work, q);
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)work, q);
+    }
+}
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -79,6 +118,8 @@
  *            int is invoked.
  *   delay  - Delay (in clock ticks) from the time queue until the worker
  *            is invoked. Zero means to perform the work immediately.
+ *   slack  - Additional ticks that the work may be deferred so that it can
+ *            be performed together with other work.
  *
  * Returned Value:
  *   Zero on success, a negated errno on failure
@@ -87,7 +128,7 @@
 
 static int work_qqueue(FAR struct usr_wqueue_s *wqueue,
                        FAR struct work_s *work, worker_t worker,
-                       FAR void *arg, systime_t delay)
+                       FAR void *arg, systime_t delay, systime_t slack)
 {
   DEBUGASSERT(work != NULL);
 
@@ -100,12 +141,13 @@ static int work_qqueue(FAR struct usr_wqueue_s *wqueue,
   work->worker = worker;           /* Work callback. non-NULL means queued */
   work->arg    = arg;              /* Callback argument */
   work->delay  = delay;            /* Delay until work performed */
+  work->slack  = slack;            /* Permitted additional delay */
 
   /* Now, time-tag that entry and put it in the work queue. */
 
   work->qtime  = clock_systimer(); /* Time work queued */
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  work_insert(&wqueue->q, work);
   kill(wqueue->pid, SIGWORK);   /* Wake up the worker thread */
 
   work_unlock();
@@ -147,10 +189,38 @@ static int work_qqueue(FAR struct usr_wqueue_s *wqueue,
 
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, systime_t delay)
+{
+  return work_queue_slack(qid, work, worker, arg, delay, 0);
+}
+
+/****************************************************************************
+ * Name: work_queue_slack
+ *
+ * Description:
+ *   Queue user-mode work to be performed at a later time, permitting the
+ *   work to be deferred by up to 'slack' ticks beyond its delay so that the
+ *   worker thread can perform it together with other delayed work.
+ *
+ * Input parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   slack  - Additional ticks that the work may be deferred.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_slack(int qid, FAR struct work_s *work, worker_t worker,
+                     FAR void *arg, systime_t delay, systime_t slack)
 {
   if (qid == USRWORK)
     {
-      return work_qqueue(&g_usrwork, work, worker, arg, delay);
+      return work_qqueue(&g_usrwork, work, worker, arg, delay, slack);
     }
   else
     {
@@ -221,34 +221,34 @@ void work_process(FAR struct usr_wqueue_s *wqueue)
         }
       else /* elapsed < work->delay */
         {
-          /* This one is not ready.
-           *
-           * NOTE that elapsed is relative to the the current time,
-           * not the time of beginning of this queue processing pass.
-           * So it may need an adjustment.
+          /* This one is not ready.  The list is sorted by due time so none
+           * of the work that follows is ready either.  Decide when to wake
+           * up next:  Any pending work may be deferred by its slack, so
+           * wake up at the earliest time that some work must be performed.
+           * That will perform all of the work that is due by then with a
+           * single wake-up.  The search can stop at the first work that is
+           * not due until after that time.
            */
 
-          elapsed += (ctick - stick);
-          if (elapsed > work->delay)
+          do
             {
-              /* The delay has expired while we are processing */
-
-              elapsed = work->delay;
-            }
-
-          /* Will it be ready before the next scheduled wakeup interval? */
+              elapsed = ctick - work->qtime;
+              remaining = elapsed >= work->delay ? 0 : work->delay - elapsed;
+              if (remaining >= next)
+                {
+                  break;
+                }
 
-          remaining = work->delay - elapsed;
-          if (remaining < next)
-            {
-              /* Yes.. Then schedule to wake up when the work is ready */
+              if (work->worker != NULL && work->slack < next - remaining)
+                {
+                  next = remaining + work->slack;
+                }
 
-              next = remaining;
+              work = (FAR struct work_s *)work->dq.flink;
             }
+          while (work != NULL);
 
-          /* Then try the next in the list. */
-
-          work = (FAR struct work_s *)work->dq.flink;
+          break;
         }
     }
 
@@ -58,21 +58,62 @@
 #  define lib_malloc(s)    kmm_malloc(s)
 #  define lib_zalloc(s)    kmm_zalloc(s)
 #  define lib_realloc(p,s) kmm_realloc(p,s)
+#  define lib_memalign(a,s) kmm_memalign(a,s)
 #  define lib_free(p)      kmm_free(p)
 #else
 #  include <cstdlib>
 #  define lib_malloc(s)    malloc(s)
 #  define lib_zalloc(s)    zalloc(s)
 #  define lib_realloc(p,s) realloc(p,s)
+#  define lib_memalign(a,s) memalign(a,s)
 #  define lib_free(p)      free(p)
 #endif
 
+// The pool for small C++ objects.  Objects of up to CONFIG_LIBXX_POOL_MAXSIZE
+// bytes are allocated from a granule allocator instance managing a static
+// region of CONFIG_LIBXX_POOL_SIZE bytes.
+
+#ifdef CONFIG_LIBXX_POOL
+#  ifndef CONFIG_LIBXX_POOL_SIZE
+#    define CONFIG_LIBXX_POOL_SIZE 4096
+#  endif
+#  ifndef CONFIG_LIBXX_POOL_LOG2GRAN
+#    define CONFIG_LIBXX_POOL_LOG2GRAN 4
+#  endif
+#  ifndef CONFIG_LIBXX_POOL_MAXSIZE
+#    define CONFIG_LIBXX_POOL_MAXSIZE 128
+#  endif
+#endif
+
 //***************************************************************************
 // Public Types
 //***************************************************************************/
 
 typedef CODE void (*__cxa_exitfunc_t)(void *arg);
 
+// The operators take the toolchain's size_t which may not have the same
+// underlying type as the NuttX size_t (see the NOTE in libxx_new.cxx).
+
+#ifdef CONFIG_CXX_NEWLONG
+typedef unsigned long libxx_size_t;
+#else
+typedef unsigned int libxx_size_t;
+#endif
+
+// The alignment argument of the C++17 aligned new and delete operators.
+// There is no <new> header to provide it.  GCC predeclares this type with
+// the toolchain's size_t as its underlying type, so the redeclaration must
+// use exactly __SIZE_TYPE__ and not libxx_size_t, which may differ.
+
+#ifdef __cpp_aligned_new
+namespace std
+{
+  enum class align_val_t : __SIZE_TYPE__
+  {
+  };
+}
+#endif
+
 //***************************************************************************
 // Public Data
 //***************************************************************************
@@ -85,4 +126,9 @@ extern "C" FAR void *__dso_handle;
 
 extern "C" int __cxa_atexit(__cxa_exitfunc_t func, void *arg, void *dso_handle);
 
+#ifdef CONFIG_LIBXX_POOL
+FAR void *libxx_pool_alloc(libxx_size_t nbytes);
+bool libxx_pool_free(FAR void *ptr, libxx_size_t nbytes);
+#endif
+
 #endif // __LIBXX_LIBXX_HXX
@@ -37,12 +37,25 @@
 // Included Files
 //***************************************************************************
 
+#include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdint.h>
+#include <semaphore.h>
+
 //***************************************************************************
 // Pre-processor Definitions
 //***************************************************************************
 
+// The first byte of the guard is set once the object has been initialized.
+// This is the byte tested by the inline check that the compiler emits
+// before each call to __cxa_guard_acquire() (bit 0 of the guard word for
+// the ARM EABI which, on a little-endian target, is the same thing).  The
+// second byte is set while some thread is running the initializer.
+
+#define GUARD_DONE(g)    (&((FAR uint8_t *)(g))[0])
+#define GUARD_PENDING(g) (&((FAR uint8_t *)(g))[1])
+
 //***************************************************************************
 // Private Types
 //***************************************************************************
@@ -53,6 +66,42 @@ __extension__ typedef int __guard __attribute__((mode(__DI__)));
 // Private Data
 //***************************************************************************
 
+// The slow path is serialized by one lock for all guards.  Threads that
+// find another thread running the initializer wait on g_guardwait; every
+// waiter is woken whenever any initialization completes or is aborted and
+// then checks its own guard again.  The lock is never held while an
+// initializer runs, so initializers may themselves initialize other
+// function-local statics.
+
+static sem_t g_guardlock = SEM_INITIALIZER(1);
+static sem_t g_guardwait = SEM_INITIALIZER(0);
+static unsigned int g_guardwaiters;
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+static void guard_lock(void)
+{
+  while (sem_wait(&g_guardlock) < 0);
+}
+
+static void guard_unlock(void)
+{
+  sem_post(&g_guardlock);
+}
+
+// Wake all waiting threads.  Called with the lock held.
+
+static void guard_broadcast(void)
+{
+  while (g_guardwaiters > 0)
+    {
+      g_guardwaiters--;
+      sem_post(&g_guardwait);
+    }
+}
+
 //***************************************************************************
 // Public Functions
 //***************************************************************************
@@ -61,11 +110,51 @@ extern "C"
 {
   //*************************************************************************
   // Name: __cxa_guard_acquire
+  //
+  // Description:
+  //   Return 1 if the caller must run the initializer and then call
+  //   __cxa_guard_release() (or __cxa_guard_abort() if it throws).  Return
+  //   0 if the object has already been initialized.
+  //
+  //   An initialized guard costs a single acquire load.  The lock is taken
+  //   only by the first users of an object.
+  //
   //*************************************************************************
 
   int __cxa_guard_acquire(FAR __guard *g)
   {
-    return !*g;
+    if (__atomic_load_n(GUARD_DONE(g), __ATOMIC_ACQUIRE) != 0)
+      {
+        return 0;
+      }
+
+    guard_lock();
+
+    for (; ; )
+      {
+        if (*GUARD_DONE(g) != 0)
+          {
+            guard_unlock();
+            return 0;
+          }
+
+        if (*GUARD_PENDING(g) == 0)
+          {
+            *GUARD_PENDING(g) = 1;
+            guard_unlock();
+            return 1;
+          }
+
+        // Another thread is running the initializer.  Wait for it to
+        // finish.
+
+        g_guardwaiters++;
+        guard_unlock();
+
+        while (sem_wait(&g_guardwait) < 0);
+
+        guard_lock();
+      }
   }
 
   //*************************************************************************
@@ -74,14 +163,26 @@ extern "C"
 
   void __cxa_guard_release(FAR __guard *g)
   {
-    *g = 1;
+    guard_lock();
+
+    // Publish the initialized object before the guard that protects it
+
+    __atomic_store_n(GUARD_DONE(g), 1, __ATOMIC_RELEASE);
+    *GUARD_PENDING(g) = 0;
+
+    guard_broadcast();
+    guard_unlock();
   }
 
   //*************************************************************************
   // Name: __cxa_guard_abort
   //*************************************************************************
 
-  void __cxa_guard_abort(FAR __guard *)
+  void __cxa_guard_abort(FAR __guard *g)
   {
+    guard_lock();
+    *GUARD_PENDING(g) = 0;
+    guard_broadcast();
+    guard_unlock();
   }
 }
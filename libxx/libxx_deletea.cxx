@@ -58,6 +58,51 @@
 //***************************************************************************
 
 void operator delete[](void *ptr)
+{
+#ifdef CONFIG_LIBXX_POOL
+  if (libxx_pool_free(ptr, 0))
+    {
+      return;
+    }
+#endif
+
+  lib_free(ptr);
+}
+
+//***************************************************************************
+// Name: delete[] (sized)
+//
+// Description:
+//   The C++14 sized deallocation function.  The size is the one that was
+//   passed to operator new[] so that pool memory can be released
+//   without looking up its size.
+//
+//***************************************************************************
+
+void operator delete[](void *ptr, libxx_size_t nbytes)
+{
+#ifdef CONFIG_LIBXX_POOL
+  if (libxx_pool_free(ptr, nbytes < 1 ? 1 : nbytes))
+    {
+      return;
+    }
+#endif
+
+  lib_free(ptr);
+}
+
+//***************************************************************************
+// Name: delete[] (aligned)
+//***************************************************************************
+
+#ifdef __cpp_aligned_new
+void operator delete[](void *ptr, std::align_val_t)
+{
+  lib_free(ptr);
+}
+
+void operator delete[](void *ptr, libxx_size_t, std::align_val_t)
 {
   lib_free(ptr);
 }
+#endif
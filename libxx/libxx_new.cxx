@@ -83,9 +83,18 @@ void *operator new(unsigned int nbytes)
       nbytes = 1;
     }
 
-  // Perform the allocation
+  // Perform the allocation.  Small objects come from the pool if there is
+  // room in it.
 
+#ifdef CONFIG_LIBXX_POOL
+  void *alloc = libxx_pool_alloc(nbytes);
+  if (alloc == 0)
+    {
+      alloc = lib_malloc(nbytes);
+    }
+#else
   void *alloc = lib_malloc(nbytes);
+#endif
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (alloc == 0)
@@ -101,3 +110,33 @@ void *operator new(unsigned int nbytes)
 
   return alloc;
 }
+
+//***************************************************************************
+// Name: new (aligned)
+//
+// Description:
+//   The C++17 allocation function for types with extended alignment
+//   requirements.  These never come from the pool.
+//
+//***************************************************************************
+
+#ifdef __cpp_aligned_new
+void *operator new(libxx_size_t nbytes, std::align_val_t align)
+{
+  if (nbytes < 1)
+    {
+      nbytes = 1;
+    }
+
+  void *alloc = lib_memalign((size_t)align, nbytes);
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (alloc == 0)
+    {
+      _err("ERROR: Failed to allocate\n");
+    }
+#endif
+
+  return alloc;
+}
+#endif
@@ -0,0 +1,193 @@
+//***************************************************************************
+// libxx/libxx_pool.cxx
+//
+//   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+//   Author: Gregory Nutt <gnutt@nuttx.org>
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in
+//    the documentation and/or other materials provided with the
+//    distribution.
+// 3. Neither the name NuttX nor the names of its contributors may be
+//    used to endorse or promote products derived from this software
+//    without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+// AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <semaphore.h>
+
+#include <nuttx/mm/gran.h>
+
+#include "libxx.hxx"
+
+#ifdef CONFIG_LIBXX_POOL
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+#define POOL_GRANSIZE  (1 << CONFIG_LIBXX_POOL_LOG2GRAN)
+#define POOL_NGRANULES (CONFIG_LIBXX_POOL_SIZE >> CONFIG_LIBXX_POOL_LOG2GRAN)
+
+// The granule allocator can allocate no more than 32 granules at a time and
+// the size table holds granule counts in one byte.
+
+#if CONFIG_LIBXX_POOL_MAXSIZE > (32 << CONFIG_LIBXX_POOL_LOG2GRAN)
+#  error CONFIG_LIBXX_POOL_MAXSIZE is larger than 32 granules
+#endif
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+// The memory managed by the pool
+
+static uint8_t g_poolheap[CONFIG_LIBXX_POOL_SIZE]
+  __attribute__((aligned(POOL_GRANSIZE)));
+
+// The size, in granules, of the allocation starting at each granule.  This
+// is what lets the unsized operator delete return memory to the pool.
+// Each entry is written only by the owner of the allocation so that no
+// locking is needed.
+
+static uint8_t g_poolngran[POOL_NGRANULES];
+
+// The granule allocator instance, created on first use because operator
+// new may be called by static constructors before anything else has run.
+
+static GRAN_HANDLE g_poolhandle;
+static sem_t g_poolsem = SEM_INITIALIZER(1);
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_pool_handle
+//
+// Description:
+//   Return the granule allocator handle, creating the allocator if
+//   necessary.  NULL is returned if it could not be created.
+//
+//***************************************************************************
+
+static GRAN_HANDLE libxx_pool_handle(void)
+{
+  GRAN_HANDLE handle = g_poolhandle;
+
+  if (handle == NULL)
+    {
+      while (sem_wait(&g_poolsem) < 0);
+
+      handle = g_poolhandle;
+      if (handle == NULL)
+        {
+          handle = gran_initialize(g_poolheap, CONFIG_LIBXX_POOL_SIZE,
+                                   CONFIG_LIBXX_POOL_LOG2GRAN,
+                                   CONFIG_LIBXX_POOL_LOG2GRAN);
+          g_poolhandle = handle;
+        }
+
+      sem_post(&g_poolsem);
+    }
+
+  return handle;
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: libxx_pool_alloc
+//
+// Description:
+//   Allocate a small object from the pool.  NULL is returned if the object
+//   is too large for the pool or if the pool is exhausted; the caller then
+//   falls back to the heap.
+//
+//***************************************************************************
+
+FAR void *libxx_pool_alloc(libxx_size_t nbytes)
+{
+  GRAN_HANDLE handle;
+  FAR uint8_t *alloc;
+
+  if (nbytes > CONFIG_LIBXX_POOL_MAXSIZE ||
+      (handle = libxx_pool_handle()) == NULL)
+    {
+      return NULL;
+    }
+
+  alloc = (FAR uint8_t *)gran_alloc(handle, nbytes);
+  if (alloc != NULL)
+    {
+      g_poolngran[(alloc - g_poolheap) >> CONFIG_LIBXX_POOL_LOG2GRAN] =
+        (nbytes + POOL_GRANSIZE - 1) >> CONFIG_LIBXX_POOL_LOG2GRAN;
+    }
+
+  return alloc;
+}
+
+//***************************************************************************
+// Name: libxx_pool_free
+//
+// Description:
+//   Return memory to the pool if it came from the pool.  nbytes is the size
+//   of the allocation if known (from a sized operator delete) or zero if it
+//   must be looked up.
+//
+// Returned Value:
+//   true if the memory belonged to the pool and was freed; false if it must
+//   be returned to the heap instead.
+//
+//***************************************************************************
+
+bool libxx_pool_free(FAR void *ptr, libxx_size_t nbytes)
+{
+  FAR uint8_t *mem = (FAR uint8_t *)ptr;
+
+  if (mem < g_poolheap || mem >= g_poolheap + CONFIG_LIBXX_POOL_SIZE)
+    {
+      return false;
+    }
+
+  if (nbytes == 0)
+    {
+      nbytes = (libxx_size_t)
+        g_poolngran[(mem - g_poolheap) >> CONFIG_LIBXX_POOL_LOG2GRAN] <<
+        CONFIG_LIBXX_POOL_LOG2GRAN;
+    }
+
+  gran_free(g_poolhandle, mem, nbytes);
+  return true;
+}
+
+#endif // CONFIG_LIBXX_POOL
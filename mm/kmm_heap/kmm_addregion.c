@@ -67,4 +67,24 @@ void kmm_addregion(FAR void *heap_start, size_t heap_size)
   return mm_addregion(&g_kmmheap, heap_start, heap_size);
 }
 
+/****************************************************************************
+ * Name: kmm_regionattr
+ *
+ * Description:
+ *   Set the attributes of the kernel heap region that contains 'mem'.
+ *
+ * Parameters:
+ *   mem  - Any address within the region
+ *   attr - The region attributes (MM_REGION_* bits)
+ *
+ * Return Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int kmm_regionattr(FAR void *mem, uint8_t attr)
+{
+  return mm_regionattr(&g_kmmheap, mem, attr);
+}
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -66,4 +66,24 @@ FAR void *kmm_malloc(size_t size)
   return mm_malloc(&g_kmmheap, size);
 }
 
+/****************************************************************************
+ * Name: kmm_malloc_attr
+ *
+ * Description:
+ *   Allocate memory from a kernel heap region with the attributes 'attr'.
+ *
+ * Parameters:
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *   attr - The required region attributes (MM_REGION_* bits)
+ *
+ * Return Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+FAR void *kmm_malloc_attr(size_t size, uint8_t attr)
+{
+  return mm_malloc_attr(&g_kmmheap, size, attr);
+}
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -0,0 +1,168 @@
+/****************************************************************************
+ * mm/mempool/mempool_alloc.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+
+#include "mempool/mempool.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_expand
+ *
+ * Description:
+ *   Allocate one expansion chunk from the heap and add its blocks to the
+ *   free list.  The chunk is linked into the list of chunks through an
+ *   sq_entry_t that follows the last block in the chunk.
+ *
+ * Assumptions:
+ *   Called from a task context with interrupts enabled.
+ *
+ ****************************************************************************/
+
+static bool mempool_expand(FAR struct mempool_s *pool)
+{
+  FAR uint8_t *chunk;
+  irqstate_t flags;
+  size_t size;
+
+  size  = pool->blocksize * pool->nexpand;
+  chunk = (FAR uint8_t *)kmm_malloc(size + sizeof(sq_entry_t));
+  if (chunk == NULL)
+    {
+      return false;
+    }
+
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)(chunk + size), &pool->chunks);
+  mempool_addblocks(pool, chunk, pool->nexpand);
+  leave_critical_section(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_alloc
+ *
+ * Description:
+ *   Allocate one block from the pool.  This function may be called from an
+ *   interrupt handler.  In that case, the reserved blocks are available
+ *   but the pool will never be expanded.
+ *
+ * Input Parameters:
+ *   pool - The pool from which to allocate the block
+ *
+ * Returned Value:
+ *   The allocated block or NULL if no block is available.
+ *
+ ****************************************************************************/
+
+FAR void *mempool_alloc(FAR struct mempool_s *pool)
+{
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+  uint16_t nused;
+
+  DEBUGASSERT(pool != NULL);
+
+  for (; ; )
+    {
+      /* These actions must be atomic with respect to other tasks and also
+       * with respect to interrupt handlers that may be allocating or
+       * freeing blocks.
+       */
+
+      flags = enter_critical_section();
+
+      /* Interrupt handlers may take any free block.  Tasks may not take
+       * the reserved blocks if the pool can be expanded instead.
+       */
+
+      if (pool->nfree > pool->nreserve || pool->nexpand == 0 ||
+          up_interrupt_context())
+        {
+          blk = sq_remfirst(&pool->freelist);
+          if (blk != NULL)
+            {
+              DEBUGASSERT(pool->nfree > 0);
+              pool->nfree--;
+
+              nused = pool->nblocks - pool->nfree;
+              if (nused > pool->peak)
+                {
+                  pool->peak = nused;
+                }
+            }
+          else
+            {
+              pool->nfail++;
+            }
+
+          leave_critical_section(flags);
+          return blk;
+        }
+
+      /* We are in a task context and only the reserve remains.  Expand the
+       * pool (with interrupts enabled) and try again.
+       */
+
+      leave_critical_section(flags);
+      if (!mempool_expand(pool))
+        {
+          flags = enter_critical_section();
+          pool->nfail++;
+          leave_critical_section(flags);
+          return NULL;
+        }
+    }
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * mm/mempool/mempool_initialize.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mempool.h>
+
+#include "mempool/mempool.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mempool_addblocks
+ *
+ * Description:
+ *   Add 'nblocks' contiguous blocks beginning at 'base' to the free list of
+ *   the pool.  The caller must assure exclusive access to the pool.
+ *
+ ****************************************************************************/
+
+void mempool_addblocks(FAR struct mempool_s *pool, FAR void *base,
+                       unsigned int nblocks)
+{
+  FAR uint8_t *blk = (FAR uint8_t *)base;
+
+  pool->nblocks += nblocks;
+  pool->nfree   += nblocks;
+
+  while (nblocks-- > 0)
+    {
+      sq_addlast((FAR sq_entry_t *)blk, &pool->freelist);
+      blk += pool->blocksize;
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_initialize
+ *
+ * Description:
+ *   Set up a pool of fixed size memory blocks.
+ *
+ * Input Parameters:
+ *   pool      - The pool instance to be initialized
+ *   blocksize - The size of one block
+ *   pbuffer   - Memory to hold the initial blocks or NULL
+ *   ninitial  - The number of initial blocks
+ *   nreserve  - The number of blocks reserved for interrupt handlers
+ *   nexpand   - The number of blocks to add whenever the pool expands
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_initialize(FAR struct mempool_s *pool, size_t blocksize,
+                       FAR void *pbuffer, unsigned int ninitial,
+                       unsigned int nreserve, unsigned int nexpand)
+{
+  DEBUGASSERT(pool != NULL && blocksize > 0);
+
+  /* Each free block must hold the free list link.  Keeping the block size
+   * a multiple of the pointer size also keeps the link at the end of each
+   * expansion chunk properly aligned.
+   */
+
+  if (blocksize < sizeof(sq_entry_t))
+    {
+      blocksize = sizeof(sq_entry_t);
+    }
+
+  blocksize = (blocksize + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1);
+
+  sq_init(&pool->freelist);
+  sq_init(&pool->chunks);
+
+  pool->blocksize = blocksize;
+  pool->nreserve  = nreserve;
+  pool->nexpand   = nexpand;
+  pool->nblocks   = 0;
+  pool->nfree     = 0;
+  pool->peak      = 0;
+  pool->nfail     = 0;
+
+  /* Allocate the initial blocks from the heap if they were not provided */
+
+  if (ninitial > 0)
+    {
+      if (pbuffer == NULL)
+        {
+          pbuffer = kmm_malloc(blocksize * ninitial);
+          if (pbuffer == NULL)
+            {
+              return -ENOMEM;
+            }
+        }
+
+      mempool_addblocks(pool, pbuffer, ninitial);
+    }
+
+  return OK;
+}
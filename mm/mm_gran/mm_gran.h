@@ -56,8 +56,19 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+#define SIZEOF_GSUM(n) \
+  ((SIZEOF_GAT(n) + 31) >> 5)
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + \
+   sizeof(uint32_t) * (SIZEOF_GAT(n) + SIZEOF_GSUM(n) - 1))
+
+/* The GAT summary holds one bit for each GAT entry.  The bit is set if all
+ * granules of the GAT entry are allocated so that the search for free
+ * granules can skip over 32 entries at a time.
+ */
+
+#define GRAN_SUMSET(p,i) ((p)->gsum[(i) >> 5] |=  ((uint32_t)1 << ((i) & 31)))
+#define GRAN_SUMCLR(p,i) ((p)->gsum[(i) >> 5] &= ~((uint32_t)1 << ((i) & 31)))
 
 /* Debug */
 
@@ -93,12 +104,14 @@ struct gran_s
 {
   uint8_t    log2gran;  /* Log base 2 of the size of one granule */
   uint16_t   ngranules; /* The total number of (aligned) granules in the heap */
+  uint16_t   hint;      /* Granule where the next search begins (next fit) */
 #ifdef CONFIG_GRAN_INTR
   irqstate_t irqstate;  /* For exclusive access to the GAT */
 #else
   sem_t      exclsem;   /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+  FAR uint32_t *gsum;   /* The GAT summary (follows the GAT) */
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
@@ -112,6 +125,59 @@ struct gran_s
 extern FAR struct gran_s *g_graninfo;
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gran_ctz
+ *
+ * Description:
+ *   Return the number of trailing zero bits in a non-zero value, i.e., the
+ *   bit number of the least significant bit that is set.
+ *
+ ****************************************************************************/
+
+static inline unsigned int gran_ctz(uint32_t value)
+{
+#ifdef __GNUC__
+  return __builtin_ctz(value);
+#else
+  unsigned int bitno = 0;
+
+  if ((value & 0x0000ffff) == 0)
+    {
+      value >>= 16;
+      bitno  += 16;
+    }
+
+  if ((value & 0x000000ff) == 0)
+    {
+      value >>= 8;
+      bitno  += 8;
+    }
+
+  if ((value & 0x0000000f) == 0)
+    {
+      value >>= 4;
+      bitno  += 4;
+    }
+
+  if ((value & 0x00000003) == 0)
+    {
+      value >>= 2;
+      bitno  += 2;
+    }
+
+  if ((value & 0x00000001) == 0)
+    {
+      bitno  += 1;
+    }
+
+  return bitno;
+#endif
+}
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
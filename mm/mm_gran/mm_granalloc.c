@@ -51,6 +51,197 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: gran_nextentry
+ *
+ * Description:
+ *   Use the GAT summary to find the first GAT entry at or after gatidx that
+ *   has at least one free granule.
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   gatidx - The GAT index where the search begins.
+ *
+ * Returned Value:
+ *   The GAT index of the entry or the number of GAT entries if there is no
+ *   such entry.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_nextentry(FAR struct gran_s *priv,
+                                   unsigned int gatidx)
+{
+  unsigned int ngat = SIZEOF_GAT(priv->ngranules);
+  unsigned int sumidx;
+  uint32_t     bits;
+
+  if (gatidx >= ngat)
+    {
+      return ngat;
+    }
+
+  sumidx = gatidx >> 5;
+  bits   = ~priv->gsum[sumidx] & (0xffffffff << (gatidx & 31));
+
+  while (bits == 0)
+    {
+      if (++sumidx >= SIZEOF_GSUM(priv->ngranules))
+        {
+          return ngat;
+        }
+
+      bits = ~priv->gsum[sumidx];
+    }
+
+  gatidx = (sumidx << 5) + gran_ctz(bits);
+  return gatidx < ngat ? gatidx : ngat;
+}
+
+/****************************************************************************
+ * Name: gran_nextfree
+ *
+ * Description:
+ *   Find the first free granule at or after granno.
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The granule number where the search begins.
+ *
+ * Returned Value:
+ *   The granule number of the free granule or the total number of granules
+ *   if there is no free granule.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_nextfree(FAR struct gran_s *priv,
+                                  unsigned int granno)
+{
+  unsigned int gatidx;
+  uint32_t     bits;
+
+  if (granno >= priv->ngranules)
+    {
+      return priv->ngranules;
+    }
+
+  /* The unused bits at the end of the last GAT entry are marked allocated
+   * so any free bit found lies within the heap.
+   */
+
+  gatidx = granno >> 5;
+  bits   = ~priv->gat[gatidx] & (0xffffffff << (granno & 31));
+
+  while (bits == 0)
+    {
+      /* Skip over all of the full GAT entries */
+
+      gatidx = gran_nextentry(priv, gatidx + 1);
+      if (gatidx >= SIZEOF_GAT(priv->ngranules))
+        {
+          return priv->ngranules;
+        }
+
+      bits = ~priv->gat[gatidx];
+    }
+
+  return (gatidx << 5) + gran_ctz(bits);
+}
+
+/****************************************************************************
+ * Name: gran_nextused
+ *
+ * Description:
+ *   Find the first allocated granule at or after granno, but before limit.
+ *
+ * Input Parameters:
+ *   priv   - The granule heap state structure.
+ *   granno - The granule number where the search begins.
+ *   limit  - The granule number where the search ends.  Must not be larger
+ *            than the total number of granules.
+ *
+ * Returned Value:
+ *   The granule number of the allocated granule or limit if all of the
+ *   granules are free.
+ *
+ ****************************************************************************/
+
+static unsigned int gran_nextused(FAR struct gran_s *priv,
+                                  unsigned int granno, unsigned int limit)
+{
+  unsigned int gatidx;
+  uint32_t     bits;
+
+  if (granno >= limit)
+    {
+      return limit;
+    }
+
+  gatidx = granno >> 5;
+  bits   = priv->gat[gatidx] & (0xffffffff << (granno & 31));
+
+  while (bits == 0)
+    {
+      if ((++gatidx << 5) >= limit)
+        {
+          return limit;
+        }
+
+      bits = priv->gat[gatidx];
+    }
+
+  granno = (gatidx << 5) + gran_ctz(bits);
+  return granno < limit ? granno : limit;
+}
+
+/****************************************************************************
+ * Name: gran_search
+ *
+ * Description:
+ *   Find ngranules contiguous free granules starting at a granule number
+ *   in the range start through end-1.
+ *
+ * Input Parameters:
+ *   priv      - The granule heap state structure.
+ *   start     - The first granule number to consider.
+ *   end       - The granule number after the last one to consider.
+ *   ngranules - The number of contiguous granules needed
+ *
+ * Returned Value:
+ *   The granule number of the first granule of the free run or -1 if there
+ *   is no such run.
+ *
+ ****************************************************************************/
+
+static int gran_search(FAR struct gran_s *priv, unsigned int start,
+                       unsigned int end, unsigned int ngranules)
+{
+  unsigned int granno = start;
+  unsigned int used;
+
+  for (; ; )
+    {
+      /* Find the beginning of the next free run */
+
+      granno = gran_nextfree(priv, granno);
+      if (granno >= end || granno + ngranules > priv->ngranules)
+        {
+          return -1;
+        }
+
+      /* Is the run long enough? */
+
+      used = gran_nextused(priv, granno, granno + ngranules);
+      if (used >= granno + ngranules)
+        {
+          return (int)granno;
+        }
+
+      /* No.. continue after the allocated granule that ended the run */
+
+      granno = used + 1;
+    }
+}
+
 /****************************************************************************
  * Name: gran_common_alloc
  *
@@ -68,178 +259,57 @@
 
 static inline FAR void *gran_common_alloc(FAR struct gran_s *priv, size_t size)
 {
-  unsigned int ngranules;
+  size_t       ngranules;
   size_t       tmpmask;
   uintptr_t    alloc;
-  uint32_t     curr;
-  uint32_t     next;
-  uint32_t     mask;
-  int          granidx;
-  int          gatidx;
-  int          bitidx;
-  int          shift;
+  unsigned int hint;
+  int          granno;
 
-  DEBUGASSERT(priv && size <= 32 * (1 << priv->log2gran));
+  DEBUGASSERT(priv);
 
   if (priv && size > 0)
     {
-      /* Get exclusive access to the GAT */
-
-      gran_enter_critical(priv);
-
       /* How many contiguous granules we we need to find? */
 
       tmpmask   = (1 << priv->log2gran) - 1;
       ngranules = (size + tmpmask) >> priv->log2gran;
 
-      /* Then create mask for that number of granules */
+      if (ngranules > priv->ngranules)
+        {
+          return NULL;
+        }
 
-      DEBUGASSERT(ngranules <= 32);
-      mask = 0xffffffff >> (32 - ngranules);
+      /* Get exclusive access to the GAT */
+
+      gran_enter_critical(priv);
 
-      /* Now search the granule allocation table for that number of contiguous */
+      /* Search from the end of the previous allocation to the end of the
+       * heap, then from the beginning of the heap (next fit).
+       */
 
-      alloc = priv->heapstart;
+      hint   = priv->hint;
+      granno = gran_search(priv, hint, priv->ngranules, ngranules);
+      if (granno < 0 && hint > 0)
+        {
+          granno = gran_search(priv, 0, hint, ngranules);
+        }
 
-      for (granidx = 0; granidx < priv->ngranules; granidx += 32)
+      if (granno >= 0)
         {
-          /* Get the GAT index associated with the granule table entry */
-
-          gatidx = granidx >> 5;
-          curr = priv->gat[gatidx];
-
-          /* Handle the case where there are no free granules in the entry */
-
-          if (curr == 0xffffffff)
-            {
-              alloc += (32 << priv->log2gran);
-              continue;
-            }
-
-          /* Get the next entry from the GAT to support a 64 bit shift */
-
-          if (granidx < priv->ngranules)
-            {
-              next = priv->gat[gatidx + 1];
-            }
-
-          /* Use all ones when are at the last entry in the GAT (meaning
-           * nothing can be allocated.
-           */
-
-          else
-            {
-              next = 0xffffffff;
-            }
-
-          /* Search through the allocations in the 'curr' GAT entry
-           * to see if we can satisfy the allocation starting in that
-           * entry.
-           *
-           * This loop continues until either all of the bits have been
-           * examined (bitidx >= 32), or until there are insufficient
-           * granules left to satisfy the allocation.
-           */
-
-          for (bitidx = 0;
-               bitidx < 32 && (granidx + bitidx + ngranules) <= priv->ngranules;
-              )
-            {
-              /* Break out if there are no further free bits in 'curr'.
-               * All of the zero bits might have gotten shifted out.
-               */
-
-              if (curr == 0xffffffff)
-                {
-                  break;
-                }
-
-              /* Check for the first zero bit in the lower or upper 16-bits.
-               * From the test above, we know that at least one of the 32-
-               * bits in 'curr' is zero.
-               */
-
-              else if ((curr & 0x0000ffff) == 0x0000ffff)
-                {
-                  /* Not in the lower 16 bits.  The first free bit must be
-                   * in the upper 16 bits.
-                   */
-
-                  shift = 16;
-                }
-
-              /* We know that the first free bit is now within the lower 16
-               * bits of 'curr'.  Is it in the upper or lower byte?
-               */
-
-              else if ((curr & 0x0000ff) == 0x000000ff)
-                {
-                  /* Not in the lower 8 bits.  The first free bit must be in
-                   * the upper 8 bits.
-                   */
-
-                  shift = 8;
-                }
-
-              /* We know that the first free bit is now within the lower 4
-               * bits of 'curr'.  Is it in the upper or lower nibble?
-               */
-
-              else if ((curr & 0x00000f) == 0x0000000f)
-                {
-                  /* Not in the lower 4 bits.  The first free bit must be in
-                   * the upper 4 bits.
-                   */
-
-                  shift = 4;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Is it in the upper or lower pair?
-               */
-
-              else if ((curr & 0x000003) == 0x00000003)
-                {
-                  /* Not in the lower 2 bits.  The first free bit must be in
-                   * the upper 2 bits.
-                   */
-
-                  shift = 2;
-                }
-
-              /* We know that the first free bit is now within the lower 4 bits
-               * of 'curr'.  Check if we have the allocation at this bit position.
-               */
-
-              else if ((curr & mask) == 0)
-                {
-                  /* Yes.. mark these granules allocated */
-
-                  gran_mark_allocated(priv, alloc, ngranules);
-
-                  /* And return the allocation address */
-
-                  gran_leave_critical(priv);
-                  return (FAR void *)alloc;
-                }
-
-              /* The free allocation does not start at this position */
-
-              else
-                {
-                  shift = 1;
-                }
-
-              /* Set up for the next time through the loop.  Perform a 64
-               * bit shift to move to the next gran position andi ncrement
-               * to the next candidate allocation address.
-               */
-
-              alloc  += (shift << priv->log2gran);
-              curr    = (curr >> shift) | (next << (32 - shift));
-              next  >>= shift;
-              bitidx += shift;
-            }
+          /* Mark these granules allocated */
+
+          alloc = priv->heapstart + ((uintptr_t)granno << priv->log2gran);
+          gran_mark_allocated(priv, alloc, ngranules);
+
+          /* The next search will begin after this allocation */
+
+          hint = granno + ngranules;
+          priv->hint = hint < priv->ngranules ? hint : 0;
+
+          /* And return the allocation address */
+
+          gran_leave_critical(priv);
+          return (FAR void *)alloc;
         }
 
       gran_leave_critical(priv);
@@ -258,9 +328,8 @@ static inline FAR void *gran_common_alloc(FAR struct gran_s *priv, size_t size)
  * Description:
  *   Allocate memory from the granule heap.
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
+ *   The search starts after the previous allocation (next fit) and skips
+ *   over fully allocated words of the granule allocation table.
  *
  * Input Parameters:
  *   handle - The handle previously returned by gran_initialize
@@ -131,6 +131,18 @@ gran_common_initialize(FAR void *heapstart, size_t heapsize, uint8_t log2gran,
       priv->log2gran  = log2gran;
       priv->ngranules = ngranules;
       priv->heapstart = alignedstart;
+      priv->gsum      = &priv->gat[SIZEOF_GAT(ngranules)];
+
+      /* Mark the unused bits at the end of the last GAT entry as allocated
+       * so that they will never be found by the search for free granules.
+       */
+
+      if ((ngranules & 31) != 0)
+        {
+          gran_mark_allocated(priv,
+                              alignedstart + (ngranules << log2gran),
+                              32 - (ngranules & 31));
+        }
 
       /* Initialize mutual exclusion support */
 
@@ -178,10 +190,6 @@ gran_common_initialize(FAR void *heapstart, size_t heapsize, uint8_t log2gran,
  *   The actual memory allocates will be 64 byte (wasting 17 bytes) and
  *   will be aligned at least to (1 << log2align).
  *
- *   NOTE: The current implementation also restricts the maximum allocation
- *   size to 32 granules.  That restriction could be eliminated with some
- *   additional coding effort.
- *
  * Input Parameters:
  *   heapstart - Start of the granule allocation heap
  *   heapsize  - Size of heap in bytes
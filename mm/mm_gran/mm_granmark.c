@@ -85,39 +85,38 @@ void gran_mark_allocated(FAR struct gran_s *priv, uintptr_t alloc,
   gatidx = granno >> 5;
   gatbit = granno & 31;
 
-  /* Mark bits in the GAT entry or entries */
+  /* Mark bits in the GAT entry or entries.  The first and last entries
+   * may be partially marked; all of the entries in between are marked
+   * completely.
+   */
 
-  avail = 32 - gatbit;
-  if (ngranules > avail)
+  while (ngranules > 0)
     {
-      /* Mark bits in the first GAT entry */
+      avail = 32 - gatbit;
+      if (ngranules >= avail)
+        {
+          gatmask    = 0xffffffff << gatbit;
+          ngranules -= avail;
+        }
+      else
+        {
+          gatmask    = 0xffffffff >> (32 - ngranules);
+          gatmask  <<= gatbit;
+          ngranules  = 0;
+        }
 
-      gatmask = 0xffffffff << gatbit;
       DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
-
       priv->gat[gatidx] |= gatmask;
-      ngranules -= avail;
-
-      /* Mark bits in the second GAT entry */
 
-      gatmask = 0xffffffff >> (32 - ngranules);
-      DEBUGASSERT((priv->gat[gatidx+1] & gatmask) == 0);
+      /* Update the summary if the GAT entry is now full */
 
-      priv->gat[gatidx+1] |= gatmask;
-    }
+      if (priv->gat[gatidx] == 0xffffffff)
+        {
+          GRAN_SUMSET(priv, gatidx);
+        }
 
-  /* Handle the case where where all of the granules come from one entry */
-
-  else
-    {
-      /* Mark bits in a single GAT entry */
-
-      gatmask   = 0xffffffff >> (32 - ngranules);
-      gatmask <<= gatbit;
-      DEBUGASSERT((priv->gat[gatidx] & gatmask) == 0);
-
-      priv->gat[gatidx] |= gatmask;
-      return;
+      gatidx++;
+      gatbit = 0;
     }
 }
 
@@ -63,11 +63,25 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 
   int ndx = mm_size2ndx(node->size);
 
+#ifdef CONFIG_MM_TLSF
+  /* Every node in a second-level list is large enough to satisfy any
+   * allocation that selects the list.  There is no need to keep this list
+   * ordered:  Just put the new node at the head of its list and mark the
+   * list as non-empty.
+   */
+
+  prev = &heap->mm_nodelist[ndx];
+  next = prev->flink;
+
+  heap->mm_flbitmap                    |= (1 << (ndx >> MM_SLSHIFT));
+  heap->mm_slbitmap[ndx >> MM_SLSHIFT] |= (1 << (ndx & (MM_NSUBLISTS - 1)));
+#else
   /* Now put the new node int the next */
 
   for (prev = &heap->mm_nodelist[ndx], next = heap->mm_nodelist[ndx].flink;
        next && next->size && next->size < node->size;
        prev = next, next = next->flink);
+#endif
 
   /* Does it go in mid next or at the end? */
 
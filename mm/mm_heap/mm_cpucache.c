@@ -0,0 +1,335 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cpucache.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_CPUCACHE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_ndx
+ *
+ * Description:
+ *   Return the index of the largest cache whose chunk size does not exceed
+ *   'chunksize'.  Any chunk in that cache is then at least that large.
+ *
+ ****************************************************************************/
+
+static inline int mm_cache_ndx(size_t chunksize)
+{
+  int ndx = 0;
+
+  chunksize >>= MM_MIN_SHIFT;
+  while (chunksize > 1)
+    {
+      ndx++;
+      chunksize >>= 1;
+    }
+
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: mm_cache_release
+ *
+ * Description:
+ *   Return a batch of chunks to the heap.  The heap semaphore is taken only
+ *   once for the whole batch.
+ *
+ ****************************************************************************/
+
+static void mm_cache_release(FAR struct mm_heap_s *heap, FAR void **batch,
+                             int count)
+{
+  mm_takesemaphore(heap);
+  while (count > 0)
+    {
+      mm_heapfree(heap, batch[--count]);
+    }
+
+  mm_givesemaphore(heap);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cpucache_alloc
+ *
+ * Description:
+ *   Attempt to satisfy a small allocation from the cache of the current
+ *   CPU.  If the cache is empty, it is refilled with a batch of chunks
+ *   from the heap.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *   size - The requested allocation size (not including the header)
+ *
+ * Returned Value:
+ *   The allocated memory or NULL if the request cannot be satisfied from
+ *   the cache.  In that case, the caller should fall back to the
+ *   heap.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cpucache_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_allocnode_s *node;
+  FAR void *batch[MM_CACHE_BATCH];
+  FAR void *ret;
+  irqstate_t flags;
+  size_t chunksize;
+  int count;
+  int ndx;
+
+  /* Is this a small allocation? */
+
+  chunksize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  if (size < 1 || chunksize > MM_CACHE_MAXCHUNK)
+    {
+      return NULL;
+    }
+
+  /* Get the smallest cache whose chunks are large enough */
+
+  ndx = mm_cache_ndx(chunksize);
+  if ((MM_MIN_CHUNK << ndx) < chunksize)
+    {
+      ndx++;
+    }
+
+  /* Disabling local interrupts is sufficient to keep us on this CPU and
+   * to protect its cache.
+   */
+
+  flags = up_irq_save();
+  cache = &heap->mm_cpucache[up_cpu_index()];
+
+  if (cache->mc_count[ndx] > 0)
+    {
+      ret  = cache->mc_mem[ndx][--cache->mc_count[ndx]];
+      node = (FAR struct mm_allocnode_s *)((FAR char *)ret - SIZEOF_MM_ALLOCNODE);
+      cache->mc_cached -= node->size;
+
+      up_irq_restore(flags);
+      mm_trace_alloc(heap, node);
+      return ret;
+    }
+
+  up_irq_restore(flags);
+
+  /* The cache is empty.  Refill it with a batch of chunks from the heap. */
+
+  chunksize = MM_MIN_CHUNK << ndx;
+
+  mm_takesemaphore(heap);
+  for (count = 0; count < MM_CACHE_BATCH; count++)
+    {
+      batch[count] = mm_heapmalloc(heap, chunksize - SIZEOF_MM_ALLOCNODE);
+      if (batch[count] == NULL)
+        {
+          break;
+        }
+
+      /* Chunks in the cache are not owned by any thread */
+
+      node = (FAR struct mm_allocnode_s *)
+        ((FAR char *)batch[count] - SIZEOF_MM_ALLOCNODE);
+      mm_trace_free(heap, node);
+    }
+
+  if (count < 1)
+    {
+      mm_givesemaphore(heap);
+      return NULL;
+    }
+
+  /* Keep one for the caller and put the rest into the cache of the CPU
+   * that we are running on now.
+   */
+
+  ret = batch[--count];
+  mm_trace_alloc(heap, (FAR struct mm_allocnode_s *)
+                 ((FAR char *)ret - SIZEOF_MM_ALLOCNODE));
+  mm_givesemaphore(heap);
+
+  flags = up_irq_save();
+  cache = &heap->mm_cpucache[up_cpu_index()];
+
+  while (count > 0 && cache->mc_count[ndx] < CONFIG_MM_CPUCACHE_DEPTH)
+    {
+      FAR void *mem = batch[--count];
+
+      node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+      cache->mc_mem[ndx][cache->mc_count[ndx]++] = mem;
+      cache->mc_cached += node->size;
+    }
+
+  up_irq_restore(flags);
+
+  /* There will only be left-over chunks if the cache was refilled on
+   * this CPU while we were refilling it.
+   */
+
+  if (count > 0)
+    {
+      mm_cache_release(heap, batch, count);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_free
+ *
+ * Description:
+ *   Attempt to free a small chunk into the cache of the current CPU.  If
+ *   the cache is full, then a batch of chunks is drained from the cache
+ *   back into the heap.
+ *
+ * Input Parameters:
+ *   heap - The selected heap
+ *   mem  - The memory to be freed
+ *
+ * Returned Value:
+ *   True if the memory was freed;  false if it is not a small chunk and
+ *   must be returned directly to the heap.
+ *
+ ****************************************************************************/
+
+bool mm_cpucache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_cpucache_s *cache;
+  FAR struct mm_allocnode_s *node;
+  FAR void *batch[MM_CACHE_BATCH];
+  irqstate_t flags;
+  int count = 0;
+  int ndx;
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT((node->preceding & MM_ALLOC_BIT) != 0);
+
+  if (node->size > MM_CACHE_MAXCHUNK)
+    {
+      return false;
+    }
+
+  /* Chunks in the cache are not owned by any thread */
+
+  mm_trace_free(heap, node);
+
+  ndx   = mm_cache_ndx(node->size);
+  flags = up_irq_save();
+  cache = &heap->mm_cpucache[up_cpu_index()];
+
+  /* If the cache is full, remove a batch of the oldest chunks to make
+   * space.
+   */
+
+  if (cache->mc_count[ndx] >= CONFIG_MM_CPUCACHE_DEPTH)
+    {
+      FAR struct mm_allocnode_s *tmp;
+      int i;
+
+      for (count = 0; count < MM_CACHE_BATCH; count++)
+        {
+          batch[count] = cache->mc_mem[ndx][count];
+          tmp = (FAR struct mm_allocnode_s *)
+            ((FAR char *)batch[count] - SIZEOF_MM_ALLOCNODE);
+          cache->mc_cached -= tmp->size;
+        }
+
+      for (i = count; i < CONFIG_MM_CPUCACHE_DEPTH; i++)
+        {
+          cache->mc_mem[ndx][i - count] = cache->mc_mem[ndx][i];
+        }
+
+      cache->mc_count[ndx] -= count;
+    }
+
+  cache->mc_mem[ndx][cache->mc_count[ndx]++] = mem;
+  cache->mc_cached += node->size;
+  up_irq_restore(flags);
+
+  if (count > 0)
+    {
+      mm_cache_release(heap, batch, count);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cpucache_size
+ *
+ * Description:
+ *   Return the total size of all chunks held in the per-CPU caches.  These
+ *   chunks are marked as allocated in the heap but are really free.
+ *
+ ****************************************************************************/
+
+size_t mm_cpucache_size(FAR struct mm_heap_s *heap)
+{
+  irqstate_t flags;
+  size_t cached = 0;
+  int cpu;
+
+  flags = enter_critical_section();
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cached += heap->mm_cpucache[cpu].mc_cached;
+    }
+
+  leave_critical_section(flags);
+  return cached;
+}
+
+#endif /* CONFIG_MM_CPUCACHE */
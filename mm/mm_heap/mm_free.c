@@ -49,15 +49,22 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_free
+ * Name: mm_free (or mm_heapfree)
  *
  * Description:
  *   Returns a chunk of memory to the list of free nodes,  merging with
  *   adjacent free chunks if possible.
  *
+ *   If CONFIG_MM_CPUCACHE is selected, this is mm_heapfree() which always
+ *   returns the chunk to the heap, bypassing the per-CPU caches.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_CPUCACHE
+void mm_heapfree(FAR struct mm_heap_s *heap, FAR void *mem)
+#else
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+#endif
 {
   FAR struct mm_freenode_s *node;
   FAR struct mm_freenode_s *prev;
@@ -81,6 +88,7 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   /* Map the memory chunk into a free node */
 
   node = (FAR struct mm_freenode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  mm_trace_free(heap, (FAR struct mm_allocnode_s *)node);
   node->preceding &= ~MM_ALLOC_BIT;
 
   /* Check if the following node is free and, if so, merge it */
@@ -101,12 +109,7 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
        * but there may not be a successor node.
        */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_remfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -126,12 +129,7 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
        * not be a successor node.
        */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_remfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -145,3 +143,24 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   mm_addfreechunk(heap, node);
   mm_givesemaphore(heap);
 }
+
+/****************************************************************************
+ * Name: mm_free
+ *
+ * Description:
+ *   Free small chunks into the cache of the current CPU, if possible.
+ *   Otherwise, return the chunk to the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_CPUCACHE
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  /* Protect against attempts to free a NULL reference */
+
+  if (mem != NULL && !mm_cpucache_free(heap, mem))
+    {
+      mm_heapfree(heap, mem);
+    }
+}
+#endif
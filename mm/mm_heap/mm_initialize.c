@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -122,6 +123,8 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   heap->mm_heapend[IDX]->size        = SIZEOF_MM_ALLOCNODE;
   heap->mm_heapend[IDX]->preceding   = node->size | MM_ALLOC_BIT;
 
+  heap->mm_heapattr[IDX]             = 0;
+
 #undef IDX
 
 #if CONFIG_MM_REGIONS > 1
@@ -133,6 +136,47 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   mm_addfreechunk(heap, node);
 }
 
+/****************************************************************************
+ * Name: mm_regionattr
+ *
+ * Description:
+ *   Set the attributes of the heap region that contains the memory 'mem'.
+ *   This is normally called by board logic after the region has been added
+ *   to the heap.
+ *
+ * Parameters:
+ *   heap - The selected heap
+ *   mem  - Any address within the region, such as its start address
+ *   attr - The region attributes (MM_REGION_* bits)
+ *
+ * Return Value:
+ *   Zero on success; -ENOENT if no region of the heap contains 'mem'.
+ *
+ ****************************************************************************/
+
+int mm_regionattr(FAR struct mm_heap_s *heap, FAR void *mem, uint8_t attr)
+{
+  int region;
+#if CONFIG_MM_REGIONS > 1
+  int nregions = heap->mm_nregions;
+#else
+# define nregions 1
+#endif
+
+  for (region = 0; region < nregions; region++)
+    {
+      if ((uintptr_t)mem >= (uintptr_t)heap->mm_heapstart[region] &&
+          (uintptr_t)mem < (uintptr_t)heap->mm_heapend[region])
+        {
+          heap->mm_heapattr[region] = attr;
+          return OK;
+        }
+    }
+
+#undef nregions
+  return -ENOENT;
+}
+
 /****************************************************************************
  * Name: mm_initialize
  *
@@ -155,7 +199,9 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
                    size_t heapsize)
 {
+#ifndef CONFIG_MM_TLSF
   int i;
+#endif
 
   minfo("Heap: start=%p size=%u\n", heapstart, heapsize);
 
@@ -179,12 +225,28 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   /* Initialize the node array */
 
-  memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
+  memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NLISTS);
+
+#ifdef CONFIG_MM_TLSF
+  /* Each second-level free list is a separate, NULL-terminated list and
+   * all lists are initially empty.
+   */
+
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+#else
   for (i = 1; i < MM_NNODES; i++)
     {
       heap->mm_nodelist[i-1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink   = &heap->mm_nodelist[i-1];
     }
+#endif
+
+#ifdef CONFIG_MM_CPUCACHE
+  /* All per-CPU small object caches are initially empty */
+
+  memset(heap->mm_cpucache, 0, sizeof(heap->mm_cpucache));
+#endif
 
   /* Initialize the malloc semaphore to one (to support one-at-
    * a-time access to private data sets).
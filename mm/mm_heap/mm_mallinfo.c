@@ -64,6 +64,9 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
   int    ordblks  = 0;  /* Number of non-inuse chunks */
   size_t uordblks = 0;  /* Total allocated space */
   size_t fordblks = 0;  /* Total non-inuse space */
+#ifdef CONFIG_MM_CPUCACHE
+  size_t cached;        /* Total space held in the per-CPU caches */
+#endif
 #if CONFIG_MM_REGIONS > 1
   int region;
 #else
@@ -119,6 +122,16 @@ int mm_mallinfo(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
 
   DEBUGASSERT(uordblks + fordblks == heap->mm_heapsize);
 
+#ifdef CONFIG_MM_CPUCACHE
+  /* Chunks held in the per-CPU caches appear to be allocated but are
+   * really available.
+   */
+
+  cached    = mm_cpucache_size(heap);
+  uordblks -= cached;
+  fordblks += cached;
+#endif
+
   info->arena    = heap->mm_heapsize;
   info->ordblks  = ordblks;
   info->mxordblk = mxordblk;
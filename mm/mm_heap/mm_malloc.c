@@ -39,6 +39,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -52,12 +53,197 @@
 #  define NULL ((void *)0)
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_ffs
+ *
+ * Description:
+ *   Return the (zero-based) index of the least significant bit set in a
+ *   non-zero value using a fixed number of steps.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TLSF
+static inline int mm_ffs(uint32_t value)
+{
+  int bit = 0;
+
+  if ((value & 0x0000ffff) == 0)
+    {
+      value >>= 16;
+      bit    += 16;
+    }
+
+  if ((value & 0x000000ff) == 0)
+    {
+      value >>= 8;
+      bit    += 8;
+    }
+
+  if ((value & 0x0000000f) == 0)
+    {
+      value >>= 4;
+      bit    += 4;
+    }
+
+  if ((value & 0x00000003) == 0)
+    {
+      value >>= 2;
+      bit    += 2;
+    }
+
+  if ((value & 0x00000001) == 0)
+    {
+      bit    += 1;
+    }
+
+  return bit;
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_findlist
+ *
+ * Description:
+ *   Use the first- and second-level bitmaps to find the first non-empty
+ *   free list at or above the list 'ndx'.  Returns -1 if there is no such
+ *   list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TLSF
+static inline int mm_findlist(FAR struct mm_heap_s *heap, int ndx)
+{
+  uint32_t bitmap;
+  int fl = ndx >> MM_SLSHIFT;
+  int sl = ndx & (MM_NSUBLISTS - 1);
+
+  /* Is there a non-empty list in the same first-level size class? */
+
+  bitmap = heap->mm_slbitmap[fl] & (0xffffffff << sl);
+  if (bitmap == 0)
+    {
+      /* No.. then find the next larger, non-empty first-level class */
+
+      bitmap = heap->mm_flbitmap & (0xffffffff << (fl + 1));
+      if (bitmap == 0)
+        {
+          return -1;
+        }
+
+      fl     = mm_ffs(bitmap);
+      bitmap = heap->mm_slbitmap[fl];
+    }
+
+  return (fl << MM_SLSHIFT) + mm_ffs(bitmap);
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_takechunk
+ *
+ * Description:
+ *   Allocate 'size' bytes from the free chunk 'node', returning the
+ *   remainder (if any) to the free lists.
+ *
+ * Assumptions:
+ *   The caller holds the MM semaphore.
+ *
+ ****************************************************************************/
+
+static FAR void *mm_takechunk(FAR struct mm_heap_s *heap,
+                              FAR struct mm_freenode_s *node, size_t size)
+{
+  FAR struct mm_freenode_s *remainder;
+  FAR struct mm_freenode_s *next;
+  size_t remaining;
+
+  /* Remove the node.  There must be a predecessor, but there may not be
+   * a successor node.
+   */
+
+  mm_remfreechunk(heap, node);
+
+  /* Check if we have to split the free node into one of the allocated
+   * size and another smaller freenode.  In some cases, the remaining
+   * bytes can be smaller (they may be SIZEOF_MM_ALLOCNODE).  In that
+   * case, we will just carry the few wasted bytes at the end of the
+   * allocation.
+   */
+
+  remaining = node->size - size;
+  if (remaining >= SIZEOF_MM_FREENODE)
+    {
+      /* Get a pointer to the next node in physical memory */
+
+      next = (FAR struct mm_freenode_s *)(((FAR char *)node) + node->size);
+
+      /* Create the remainder node */
+
+      remainder = (FAR struct mm_freenode_s *)(((FAR char *)node) + size);
+      remainder->size = remaining;
+      remainder->preceding = size;
+
+      /* Adjust the size of the node under consideration */
+
+      node->size = size;
+
+      /* Adjust the 'preceding' size of the (old) next node, preserving
+       * the allocated flag.
+       */
+
+      next->preceding = remaining | (next->preceding & MM_ALLOC_BIT);
+
+      /* Add the remainder back into the nodelist */
+
+      mm_addfreechunk(heap, remainder);
+    }
+
+  /* Handle the case of an exact size match */
+
+  node->preceding |= MM_ALLOC_BIT;
+  mm_trace_alloc(heap, (FAR struct mm_allocnode_s *)node);
+  return (FAR void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Name: mm_nodeattr
+ *
+ * Description:
+ *   Return the attributes of the region that contains a free chunk.
+ *
+ ****************************************************************************/
+
+static uint8_t mm_nodeattr(FAR struct mm_heap_s *heap,
+                           FAR struct mm_freenode_s *node)
+{
+#if CONFIG_MM_REGIONS > 1
+  int region;
+
+  for (region = 0; region < heap->mm_nregions; region++)
+    {
+      if ((uintptr_t)node >= (uintptr_t)heap->mm_heapstart[region] &&
+          (uintptr_t)node < (uintptr_t)heap->mm_heapend[region])
+        {
+          return heap->mm_heapattr[region];
+        }
+    }
+
+  return 0;
+#else
+  return heap->mm_heapattr[0];
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_malloc (or mm_heapmalloc)
  *
  * Description:
  *  Find the smallest chunk that satisfies the request. Take the memory from
@@ -65,9 +251,16 @@
  *
  *  8-byte alignment of the allocated data is assured.
  *
+ *  If CONFIG_MM_CPUCACHE is selected, this is mm_heapmalloc() which
+ *  always allocates from the heap, bypassing the per-CPU caches.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_CPUCACHE
+FAR void *mm_heapmalloc(FAR struct mm_heap_s *heap, size_t size)
+#else
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+#endif
 {
   FAR struct mm_freenode_s *node;
   void *ret = NULL;
@@ -90,6 +283,35 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   mm_takesemaphore(heap);
 
+#ifdef CONFIG_MM_TLSF
+  /* Find the first non-empty free list whose size class is guaranteed to
+   * satisfy the request.  Any chunk in that list will do.  The only
+   * exception is the last list which holds all really big chunks.
+   */
+
+  node = NULL;
+  ndx  = mm_findlist(heap, mm_size2searchndx(size));
+  if (ndx >= 0)
+    {
+      for (node = heap->mm_nodelist[ndx].flink;
+           node && node->size < size;
+           node = node->flink);
+    }
+
+  /* If there is no such list, there may still be a large enough chunk in
+   * the list for the size class that contains the request.  Search that
+   * list only as a last resort before failing the allocation.
+   */
+
+  if (node == NULL)
+    {
+      ndx = mm_size2ndx(size);
+      for (node = heap->mm_nodelist[ndx].flink;
+           node && node->size < size;
+           node = node->flink);
+    }
+
+#else
   /* Get the location in the node list to start the search. Special case
    * really big allocations
    */
@@ -113,6 +335,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   for (node = heap->mm_nodelist[ndx].flink;
        node && node->size < size;
        node = node->flink);
+#endif
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
@@ -121,78 +344,123 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   if (node)
     {
-      FAR struct mm_freenode_s *remainder;
-      FAR struct mm_freenode_s *next;
-      size_t remaining;
+      ret = mm_takechunk(heap, node, size);
+    }
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+  mm_givesemaphore(heap);
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+  /* If CONFIG_DEBUG_MM is defined, then output the result of the allocation
+   * to the SYSLOG.
+   */
 
-      /* Check if we have to split the free node into one of the allocated
-       * size and another smaller freenode.  In some cases, the remaining
-       * bytes can be smaller (they may be SIZEOF_MM_ALLOCNODE).  In that
-       * case, we will just carry the few wasted bytes at the end of the
-       * allocation.
-       */
+#ifdef CONFIG_DEBUG_MM
+  if (!ret)
+    {
+      mwarn("WARNING: Allocation failed, size %d\n", size);
+    }
+  else
+    {
+      minfo("Allocated %p, size %d\n", ret, size);
+    }
+#endif
 
-      remaining = node->size - size;
-      if (remaining >= SIZEOF_MM_FREENODE)
-        {
-          /* Get a pointer to the next node in physical memory */
+  return ret;
+}
 
-          next = (FAR struct mm_freenode_s *)(((FAR char *)node) + node->size);
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Allocate small chunks from the cache of the current CPU, if possible.
+ *  Otherwise, allocate from the heap.
+ *
+ ****************************************************************************/
 
-          /* Create the remainder node */
+#ifdef CONFIG_MM_CPUCACHE
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR void *ret;
 
-          remainder = (FAR struct mm_freenode_s *)(((FAR char *)node) + size);
-          remainder->size = remaining;
-          remainder->preceding = size;
+  ret = mm_cpucache_alloc(heap, size);
+  if (ret == NULL)
+    {
+      ret = mm_heapmalloc(heap, size);
+    }
 
-          /* Adjust the size of the node under consideration */
+  return ret;
+}
+#endif
 
-          node->size = size;
+/****************************************************************************
+ * Name: mm_malloc_attr
+ *
+ * Description:
+ *  Allocate memory from a heap region that has (at least) all of the
+ *  attributes in 'attr'.  This is like mm_malloc() but the search also
+ *  skips the free chunks of regions that do not have those attributes.
+ *  NULL is returned if no such region has a large enough free chunk;  the
+ *  caller may then fall back to mm_malloc().  An 'attr' of zero accepts
+ *  any region.
+ *
+ *  The small object caches of CONFIG_MM_CPUCACHE are always bypassed.
+ *
+ ****************************************************************************/
 
-          /* Adjust the 'preceding' size of the (old) next node, preserving
-           * the allocated flag.
-           */
+FAR void *mm_malloc_attr(FAR struct mm_heap_s *heap, size_t size,
+                         uint8_t attr)
+{
+  FAR struct mm_freenode_s *node;
+  FAR void *ret = NULL;
+  int ndx;
 
-          next->preceding = remaining | (next->preceding & MM_ALLOC_BIT);
+  if (size < 1)
+    {
+      return NULL;
+    }
 
-          /* Add the remainder back into the nodelist */
+  size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
 
-          mm_addfreechunk(heap, remainder);
-        }
+  mm_takesemaphore(heap);
 
-      /* Handle the case of an exact size match */
+#ifdef CONFIG_MM_TLSF
+  /* Visit the non-empty free lists starting with the size class that
+   * contains the request.  The lists are not ordered, so each list must be
+   * searched completely.
+   */
 
-      node->preceding |= MM_ALLOC_BIT;
-      ret = (void *)((FAR char *)node + SIZEOF_MM_ALLOCNODE);
-    }
+  node = NULL;
+  ndx  = mm_findlist(heap, mm_size2ndx(size));
+  while (ndx >= 0)
+    {
+      for (node = heap->mm_nodelist[ndx].flink;
+           node && (node->size < size ||
+                    (mm_nodeattr(heap, node) & attr) != attr);
+           node = node->flink);
 
-  mm_givesemaphore(heap);
+      if (node != NULL || ++ndx >= MM_NLISTS)
+        {
+          break;
+        }
 
-  /* If CONFIG_DEBUG_MM is defined, then output the result of the allocation
-   * to the SYSLOG.
+      ndx = mm_findlist(heap, ndx);
+    }
+#else
+  /* The free list is ordered by size, so the first acceptable chunk is the
+   * best fitting one in a region with the requested attributes.
    */
 
-#ifdef CONFIG_DEBUG_MM
-  if (!ret)
-    {
-      mwarn("WARNING: Allocation failed, size %d\n", size);
-    }
-  else
+  ndx = size >= MM_MAX_CHUNK ? MM_NNODES - 1 : mm_size2ndx(size);
+  for (node = heap->mm_nodelist[ndx].flink;
+       node && (node->size < size ||
+                (mm_nodeattr(heap, node) & attr) != attr);
+       node = node->flink);
+#endif
+
+  if (node)
     {
-      minfo("Allocated %p, size %d\n", ret, size);
+      ret = mm_takechunk(heap, node, size);
     }
-#endif
 
+  mm_givesemaphore(heap);
   return ret;
 }
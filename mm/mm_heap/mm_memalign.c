@@ -112,6 +112,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
    */
 
   node = (FAR struct mm_allocnode_s *)(rawchunk - SIZEOF_MM_ALLOCNODE);
+  mm_trace_free(heap, node);
 
   /* Find the aligned subregion */
 
@@ -201,6 +202,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       mm_shrinkchunk(heap, node, size + SIZEOF_MM_ALLOCNODE);
     }
 
+  mm_trace_alloc(heap, node);
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
@@ -124,7 +124,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
       if (size < oldsize)
         {
+          mm_trace_free(heap, oldnode);
           mm_shrinkchunk(heap, oldnode, size);
+          mm_trace_alloc(heap, oldnode);
         }
 
       /* Then return the original address */
@@ -158,6 +160,10 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev = 0;
       size_t takenext = 0;
 
+      /* The chunk will be re-tagged when it has been extended */
+
+      mm_trace_free(heap, oldnode);
+
       /* Check if we can extend into the previous chunk and if the
        * previous chunk is smaller than the next chunk.
        */
@@ -223,12 +229,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
            * there may not be a successor node.
            */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_remfreechunk(heap, prev);
 
           /* Extend the node into the previous free chunk */
 
@@ -290,12 +291,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
            * may not be a successor node.
            */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_remfreechunk(heap, next);
 
           /* Extend the node into the next chunk */
 
@@ -326,6 +322,7 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
             }
         }
 
+      mm_trace_alloc(heap, oldnode);
       mm_givesemaphore(heap);
       return newmem;
     }
@@ -43,6 +43,7 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/mm.h>
 
 /****************************************************************************
@@ -89,6 +90,13 @@ void mm_seminitialize(FAR struct mm_heap_s *heap)
 
   (void)sem_init(&heap->mm_semaphore, 0, 1);
 
+  /* Collect contention statistics, but only for heaps in the kernel */
+
+#if defined(CONFIG_SCHED_LOCKSTAT) && \
+   (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+  (void)sem_setname(&heap->mm_semaphore, "mm_heap");
+#endif
+
   heap->mm_holder      = -1;
   heap->mm_counts_held = 0;
 }
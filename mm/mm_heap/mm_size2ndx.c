@@ -39,8 +39,62 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 #include <nuttx/mm/mm.h>
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_fls
+ *
+ * Description:
+ *   Return the (zero-based) index of the most significant bit set in a
+ *   non-zero value.  This is done with a fixed number of steps so that the
+ *   cost of the conversion does not depend on the size.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TLSF
+static inline int mm_fls(uint32_t value)
+{
+  int bit = 0;
+
+  if ((value & 0xffff0000) != 0)
+    {
+      value >>= 16;
+      bit    += 16;
+    }
+
+  if ((value & 0x0000ff00) != 0)
+    {
+      value >>= 8;
+      bit    += 8;
+    }
+
+  if ((value & 0x000000f0) != 0)
+    {
+      value >>= 4;
+      bit    += 4;
+    }
+
+  if ((value & 0x0000000c) != 0)
+    {
+      value >>= 2;
+      bit    += 2;
+    }
+
+  if ((value & 0x00000002) != 0)
+    {
+      bit    += 1;
+    }
+
+  return bit;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,8 +105,55 @@
  * Description:
  *    Convert the size to a nodelist index.
  *
+ *    If CONFIG_MM_TLSF is selected, the returned index selects one of the
+ *    second-level free lists:  Index (fl << MM_SLSHIFT) + sl where fl is
+ *    the power-of-two size class and sl is the linear subdivision of that
+ *    class which contains the size.  Every chunk in that list has a size
+ *    greater than or equal to the lower bound of the sub-class.
+ *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_TLSF
+int mm_size2ndx(size_t size)
+{
+  uint32_t units;
+  int fl;
+  int sl;
+
+  if (size >= MM_MAX_CHUNK)
+    {
+       return MM_NLISTS - 1;
+    }
+
+  /* Get the size in units of the minimum chunk size.  Sizes are always
+   * aligned to MM_MIN_CHUNK so there is no loss of information.
+   */
+
+  units = (uint32_t)(size >> MM_MIN_SHIFT);
+  if (units == 0)
+    {
+      return 0;
+    }
+
+  /* The first-level index is the power-of-two size class.  The second-
+   * level index is given by the MM_SLSHIFT bits below the most significant
+   * bit.  For the smallest size classes, there are fewer possible sizes
+   * than second-level lists and each list then holds a single size.
+   */
+
+  fl = mm_fls(units);
+  if (fl >= MM_SLSHIFT)
+    {
+      sl = (int)(units >> (fl - MM_SLSHIFT)) & (MM_NSUBLISTS - 1);
+    }
+  else
+    {
+      sl = (int)(units << (MM_SLSHIFT - fl)) & (MM_NSUBLISTS - 1);
+    }
+
+  return (fl << MM_SLSHIFT) + sl;
+}
+#else
 int mm_size2ndx(size_t size)
 {
   int ndx = 0;
@@ -71,3 +172,38 @@ int mm_size2ndx(size_t size)
 
   return ndx;
 }
+#endif
+
+/****************************************************************************
+ * Name: mm_size2searchndx
+ *
+ * Description:
+ *    Convert an allocation size to the index of the first free list that
+ *    is guaranteed to contain only chunks of at least that size.  This
+ *    differs from mm_size2ndx() in that the size is rounded up to the next
+ *    second-level size class boundary.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_TLSF
+int mm_size2searchndx(size_t size)
+{
+  uint32_t units;
+  int fl;
+
+  if (size < MM_MAX_CHUNK)
+    {
+      units = (uint32_t)(size >> MM_MIN_SHIFT);
+      if (units > 0)
+        {
+          fl = mm_fls(units);
+          if (fl > MM_SLSHIFT)
+            {
+              size += ((size_t)1 << (fl - MM_SLSHIFT + MM_MIN_SHIFT)) - 1;
+            }
+        }
+    }
+
+  return mm_size2ndx(size);
+}
+#endif
@@ -0,0 +1,132 @@
+/****************************************************************************
+ * mm/mm_heap/mm_trace.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TRACE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_trace_alloc
+ *
+ * Description:
+ *   Tag a newly allocated chunk with the ID of the allocating thread and
+ *   the next allocation sequence number.  The size of the chunk is added
+ *   to the heap usage of that thread.
+ *
+ * Assumptions:
+ *   The caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_trace_alloc(FAR struct mm_heap_s *heap,
+                    FAR struct mm_allocnode_s *node)
+{
+  FAR struct tcb_s *tcb = sched_self();
+
+  node->seqno = heap->mm_seqno++;
+
+  /* There is no TCB during the earliest phases of initialization */
+
+  if (tcb == NULL)
+    {
+      node->pid = -1;
+      return;
+    }
+
+  node->pid          = tcb->pid;
+  tcb->heap_live    += node->size;
+  tcb->heap_nallocs++;
+
+  if (tcb->heap_live > tcb->heap_peak)
+    {
+      tcb->heap_peak = tcb->heap_live;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_trace_free
+ *
+ * Description:
+ *   Remove the size of an allocated chunk from the heap usage of the
+ *   thread that allocated it (if that thread still exists).  The chunk is
+ *   then no longer owned by any thread.
+ *
+ * Assumptions:
+ *   The caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_trace_free(FAR struct mm_heap_s *heap,
+                   FAR struct mm_allocnode_s *node)
+{
+  FAR struct tcb_s *tcb;
+
+  if (node->pid < 0)
+    {
+      return;
+    }
+
+  tcb = sched_gettcb(node->pid);
+  if (tcb != NULL)
+    {
+      /* The thread ID may have been reused by a newer thread */
+
+      if (tcb->heap_live >= node->size)
+        {
+          tcb->heap_live -= node->size;
+        }
+      else
+        {
+          tcb->heap_live = 0;
+        }
+    }
+
+  node->pid = -1;
+}
+
+#endif /* CONFIG_MM_TRACE */
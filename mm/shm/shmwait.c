@@ -0,0 +1,317 @@
+/****************************************************************************
+ * mm/shm/shmwait.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/shm.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/shm.h>
+
+#include "shm/shm.h"
+
+#ifdef CONFIG_MM_SHM
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One thread blocked in shmwait().  The word waited on is identified by
+ * its shared memory region and its offset in the region because each
+ * process may attach the region at a different virtual address.  The
+ * structure lives on the stack of the waiting thread.
+ */
+
+struct shm_waiter_s
+{
+  FAR struct shm_waiter_s *flink;  /* Supports a singly linked list */
+  int shmid;                       /* The region containing the word */
+  size_t offset;                   /* Offset of the word in the region */
+  sem_t sem;                       /* The waiting thread blocks here */
+  bool woken;                      /* Set by shmwake() */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All threads blocked in shmwait(), in the order that they blocked.
+ * Protected by a critical section.
+ */
+
+static sq_queue_t g_shmwaitq;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shm_findword
+ *
+ * Description:
+ *   Find the shared memory region of the calling process that contains
+ *   the word at 'addr' and the offset of the word in that region.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if 'addr' is not an
+ *   aligned word within a region attached by the calling process.
+ *
+ ****************************************************************************/
+
+static int shm_findword(FAR volatile uint32_t *addr, FAR int *shmid,
+                        FAR size_t *offset)
+{
+  FAR struct task_group_s *group = sched_self()->group;
+  uintptr_t vaddr;
+  int i;
+
+  if (((uintptr_t)addr & (sizeof(uint32_t) - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < CONFIG_ARCH_SHM_MAXREGIONS; i++)
+    {
+      vaddr = group->tg_shm.gs_vaddr[i];
+      if (vaddr != 0 && (uintptr_t)addr >= vaddr &&
+          (uintptr_t)addr < vaddr + g_shminfo.si_region[i].sr_ds.shm_segsz)
+        {
+          *shmid  = i;
+          *offset = (uintptr_t)addr - vaddr;
+          return OK;
+        }
+    }
+
+  return -EFAULT;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmwait
+ *
+ * Description:
+ *   This is a NuttX extension that provides a doorbell for processes that
+ *   communicate through shared memory.  It blocks the calling thread if,
+ *   and only if, the 32-bit word at 'addr' still holds the value 'val'.
+ *   The word must lie in a shared memory region attached by the calling
+ *   process.  shmwake() on the same word, from any process that has the
+ *   region attached at any address, wakes the thread.
+ *
+ *   The comparison is atomic with respect to shmwake():  A process that
+ *   changes the word and then calls shmwake() cannot miss a thread that
+ *   saw the old value.  Waits may also end spuriously, so the caller must
+ *   re-check its condition.
+ *
+ * Input Parameters:
+ *   addr    - The address of the doorbell word
+ *   val     - The value that the caller last saw in the word
+ *   abstime - If non-NULL, the CLOCK_REALTIME time at which to give up
+ *
+ * Returned Value:
+ *   Zero (OK) if awakened by shmwake().  Otherwise -1 (ERROR) with errno
+ *   set to:
+ *     - EAGAIN:    The word no longer holds 'val'
+ *     - EINVAL:    The word is not aligned
+ *     - EFAULT:    The word is not in an attached shared memory region
+ *     - EINTR:     A signal interrupted the wait
+ *     - ETIMEDOUT: 'abstime' passed
+ *
+ ****************************************************************************/
+
+int shmwait(FAR volatile uint32_t *addr, uint32_t val,
+            FAR const struct timespec *abstime)
+{
+  struct shm_waiter_s waiter;
+  irqstate_t flags;
+  int errcode;
+  int ret;
+
+  ret = shm_findword(addr, &waiter.shmid, &waiter.offset);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  waiter.woken = false;
+  (void)sem_init(&waiter.sem, 0, 0);
+
+  /* Compare the word and queue the waiter atomically with respect to
+   * shmwake().
+   */
+
+  flags = enter_critical_section();
+  if (*addr != val)
+    {
+      leave_critical_section(flags);
+      sem_destroy(&waiter.sem);
+      set_errno(EAGAIN);
+      return ERROR;
+    }
+
+  sq_addlast((FAR sq_entry_t *)&waiter, &g_shmwaitq);
+  leave_critical_section(flags);
+
+  /* Wait to be awakened.  The semaphore counts, so a shmwake() before we
+   * get here is not lost.
+   */
+
+#ifndef CONFIG_DISABLE_SIGNALS
+  if (abstime != NULL)
+    {
+      ret = sem_timedwait(&waiter.sem, abstime);
+    }
+  else
+#endif
+    {
+      ret = sem_wait(&waiter.sem);
+    }
+
+  errcode = get_errno();
+
+  /* If a signal or the timeout ended the wait, we may still be queued.
+   * But if shmwake() dequeued us in the meantime, then report the wake-up
+   * so that it is not lost.
+   */
+
+  flags = enter_critical_section();
+  if (!waiter.woken)
+    {
+      sq_rem((FAR sq_entry_t *)&waiter, &g_shmwaitq);
+    }
+  else
+    {
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  sem_destroy(&waiter.sem);
+
+  if (ret < 0)
+    {
+      set_errno(errcode);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmwake
+ *
+ * Description:
+ *   This is a NuttX extension.  Wake up to 'nwake' threads, in any
+ *   process, that are blocked in shmwait() on the shared memory word at
+ *   'addr'.
+ *
+ * Input Parameters:
+ *   addr  - The address of the doorbell word
+ *   nwake - The maximum number of threads to wake up
+ *
+ * Returned Value:
+ *   The number of threads awakened.  Otherwise -1 (ERROR) with errno set
+ *   to EINVAL or EFAULT as for shmwait().
+ *
+ ****************************************************************************/
+
+int shmwake(FAR volatile uint32_t *addr, int nwake)
+{
+  FAR struct shm_waiter_s *waiter;
+  FAR struct shm_waiter_s *next;
+  FAR struct shm_waiter_s *prev = NULL;
+  irqstate_t flags;
+  size_t offset;
+  int nwoken = 0;
+  int shmid;
+  int ret;
+
+  ret = shm_findword(addr, &shmid, &offset);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  flags = enter_critical_section();
+
+  for (waiter = (FAR struct shm_waiter_s *)g_shmwaitq.head;
+       waiter != NULL && nwoken < nwake;
+       waiter = next)
+    {
+      next = waiter->flink;
+
+      if (waiter->shmid == shmid && waiter->offset == offset)
+        {
+          /* Dequeue the waiter before waking it; it is then free to
+           * return and release the structure.
+           */
+
+          if (prev == NULL)
+            {
+              (void)sq_remfirst(&g_shmwaitq);
+            }
+          else
+            {
+              (void)sq_remafter((FAR sq_entry_t *)prev, &g_shmwaitq);
+            }
+
+          waiter->woken = true;
+          sem_post(&waiter->sem);
+          nwoken++;
+        }
+      else
+        {
+          prev = waiter;
+        }
+    }
+
+  leave_critical_section(flags);
+  return nwoken;
+}
+
+#endif /* CONFIG_MM_SHM */
@@ -68,3 +68,24 @@ void umm_addregion(FAR void *heap_start, size_t heap_size)
 {
   mm_addregion(USR_HEAP, heap_start, heap_size);
 }
+
+/****************************************************************************
+ * Name: umm_regionattr
+ *
+ * Description:
+ *   This is a simple wrapper for the mm_regionattr() function.  It sets
+ *   the attributes of the user heap region that contains 'mem'.
+ *
+ * Parameters:
+ *   mem  - Any address within the region
+ *   attr - The region attributes (MM_REGION_* bits)
+ *
+ * Return Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int umm_regionattr(FAR void *mem, uint8_t attr)
+{
+  return mm_regionattr(USR_HEAP, mem, attr);
+}
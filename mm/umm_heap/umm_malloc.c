@@ -100,3 +100,26 @@ FAR void *malloc(size_t size)
   return mm_malloc(USR_HEAP, size);
 #endif
 }
+
+/****************************************************************************
+ * Name: malloc_attr
+ *
+ * Description:
+ *   Allocate memory from a user heap region that has all of the attributes
+ *   in 'attr' (MM_REGION_FAST, MM_REGION_DMA, ...).  NULL is returned if
+ *   no such region can satisfy the request; the caller may then fall back
+ *   to malloc().
+ *
+ * Parameters:
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *   attr - The required region attributes
+ *
+ * Return Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+FAR void *malloc_attr(size_t size, uint8_t attr)
+{
+  return mm_malloc_attr(USR_HEAP, size, attr);
+}
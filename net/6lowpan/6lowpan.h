@@ -42,8 +42,58 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/net/6lowpan.h>
+
 #ifdef CONFIG_NET_6LOWPAN
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IPHC encoding (RFC 6282): The first two bytes */
+
+#define SIXLOWPAN_IPHC_TF_MASK     0x18  /* Traffic class and flow label */
+#define SIXLOWPAN_IPHC_TF_00       0x00  /*   ECN + DSCP + FL inline */
+#define SIXLOWPAN_IPHC_TF_01       0x08  /*   ECN + FL inline */
+#define SIXLOWPAN_IPHC_TF_10       0x10  /*   ECN + DSCP inline */
+#define SIXLOWPAN_IPHC_TF_11       0x18  /*   All elided */
+#define SIXLOWPAN_IPHC_NH          0x04  /* Next header is NHC encoded */
+#define SIXLOWPAN_IPHC_HLIM_MASK   0x03  /* Hop limit */
+#define SIXLOWPAN_IPHC_HLIM_INLINE 0x00
+#define SIXLOWPAN_IPHC_HLIM_1      0x01
+#define SIXLOWPAN_IPHC_HLIM_64     0x02
+#define SIXLOWPAN_IPHC_HLIM_255    0x03
+
+#define SIXLOWPAN_IPHC_CID         0x80  /* Context identifier extension */
+#define SIXLOWPAN_IPHC_SAC         0x40  /* Stateful source compression */
+#define SIXLOWPAN_IPHC_SAM_SHIFT   4     /* Source address mode */
+#define SIXLOWPAN_IPHC_M           0x08  /* Multicast destination */
+#define SIXLOWPAN_IPHC_DAC         0x04  /* Stateful destination compression */
+#define SIXLOWPAN_IPHC_DAM_SHIFT   0     /* Destination address mode */
+#define SIXLOWPAN_IPHC_AM_MASK     0x03
+
+/* NHC UDP encoding (RFC 6282): 11110CPP */
+
+#define SIXLOWPAN_NHC_UDP_MASK     0xf8
+#define SIXLOWPAN_NHC_UDP          0xf0
+#define SIXLOWPAN_NHC_UDP_C        0x04  /* Checksum elided (not used) */
+#define SIXLOWPAN_NHC_UDP_PP_MASK  0x03  /* Port compression */
+
+/* The largest IPHC header this implementation produces: dispatch and
+ * encoding (2), traffic class and flow label (4), next header (1), hop
+ * limit (1), two full addresses (32) and the UDP NHC header (7).
+ */
+
+#define SIXLOWPAN_IPHC_MAXLEN      47
+
+/* The largest header that can be compressed (IPv6 + UDP) */
+
+#define SIXLOWPAN_UNCOMP_MAXLEN    (IPv6_HDRLEN + UDP_HDRLEN)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -52,5 +102,85 @@
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Function: sixlowpan_compresshdr
+ *
+ * Description:
+ *   Compress the IPv6 header (and the UDP header that follows it, if any)
+ *   at the beginning of ipbuf using stateless IPHC and NHC encoding.
+ *
+ * Parameters:
+ *   ipbuf    - The IPv6 packet
+ *   iplen    - The size of the IPv6 packet
+ *   srcaddr  - The link-layer source address (may be NULL)
+ *   destaddr - The link-layer destination address (may be NULL)
+ *   hc       - Receives the compressed header (SIXLOWPAN_IPHC_MAXLEN bytes)
+ *   hdrlen   - Receives the number of bytes of ipbuf that were compressed
+ *
+ * Returned Value:
+ *   The size of the compressed header
+ *
+ ****************************************************************************/
+
+int sixlowpan_compresshdr(FAR const uint8_t *ipbuf, uint16_t iplen,
+                          FAR const struct sixlowpan_addr_s *srcaddr,
+                          FAR const struct sixlowpan_addr_s *destaddr,
+                          FAR uint8_t *hc, FAR uint16_t *hdrlen);
+
+/****************************************************************************
+ * Function: sixlowpan_uncompresshdr
+ *
+ * Description:
+ *   Expand an IPHC compressed header into an IPv6 header (followed by a
+ *   UDP header if NHC was used).  The IPv6 payload length and the UDP
+ *   length are left zero; sixlowpan_setlength() sets them once the size
+ *   of the datagram is known.
+ *
+ * Parameters:
+ *   hc       - The compressed header
+ *   hclen    - The number of bytes available at hc
+ *   srcaddr  - The link-layer source address (may be NULL)
+ *   destaddr - The link-layer destination address (may be NULL)
+ *   hdr      - Receives the expanded headers (SIXLOWPAN_UNCOMP_MAXLEN bytes)
+ *   hdrlen   - Receives the size of the expanded headers
+ *
+ * Returned Value:
+ *   The number of compressed bytes consumed; a negated errno value if the
+ *   header is malformed or uses an unsupported (stateful) encoding.
+ *
+ ****************************************************************************/
+
+int sixlowpan_uncompresshdr(FAR const uint8_t *hc, uint16_t hclen,
+                            FAR const struct sixlowpan_addr_s *srcaddr,
+                            FAR const struct sixlowpan_addr_s *destaddr,
+                            FAR uint8_t *hdr, FAR uint16_t *hdrlen);
+
+/****************************************************************************
+ * Function: sixlowpan_setlength
+ *
+ * Description:
+ *   Set the IPv6 payload length (and the UDP length, if the UDP header was
+ *   expanded by sixlowpan_uncompresshdr()) of an expanded datagram.
+ *
+ ****************************************************************************/
+
+void sixlowpan_setlength(FAR uint8_t *ipbuf, uint16_t hdrlen,
+                         uint16_t iplen);
+
+/****************************************************************************
+ * Function: sixlowpan_reass_timer
+ *
+ * Description:
+ *   Age the datagrams being reassembled and discard those that have not
+ *   been completed within CONFIG_NET_6LOWPAN_MAXAGE.  Called from
+ *   devif_timer().
+ *
+ * Parameters:
+ *   hsec - The elapsed time in half seconds
+ *
+ ****************************************************************************/
+
+void sixlowpan_reass_timer(int hsec);
+
 #endif /* CONFIG_NET_6LOWPAN */
 #endif /* __NET_6LOWPAN_6LOWPAN_H */
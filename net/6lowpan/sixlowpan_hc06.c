@@ -0,0 +1,840 @@
+/****************************************************************************
+ * net/6lowpan/sixlowpan_hc06.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_6LOWPAN)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/net/6lowpan.h>
+
+#include "6lowpan/6lowpan.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Address modes (SAM/DAM) for stateless unicast addresses */
+
+#define AM_FULL        0  /* 128 bits inline */
+#define AM_IID64       1  /* fe80::/64 + 64-bit IID inline */
+#define AM_IID16       2  /* fe80::/64 + 0000:00ff:fe00:XXXX */
+#define AM_ELIDED      3  /* fe80::/64 + IID from the link-layer address */
+
+/* Address modes (DAM) for multicast addresses */
+
+#define AM_MCAST_FULL  0  /* 128 bits inline */
+#define AM_MCAST_48    1  /* ffXX::00XX:XXXX:XXXX */
+#define AM_MCAST_32    2  /* ffXX::00XX:XXXX */
+#define AM_MCAST_8     3  /* ff02::00XX */
+
+/* UDP ports that can be compressed */
+
+#define UDP_PORT_8BIT  0xf000  /* 0xf0XX */
+#define UDP_PORT_4BIT  0xf0b0  /* 0xf0bX */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sixlowpan_iid
+ *
+ * Description:
+ *   Form the IPv6 interface identifier that corresponds to an IEEE 802.15.4
+ *   link-layer address (RFC 4944, section 6).
+ *
+ ****************************************************************************/
+
+static void sixlowpan_iid(FAR const struct sixlowpan_addr_s *lladdr,
+                          FAR uint8_t *iid)
+{
+  if (lladdr->len == SIXLOWPAN_EADDRSIZE)
+    {
+      /* EUI-64 with the universal/local bit inverted */
+
+      memcpy(iid, lladdr->u8, 8);
+      iid[0] ^= 0x02;
+    }
+  else
+    {
+      /* 0000:00ff:fe00:XXXX */
+
+      iid[0] = 0x00;
+      iid[1] = 0x00;
+      iid[2] = 0x00;
+      iid[3] = 0xff;
+      iid[4] = 0xfe;
+      iid[5] = 0x00;
+      iid[6] = lladdr->u8[0];
+      iid[7] = lladdr->u8[1];
+    }
+}
+
+/****************************************************************************
+ * Function: sixlowpan_iszero
+ ****************************************************************************/
+
+static bool sixlowpan_iszero(FAR const uint8_t *ptr, int len)
+{
+  while (len-- > 0)
+    {
+      if (*ptr++ != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Function: sixlowpan_islinklocal
+ ****************************************************************************/
+
+static bool sixlowpan_islinklocal(FAR const uint8_t *ipaddr)
+{
+  return ipaddr[0] == 0xfe && ipaddr[1] == 0x80 &&
+         sixlowpan_iszero(&ipaddr[2], 6);
+}
+
+/****************************************************************************
+ * Function: sixlowpan_compressaddr
+ *
+ * Description:
+ *   Compress a unicast address.  Returns the address mode and appends any
+ *   inline bytes at *pptr.
+ *
+ ****************************************************************************/
+
+static uint8_t sixlowpan_compressaddr(FAR const uint8_t *ipaddr,
+                                      FAR const struct sixlowpan_addr_s *lladdr,
+                                      FAR uint8_t **pptr)
+{
+  FAR uint8_t *ptr = *pptr;
+  uint8_t iid[8];
+  uint8_t mode;
+
+  if (!sixlowpan_islinklocal(ipaddr))
+    {
+      memcpy(ptr, ipaddr, 16);
+      ptr += 16;
+      mode = AM_FULL;
+    }
+  else
+    {
+      if (lladdr != NULL)
+        {
+          sixlowpan_iid(lladdr, iid);
+        }
+
+      if (lladdr != NULL && memcmp(&ipaddr[8], iid, 8) == 0)
+        {
+          mode = AM_ELIDED;
+        }
+      else if (ipaddr[8] == 0x00 && ipaddr[9] == 0x00 &&
+               ipaddr[10] == 0x00 && ipaddr[11] == 0xff &&
+               ipaddr[12] == 0xfe && ipaddr[13] == 0x00)
+        {
+          memcpy(ptr, &ipaddr[14], 2);
+          ptr += 2;
+          mode = AM_IID16;
+        }
+      else
+        {
+          memcpy(ptr, &ipaddr[8], 8);
+          ptr += 8;
+          mode = AM_IID64;
+        }
+    }
+
+  *pptr = ptr;
+  return mode;
+}
+
+/****************************************************************************
+ * Function: sixlowpan_compressmcast
+ ****************************************************************************/
+
+static uint8_t sixlowpan_compressmcast(FAR const uint8_t *ipaddr,
+                                       FAR uint8_t **pptr)
+{
+  FAR uint8_t *ptr = *pptr;
+  uint8_t mode;
+
+  if (ipaddr[1] == 0x02 && sixlowpan_iszero(&ipaddr[2], 13))
+    {
+      *ptr++ = ipaddr[15];
+      mode   = AM_MCAST_8;
+    }
+  else if (sixlowpan_iszero(&ipaddr[2], 11))
+    {
+      *ptr++ = ipaddr[1];
+      memcpy(ptr, &ipaddr[13], 3);
+      ptr   += 3;
+      mode   = AM_MCAST_32;
+    }
+  else if (sixlowpan_iszero(&ipaddr[2], 9))
+    {
+      *ptr++ = ipaddr[1];
+      memcpy(ptr, &ipaddr[11], 5);
+      ptr   += 5;
+      mode   = AM_MCAST_48;
+    }
+  else
+    {
+      memcpy(ptr, ipaddr, 16);
+      ptr   += 16;
+      mode   = AM_MCAST_FULL;
+    }
+
+  *pptr = ptr;
+  return mode;
+}
+
+/****************************************************************************
+ * Function: sixlowpan_uncompressaddr
+ *
+ * Description:
+ *   Expand a unicast address.  Returns a pointer past the inline bytes or
+ *   NULL if the encoding cannot be expanded.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *
+sixlowpan_uncompressaddr(FAR const uint8_t *ptr, FAR const uint8_t *end,
+                         uint8_t mode,
+                         FAR const struct sixlowpan_addr_s *lladdr,
+                         FAR uint8_t *ipaddr)
+{
+  static const uint8_t inline16[6] =
+  {
+    0x00, 0x00, 0x00, 0xff, 0xfe, 0x00
+  };
+
+  if (mode == AM_FULL)
+    {
+      if (end - ptr < 16)
+        {
+          return NULL;
+        }
+
+      memcpy(ipaddr, ptr, 16);
+      return ptr + 16;
+    }
+
+  /* All other modes use the link-local prefix */
+
+  memset(ipaddr, 0, 16);
+  ipaddr[0] = 0xfe;
+  ipaddr[1] = 0x80;
+
+  switch (mode)
+    {
+      case AM_IID64:
+        if (end - ptr < 8)
+          {
+            return NULL;
+          }
+
+        memcpy(&ipaddr[8], ptr, 8);
+        return ptr + 8;
+
+      case AM_IID16:
+        if (end - ptr < 2)
+          {
+            return NULL;
+          }
+
+        memcpy(&ipaddr[8], inline16, 6);
+        memcpy(&ipaddr[14], ptr, 2);
+        return ptr + 2;
+
+      default: /* AM_ELIDED */
+        if (lladdr == NULL)
+          {
+            return NULL;
+          }
+
+        sixlowpan_iid(lladdr, &ipaddr[8]);
+        return ptr;
+    }
+}
+
+/****************************************************************************
+ * Function: sixlowpan_uncompressmcast
+ ****************************************************************************/
+
+static FAR const uint8_t *
+sixlowpan_uncompressmcast(FAR const uint8_t *ptr, FAR const uint8_t *end,
+                          uint8_t mode, FAR uint8_t *ipaddr)
+{
+  memset(ipaddr, 0, 16);
+  ipaddr[0] = 0xff;
+
+  switch (mode)
+    {
+      case AM_MCAST_FULL:
+        if (end - ptr < 16)
+          {
+            return NULL;
+          }
+
+        memcpy(ipaddr, ptr, 16);
+        return ptr + 16;
+
+      case AM_MCAST_48:
+        if (end - ptr < 6)
+          {
+            return NULL;
+          }
+
+        ipaddr[1] = ptr[0];
+        memcpy(&ipaddr[11], &ptr[1], 5);
+        return ptr + 6;
+
+      case AM_MCAST_32:
+        if (end - ptr < 4)
+          {
+            return NULL;
+          }
+
+        ipaddr[1] = ptr[0];
+        memcpy(&ipaddr[13], &ptr[1], 3);
+        return ptr + 4;
+
+      default: /* AM_MCAST_8 */
+        if (end - ptr < 1)
+          {
+            return NULL;
+          }
+
+        ipaddr[1]  = 0x02;
+        ipaddr[15] = ptr[0];
+        return ptr + 1;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sixlowpan_compresshdr
+ *
+ * Description:
+ *   Compress the IPv6 header (and the UDP header that follows it, if any)
+ *   at the beginning of ipbuf using stateless IPHC and NHC encoding.
+ *
+ * Parameters:
+ *   ipbuf    - The IPv6 packet
+ *   iplen    - The size of the IPv6 packet
+ *   srcaddr  - The link-layer source address (may be NULL)
+ *   destaddr - The link-layer destination address (may be NULL)
+ *   hc       - Receives the compressed header (SIXLOWPAN_IPHC_MAXLEN bytes)
+ *   hdrlen   - Receives the number of bytes of ipbuf that were compressed
+ *
+ * Returned Value:
+ *   The size of the compressed header
+ *
+ ****************************************************************************/
+
+int sixlowpan_compresshdr(FAR const uint8_t *ipbuf, uint16_t iplen,
+                          FAR const struct sixlowpan_addr_s *srcaddr,
+                          FAR const struct sixlowpan_addr_s *destaddr,
+                          FAR uint8_t *hc, FAR uint16_t *hdrlen)
+{
+  FAR const struct ipv6_hdr_s *ipv6 = (FAR const struct ipv6_hdr_s *)ipbuf;
+  FAR const uint8_t *srcip = (FAR const uint8_t *)ipv6->srcipaddr;
+  FAR const uint8_t *destip = (FAR const uint8_t *)ipv6->destipaddr;
+  FAR uint8_t *ptr = &hc[2];
+  uint8_t iphc0 = SIXLOWPAN_DISPATCH_IPHC;
+  uint8_t iphc1 = 0;
+  uint32_t flow;
+  uint8_t tc;
+  uint8_t ecndscp;
+  bool udp;
+
+  /* Traffic class and flow label.  IPHC carries the ECN bits ahead of the
+   * DSCP.
+   */
+
+  tc      = (ipbuf[0] << 4) | (ipbuf[1] >> 4);
+  flow    = ((uint32_t)(ipbuf[1] & 0x0f) << 16) |
+            ((uint32_t)ipbuf[2] << 8) | ipbuf[3];
+  ecndscp = (tc >> 2) | (tc << 6);
+
+  if (tc == 0 && flow == 0)
+    {
+      iphc0 |= SIXLOWPAN_IPHC_TF_11;
+    }
+  else if (flow == 0)
+    {
+      iphc0 |= SIXLOWPAN_IPHC_TF_10;
+      *ptr++ = ecndscp;
+    }
+  else if ((tc >> 2) == 0)
+    {
+      /* DSCP is zero: Send ECN and the flow label */
+
+      iphc0 |= SIXLOWPAN_IPHC_TF_01;
+      *ptr++ = (uint8_t)(tc << 6) | (uint8_t)(flow >> 16);
+      *ptr++ = (uint8_t)(flow >> 8);
+      *ptr++ = (uint8_t)flow;
+    }
+  else
+    {
+      iphc0 |= SIXLOWPAN_IPHC_TF_00;
+      *ptr++ = ecndscp;
+      *ptr++ = (uint8_t)(flow >> 16);
+      *ptr++ = (uint8_t)(flow >> 8);
+      *ptr++ = (uint8_t)flow;
+    }
+
+  /* Next header: UDP is NHC compressed, anything else is carried inline */
+
+  udp = (ipv6->proto == IP_PROTO_UDP && iplen >= IPv6_HDRLEN + UDP_HDRLEN);
+  if (udp)
+    {
+      iphc0 |= SIXLOWPAN_IPHC_NH;
+    }
+  else
+    {
+      *ptr++ = ipv6->proto;
+    }
+
+  /* Hop limit */
+
+  switch (ipv6->ttl)
+    {
+      case 1:
+        iphc0 |= SIXLOWPAN_IPHC_HLIM_1;
+        break;
+
+      case 64:
+        iphc0 |= SIXLOWPAN_IPHC_HLIM_64;
+        break;
+
+      case 255:
+        iphc0 |= SIXLOWPAN_IPHC_HLIM_255;
+        break;
+
+      default:
+        iphc0 |= SIXLOWPAN_IPHC_HLIM_INLINE;
+        *ptr++ = ipv6->ttl;
+        break;
+    }
+
+  /* Source address.  The unspecified address is encoded with SAC=1, SAM=0 */
+
+  if (sixlowpan_iszero(srcip, 16))
+    {
+      iphc1 |= SIXLOWPAN_IPHC_SAC;
+    }
+  else
+    {
+      iphc1 |= sixlowpan_compressaddr(srcip, srcaddr, &ptr) <<
+               SIXLOWPAN_IPHC_SAM_SHIFT;
+    }
+
+  /* Destination address */
+
+  if (destip[0] == 0xff)
+    {
+      iphc1 |= SIXLOWPAN_IPHC_M;
+      iphc1 |= sixlowpan_compressmcast(destip, &ptr) <<
+               SIXLOWPAN_IPHC_DAM_SHIFT;
+    }
+  else
+    {
+      iphc1 |= sixlowpan_compressaddr(destip, destaddr, &ptr) <<
+               SIXLOWPAN_IPHC_DAM_SHIFT;
+    }
+
+  *hdrlen = IPv6_HDRLEN;
+
+  /* UDP header (RFC 6282, section 4.3.3).  The length is always elided and
+   * the checksum is always carried.
+   */
+
+  if (udp)
+    {
+      FAR const struct udp_hdr_s *udphdr =
+        (FAR const struct udp_hdr_s *)&ipbuf[IPv6_HDRLEN];
+      uint16_t srcport  = ntohs(udphdr->srcport);
+      uint16_t destport = ntohs(udphdr->destport);
+
+      if ((srcport & 0xfff0) == UDP_PORT_4BIT &&
+          (destport & 0xfff0) == UDP_PORT_4BIT)
+        {
+          *ptr++ = SIXLOWPAN_NHC_UDP | 3;
+          *ptr++ = (uint8_t)((srcport & 0x0f) << 4) |
+                   (uint8_t)(destport & 0x0f);
+        }
+      else if ((destport & 0xff00) == UDP_PORT_8BIT)
+        {
+          *ptr++ = SIXLOWPAN_NHC_UDP | 1;
+          memcpy(ptr, &udphdr->srcport, 2);
+          ptr   += 2;
+          *ptr++ = (uint8_t)destport;
+        }
+      else if ((srcport & 0xff00) == UDP_PORT_8BIT)
+        {
+          *ptr++ = SIXLOWPAN_NHC_UDP | 2;
+          *ptr++ = (uint8_t)srcport;
+          memcpy(ptr, &udphdr->destport, 2);
+          ptr   += 2;
+        }
+      else
+        {
+          *ptr++ = SIXLOWPAN_NHC_UDP;
+          memcpy(ptr, &udphdr->srcport, 4);
+          ptr   += 4;
+        }
+
+      memcpy(ptr, &udphdr->udpchksum, 2);
+      ptr += 2;
+
+      *hdrlen += UDP_HDRLEN;
+    }
+
+  hc[0] = iphc0;
+  hc[1] = iphc1;
+  return ptr - hc;
+}
+
+/****************************************************************************
+ * Function: sixlowpan_uncompresshdr
+ *
+ * Description:
+ *   Expand an IPHC compressed header into an IPv6 header (followed by a
+ *   UDP header if NHC was used).  The IPv6 payload length and the UDP
+ *   length are left zero; sixlowpan_setlength() sets them once the size
+ *   of the datagram is known.
+ *
+ * Parameters:
+ *   hc       - The compressed header
+ *   hclen    - The number of bytes available at hc
+ *   srcaddr  - The link-layer source address (may be NULL)
+ *   destaddr - The link-layer destination address (may be NULL)
+ *   hdr      - Receives the expanded headers (SIXLOWPAN_UNCOMP_MAXLEN bytes)
+ *   hdrlen   - Receives the size of the expanded headers
+ *
+ * Returned Value:
+ *   The number of compressed bytes consumed; a negated errno value if the
+ *   header is malformed or uses an unsupported (stateful) encoding.
+ *
+ ****************************************************************************/
+
+int sixlowpan_uncompresshdr(FAR const uint8_t *hc, uint16_t hclen,
+                            FAR const struct sixlowpan_addr_s *srcaddr,
+                            FAR const struct sixlowpan_addr_s *destaddr,
+                            FAR uint8_t *hdr, FAR uint16_t *hdrlen)
+{
+  FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)hdr;
+  FAR const uint8_t *end = hc + hclen;
+  FAR const uint8_t *ptr = &hc[2];
+  uint32_t flow = 0;
+  uint8_t tc = 0;
+  uint8_t iphc0;
+  uint8_t iphc1;
+  uint8_t mode;
+
+  if (hclen < 2 ||
+      (hc[0] & SIXLOWPAN_DISPATCH_IPHC_MASK) != SIXLOWPAN_DISPATCH_IPHC)
+    {
+      return -EINVAL;
+    }
+
+  iphc0 = hc[0];
+  iphc1 = hc[1];
+
+  /* Contexts (stateful compression) are not supported */
+
+  if ((iphc1 & SIXLOWPAN_IPHC_CID) != 0 ||
+      (iphc1 & SIXLOWPAN_IPHC_DAC) != 0 ||
+      ((iphc1 & SIXLOWPAN_IPHC_SAC) != 0 &&
+       ((iphc1 >> SIXLOWPAN_IPHC_SAM_SHIFT) & SIXLOWPAN_IPHC_AM_MASK) != 0))
+    {
+      nwarn("WARNING: Stateful IPHC not supported: %02x\n", iphc1);
+      return -EPROTONOSUPPORT;
+    }
+
+  /* Traffic class and flow label */
+
+  switch (iphc0 & SIXLOWPAN_IPHC_TF_MASK)
+    {
+      case SIXLOWPAN_IPHC_TF_00:
+        if (end - ptr < 4)
+          {
+            return -EINVAL;
+          }
+
+        tc   = (uint8_t)(ptr[0] << 2) | (ptr[0] >> 6);
+        flow = ((uint32_t)(ptr[1] & 0x0f) << 16) |
+               ((uint32_t)ptr[2] << 8) | ptr[3];
+        ptr += 4;
+        break;
+
+      case SIXLOWPAN_IPHC_TF_01:
+        if (end - ptr < 3)
+          {
+            return -EINVAL;
+          }
+
+        tc   = ptr[0] >> 6;
+        flow = ((uint32_t)(ptr[0] & 0x0f) << 16) |
+               ((uint32_t)ptr[1] << 8) | ptr[2];
+        ptr += 3;
+        break;
+
+      case SIXLOWPAN_IPHC_TF_10:
+        if (end - ptr < 1)
+          {
+            return -EINVAL;
+          }
+
+        tc   = (uint8_t)(ptr[0] << 2) | (ptr[0] >> 6);
+        ptr += 1;
+        break;
+
+      default: /* SIXLOWPAN_IPHC_TF_11 */
+        break;
+    }
+
+  memset(hdr, 0, IPv6_HDRLEN);
+  hdr[0] = 0x60 | (tc >> 4);
+  hdr[1] = (uint8_t)(tc << 4) | (uint8_t)(flow >> 16);
+  hdr[2] = (uint8_t)(flow >> 8);
+  hdr[3] = (uint8_t)flow;
+
+  /* Next header */
+
+  if ((iphc0 & SIXLOWPAN_IPHC_NH) != 0)
+    {
+      ipv6->proto = IP_PROTO_UDP;
+    }
+  else
+    {
+      if (end - ptr < 1)
+        {
+          return -EINVAL;
+        }
+
+      ipv6->proto = *ptr++;
+    }
+
+  /* Hop limit */
+
+  switch (iphc0 & SIXLOWPAN_IPHC_HLIM_MASK)
+    {
+      case SIXLOWPAN_IPHC_HLIM_1:
+        ipv6->ttl = 1;
+        break;
+
+      case SIXLOWPAN_IPHC_HLIM_64:
+        ipv6->ttl = 64;
+        break;
+
+      case SIXLOWPAN_IPHC_HLIM_255:
+        ipv6->ttl = 255;
+        break;
+
+      default:
+        if (end - ptr < 1)
+          {
+            return -EINVAL;
+          }
+
+        ipv6->ttl = *ptr++;
+        break;
+    }
+
+  /* Source address (the unspecified address if SAC is set) */
+
+  if ((iphc1 & SIXLOWPAN_IPHC_SAC) == 0)
+    {
+      mode = (iphc1 >> SIXLOWPAN_IPHC_SAM_SHIFT) & SIXLOWPAN_IPHC_AM_MASK;
+      ptr  = sixlowpan_uncompressaddr(ptr, end, mode, srcaddr,
+                                      (FAR uint8_t *)ipv6->srcipaddr);
+      if (ptr == NULL)
+        {
+          return -EINVAL;
+        }
+    }
+
+  /* Destination address */
+
+  mode = (iphc1 >> SIXLOWPAN_IPHC_DAM_SHIFT) & SIXLOWPAN_IPHC_AM_MASK;
+  if ((iphc1 & SIXLOWPAN_IPHC_M) != 0)
+    {
+      ptr = sixlowpan_uncompressmcast(ptr, end, mode,
+                                      (FAR uint8_t *)ipv6->destipaddr);
+    }
+  else
+    {
+      ptr = sixlowpan_uncompressaddr(ptr, end, mode, destaddr,
+                                     (FAR uint8_t *)ipv6->destipaddr);
+    }
+
+  if (ptr == NULL)
+    {
+      return -EINVAL;
+    }
+
+  *hdrlen = IPv6_HDRLEN;
+
+  /* UDP header */
+
+  if ((iphc0 & SIXLOWPAN_IPHC_NH) != 0)
+    {
+      FAR struct udp_hdr_s *udphdr =
+        (FAR struct udp_hdr_s *)&hdr[IPv6_HDRLEN];
+      uint8_t nhc;
+
+      if (end - ptr < 1 ||
+          (ptr[0] & SIXLOWPAN_NHC_UDP_MASK) != SIXLOWPAN_NHC_UDP)
+        {
+          nwarn("WARNING: Unsupported NHC header\n");
+          return -EPROTONOSUPPORT;
+        }
+
+      nhc = *ptr++;
+      memset(udphdr, 0, UDP_HDRLEN);
+
+      switch (nhc & SIXLOWPAN_NHC_UDP_PP_MASK)
+        {
+          case 0:
+            if (end - ptr < 4)
+              {
+                return -EINVAL;
+              }
+
+            memcpy(&udphdr->srcport, ptr, 4);
+            ptr += 4;
+            break;
+
+          case 1:
+            if (end - ptr < 3)
+              {
+                return -EINVAL;
+              }
+
+            memcpy(&udphdr->srcport, ptr, 2);
+            udphdr->destport = htons(UDP_PORT_8BIT | ptr[2]);
+            ptr += 3;
+            break;
+
+          case 2:
+            if (end - ptr < 3)
+              {
+                return -EINVAL;
+              }
+
+            udphdr->srcport = htons(UDP_PORT_8BIT | ptr[0]);
+            memcpy(&udphdr->destport, &ptr[1], 2);
+            ptr += 3;
+            break;
+
+          default:
+            if (end - ptr < 1)
+              {
+                return -EINVAL;
+              }
+
+            udphdr->srcport  = htons(UDP_PORT_4BIT | (ptr[0] >> 4));
+            udphdr->destport = htons(UDP_PORT_4BIT | (ptr[0] & 0x0f));
+            ptr += 1;
+            break;
+        }
+
+      /* An elided checksum would have to be recomputed; RFC 6282 only
+       * permits it with upper layer authorization, so it is not accepted.
+       */
+
+      if ((nhc & SIXLOWPAN_NHC_UDP_C) != 0 || end - ptr < 2)
+        {
+          return -EINVAL;
+        }
+
+      memcpy(&udphdr->udpchksum, ptr, 2);
+      ptr += 2;
+
+      *hdrlen += UDP_HDRLEN;
+    }
+
+  return ptr - hc;
+}
+
+/****************************************************************************
+ * Function: sixlowpan_setlength
+ *
+ * Description:
+ *   Set the IPv6 payload length (and the UDP length, if the UDP header was
+ *   expanded by sixlowpan_uncompresshdr()) of an expanded datagram.
+ *
+ ****************************************************************************/
+
+void sixlowpan_setlength(FAR uint8_t *ipbuf, uint16_t hdrlen,
+                         uint16_t iplen)
+{
+  FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ipbuf;
+  uint16_t paylen = iplen - IPv6_HDRLEN;
+
+  ipv6->len[0] = (uint8_t)(paylen >> 8);
+  ipv6->len[1] = (uint8_t)paylen;
+
+  if (hdrlen > IPv6_HDRLEN)
+    {
+      FAR struct udp_hdr_s *udphdr =
+        (FAR struct udp_hdr_s *)&ipbuf[IPv6_HDRLEN];
+
+      udphdr->udplen = htons(paylen);
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_6LOWPAN */
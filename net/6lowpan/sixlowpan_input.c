@@ -0,0 +1,473 @@
+/****************************************************************************
+ * net/6lowpan/sixlowpan_input.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_6LOWPAN)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/iob.h>
+#include <nuttx/net/6lowpan.h>
+
+#include "iob/iob.h"
+#include "6lowpan/6lowpan.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The reassembly timeout in half seconds (the devif_timer() unit) */
+
+#define SIXLOWPAN_REASS_MAXAGE  (2 * CONFIG_NET_6LOWPAN_MAXAGE)
+
+/* The largest datagram (11-bit size) in 8-byte units */
+
+#define SIXLOWPAN_REASS_NUNITS  (2048 / 8)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One datagram being reassembled */
+
+struct sixlowpan_reass_s
+{
+  FAR struct iob_s *iob;          /* The datagram (NULL: entry is free) */
+  struct sixlowpan_addr_s src;    /* Link-layer source of the fragments */
+  uint16_t tag;                   /* Datagram tag */
+  uint16_t dgramlen;              /* Size of the uncompressed datagram */
+  uint16_t nunits;                /* Number of 8-byte units received */
+  uint8_t  hdrlen;                /* Size of the headers expanded from IPHC
+                                   * (0: the first fragment is missing) */
+  uint8_t  age;                   /* Time since the first fragment
+                                   * (half seconds) */
+  uint8_t  bitmap[SIXLOWPAN_REASS_NUNITS / 8]; /* Units received */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sixlowpan_reass_s g_reass[CONFIG_NET_6LOWPAN_NREASS];
+
+/* Used to grow a reassembly IOB chain to the size of the datagram */
+
+static const uint8_t g_zeros[16];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sixlowpan_reass_free
+ ****************************************************************************/
+
+static void sixlowpan_reass_free(FAR struct sixlowpan_reass_s *reass)
+{
+  if (reass->iob != NULL)
+    {
+      iob_free_chain(reass->iob);
+      reass->iob = NULL;
+    }
+}
+
+/****************************************************************************
+ * Function: sixlowpan_reass_find
+ *
+ * Description:
+ *   Find the reassembly of the datagram that a fragment belongs to or
+ *   start a new one, recycling the oldest reassembly if none is free.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_reass_s *
+sixlowpan_reass_find(FAR const struct sixlowpan_addr_s *srcaddr,
+                     uint16_t tag, uint16_t dgramlen)
+{
+  FAR struct sixlowpan_reass_s *reass;
+  FAR struct sixlowpan_reass_s *victim = NULL;
+  FAR struct iob_s *iob;
+  uint16_t len;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_NREASS; i++)
+    {
+      reass = &g_reass[i];
+      if (reass->iob == NULL)
+        {
+          if (victim == NULL || victim->iob != NULL)
+            {
+              victim = reass;
+            }
+        }
+      else if (reass->tag == tag && reass->dgramlen == dgramlen &&
+               reass->src.len == srcaddr->len &&
+               memcmp(reass->src.u8, srcaddr->u8, srcaddr->len) == 0)
+        {
+          return reass;
+        }
+      else if (victim == NULL ||
+               (victim->iob != NULL && reass->age > victim->age))
+        {
+          victim = reass;
+        }
+    }
+
+  /* Start a new reassembly.  The IOB chain is grown to the size of the
+   * datagram up front, so that fragments can be copied in at their offsets
+   * in any order.
+   */
+
+  sixlowpan_reass_free(victim);
+
+  iob = iob_tryalloc_user(false, IOBUSER_NETDEV);
+  if (iob == NULL)
+    {
+      return NULL;
+    }
+
+  while (iob->io_pktlen < dgramlen)
+    {
+      len = dgramlen - iob->io_pktlen;
+      if (len > sizeof(g_zeros))
+        {
+          len = sizeof(g_zeros);
+        }
+
+      if (iob_trycopyin(iob, g_zeros, len, iob->io_pktlen, false) != len)
+        {
+          iob_free_chain(iob);
+          return NULL;
+        }
+    }
+
+  memset(victim, 0, sizeof(struct sixlowpan_reass_s));
+  victim->iob      = iob;
+  victim->src      = *srcaddr;
+  victim->tag      = tag;
+  victim->dgramlen = dgramlen;
+  return victim;
+}
+
+/****************************************************************************
+ * Function: sixlowpan_reass_mark
+ *
+ * Description:
+ *   Record the 8-byte units covered by a fragment.
+ *
+ ****************************************************************************/
+
+static void sixlowpan_reass_mark(FAR struct sixlowpan_reass_s *reass,
+                                 uint16_t offset, uint16_t len)
+{
+  unsigned int unit = offset >> 3;
+  unsigned int last = (offset + len + 7) >> 3;
+
+  for (; unit < last; unit++)
+    {
+      if ((reass->bitmap[unit >> 3] & (1 << (unit & 7))) == 0)
+        {
+          reass->bitmap[unit >> 3] |= (1 << (unit & 7));
+          reass->nunits++;
+        }
+    }
+}
+
+/****************************************************************************
+ * Function: sixlowpan_frag_input
+ *
+ * Description:
+ *   Handle a FRAG1 or FRAGN frame.
+ *
+ ****************************************************************************/
+
+static int sixlowpan_frag_input(FAR struct net_driver_s *dev,
+                                FAR const uint8_t *frame, uint16_t framelen,
+                                FAR const struct sixlowpan_addr_s *srcaddr,
+                                FAR const struct sixlowpan_addr_s *destaddr)
+{
+  FAR struct sixlowpan_reass_s *reass;
+  uint8_t hdr[SIXLOWPAN_UNCOMP_MAXLEN];
+  FAR const uint8_t *data;
+  uint16_t dgramlen;
+  uint16_t offset;
+  uint16_t datalen;
+  uint16_t hdrlen = 0;
+  uint16_t tag;
+  bool first;
+  int ret;
+
+  first = (frame[0] & SIXLOWPAN_DISPATCH_FRAG_MASK) ==
+          SIXLOWPAN_DISPATCH_FRAG1;
+
+  if (srcaddr == NULL ||
+      framelen <= (first ? SIXLOWPAN_FRAG1_HDRLEN : SIXLOWPAN_FRAGN_HDRLEN))
+    {
+      return -EINVAL;
+    }
+
+  dgramlen = ((uint16_t)(frame[0] & 0x07) << 8) | frame[1];
+  tag      = ((uint16_t)frame[2] << 8) | frame[3];
+
+  if (dgramlen < IPv6_HDRLEN ||
+      dgramlen > NET_DEV_MTU(dev) - NET_LL_HDRLEN(dev))
+    {
+      return -EMSGSIZE;
+    }
+
+  if (first)
+    {
+      /* The first fragment starts with the (compressed) IPv6 header */
+
+      offset  = 0;
+      data    = &frame[SIXLOWPAN_FRAG1_HDRLEN];
+      datalen = framelen - SIXLOWPAN_FRAG1_HDRLEN;
+
+      if (data[0] == SIXLOWPAN_DISPATCH_IPV6)
+        {
+          data++;
+          datalen--;
+        }
+      else
+        {
+          ret = sixlowpan_uncompresshdr(data, datalen, srcaddr, destaddr,
+                                        hdr, &hdrlen);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          data    += ret;
+          datalen -= ret;
+        }
+    }
+  else
+    {
+      offset  = (uint16_t)frame[4] << 3;
+      data    = &frame[SIXLOWPAN_FRAGN_HDRLEN];
+      datalen = framelen - SIXLOWPAN_FRAGN_HDRLEN;
+    }
+
+  if (offset + hdrlen + datalen > dgramlen)
+    {
+      return -EINVAL;
+    }
+
+  reass = sixlowpan_reass_find(srcaddr, tag, dgramlen);
+  if (reass == NULL)
+    {
+      nwarn("WARNING: No buffers to reassemble datagram\n");
+      return -ENOMEM;
+    }
+
+  /* Copy the fragment into place.  The chain already spans the whole
+   * datagram, so this cannot fail.
+   */
+
+  if (first)
+    {
+      if (hdrlen > 0)
+        {
+          (void)iob_trycopyin(reass->iob, hdr, hdrlen, 0, false);
+        }
+
+      reass->hdrlen = hdrlen > 0 ? hdrlen : IPv6_HDRLEN;
+    }
+
+  (void)iob_trycopyin(reass->iob, data, datalen, offset + hdrlen, false);
+  sixlowpan_reass_mark(reass, offset, hdrlen + datalen);
+
+  /* Is the datagram complete? */
+
+  if (reass->hdrlen == 0 || reass->nunits < (dgramlen + 7) >> 3)
+    {
+      return -EAGAIN;
+    }
+
+  (void)iob_copyout(dev->d_buf, reass->iob, dgramlen, 0);
+
+  /* Only headers expanded from IPHC lack the lengths.  An uncompressed
+   * first fragment (reass->hdrlen == IPv6_HDRLEN) carries them already,
+   * but setting them again does no harm.
+   */
+
+  sixlowpan_setlength(dev->d_buf, reass->hdrlen, dgramlen);
+  dev->d_len = dgramlen;
+
+  sixlowpan_reass_free(reass);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sixlowpan_input
+ *
+ * Description:
+ *   Handle one received 6LoWPAN frame payload (without the MAC header and
+ *   FCS).  Compressed headers are expanded and fragments are reassembled.
+ *   When an IPv6 packet is complete, it is placed in dev->d_buf with d_len
+ *   set and the driver should then pass it to ipv6_input().
+ *
+ * Parameters:
+ *   dev      - The network device that received the frame
+ *   frame    - The frame payload
+ *   framelen - The size of the frame payload
+ *   srcaddr  - The link-layer source address of the frame
+ *   destaddr - The link-layer destination address of the frame
+ *
+ * Returned Value:
+ *   OK if an IPv6 packet is now in dev->d_buf; -EAGAIN if the frame was a
+ *   fragment of a datagram that is not yet complete; another negated errno
+ *   value if the frame was dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int sixlowpan_input(FAR struct net_driver_s *dev, FAR const uint8_t *frame,
+                    uint16_t framelen,
+                    FAR const struct sixlowpan_addr_s *srcaddr,
+                    FAR const struct sixlowpan_addr_s *destaddr)
+{
+  uint16_t maxlen = NET_DEV_MTU(dev) - NET_LL_HDRLEN(dev);
+  uint16_t hdrlen;
+  int ret;
+
+  if (framelen < 1)
+    {
+      return -EINVAL;
+    }
+
+  /* Fragments are reassembled */
+
+  if ((frame[0] & SIXLOWPAN_DISPATCH_FRAG_MASK) == SIXLOWPAN_DISPATCH_FRAG1 ||
+      (frame[0] & SIXLOWPAN_DISPATCH_FRAG_MASK) == SIXLOWPAN_DISPATCH_FRAGN)
+    {
+      return sixlowpan_frag_input(dev, frame, framelen, srcaddr, destaddr);
+    }
+
+  /* Uncompressed IPv6 */
+
+  if (frame[0] == SIXLOWPAN_DISPATCH_IPV6)
+    {
+      if (framelen - 1 > maxlen)
+        {
+          return -EMSGSIZE;
+        }
+
+      memcpy(dev->d_buf, &frame[1], framelen - 1);
+      dev->d_len = framelen - 1;
+      return OK;
+    }
+
+  /* IPHC compressed IPv6 */
+
+  if ((frame[0] & SIXLOWPAN_DISPATCH_IPHC_MASK) == SIXLOWPAN_DISPATCH_IPHC)
+    {
+      ret = sixlowpan_uncompresshdr(frame, framelen, srcaddr, destaddr,
+                                    dev->d_buf, &hdrlen);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (hdrlen + framelen - ret > maxlen)
+        {
+          return -EMSGSIZE;
+        }
+
+      memcpy(&dev->d_buf[hdrlen], &frame[ret], framelen - ret);
+      dev->d_len = hdrlen + framelen - ret;
+      sixlowpan_setlength(dev->d_buf, hdrlen, dev->d_len);
+      return OK;
+    }
+
+  /* Mesh, broadcast and other headers are not supported */
+
+  nwarn("WARNING: Unsupported dispatch: %02x\n", frame[0]);
+  return -EPROTONOSUPPORT;
+}
+
+/****************************************************************************
+ * Function: sixlowpan_reass_timer
+ *
+ * Description:
+ *   Age the datagrams being reassembled and discard those that have not
+ *   been completed within CONFIG_NET_6LOWPAN_MAXAGE.  Called from
+ *   devif_timer().
+ *
+ * Parameters:
+ *   hsec - The elapsed time in half seconds
+ *
+ ****************************************************************************/
+
+void sixlowpan_reass_timer(int hsec)
+{
+  FAR struct sixlowpan_reass_s *reass;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_NREASS; i++)
+    {
+      reass = &g_reass[i];
+      if (reass->iob != NULL)
+        {
+          if (reass->age + hsec >= SIXLOWPAN_REASS_MAXAGE)
+            {
+              nwarn("WARNING: Reassembly timed out, tag=%04x\n", reass->tag);
+              sixlowpan_reass_free(reass);
+            }
+          else
+            {
+              reass->age += hsec;
+            }
+        }
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_6LOWPAN */
@@ -0,0 +1,195 @@
+/****************************************************************************
+ * net/6lowpan/sixlowpan_send.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_6LOWPAN)
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/6lowpan.h>
+
+#include "6lowpan/6lowpan.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC 4944 limits the datagram size to 11 bits */
+
+#define SIXLOWPAN_MAX_DGRAMLEN  2047
+
+/* All fragments but the last must carry a multiple of 8 bytes */
+
+#define SIXLOWPAN_FRAGN_MAXDATA \
+  ((CONFIG_NET_6LOWPAN_FRAMELEN - SIXLOWPAN_FRAGN_HDRLEN) & ~7)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The tag that identifies the fragments of the next datagram */
+
+static uint16_t g_dgram_tag;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sixlowpan_send
+ *
+ * Description:
+ *   Compress the IPv6 packet in dev->d_buf (d_len bytes) and send it as one
+ *   or more 6LoWPAN frames of at most CONFIG_NET_6LOWPAN_FRAMELEN bytes,
+ *   fragmenting it if necessary.  This is called by the radio driver for
+ *   each packet from devif_poll() in place of a hardware transmission.
+ *
+ * Parameters:
+ *   dev       - The network device holding the packet
+ *   srcaddr   - The link-layer source address (the radio's own address)
+ *   destaddr  - The link-layer address of the next hop (or NULL for a
+ *               multicast destination)
+ *   sendframe - Called to send each frame
+ *   arg       - Passed to sendframe
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure, including any error
+ *   returned by sendframe.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int sixlowpan_send(FAR struct net_driver_s *dev,
+                   FAR const struct sixlowpan_addr_s *srcaddr,
+                   FAR const struct sixlowpan_addr_s *destaddr,
+                   sixlowpan_sendframe_t sendframe, FAR void *arg)
+{
+  FAR const uint8_t *ipbuf = dev->d_buf;
+  uint8_t frame[CONFIG_NET_6LOWPAN_FRAMELEN];
+  uint8_t hc[SIXLOWPAN_IPHC_MAXLEN];
+  uint16_t iplen = dev->d_len;
+  uint16_t hdrlen;
+  uint16_t offset;
+  uint16_t tag;
+  uint16_t ndata;
+  int hclen;
+  int ret;
+
+  if (iplen < IPv6_HDRLEN)
+    {
+      return -EINVAL;
+    }
+
+  hclen = sixlowpan_compresshdr(ipbuf, iplen, srcaddr, destaddr, hc,
+                                &hdrlen);
+
+  /* Does the compressed packet fit in a single frame? */
+
+  if (hclen + iplen - hdrlen <= CONFIG_NET_6LOWPAN_FRAMELEN)
+    {
+      memcpy(frame, hc, hclen);
+      memcpy(&frame[hclen], &ipbuf[hdrlen], iplen - hdrlen);
+      return sendframe(dev, frame, hclen + iplen - hdrlen, arg);
+    }
+
+  /* No.. fragment it (RFC 4944, section 5.3).  Fragment offsets and the
+   * datagram size refer to the uncompressed datagram.
+   */
+
+  if (iplen > SIXLOWPAN_MAX_DGRAMLEN)
+    {
+      return -EMSGSIZE;
+    }
+
+  tag = g_dgram_tag++;
+
+  /* The first fragment carries the compressed header and as much payload
+   * as fits, keeping the uncompressed size a multiple of 8 (hdrlen always
+   * is).
+   */
+
+  ndata = (CONFIG_NET_6LOWPAN_FRAMELEN - SIXLOWPAN_FRAG1_HDRLEN - hclen) &
+          ~7;
+
+  frame[0] = SIXLOWPAN_DISPATCH_FRAG1 | (uint8_t)(iplen >> 8);
+  frame[1] = (uint8_t)iplen;
+  frame[2] = (uint8_t)(tag >> 8);
+  frame[3] = (uint8_t)tag;
+  memcpy(&frame[SIXLOWPAN_FRAG1_HDRLEN], hc, hclen);
+  memcpy(&frame[SIXLOWPAN_FRAG1_HDRLEN + hclen], &ipbuf[hdrlen], ndata);
+
+  ret = sendframe(dev, frame, SIXLOWPAN_FRAG1_HDRLEN + hclen + ndata, arg);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Then the rest, uncompressed */
+
+  frame[0] = SIXLOWPAN_DISPATCH_FRAGN | (uint8_t)(iplen >> 8);
+
+  for (offset = hdrlen + ndata; offset < iplen; offset += ndata)
+    {
+      ndata = iplen - offset;
+      if (ndata > SIXLOWPAN_FRAGN_MAXDATA)
+        {
+          ndata = SIXLOWPAN_FRAGN_MAXDATA;
+        }
+
+      frame[4] = (uint8_t)(offset >> 3);
+      memcpy(&frame[SIXLOWPAN_FRAGN_HDRLEN], &ipbuf[offset], ndata);
+
+      ret = sendframe(dev, frame, SIXLOWPAN_FRAGN_HDRLEN + ndata, arg);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_6LOWPAN */
@@ -53,6 +53,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
 #include <netinet/in.h>
@@ -398,19 +399,11 @@ FAR struct arp_entry *arp_find(in_addr_t ipaddr);
  *   ipaddr - Refers to an IP address in network order
  *
  * Assumptions
- *   Interrupts are disabled to assure exclusive access to the ARP table
- *   (and because arp_find() is called).
+ *   The network is locked to assure exclusive access to the ARP table
  *
  ****************************************************************************/
 
-#define arp_delete(ipaddr) \
-{ \
-  struct arp_entry *tabptr = arp_find(ipaddr); \
-  if (tabptr) \
-    { \
-      tabptr->at_ipaddr = 0; \
-    } \
-}
+void arp_delete(in_addr_t ipaddr);
 
 /****************************************************************************
  * Name: arp_update
@@ -470,6 +463,77 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr);
  *
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: arp_pending_out
+ *
+ * Description:
+ *   Called from arp_out() when there is no ARP table entry for the
+ *   destination of the IP packet in d_buf.  A copy of the packet is
+ *   queued so that it can be sent as soon as the address is resolved.
+ *
+ * Input Parameters:
+ *   dev    - The device used to send the packet
+ *   ipaddr - The IP address to be resolved
+ *
+ * Returned Value:
+ *   True if the packet in d_buf should be replaced by an ARP request;
+ *   false if nothing should be sent now (the request is rate-limited or
+ *   the address is negatively cached).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+bool arp_pending_out(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#else
+#  define arp_pending_out(d,i) (true)
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_resolved
+ *
+ * Description:
+ *   Called when an ARP table entry is added or updated.  Any packet queued
+ *   for the IP address is marked to be sent on the next poll of its device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+void arp_pending_resolved(in_addr_t ipaddr);
+#else
+#  define arp_pending_resolved(i)
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_poll
+ *
+ * Description:
+ *   Send the packets queued on the device whose destination addresses have
+ *   been resolved.  Called from devif_poll().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+int arp_pending_poll(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback);
+#else
+#  define arp_pending_poll(d,c) (0)
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_timer
+ *
+ * Description:
+ *   Release the entries of addresses that have not been resolved within
+ *   the negative cache time.  Called from arp_timer().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+void arp_pending_timer(void);
+#else
+#  define arp_pending_timer()
+#endif
+
 #ifdef CONFIG_NET_ARP_DUMP
 void arp_dump(FAR struct arp_hdr_s *arp);
 #else
@@ -494,6 +558,10 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_delete(i)
 #  define arp_update(i,m);
 #  define arp_hdr_update(i,m);
+#  define arp_pending_out(d,i) (true)
+#  define arp_pending_resolved(i)
+#  define arp_pending_poll(d,c) (0)
+#  define arp_pending_timer()
 #  define arp_dump(arp)
 
 #endif /* CONFIG_NET_ARP */
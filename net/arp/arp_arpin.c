@@ -51,6 +51,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 
+#include "utils/utils.h"
 #include "arp/arp.h"
 
 #ifdef CONFIG_NET_ARP
@@ -63,33 +64,18 @@
 #define ARPBUF  ((struct arp_hdr_s *)&dev->d_buf[ETH_HDRLEN])
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: arp_arpin
+ * Name: arp_arpin_internal
  *
  * Description:
- *   This function should be called by the Ethernet device driver when an ARP
- *   packet has been received.   The function will act differently
- *   depending on the ARP packet type: if it is a reply for a request
- *   that we previously sent out, the ARP cache will be filled in with
- *   the values from the ARP reply.  If the incoming ARP packet is an ARP
- *   request for our IP address, an ARP reply packet is created and put
- *   into the d_buf[] buffer.
- *
- *   On entry, this function expects that an ARP packet with a prepended
- *   Ethernet header is present in the d_buf[] buffer and that the length of
- *   the packet is set in the d_len field.
- *
- *   When the function returns, the value of the field d_len indicates whether
- *   the device driver should send out the ARP reply packet or not. If d_len
- *   is zero, no packet should be sent; If d_len is non-zero, it contains the
- *   length of the outbound packet that is present in the d_buf[] buffer.
+ *   Implements arp_arpin() with the ARP table locked.
  *
  ****************************************************************************/
 
-void arp_arpin(FAR struct net_driver_s *dev)
+static void arp_arpin_internal(FAR struct net_driver_s *dev)
 {
   FAR struct arp_hdr_s *arp = ARPBUF;
   in_addr_t ipaddr;
@@ -159,4 +145,38 @@ void arp_arpin(FAR struct net_driver_s *dev)
     }
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_arpin
+ *
+ * Description:
+ *   This function should be called by the Ethernet device driver when an ARP
+ *   packet has been received.   The function will act differently
+ *   depending on the ARP packet type: if it is a reply for a request
+ *   that we previously sent out, the ARP cache will be filled in with
+ *   the values from the ARP reply.  If the incoming ARP packet is an ARP
+ *   request for our IP address, an ARP reply packet is created and put
+ *   into the d_buf[] buffer.
+ *
+ *   On entry, this function expects that an ARP packet with a prepended
+ *   Ethernet header is present in the d_buf[] buffer and that the length of
+ *   the packet is set in the d_len field.
+ *
+ *   When the function returns, the value of the field d_len indicates whether
+ *   the device driver should send out the ARP reply packet or not. If d_len
+ *   is zero, no packet should be sent; If d_len is non-zero, it contains the
+ *   length of the outbound packet that is present in the d_buf[] buffer.
+ *
+ ****************************************************************************/
+
+void arp_arpin(FAR struct net_driver_s *dev)
+{
+  net_protolock(NETLOCK_OTHER);
+  arp_arpin_internal(dev);
+  net_protounlock(NETLOCK_OTHER);
+}
+
 #endif /* CONFIG_NET_ARP */
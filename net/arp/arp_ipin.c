@@ -48,6 +48,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 
+#include "utils/utils.h"
 #include "arp/arp.h"
 
 #ifdef CONFIG_NET_ARP_IPIN
@@ -89,7 +90,9 @@ void arp_ipin(FAR struct net_driver_s *dev)
   srcipaddr = net_ip4addr_conv32(IPBUF->eh_srcipaddr);
   if (net_ipv4addr_maskcmp(srcipaddr, dev->d_ipaddr, dev->d_netmask))
     {
+      net_protolock(NETLOCK_OTHER);
       arp_hdr_update(IPBUF->eh_srcipaddr, ETHBUF->src);
+      net_protounlock(NETLOCK_OTHER);
     }
 }
 
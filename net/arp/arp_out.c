@@ -49,6 +49,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 
+#include "utils/utils.h"
 #include "route/route.h"
 #include "arp/arp.h"
 
@@ -104,37 +105,18 @@ static const uint8_t g_multicast_ethaddr[3] =
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: arp_out
+ * Name: arp_out_internal
  *
  * Description:
- *   This function should be called before sending out an IP packet. The
- *   function checks the destination IP address of the IP packet to see
- *   what Ethernet MAC address that should be used as a destination MAC
- *   address on the Ethernet.
- *
- *   If the destination IP address is in the local network (determined
- *   by logical ANDing of netmask and our IP address), the function
- *   checks the ARP cache to see if an entry for the destination IP
- *   address is found.  If so, an Ethernet header is pre-pended at the
- *   beginning of the packet and the function returns.
- *
- *   If no ARP cache entry is found for the destination IP address, the
- *   packet in the d_buf[] is replaced by an ARP request packet for the
- *   IP address. The IP packet is dropped and it is assumed that the
- *   higher level protocols (e.g., TCP) eventually will retransmit the
- *   dropped packet.
- *
- *   Upon return in either the case, a packet to be sent is present in the
- *   d_buf[] buffer and the d_len field holds the length of the Ethernet
- *   frame that should be transmitted.
+ *   Implements arp_out() with the ARP table locked.
  *
  ****************************************************************************/
 
-void arp_out(FAR struct net_driver_s *dev)
+static void arp_out_internal(FAR struct net_driver_s *dev)
 {
   FAR const struct arp_entry *tabptr = NULL;
   FAR struct eth_hdr_s       *peth   = ETHBUF;
@@ -231,14 +213,29 @@ void arp_out(FAR struct net_driver_s *dev)
       tabptr = arp_find(ipaddr);
       if (!tabptr)
         {
+          /* The destination address was not in our ARP table.  Queue a copy
+           * of the IP packet until the address is resolved, if so
+           * configured, and check whether an ARP request may be sent now.
+           */
+
+          if (!arp_pending_out(dev, ipaddr))
+            {
+              dev->d_len = 0;
+#ifdef CONFIG_NET_IOBTX
+              dev->d_sndiob = NULL;
+#endif
+              return;
+            }
+
            ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
-          /* The destination address was not in our ARP table, so we
-           * overwrite the IP packet with an ARP request.
-           */
+          /* Overwrite the IP packet with an ARP request. */
 
           arp_format(dev, ipaddr);
           arp_dump(ARPBUF);
+#ifdef CONFIG_NET_IOBTX
+          dev->d_sndiob = NULL;
+#endif
           return;
         }
 
@@ -254,4 +251,44 @@ void arp_out(FAR struct net_driver_s *dev)
   dev->d_len += ETH_HDRLEN;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_out
+ *
+ * Description:
+ *   This function should be called before sending out an IP packet. The
+ *   function checks the destination IP address of the IP packet to see
+ *   what Ethernet MAC address that should be used as a destination MAC
+ *   address on the Ethernet.
+ *
+ *   If the destination IP address is in the local network (determined
+ *   by logical ANDing of netmask and our IP address), the function
+ *   checks the ARP cache to see if an entry for the destination IP
+ *   address is found.  If so, an Ethernet header is pre-pended at the
+ *   beginning of the packet and the function returns.
+ *
+ *   If no ARP cache entry is found for the destination IP address, the
+ *   packet in the d_buf[] is replaced by an ARP request packet for the
+ *   IP address. The IP packet is dropped and it is assumed that the
+ *   higher level protocols (e.g., TCP) eventually will retransmit the
+ *   dropped packet.  With CONFIG_NET_ARP_PENDING, a copy of the packet is
+ *   kept and sent once the address is resolved; d_len is set to zero if
+ *   the ARP request is suppressed by the rate limit.
+ *
+ *   Upon return in either the case, a packet to be sent is present in the
+ *   d_buf[] buffer and the d_len field holds the length of the Ethernet
+ *   frame that should be transmitted.
+ *
+ ****************************************************************************/
+
+void arp_out(FAR struct net_driver_s *dev)
+{
+  net_protolock(NETLOCK_OTHER);
+  arp_out_internal(dev);
+  net_protounlock(NETLOCK_OTHER);
+}
+
 #endif /* CONFIG_NET_ARP */
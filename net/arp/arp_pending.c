@@ -0,0 +1,362 @@
+/****************************************************************************
+ * net/arp/arp_pending.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/net/iob.h>
+
+#include "netdev/netdev.h"
+#include "iob/iob.h"
+#include "arp/arp.h"
+
+#ifdef CONFIG_NET_ARP_PENDING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPBUF(dev) (&(dev)->d_buf[ETH_HDRLEN])
+
+#define ARP_REQTICKS MSEC2TICK(CONFIG_NET_ARP_REQINTERVAL)
+#define ARP_NEGTICKS SEC2TICK(CONFIG_NET_ARP_NEGTIME)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One IP address whose MAC address is being resolved.  The most recent
+ * packet sent to the address is held until the ARP response is received.
+ */
+
+struct arp_pending_s
+{
+  in_addr_t ap_ipaddr;                 /* The IP address being resolved */
+  FAR struct net_driver_s *ap_dev;     /* The device used to reach it */
+  systime_t ap_time;                   /* Time of the last ARP request */
+  uint8_t   ap_nreqs;                  /* Number of ARP requests sent */
+  bool      ap_resolved;               /* True: The packet may be sent */
+  FAR struct iob_s *ap_iob;            /* The queued IP packet (or NULL) */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct arp_pending_s g_arp_pending[CONFIG_NET_ARP_NPENDING];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_pending_free
+ *
+ * Description:
+ *   Release an entry and any packet queued on it.
+ *
+ ****************************************************************************/
+
+static void arp_pending_free(FAR struct arp_pending_s *pend)
+{
+  if (pend->ap_iob != NULL)
+    {
+      iob_free_chain(pend->ap_iob);
+    }
+
+  memset(pend, 0, sizeof(struct arp_pending_s));
+}
+
+/****************************************************************************
+ * Name: arp_pending_find
+ *
+ * Description:
+ *   Find the entry for the IP address.  If there is none, allocate a free
+ *   entry or, if there are no free entries, re-use the one with the oldest
+ *   ARP request.  NULL is returned only if alloc is false.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_pending_s *arp_pending_find(in_addr_t ipaddr,
+                                                  bool alloc)
+{
+  FAR struct arp_pending_s *pend;
+  FAR struct arp_pending_s *victim = NULL;
+  systime_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING; i++)
+    {
+      pend = &g_arp_pending[i];
+      if (pend->ap_ipaddr == ipaddr && ipaddr != 0)
+        {
+          return pend;
+        }
+
+      if (!alloc || (victim != NULL && victim->ap_ipaddr == 0))
+        {
+          continue;
+        }
+
+      if (victim == NULL || pend->ap_ipaddr == 0 ||
+          now - pend->ap_time > now - victim->ap_time)
+        {
+          victim = pend;
+        }
+    }
+
+  if (victim != NULL)
+    {
+      arp_pending_free(victim);
+      victim->ap_ipaddr = ipaddr;
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_pending_out
+ *
+ * Description:
+ *   Called from arp_out() when there is no ARP table entry for the
+ *   destination of the IP packet in d_buf.  A copy of the packet is
+ *   queued so that it can be sent as soon as the address is resolved.
+ *
+ * Input Parameters:
+ *   dev    - The device used to send the packet
+ *   ipaddr - The IP address to be resolved
+ *
+ * Returned Value:
+ *   True if the packet in d_buf should be replaced by an ARP request;
+ *   false if no request is needed now and nothing should be sent.  ARP
+ *   requests are sent no more often than once every
+ *   CONFIG_NET_ARP_REQINTERVAL milliseconds and, after
+ *   CONFIG_NET_ARP_MAXREQS unanswered requests, not at all for
+ *   CONFIG_NET_ARP_NEGTIME seconds.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool arp_pending_out(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct arp_pending_s *pend = arp_pending_find(ipaddr, true);
+  systime_t now = clock_systimer();
+  FAR struct iob_s *iob;
+
+  /* Nothing is queued or sent while the address is known to be
+   * unreachable.
+   */
+
+  if (pend->ap_nreqs >= CONFIG_NET_ARP_MAXREQS &&
+      now - pend->ap_time < ARP_NEGTICKS)
+    {
+      return false;
+    }
+
+  /* Hold the most recent packet.  A packet whose payload is in an I/O
+   * buffer chain owned by the sender (d_sndiob) is not copied; the
+   * higher level protocols will retransmit it.
+   */
+
+#ifdef CONFIG_NET_IOBTX
+  if (dev->d_sndiob == NULL)
+#endif
+    {
+      iob = iob_tryalloc_user(true, IOBUSER_NETDEV);
+      if (iob != NULL)
+        {
+          if (iob_trycopyin(iob, IPBUF(dev), dev->d_len, 0, true) ==
+              dev->d_len)
+            {
+              if (pend->ap_iob != NULL)
+                {
+                  iob_free_chain(pend->ap_iob);
+                }
+
+              pend->ap_iob = iob;
+              pend->ap_dev = dev;
+            }
+          else
+            {
+              iob_free_chain(iob);
+            }
+        }
+    }
+
+  /* Rate-limit the ARP requests. */
+
+  if (pend->ap_nreqs > 0 && now - pend->ap_time < ARP_REQTICKS)
+    {
+      return false;
+    }
+
+  /* Restart the count after the negative cache time has expired */
+
+  if (pend->ap_nreqs >= CONFIG_NET_ARP_MAXREQS)
+    {
+      pend->ap_nreqs = 0;
+    }
+
+  pend->ap_nreqs++;
+  pend->ap_time = now;
+  return true;
+}
+
+/****************************************************************************
+ * Name: arp_pending_resolved
+ *
+ * Description:
+ *   Called when an ARP table entry is added or updated.  Any packet queued
+ *   for the IP address is marked to be sent on the next poll of its device.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_pending_resolved(in_addr_t ipaddr)
+{
+  FAR struct arp_pending_s *pend = arp_pending_find(ipaddr, false);
+
+  if (pend != NULL)
+    {
+      if (pend->ap_iob != NULL)
+        {
+          pend->ap_resolved = true;
+          netdev_txnotify_dev(pend->ap_dev);
+        }
+      else
+        {
+          arp_pending_free(pend);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: arp_pending_poll
+ *
+ * Description:
+ *   Send the packets queued on the device whose destination addresses have
+ *   been resolved.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() and the network is locked.
+ *
+ ****************************************************************************/
+
+int arp_pending_poll(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback)
+{
+  FAR struct arp_pending_s *pend;
+  int bstop = false;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING && !bstop; i++)
+    {
+      pend = &g_arp_pending[i];
+      if (pend->ap_resolved && pend->ap_dev == dev)
+        {
+          /* Copy the IP packet into d_buf and release the entry */
+
+          dev->d_len = iob_copyout(IPBUF(dev), pend->ap_iob,
+                                   pend->ap_iob->io_pktlen, 0);
+#ifdef CONFIG_NET_IOBTX
+          dev->d_sndiob = NULL;
+#endif
+          arp_pending_free(pend);
+
+          /* Add the Ethernet header and call back into the driver */
+
+          arp_out(dev);
+          if (dev->d_len > 0)
+            {
+              bstop = callback(dev);
+            }
+        }
+    }
+
+  return bstop;
+}
+
+/****************************************************************************
+ * Name: arp_pending_timer
+ *
+ * Description:
+ *   Release the entries (and queued packets) of addresses that have not
+ *   been resolved within the negative cache time.  Called from arp_timer().
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_pending_timer(void)
+{
+  FAR struct arp_pending_s *pend;
+  systime_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING; i++)
+    {
+      pend = &g_arp_pending[i];
+      if (pend->ap_ipaddr != 0 && !pend->ap_resolved &&
+          now - pend->ap_time >= ARP_NEGTICKS)
+        {
+          arp_pending_free(pend);
+        }
+    }
+}
+
+#endif /* CONFIG_NET_ARP_PENDING */
@@ -62,6 +62,22 @@
 
 #ifdef CONFIG_NET_ARP
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_HASH
+#  ifndef CONFIG_NET_ARP_HASHSIZE
+#    define CONFIG_NET_ARP_HASHSIZE 16
+#  endif
+
+#  if (CONFIG_NET_ARP_HASHSIZE & (CONFIG_NET_ARP_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_ARP_HASHSIZE must be a power of two
+#  endif
+
+#  define ARP_HASHMASK (CONFIG_NET_ARP_HASHSIZE - 1)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -71,6 +87,106 @@
 static struct arp_entry g_arptable[CONFIG_NET_ARPTAB_SIZE];
 static uint8_t g_arptime;
 
+#ifdef CONFIG_NET_ARP_HASH
+/* The entries in use, hashed by IP address and chained through at_next */
+
+static FAR struct arp_entry *g_arphash[CONFIG_NET_ARP_HASHSIZE];
+
+/* Incremented on each successful lookup to order entries by last usage */
+
+static uint16_t g_arplru;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_HASH
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash table index for an IP address.  All four bytes of the
+ *   address are folded so that the result does not depend on the host
+ *   byte order.
+ *
+ ****************************************************************************/
+
+static inline unsigned int arp_hash(in_addr_t ipaddr)
+{
+  uint32_t key = (uint32_t)ipaddr;
+
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key & ARP_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: arp_hash_remove
+ *
+ * Description:
+ *   Remove an entry from its hash chain and mark it unused.
+ *
+ ****************************************************************************/
+
+static void arp_hash_remove(FAR struct arp_entry *tabptr)
+{
+  FAR struct arp_entry **link;
+
+  for (link = &g_arphash[arp_hash(tabptr->at_ipaddr)];
+       *link != NULL;
+       link = &(*link)->at_next)
+    {
+      if (*link == tabptr)
+        {
+          *link = tabptr->at_next;
+          break;
+        }
+    }
+
+  tabptr->at_ipaddr = 0;
+}
+#endif /* CONFIG_NET_ARP_HASH */
+
+/****************************************************************************
+ * Name: arp_lookup
+ *
+ * Description:
+ *   Find the ARP table entry in use for the IP address.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry *arp_lookup(in_addr_t ipaddr)
+{
+  FAR struct arp_entry *tabptr;
+#ifdef CONFIG_NET_ARP_HASH
+
+  for (tabptr = g_arphash[arp_hash(ipaddr)];
+       tabptr != NULL;
+       tabptr = tabptr->at_next)
+    {
+      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+#else
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+    {
+      tabptr = &g_arptable[i];
+      if (tabptr->at_ipaddr != 0 &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+#endif
+
+  return NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -91,6 +207,10 @@ void arp_reset(void)
     {
       memset(&g_arptable[i].at_ipaddr, 0, sizeof(in_addr_t));
     }
+
+#ifdef CONFIG_NET_ARP_HASH
+  memset(g_arphash, 0, sizeof(g_arphash));
+#endif
 }
 
 /****************************************************************************
@@ -117,9 +237,17 @@ void arp_timer(void)
       if (tabptr->at_ipaddr != 0 &&
           g_arptime - tabptr->at_time >= CONFIG_NET_ARP_MAXAGE)
         {
+#ifdef CONFIG_NET_ARP_HASH
+          arp_hash_remove(tabptr);
+#else
           tabptr->at_ipaddr = 0;
+#endif
         }
     }
+
+  /* Also age the entries waiting for ARP resolution */
+
+  arp_pending_timer();
 }
 
 /****************************************************************************
@@ -147,32 +275,19 @@ int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
   struct arp_entry *tabptr = NULL;
   int               i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in the ARP table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_lookup(ipaddr);
+  if (tabptr != NULL)
     {
-      tabptr = &g_arptable[i];
-
-      /* Only check those entries that are actually in use. */
-
-      if (tabptr->at_ipaddr != 0)
-        {
-          /* Check if the source IP address of the incoming packet matches
-           * the IP address in this ARP table entry.
-           */
+      /* An old entry found, update this and return. */
 
-          if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-            {
-              /* An old entry found, update this and return. */
-
-              memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-              tabptr->at_time = g_arptime;
-              return OK;
-            }
-        }
+      memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
+      tabptr->at_time = g_arptime;
+      arp_pending_resolved(ipaddr);
+      return OK;
     }
 
   /* If we get here, no existing ARP table entry was found, so we create one. */
@@ -188,26 +303,43 @@ int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
     }
 
   /* If no unused entry is found, we try to find the oldest entry and
-   * throw it away.
+   * throw it away.  With the hashed table, the entry that was least
+   * recently used rather than least recently updated is replaced.
    */
 
   if (i == CONFIG_NET_ARPTAB_SIZE)
     {
+#ifdef CONFIG_NET_ARP_HASH
+      uint16_t tmpage = 0;
+#else
       uint8_t tmpage = 0;
+#endif
       int j = 0;
 
       for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
         {
           tabptr = &g_arptable[i];
+#ifdef CONFIG_NET_ARP_HASH
+          if ((uint16_t)(g_arplru - tabptr->at_lru) > tmpage)
+            {
+              tmpage = g_arplru - tabptr->at_lru;
+              j = i;
+            }
+#else
           if (g_arptime - tabptr->at_time > tmpage)
             {
               tmpage = g_arptime - tabptr->at_time;
               j = i;
             }
+#endif
         }
 
       i = j;
       tabptr = &g_arptable[i];
+
+#ifdef CONFIG_NET_ARP_HASH
+      arp_hash_remove(tabptr);
+#endif
     }
 
   /* Now, i is the ARP table entry which we will fill with the new
@@ -217,6 +349,14 @@ int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
   tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_time = g_arptime;
+
+#ifdef CONFIG_NET_ARP_HASH
+  tabptr->at_lru  = g_arplru;
+  tabptr->at_next = g_arphash[arp_hash(ipaddr)];
+  g_arphash[arp_hash(ipaddr)] = tabptr;
+#endif
+
+  arp_pending_resolved(ipaddr);
   return OK;
 }
 
@@ -266,19 +406,46 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry *arp_find(in_addr_t ipaddr)
 {
-  FAR struct arp_entry *tabptr;
-  int i;
+  FAR struct arp_entry *tabptr = arp_lookup(ipaddr);
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+#ifdef CONFIG_NET_ARP_HASH
+  /* Remember when the entry was last used */
+
+  if (tabptr != NULL)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-        {
-          return tabptr;
-        }
+      tabptr->at_lru = ++g_arplru;
     }
+#endif
 
-  return NULL;
+  return tabptr;
+}
+
+/****************************************************************************
+ * Name: arp_delete
+ *
+ * Description:
+ *   Remove an IP association from the ARP table
+ *
+ * Input parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+void arp_delete(in_addr_t ipaddr)
+{
+  FAR struct arp_entry *tabptr = arp_lookup(ipaddr);
+
+  if (tabptr != NULL)
+    {
+#ifdef CONFIG_NET_ARP_HASH
+      arp_hash_remove(tabptr);
+#else
+      tabptr->at_ipaddr = 0;
+#endif
+    }
 }
 
 #endif /* CONFIG_NET_ARP */
@@ -0,0 +1,632 @@
+/****************************************************************************
+ * net/bench/net_bench.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/iob.h>
+#include <nuttx/net/bench.h>
+
+#ifdef CONFIG_NET_BENCHMARK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The receiving end stops when no data has been received for this long */
+
+#define NETBENCH_IDLE_SEC   1
+
+/* Number of empty datagrams sent to mark the end of a UDP run */
+
+#define NETBENCH_UDP_NEND   3
+
+#ifdef CONFIG_SMP
+#  define NETBENCH_NCPUS    CONFIG_SMP_NCPUS
+#else
+#  define NETBENCH_NCPUS    1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct netbench_state_s
+{
+  FAR struct netbench_s *bench;   /* The run in progress */
+  struct socket sock;             /* Listening (TCP) or bound (UDP) socket */
+  int result;                     /* Result of the loopback receiver */
+  sem_t done;                     /* Posted when the receiver exits */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct netbench_state_s g_netbench;
+static sem_t g_netbench_exclsem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_takesem
+ ****************************************************************************/
+
+static int netbench_takesem(FAR sem_t *sem)
+{
+  while (sem_wait(sem) < 0)
+    {
+      int errcode = get_errno();
+
+      DEBUGASSERT(errcode == EINTR);
+      if (errcode != EINTR)
+        {
+          return -errcode;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_rate
+ *
+ * Description:
+ *   Return count per second given the time in ticks over which it was
+ *   counted.
+ *
+ ****************************************************************************/
+
+static uint32_t netbench_rate(uint64_t count, systime_t ticks)
+{
+  uint64_t usec = TICK2USEC((uint64_t)ticks);
+
+  return usec > 0 ? (uint32_t)(count * USEC_PER_SEC / usec) : 0;
+}
+
+/****************************************************************************
+ * Name: netbench_cpuload
+ *
+ * Description:
+ *   Return the CPU load in units of 0.1% as shown by /proc/cpuload.
+ *
+ ****************************************************************************/
+
+static uint16_t netbench_cpuload(void)
+{
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
+  struct cpuload_s idle;
+  int cpu;
+
+  /* The IDLE thread of CPU n has PID n */
+
+  cpuload.total  = 0;
+  cpuload.active = 0;
+
+  for (cpu = 0; cpu < NETBENCH_NCPUS; cpu++)
+    {
+      if (clock_cpuload(cpu, &idle) == OK)
+        {
+          cpuload.total   = idle.total;
+          cpuload.active += idle.active;
+        }
+    }
+#else
+  if (clock_cpuload(0, &cpuload) < 0)
+    {
+      return 0;
+    }
+#endif
+
+  if (cpuload.total > 0 && cpuload.active <= cpuload.total)
+    {
+      return 1000 - (uint16_t)(((uint64_t)1000 * cpuload.active) /
+                               cpuload.total);
+    }
+#endif
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: netbench_open
+ *
+ * Description:
+ *   Create the socket of the receiving end:  A listening TCP socket or a
+ *   bound UDP socket.
+ *
+ ****************************************************************************/
+
+static int netbench_open(FAR struct netbench_s *bench,
+                         FAR const struct sockaddr_in *addr,
+                         FAR struct socket *sock)
+{
+  int type = bench->proto == NETBENCH_TCP ? SOCK_STREAM : SOCK_DGRAM;
+  int errcode;
+
+  if (psock_socket(PF_INET, type, 0, sock) < 0)
+    {
+      return -get_errno();
+    }
+
+  if (psock_bind(sock, (FAR const struct sockaddr *)addr,
+                 sizeof(struct sockaddr_in)) < 0)
+    {
+      goto errout_with_sock;
+    }
+
+  if (bench->proto == NETBENCH_TCP && psock_listen(sock, 1) < 0)
+    {
+      goto errout_with_sock;
+    }
+
+  return OK;
+
+errout_with_sock:
+  errcode = get_errno();
+  (void)psock_close(sock);
+  return -errcode;
+}
+
+/****************************************************************************
+ * Name: netbench_receive
+ *
+ * Description:
+ *   The receiving end.  Accept one connection (TCP) and receive until the
+ *   end of the run.
+ *
+ ****************************************************************************/
+
+static int netbench_receive(FAR struct netbench_s *bench,
+                            FAR struct socket *sock)
+{
+  struct socket conn;
+  FAR struct socket *data = sock;
+  struct timeval tv;
+  FAR uint8_t *buffer;
+  systime_t first = 0;
+  systime_t last = 0;
+  ssize_t nrecvd;
+  int ret = OK;
+
+  buffer = (FAR uint8_t *)kmm_malloc(bench->bufsize);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+#ifdef CONFIG_NET_TCP
+  if (bench->proto == NETBENCH_TCP)
+    {
+      if (psock_accept(sock, NULL, NULL, &conn) < 0)
+        {
+          ret = -get_errno();
+          goto errout_with_buffer;
+        }
+
+      data = &conn;
+    }
+#endif
+
+  tv.tv_sec  = NETBENCH_IDLE_SEC;
+  tv.tv_usec = 0;
+  (void)psock_setsockopt(data, SOL_SOCKET, SO_RCVTIMEO, &tv,
+                         sizeof(struct timeval));
+
+  for (; ; )
+    {
+      nrecvd = psock_recv(data, buffer, bench->bufsize, 0);
+      if (nrecvd < 0)
+        {
+          int errcode = get_errno();
+
+          /* A server waits for as long as it takes for the first data */
+
+          if (errcode == EAGAIN && bench->rxpackets == 0 &&
+              bench->mode == NETBENCH_SERVER)
+            {
+              continue;
+            }
+
+          /* Otherwise a timeout or a signal ends the run */
+
+          if (errcode != EAGAIN && errcode != EINTR)
+            {
+              ret = -errcode;
+            }
+
+          break;
+        }
+
+      /* End of file (TCP) or the end marker (UDP) */
+
+      if (nrecvd == 0)
+        {
+          break;
+        }
+
+      last = clock_systimer();
+      if (bench->rxpackets == 0)
+        {
+          first = last;
+        }
+
+      bench->rxbytes += nrecvd;
+      bench->rxpackets++;
+    }
+
+  bench->rxbps = netbench_rate(bench->rxbytes, last - first);
+  bench->rxpps = netbench_rate(bench->rxpackets, last - first);
+
+  if (data != sock)
+    {
+      (void)psock_close(data);
+    }
+
+#ifdef CONFIG_NET_TCP
+errout_with_buffer:
+#endif
+  kmm_free(buffer);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_send
+ *
+ * Description:
+ *   The sending end.  Send for the duration of the run.  A UDP send that
+ *   fails for lack of buffers is not counted but does not end the run.
+ *
+ ****************************************************************************/
+
+static int netbench_send(FAR struct netbench_s *bench,
+                         FAR const struct sockaddr_in *addr)
+{
+  struct socket sock;
+  FAR uint8_t *buffer;
+  systime_t duration = SEC2TICK(bench->duration);
+  systime_t start;
+  systime_t first = 0;
+  systime_t last = 0;
+  ssize_t nsent;
+  int type = bench->proto == NETBENCH_TCP ? SOCK_STREAM : SOCK_DGRAM;
+  int ret = OK;
+  int i;
+
+  buffer = (FAR uint8_t *)kmm_malloc(bench->bufsize);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < bench->bufsize; i++)
+    {
+      buffer[i] = (uint8_t)i;
+    }
+
+  if (psock_socket(PF_INET, type, 0, &sock) < 0)
+    {
+      ret = -get_errno();
+      goto errout_with_buffer;
+    }
+
+  if (psock_connect(&sock, (FAR const struct sockaddr *)addr,
+                    sizeof(struct sockaddr_in)) < 0)
+    {
+      ret = -get_errno();
+      goto errout_with_sock;
+    }
+
+  start = clock_systimer();
+  while (clock_systimer() - start < duration)
+    {
+      nsent = psock_send(&sock, buffer, bench->bufsize, 0);
+      if (nsent < 0)
+        {
+          int errcode = get_errno();
+
+          if (bench->proto == NETBENCH_UDP &&
+              (errcode == EAGAIN || errcode == ENOBUFS ||
+               errcode == ENOMEM))
+            {
+              continue;
+            }
+
+          ret = -errcode;
+          break;
+        }
+
+      last = clock_systimer();
+      if (bench->txpackets == 0)
+        {
+          first = last;
+        }
+
+      bench->txbytes += nsent;
+      bench->txpackets++;
+    }
+
+  bench->txbps = netbench_rate(bench->txbytes, last - first);
+  bench->txpps = netbench_rate(bench->txpackets, last - first);
+
+  /* Tell a UDP receiver that the run is over.  If these are lost, the
+   * receiver stops when it has received nothing for a while.
+   */
+
+  if (bench->proto == NETBENCH_UDP)
+    {
+      for (i = 0; i < NETBENCH_UDP_NEND; i++)
+        {
+          (void)psock_send(&sock, buffer, 0, 0);
+        }
+    }
+
+errout_with_sock:
+  (void)psock_close(&sock);
+
+errout_with_buffer:
+  kmm_free(buffer);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_receiver
+ *
+ * Description:
+ *   The receiving end of a loopback run.
+ *
+ ****************************************************************************/
+
+static int netbench_receiver(int argc, FAR char *argv[])
+{
+  FAR struct netbench_state_s *priv = &g_netbench;
+
+  priv->result = netbench_receive(priv->bench, &priv->sock);
+  sem_post(&priv->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: netbench_loopback
+ *
+ * Description:
+ *   Run both ends:  The receiving end in a kernel thread, the sending end
+ *   in the caller.
+ *
+ ****************************************************************************/
+
+static int netbench_loopback(FAR struct netbench_s *bench,
+                             FAR const struct sockaddr_in *addr)
+{
+  FAR struct netbench_state_s *priv = &g_netbench;
+  int pid;
+  int ret;
+
+  priv->bench  = bench;
+  priv->result = OK;
+  sem_init(&priv->done, 0, 0);
+
+  ret = netbench_open(bench, addr, &priv->sock);
+  if (ret < 0)
+    {
+      goto errout_with_sem;
+    }
+
+  pid = kernel_thread("netbench", CONFIG_NET_BENCHMARK_PRIORITY,
+                      CONFIG_NET_BENCHMARK_STACKSIZE, netbench_receiver,
+                      (FAR char * const *)NULL);
+  if (pid < 0)
+    {
+      ret = -get_errno();
+      nerr("ERROR: Failed to start the receiver: %d\n", ret);
+      goto errout_with_sock;
+    }
+
+  ret = netbench_send(bench, addr);
+
+#ifndef CONFIG_DISABLE_SIGNALS
+  /* If no connection was made, the receiver is still waiting in accept() */
+
+  if (ret < 0 && bench->proto == NETBENCH_TCP && bench->txpackets == 0)
+    {
+      (void)kill(pid, SIGUSR1);
+    }
+#endif
+
+  (void)netbench_takesem(&priv->done);
+  if (ret == OK)
+    {
+      ret = priv->result;
+    }
+
+errout_with_sock:
+  (void)psock_close(&priv->sock);
+
+errout_with_sem:
+  sem_destroy(&priv->done);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_run
+ *
+ * Description:
+ *   Run the network throughput benchmark.  See include/nuttx/net/bench.h.
+ *
+ ****************************************************************************/
+
+int netbench_run(FAR struct netbench_s *bench)
+{
+  struct sockaddr_in addr;
+  int ret;
+
+  if (bench == NULL || bench->mode > NETBENCH_CLIENT)
+    {
+      return -EINVAL;
+    }
+
+#ifndef CONFIG_NET_TCP
+  if (bench->proto == NETBENCH_TCP)
+    {
+      return -EPROTONOSUPPORT;
+    }
+#endif
+
+#ifndef CONFIG_NET_UDP
+  if (bench->proto == NETBENCH_UDP)
+    {
+      return -EPROTONOSUPPORT;
+    }
+#endif
+
+  if (bench->proto != NETBENCH_TCP && bench->proto != NETBENCH_UDP)
+    {
+      return -EPROTONOSUPPORT;
+    }
+
+  /* Apply the defaults */
+
+  if (bench->port == 0)
+    {
+      bench->port = CONFIG_NET_BENCHMARK_PORT;
+    }
+
+  if (bench->bufsize == 0)
+    {
+      bench->bufsize = CONFIG_NET_BENCHMARK_BUFSIZE;
+    }
+
+  if (bench->duration == 0)
+    {
+      bench->duration = CONFIG_NET_BENCHMARK_DURATION;
+    }
+
+  if (bench->addr == INADDR_ANY && bench->mode == NETBENCH_LOOPBACK)
+    {
+      bench->addr = HTONL(INADDR_LOOPBACK);
+    }
+  else if (bench->addr == INADDR_ANY && bench->mode == NETBENCH_CLIENT)
+    {
+      return -EDESTADDRREQ;
+    }
+
+  memset(&addr, 0, sizeof(struct sockaddr_in));
+  addr.sin_family      = AF_INET;
+  addr.sin_port        = HTONS(bench->port);
+  addr.sin_addr.s_addr = bench->addr;
+
+  ret = netbench_takesem(&g_netbench_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  bench->txbytes   = 0;
+  bench->txpackets = 0;
+  bench->txbps     = 0;
+  bench->txpps     = 0;
+  bench->rxbytes   = 0;
+  bench->rxpackets = 0;
+  bench->rxbps     = 0;
+  bench->rxpps     = 0;
+
+#ifdef CONFIG_IOB_HIGHWATER
+  (void)iob_highwater(true);
+#endif
+
+  switch (bench->mode)
+    {
+      case NETBENCH_LOOPBACK:
+        ret = netbench_loopback(bench, &addr);
+        break;
+
+      case NETBENCH_SERVER:
+        {
+          struct socket sock;
+
+          ret = netbench_open(bench, &addr, &sock);
+          if (ret == OK)
+            {
+              ret = netbench_receive(bench, &sock);
+              (void)psock_close(&sock);
+            }
+        }
+        break;
+
+      default:
+        ret = netbench_send(bench, &addr);
+        break;
+    }
+
+  bench->cpuload = netbench_cpuload();
+#ifdef CONFIG_IOB_HIGHWATER
+  bench->iobhwm  = (uint16_t)iob_highwater(false);
+#else
+  bench->iobhwm  = 0;
+#endif
+
+  sem_post(&g_netbench_exclsem);
+  return ret;
+}
+
+#endif /* CONFIG_NET_BENCHMARK */
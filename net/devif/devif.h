@@ -53,6 +53,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -200,6 +201,19 @@
 #define TCP_DISCONN_EVENTS \
   (TCP_CLOSE | TCP_ABORT | TCP_TIMEDOUT | NETDEV_DOWN)
 
+/* Connection types in struct devif_txpend_s */
+
+#define DEVIF_TXPEND_PKT 0
+#define DEVIF_TXPEND_TCP 1
+#define DEVIF_TXPEND_UDP 2
+
+#ifndef CONFIG_NET_TXPENDING
+#  define devif_txpend_add(dev,txp,type)
+#  define devif_txpend_remove(txp)
+#  define devif_txpend_flush(dev)
+#  define devif_txpend_setprio(txp,prio)
+#endif
+
 /* IPv4/IPv6 Helpers */
 
 #ifdef CONFIG_NET_IPv4
@@ -234,6 +248,10 @@
  */
 
 struct net_driver_s;       /* Forward reference */
+#ifdef CONFIG_NET_TXPENDING
+struct devif_txpend_s;     /* Forward reference */
+#endif
+
 struct devif_callback_s
 {
   FAR struct devif_callback_s *nxtconn;
@@ -465,6 +483,31 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *buf,
                     unsigned int len, unsigned int offset);
 #endif
 
+/****************************************************************************
+ * Name: devif_iob_claim
+ *
+ * Description:
+ *   Take ownership of the I/O buffer that the driver received the current
+ *   packet into, trimmed so that it holds only the buflen bytes beginning
+ *   at buffer.  The driver is given a new I/O buffer holding a copy of the
+ *   packet headers in exchange.
+ *
+ * Returned Value:
+ *   The claimed I/O buffer; NULL if the packet was not received into an
+ *   I/O buffer, if buffer does not lie in that I/O buffer, or if no
+ *   replacement I/O buffer is available.  The caller must then copy the
+ *   data as usual.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IOBRX
+FAR struct iob_s *devif_iob_claim(FAR struct net_driver_s *dev,
+                                  FAR uint8_t *buffer, uint16_t buflen);
+#endif
+
 /****************************************************************************
  * Name: devif_pkt_send
  *
@@ -486,6 +529,119 @@ void devif_pkt_send(FAR struct net_driver_s *dev, FAR const void *buf,
                     unsigned int len);
 #endif
 
+/****************************************************************************
+ * Function: ipv4_forward and ipv6_forward
+ *
+ * Description:
+ *   Called from ipv4_input() and ipv6_input() for each received packet.  A
+ *   packet addressed to another host is queued on the egress device
+ *   selected by its destination address.
+ *
+ * Returned Value:
+ *   OK if the packet was forwarded; -ENOENT if the packet is not to be
+ *   forwarded and should be processed normally.  Any other negated errno
+ *   value means that the packet must be dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv4)
+int ipv4_forward(FAR struct net_driver_s *dev);
+#endif
+
+#if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv6)
+int ipv6_forward(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Function: devif_forward_poll
+ *
+ * Description:
+ *   Send the packets queued on the device by ipv4_forward() and
+ *   ipv6_forward().  Called from devif_poll().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD
+int devif_forward_poll(FAR struct net_driver_s *dev,
+                       devif_poll_callback_t callback);
+#endif
+
+/****************************************************************************
+ * Function: devif_txpend_add
+ *
+ * Description:
+ *   Queue a connection that has data to send in d_txpend of the device.
+ *   The next devif_poll() of the device will poll the connection.  Nothing
+ *   is done if the connection is already queued.
+ *
+ * Parameters:
+ *   dev  - The device that will send the data
+ *   txp  - The devif_txpend_s structure of the connection
+ *   type - The connection type:  DEVIF_TXPEND_TCP, _UDP or _PKT
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TXPENDING
+void devif_txpend_add(FAR struct net_driver_s *dev,
+                      FAR struct devif_txpend_s *txp, uint8_t type);
+#endif
+
+/****************************************************************************
+ * Function: devif_txpend_remove
+ *
+ * Description:
+ *   Remove a connection from the d_txpend queue of its device (if it is
+ *   queued).  Must be called before the connection is freed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TXPENDING
+void devif_txpend_remove(FAR struct devif_txpend_s *txp);
+#endif
+
+/****************************************************************************
+ * Function: devif_txpend_flush
+ *
+ * Description:
+ *   Remove all connections from the d_txpend queue of a device.  Called when
+ *   the device is unregistered.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TXPENDING
+void devif_txpend_flush(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Function: devif_txpend_setprio
+ *
+ * Description:
+ *   Set the priority class of a connection from an SO_PRIORITY value.
+ *   Values beyond the highest class select the highest class.  If the
+ *   connection is queued, it moves to the end of the queue of its new
+ *   class.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TXPENDING
+void devif_txpend_setprio(FAR struct devif_txpend_s *txp, int prio);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -385,13 +385,13 @@ uint16_t devif_conn_event(FAR struct net_driver_s *dev, void *pvconn,
                           uint16_t flags, FAR struct devif_callback_s *list)
 {
   FAR struct devif_callback_s *next;
-  net_lock_t save;
 
   /* Loop for each callback in the list and while there are still events
-   * set in the flags set.
+   * set in the flags set.  The caller holds the network lock (or, with
+   * CONFIG_NET_FINELOCK, the lock of the device and of the protocol that
+   * owns the list) so the list is not locked again here.
    */
 
-  save = net_lock();
   while (list && flags)
     {
       /* Save the pointer to the next callback in the lists.  This is done
@@ -419,7 +419,6 @@ uint16_t devif_conn_event(FAR struct net_driver_s *dev, void *pvconn,
       list = next;
     }
 
-  net_unlock(save);
   return flags;
 }
 
@@ -450,13 +449,11 @@ uint16_t devif_dev_event(FAR struct net_driver_s *dev, void *pvconn,
 {
   FAR struct devif_callback_s *cb;
   FAR struct devif_callback_s *next;
-  net_lock_t save;
 
   /* Loop for each callback in the list and while there are still events
    * set in the flags set.
    */
 
-  save = net_lock();
   for (cb = dev->d_devcb; cb != NULL && flags != 0; cb = next)
     {
       /* Save the pointer to the next callback in the lists.  This is done
@@ -484,7 +481,6 @@ uint16_t devif_dev_event(FAR struct net_driver_s *dev, void *pvconn,
       cb = next;
     }
 
-  net_unlock(save);
   return flags;
 }
 
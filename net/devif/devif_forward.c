@@ -0,0 +1,109 @@
+/****************************************************************************
+ * net/devif/devif_forward.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <net/if.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/iob.h>
+#include <nuttx/net/ip.h>
+
+#include "devif/devif.h"
+
+#ifdef CONFIG_NET_IPFORWARD
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: devif_forward_poll
+ *
+ * Description:
+ *   Send the packets that have been queued on the device by ipv4_forward()
+ *   and ipv6_forward().  Each packet is copied into d_buf (after the link
+ *   layer header) and passed to the driver's poll callback just as a
+ *   packet generated locally would be.  The driver then adds the link
+ *   layer header (e.g., with arp_out()) as usual.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() and the network is locked.
+ *
+ ****************************************************************************/
+
+int devif_forward_poll(FAR struct net_driver_s *dev,
+                       devif_poll_callback_t callback)
+{
+  FAR uint8_t *buf = &dev->d_buf[NET_LL_HDRLEN(dev)];
+  FAR struct iob_s *iob;
+  int bstop = false;
+
+  while (!bstop && (iob = iob_remove_queue(&dev->d_fwdq)) != NULL)
+    {
+      dev->d_len    = iob_copyout(buf, iob, iob->io_pktlen, 0);
+      dev->d_sndlen = 0;
+#ifdef CONFIG_NET_IOBTX
+      dev->d_sndiob = NULL;
+#endif
+      iob_free_chain(iob);
+
+      /* Let the driver know which link layer header to use */
+
+      if ((buf[0] & 0xf0) == 0x40)
+        {
+          IFF_SET_IPv4(dev->d_flags);
+        }
+      else
+        {
+          IFF_SET_IPv6(dev->d_flags);
+        }
+
+      bstop = callback(dev);
+    }
+
+  return bstop;
+}
+
+#endif /* CONFIG_NET_IPFORWARD */
@@ -0,0 +1,170 @@
+/****************************************************************************
+ * net/devif/devif_iobclaim.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/iob.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+#include "iob/iob.h"
+
+#ifdef CONFIG_NET_IOBRX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The driver receives an entire packet into a single I/O buffer */
+
+#if CONFIG_IOB_BUFSIZE < (MAX_NET_DEV_MTU + CONFIG_NET_GUARDSIZE)
+#  error CONFIG_IOB_BUFSIZE too small for CONFIG_NET_IOBRX
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_iob_claim
+ *
+ * Description:
+ *   Take ownership of the I/O buffer that the driver received the current
+ *   packet into, trimmed so that it holds only the buflen bytes beginning
+ *   at buffer.  The driver is given a new I/O buffer holding a copy of the
+ *   packet headers in exchange.
+ *
+ * Input Parameters:
+ *   dev    - The device that received the packet
+ *   buffer - The start of the data to be claimed (normally within the
+ *            application data of the packet)
+ *   buflen - The number of bytes to claim
+ *
+ * Returned Value:
+ *   The claimed I/O buffer; NULL if the packet was not received into an
+ *   I/O buffer, if buffer does not lie in that I/O buffer, or if no
+ *   replacement I/O buffer is available.  The caller must then copy the
+ *   data as usual.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *devif_iob_claim(FAR struct net_driver_s *dev,
+                                  FAR uint8_t *buffer, uint16_t buflen)
+{
+  FAR struct iob_s *iob;
+  FAR struct iob_s *newiob;
+  unsigned int offset;
+
+  DEBUGASSERT(dev != NULL && buffer != NULL);
+
+  /* Was the packet received into an I/O buffer?  And does the data lie
+   * within that buffer?
+   */
+
+  iob = dev->d_iob;
+  if (iob == NULL || buffer < iob->io_data ||
+      buffer + buflen > &iob->io_data[CONFIG_IOB_BUFSIZE])
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(dev->d_buf == iob->io_data);
+
+  /* Get a replacement I/O buffer for the driver (throttled and accounted
+   * to TCP read-ahead, just as if we were allocating a buffer to copy the
+   * data into).
+   */
+
+  newiob = iob_tryalloc_user(true, IOBUSER_TCP_RX);
+  if (newiob == NULL)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_IOB_QUOTA
+  /* The claimed buffer now belongs to TCP read-ahead and the new one to the
+   * driver.  Swapping the owners leaves the counts as they were charged.
+   */
+
+  newiob->io_user = iob->io_user;
+  iob->io_user    = IOBUSER_TCP_RX;
+#endif
+
+  /* Preserve everything in front of the claimed data, i.e., the packet
+   * headers.  The network may still need these to generate a response.
+   */
+
+  offset = buffer - iob->io_data;
+  memcpy(newiob->io_data, iob->io_data, offset);
+
+  /* Hand the new I/O buffer to the driver, relocating the pointers into
+   * the packet buffer.
+   */
+
+  dev->d_appdata = newiob->io_data + (dev->d_appdata - iob->io_data);
+#ifdef CONFIG_NET_TCPURGDATA
+  if (dev->d_urgdata != NULL)
+    {
+      dev->d_urgdata = newiob->io_data + (dev->d_urgdata - iob->io_data);
+    }
+#endif
+
+  dev->d_buf     = newiob->io_data;
+  dev->d_iob     = newiob;
+
+  /* Trim the claimed I/O buffer so that it holds only the data */
+
+  iob->io_flink  = NULL;
+  iob->io_offset = offset;
+  iob->io_len    = buflen;
+  iob->io_pktlen = buflen;
+
+  ninfo("Claimed %u bytes at offset %u\n", buflen, offset);
+  return iob;
+}
+
+#endif /* CONFIG_NET_IOBRX */
@@ -41,6 +41,7 @@
 
 #include <string.h>
 #include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/net/iob.h>
@@ -99,7 +100,32 @@
 void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                     unsigned int len, unsigned int offset)
 {
+#ifdef CONFIG_NET_TCP_TSO
+  DEBUGASSERT(dev && len > 0 &&
+              (len < NET_DEV_MTU(dev) ||
+               (dev->d_tsomax > 0 && IFF_IS_TXIOB(dev->d_flags))));
+
+  /* The caller selects segmentation after the data is in place */
+
+  dev->d_tsomss = 0;
+#else
   DEBUGASSERT(dev && len > 0 && len < NET_DEV_MTU(dev));
+#endif
+
+#ifdef CONFIG_NET_IOBTX
+  /* If the driver can gather the payload from the I/O buffer chain, then
+   * just remember where the data is.
+   */
+
+  if (IFF_IS_TXIOB(dev->d_flags))
+    {
+      dev->d_sndiob     = iob;
+      dev->d_sndioboffs = offset;
+      dev->d_sndioblen  = len;
+      dev->d_sndlen     = len;
+      return;
+    }
+#endif
 
   /* Copy the data from the I/O buffer chain to the device buffer */
 
@@ -113,5 +139,90 @@ void devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 #endif
 }
 
+/****************************************************************************
+ * Function: devif_iob_txsegs
+ *
+ * Description:
+ *   Drivers that set IFF_TXIOB may call this function from their transmit
+ *   logic to get the list of segments that make up the outgoing packet:
+ *   The headers in d_buf followed by the pieces of the payload in the I/O
+ *   buffer chain d_sndiob (if any).  Each segment may then be assigned to
+ *   one transmit descriptor.
+ *
+ * Parameters:
+ *   dev   - The device driver structure holding the outgoing packet
+ *   segs  - The array of segment descriptions to be filled in
+ *   nsegs - The number of entries in segs
+ *
+ * Return:
+ *   The number of segments on success; -E2BIG if the packet requires more
+ *   than nsegs segments.
+ *
+ * Assumptions:
+ *   Called from the interrupt level or, at a minimum, with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IOBTX
+int devif_iob_txsegs(FAR struct net_driver_s *dev,
+                     FAR struct netdev_txseg_s *segs, int nsegs)
+{
+  FAR struct iob_s *iob;
+  unsigned int offset;
+  unsigned int remaining;
+  unsigned int ncopy;
+  int n;
+
+  DEBUGASSERT(dev != NULL && segs != NULL && nsegs > 0);
+
+  /* The first segment is always the portion of the packet in d_buf */
+
+  iob = dev->d_sndiob;
+  remaining = (iob != NULL) ? dev->d_sndioblen : 0;
+
+  DEBUGASSERT(dev->d_len >= remaining);
+  segs[0].ts_data = dev->d_buf;
+  segs[0].ts_len  = dev->d_len - remaining;
+  n               = 1;
+
+  /* Skip over I/O buffers that precede the payload */
+
+  offset = dev->d_sndioboffs;
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  /* Then add one segment for each I/O buffer holding payload */
+
+  while (remaining > 0 && iob != NULL)
+    {
+      if (n >= nsegs)
+        {
+          return -E2BIG;
+        }
+
+      ncopy = iob->io_len - offset;
+      if (ncopy > remaining)
+        {
+          ncopy = remaining;
+        }
+
+      segs[n].ts_data = &iob->io_data[iob->io_offset + offset];
+      segs[n].ts_len  = ncopy;
+      n++;
+
+      remaining -= ncopy;
+      offset     = 0;
+      iob        = iob->io_flink;
+    }
+
+  DEBUGASSERT(remaining == 0);
+  return n;
+}
+#endif /* CONFIG_NET_IOBTX */
+
 #endif /* CONFIG_NET_IOB */
 
@@ -109,6 +109,10 @@ void devif_pkt_send(FAR struct net_driver_s *dev, FAR const void *buf,
 
   dev->d_len    = len;
   dev->d_sndlen = len;
+
+#ifdef CONFIG_NET_TCP_TSO
+  dev->d_tsomss = 0;
+#endif
 }
 
 #endif /* CONFIG_NET_PKT */
@@ -40,9 +40,13 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stddef.h>
+#include <stdbool.h>
+#include <queue.h>
 #include <debug.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 
@@ -55,6 +59,18 @@
 #include "icmp/icmp.h"
 #include "icmpv6/icmpv6.h"
 #include "igmp/igmp.h"
+#include "6lowpan/6lowpan.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Maximum number of segments sent from one TCP connection per poll */
+
+#ifndef CONFIG_NET_TCP_POLL_BATCH
+#  define CONFIG_NET_TCP_POLL_BATCH 1
+#endif
 
 /****************************************************************************
  * Public Data
@@ -89,6 +105,7 @@ static int devif_poll_pkt_connections(FAR struct net_driver_s *dev,
 
   /* Traverse all of the allocated packet connections and perform the poll action */
 
+  net_protolock(NETLOCK_OTHER);
   while (!bstop && (pkt_conn = pkt_nextconn(pkt_conn)))
     {
       /* Perform the packet TX poll */
@@ -100,6 +117,7 @@ static int devif_poll_pkt_connections(FAR struct net_driver_s *dev,
       bstop = callback(dev);
     }
 
+  net_protounlock(NETLOCK_OTHER);
   return bstop;
 }
 #endif /* CONFIG_NET_PKT */
@@ -116,13 +134,18 @@ static int devif_poll_pkt_connections(FAR struct net_driver_s *dev,
 static inline int devif_poll_icmp(FAR struct net_driver_s *dev,
                                   devif_poll_callback_t callback)
 {
+  int bstop;
+
   /* Perform the ICMP poll */
 
+  net_protolock(NETLOCK_OTHER);
   icmp_poll(dev);
 
   /* Call back into the driver */
 
-  return callback(dev);
+  bstop = callback(dev);
+  net_protounlock(NETLOCK_OTHER);
+  return bstop;
 }
 #endif /* CONFIG_NET_ICMP && CONFIG_NET_ICMP_PING */
 
@@ -138,13 +161,18 @@ static inline int devif_poll_icmp(FAR struct net_driver_s *dev,
 static inline int devif_poll_icmpv6(FAR struct net_driver_s *dev,
                                     devif_poll_callback_t callback)
 {
+  int bstop;
+
   /* Perform the ICMPv6 poll */
 
+  net_protolock(NETLOCK_OTHER);
   icmpv6_poll(dev);
 
   /* Call back into the driver */
 
-  return callback(dev);
+  bstop = callback(dev);
+  net_protounlock(NETLOCK_OTHER);
+  return bstop;
 }
 #endif /* CONFIG_NET_ICMPv6_PING || CONFIG_NET_ICMPv6_NEIGHBOR*/
 
@@ -164,13 +192,18 @@ static inline int devif_poll_icmpv6(FAR struct net_driver_s *dev,
 static inline int devif_poll_igmp(FAR struct net_driver_s *dev,
                                   devif_poll_callback_t callback)
 {
+  int bstop;
+
   /* Perform the IGMP TX poll */
 
+  net_protolock(NETLOCK_OTHER);
   igmp_poll(dev);
 
   /* Call back into the driver */
 
-  return callback(dev);
+  bstop = callback(dev);
+  net_protounlock(NETLOCK_OTHER);
+  return bstop;
 }
 #endif /* CONFIG_NET_IGMP */
 
@@ -191,12 +224,29 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
                                       devif_poll_callback_t callback)
 {
   FAR struct udp_conn_s *conn = NULL;
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  bool sent;
+#endif
   int bstop = 0;
 
   /* Traverse all of the allocated UDP connections and perform the poll action */
 
+  net_protolock(NETLOCK_UDP);
   while (!bstop && (conn = udp_nextconn(conn)))
     {
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      /* Send all buffered datagrams of the connection while the driver
+       * accepts them.
+       */
+
+      do
+        {
+          udp_poll(dev, conn);
+          sent  = (dev->d_len > 0);
+          bstop = callback(dev);
+        }
+      while (!bstop && sent && !sq_empty(&conn->write_q));
+#else
       /* Perform the UDP TX poll */
 
       udp_poll(dev, conn);
@@ -204,8 +254,10 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
       /* Call back into the driver */
 
       bstop = callback(dev);
+#endif
     }
 
+  net_protounlock(NETLOCK_UDP);
   return bstop;
 }
 #endif /* CONFIG_NET_UDP */
@@ -228,11 +280,35 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn  = NULL;
   int bstop = 0;
+#if CONFIG_NET_TCP_POLL_BATCH > 1
+  bool sent;
+  int nsegs;
+#endif
 
   /* Traverse all of the active TCP connections and perform the poll action */
 
+  net_protolock(NETLOCK_TCP);
   while (!bstop && (conn = tcp_nextconn(conn)))
     {
+#if CONFIG_NET_TCP_POLL_BATCH > 1
+      /* Keep polling the same connection as long as it produces data and
+       * the driver can accept more packets.
+       */
+
+      nsegs = 0;
+      do
+        {
+          /* Perform the TCP TX poll */
+
+          tcp_poll(dev, conn);
+          sent = (dev->d_sndlen > 0);
+
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+        }
+      while (!bstop && sent && ++nsegs < CONFIG_NET_TCP_POLL_BATCH);
+#else
       /* Perform the TCP TX poll */
 
       tcp_poll(dev, conn);
@@ -240,8 +316,10 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
       /* Call back into the driver */
 
       bstop = callback(dev);
+#endif
     }
 
+  net_protounlock(NETLOCK_TCP);
   return bstop;
 }
 #else
@@ -271,6 +349,14 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
 
   /* Traverse all of the active TCP connections and perform the poll action. */
 
+  net_protolock(NETLOCK_TCP);
+
+#ifdef CONFIG_NET_TCP_SYNQUEUE
+  /* Forget half-open TCP connections that did not complete */
+
+  tcp_synq_timer(hsec);
+#endif
+
   while (!bstop && (conn = tcp_nextconn(conn)))
     {
       /* Perform the TCP timer poll */
@@ -282,6 +368,7 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
       bstop = callback(dev);
     }
 
+  net_protounlock(NETLOCK_TCP);
   return bstop;
 }
 #else
@@ -289,35 +376,238 @@ static inline int devif_poll_tcp_timer(FAR struct net_driver_s *dev,
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Function: devif_poll_pending
+ *
+ * Description:
+ *   Poll only the connections that have requested to send through this
+ *   device (see devif_txpend_add()).  A connection that produced a packet
+ *   is queued again at the end, since it may have more to send; one that
+ *   produced nothing is removed until it requests to send again.
+ *
+ *   With several priority classes (CONFIG_NET_TXPRIO_NCLASSES), the
+ *   classes are served as described for devif_txpend_class().
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver and may be called
+ *   from the timer interrupt/watchdog handle level.
+ *
  ****************************************************************************/
 
+#if defined(CONFIG_NET_TXPENDING) && CONFIG_NET_TXPRIO_NCLASSES > 1
 /****************************************************************************
- * Function: devif_poll
+ * Function: devif_txpend_class
  *
  * Description:
- *   This function will traverse each active network connection structure and
- *   will perform network polling operations. devif_poll() may be called
- *   asynchronously with the network driver can accept another outgoing
- *   packet.
+ *   Select the priority class whose next connection should be polled.  The
+ *   highest class is always served first.  The other classes are served in
+ *   weighted round-robin order:  Class i may send i + 1 packets per round
+ *   (d_txcredit[i]), and a new round begins when no class that has
+ *   connections queued has credit left.
  *
- *   This function will call the provided callback function for every active
- *   connection. Polling will continue until all connections have been polled
- *   or until the user-supplied function returns a non-zero value (which it
- *   should do only if it cannot accept further write data).
+ * Returned Value:
+ *   The selected class or -1 if no connection is queued.
  *
- *   When the callback function is called, there may be an outbound packet
- *   waiting for service in the device packet buffer, and if so the d_len field
- *   is set to a value larger than zero. The device driver should then send
- *   out the packet.
+ ****************************************************************************/
+
+static int devif_txpend_class(FAR struct net_driver_s *dev)
+{
+  int top = CONFIG_NET_TXPRIO_NCLASSES - 1;
+  int round;
+  int i;
+
+  if (!sq_empty(&dev->d_txpend[top]))
+    {
+      return top;
+    }
+
+  for (round = 0; round < 2; round++)
+    {
+      for (i = top - 1; i >= 0; i--)
+        {
+          if (!sq_empty(&dev->d_txpend[i]) && dev->d_txcredit[i] > 0)
+            {
+              dev->d_txcredit[i]--;
+              return i;
+            }
+        }
+
+      /* Start a new round */
+
+      for (i = 0; i < top; i++)
+        {
+          dev->d_txcredit[i] = i + 1;
+        }
+    }
+
+  return -1;
+}
+#endif
+
+#ifdef CONFIG_NET_TXPENDING
+static inline int devif_txpend_proto(uint8_t type)
+{
+  switch (type)
+    {
+      case DEVIF_TXPEND_TCP:
+        return NETLOCK_TCP;
+
+      case DEVIF_TXPEND_UDP:
+        return NETLOCK_UDP;
+
+      default:
+        return NETLOCK_OTHER;
+    }
+}
+
+static int devif_poll_pending(FAR struct net_driver_s *dev,
+                              devif_poll_callback_t callback)
+{
+  FAR struct devif_txpend_s *txp;
+  FAR sq_entry_t *entry;
+  irqstate_t flags;
+  int npending = 0;
+  int bstop = 0;
+  int proto;
+  int prio;
+
+  /* Visit only as many connections as were queued on entry.  Connections
+   * queued again below (or by the callbacks) wait for the next poll.
+   */
+
+  flags = enter_critical_section();
+  for (prio = 0; prio < CONFIG_NET_TXPRIO_NCLASSES; prio++)
+    {
+      for (entry = sq_peek(&dev->d_txpend[prio]);
+           entry != NULL;
+           entry = sq_next(entry))
+        {
+          npending++;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  while (!bstop && npending-- > 0)
+    {
+      /* The queues may be changed by threads that hold other locks, so
+       * peek at the head first, take the lock of its protocol and then
+       * make sure that it is still there.
+       */
+
+      flags = enter_critical_section();
+
+#if CONFIG_NET_TXPRIO_NCLASSES > 1
+      prio = devif_txpend_class(dev);
+      if (prio < 0)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+#else
+      prio = 0;
+#endif
+
+      txp = (FAR struct devif_txpend_s *)sq_peek(&dev->d_txpend[prio]);
+      if (txp == NULL)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      proto = devif_txpend_proto(txp->tp_type);
+      leave_critical_section(flags);
+
+      net_protolock(proto);
+
+      /* Dequeue the connection before polling it so that freeing it from a
+       * callback is harmless.
+       */
+
+      flags = enter_critical_section();
+      if ((FAR struct devif_txpend_s *)sq_peek(&dev->d_txpend[prio]) != txp)
+        {
+          leave_critical_section(flags);
+          net_protounlock(proto);
+          continue;
+        }
+
+      sq_remfirst(&dev->d_txpend[prio]);
+      txp->tp_dev = NULL;
+      leave_critical_section(flags);
+
+      dev->d_txprio = prio;
+
+      switch (txp->tp_type)
+        {
+#ifdef CONFIG_NET_PKT
+          case DEVIF_TXPEND_PKT:
+            pkt_poll(dev, (FAR struct pkt_conn_s *)
+                     ((FAR uint8_t *)txp - offsetof(struct pkt_conn_s,
+                                                    txpend)));
+            break;
+#endif
+
+#ifdef CONFIG_NET_TCP
+          case DEVIF_TXPEND_TCP:
+            tcp_poll(dev, (FAR struct tcp_conn_s *)
+                     ((FAR uint8_t *)txp - offsetof(struct tcp_conn_s,
+                                                    txpend)));
+            break;
+#endif
+
+#ifdef CONFIG_NET_UDP
+          case DEVIF_TXPEND_UDP:
+            udp_poll(dev, (FAR struct udp_conn_s *)
+                     ((FAR uint8_t *)txp - offsetof(struct udp_conn_s,
+                                                    txpend)));
+            break;
+#endif
+
+          default:
+            dev->d_len = 0;
+            break;
+        }
+
+      if (dev->d_len > 0)
+        {
+          devif_txpend_add(dev, txp, txp->tp_type);
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+          /* A UDP connection sends one buffered datagram per visit.  Visit
+           * it again in this poll so that its write queue is drained in a
+           * batch (the queue is bounded by CONFIG_NET_UDP_NWRBCHAINS).
+           */
+
+          if (txp->tp_type == DEVIF_TXPEND_UDP)
+            {
+              npending++;
+            }
+#endif
+        }
+
+      /* Call back into the driver */
+
+      bstop = callback(dev);
+      net_protounlock(proto);
+    }
+
+  dev->d_txprio = 0;
+  return bstop;
+}
+#endif /* CONFIG_NET_TXPENDING */
+
+/****************************************************************************
+ * Function: devif_poll_all
  *
- * Assumptions:
- *   This function is called from the MAC device driver and may be called
- *   from the timer interrupt/watchdog handle level.
+ * Description:
+ *   Implements devif_poll() and the poll part of devif_timer().  If 'sweep'
+ *   is true, all TCP, UDP and packet connections are polled; otherwise
+ *   only those that requested to send (CONFIG_NET_TXPENDING only).
  *
  ****************************************************************************/
 
-int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
+static int devif_poll_all(FAR struct net_driver_s *dev,
+                          devif_poll_callback_t callback, bool sweep)
 {
   int bstop = false;
 
@@ -328,14 +618,66 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 #ifdef CONFIG_NET_ARP_SEND
   /* Check for pending ARP requests */
 
+  net_protolock(NETLOCK_OTHER);
   bstop = arp_poll(dev, callback);
+  net_protounlock(NETLOCK_OTHER);
+  if (!bstop)
+#endif
+#ifdef CONFIG_NET_ARP_PENDING
+    {
+      /* Send packets that were waiting for ARP resolution */
+
+      net_protolock(NETLOCK_OTHER);
+      bstop = arp_pending_poll(dev, callback);
+      net_protounlock(NETLOCK_OTHER);
+    }
+
+  if (!bstop)
+#endif
+#ifdef CONFIG_NET_IPv6_NUD
+    {
+      /* Send Neighbor Solicitations and the packets that were waiting for
+       * Neighbor Discovery.
+       */
+
+      net_protolock(NETLOCK_OTHER);
+      bstop = neighbor_poll(dev, callback);
+      net_protounlock(NETLOCK_OTHER);
+    }
+
+  if (!bstop)
+#endif
+#ifdef CONFIG_NET_IPFORWARD
+    {
+      /* Send packets forwarded from other devices */
+
+      net_protolock(NETLOCK_OTHER);
+      bstop = devif_forward_poll(dev, callback);
+      net_protounlock(NETLOCK_OTHER);
+    }
+
+  if (!bstop)
+#endif
+#ifdef CONFIG_NET_TXPENDING
+    {
+      /* Poll only the connections that have something to send */
+
+      if (!sweep)
+        {
+          bstop = devif_poll_pending(dev, callback);
+        }
+    }
+
   if (!bstop)
 #endif
 #ifdef CONFIG_NET_PKT
     {
       /* Check for pending packet socket transfer */
 
-      bstop = devif_poll_pkt_connections(dev, callback);
+      if (sweep)
+        {
+          bstop = devif_poll_pkt_connections(dev, callback);
+        }
     }
 
   if (!bstop)
@@ -355,7 +697,10 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
        * action.
        */
 
-      bstop = devif_poll_tcp_connections(dev, callback);
+      if (sweep)
+        {
+          bstop = devif_poll_tcp_connections(dev, callback);
+        }
     }
 
   if (!bstop)
@@ -366,7 +711,10 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
        * the poll action
        */
 
-      bstop = devif_poll_udp_connections(dev, callback);
+      if (sweep)
+        {
+          bstop = devif_poll_udp_connections(dev, callback);
+        }
     }
 
   if (!bstop)
@@ -396,6 +744,48 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   return bstop;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: devif_poll
+ *
+ * Description:
+ *   This function will traverse each active network connection structure and
+ *   will perform network polling operations. devif_poll() may be called
+ *   asynchronously with the network driver can accept another outgoing
+ *   packet.
+ *
+ *   This function will call the provided callback function for every active
+ *   connection. Polling will continue until all connections have been polled
+ *   or until the user-supplied function returns a non-zero value (which it
+ *   should do only if it cannot accept further write data).
+ *
+ *   When the callback function is called, there may be an outbound packet
+ *   waiting for service in the device packet buffer, and if so the d_len field
+ *   is set to a value larger than zero. The device driver should then send
+ *   out the packet.
+ *
+ *   With CONFIG_NET_TXPENDING, only the TCP, UDP and packet connections
+ *   that requested to send through this device are polled.  The periodic
+ *   devif_timer() still polls all of them.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver and may be called
+ *   from the timer interrupt/watchdog handle level.
+ *
+ ****************************************************************************/
+
+int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
+{
+#ifdef CONFIG_NET_TXPENDING
+  return devif_poll_all(dev, callback, false);
+#else
+  return devif_poll_all(dev, callback, true);
+#endif
+}
+
 /****************************************************************************
  * Function: devif_timer
  *
@@ -425,11 +815,13 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   systime_t now;
   systime_t elapsed;
   int bstop = false;
+  int hsec = 0;
 
   /* Get the elapsed time since the last poll in units of half seconds
    * (truncating).
    */
 
+  net_protolock(NETLOCK_OTHER);
   now     = clock_systimer();
   elapsed = now - g_polltime;
 
@@ -441,7 +833,7 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
        * number of whole half seconds).
        */
 
-      int hsec = (int)(elapsed / TICK_PER_HSEC);
+      hsec = (int)(elapsed / TICK_PER_HSEC);
 
       /* Update the current poll time (truncating to the last half second
        * boundary to avoid error build-up).
@@ -467,14 +859,25 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
        neighbor_periodic(hsec);
 #endif
 
+#ifdef CONFIG_NET_6LOWPAN
+      /* Discard 6LoWPAN datagrams whose reassembly has timed out */
+
+      sixlowpan_reass_timer(hsec);
+#endif
+    }
+
+  net_protounlock(NETLOCK_OTHER);
+
 #ifdef CONFIG_NET_TCP
+  if (hsec > 0)
+    {
       /* Traverse all of the active TCP connections and perform the
        * timer action.
        */
 
       bstop = devif_poll_tcp_timer(dev, callback, hsec);
-#endif
     }
+#endif
 
   /* If possible, continue with a normal poll checking for pending
    * network driver actions.
@@ -482,7 +885,7 @@ int devif_timer(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
 
   if (!bstop)
     {
-      bstop = devif_poll(dev, callback);
+      bstop = devif_poll_all(dev, callback, true);
     }
 
   return bstop;
@@ -98,4 +98,8 @@ void devif_send(struct net_driver_s *dev, const void *buf, int len)
 
   memcpy(dev->d_appdata, buf, len);
   dev->d_sndlen = len;
+
+#ifdef CONFIG_NET_TCP_TSO
+  dev->d_tsomss = 0;
+#endif
 }
@@ -0,0 +1,199 @@
+/****************************************************************************
+ * net/devif/devif_txpend.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TXPENDING)
+
+#include <queue.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: devif_txpend_add
+ *
+ * Description:
+ *   Queue a connection that has data to send in d_txpend of the device,
+ *   at the end of the queue of its priority class.  The next devif_poll()
+ *   of the device will poll the connection.  Nothing is done if the
+ *   connection is already queued.
+ *
+ * Parameters:
+ *   dev  - The device that will send the data
+ *   txp  - The devif_txpend_s structure of the connection
+ *   type - The connection type:  DEVIF_TXPEND_TCP, _UDP or _PKT
+ *
+ * Assumptions:
+ *   The network is locked.  The queues of a device may also be changed by
+ *   threads that hold only the lock of another device (see
+ *   CONFIG_NET_FINELOCK), so they are always changed in a critical section.
+ *
+ ****************************************************************************/
+
+void devif_txpend_add(FAR struct net_driver_s *dev,
+                      FAR struct devif_txpend_s *txp, uint8_t type)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(dev != NULL && txp != NULL);
+
+  /* A connection is queued in only one device at a time.  If it is already
+   * queued in another device, then that device will poll it (and find that
+   * it has nothing to send) and the connection will be queued here the next
+   * time that it requests to send.
+   */
+
+  flags = enter_critical_section();
+  if (txp->tp_dev == NULL)
+    {
+      txp->tp_dev  = dev;
+      txp->tp_type = type;
+      sq_addlast(&txp->tp_node, &dev->d_txpend[txp->tp_prio]);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Function: devif_txpend_remove
+ *
+ * Description:
+ *   Remove a connection from the d_txpend queue of its device (if it is
+ *   queued).  Must be called before the connection is freed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void devif_txpend_remove(FAR struct devif_txpend_s *txp)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (txp->tp_dev != NULL)
+    {
+      sq_rem(&txp->tp_node, &txp->tp_dev->d_txpend[txp->tp_prio]);
+      txp->tp_dev = NULL;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Function: devif_txpend_flush
+ *
+ * Description:
+ *   Remove all connections from the d_txpend queue of a device.  Called when
+ *   the device is unregistered.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void devif_txpend_flush(FAR struct net_driver_s *dev)
+{
+  FAR struct devif_txpend_s *txp;
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_NET_TXPRIO_NCLASSES; i++)
+    {
+      while ((txp = (FAR struct devif_txpend_s *)
+                    sq_remfirst(&dev->d_txpend[i])) != NULL)
+        {
+          txp->tp_dev = NULL;
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Function: devif_txpend_setprio
+ *
+ * Description:
+ *   Set the priority class of a connection from an SO_PRIORITY value.
+ *   Values beyond the highest class select the highest class.  If the
+ *   connection is queued, it moves to the end of the queue of its new
+ *   class.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void devif_txpend_setprio(FAR struct devif_txpend_s *txp, int prio)
+{
+  FAR struct net_driver_s *dev;
+  irqstate_t flags;
+
+  if (prio >= CONFIG_NET_TXPRIO_NCLASSES)
+    {
+      prio = CONFIG_NET_TXPRIO_NCLASSES - 1;
+    }
+
+  flags = enter_critical_section();
+  dev   = txp->tp_dev;
+
+  if (prio != txp->tp_prio)
+    {
+      devif_txpend_remove(txp);
+      txp->tp_prio = (uint8_t)prio;
+
+      if (dev != NULL)
+        {
+          devif_txpend_add(dev, txp, txp->tp_type);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TXPENDING */
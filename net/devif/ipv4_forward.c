@@ -0,0 +1,186 @@
+/****************************************************************************
+ * net/devif/ipv4_forward.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+#include <net/if.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/iob.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "iob/iob.h"
+#include "devif/devif.h"
+
+#if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv4)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: ipv4_forward
+ *
+ * Description:
+ *   Called from ipv4_input() for each received IPv4 packet.  If the packet
+ *   is addressed to another host, it is forwarded:  The egress device is
+ *   selected by the destination address (using the routing table, if
+ *   any), the TTL is decremented and the header checksum is updated
+ *   incrementally.  Then a copy of the packet is queued on the egress
+ *   device, which is asked to poll for it.
+ *
+ * Parameters:
+ *   dev - The device on which the packet was received.  d_len holds the
+ *         length of the IPv4 packet.
+ *
+ * Returned Value:
+ *   OK        The packet was forwarded; nothing remains to be done.
+ *   -ENOENT   The packet is not to be forwarded; process it normally.
+ *   Any other negated errno value means that the packet should have been
+ *   forwarded but could not be and must be dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipv4_forward(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  FAR struct net_driver_s *fwddev;
+  FAR struct iob_s *iob;
+  in_addr_t destipaddr;
+  uint32_t sum;
+  int ret;
+
+  /* Only unicast packets addressed to other hosts are forwarded.  We must
+   * have an address of our own (we may still be negotiating one).
+   */
+
+  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  if (net_ipv4addr_cmp(dev->d_ipaddr, INADDR_ANY) ||
+      net_ipv4addr_cmp(destipaddr, dev->d_ipaddr) ||
+      net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST) ||
+      (destipaddr & ~dev->d_netmask) == ~dev->d_netmask ||
+      (NTOHS(ipv4->destipaddr[0]) & 0xf000) == 0xe000)
+    {
+      return -ENOENT;
+    }
+
+  if (!IFF_IS_RXCSUM(dev->d_flags) && ipv4_chksum(dev) != 0xffff)
+    {
+      nwarn("WARNING: Bad IP checksum\n");
+      return -EINVAL;
+    }
+
+  if (ipv4->ttl <= 1)
+    {
+      nwarn("WARNING: TTL exceeded\n");
+      return -EHOSTUNREACH;
+    }
+
+  /* Select the egress device */
+
+  fwddev = netdev_findby_ipv4addr(INADDR_ANY, destipaddr);
+  if (fwddev == NULL || (fwddev->d_flags & IFF_UP) == 0)
+    {
+      nwarn("WARNING: No route to %08lx\n", (unsigned long)destipaddr);
+      return -ENETUNREACH;
+    }
+
+  /* The packet is not fragmented */
+
+  if (dev->d_len > NET_DEV_MTU(fwddev) - NET_LL_HDRLEN(fwddev))
+    {
+      nwarn("WARNING: Packet too big for %s\n", fwddev->d_ifname);
+      return -EMSGSIZE;
+    }
+
+  /* Decrement the TTL.  The TTL is the upper byte of a 16-bit word of the
+   * header, so the checksum increases by 0x0100 (RFC 1141).
+   */
+
+  ipv4->ttl--;
+  sum = (uint32_t)NTOHS(ipv4->ipchksum) + 0x0100;
+  ipv4->ipchksum = HTONS((uint16_t)(sum + (sum >> 16)));
+
+  /* Queue a copy of the packet on the egress device */
+
+  iob = iob_tryalloc_user(true, IOBUSER_NETDEV);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)ipv4, dev->d_len, 0, true);
+  if (ret == dev->d_len)
+    {
+      ret = iob_tryadd_queue(iob, &fwddev->d_fwdq);
+    }
+  else
+    {
+      ret = -ENOMEM;
+    }
+
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return ret;
+    }
+
+  /* Let the egress device know that there is something to send */
+
+  netdev_txnotify_dev(fwddev);
+  return OK;
+}
+
+#endif /* CONFIG_NET_IPFORWARD && CONFIG_NET_IPv4 */
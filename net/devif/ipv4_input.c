@@ -100,6 +100,7 @@
 #include "igmp/igmp.h"
 
 #include "devif/devif.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -321,8 +322,21 @@ int ipv4_input(FAR struct net_driver_s *dev)
   FAR struct ipv4_hdr_s *pbuf = BUF;
   uint16_t hdrlen;
   uint16_t iplen;
+#if defined(CONFIG_NET_IPFORWARD) || \
+    (defined(CONFIG_NET_BROADCAST) && defined(CONFIG_NET_UDP))
+  int ret;
+#endif
+
+  /* This is where the input processing starts.  With CONFIG_NET_FINELOCK,
+   * only the device may be locked; the protocol locks are taken around
+   * the processing below.
+   */
 
-  /* This is where the input processing starts. */
+#ifdef CONFIG_NET_IOBTX
+  /* The packet buffer now holds an incoming packet */
+
+  dev->d_sndiob = NULL;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   g_netstats.ipv4.recv++;
@@ -373,12 +387,40 @@ int ipv4_input(FAR struct net_driver_s *dev)
       goto drop;
     }
 
+#ifdef CONFIG_NET_IPFORWARD
+  /* Forward packets addressed to other hosts.  This is done before
+   * reassembly so that fragments are forwarded as they are.
+   */
+
+  net_protolock(NETLOCK_OTHER);
+  ret = ipv4_forward(dev);
+  net_protounlock(NETLOCK_OTHER);
+
+  if (ret == OK)
+    {
+      /* The packet was queued on the egress device */
+
+      dev->d_len = 0;
+      return OK;
+    }
+  else if (ret != -ENOENT)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.drop++;
+#endif
+      goto drop;
+    }
+#endif
+
   /* Check the fragment flag. */
 
   if ((pbuf->ipoffset[0] & 0x3f) != 0 || pbuf->ipoffset[1] != 0)
     {
 #if defined(CONFIG_NET_TCP_REASSEMBLY)
+      net_protolock(NETLOCK_OTHER);
       dev->d_len = devif_reassembly();
+      net_protounlock(NETLOCK_OTHER);
+
       if (dev->d_len == 0)
         {
           goto drop;
@@ -404,7 +446,10 @@ int ipv4_input(FAR struct net_driver_s *dev)
       net_ipv4addr_cmp(net_ip4addr_conv32(pbuf->destipaddr),
                        INADDR_BROADCAST))
     {
-      return udp_ipv4_input(dev);
+      net_protolock(NETLOCK_UDP);
+      ret = udp_ipv4_input(dev);
+      net_protounlock(NETLOCK_UDP);
+      return ret;
     }
 
   /* In other cases, the device must be assigned a non-zero IP address. */
@@ -439,7 +484,7 @@ int ipv4_input(FAR struct net_driver_s *dev)
         }
     }
 
-  if (ipv4_chksum(dev) != 0xffff)
+  if (!IFF_IS_RXCSUM(dev->d_flags) && ipv4_chksum(dev) != 0xffff)
     {
       /* Compute and check the IP header checksum. */
 
@@ -463,13 +508,17 @@ int ipv4_input(FAR struct net_driver_s *dev)
     {
 #ifdef CONFIG_NET_TCP
       case IP_PROTO_TCP:   /* TCP input */
+        net_protolock(NETLOCK_TCP);
         tcp_ipv4_input(dev);
+        net_protounlock(NETLOCK_TCP);
         break;
 #endif
 
 #ifdef CONFIG_NET_UDP
       case IP_PROTO_UDP:   /* UDP input */
+        net_protolock(NETLOCK_UDP);
         udp_ipv4_input(dev);
+        net_protounlock(NETLOCK_UDP);
         break;
 #endif
 
@@ -477,7 +526,9 @@ int ipv4_input(FAR struct net_driver_s *dev)
   /* Check for ICMP input */
 
       case IP_PROTO_ICMP:  /* ICMP input */
+        net_protolock(NETLOCK_OTHER);
         icmp_input(dev);
+        net_protounlock(NETLOCK_OTHER);
         break;
 #endif
 
@@ -485,7 +536,9 @@ int ipv4_input(FAR struct net_driver_s *dev)
   /* Check for IGMP input */
 
       case IP_PROTO_IGMP:  /* IGMP input */
+        net_protolock(NETLOCK_OTHER);
         igmp_input(dev);
+        net_protounlock(NETLOCK_OTHER);
         break;
 #endif
 
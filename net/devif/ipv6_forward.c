@@ -0,0 +1,176 @@
+/****************************************************************************
+ * net/devif/ipv6_forward.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/iob.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "iob/iob.h"
+#include "devif/devif.h"
+
+#if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv6)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: ipv6_forward
+ *
+ * Description:
+ *   Called from ipv6_input() for each received IPv6 packet.  If the packet
+ *   is addressed to another host, it is forwarded:  The egress device is
+ *   selected by the destination address (using the routing table, if
+ *   any) and the hop limit is decremented.  Then a copy of the packet is
+ *   queued on the egress device, which is asked to poll for it.
+ *
+ * Parameters:
+ *   dev - The device on which the packet was received.  d_len holds the
+ *         length of the IPv6 packet.
+ *
+ * Returned Value:
+ *   OK        The packet was forwarded; nothing remains to be done.
+ *   -ENOENT   The packet is not to be forwarded; process it normally.
+ *   Any other negated errno value means that the packet should have been
+ *   forwarded but could not be and must be dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipv6_forward(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+  FAR struct net_driver_s *fwddev;
+  FAR struct iob_s *iob;
+  uint16_t iplen;
+  int ret;
+
+  /* Only unicast packets addressed to other hosts are forwarded.  We must
+   * have an address of our own.  Link-local addresses (fe80::/10) are
+   * never forwarded.
+   */
+
+  if (net_ipv6addr_cmp(dev->d_ipv6addr, g_ipv6_allzeroaddr) ||
+      net_ipv6addr_cmp(ipv6->destipaddr, dev->d_ipv6addr) ||
+      (NTOHS(ipv6->destipaddr[0]) & 0xff00) == 0xff00 ||
+      (NTOHS(ipv6->destipaddr[0]) & 0xffc0) == 0xfe80 ||
+      (NTOHS(ipv6->srcipaddr[0]) & 0xffc0) == 0xfe80)
+    {
+      return -ENOENT;
+    }
+
+  if (ipv6->ttl <= 1)
+    {
+      nwarn("WARNING: Hop limit exceeded\n");
+      return -EHOSTUNREACH;
+    }
+
+  /* Select the egress device */
+
+  fwddev = netdev_findby_ipv6addr(g_ipv6_allzeroaddr, ipv6->destipaddr);
+  if (fwddev == NULL || (fwddev->d_flags & IFF_UP) == 0)
+    {
+      nwarn("WARNING: No route\n");
+      return -ENETUNREACH;
+    }
+
+  /* The packet is not fragmented */
+
+  iplen = ((uint16_t)ipv6->len[0] << 8) + ipv6->len[1] + IPv6_HDRLEN;
+  if (iplen > dev->d_len ||
+      iplen > NET_DEV_MTU(fwddev) - NET_LL_HDRLEN(fwddev))
+    {
+      nwarn("WARNING: Packet too big for %s\n", fwddev->d_ifname);
+      return -EMSGSIZE;
+    }
+
+  /* Decrement the hop limit.  There is no header checksum. */
+
+  ipv6->ttl--;
+
+  /* Queue a copy of the packet on the egress device */
+
+  iob = iob_tryalloc_user(true, IOBUSER_NETDEV);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)ipv6, iplen, 0, true);
+  if (ret == iplen)
+    {
+      ret = iob_tryadd_queue(iob, &fwddev->d_fwdq);
+    }
+  else
+    {
+      ret = -ENOMEM;
+    }
+
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return ret;
+    }
+
+  /* Let the egress device know that there is something to send */
+
+  netdev_txnotify_dev(fwddev);
+  return OK;
+}
+
+#endif /* CONFIG_NET_IPFORWARD && CONFIG_NET_IPv6 */
@@ -99,6 +99,7 @@
 #include "icmpv6/icmpv6.h"
 
 #include "devif/devif.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -132,8 +133,21 @@ int ipv6_input(FAR struct net_driver_s *dev)
   FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
   uint16_t hdrlen;
   uint16_t pktlen;
+#if defined(CONFIG_NET_IPFORWARD) || \
+    (defined(CONFIG_NET_BROADCAST) && defined(CONFIG_NET_UDP))
+  int ret;
+#endif
+
+  /* This is where the input processing starts.  With CONFIG_NET_FINELOCK,
+   * only the device may be locked; the protocol locks are taken around
+   * the processing below.
+   */
 
-  /* This is where the input processing starts. */
+#ifdef CONFIG_NET_IOBTX
+  /* The packet buffer now holds an incoming packet */
+
+  dev->d_sndiob = NULL;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   g_netstats.ipv6.recv++;
@@ -191,6 +205,29 @@ int ipv6_input(FAR struct net_driver_s *dev)
       goto drop;
     }
 
+#ifdef CONFIG_NET_IPFORWARD
+  /* Forward packets addressed to other hosts */
+
+  net_protolock(NETLOCK_OTHER);
+  ret = ipv6_forward(dev);
+  net_protounlock(NETLOCK_OTHER);
+
+  if (ret == OK)
+    {
+      /* The packet was queued on the egress device */
+
+      dev->d_len = 0;
+      return OK;
+    }
+  else if (ret != -ENOENT)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv6.drop++;
+#endif
+      goto drop;
+    }
+#endif
+
   /* If IP broadcast support is configured, we check for a broadcast
    * UDP packet, which may be destined to us (even if there is no IP
    * address yet assigned to the device as is the case when we are
@@ -201,7 +238,10 @@ int ipv6_input(FAR struct net_driver_s *dev)
   if (ipv6->proto == IP_PROTO_UDP &&
       net_ipv6addr_cmp(ipv6->destipaddr, g_ipv6_alloneaddr))
     {
-      return udp_ipv6_input(dev);
+      net_protolock(NETLOCK_UDP);
+      ret = udp_ipv6_input(dev);
+      net_protounlock(NETLOCK_UDP);
+      return ret;
     }
 
   /* In other cases, the device must be assigned a non-zero IP address. */
@@ -255,13 +295,17 @@ int ipv6_input(FAR struct net_driver_s *dev)
     {
 #ifdef CONFIG_NET_TCP
       case IP_PROTO_TCP:   /* TCP input */
+        net_protolock(NETLOCK_TCP);
         tcp_ipv6_input(dev);
+        net_protounlock(NETLOCK_TCP);
         break;
 #endif
 
 #ifdef CONFIG_NET_UDP
       case IP_PROTO_UDP:   /* UDP input */
+        net_protolock(NETLOCK_UDP);
         udp_ipv6_input(dev);
+        net_protounlock(NETLOCK_UDP);
         break;
 #endif
 
@@ -269,7 +313,9 @@ int ipv6_input(FAR struct net_driver_s *dev)
 
 #ifdef CONFIG_NET_ICMPv6
       case IP_PROTO_ICMP6: /* ICMP6 input */
+        net_protolock(NETLOCK_OTHER);
         icmpv6_input(dev);
+        net_protounlock(NETLOCK_OTHER);
         break;
 #endif
 
@@ -120,15 +120,19 @@ void icmp_send(FAR struct net_driver_s *dev, FAR in_addr_t *destaddr)
       /* Calculate IP checksum. */
 
       picmp->ipchksum    = 0;
-      picmp->ipchksum    = ~(ipv4_chksum(dev));
-
-      /* Calculate the ICMP checksum. */
-
       picmp->icmpchksum  = 0;
-      picmp->icmpchksum  = ~(icmp_chksum(dev, dev->d_sndlen));
-      if (picmp->icmpchksum == 0)
+
+      if (!IFF_IS_TXCSUM(dev->d_flags))
         {
-          picmp->icmpchksum = 0xffff;
+          picmp->ipchksum = ~(ipv4_chksum(dev));
+
+          /* Calculate the ICMP checksum. */
+
+          picmp->icmpchksum = ~(icmp_chksum(dev, dev->d_sndlen));
+          if (picmp->icmpchksum == 0)
+            {
+              picmp->icmpchksum = 0xffff;
+            }
         }
 
       ninfo("Outgoing ICMP packet length: %d (%d)\n",
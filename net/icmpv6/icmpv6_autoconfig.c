@@ -52,6 +52,7 @@
 
 #include "devif/devif.h"
 #include "netdev/netdev.h"
+#include "route/route.h"
 #include "icmpv6/icmpv6.h"
 
 #ifdef CONFIG_NET_ICMPv6_AUTOCONF
@@ -452,6 +453,7 @@ int icmpv6_autoconfig(FAR struct net_driver_s *dev)
 
   save = net_lock();
   net_ipv6addr_copy(dev->d_ipv6addr, lladdr);
+  net_route_invalidate();
 
   /* Bring the interface up with the new, temporary IP address */
 
@@ -523,6 +525,7 @@ int icmpv6_autoconfig(FAR struct net_driver_s *dev)
       /* Set a netmask for the local link address */
 
       net_ipv6addr_copy(dev->d_ipv6netmask, g_ipv6_llnetmask);
+      net_route_invalidate();
 
       /* Leave the network up and return success (even though things did not
        * work out quite the way we wanted).
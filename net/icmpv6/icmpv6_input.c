@@ -125,6 +125,22 @@ void icmpv6_input(FAR struct net_driver_s *dev)
         sol = ICMPv6SOLICIT;
         if (net_ipv6addr_cmp(sol->tgtaddr, dev->d_ipv6addr))
           {
+#ifdef CONFIG_NET_IPv6_NUD
+            /* The solicitation carries the link layer address of the
+             * sender.  Remember it as a STALE entry (RFC 4861, section
+             * 7.2.3) so that the advertisement and any reply do not need
+             * an address resolution of their own.
+             */
+
+            if (sol->opttype == ICMPv6_OPT_SRCLLADDR &&
+                !net_ipv6addr_cmp(icmp->srcipaddr, g_ipv6_allzeroaddr))
+              {
+                neighbor_add(dev, icmp->srcipaddr,
+                             (FAR struct neighbor_addr_s *)sol->srclladdr,
+                             false);
+              }
+#endif
+
             /* Yes..  Send a neighbor advertisement back to where the neighbor
              * solicitation came from.
              */
@@ -167,8 +183,9 @@ void icmpv6_input(FAR struct net_driver_s *dev)
               {
                 /* Save the sender's address mapping in our Neighbor Table. */
 
-                neighbor_add(icmp->srcipaddr,
-                             (FAR struct neighbor_addr_s *)adv->tgtlladdr);
+                neighbor_add(dev, icmp->srcipaddr,
+                             (FAR struct neighbor_addr_s *)adv->tgtlladdr,
+                             (adv->flags[0] & ICMPv6_NADV_FLAG_S) != 0);
 
 #ifdef CONFIG_NET_ICMPv6_NEIGHBOR
                 /* Then notify any logic waiting for the Neighbor Advertisement */
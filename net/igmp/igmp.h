@@ -81,12 +81,34 @@
 
 #ifdef CONFIG_NET_IGMP
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Group hash table.  The group address is in network byte order; all four
+ * bytes are folded so that the result does not depend on the host byte
+ * order.
+ */
+
+#ifdef CONFIG_NET_IGMP_HASH
+#  ifndef CONFIG_NET_IGMP_HASHSIZE
+#    define CONFIG_NET_IGMP_HASHSIZE 16
+#  endif
+
+#  define IGMP_HASH(a) \
+     ((unsigned int)(((a) ^ ((a) >> 8) ^ ((a) >> 16) ^ ((a) >> 24)) & 0xff) % \
+      CONFIG_NET_IGMP_HASHSIZE)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
 /* This structure represents one group member.  There is a list of groups
- * for each device interface structure.
+ * for each device interface structure.  If CONFIG_NET_IGMP_HASH is
+ * selected, the groups of all devices are also kept in a hash table keyed
+ * by the group address so that received packets can be matched without
+ * searching the list.
  *
  * There will be a group for the all systems group address but this
  * will not run the state machine as it is used to kick off reports
@@ -97,6 +119,10 @@ typedef FAR struct wdog_s *WDOG_ID;
 struct igmp_group_s
 {
   struct igmp_group_s *next;    /* Implements a singly-linked list */
+#ifdef CONFIG_NET_IGMP_HASH
+  struct igmp_group_s *hnext;   /* Next group in the hash chain */
+  FAR struct net_driver_s *dev; /* Device that the group belongs to */
+#endif
   in_addr_t            grpaddr; /* Group IPv4 address */
   WDOG_ID              wdog;    /* WDOG used to detect timeouts */
   sem_t                sem;     /* Used to wait for message transmission */
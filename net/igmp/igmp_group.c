@@ -108,6 +108,12 @@
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_IGMP_HASH
+/* The groups of all devices hashed by group address */
+
+static FAR struct igmp_group_s *g_igmp_hash[CONFIG_NET_IGMP_HASHSIZE];
+#endif
+
 /* kmm_malloc() cannot be called from an interrupt handler.  To work around this,
  * a small number of IGMP groups are preallocated just for use in interrupt
  * handling logic.
@@ -254,6 +260,15 @@ FAR struct igmp_group_s *igmp_grpalloc(FAR struct net_driver_s *dev,
       /* Add the group structure to the list in the device structure */
 
       sq_addfirst((FAR sq_entry_t *)group, &dev->grplist);
+
+#ifdef CONFIG_NET_IGMP_HASH
+      /* And to the hash chain for the group address */
+
+      group->dev   = dev;
+      group->hnext = g_igmp_hash[IGMP_HASH(*addr)];
+      g_igmp_hash[IGMP_HASH(*addr)] = group;
+#endif
+
       net_unlock(flags);
     }
 
@@ -284,6 +299,17 @@ FAR struct igmp_group_s *igmp_grpfind(FAR struct net_driver_s *dev,
    */
 
   flags = net_lock();
+#ifdef CONFIG_NET_IGMP_HASH
+  for (group = g_igmp_hash[IGMP_HASH(*addr)]; group; group = group->hnext)
+    {
+      grpinfo("Compare: %08x vs. %08x\n", group->grpaddr, *addr);
+      if (group->dev == dev && net_ipv4addr_cmp(group->grpaddr, *addr))
+        {
+          grpinfo("Match!\n");
+          break;
+        }
+    }
+#else
   for (group = (FAR struct igmp_group_s *)dev->grplist.head;
        group;
        group = group->next)
@@ -295,6 +321,7 @@ FAR struct igmp_group_s *igmp_grpfind(FAR struct net_driver_s *dev,
           break;
         }
     }
+#endif
 
   net_unlock(flags);
   return group;
@@ -340,6 +367,9 @@ FAR struct igmp_group_s *igmp_grpallocfind(FAR struct net_driver_s *dev,
 
 void igmp_grpfree(FAR struct net_driver_s *dev, FAR struct igmp_group_s *group)
 {
+#ifdef CONFIG_NET_IGMP_HASH
+  FAR struct igmp_group_s **link;
+#endif
   net_lock_t flags;
 
   grpinfo("Free: %p flags: %02x\n", group, group->flags);
@@ -353,6 +383,21 @@ void igmp_grpfree(FAR struct net_driver_s *dev, FAR struct igmp_group_s *group)
 
   sq_rem((FAR sq_entry_t *)group, &dev->grplist);
 
+#ifdef CONFIG_NET_IGMP_HASH
+  /* And from its hash chain */
+
+  for (link = &g_igmp_hash[IGMP_HASH(group->grpaddr)];
+       *link != NULL;
+       link = &(*link)->hnext)
+    {
+      if (*link == group)
+        {
+          *link = group->hnext;
+          break;
+        }
+    }
+#endif
+
   /* Destroy the wait semaphore */
 
   (void)sem_destroy(&group->sem);
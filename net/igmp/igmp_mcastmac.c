@@ -43,6 +43,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -83,6 +84,38 @@ static void igmp_mcastmac(in_addr_t *ip, FAR uint8_t *mac)
         *ip, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 }
 
+/****************************************************************************
+ * Name:  igmp_mcastmac_shared
+ *
+ * Description:
+ *   Only the low order 23 bits of the group address are mapped into the
+ *   multicast MAC address, so several groups may share one MAC filter
+ *   entry.  Return true if any group of the device other than the one with
+ *   this IP address maps to the same MAC address.
+ *
+ ****************************************************************************/
+
+static bool igmp_mcastmac_shared(FAR struct net_driver_s *dev,
+                                 FAR in_addr_t *ip)
+{
+  FAR struct igmp_group_s *group;
+
+  for (group = (FAR struct igmp_group_s *)dev->grplist.head;
+       group;
+       group = group->next)
+    {
+      if (!net_ipv4addr_cmp(group->grpaddr, *ip) &&
+          (ip4_addr2(group->grpaddr) & 0x7f) == (ip4_addr2(*ip) & 0x7f) &&
+          ip4_addr3(group->grpaddr) == ip4_addr3(*ip) &&
+          ip4_addr4(group->grpaddr) == ip4_addr4(*ip))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -91,7 +124,8 @@ static void igmp_mcastmac(in_addr_t *ip, FAR uint8_t *mac)
  * Name:  igmp_addmcastmac
  *
  * Description:
- *   Add an IGMP MAC address to the device's MAC filter table.
+ *   Add an IGMP MAC address to the device's MAC filter table.  Nothing is
+ *   done if another group of the device already uses the same MAC address.
  *
  ****************************************************************************/
 
@@ -100,7 +134,7 @@ void igmp_addmcastmac(FAR struct net_driver_s *dev, FAR in_addr_t *ip)
   uint8_t mcastmac[6];
 
   ninfo("Adding: IP %08x\n", *ip);
-  if (dev->d_addmac)
+  if (dev->d_addmac && !igmp_mcastmac_shared(dev, ip))
     {
       igmp_mcastmac(ip, mcastmac);
       dev->d_addmac(dev, mcastmac);
@@ -111,7 +145,9 @@ void igmp_addmcastmac(FAR struct net_driver_s *dev, FAR in_addr_t *ip)
  * Name:  igmp_removemcastmac
  *
  * Description:
- *   Remove an IGMP MAC address from the device's MAC filter table.
+ *   Remove an IGMP MAC address from the device's MAC filter table unless
+ *   it is still needed by another group of the device.  The group being
+ *   left must already have been removed from the device's group list.
  *
  ****************************************************************************/
 
@@ -120,7 +156,7 @@ void igmp_removemcastmac(FAR struct net_driver_s *dev, FAR in_addr_t *ip)
   uint8_t mcastmac[6];
 
   ninfo("Removing: IP %08x\n", *ip);
-  if (dev->d_rmmac)
+  if (dev->d_rmmac && !igmp_mcastmac_shared(dev, ip))
     {
       igmp_mcastmac(ip, mcastmac);
       dev->d_rmmac(dev, mcastmac);
@@ -48,6 +48,30 @@
 
 #ifdef CONFIG_NET_IOB
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Account one more or one fewer I/O buffer in use.  Called in a critical
+ * section.
+ */
+
+#ifdef CONFIG_IOB_HIGHWATER
+#  define IOB_COUNT_ALLOC() \
+  do \
+    { \
+      if (++g_iob_nused > g_iob_hwm) \
+        { \
+          g_iob_hwm = g_iob_nused; \
+        } \
+    } \
+  while (0)
+#  define IOB_COUNT_FREE()  (g_iob_nused--)
+#else
+#  define IOB_COUNT_ALLOC()
+#  define IOB_COUNT_FREE()
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -72,6 +96,28 @@ extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_QUOTA
+/* The number of I/O buffers held by each user and a semaphore to wait on
+ * when an allocation is refused because of a quota or reservation.
+ */
+
+extern uint16_t g_iob_usage[IOBUSER_NUSERS];
+extern sem_t g_iob_quotasem;
+#endif
+
+#ifdef CONFIG_IOB_GROWTH
+/* The number of I/O buffers that exist, pre-allocated or not */
+
+extern uint16_t g_iob_nbuffers;
+#endif
+
+#ifdef CONFIG_IOB_HIGHWATER
+/* The number of I/O buffers in use and the largest number in use */
+
+extern uint16_t g_iob_nused;
+extern uint16_t g_iob_hwm;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -111,6 +157,17 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryalloc_user
+ *
+ * Description:
+ *   Try to allocate an I/O buffer on behalf of one of the IOBUSER_* users
+ *   without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_user(bool throttled, uint8_t user);
+
 /****************************************************************************
  * Name: iob_free_qentry
  *
@@ -52,14 +52,188 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/iob.h>
 
 #include "iob.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+#  ifndef CONFIG_IOB_QUOTA_TCP_RX
+#    define CONFIG_IOB_QUOTA_TCP_RX 0
+#  endif
+#  ifndef CONFIG_IOB_QUOTA_TCP_TX
+#    define CONFIG_IOB_QUOTA_TCP_TX 0
+#  endif
+#  ifndef CONFIG_IOB_QUOTA_UDP_RX
+#    define CONFIG_IOB_QUOTA_UDP_RX 0
+#  endif
+#  ifndef CONFIG_IOB_QUOTA_UDP_TX
+#    define CONFIG_IOB_QUOTA_UDP_TX 0
+#  endif
+#  ifndef CONFIG_IOB_QUOTA_NETDEV
+#    define CONFIG_IOB_QUOTA_NETDEV 0
+#  endif
+#  ifndef CONFIG_IOB_RESERVE_TCP_RX
+#    define CONFIG_IOB_RESERVE_TCP_RX 0
+#  endif
+#  ifndef CONFIG_IOB_RESERVE_TCP_TX
+#    define CONFIG_IOB_RESERVE_TCP_TX 0
+#  endif
+#  ifndef CONFIG_IOB_RESERVE_UDP_RX
+#    define CONFIG_IOB_RESERVE_UDP_RX 0
+#  endif
+#  ifndef CONFIG_IOB_RESERVE_UDP_TX
+#    define CONFIG_IOB_RESERVE_UDP_TX 0
+#  endif
+#  ifndef CONFIG_IOB_RESERVE_NETDEV
+#    define CONFIG_IOB_RESERVE_NETDEV 0
+#  endif
+
+#  if CONFIG_IOB_RESERVE_TCP_RX + CONFIG_IOB_RESERVE_TCP_TX + \
+      CONFIG_IOB_RESERVE_UDP_RX + CONFIG_IOB_RESERVE_UDP_TX + \
+      CONFIG_IOB_RESERVE_NETDEV > \
+      CONFIG_IOB_NBUFFERS
+#    error The I/O buffer reservations exceed CONFIG_IOB_NBUFFERS
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+/* The maximum number of I/O buffers that each user may hold (zero means no
+ * limit) and the number of I/O buffers reserved for each user.
+ */
+
+static const uint16_t g_iob_quota[IOBUSER_NUSERS] =
+{
+  0,
+  CONFIG_IOB_QUOTA_TCP_RX,
+  CONFIG_IOB_QUOTA_TCP_TX,
+  CONFIG_IOB_QUOTA_UDP_RX,
+  CONFIG_IOB_QUOTA_UDP_TX,
+  CONFIG_IOB_QUOTA_NETDEV
+};
+
+static const uint16_t g_iob_reserve[IOBUSER_NUSERS] =
+{
+  0,
+  CONFIG_IOB_RESERVE_TCP_RX,
+  CONFIG_IOB_RESERVE_TCP_TX,
+  CONFIG_IOB_RESERVE_UDP_RX,
+  CONFIG_IOB_RESERVE_UDP_TX,
+  CONFIG_IOB_RESERVE_NETDEV
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_quota_check
+ *
+ * Description:
+ *   Return true if the user may take one more I/O buffer:  It has not
+ *   reached its quota and taking the buffer does not eat into the unused
+ *   reservations of the other users.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+static bool iob_quota_check(uint8_t user)
+{
+  int avail;
+  int needed;
+  int i;
+
+  DEBUGASSERT(user < IOBUSER_NUSERS);
+
+  if (g_iob_quota[user] > 0 && g_iob_usage[user] >= g_iob_quota[user])
+    {
+      return false;
+    }
+
+  /* A user may always take from its own reservation */
+
+  if (g_iob_usage[user] < g_iob_reserve[user])
+    {
+      return true;
+    }
+
+  /* Otherwise, there must be more buffers available than still reserved */
+
+  avail = g_iob_sem.semcount;
+#ifdef CONFIG_IOB_GROWTH
+  avail += CONFIG_IOB_MAXBUFFERS - g_iob_nbuffers;
+#endif
+
+  for (i = 0, needed = 0; i < IOBUSER_NUSERS; i++)
+    {
+      if (g_iob_usage[i] < g_iob_reserve[i])
+        {
+          needed += g_iob_reserve[i] - g_iob_usage[i];
+        }
+    }
+
+  return avail > needed;
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_grow
+ *
+ * Description:
+ *   The free list is empty:  Allocate a new I/O buffer from the heap unless
+ *   CONFIG_IOB_MAXBUFFERS buffers already exist.  Buffers allocated this
+ *   way are returned to the free list when freed and are never given back
+ *   to the heap.
+ *
+ * Assumptions:
+ *   Called in the critical section 'flags', which is left.  Not called from
+ *   an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_GROWTH
+static FAR struct iob_s *iob_grow(irqstate_t flags)
+{
+  FAR struct iob_s *iob = NULL;
+
+  if (g_iob_nbuffers < CONFIG_IOB_MAXBUFFERS)
+    {
+      /* Claim the slot before leaving the critical section */
+
+      g_iob_nbuffers++;
+      IOB_COUNT_ALLOC();
+      leave_critical_section(flags);
+
+      iob = (FAR struct iob_s *)kmm_malloc(sizeof(struct iob_s));
+      if (iob == NULL)
+        {
+          flags = enter_critical_section();
+          g_iob_nbuffers--;
+          IOB_COUNT_FREE();
+          leave_critical_section(flags);
+        }
+    }
+  else
+    {
+      leave_critical_section(flags);
+    }
+
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -69,11 +243,12 @@
  *
  ****************************************************************************/
 
-static FAR struct iob_s *iob_allocwait(bool throttled)
+static FAR struct iob_s *iob_allocwait(bool throttled, uint8_t user)
 {
   FAR struct iob_s *iob;
   irqstate_t flags;
   FAR sem_t *sem;
+  FAR sem_t *waitsem;
   int ret = OK;
 
 #if CONFIG_IOB_THROTTLE > 0
@@ -97,7 +272,7 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
        * will be decremented atomically.
        */
 
-      iob = iob_tryalloc(throttled);
+      iob = iob_tryalloc_user(throttled, user);
       if (!iob)
         {
           /* If not successful, then the semaphore count was less than or
@@ -106,7 +281,19 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
            * count will be incremented.
            */
 
-          ret = sem_wait(sem);
+          waitsem = sem;
+#ifdef CONFIG_IOB_QUOTA
+          /* If there are free buffers, the allocation was refused because
+           * of a quota or a reservation.  Wait until any buffer is freed.
+           */
+
+          if (sem->semcount > 0)
+            {
+              waitsem = &g_iob_quotasem;
+            }
+#endif
+
+          ret = sem_wait(waitsem);
           if (ret < 0)
             {
               int errcode = get_errno();
@@ -151,9 +338,15 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
                *
                * TODO: Consider a design modification to permit us to
                * complete the allocation without losing our count.
+               *
+               * g_iob_quotasem is only used for wake-up; there is no count
+               * to give back.
                */
 
-              sem_post(sem);
+              if (waitsem == sem)
+                {
+                  sem_post(sem);
+                }
             }
         }
     }
@@ -176,6 +369,22 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
  ****************************************************************************/
 
 FAR struct iob_s *iob_alloc(bool throttled)
+{
+  return iob_alloc_user(throttled, IOBUSER_OTHER);
+}
+
+/****************************************************************************
+ * Name: iob_alloc_user
+ *
+ * Description:
+ *   Allocate an I/O buffer on behalf of one of the IOBUSER_* users.  With
+ *   CONFIG_IOB_QUOTA, the allocation may wait (or fail, if called from an
+ *   interrupt handler) because the user has reached its quota or because
+ *   the remaining free buffers are reserved for other users.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_user(bool throttled, uint8_t user)
 {
   /* Were we called from the interrupt level? */
 
@@ -183,13 +392,13 @@ FAR struct iob_s *iob_alloc(bool throttled)
     {
       /* Yes, then try to allocate an I/O buffer without waiting */
 
-      return iob_tryalloc(throttled);
+      return iob_tryalloc_user(throttled, user);
     }
   else
     {
       /* Then allocate an I/O buffer, waiting as necessary */
 
-      return iob_allocwait(throttled);
+      return iob_allocwait(throttled, user);
     }
 }
 
@@ -203,6 +412,20 @@ FAR struct iob_s *iob_alloc(bool throttled)
  ****************************************************************************/
 
 FAR struct iob_s *iob_tryalloc(bool throttled)
+{
+  return iob_tryalloc_user(throttled, IOBUSER_OTHER);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_user
+ *
+ * Description:
+ *   Try to allocate an I/O buffer on behalf of one of the IOBUSER_* users
+ *   without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_user(bool throttled, uint8_t user)
 {
   FAR struct iob_s *iob;
   irqstate_t flags;
@@ -222,6 +445,16 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_IOB_QUOTA
+  /* Is this user allowed to take another buffer? */
+
+  if (!iob_quota_check(user))
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   /* If there are free I/O buffers for this allocation */
 
@@ -258,18 +491,107 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
           g_throttle_sem.semcount--;
           DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
 #endif
-          leave_critical_section(flags);
+          goto found;
+        }
+    }
+
+#ifdef CONFIG_IOB_GROWTH
+  /* Try to add a buffer to the pool.  The heap cannot be used from an
+   * interrupt handler.
+   */
 
-          /* Put the I/O buffer in a known state */
+  if (!up_interrupt_context())
+    {
+#ifdef CONFIG_IOB_QUOTA
+      /* Account the buffer before leaving the critical section */
 
-          iob->io_flink  = NULL; /* Not in a chain */
-          iob->io_len    = 0;    /* Length of the data in the entry */
-          iob->io_offset = 0;    /* Offset to the beginning of data */
-          iob->io_pktlen = 0;    /* Total length of the packet */
-          return iob;
+      g_iob_usage[user]++;
+#endif
+
+      iob = iob_grow(flags);
+      if (iob != NULL)
+        {
+          goto initialize;
         }
+
+#ifdef CONFIG_IOB_QUOTA
+      flags = enter_critical_section();
+      g_iob_usage[user]--;
+      leave_critical_section(flags);
+#endif
+      return NULL;
     }
+#endif
 
   leave_critical_section(flags);
   return NULL;
+
+found:
+#ifdef CONFIG_IOB_QUOTA
+  /* Account the buffer to the user */
+
+  g_iob_usage[user]++;
+#endif
+  IOB_COUNT_ALLOC();
+  leave_critical_section(flags);
+
+#ifdef CONFIG_IOB_GROWTH
+initialize:
+#endif
+#ifdef CONFIG_IOB_QUOTA
+  iob->io_user   = user;
+#endif
+
+  /* Put the I/O buffer in a known state */
+
+  iob->io_flink  = NULL; /* Not in a chain */
+  iob->io_len    = 0;    /* Length of the data in the entry */
+  iob->io_offset = 0;    /* Offset to the beginning of data */
+  iob->io_pktlen = 0;    /* Total length of the packet */
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_usage
+ *
+ * Description:
+ *   Return the number of I/O buffers currently held by one of the
+ *   IOBUSER_* users.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+int iob_usage(uint8_t user)
+{
+  DEBUGASSERT(user < IOBUSER_NUSERS);
+  return g_iob_usage[user];
 }
+#endif
+
+/****************************************************************************
+ * Name: iob_highwater
+ *
+ * Description:
+ *   Return the largest number of I/O buffers that were in use at any time
+ *   since the last reset.  If 'reset' is true, the mark is then reset to
+ *   the number of I/O buffers currently in use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_HIGHWATER
+int iob_highwater(bool reset)
+{
+  irqstate_t flags;
+  int hwm;
+
+  flags = enter_critical_section();
+  hwm   = g_iob_hwm;
+  if (reset)
+    {
+      g_iob_hwm = g_iob_nused;
+    }
+
+  leave_critical_section(flags);
+  return hwm;
+}
+#endif
@@ -64,18 +64,19 @@
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: iob_clone
+ * Name: iob_clone_internal
  *
  * Description:
- *   Duplicate (and pack) the data in iob1 in iob2.  iob2 must be empty.
+ *   Common logic for iob_clone() and iob_tryclone().
  *
  ****************************************************************************/
 
-int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
+static int iob_clone_internal(FAR struct iob_s *iob1, FAR struct iob_s *iob2,
+                              bool throttled, bool can_block)
 {
   FAR uint8_t *src;
   FAR uint8_t *dest;
@@ -92,11 +93,18 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
 
   iob2->io_pktlen = iob1->io_pktlen;
 
+#ifdef CONFIG_NET_TIMESTAMP
+  /* And the time stamps which are also kept only in the head of the chain */
+
+  iob2->io_swtime = iob1->io_swtime;
+  iob2->io_hwtime = iob1->io_hwtime;
+#endif
+
   /* Handle special case where there are empty buffers at the head
    * the the list.
    */
 
-  while (iob1->io_len <= 0)
+  while (iob1 != NULL && iob1->io_len <= 0)
     {
       iob1 = iob1->io_flink;
     }
@@ -131,6 +139,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
 
       offset1 += ncopy;
       offset2 += ncopy;
+      iob2->io_len = offset2;
 
       /* Have we taken all of the data from the source I/O buffer? */
 
@@ -146,7 +155,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
 
               iob1 = iob1->io_flink;
             }
-          while (iob1->io_len <= 0);
+          while (iob1 != NULL && iob1->io_len <= 0);
 
           /* Reset the offset to the beginning of the I/O buffer */
 
@@ -157,7 +166,7 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
        * transferred?
        */
 
-       if (offset2 >= CONFIG_IOB_BUFSIZE && iob1 != NULL)
+      if (offset2 >= CONFIG_IOB_BUFSIZE && iob1 != NULL)
         {
           FAR struct iob_s *next;
 
@@ -165,7 +174,15 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
            * destination I/O buffer chain.
            */
 
-          next = iob_alloc(throttled);
+          if (can_block)
+            {
+              next = iob_alloc_user(throttled, IOB_USER(iob2));
+            }
+          else
+            {
+              next = iob_tryalloc_user(throttled, IOB_USER(iob2));
+            }
+
           if (!next)
             {
               nerr("ERROR: Failed to allocate an I/O buffer/n");
@@ -178,5 +195,38 @@ int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
         }
     }
 
-  return 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_clone
+ *
+ * Description:
+ *   Duplicate (and pack) the data in iob1 in iob2.  iob2 must be empty.
+ *
+ ****************************************************************************/
+
+int iob_clone(FAR struct iob_s *iob1, FAR struct iob_s *iob2, bool throttled)
+{
+  return iob_clone_internal(iob1, iob2, throttled, true);
+}
+
+/****************************************************************************
+ * Name: iob_tryclone
+ *
+ * Description:
+ *   Duplicate (and pack) the data in iob1 in iob2 BUT without waiting if
+ *   buffers are not available.  iob2 must be empty.  On failure, any
+ *   buffers already added to iob2 are not freed.
+ *
+ ****************************************************************************/
+
+int iob_tryclone(FAR struct iob_s *iob1, FAR struct iob_s *iob2,
+                 bool throttled)
+{
+  return iob_clone_internal(iob1, iob2, throttled, false);
 }
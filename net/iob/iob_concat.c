@@ -66,18 +66,20 @@
 
 void iob_concat(FAR struct iob_s *iob1, FAR struct iob_s *iob2)
 {
+  FAR struct iob_s *last = iob1;
+
   /* Find the last buffer in the iob1 buffer chain */
 
-  while (iob1->io_flink)
+  while (last->io_flink)
     {
-      iob1 = iob1->io_flink;
+      last = last->io_flink;
     }
 
   /* Then connect iob2 buffer chain to the end of the iob1 chain */
 
-  iob1->io_flink = iob2;
+  last->io_flink = iob2;
 
-  /* Combine the total packet size */
+  /* Combine the total packet size in the head of the chain */
 
   iob1->io_pktlen += iob2->io_pktlen;
 }
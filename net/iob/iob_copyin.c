@@ -211,11 +211,11 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
           if (!can_block || len < total)
             {
-              next = iob_tryalloc(throttled);
+              next = iob_tryalloc_user(throttled, IOB_USER(head));
             }
           else
             {
-              next = iob_alloc(throttled);
+              next = iob_alloc_user(throttled, IOB_USER(head));
             }
 
           if (next == NULL)
@@ -116,6 +116,21 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
   flags = enter_critical_section();
   iob->io_flink = g_iob_freelist;
   g_iob_freelist = iob;
+  IOB_COUNT_FREE();
+
+#ifdef CONFIG_IOB_QUOTA
+  /* The buffer no longer counts against its user.  Wake up a task that may
+   * be waiting because of a quota or reservation.
+   */
+
+  DEBUGASSERT(g_iob_usage[iob->io_user] > 0);
+  g_iob_usage[iob->io_user]--;
+
+  if (g_iob_quotasem.semcount < 0)
+    {
+      sem_post(&g_iob_quotasem);
+    }
+#endif
 
   /* Signal that an IOB is available */
 
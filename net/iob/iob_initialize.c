@@ -88,6 +88,28 @@ sem_t g_throttle_sem;       /* Counts available I/O buffers when throttled */
 sem_t g_qentry_sem;         /* Counts free I/O buffer queue containers */
 #endif
 
+#ifdef CONFIG_IOB_QUOTA
+/* The number of I/O buffers held by each user and a semaphore to wait on
+ * when an allocation is refused because of a quota or reservation.
+ */
+
+uint16_t g_iob_usage[IOBUSER_NUSERS];
+sem_t g_iob_quotasem;
+#endif
+
+#ifdef CONFIG_IOB_GROWTH
+/* The number of I/O buffers that exist, pre-allocated or not */
+
+uint16_t g_iob_nbuffers = CONFIG_IOB_NBUFFERS;
+#endif
+
+#ifdef CONFIG_IOB_HIGHWATER
+/* The number of I/O buffers in use and the largest number in use */
+
+uint16_t g_iob_nused;
+uint16_t g_iob_hwm;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -127,6 +149,10 @@ void iob_initialize(void)
       sem_init(&g_throttle_sem, 0, CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE);
 #endif
 
+#ifdef CONFIG_IOB_QUOTA
+      sem_init(&g_iob_quotasem, 0, 0);
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
       /* Add each I/O buffer chain queue container to the free list */
 
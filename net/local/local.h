@@ -74,6 +74,20 @@
 #define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
 #define LOCAL_END_BYTE    0xbd     /* End of sync seqence */
 
+/* True if lc_proto is a connection-oriented socket type */
+
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+#  define LOCAL_CONNPROTO(p) ((p) == SOCK_STREAM || (p) == SOCK_SEQPACKET)
+#else
+#  define LOCAL_CONNPROTO(p) ((p) == SOCK_STREAM)
+#endif
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+/* Size of a direct transport message holding 'n' bytes of data */
+
+#  define SIZEOF_LOCAL_MSG_S(n) (sizeof(struct local_msg_s) + (n) - 1)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -107,6 +121,21 @@ enum local_state_s
   LOCAL_STATE_DISCONNECTED     /* Peer disconnected */
 };
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+/* One message queued on a receiving socket by the direct transport.  A
+ * SOCK_STREAM receiver may consume a message in several pieces; lm_offset
+ * is the offset to the first unread byte.
+ */
+
+struct local_msg_s
+{
+  sq_entry_t lm_node;          /* Supports a singly linked list */
+  uint16_t lm_len;             /* Length of the message data */
+  uint16_t lm_offset;          /* Offset to the first unread byte */
+  uint8_t lm_data[1];          /* Message data (actual size is lm_len) */
+};
+#endif
+
 /* Representation of a local connection.  There are four types of
  * connection structures:
  *
@@ -146,6 +175,21 @@ struct local_conn_s
   int32_t lc_instance_id;      /* Connection instance ID for stream
                                 * server<->client connection pair */
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Direct transport.  Data sent to this socket is queued in lc_rxq.  The
+   * sender waits on its own lc_txsem for space in the receiver so that it
+   * never sleeps on a structure that its peer may free.
+   */
+
+  FAR struct local_conn_s *lc_peer; /* Connected peer (NULL if none) */
+  sq_queue_t lc_rxq;           /* Queue of struct local_msg_s */
+  uint16_t lc_rxbytes;         /* Number of unread bytes in lc_rxq */
+  uint8_t lc_nrxwait;          /* Number of threads waiting on lc_rxsem */
+  uint8_t lc_ntxwait;          /* Number of threads waiting on lc_txsem */
+  sem_t lc_rxsem;              /* Used to wait for data */
+  sem_t lc_txsem;              /* Used to wait for space in the peer */
+#endif
+
 #ifdef CONFIG_NET_LOCAL_STREAM
   /* SOCK_STREAM fields common to both client and server */
 
@@ -153,7 +197,8 @@ struct local_conn_s
 
 #ifdef HAVE_LOCAL_POLL
   /* The following is a list if poll structures of threads waiting for
-   * socket accept events.
+   * socket accept events (or, with the direct transport, for data events
+   * on a connected peer).
    */
 
   struct pollfd *lc_accept_fds[LOCAL_ACCEPT_NPOLLWAITERS];
@@ -210,6 +255,12 @@ extern "C"
 EXTERN dq_queue_t g_local_listeners;
 #endif
 
+#if defined(CONFIG_NET_LOCAL_DIRECT) && defined(CONFIG_NET_LOCAL_DGRAM)
+/* A list of all SOCK_DGRAM connections bound to a path name */
+
+EXTERN dq_queue_t g_local_dgrams;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -633,6 +684,113 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
                       bool nonblock);
 #endif
 
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Queue data directly on the connected peer of a SOCK_STREAM or
+ *   SOCK_SEQPACKET socket.  A SOCK_STREAM send may be queued in several
+ *   pieces as space becomes available; a SOCK_SEQPACKET message is always
+ *   queued as a whole.
+ *
+ * Parameters:
+ *   conn     The sending connection
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   nonblock True: Don't wait for space in the peer
+ *
+ * Return:
+ *   The number of bytes sent on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_direct_send(FAR struct local_conn_s *conn,
+                          FAR const void *buf, size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_sendto
+ *
+ * Description:
+ *   Queue one datagram directly on the SOCK_DGRAM socket bound to 'path'.
+ *
+ * Return:
+ *   The number of bytes sent on success; a negated errno value on failure.
+ *   -ECONNREFUSED is returned if no socket is bound to 'path'.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DIRECT) && defined(CONFIG_NET_LOCAL_DGRAM)
+ssize_t local_direct_sendto(FAR const char *path, FAR const void *buf,
+                            size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_recv
+ *
+ * Description:
+ *   Receive data queued on the socket by the direct transport.  A
+ *   SOCK_STREAM receive returns as much of the queued data as will fit in
+ *   the buffer.  Otherwise, one message is returned and any part of it that
+ *   does not fit is discarded.
+ *
+ * Parameters:
+ *   conn     The receiving connection
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   nonblock True: Don't wait for data
+ *
+ * Return:
+ *   The number of bytes received on success; zero if the peer of a
+ *   connected socket has closed and all queued data has been read; a
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_direct_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                          size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_bind
+ *
+ * Description:
+ *   Make a SOCK_DGRAM socket that was just bound to a path name reachable
+ *   by local_direct_sendto().
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DIRECT) && defined(CONFIG_NET_LOCAL_DGRAM)
+void local_direct_bind(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_release
+ *
+ * Description:
+ *   Disconnect the socket from its peer, waking up any threads waiting on
+ *   the peer, and discard all data queued on the socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+void local_direct_release(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_pollevents
+ *
+ * Description:
+ *   Return the poll events that are currently true for a connected socket
+ *   that uses the direct transport.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DIRECT) && defined(HAVE_LOCAL_POLL)
+pollevent_t local_direct_pollevents(FAR struct local_conn_s *conn);
+#endif
 
 /****************************************************************************
  * Name: local_accept_pollnotify
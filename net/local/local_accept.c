@@ -117,6 +117,9 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
   FAR struct local_conn_s *server;
   FAR struct local_conn_s *client;
   FAR struct local_conn_s *conn;
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  net_lock_t state;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -124,7 +127,7 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
   DEBUGASSERT(psock && psock->s_conn);
   server = (FAR struct local_conn_s *)psock->s_conn;
 
-  if (server->lc_proto != SOCK_STREAM ||
+  if (!LOCAL_CONNPROTO(server->lc_proto) ||
       server->lc_state != LOCAL_STATE_LISTENING ||
       server->lc_type  != LOCAL_TYPE_PATHNAME)
     {
@@ -164,7 +167,7 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               /* Initialize the new connection structure */
 
               conn->lc_crefs  = 1;
-              conn->lc_proto  = SOCK_STREAM;
+              conn->lc_proto  = server->lc_proto;
               conn->lc_type   = LOCAL_TYPE_PATHNAME;
               conn->lc_state  = LOCAL_STATE_CONNECTED;
 
@@ -172,6 +175,17 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               conn->lc_path[UNIX_PATH_MAX-1] = '\0';
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+              /* Link the new connection and the client to each other.  Data
+               * will be queued directly on the peer; no FIFOs are needed.
+               */
+
+              state           = net_lock();
+              conn->lc_peer   = client;
+              client->lc_peer = conn;
+              net_unlock(state);
+              ret = OK;
+#else
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -183,8 +197,10 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                    nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
                         conn->lc_path, ret);
                 }
+#endif
             }
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
           /* Do we have a connection?  Is the write-side FIFO opened? */
 
           if (ret == OK)
@@ -210,7 +226,11 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
           if (ret == OK)
             {
               DEBUGASSERT(conn->lc_infd >= 0);
+            }
+#endif
 
+          if (ret == OK)
+            {
               /* Return the address family */
 
               if (addr)
@@ -225,6 +245,19 @@ int psock_local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
               *newconn = (FAR void *)conn;
             }
+#ifdef CONFIG_NET_LOCAL_DIRECT
+          else if (conn != NULL)
+            {
+              /* Unlink the client from the connection that was not
+               * accepted.
+               */
+
+              state           = net_lock();
+              conn->lc_peer   = NULL;
+              client->lc_peer = NULL;
+              net_unlock(state);
+            }
+#endif
 
           /* Signal the client with the result of the connection */
 
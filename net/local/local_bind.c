@@ -114,6 +114,16 @@ int psock_local_bind(FAR struct socket *psock,
     }
 
   conn->lc_state = LOCAL_STATE_BOUND;
+
+#if defined(CONFIG_NET_LOCAL_DIRECT) && defined(CONFIG_NET_LOCAL_DGRAM)
+  /* Make the datagram socket reachable by its new name */
+
+  if (conn->lc_proto == SOCK_DGRAM)
+    {
+      local_direct_bind(conn);
+    }
+#endif
+
   return OK;
 }
 
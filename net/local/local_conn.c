@@ -69,6 +69,9 @@ void local_initialize(void)
 #ifdef CONFIG_NET_LOCAL_STREAM
   dq_init(&g_local_listeners);
 #endif
+#if defined(CONFIG_NET_LOCAL_DIRECT) && defined(CONFIG_NET_LOCAL_DGRAM)
+  dq_init(&g_local_dgrams);
+#endif
 }
 
 /****************************************************************************
@@ -97,6 +100,11 @@ FAR struct local_conn_s *local_alloc(void)
 #ifdef HAVE_LOCAL_POLL
       memset(conn->lc_accept_fds, 0, sizeof(conn->lc_accept_fds));
 #endif
+#endif
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      sq_init(&conn->lc_rxq);
+      sem_init(&conn->lc_rxsem, 0, 0);
+      sem_init(&conn->lc_txsem, 0, 0);
 #endif
     }
 
@@ -116,6 +124,14 @@ void local_free(FAR struct local_conn_s *conn)
 {
   DEBUGASSERT(conn != NULL);
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Disconnect from the peer and discard any unread data */
+
+  local_direct_release(conn);
+  sem_destroy(&conn->lc_rxsem);
+  sem_destroy(&conn->lc_txsem);
+#endif
+
   /* Make sure that the read-only FIFO is closed */
 
   if (conn->lc_infd >= 0)
@@ -148,6 +148,7 @@ int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -175,6 +176,7 @@ int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_outfd >= 0);
+#endif
 
   /* Add ourself to the list of waiting connections and notify the server. */
 
@@ -199,9 +201,21 @@ int inline local_stream_connect(FAR struct local_conn_s *client,
   if (ret < 0)
     {
       nerr("ERROR: Failed to connect: %d\n", ret);
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      client->lc_state = LOCAL_STATE_BOUND;
+      return ret;
+#else
       goto errout_with_outfd;
+#endif
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* The server has linked us to the new peer connection.  There are no
+   * FIFOs to open.
+   */
+
+  DEBUGASSERT(client->lc_peer != NULL);
+#else
   /* Yes.. open the read-only FIFO */
 
   ret = local_open_client_rx(client, nonblock);
@@ -213,9 +227,12 @@ int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_infd >= 0);
+#endif
+
   client->lc_state = LOCAL_STATE_CONNECTED;
   return OK;
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
 errout_with_outfd:
   (void)close(client->lc_outfd);
   client->lc_outfd = -1;
@@ -224,6 +241,7 @@ errout_with_fifos:
   (void)local_release_fifos(client);
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
+#endif
 }
 
 /****************************************************************************
@@ -280,7 +298,7 @@ int psock_local_connect(FAR struct socket *psock,
        */
 
       DEBUGASSERT(conn->lc_state == LOCAL_STATE_LISTENING &&
-                  conn->lc_proto == SOCK_STREAM);
+                  LOCAL_CONNPROTO(conn->lc_proto));
 
       /* Handle according to the server connection type */
 
@@ -301,6 +319,14 @@ int psock_local_connect(FAR struct socket *psock,
               {
                 int ret = OK;
 
+                /* The server must be of the same socket type */
+
+                if (conn->lc_proto != psock->s_type)
+                  {
+                    net_unlock(state);
+                    return -EPROTOTYPE;
+                  }
+
                 /* Bind the address and protocol */
 
                 client->lc_proto = conn->lc_proto;
@@ -314,7 +340,7 @@ int psock_local_connect(FAR struct socket *psock,
 
                 /* We have to do more for the SOCK_STREAM family */
 
-                if (conn->lc_proto == SOCK_STREAM)
+                if (LOCAL_CONNPROTO(conn->lc_proto))
                   {
                     ret = local_stream_connect(client, conn,
                                                _SS_ISNONBLOCK(psock->s_flags),
@@ -0,0 +1,666 @@
+/****************************************************************************
+ * net/local/local_direct.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_DIRECT)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/* Free space in the receive queue of a connection */
+
+#define local_direct_space(c) \
+  ((size_t)(CONFIG_NET_LOCAL_DIRECT_RCVBUF - (c)->lc_rxbytes))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+/* A list of all SOCK_DGRAM connections bound to a path name */
+
+dq_queue_t g_local_dgrams;
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+/* Datagram senders are not connected to the receiver, which may be freed
+ * while they wait.  They wait here instead and look the receiver up again
+ * when they are awakened.
+ */
+
+static sem_t g_local_dgsem = SEM_INITIALIZER(0);
+static uint8_t g_local_ndgwait;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_direct_wait
+ *
+ * Description:
+ *   Wait on 'sem' with the network unlocked.  'nwaiters' counts the threads
+ *   waiting on the semaphore.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int local_direct_wait(FAR sem_t *sem, FAR uint8_t *nwaiters)
+{
+  int ret;
+
+  DEBUGASSERT(*nwaiters < UINT8_MAX);
+  (*nwaiters)++;
+
+  ret = net_lockedwait(sem);
+  if (ret < 0)
+    {
+      ret = -get_errno();
+
+      /* We were not awakened by local_direct_wakeup(), so we are still
+       * counted.
+       */
+
+      if (*nwaiters > 0)
+        {
+          (*nwaiters)--;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on 'sem'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void local_direct_wakeup(FAR sem_t *sem, FAR uint8_t *nwaiters)
+{
+  while (*nwaiters > 0)
+    {
+      (*nwaiters)--;
+      sem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_direct_queue
+ *
+ * Description:
+ *   Copy 'len' bytes into a new message and add it to the receive queue of
+ *   'dest'.  The caller has verified that there is space.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int local_direct_queue(FAR struct local_conn_s *dest,
+                              FAR const uint8_t *buf, size_t len)
+{
+  FAR struct local_msg_s *msg;
+
+  DEBUGASSERT(len <= local_direct_space(dest));
+
+  msg = (FAR struct local_msg_s *)kmm_malloc(SIZEOF_LOCAL_MSG_S(len));
+  if (msg == NULL)
+    {
+      nerr("ERROR: Failed to allocate a %d byte message\n", (int)len);
+      return -ENOMEM;
+    }
+
+  msg->lm_len    = len;
+  msg->lm_offset = 0;
+  memcpy(msg->lm_data, buf, len);
+
+  sq_addlast(&msg->lm_node, &dest->lc_rxq);
+  dest->lc_rxbytes += len;
+
+  /* Wake up any receivers */
+
+  local_direct_wakeup(&dest->lc_rxsem, &dest->lc_nrxwait);
+  local_accept_pollnotify(dest, POLLIN);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_direct_txready
+ *
+ * Description:
+ *   Space has become available in the receive queue of 'conn'.  Wake up
+ *   the threads that may be waiting to send to it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void local_direct_txready(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer;
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (conn->lc_proto == SOCK_DGRAM)
+    {
+      local_direct_wakeup(&g_local_dgsem, &g_local_ndgwait);
+      return;
+    }
+#endif
+
+  peer = conn->lc_peer;
+  if (peer != NULL)
+    {
+      local_direct_wakeup(&peer->lc_txsem, &peer->lc_ntxwait);
+      local_accept_pollnotify(peer, POLLOUT);
+    }
+}
+
+/****************************************************************************
+ * Name: local_direct_unlist
+ *
+ * Description:
+ *   Remove a connection from the list of bound SOCK_DGRAM connections if it
+ *   is there.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+static void local_direct_unlist(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *curr;
+
+  for (curr = (FAR struct local_conn_s *)g_local_dgrams.head;
+       curr != NULL;
+       curr = (FAR struct local_conn_s *)dq_next(&curr->lc_node))
+    {
+      if (curr == conn)
+        {
+          dq_rem(&conn->lc_node, &g_local_dgrams);
+          break;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: local_direct_find
+ *
+ * Description:
+ *   Find the SOCK_DGRAM connection bound to 'path'.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+static FAR struct local_conn_s *local_direct_find(FAR const char *path)
+{
+  FAR struct local_conn_s *conn;
+
+  for (conn = (FAR struct local_conn_s *)g_local_dgrams.head;
+       conn != NULL;
+       conn = (FAR struct local_conn_s *)dq_next(&conn->lc_node))
+    {
+      if (strncmp(conn->lc_path, path, UNIX_PATH_MAX-1) == 0)
+        {
+          return conn;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Queue data directly on the connected peer of a SOCK_STREAM or
+ *   SOCK_SEQPACKET socket.  A SOCK_STREAM send may be queued in several
+ *   pieces as space becomes available; a SOCK_SEQPACKET message is always
+ *   queued as a whole.
+ *
+ * Parameters:
+ *   conn     The sending connection
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   nonblock True: Don't wait for space in the peer
+ *
+ * Return:
+ *   The number of bytes sent on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_send(FAR struct local_conn_s *conn,
+                          FAR const void *buf, size_t len, bool nonblock)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)buf;
+  FAR struct local_conn_s *peer;
+  bool stream = (conn->lc_proto == SOCK_STREAM);
+  net_lock_t state;
+  size_t nsent = 0;
+  size_t space;
+  size_t chunk;
+  int ret = OK;
+
+  if (stream && len == 0)
+    {
+      return 0;
+    }
+
+  /* A message must fit in the receive queue of the peer as a whole */
+
+  if (!stream && len > CONFIG_NET_LOCAL_DIRECT_RCVBUF)
+    {
+      return -EMSGSIZE;
+    }
+
+  state = net_lock();
+  do
+    {
+      peer = conn->lc_peer;
+      if (peer == NULL)
+        {
+          /* The peer has closed the connection */
+
+          ret = -EPIPE;
+          break;
+        }
+
+      space = local_direct_space(peer);
+      if (stream ? space > 0 : space >= len)
+        {
+          chunk = stream ? MIN(space, len - nsent) : len;
+          ret   = local_direct_queue(peer, src + nsent, chunk);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nsent += chunk;
+        }
+      else if (nonblock)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+      else
+        {
+          /* Wait for the peer to receive some data or to close */
+
+          ret = local_direct_wait(&conn->lc_txsem, &conn->lc_ntxwait);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+    }
+  while (nsent < len);
+
+  net_unlock(state);
+
+  /* Report a partial send as success */
+
+  return nsent > 0 ? (ssize_t)nsent : (ssize_t)ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_sendto
+ *
+ * Description:
+ *   Queue one datagram directly on the SOCK_DGRAM socket bound to 'path'.
+ *
+ * Return:
+ *   The number of bytes sent on success; a negated errno value on failure.
+ *   -ECONNREFUSED is returned if no socket is bound to 'path'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+ssize_t local_direct_sendto(FAR const char *path, FAR const void *buf,
+                            size_t len, bool nonblock)
+{
+  FAR struct local_conn_s *dest;
+  net_lock_t state;
+  ssize_t ret;
+
+  if (len > CONFIG_NET_LOCAL_DIRECT_RCVBUF)
+    {
+      return -EMSGSIZE;
+    }
+
+  state = net_lock();
+  for (; ; )
+    {
+      dest = local_direct_find(path);
+      if (dest == NULL)
+        {
+          nerr("ERROR: No socket bound to %s\n", path);
+          ret = -ECONNREFUSED;
+          break;
+        }
+
+      if (local_direct_space(dest) >= len)
+        {
+          ret = local_direct_queue(dest, buf, len);
+          if (ret == OK)
+            {
+              ret = len;
+            }
+
+          break;
+        }
+
+      if (nonblock)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      ret = local_direct_wait(&g_local_dgsem, &g_local_ndgwait);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  net_unlock(state);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: local_direct_recv
+ *
+ * Description:
+ *   Receive data queued on the socket by the direct transport.  A
+ *   SOCK_STREAM receive returns as much of the queued data as will fit in
+ *   the buffer.  Otherwise, one message is returned and any part of it that
+ *   does not fit is discarded.
+ *
+ * Parameters:
+ *   conn     The receiving connection
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   nonblock True: Don't wait for data
+ *
+ * Return:
+ *   The number of bytes received on success; zero if the peer of a
+ *   connected socket has closed and all queued data has been read; a
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                          size_t len, bool nonblock)
+{
+  FAR uint8_t *dest = (FAR uint8_t *)buf;
+  FAR struct local_msg_s *msg;
+  net_lock_t state;
+  size_t nrecv = 0;
+  size_t ncopy;
+  int ret;
+
+  state = net_lock();
+
+  /* Wait for data */
+
+  while (sq_empty(&conn->lc_rxq))
+    {
+      if (LOCAL_CONNPROTO(conn->lc_proto) && conn->lc_peer == NULL)
+        {
+          /* The peer has closed the connection:  End of file */
+
+          net_unlock(state);
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          net_unlock(state);
+          return -EAGAIN;
+        }
+
+      ret = local_direct_wait(&conn->lc_rxsem, &conn->lc_nrxwait);
+      if (ret < 0)
+        {
+          net_unlock(state);
+          return ret;
+        }
+    }
+
+  if (conn->lc_proto == SOCK_STREAM)
+    {
+      /* Return data from as many messages as will fit */
+
+      while (nrecv < len &&
+             (msg = (FAR struct local_msg_s *)sq_peek(&conn->lc_rxq)) != NULL)
+        {
+          ncopy = MIN(msg->lm_len - msg->lm_offset, len - nrecv);
+          memcpy(dest + nrecv, &msg->lm_data[msg->lm_offset], ncopy);
+
+          nrecv            += ncopy;
+          msg->lm_offset   += ncopy;
+          conn->lc_rxbytes -= ncopy;
+
+          if (msg->lm_offset >= msg->lm_len)
+            {
+              (void)sq_remfirst(&conn->lc_rxq);
+              kmm_free(msg);
+            }
+        }
+    }
+  else
+    {
+      /* Return one message, discarding whatever does not fit */
+
+      msg   = (FAR struct local_msg_s *)sq_remfirst(&conn->lc_rxq);
+      nrecv = MIN(msg->lm_len, len);
+      memcpy(dest, msg->lm_data, nrecv);
+
+      conn->lc_rxbytes -= msg->lm_len;
+      kmm_free(msg);
+    }
+
+  local_direct_txready(conn);
+  net_unlock(state);
+  return nrecv;
+}
+
+/****************************************************************************
+ * Name: local_direct_bind
+ *
+ * Description:
+ *   Make a SOCK_DGRAM socket that was just bound to a path name reachable
+ *   by local_direct_sendto().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+void local_direct_bind(FAR struct local_conn_s *conn)
+{
+  net_lock_t state;
+
+  DEBUGASSERT(conn->lc_proto == SOCK_DGRAM);
+
+  /* The socket may be re-bound to a different name */
+
+  state = net_lock();
+  local_direct_unlist(conn);
+
+  if (conn->lc_type == LOCAL_TYPE_PATHNAME)
+    {
+      dq_addlast(&conn->lc_node, &g_local_dgrams);
+    }
+
+  net_unlock(state);
+}
+#endif
+
+/****************************************************************************
+ * Name: local_direct_release
+ *
+ * Description:
+ *   Disconnect the socket from its peer, waking up any threads waiting on
+ *   the peer, and discard all data queued on the socket.
+ *
+ ****************************************************************************/
+
+void local_direct_release(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer;
+  FAR sq_entry_t *msg;
+  net_lock_t state;
+
+  state = net_lock();
+
+  peer = conn->lc_peer;
+  if (peer != NULL)
+    {
+      /* The peer will see end-of-file once it has read its queued data and
+       * EPIPE if it tries to send.
+       */
+
+      DEBUGASSERT(peer->lc_peer == conn);
+      peer->lc_peer = NULL;
+      conn->lc_peer = NULL;
+
+      local_direct_wakeup(&peer->lc_rxsem, &peer->lc_nrxwait);
+      local_direct_wakeup(&peer->lc_txsem, &peer->lc_ntxwait);
+      local_accept_pollnotify(peer, POLLIN | POLLOUT | POLLHUP);
+    }
+
+#ifdef CONFIG_NET_LOCAL_DGRAM
+  if (conn->lc_proto == SOCK_DGRAM)
+    {
+      /* Waiting senders will fail to find the receiver when they retry */
+
+      local_direct_unlist(conn);
+      local_direct_wakeup(&g_local_dgsem, &g_local_ndgwait);
+    }
+#endif
+
+  /* Discard all unread data */
+
+  while ((msg = sq_remfirst(&conn->lc_rxq)) != NULL)
+    {
+      kmm_free(msg);
+    }
+
+  conn->lc_rxbytes = 0;
+  net_unlock(state);
+}
+
+/****************************************************************************
+ * Name: local_direct_pollevents
+ *
+ * Description:
+ *   Return the poll events that are currently true for a connected socket
+ *   that uses the direct transport.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+pollevent_t local_direct_pollevents(FAR struct local_conn_s *conn)
+{
+  pollevent_t eventset = 0;
+
+  if (!sq_empty(&conn->lc_rxq))
+    {
+      eventset |= POLLIN;
+    }
+
+  if (conn->lc_peer == NULL)
+    {
+      /* Reading will return end-of-file */
+
+      eventset |= POLLIN | POLLHUP;
+    }
+  else if (local_direct_space(conn->lc_peer) > 0)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+#endif
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_DIRECT */
@@ -90,7 +90,7 @@ int local_listen(FAR struct local_conn_s *server, int backlog)
 
   DEBUGASSERT(server);
 
-  if (server->lc_proto != SOCK_STREAM ||
+  if (!LOCAL_CONNPROTO(server->lc_proto) ||
       server->lc_state == LOCAL_STATE_UNBOUND ||
       server->lc_type != LOCAL_TYPE_PATHNAME)
     {
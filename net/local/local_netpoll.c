@@ -96,6 +96,15 @@ static int local_accept_pollsetup(FAR struct local_conn_s *conn,
         }
 
       eventset = 0;
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      if (conn->lc_state != LOCAL_STATE_LISTENING)
+        {
+          /* A connected peer using the direct transport */
+
+          eventset = local_direct_pollevents(conn);
+        }
+      else
+#endif
       if (dq_peek(&conn->u.server.lc_waiters) != NULL)
         {
           eventset |= POLLIN;
@@ -195,6 +204,17 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_accept_pollsetup(conn, fds, true);
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* There are no FIFOs to poll.  The direct transport notifies the same
+   * poll slots as a listening socket.
+   */
+
+  if (conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      return local_accept_pollsetup(conn, fds, true);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       fds->priv = NULL;
@@ -335,6 +355,13 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_accept_pollsetup(conn, fds, false);
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  if (conn->lc_state == LOCAL_STATE_CONNECTED)
+    {
+      return local_accept_pollsetup(conn, fds, false);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       return OK;
@@ -73,6 +73,7 @@
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
 static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
                            FAR size_t *readlen)
 {
@@ -118,6 +119,7 @@ static int psock_fifo_read(FAR struct socket *psock, FAR void *buf,
 
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Function: psock_stream_recvfrom
@@ -159,6 +161,17 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Receive the data queued directly on this socket */
+
+  ret = local_direct_recv(conn, buf, len, _SS_ISNONBLOCK(psock->s_flags));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  readlen = ret;
+#else
   /* The incoming FIFO should be open */
 
   DEBUGASSERT(conn->lc_infd >= 0);
@@ -199,6 +212,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   DEBUGASSERT(readlen <= conn->u.peer.lc_remaining);
   conn->u.peer.lc_remaining -= readlen;
+#endif
 
   /* Return the address family */
 
@@ -243,7 +257,9 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
                      FAR socklen_t *fromlen)
 {
   FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+#ifndef CONFIG_NET_LOCAL_DIRECT
   uint16_t pktlen;
+#endif
   size_t readlen;
   int ret;
 
@@ -263,6 +279,17 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return -EISCONN;
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Receive the next datagram queued directly on this socket */
+
+  ret = local_direct_recv(conn, buf, len, _SS_ISNONBLOCK(psock->s_flags));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  readlen = ret;
+#else
   /* The incoming FIFO should not be open */
 
   DEBUGASSERT(conn->lc_infd < 0);
@@ -354,6 +381,7 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
   /* Release our reference to the half duplex FIFO */
 
   (void)local_release_halfduplex(conn);
+#endif
 
   /* Return the address family */
 
@@ -368,6 +396,7 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   return readlen;
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
 errout_with_infd:
   /* Close the read-only file descriptor */
 
@@ -379,6 +408,7 @@ errout_with_halfduplex:
 
   (void)local_release_halfduplex(conn);
   return ret;
+#endif
 }
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
@@ -423,7 +453,7 @@ ssize_t psock_local_recvfrom(FAR struct socket *psock, FAR void *buf,
   /* Check for a stream socket */
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-  if (psock->s_type == SOCK_STREAM)
+  if (LOCAL_CONNPROTO(psock->s_type))
     {
       return psock_stream_recvfrom(psock, buf, len, flags, from, fromlen);
     }
@@ -88,7 +88,7 @@ int local_release(FAR struct local_conn_s *conn)
   if (conn->lc_state == LOCAL_STATE_CONNECTED ||
       conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
-      DEBUGASSERT(conn->lc_proto == SOCK_STREAM);
+      DEBUGASSERT(LOCAL_CONNPROTO(conn->lc_proto));
 
       /* Just free the connection structure */
     }
@@ -99,7 +99,7 @@ int local_release(FAR struct local_conn_s *conn)
     {
       FAR struct local_conn_s *client;
 
-      DEBUGASSERT(conn->lc_proto == SOCK_STREAM);
+      DEBUGASSERT(LOCAL_CONNPROTO(conn->lc_proto));
 
       /* Are there still clients waiting for a connection to the server? */
 
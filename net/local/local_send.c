@@ -47,6 +47,7 @@
 
 #include <nuttx/net/net.h>
 
+#include "socket/socket.h"
 #include "local/local.h"
 
 /****************************************************************************
@@ -76,11 +77,26 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
                          size_t len, int flags)
 {
   FAR struct local_conn_s *peer;
+#ifndef CONFIG_NET_LOCAL_DIRECT
   int ret;
+#endif
 
   DEBUGASSERT(psock && psock->s_conn && buf);
   peer = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Verify that this is a connected peer socket */
+
+  if (peer->lc_state != LOCAL_STATE_CONNECTED)
+    {
+      nerr("ERROR: not connected\n");
+      return -ENOTCONN;
+    }
+
+  /* Queue the data directly on the peer */
+
+  return local_direct_send(peer, buf, len, _SS_ISNONBLOCK(psock->s_flags));
+#else
   /* Verify that this is a connected peer socket and that it has opened the
    * outgoing FIFO for write-only access.
    */
@@ -99,6 +115,7 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
   /* If the send was successful, then the full packet will have been sent */
 
   return ret < 0 ? ret : len;
+#endif
 }
 
 #endif /* CONFIG_NET && CONFIG_NET_LOCAL_STREAM */
@@ -46,11 +46,13 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
 
 #ifdef CONFIG_NET_IPv6
 
@@ -64,6 +66,60 @@
 
 #define NEIGHBOR_MAXTIME 128
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+#  ifndef CONFIG_NET_IPv6_NCONF_HASHSIZE
+#    define CONFIG_NET_IPv6_NCONF_HASHSIZE 16
+#  endif
+
+#  if (CONFIG_NET_IPv6_NCONF_HASHSIZE & (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_IPv6_NCONF_HASHSIZE must be a power of two
+#  endif
+
+/* Hash on the interface identifier (the low-order 64 bits), folded so that
+ * the result does not depend on the host byte order.
+ */
+
+#  define NEIGHBOR_HASH(a) \
+     ((((a)[4] ^ (a)[5] ^ (a)[6] ^ (a)[7]) ^ \
+       (((a)[4] ^ (a)[5] ^ (a)[6] ^ (a)[7]) >> 8)) & \
+      (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1))
+#endif
+
+#ifdef CONFIG_NET_IPv6_NUD
+#  ifndef CONFIG_NET_IPv6_NUD_REACHABLE
+#    define CONFIG_NET_IPv6_NUD_REACHABLE 30
+#  endif
+
+#  ifndef CONFIG_NET_IPv6_NUD_DELAY
+#    define CONFIG_NET_IPv6_NUD_DELAY 5
+#  endif
+
+#  ifndef CONFIG_NET_IPv6_NUD_RETRANS
+#    define CONFIG_NET_IPv6_NUD_RETRANS 1000
+#  endif
+
+#  ifndef CONFIG_NET_IPv6_NUD_MAXSOLICIT
+#    define CONFIG_NET_IPv6_NUD_MAXSOLICIT 3
+#  endif
+
+#  ifndef CONFIG_NET_IPv6_NCONF_QLEN
+#    define CONFIG_NET_IPv6_NCONF_QLEN 3
+#  endif
+
+#  define NEIGHBOR_REACHABLE_TICKS SEC2TICK(CONFIG_NET_IPv6_NUD_REACHABLE)
+#  define NEIGHBOR_DELAY_TICKS     SEC2TICK(CONFIG_NET_IPv6_NUD_DELAY)
+#  define NEIGHBOR_RETRANS_TICKS   MSEC2TICK(CONFIG_NET_IPv6_NUD_RETRANS)
+
+/* Neighbor Unreachability Detection states (RFC 4861, section 7.3.2) */
+
+#  define NEIGHBOR_STATE_INCOMPLETE 0 /* Address resolution in progress */
+#  define NEIGHBOR_STATE_REACHABLE  1 /* Recently confirmed reachable */
+#  define NEIGHBOR_STATE_STALE      2 /* Not confirmed recently; unused */
+#  define NEIGHBOR_STATE_DELAY      3 /* Used while stale; wait for upper
+                                       * layer confirmation */
+#  define NEIGHBOR_STATE_PROBE      4 /* Being re-verified by solicitations */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -84,9 +140,24 @@ struct neighbor_addr_s
 
 struct neighbor_entry
 {
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR struct neighbor_entry *ne_flink; /* Next entry in the hash chain */
+#endif
   net_ipv6addr_t         ne_ipaddr;  /* IPv6 address of the Neighbor */
   struct neighbor_addr_s ne_addr;    /* Link layer address of the Neighbor */
   uint8_t                ne_time;    /* For aging, units of half seconds */
+#ifdef CONFIG_NET_IPv6_NUD
+  uint8_t                ne_state;   /* See NEIGHBOR_STATE_* definitions */
+  uint8_t                ne_nsolicit; /* Solicitations sent in this state */
+  uint8_t                ne_npending; /* Number of queued packets */
+  systime_t              ne_tstamp;  /* Time of the last state change or
+                                      * solicitation */
+  FAR struct net_driver_s *ne_dev;   /* Device used to reach the Neighbor */
+#ifdef CONFIG_NET_IPv6_NCONF_PENDING
+                                     /* Packets waiting for resolution */
+  FAR struct iob_s      *ne_pending[CONFIG_NET_IPv6_NCONF_QLEN];
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -99,6 +170,13 @@ struct neighbor_entry
 
 extern struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* The entries in use, hashed by IPv6 address and chained through ne_flink */
+
+extern FAR struct neighbor_entry *
+  g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -134,12 +212,48 @@ void neighbor_initialize(void);
  *
  * Returned Value:
  *   The Neighbor Table entry corresponding to the IPv6 address;  NULL is
- *   returned if there is no matching entry in the Neighbor Table.
+ *   returned if there is no matching entry in the Neighbor Table.  Entries
+ *   whose link layer address is still being resolved are not returned.
  *
  ****************************************************************************/
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_search
+ *
+ * Description:
+ *   Find any entry for the IPv6 address in the Neighbor Table, including
+ *   an entry whose link layer address is still being resolved.  This
+ *   interface is internal to the neighbor implementation.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry *neighbor_search(const net_ipv6addr_t ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Allocate a Neighbor Table entry for the IPv6 address, replacing the
+ *   oldest entry if there is no unused entry.  This interface is internal
+ *   to the neighbor implementation.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry *neighbor_alloc(const net_ipv6addr_t ipaddr);
+
+/****************************************************************************
+ * Name: neighbor_free
+ *
+ * Description:
+ *   Remove an entry from the Neighbor Table, discarding any packets queued
+ *   on it.  This interface is internal to the neighbor implementation.
+ *
+ ****************************************************************************/
+
+void neighbor_free(FAR struct neighbor_entry *neighbor);
+
 /****************************************************************************
  * Name: neighbor_add
  *
@@ -148,15 +262,20 @@ FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr);
  *   already there).
  *
  * Input Parameters:
- *   ipaddr - The IPv6 address of the mapping.
- *   addr   - The link layer address of the mapping
+ *   dev       - The device on which the mapping was learned
+ *   ipaddr    - The IPv6 address of the mapping.
+ *   addr      - The link layer address of the mapping
+ *   reachable - True if the mapping is known to be reachable (a solicited
+ *               Neighbor Advertisement); false if it was learned from
+ *               an unsolicited message.
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void neighbor_add(FAR net_ipv6addr_t ipaddr, FAR struct neighbor_addr_s *addr);
+void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
+                  FAR struct neighbor_addr_s *addr, bool reachable);
 
 /****************************************************************************
  * Name:  neighbor_lookup
@@ -172,6 +291,9 @@ void neighbor_add(FAR net_ipv6addr_t ipaddr, FAR struct neighbor_addr_s *addr);
  *   returned on success.  NULL is returned if there is no matching entry in
  *   the Neighbor Table.
  *
+ *   With CONFIG_NET_IPv6_NUD, this counts as use of the entry:  A STALE
+ *   entry moves to the DELAY state so that its reachability is verified.
+ *
  ****************************************************************************/
 
 FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr);
@@ -194,12 +316,83 @@ FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr);
 
 void neighbor_update(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_reachable
+ *
+ * Description:
+ *   Called by the upper layer protocols when they have confirmation that
+ *   a remote IPv6 address is reachable (for example, when a TCP ACK
+ *   acknowledges new data).  The Neighbor Table entry of the next hop
+ *   towards the address, which is the neighbor itself or the router, is
+ *   marked REACHABLE.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the confirmation was received
+ *   ipaddr - The remote IPv6 address
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NUD
+void neighbor_reachable(FAR struct net_driver_s *dev,
+                        const net_ipv6addr_t ipaddr);
+#else
+#  define neighbor_reachable(d,i)
+#endif
+
+/****************************************************************************
+ * Name: neighbor_pending_out
+ *
+ * Description:
+ *   Called from neighbor_out() when there is no usable Neighbor Table entry
+ *   for the next hop of the IPv6 packet in d_buf.  An INCOMPLETE entry is
+ *   created (if there is none) and a copy of the packet is queued on it
+ *   (with CONFIG_NET_IPv6_NCONF_PENDING) so that it can be sent as soon as
+ *   the address is resolved.
+ *
+ * Input Parameters:
+ *   dev    - The device used to send the packet
+ *   ipaddr - The IPv6 address to be resolved
+ *
+ * Returned Value:
+ *   True if the packet in d_buf should be replaced by a Neighbor
+ *   Solicitation; false if nothing should be sent now.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NUD
+bool neighbor_pending_out(FAR struct net_driver_s *dev,
+                          const net_ipv6addr_t ipaddr);
+#else
+#  define neighbor_pending_out(d,i) (true)
+#endif
+
+/****************************************************************************
+ * Name: neighbor_poll
+ *
+ * Description:
+ *   Send the Neighbor Solicitations that are due and the packets queued on
+ *   Neighbor Table entries that have been resolved.  Called from
+ *   devif_poll().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NUD
+int neighbor_poll(FAR struct net_driver_s *dev,
+                  devif_poll_callback_t callback);
+#else
+#  define neighbor_poll(d,c) (0)
+#endif
+
 /****************************************************************************
  * Name: neighbor_periodic
  *
  * Description:
  *   Called from the timer poll logic in order to perform agin operations on
- *   entries in the Neighbor Table
+ *   entries in the Neighbor Table.  With CONFIG_NET_IPv6_NUD, this also
+ *   runs the timers of the Neighbor Unreachability Detection state machine.
  *
  * Input Parameters:
  *   hsec - Elapsed time in half seconds since the last check
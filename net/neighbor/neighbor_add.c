@@ -46,8 +46,10 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
 
+#include "netdev/netdev.h"
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -62,19 +64,22 @@
  *   already there).
  *
  * Input Parameters:
- *   ipaddr - The IPv6 address of the mapping.
- *   addr   - The link layer address of the mapping
+ *   dev       - The device on which the mapping was learned
+ *   ipaddr    - The IPv6 address of the mapping.
+ *   addr      - The link layer address of the mapping
+ *   reachable - True if the mapping is known to be reachable (a solicited
+ *               Neighbor Advertisement); false if it was learned from
+ *               an unsolicited message.
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void neighbor_add(FAR net_ipv6addr_t ipaddr, FAR struct neighbor_addr_s *addr)
+void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
+                  FAR struct neighbor_addr_s *addr, bool reachable)
 {
-  uint8_t oldest_time;
-  int     oldest_ndx;
-  int     i;
+  FAR struct neighbor_entry *neighbor;
 
   ninfo("Add neighbor: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
         ntohs(ipaddr[0]), ntohs(ipaddr[1]), ntohs(ipaddr[2]),
@@ -88,37 +93,51 @@ void neighbor_add(FAR net_ipv6addr_t ipaddr, FAR struct neighbor_addr_s *addr)
         addr->na_addr.ether_addr_octet[4],
         addr->na_addr.ether_addr_octet[5]);
 
-  /* Find the first unused entry or the oldest used entry. */
-
-  oldest_time = 0;
-  oldest_ndx  = 0;
+  /* Update the existing entry for the address or, if there is none, use
+   * the first free entry or the oldest used entry.
+   */
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  neighbor = neighbor_search(ipaddr);
+  if (neighbor == NULL)
     {
-      if (g_neighbors[i].ne_time == NEIGHBOR_MAXTIME)
-        {
-          oldest_ndx = i;
-          break;
-        }
-
-      if (net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          break;
-        }
-
-      if (g_neighbors[i].ne_time > oldest_time)
-        {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
-        }
+      neighbor = neighbor_alloc(ipaddr);
     }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
+#ifdef CONFIG_NET_IPv6_NUD
+  /* A solicited advertisement confirms reachability.  Otherwise, the entry
+   * is STALE if the link layer address is new or changed; an unchanged
+   * entry keeps its state (RFC 4861, section 7.2.5).
    */
 
-  g_neighbors[oldest_ndx].ne_time = 0;
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
-  memcpy(&g_neighbors[oldest_ndx].ne_addr, addr, sizeof(struct neighbor_addr_s));
+  if (reachable)
+    {
+      neighbor->ne_state  = NEIGHBOR_STATE_REACHABLE;
+      neighbor->ne_tstamp = clock_systimer();
+    }
+  else if (neighbor->ne_state == NEIGHBOR_STATE_INCOMPLETE ||
+           memcmp(&neighbor->ne_addr, addr,
+                  sizeof(struct neighbor_addr_s)) != 0)
+    {
+      neighbor->ne_state  = NEIGHBOR_STATE_STALE;
+      neighbor->ne_tstamp = clock_systimer();
+    }
+
+  neighbor->ne_nsolicit = 0;
+  neighbor->ne_dev      = dev;
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDING
+  /* Packets waiting for the address can now be sent */
+
+  if (neighbor->ne_npending > 0)
+    {
+      netdev_txnotify_dev(dev);
+    }
+#endif
+#else
+  UNUSED(dev);
+  UNUSED(reachable);
+#endif
+
+  neighbor->ne_time = 0;
+  memcpy(&neighbor->ne_addr, addr, sizeof(struct neighbor_addr_s));
 }
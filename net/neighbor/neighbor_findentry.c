@@ -46,12 +46,61 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/net/iob.h>
+
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_search
+ *
+ * Description:
+ *   Find any entry for the IPv6 address in the Neighbor Table, including
+ *   an entry whose link layer address is still being resolved.  This
+ *   interface is internal to the neighbor implementation.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address to use in the lookup;
+ *
+ * Returned Value:
+ *   The Neighbor Table entry corresponding to the IPv6 address;  NULL is
+ *   returned if there is no matching entry in the Neighbor Table.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry *neighbor_search(const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_entry *neighbor;
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+
+  for (neighbor = g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
+       neighbor != NULL;
+       neighbor = neighbor->ne_flink)
+    {
+      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+        {
+          return neighbor;
+        }
+    }
+#else
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+    {
+      neighbor = &g_neighbors[i];
+      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+        {
+          return neighbor;
+        }
+    }
+#endif
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -64,37 +113,148 @@
  *
  * Returned Value:
  *   The Neighbor Table entry corresponding to the IPv6 address;  NULL is
- *   returned if there is no matching entry in the Neighbor Table.
+ *   returned if there is no matching entry in the Neighbor Table.  Entries
+ *   whose link layer address is still being resolved are not returned.
  *
  ****************************************************************************/
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry *neighbor;
 
   ninfo("Find neighbor: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
         ntohs(ipaddr[0]), ntohs(ipaddr[1]), ntohs(ipaddr[2]),
         ntohs(ipaddr[3]), ntohs(ipaddr[4]), ntohs(ipaddr[5]),
         ntohs(ipaddr[6]), ntohs(ipaddr[7]));
 
+  neighbor = neighbor_search(ipaddr);
+#ifdef CONFIG_NET_IPv6_NUD
+  if (neighbor != NULL && neighbor->ne_state != NEIGHBOR_STATE_INCOMPLETE)
+#else
+  if (neighbor != NULL)
+#endif
+    {
+      ninfo("  at: %02x:%02x:%02x:%02x:%02x:%02x\n",
+            neighbor->ne_addr.na_addr.ether_addr_octet[0],
+            neighbor->ne_addr.na_addr.ether_addr_octet[1],
+            neighbor->ne_addr.na_addr.ether_addr_octet[2],
+            neighbor->ne_addr.na_addr.ether_addr_octet[3],
+            neighbor->ne_addr.na_addr.ether_addr_octet[4],
+            neighbor->ne_addr.na_addr.ether_addr_octet[5]);
+
+      return neighbor;
+    }
+
+  ninfo("  Not found\n");
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Allocate a Neighbor Table entry for the IPv6 address, replacing the
+ *   oldest entry if there is no unused entry.  This interface is internal
+ *   to the neighbor implementation.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address of the new entry
+ *
+ * Returned Value:
+ *   The new entry.  Only the IPv6 address is initialized.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry *neighbor_alloc(const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_entry *neighbor;
+  uint8_t oldest_time;
+  int     oldest_ndx;
+  int     i;
+
+  /* Find the first unused entry or the oldest used entry. */
+
+  oldest_time = 0;
+  oldest_ndx  = 0;
+
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
-      FAR struct neighbor_entry *neighbor = &g_neighbors[i];
+      if (g_neighbors[i].ne_time == NEIGHBOR_MAXTIME)
+        {
+          oldest_ndx = i;
+          break;
+        }
 
-      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+      if (g_neighbors[i].ne_time > oldest_time)
         {
-          ninfo("  at: %02x:%02x:%02x:%02x:%02x:%02x\n",
-                neighbor->ne_addr.na_addr.ether_addr_octet[0],
-                neighbor->ne_addr.na_addr.ether_addr_octet[1],
-                neighbor->ne_addr.na_addr.ether_addr_octet[2],
-                neighbor->ne_addr.na_addr.ether_addr_octet[3],
-                neighbor->ne_addr.na_addr.ether_addr_octet[4],
-                neighbor->ne_addr.na_addr.ether_addr_octet[5]);
-
-          return &g_neighbors[i];
+          oldest_ndx = i;
+          oldest_time = g_neighbors[i].ne_time;
         }
     }
 
-  ninfo("  Not found\n");
-  return NULL;
+  /* Use the oldest or first free entry (either pointed to by the
+   * "oldest_ndx" variable).
+   */
+
+  neighbor = &g_neighbors[oldest_ndx];
+  neighbor_free(neighbor);
+
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+  neighbor->ne_time = 0;
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  /* Add the entry to its hash chain */
+
+  neighbor->ne_flink = g_neighbor_hash[NEIGHBOR_HASH(ipaddr)];
+  g_neighbor_hash[NEIGHBOR_HASH(ipaddr)] = neighbor;
+#endif
+
+  return neighbor;
+}
+
+/****************************************************************************
+ * Name: neighbor_free
+ *
+ * Description:
+ *   Remove an entry from the Neighbor Table, discarding any packets queued
+ *   on it.  This interface is internal to the neighbor implementation.
+ *
+ * Input Parameters:
+ *   neighbor - The entry to be removed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_free(FAR struct neighbor_entry *neighbor)
+{
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR struct neighbor_entry **link;
+
+  /* Remove the entry from its hash chain (if it is in use) */
+
+  for (link = &g_neighbor_hash[NEIGHBOR_HASH(neighbor->ne_ipaddr)];
+       *link != NULL;
+       link = &(*link)->ne_flink)
+    {
+      if (*link == neighbor)
+        {
+          *link = neighbor->ne_flink;
+          break;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDING
+  /* Discard the packets waiting for the address to be resolved */
+
+  while (neighbor->ne_npending > 0)
+    {
+      iob_free_chain(neighbor->ne_pending[--neighbor->ne_npending]);
+    }
+#endif
+
+  memset(neighbor, 0, sizeof(struct neighbor_entry));
+  neighbor->ne_time = NEIGHBOR_MAXTIME;
 }
@@ -42,6 +42,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <string.h>
+
 #include <nuttx/clock.h>
 
 #include "neighbor/neighbor.h"
@@ -56,6 +59,12 @@
 
 struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* The entries in use, hashed by IPv6 address and chained through ne_flink */
+
+FAR struct neighbor_entry *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,4 +94,8 @@ void neighbor_initialize(void)
     {
       g_neighbors[i].ne_time = NEIGHBOR_MAXTIME;
     }
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  memset(g_neighbor_hash, 0, sizeof(g_neighbor_hash));
+#endif
 }
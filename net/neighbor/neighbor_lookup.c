@@ -45,6 +45,7 @@
 
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/net/ip.h>
 
 #include "neighbor/neighbor.h"
@@ -67,6 +68,9 @@
  *   Returns OK if the address was successfully obtain; a negated errno
  *   value is returned on failure.
  *
+ *   With CONFIG_NET_IPv6_NUD, this counts as use of the entry:  A STALE
+ *   entry moves to the DELAY state so that its reachability is verified.
+ *
  ****************************************************************************/
 
 FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr)
@@ -84,6 +88,21 @@ FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr)
             neighbor->ne_addr.na_addr.ether_addr_octet[4],
             neighbor->ne_addr.na_addr.ether_addr_octet[5]);
 
+#ifdef CONFIG_NET_IPv6_NUD
+      /* Sending to a STALE neighbor starts the reachability check.  The
+       * entry is probed if no upper layer confirmation arrives within
+       * the delay time.
+       */
+
+      if (neighbor->ne_state == NEIGHBOR_STATE_STALE)
+        {
+          neighbor->ne_state  = NEIGHBOR_STATE_DELAY;
+          neighbor->ne_tstamp = clock_systimer();
+        }
+
+      neighbor->ne_time = 0;
+#endif
+
       return &neighbor->ne_addr;
     }
 
@@ -45,6 +45,7 @@
 #include <nuttx/net/arp.h>
 #include <nuttx/net/netdev.h>
 
+#include "utils/utils.h"
 #include "route/route.h"
 #include "icmpv6/icmpv6.h"
 #include "neighbor/neighbor.h"
@@ -101,37 +102,14 @@ static const uint8_t g_multicast_ethaddr[3] =
  ****************************************************************************/
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: neighbor_out
+ * Name: neighbor_out_internal
  *
  * Description:
- *   This function should be called before sending out an IPv6 packet. The
- *   function checks the destination IPv6 address of the IPv6 packet to see
- *   what Ethernet MAC address that should be used as a destination MAC
- *   address on the Ethernet.
- *
- *   If the destination IPv6 address is in the local network (determined
- *   by logical ANDing of netmask and our IPv6 address), the function
- *   checks the Neighbor Table to see if an entry for the destination IPv6
- *   address is found.  If so, an Ethernet header is pre-pended at the
- *   beginning of the packet and the function returns.
- *
- *   If no Neighbor Table entry is found for the destination IPv6 address,
- *   the packet in the d_buf[] is replaced by an ICMPv6 Neighbor Solicit
- *   request packet for the IPv6 address. The IPv6 packet is dropped and 
- *   it is assumed that the higher level protocols (e.g., TCP) eventually
- *   will retransmit the dropped packet.
- *
- *   Upon return in either the case, a packet to be sent is present in the
- *   d_buf[] buffer and the d_len field holds the length of the Ethernet
- *   frame that should be transmitted.
+ *   Implements neighbor_out() with the Neighbor Table locked.
  *
  ****************************************************************************/
 
-void neighbor_out(FAR struct net_driver_s *dev)
+static void neighbor_out_internal(FAR struct net_driver_s *dev)
 {
   FAR const struct neighbor_addr_s *naddr;
   FAR struct eth_hdr_s *eth = ETHBUF;
@@ -227,14 +205,30 @@ void neighbor_out(FAR struct net_driver_s *dev)
       naddr = neighbor_lookup(ipaddr);
       if (!naddr)
         {
+          /* The destination address was not in our Neighbor Table.  Queue
+           * a copy of the IPv6 packet until the address is resolved, if so
+           * configured, and check whether a solicitation may be sent now.
+           */
+
+          if (!neighbor_pending_out(dev, ipaddr))
+            {
+              dev->d_len = 0;
+#ifdef CONFIG_NET_IOBTX
+              dev->d_sndiob = NULL;
+#endif
+              return;
+            }
+
            ninfo("IPv6 Neighbor solicitation for IPv6\n");
 
-          /* The destination address was not in our Neighbor Table, so we
-           * overwrite the IPv6 packet with an ICMDv6 Neighbor Solicitation
+          /* Overwrite the IPv6 packet with an ICMDv6 Neighbor Solicitation
            * message.
            */
 
           icmpv6_solicit(dev, ipaddr);
+#ifdef CONFIG_NET_IOBTX
+          dev->d_sndiob = NULL;
+#endif
           return;
         }
 
@@ -256,3 +250,44 @@ void neighbor_out(FAR struct net_driver_s *dev)
   ninfo("Outgoing IPv6 Packet length: %d (%d)\n",
           dev->d_len, (ip->len[0] << 8) | ip->len[1]);
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_out
+ *
+ * Description:
+ *   This function should be called before sending out an IPv6 packet. The
+ *   function checks the destination IPv6 address of the IPv6 packet to see
+ *   what Ethernet MAC address that should be used as a destination MAC
+ *   address on the Ethernet.
+ *
+ *   If the destination IPv6 address is in the local network (determined
+ *   by logical ANDing of netmask and our IPv6 address), the function
+ *   checks the Neighbor Table to see if an entry for the destination IPv6
+ *   address is found.  If so, an Ethernet header is pre-pended at the
+ *   beginning of the packet and the function returns.
+ *
+ *   If no Neighbor Table entry is found for the destination IPv6 address,
+ *   the packet in the d_buf[] is replaced by an ICMPv6 Neighbor Solicit
+ *   request packet for the IPv6 address. The IPv6 packet is dropped and 
+ *   it is assumed that the higher level protocols (e.g., TCP) eventually
+ *   will retransmit the dropped packet.  With CONFIG_NET_IPv6_NCONF_PENDING,
+ *   a copy of the packet is kept and sent once the address is resolved;
+ *   with CONFIG_NET_IPv6_NUD, d_len is set to zero if the solicitation is
+ *   suppressed by the retransmission timer.
+ *
+ *   Upon return in either the case, a packet to be sent is present in the
+ *   d_buf[] buffer and the d_len field holds the length of the Ethernet
+ *   frame that should be transmitted.
+ *
+ ****************************************************************************/
+
+void neighbor_out(FAR struct net_driver_s *dev)
+{
+  net_protolock(NETLOCK_OTHER);
+  neighbor_out_internal(dev);
+  net_protounlock(NETLOCK_OTHER);
+}
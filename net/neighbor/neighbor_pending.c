@@ -0,0 +1,277 @@
+/****************************************************************************
+ * net/neighbor/neighbor_pending.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <net/if.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/iob.h>
+
+#include "iob/iob.h"
+#include "icmpv6/icmpv6.h"
+#include "neighbor/neighbor.h"
+
+#ifdef CONFIG_NET_IPv6_NUD
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv6BUF(dev) (&(dev)->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_solicit_due
+ *
+ * Description:
+ *   Return true if another Neighbor Solicitation should be sent for an
+ *   INCOMPLETE or PROBE entry.
+ *
+ ****************************************************************************/
+
+static bool neighbor_solicit_due(FAR struct neighbor_entry *neighbor,
+                                 systime_t now)
+{
+  return neighbor->ne_nsolicit == 0 ||
+         (neighbor->ne_nsolicit < CONFIG_NET_IPv6_NUD_MAXSOLICIT &&
+          now - neighbor->ne_tstamp >= NEIGHBOR_RETRANS_TICKS);
+}
+
+/****************************************************************************
+ * Name: neighbor_enqueue
+ *
+ * Description:
+ *   Keep a copy of the IPv6 packet in d_buf on an INCOMPLETE entry.  When
+ *   the queue is full, the oldest packet is discarded.  A packet whose
+ *   payload is in an I/O buffer chain owned by the sender (d_sndiob) is
+ *   not copied; the higher level protocols will retransmit it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDING
+static void neighbor_enqueue(FAR struct net_driver_s *dev,
+                             FAR struct neighbor_entry *neighbor)
+{
+  FAR struct iob_s *iob;
+
+#ifdef CONFIG_NET_IOBTX
+  if (dev->d_sndiob != NULL)
+    {
+      return;
+    }
+#endif
+
+  iob = iob_tryalloc_user(true, IOBUSER_NETDEV);
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  if (iob_trycopyin(iob, IPv6BUF(dev), dev->d_len, 0, true) != dev->d_len)
+    {
+      iob_free_chain(iob);
+      return;
+    }
+
+  if (neighbor->ne_npending >= CONFIG_NET_IPv6_NCONF_QLEN)
+    {
+      iob_free_chain(neighbor->ne_pending[0]);
+      memmove(&neighbor->ne_pending[0], &neighbor->ne_pending[1],
+              (CONFIG_NET_IPv6_NCONF_QLEN - 1) * sizeof(FAR struct iob_s *));
+      neighbor->ne_npending--;
+    }
+
+  neighbor->ne_pending[neighbor->ne_npending++] = iob;
+}
+#else
+#  define neighbor_enqueue(d,n)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_pending_out
+ *
+ * Description:
+ *   Called from neighbor_out() when there is no usable Neighbor Table entry
+ *   for the next hop of the IPv6 packet in d_buf.  An INCOMPLETE entry is
+ *   created (if there is none) and a copy of the packet is queued on it
+ *   (with CONFIG_NET_IPv6_NCONF_PENDING) so that it can be sent as soon as
+ *   the address is resolved.
+ *
+ * Input Parameters:
+ *   dev    - The device used to send the packet
+ *   ipaddr - The IPv6 address to be resolved
+ *
+ * Returned Value:
+ *   True if the packet in d_buf should be replaced by a Neighbor
+ *   Solicitation; false if nothing should be sent now.  Solicitations are
+ *   sent no more often than once every CONFIG_NET_IPv6_NUD_RETRANS
+ *   milliseconds and no more than CONFIG_NET_IPv6_NUD_MAXSOLICIT times.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool neighbor_pending_out(FAR struct net_driver_s *dev,
+                          const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_entry *neighbor;
+  systime_t now = clock_systimer();
+
+  /* neighbor_lookup() failed, so any existing entry is INCOMPLETE */
+
+  neighbor = neighbor_search(ipaddr);
+  if (neighbor == NULL)
+    {
+      neighbor            = neighbor_alloc(ipaddr);
+      neighbor->ne_state  = NEIGHBOR_STATE_INCOMPLETE;
+      neighbor->ne_tstamp = now;
+      neighbor->ne_dev    = dev;
+    }
+
+  neighbor_enqueue(dev, neighbor);
+
+  if (!neighbor_solicit_due(neighbor, now))
+    {
+      return false;
+    }
+
+  neighbor->ne_nsolicit++;
+  neighbor->ne_tstamp = now;
+  return true;
+}
+
+/****************************************************************************
+ * Name: neighbor_poll
+ *
+ * Description:
+ *   Send the Neighbor Solicitations that are due and the packets queued on
+ *   Neighbor Table entries that have been resolved.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() and the network is locked.
+ *
+ ****************************************************************************/
+
+int neighbor_poll(FAR struct net_driver_s *dev,
+                  devif_poll_callback_t callback)
+{
+  FAR struct neighbor_entry *neighbor;
+  systime_t now = clock_systimer();
+  int bstop = false;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES && !bstop; i++)
+    {
+      neighbor = &g_neighbors[i];
+      if (neighbor->ne_dev != dev)
+        {
+          continue;
+        }
+
+#ifdef CONFIG_NET_IPv6_NCONF_PENDING
+      /* Send the packets that were waiting for the link layer address.
+       * The driver adds the Ethernet header through neighbor_out().
+       */
+
+      while (neighbor->ne_state != NEIGHBOR_STATE_INCOMPLETE &&
+             neighbor->ne_npending > 0 && !bstop)
+        {
+          FAR struct iob_s *iob = neighbor->ne_pending[0];
+
+          neighbor->ne_npending--;
+          memmove(&neighbor->ne_pending[0], &neighbor->ne_pending[1],
+                  neighbor->ne_npending * sizeof(FAR struct iob_s *));
+
+          dev->d_len = iob_copyout(IPv6BUF(dev), iob, iob->io_pktlen, 0);
+#ifdef CONFIG_NET_IOBTX
+          dev->d_sndiob = NULL;
+#endif
+          iob_free_chain(iob);
+
+          IFF_SET_IPv6(dev->d_flags);
+          bstop = callback(dev);
+        }
+#endif
+
+      /* Send the next Neighbor Solicitation of an unresolved or unconfirmed
+       * neighbor.
+       */
+
+      if (!bstop &&
+          (neighbor->ne_state == NEIGHBOR_STATE_INCOMPLETE ||
+           neighbor->ne_state == NEIGHBOR_STATE_PROBE) &&
+          neighbor_solicit_due(neighbor, now))
+        {
+          ninfo("Neighbor solicitation %d\n", neighbor->ne_nsolicit + 1);
+
+          icmpv6_solicit(dev, neighbor->ne_ipaddr);
+#ifdef CONFIG_NET_IOBTX
+          dev->d_sndiob = NULL;
+#endif
+          neighbor->ne_nsolicit++;
+          neighbor->ne_tstamp = now;
+
+          /* The Ethernet header is already in place */
+
+          IFF_SET_IPv6(dev->d_flags);
+          IFF_SET_NOARP(dev->d_flags);
+          bstop = callback(dev);
+        }
+    }
+
+  return bstop;
+}
+
+#endif /* CONFIG_NET_IPv6_NUD */
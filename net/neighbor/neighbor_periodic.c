@@ -43,6 +43,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/clock.h>
+
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -54,7 +56,15 @@
  *
  * Description:
  *   Called from the timer poll logic in order to perform agin operations on
- *   entries in the Neighbor Table
+ *   entries in the Neighbor Table.  With CONFIG_NET_IPv6_NUD, this also
+ *   runs the timers of the Neighbor Unreachability Detection state machine:
+ *
+ *   REACHABLE -> STALE when the reachable time expires without
+ *                confirmation.
+ *   DELAY     -> PROBE when the delay time expires without confirmation.
+ *                The solicitations are then sent by neighbor_poll().
+ *   INCOMPLETE, PROBE -> removed when the last solicitation is not
+ *                answered.
  *
  * Input Parameters:
  *   hsec - Elapsed time in half seconds since the last check
@@ -66,6 +76,11 @@
 
 void neighbor_periodic(int hsec)
 {
+#ifdef CONFIG_NET_IPv6_NUD
+  FAR struct neighbor_entry *neighbor;
+  systime_t now = clock_systimer();
+  systime_t elapsed;
+#endif
   int i;
 
   /* Only perform the aging when more than a half second has elapsed */
@@ -87,4 +102,56 @@ void neighbor_periodic(int hsec)
           g_neighbors[i].ne_time = newtime;
         }
     }
+
+#ifdef CONFIG_NET_IPv6_NUD
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+    {
+      neighbor = &g_neighbors[i];
+      if (neighbor->ne_dev == NULL)
+        {
+          /* This entry is not in use */
+
+          continue;
+        }
+
+      elapsed = now - neighbor->ne_tstamp;
+      switch (neighbor->ne_state)
+        {
+          case NEIGHBOR_STATE_REACHABLE:
+            if (elapsed >= NEIGHBOR_REACHABLE_TICKS)
+              {
+                neighbor->ne_state  = NEIGHBOR_STATE_STALE;
+                neighbor->ne_tstamp = now;
+              }
+            break;
+
+          case NEIGHBOR_STATE_DELAY:
+            if (elapsed >= NEIGHBOR_DELAY_TICKS)
+              {
+                /* Make the first probe due immediately */
+
+                neighbor->ne_state    = NEIGHBOR_STATE_PROBE;
+                neighbor->ne_nsolicit = 0;
+                neighbor->ne_tstamp   = now - NEIGHBOR_RETRANS_TICKS;
+              }
+            break;
+
+          case NEIGHBOR_STATE_INCOMPLETE:
+          case NEIGHBOR_STATE_PROBE:
+            if (neighbor->ne_nsolicit >= CONFIG_NET_IPv6_NUD_MAXSOLICIT &&
+                elapsed >= NEIGHBOR_RETRANS_TICKS)
+              {
+                /* The neighbor did not answer.  Forget it (and discard
+                 * any packets waiting for it).
+                 */
+
+                neighbor_free(neighbor);
+              }
+            break;
+
+          default:
+            break;
+        }
+    }
+#endif
 }
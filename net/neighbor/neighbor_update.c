@@ -43,6 +43,12 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netdev.h>
+
+#include "route/route.h"
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -55,7 +61,8 @@
  * Description:
  *   Reset time on the Neighbor Table entry associated with the IPv6 address.
  *   This makes the associated entry the most recently used and not a
- *   candidate for removal.
+ *   candidate for removal.  With CONFIG_NET_IPv6_NUD, the entry is also
+ *   confirmed REACHABLE.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address of the entry to be updated
@@ -73,5 +80,55 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   if (neighbor != NULL)
     {
       neighbor->ne_time = 0;
+
+#ifdef CONFIG_NET_IPv6_NUD
+      neighbor->ne_state    = NEIGHBOR_STATE_REACHABLE;
+      neighbor->ne_nsolicit = 0;
+      neighbor->ne_tstamp   = clock_systimer();
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: neighbor_reachable
+ *
+ * Description:
+ *   Called by the upper layer protocols when they have confirmation that
+ *   a remote IPv6 address is reachable (for example, when a TCP ACK
+ *   acknowledges new data).  The Neighbor Table entry of the next hop
+ *   towards the address, which is the neighbor itself or the router, is
+ *   marked REACHABLE.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the confirmation was received
+ *   ipaddr - The remote IPv6 address
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NUD
+void neighbor_reachable(FAR struct net_driver_s *dev,
+                        const net_ipv6addr_t ipaddr)
+{
+  net_ipv6addr_t nexthop;
+
+  /* Find the next hop in the same way as neighbor_out() */
+
+  if (!net_ipv6addr_maskcmp(ipaddr, dev->d_ipv6addr, dev->d_ipv6netmask))
+    {
+#ifdef CONFIG_NET_ROUTE
+      netdev_ipv6_router(dev, ipaddr, nexthop);
+#else
+      net_ipv6addr_copy(nexthop, dev->d_ipv6draddr);
+#endif
     }
+  else
+    {
+      net_ipv6addr_copy(nexthop, ipaddr);
+    }
+
+  neighbor_update(nexthop);
 }
+#endif
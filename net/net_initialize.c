@@ -163,7 +163,13 @@ void net_setup(void)
   /* Initialize the UDP connection structures */
 
   udp_initialize();
+
+  /* Initialize the UDP/IP write buffering */
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  udp_wrbuffer_initialize();
 #endif
+#endif /* CONFIG_NET_UDP */
 
 #ifdef CONFIG_NET_IGMP
   /* Initialize IGMP support */
@@ -47,6 +47,22 @@
 
 #include <nuttx/net/ip.h>
 
+#ifdef CONFIG_NET_FINELOCK
+#  include <nuttx/wqueue.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The work queue that runs the transmit notifications deferred by
+ * netdev_txnotify_dev() and friends (CONFIG_NET_FINELOCK).
+ */
+
+#ifdef CONFIG_NET_FINELOCK
+#  define NETDEV_TXWORK LPWORK
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -71,6 +71,7 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "pkt/pkt.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -391,6 +392,7 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
             {
               netdev_ifdown(dev);
               ioctl_setipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+              net_route_invalidate();
               netdev_ifup(dev);
               ret = OK;
             }
@@ -453,6 +455,7 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
           if (dev)
             {
               ioctl_setipv4addr(&dev->d_netmask, &req->ifr_addr);
+              net_route_invalidate();
               ret = OK;
             }
         }
@@ -484,6 +487,7 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
 
               netdev_ifdown(dev);
               ioctl_setipv6addr(dev->d_ipv6addr, &lreq->lifr_addr);
+              net_route_invalidate();
               netdev_ifup(dev);
               ret = OK;
             }
@@ -553,6 +557,7 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
             {
               FAR struct lifreq *lreq = (FAR struct lifreq *)req;
               ioctl_setipv6addr(dev->d_ipv6netmask, &lreq->lifr_addr);
+              net_route_invalidate();
               ret = OK;
             }
         }
@@ -664,6 +669,7 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
 #ifdef CONFIG_NET_IPv6
               memset(&dev->d_ipv6addr, 0, sizeof(net_ipv6addr_t));
 #endif
+              net_route_invalidate();
               ret = OK;
             }
         }
@@ -704,6 +710,35 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
         break;
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMP
+      case SIOCSHWTSTAMP:  /* Set hardware time stamping configuration */
+      case SIOCGHWTSTAMP:  /* Get hardware time stamping configuration */
+      case SIOCGPHCTIME:   /* Get the PTP hardware clock time */
+      case SIOCSPHCTIME:   /* Set the PTP hardware clock time */
+      case SIOCADJPHCTIME: /* Step the PTP hardware clock */
+      case SIOCADJPHCFREQ: /* Adjust the PTP hardware clock frequency */
+        {
+          /* These are all implemented by the driver, which interprets the
+           * ifr_hwtstamp, ifr_phctime or ifr_phcppb member of the request.
+           */
+
+          dev = netdev_ifrdev(req);
+          if (dev == NULL)
+            {
+              ret = -ENODEV;
+            }
+          else if (dev->d_ioctl == NULL)
+            {
+              ret = -ENOTTY;
+            }
+          else
+            {
+              ret = dev->d_ioctl(dev, cmd, (long)((uintptr_t)&req->ifr_ifru));
+            }
+        }
+        break;
+#endif
+
       default:
         {
           ret = -ENOTTY;
@@ -866,11 +901,9 @@ static int netdev_arpioctl(FAR struct socket *psock, int cmd,
               FAR struct arp_entry *entry = arp_find(addr->sin_addr.s_addr);
               if (entry != NULL)
                 {
-                  /* The ARP table is fixed size; an entry is deleted
-                   * by nullifying its protocol address.
-                   */
+                  /* Remove the entry from the ARP table */
 
-                  entry->at_ipaddr = 0;
+                  arp_delete(addr->sin_addr.s_addr);
                   ret = OK;
                 }
               else
@@ -1060,6 +1093,22 @@ int psock_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
 {
   int ret;
 
+#ifdef CONFIG_NET_PKT_RXRING
+  /* mmap() of a packet socket returns the address of its receive ring */
+
+  if (cmd == FIOC_MMAP && psock != NULL && psock->s_crefs > 0 &&
+      psock->s_domain == PF_PACKET)
+    {
+      ret = pkt_rxring_mmap(psock, (FAR void **)((uintptr_t)arg));
+      if (ret >= 0)
+        {
+          return ret;
+        }
+
+      goto errout;
+    }
+#endif
+
   /* Check if this is a valid command.  In all cases, arg is a pointer that has
    * been cast to unsigned long.  Verify that the value of the to-be-pointer is
    * non-NULL.
@@ -1212,6 +1261,12 @@ void netdev_ifdown(FAR struct net_driver_s *dev)
             }
         }
 
+#ifdef CONFIG_NET_IPFORWARD
+      /* Discard any packets waiting to be forwarded through the device */
+
+      iob_free_queue(&dev->d_fwdq);
+#endif
+
       /* Notify clients that the network has been taken down */
 
       (void)devif_dev_event(dev, NULL, NETDEV_DOWN);
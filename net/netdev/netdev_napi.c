@@ -0,0 +1,197 @@
+/****************************************************************************
+ * net/netdev/netdev_napi.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NETDEV_NAPI)
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_napi_worker
+ *
+ * Description:
+ *   Receive up to one budget of frames.  Then either queue the work again
+ *   (more frames may be pending) or re-enable the receive interrupt (the
+ *   ring is empty).
+ *
+ ****************************************************************************/
+
+static void netdev_napi_worker(FAR void *arg)
+{
+  FAR struct netdev_napi_s *napi = (FAR struct netdev_napi_s *)arg;
+  irqstate_t flags;
+  net_lock_t lock;
+  int nrecvd;
+
+  lock   = net_lock();
+  nrecvd = napi->n_poll(napi, napi->n_budget);
+  net_unlock(lock);
+
+  flags = enter_critical_section();
+  if (napi->n_scheduled)
+    {
+      if (nrecvd >= napi->n_budget)
+        {
+          /* Queuing the work again puts it behind any other work that
+           * became ready in the meantime.
+           */
+
+          (void)work_queue(napi->n_qid, &napi->n_work, netdev_napi_worker,
+                           napi, 0);
+        }
+      else
+        {
+          napi->n_scheduled = false;
+          napi->n_irqctl(napi, true);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_napi_init
+ *
+ * Description:
+ *   Initialize the budgeted receive polling state of a driver.  The
+ *   receive interrupt is assumed to be enabled.
+ *
+ * Input Parameters:
+ *   napi   - The state to be initialized
+ *   qid    - The work queue to poll on (HPWORK or LPWORK)
+ *   budget - The maximum number of frames per work queue activation, or
+ *            zero for CONFIG_NETDEV_NAPI_BUDGET
+ *   poll   - The driver function that receives frames
+ *   irqctl - The driver function that enables or disables the receive
+ *            interrupt
+ *   arg    - Driver private data (n_arg)
+ *
+ ****************************************************************************/
+
+void netdev_napi_init(FAR struct netdev_napi_s *napi, int qid, int budget,
+                      netdev_napi_poll_t poll, netdev_napi_irqctl_t irqctl,
+                      FAR void *arg)
+{
+  DEBUGASSERT(napi != NULL && poll != NULL && irqctl != NULL);
+
+  napi->n_work.worker = NULL;
+  napi->n_poll        = poll;
+  napi->n_irqctl      = irqctl;
+  napi->n_arg         = arg;
+  napi->n_budget      = budget > 0 ? budget : CONFIG_NETDEV_NAPI_BUDGET;
+  napi->n_qid         = qid;
+  napi->n_scheduled   = false;
+}
+
+/****************************************************************************
+ * Name: netdev_napi_schedule
+ *
+ * Description:
+ *   Called from the receive interrupt handler.  Disable the receive
+ *   interrupt and start polling, unless polling is already active.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the work could not be
+ *   queued.  The receive interrupt is then enabled again.
+ *
+ ****************************************************************************/
+
+int netdev_napi_schedule(FAR struct netdev_napi_s *napi)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  if (!napi->n_scheduled)
+    {
+      napi->n_scheduled = true;
+      napi->n_irqctl(napi, false);
+
+      ret = work_queue(napi->n_qid, &napi->n_work, netdev_napi_worker,
+                       napi, 0);
+      if (ret < 0)
+        {
+          nerr("ERROR: work_queue failed: %d\n", ret);
+          napi->n_scheduled = false;
+          napi->n_irqctl(napi, true);
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_napi_cancel
+ *
+ * Description:
+ *   Stop polling.  The receive interrupt is left disabled; the driver
+ *   enables it again (if appropriate) when the interface is brought up.
+ *
+ ****************************************************************************/
+
+void netdev_napi_cancel(FAR struct netdev_napi_s *napi)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  napi->n_irqctl(napi, false);
+  napi->n_scheduled = false;
+  (void)work_cancel(napi->n_qid, &napi->n_work);
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_NET && CONFIG_NETDEV_NAPI */
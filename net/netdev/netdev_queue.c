@@ -0,0 +1,330 @@
+/****************************************************************************
+ * net/netdev/netdev_queue.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NETDEV_MULTIQUEUE)
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPBUF(dev) (&(dev)->d_buf[NET_LL_HDRLEN(dev)])
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_hashmix
+ *
+ * Description:
+ *   Mix one 32-bit word into the running hash (the Murmur3 step).
+ *
+ ****************************************************************************/
+
+static uint32_t netdev_hashmix(uint32_t hash, uint32_t value)
+{
+  value *= 0xcc9e2d51;
+  value  = (value << 15) | (value >> 17);
+  value *= 0x1b873593;
+
+  hash  ^= value;
+  hash   = (hash << 13) | (hash >> 19);
+  return hash * 5 + 0xe6546b64;
+}
+
+/****************************************************************************
+ * Name: netdev_ports
+ *
+ * Description:
+ *   Return the source and destination ports of a TCP or UDP packet, XOR-ed
+ *   together so that both directions of a flow give the same value.
+ *   Other protocols return zero.
+ *
+ ****************************************************************************/
+
+static uint32_t netdev_ports(uint8_t proto, FAR const uint8_t *l4)
+{
+  if (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP)
+    {
+      return (((uint32_t)l4[0] << 8) | l4[1]) ^
+             (((uint32_t)l4[2] << 8) | l4[3]);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: netdev_queue_worker
+ *
+ * Description:
+ *   Runs on the CPU of the queue.  Make the queue's packet the current
+ *   packet of the device and pass it to the driver's receive handler.
+ *
+ ****************************************************************************/
+
+static void netdev_queue_worker(FAR void *arg)
+{
+  FAR struct netdev_queue_s *queue = (FAR struct netdev_queue_s *)arg;
+  FAR struct net_driver_s *dev = queue->q_dev;
+  FAR struct netdev_queue_s *saveq;
+  FAR uint8_t *savebuf;
+  uint16_t savelen;
+  net_lock_t flags;
+
+  /* The queues of one device share its packet buffer and are serialized
+   * by the device lock.  With CONFIG_NET_FINELOCK, the queues of different
+   * devices run in parallel up to the protocol locks; otherwise the device
+   * lock is the network lock and only the processing outside of it runs in
+   * parallel.
+   */
+
+  flags          = netdev_lock(dev);
+
+  saveq          = dev->d_rxqueue;
+  savebuf        = dev->d_buf;
+  savelen        = dev->d_len;
+
+  dev->d_rxqueue = queue;
+  dev->d_buf     = queue->q_buf;
+  dev->d_len     = queue->q_len;
+
+  queue->q_input(queue);
+
+  dev->d_rxqueue = saveq;
+  dev->d_buf     = savebuf;
+  dev->d_len     = savelen;
+
+  netdev_unlock(dev, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_queue_setup
+ *
+ * Description:
+ *   Register the receive queues of a multi-queue network device.  Queue i
+ *   is processed on CPU (i % CONFIG_SMP_NCPUS) and the flow indirection
+ *   table is filled so that flows are spread evenly over the queues.
+ *
+ * Input Parameters:
+ *   dev     - The network device
+ *   queues  - The array of queues.  q_buf, q_input and q_priv must already
+ *             be set up by the driver.
+ *   nqueues - The number of queues (1 .. CONFIG_NETDEV_MAXQUEUES)
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the number of queues is invalid.
+ *
+ ****************************************************************************/
+
+int netdev_queue_setup(FAR struct net_driver_s *dev,
+                       FAR struct netdev_queue_s *queues, int nqueues)
+{
+  int i;
+
+  DEBUGASSERT(dev != NULL && queues != NULL);
+
+  if (nqueues < 1 || nqueues > CONFIG_NETDEV_MAXQUEUES)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < nqueues; i++)
+    {
+      DEBUGASSERT(queues[i].q_buf != NULL && queues[i].q_input != NULL);
+
+      queues[i].q_dev   = dev;
+      queues[i].q_len   = 0;
+      queues[i].q_index = i;
+      queues[i].q_cpu   = i % CONFIG_SMP_NCPUS;
+      queues[i].q_work.worker = NULL;
+    }
+
+  for (i = 0; i < CONFIG_NETDEV_RSS_TABLESIZE; i++)
+    {
+      dev->d_rsstable[i] = i % nqueues;
+    }
+
+  dev->d_queues  = queues;
+  dev->d_nqueues = nqueues;
+  dev->d_rxqueue = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_queue_rxavail
+ *
+ * Description:
+ *   Notify the network that a packet of q_len bytes has been received into
+ *   the q_buf of the queue.  The queue's q_input handler will be called on
+ *   the queue's CPU.  May be called from an interrupt handler.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if the previous packet of the queue has
+ *   not yet been processed.  The driver should then leave the packet in the
+ *   hardware ring and retry later.
+ *
+ ****************************************************************************/
+
+int netdev_queue_rxavail(FAR struct netdev_queue_s *queue)
+{
+  DEBUGASSERT(queue != NULL && queue->q_dev != NULL);
+
+  if (!work_available(&queue->q_work))
+    {
+      return -EBUSY;
+    }
+
+  return work_queue_cpu(queue->q_cpu, &queue->q_work, netdev_queue_worker,
+                        queue, 0);
+}
+
+/****************************************************************************
+ * Name: netdev_flowhash
+ *
+ * Description:
+ *   Compute a hash of the addresses, ports and protocol of the IP packet
+ *   in d_buf for hardware that cannot provide an RSS hash.  The hash is
+ *   symmetric:  Both directions of a connection give the same value and are
+ *   therefore steered to the same queue.  Fragments and non-IP packets hash
+ *   on what is available, so that at least all of their packets stay
+ *   together.
+ *
+ ****************************************************************************/
+
+uint32_t netdev_flowhash(FAR struct net_driver_s *dev)
+{
+  FAR const uint8_t *ip = IPBUF(dev);
+  uint32_t hash = 0;
+
+  if (dev->d_len < NET_LL_HDRLEN(dev) + 1)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] & 0xf0) == 0x40 &&
+      dev->d_len >= NET_LL_HDRLEN(dev) + IPv4_HDRLEN)
+    {
+      FAR const struct ipv4_hdr_s *ipv4 = (FAR const struct ipv4_hdr_s *)ip;
+      unsigned int hdrlen = (ipv4->vhl & 0x0f) << 2;
+
+      hash = netdev_hashmix(hash,
+                            net_ip4addr_conv32(ipv4->srcipaddr) ^
+                            net_ip4addr_conv32(ipv4->destipaddr));
+
+      /* Only the first fragment holds the ports */
+
+      if ((ipv4->ipoffset[0] & 0x3f) == 0 && ipv4->ipoffset[1] == 0 &&
+          dev->d_len >= NET_LL_HDRLEN(dev) + hdrlen + 4)
+        {
+          hash = netdev_hashmix(hash, netdev_ports(ipv4->proto,
+                                                   ip + hdrlen));
+        }
+
+      return netdev_hashmix(hash, ipv4->proto);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] & 0xf0) == 0x60 &&
+      dev->d_len >= NET_LL_HDRLEN(dev) + IPv6_HDRLEN)
+    {
+      FAR const struct ipv6_hdr_s *ipv6 = (FAR const struct ipv6_hdr_s *)ip;
+      int i;
+
+      for (i = 0; i < 8; i += 2)
+        {
+          hash = netdev_hashmix(hash,
+                   (((uint32_t)ipv6->srcipaddr[i] << 16) |
+                     ipv6->srcipaddr[i + 1]) ^
+                   (((uint32_t)ipv6->destipaddr[i] << 16) |
+                     ipv6->destipaddr[i + 1]));
+        }
+
+      /* Extension headers are not followed */
+
+      if (dev->d_len >= NET_LL_HDRLEN(dev) + IPv6_HDRLEN + 4)
+        {
+          hash = netdev_hashmix(hash, netdev_ports(ipv6->proto,
+                                                   ip + IPv6_HDRLEN));
+        }
+
+      return netdev_hashmix(hash, ipv6->proto);
+    }
+#endif
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: netdev_queue_select
+ *
+ * Description:
+ *   Select the receive queue for a flow hash using the indirection table
+ *   of the device.  The hash may come from the hardware (RSS) or from
+ *   netdev_flowhash().
+ *
+ ****************************************************************************/
+
+FAR struct netdev_queue_s *netdev_queue_select(FAR struct net_driver_s *dev,
+                                               uint32_t hash)
+{
+  DEBUGASSERT(dev->d_queues != NULL && dev->d_nqueues > 0);
+
+  return &dev->d_queues[dev->d_rsstable[hash % CONFIG_NETDEV_RSS_TABLESIZE]];
+}
+
+#endif /* CONFIG_NET && CONFIG_NETDEV_MULTIQUEUE */
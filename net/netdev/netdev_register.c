@@ -180,6 +180,9 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 #endif
   net_lock_t save;
   int devnum;
+#ifdef CONFIG_NET_TXPENDING
+  int i;
+#endif
 
   if (dev)
     {
@@ -266,6 +269,19 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 
       dev->d_conncb = NULL;
       dev->d_devcb = NULL;
+#ifdef CONFIG_NET_TXPENDING
+      for (i = 0; i < CONFIG_NET_TXPRIO_NCLASSES; i++)
+        {
+          sq_init(&dev->d_txpend[i]);
+        }
+#endif
+
+#ifdef CONFIG_NET_FINELOCK
+      /* Initialize the lock taken by netdev_lock() */
+
+      net_rlockinit(&dev->d_lock);
+      memset(&dev->d_txwork, 0, sizeof(struct work_s));
+#endif
 
       /* Get the next available device number and assign a device name to
        * the interface
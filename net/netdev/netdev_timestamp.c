@@ -0,0 +1,86 @@
+/****************************************************************************
+ * net/netdev/netdev_timestamp.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TIMESTAMP)
+
+#include <sys/socket.h>
+#include <time.h>
+#include <assert.h>
+
+#include <nuttx/net/netdev.h>
+
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_txtimestamp
+ *
+ * Description:
+ *   Report the hardware transmit time of a frame.  'req' is the value of
+ *   d_txtsreq that the driver saved when it took the frame.  The time is
+ *   then returned to the sender by recvmsg() with MSG_ERRQUEUE.
+ *
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void netdev_txtimestamp(FAR void *req, FAR const struct timespec *ts)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)req;
+
+  DEBUGASSERT(conn != NULL && ts != NULL);
+
+  /* Only UDP requests transmit time stamps.  The connection may have been
+   * closed (or closed and re-used without time stamping) since the frame
+   * was sent.
+   */
+
+  if (conn->crefs > 0 &&
+      (conn->tsflags & SOF_TIMESTAMPING_TX_HARDWARE) != 0)
+    {
+      conn->txhwtime  = *ts;
+      conn->txtsvalid = true;
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TIMESTAMP */
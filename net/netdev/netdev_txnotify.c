@@ -49,6 +49,63 @@
 #include <nuttx/net/ip.h>
 
 #include "netdev/netdev.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: netdev_txavail_work
+ *
+ * Description:
+ *   Run a deferred transmit notification with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINELOCK
+static void netdev_txavail_work(FAR void *arg)
+{
+  FAR struct net_driver_s *dev = (FAR struct net_driver_s *)arg;
+  net_lock_t save;
+
+  save = net_lock();
+  (void)dev->d_txavail(dev);
+  net_unlock(save);
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_txavail
+ *
+ * Description:
+ *   Notify the device driver that new TX data is available.
+ *
+ *   With CONFIG_NET_FINELOCK, the notification may come from the receive
+ *   processing or the poll of another device.  The driver may then poll
+ *   its device right away, which would lock a second device or take the
+ *   protocol locks out of order.  So the notification is deferred to the
+ *   work queue in that case.
+ *
+ ****************************************************************************/
+
+static void netdev_txavail(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_FINELOCK
+  if (net_isshared())
+    {
+      if (work_available(&dev->d_txwork))
+        {
+          (void)work_queue(NETDEV_TXWORK, &dev->d_txwork,
+                           netdev_txavail_work, dev, 0);
+        }
+
+      return;
+    }
+#endif
+
+  (void)dev->d_txavail(dev);
+}
 
 /****************************************************************************
  * Public Functions
@@ -94,7 +151,7 @@ void netdev_ipv4_txnotify(in_addr_t ripaddr)
     {
       /* Notify the device driver that new TX data is available. */
 
-      (void)dev->d_txavail(dev);
+      netdev_txavail(dev);
     }
 }
 #endif /* CONFIG_NET_IPv4 */
@@ -141,7 +198,7 @@ void netdev_ipv6_txnotify(FAR const net_ipv6addr_t ripaddr)
     {
       /* Notify the device driver that new TX data is available. */
 
-      (void)dev->d_txavail(dev);
+      netdev_txavail(dev);
     }
 }
 #endif /* CONFIG_NET_IPv6 */
@@ -171,7 +228,7 @@ void netdev_txnotify_dev(FAR struct net_driver_s *dev)
     {
       /* Notify the device driver that new TX data is available. */
 
-      (void)dev->d_txavail(dev);
+      netdev_txavail(dev);
     }
 }
 
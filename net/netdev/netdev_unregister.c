@@ -53,6 +53,7 @@
 #include <nuttx/net/netdev.h>
 
 #include "utils/utils.h"
+#include "devif/devif.h"
 #include "netdev/netdev.h"
 
 /****************************************************************************
@@ -125,8 +126,18 @@ int netdev_unregister(FAR struct net_driver_s *dev)
           curr->flink = NULL;
         }
 
+      /* No connection may remain queued for polling by the device */
+
+      devif_txpend_flush(dev);
       net_unlock(save);
 
+#ifdef CONFIG_NET_FINELOCK
+      /* Cancel any deferred transmit notification */
+
+      (void)work_cancel(NETDEV_TXWORK, &dev->d_txwork);
+      sem_destroy(&dev->d_lock.rl_sem);
+#endif
+
 #ifdef CONFIG_NET_ETHERNET
       ninfo("Unregistered MAC: %02x:%02x:%02x:%02x:%02x:%02x as dev: %s\n",
             dev->d_mac.ether_addr_octet[0], dev->d_mac.ether_addr_octet[1],
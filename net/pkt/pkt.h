@@ -43,6 +43,12 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+
+#ifdef CONFIG_NET_TXPENDING
+#  include <nuttx/net/netdev.h>
+#endif
 
 #ifdef CONFIG_NET_PKT
 
@@ -68,11 +74,28 @@ struct devif_callback_s; /* Forward reference */
 struct pkt_conn_s
 {
   dq_entry_t node;     /* Supports a double linked list */
+#ifdef CONFIG_NET_TXPENDING
+  struct devif_txpend_s txpend; /* Queues the connection for TX polling */
+#endif
   uint8_t    lmac[6];  /* The local Ethernet address in network byte order */
   uint8_t    ifindex;
   uint16_t   proto;
   uint8_t    crefs;    /* Reference counts on this instance */
 
+#ifdef CONFIG_NET_PKT_RXRING
+  /* PACKET_RX_RING receive ring */
+
+  FAR uint8_t *rx_ring;        /* Frame slots (NULL: no ring) */
+  size_t     rx_ringsize;      /* Size of the ring in bytes */
+  uint16_t   rx_framesize;     /* Size of one frame slot */
+  uint16_t   rx_framenr;       /* Number of frame slots */
+  uint16_t   rx_head;          /* Next frame slot to be filled */
+  bool       rx_losing;        /* Frames were dropped (ring full) */
+#ifndef CONFIG_DISABLE_POLL
+  FAR struct pollfd *rx_fds;   /* Waiting for a filled frame slot */
+#endif
+#endif
+
   /* Defines the list of packet callbacks */
 
   struct devif_callback_s *list;
@@ -295,6 +318,77 @@ struct socket;
 ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+#ifdef CONFIG_NET_PKT_RXRING
+/****************************************************************************
+ * Function: pkt_rxring_setup
+ *
+ * Description:
+ *   Implement setsockopt(SOL_PACKET, PACKET_RX_RING): Allocate the receive
+ *   ring described by a struct tpacket_req, replacing any previous ring.
+ *   A request with tp_block_nr == 0 releases the ring.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_rxring_setup(FAR struct socket *psock, FAR const void *value,
+                     socklen_t value_len);
+
+/****************************************************************************
+ * Function: pkt_rxring_mmap
+ *
+ * Description:
+ *   Return the address of the receive ring for mmap() (FIOC_MMAP).
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENXIO if no ring has been set up.
+ *
+ ****************************************************************************/
+
+int pkt_rxring_mmap(FAR struct socket *psock, FAR void **addr);
+
+/****************************************************************************
+ * Function: pkt_rxring_input
+ *
+ * Description:
+ *   Copy the frame in d_buf into the next free slot of the receive ring.
+ *
+ * Assumptions:
+ *   Called from the interrupt level or with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void pkt_rxring_input(FAR struct net_driver_s *dev,
+                      FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Function: pkt_rxring_free
+ *
+ * Description:
+ *   Release the receive ring of a connection, if any.
+ *
+ ****************************************************************************/
+
+void pkt_rxring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Function: pkt_pollsetup / pkt_pollteardown
+ *
+ * Description:
+ *   Set up or tear down poll() on a packet socket with a receive ring.
+ *   POLLIN is reported while the most recently filled frame slot is still
+ *   owned by the application.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+struct pollfd;
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
+#endif
+#endif /* CONFIG_NET_PKT_RXRING */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -159,6 +159,9 @@ FAR struct pkt_conn_s *pkt_alloc(void)
       /* Make sure that the connection is marked as uninitialized */
 
       conn->ifindex = 0;
+#ifdef CONFIG_NET_TXPENDING
+      conn->txpend.tp_prio = 0;
+#endif
 
       /* Enqueue the connection into the active list */
 
@@ -180,18 +183,36 @@ FAR struct pkt_conn_s *pkt_alloc(void)
 
 void pkt_free(FAR struct pkt_conn_s *conn)
 {
+#ifdef CONFIG_NET_TXPENDING
+  net_lock_t flags;
+#endif
+
   /* The free list is only accessed from user, non-interrupt level and
    * is protected by a semaphore (that behaves like a mutex).
    */
 
   DEBUGASSERT(conn->crefs == 0);
 
+#ifdef CONFIG_NET_PKT_RXRING
+  /* Release the receive ring, if any */
+
+  pkt_rxring_free(conn);
+#endif
+
   _pkt_semtake(&g_free_sem);
 
   /* Remove the connection from the active list */
 
   dq_rem(&conn->node, &g_active_pkt_connections);
 
+#ifdef CONFIG_NET_TXPENDING
+  /* Stop TX polling of the connection */
+
+  flags = net_lock();
+  devif_txpend_remove(&conn->txpend);
+  net_unlock(flags);
+#endif
+
   /* Free the connection */
 
   dq_addlast(&conn->node, &g_free_pkt_connections);
@@ -52,6 +52,7 @@
 #include <nuttx/net/pkt.h>
 
 #include "devif/devif.h"
+#include "utils/utils.h"
 #include "pkt/pkt.h"
 
 /****************************************************************************
@@ -89,11 +90,23 @@ int pkt_input(struct net_driver_s *dev)
   FAR struct eth_hdr_s  *pbuf = (struct eth_hdr_s *)dev->d_buf;
   int ret = OK;
 
+  net_protolock(NETLOCK_OTHER);
   conn = pkt_active(pbuf);
   if (conn)
     {
       uint16_t flags;
 
+#ifdef CONFIG_NET_PKT_RXRING
+      /* If the socket has a receive ring, copy the frame into it */
+
+      if (conn->rx_ring != NULL)
+        {
+          pkt_rxring_input(dev, conn);
+          net_protounlock(NETLOCK_OTHER);
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -121,6 +134,7 @@ int pkt_input(struct net_driver_s *dev)
       nerr("ERROR: No listener\n");
     }
 
+  net_protounlock(NETLOCK_OTHER);
   return ret;
 }
 
@@ -0,0 +1,356 @@
+/****************************************************************************
+ * net/pkt/pkt_rxring.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_RXRING)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#ifndef CONFIG_DISABLE_POLL
+#  include <poll.h>
+#endif
+
+#include <netpacket/packet.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The frame contents must be visible to the application before the status
+ * word hands the frame over to it.
+ */
+
+#if defined(CONFIG_SMP) && defined(__GNUC__)
+#  define PKT_RXRING_BARRIER() __sync_synchronize()
+#elif defined(__GNUC__)
+#  define PKT_RXRING_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#else
+#  define PKT_RXRING_BARRIER()
+#endif
+
+#define PKT_RXRING_FRAME(c,n) \
+  ((FAR volatile struct tpacket_hdr *)((c)->rx_ring + (n) * (c)->rx_framesize))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: pkt_rxring_setup
+ *
+ * Description:
+ *   Implement setsockopt(SOL_PACKET, PACKET_RX_RING): Allocate the receive
+ *   ring described by a struct tpacket_req, replacing any previous ring.
+ *   A request with tp_block_nr == 0 releases the ring.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_rxring_setup(FAR struct socket *psock, FAR const void *value,
+                     socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  FAR const struct tpacket_req *req = (FAR const struct tpacket_req *)value;
+  FAR uint8_t *ring = NULL;
+  net_lock_t state;
+  size_t ringsize = 0;
+
+  if (psock->s_domain != PF_PACKET || conn == NULL)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value_len != sizeof(struct tpacket_req))
+    {
+      return -EINVAL;
+    }
+
+  if (req->tp_block_nr > 0)
+    {
+      /* Frames must hold at least the header and must tile the blocks
+       * exactly.
+       */
+
+      if (req->tp_frame_size <= TPACKET_HDRLEN ||
+          req->tp_frame_size > UINT16_MAX ||
+          (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+          req->tp_block_size < req->tp_frame_size ||
+          (req->tp_block_size % req->tp_frame_size) != 0 ||
+          req->tp_frame_nr != req->tp_block_nr *
+                              (req->tp_block_size / req->tp_frame_size) ||
+          req->tp_frame_nr > UINT16_MAX)
+        {
+          return -EINVAL;
+        }
+
+      /* The ring is shared with the application, so it is allocated from
+       * the user heap.  All frames start out owned by the kernel.
+       */
+
+      ringsize = (size_t)req->tp_block_size * req->tp_block_nr;
+      ring     = (FAR uint8_t *)kumm_zalloc(ringsize);
+      if (ring == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  /* Swap in the new ring with the network locked so that pkt_input() never
+   * sees a partially configured ring.
+   */
+
+  state = net_lock();
+  pkt_rxring_free(conn);
+
+  conn->rx_ring      = ring;
+  conn->rx_ringsize  = ringsize;
+  conn->rx_framesize = ring != NULL ? req->tp_frame_size : 0;
+  conn->rx_framenr   = ring != NULL ? req->tp_frame_nr : 0;
+  conn->rx_head      = 0;
+  conn->rx_losing    = false;
+  net_unlock(state);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Function: pkt_rxring_mmap
+ *
+ * Description:
+ *   Return the address of the receive ring for mmap() (FIOC_MMAP).
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENXIO if no ring has been set up.
+ *
+ ****************************************************************************/
+
+int pkt_rxring_mmap(FAR struct socket *psock, FAR void **addr)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+
+  if (conn == NULL || conn->rx_ring == NULL)
+    {
+      return -ENXIO;
+    }
+
+  *addr = conn->rx_ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Function: pkt_rxring_input
+ *
+ * Description:
+ *   Copy the frame in d_buf into the next free slot of the receive ring.
+ *
+ * Assumptions:
+ *   Called from the interrupt level or with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void pkt_rxring_input(FAR struct net_driver_s *dev,
+                      FAR struct pkt_conn_s *conn)
+{
+  FAR volatile struct tpacket_hdr *hdr;
+  struct timespec ts;
+  unsigned long status;
+  size_t snaplen;
+
+  hdr = PKT_RXRING_FRAME(conn, conn->rx_head);
+  if (hdr->tp_status != TP_STATUS_KERNEL)
+    {
+      /* The application has not yet returned this frame: The ring is full
+       * and the frame is dropped.
+       */
+
+      conn->rx_losing = true;
+      return;
+    }
+
+  status  = TP_STATUS_USER;
+  snaplen = dev->d_len;
+  if (snaplen > conn->rx_framesize - TPACKET_HDRLEN)
+    {
+      snaplen = conn->rx_framesize - TPACKET_HDRLEN;
+      status |= TP_STATUS_COPY;
+    }
+
+  if (conn->rx_losing)
+    {
+      status |= TP_STATUS_LOSING;
+      conn->rx_losing = false;
+    }
+
+  /* Copy the frame; this is the only copy made */
+
+  memcpy((FAR uint8_t *)hdr + TPACKET_HDRLEN, dev->d_buf, snaplen);
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_mac     = TPACKET_HDRLEN;
+  hdr->tp_net     = TPACKET_HDRLEN + NET_LL_HDRLEN(dev);
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / 1000;
+
+  /* Then hand the frame over to the application */
+
+  PKT_RXRING_BARRIER();
+  hdr->tp_status  = status;
+
+  if (++conn->rx_head >= conn->rx_framenr)
+    {
+      conn->rx_head = 0;
+    }
+
+#ifndef CONFIG_DISABLE_POLL
+  if (conn->rx_fds != NULL && (conn->rx_fds->events & POLLIN) != 0)
+    {
+      conn->rx_fds->revents |= POLLIN;
+      sem_post(conn->rx_fds->sem);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Function: pkt_rxring_free
+ *
+ * Description:
+ *   Release the receive ring of a connection, if any.
+ *
+ ****************************************************************************/
+
+void pkt_rxring_free(FAR struct pkt_conn_s *conn)
+{
+  if (conn->rx_ring != NULL)
+    {
+      kumm_free(conn->rx_ring);
+      conn->rx_ring    = NULL;
+      conn->rx_framenr = 0;
+    }
+}
+
+/****************************************************************************
+ * Function: pkt_pollsetup
+ *
+ * Description:
+ *   Set up poll() on a packet socket with a receive ring.  POLLIN is
+ *   reported while the most recently filled frame slot is still owned by
+ *   the application.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)psock->s_conn;
+  FAR volatile struct tpacket_hdr *hdr;
+  net_lock_t state;
+  int ret = OK;
+
+  if (conn == NULL || conn->rx_ring == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  state = net_lock();
+  if (conn->rx_fds != NULL)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      conn->rx_fds = fds;
+      fds->priv    = conn;
+
+      hdr = PKT_RXRING_FRAME(conn, conn->rx_head > 0 ? conn->rx_head - 1 :
+                                   conn->rx_framenr - 1);
+      if ((hdr->tp_status & TP_STATUS_USER) != 0 &&
+          (fds->events & POLLIN) != 0)
+        {
+          fds->revents |= POLLIN;
+          sem_post(fds->sem);
+        }
+    }
+
+  net_unlock(state);
+  return ret;
+}
+
+/****************************************************************************
+ * Function: pkt_pollteardown
+ ****************************************************************************/
+
+int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
+{
+  FAR struct pkt_conn_s *conn = (FAR struct pkt_conn_s *)fds->priv;
+  net_lock_t state;
+
+  if (conn != NULL)
+    {
+      state = net_lock();
+      if (conn->rx_fds == fds)
+        {
+          conn->rx_fds = NULL;
+        }
+
+      net_unlock(state);
+      fds->priv = NULL;
+    }
+
+  return OK;
+}
+#endif /* !CONFIG_DISABLE_POLL */
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_RXRING */
@@ -267,6 +267,7 @@ ssize_t psock_pkt_send(FAR struct socket *psock, FAR const void *buf,
 
           /* Notify the device driver that new TX data is available. */
 
+          devif_txpend_add(dev, &conn->txpend, DEVIF_TXPEND_PKT);
           netdev_txnotify_dev(dev);
 
           /* Wait for the send to complete or an error to occur: NOTES: (1)
@@ -87,6 +87,33 @@ static int     netprocfs_rewinddir(FAR struct fs_dirent_s *dir);
 
 static int     netprocfs_stat(FAR const char *relpath, FAR struct stat *buf);
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS
+/* The files in the net/ directory that are not network devices */
+
+struct netprocfs_entry_s
+{
+  FAR const char *name;              /* Name of the file within net/ */
+  uint8_t entry;                     /* See NETPROCFS_SUBDIR_* */
+};
+
+static const struct netprocfs_entry_s g_net_entries[] =
+{
+  { "stat", NETPROCFS_SUBDIR_STAT }
+#ifdef CONFIG_NET_TCP_CONNSTATS
+  , { "tcp", NETPROCFS_SUBDIR_TCP }
+#endif
+};
+
+#define NETPROCFS_NENTRIES \
+  (sizeof(g_net_entries) / sizeof(struct netprocfs_entry_s))
+#else
+#define NETPROCFS_NENTRIES 0
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -116,6 +143,35 @@ const struct procfs_operations net_procfsoperations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netprocfs_findentry
+ *
+ * Description:
+ *   Return the index into g_net_entries[] of the file named by relpath or
+ *   -1 if relpath does not refer to one of those files.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS
+static int netprocfs_findentry(FAR const char *relpath)
+{
+  int i;
+
+  if (strncmp(relpath, "net/", 4) == 0)
+    {
+      for (i = 0; i < NETPROCFS_NENTRIES; i++)
+        {
+          if (strcmp(&relpath[4], g_net_entries[i].name) == 0)
+            {
+              return i;
+            }
+        }
+    }
+
+  return -1;
+}
+#endif
+
 /****************************************************************************
  * Name: netprocfs_open
  ****************************************************************************/
@@ -125,6 +181,10 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct netprocfs_file_s *priv;
   FAR struct net_driver_s *dev;
+  uint8_t entry;
+#ifdef CONFIG_NET_STATISTICS
+  int ndx;
+#endif
 
   finfo("Open '%s'\n", relpath);
 
@@ -141,18 +201,16 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
       return -EACCES;
     }
 
-  /* "net/stat" is an acceptable value for the relpath only if network layer
-   * statistics are enabled.
+  /* "net/stat" and "net/tcp" are acceptable values for the relpath only if
+   * network layer statistics are enabled.
    */
 
 #ifdef CONFIG_NET_STATISTICS
-  if (strcmp(relpath, "net/stat") == 0)
+  ndx = netprocfs_findentry(relpath);
+  if (ndx >= 0)
     {
-      /* A NULL network device reference is a clue that we are processing
-       * the network statistics file.
-       */
-
-      dev = NULL;
+      dev   = NULL;
+      entry = g_net_entries[ndx].entry;
     }
   else
 #endif
@@ -180,6 +238,8 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
           ferr("ERROR: relpath is '%s'\n", relpath);
           return -ENOENT;
         }
+
+      entry = NETPROCFS_SUBDIR_DEV;
     }
 
   /* Allocate the open file structure */
@@ -193,7 +253,8 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Initialize the open-file structure */
 
-  priv->dev = dev;
+  priv->dev   = dev;
+  priv->entry = entry;
 
   /* Save the open file structure as the open-specific state in
    * filep->f_priv.
@@ -240,24 +301,30 @@ static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer,
   priv = (FAR struct netprocfs_file_s *)filep->f_priv;
   DEBUGASSERT(priv);
 
+  switch (priv->entry)
+    {
 #ifdef CONFIG_NET_STATISTICS
-  /* A NULL device structure reference is the key that we are showing the
-   * network statistics.
-   */
+      case NETPROCFS_SUBDIR_STAT:
+        /* Show the network layer statistics */
 
-  if (priv->dev == NULL)
-    {
-      /* Show the network layer statistics */
+        nreturned = netprocfs_read_netstats(priv, buffer, buflen);
+        break;
+#endif
 
-      nreturned = netprocfs_read_netstats(priv, buffer, buflen);
-    }
-  else
+#ifdef CONFIG_NET_TCP_CONNSTATS
+      case NETPROCFS_SUBDIR_TCP:
+        /* Show the TCP connection statistics */
+
+        nreturned = netprocfs_read_tcpstats(priv, buffer, buflen);
+        break;
 #endif
-   {
-      /* Otherwise, we are showing device-specific statistics */
 
-      nreturned = netprocfs_read_devstats(priv, buffer, buflen);
-   }
+      default:
+        /* Otherwise, we are showing device-specific statistics */
+
+        nreturned = netprocfs_read_devstats(priv, buffer, buflen);
+        break;
+    }
 
   /* Update the file offset */
 
@@ -358,11 +425,7 @@ static int netprocfs_opendir(FAR const char *relpath,
   /* Initialze base structure components */
 
   level1->base.level    = 1;
-#ifdef CONFIG_NET_STATISTICS
-  level1->base.nentries = ndevs + 1;
-#else
-  level1->base.nentries = ndevs;
-#endif
+  level1->base.nentries = ndevs + NETPROCFS_NENTRIES;
   level1->base.index    = 0;
 
   dir->u.procfs = (FAR void *) level1;
@@ -425,25 +488,19 @@ static int netprocfs_readdir(FAR struct fs_dirent_s *dir)
     }
 
 #ifdef CONFIG_NET_STATISTICS
-  else if (index == 0)
+  else if (index < NETPROCFS_NENTRIES)
     {
       /* Copy the network statistics directory entry */
 
       dir->fd_dir.d_type = DTYPE_FILE;
-      strncpy(dir->fd_dir.d_name, "stat", NAME_MAX + 1);
+      strncpy(dir->fd_dir.d_name, g_net_entries[index].name, NAME_MAX + 1);
     }
   else
 #endif
     {
-      int devndx = index;
-
-#ifdef CONFIG_NET_STATISTICS
-      /* Subtract one to account for index == 0 which is used for network
-       * status.
-       */
+      /* Subtract the entries used for the network statistics */
 
-      devndx--;
-#endif
+      int devndx = index - NETPROCFS_NENTRIES;
 
       /* Find the device corresponding to this device index */
 
@@ -498,9 +555,9 @@ static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
     }
   else
 #ifdef CONFIG_NET_STATISTICS
-  /* Check for network statistics "net/stat" */
+  /* Check for network statistics "net/stat" or "net/tcp" */
 
-  if (strcmp(relpath, "net/stat") == 0)
+  if (netprocfs_findentry(relpath) >= 0)
     {
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
     }
@@ -45,6 +45,9 @@
 #include <debug.h>
 
 #include <nuttx/net/netstats.h>
+#ifdef CONFIG_IOB_QUOTA
+#  include <nuttx/net/iob.h>
+#endif
 
 #include "procfs/procfs.h"
 
@@ -75,6 +78,10 @@ static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_IOB_QUOTA
+static int     netprocfs_iobusage_header(FAR struct netprocfs_file_s *netfile);
+static int     netprocfs_iobusage(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_IOB_QUOTA */
 
 /****************************************************************************
  * Private Data
@@ -109,6 +116,11 @@ static const linegen_t g_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_IOB_QUOTA
+  , netprocfs_iobusage_header,
+  netprocfs_iobusage
+#endif /* CONFIG_IOB_QUOTA */
 };
 
 #define NSTAT_LINES (sizeof(g_linegen) / sizeof(linegen_t))
@@ -431,6 +443,33 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_iobusage_header
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+static int netprocfs_iobusage_header(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\nIOBs:      TCPrx  TCPtx  UDPrx  UDPtx Netdev  Other\n");
+}
+#endif /* CONFIG_IOB_QUOTA */
+
+/****************************************************************************
+ * Name: netprocfs_iobusage
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_QUOTA
+static int netprocfs_iobusage(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  In use    %5d  %5d  %5d  %5d  %5d  %5d\n",
+                  iob_usage(IOBUSER_TCP_RX), iob_usage(IOBUSER_TCP_TX),
+                  iob_usage(IOBUSER_UDP_RX), iob_usage(IOBUSER_UDP_TX),
+                  iob_usage(IOBUSER_NETDEV), iob_usage(IOBUSER_OTHER));
+}
+#endif /* CONFIG_IOB_QUOTA */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -273,6 +273,39 @@ static int netprocfs_ipaddresses(FAR struct netprocfs_file_s *netfile)
   return len;
 }
 
+/****************************************************************************
+ * Name: netprocfs_devstats
+ *
+ * Description:
+ *   Add together the per-CPU copies of the device statistics.  All of the
+ *   counters are uint32_t so the structures may be summed as arrays.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+static void netprocfs_devstats(FAR struct net_driver_s *dev,
+                               FAR struct netdev_statistics_s *stats)
+{
+  FAR const uint32_t *src;
+  FAR uint32_t *dest;
+  int slot;
+  int i;
+
+  memset(stats, 0, sizeof(struct netdev_statistics_s));
+  dest = (FAR uint32_t *)stats;
+
+  for (slot = 0; slot < NETDEV_STATS_NSLOTS; slot++)
+    {
+      src = (FAR const uint32_t *)&dev->d_statistics[slot];
+      for (i = 0; i < sizeof(struct netdev_statistics_s) / sizeof(uint32_t);
+           i++)
+        {
+          dest[i] += src[i];
+        }
+    }
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
 /****************************************************************************
  * Name: netprocfs_rxstatistics_header
  ****************************************************************************/
@@ -281,8 +314,8 @@ static int netprocfs_ipaddresses(FAR struct netprocfs_file_s *netfile)
 static int netprocfs_rxstatistics_header(FAR struct netprocfs_file_s *netfile)
 {
   DEBUGASSERT(netfile != NULL);
-  return snprintf(netfile->line, NET_LINELEN , "\tRX: %-8s %-8s %-8s\n",
-                  "Received", "Fragment", "Errors");
+  return snprintf(netfile->line, NET_LINELEN , "\tRX: %-8s %-8s %-8s %-8s\n",
+                  "Received", "Fragment", "Errors", "NoBufs");
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -293,17 +326,18 @@ static int netprocfs_rxstatistics_header(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NETDEV_STATISTICS
 static int netprocfs_rxstatistics(FAR struct netprocfs_file_s *netfile)
 {
-  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s stats;
   FAR struct net_driver_s *dev;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  netprocfs_devstats(dev, &stats);
 
-  return snprintf(netfile->line, NET_LINELEN, "\t    %08lx %08lx %08lx\n",
-                  (unsigned long)stats->rx_packets,
-                  (unsigned long)stats->rx_fragments,
-                  (unsigned long)stats->rx_errors);
+  return snprintf(netfile->line, NET_LINELEN, "\t    %08lx %08lx %08lx %08lx\n",
+                  (unsigned long)stats.rx_packets,
+                  (unsigned long)stats.rx_fragments,
+                  (unsigned long)stats.rx_errors,
+                  (unsigned long)stats.rx_nobufs);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -351,13 +385,13 @@ static int netprocfs_rxpackets_header(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NETDEV_STATISTICS
 static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile)
 {
-  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s stats;
   FAR struct net_driver_s *dev;
   FAR char *fmt;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  netprocfs_devstats(dev, &stats);
 
   fmt = "\t    "
 #ifdef CONFIG_NET_IPv4
@@ -373,15 +407,15 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile)
 
   return snprintf(netfile->line, NET_LINELEN, fmt
 #ifdef CONFIG_NET_IPv4
-        , (unsigned long)stats->rx_ipv4
+        , (unsigned long)stats.rx_ipv4
 #endif
 #ifdef CONFIG_NET_IPv6
-        , (unsigned long)stats->rx_ipv6
+        , (unsigned long)stats.rx_ipv6
 #endif
 #ifdef CONFIG_NET_ARP
-        , (unsigned long)stats->rx_arp
+        , (unsigned long)stats.rx_arp
 #endif
-        , (unsigned long)stats->rx_dropped);
+        , (unsigned long)stats.rx_dropped);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -394,8 +428,8 @@ static int netprocfs_txstatistics_header(FAR struct netprocfs_file_s *netfile)
 {
   DEBUGASSERT(netfile != NULL);
 
-  return snprintf(netfile->line, NET_LINELEN, "\tTX: %-8s %-8s %-8s %-8s\n",
-                 "Queued", "Sent", "Erorts", "Timeouts");
+  return snprintf(netfile->line, NET_LINELEN, "\tTX: %-8s %-8s %-8s %-8s %-8s\n",
+                 "Queued", "Sent", "Erorts", "Timeouts", "Dropped");
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -406,18 +440,19 @@ static int netprocfs_txstatistics_header(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NETDEV_STATISTICS
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 {
-  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s stats;
   FAR struct net_driver_s *dev;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
-
-  return snprintf(netfile->line, NET_LINELEN, "\t    %08lx %08lx %08lx %08lx\n",
-                  (unsigned long)stats->tx_packets,
-                  (unsigned long)stats->tx_done,
-                  (unsigned long)stats->tx_errors,
-                  (unsigned long)stats->tx_timeouts);
+  netprocfs_devstats(dev, &stats);
+
+  return snprintf(netfile->line, NET_LINELEN, "\t    %08lx %08lx %08lx %08lx %08lx\n",
+                  (unsigned long)stats.tx_packets,
+                  (unsigned long)stats.tx_done,
+                  (unsigned long)stats.tx_errors,
+                  (unsigned long)stats.tx_timeouts,
+                  (unsigned long)stats.tx_dropped);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -428,15 +463,15 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 #ifdef CONFIG_NETDEV_STATISTICS
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile)
 {
-  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s stats;
   FAR struct net_driver_s *dev;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  netprocfs_devstats(dev, &stats);
 
   return snprintf(netfile->line, NET_LINELEN , "\tTotal Errors: %08x\n\n",
-                  (unsigned long)stats->errors);
+                  (unsigned long)stats.errors);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -54,7 +54,13 @@
  * to handle the longest line generated by this logic.
  */
 
-#define NET_LINELEN 64
+#define NET_LINELEN 160
+
+/* The kinds of "file" in the net/ directory */
+
+#define NETPROCFS_SUBDIR_DEV   0     /* Network device statistics */
+#define NETPROCFS_SUBDIR_STAT  1     /* Network layer statistics (net/stat) */
+#define NETPROCFS_SUBDIR_TCP   2     /* TCP connection statistics (net/tcp) */
 
 /****************************************************************************
  * Public Type Definitions
@@ -67,7 +73,8 @@ struct netprocfs_file_s
 {
   struct procfs_file_s base;         /* Base open file structure */
   FAR struct net_driver_s *dev;      /* Current network device */
-  uint8_t lineno;                    /* Line number */
+  uint8_t entry;                     /* See NETPROCFS_SUBDIR_* */
+  uint16_t lineno;                   /* Line number */
   uint8_t linesize;                  /* Number of valid characters in line[] */
   uint8_t offset;                    /* Offset to first valid character in line[] */
   char line[NET_LINELEN];            /* Pre-allocated buffer for formatted lines */
@@ -148,6 +155,29 @@ ssize_t netprocfs_read_netstats(FAR struct netprocfs_file_s *priv,
                                 FAR char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: netprocfs_read_tcpstats
+ *
+ * Description:
+ *   Read and format the statistics of the active TCP connections.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which the statistics will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: netprocfs_read_devstats
  *
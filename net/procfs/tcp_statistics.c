@@ -0,0 +1,308 @@
+/****************************************************************************
+ * net/procfs/tcp_statistics.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_NET_TCP_CONNSTATS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv6)
+#  define TCPSTAT_ADDRLEN INET6_ADDRSTRLEN
+#else
+#  define TCPSTAT_ADDRLEN INET_ADDRSTRLEN
+#endif
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_tcp_header
+ *
+ * Description:
+ *   Format the header line.  rtt and rto are in units of the TCP timer
+ *   (half seconds); rcvq is the number of bytes waiting in the read-ahead
+ *   buffers and sndq the number of bytes waiting in the write buffers.
+ *
+ ****************************************************************************/
+
+static int netprocfs_tcp_header(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%3s %5s %-15s %5s %2s %3s %3s "
+#ifdef CONFIG_NET_TCP_CC
+                  "%8s "
+#endif
+                  "%8s %6s %6s %8s %8s %8s %8s\n",
+                  "sl", "lport", "raddr", "rport", "st", "rtt", "rto",
+#ifdef CONFIG_NET_TCP_CC
+                  "cwnd",
+#endif
+                  "unacked", "rcvq", "sndq", "rx", "tx", "rexmit", "dropped");
+}
+
+/****************************************************************************
+ * Name: netprocfs_tcp_raddr
+ *
+ * Description:
+ *   Format the remote address of the connection.
+ *
+ ****************************************************************************/
+
+static void netprocfs_tcp_raddr(FAR struct tcp_conn_s *conn, FAR char *buf)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      if (inet_ntop(AF_INET6, conn->u.ipv6.raddr, buf,
+                    TCPSTAT_ADDRLEN) == NULL)
+        {
+          strcpy(buf, "?");
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      struct in_addr addr;
+
+      addr.s_addr = conn->u.ipv4.raddr;
+      strncpy(buf, inet_ntoa(addr), TCPSTAT_ADDRLEN);
+      buf[TCPSTAT_ADDRLEN - 1] = '\0';
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: netprocfs_tcp_conn
+ *
+ * Description:
+ *   Format the statistics of one connection.
+ *
+ ****************************************************************************/
+
+static int netprocfs_tcp_conn(FAR struct netprocfs_file_s *netfile,
+                              FAR struct tcp_conn_s *conn, int sl)
+{
+  FAR struct tcp_connstats_s *stats = &conn->stats;
+  char raddr[TCPSTAT_ADDRLEN];
+  unsigned long rcvq = 0;
+  unsigned long sndq = 0;
+#ifdef CONFIG_NET_TCP_READAHEAD
+  FAR struct iob_qentry_s *qentry;
+#endif
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  FAR sq_entry_t *entry;
+#endif
+
+#ifdef CONFIG_NET_TCP_READAHEAD
+  for (qentry = conn->readahead.qh_head; qentry != NULL;
+       qentry = qentry->qe_flink)
+    {
+      rcvq += qentry->qe_head->io_pktlen;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  for (entry = sq_peek(&conn->write_q); entry != NULL;
+       entry = sq_next(entry))
+    {
+      sndq += WRB_PKTLEN((FAR struct tcp_wrbuffer_s *)entry);
+    }
+#endif
+
+  netprocfs_tcp_raddr(conn, raddr);
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%3d %5u %-15s %5u %2x %3u %3u "
+#ifdef CONFIG_NET_TCP_CC
+                  "%8lu "
+#endif
+                  "%8lu %6lu %6lu %08lx %08lx %08lx %08lx\n",
+                  sl, ntohs(conn->lport), raddr, ntohs(conn->rport),
+                  conn->tcpstateflags & TCP_STATE_MASK,
+                  conn->sa >> 3, conn->rto,
+#ifdef CONFIG_NET_TCP_CC
+                  (unsigned long)conn->cwnd,
+#endif
+                  (unsigned long)conn->unacked, rcvq, sndq,
+                  (unsigned long)stats->rx_segments,
+                  (unsigned long)stats->tx_segments,
+                  (unsigned long)stats->retransmits,
+                  (unsigned long)stats->rx_dropped);
+}
+
+/****************************************************************************
+ * Name: netprocfs_tcp_line
+ *
+ * Description:
+ *   Format line 'lineno':  The header or the statistics of the
+ *   (lineno - 1)th active connection.  Returns zero if there is no such
+ *   connection.  The connection list may change between reads; the lines
+ *   then describe the list as it was when each line was generated.
+ *
+ ****************************************************************************/
+
+static int netprocfs_tcp_line(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct tcp_conn_s *conn;
+  net_lock_t state;
+  int len = 0;
+  int i;
+
+  if (netfile->lineno == 0)
+    {
+      len = netprocfs_tcp_header(netfile);
+    }
+  else
+    {
+      state = net_lock();
+
+      conn = tcp_nextconn(NULL);
+      for (i = 1; i < netfile->lineno && conn != NULL; i++)
+        {
+          conn = tcp_nextconn(conn);
+        }
+
+      if (conn != NULL)
+        {
+          len = netprocfs_tcp_conn(netfile, conn, netfile->lineno - 1);
+        }
+
+      net_unlock(state);
+    }
+
+  return MIN(len, NET_LINELEN - 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_tcpstats
+ *
+ * Description:
+ *   Read and format the statistics of the active TCP connections.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which the statistics will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen)
+{
+  ssize_t nreturned = 0;
+  size_t xfrsize;
+  int len;
+
+  /* Unlike netprocfs_read_linegen(), the number of lines is not known in
+   * advance:  Generate lines until there are no more connections.
+   */
+
+  while (buflen > 0)
+    {
+      if (priv->linesize == 0)
+        {
+          len = netprocfs_tcp_line(priv);
+          if (len <= 0)
+            {
+              break;
+            }
+
+          priv->lineno++;
+          priv->linesize = len;
+          priv->offset   = 0;
+        }
+
+      /* Transfer data to the user buffer */
+
+      xfrsize = MIN(priv->linesize, buflen);
+      memcpy(buffer, &priv->line[priv->offset], xfrsize);
+
+      /* Update pointers, sizes, and offsets */
+
+      buffer         += xfrsize;
+      buflen         -= xfrsize;
+
+      priv->linesize -= xfrsize;
+      priv->offset   += xfrsize;
+      nreturned      += xfrsize;
+    }
+
+  return nreturned;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_TCP_CONNSTATS */
@@ -75,6 +75,19 @@ int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_s *route;
   net_lock_t save;
+#ifdef CONFIG_NET_ROUTE_LPM
+  int plen;
+  int ret;
+
+  /* Only contiguous network masks can be looked up by prefix */
+
+  plen = net_lpm_prefixlen((FAR const uint8_t *)&netmask, sizeof(in_addr_t));
+  if (plen < 0)
+    {
+      nerr("ERROR:  Non-contiguous netmask %08lx\n", (unsigned long)netmask);
+      return plen;
+    }
+#endif
 
   /* Allocate a route entry */
 
@@ -95,9 +108,23 @@ int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   save = net_lock();
 
+#ifdef CONFIG_NET_ROUTE_LPM
+  /* Index the new entry by its prefix */
+
+  ret = net_lpm_insert(&g_routes_lpm, (FAR const uint8_t *)&route->target,
+                       plen, route);
+  if (ret < 0)
+    {
+      net_unlock(save);
+      net_freeroute(route);
+      return ret;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes);
+  net_route_invalidate();
   net_unlock(save);
   return OK;
 }
@@ -108,6 +135,20 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask, net_ipv6add
 {
   FAR struct net_route_ipv6_s *route;
   net_lock_t save;
+#ifdef CONFIG_NET_ROUTE_LPM
+  int plen;
+  int ret;
+
+  /* Only contiguous network masks can be looked up by prefix */
+
+  plen = net_lpm_prefixlen((FAR const uint8_t *)netmask,
+                           sizeof(net_ipv6addr_t));
+  if (plen < 0)
+    {
+      nerr("ERROR:  Non-contiguous netmask\n");
+      return plen;
+    }
+#endif
 
   /* Allocate a route entry */
 
@@ -128,9 +169,23 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask, net_ipv6add
 
   save = net_lock();
 
+#ifdef CONFIG_NET_ROUTE_LPM
+  /* Index the new entry by its prefix */
+
+  ret = net_lpm_insert(&g_routes_lpm_ipv6,
+                       (FAR const uint8_t *)route->target, plen, route);
+  if (ret < 0)
+    {
+      net_unlock(save);
+      net_freeroute_ipv6(route);
+      return ret;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes_ipv6);
+  net_route_invalidate();
   net_unlock(save);
   return OK;
 }
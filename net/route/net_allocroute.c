@@ -64,6 +64,24 @@ sq_queue_t g_routes;
 sq_queue_t g_routes_ipv6;
 #endif
 
+#ifdef CONFIG_NET_ROUTE_LPM
+/* The same routes, indexed by prefix */
+
+#ifdef CONFIG_NET_IPv4
+struct net_lpm_s g_routes_lpm;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct net_lpm_s g_routes_lpm_ipv6;
+#endif
+#endif
+
+#ifdef CONFIG_NET_ROUTE_CACHE
+/* The current generation of the device route caches */
+
+uint16_t g_route_generation;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -140,6 +158,25 @@ void net_initroute(void)
                  (FAR sq_queue_t *)&g_freeroutes_ipv6);
     }
 #endif
+
+#ifdef CONFIG_NET_ROUTE_LPM
+  /* Initialize the (empty) prefix tries and the pool of trie nodes */
+
+#ifdef CONFIG_NET_IPv4
+  g_routes_lpm.root = NULL;
+#endif
+#ifdef CONFIG_NET_IPv6
+  g_routes_lpm_ipv6.root = NULL;
+#endif
+
+  net_lpm_initialize();
+#endif
+
+#ifdef CONFIG_NET_ROUTE_CACHE
+  /* Device caches are zeroed, so generation zero is never valid */
+
+  g_route_generation = 1;
+#endif
 }
 
 /****************************************************************************
@@ -94,6 +94,9 @@ struct route_match_ipv6_s
 static int net_match(FAR struct net_route_s *route, FAR void *arg)
 {
   FAR struct route_match_s *match = (FAR struct route_match_s *)arg;
+#ifdef CONFIG_NET_ROUTE_LPM
+  int plen;
+#endif
 
   /* To match, the masked target address must be the same, and the masks
    * must be the same.
@@ -114,6 +117,17 @@ static int net_match(FAR struct net_route_s *route, FAR void *arg)
           (void)sq_remfirst((FAR sq_queue_t *)&g_routes);
         }
 
+#ifdef CONFIG_NET_ROUTE_LPM
+      /* Remove the entry from the prefix trie */
+
+      plen = net_lpm_prefixlen((FAR const uint8_t *)&route->netmask,
+                               sizeof(in_addr_t));
+      (void)net_lpm_remove(&g_routes_lpm,
+                           (FAR const uint8_t *)&route->target, plen);
+#endif
+
+      net_route_invalidate();
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute(route);
@@ -134,6 +148,9 @@ static int net_match(FAR struct net_route_s *route, FAR void *arg)
 static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
 {
   FAR struct route_match_ipv6_s *match = (FAR struct route_match_ipv6_s *)arg;
+#ifdef CONFIG_NET_ROUTE_LPM
+  int plen;
+#endif
 
   /* To match, the masked target address must be the same, and the masks
    * must be the same.
@@ -154,6 +171,17 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
           (void)sq_remfirst((FAR sq_queue_t *)&g_routes_ipv6);
         }
 
+#ifdef CONFIG_NET_ROUTE_LPM
+      /* Remove the entry from the prefix trie */
+
+      plen = net_lpm_prefixlen((FAR const uint8_t *)route->netmask,
+                               sizeof(net_ipv6addr_t));
+      (void)net_lpm_remove(&g_routes_lpm_ipv6,
+                           (FAR const uint8_t *)route->target, plen);
+#endif
+
+      net_route_invalidate();
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
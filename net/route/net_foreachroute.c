@@ -63,7 +63,8 @@
  * Parameters:
  *
  * Returned Value:
- *   0 if in use; 1 if avaialble and the new entry was added
+ *   The first non-zero value returned by the handler (which terminates
+ *   the traversal) or zero if the handler returned zero for every entry.
  *
  ****************************************************************************/
 
@@ -81,7 +82,9 @@ int net_foreachroute(route_handler_t handler, FAR void *arg)
 
   /* Visit each entry in the routing table */
 
-  for (route = (FAR struct net_route_s *)g_routes.head; route; route = next)
+  for (route = (FAR struct net_route_s *)g_routes.head;
+       route != NULL && ret == 0;
+       route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the hanlder may delete this entry.
@@ -112,7 +115,9 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
 
   /* Visit each entry in the routing table */
 
-  for (route = (FAR struct net_route_s *)g_routes_ipv6.head; route; route = next)
+  for (route = (FAR struct net_route_ipv6_s *)g_routes_ipv6.head;
+       route != NULL && ret == 0;
+       route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the hanlder may delete this entry.
@@ -0,0 +1,439 @@
+/****************************************************************************
+ * net/route/net_lpm.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE_LPM)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A compressed trie with N prefixes has at most N - 1 additional (glue)
+ * nodes where two prefixes diverge.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define NET_LPM_NNODES (4 * CONFIG_NET_MAXROUTES)
+#else
+#  define NET_LPM_NNODES (2 * CONFIG_NET_MAXROUTES)
+#endif
+
+/* Bit n of the key, counting from the most significant bit of the first
+ * byte (i.e., network order).
+ */
+
+#define LPM_BIT(k,n) (((k)[(n) >> 3] >> (7 - ((n) & 7))) & 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The pre-allocated trie nodes and the list of free nodes (linked through
+ * the parent field).
+ */
+
+static struct net_lpm_node_s g_lpm_nodes[NET_LPM_NNODES];
+static FAR struct net_lpm_node_s *g_lpm_free;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits (up to nbits) that two keys have in
+ *   common.
+ *
+ ****************************************************************************/
+
+static int lpm_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                      int nbits)
+{
+  int n;
+
+  for (n = 0; n < nbits; n++)
+    {
+      /* Skip whole bytes that are the same */
+
+      if ((n & 7) == 0 && nbits - n >= 8 && a[n >> 3] == b[n >> 3])
+        {
+          n += 7;
+          continue;
+        }
+
+      if (LPM_BIT(a, n) != LPM_BIT(b, n))
+        {
+          break;
+        }
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: lpm_alloc
+ *
+ * Description:
+ *   Allocate a node for the first plen bits of the key.
+ *
+ ****************************************************************************/
+
+static FAR struct net_lpm_node_s *lpm_alloc(FAR const uint8_t *key,
+                                            int plen, FAR void *route)
+{
+  FAR struct net_lpm_node_s *node = g_lpm_free;
+  int nbytes = (plen + 7) >> 3;
+
+  if (node != NULL)
+    {
+      g_lpm_free = node->parent;
+      memset(node, 0, sizeof(struct net_lpm_node_s));
+
+      /* Keep only the prefix bits of the key */
+
+      memcpy(node->key, key, nbytes);
+      if ((plen & 7) != 0)
+        {
+          node->key[nbytes - 1] &= 0xff << (8 - (plen & 7));
+        }
+
+      node->plen  = plen;
+      node->route = route;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_free
+ ****************************************************************************/
+
+static void lpm_free(FAR struct net_lpm_node_s *node)
+{
+  node->parent = g_lpm_free;
+  g_lpm_free   = node;
+}
+
+/****************************************************************************
+ * Name: lpm_link
+ *
+ * Description:
+ *   Return the location of the pointer to a node.
+ *
+ ****************************************************************************/
+
+static FAR struct net_lpm_node_s **lpm_link(FAR struct net_lpm_s *lpm,
+                                            FAR struct net_lpm_node_s *node)
+{
+  FAR struct net_lpm_node_s *parent = node->parent;
+
+  if (parent == NULL)
+    {
+      return &lpm->root;
+    }
+
+  return &parent->child[parent->child[1] == node];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_lpm_initialize
+ *
+ * Description:
+ *   Initialize the pool of trie nodes.  Called from net_initroute().
+ *
+ ****************************************************************************/
+
+void net_lpm_initialize(void)
+{
+  int i;
+
+  g_lpm_free = NULL;
+  for (i = 0; i < NET_LPM_NNODES; i++)
+    {
+      lpm_free(&g_lpm_nodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Function: net_lpm_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a network mask of nbytes bytes (in network
+ *   order) or -EINVAL if the mask is not contiguous.
+ *
+ ****************************************************************************/
+
+int net_lpm_prefixlen(FAR const uint8_t *mask, int nbytes)
+{
+  int nbits = nbytes << 3;
+  int plen;
+  int n;
+
+  for (plen = 0; plen < nbits && LPM_BIT(mask, plen); plen++);
+
+  for (n = plen; n < nbits; n++)
+    {
+      if (LPM_BIT(mask, n))
+        {
+          return -EINVAL;
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Function: net_lpm_insert
+ *
+ * Description:
+ *   Add a route for the first plen bits of key to the trie.
+ *
+ * Returned Value:
+ *   OK on success; -EEXIST if there is already a route for the prefix or
+ *   -ENOMEM if no trie nodes are available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int net_lpm_insert(FAR struct net_lpm_s *lpm, FAR const uint8_t *key,
+                   int plen, FAR void *route)
+{
+  FAR struct net_lpm_node_s **link = &lpm->root;
+  FAR struct net_lpm_node_s *parent = NULL;
+  FAR struct net_lpm_node_s *node;
+  FAR struct net_lpm_node_s *leaf;
+  FAR struct net_lpm_node_s *glue;
+  int n;
+
+  while ((node = *link) != NULL)
+    {
+      n = lpm_common(node->key, key, node->plen < plen ? node->plen : plen);
+      if (n < node->plen)
+        {
+          /* The new prefix diverges from (or is a prefix of) this one */
+
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          /* Same prefix.  This may be a glue node. */
+
+          if (node->route != NULL)
+            {
+              return -EEXIST;
+            }
+
+          node->route = route;
+          return OK;
+        }
+
+      parent = node;
+      link   = &node->child[LPM_BIT(key, node->plen)];
+    }
+
+  leaf = lpm_alloc(key, plen, route);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  leaf->parent = parent;
+  if (node == NULL)
+    {
+      /* Add a leaf at the end of the path */
+
+      *link = leaf;
+    }
+  else if (n == plen)
+    {
+      /* The new prefix is a prefix of the node: Insert it above the node */
+
+      leaf->child[LPM_BIT(node->key, plen)] = node;
+      node->parent = leaf;
+      *link        = leaf;
+    }
+  else
+    {
+      /* The prefixes diverge at bit n:  Add a glue node with both below */
+
+      glue = lpm_alloc(key, n, NULL);
+      if (glue == NULL)
+        {
+          lpm_free(leaf);
+          return -ENOMEM;
+        }
+
+      glue->parent                       = parent;
+      glue->child[LPM_BIT(key, n)]       = leaf;
+      glue->child[LPM_BIT(node->key, n)] = node;
+      leaf->parent                       = glue;
+      node->parent                       = glue;
+      *link                              = glue;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Function: net_lpm_remove
+ *
+ * Description:
+ *   Remove the route for the first plen bits of key from the trie.
+ *
+ * Returned Value:
+ *   The route that was removed or NULL if there was none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR void *net_lpm_remove(FAR struct net_lpm_s *lpm, FAR const uint8_t *key,
+                         int plen)
+{
+  FAR struct net_lpm_node_s *node = lpm->root;
+  FAR struct net_lpm_node_s *child;
+  FAR struct net_lpm_node_s *parent;
+  FAR void *route;
+
+  /* Find the node with exactly this prefix */
+
+  while (node != NULL && node->plen < plen &&
+         lpm_common(node->key, key, node->plen) == node->plen)
+    {
+      node = node->child[LPM_BIT(key, node->plen)];
+    }
+
+  if (node == NULL || node->plen != plen || node->route == NULL ||
+      lpm_common(node->key, key, plen) != plen)
+    {
+      return NULL;
+    }
+
+  route       = node->route;
+  node->route = NULL;
+
+  /* Remove nodes that are no longer needed:  A node without a route is
+   * kept only while it joins two sub-tries.
+   */
+
+  while (node != NULL && node->route == NULL &&
+         (node->child[0] == NULL || node->child[1] == NULL))
+    {
+      child  = node->child[0] != NULL ? node->child[0] : node->child[1];
+      parent = node->parent;
+
+      *lpm_link(lpm, node) = child;
+      if (child != NULL)
+        {
+          /* The parent still has the same number of children */
+
+          child->parent = parent;
+          lpm_free(node);
+          break;
+        }
+
+      lpm_free(node);
+      node = parent;
+    }
+
+  return route;
+}
+
+/****************************************************************************
+ * Function: net_lpm_lookup
+ *
+ * Description:
+ *   Return the route with the longest prefix matching the first keybits
+ *   bits of key.  If a filter is provided, only routes for which it
+ *   returns true are considered.
+ *
+ * Returned Value:
+ *   The matching route or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR void *net_lpm_lookup(FAR struct net_lpm_s *lpm, FAR const uint8_t *key,
+                         int keybits, net_lpm_filter_t filter, FAR void *arg)
+{
+  FAR struct net_lpm_node_s *node = lpm->root;
+  FAR void *best = NULL;
+
+  /* The prefixes get longer along the path, so the last route found is the
+   * best one.
+   */
+
+  while (node != NULL && node->plen <= keybits &&
+         lpm_common(node->key, key, node->plen) == node->plen)
+    {
+      if (node->route != NULL &&
+          (filter == NULL || filter(node->route, arg)))
+        {
+          best = node->route;
+        }
+
+      if (node->plen == keybits)
+        {
+          break;
+        }
+
+      node = node->child[LPM_BIT(key, node->plen)];
+    }
+
+  return best;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_ROUTE_LPM */
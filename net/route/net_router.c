@@ -45,6 +45,7 @@
 
 #include <netinet/in.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "devif/devif.h"
@@ -56,6 +57,7 @@
  * Public Types
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ROUTE_LPM
 #ifdef CONFIG_NET_IPv4
 struct route_ipv4_match_s
 {
@@ -149,6 +151,7 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
   return 0;
 }
 #endif /* CONFIG_NET_IPv6 */
+#endif /* !CONFIG_NET_ROUTE_LPM */
 
 /****************************************************************************
  * Public Functions
@@ -174,7 +177,12 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 #ifdef CONFIG_NET_IPv4
 int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 {
+#ifdef CONFIG_NET_ROUTE_LPM
+  FAR struct net_route_s *route;
+  net_lock_t save;
+#else
   struct route_ipv4_match_s match;
+#endif
   int ret;
 
   /* Do not route the special broadcast IP address */
@@ -184,6 +192,25 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_NET_ROUTE_LPM
+  /* Find the route with the longest prefix that matches the address */
+
+  save  = net_lock();
+  route = (FAR struct net_route_s *)
+    net_lpm_lookup(&g_routes_lpm, (FAR const uint8_t *)&target,
+                   8 * sizeof(in_addr_t), NULL, NULL);
+  if (route != NULL)
+    {
+      net_ipv4addr_copy(*router, route->router);
+      ret = OK;
+    }
+  else
+    {
+      ret = -ENOENT;
+    }
+
+  net_unlock(save);
+#else
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -207,6 +234,7 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 
       ret = -ENOENT;
     }
+#endif
 
   return ret;
 }
@@ -232,7 +260,12 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 #ifdef CONFIG_NET_IPv6
 int net_ipv6_router(net_ipv6addr_t target, net_ipv6addr_t router)
 {
+#ifdef CONFIG_NET_ROUTE_LPM
+  FAR struct net_route_ipv6_s *route;
+  net_lock_t save;
+#else
   struct route_ipv6_match_s match;
+#endif
   int ret;
 
   /* Do not route the special broadcast IP address */
@@ -242,6 +275,25 @@ int net_ipv6_router(net_ipv6addr_t target, net_ipv6addr_t router)
       return -ENOENT;
     }
 
+#ifdef CONFIG_NET_ROUTE_LPM
+  /* Find the route with the longest prefix that matches the address */
+
+  save  = net_lock();
+  route = (FAR struct net_route_ipv6_s *)
+    net_lpm_lookup(&g_routes_lpm_ipv6, (FAR const uint8_t *)target,
+                   8 * sizeof(net_ipv6addr_t), NULL, NULL);
+  if (route != NULL)
+    {
+      net_ipv6addr_copy(router, route->router);
+      ret = OK;
+    }
+  else
+    {
+      ret = -ENOENT;
+    }
+
+  net_unlock(save);
+#else
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
@@ -265,6 +317,7 @@ int net_ipv6_router(net_ipv6addr_t target, net_ipv6addr_t router)
 
       ret = -ENOENT;
     }
+#endif
 
   return ret;
 }
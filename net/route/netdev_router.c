@@ -40,9 +40,11 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <errno.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 
@@ -55,6 +57,7 @@
  * Public Types
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ROUTE_LPM
 #ifdef CONFIG_NET_IPv4
 struct route_ipv4_devmatch_s
 {
@@ -72,11 +75,59 @@ struct route_ipv6_devmatch_s
   net_ipv6addr_t router;        /* IPv6 address of the router on one of our networks */
 };
 #endif
+#endif /* !CONFIG_NET_ROUTE_LPM */
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_ROUTE_LPM
+/****************************************************************************
+ * Function: net_ipv4_devfilter
+ *
+ * Description:
+ *   Return true if the router of the IPv4 route is on the device's network.
+ *
+ * Parameters:
+ *   route - The route to examine
+ *   arg   - The device (cast to void*)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static bool net_ipv4_devfilter(FAR void *route, FAR void *arg)
+{
+  FAR struct net_route_s *rt = (FAR struct net_route_s *)route;
+  FAR struct net_driver_s *dev = (FAR struct net_driver_s *)arg;
+
+  return net_ipv4addr_maskcmp(rt->router, dev->d_ipaddr, dev->d_netmask);
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Function: net_ipv6_devfilter
+ *
+ * Description:
+ *   Return true if the router of the IPv6 route is on the device's network.
+ *
+ * Parameters:
+ *   route - The route to examine
+ *   arg   - The device (cast to void*)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static bool net_ipv6_devfilter(FAR void *route, FAR void *arg)
+{
+  FAR struct net_route_ipv6_s *rt = (FAR struct net_route_ipv6_s *)route;
+  FAR struct net_driver_s *dev = (FAR struct net_driver_s *)arg;
+
+  return net_ipv6addr_maskcmp(rt->router, dev->d_ipv6addr,
+                              dev->d_ipv6netmask);
+}
+#endif /* CONFIG_NET_IPv6 */
+
+#else /* CONFIG_NET_ROUTE_LPM */
 /****************************************************************************
  * Function: net_ipv4_devmatch
  *
@@ -158,6 +209,7 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route, FAR void *arg)
   return 0;
 }
 #endif /* CONFIG_NET_IPv6 */
+#endif /* CONFIG_NET_ROUTE_LPM */
 
 /****************************************************************************
  * Public Functions
@@ -188,9 +240,42 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route, FAR void *arg)
 void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
                         FAR in_addr_t *router)
 {
+#ifdef CONFIG_NET_ROUTE_LPM
+  FAR struct net_route_s *route;
+#else
   struct route_ipv4_devmatch_s match;
-  int ret;
+#endif
+  net_lock_t save;
+  bool found;
+
+  save = net_lock();
+
+#ifdef CONFIG_NET_ROUTE_CACHE
+  /* The same destination as last time? */
+
+  if (dev->d_rtgen == g_route_generation &&
+      net_ipv4addr_cmp(dev->d_rtdest, target))
+    {
+      net_ipv4addr_copy(*router, dev->d_rtrouter);
+      net_unlock(save);
+      return;
+    }
+#endif
+
+#ifdef CONFIG_NET_ROUTE_LPM
+  /* Find the route with the longest prefix that matches the address and
+   * that can forward to this address using this device.
+   */
 
+  route = (FAR struct net_route_s *)
+    net_lpm_lookup(&g_routes_lpm, (FAR const uint8_t *)&target,
+                   8 * sizeof(in_addr_t), net_ipv4_devfilter, dev);
+  found = (route != NULL);
+  if (found)
+    {
+      net_ipv4addr_copy(*router, route->router);
+    }
+#else
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_devmatch_s));
@@ -201,12 +286,24 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
    * address using this device.
    */
 
-  ret = net_foreachroute(net_ipv4_devmatch, &match);
-  if (ret > 0)
+  found = (net_foreachroute(net_ipv4_devmatch, &match) > 0);
+  if (found)
     {
       /* We found a route.  Return the router address. */
 
-      net_ipv4addr_copy(*router, match.target);
+      net_ipv4addr_copy(*router, match.router);
+    }
+#endif
+
+  if (found)
+    {
+#ifdef CONFIG_NET_ROUTE_CACHE
+      /* Remember the route for the next packet to the same destination */
+
+      net_ipv4addr_copy(dev->d_rtdest, target);
+      net_ipv4addr_copy(dev->d_rtrouter, *router);
+      dev->d_rtgen = g_route_generation;
+#endif
     }
   else
     {
@@ -216,6 +313,8 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
 
       net_ipv4addr_copy(*router, dev->d_draddr);
     }
+
+  net_unlock(save);
 }
 #endif
 
@@ -245,9 +344,42 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR const net_ipv6addr_t target,
                         FAR net_ipv6addr_t router)
 {
+#ifdef CONFIG_NET_ROUTE_LPM
+  FAR struct net_route_ipv6_s *route;
+#else
   struct route_ipv6_devmatch_s match;
-  int ret;
+#endif
+  net_lock_t save;
+  bool found;
+
+  save = net_lock();
 
+#ifdef CONFIG_NET_ROUTE_CACHE
+  /* The same destination as last time? */
+
+  if (dev->d_rtgen6 == g_route_generation &&
+      net_ipv6addr_cmp(dev->d_rtdest6, target))
+    {
+      net_ipv6addr_copy(router, dev->d_rtrouter6);
+      net_unlock(save);
+      return;
+    }
+#endif
+
+#ifdef CONFIG_NET_ROUTE_LPM
+  /* Find the route with the longest prefix that matches the address and
+   * that can forward to this address using this device.
+   */
+
+  route = (FAR struct net_route_ipv6_s *)
+    net_lpm_lookup(&g_routes_lpm_ipv6, (FAR const uint8_t *)target,
+                   8 * sizeof(net_ipv6addr_t), net_ipv6_devfilter, dev);
+  found = (route != NULL);
+  if (found)
+    {
+      net_ipv6addr_copy(router, route->router);
+    }
+#else
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_devmatch_s));
@@ -258,12 +390,24 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
    * address using this device.
    */
 
-  ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
-  if (ret > 0)
+  found = (net_foreachroute_ipv6(net_ipv6_devmatch, &match) > 0);
+  if (found)
     {
       /* We found a route.  Return the router address. */
 
-      net_ipv6addr_copy(router, match.target);
+      net_ipv6addr_copy(router, match.router);
+    }
+#endif
+
+  if (found)
+    {
+#ifdef CONFIG_NET_ROUTE_CACHE
+      /* Remember the route for the next packet to the same destination */
+
+      net_ipv6addr_copy(dev->d_rtdest6, target);
+      net_ipv6addr_copy(dev->d_rtrouter6, router);
+      dev->d_rtgen6 = g_route_generation;
+#endif
     }
   else
     {
@@ -273,6 +417,8 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
 
       net_ipv6addr_copy(router, dev->d_ipv6draddr);
     }
+
+  net_unlock(save);
 }
 #endif
 
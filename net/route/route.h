@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #include <net/if.h>
@@ -59,6 +61,33 @@
 #  define CONFIG_NET_MAXROUTES 4
 #endif
 
+/* Size of the keys in the longest prefix match trie */
+
+#ifdef CONFIG_NET_IPv6
+#  define NET_LPM_KEYLEN 16
+#else
+#  define NET_LPM_KEYLEN 4
+#endif
+
+/* Invalidate the route caches of all devices.  This must be done whenever
+ * a route is added or removed or the address or network mask of a device
+ * changes.
+ */
+
+#ifdef CONFIG_NET_ROUTE_CACHE
+#  define net_route_invalidate() \
+  do \
+    { \
+      if (++g_route_generation == 0) \
+        { \
+          g_route_generation = 1; \
+        } \
+    } \
+  while (0)
+#else
+#  define net_route_invalidate()
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -92,6 +121,34 @@ struct net_route_ipv6_s
 typedef int (*route_handler_ipv6_t)(FAR struct net_route_ipv6_s *route, FAR void *arg);
 #endif
 
+#ifdef CONFIG_NET_ROUTE_LPM
+/* One node of the longest prefix match trie.  This is a binary trie in
+ * which chains of nodes with a single child are compressed:  A node holds
+ * the first plen bits of its key and either a route for that prefix or,
+ * for a glue node, two children.
+ */
+
+struct net_lpm_node_s
+{
+  FAR struct net_lpm_node_s *parent;   /* Parent node (NULL for the root) */
+  FAR struct net_lpm_node_s *child[2]; /* Children by the next key bit */
+  FAR void *route;                     /* Route for the prefix (or NULL) */
+  uint8_t key[NET_LPM_KEYLEN];         /* Prefix bits in network order */
+  uint8_t plen;                        /* Prefix length in bits */
+};
+
+/* The root of one trie (one per address family) */
+
+struct net_lpm_s
+{
+  FAR struct net_lpm_node_s *root;
+};
+
+/* Type of the filter function provided to net_lpm_lookup() */
+
+typedef bool (*net_lpm_filter_t)(FAR void *route, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -113,6 +170,26 @@ EXTERN sq_queue_t g_routes;
 EXTERN sq_queue_t g_routes_ipv6;
 #endif
 
+#ifdef CONFIG_NET_ROUTE_LPM
+/* The same routes, indexed by prefix */
+
+#ifdef CONFIG_NET_IPv4
+EXTERN struct net_lpm_s g_routes_lpm;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+EXTERN struct net_lpm_s g_routes_lpm_ipv6;
+#endif
+#endif
+
+#ifdef CONFIG_NET_ROUTE_CACHE
+/* Incremented by net_route_invalidate().  A device route cache entry is
+ * valid only if it was saved with the current value.
+ */
+
+EXTERN uint16_t g_route_generation;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -344,10 +421,86 @@ int net_foreachroute(route_handler_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Function: net_lpm_initialize
+ *
+ * Description:
+ *   Initialize the pool of trie nodes.  Called from net_initroute().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ROUTE_LPM
+void net_lpm_initialize(void);
+#endif
+
+/****************************************************************************
+ * Function: net_lpm_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a network mask of nbytes bytes (in network
+ *   order) or -EINVAL if the mask is not contiguous.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ROUTE_LPM
+int net_lpm_prefixlen(FAR const uint8_t *mask, int nbytes);
+#endif
+
+/****************************************************************************
+ * Function: net_lpm_insert
+ *
+ * Description:
+ *   Add a route for the first plen bits of key to the trie.
+ *
+ * Returned Value:
+ *   OK on success; -EEXIST if there is already a route for the prefix or
+ *   -ENOMEM if no trie nodes are available.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ROUTE_LPM
+int net_lpm_insert(FAR struct net_lpm_s *lpm, FAR const uint8_t *key,
+                   int plen, FAR void *route);
+#endif
+
+/****************************************************************************
+ * Function: net_lpm_remove
+ *
+ * Description:
+ *   Remove the route for the first plen bits of key from the trie.
+ *
+ * Returned Value:
+ *   The route that was removed or NULL if there was none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ROUTE_LPM
+FAR void *net_lpm_remove(FAR struct net_lpm_s *lpm, FAR const uint8_t *key,
+                         int plen);
+#endif
+
+/****************************************************************************
+ * Function: net_lpm_lookup
+ *
+ * Description:
+ *   Return the route with the longest prefix matching the first keybits
+ *   bits of key.  If a filter is provided, only routes for which it
+ *   returns true are considered.  The cost is proportional to the key
+ *   length, not to the number of routes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ROUTE_LPM
+FAR void *net_lpm_lookup(FAR struct net_lpm_s *lpm, FAR const uint8_t *key,
+                         int keybits, net_lpm_filter_t filter, FAR void *arg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
 #endif
 
+#else
+#  define net_route_invalidate()
 #endif /* CONFIG_NET_ROUTE */
 #endif /* __NET_ROUTE_ROUTE_H */
@@ -132,9 +132,13 @@ int psock_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
   DEBUGASSERT(psock != NULL);
 
-  /* Is the socket a stream? */
+  /* Is the socket a stream (or a sequenced-packet socket)? */
 
-  if (psock->s_type != SOCK_STREAM)
+  if (psock->s_type != SOCK_STREAM
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      && psock->s_type != SOCK_SEQPACKET
+#endif
+     )
     {
       errcode = EOPNOTSUPP;
       goto errout;
@@ -208,7 +212,7 @@ int psock_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
   /* Initialize the socket structure. */
 
   newsock->s_domain = psock->s_domain;
-  newsock->s_type   = SOCK_STREAM;
+  newsock->s_type   = psock->s_type;
 
   /* Perform the correct accept operation for this address domain */
 
@@ -223,6 +223,9 @@ int psock_bind(FAR struct socket *psock, const struct sockaddr *addr,
        */
 
 #if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_LOCAL_STREAM)
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+#endif
       case SOCK_STREAM:
         {
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -284,6 +287,13 @@ int psock_bind(FAR struct socket *psock, const struct sockaddr *addr,
           else
 #endif
             {
+#ifdef CONFIG_NET_UDP_REUSEPORT
+              /* Let the UDP connection know if its port may be shared */
+
+              ((FAR struct udp_conn_s *)psock->s_conn)->reuseport =
+                _SO_GETOPT(psock->s_options, SO_REUSEPORT);
+#endif
+
               /* Bind the UDPP/IP connection structure */
 
               ret = udp_bind(psock->s_conn, addr);
@@ -568,6 +568,9 @@ int psock_connect(FAR struct socket *psock, FAR const struct sockaddr *addr,
   switch (psock->s_type)
     {
 #if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_LOCAL_STREAM)
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+#endif
       case SOCK_STREAM:
         {
           /* Verify that the socket is not already connected */
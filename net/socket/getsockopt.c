@@ -45,8 +45,14 @@
 #include <sys/time.h>
 #include <errno.h>
 
+#ifdef CONFIG_NET_TCP
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#endif
+
 #include "socket/socket.h"
 #include "utils/utils.h"
+#include "tcp/tcp.h"
 
 /****************************************************************************
  * Public Functions
@@ -98,6 +104,43 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
 {
   int errcode;
 
+#ifdef CONFIG_NET_TCP
+  /* TCP options.  Without Nagle's algorithm, segments are never delayed. */
+
+  if (level == IPPROTO_TCP)
+    {
+#ifdef CONFIG_NET_TCP_NAGLE
+      FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+#endif
+
+      if (psock->s_type != SOCK_STREAM || psock->s_domain == PF_PACKET ||
+          (option != TCP_NODELAY
+#ifdef CONFIG_NET_TCP_NAGLE
+           && option != TCP_CORK
+#endif
+          ))
+        {
+          errcode = ENOPROTOOPT;
+          goto errout;
+        }
+
+      if (!value || !value_len || *value_len < sizeof(int))
+        {
+          errcode = EINVAL;
+          goto errout;
+        }
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      *(FAR int *)value = (conn->sndopts & (option == TCP_NODELAY ?
+                           TCP_SNDOPT_NODELAY : TCP_SNDOPT_CORK)) != 0;
+#else
+      *(FAR int *)value = 1;
+#endif
+      *value_len = sizeof(int);
+      return OK;
+    }
+#endif
+
   /* Verify that the socket option if valid (but might not be supported ) */
 
   if (!_SO_GETVALID(option) || !value || !value_len)
@@ -118,10 +161,14 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
       case SO_DEBUG:      /* Enables recording of debugging information */
       case SO_BROADCAST:  /* Permits sending of broadcast messages */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_REUSEPORT:  /* Allow several sockets to bind the same port */
       case SO_KEEPALIVE:  /* Keeps connections active by enabling the
                            * periodic transmission */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_DONTROUTE:  /* Requests outgoing messages bypass standard routing */
+#ifdef CONFIG_NET_TIMESTAMP
+      case SO_TIMESTAMP:  /* Report the receive time in SCM_TIMESTAMP */
+#endif
         {
           sockopt_t optionset;
 
@@ -203,6 +250,36 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
         }
         break;
 
+#ifdef CONFIG_NET_TIMESTAMP
+      case SO_TIMESTAMPING: /* Reports the selected time stamps */
+        {
+          if (*value_len < sizeof(int))
+            {
+              errcode = EINVAL;
+              goto errout;
+            }
+
+          *(FAR int *)value = psock->s_tsflags;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TXPENDING
+      case SO_PRIORITY:   /* Reports the transmit priority */
+        {
+          if (*value_len < sizeof(int))
+            {
+              errcode = EINVAL;
+              goto errout;
+            }
+
+          *(FAR int *)value = psock->s_priority;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
       /* The following are not yet implemented */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
@@ -88,9 +88,15 @@ int psock_listen(FAR struct socket *psock, int backlog)
 
   DEBUGASSERT(psock != NULL);
 
-  /* Verify that the sockfd corresponds to a connected SOCK_STREAM */
+  /* Verify that the sockfd corresponds to a connected SOCK_STREAM (or
+   * SOCK_SEQPACKET)
+   */
 
-  if (psock->s_type != SOCK_STREAM || !psock->s_conn)
+  if ((psock->s_type != SOCK_STREAM
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+       && psock->s_type != SOCK_SEQPACKET
+#endif
+      ) || !psock->s_conn)
     {
       errcode = EOPNOTSUPP;
       goto errout;
@@ -85,6 +85,12 @@ int net_clone(FAR struct socket *psock1, FAR struct socket *psock2)
 #ifdef CONFIG_NET_SOLINGER
   psock2->s_linger   = psock1->s_linger;    /* Linger timeout value (in deciseconds) */
 #endif
+#ifdef CONFIG_NET_TIMESTAMP
+  psock2->s_tsflags  = psock1->s_tsflags;   /* SO_TIMESTAMPING flags */
+#endif
+#ifdef CONFIG_NET_TXPENDING
+  psock2->s_priority = psock1->s_priority;  /* SO_PRIORITY value */
+#endif
 #endif
   psock2->s_conn     = psock1->s_conn;      /* UDP or TCP connection structure */
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
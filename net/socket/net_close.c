@@ -276,6 +276,10 @@ end_wait:
 static inline void netclose_txnotify(FAR struct socket *psock,
                                      FAR struct tcp_conn_s *conn)
 {
+  /* Make sure that the device will poll this connection */
+
+  tcp_txpending(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -532,6 +536,9 @@ int psock_close(FAR struct socket *psock)
       switch (psock->s_type)
         {
 #if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_LOCAL_STREAM)
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+          case SOCK_SEQPACKET:
+#endif
           case SOCK_STREAM:
             {
 #ifdef CONFIG_NET_LOCAL_STREAM
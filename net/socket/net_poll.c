@@ -44,6 +44,7 @@
 #include "tcp/tcp.h"
 #include "udp/udp.h"
 #include "local/local.h"
+#include "pkt/pkt.h"
 #include "socket/socket.h"
 
 #if defined(CONFIG_NET) && !defined(CONFIG_DISABLE_POLL)
@@ -52,12 +53,20 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Packet sockets support poll() only on their receive ring */
+
+#undef HAVE_PKT_POLL
+#ifdef CONFIG_NET_PKT_RXRING
+#  define HAVE_PKT_POLL 1
+#endif
+
 /* Network polling can only be supported if poll support is provided by TCP,
- * UDP, or LOCAL sockets.
+ * UDP, LOCAL, or packet sockets.
  */
 
 #undef HAVE_NET_POLL
-#if defined(HAVE_TCP_POLL) || defined(HAVE_UDP_POLL) || defined(HAVE_LOCAL_POLL)
+#if defined(HAVE_TCP_POLL) || defined(HAVE_UDP_POLL) || \
+    defined(HAVE_LOCAL_POLL) || defined(HAVE_PKT_POLL)
 #  define HAVE_NET_POLL 1
 #endif
 
@@ -86,6 +95,13 @@
 static inline int net_pollsetup(FAR struct socket *psock,
                                 FAR struct pollfd *fds)
 {
+#ifdef HAVE_PKT_POLL
+  if (psock->s_domain == PF_PACKET)
+    {
+      return pkt_pollsetup(psock, fds);
+    }
+#endif
+
 #if defined(HAVE_TCP_POLL) || defined(HAVE_LOCAL_POLL)
   if (psock->s_type == SOCK_STREAM)
     {
@@ -154,6 +170,13 @@ static inline int net_pollsetup(FAR struct socket *psock,
 static inline int net_pollteardown(FAR struct socket *psock,
                                    FAR struct pollfd *fds)
 {
+#ifdef HAVE_PKT_POLL
+  if (psock->s_domain == PF_PACKET)
+    {
+      return pkt_pollteardown(psock, fds);
+    }
+#endif
+
 #if defined(HAVE_TCP_POLL) || defined(HAVE_LOCAL_POLL)
   if (psock->s_type == SOCK_STREAM)
     {
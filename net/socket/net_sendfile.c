@@ -58,6 +58,7 @@
 #include <arch/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -96,6 +97,7 @@ struct sendfile_s
   FAR struct devif_callback_s *snd_datacb; /* Data callback */
   FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
   FAR struct file   *snd_file;    /* File structure of the input file */
+  FAR const uint8_t *snd_xip;     /* Memory mapped file data (or NULL) */
   sem_t              snd_sem;     /* Used to wake up the waiting thread */
   off_t              snd_foffset; /* Input file offset */
   size_t             snd_flen;    /* File length */
@@ -294,7 +296,7 @@ static inline bool sendfile_addrcheck(FAR struct tcp_conn_s *conn)
 }
 
 #else /* CONFIG_NET_ETHERNET */
-#  sendfile_addrcheck(r) (true)
+#  define sendfile_addrcheck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
 /****************************************************************************
@@ -381,23 +383,48 @@ static uint16_t sendfile_interrupt(FAR struct net_driver_s *dev, FAR void *pvcon
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+          if (pstate->snd_xip != NULL)
             {
-              int errcode = get_errno();
-              nerr("ERROR: Failed to lseek: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
+              /* The file data is directly addressable (XIP):  Copy it
+               * straight from the media into the packet buffer without
+               * going through the file system.
+               */
+
+              memcpy(dev->d_appdata,
+                     &pstate->snd_xip[pstate->snd_foffset + pstate->snd_sent],
+                     sndlen);
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+          else
             {
-              int errcode = get_errno();
-              nerr("ERROR: Failed to read from input file: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  int errcode = get_errno();
+                  nerr("ERROR: Failed to lseek: %d\n", errcode);
+                  pstate->snd_sent = -errcode;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+              if (ret < 0)
+                {
+                  int errcode = get_errno();
+                  nerr("ERROR: Failed to read from input file: %d\n",
+                       errcode);
+                  pstate->snd_sent = -errcode;
+                  goto end_wait;
+                }
+              else if (ret == 0)
+                {
+                  /* End of file:  Only wait for the outstanding ACKs */
+
+                  pstate->snd_flen = pstate->snd_sent;
+                  goto end_wait;
+                }
+
+              sndlen = ret;
             }
 
           dev->d_sndlen = sndlen;
@@ -493,6 +520,10 @@ wait:
 static inline void sendfile_txnotify(FAR struct socket *psock,
                                      FAR struct tcp_conn_s *conn)
 {
+  /* Make sure that the device will poll this connection */
+
+  tcp_txpending(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -602,9 +633,15 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
 {
   FAR struct socket *psock = sockfd_socket(outfd);
   FAR struct tcp_conn_s *conn;
+  FAR const uint8_t *xip = NULL;
   struct sendfile_s state;
   net_lock_t save;
-  int errcode;
+  off_t startpos;
+  off_t endpos;
+  int errcode = 0;
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
+  int ret;
+#endif
 
   /* Verify that the sockfd corresponds to valid, allocated socket */
 
@@ -663,6 +700,42 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* Send from the file position if no offset is provided */
+
+  startpos = offset ? *offset : infile->f_pos;
+
+  /* If the file can be memory mapped (as on an XIP ROMFS volume), then the
+   * data can be taken directly from the media.  The end of the file must
+   * be determined in that case because nothing will stop at end-of-file.
+   */
+
+  if (file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&xip)) >= 0 &&
+      xip != NULL)
+    {
+      endpos = file_seek(infile, 0, SEEK_END);
+      if (endpos < 0)
+        {
+          xip = NULL;
+        }
+      else if (startpos >= endpos)
+        {
+          count = 0;
+        }
+      else if (count > endpos - startpos)
+        {
+          count = endpos - startpos;
+        }
+    }
+  else
+    {
+      xip = NULL;
+    }
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -677,9 +750,10 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
   memset(&state, 0, sizeof(struct sendfile_s));
   sem_init(&state. snd_sem, 0, 0);          /* Doesn't really fail */
   state.snd_sock    = psock;                /* Socket descriptor to use */
-  state.snd_foffset = offset ? *offset : 0; /* Input file offset */
+  state.snd_foffset = startpos;             /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+  state.snd_xip     = xip;                  /* Mapped file data */
 
   /* Allocate resources to receive a callback */
 
@@ -766,6 +840,17 @@ errout:
     }
   else
     {
+      /* Advance the offset or the file position past the data sent */
+
+      if (offset != NULL)
+        {
+          *offset = startpos + state.snd_sent;
+        }
+      else
+        {
+          (void)file_seek(infile, startpos + state.snd_sent, SEEK_SET);
+        }
+
       return state.snd_sent;
     }
 }
@@ -187,7 +187,11 @@ int net_vfcntl(int sockfd, int cmd, va_list ap)
 
           int mode =  va_arg(ap, int);
 #if defined(CONFIG_NET_LOCAL_STREAM) || defined(CONFIG_NET_TCP_READAHEAD)
-          if (psock->s_type == SOCK_STREAM) /* IP or Unix domain stream */
+          if (psock->s_type == SOCK_STREAM /* IP or Unix domain stream */
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+              || psock->s_type == SOCK_SEQPACKET
+#endif
+             )
             {
                if ((mode & O_NONBLOCK) != 0)
                  {
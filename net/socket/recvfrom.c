@@ -45,6 +45,7 @@
 #include <sys/socket.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 #include <errno.h>
 #include <debug.h>
 #include <assert.h>
@@ -274,9 +275,9 @@ static inline void recvfrom_newtcpdata(FAR struct net_driver_s *dev,
 #ifdef CONFIG_DEBUG_NET
       uint16_t nsaved;
 
-      nsaved = tcp_datahandler(conn, buffer, buflen);
+      nsaved = tcp_datahandler(dev, conn, buffer, buflen);
 #else
-      (void)tcp_datahandler(conn, buffer, buflen);
+      (void)tcp_datahandler(dev, conn, buffer, buflen);
 #endif
 
       /* There are complicated buffering issues that are not addressed fully
@@ -440,6 +441,13 @@ static inline void recvfrom_udpreadahead(struct recvfrom_s *pstate)
 
       DEBUGASSERT(iob->io_pktlen > 0);
 
+#ifdef CONFIG_NET_TIMESTAMP
+      /* Save the receive time stamps for recvmsg() */
+
+      pstate->rf_sock->s_rxswtime = iob->io_swtime;
+      pstate->rf_sock->s_rxhwtime = iob->io_hwtime;
+#endif
+
       /* Transfer that buffered data from the I/O buffer chain into
        * the user buffer.
        */
@@ -979,6 +987,13 @@ static uint16_t recvfrom_tcpinterrupt(FAR struct net_driver_s *dev,
 #ifdef CONFIG_NET_UDP
 static inline void recvfrom_udpsender(struct net_driver_s *dev, struct recvfrom_s *pstate)
 {
+#ifdef CONFIG_NET_TIMESTAMP
+  /* Save the receive time stamps for recvmsg() */
+
+  pstate->rf_sock->s_rxhwtime = dev->d_rxtime;
+  (void)clock_gettime(CLOCK_REALTIME, &pstate->rf_sock->s_rxswtime);
+#endif
+
   /* Get the family from the packet type, IP address from the IP header, and
    * the port number from the UDP header.
    */
@@ -1471,6 +1486,7 @@ errout_with_state:
  *   psock  Pointer to the socket structure for the SOCK_DRAM socket
  *   buf    Buffer to receive data
  *   len    Length of buffer
+ *   flags  Receive flags (only MSG_DONTWAIT is used)
  *   from   INET address of source (may be NULL)
  *
  * Returned Value:
@@ -1483,7 +1499,8 @@ errout_with_state:
 
 #ifdef CONFIG_NET_UDP
 static ssize_t udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
-                            FAR struct sockaddr *from, FAR socklen_t *fromlen)
+                            int flags, FAR struct sockaddr *from,
+                            FAR socklen_t *fromlen)
 {
   FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
   FAR struct net_driver_s *dev;
@@ -1529,7 +1546,7 @@ static ssize_t udp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #endif
 
 #ifdef CONFIG_NET_UDP_READAHEAD
-  if (_SS_ISNONBLOCK(psock->s_flags))
+  if (_SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0)
     {
       /* Return the number of bytes read from the read-ahead buffer if
        * something was received (already in 'ret'); EAGAIN if not.
@@ -1937,6 +1954,9 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #endif /* CONFIG_NET_PKT */
 
 #if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_LOCAL_STREAM)
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+    case SOCK_SEQPACKET:
+#endif
     case SOCK_STREAM:
       {
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -1979,7 +1999,7 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         else
 #endif
           {
-            ret = udp_recvfrom(psock, buf, len, from, fromlen);
+            ret = udp_recvfrom(psock, buf, len, flags, from, fromlen);
           }
 #endif /* CONFIG_NET_UDP */
       }
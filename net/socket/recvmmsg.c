@@ -0,0 +1,197 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: recvmmsg_one
+ *
+ * Description:
+ *   Receive one message into the buffer described by a msghdr structure.
+ *
+ * Returned Value:
+ *   The number of bytes received on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static ssize_t recvmmsg_one(FAR struct socket *psock,
+                            FAR struct msghdr *msg, int flags)
+{
+  ssize_t ret;
+
+  /* psock_recvmsg() also returns the ancillary data of the message */
+
+  ret = psock_recvmsg(psock, msg, flags);
+  if (ret < 0)
+    {
+      return -get_errno();
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' messages from a socket with a single call.  This
+ *   is equivalent to calling recvfrom() for each message, but the network
+ *   is locked only once for the whole batch so that the messages already
+ *   buffered in the UDP read-ahead queue are drained without a
+ *   reschedule between them.
+ *
+ *   The call blocks until all 'vlen' messages are received unless
+ *   MSG_WAITFORONE is set, in which case it blocks only for the first
+ *   message and then returns as soon as no more messages are buffered.
+ *   If 'timeout' is not NULL, no more messages are received after the
+ *   timeout has elapsed.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Array of messages to be received.  Each message must provide
+ *            exactly one I/O vector.
+ *   vlen     The number of elements in msgvec
+ *   flags    Receive flags
+ *   timeout  Timeout for the complete call (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  The length of
+ *   each message is returned in its msg_len field.  On error, -1 is
+ *   returned and errno is set appropriately (see recvfrom()).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  net_lock_t save;
+  systime_t start = 0;
+  systime_t ticks = 0;
+  unsigned int n;
+  ssize_t ret = OK;
+
+  if (msgvec == NULL || vlen == 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  if (timeout != NULL)
+    {
+      ticks = SEC2TICK(timeout->tv_sec) + NSEC2TICK(timeout->tv_nsec);
+      start = clock_systimer();
+    }
+
+  /* The network lock may be taken recursively, so the lock taken by
+   * psock_recvfrom() for each message is only a nested reference.
+   */
+
+  save = net_lock();
+  for (n = 0; n < vlen; n++)
+    {
+      ret = recvmmsg_one(psock, &msgvec[n].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[n].msg_len = ret;
+
+      /* Don't wait for any more messages after the first if so requested */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+#if !defined(CONFIG_NET_UDP_READAHEAD)
+          /* Without the read-ahead buffers there is no way to check for
+           * another message without waiting for it.
+           */
+
+          n++;
+          break;
+#else
+          flags |= MSG_DONTWAIT;
+#endif
+        }
+
+      if (timeout != NULL && clock_systimer() - start >= ticks)
+        {
+          n++;
+          break;
+        }
+    }
+
+  net_unlock(save);
+
+  /* Report an error only if nothing at all was received */
+
+  if (n == 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return n;
+}
+
+#endif /* CONFIG_NET */
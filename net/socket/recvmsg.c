@@ -0,0 +1,358 @@
+/****************************************************************************
+ * net/socket/recvmsg.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: recvmsg_putcmsg
+ *
+ * Description:
+ *   Append one control message to the msg_control buffer.  'used' is the
+ *   number of bytes of the buffer that are already in use.  If the message
+ *   does not fit, MSG_CTRUNC is set in msg_flags.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMP
+static void recvmsg_putcmsg(FAR struct msghdr *msg, FAR size_t *used,
+                            int level, int type, FAR const void *data,
+                            size_t len)
+{
+  FAR struct cmsghdr *cmsg;
+
+  if (msg->msg_control == NULL ||
+      *used + CMSG_SPACE(len) > (size_t)msg->msg_controllen)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+      return;
+    }
+
+  cmsg             = (FAR struct cmsghdr *)
+                     ((FAR uint8_t *)msg->msg_control + *used);
+  cmsg->cmsg_len   = CMSG_LEN(len);
+  cmsg->cmsg_level = level;
+  cmsg->cmsg_type  = type;
+  memcpy(CMSG_DATA(cmsg), data, len);
+
+  *used += CMSG_SPACE(len);
+}
+#endif
+
+/****************************************************************************
+ * Function: recvmsg_timestamps
+ *
+ * Description:
+ *   Add the time stamp control messages selected by the socket options to
+ *   the msg_control buffer.  'swtime' and 'hwtime' are the software and
+ *   hardware time stamps.  'rxtx' is SOF_TIMESTAMPING_RX_SOFTWARE or
+ *   SOF_TIMESTAMPING_TX_SOFTWARE (the corresponding hardware flag is one
+ *   bit lower).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMP
+static void recvmsg_timestamps(FAR struct socket *psock,
+                               FAR struct msghdr *msg, FAR size_t *used,
+                               FAR const struct timespec *swtime,
+                               FAR const struct timespec *hwtime,
+                               int rxtx)
+{
+  uint8_t tsflags = psock->s_tsflags;
+
+  if (rxtx == SOF_TIMESTAMPING_RX_SOFTWARE &&
+      _SO_GETOPT(psock->s_options, SO_TIMESTAMP))
+    {
+      struct timeval tv;
+
+      tv.tv_sec  = swtime->tv_sec;
+      tv.tv_usec = swtime->tv_nsec / 1000;
+      recvmsg_putcmsg(msg, used, SOL_SOCKET, SCM_TIMESTAMP, &tv,
+                      sizeof(struct timeval));
+    }
+
+  if ((tsflags & (SOF_TIMESTAMPING_SOFTWARE |
+                  SOF_TIMESTAMPING_RAW_HARDWARE)) != 0 &&
+      (tsflags & (rxtx | (rxtx >> 1))) != 0)
+    {
+      struct timespec ts[3];
+
+      /* ts[0] is the software time stamp, ts[2] the raw hardware time
+       * stamp.  ts[1] is unused, as in Linux.
+       */
+
+      memset(ts, 0, sizeof(ts));
+      if ((tsflags & SOF_TIMESTAMPING_SOFTWARE) != 0 &&
+          (tsflags & rxtx) != 0)
+        {
+          ts[0] = *swtime;
+        }
+
+      if ((tsflags & SOF_TIMESTAMPING_RAW_HARDWARE) != 0 &&
+          (tsflags & (rxtx >> 1)) != 0)
+        {
+          ts[2] = *hwtime;
+        }
+
+      recvmsg_putcmsg(msg, used, SOL_SOCKET, SCM_TIMESTAMPING, ts,
+                      sizeof(ts));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Function: recvmsg_errqueue
+ *
+ * Description:
+ *   Return the transmit time stamps of the last datagram sent on a UDP
+ *   socket.  No data is returned.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  -EAGAIN means that
+ *   there is no transmit time stamp to be read.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TIMESTAMP) && defined(CONFIG_NET_UDP)
+static int recvmsg_errqueue(FAR struct socket *psock,
+                            FAR struct msghdr *msg)
+{
+  FAR struct udp_conn_s *conn;
+  net_lock_t save;
+  size_t used = 0;
+  int ret = OK;
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      return -EBADF;
+    }
+
+  if (psock->s_type != SOCK_DGRAM || psock->s_conn == NULL ||
+      (psock->s_domain != PF_INET && psock->s_domain != PF_INET6))
+    {
+      return -EOPNOTSUPP;
+    }
+
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+
+  save = net_lock();
+  if (!conn->txtsvalid)
+    {
+      ret = -EAGAIN;
+    }
+  else
+    {
+      msg->msg_flags = MSG_ERRQUEUE;
+      recvmsg_timestamps(psock, msg, &used, &conn->txswtime,
+                         &conn->txhwtime, SOF_TIMESTAMPING_TX_SOFTWARE);
+
+      msg->msg_controllen = used;
+      msg->msg_namelen    = 0;
+      conn->txtsvalid     = false;
+    }
+
+  net_unlock(save);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: psock_recvmsg
+ *
+ * Description:
+ *   Receive one message into the buffer described by a msghdr structure.
+ *   See recvmsg() for the details.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      The message to be received
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received.  On failure, -1 is
+ *   returned and errno is set appropriately (see psock_recvfrom()).
+ *
+ ****************************************************************************/
+
+ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                      int flags)
+{
+  FAR struct sockaddr *from;
+#ifdef CONFIG_NET_TIMESTAMP
+  net_lock_t save;
+  size_t used = 0;
+#endif
+  ssize_t ret;
+  int errcode;
+
+  /* REVISIT: Only a single I/O vector is supported because the data is
+   * received directly into the user buffer by psock_recvfrom().
+   */
+
+  if (msg == NULL || msg->msg_iovlen != 1 || msg->msg_iov == NULL)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+#if defined(CONFIG_NET_TIMESTAMP) && defined(CONFIG_NET_UDP)
+      errcode = -recvmsg_errqueue(psock, msg);
+      if (errcode == OK)
+        {
+          return 0;
+        }
+#else
+      errcode = EAGAIN;
+#endif
+      goto errout;
+    }
+
+  from = (FAR struct sockaddr *)msg->msg_name;
+
+#ifdef CONFIG_NET_TIMESTAMP
+  /* Keep the network locked until the time stamps of the datagram have
+   * been copied, so that another receive on the same socket cannot replace
+   * them.  The lock may be taken recursively.
+   */
+
+  save = net_lock();
+#endif
+
+  ret = psock_recvfrom(psock, msg->msg_iov[0].iov_base,
+                       msg->msg_iov[0].iov_len, flags, from,
+                       from != NULL ? &msg->msg_namelen : NULL);
+  if (ret >= 0)
+    {
+      msg->msg_flags = 0;
+
+#ifdef CONFIG_NET_TIMESTAMP
+      if (psock->s_type == SOCK_DGRAM)
+        {
+          recvmsg_timestamps(psock, msg, &used, &psock->s_rxswtime,
+                             &psock->s_rxhwtime,
+                             SOF_TIMESTAMPING_RX_SOFTWARE);
+        }
+
+      msg->msg_controllen = used;
+#else
+      msg->msg_controllen = 0;
+#endif
+    }
+
+#ifdef CONFIG_NET_TIMESTAMP
+  net_unlock(save);
+#endif
+
+  return ret;
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Function: recvmsg
+ *
+ * Description:
+ *   Receive a message from a socket into the buffer described by a msghdr
+ *   structure.  This is like recvfrom() with, in addition, ancillary data
+ *   returned in msg_control:
+ *
+ *   - SCM_TIMESTAMP (struct timeval), the software receive time of a
+ *     datagram, if the SO_TIMESTAMP option is enabled.
+ *   - SCM_TIMESTAMPING (struct timespec[3]), the software and raw hardware
+ *     receive times selected with the SO_TIMESTAMPING option.
+ *
+ *   With MSG_ERRQUEUE, no data is received.  Instead, the transmit time
+ *   stamps of the last datagram sent on a UDP socket with
+ *   SOF_TIMESTAMPING_TX_* enabled are returned in an SCM_TIMESTAMPING
+ *   message; the call fails with EAGAIN if they are not (yet) available.
+ *
+ *   If msg_control is too small for all of the ancillary data, MSG_CTRUNC
+ *   is set in msg_flags.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msg      The message to be received.  It must provide exactly one I/O
+ *            vector.
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received.  On failure, -1 is
+ *   returned and errno is set appropriately (see recvfrom()).
+ *
+ ****************************************************************************/
+
+ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags)
+{
+  FAR struct socket *psock;
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* Then let psock_recvmsg() do all of the work */
+
+  return psock_recvmsg(psock, msg, flags);
+}
+
+#endif /* CONFIG_NET */
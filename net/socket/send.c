@@ -133,6 +133,9 @@ ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len,
 #endif
 
 #if defined(CONFIG_NET_TCP) || defined(CONFIG_NET_LOCAL_STREAM)
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+#endif
       case SOCK_STREAM:
         {
 #ifdef CONFIG_NET_LOCAL_STREAM
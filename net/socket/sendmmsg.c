@@ -0,0 +1,140 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *   Send up to 'vlen' messages on a socket with a single call.  This is
+ *   equivalent to calling sendto() for each message, but the network is
+ *   locked only once for the whole batch.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Array of messages to be sent.  Each message must provide
+ *            exactly one I/O vector.
+ *   vlen     The number of elements in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  The number of bytes
+ *   sent for each message is returned in its msg_len field.  On error, -1
+ *   is returned and errno is set appropriately (see sendto()).
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  FAR struct msghdr *msg;
+  net_lock_t save;
+  unsigned int n;
+  ssize_t ret;
+  int errcode = OK;
+
+  if (msgvec == NULL || vlen == 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* The network lock may be taken recursively, so the lock taken by
+   * psock_sendto() for each message is only a nested reference.
+   */
+
+  save = net_lock();
+  for (n = 0; n < vlen; n++)
+    {
+      msg = &msgvec[n].msg_hdr;
+
+      /* REVISIT: Only a single I/O vector is supported */
+
+      if (msg->msg_iovlen != 1 || msg->msg_iov == NULL)
+        {
+          errcode = EINVAL;
+          break;
+        }
+
+      ret = psock_sendto(psock, msg->msg_iov[0].iov_base,
+                         msg->msg_iov[0].iov_len, flags,
+                         (FAR const struct sockaddr *)msg->msg_name,
+                         msg->msg_namelen);
+      if (ret < 0)
+        {
+          errcode = get_errno();
+          break;
+        }
+
+      msgvec[n].msg_len = ret;
+    }
+
+  net_unlock(save);
+
+  /* Report an error only if nothing at all was sent */
+
+  if (n == 0)
+    {
+      set_errno(errcode);
+      return ERROR;
+    }
+
+  return n;
+}
+
+#endif /* CONFIG_NET */
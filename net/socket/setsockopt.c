@@ -44,13 +44,97 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <stdint.h>
 #include <errno.h>
 #include <arch/irq.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NET_PKT_RXRING
+#  include <netpacket/packet.h>
+#endif
+
+#ifdef CONFIG_NET_UDP_SRCFILTER
+#  include <netinet/in.h>
+#endif
+
+#ifdef CONFIG_NET_TCP
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#endif
 
 #include "socket/socket.h"
 #include "utils/utils.h"
+#include "devif/devif.h"
+#include "pkt/pkt.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: psock_tcp_setsockopt
+ *
+ * Description:
+ *   Set a TCP socket option (level IPPROTO_TCP).  Without Nagle's
+ *   algorithm (CONFIG_NET_TCP_NAGLE), segments are never delayed, so
+ *   TCP_NODELAY is accepted but has no effect.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP
+static int psock_tcp_setsockopt(FAR struct socket *psock, int option,
+                                FAR const void *value, socklen_t value_len)
+{
+#ifdef CONFIG_NET_TCP_NAGLE
+  uint8_t sndopt;
+#endif
+  int setting;
+
+  if (psock->s_type != SOCK_STREAM || psock->s_domain == PF_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL || value_len != sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  setting = *(FAR const int *)value;
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_NODELAY:
+        sndopt = TCP_SNDOPT_NODELAY;
+        break;
+
+      case TCP_CORK:
+        sndopt = TCP_SNDOPT_CORK;
+        break;
+#else
+      case TCP_NODELAY:
+        UNUSED(setting);
+        return OK;
+#endif
+
+      default:
+        return -ENOPROTOOPT;
+    }
+
+#ifdef CONFIG_NET_TCP_NAGLE
+  psock_tcp_sndopt(psock, sndopt, setting != 0);
+  return OK;
+#endif
+}
+#endif /* CONFIG_NET_TCP */
 
 /****************************************************************************
  * Public Functions
@@ -108,6 +192,81 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
   net_lock_t flags;
   int errcode;
 
+#ifdef CONFIG_NET_PKT_RXRING
+  /* Packet socket options */
+
+  if (level == SOL_PACKET)
+    {
+      if (option != PACKET_RX_RING || !value)
+        {
+          errcode = ENOPROTOOPT;
+          goto errout;
+        }
+
+      errcode = -pkt_rxring_setup(psock, value, value_len);
+      if (errcode != 0)
+        {
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP_SRCFILTER
+  /* Source-specific multicast membership of UDP sockets.  IPPROTO_IP is the
+   * same as SOL_SOCKET so these are recognized by the option alone.
+   */
+
+  if (level == IPPROTO_IP &&
+      (option == IP_ADD_SOURCE_MEMBERSHIP ||
+       option == IP_DROP_SOURCE_MEMBERSHIP))
+    {
+      if (psock->s_domain != PF_INET || psock->s_type != SOCK_DGRAM)
+        {
+          errcode = ENOPROTOOPT;
+          goto errout;
+        }
+
+      if (!value || value_len < sizeof(struct ip_mreq_source))
+        {
+          errcode = EINVAL;
+          goto errout;
+        }
+
+      if (option == IP_ADD_SOURCE_MEMBERSHIP)
+        {
+          errcode = -udp_addsource(psock->s_conn, value);
+        }
+      else
+        {
+          errcode = -udp_dropsource(psock->s_conn, value);
+        }
+
+      if (errcode != 0)
+        {
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP
+  /* TCP options */
+
+  if (level == IPPROTO_TCP)
+    {
+      errcode = -psock_tcp_setsockopt(psock, option, value, value_len);
+      if (errcode != 0)
+        {
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Verify that the socket option if valid (but might not be supported ) */
 
   if (!_SO_SETVALID(option) || !value)
@@ -128,10 +287,14 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
       case SO_DEBUG:      /* Enables recording of debugging information */
       case SO_BROADCAST:  /* Permits sending of broadcast messages */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_REUSEPORT:  /* Allow several sockets to bind the same port */
       case SO_KEEPALIVE:  /* Keeps connections active by enabling the
                            * periodic transmission */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_DONTROUTE:  /* Requests outgoing messages bypass standard routing */
+#ifdef CONFIG_NET_TIMESTAMP
+      case SO_TIMESTAMP:  /* Report the receive time in SCM_TIMESTAMP */
+#endif
         {
           int setting;
 
@@ -254,6 +417,117 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
         }
         break;
 #endif
+#ifdef CONFIG_NET_TIMESTAMP
+      case SO_TIMESTAMPING: /* Select the time stamps to be reported */
+        {
+          int setting;
+
+          if (value_len != sizeof(int))
+            {
+              errcode = EINVAL;
+              goto errout;
+            }
+
+          setting = *(FAR int *)value;
+          if ((setting & ~SOF_TIMESTAMPING_MASK) != 0)
+            {
+              errcode = EINVAL;
+              goto errout;
+            }
+
+          flags = net_lock();
+
+          if (setting != 0)
+            {
+              _SO_SETOPT(psock->s_options, option);
+            }
+          else
+            {
+              _SO_CLROPT(psock->s_options, option);
+            }
+
+          psock->s_tsflags = (uint8_t)setting;
+
+#ifdef CONFIG_NET_UDP
+          /* UDP time stamps sent datagrams itself, so it needs a copy of
+           * the flags.
+           */
+
+          if (psock->s_type == SOCK_DGRAM && psock->s_conn != NULL &&
+              (psock->s_domain == PF_INET || psock->s_domain == PF_INET6))
+            {
+              FAR struct udp_conn_s *conn =
+                (FAR struct udp_conn_s *)psock->s_conn;
+
+              conn->tsflags   = (uint8_t)setting;
+              conn->txtsvalid = false;
+            }
+#endif
+
+          net_unlock(flags);
+        }
+        break;
+#endif
+#ifdef CONFIG_NET_TXPENDING
+      case SO_PRIORITY:   /* Sets the transmit priority */
+        {
+          FAR struct devif_txpend_s *txp = NULL;
+          int setting;
+
+          if (value_len != sizeof(int))
+            {
+              errcode = EINVAL;
+              goto errout;
+            }
+
+          setting = *(FAR int *)value;
+          if (setting < 0 || setting > UINT8_MAX)
+            {
+              errcode = EINVAL;
+              goto errout;
+            }
+
+          flags = net_lock();
+          psock->s_priority = (uint8_t)setting;
+
+          /* The connection carries the priority class that devif_poll()
+           * uses to order the connections waiting to send.
+           */
+
+          if (psock->s_conn != NULL)
+            {
+#ifdef CONFIG_NET_TCP
+              if (psock->s_type == SOCK_STREAM &&
+                  psock->s_domain != PF_PACKET)
+                {
+                  txp = &((FAR struct tcp_conn_s *)psock->s_conn)->txpend;
+                }
+#endif
+#ifdef CONFIG_NET_UDP
+              if (psock->s_type == SOCK_DGRAM &&
+                  psock->s_domain != PF_PACKET)
+                {
+                  txp = &((FAR struct udp_conn_s *)psock->s_conn)->txpend;
+                }
+#endif
+#ifdef CONFIG_NET_PKT
+              if (psock->s_domain == PF_PACKET)
+                {
+                  txp = &((FAR struct pkt_conn_s *)psock->s_conn)->txpend;
+                }
+#endif
+            }
+
+          if (txp != NULL)
+            {
+              devif_txpend_setprio(txp, setting);
+            }
+
+          net_unlock(flags);
+        }
+        break;
+#endif
+
       /* The following are not yet implemented */
 
       case SO_SNDBUF:     /* Sets send buffer size */
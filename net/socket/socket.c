@@ -292,7 +292,9 @@ int psock_socket(int domain, int type, int protocol, FAR struct socket *psock)
   UNUSED(ipdomain);
 #endif
 
-  /* Only SOCK_STREAM, SOCK_DGRAM and possible SOCK_RAW are supported */
+  /* Only SOCK_STREAM, SOCK_DGRAM and possible SOCK_SEQPACKET or SOCK_RAW
+   * are supported
+   */
 
   switch (type)
     {
@@ -327,6 +329,19 @@ int psock_socket(int domain, int type, int protocol, FAR struct socket *psock)
         break;
 #endif /* CONFIG_NET_TCP || CONFIG_NET_LOCAL_STREAM */
 
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+        /* Only supported for Unix domain sockets */
+
+        if (domain != PF_LOCAL || protocol != 0)
+          {
+            errcode = EPROTONOSUPPORT;
+            goto errout;
+          }
+
+        break;
+#endif
+
 #if defined(CONFIG_NET_UDP) || defined(CONFIG_NET_LOCAL_DGRAM)
       case SOCK_DGRAM:
 #ifdef CONFIG_NET_UDP
@@ -430,6 +445,23 @@ int psock_socket(int domain, int type, int protocol, FAR struct socket *psock)
         break;
 #endif
 
+#ifdef CONFIG_NET_LOCAL_SEQPACKET
+      case SOCK_SEQPACKET:
+        {
+          /* Allocate and attach the local connection structure */
+
+          ret = psock_local_alloc(psock);
+          if (ret < 0)
+            {
+              /* Failed to reserve a connection structure */
+
+              errcode = -ret;
+              goto errout;
+            }
+        }
+        break;
+#endif
+
 #if defined(CONFIG_NET_UDP) || defined(CONFIG_NET_LOCAL_DGRAM)
       case SOCK_DGRAM:
         {
@@ -91,7 +91,7 @@
 
 /* This macro converts a socket option value into a bit setting */
 
-#define _SO_BIT(o)       (1 << (o))
+#define _SO_BIT(o)       ((sockopt_t)1 << (o))
 
 /* These define bit positions for each socket option (see sys/socket.h) */
 
@@ -111,10 +111,14 @@
 #define _SO_RCVTIMEO     _SO_BIT(SO_RCVTIMEO)
 #define _SO_SNDLOWAT     _SO_BIT(SO_SNDLOWAT)
 #define _SO_SNDTIMEO     _SO_BIT(SO_SNDTIMEO)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
+#define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
+#define _SO_TIMESTAMPING _SO_BIT(SO_TIMESTAMPING)
+#define _SO_PRIORITY     _SO_BIT(SO_PRIORITY)
 
 /* This is the larget option value */
 
-#define _SO_MAXOPT       (15)
+#define _SO_MAXOPT       (19)
 
 /* Macros to set, test, clear options */
 
@@ -43,11 +43,16 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #include <nuttx/net/iob.h>
 #include <nuttx/net/ip.h>
 
+#ifdef CONFIG_NET_TXPENDING
+#  include <nuttx/net/netdev.h>
+#endif
+
 #ifdef CONFIG_NET_TCP
 
 /****************************************************************************
@@ -123,6 +128,29 @@
 #endif
 #endif
 
+/* tcp_parseoptions() leaves the window scale unchanged if the segment
+ * carries no window scale option.  Callers start with this value.
+ */
+
+#define TCP_WS_NONE 0xff
+
+/* Values of the sndopts field of struct tcp_conn_s */
+
+#define TCP_SNDOPT_NODELAY (1 << 0) /* TCP_NODELAY: Do not hold back data */
+#define TCP_SNDOPT_CORK    (1 << 1) /* TCP_CORK: Send only full segments */
+
+/* Per-connection statistics.  These are always updated with the network
+ * locked so, unlike the device statistics, a single copy suffices.
+ */
+
+#ifdef CONFIG_NET_TCP_CONNSTATS
+#  define TCP_CONNSTAT(conn,name)       ((conn)->stats.name++)
+#  define TCP_CONNSTAT_ADD(conn,name,n) ((conn)->stats.name += (n))
+#else
+#  define TCP_CONNSTAT(conn,name)
+#  define TCP_CONNSTAT_ADD(conn,name,n)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -141,9 +169,29 @@ struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
 
+#ifdef CONFIG_NET_TCP_CONNSTATS
+/* The counts of events on one TCP connection (see /proc/net/tcp) */
+
+struct tcp_connstats_s
+{
+  uint32_t rx_segments;   /* Number of segments received */
+  uint32_t rx_bytes;      /* Number of payload bytes accepted */
+  uint32_t rx_dropped;    /* Number of segments with data discarded */
+  uint32_t tx_segments;   /* Number of segments sent */
+  uint32_t retransmits;   /* Number of retransmissions */
+};
+#endif
+
 struct tcp_conn_s
 {
   dq_entry_t node;        /* Implements a doubly linked list */
+#ifdef CONFIG_NET_TCP_HASH
+  FAR struct tcp_conn_s *hnext; /* Next conn in the active hash chain */
+  FAR struct tcp_conn_s *pnext; /* Next conn in the local port hash chain */
+#endif
+#ifdef CONFIG_NET_TXPENDING
+  struct devif_txpend_s txpend; /* Queues the connection for TX polling */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -165,12 +213,24 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+  bool     wscale;        /* True: Window scaling negotiated */
+  uint8_t  snd_wscale;    /* Window scale shift of the peer */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
   uint16_t unacked;       /* Number bytes sent but not yet ACKed */
 #endif
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  uint8_t  rx_unackseg;   /* Number of received segments not yet ACKed */
+#endif
+#ifdef CONFIG_NET_TCP_NAGLE
+  uint8_t  sndopts;       /* Send options: TCP_SNDOPT_* */
+#endif
 
 #ifdef CONFIG_NETDEV_MULTINIC
   /* If the TCP socket is bound to a local address, then this is
@@ -210,6 +270,21 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control (RFC 5681)
+   *
+   *   cwnd     - The congestion window: The maximum number of un-ACKed
+   *              bytes in flight.
+   *   ssthresh - The slow start threshold.  Slow start while cwnd is
+   *              below this value, congestion avoidance above it.
+   *   dupacks  - The number of consecutive duplicate ACKs received.
+   */
+
+  uint32_t   cwnd;        /* Congestion window */
+  uint32_t   ssthresh;    /* Slow start threshold */
+  uint8_t    dupacks;     /* Count of duplicate ACKs */
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -225,6 +300,10 @@ struct tcp_conn_s
   FAR struct tcp_backlog_s *backlog;
 #endif
 
+#ifdef CONFIG_NET_TCP_CONNSTATS
+  struct tcp_connstats_s stats;   /* Per-connection statistics */
+#endif
+
   /* Application callbacks:
    *
    * Data transfer events are retained in 'list'.  Event handlers in 'list'
@@ -658,6 +737,25 @@ void tcp_nextsequence(void);
 
 void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_txpending
+ *
+ * Description:
+ *   Queue the connection for polling by the device that it sends through
+ *   (CONFIG_NET_TXPENDING).  Called before the device driver is notified
+ *   that TX data is available.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TXPENDING
+void tcp_txpending(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_txpending(conn)
+#endif
+
 /****************************************************************************
  * Name: tcp_timer
  *
@@ -747,6 +845,57 @@ bool tcp_islistener(uint16_t portno);
 int tcp_accept_connection(FAR struct net_driver_s *dev,
                           FAR struct tcp_conn_s *conn, uint16_t portno);
 
+/****************************************************************************
+ * Name: tcp_synq_input
+ *
+ * Description:
+ *   Handle a SYN for a listening port:  Remember the half-open connection
+ *   (or, if the queue is full and SYN cookies are enabled, encode it in our
+ *   initial sequence number) and answer with a SYNACK.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNQUEUE
+void tcp_synq_input(FAR struct net_driver_s *dev, FAR struct tcp_hdr_s *tcp,
+                    unsigned int iplen, unsigned int hdrlen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_synq_accept
+ *
+ * Description:
+ *   Create the connection for an ACK that completes the handshake of a
+ *   half-open connection.  Returns NULL if the ACK does not complete a
+ *   handshake or if the connection could not be created or accepted.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNQUEUE
+FAR struct tcp_conn_s *tcp_synq_accept(FAR struct net_driver_s *dev,
+                                       FAR struct tcp_hdr_s *tcp);
+#endif
+
+/****************************************************************************
+ * Name: tcp_synq_timer
+ *
+ * Description:
+ *   Forget half-open connections whose handshake did not complete.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNQUEUE
+void tcp_synq_timer(int hsec);
+#endif
+
 /****************************************************************************
  * Name: tcp_send
  *
@@ -811,6 +960,30 @@ void tcp_reset(FAR struct net_driver_s *dev);
 void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
              uint8_t ack);
 
+/****************************************************************************
+ * Name: tcp_synack
+ *
+ * Description:
+ *   Send a SYNACK in reply to the SYN in the device buffer without a
+ *   connection structure.
+ *
+ * Parameters:
+ *   dev    - The device driver structure holding the received SYN
+ *   iss    - Our initial sequence number
+ *   wscale - True:  Offer (a zero) window scale option
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNQUEUE
+void tcp_synack(FAR struct net_driver_s *dev, uint32_t iss, bool wscale);
+#endif
+
 /****************************************************************************
  * Name: tcp_appsend
  *
@@ -857,6 +1030,32 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 void tcp_rexmit(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                 uint16_t result);
 
+/****************************************************************************
+ * Name: tcp_cc_init, tcp_cc_ack, tcp_cc_dupack, and tcp_cc_timeout
+ *
+ * Description:
+ *   Congestion control (RFC 5681):  Initialize the congestion window of a
+ *   newly established connection, open it as data is ACKed, and close it
+ *   on a fast retransmit (tcp_cc_dupack() returns true on the third
+ *   duplicate ACK) or on a retransmission timeout.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t nacked);
+bool tcp_cc_dupack(FAR struct tcp_conn_s *conn);
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_cc_init(c)
+#  define tcp_cc_ack(c,n)
+#  define tcp_cc_dupack(c) false
+#  define tcp_cc_timeout(c)
+#endif
+
 /****************************************************************************
  * Name: tcp_ipv4_input
  *
@@ -878,6 +1077,25 @@ void tcp_rexmit(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 void tcp_ipv4_input(FAR struct net_driver_s *dev);
 #endif
 
+/****************************************************************************
+ * Name: tcp_parseoptions
+ *
+ * Description:
+ *   Parse the options of a SYN or SYNACK segment:  The maximum segment
+ *   size (limited to that of the device) is returned in 'mss' and the
+ *   window scale shift in 'wscale'.  Each is left unchanged if the segment
+ *   does not carry the option.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_parseoptions(FAR struct net_driver_s *dev,
+                      FAR struct tcp_hdr_s *tcp,
+                      unsigned int iplen, unsigned int hdrlen,
+                      FAR uint16_t *mss, FAR uint8_t *wscale);
+
 /****************************************************************************
  * Name: tcp_ipv6_input
  *
@@ -923,6 +1141,7 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
  *   receive the data.
  *
  * Input Parameters:
+ *   dev - The device driver structure containing the received packet
  *   conn - A pointer to the TCP connection structure
  *   buffer - A pointer to the buffer to be copied to the read-ahead
  *     buffers
@@ -940,7 +1159,8 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 #ifdef CONFIG_NET_TCP_READAHEAD
-uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
+uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
+                         FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t nbytes);
 #endif
 
@@ -1146,6 +1366,20 @@ struct socket;
 ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
                        size_t len);
 
+/****************************************************************************
+ * Function: psock_tcp_sndopt
+ *
+ * Description:
+ *   Set or clear a send option (TCP_SNDOPT_NODELAY or TCP_SNDOPT_CORK) of
+ *   a TCP socket.  If this may release data held back by Nagle's
+ *   algorithm, the device is notified that TX data is available.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+void psock_tcp_sndopt(FAR struct socket *psock, uint8_t sndopt, bool enable);
+#endif
+
 /****************************************************************************
  * Function: psock_tcp_cansend
  *
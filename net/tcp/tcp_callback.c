@@ -102,7 +102,7 @@ tcp_data_event(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        * partial packets will not be buffered.
        */
 
-      recvlen = tcp_datahandler(conn, buffer, buflen);
+      recvlen = tcp_datahandler(dev, conn, buffer, buflen);
       if (recvlen < buflen)
 #endif
         {
@@ -116,6 +116,8 @@ tcp_data_event(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
           g_netstats.tcp.syndrop++;
           g_netstats.tcp.drop++;
 #endif
+          TCP_CONNSTAT(conn, rx_dropped);
+
           /* Clear the TCP_SNDACK bit so that no ACK will be sent */
 
           ret &= ~TCP_SNDACK;
@@ -154,6 +156,12 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
 
   ninfo("flags: %04x\n", flags);
 
+#ifdef CONFIG_NET_IOBTX
+  /* Forget any I/O buffer payload from a previous packet */
+
+  dev->d_sndiob = NULL;
+#endif
+
   /* Perform the data callback.  When a data callback is executed from 'list',
    * the input flags are normally returned, however, the implementation
    * may set one of the following:
@@ -214,6 +222,7 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
  *   receive the data.
  *
  * Input Parameters:
+ *   dev - The device driver structure containing the received packet
  *   conn - A pointer to the TCP connection structure
  *   buffer - A pointer to the buffer to be copied to the read-ahead
  *     buffers
@@ -231,36 +240,48 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
  ****************************************************************************/
 
 #ifdef CONFIG_NET_TCP_READAHEAD
-uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
+uint16_t tcp_datahandler(FAR struct net_driver_s *dev,
+                         FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
                          uint16_t buflen)
 {
   FAR struct iob_s *iob;
   int ret;
 
-  /* Try to allocate on I/O buffer to start the chain without waiting (and
-   * throttling as necessary).  If we would have to wait, then drop the
-   * packet.
+#ifdef CONFIG_NET_IOBRX
+  /* If the driver received the packet into an I/O buffer, then try to
+   * take that buffer as is, without copying the data.
    */
 
-  iob = iob_tryalloc(true);
+  iob = devif_iob_claim(dev, buffer, buflen);
   if (iob == NULL)
+#endif
     {
-      nerr("ERROR: Failed to create new I/O buffer chain\n");
-      return 0;
-    }
+      /* Try to allocate on I/O buffer to start the chain without waiting
+       * (and throttling as necessary).  If we would have to wait, then drop
+       * the packet.
+       */
 
-  /* Copy the new appdata into the I/O buffer chain (without waiting) */
+      iob = iob_tryalloc_user(true, IOBUSER_TCP_RX);
+      if (iob == NULL)
+        {
+          nerr("ERROR: Failed to create new I/O buffer chain\n");
+          return 0;
+        }
 
-  ret = iob_trycopyin(iob, buffer, buflen, 0, true);
-  if (ret < 0)
-    {
-      /* On a failure, iob_copyin return a negated error value but does
-       * not free any I/O buffers.
-       */
+      /* Copy the new appdata into the I/O buffer chain (without waiting) */
 
-      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
-      (void)iob_free_chain(iob);
-      return 0;
+      ret = iob_trycopyin(iob, buffer, buflen, 0, true);
+      if (ret < 0)
+        {
+          /* On a failure, iob_copyin return a negated error value but does
+           * not free any I/O buffers.
+           */
+
+          nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n",
+               ret);
+          (void)iob_free_chain(iob);
+          return 0;
+        }
     }
 
   /* Add the new I/O buffer chain to the tail of the read-ahead queue (again
@@ -276,6 +297,7 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
     }
 
   ninfo("Buffered %d bytes\n", buflen);
+  TCP_CONNSTAT_ADD(conn, rx_bytes, buflen);
   return buflen;
 }
 #endif /* CONFIG_NET_TCP_READAHEAD */
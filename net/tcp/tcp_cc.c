@@ -0,0 +1,221 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCP_CC)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of duplicate ACKs that trigger a fast retransmit */
+
+#define TCP_CC_DUPTHRESH 3
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_halve
+ *
+ * Description:
+ *   Set the slow start threshold to half of the data in flight (but no
+ *   less than two segments).
+ *
+ ****************************************************************************/
+
+static void tcp_cc_halve(FAR struct tcp_conn_s *conn)
+{
+  uint32_t flight = conn->unacked;
+
+  if (flight > conn->winsize)
+    {
+      flight = conn->winsize;
+    }
+
+  conn->ssthresh = flight / 2;
+  if (conn->ssthresh < 2 * (uint32_t)conn->mss)
+    {
+      conn->ssthresh = 2 * (uint32_t)conn->mss;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   been established.  The initial window is set as in RFC 3390.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+  uint32_t mss = conn->mss;
+
+  conn->cwnd = 4 * mss;
+  if (conn->cwnd > 4380)
+    {
+      conn->cwnd = 2 * mss > 4380 ? 2 * mss : 4380;
+    }
+
+  conn->ssthresh = UINT32_MAX;
+  conn->dupacks  = 0;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Open the congestion window when new data is ACKed:  By up to one
+ *   segment per ACK in slow start, and by about one segment per round trip
+ *   in congestion avoidance.
+ *
+ * Parameters:
+ *   conn   - The TCP connection
+ *   nacked - The number of newly ACKed bytes
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t nacked)
+{
+  uint32_t mss = conn->mss;
+  uint32_t incr;
+
+  conn->dupacks = 0;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      incr = nacked < mss ? nacked : mss;
+    }
+  else
+    {
+      incr = (mss * mss) / conn->cwnd;
+      if (incr == 0)
+        {
+          incr = 1;
+        }
+    }
+
+  /* Don't let the window wrap */
+
+  if (conn->cwnd + incr > conn->cwnd)
+    {
+      conn->cwnd += incr;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_dupack
+ *
+ * Description:
+ *   Count a duplicate ACK.  On the third one, the segment following the
+ *   ACKed data is assumed to be lost:  The slow start threshold is set to
+ *   half of the data in flight and the congestion window to the new
+ *   threshold.
+ *
+ * Returned Value:
+ *   True if the un-ACKed data should be retransmitted now.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool tcp_cc_dupack(FAR struct tcp_conn_s *conn)
+{
+  if (++conn->dupacks != TCP_CC_DUPTHRESH)
+    {
+      /* Don't wrap the counter while waiting for new data to be ACKed */
+
+      if (conn->dupacks > TCP_CC_DUPTHRESH)
+        {
+          conn->dupacks = TCP_CC_DUPTHRESH + 1;
+        }
+
+      return false;
+    }
+
+  tcp_cc_halve(conn);
+  conn->cwnd = conn->ssthresh;
+
+  ninfo("Fast retransmit: cwnd=%u ssthresh=%u\n",
+        conn->cwnd, conn->ssthresh);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Collapse the congestion window to one segment after a retransmission
+ *   timeout.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  tcp_cc_halve(conn);
+  conn->cwnd    = conn->mss;
+  conn->dupacks = 0;
+
+  ninfo("Timeout: cwnd=%u ssthresh=%u\n", conn->cwnd, conn->ssthresh);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
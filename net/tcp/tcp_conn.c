@@ -69,6 +69,18 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_TCP_HASH
+#  ifndef CONFIG_NET_TCP_HASHSIZE
+#    define CONFIG_NET_TCP_HASHSIZE 16
+#  endif
+
+#  if (CONFIG_NET_TCP_HASHSIZE & (CONFIG_NET_TCP_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_TCP_HASHSIZE must be a power of two
+#  endif
+
+#  define TCP_HASHMASK (CONFIG_NET_TCP_HASHSIZE - 1)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -89,10 +101,200 @@ static dq_queue_t g_active_tcp_connections;
 
 static uint16_t g_last_tcp_port;
 
+#ifdef CONFIG_NET_TCP_HASH
+/* Active connections hashed by local port, remote port, and remote
+ * address.  Chained through the hnext field of the connection structure.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_active_hash[CONFIG_NET_TCP_HASHSIZE];
+
+/* Connections with an assigned local port, hashed by that port number.
+ * Chained through the pnext field of the connection structure.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_port_hash[CONFIG_NET_TCP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_HASH
+/****************************************************************************
+ * Name: tcp_porthash
+ *
+ * Description:
+ *   Return the port hash table index for the local port number (in network
+ *   byte order).
+ *
+ ****************************************************************************/
+
+static inline unsigned int tcp_porthash(uint16_t portno)
+{
+  return (portno ^ (portno >> 8)) & TCP_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: tcp_activehash
+ *
+ * Description:
+ *   Return the active hash table index for the local port, remote port
+ *   (both in network byte order), and the remote address folded to 32-bits.
+ *
+ ****************************************************************************/
+
+static inline unsigned int tcp_activehash(uint32_t raddr, uint16_t lport,
+                                          uint16_t rport)
+{
+  uint32_t key = raddr ^ ((uint32_t)lport << 16 | (uint32_t)rport);
+
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key & TCP_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: tcp_ipv6_fold
+ *
+ * Description:
+ *   Fold a 128-bit IPv6 address into a 32-bit value for hashing.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_fold(const net_ipv6addr_t ipaddr)
+{
+  return ((uint32_t)(ipaddr[0] ^ ipaddr[2] ^ ipaddr[4] ^ ipaddr[6]) << 16) |
+          (uint32_t)(ipaddr[1] ^ ipaddr[3] ^ ipaddr[5] ^ ipaddr[7]);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_raddr_fold
+ *
+ * Description:
+ *   Return the remote address of the connection folded to 32-bits.
+ *
+ ****************************************************************************/
+
+static inline uint32_t tcp_raddr_fold(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return (uint32_t)conn->u.ipv4.raddr;
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_fold(conn->u.ipv6.raddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_hash_remove
+ *
+ * Description:
+ *   Remove a connection from a hash chain.
+ *
+ ****************************************************************************/
+
+static void tcp_hash_remove(FAR struct tcp_conn_s **head,
+                            FAR struct tcp_conn_s *conn, bool active)
+{
+  FAR struct tcp_conn_s **link;
+
+  for (link = head; *link != NULL;
+       link = active ? &(*link)->hnext : &(*link)->pnext)
+    {
+      if (*link == conn)
+        {
+          *link = active ? conn->hnext : conn->pnext;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_active_add and tcp_active_remove
+ *
+ * Description:
+ *   Add or remove a connection to/from the list of active connections and
+ *   the active connection hash table.  The local and remote ports and the
+ *   remote address must not change while the connection is active.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_active_add(FAR struct tcp_conn_s *conn)
+{
+  unsigned int ndx = tcp_activehash(tcp_raddr_fold(conn), conn->lport,
+                                    conn->rport);
+
+  conn->hnext             = g_tcp_active_hash[ndx];
+  g_tcp_active_hash[ndx]  = conn;
+  dq_addlast(&conn->node, &g_active_tcp_connections);
+}
+
+static void tcp_active_remove(FAR struct tcp_conn_s *conn)
+{
+  unsigned int ndx = tcp_activehash(tcp_raddr_fold(conn), conn->lport,
+                                    conn->rport);
+
+  tcp_hash_remove(&g_tcp_active_hash[ndx], conn, true);
+  dq_rem(&conn->node, &g_active_tcp_connections);
+}
+
+/****************************************************************************
+ * Name: tcp_setlport
+ *
+ * Description:
+ *   Assign the local port (in network byte order) of a connection, keeping
+ *   the port hash table up to date.  A port number of zero removes the
+ *   connection from the port hash table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_setlport(FAR struct tcp_conn_s *conn, uint16_t portno)
+{
+  unsigned int ndx;
+
+  if (conn->lport != 0)
+    {
+      tcp_hash_remove(&g_tcp_port_hash[tcp_porthash(conn->lport)], conn,
+                      false);
+    }
+
+  conn->lport = portno;
+  if (portno != 0)
+    {
+      ndx                  = tcp_porthash(portno);
+      conn->pnext          = g_tcp_port_hash[ndx];
+      g_tcp_port_hash[ndx] = conn;
+    }
+}
+
+#else
+#  define tcp_active_add(conn) \
+     dq_addlast(&(conn)->node, &g_active_tcp_connections)
+#  define tcp_active_remove(conn) \
+     dq_rem(&(conn)->node, &g_active_tcp_connections)
+#  define tcp_setlport(conn,portno) \
+     do { (conn)->lport = (portno); } while (0)
+#endif /* CONFIG_NET_TCP_HASH */
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -110,13 +312,23 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_HASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+  for (conn = g_tcp_port_hash[tcp_porthash(portno)];
+       conn != NULL;
+       conn = conn->pnext)
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_HASH
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -161,13 +373,23 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_HASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+  for (conn = g_tcp_port_hash[tcp_porthash(portno)];
+       conn != NULL;
+       conn = conn->pnext)
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_HASH
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -236,13 +458,23 @@ static FAR struct tcp_conn_s *
 static FAR struct tcp_conn_s *tcp_listener(uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_HASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+  for (conn = g_tcp_port_hash[tcp_porthash(portno)];
+       conn != NULL;
+       conn = conn->pnext)
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_HASH
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -366,8 +598,14 @@ static inline FAR struct tcp_conn_s *
   in_addr_t destipaddr;
 #endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
+#ifdef CONFIG_NET_TCP_HASH
+  conn       = g_tcp_active_hash[tcp_activehash((uint32_t)srcipaddr,
+                                                tcp->destport,
+                                                tcp->srcport)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 #ifdef CONFIG_NETDEV_MULTINIC
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 #endif
@@ -411,7 +649,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -441,8 +683,14 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *destipaddr;
 #endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
+#ifdef CONFIG_NET_TCP_HASH
+  conn       = g_tcp_active_hash[tcp_activehash(tcp_ipv6_fold(*srcipaddr),
+                                                tcp->destport,
+                                                tcp->srcport)];
+#else
+  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
 #ifdef CONFIG_NETDEV_MULTINIC
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 #endif
@@ -486,7 +734,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -538,7 +790,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure. */
 
-  conn->lport = addr->sin_port;
+  tcp_setlport(conn, addr->sin_port);
 #ifdef CONFIG_NETDEV_MULTINIC
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 #endif
@@ -556,7 +808,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
 #ifdef CONFIG_NETDEV_MULTINIC
       net_ipv4addr_copy(conn->u.ipv4.laddr, INADDR_ANY);
 #endif
@@ -619,7 +871,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure. */
 
-  conn->lport = addr->sin6_port;
+  tcp_setlport(conn, addr->sin6_port);
 #ifdef CONFIG_NETDEV_MULTINIC
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 #endif
@@ -637,7 +889,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
 #ifdef CONFIG_NETDEV_MULTINIC
       net_ipv6addr_copy(conn->u.ipv6.laddr, g_ipv6_allzeroaddr);
 #endif
@@ -671,6 +923,11 @@ void tcp_initialize(void)
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+#ifdef CONFIG_NET_TCP_HASH
+  memset(g_tcp_active_hash, 0, sizeof(g_tcp_active_hash));
+  memset(g_tcp_port_hash, 0, sizeof(g_tcp_port_hash));
+#endif
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -844,9 +1101,17 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->node, &g_active_tcp_connections);
+      tcp_active_remove(conn);
     }
 
+  /* Release the local port number */
+
+  tcp_setlport(conn, 0);
+
+  /* Stop TX polling of the connection */
+
+  devif_txpend_remove(&conn->txpend);
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
@@ -1078,8 +1343,8 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->sa            = 0;
       conn->sv            = 4;
       conn->nrtx          = 0;
-      conn->lport         = tcp->destport;
       conn->rport         = tcp->srcport;
+      tcp_setlport(conn, tcp->destport);
       conn->tcpstateflags = TCP_SYN_RCVD;
 
       tcp_initsequence(conn->sndseq);
@@ -1112,7 +1377,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->node, &g_active_tcp_connections);
+      tcp_active_add(conn);
     }
 
   return conn;
@@ -1340,7 +1605,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
-  conn->lport      = htons((uint16_t)port);
+  tcp_setlport(conn, htons((uint16_t)port));
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
   conn->isn        = 0;
@@ -1363,7 +1628,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->node, &g_active_tcp_connections);
+  tcp_active_add(conn);
   ret = OK;
 
 errout_with_lock:
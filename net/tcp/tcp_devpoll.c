@@ -53,6 +53,7 @@
 #include <nuttx/net/tcp.h>
 
 #include "devif/devif.h"
+#include "netdev/netdev.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -121,4 +122,35 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_txpending
+ *
+ * Description:
+ *   Queue the connection for polling by the device that it sends through
+ *   (CONFIG_NET_TXPENDING).  Called before the device driver is notified
+ *   that TX data is available.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TXPENDING
+void tcp_txpending(FAR struct tcp_conn_s *conn)
+{
+  FAR struct net_driver_s *dev;
+
+#ifdef CONFIG_NETDEV_MULTINIC
+  dev = conn->dev;
+#else
+  dev = netdev_default();
+#endif
+
+  if (dev != NULL)
+    {
+      devif_txpend_add(dev, &conn->txpend, DEVIF_TXPEND_TCP);
+    }
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
@@ -57,6 +57,7 @@
 #include <nuttx/net/tcp.h>
 
 #include "devif/devif.h"
+#include "neighbor/neighbor.h"
 #include "utils/utils.h"
 #include "tcp/tcp.h"
 
@@ -64,6 +65,32 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_connoptions
+ *
+ * Description:
+ *   Parse the options of a SYN or SYNACK segment into the connection.
+ *
+ ****************************************************************************/
+
+static void tcp_connoptions(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn,
+                            FAR struct tcp_hdr_s *tcp,
+                            unsigned int iplen, unsigned int hdrlen)
+{
+  uint8_t wscale = TCP_WS_NONE;
+
+  tcp_parseoptions(dev, tcp, iplen, hdrlen, &conn->mss, &wscale);
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (wscale != TCP_WS_NONE)
+    {
+      conn->wscale     = true;
+      conn->snd_wscale = wscale;
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -92,9 +119,11 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
+#ifdef CONFIG_NET_TCP_CC
+  uint32_t winsize;
+  bool     rexmit = false;
+#endif
   int      len;
-  int      i;
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -118,7 +147,7 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!IFF_IS_RXCSUM(dev->d_flags) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -167,6 +196,14 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
       tmp16 = tcp->destport;
       if (tcp_islistener(tmp16))
         {
+#ifdef CONFIG_NET_TCP_SYNQUEUE
+          /* Queue the half-open connection and send a SYNACK.  The
+           * connection structure is not allocated until the final ACK.
+           */
+
+          tcp_synq_input(dev, tcp, iplen, hdrlen);
+          return;
+#else
           /* We matched the incoming packet with a connection in LISTEN.
            * We now need to create a new connection and send a SYNACK in
            * response.
@@ -212,66 +249,34 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
           net_incr32(conn->rcvseq, 1);
 
-          /* Parse the TCP MSS option, if present. */
+          /* Parse the TCP options, if present. */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we easily
-                       * can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are malformed
-                           * and we don't process them further.
-                           */
-
-                          break;
-                        }
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_connoptions(dev, conn, tcp, iplen, hdrlen);
 
           /* Our response will be a SYNACK. */
 
           tcp_ack(dev, conn, TCP_ACK | TCP_SYN);
           return;
+#endif /* CONFIG_NET_TCP_SYNQUEUE */
         }
     }
 
+#ifdef CONFIG_NET_TCP_SYNQUEUE
+  /* An ACK for a listening port may complete the handshake of a half-open
+   * connection.  If so, process it on the new connection.
+   */
+
+  else if ((tcp->flags & (TCP_SYN | TCP_RST | TCP_ACK)) == TCP_ACK &&
+           tcp_islistener(tcp->destport))
+    {
+      conn = tcp_synq_accept(dev, tcp);
+      if (conn != NULL)
+        {
+          goto found;
+        }
+    }
+#endif
+
   /* This is (1) an old duplicate packet or (2) a SYN packet but with
    * no matching listener found.  Send RST packet in either case.
    */
@@ -292,11 +297,24 @@ reset:
   return;
 
 found:
+  TCP_CONNSTAT(conn, rx_segments);
 
   /* Update the connection's window size */
 
+#ifdef CONFIG_NET_TCP_CC
+  winsize       = conn->winsize;
+#endif
   conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* The window field of a SYN segment is never scaled (RFC 7323) */
+
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      conn->winsize <<= conn->snd_wscale;
+    }
+#endif
+
   flags = 0;
 
   /* We do a very naive form of TCP reset processing; we just accept
@@ -357,6 +375,9 @@ found:
     {
       uint32_t unackseq;
       uint32_t ackseq;
+#ifdef CONFIG_NET_TCP_CC
+      uint32_t unacked = conn->unacked;
+#endif
 
       /* The next sequence number is equal to the current sequence
        * number (sndseq) plus the size of the outstanding, unacknowledged
@@ -411,8 +432,41 @@ found:
 
       ninfo("sndseq: %08x->%08x unackseq: %08x new unacked: %d\n",
             conn->sndseq, ackseq, unackseq, conn->unacked);
+
+#if defined(CONFIG_NET_IPv6) && defined(CONFIG_NET_IPv6_NUD)
+      /* An ACK of new data confirms that the peer is reachable.  This is
+       * the forward progress hint of Neighbor Unreachability Detection that
+       * keeps the neighbor from being probed.
+       */
+
+      if (IFF_IS_IPv6(dev->d_flags) &&
+          ackseq != tcp_getsequence(conn->sndseq))
+        {
+          neighbor_reachable(dev, conn->u.ipv6.raddr);
+        }
+#endif
+
       tcp_setsequence(conn->sndseq, ackseq);
 
+#ifdef CONFIG_NET_TCP_CC
+      /* Open the congestion window if new data was ACKed.  Otherwise, an
+       * ACK without data that does not change the window is a duplicate
+       * ACK and may indicate that a segment was lost.
+       */
+
+      if (conn->unacked < unacked)
+        {
+          tcp_cc_ack(conn, unacked - conn->unacked);
+        }
+      else if (conn->unacked == unacked && dev->d_len == 0 &&
+               (tcp->flags & (TCP_SYN | TCP_FIN)) == 0 &&
+               conn->winsize == winsize &&
+               (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
+        {
+          rexmit = tcp_cc_dupack(conn);
+        }
+#endif
+
       /* Do RTT estimation, unless we have done retransmissions. */
 
       if (conn->nrtx == 0)
@@ -472,6 +526,7 @@ found:
 #endif
             conn->unacked       = 0;
             flags               = TCP_CONNECTED;
+            tcp_cc_init(conn);
             ninfo("TCP state: TCP_ESTABLISHED\n");
 
             if (dev->d_len > 0)
@@ -505,59 +560,9 @@ found:
 
         if ((flags & TCP_ACKDATA) != 0 && (tcp->flags & TCP_CTL) == (TCP_SYN | TCP_ACK))
           {
-            /* Parse the TCP MSS option, if present. */
+            /* Parse the TCP options, if present. */
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
-              {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
-              }
+            tcp_connoptions(dev, conn, tcp, iplen, hdrlen);
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -569,6 +574,7 @@ found:
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
 #endif
+            tcp_cc_init(conn);
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
 
@@ -610,6 +616,24 @@ found:
          * sequence numbers will be screwed up.
          */
 
+#ifdef CONFIG_NET_TCP_CC
+        if (rexmit)
+          {
+            /* Fast retransmit:  Resend the un-ACKed data now rather than
+             * waiting for the retransmission timer.
+             */
+
+#ifdef CONFIG_NET_STATISTICS
+            g_netstats.tcp.rexmit++;
+#endif
+            TCP_CONNSTAT(conn, retransmits);
+            dev->d_sndlen = 0;
+            result = tcp_callback(dev, conn, TCP_REXMIT);
+            tcp_rexmit(dev, conn, result);
+            return;
+          }
+#endif
+
         if ((tcp->flags & TCP_FIN) != 0 && (conn->tcpstateflags & TCP_STOPPED) == 0)
           {
             /* Needs to be investigated further.
@@ -708,6 +732,15 @@ found:
 
         if ((flags & (TCP_NEWDATA | TCP_ACKDATA)) != 0)
           {
+            /* Acknowledged data may have opened the send window.  Make sure
+             * that the connection is polled for any data still queued.
+             */
+
+            if ((flags & TCP_ACKDATA) != 0)
+              {
+                devif_txpend_add(dev, &conn->txpend, DEVIF_TXPEND_TCP);
+              }
+
             /* Clear sndlen and remember the size in d_len.  The application
              * may modify d_len and we will need this value later when we
              * update the sequence number.
@@ -731,6 +764,20 @@ found:
                 /* Update the sequence number using the saved length */
 
                 net_incr32(conn->rcvseq, len);
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+                /* ACK only every second segment of new data right away,
+                 * unless the response carries data (and so the ACK)
+                 * anyway.  Otherwise, the ACK is sent with the next
+                 * segment that goes out or by tcp_timer().
+                 */
+
+                if ((flags & TCP_NEWDATA) != 0 && dev->d_sndlen == 0 &&
+                    ++conn->rx_unackseg < 2)
+                  {
+                    result &= ~TCP_SNDACK;
+                  }
+#endif
               }
 
             /* Send the response, ACKing the data or not, as appropriate */
@@ -852,6 +899,97 @@ drop:
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_parseoptions
+ *
+ * Description:
+ *   Parse the options of a SYN or SYNACK segment:  The maximum segment
+ *   size and, if enabled, the window scale option.
+ *
+ * Parameters:
+ *   dev    - The device driver structure containing the received packet.
+ *   tcp    - A pointer to the TCP header in the packet
+ *   iplen  - Length of the IP header
+ *   hdrlen - Combined length of the link layer, IP and TCP headers
+ *   mss    - Updated with the peer's MSS (limited to that of the device)
+ *            if the segment carries an MSS option.
+ *   wscale - Set to the peer's window scale shift if the segment carries
+ *            a window scale option (and CONFIG_NET_TCP_WINDOW_SCALE is
+ *            enabled).  Otherwise, it is not modified.
+ *
+ * Return:
+ *   None
+ *
+ ****************************************************************************/
+
+void tcp_parseoptions(FAR struct net_driver_s *dev,
+                      FAR struct tcp_hdr_s *tcp,
+                      unsigned int iplen, unsigned int hdrlen,
+                      FAR uint16_t *mss, FAR uint8_t *wscale)
+{
+  FAR const uint8_t *optdata = &dev->d_buf[hdrlen];
+  int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  uint16_t tmp16;
+  uint8_t opt;
+  int i;
+
+  for (i = 0; i < optlen; )
+    {
+      opt = optdata[i];
+      if (opt == TCP_OPT_END)
+        {
+          /* End of options. */
+
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          /* NOP option. */
+
+          ++i;
+        }
+      else if (opt == TCP_OPT_MSS && optdata[i + 1] == TCP_OPT_MSS_LEN)
+        {
+          uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+          /* An MSS option with the right option length. */
+
+          tmp16 = ((uint16_t)optdata[i + 2] << 8) | (uint16_t)optdata[i + 3];
+          *mss  = tmp16 > tcp_mss ? tcp_mss : tmp16;
+          i += TCP_OPT_MSS_LEN;
+        }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      else if (opt == TCP_OPT_WS && optdata[i + 1] == TCP_OPT_WS_LEN)
+        {
+          /* The peer supports window scaling.  Larger shifts than allowed
+           * by RFC 7323 are treated as the maximum.
+           */
+
+          *wscale = optdata[i + 2] > TCP_WS_MAXSHIFT ?
+                    TCP_WS_MAXSHIFT : optdata[i + 2];
+          i += TCP_OPT_WS_LEN;
+        }
+#endif
+      else
+        {
+          /* All other options have a length field, so that we easily
+           * can skip past them.
+           */
+
+          if (optdata[i + 1] == 0)
+            {
+              /* If the length field is zero, the options are malformed
+               * and we don't process them further.
+               */
+
+              break;
+            }
+
+          i += optdata[i + 1];
+        }
+    }
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_input
  *
@@ -107,6 +107,43 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_hdrlen
+ *
+ * Description:
+ *   Get the combined length of the IP and TCP headers (without options)
+ *
+ * Parameters:
+ *   dev - The device driver structure to use in the send operation
+ *
+ * Return:
+ *   IPv4TCP_HDRLEN or IPv6TCP_HDRLEN
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IOBTX
+static inline uint16_t tcp_hdrlen(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      return IPv6TCP_HDRLEN;
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return IPv4TCP_HDRLEN;
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+#endif /* CONFIG_NET_IOBTX */
+
 /****************************************************************************
  * Name: tcp_sendcomplete, tcp_ipv4_sendcomplete, and tcp_ipv6_sendcomplete
  *
@@ -150,7 +187,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]      = 0;
 
   tcp->tcpchksum    = 0;
-  tcp->tcpchksum    = ~tcp_ipv4_chksum(dev);
+  if (!IFF_IS_TXCSUM(dev->d_flags))
+    {
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+    }
 
   /* Finish initializing the IP header and calculate the IP checksum */
 
@@ -165,7 +205,10 @@ static inline void tcp_ipv4_sendcomplete(FAR struct net_driver_s *dev,
   /* Calculate IP checksum. */
 
   ipv4->ipchksum    = 0;
-  ipv4->ipchksum    = ~ipv4_chksum(dev);
+  if (!IFF_IS_TXCSUM(dev->d_flags))
+    {
+      ipv4->ipchksum = ~ipv4_chksum(dev);
+    }
 
   ninfo("IPv4 length: %d\n", ((int)ipv4->len[0] << 8) + ipv4->len[1]);
 
@@ -222,7 +265,10 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
   tcp->urgp[1]     = 0;
 
   tcp->tcpchksum   = 0;
-  tcp->tcpchksum   = ~tcp_ipv6_chksum(dev);
+  if (!IFF_IS_TXCSUM(dev->d_flags))
+    {
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+    }
 
   /* Finish initializing the IP header (no IPv6 checksum) */
 
@@ -308,6 +354,19 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
                            FAR struct tcp_conn_s *conn,
                            FAR struct tcp_hdr_s *tcp)
 {
+#ifdef CONFIG_NET_IOBTX
+  /* The payload may be left in an I/O buffer chain only if that chain
+   * provides all of the data for this packet.  Otherwise, this packet does
+   * not carry the data passed to devif_iob_send().
+   */
+
+  if (dev->d_sndiob != NULL &&
+      dev->d_len != tcp_hdrlen(dev) + dev->d_sndioblen)
+    {
+      dev->d_sndiob = NULL;
+    }
+
+#endif
   /* Copy the IP address into the IPv6 header */
 
 #ifdef CONFIG_NET_IPv6
@@ -337,6 +396,12 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   memcpy(tcp->ackno, conn->rcvseq, 4);
   memcpy(tcp->seqno, conn->sndseq, 4);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* This segment acknowledges everything received so far */
+
+  conn->rx_unackseg = 0;
+#endif
+
   tcp->srcport  = conn->lport;
   tcp->destport = conn->rport;
 
@@ -360,6 +425,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   /* Finish the IP portion of the message and calculate checksums */
 
   tcp_sendcomplete(dev, tcp);
+  TCP_CONNSTAT(conn, tx_segments);
 }
 
 /****************************************************************************
@@ -425,6 +491,12 @@ void tcp_reset(FAR struct net_driver_s *dev)
   g_netstats.tcp.rst++;
 #endif
 
+#ifdef CONFIG_NET_IOBTX
+  /* A reset carries no data */
+
+  dev->d_sndiob  = NULL;
+#endif
+
   /* TCP setup */
 
   tcp->flags     = TCP_RST | TCP_ACK;
@@ -537,6 +609,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 {
   struct tcp_hdr_s *tcp;
   uint16_t tcp_mss;
+  uint16_t optlen = TCP_OPT_MSS_LEN;
 
   /* Get values that vary with the underlying IP domain */
 
@@ -582,11 +655,140 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->optdata[1] = TCP_OPT_MSS_LEN;
   tcp->optdata[2] = tcp_mss >> 8;
   tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Offer window scaling in a SYN, but only accept it in a SYNACK if the
+   * peer offered it.  We never scale our own window.
+   */
+
+  if ((ack & TCP_ACK) == 0 || conn->wscale)
+    {
+      FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      optdata[0]  = TCP_OPT_NOOP;
+      optdata[1]  = TCP_OPT_WS;
+      optdata[2]  = TCP_OPT_WS_LEN;
+      optdata[3]  = 0;
+
+      optlen     += 1 + TCP_OPT_WS_LEN;
+      dev->d_len += 1 + TCP_OPT_WS_LEN;
+    }
+#endif
+
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
   tcp_sendcommon(dev, conn, tcp);
 }
 
+/****************************************************************************
+ * Name: tcp_synack
+ *
+ * Description:
+ *   Send a SYNACK in reply to the SYN in the device buffer without a
+ *   connection structure.  Like tcp_reset(), the reply is built in place
+ *   of the received SYN.
+ *
+ * Parameters:
+ *   dev    - The device driver structure holding the received SYN
+ *   iss    - Our initial sequence number
+ *   wscale - True:  Offer (a zero) window scale option
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNQUEUE
+void tcp_synack(FAR struct net_driver_s *dev, uint32_t iss, bool wscale)
+{
+  FAR struct tcp_hdr_s *tcp = tcp_header(dev);
+  uint16_t optlen = TCP_OPT_MSS_LEN;
+  uint16_t tcp_mss;
+  uint16_t tmp16;
+
+#ifdef CONFIG_NET_IOBTX
+  /* A SYNACK carries no data */
+
+  dev->d_sndiob = NULL;
+#endif
+
+  /* Acknowledge the SYN and send our own sequence number */
+
+  tcp_setsequence(tcp->ackno, tcp_getsequence(tcp->seqno) + 1);
+  tcp_setsequence(tcp->seqno, iss);
+
+  /* Swap port numbers. */
+
+  tmp16         = tcp->srcport;
+  tcp->srcport  = tcp->destport;
+  tcp->destport = tmp16;
+
+  /* Set the packet length and swap IP addresses. */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      tcp_mss    = TCP_IPv6_MSS(dev);
+      dev->d_len = IPv6TCP_HDRLEN + TCP_OPT_MSS_LEN;
+
+      net_ipv6addr_hdrcopy(ipv6->destipaddr, ipv6->srcipaddr);
+      net_ipv6addr_hdrcopy(ipv6->srcipaddr, dev->d_ipv6addr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      tcp_mss    = TCP_IPv4_MSS(dev);
+      dev->d_len = IPv4TCP_HDRLEN + TCP_OPT_MSS_LEN;
+
+      net_ipv4addr_hdrcopy(ipv4->destipaddr, ipv4->srcipaddr);
+      net_ipv4addr_hdrcopy(ipv4->srcipaddr, &dev->d_ipaddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  /* The SYN's options have already been parsed and may be overwritten */
+
+  tcp->flags      = TCP_SYN | TCP_ACK;
+  tcp->optdata[0] = TCP_OPT_MSS;
+  tcp->optdata[1] = TCP_OPT_MSS_LEN;
+  tcp->optdata[2] = tcp_mss >> 8;
+  tcp->optdata[3] = tcp_mss & 0xff;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (wscale)
+    {
+      FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      optdata[0]  = TCP_OPT_NOOP;
+      optdata[1]  = TCP_OPT_WS;
+      optdata[2]  = TCP_OPT_WS_LEN;
+      optdata[3]  = 0;
+
+      optlen     += 1 + TCP_OPT_WS_LEN;
+      dev->d_len += 1 + TCP_OPT_WS_LEN;
+    }
+#endif
+
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
+  tcp->wnd[0]     = ((NET_DEV_RCVWNDO(dev)) >> 8);
+  tcp->wnd[1]     = ((NET_DEV_RCVWNDO(dev)) & 0xff);
+
+  tcp_sendcomplete(dev, tcp);
+}
+#endif /* CONFIG_NET_TCP_SYNQUEUE */
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
@@ -311,6 +311,142 @@ static inline bool psock_send_addrchck(FAR struct tcp_conn_s *conn)
 #  define psock_send_addrchck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Name: psock_send_maxseg
+ *
+ * Description:
+ *   Return the largest amount of data that may be sent in one packet:  The
+ *   MSS or, if the driver supports TCP segmentation offload, the largest
+ *   payload that the driver will segment.
+ *
+ * Parameters:
+ *   dev   - The network device that is being polled
+ *   conn  - The TCP connection structure
+ *
+ * Returned Value:
+ *   The maximum segment length in bytes
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+static inline uint32_t psock_send_maxseg(FAR struct net_driver_s *dev,
+                                         FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_TSO
+  if (dev->d_tsomax > conn->mss && IFF_IS_TXIOB(dev->d_flags))
+    {
+      return dev->d_tsomax;
+    }
+#endif
+
+  return conn->mss;
+}
+
+/****************************************************************************
+ * Name: psock_send_window
+ *
+ * Description:
+ *   Return the number of bytes that may be sent now:  The receiver's
+ *   advertised window or, if congestion control is enabled, the part of the
+ *   smaller of the advertised and the congestion window that is not already
+ *   occupied by un-ACKed data.
+ *
+ * Parameters:
+ *   conn  - The TCP connection structure
+ *
+ * Returned Value:
+ *   The usable send window in bytes
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+static inline uint32_t psock_send_window(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CC
+  uint32_t window = conn->winsize < conn->cwnd ? conn->winsize : conn->cwnd;
+
+  return window > conn->unacked ? window - conn->unacked : 0;
+#else
+  return conn->winsize;
+#endif
+}
+
+/****************************************************************************
+ * Function: psock_send_hold
+ *
+ * Description:
+ *   Nagle's algorithm (RFC 1122 4.2.3.4):  Decide if a segment of 'sndlen'
+ *   bytes from the head of the write queue should be held back so that
+ *   more data can be added to it.  Only a segment smaller than the MSS that
+ *   ends the queued data is held, and only while earlier data is
+ *   unacknowledged (unless TCP_NODELAY) or while TCP_CORK is set.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+static inline bool psock_send_hold(FAR struct tcp_conn_s *conn,
+                                   FAR struct tcp_wrbuffer_s *wrb,
+                                   size_t sndlen)
+{
+  if (sndlen >= conn->mss || sq_next(&wrb->wb_node) != NULL ||
+      WRB_SENT(wrb) + sndlen < WRB_PKTLEN(wrb))
+    {
+      return false;
+    }
+
+  if ((conn->sndopts & TCP_SNDOPT_CORK) != 0)
+    {
+      return true;
+    }
+
+  return conn->unacked > 0 && (conn->sndopts & TCP_SNDOPT_NODELAY) == 0;
+}
+#endif
+
+/****************************************************************************
+ * Function: psock_send_coalesce
+ *
+ * Description:
+ *   Append the data of a new write buffer to the last write buffer in the
+ *   write queue if nothing of that buffer has been sent yet and the data of
+ *   both fits in one segment.  The new write buffer is then released.
+ *
+ * Returned Value:
+ *   True if the data was appended; false if 'wrb' must be queued.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+static bool psock_send_coalesce(FAR struct tcp_conn_s *conn,
+                                FAR struct tcp_wrbuffer_s *wrb)
+{
+  FAR struct tcp_wrbuffer_s *tail;
+
+  tail = (FAR struct tcp_wrbuffer_s *)conn->write_q.tail;
+  if (tail == NULL || WRB_SEQNO(tail) != (unsigned)-1 ||
+      WRB_SENT(tail) > 0 ||
+      WRB_PKTLEN(tail) + WRB_PKTLEN(wrb) > conn->mss)
+    {
+      return false;
+    }
+
+  ninfo("Append WRB=%p pktlen=%u to WRB=%p pktlen=%u\n",
+        wrb, WRB_PKTLEN(wrb), tail, WRB_PKTLEN(tail));
+
+  iob_concat(WRB_IOB(tail), WRB_IOB(wrb));
+  wrb->wb_iob = NULL;
+  tcp_wrbuffer_release(wrb);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Function: psock_send_interrupt
  *
@@ -496,6 +632,18 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, WRB_SEQNO(wrb), WRB_PKTLEN(wrb), WRB_SENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      /* A segment held back by psock_send_hold() may go out now that all
+       * data in flight has been ACKed.  Have the device poll us soon rather
+       * than on its next timer poll.
+       */
+
+      if (conn->unacked == 0 && !sq_empty(&conn->write_q))
+        {
+          netdev_txnotify_dev(dev);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -694,7 +842,7 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
        * will be replaced with an ARP request or Neighbor Solicitation.
        */
 
-      if (psock_send_addrchck(conn))
+      if (psock_send_addrchck(conn) && psock_send_window(conn) > 0)
         {
           FAR struct tcp_wrbuffer_s *wrb;
           uint32_t predicted_seqno;
@@ -715,16 +863,28 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
            */
 
           sndlen = WRB_PKTLEN(wrb) - WRB_SENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > psock_send_maxseg(dev, conn))
             {
-              sndlen = conn->mss;
+              sndlen = psock_send_maxseg(dev, conn);
             }
 
-          if (sndlen > conn->winsize)
+          if (sndlen > psock_send_window(conn))
             {
-              sndlen = conn->winsize;
+              sndlen = psock_send_window(conn);
             }
 
+#ifdef CONFIG_NET_TCP_NAGLE
+          /* Wait for more data or for the ACK of the data in flight */
+
+          if ((flags & TCP_REXMIT) == 0 &&
+              psock_send_hold(conn, wrb, sndlen))
+            {
+              ninfo("SEND: wrb=%p hold sndlen=%u unacked=%u\n",
+                    wrb, sndlen, conn->unacked);
+              return flags;
+            }
+#endif
+
           ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
                 wrb, WRB_PKTLEN(wrb), WRB_SENT(wrb), sndlen);
 
@@ -763,6 +923,15 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
 
           devif_iob_send(dev, WRB_IOB(wrb), sndlen, WRB_SENT(wrb));
 
+#ifdef CONFIG_NET_TCP_TSO
+          /* Let the hardware split the segment if it exceeds the MSS */
+
+          if (sndlen > conn->mss)
+            {
+              dev->d_tsomss = conn->mss;
+            }
+#endif
+
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment
            * the amount of data sent. This will be needed in sequence
@@ -846,6 +1015,10 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Make sure that the device will poll this connection */
+
+  tcp_txpending(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -1015,11 +1188,12 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   if (len > 0)
     {
-      /* Allocate a write buffer.  Careful, the network will be momentarily
-       * unlocked here.
+      /* Allocate a write buffer and copy the user data into it before
+       * locking the network.  Neither needs the network lock and the copy
+       * may wait for free I/O buffers, so the rest of the network can
+       * continue to run in the meantime.
        */
 
-      save = net_lock();
       wrb = tcp_wrbuffer_alloc();
       if (!wrb)
         {
@@ -1027,11 +1201,40 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
           nerr("ERROR: Failed to allocate write buffer\n");
           errcode = ENOMEM;
-          goto errout_with_lock;
+          goto errout;
+        }
+
+      /* Initialize the write buffer */
+
+      WRB_SEQNO(wrb) = (unsigned)-1;
+      WRB_NRTX(wrb)  = 0;
+      result = WRB_COPYIN(wrb, (FAR uint8_t *)buf, len);
+      if (result < 0)
+        {
+          tcp_wrbuffer_release(wrb);
+          errcode = -result;
+          goto errout;
         }
 
+      /* Dump I/O buffer chain */
+
+      WRB_DUMP("I/O buffer chain", wrb, WRB_PKTLEN(wrb), 0);
+
       /* Allocate resources to receive a callback */
 
+      save = net_lock();
+
+      /* The connection may have been lost while the data was copied without
+       * the network lock.
+       */
+
+      if (!_SS_ISCONNECTED(psock->s_flags))
+        {
+          nerr("ERROR: Not connected\n");
+          errcode = ENOTCONN;
+          goto errout_with_wrb;
+        }
+
       if (!psock->s_sndcb)
         {
           psock->s_sndcb = tcp_callback_alloc(conn);
@@ -1055,24 +1258,19 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       psock->s_sndcb->priv  = (FAR void *)psock;
       psock->s_sndcb->event = psock_send_interrupt;
 
-      /* Initialize the write buffer */
-
-      WRB_SEQNO(wrb) = (unsigned)-1;
-      WRB_NRTX(wrb)  = 0;
-      result = WRB_COPYIN(wrb, (FAR uint8_t *)buf, len);
-
-      /* Dump I/O buffer chain */
-
-      WRB_DUMP("I/O buffer chain", wrb, WRB_PKTLEN(wrb), 0);
-
       /* psock_send_interrupt() will send data in FIFO order from the
        * conn->write_q
        */
 
-      sq_addlast(&wrb->wb_node, &conn->write_q);
-      ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
-            wrb, WRB_PKTLEN(wrb),
-            conn->write_q.head, conn->write_q.tail);
+#ifdef CONFIG_NET_TCP_NAGLE
+      if (!psock_send_coalesce(conn, wrb))
+#endif
+        {
+          sq_addlast(&wrb->wb_node, &conn->write_q);
+          ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
+                wrb, WRB_PKTLEN(wrb),
+                conn->write_q.head, conn->write_q.tail);
+        }
 
       /* Notify the device driver of the availability of TX data */
 
@@ -1084,16 +1282,6 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
 
-  /* Check for errors.  Errors are signalled by negative errno values
-   * for the send length
-   */
-
-  if (result < 0)
-    {
-      errcode = result;
-      goto errout;
-    }
-
   /* If net_lockedwait failed, then we were probably reawakened by a signal.
    * In this case, net_lockedwait will have set errno appropriately.
    */
@@ -1110,8 +1298,6 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
 errout_with_wrb:
   tcp_wrbuffer_release(wrb);
-
-errout_with_lock:
   net_unlock(save);
 
 errout:
@@ -1119,6 +1305,49 @@ errout:
   return ERROR;
 }
 
+/****************************************************************************
+ * Function: psock_tcp_sndopt
+ *
+ * Description:
+ *   Set or clear a send option (TCP_SNDOPT_NODELAY or TCP_SNDOPT_CORK) of
+ *   a TCP socket.  If this may release data held back by Nagle's
+ *   algorithm, the device is notified that TX data is available.
+ *
+ * Parameters:
+ *   psock  - An instance of the internal socket structure.
+ *   sndopt - The option bit
+ *   enable - True:  Set the option; false:  Clear it
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+void psock_tcp_sndopt(FAR struct socket *psock, uint8_t sndopt, bool enable)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)psock->s_conn;
+  net_lock_t save;
+
+  DEBUGASSERT(conn != NULL);
+
+  save = net_lock();
+  if (enable)
+    {
+      conn->sndopts |= sndopt;
+    }
+  else
+    {
+      conn->sndopts &= ~sndopt;
+    }
+
+  if ((conn->sndopts & TCP_SNDOPT_CORK) == 0 &&
+      !sq_empty(&conn->write_q) && _SS_ISCONNECTED(psock->s_flags))
+    {
+      send_txnotify(psock, conn);
+    }
+
+  net_unlock(save);
+}
+#endif
+
 /****************************************************************************
  * Function: psock_tcp_cansend
  *
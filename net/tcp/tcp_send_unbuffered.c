@@ -616,6 +616,10 @@ end_wait:
 static inline void send_txnotify(FAR struct socket *psock,
                                  FAR struct tcp_conn_s *conn)
 {
+  /* Make sure that the device will poll this connection */
+
+  tcp_txpending(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -0,0 +1,577 @@
+/****************************************************************************
+ * net/tcp/tcp_synqueue.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_SYNQUEUE)
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
+/* A half-open connection is forgotten after about as long as a connection
+ * in SYN_RCVD would have kept retransmitting its SYNACK (units: half
+ * seconds).  The peer's retransmitted SYNs cause the SYNACK to be sent
+ * again in the meantime.
+ */
+
+#define TCP_SYNQ_MAXAGE    (TCP_RTO << TCP_MAXSYNRTX)
+
+/* SYN cookie layout:  The initial sequence number that we send is
+ *
+ *   Bits 27-31: The cookie period in which the SYN arrived
+ *   Bits 24-26: Index of the peer's MSS in g_cookie_mss[]
+ *   Bits  0-23: A keyed hash of the addresses, ports, the peer's initial
+ *               sequence number and the period.
+ *
+ * A cookie is accepted during the period in which it was sent and the one
+ * following it.  A period is 128 half seconds.
+ */
+
+#define COOKIE_PERIOD_SHIFT 7
+#define COOKIE_PERIOD_MASK  0x1f
+#define COOKIE_TIME_SHIFT   27
+#define COOKIE_MSS_SHIFT    24
+#define COOKIE_MSS_MASK     0x07
+#define COOKIE_HASH_MASK    0x00ffffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One half-open connection:  A SYN has been received and answered with a
+ * SYNACK, but the final ACK of the handshake has not yet arrived.  This
+ * holds only what is needed to create the connection when it does.
+ */
+
+struct tcp_synentry_s
+{
+  union ip_binding_u u;   /* Remote (and local) address */
+  uint32_t iss;           /* Our initial sequence number */
+  uint16_t lport;         /* Local port, network order.  Zero: unused */
+  uint16_t rport;         /* Remote port, network order */
+  uint16_t mss;           /* MSS negotiated in the SYN */
+  uint16_t age;           /* Half seconds since the SYN arrived */
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t  domain;        /* PF_INET or PF_INET6 */
+#endif
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint8_t  wscale;        /* Peer's window scale or TCP_WS_NONE */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct tcp_synentry_s g_synqueue[CONFIG_NET_TCP_SYNQUEUE_SIZE];
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+/* The time in half seconds, advanced by tcp_synq_timer() */
+
+static uint32_t g_cookie_clock;
+
+/* The key of the cookie hash, chosen when the first cookie is sent */
+
+static uint32_t g_cookie_secret;
+
+/* The MSS values that can be encoded in a cookie */
+
+static const uint16_t g_cookie_mss[COOKIE_MSS_MASK + 1] =
+{
+  216, 536, 1024, 1220, 1380, 1440, 1452, 1460
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_synq_key
+ *
+ * Description:
+ *   Describe the half-open connection of the segment in the device buffer:
+ *   Set up the addresses, ports and domain of 'key' and return the MSS of
+ *   the device.  All other fields are cleared.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_synq_key(FAR struct net_driver_s *dev,
+                             FAR struct tcp_hdr_s *tcp,
+                             FAR struct tcp_synentry_s *key)
+{
+  uint16_t mss;
+
+  memset(key, 0, sizeof(struct tcp_synentry_s));
+  key->lport = tcp->destport;
+  key->rport = tcp->srcport;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+      net_ipv6addr_copy(key->u.ipv6.raddr, ip->srcipaddr);
+#ifdef CONFIG_NETDEV_MULTINIC
+      net_ipv6addr_copy(key->u.ipv6.laddr, ip->destipaddr);
+#endif
+#ifdef CONFIG_NET_IPv4
+      key->domain = PF_INET6;
+#endif
+      mss = TCP_IPv6_INITIAL_MSS(dev);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+      net_ipv4addr_copy(key->u.ipv4.raddr,
+                        net_ip4addr_conv32(ip->srcipaddr));
+#ifdef CONFIG_NETDEV_MULTINIC
+      net_ipv4addr_copy(key->u.ipv4.laddr,
+                        net_ip4addr_conv32(ip->destipaddr));
+#endif
+#ifdef CONFIG_NET_IPv6
+      key->domain = PF_INET;
+#endif
+      mss = TCP_IPv4_INITIAL_MSS(dev);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return mss;
+}
+
+/****************************************************************************
+ * Name: tcp_synq_find
+ *
+ * Description:
+ *   Find the half-open connection described by 'key'
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_synentry_s *
+tcp_synq_find(FAR const struct tcp_synentry_s *key)
+{
+  FAR struct tcp_synentry_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TCP_SYNQUEUE_SIZE; i++)
+    {
+      entry = &g_synqueue[i];
+      if (entry->lport == key->lport && entry->rport == key->rport &&
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+          entry->domain == key->domain &&
+#endif
+          memcmp(&entry->u, &key->u, sizeof(union ip_binding_u)) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_cookie_hash
+ *
+ * Description:
+ *   Compute the keyed hash of a SYN cookie
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+static uint32_t tcp_cookie_mix(uint32_t hash, uint32_t value)
+{
+  hash ^= value;
+  hash *= 0x9e3779b1;
+  return hash ^ (hash >> 15);
+}
+
+static uint32_t tcp_cookie_hash(FAR const struct tcp_synentry_s *key,
+                                uint32_t irs, uint32_t period)
+{
+  FAR const uint8_t *addr = (FAR const uint8_t *)&key->u;
+  uint32_t hash = g_cookie_secret;
+  uint32_t value;
+  int i;
+
+  for (i = 0; i + 4 <= sizeof(union ip_binding_u); i += 4)
+    {
+      memcpy(&value, &addr[i], 4);
+      hash = tcp_cookie_mix(hash, value);
+    }
+
+  hash = tcp_cookie_mix(hash, (uint32_t)key->lport << 16 | key->rport);
+  hash = tcp_cookie_mix(hash, irs);
+  hash = tcp_cookie_mix(hash, period);
+  return hash & COOKIE_HASH_MASK;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_cookie_make
+ *
+ * Description:
+ *   Return the SYN cookie to use as our initial sequence number
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+static uint32_t tcp_cookie_make(FAR const struct tcp_synentry_s *key,
+                                uint32_t irs, uint16_t mss)
+{
+  uint32_t period;
+  int mssndx;
+
+  /* There is no source of random numbers, so the secret is only as
+   * unpredictable as the time and the sequence number counter are when the
+   * first cookie is needed.
+   */
+
+  if (g_cookie_secret == 0)
+    {
+      uint8_t seqno[4];
+
+      tcp_initsequence(seqno);
+      g_cookie_secret = tcp_cookie_mix((uint32_t)clock_systimer(),
+                                       tcp_getsequence(seqno)) | 1;
+    }
+
+  /* Encode the largest MSS that does not exceed the peer's */
+
+  for (mssndx = COOKIE_MSS_MASK;
+       mssndx > 0 && g_cookie_mss[mssndx] > mss;
+       mssndx--);
+
+  period = (g_cookie_clock >> COOKIE_PERIOD_SHIFT) & COOKIE_PERIOD_MASK;
+  return period << COOKIE_TIME_SHIFT | (uint32_t)mssndx << COOKIE_MSS_SHIFT |
+         tcp_cookie_hash(key, irs, period);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_cookie_check
+ *
+ * Description:
+ *   Check whether 'iss' is a valid, recent cookie for the connection
+ *   described by 'key'.  If so, return the MSS that it encodes.  Otherwise
+ *   return zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+static uint16_t tcp_cookie_check(FAR const struct tcp_synentry_s *key,
+                                 uint32_t iss, uint32_t irs)
+{
+  uint32_t period = iss >> COOKIE_TIME_SHIFT;
+  uint32_t now;
+
+  if (g_cookie_secret == 0)
+    {
+      return 0;
+    }
+
+  now = (g_cookie_clock >> COOKIE_PERIOD_SHIFT) & COOKIE_PERIOD_MASK;
+  if (((now - period) & COOKIE_PERIOD_MASK) > 1 ||
+      (iss & COOKIE_HASH_MASK) != tcp_cookie_hash(key, irs, period))
+    {
+      return 0;
+    }
+
+  return g_cookie_mss[(iss >> COOKIE_MSS_SHIFT) & COOKIE_MSS_MASK];
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_synq_input
+ *
+ * Description:
+ *   Handle a SYN for a listening port:  Remember the half-open connection
+ *   (or, if the queue is full and SYN cookies are enabled, encode it in our
+ *   initial sequence number) and answer with a SYNACK.  No connection
+ *   structure is allocated until the handshake completes.
+ *
+ * Parameters:
+ *   dev    - The device driver structure containing the received SYN
+ *   tcp    - A pointer to the TCP header in the packet
+ *   iplen  - Length of the IP header
+ *   hdrlen - Combined length of the link layer, IP and TCP headers
+ *
+ * Return:
+ *   None.  dev->d_len is zero if the SYN was dropped.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_synq_input(FAR struct net_driver_s *dev, FAR struct tcp_hdr_s *tcp,
+                    unsigned int iplen, unsigned int hdrlen)
+{
+  FAR struct tcp_synentry_s *entry;
+  struct tcp_synentry_s key;
+  uint8_t wscale = TCP_WS_NONE;
+  uint8_t seqno[4];
+  int i;
+
+  key.mss = tcp_synq_key(dev, tcp, &key);
+  tcp_parseoptions(dev, tcp, iplen, hdrlen, &key.mss, &wscale);
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  key.wscale = wscale;
+#endif
+
+  /* A retransmitted SYN means that our SYNACK was lost:  Send it again */
+
+  entry = tcp_synq_find(&key);
+  if (entry == NULL)
+    {
+      for (i = 0; i < CONFIG_NET_TCP_SYNQUEUE_SIZE; i++)
+        {
+          if (g_synqueue[i].lport == 0)
+            {
+              entry = &g_synqueue[i];
+              break;
+            }
+        }
+
+      if (entry == NULL)
+        {
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+          /* The queue is full.  Answer with a cookie; window scaling
+           * cannot be negotiated because there is nowhere to remember it.
+           */
+
+          tcp_synack(dev, tcp_cookie_make(&key, tcp_getsequence(tcp->seqno),
+                                          key.mss), false);
+#else
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.tcp.syndrop++;
+          g_netstats.tcp.drop++;
+#endif
+          nwarn("WARNING: SYN queue full\n");
+          dev->d_len = 0;
+#endif
+          return;
+        }
+
+      tcp_initsequence(seqno);
+      key.iss = tcp_getsequence(seqno);
+      *entry  = key;
+    }
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  tcp_synack(dev, entry->iss, entry->wscale != TCP_WS_NONE);
+#else
+  tcp_synack(dev, entry->iss, false);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_synq_accept
+ *
+ * Description:
+ *   Handle an ACK for a listening port that does not belong to an active
+ *   connection.  If it completes the handshake of a half-open connection
+ *   (or carries a valid SYN cookie), create the connection in the SYN_RCVD
+ *   state and pass it to the listener.
+ *
+ * Parameters:
+ *   dev - The device driver structure containing the received ACK
+ *   tcp - A pointer to the TCP header in the packet
+ *
+ * Return:
+ *   The new connection.  The caller processes the ACK on it, which moves
+ *   it to the ESTABLISHED state.  NULL if the ACK does not complete a
+ *   handshake or if the connection could not be created or accepted; the
+ *   caller should then reset the connection.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_synq_accept(FAR struct net_driver_s *dev,
+                                       FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_synentry_s *entry;
+  FAR struct tcp_conn_s *conn;
+  struct tcp_synentry_s key;
+  uint32_t iss = tcp_getsequence(tcp->ackno) - 1;
+
+  (void)tcp_synq_key(dev, tcp, &key);
+
+  entry = tcp_synq_find(&key);
+  if (entry != NULL)
+    {
+      if (entry->iss != iss)
+        {
+          return NULL;
+        }
+
+      key = *entry;
+      entry->lport = 0;
+    }
+  else
+    {
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+      key.mss = tcp_cookie_check(&key, iss,
+                                 tcp_getsequence(tcp->seqno) - 1);
+      if (key.mss == 0)
+        {
+          return NULL;
+        }
+
+      key.iss = iss;
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      key.wscale = TCP_WS_NONE;
+#endif
+#else
+      return NULL;
+#endif
+    }
+
+  /* Now create the real connection.  tcp_alloc_accept() sets it up from
+   * the ACK, which already carries the peer's next sequence number.
+   */
+
+  conn = tcp_alloc_accept(dev, tcp);
+  if (conn == NULL)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.syndrop++;
+#endif
+      nerr("ERROR: No free TCP connections\n");
+      return NULL;
+    }
+
+  tcp_setsequence(conn->sndseq, key.iss);
+  if (key.mss < conn->mss)
+    {
+      conn->mss = key.mss;
+    }
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if (key.wscale != TCP_WS_NONE)
+    {
+      conn->wscale     = true;
+      conn->snd_wscale = key.wscale;
+    }
+#endif
+
+  conn->crefs = 1;
+  if (tcp_accept_connection(dev, conn, tcp->destport) != OK)
+    {
+      conn->crefs = 0;
+      tcp_free(conn);
+      return NULL;
+    }
+
+  return conn;
+}
+
+/****************************************************************************
+ * Name: tcp_synq_timer
+ *
+ * Description:
+ *   Forget half-open connections whose handshake did not complete and
+ *   advance the SYN cookie clock.
+ *
+ * Parameters:
+ *   hsec - The elapsed time in half seconds
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_synq_timer(int hsec)
+{
+  FAR struct tcp_synentry_s *entry;
+  int i;
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+  g_cookie_clock += hsec;
+#endif
+
+  for (i = 0; i < CONFIG_NET_TCP_SYNQUEUE_SIZE; i++)
+    {
+      entry = &g_synqueue[i];
+      if (entry->lport != 0)
+        {
+          entry->age += hsec;
+          if (entry->age >= TCP_SYNQ_MAXAGE)
+            {
+              ninfo("Half-open connection timed out\n");
+              entry->lport = 0;
+            }
+        }
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_SYNQUEUE */
@@ -262,6 +262,8 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 #ifdef CONFIG_NET_STATISTICS
               g_netstats.tcp.rexmit++;
 #endif
+              TCP_CONNSTAT(conn, retransmits);
+
               switch (conn->tcpstateflags & TCP_STATE_MASK)
                 {
                   case TCP_SYN_RCVD:
@@ -284,6 +286,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                      * the code for sending out the packet.
                      */
 
+                    tcp_cc_timeout(conn);
                     result = tcp_callback(dev, conn, TCP_REXMIT);
                     tcp_rexmit(dev, conn, result);
                     goto done;
@@ -320,10 +323,35 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 #endif
             {
               result = tcp_callback(dev, conn, TCP_POLL);
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+              if (conn->rx_unackseg > 0)
+                {
+                  /* Send the delayed ACK, with data if there is any */
+
+                  result |= TCP_SNDACK;
+                }
+#endif
               tcp_appsend(dev, conn, result);
               goto done;
             }
         }
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+      /* Send a delayed ACK that is still pending while we wait for our own
+       * data to be acknowledged.
+       */
+
+      if (conn->rx_unackseg > 0 &&
+          (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED
+#ifdef CONFIG_NETDEV_MULTINIC
+          && dev == conn->dev
+#endif
+         )
+        {
+          tcp_send(dev, conn, TCP_ACK, hdrlen);
+          goto done;
+        }
+#endif
     }
 
   /* Nothing to be done */
@@ -54,6 +54,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/iob.h>
 
@@ -129,13 +130,14 @@ void tcp_wrbuffer_initialize(void)
  *   None
  *
  * Assumptions:
- *   Called from user logic with the network locked.
+ *   Called from user logic.  The network may or may not be locked.
  *
  ****************************************************************************/
 
 FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
 {
   FAR struct tcp_wrbuffer_s *wrb;
+  irqstate_t flags;
 
   /* We need to allocate two things:  (1) A write buffer structure and (2)
    * at least one I/O buffer to start the chain.
@@ -148,16 +150,21 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
   DEBUGVERIFY(net_lockedwait(&g_wrbuffer.sem));
 
   /* Now, we are guaranteed to have a write buffer structure reserved
-   * for us in the free list.
+   * for us in the free list.  The free list is protected by a critical
+   * section because buffers may be released with the network locked by
+   * another thread.
    */
 
+  flags = enter_critical_section();
   wrb = (FAR struct tcp_wrbuffer_s *)sq_remfirst(&g_wrbuffer.freebuffers);
+  leave_critical_section(flags);
+
   DEBUGASSERT(wrb);
   memset(wrb, 0, sizeof(struct tcp_wrbuffer_s));
 
   /* Now get the first I/O buffer for the write buffer structure */
 
-  wrb->wb_iob = iob_alloc(false);
+  wrb->wb_iob = iob_alloc_user(false, IOBUSER_TCP_TX);
   if (!wrb->wb_iob)
     {
       nerr("ERROR: Failed to allocate I/O buffer\n");
@@ -183,17 +190,26 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
 
 void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
 {
-  DEBUGASSERT(wrb && wrb->wb_iob);
+  irqstate_t flags;
+
+  DEBUGASSERT(wrb);
 
   /* To avoid deadlocks, we must following this ordering:  Release the I/O
-   * buffer chain first, then the write buffer structure.
+   * buffer chain first, then the write buffer structure.  There is no
+   * chain if its data was moved to another write buffer.
    */
 
-  iob_free_chain(wrb->wb_iob);
+  if (wrb->wb_iob != NULL)
+    {
+      iob_free_chain(wrb->wb_iob);
+    }
 
   /* Then free the write buffer structure */
 
+  flags = enter_critical_section();
   sq_addlast(&wrb->wb_node, &g_wrbuffer.freebuffers);
+  leave_critical_section(flags);
+
   sem_post(&g_wrbuffer.sem);
 }
 
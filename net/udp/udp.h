@@ -43,14 +43,26 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <queue.h>
+#ifdef CONFIG_NET_TIMESTAMP
+#  include <time.h>
+#endif
 
 #include <nuttx/net/ip.h>
 
-#ifdef CONFIG_NET_UDP_READAHEAD
+#ifdef CONFIG_NET_TXPENDING
+#  include <nuttx/net/netdev.h>
+#endif
+
+#if defined(CONFIG_NET_UDP_READAHEAD) || defined(CONFIG_NET_UDP_WRITE_BUFFERS)
 #  include <nuttx/net/iob.h>
 #endif
 
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+#  include <netinet/in.h>
+#endif
+
 #ifdef CONFIG_NET_UDP
 
 /****************************************************************************
@@ -70,6 +82,14 @@
 #define udp_callback_free(dev, conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->list)
 
+#ifdef CONFIG_NET_UDP_SRCFILTER
+#  ifndef CONFIG_NET_UDP_NSRCFILTERS
+#    define CONFIG_NET_UDP_NSRCFILTERS 4
+#  endif
+#else
+#  define udp_freesources(conn)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -78,16 +98,80 @@
 
 struct devif_callback_s;  /* Forward reference */
 struct udp_hdr_s;         /* Forward reference */
+struct net_driver_s;      /* Forward reference */
+struct iob_s;             /* Forward reference */
+
+#ifdef CONFIG_NET_UDP_SRCFILTER
+/* One source accepted for a multicast group (IP_ADD_SOURCE_MEMBERSHIP).
+ * Once a socket has any source for a group, datagrams sent to the group
+ * are received only from the listed sources.
+ */
+
+struct udp_srcfilter_s
+{
+  FAR struct net_driver_s *dev; /* Device on which the group was joined */
+  in_addr_t grpaddr;            /* Group address (INADDR_ANY if unused) */
+  in_addr_t srcaddr;            /* Accepted source address */
+  bool joined;                  /* This entry holds the IGMP membership */
+};
+#endif
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+/* This defines a UDP write buffer.  It holds one datagram and the address
+ * that the datagram is to be sent to.
+ */
+
+struct udp_wrbuffer_s
+{
+  sq_entry_t wb_node;      /* Supports a singly linked list */
+  union
+  {
+#ifdef CONFIG_NET_IPv4
+    struct sockaddr_in  ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+    struct sockaddr_in6 ipv6;
+#endif
+  } wb_dest;               /* Destination address of the datagram */
+  uint16_t   wb_len;       /* Length of the datagram */
+  FAR struct iob_s *wb_iob; /* Head of the I/O buffer chain */
+};
+#endif
 
 struct udp_conn_s
 {
   dq_entry_t node;        /* Supports a doubly linked list */
+#ifdef CONFIG_NET_UDP_HASH
+  FAR struct udp_conn_s *hnext; /* Next conn in the local port hash chain */
+#endif
+#ifdef CONFIG_NET_TXPENDING
+  struct devif_txpend_s txpend; /* Queues the connection for TX polling */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  ttl;           /* Default time-to-live */
   uint8_t  crefs;         /* Reference counts on this instance */
+#ifdef CONFIG_NET_UDP_REUSEPORT
+  bool     reuseport;     /* The local port may be shared (SO_REUSEPORT) */
+#endif
+#ifdef CONFIG_NET_UDP_SRCFILTER
+  uint8_t  nsources;      /* Number of source filters in use */
+
+  /* Multicast source filters */
+
+  struct udp_srcfilter_s srcfilter[CONFIG_NET_UDP_NSRCFILTERS];
+#endif
+#ifdef CONFIG_NET_TIMESTAMP
+  uint8_t  tsflags;       /* SO_TIMESTAMPING flags of the socket */
+  bool     txtsvalid;     /* The transmit time stamp has not been read */
+
+  /* Time stamps of the last datagram sent (see recvmsg() MSG_ERRQUEUE) */
+
+  struct timespec txswtime; /* Software transmit time */
+  struct timespec txhwtime; /* Hardware transmit time (zero if none) */
+#endif
 
 #ifdef CONFIG_NET_UDP_READAHEAD
   /* Read-ahead buffering.
@@ -99,6 +183,18 @@ struct udp_conn_s
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 #endif
 
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  /* Write buffering
+   *
+   *   write_q - The queue of datagrams (struct udp_wrbuffer_s) waiting to
+   *             be sent, in the order in which they were written.
+   *   sndcb   - The poll callback that sends the queued datagrams.
+   */
+
+  sq_queue_t write_q;                  /* Write buffering for datagrams */
+  FAR struct devif_callback_s *sndcb;  /* Sends the queued datagrams */
+#endif
+
   /* Defines the list of UDP callbacks */
 
   FAR struct devif_callback_s *list;
@@ -136,6 +232,54 @@ struct pollfd;        /* Forward reference */
 
 void udp_initialize(void);
 
+/****************************************************************************
+ * Function: udp_wrbuffer_initialize
+ *
+ * Description:
+ *   Initialize the list of free write buffers
+ *
+ * Assumptions:
+ *   Called once early initialization.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+void udp_wrbuffer_initialize(void);
+#endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
+
+/****************************************************************************
+ * Function: udp_wrbuffer_alloc
+ *
+ * Description:
+ *   Allocate a UDP write buffer by taking a pre-allocated buffer from
+ *   the free list.  If 'nonblock' is true, NULL is returned rather than
+ *   waiting for a write buffer or for the first I/O buffer of its chain.
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(bool nonblock);
+#endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
+
+/****************************************************************************
+ * Function: udp_wrbuffer_release
+ *
+ * Description:
+ *   Release a UDP write buffer and its I/O buffer chain by returning the
+ *   buffer to the free list.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb);
+#endif /* CONFIG_NET_UDP_WRITE_BUFFERS */
+
 /****************************************************************************
  * Name: udp_alloc
  *
@@ -186,6 +330,28 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_nextmatch
+ *
+ * Description:
+ *   Return the next connection after 'conn' (or the first connection if
+ *   'conn' is NULL) that should receive the UDP packet in the device
+ *   buffer.  Unlike udp_active(), every matching connection is returned in
+ *   turn, including all of the connections sharing a port with
+ *   SO_REUSEPORT.  This is used to deliver multicast and broadcast
+ *   datagrams to all of the sockets that are listening for them.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_MULTICAST
+FAR struct udp_conn_s *udp_nextmatch(FAR struct net_driver_s *dev,
+                                     FAR struct udp_hdr_s *udp,
+                                     FAR struct udp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -425,6 +591,98 @@ FAR struct net_driver_s *udp_find_raddr_device(FAR struct udp_conn_s *conn);
 uint16_t udp_callback(FAR struct net_driver_s *dev,
                       FAR struct udp_conn_s *conn, uint16_t flags);
 
+/****************************************************************************
+ * Function: udp_mcast_callback
+ *
+ * Description:
+ *   Like udp_callback(), but for one of several connections receiving the
+ *   same datagram.  If the datagram must be buffered in the read-ahead
+ *   queue, the I/O buffer chain that was buffered for a previous recipient
+ *   (*iob, if not NULL) is cloned rather than building a new chain from
+ *   the device buffer.  On return, *iob refers to the chain buffered for
+ *   this connection, if any.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_MULTICAST
+uint16_t udp_mcast_callback(FAR struct net_driver_s *dev,
+                            FAR struct udp_conn_s *conn, uint16_t flags,
+                            FAR struct iob_s **iob);
+#endif
+
+/****************************************************************************
+ * Name: udp_addsource
+ *
+ * Description:
+ *   Implements IP_ADD_SOURCE_MEMBERSHIP:  Join the multicast group (if it
+ *   has not already been joined) and accept datagrams sent to the group
+ *   from the source address.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Called from normal user level code.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_SRCFILTER
+struct ip_mreq_source;  /* Forward reference */
+int udp_addsource(FAR struct udp_conn_s *conn,
+                  FAR const struct ip_mreq_source *mreq);
+
+/****************************************************************************
+ * Name: udp_dropsource
+ *
+ * Description:
+ *   Implements IP_DROP_SOURCE_MEMBERSHIP:  Stop accepting datagrams sent to
+ *   the multicast group from the source address.  The group is left when
+ *   no socket has a source filter for it any longer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Called from normal user level code.
+ *
+ ****************************************************************************/
+
+int udp_dropsource(FAR struct udp_conn_s *conn,
+                   FAR const struct ip_mreq_source *mreq);
+
+/****************************************************************************
+ * Name: udp_freesources
+ *
+ * Description:
+ *   Drop all of the source filters of a connection that is being freed.
+ *
+ * Assumptions:
+ *   Called from normal user level code.
+ *
+ ****************************************************************************/
+
+void udp_freesources(FAR struct udp_conn_s *conn);
+
+/****************************************************************************
+ * Name: udp_checksource
+ *
+ * Description:
+ *   Return true if the connection accepts a datagram sent to 'grpaddr'
+ *   from 'srcaddr'.  This is always true unless the connection has source
+ *   filters for the group and the source is not one of them.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool udp_checksource(FAR struct udp_conn_s *conn, in_addr_t grpaddr,
+                     in_addr_t srcaddr);
+#endif /* CONFIG_NET_UDP_SRCFILTER */
+
 /****************************************************************************
  * Function: psock_udp_send
  *
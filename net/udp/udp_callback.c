@@ -42,6 +42,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -78,7 +79,8 @@
 
 #ifdef CONFIG_NET_UDP_READAHEAD
 static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
-                                FAR uint8_t *buffer, uint16_t buflen)
+                                FAR uint8_t *buffer, uint16_t buflen,
+                                FAR struct iob_s **clone)
 {
   FAR struct iob_s *iob;
   int ret;
@@ -91,17 +93,6 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
   FAR void  *src_addr;
   uint8_t src_addr_size;
 
-  /* Allocate on I/O buffer to start the chain (throttling as necessary).
-   * We will not wait for an I/O buffer to become available in this context.
-   */
-
-  iob = iob_tryalloc(true);
-  if (iob == NULL)
-    {
-      nerr("ERROR: Failed to create new I/O buffer chain\n");
-      return 0;
-    }
-
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
@@ -165,43 +156,58 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
     }
 #endif /* CONFIG_NET_IPv4 */
 
-  /* Copy the src address info into the I/O buffer chain.  We will not wait
-   * for an I/O buffer to become available in this context.  It there is
-   * any failure to allocated, the entire I/O buffer chain will be discarded.
+  /* Allocate on I/O buffer to start the chain (throttling as necessary).
+   * We will not wait for an I/O buffer to become available in this context.
    */
 
-  ret = iob_trycopyin(iob, (FAR const uint8_t *)&src_addr_size,
-                      sizeof(uint8_t), 0, true);
-  if (ret < 0)
+  iob = iob_tryalloc_user(true, IOBUSER_UDP_RX);
+  if (iob == NULL)
     {
-      /* On a failure, iob_trycopyin return a negated error value but does
-       * not free any I/O buffers.
-       */
-
-      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
-      (void)iob_free_chain(iob);
+      nerr("ERROR: Failed to create new I/O buffer chain\n");
       return 0;
     }
 
-  ret = iob_trycopyin(iob, (FAR const uint8_t *)src_addr, src_addr_size,
-                      sizeof(uint8_t), true);
-  if (ret < 0)
+#ifdef CONFIG_NET_UDP_MULTICAST
+  /* If the same datagram was buffered for a previous recipient with the
+   * same source address encoding, then just clone that I/O buffer chain.
+   */
+
+  if (clone != NULL && *clone != NULL &&
+      (*clone)->io_data[(*clone)->io_offset] == src_addr_size)
     {
-      /* On a failure, iob_trycopyin return a negated error value but does
-       * not free any I/O buffers.
+      ret = iob_tryclone(*clone, iob, true);
+      if (ret < 0)
+        {
+          nerr("ERROR: Failed to clone the I/O buffer chain: %d\n", ret);
+          (void)iob_free_chain(iob);
+          return 0;
+        }
+    }
+  else
+#endif
+    {
+      /* Copy the src address info into the I/O buffer chain.  We will not
+       * wait for an I/O buffer to become available in this context.  It
+       * there is any failure to allocated, the entire I/O buffer chain will
+       * be discarded.
        */
 
-      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
-      (void)iob_free_chain(iob);
-      return 0;
-    }
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)&src_addr_size,
+                          sizeof(uint8_t), 0, true);
+      if (ret < 0)
+        {
+          /* On a failure, iob_trycopyin return a negated error value but
+           * does not free any I/O buffers.
+           */
 
-  if (buflen > 0)
-    {
-      /* Copy the new appdata into the I/O buffer chain */
+          nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n",
+               ret);
+          (void)iob_free_chain(iob);
+          return 0;
+        }
 
-      ret = iob_trycopyin(iob, buffer, buflen,
-                          src_addr_size + sizeof(uint8_t), true);
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)src_addr, src_addr_size,
+                          sizeof(uint8_t), true);
       if (ret < 0)
         {
           /* On a failure, iob_trycopyin return a negated error value but
@@ -213,6 +219,34 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
           (void)iob_free_chain(iob);
           return 0;
         }
+
+      if (buflen > 0)
+        {
+          /* Copy the new appdata into the I/O buffer chain */
+
+          ret = iob_trycopyin(iob, buffer, buflen,
+                              src_addr_size + sizeof(uint8_t), true);
+          if (ret < 0)
+            {
+              /* On a failure, iob_trycopyin return a negated error value but
+               * does not free any I/O buffers.
+               */
+
+              nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n",
+                   ret);
+              (void)iob_free_chain(iob);
+              return 0;
+            }
+        }
+
+#ifdef CONFIG_NET_TIMESTAMP
+      /* Remember when the datagram was received.  A clone keeps the time
+       * stamps of the original.
+       */
+
+      iob->io_hwtime = dev->d_rxtime;
+      (void)clock_gettime(CLOCK_REALTIME, &iob->io_swtime);
+#endif
     }
 
   /* Add the new I/O buffer chain to the tail of the read-ahead queue */
@@ -225,6 +259,15 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
       return 0;
     }
 
+#ifdef CONFIG_NET_UDP_MULTICAST
+  /* Let the next recipient clone this chain */
+
+  if (clone != NULL)
+    {
+      *clone = iob;
+    }
+#endif
+
   ninfo("Buffered %d bytes\n", buflen);
   return buflen;
 }
@@ -240,7 +283,7 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
 
 static inline uint16_t
 net_dataevent(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
-              uint16_t flags)
+              uint16_t flags, FAR struct iob_s **clone)
 {
   uint16_t ret;
 #ifdef CONFIG_NET_UDP_READAHEAD
@@ -262,7 +305,7 @@ net_dataevent(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
    * partial packets will not be buffered.
    */
 
-  recvlen = udp_datahandler(dev, conn, buffer, buflen);
+  recvlen = udp_datahandler(dev, conn, buffer, buflen, clone);
   if (recvlen < buflen)
 #endif
     {
@@ -318,11 +361,44 @@ uint16_t udp_callback(FAR struct net_driver_s *dev,
         {
           /* Data was not handled.. dispose of it appropriately */
 
-          flags = net_dataevent(dev, conn, flags);
+          flags = net_dataevent(dev, conn, flags, NULL);
         }
     }
 
   return flags;
 }
 
+/****************************************************************************
+ * Function: udp_mcast_callback
+ *
+ * Description:
+ *   Like udp_callback(), but for one of several connections receiving the
+ *   same datagram.  If the datagram must be buffered in the read-ahead
+ *   queue, the I/O buffer chain that was buffered for a previous recipient
+ *   (*iob, if not NULL) is cloned rather than building a new chain from
+ *   the device buffer.  On return, *iob refers to the chain buffered for
+ *   this connection, if any.
+ *
+ * Assumptions:
+ *   This function is called at the interrupt level with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_MULTICAST
+uint16_t udp_mcast_callback(FAR struct net_driver_s *dev,
+                            FAR struct udp_conn_s *conn, uint16_t flags,
+                            FAR struct iob_s **iob)
+{
+  ninfo("flags: %04x\n", flags);
+
+  flags = devif_conn_event(dev, conn, flags, conn->list);
+  if ((flags & UDP_NEWDATA) != 0)
+    {
+      flags = net_dataevent(dev, conn, flags, iob);
+    }
+
+  return flags;
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
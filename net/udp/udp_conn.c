@@ -72,6 +72,27 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_UDP_HASH
+#  ifndef CONFIG_NET_UDP_HASHSIZE
+#    define CONFIG_NET_UDP_HASHSIZE 16
+#  endif
+
+#  if (CONFIG_NET_UDP_HASHSIZE & (CONFIG_NET_UDP_HASHSIZE - 1)) != 0
+#    error CONFIG_NET_UDP_HASHSIZE must be a power of two
+#  endif
+
+#  define UDP_HASHMASK (CONFIG_NET_UDP_HASHSIZE - 1)
+
+/* Traverse the connections that may be bound to a local port */
+
+#  define udp_firstconn(portno) g_udp_port_hash[udp_porthash(portno)]
+#  define udp_nextport(conn)    ((conn)->hnext)
+#else
+#  define udp_firstconn(portno) \
+     ((FAR struct udp_conn_s *)g_active_udp_connections.head)
+#  define udp_nextport(conn)    ((FAR struct udp_conn_s *)(conn)->node.flink)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -93,10 +114,78 @@ static dq_queue_t g_active_udp_connections;
 
 static uint16_t g_last_udp_port;
 
+#ifdef CONFIG_NET_UDP_HASH
+/* Connections with an assigned local port, hashed by that port number.
+ * Chained through the hnext field of the connection structure.
+ */
+
+static FAR struct udp_conn_s *g_udp_port_hash[CONFIG_NET_UDP_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_UDP_HASH
+/****************************************************************************
+ * Name: udp_porthash
+ *
+ * Description:
+ *   Return the port hash table index for the local port number (in network
+ *   byte order).
+ *
+ ****************************************************************************/
+
+static inline unsigned int udp_porthash(uint16_t portno)
+{
+  return (portno ^ (portno >> 8)) & UDP_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Assign the local port (in network byte order) of a connection, keeping
+ *   the port hash table up to date.  A port number of zero removes the
+ *   connection from the port hash table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void udp_setlport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  FAR struct udp_conn_s **link;
+  unsigned int ndx;
+
+  if (conn->lport != 0)
+    {
+      for (link = &g_udp_port_hash[udp_porthash(conn->lport)];
+           *link != NULL;
+           link = &(*link)->hnext)
+        {
+          if (*link == conn)
+            {
+              *link = conn->hnext;
+              break;
+            }
+        }
+    }
+
+  conn->lport = portno;
+  if (portno != 0)
+    {
+      ndx                  = udp_porthash(portno);
+      conn->hnext          = g_udp_port_hash[ndx];
+      g_udp_port_hash[ndx] = conn;
+    }
+}
+#else
+#  define udp_setlport(conn,portno) \
+     do { (conn)->lport = (portno); } while (0)
+#endif /* CONFIG_NET_UDP_HASH */
+
 /****************************************************************************
  * Name: _udp_semtake() and _udp_semgive()
  *
@@ -139,14 +228,11 @@ static FAR struct udp_conn_s *udp_find_conn(uint16_t portno)
 #endif
 {
   FAR struct udp_conn_s *conn;
-  int i;
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure that may be bound to the port. */
 
-  for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
+  for (conn = udp_firstconn(portno); conn != NULL; conn = udp_nextport(conn))
     {
-      conn = &g_udp_connections[i];
-
 #ifdef CONFIG_NETDEV_MULTINIC
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
@@ -262,11 +348,11 @@ static uint16_t udp_select_port(void)
 }
 
 /****************************************************************************
- * Name: udp_ipv4_active
+ * Name: udp_ipv4_match
  *
  * Description:
- *   Find a connection structure that is the appropriate connection to be
- *   used within the provided UDP header
+ *   Return true if the connection should receive the UDP packet in the
+ *   device buffer.
  *
  * Assumptions:
  *   This function is called from UIP logic at interrupt level
@@ -274,38 +360,43 @@ static uint16_t udp_select_port(void)
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static inline FAR struct udp_conn_s *
-  udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+static inline bool udp_ipv4_match(FAR struct net_driver_s *dev,
+                                  FAR struct udp_hdr_s *udp,
+                                  FAR struct udp_conn_s *conn)
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
-  FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn)
-    {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, then the following checks are performed:
-       *
-       * - The local port number is checked against the destination port
-       *   number in the received packet.
-       * - The remote port number is checked if the connection is bound
-       *   to a remote port.
-       * - If multiple network interfaces are supported, then the local
-       *   IP address is available and we will insist that the
-       *   destination IP matches the bound address (or the destination
-       *   IP address is a broadcast address). If a socket is bound to
-       *   INADDRY_ANY (laddr), then it should receive all packets
-       *   directed to the port.
-       * - Finally, if the connection is bound to a remote IP address,
-       *   the source IP address of the packet is checked. Broadcast
-       *   addresses are also accepted.
-       *
-       * If all of the above are true then the newly received UDP packet
-       * is destined for this UDP connection.
-       */
+  /* If the local UDP port is non-zero, the connection is considered
+   * to be used. If so, then the following checks are performed:
+   *
+   * - The local port number is checked against the destination port
+   *   number in the received packet.
+   * - The remote port number is checked if the connection is bound
+   *   to a remote port.
+   * - If multiple network interfaces are supported, then the local
+   *   IP address is available and we will insist that the
+   *   destination IP matches the bound address (or the destination
+   *   IP address is a broadcast address). If a socket is bound to
+   *   INADDRY_ANY (laddr), then it should receive all packets
+   *   directed to the port.
+   * - Finally, if the connection is bound to a remote IP address,
+   *   the source IP address of the packet is checked. Broadcast
+   *   addresses are also accepted.
+   *
+   * If the connection has multicast source filters, datagrams sent to a
+   * filtered group must also come from one of the accepted sources.
+   *
+   * If all of the above are true then the newly received UDP packet
+   * is destined for this UDP connection.
+   */
 
-      if (conn->lport != 0 && udp->destport == conn->lport &&
+  return (conn->lport != 0 && udp->destport == conn->lport &&
           (conn->rport == 0 || udp->srcport == conn->rport) &&
+#ifdef CONFIG_NET_UDP_SRCFILTER
+          (conn->nsources == 0 ||
+           udp_checksource(conn, net_ip4addr_conv32(ip->destipaddr),
+                           net_ip4addr_conv32(ip->srcipaddr))) &&
+#endif
 #ifdef CONFIG_NETDEV_MULTINIC
           (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
            net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_BROADCAST) ||
@@ -313,28 +404,16 @@ static inline FAR struct udp_conn_s *
 #endif
           (net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY) ||
            net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_BROADCAST) ||
-           net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
-        {
-          /* Matching connection found.. return a reference to it */
-
-          break;
-        }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
-    }
-
-  return conn;
+           net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)));
 }
 #endif /* CONFIG_NET_IPv4 */
 
 /****************************************************************************
- * Name: udp_ipv6_active
+ * Name: udp_ipv6_match
  *
  * Description:
- *   Find a connection structure that is the appropriate connection to be
- *   used within the provided UDP header
+ *   Return true if the connection should receive the UDP packet in the
+ *   device buffer.
  *
  * Assumptions:
  *   This function is called from UIP logic at interrupt level
@@ -342,37 +421,34 @@ static inline FAR struct udp_conn_s *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv6
-static inline FAR struct udp_conn_s *
-  udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_hdr_s *udp)
+static inline bool udp_ipv6_match(FAR struct net_driver_s *dev,
+                                  FAR struct udp_hdr_s *udp,
+                                  FAR struct udp_conn_s *conn)
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
-  FAR struct udp_conn_s *conn;
 
-  conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
-  while (conn)
-    {
-      /* If the local UDP port is non-zero, the connection is considered
-       * to be used. If so, then the following checks are performed:
-       *
-       * - The local port number is checked against the destination port
-       *   number in the received packet.
-       * - The remote port number is checked if the connection is bound
-       *   to a remote port.
-       * - If multiple network interfaces are supported, then the local
-       *   IP address is available and we will insist that the
-       *   destination IP matches the bound address (or the destination
-       *   IP address is a broadcast address). If a socket is bound to
-       *   INADDRY_ANY (laddr), then it should receive all packets
-       *   directed to the port.
-       * - Finally, if the connection is bound to a remote IP address,
-       *   the source IP address of the packet is checked. Broadcast
-       *   addresses are also accepted.
-       *
-       * If all of the above are true then the newly received UDP packet
-       * is destined for this UDP connection.
-       */
+  /* If the local UDP port is non-zero, the connection is considered
+   * to be used. If so, then the following checks are performed:
+   *
+   * - The local port number is checked against the destination port
+   *   number in the received packet.
+   * - The remote port number is checked if the connection is bound
+   *   to a remote port.
+   * - If multiple network interfaces are supported, then the local
+   *   IP address is available and we will insist that the
+   *   destination IP matches the bound address (or the destination
+   *   IP address is a broadcast address). If a socket is bound to
+   *   INADDRY_ANY (laddr), then it should receive all packets
+   *   directed to the port.
+   * - Finally, if the connection is bound to a remote IP address,
+   *   the source IP address of the packet is checked. Broadcast
+   *   addresses are also accepted.
+   *
+   * If all of the above are true then the newly received UDP packet
+   * is destined for this UDP connection.
+   */
 
-      if (conn->lport != 0 && udp->destport == conn->lport &&
+  return (conn->lport != 0 && udp->destport == conn->lport &&
           (conn->rport == 0 || udp->srcport == conn->rport) &&
 #ifdef CONFIG_NETDEV_MULTINIC
           (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_allzeroaddr) ||
@@ -381,21 +457,94 @@ static inline FAR struct udp_conn_s *
 #endif
           (net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_allzeroaddr) ||
            net_ipv6addr_cmp(conn->u.ipv6.raddr, g_ipv6_alloneaddr) ||
-           net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
-        {
-          /* Matching connection found.. return a reference to it */
+           net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)));
+}
+#endif /* CONFIG_NET_IPv6 */
 
-          break;
+/****************************************************************************
+ * Name: udp_match
+ *
+ * Description:
+ *   Return true if the connection should receive the UDP packet in the
+ *   device buffer.
+ *
+ * Assumptions:
+ *   This function is called from UIP logic at interrupt level
+ *
+ ****************************************************************************/
+
+static inline bool udp_match(FAR struct net_driver_s *dev,
+                             FAR struct udp_hdr_s *udp,
+                             FAR struct udp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      return udp_ipv6_match(dev, udp, conn);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return udp_ipv4_match(dev, udp, conn);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Name: udp_flowhash
+ *
+ * Description:
+ *   Return a hash of the source address and port of the UDP packet in the
+ *   device buffer.  This is used to select one of several sockets sharing
+ *   a port so that all datagrams of a flow are received by the same socket.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_REUSEPORT
+static unsigned int udp_flowhash(FAR struct net_driver_s *dev,
+                                 FAR struct udp_hdr_s *udp)
+{
+  uint32_t key = udp->srcport;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+      int i;
+
+      for (i = 0; i < 8; i += 2)
+        {
+          key ^= ((uint32_t)ip->srcipaddr[i] << 16) |
+                  (uint32_t)ip->srcipaddr[i + 1];
         }
+    }
+#endif /* CONFIG_NET_IPv6 */
 
-      /* Look at the next active connection */
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-      conn = (FAR struct udp_conn_s *)conn->node.flink;
+      key ^= ((uint32_t)ip->srcipaddr[0] << 16) |
+              (uint32_t)ip->srcipaddr[1];
     }
+#endif /* CONFIG_NET_IPv4 */
 
-  return conn;
+  key ^= key >> 16;
+  key ^= key >> 8;
+  return key;
 }
-#endif /* CONFIG_NET_IPv6 */
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -458,6 +607,20 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       conn->domain = domain;
 #endif
       conn->lport  = 0;
+#ifdef CONFIG_NET_UDP_REUSEPORT
+      conn->reuseport = false;
+#endif
+#ifdef CONFIG_NET_TIMESTAMP
+      conn->tsflags   = 0;
+      conn->txtsvalid = false;
+#endif
+#ifdef CONFIG_NET_TXPENDING
+      conn->txpend.tp_prio = 0;
+#endif
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+      sq_init(&conn->write_q);
+      conn->sndcb = NULL;
+#endif
 
       /* Enqueue the connection into the active list */
 
@@ -479,14 +642,46 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 
 void udp_free(FAR struct udp_conn_s *conn)
 {
+  net_lock_t flags;
+
   /* The free list is only accessed from user, non-interrupt level and
    * is protected by a semaphore (that behaves like a mutex).
    */
 
   DEBUGASSERT(conn->crefs == 0);
 
+  /* Drop any multicast source filters (this may leave groups) */
+
+  udp_freesources(conn);
+
   _udp_semtake(&g_free_sem);
-  conn->lport = 0;
+
+  /* Release the local port number */
+
+  flags = net_lock();
+  udp_setlport(conn, 0);
+
+  /* Stop TX polling of the connection */
+
+  devif_txpend_remove(&conn->txpend);
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+  /* Discard any datagrams that were not yet sent */
+
+  if (conn->sndcb != NULL)
+    {
+      udp_callback_free(NULL, conn, conn->sndcb);
+      conn->sndcb = NULL;
+    }
+
+  while (!sq_empty(&conn->write_q))
+    {
+      udp_wrbuffer_release((FAR struct udp_wrbuffer_s *)
+                           sq_remfirst(&conn->write_q));
+    }
+#endif
+
+  net_unlock(flags);
 
   /* Remove the connection from the active list */
 
@@ -519,23 +714,60 @@ void udp_free(FAR struct udp_conn_s *conn)
 FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_hdr_s *udp)
 {
-#ifdef CONFIG_NET_IPv6
-#ifdef CONFIG_NET_IPv4
-  if (IFF_IS_IPv6(dev->d_flags))
+  FAR struct udp_conn_s *conn;
+#ifdef CONFIG_NET_UDP_REUSEPORT
+  FAR struct udp_conn_s *first = NULL;
+  unsigned int nmatch = 0;
 #endif
+
+  for (conn = udp_firstconn(udp->destport);
+       conn != NULL;
+       conn = udp_nextport(conn))
     {
-      return udp_ipv6_active(dev, udp);
-    }
-#endif /* CONFIG_NET_IPv6 */
+      if (udp_match(dev, udp, conn))
+        {
+#ifdef CONFIG_NET_UDP_REUSEPORT
+          /* If the port is shared, count all of the sockets that could
+           * receive the packet.
+           */
 
-#ifdef CONFIG_NET_IPv4
-#ifdef CONFIG_NET_IPv6
-  else
+          if (conn->reuseport)
+            {
+              if (first == NULL)
+                {
+                  first = conn;
+                }
+
+              nmatch++;
+              continue;
+            }
 #endif
+
+          /* Matching connection found.. return a reference to it */
+
+          return conn;
+        }
+    }
+
+#ifdef CONFIG_NET_UDP_REUSEPORT
+  /* Select one of the sockets sharing the port by the flow hash */
+
+  if (nmatch > 1)
     {
-      return udp_ipv4_active(dev, udp);
+      nmatch = udp_flowhash(dev, udp) % nmatch;
+      for (conn = first; conn != NULL; conn = udp_nextport(conn))
+        {
+          if (conn->reuseport && udp_match(dev, udp, conn) && nmatch-- == 0)
+            {
+              return conn;
+            }
+        }
     }
-#endif /* CONFIG_NET_IPv4 */
+
+  return first;
+#else
+  return NULL;
+#endif
 }
 
 /****************************************************************************
@@ -562,6 +794,38 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_nextmatch
+ *
+ * Description:
+ *   Return the next connection after 'conn' (or the first connection if
+ *   'conn' is NULL) that should receive the UDP packet in the device
+ *   buffer.  Every matching connection is returned in turn, including all
+ *   of the connections sharing a port with SO_REUSEPORT.
+ *
+ * Assumptions:
+ *   This function is called from UIP logic at interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_MULTICAST
+FAR struct udp_conn_s *udp_nextmatch(FAR struct net_driver_s *dev,
+                                     FAR struct udp_hdr_s *udp,
+                                     FAR struct udp_conn_s *conn)
+{
+  conn = (conn == NULL) ? udp_firstconn(udp->destport) : udp_nextport(conn);
+  for (; conn != NULL; conn = udp_nextport(conn))
+    {
+      if (udp_match(dev, udp, conn))
+        {
+          return conn;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -576,9 +840,10 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
 
 int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 {
+  FAR struct udp_conn_s *other;
   net_lock_t flags;
   uint16_t portno;
-  int ret;
+  int ret = -EADDRINUSE;
 
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
@@ -633,11 +898,14 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
       /* Yes.. Select any unused local port number */
 
 #ifdef CONFIG_NETDEV_MULTINIC
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      portno = htons(udp_select_port(conn->domain, &conn->u));
 #else
-      conn->lport = htons(udp_select_port());
+      portno = htons(udp_select_port());
 #endif
-      ret         = OK;
+      flags  = net_lock();
+      udp_setlport(conn, portno);
+      net_unlock(flags);
+      ret    = OK;
     }
   else
     {
@@ -648,15 +916,30 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
       /* Is any other UDP connection already bound to this address and port? */
 
 #ifdef CONFIG_NETDEV_MULTINIC
-      if (!udp_find_conn(conn->domain, &conn->u, portno))
+      other = udp_find_conn(conn->domain, &conn->u, portno);
 #else
-      if (!udp_find_conn(portno))
+      other = udp_find_conn(portno);
+#endif
+
+#ifdef CONFIG_NET_UDP_REUSEPORT
+      /* The port may be shared if both sockets selected SO_REUSEPORT.
+       * Since a port can only be shared by sockets that all selected the
+       * option, it is sufficient to check the first one found.
+       */
+
+      if (other != NULL && other != conn && conn->reuseport &&
+          other->reuseport)
+        {
+          other = NULL;
+        }
 #endif
+
+      if (other == NULL)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
-          ret         = OK;
+          udp_setlport(conn, portno);
+          ret = OK;
         }
 
       net_unlock(flags);
@@ -698,15 +981,21 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 
   if (!conn->lport)
     {
+      net_lock_t flags;
+      uint16_t portno;
+
       /* No.. Find an unused local port number and bind it to the
        * connection structure.
        */
 
 #ifdef CONFIG_NETDEV_MULTINIC
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      portno = htons(udp_select_port(conn->domain, &conn->u));
 #else
-      conn->lport = htons(udp_select_port());
+      portno = htons(udp_select_port());
 #endif
+      flags  = net_lock();
+      udp_setlport(conn, portno);
+      net_unlock(flags);
     }
 
   /* Is there a remote port (rport)? */
@@ -47,6 +47,8 @@
 
 #include <debug.h>
 
+#include <netinet/in.h>
+
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/udp.h>
@@ -56,10 +58,130 @@
 #include "utils/utils.h"
 #include "udp/udp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPv4BUF ((FAR struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+#define IPv6BUF ((FAR struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_ismulticast
+ *
+ * Description:
+ *   Return true if the packet in the device buffer was sent to a multicast
+ *   or broadcast address and so may be received by several sockets.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_MULTICAST
+static inline bool udp_ismulticast(FAR struct net_driver_s *dev)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      return (IPv6BUF->destipaddr[0] & HTONS(0xff00)) == HTONS(0xff00);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      in_addr_t destipaddr = net_ip4addr_conv32(IPv4BUF->destipaddr);
+
+      return IN_MULTICAST(NTOHL(destipaddr)) ||
+             net_ipv4addr_cmp(destipaddr, INADDR_BROADCAST);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+#endif
+
+/****************************************************************************
+ * Name: udp_mcast_input
+ *
+ * Description:
+ *   Deliver a multicast or broadcast UDP packet to every socket that is
+ *   listening for it.  If the packet must be buffered for more than one
+ *   socket, the read-ahead I/O buffer chain is built once and then cloned.
+ *
+ *   Every recipient but the last must treat the packet as read-only:  A
+ *   reply would overwrite the packet in the device buffer so it is only
+ *   sent if it comes from the last recipient.
+ *
+ * Parameters:
+ *   dev    - The device driver structure containing the received UDP packet
+ *   udp    - A pointer to the UDP header in the packet
+ *   hdrlen - Length of the link layer, IP and UDP headers
+ *
+ * Assumptions:
+ *   Called from the interrupt level or with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_MULTICAST
+static void udp_mcast_input(FAR struct net_driver_s *dev,
+                            FAR struct udp_hdr_s *udp, unsigned int hdrlen)
+{
+  FAR struct udp_conn_s *conn;
+  FAR struct udp_conn_s *next;
+  FAR struct iob_s *iob = NULL;
+  uint16_t len = dev->d_len;
+
+  conn = udp_nextmatch(dev, udp, NULL);
+  if (conn == NULL)
+    {
+      nwarn("WARNING: No listener on UDP port\n");
+      dev->d_len = 0;
+      return;
+    }
+
+  for (; conn != NULL; conn = next)
+    {
+      /* Find the next recipient before the callback can modify the
+       * packet.
+       */
+
+      next = udp_nextmatch(dev, udp, conn);
+
+      /* Set-up for the application callback */
+
+      dev->d_appdata = &dev->d_buf[hdrlen];
+      dev->d_len     = len;
+      dev->d_sndlen  = 0;
+
+      /* Perform the application callback.  The packet cannot be held for
+       * a later retry once some of the sockets have received it so the
+       * returned flags are ignored.
+       */
+
+      (void)udp_mcast_callback(dev, conn, UDP_NEWDATA, &iob);
+
+      /* If the application has data to send, setup the UDP/IP header */
+
+      if (dev->d_sndlen > 0)
+        {
+          if (next == NULL)
+            {
+              udp_send(dev, conn);
+            }
+          else
+            {
+              nwarn("WARNING: Dropped reply to a multicast datagram\n");
+              dev->d_sndlen = 0;
+            }
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: udp_input
  *
@@ -121,7 +243,9 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = &dev->d_buf[hdrlen];
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  /* Skip the check if the hardware has already verified the checksum */
+
+  chksum = IFF_IS_RXCSUM(dev->d_flags) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
@@ -169,8 +293,19 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
        * however.  recvfrom() will not do that, however.  We would have to
        * make that the rule: Recipients of a UDP packet must treat the
        * packet as read-only.
+       *
+       * If CONFIG_NET_UDP_MULTICAST is selected, that is what is done for
+       * multicast and broadcast packets by udp_mcast_input().
        */
 
+#ifdef CONFIG_NET_UDP_MULTICAST
+      if (udp_ismulticast(dev))
+        {
+          udp_mcast_input(dev, udp, hdrlen);
+          return OK;
+        }
+#endif
+
       conn = udp_active(dev, udp);
       if (conn)
         {
@@ -446,6 +446,7 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
       /* Notify the device driver of the availability of TX data */
 
+      devif_txpend_add(dev, &conn->txpend, DEVIF_TXPEND_UDP);
       netdev_txnotify_dev(dev);
 
       /* Wait for either the receive to complete or for an error/timeout to occur.
@@ -45,6 +45,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <string.h>
+#include <time.h>
 #include <debug.h>
 #include <assert.h>
 
@@ -162,7 +163,10 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
           /* Calculate IP checksum. */
 
           ipv4->ipchksum    = 0;
-          ipv4->ipchksum    = ~ipv4_chksum(dev);
+          if (!IFF_IS_TXCSUM(dev->d_flags))
+            {
+              ipv4->ipchksum = ~ipv4_chksum(dev);
+            }
 
 #ifdef CONFIG_NET_STATISTICS
           g_netstats.ipv4.sent++;
@@ -224,36 +228,60 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       udp->udpchksum   = 0;
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum unless the hardware will insert it. */
 
+      if (!IFF_IS_TXCSUM(dev->d_flags))
+        {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
-      if (conn->domain == PF_INET ||
-          (conn->domain == PF_INET6 &&
-           ip6_is_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr)))
+          if (conn->domain == PF_INET ||
+              (conn->domain == PF_INET6 &&
+               ip6_is_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr)))
 #endif
-        {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
-      else
+          else
 #endif
-        {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (udp->udpchksum == 0)
-        {
-          udp->udpchksum = 0xffff;
+          if (udp->udpchksum == 0)
+            {
+              udp->udpchksum = 0xffff;
+            }
         }
 #endif /* CONFIG_NET_UDP_CHECKSUMS */
 
       ninfo("Outgoing UDP packet length: %d\n", dev->d_len);
 
+#ifdef CONFIG_NET_TIMESTAMP
+      /* Time stamp the datagram if the socket asked for it.  A hardware
+       * time stamp is reported later by the driver with
+       * netdev_txtimestamp().
+       */
+
+      if ((conn->tsflags & (SOF_TIMESTAMPING_TX_SOFTWARE |
+                            SOF_TIMESTAMPING_TX_HARDWARE)) != 0)
+        {
+          memset(&conn->txhwtime, 0, sizeof(struct timespec));
+          (void)clock_gettime(CLOCK_REALTIME, &conn->txswtime);
+          conn->txtsvalid =
+            (conn->tsflags & SOF_TIMESTAMPING_TX_SOFTWARE) != 0;
+
+          if ((conn->tsflags & SOF_TIMESTAMPING_TX_HARDWARE) != 0)
+            {
+              dev->d_txtsreq = conn;
+            }
+        }
+#endif
+
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.udp.sent++;
 #endif
@@ -0,0 +1,468 @@
+/****************************************************************************
+ * net/udp/udp_sendto_buffered.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+#include <assert.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/net/iob.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "arp/arp.h"
+#include "icmpv6/icmpv6.h"
+#include "socket/socket.h"
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* If both IPv4 and IPv6 support are both enabled, then we will need to build
+ * in some additional domain selection support.
+ */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define NEED_IPDOMAIN_SUPPORT 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sendto_ipselect
+ *
+ * Description:
+ *   If both IPv4 and IPv6 support are enabled, then we will need to select
+ *   which one to use when generating the outgoing packet.  If only one
+ *   domain is selected, then the setup is already in place and we need do
+ *   nothing.
+ *
+ * Parameters:
+ *   dev  - The structure of the network driver that caused the interrupt
+ *   conn - The UDP connection that is sending
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+static inline void sendto_ipselect(FAR struct net_driver_s *dev,
+                                   FAR struct udp_conn_s *conn)
+{
+  if (conn->domain == PF_INET)
+    {
+      /* Select the IPv4 domain */
+
+      udp_ipv4_select(dev);
+    }
+  else /* if (conn->domain == PF_INET6) */
+    {
+      /* Select the IPv6 domain */
+
+      DEBUGASSERT(conn->domain == PF_INET6);
+      udp_ipv6_select(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Function: sendto_discard
+ *
+ * Description:
+ *   Discard all datagrams queued on the connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void sendto_discard(FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+
+  while ((wrb = (FAR struct udp_wrbuffer_s *)sq_remfirst(&conn->write_q))
+         != NULL)
+    {
+      udp_wrbuffer_release(wrb);
+    }
+}
+
+/****************************************************************************
+ * Function: sendto_interrupt
+ *
+ * Description:
+ *   This function is called from the interrupt level to send the datagram
+ *   at the head of the write queue when polled by the lower, device
+ *   interfacing layer.  One datagram is sent per poll; the connection
+ *   stays queued for TX polling until the write queue is empty.
+ *
+ * Parameters:
+ *   dev        The structure of the network driver that caused the interrupt
+ *   pvconn     An instance of the UDP connection structure cast to void *
+ *   pvpriv     Unused
+ *   flags      Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   Modified value of the input flags
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+static uint16_t sendto_interrupt(FAR struct net_driver_s *dev,
+                                 FAR void *pvconn, FAR void *pvpriv,
+                                 uint16_t flags)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)pvconn;
+  FAR struct udp_wrbuffer_s *wrb;
+#ifdef CONFIG_NETDEV_MULTINIC
+  FAR struct net_driver_s *txdev;
+#endif
+
+  ninfo("flags: %04x\n", flags);
+
+  wrb = (FAR struct udp_wrbuffer_s *)sq_peek(&conn->write_q);
+  if (wrb == NULL)
+    {
+      return flags;
+    }
+
+  /* If the network device has gone down, then the queued datagrams can
+   * no longer be sent.
+   */
+
+  if ((flags & NETDEV_DOWN) != 0)
+    {
+      nwarn("WARNING: Network is down, dropping datagrams\n");
+      sendto_discard(conn);
+      return flags;
+    }
+
+  /* Check if the outgoing packet is available.  It may have been claimed
+   * by another callback -OR- the output buffer currently contains
+   * unprocessed incoming data.  In these cases we will just have to wait
+   * for the next polling cycle.
+   */
+
+  if ((flags & UDP_POLL) == 0 || dev->d_sndlen > 0 ||
+      (flags & UDP_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  /* Set the destination of the datagram.  udp_send() takes the remote
+   * address from the connection structure.
+   */
+
+  (void)udp_connect(conn, (FAR const struct sockaddr *)&wrb->wb_dest);
+
+#ifdef CONFIG_NETDEV_MULTINIC
+  /* The datagram may be routed through another device.  Leave it queued
+   * for that device (or drop it if it can no longer be routed at all).
+   */
+
+  txdev = udp_find_raddr_device(conn);
+  if (txdev != dev)
+    {
+      if (txdev == NULL)
+        {
+          nwarn("WARNING: Destination unreachable, dropping datagram\n");
+          (void)sq_remfirst(&conn->write_q);
+          udp_wrbuffer_release(wrb);
+        }
+      else
+        {
+          devif_txpend_add(txdev, &conn->txpend, DEVIF_TXPEND_UDP);
+          netdev_txnotify_dev(txdev);
+        }
+
+      return flags;
+    }
+#endif
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  /* If both IPv4 and IPv6 support are enabled, then we will need to
+   * select which one to use when generating the outgoing packet.
+   */
+
+  sendto_ipselect(dev, conn);
+#endif
+
+  /* Copy the datagram into d_appdata.  The I/O buffer chain is released
+   * below, so the driver must not gather from it (see devif_iob_send()).
+   */
+
+  iob_copyout(dev->d_appdata, wrb->wb_iob, wrb->wb_len, 0);
+  dev->d_sndlen = wrb->wb_len;
+
+  /* The datagram is on its way.  Release the write buffer. */
+
+  (void)sq_remfirst(&conn->write_q);
+  udp_wrbuffer_release(wrb);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.  The datagram is copied into an I/O buffer
+ *   chain and queued on the connection; this function then returns without
+ *   waiting for the network device to send it.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ *   NOTE: All input parameters were verified by sendto() before this
+ *   function was called.
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See the description in
+ *   net/socket/sendto.c for the list of appropriate return value.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags, FAR const struct sockaddr *to,
+                         socklen_t tolen)
+{
+  FAR struct udp_conn_s *conn;
+  FAR struct net_driver_s *dev;
+  FAR struct udp_wrbuffer_s *wrb;
+  bool nonblock;
+  net_lock_t save;
+  int ret;
+
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
+#ifdef CONFIG_NET_ARP_SEND
+#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
+  if (psock->s_domain == PF_INET)
+#endif
+    {
+      FAR const struct sockaddr_in *into;
+
+      /* Make sure that the IP address mapping is in the ARP table */
+
+      into = (FAR const struct sockaddr_in *)to;
+      ret = arp_send(into->sin_addr.s_addr);
+    }
+#endif /* CONFIG_NET_ARP_SEND */
+
+#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
+#ifdef CONFIG_NET_ARP_SEND
+  else
+#endif
+    {
+      FAR const struct sockaddr_in6 *into;
+
+      /* Make sure that the IP address mapping is in the Neighbor Table */
+
+      into = (FAR const struct sockaddr_in6 *)to;
+      ret = icmpv6_neighbor(into->sin6_addr.s6_addr16);
+    }
+#endif /* CONFIG_NET_ICMPv6_NEIGHBOR */
+
+  /* Did we successfully get the address mapping? */
+
+  if (ret < 0)
+    {
+      nerr("ERROR: Peer not reachable\n");
+      return -ENETUNREACH;
+    }
+#endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  save = net_lock();
+
+  /* Setup the UDP socket.  udp_connect will set the remote address in the
+   * connection structure (and bind a local port if there is none yet).
+   */
+
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+  DEBUGASSERT(conn);
+
+  ret = udp_connect(conn, to);
+  if (ret < 0)
+    {
+      nerr("ERROR: udp_connect failed: %d\n", ret);
+      goto errout_with_lock;
+    }
+
+  /* Get the device that will handle the remote packet transfers.  This
+   * should never be NULL.
+   */
+
+  dev = udp_find_raddr_device(conn);
+  if (dev == NULL)
+    {
+      nerr("ERROR: udp_find_raddr_device failed\n");
+      ret = -ENETUNREACH;
+      goto errout_with_lock;
+    }
+
+  /* The datagram must fit into a single packet on that device */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      if (len > UDP_MSS(dev, IPv6UDP_HDRLEN))
+        {
+          ret = -EMSGSIZE;
+          goto errout_with_lock;
+        }
+    }
+#endif
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      if (len > UDP_MSS(dev, IPv4UDP_HDRLEN))
+        {
+          ret = -EMSGSIZE;
+          goto errout_with_lock;
+        }
+    }
+#endif
+
+  /* Set up the callback that drains the write queue the first time that
+   * the connection sends.  It stays in place until the connection is
+   * freed.
+   */
+
+  if (conn->sndcb == NULL)
+    {
+      conn->sndcb = udp_callback_alloc(NULL, conn);
+      if (conn->sndcb == NULL)
+        {
+          nerr("ERROR: Failed to allocate callback\n");
+          ret = -EBUSY;
+          goto errout_with_lock;
+        }
+
+      conn->sndcb->flags = (UDP_POLL | NETDEV_DOWN);
+      conn->sndcb->priv  = NULL;
+      conn->sndcb->event = sendto_interrupt;
+    }
+
+  /* Allocate a write buffer.  This may wait (with the network unlocked)
+   * unless the socket is non-blocking.
+   */
+
+  wrb = udp_wrbuffer_alloc(nonblock);
+  if (wrb == NULL)
+    {
+      ret = nonblock ? -EAGAIN : -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  /* Copy the datagram into the I/O buffer chain */
+
+  if (len > 0)
+    {
+      if (nonblock)
+        {
+          ret = iob_trycopyin(wrb->wb_iob, (FAR const uint8_t *)buf, len, 0,
+                              false);
+        }
+      else
+        {
+          ret = iob_copyin(wrb->wb_iob, (FAR const uint8_t *)buf, len, 0,
+                           false);
+        }
+
+      if (ret < 0)
+        {
+          udp_wrbuffer_release(wrb);
+          ret = nonblock ? -EAGAIN : ret;
+          goto errout_with_lock;
+        }
+    }
+
+  memcpy(&wrb->wb_dest, to,
+         tolen < sizeof(wrb->wb_dest) ? tolen : sizeof(wrb->wb_dest));
+  wrb->wb_len = len;
+
+  /* Queue the datagram and notify the device driver of the availability
+   * of TX data.
+   */
+
+  sq_addlast(&wrb->wb_node, &conn->write_q);
+
+  devif_txpend_add(dev, &conn->txpend, DEVIF_TXPEND_UDP);
+  netdev_txnotify_dev(dev);
+
+  ret = len;
+
+errout_with_lock:
+  net_unlock(save);
+  return ret;
+}
+
+#endif /* CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
@@ -0,0 +1,374 @@
+/****************************************************************************
+ * net/udp/udp_srcfilter.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_UDP_SRCFILTER)
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "igmp/igmp.h"
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_findsource
+ *
+ * Description:
+ *   Find the source filter of the connection for the group and source.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_srcfilter_s *
+udp_findsource(FAR struct udp_conn_s *conn, in_addr_t grpaddr,
+               in_addr_t srcaddr)
+{
+  FAR struct udp_srcfilter_s *filter;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_UDP_NSRCFILTERS; i++)
+    {
+      filter = &conn->srcfilter[i];
+      if (net_ipv4addr_cmp(filter->grpaddr, grpaddr) &&
+          net_ipv4addr_cmp(filter->srcaddr, srcaddr))
+        {
+          return filter;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: udp_groupuser
+ *
+ * Description:
+ *   Find any source filter of any connection for the group on the device.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_srcfilter_s *
+udp_groupuser(FAR struct net_driver_s *dev, in_addr_t grpaddr)
+{
+  FAR struct udp_conn_s *conn;
+  FAR struct udp_srcfilter_s *filter;
+  int i;
+
+  for (conn = udp_nextconn(NULL); conn != NULL; conn = udp_nextconn(conn))
+    {
+      for (i = 0; i < CONFIG_NET_UDP_NSRCFILTERS; i++)
+        {
+          filter = &conn->srcfilter[i];
+          if (filter->dev == dev &&
+              net_ipv4addr_cmp(filter->grpaddr, grpaddr))
+            {
+              return filter;
+            }
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: udp_dropfilter
+ *
+ * Description:
+ *   Release one source filter and leave the group if no socket uses it any
+ *   longer.
+ *
+ ****************************************************************************/
+
+static void udp_dropfilter(FAR struct udp_conn_s *conn,
+                           FAR struct udp_srcfilter_s *filter)
+{
+  FAR struct net_driver_s *dev = filter->dev;
+  FAR struct udp_srcfilter_s *other;
+  struct in_addr grpaddr;
+  bool leave = false;
+  net_lock_t flags;
+
+  grpaddr.s_addr = filter->grpaddr;
+
+  flags = net_lock();
+  filter->grpaddr = INADDR_ANY;
+  filter->srcaddr = INADDR_ANY;
+  filter->dev     = NULL;
+  conn->nsources--;
+
+  /* If this filter holds the group membership, pass it on to any other
+   * filter for the group.  If there is none, the group must be left.
+   */
+
+  if (filter->joined)
+    {
+      filter->joined = false;
+      other = udp_groupuser(dev, grpaddr.s_addr);
+      if (other != NULL)
+        {
+          other->joined = true;
+        }
+      else
+        {
+          leave = true;
+        }
+    }
+
+  net_unlock(flags);
+
+  /* igmp_leavegroup() waits for the Leave Group message to be sent so it
+   * must be called without the network locked.
+   */
+
+  if (leave)
+    {
+      (void)igmp_leavegroup(dev, &grpaddr);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_addsource
+ *
+ * Description:
+ *   Implements IP_ADD_SOURCE_MEMBERSHIP:  Join the multicast group (if it
+ *   has not already been joined) and accept datagrams sent to the group
+ *   from the source address.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Called from normal user level code.
+ *
+ ****************************************************************************/
+
+int udp_addsource(FAR struct udp_conn_s *conn,
+                  FAR const struct ip_mreq_source *mreq)
+{
+  FAR struct net_driver_s *dev;
+  FAR struct udp_srcfilter_s *filter;
+  in_addr_t grpaddr = mreq->imr_multiaddr.s_addr;
+  in_addr_t srcaddr = mreq->imr_sourceaddr.s_addr;
+  net_lock_t flags;
+  int ret;
+
+  if (!IN_MULTICAST(NTOHL(grpaddr)) ||
+      net_ipv4addr_cmp(srcaddr, INADDR_ANY))
+    {
+      return -EINVAL;
+    }
+
+  /* Find the device on which to join the group */
+
+#ifdef CONFIG_NETDEV_MULTINIC
+  dev = netdev_findby_ipv4addr(mreq->imr_interface.s_addr, grpaddr);
+#else
+  dev = netdev_findby_ipv4addr(grpaddr);
+#endif
+  if (dev == NULL)
+    {
+      return -ENODEV;
+    }
+
+  /* Reserve a free filter.  It is filled in now so that a concurrent
+   * request for the same group and source fails.
+   */
+
+  flags = net_lock();
+  if (udp_findsource(conn, grpaddr, srcaddr) != NULL)
+    {
+      net_unlock(flags);
+      return -EADDRINUSE;
+    }
+
+  filter = udp_findsource(conn, INADDR_ANY, INADDR_ANY);
+  if (filter == NULL)
+    {
+      net_unlock(flags);
+      return -ENOBUFS;
+    }
+
+  filter->dev     = dev;
+  filter->grpaddr = grpaddr;
+  filter->srcaddr = srcaddr;
+  filter->joined  = false;
+  conn->nsources++;
+  net_unlock(flags);
+
+  /* Join the group.  -EEXIST means that the group has already been joined
+   * on the device, either by another socket or through SIOCSIPMSFILTER.
+   */
+
+  ret = igmp_joingroup(dev, &mreq->imr_multiaddr);
+  if (ret == OK)
+    {
+      filter->joined = true;
+    }
+  else if (ret != -EEXIST)
+    {
+      nerr("ERROR: igmp_joingroup failed: %d\n", ret);
+
+      flags = net_lock();
+      filter->grpaddr = INADDR_ANY;
+      filter->srcaddr = INADDR_ANY;
+      filter->dev     = NULL;
+      conn->nsources--;
+      net_unlock(flags);
+      return ret;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: udp_dropsource
+ *
+ * Description:
+ *   Implements IP_DROP_SOURCE_MEMBERSHIP:  Stop accepting datagrams sent to
+ *   the multicast group from the source address.  The group is left when
+ *   no socket has a source filter for it any longer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Called from normal user level code.
+ *
+ ****************************************************************************/
+
+int udp_dropsource(FAR struct udp_conn_s *conn,
+                   FAR const struct ip_mreq_source *mreq)
+{
+  FAR struct udp_srcfilter_s *filter;
+
+  if (net_ipv4addr_cmp(mreq->imr_multiaddr.s_addr, INADDR_ANY))
+    {
+      return -EINVAL;
+    }
+
+  filter = udp_findsource(conn, mreq->imr_multiaddr.s_addr,
+                          mreq->imr_sourceaddr.s_addr);
+  if (filter == NULL)
+    {
+      return -EADDRNOTAVAIL;
+    }
+
+  udp_dropfilter(conn, filter);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: udp_freesources
+ *
+ * Description:
+ *   Drop all of the source filters of a connection that is being freed.
+ *
+ * Assumptions:
+ *   Called from normal user level code.
+ *
+ ****************************************************************************/
+
+void udp_freesources(FAR struct udp_conn_s *conn)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_UDP_NSRCFILTERS && conn->nsources > 0; i++)
+    {
+      if (!net_ipv4addr_cmp(conn->srcfilter[i].grpaddr, INADDR_ANY))
+        {
+          udp_dropfilter(conn, &conn->srcfilter[i]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: udp_checksource
+ *
+ * Description:
+ *   Return true if the connection accepts a datagram sent to 'grpaddr'
+ *   from 'srcaddr'.  This is always true unless the connection has source
+ *   filters for the group and the source is not one of them.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+bool udp_checksource(FAR struct udp_conn_s *conn, in_addr_t grpaddr,
+                     in_addr_t srcaddr)
+{
+  FAR struct udp_srcfilter_s *filter;
+  bool accept = true;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_UDP_NSRCFILTERS; i++)
+    {
+      filter = &conn->srcfilter[i];
+      if (net_ipv4addr_cmp(filter->grpaddr, grpaddr))
+        {
+          if (net_ipv4addr_cmp(filter->srcaddr, srcaddr))
+            {
+              return true;
+            }
+
+          accept = false;
+        }
+    }
+
+  return accept;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_UDP_SRCFILTER */
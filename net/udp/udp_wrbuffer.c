@@ -0,0 +1,220 @@
+/****************************************************************************
+ * net/udp/udp_wrbuffer.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/net/netconfig.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_UDP) && \
+    defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+
+#include <queue.h>
+#include <semaphore.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/iob.h>
+
+#include "iob/iob.h"
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Package all globals used by this logic into a structure */
+
+struct wrbuffer_s
+{
+  /* The semaphore to protect the buffers */
+
+  sem_t sem;
+
+  /* This is the list of available write buffers */
+
+  sq_queue_t freebuffers;
+
+  /* These are the pre-allocated write buffers */
+
+  struct udp_wrbuffer_s buffers[CONFIG_NET_UDP_NWRBCHAINS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This is the state of the global write buffer resource */
+
+static struct wrbuffer_s g_wrbuffer;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: udp_wrbuffer_initialize
+ *
+ * Description:
+ *   Initialize the list of free write buffers
+ *
+ * Assumptions:
+ *   Called once early initialization.
+ *
+ ****************************************************************************/
+
+void udp_wrbuffer_initialize(void)
+{
+  int i;
+
+  sq_init(&g_wrbuffer.freebuffers);
+
+  for (i = 0; i < CONFIG_NET_UDP_NWRBCHAINS; i++)
+    {
+      sq_addfirst(&g_wrbuffer.buffers[i].wb_node, &g_wrbuffer.freebuffers);
+    }
+
+  sem_init(&g_wrbuffer.sem, 0, CONFIG_NET_UDP_NWRBCHAINS);
+}
+
+/****************************************************************************
+ * Function: udp_wrbuffer_alloc
+ *
+ * Description:
+ *   Allocate a UDP write buffer by taking a pre-allocated buffer from
+ *   the free list.  This function is called from UDP logic when a datagram
+ *   is about to be queued for sending.
+ *
+ * Input parameters:
+ *   nonblock - Return NULL instead of waiting if no buffer is available
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct udp_wrbuffer_s *udp_wrbuffer_alloc(bool nonblock)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+  irqstate_t flags;
+
+  /* Reserve a write buffer structure first, then get the IOB.  In order to
+   * avoid deadlocks, the IOB is always freed first, then the write buffer.
+   */
+
+  if (nonblock)
+    {
+      if (sem_trywait(&g_wrbuffer.sem) < 0)
+        {
+          return NULL;
+        }
+    }
+  else
+    {
+      DEBUGVERIFY(net_lockedwait(&g_wrbuffer.sem));
+    }
+
+  /* Now, we are guaranteed to have a write buffer structure reserved
+   * for us in the free list.
+   */
+
+  flags = enter_critical_section();
+  wrb = (FAR struct udp_wrbuffer_s *)sq_remfirst(&g_wrbuffer.freebuffers);
+  leave_critical_section(flags);
+
+  DEBUGASSERT(wrb);
+  memset(wrb, 0, sizeof(struct udp_wrbuffer_s));
+
+  /* Now get the first I/O buffer for the write buffer structure */
+
+  if (nonblock)
+    {
+      wrb->wb_iob = iob_tryalloc_user(false, IOBUSER_UDP_TX);
+    }
+  else
+    {
+      wrb->wb_iob = iob_alloc_user(false, IOBUSER_UDP_TX);
+    }
+
+  if (!wrb->wb_iob)
+    {
+      nerr("ERROR: Failed to allocate I/O buffer\n");
+      udp_wrbuffer_release(wrb);
+      return NULL;
+    }
+
+  return wrb;
+}
+
+/****************************************************************************
+ * Function: udp_wrbuffer_release
+ *
+ * Description:
+ *   Release a UDP write buffer by returning the buffer to the free list.
+ *   This function is called after the datagram has been sent or discarded.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void udp_wrbuffer_release(FAR struct udp_wrbuffer_s *wrb)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(wrb);
+
+  /* To avoid deadlocks, we must following this ordering:  Release the I/O
+   * buffer chain first, then the write buffer structure.
+   */
+
+  if (wrb->wb_iob != NULL)
+    {
+      iob_free_chain(wrb->wb_iob);
+    }
+
+  /* Then free the write buffer structure */
+
+  flags = enter_critical_section();
+  sq_addlast(&wrb->wb_node, &g_wrbuffer.freebuffers);
+  leave_critical_section(flags);
+
+  sem_post(&g_wrbuffer.sem);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_UDP_WRITE_BUFFERS */
@@ -41,12 +41,16 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <debug.h>
 
+#include <arpa/inet.h>
+
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/icmp.h>
+#include <nuttx/net/iob.h>
 
 #include "utils/utils.h"
 
@@ -63,48 +67,208 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold a 32-bit one's complement sum into 16 bits.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static inline uint16_t chksum_fold(uint32_t acc)
+{
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
+}
+#endif
+
 /****************************************************************************
  * Name: chksum
+ *
+ * Description:
+ *   Continue the one's complement sum over len bytes of data.  The sum is
+ *   accumulated in 32 bits and the carries are folded in only at the end.
+ *   A 16-bit aligned buffer is summed in native 16-bit words, four at a
+ *   time, and the result is swapped into network order afterwards.  That
+ *   works because the one's complement sum is independent of byte order
+ *   (RFC 1071).
+ *
  ****************************************************************************/
 
 #ifndef CONFIG_NET_ARCH_CHKSUM
 static uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
+  FAR const uint16_t *wptr;
+  uint32_t acc = 0;
+
+  /* Even with len = 65535, the 32-bit accumulator cannot overflow */
+
+  if (((uintptr_t)data & 1) == 0)
+    {
+      wptr = (FAR const uint16_t *)data;
+
+      while (len >= 8)
+        {
+          acc += (uint32_t)wptr[0] + wptr[1] + wptr[2] + wptr[3];
+          wptr += 4;
+          len  -= 8;
+        }
+
+      while (len >= 2)
+        {
+          acc += *wptr++;
+          len -= 2;
+        }
+
+      data = (FAR const uint8_t *)wptr;
+      acc  = HTONS(chksum_fold(acc));
+    }
+  else
+    {
+      while (len >= 2)
+        {
+          acc  += ((uint32_t)data[0] << 8) | data[1];
+          data += 2;
+          len  -= 2;
+        }
+    }
+
+  /* Add any trailing odd byte and the sum so far */
+
+  if (len > 0)
+    {
+      acc += (uint32_t)data[0] << 8;
+    }
+
+  acc += sum;
+
+  /* Return sum in host byte order. */
+
+  return chksum_fold(acc);
+}
+#endif /* CONFIG_NET_ARCH_CHKSUM */
+
+/****************************************************************************
+ * Name: iob_chksum
+ *
+ * Description:
+ *   Continue the checksum over len bytes of an I/O buffer chain beginning
+ *   at offset.  The I/O buffers may hold an odd numbers of bytes so the
+ *   odd byte at the end of one buffer is carried over to the next.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_NET_IOBTX)
+static uint16_t iob_chksum(uint16_t sum, FAR struct iob_s *iob,
+                           unsigned int offset, unsigned int len)
+{
+  FAR const uint8_t *data;
+  unsigned int ncopy;
+  uint16_t pending = 0;
+  bool odd = false;
   uint16_t t;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  /* Skip over I/O buffers that precede the data */
 
-  while (dataptr < last_byte)
+  while (iob != NULL && offset >= iob->io_len)
     {
-      /* At least two more bytes */
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
+  while (len > 0 && iob != NULL)
+    {
+      data  = &iob->io_data[iob->io_offset + offset];
+      ncopy = iob->io_len - offset;
+      if (ncopy > len)
         {
-          sum++; /* carry */
+          ncopy = len;
+        }
+
+      len -= ncopy;
+
+      /* Complete the 16-bit word started at the end of the last buffer */
+
+      if (odd && ncopy > 0)
+        {
+          t    = pending + *data++;
+          sum += t;
+          if (sum < t)
+            {
+              sum++; /* carry */
+            }
+
+          ncopy--;
+          odd = false;
         }
 
-      dataptr += 2;
+      /* Sum the even part of this buffer and hold any odd byte */
+
+      if (ncopy > 1)
+        {
+          sum = chksum(sum, data, ncopy & ~1);
+        }
+
+      if ((ncopy & 1) != 0)
+        {
+          pending = (uint16_t)data[ncopy - 1] << 8;
+          odd     = true;
+        }
+
+      offset = 0;
+      iob    = iob->io_flink;
     }
 
-  if (dataptr == last_byte)
+  if (odd)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
+      sum += pending;
+      if (sum < pending)
         {
           sum++; /* carry */
         }
     }
 
-  /* Return sum in host byte order. */
-
   return sum;
 }
+#endif /* !CONFIG_NET_ARCH_CHKSUM && CONFIG_NET_IOBTX */
+
+/****************************************************************************
+ * Name: upperlayer_payload_chksum
+ *
+ * Description:
+ *   Sum upperlen bytes of the upper layer header and payload that begin at
+ *   the offset hdrlen in d_buf.  If the payload was left in an I/O buffer
+ *   chain (see devif_iob_send()), then only the headers are in d_buf.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM
+static inline uint16_t upperlayer_payload_chksum(FAR struct net_driver_s *dev,
+                                                 uint8_t proto,
+                                                 uint16_t sum,
+                                                 unsigned int hdrlen,
+                                                 uint16_t upperlen)
+{
+#ifdef CONFIG_NET_IOBTX
+  /* Only TCP write buffers are sent from I/O buffer chains */
+
+  if (proto == IP_PROTO_TCP && dev->d_sndiob != NULL &&
+      dev->d_sndioblen <= upperlen)
+    {
+      uint16_t buflen = upperlen - dev->d_sndioblen;
+
+      /* The headers in d_buf always have an even length */
+
+      sum = chksum(sum, &dev->d_buf[hdrlen], buflen);
+      return iob_chksum(sum, dev->d_sndiob, dev->d_sndioboffs,
+                        dev->d_sndioblen);
+    }
+#endif
+
+  return chksum(sum, &dev->d_buf[hdrlen], upperlen);
+}
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
 /****************************************************************************
@@ -144,7 +308,8 @@ static uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[IPv4_HDRLEN + NET_LL_HDRLEN(dev)], upperlen);
+  sum = upperlayer_payload_chksum(dev, proto, sum,
+                                  IPv4_HDRLEN + NET_LL_HDRLEN(dev), upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -187,7 +352,8 @@ static uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  sum = chksum(sum, &dev->d_buf[IPv6_HDRLEN + NET_LL_HDRLEN(dev)], upperlen);
+  sum = upperlayer_payload_chksum(dev, proto, sum,
+                                  IPv6_HDRLEN + NET_LL_HDRLEN(dev), upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
@@ -47,7 +47,10 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
 
 #include "utils/utils.h"
 
@@ -67,6 +70,21 @@ static sem_t        g_netlock;
 static pid_t        g_holder  = NO_HOLDER;
 static unsigned int g_count   = 0;
 
+#ifdef CONFIG_NET_FINELOCK
+/* Threads that hold a device lock taken with netdev_lock() are "sharers".
+ * A sharer must take g_netlock to become one, and net_lock() waits until
+ * there are no sharers left.  Sharers exclude each other with the device
+ * locks and the protocol locks, taken in this order:  Device, TCP, UDP,
+ * OTHER.
+ */
+
+static uint16_t     g_nsharers;   /* Number of sharers */
+static bool         g_draining;   /* net_lock() waits for sharers to leave */
+static sem_t        g_drainsem;   /* Posted when the last sharer leaves */
+
+static struct net_rlock_s g_protolock[NETLOCK_NPROTOS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -75,13 +93,13 @@ static unsigned int g_count   = 0;
  * Function: _net_takesem
  *
  * Description:
- *   Take the semaphore
+ *   Take a semaphore, ignoring signals
  *
  ****************************************************************************/
 
-static void _net_takesem(void)
+static void _net_takesem(FAR sem_t *sem)
 {
-  while (sem_wait(&g_netlock) != 0)
+  while (sem_wait(sem) != 0)
     {
       /* The only case that an error should occur here is if the wait was
        * awakened by a signal.
@@ -91,6 +109,81 @@ static void _net_takesem(void)
     }
 }
 
+/****************************************************************************
+ * Function: net_takeall
+ *
+ * Description:
+ *   Take the lock of the whole network.  With CONFIG_NET_FINELOCK, this
+ *   also waits until no thread holds a device lock.
+ *
+ ****************************************************************************/
+
+static void net_takeall(void)
+{
+#ifdef CONFIG_NET_FINELOCK
+  irqstate_t flags;
+#endif
+
+  _net_takesem(&g_netlock);
+
+#ifdef CONFIG_NET_FINELOCK
+  /* No other thread can become a sharer now.  Wait for the current sharers
+   * to release their device locks.
+   */
+
+  flags = enter_critical_section();
+  while (g_nsharers > 0)
+    {
+      g_draining = true;
+      _net_takesem(&g_drainsem);
+    }
+
+  leave_critical_section(flags);
+#endif
+}
+
+#ifdef CONFIG_NET_FINELOCK
+/****************************************************************************
+ * Function: net_rlocktake and net_rlockgive
+ *
+ * Description:
+ *   Take and release a re-entrant lock
+ *
+ ****************************************************************************/
+
+static void net_rlocktake(FAR struct net_rlock_s *lock)
+{
+  pid_t me = getpid();
+
+  if (lock->rl_holder == me)
+    {
+      lock->rl_count++;
+    }
+  else
+    {
+      _net_takesem(&lock->rl_sem);
+      lock->rl_holder = me;
+      lock->rl_count  = 1;
+    }
+}
+
+static void net_rlockgive(FAR struct net_rlock_s *lock)
+{
+  DEBUGASSERT(lock->rl_holder == getpid() && lock->rl_count > 0);
+
+  if (lock->rl_count == 1)
+    {
+      lock->rl_holder = NO_HOLDER;
+      lock->rl_count  = 0;
+      sem_post(&lock->rl_sem);
+    }
+  else
+    {
+      lock->rl_count--;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,9 +198,48 @@ static void _net_takesem(void)
 
 void net_lockinitialize(void)
 {
+#ifdef CONFIG_NET_FINELOCK
+  int i;
+#endif
+
   sem_init(&g_netlock, 0, 1);
+#ifdef CONFIG_SCHED_LOCKSTAT
+  (void)sem_setname(&g_netlock, "net_lock");
+#endif
+
+#ifdef CONFIG_NET_FINELOCK
+  sem_init(&g_drainsem, 0, 0);
+
+  for (i = 0; i < NETLOCK_NPROTOS; i++)
+    {
+      net_rlockinit(&g_protolock[i]);
+    }
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+  (void)sem_setname(&g_protolock[NETLOCK_TCP].rl_sem, "net_tcp");
+  (void)sem_setname(&g_protolock[NETLOCK_UDP].rl_sem, "net_udp");
+  (void)sem_setname(&g_protolock[NETLOCK_OTHER].rl_sem, "net_other");
+#endif
+#endif
 }
 
+/****************************************************************************
+ * Function: net_rlockinit
+ *
+ * Description:
+ *   Initialize a re-entrant lock, i.e. the lock of a network device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINELOCK
+void net_rlockinit(FAR struct net_rlock_s *lock)
+{
+  sem_init(&lock->rl_sem, 0, 1);
+  lock->rl_holder = NO_HOLDER;
+  lock->rl_count  = 0;
+}
+#endif
+
 /****************************************************************************
  * Function: net_lock
  *
@@ -128,11 +260,22 @@ net_lock_t net_lock(void)
 
       g_count++;
     }
+#ifdef CONFIG_NET_FINELOCK
+  else if (net_isshared())
+    {
+      /* This thread holds a device lock.  Waiting for the whole network
+       * could deadlock with the other sharers, so lock only the protocols
+       * other than TCP and UDP.
+       */
+
+      net_rlocktake(&g_protolock[NETLOCK_OTHER]);
+    }
+#endif
   else
     {
       /* No.. take the semaphore (perhaps waiting) */
 
-      _net_takesem();
+      net_takeall();
 
       /* Now this thread holds the semaphore */
 
@@ -153,6 +296,16 @@ net_lock_t net_lock(void)
 
 void net_unlock(net_lock_t flags)
 {
+#ifdef CONFIG_NET_FINELOCK
+  if (g_holder != getpid())
+    {
+      /* net_lock() was called while a device was locked */
+
+      net_rlockgive(&g_protolock[NETLOCK_OTHER]);
+      return;
+    }
+#endif
+
   DEBUGASSERT(g_holder == getpid() && g_count > 0);
 
   /* If the count would go to zero, then release the semaphore */
@@ -189,6 +342,11 @@ void net_unlock(net_lock_t flags)
  *   (OK) is returned on success; -1 (ERROR) is returned on a failure with
  *   the errno value set appropriately.
  *
+ * Assumptions:
+ *   The caller does not hold a device lock taken with netdev_lock().  The
+ *   wait would keep the device and protocol locks and so block net_lock()
+ *   until it ends.
+ *
  ****************************************************************************/
 
 int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
@@ -198,6 +356,8 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
   irqstate_t   flags;
   int          ret;
 
+  DEBUGASSERT(!net_isshared());
+
   flags = enter_critical_section(); /* No interrupts */
   sched_lock();      /* No context switches */
   if (g_holder == me)
@@ -226,7 +386,7 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
       /* Recover the network lock at the proper count */
 
-      _net_takesem();
+      net_takeall();
       g_holder = me;
       g_count  = count;
     }
@@ -261,4 +421,142 @@ int net_lockedwait(sem_t *sem)
   return net_timedwait(sem, NULL);
 }
 
+#ifdef CONFIG_NET_FINELOCK
+/****************************************************************************
+ * Function: netdev_lock
+ *
+ * Description:
+ *   Lock the network for the receive processing or the polling of one
+ *   device.  Other devices can be serviced at the same time; the stack
+ *   takes the protocol locks as needed.
+ *
+ ****************************************************************************/
+
+net_lock_t netdev_lock(FAR struct net_driver_s *dev)
+{
+  FAR struct tcb_s *tcb = sched_self();
+  irqstate_t flags;
+
+  DEBUGASSERT(dev != NULL);
+
+  /* The lock of the whole network also covers the device */
+
+  if (g_holder == getpid())
+    {
+      return net_lock();
+    }
+
+  if (tcb->netshared == 0)
+    {
+      /* Wait until no thread holds the whole network and become a sharer */
+
+      _net_takesem(&g_netlock);
+
+      flags = enter_critical_section();
+      g_nsharers++;
+      leave_critical_section(flags);
+
+      sem_post(&g_netlock);
+    }
+
+  DEBUGASSERT(tcb->netshared < UINT8_MAX);
+  tcb->netshared++;
+
+  net_rlocktake(&dev->d_lock);
+  return 0;
+}
+
+/****************************************************************************
+ * Function: netdev_unlock
+ *
+ * Description:
+ *   Release the lock taken with netdev_lock().
+ *
+ ****************************************************************************/
+
+void netdev_unlock(FAR struct net_driver_s *dev, net_lock_t flags)
+{
+  FAR struct tcb_s *tcb = sched_self();
+  irqstate_t state;
+
+  if (g_holder == getpid())
+    {
+      net_unlock(flags);
+      return;
+    }
+
+  DEBUGASSERT(dev != NULL && tcb->netshared > 0);
+  net_rlockgive(&dev->d_lock);
+
+  if (--tcb->netshared == 0)
+    {
+      /* No longer a sharer.  Wake up net_lock() if it waits for the last
+       * one.
+       */
+
+      state = enter_critical_section();
+      DEBUGASSERT(g_nsharers > 0);
+
+      if (--g_nsharers == 0 && g_draining)
+        {
+          g_draining = false;
+          sem_post(&g_drainsem);
+        }
+
+      leave_critical_section(state);
+    }
+}
+
+/****************************************************************************
+ * Function: net_protolock
+ *
+ * Description:
+ *   Lock one protocol of the stack.  Nothing is done if the whole network
+ *   is locked.
+ *
+ ****************************************************************************/
+
+void net_protolock(int proto)
+{
+  DEBUGASSERT(proto >= 0 && proto < NETLOCK_NPROTOS);
+
+  if (g_holder != getpid())
+    {
+      DEBUGASSERT(net_isshared());
+      net_rlocktake(&g_protolock[proto]);
+    }
+}
+
+/****************************************************************************
+ * Function: net_protounlock
+ *
+ * Description:
+ *   Release a lock taken with net_protolock().
+ *
+ ****************************************************************************/
+
+void net_protounlock(int proto)
+{
+  DEBUGASSERT(proto >= 0 && proto < NETLOCK_NPROTOS);
+
+  if (g_holder != getpid())
+    {
+      net_rlockgive(&g_protolock[proto]);
+    }
+}
+
+/****************************************************************************
+ * Function: net_isshared
+ *
+ * Description:
+ *   Return true if the calling thread holds a device lock.
+ *
+ ****************************************************************************/
+
+bool net_isshared(void)
+{
+  return sched_self()->netshared > 0;
+}
+#endif /* CONFIG_NET_FINELOCK */
+
 #endif /* CONFIG_NET */
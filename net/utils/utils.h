@@ -44,6 +44,19 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The protocol locks of CONFIG_NET_FINELOCK (see net_protolock()).  A
+ * thread that holds more than one takes them in this order.
+ */
+
+#define NETLOCK_TCP     0  /* TCP connections */
+#define NETLOCK_UDP     1  /* UDP connections */
+#define NETLOCK_OTHER   2  /* Everything else */
+#define NETLOCK_NPROTOS 3
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -90,6 +103,68 @@ void net_lockinitialize(void);
 #  define net_lockinitialize()
 #endif
 
+/****************************************************************************
+ * Function: net_rlockinit
+ *
+ * Description:
+ *   Initialize a re-entrant lock, i.e. the lock of a network device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINELOCK
+void net_rlockinit(FAR struct net_rlock_s *lock);
+#endif
+
+/****************************************************************************
+ * Function: net_protolock
+ *
+ * Description:
+ *   Lock one protocol of the stack (NETLOCK_TCP, NETLOCK_UDP or
+ *   NETLOCK_OTHER).  This is needed only by a thread that locked a device
+ *   with netdev_lock(); if the whole network is locked with net_lock(),
+ *   nothing is done.  net_lock() called while a device is locked takes
+ *   NETLOCK_OTHER.
+ *
+ *   The input and poll functions of devif take the protocol locks, so
+ *   drivers do not need to.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINELOCK
+void net_protolock(int proto);
+#else
+#  define net_protolock(p) ((void)(p))
+#endif
+
+/****************************************************************************
+ * Function: net_protounlock
+ *
+ * Description:
+ *   Release a lock taken with net_protolock().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINELOCK
+void net_protounlock(int proto);
+#else
+#  define net_protounlock(p) ((void)(p))
+#endif
+
+/****************************************************************************
+ * Function: net_isshared
+ *
+ * Description:
+ *   Return true if the calling thread holds a device lock taken with
+ *   netdev_lock() (and so not the lock of the whole network).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_FINELOCK
+bool net_isshared(void);
+#else
+#  define net_isshared() false
+#endif
+
 /****************************************************************************
  * Function: net_dsec2timeval
  *
@@ -0,0 +1,81 @@
+/****************************************************************************
+ * sched/bench/bench.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_BENCH_BENCH_H
+#define __SCHED_BENCH_BENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <semaphore.h>
+
+#include <nuttx/bench.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_PRIORITY_HIGH CONFIG_SCHED_BENCHMARK_PRIORITY
+#define BENCH_PRIORITY_LOW  (CONFIG_SCHED_BENCHMARK_PRIORITY - 1)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Common helpers (bench_run.c) */
+
+void bench_sample(FAR struct bench_result_s *result, uint32_t elapsed);
+int  bench_start(FAR const char *name, int priority, main_t entry);
+int  bench_wait(FAR sem_t *sem);
+
+/* The benchmarks.  Each takes nsamples samples and accumulates them in
+ * result with bench_sample().
+ */
+
+int bench_ctxswitch(uint32_t nsamples, FAR struct bench_result_s *result);
+int bench_semwake(uint32_t nsamples, FAR struct bench_result_s *result);
+int bench_mqroundtrip(uint32_t nsamples, FAR struct bench_result_s *result);
+int bench_mutex(uint32_t nsamples, FAR struct bench_result_s *result);
+int bench_malloc(uint32_t nsamples, FAR struct bench_result_s *result);
+int bench_wdog(uint32_t nsamples, FAR struct bench_result_s *result);
+int bench_workqueue(uint32_t nsamples, FAR struct bench_result_s *result);
+int bench_timerjitter(uint32_t nsamples, FAR struct bench_result_s *result);
+
+#endif /* __SCHED_BENCH_BENCH_H */
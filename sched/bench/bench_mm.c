@@ -0,0 +1,136 @@
+/****************************************************************************
+ * sched/bench/bench_mm.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/bench.h>
+
+#include "bench/bench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A few allocations are kept live so that the heap is not simply handing
+ * the same chunk back and forth.
+ */
+
+#define BENCH_MM_NSLOTS  8
+#define BENCH_MM_MINSIZE 16
+#define BENCH_MM_MAXSIZE 1024
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_mm_size
+ *
+ * Description:
+ *   A pseudo-random allocation size (the same sequence on every run).
+ *
+ ****************************************************************************/
+
+static size_t bench_mm_size(FAR uint32_t *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return BENCH_MM_MINSIZE +
+         (*seed >> 16) % (BENCH_MM_MAXSIZE - BENCH_MM_MINSIZE + 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_malloc
+ *
+ * Description:
+ *   Heap throughput:  The cost of freeing one of a number of live blocks
+ *   and allocating a new block of a different size in its place.
+ *
+ ****************************************************************************/
+
+int bench_malloc(uint32_t nsamples, FAR struct bench_result_s *result)
+{
+  FAR void *slots[BENCH_MM_NSLOTS];
+  uint32_t seed = 1;
+  uint32_t start;
+  uint32_t i;
+  size_t size;
+  int ret = OK;
+  int ndx;
+
+  for (ndx = 0; ndx < BENCH_MM_NSLOTS; ndx++)
+    {
+      slots[ndx] = kmm_malloc(bench_mm_size(&seed));
+    }
+
+  for (i = 0; i < nsamples; i++)
+    {
+      ndx   = i % BENCH_MM_NSLOTS;
+      size  = bench_mm_size(&seed);
+
+      start = up_perf_gettime();
+      kmm_free(slots[ndx]);
+      slots[ndx] = kmm_malloc(size);
+      bench_sample(result, up_perf_gettime() - start);
+
+      if (slots[ndx] == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+    }
+
+  for (ndx = 0; ndx < BENCH_MM_NSLOTS; ndx++)
+    {
+      if (slots[ndx] != NULL)
+        {
+          kmm_free(slots[ndx]);
+        }
+    }
+
+  return ret;
+}
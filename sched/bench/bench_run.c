@@ -0,0 +1,219 @@
+/****************************************************************************
+ * sched/bench/bench_run.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kthread.h>
+#include <nuttx/bench.h>
+
+#include "sched/sched.h"
+#include "bench/bench.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE int (*bench_t)(uint32_t nsamples,
+                            FAR struct bench_result_s *result);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The benchmarks, indexed by enum bench_e */
+
+static const bench_t g_benchmarks[BENCH_NTESTS] =
+{
+  bench_ctxswitch,      /* BENCH_CTXSWITCH */
+  bench_semwake,        /* BENCH_SEMWAKE */
+  bench_mqroundtrip,    /* BENCH_MQROUNDTRIP */
+  bench_mutex,          /* BENCH_MUTEX */
+  bench_malloc,         /* BENCH_MALLOC */
+  bench_wdog,           /* BENCH_WDOG */
+  bench_workqueue,      /* BENCH_WORKQUEUE */
+  bench_timerjitter     /* BENCH_TIMERJITTER */
+};
+
+/* The benchmarks share static state so only one may run at a time */
+
+static sem_t g_bench_exclsem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_sample
+ *
+ * Description:
+ *   Add one sample to the result.
+ *
+ ****************************************************************************/
+
+void bench_sample(FAR struct bench_result_s *result, uint32_t elapsed)
+{
+  if (elapsed < result->min)
+    {
+      result->min = elapsed;
+    }
+
+  if (elapsed > result->max)
+    {
+      result->max = elapsed;
+    }
+
+  result->total += elapsed;
+  result->nsamples++;
+}
+
+/****************************************************************************
+ * Name: bench_start
+ *
+ * Description:
+ *   Start one benchmark thread.  Under SMP, the thread is kept on the CPU
+ *   of the caller so that what is measured really is the path through the
+ *   OS and not two CPUs running concurrently.  The caller should hold
+ *   sched_lock() until all of its threads have been started.
+ *
+ * Returned Value:
+ *   The pid of the new thread on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int bench_start(FAR const char *name, int priority, main_t entry)
+{
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+  int pid;
+
+  pid = kernel_thread(name, priority, CONFIG_SCHED_BENCHMARK_STACKSIZE,
+                      entry, (FAR char * const *)NULL);
+  if (pid < 0)
+    {
+      int errcode = get_errno();
+      serr("ERROR: Failed to start %s: %d\n", name, errcode);
+      return -errcode;
+    }
+
+#ifdef CONFIG_SMP
+  CPU_ZERO(&cpuset);
+  CPU_SET(this_cpu(), &cpuset);
+  (void)sched_setaffinity(pid, sizeof(cpu_set_t), &cpuset);
+#endif
+
+  return pid;
+}
+
+/****************************************************************************
+ * Name: bench_wait
+ *
+ * Description:
+ *   Wait on a semaphore, ignoring signals.
+ *
+ ****************************************************************************/
+
+int bench_wait(FAR sem_t *sem)
+{
+  while (sem_wait(sem) < 0)
+    {
+      int errcode = get_errno();
+
+      DEBUGASSERT(errcode == EINTR);
+      if (errcode != EINTR)
+        {
+          return -errcode;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_run
+ *
+ * Description:
+ *   Run one OS micro-benchmark.  See include/nuttx/bench.h.
+ *
+ ****************************************************************************/
+
+int bench_run(int test, uint32_t nsamples, FAR struct bench_result_s *result)
+{
+  int ret;
+
+  if (test < 0 || test >= BENCH_NTESTS || result == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (nsamples == 0)
+    {
+      nsamples = CONFIG_SCHED_BENCHMARK_NSAMPLES;
+    }
+
+  ret = bench_wait(&g_bench_exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(result, 0, sizeof(struct bench_result_s));
+  result->freq = up_perf_getfreq();
+  result->min  = UINT32_MAX;
+
+  ret = g_benchmarks[test](nsamples, result);
+
+  if (result->nsamples == 0)
+    {
+      result->min = 0;
+    }
+
+  sem_post(&g_bench_exclsem);
+  return ret;
+}
@@ -0,0 +1,258 @@
+/****************************************************************************
+ * sched/bench/bench_sched.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sched.h>
+#include <semaphore.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/bench.h>
+
+#include "bench/bench.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_sched_s
+{
+  uint32_t nsamples;                  /* Number of samples to take */
+  FAR struct bench_result_s *result;  /* Where the samples go */
+  volatile uint32_t stamp;            /* Time of the last yield or post */
+  volatile bool valid;                /* True: stamp has been set */
+  sem_t sem;                          /* Semaphore posted to the waiter */
+  sem_t done;                         /* Posted by each exiting thread */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bench_sched_s g_bench_sched;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ctxswitch_thread
+ *
+ * Description:
+ *   Two of these run at the same priority and yield to each other.  Each
+ *   measures the time from the other's call to sched_yield() to its own
+ *   return from sched_yield().
+ *
+ ****************************************************************************/
+
+static int ctxswitch_thread(int argc, FAR char *argv[])
+{
+  FAR struct bench_sched_s *priv = &g_bench_sched;
+  uint32_t now;
+
+  for (; ; )
+    {
+      now = up_perf_gettime();
+      if (priv->result->nsamples >= priv->nsamples)
+        {
+          break;
+        }
+
+      if (priv->valid)
+        {
+          bench_sample(priv->result, now - priv->stamp);
+        }
+
+      priv->valid = true;
+      priv->stamp = up_perf_gettime();
+      sched_yield();
+    }
+
+  sem_post(&priv->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: semwake_waiter
+ *
+ * Description:
+ *   The higher priority thread.  Measures the time from sem_post() in the
+ *   poster to its own return from sem_wait().
+ *
+ ****************************************************************************/
+
+static int semwake_waiter(int argc, FAR char *argv[])
+{
+  FAR struct bench_sched_s *priv = &g_bench_sched;
+  uint32_t now;
+  uint32_t i;
+
+  for (i = 0; i < priv->nsamples; i++)
+    {
+      if (bench_wait(&priv->sem) < 0)
+        {
+          break;
+        }
+
+      now = up_perf_gettime();
+      bench_sample(priv->result, now - priv->stamp);
+    }
+
+  sem_post(&priv->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: semwake_poster
+ *
+ * Description:
+ *   The lower priority thread.  Each sem_post() immediately switches to the
+ *   waiter, which takes its sample and waits again before the poster runs
+ *   again.
+ *
+ ****************************************************************************/
+
+static int semwake_poster(int argc, FAR char *argv[])
+{
+  FAR struct bench_sched_s *priv = &g_bench_sched;
+  uint32_t i;
+
+  for (i = 0; i < priv->nsamples; i++)
+    {
+      priv->stamp = up_perf_gettime();
+      sem_post(&priv->sem);
+    }
+
+  sem_post(&priv->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_sched_run
+ *
+ * Description:
+ *   Start the two benchmark threads and wait for them to complete.  The
+ *   first thread is started first; if the second cannot be started, the
+ *   first is told to take no samples.
+ *
+ ****************************************************************************/
+
+static int bench_sched_run(uint32_t nsamples,
+                           FAR struct bench_result_s *result,
+                           int prio1, main_t entry1,
+                           int prio2, main_t entry2)
+{
+  FAR struct bench_sched_s *priv = &g_bench_sched;
+  int nthreads = 0;
+  int ret;
+
+  priv->nsamples = nsamples;
+  priv->result   = result;
+  priv->stamp    = 0;
+  priv->valid    = false;
+  sem_init(&priv->sem, 0, 0);
+  sem_init(&priv->done, 0, 0);
+
+  /* Start both threads before either one runs */
+
+  sched_lock();
+  ret = bench_start("bench1", prio1, entry1);
+  if (ret >= 0)
+    {
+      nthreads++;
+      ret = bench_start("bench2", prio2, entry2);
+      if (ret >= 0)
+        {
+          nthreads++;
+        }
+      else
+        {
+          priv->nsamples = 0;
+        }
+    }
+
+  sched_unlock();
+
+  while (nthreads-- > 0)
+    {
+      (void)bench_wait(&priv->done);
+    }
+
+  sem_destroy(&priv->sem);
+  sem_destroy(&priv->done);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_ctxswitch
+ *
+ * Description:
+ *   Context switch latency:  sched_yield() in one thread to the other
+ *   thread of the same priority running.
+ *
+ ****************************************************************************/
+
+int bench_ctxswitch(uint32_t nsamples, FAR struct bench_result_s *result)
+{
+  return bench_sched_run(nsamples, result,
+                         BENCH_PRIORITY_HIGH, ctxswitch_thread,
+                         BENCH_PRIORITY_HIGH, ctxswitch_thread);
+}
+
+/****************************************************************************
+ * Name: bench_semwake
+ *
+ * Description:
+ *   Semaphore post-to-wake latency:  sem_post() in a thread to the higher
+ *   priority thread waiting on the semaphore running.
+ *
+ ****************************************************************************/
+
+int bench_semwake(uint32_t nsamples, FAR struct bench_result_s *result)
+{
+  return bench_sched_run(nsamples, result,
+                         BENCH_PRIORITY_LOW, semwake_poster,
+                         BENCH_PRIORITY_HIGH, semwake_waiter);
+}
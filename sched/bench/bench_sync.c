@@ -0,0 +1,403 @@
+/****************************************************************************
+ * sched/bench/bench_sync.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <pthread.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/bench.h>
+
+#include "bench/bench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_MQREQUEST   "bench_req"
+#define BENCH_MQRESPONSE  "bench_rsp"
+#define BENCH_MQSTOP      UINT32_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_sync_s
+{
+  uint32_t nsamples;                  /* Number of samples to take */
+  FAR struct bench_result_s *result;  /* Where the samples go */
+  volatile uint32_t stamp;            /* Time of the mutex unlock */
+#ifndef CONFIG_DISABLE_PTHREAD
+  pthread_mutex_t mutex;              /* The contended mutex */
+#endif
+  sem_t go;                           /* Posted by the mutex holder */
+  sem_t done;                         /* Posted by each exiting thread */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bench_sync_s g_bench_sync;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mqroundtrip_server
+ *
+ * Description:
+ *   Return each request as the response until the stop request is
+ *   received.  Message queue descriptors are private to each task so both
+ *   threads open the queues by name.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+static int mqroundtrip_server(int argc, FAR char *argv[])
+{
+  FAR struct bench_sync_s *priv = &g_bench_sync;
+  uint32_t msg;
+  mqd_t req;
+  mqd_t rsp;
+
+  req = mq_open(BENCH_MQREQUEST, O_RDONLY);
+  rsp = mq_open(BENCH_MQRESPONSE, O_WRONLY);
+
+  if (req != (mqd_t)ERROR && rsp != (mqd_t)ERROR)
+    {
+      while (mq_receive(req, (FAR char *)&msg, sizeof(msg), NULL) >= 0 &&
+             msg != BENCH_MQSTOP)
+        {
+          (void)mq_send(rsp, (FAR const char *)&msg, sizeof(msg), 0);
+        }
+    }
+
+  if (req != (mqd_t)ERROR)
+    {
+      (void)mq_close(req);
+    }
+
+  if (rsp != (mqd_t)ERROR)
+    {
+      (void)mq_close(rsp);
+    }
+
+  sem_post(&priv->done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: mqroundtrip_client
+ *
+ * Description:
+ *   Measure the time from mq_send() of a request until mq_receive() returns
+ *   the response, then stop the server.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+static int mqroundtrip_client(int argc, FAR char *argv[])
+{
+  FAR struct bench_sync_s *priv = &g_bench_sync;
+  uint32_t start;
+  uint32_t msg;
+  uint32_t i;
+  mqd_t req;
+  mqd_t rsp;
+
+  req = mq_open(BENCH_MQREQUEST, O_WRONLY);
+  rsp = mq_open(BENCH_MQRESPONSE, O_RDONLY);
+
+  if (req != (mqd_t)ERROR && rsp != (mqd_t)ERROR)
+    {
+      for (i = 0; i < priv->nsamples; i++)
+        {
+          start = up_perf_gettime();
+          msg   = i;
+
+          if (mq_send(req, (FAR const char *)&msg, sizeof(msg), 0) < 0 ||
+              mq_receive(rsp, (FAR char *)&msg, sizeof(msg), NULL) < 0)
+            {
+              break;
+            }
+
+          bench_sample(priv->result, up_perf_gettime() - start);
+        }
+    }
+
+  if (req != (mqd_t)ERROR)
+    {
+      (void)mq_close(req);
+    }
+
+  if (rsp != (mqd_t)ERROR)
+    {
+      (void)mq_close(rsp);
+    }
+
+  sem_post(&priv->done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: mutex_waiter
+ *
+ * Description:
+ *   The higher priority thread.  Blocks on the mutex held by the holder and
+ *   measures the time from pthread_mutex_unlock() in the holder to its own
+ *   return from pthread_mutex_lock().
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PTHREAD
+static int mutex_waiter(int argc, FAR char *argv[])
+{
+  FAR struct bench_sync_s *priv = &g_bench_sync;
+  uint32_t now;
+  uint32_t i;
+
+  for (i = 0; i < priv->nsamples; i++)
+    {
+      if (bench_wait(&priv->go) < 0 ||
+          pthread_mutex_lock(&priv->mutex) != 0)
+        {
+          break;
+        }
+
+      now = up_perf_gettime();
+      bench_sample(priv->result, now - priv->stamp);
+      pthread_mutex_unlock(&priv->mutex);
+    }
+
+  sem_post(&priv->done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: mutex_holder
+ *
+ * Description:
+ *   The lower priority thread.  Takes the mutex, wakes the waiter (which
+ *   then blocks on the mutex) and releases the mutex.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PTHREAD
+static int mutex_holder(int argc, FAR char *argv[])
+{
+  FAR struct bench_sync_s *priv = &g_bench_sync;
+  uint32_t i;
+
+  for (i = 0; i < priv->nsamples; i++)
+    {
+      if (pthread_mutex_lock(&priv->mutex) != 0)
+        {
+          break;
+        }
+
+      sem_post(&priv->go);
+
+      priv->stamp = up_perf_gettime();
+      pthread_mutex_unlock(&priv->mutex);
+    }
+
+  sem_post(&priv->done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_mqroundtrip
+ *
+ * Description:
+ *   Message queue round trip:  mq_send() of a request to a server thread of
+ *   the same priority until mq_receive() of its response.
+ *
+ ****************************************************************************/
+
+int bench_mqroundtrip(uint32_t nsamples, FAR struct bench_result_s *result)
+{
+#ifndef CONFIG_DISABLE_MQUEUE
+  FAR struct bench_sync_s *priv = &g_bench_sync;
+  struct mq_attr attr;
+  uint32_t msg = BENCH_MQSTOP;
+  mqd_t req;
+  mqd_t rsp;
+  int ret;
+
+  priv->nsamples = nsamples;
+  priv->result   = result;
+  sem_init(&priv->done, 0, 0);
+
+  /* Create the queues.  This descriptor of the request queue is used to
+   * stop the server if the client cannot be started.
+   */
+
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = sizeof(uint32_t);
+  attr.mq_flags   = 0;
+
+  req = mq_open(BENCH_MQREQUEST, O_WRONLY | O_CREAT, 0666, &attr);
+  if (req == (mqd_t)ERROR)
+    {
+      ret = -get_errno();
+      goto errout_with_sem;
+    }
+
+  rsp = mq_open(BENCH_MQRESPONSE, O_RDONLY | O_CREAT, 0666, &attr);
+  if (rsp == (mqd_t)ERROR)
+    {
+      ret = -get_errno();
+      goto errout_with_req;
+    }
+
+  sched_lock();
+  ret = bench_start("bench_server", BENCH_PRIORITY_HIGH,
+                    mqroundtrip_server);
+  if (ret >= 0)
+    {
+      ret = bench_start("bench_client", BENCH_PRIORITY_HIGH,
+                        mqroundtrip_client);
+      if (ret < 0)
+        {
+          (void)mq_send(req, (FAR const char *)&msg, sizeof(msg), 0);
+          sched_unlock();
+          (void)bench_wait(&priv->done);
+        }
+      else
+        {
+          /* Wait for the client, then stop the server */
+
+          sched_unlock();
+          (void)bench_wait(&priv->done);
+          (void)mq_send(req, (FAR const char *)&msg, sizeof(msg), 0);
+          (void)bench_wait(&priv->done);
+          ret = OK;
+        }
+    }
+  else
+    {
+      sched_unlock();
+    }
+
+  (void)mq_close(rsp);
+  (void)mq_unlink(BENCH_MQRESPONSE);
+
+errout_with_req:
+  (void)mq_close(req);
+  (void)mq_unlink(BENCH_MQREQUEST);
+
+errout_with_sem:
+  sem_destroy(&priv->done);
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: bench_mutex
+ *
+ * Description:
+ *   Mutex hand-off under contention:  pthread_mutex_unlock() in one thread
+ *   to the higher priority thread blocked in pthread_mutex_lock() running.
+ *
+ ****************************************************************************/
+
+int bench_mutex(uint32_t nsamples, FAR struct bench_result_s *result)
+{
+#ifndef CONFIG_DISABLE_PTHREAD
+  FAR struct bench_sync_s *priv = &g_bench_sync;
+  int nthreads = 0;
+  int ret;
+
+  priv->nsamples = nsamples;
+  priv->result   = result;
+  priv->stamp    = 0;
+  pthread_mutex_init(&priv->mutex, NULL);
+  sem_init(&priv->go, 0, 0);
+  sem_init(&priv->done, 0, 0);
+
+  sched_lock();
+  ret = bench_start("bench_holder", BENCH_PRIORITY_LOW, mutex_holder);
+  if (ret >= 0)
+    {
+      nthreads++;
+      ret = bench_start("bench_waiter", BENCH_PRIORITY_HIGH, mutex_waiter);
+      if (ret >= 0)
+        {
+          nthreads++;
+        }
+      else
+        {
+          priv->nsamples = 0;
+        }
+    }
+
+  sched_unlock();
+
+  while (nthreads-- > 0)
+    {
+      (void)bench_wait(&priv->done);
+    }
+
+  sem_destroy(&priv->go);
+  sem_destroy(&priv->done);
+  pthread_mutex_destroy(&priv->mutex);
+  return ret < 0 ? ret : OK;
+#else
+  return -ENOSYS;
+#endif
+}
@@ -0,0 +1,281 @@
+/****************************************************************************
+ * sched/bench/bench_timer.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/bench.h>
+
+#include "bench/bench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The work queue used by the work queue benchmark */
+
+#if defined(CONFIG_SCHED_HPWORK)
+#  define BENCH_WORK HPWORK
+#elif defined(CONFIG_SCHED_LPWORK)
+#  define BENCH_WORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_timer_s
+{
+  uint32_t nsamples;                  /* Number of samples to take */
+  FAR struct bench_result_s *result;  /* Where the samples go */
+  volatile uint32_t stamp;            /* Time of the last event */
+  uint32_t period;                    /* Expected period (timer jitter) */
+  bool valid;                         /* True: stamp has been set */
+  WDOG_ID wdog;                       /* The timer jitter watchdog */
+#ifdef BENCH_WORK
+  struct work_s work;                 /* The work queue benchmark work */
+#endif
+  sem_t done;                         /* Posted by the worker or timer */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bench_timer_s g_bench_timer;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wdog_expiry
+ *
+ * Description:
+ *   The watchdog benchmark never lets the watchdog expire.
+ *
+ ****************************************************************************/
+
+static void wdog_expiry(int argc, wdparm_t arg1, ...)
+{
+}
+
+/****************************************************************************
+ * Name: workqueue_worker
+ ****************************************************************************/
+
+#ifdef BENCH_WORK
+static void workqueue_worker(FAR void *arg)
+{
+  FAR struct bench_timer_s *priv = (FAR struct bench_timer_s *)arg;
+
+  bench_sample(priv->result, up_perf_gettime() - priv->stamp);
+  sem_post(&priv->done);
+}
+#endif
+
+/****************************************************************************
+ * Name: timerjitter_expiry
+ *
+ * Description:
+ *   Runs from the timer interrupt every tick.  Samples the deviation of the
+ *   time since the previous expiry from one tick and restarts the
+ *   watchdog until enough samples have been taken.
+ *
+ ****************************************************************************/
+
+static void timerjitter_expiry(int argc, wdparm_t arg1, ...)
+{
+  FAR struct bench_timer_s *priv = &g_bench_timer;
+  uint32_t now = up_perf_gettime();
+  uint32_t elapsed;
+
+  if (priv->valid)
+    {
+      elapsed = now - priv->stamp;
+      bench_sample(priv->result, elapsed > priv->period ?
+                   elapsed - priv->period : priv->period - elapsed);
+    }
+
+  priv->valid = true;
+  priv->stamp = now;
+
+  if (priv->result->nsamples < priv->nsamples)
+    {
+      (void)wd_start(priv->wdog, 1, timerjitter_expiry, 0);
+    }
+  else
+    {
+      sem_post(&priv->done);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_wdog
+ *
+ * Description:
+ *   Watchdog cost:  One wd_start() and wd_cancel() pair.
+ *
+ ****************************************************************************/
+
+int bench_wdog(uint32_t nsamples, FAR struct bench_result_s *result)
+{
+  uint32_t start;
+  uint32_t i;
+  WDOG_ID wdog;
+
+  wdog = wd_create();
+  if (wdog == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nsamples; i++)
+    {
+      start = up_perf_gettime();
+      (void)wd_start(wdog, SEC2TICK(60), wdog_expiry, 0);
+      (void)wd_cancel(wdog);
+      bench_sample(result, up_perf_gettime() - start);
+    }
+
+  (void)wd_delete(wdog);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_workqueue
+ *
+ * Description:
+ *   Work queue dispatch latency:  work_queue() of work with no delay to the
+ *   worker running.  The high priority work queue is used if it is
+ *   enabled.
+ *
+ ****************************************************************************/
+
+int bench_workqueue(uint32_t nsamples, FAR struct bench_result_s *result)
+{
+#ifdef BENCH_WORK
+  FAR struct bench_timer_s *priv = &g_bench_timer;
+  uint32_t i;
+  int ret = OK;
+
+  priv->result = result;
+  sem_init(&priv->done, 0, 0);
+
+  for (i = 0; i < nsamples; i++)
+    {
+      priv->stamp = up_perf_gettime();
+      ret = work_queue(BENCH_WORK, &priv->work, workqueue_worker, priv, 0);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = bench_wait(&priv->done);
+      if (ret < 0)
+        {
+          (void)work_cancel(BENCH_WORK, &priv->work);
+          break;
+        }
+    }
+
+  sem_destroy(&priv->done);
+  return ret;
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: bench_timerjitter
+ *
+ * Description:
+ *   Timer interrupt jitter:  The deviation from one tick of the time
+ *   between the expiries of a watchdog restarted every tick.
+ *
+ ****************************************************************************/
+
+int bench_timerjitter(uint32_t nsamples, FAR struct bench_result_s *result)
+{
+  FAR struct bench_timer_s *priv = &g_bench_timer;
+  int ret;
+
+  priv->nsamples = nsamples;
+  priv->result   = result;
+  priv->period   = (uint32_t)((uint64_t)result->freq * USEC_PER_TICK /
+                              USEC_PER_SEC);
+  priv->valid    = false;
+  sem_init(&priv->done, 0, 0);
+
+  priv->wdog = wd_create();
+  if (priv->wdog == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_sem;
+    }
+
+  ret = wd_start(priv->wdog, 1, timerjitter_expiry, 0);
+  if (ret < 0)
+    {
+      ret = -get_errno();
+    }
+  else
+    {
+      ret = bench_wait(&priv->done);
+    }
+
+  (void)wd_cancel(priv->wdog);
+  (void)wd_delete(priv->wdog);
+
+errout_with_sem:
+  sem_destroy(&priv->done);
+  return ret;
+}
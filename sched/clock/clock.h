@@ -59,6 +59,14 @@
 #  undef CONFIG_SYSTEM_TIME64
 #endif
 
+/* The cycle counter clocksource needs 64-bit arithmetic and is not safe
+ * for concurrent readers and writers on different CPUs.
+ */
+
+#if !defined(CONFIG_HAVE_LONG_LONG) || defined(CONFIG_SMP)
+#  undef CONFIG_CLOCK_CLOCKSOURCE
+#endif
+
 /********************************************************************************
  * Public Type Definitions
  ********************************************************************************/
@@ -89,6 +97,13 @@ void weak_function clock_initialize(void);
 #ifndef CONFIG_SCHED_TICKLESS
 void weak_function clock_timer(void);
 #endif
+#ifdef CONFIG_CLOCK_ADJTIME
+void clock_adjtime_tick(void);
+#endif
+#ifdef CONFIG_CLOCK_CLOCKSOURCE
+void clock_clocksource_initialize(void);
+int  clock_clocksource_gettime(FAR struct timespec *ts);
+#endif
 
 int  clock_abstime2ticks(clockid_t clockid,
                          FAR const struct timespec *abstime,
@@ -0,0 +1,329 @@
+/****************************************************************************
+ * sched/clock/clock_adjtime.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/timex.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_ADJTIME
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_HAVE_LONG_LONG
+#  error CONFIG_CLOCK_ADJTIME requires CONFIG_HAVE_LONG_LONG
+#endif
+
+/* Limits of the adjustments */
+
+#define ADJTIME_MAXFREQ    500000      /* Frequency offset (ppb) */
+#define ADJTIME_MAXOFFSET  500000000   /* Slew offset (nsec) */
+
+/* The clock is slewed by at most 500 ppm, i.e. this much per tick */
+
+#define ADJTIME_MAXSLEW    (NSEC_PER_TICK / 2000)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int32_t g_adjtime_freq;   /* Frequency offset (ppb) */
+static int64_t g_adjtime_offset; /* Slew still to be applied (nsec) */
+static int64_t g_adjtime_frac;   /* Fraction of a nsec (in 1e-9 nsec) */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_adjbase
+ *
+ * Description:
+ *   Move the base time by 'delta' nanoseconds (less than one second).
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void clock_adjbase(int32_t delta)
+{
+  int32_t nsec = (int32_t)g_basetime.tv_nsec + delta;
+
+  if (nsec < 0)
+    {
+      nsec += NSEC_PER_SEC;
+      g_basetime.tv_sec--;
+    }
+  else if (nsec >= NSEC_PER_SEC)
+    {
+      nsec -= NSEC_PER_SEC;
+      g_basetime.tv_sec++;
+    }
+
+  g_basetime.tv_nsec = nsec;
+}
+
+/****************************************************************************
+ * Name: clock_adjstep
+ *
+ * Description:
+ *   Step CLOCK_REALTIME by 'sec' seconds and 'nsec' (0..NSEC_PER_SEC-1)
+ *   nanoseconds.  A negative step has a negative 'sec'.
+ *
+ ****************************************************************************/
+
+static int clock_adjstep(int32_t sec, int32_t nsec)
+{
+  struct timespec ts;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+
+  ret = clock_gettime(CLOCK_REALTIME, &ts);
+  if (ret == OK)
+    {
+      ts.tv_sec  += sec;
+      ts.tv_nsec += nsec;
+      if (ts.tv_nsec >= NSEC_PER_SEC)
+        {
+          ts.tv_nsec -= NSEC_PER_SEC;
+          ts.tv_sec++;
+        }
+
+      ret = clock_settime(CLOCK_REALTIME, &ts);
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_adjtime_tick
+ *
+ * Description:
+ *   Apply the frequency offset and the slew to the base time.  Called
+ *   from clock_timer() on each system timer tick, before the time is
+ *   published.
+ *
+ ****************************************************************************/
+
+void clock_adjtime_tick(void)
+{
+  int64_t delta;
+  int32_t slew;
+
+  if (g_adjtime_freq == 0 && g_adjtime_offset == 0)
+    {
+      return;
+    }
+
+  /* The frequency offset over one tick, keeping the fraction of a
+   * nanosecond for the next tick.
+   */
+
+  g_adjtime_frac += (int64_t)NSEC_PER_TICK * g_adjtime_freq;
+  delta           = g_adjtime_frac / NSEC_PER_SEC;
+  g_adjtime_frac -= delta * NSEC_PER_SEC;
+
+  /* Plus a part of the remaining slew */
+
+  if (g_adjtime_offset != 0)
+    {
+      if (g_adjtime_offset > ADJTIME_MAXSLEW)
+        {
+          slew = ADJTIME_MAXSLEW;
+        }
+      else if (g_adjtime_offset < -ADJTIME_MAXSLEW)
+        {
+          slew = -ADJTIME_MAXSLEW;
+        }
+      else
+        {
+          slew = (int32_t)g_adjtime_offset;
+        }
+
+      g_adjtime_offset -= slew;
+      delta            += slew;
+    }
+
+  if (delta != 0)
+    {
+      clock_adjbase((int32_t)delta);
+    }
+}
+
+/****************************************************************************
+ * Name: clock_adjtime
+ *
+ * Description:
+ *   Adjust CLOCK_REALTIME and return its state:
+ *
+ *   ADJ_FREQUENCY - Run the clock 'freq' (ppm with a 16 bit fraction)
+ *     faster or slower.  This is what a PTP or NTP servo normally adjusts.
+ *   ADJ_OFFSET - Slew the clock gradually (at 500 ppm) by 'offset'
+ *     microseconds (nanoseconds with ADJ_NANO).
+ *   ADJ_SETOFFSET - Step the clock by 'time'.  A negative step has a
+ *     negative tv_sec and a positive tv_usec.
+ *
+ *   On return, 'offset' holds the slew still to be applied, 'freq' the
+ *   frequency offset and 'time' the current time.
+ *
+ * Input Parameters:
+ *   clk_id - The clock.  Only CLOCK_REALTIME is supported.
+ *   buf    - The adjustment
+ *
+ * Returned Value:
+ *   TIME_OK on success.  On failure, -1 (ERROR) is returned and errno is
+ *   set appropriately.
+ *
+ ****************************************************************************/
+
+int clock_adjtime(clockid_t clk_id, FAR struct timex *buf)
+{
+  struct timespec ts;
+  irqstate_t flags;
+  int64_t offset;
+  int32_t sec;
+  int32_t nsec;
+  int32_t unit;
+  int errcode;
+
+  if (clk_id != CLOCK_REALTIME || buf == NULL)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+  unit = (buf->modes & ADJ_NANO) != 0 ? 1 : NSEC_PER_USEC;
+
+  if ((buf->modes & ADJ_SETOFFSET) != 0)
+    {
+      sec  = (int32_t)buf->time.tv_sec;
+      nsec = buf->time.tv_usec * unit;
+      if (buf->time.tv_usec < 0 || nsec >= NSEC_PER_SEC)
+        {
+          errcode = EINVAL;
+          goto errout;
+        }
+
+      if (clock_adjstep(sec, nsec) < 0)
+        {
+          errcode = get_errno();
+          goto errout;
+        }
+    }
+
+  flags = enter_critical_section();
+
+  if ((buf->modes & ADJ_FREQUENCY) != 0)
+    {
+      /* Convert from ppm with a 16 bit fraction to ppb */
+
+      offset = ((int64_t)buf->freq * 1000) >> 16;
+      if (offset > ADJTIME_MAXFREQ)
+        {
+          offset = ADJTIME_MAXFREQ;
+        }
+      else if (offset < -ADJTIME_MAXFREQ)
+        {
+          offset = -ADJTIME_MAXFREQ;
+        }
+
+      g_adjtime_freq = (int32_t)offset;
+    }
+
+  if ((buf->modes & ADJ_OFFSET) != 0)
+    {
+      offset = (int64_t)buf->offset * unit;
+      if (offset > ADJTIME_MAXOFFSET)
+        {
+          offset = ADJTIME_MAXOFFSET;
+        }
+      else if (offset < -ADJTIME_MAXOFFSET)
+        {
+          offset = -ADJTIME_MAXOFFSET;
+        }
+
+      g_adjtime_offset = offset;
+    }
+
+  /* Return the current state */
+
+  buf->offset    = (long)(g_adjtime_offset / unit);
+  buf->freq      = (long)(((int64_t)g_adjtime_freq << 16) / 1000);
+
+  leave_critical_section(flags);
+
+  buf->maxerror  = 0;
+  buf->esterror  = 0;
+  buf->status    = 0;
+  buf->constant  = 0;
+  buf->precision = USEC_PER_TICK;
+  buf->tolerance = (long)(((int64_t)ADJTIME_MAXFREQ << 16) / 1000);
+  buf->tick      = USEC_PER_TICK;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  buf->time.tv_sec  = ts.tv_sec;
+  buf->time.tv_usec = ts.tv_nsec / unit;
+
+  sinfo("freq=%ld ppb offset=%ld\n", (long)g_adjtime_freq, buf->offset);
+  return TIME_OK;
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
+
+#endif /* CONFIG_CLOCK_ADJTIME */
@@ -0,0 +1,293 @@
+/****************************************************************************
+ * sched/clock/clock_clocksource.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_CLOCK_CLOCKSOURCE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Only the compiler must be kept from re-ordering the accesses to the
+ * clocksource state:  The writer runs in the watchdog interrupt handler on
+ * the same CPU as the readers.
+ */
+
+#ifdef __GNUC__
+#  define CLOCKSOURCE_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#else
+#  define CLOCKSOURCE_BARRIER()
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The time at the last update is kept as seconds plus nanoseconds plus a
+ * binary fraction of a nanosecond, so that neither readers nor the writer
+ * need a 64-bit division and the conversion does not lose time across
+ * updates.
+ *
+ * The fields are protected by a sequence count:  The writer makes the
+ * count odd before it modifies them and even again afterward.  A count of
+ * zero means that the clocksource has not been started.
+ */
+
+struct clocksource_s
+{
+  volatile uint32_t seq;        /* Sequence count */
+  volatile uint32_t cycle;      /* Counter value at the last update */
+  volatile time_t sec;          /* Seconds since power up at 'cycle' */
+  volatile uint32_t nsec;       /* Nanoseconds since power up at 'cycle' */
+  volatile uint32_t frac;       /* Fraction of a nanosecond, << shift */
+  uint32_t mult;                /* ns = (cycles * mult) >> shift */
+  uint8_t shift;
+  int32_t period;               /* Update period in clock ticks */
+  WDOG_ID wdog;                 /* Watchdog that performs the updates */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct clocksource_s g_clocksource;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_clocksource_timeout
+ *
+ * Description:
+ *   Fold the counts elapsed since the last update into the base time and
+ *   restart the watchdog.
+ *
+ * Assumptions:
+ *   Called from the watchdog interrupt handler.
+ *
+ ****************************************************************************/
+
+static void clock_clocksource_timeout(int argc, wdparm_t arg1, ...)
+{
+  FAR struct clocksource_s *cs = &g_clocksource;
+  uint64_t scaled;
+  uint32_t cycle;
+  uint32_t nsec;
+
+  cycle  = up_perf_gettime();
+  scaled = (uint64_t)(cycle - cs->cycle) * cs->mult + cs->frac;
+  nsec   = cs->nsec + (uint32_t)(scaled >> cs->shift);
+
+  cs->seq++;
+  CLOCKSOURCE_BARRIER();
+
+  cs->cycle = cycle;
+  cs->frac  = (uint32_t)scaled & ((1ul << cs->shift) - 1);
+
+  while (nsec >= NSEC_PER_SEC)
+    {
+      nsec -= NSEC_PER_SEC;
+      cs->sec++;
+    }
+
+  cs->nsec = nsec;
+
+  CLOCKSOURCE_BARRIER();
+  cs->seq++;
+
+  (void)wd_start(cs->wdog, cs->period, clock_clocksource_timeout, 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_clocksource_initialize
+ *
+ * Description:
+ *   Compute the conversion from counts to nanoseconds, anchor the counter
+ *   to the current system time and start the periodic updates.  After
+ *   this, clock_systimespec() and clock_gettime() read the time from the
+ *   counter.
+ *
+ * Assumptions:
+ *   Called once from os_start() after up_initialize() has started the
+ *   counter.
+ *
+ ****************************************************************************/
+
+void clock_clocksource_initialize(void)
+{
+  FAR struct clocksource_s *cs = &g_clocksource;
+  struct timespec ts;
+  uint64_t mult = 0;
+  uint64_t period;
+  uint32_t freq;
+  int shift;
+
+  freq = up_perf_getfreq();
+  DEBUGASSERT(freq > 0 && cs->seq == 0);
+
+  /* Use the largest shift for which the multiplier still fits in 32 bits,
+   * so that (cycles * mult) cannot overflow 64 bits.
+   */
+
+  for (shift = 31; shift > 0; shift--)
+    {
+      mult = ((uint64_t)NSEC_PER_SEC << shift) / freq;
+      if (mult <= UINT32_MAX)
+        {
+          break;
+        }
+    }
+
+  cs->mult  = (uint32_t)mult;
+  cs->shift = shift;
+
+  /* Update at least once a second, so that the nanoseconds accumulated by
+   * a reader fit in 32 bits, and at least twice per wrap of the counter.
+   */
+
+  period = ((uint64_t)1 << 31) * TICK_PER_SEC / freq;
+  if (period > TICK_PER_SEC)
+    {
+      period = TICK_PER_SEC;
+    }
+
+  cs->period = period > 0 ? (int32_t)period : 1;
+  cs->wdog   = wd_create();
+  if (cs->wdog == NULL)
+    {
+      serr("ERROR: Failed to create the clocksource watchdog\n");
+      return;
+    }
+
+  /* Anchor the counter to the system time.  clock_systimespec() still
+   * reads the system timer because the sequence count is zero.
+   */
+
+  (void)clock_systimespec(&ts);
+
+  cs->cycle = up_perf_gettime();
+  cs->sec   = ts.tv_sec;
+  cs->nsec  = ts.tv_nsec;
+  cs->frac  = 0;
+
+  CLOCKSOURCE_BARRIER();
+  cs->seq   = 2;
+
+  sinfo("freq=%lu mult=%lu shift=%d period=%ld\n",
+        (unsigned long)freq, (unsigned long)cs->mult, shift,
+        (long)cs->period);
+
+  (void)wd_start(cs->wdog, cs->period, clock_clocksource_timeout, 0);
+}
+
+/****************************************************************************
+ * Name: clock_clocksource_gettime
+ *
+ * Description:
+ *   Return the time since power up, computed from the counter.  No lock
+ *   is taken.
+ *
+ * Parameters:
+ *   ts - Location to return the time
+ *
+ * Return Value:
+ *   OK on success; -EAGAIN if the clocksource has not been started yet.
+ *
+ ****************************************************************************/
+
+int clock_clocksource_gettime(FAR struct timespec *ts)
+{
+  FAR struct clocksource_s *cs = &g_clocksource;
+  uint64_t scaled;
+  uint32_t seq;
+  uint32_t cycle;
+  uint32_t nsec;
+  time_t sec;
+
+  do
+    {
+      seq = cs->seq;
+      if (seq == 0)
+        {
+          return -EAGAIN;
+        }
+
+      CLOCKSOURCE_BARRIER();
+
+      cycle  = up_perf_gettime();
+      scaled = (uint64_t)(cycle - cs->cycle) * cs->mult + cs->frac;
+      sec    = cs->sec;
+      nsec   = cs->nsec;
+
+      CLOCKSOURCE_BARRIER();
+    }
+  while ((seq & 1) != 0 || seq != cs->seq);
+
+  nsec += (uint32_t)(scaled >> cs->shift);
+  while (nsec >= NSEC_PER_SEC)
+    {
+      nsec -= NSEC_PER_SEC;
+      sec++;
+    }
+
+  ts->tv_sec  = sec;
+  ts->tv_nsec = nsec;
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_CLOCKSOURCE */
@@ -90,7 +90,7 @@ int clock_gettime(clockid_t clock_id, struct timespec *tp)
        * reset.
        */
 
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_SCHED_TICKLESS) && !defined(CONFIG_CLOCK_CLOCKSOURCE)
       ret = up_timer_gettime(tp);
 #else
       ret = clock_systimespec(tp);
@@ -52,6 +52,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/time.h>
+#include <nuttx/vdso.h>
 
 #include "clock/clock.h"
 
@@ -176,6 +177,7 @@ static void clock_inittime(void)
 #ifndef CONFIG_SCHED_TICKLESS
   g_system_timer = 0;
 #endif
+  sched_vdso_clock();
 }
 
 /****************************************************************************
@@ -262,5 +264,9 @@ void clock_timer(void)
   /* Increment the per-tick system counter */
 
   g_system_timer++;
+#ifdef CONFIG_CLOCK_ADJTIME
+  clock_adjtime_tick();
+#endif
+  sched_vdso_clock();
 }
 #endif
@@ -46,6 +46,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
+#include <nuttx/vdso.h>
 
 #include "clock/clock.h"
 
@@ -109,6 +110,7 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 
       g_basetime.tv_nsec -= bias.tv_nsec;
       g_basetime.tv_sec  -= bias.tv_sec;
+      sched_vdso_clock();
 
       /* Setup the RTC (lo- or high-res) */
 
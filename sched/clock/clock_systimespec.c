@@ -71,6 +71,15 @@
 
 int clock_systimespec(FAR struct timespec *ts)
 {
+#ifdef CONFIG_CLOCK_CLOCKSOURCE
+  /* Use the cycle counter clocksource once it has been started */
+
+  if (clock_clocksource_gettime(ts) == OK)
+    {
+      return OK;
+    }
+
+#endif
 #ifdef CONFIG_RTC_HIRES
   /* Do we have a high-resolution RTC that can provide us with the time? */
 
@@ -46,6 +46,7 @@
 #include <string.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 
 #include "sched/sched.h"
@@ -94,6 +95,21 @@ int env_dup(FAR struct task_group_s *group)
 
   if (ptcb->group && ptcb->group->tg_envp)
     {
+#ifdef CONFIG_ENVIRON_COW
+      irqstate_t flags;
+
+      /* Yes.. share it until one of the groups modifies it */
+
+      UNUSED(envp);
+      UNUSED(envlen);
+
+      flags = enter_critical_section();
+      ENV_CREFS(ptcb->group->tg_envp)++;
+      leave_critical_section(flags);
+
+      group->tg_envsize = ptcb->group->tg_envsize;
+      group->tg_envp    = ptcb->group->tg_envp;
+#else
       /* Yes..The parent task has an environment, duplicate it */
 
       envlen = ptcb->group->tg_envsize;
@@ -108,12 +124,72 @@ int env_dup(FAR struct task_group_s *group)
           group->tg_envp    = envp;
           memcpy(envp, ptcb->group->tg_envp, envlen);
         }
+#endif
     }
 
   sched_unlock();
   return ret;
 }
 
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Give the task group a private copy of its environment if it is shared
+ *   with other task groups.  This must be called before the environment is
+ *   modified.
+ *
+ * Parameters:
+ *   group The task group whose environment will be modified.
+ *
+ * Return Value:
+ *   zero on success; -ENOMEM if the copy could not be allocated.
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.  Pre-emption is disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ENVIRON_COW
+int env_unshare(FAR struct task_group_s *group)
+{
+  FAR char *oldenvp = group->tg_envp;
+  FAR char *newalloc;
+  irqstate_t flags;
+  bool release;
+
+  if (oldenvp == NULL || ENV_CREFS(oldenvp) <= 1)
+    {
+      return OK;
+    }
+
+  newalloc = (FAR char *)kumm_malloc(ENV_HDRSIZE + group->tg_envsize);
+  if (newalloc == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  group->tg_envp = newalloc + ENV_HDRSIZE;
+  ENV_CREFS(group->tg_envp) = 1;
+  memcpy(group->tg_envp, oldenvp, group->tg_envsize);
+
+  /* Drop our reference to the shared copy.  The other groups may have
+   * exited in the meantime, leaving this as the last reference.
+   */
+
+  flags   = enter_critical_section();
+  release = (--ENV_CREFS(oldenvp) == 0);
+  leave_critical_section(flags);
+
+  if (release)
+    {
+      sched_ufree(ENV_ALLOC(oldenvp));
+    }
+
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_DISABLE_ENVIRON */
 
 
@@ -44,6 +44,7 @@
 #include <sched.h>
 #include <errno.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 
 #include "environ/environ.h"
@@ -81,9 +82,25 @@ void env_release(FAR struct task_group_s *group)
 
   if (group->tg_envp)
     {
+#ifdef CONFIG_ENVIRON_COW
+      irqstate_t flags;
+      bool release;
+
+      /* Free the environment unless it is still shared */
+
+      flags   = enter_critical_section();
+      release = (--ENV_CREFS(group->tg_envp) == 0);
+      leave_critical_section(flags);
+
+      if (release)
+        {
+          sched_ufree(ENV_ALLOC(group->tg_envp));
+        }
+#else
       /* Free the environment */
 
       sched_ufree(group->tg_envp);
+#endif
     }
 
   /* In any event, make sure that all environment-related varialbles in the
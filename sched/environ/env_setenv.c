@@ -124,6 +124,14 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
   group = rtcb->group;
   DEBUGASSERT(group);
 
+  /* Get a private copy if the environment is shared with other groups */
+
+  if (env_unshare(group) < 0)
+    {
+      ret = ENOMEM;
+      goto errout_with_lock;
+    }
+
   /* Check if the variable already exists */
 
   if (group->tg_envp && (pvar = env_findvar(group, name)) != NULL)
@@ -157,25 +165,31 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
   if (group->tg_envp)
     {
       newsize = group->tg_envsize + varlen;
-      newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
+      newenvp = (FAR char *)kumm_realloc(ENV_ALLOC(group->tg_envp),
+                                         ENV_HDRSIZE + newsize);
       if (!newenvp)
         {
           ret = ENOMEM;
           goto errout_with_lock;
         }
 
-      pvar = &newenvp[group->tg_envsize];
+      newenvp += ENV_HDRSIZE;
+      pvar     = &newenvp[group->tg_envsize];
     }
   else
     {
       newsize = varlen;
-      newenvp = (FAR char *)kumm_malloc(varlen);
+      newenvp = (FAR char *)kumm_malloc(ENV_HDRSIZE + varlen);
       if (!newenvp)
         {
           ret = ENOMEM;
           goto errout_with_lock;
         }
 
+      newenvp += ENV_HDRSIZE;
+#ifdef CONFIG_ENVIRON_COW
+      ENV_CREFS(newenvp) = 1;
+#endif
       pvar = newenvp;
     }
 
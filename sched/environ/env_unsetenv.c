@@ -87,14 +87,31 @@ int unsetenv(FAR const char *name)
   sched_lock();
   if (group && (pvar = env_findvar(group, name)) != NULL)
     {
-      /* It does!  Remove the name=value pair from the environment. */
+#ifdef CONFIG_ENVIRON_COW
+      /* It does!  Get a private copy if the environment is shared with
+       * other groups.
+       */
+
+      if (env_unshare(group) < 0)
+        {
+          sched_unlock();
+          set_errno(ENOMEM);
+          return ERROR;
+        }
+
+      pvar = env_findvar(group, name);
+      DEBUGASSERT(pvar != NULL);
+#endif
+
+      /* Remove the name=value pair from the environment. */
 
       (void)env_removevar(group, pvar);
 
       /* Reallocate the new environment buffer */
 
       newsize = group->tg_envsize;
-      newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
+      newenvp = (FAR char *)kumm_realloc(ENV_ALLOC(group->tg_envp),
+                                         ENV_HDRSIZE + newsize);
       if (!newenvp)
         {
           set_errno(ENOMEM);
@@ -106,7 +123,7 @@ int unsetenv(FAR const char *name)
            * reallocation.
            */
 
-          group->tg_envp = newenvp;
+          group->tg_envp = newenvp + ENV_HDRSIZE;
         }
     }
 
@@ -52,6 +52,24 @@
 # define env_release(group) (0)
 #else
 
+/* With CONFIG_ENVIRON_COW, the environment strings are preceded in their
+ * allocation by a reference count.  A new task group shares the environment
+ * of its parent and env_unshare() makes a private copy only when one of the
+ * groups is about to modify it.
+ */
+
+#ifdef CONFIG_ENVIRON_COW
+#  define ENV_HDRSIZE        sizeof(size_t)
+#  define ENV_CREFS(envp)    (*(FAR size_t *)((envp) - ENV_HDRSIZE))
+#else
+#  define ENV_HDRSIZE        0
+#  define env_unshare(group) (0)
+#endif
+
+/* The start of the allocation holding the environment strings */
+
+#define ENV_ALLOC(envp)      ((FAR void *)((envp) - ENV_HDRSIZE))
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -73,6 +91,12 @@ extern "C"
 int env_dup(FAR struct task_group_s *group);
 void env_release(FAR struct task_group_s *group);
 
+/* Called before the environment of the group is modified */
+
+#ifdef CONFIG_ENVIRON_COW
+int env_unshare(FAR struct task_group_s *group);
+#endif
+
 /* Functions used internally by the environment handling logic */
 
 FAR char *env_findvar(FAR struct task_group_s *group, FAR const char *pname);
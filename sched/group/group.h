@@ -102,6 +102,10 @@ int  group_bind(FAR struct pthread_tcb_s *tcb);
 int  group_join(FAR struct pthread_tcb_s *tcb);
 #endif
 void group_leave(FAR struct tcb_s *tcb);
+#ifdef CONFIG_SCHED_TCBPOOL
+FAR struct task_group_s *group_poolalloc(void);
+void group_poolfree(FAR struct task_group_s *group);
+#endif
 #if defined(CONFIG_SCHED_WAITPID) && !defined(CONFIG_SCHED_HAVE_PARENT)
 void group_addwaiter(FAR struct task_group_s *group);
 void group_delwaiter(FAR struct task_group_s *group);
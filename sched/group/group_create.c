@@ -182,7 +182,11 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
 
   /* Allocate the group structure and assign it to the TCB */
 
+#ifdef CONFIG_SCHED_TCBPOOL
+  group = group_poolalloc();
+#else
   group = (FAR struct task_group_s *)kmm_zalloc(sizeof(struct task_group_s));
+#endif
   if (!group)
     {
       return -ENOMEM;
@@ -209,7 +213,11 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
 
   if (!group->tg_streamlist)
     {
+#ifdef CONFIG_SCHED_TCBPOOL
+      group_poolfree(group);
+#else
       kmm_free(group);
+#endif
       return -ENOMEM;
     }
 
@@ -236,7 +244,11 @@ int group_allocate(FAR struct task_tcb_s *tcb, uint8_t ttype)
     defined(CONFIG_BUILD_KERNEL)) && defined(CONFIG_MM_KERNEL_HEAP)
       group_free(group, group->tg_streamlist);
 #endif
+#ifdef CONFIG_SCHED_TCBPOOL
+      group_poolfree(group);
+#else
       kmm_free(group);
+#endif
       tcb->cmn.group = NULL;
       return ret;
     }
@@ -282,25 +294,30 @@ int group_initialize(FAR struct task_tcb_s *tcb)
   group = tcb->cmn.group;
 
 #ifdef HAVE_GROUP_MEMBERS
-  /* Allocate space to hold GROUP_INITIAL_MEMBERS members of the group */
+  /* Allocate space to hold GROUP_INITIAL_MEMBERS members of the group
+   * (unless a pooled group still has its members array).
+   */
 
-  group->tg_members = (FAR pid_t *)kmm_malloc(GROUP_INITIAL_MEMBERS*sizeof(pid_t));
-  if (!group->tg_members)
+  if (group->tg_members == NULL)
     {
-      kmm_free(group);
-      return -ENOMEM;
+      group->tg_members = (FAR pid_t *)kmm_malloc(GROUP_INITIAL_MEMBERS*sizeof(pid_t));
+      if (!group->tg_members)
+        {
+          kmm_free(group);
+          return -ENOMEM;
+        }
+
+      /* Initialize the non-zero elements of group structure and assign it
+       * to the tcb.
+       */
+
+      group->tg_mxmembers  = GROUP_INITIAL_MEMBERS; /* Number of members in allocation */
     }
 
   /* Assign the PID of this new task as a member of the group. */
 
   group->tg_members[0] = tcb->cmn.pid;
 
-  /* Initialize the non-zero elements of group structure and assign it to
-   * the tcb.
-   */
-
-  group->tg_mxmembers  = GROUP_INITIAL_MEMBERS; /* Number of members in allocation */
-
 #endif
 
 #if defined(HAVE_GROUP_MEMBERS) || defined(CONFIG_ARCH_ADDRENV)
@@ -215,8 +215,10 @@ static inline void group_release(FAR struct task_group_s *group)
   group_remove(group);
 #endif
 
-#ifdef HAVE_GROUP_MEMBERS
-  /* Release the members array */
+#if defined(HAVE_GROUP_MEMBERS) && !defined(CONFIG_SCHED_TCBPOOL)
+  /* Release the members array.  With the TCB pool, it is released (or
+   * retained) with the group structure by group_poolfree().
+   */
 
   if (group->tg_members)
     {
@@ -275,7 +277,11 @@ static inline void group_release(FAR struct task_group_s *group)
     {
       /* Release the group container itself */
 
+#ifdef CONFIG_SCHED_TCBPOOL
+      group_poolfree(group);
+#else
       sched_kfree(group);
+#endif
     }
 }
 
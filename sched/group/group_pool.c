@@ -0,0 +1,155 @@
+/****************************************************************************
+ * sched/group/group_pool.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+#include "group/group.h"
+
+#if defined(HAVE_TASK_GROUP) && defined(CONFIG_SCHED_TCBPOOL)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The retained task groups.  Each pooled group still owns its members
+ * array.
+ */
+
+static FAR struct task_group_s *g_grouppool[CONFIG_SCHED_TCBPOOL_NTASKS];
+static uint8_t g_npooled;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: group_poolalloc
+ *
+ * Description:
+ *   Allocate a zeroed task group structure, re-using a pooled one if there
+ *   is one.  A pooled group is returned with its members array (but no
+ *   members) still attached.
+ *
+ * Returned Value:
+ *   The new group or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct task_group_s *group_poolalloc(void)
+{
+  FAR struct task_group_s *group;
+#ifdef HAVE_GROUP_MEMBERS
+  FAR pid_t *members;
+  uint8_t mxmembers;
+#endif
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  group = NULL;
+  if (g_npooled > 0)
+    {
+      group = g_grouppool[--g_npooled];
+    }
+
+  leave_critical_section(flags);
+
+  if (group == NULL)
+    {
+      return (FAR struct task_group_s *)
+        kmm_zalloc(sizeof(struct task_group_s));
+    }
+
+#ifdef HAVE_GROUP_MEMBERS
+  members   = group->tg_members;
+  mxmembers = group->tg_mxmembers;
+#endif
+
+  memset(group, 0, sizeof(struct task_group_s));
+
+#ifdef HAVE_GROUP_MEMBERS
+  group->tg_members   = members;
+  group->tg_mxmembers = mxmembers;
+#endif
+
+  return group;
+}
+
+/****************************************************************************
+ * Name: group_poolfree
+ *
+ * Description:
+ *   Called in place of freeing the group structure after all other group
+ *   resources have been released.  Retain the group (and its members
+ *   array) in the pool if there is room.  Otherwise free it.
+ *
+ ****************************************************************************/
+
+void group_poolfree(FAR struct task_group_s *group)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (g_npooled < CONFIG_SCHED_TCBPOOL_NTASKS)
+    {
+      g_grouppool[g_npooled++] = group;
+      leave_critical_section(flags);
+      return;
+    }
+
+  leave_critical_section(flags);
+
+#ifdef HAVE_GROUP_MEMBERS
+  if (group->tg_members != NULL)
+    {
+      sched_kfree(group->tg_members);
+    }
+#endif
+
+  sched_kfree(group);
+}
+
+#endif /* HAVE_TASK_GROUP && CONFIG_SCHED_TCBPOOL */
@@ -91,7 +91,11 @@ void group_delwaiter(FAR struct task_group_s *group)
        * freed).
        */
 
+#ifdef CONFIG_SCHED_TCBPOOL
+      group_poolfree(group);
+#else
       sched_kfree(group);
+#endif
     }
 }
 
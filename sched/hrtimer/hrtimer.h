@@ -0,0 +1,124 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer.h
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_HRTIMER_HRTIMER_H
+#define __SCHED_HRTIMER_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/hrtimer.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* True if time 'a' is strictly before time 'b' */
+
+#define HRTIMER_BEFORE(a,b) \
+  ((a)->tv_sec < (b)->tv_sec || \
+   ((a)->tv_sec == (b)->tv_sec && (a)->tv_nsec < (b)->tv_nsec))
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* The list of active high resolution timers, ordered by expiration time */
+
+extern FAR struct hrtimer_s *g_hrtimer_active;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Remove each high resolution timer that has expired at time 'now' from
+ *   the active list and execute its function.
+ *
+ * Input Parameters:
+ *   now - The current time
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the alarm interrupt handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(FAR const struct timespec *now);
+
+/****************************************************************************
+ * Name: hrtimer_next
+ *
+ * Description:
+ *   Return the expiration time of the next high resolution timer to expire
+ *   or NULL if there are no active high resolution timers.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#define hrtimer_next() \
+  (g_hrtimer_active ? &g_hrtimer_active->expiry : NULL)
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __SCHED_HRTIMER_HRTIMER_H */
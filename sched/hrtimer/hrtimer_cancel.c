@@ -0,0 +1,112 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_cancel.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Cancel a high resolution timer.  Nothing happens if the timer is not
+ *   active.
+ *
+ *   The alarm is not reprogrammed if the cancelled timer was the next to
+ *   expire; the alarm interrupt will simply find nothing to do.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) if the timer was cancelled; -EINVAL if it was not active.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *hrtimer)
+{
+  FAR struct hrtimer_s *prev;
+  FAR struct hrtimer_s *curr;
+  irqstate_t flags;
+  int ret = -EINVAL;
+
+  flags = enter_critical_section();
+
+  if (hrtimer != NULL && hrtimer->active)
+    {
+      /* Find the timer in the active list */
+
+      for (prev = NULL, curr = g_hrtimer_active;
+           curr != NULL && curr != hrtimer;
+           prev = curr, curr = curr->flink);
+
+      DEBUGASSERT(curr != NULL);
+
+      /* And remove it */
+
+      if (prev == NULL)
+        {
+          g_hrtimer_active = hrtimer->flink;
+        }
+      else
+        {
+          prev->flink = hrtimer->flink;
+        }
+
+      hrtimer->flink  = NULL;
+      hrtimer->active = false;
+      ret             = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -0,0 +1,103 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_process.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <assert.h>
+
+#include <nuttx/hrtimer.h>
+
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The list of active high resolution timers, ordered by expiration time */
+
+FAR struct hrtimer_s *g_hrtimer_active;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_process
+ *
+ * Description:
+ *   Remove each high resolution timer that has expired at time 'now' from
+ *   the active list and execute its function.
+ *
+ *   A timer function may restart its timer.  Because the delay must be
+ *   non-zero, the restarted timer will not have expired at time 'now'.
+ *
+ * Input Parameters:
+ *   now - The current time
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the alarm interrupt handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void hrtimer_process(FAR const struct timespec *now)
+{
+  FAR struct hrtimer_s *hrtimer;
+
+  DEBUGASSERT(now != NULL);
+
+  while ((hrtimer = g_hrtimer_active) != NULL &&
+         !HRTIMER_BEFORE(now, &hrtimer->expiry))
+    {
+      /* Remove the timer from the head of the list and execute it */
+
+      g_hrtimer_active = hrtimer->flink;
+      hrtimer->flink   = NULL;
+      hrtimer->active  = false;
+
+      hrtimer->func(hrtimer, hrtimer->arg);
+    }
+}
+
+#endif /* CONFIG_HRTIMER */
@@ -0,0 +1,143 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_start.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/hrtimer.h>
+
+#include "sched/sched.h"
+#include "clock/clock.h"
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a high resolution timer.  The function 'func' will be called
+ *   from the timer interrupt handler when the 'delay' has elapsed.  Unlike
+ *   watchdog timers, the delay is not rounded to system clock ticks; the
+ *   resolution is limited only by the underlying alarm hardware.  If the
+ *   timer is already active, it is first cancelled.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer to start
+ *   delay   - The relative delay.  This must be greater than zero.
+ *   func    - The function to call when the delay expires
+ *   arg     - An argument that will be passed to func
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *hrtimer,
+                  FAR const struct timespec *delay, hrtimer_entry_t func,
+                  FAR void *arg)
+{
+  FAR struct hrtimer_s *prev;
+  FAR struct hrtimer_s *curr;
+  struct timespec now;
+  irqstate_t flags;
+
+  if (hrtimer == NULL || delay == NULL || func == NULL ||
+      delay->tv_sec < 0 || delay->tv_nsec < 0 ||
+      delay->tv_nsec >= NSEC_PER_SEC ||
+      (delay->tv_sec == 0 && delay->tv_nsec == 0))
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  /* Stop the timer if it is already active */
+
+  if (hrtimer->active)
+    {
+      (void)hrtimer_cancel(hrtimer);
+    }
+
+  /* Get the absolute expiration time */
+
+  (void)up_timer_gettime(&now);
+  clock_timespec_add(&now, delay, &hrtimer->expiry);
+
+  hrtimer->func   = func;
+  hrtimer->arg    = arg;
+  hrtimer->active = true;
+
+  /* Insert the timer into the active list after all timers that expire at
+   * the same time or earlier.
+   */
+
+  for (prev = NULL, curr = g_hrtimer_active;
+       curr != NULL && !HRTIMER_BEFORE(&hrtimer->expiry, &curr->expiry);
+       prev = curr, curr = curr->flink);
+
+  hrtimer->flink = curr;
+  if (prev == NULL)
+    {
+      /* The new timer is at the head of the list.  The alarm may need to be
+       * moved earlier.
+       */
+
+      g_hrtimer_active = hrtimer;
+      sched_alarm_reload();
+    }
+  else
+    {
+      prev->flink = hrtimer;
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+#endif /* CONFIG_HRTIMER */
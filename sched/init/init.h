@@ -85,6 +85,26 @@ void os_start(void);
 int os_smp_start(void);
 #endif
 
+/****************************************************************************
+ * Name: os_initcalls
+ *
+ * Description:
+ *   Run all initcalls registered with os_initcall_register(), level by
+ *   level.  Called on the board initialization thread after
+ *   board_initialize().
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INITCALL
+void os_initcalls(void);
+#endif
+
 /****************************************************************************
  * Name: os_idle_trampoline
  *
@@ -0,0 +1,186 @@
+/****************************************************************************
+ * sched/init/os_bootlog.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <syslog.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/init.h>
+
+#ifdef CONFIG_SCHED_BOOTLOG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SCHED_BOOTLOG_NMARKS
+#  define CONFIG_SCHED_BOOTLOG_NMARKS 32
+#endif
+
+/* Marks are time stamped with the high resolution counter if the
+ * architecture provides one; otherwise with the system timer (which does
+ * not advance until the timer is initialized in up_initialize()).
+ */
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+#  define bootlog_gettime() up_perf_gettime()
+#else
+#  define bootlog_gettime() ((uint32_t)clock_systimer())
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bootmark_s
+{
+  FAR const char *phase;   /* Name of the phase that just completed */
+  uint32_t time;           /* Time stamp in bootlog_gettime() units */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bootmark_s g_bootmarks[CONFIG_SCHED_BOOTLOG_NMARKS];
+static unsigned int g_nbootmarks;
+static unsigned int g_bootoverrun;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bootlog_usec
+ *
+ * Description:
+ *   Convert an interval in bootlog_gettime() units to microseconds.
+ *
+ ****************************************************************************/
+
+static uint32_t bootlog_usec(uint32_t elapsed)
+{
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+  return (uint32_t)(((uint64_t)elapsed * USEC_PER_SEC) / up_perf_getfreq());
+#else
+  return elapsed * USEC_PER_TICK;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: os_bootmark
+ *
+ * Description:
+ *   Record the time at which a boot phase completed.  This may be called
+ *   from any context, including concurrently running initcalls.  Marks
+ *   beyond CONFIG_SCHED_BOOTLOG_NMARKS are counted but not recorded.
+ *
+ * Input Parameters:
+ *   phase - The name of the phase.  The string is not copied and must
+ *           persist.
+ *
+ ****************************************************************************/
+
+void os_bootmark(FAR const char *phase)
+{
+  irqstate_t flags;
+  uint32_t now;
+
+  now   = bootlog_gettime();
+  flags = enter_critical_section();
+
+  if (g_nbootmarks < CONFIG_SCHED_BOOTLOG_NMARKS)
+    {
+      g_bootmarks[g_nbootmarks].phase = phase;
+      g_bootmarks[g_nbootmarks].time  = now;
+      g_nbootmarks++;
+    }
+  else
+    {
+      g_bootoverrun++;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: os_bootlog
+ *
+ * Description:
+ *   Write the recorded boot marks to the SYSLOG:  The time of each mark
+ *   since the first one and the time spent in the phase since the previous
+ *   mark, both in microseconds.
+ *
+ ****************************************************************************/
+
+void os_bootlog(void)
+{
+  uint32_t total = 0;
+  uint32_t delta;
+  unsigned int i;
+
+  syslog(LOG_INFO, "Boot log:\n");
+  syslog(LOG_INFO, "  %10s %10s  %s\n", "TIME(us)", "DELTA(us)", "PHASE");
+
+  for (i = 0; i < g_nbootmarks; i++)
+    {
+      delta  = i > 0 ?
+               bootlog_usec(g_bootmarks[i].time - g_bootmarks[i - 1].time) :
+               0;
+      total += delta;
+
+      syslog(LOG_INFO, "  %10lu %10lu  %s\n", (unsigned long)total,
+             (unsigned long)delta, g_bootmarks[i].phase);
+    }
+
+  if (g_bootoverrun > 0)
+    {
+      syslog(LOG_INFO, "  (%u marks dropped)\n", g_bootoverrun);
+    }
+}
+
+#endif /* CONFIG_SCHED_BOOTLOG */
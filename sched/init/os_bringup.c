@@ -245,8 +245,20 @@ static inline void os_do_appstart(void)
    */
 
   board_initialize();
+  os_bootmark("board_initialize");
 #endif
 
+#ifdef CONFIG_SCHED_INITCALL
+  /* Run the initcalls registered by board_initialize() */
+
+  os_initcalls();
+  os_bootmark("initcalls");
+#endif
+
+  /* Write the boot log now that the boot is complete */
+
+  os_bootlog();
+
   /* Start the application initialization task.  In a flat build, this is
    * entrypoint is given by the definitions, CONFIG_USER_ENTRYPOINT.  In
    * the protected build, however, we must get the address of the
@@ -280,8 +292,20 @@ static inline void os_do_appstart(void)
    */
 
   board_initialize();
+  os_bootmark("board_initialize");
 #endif
 
+#ifdef CONFIG_SCHED_INITCALL
+  /* Run the initcalls registered by board_initialize() */
+
+  os_initcalls();
+  os_bootmark("initcalls");
+#endif
+
+  /* Write the boot log now that the boot is complete */
+
+  os_bootlog();
+
   /* Start the application initialization program from a program in a
    * mounted file system.  Presumably the file system was mounted as part
    * of the board_initialize() operation.
@@ -430,6 +454,7 @@ int os_bringup(void)
    */
 
   os_workqueues();
+  os_bootmark("work queues");
 
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
@@ -0,0 +1,218 @@
+/****************************************************************************
+ * sched/init/os_initcall.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/init.h>
+#include <nuttx/wqueue.h>
+
+#include "init/init.h"
+
+#ifdef CONFIG_SCHED_INITCALL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initcalls run on the low priority work queue if there is one */
+
+#if defined(CONFIG_SCHED_LPWORK)
+#  define INITCALL_WORK LPWORK
+#elif defined(CONFIG_SCHED_HPWORK)
+#  define INITCALL_WORK HPWORK
+#else
+#  error CONFIG_SCHED_INITCALL requires a kernel work queue
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sq_queue_t g_initcalls;   /* Registered, not yet run */
+static sem_t g_initcallsem;      /* Counts completed initcalls */
+static bool g_initcallsrun;      /* Registration is closed */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_worker
+ *
+ * Description:
+ *   Run one initcall on a work queue thread.
+ *
+ ****************************************************************************/
+
+static void initcall_worker(FAR void *arg)
+{
+  FAR struct initcall_s *call = (FAR struct initcall_s *)arg;
+
+  call->result = call->func();
+  if (call->result < 0)
+    {
+      serr("ERROR: Initcall %s failed: %d\n", call->name, call->result);
+    }
+
+  os_bootmark(call->name);
+  sem_post(&g_initcallsem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: os_initcall_register
+ *
+ * Description:
+ *   Register an initialization function to be run after board_initialize()
+ *   and before the application is started.  Initcalls are run by level,
+ *   lowest first.  All initcalls of one level are run concurrently and
+ *   complete before any initcall of the next level is started, so an
+ *   initcall must only depend on initcalls of lower levels.
+ *
+ *   This must be called before the initcalls are run, normally from
+ *   board_initialize().
+ *
+ * Input Parameters:
+ *   call - The initcall.  The caller provides the memory, which must
+ *          persist until the initcalls have been run.  name, func and level
+ *          must be initialized.
+ *
+ * Returned Value:
+ *   OK on success; -EBUSY if the initcalls have already been run.
+ *
+ ****************************************************************************/
+
+int os_initcall_register(FAR struct initcall_s *call)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(call != NULL && call->func != NULL);
+
+  flags = enter_critical_section();
+  if (g_initcallsrun)
+    {
+      leave_critical_section(flags);
+      return -EBUSY;
+    }
+
+  call->result = -EAGAIN;
+  sq_addlast((FAR sq_entry_t *)call, &g_initcalls);
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: os_initcalls
+ *
+ * Description:
+ *   Run all registered initcalls, one level at a time.  The initcalls of a
+ *   level are queued on the work queue, which runs them concurrently when
+ *   it has several threads (CONFIG_SCHED_LPNTHREADS) and, in an SMP
+ *   configuration, on several CPUs.  Called on the board initialization
+ *   thread, which waits for each level to complete.
+ *
+ ****************************************************************************/
+
+void os_initcalls(void)
+{
+  FAR struct initcall_s *call;
+  irqstate_t flags;
+  unsigned int nqueued;
+  int level;
+  int next;
+
+  flags = enter_critical_section();
+  g_initcallsrun = true;
+  leave_critical_section(flags);
+
+  sem_init(&g_initcallsem, 0, 0);
+
+  for (level = 0; level >= 0; level = next)
+    {
+      /* Queue every initcall of this level and find the next level */
+
+      nqueued = 0;
+      next    = -1;
+
+      for (call = (FAR struct initcall_s *)sq_peek(&g_initcalls);
+           call != NULL;
+           call = call->flink)
+        {
+          if (call->level == level)
+            {
+              call->work.worker = NULL;
+              (void)work_queue(INITCALL_WORK, &call->work, initcall_worker,
+                               call, 0);
+              nqueued++;
+            }
+          else if (call->level > level && (next < 0 || call->level < next))
+            {
+              next = call->level;
+            }
+        }
+
+      /* Wait for them all to complete before starting the next level */
+
+      while (nqueued > 0)
+        {
+          while (sem_wait(&g_initcallsem) < 0)
+            {
+              DEBUGASSERT(get_errno() == EINTR);
+            }
+
+          nqueued--;
+        }
+    }
+
+  sq_init(&g_initcalls);
+  sem_destroy(&g_initcallsem);
+}
+
+#endif /* CONFIG_SCHED_INITCALL */
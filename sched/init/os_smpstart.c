@@ -163,6 +163,12 @@ int os_idle_task(int argc, FAR char *argv[])
         }
 #endif
 
+#ifdef CONFIG_SMP_IDLE_BALANCE
+      /* Pull any waiting, unassigned task that could run on this CPU */
+
+      sched_idle_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
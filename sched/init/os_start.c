@@ -195,7 +195,7 @@ volatile dq_queue_t g_inactivetasks;
 
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
      defined(CONFIG_MM_KERNEL_HEAP)
-volatile sq_queue_t g_delayed_kfree;
+volatile sq_queue_t g_delayed_kfree[SCHED_NGARBAGE];
 #endif
 
 #ifndef CONFIG_BUILD_KERNEL
@@ -207,7 +207,13 @@ volatile sq_queue_t g_delayed_kfree;
  * on a group-by-group basis.
  */
 
-volatile sq_queue_t g_delayed_kufree;
+volatile sq_queue_t g_delayed_kufree[SCHED_NGARBAGE];
+#endif
+
+#ifdef CONFIG_SMP
+/* This spinlock protects the delayed deallocation lists of each CPU */
+
+volatile spinlock_t g_delayed_lock[CONFIG_SMP_NCPUS];
 #endif
 
 /* This is the value of the last process ID assigned to a task */
@@ -224,7 +230,13 @@ volatile pid_t g_lastpid;
  * the number of tasks to CONFIG_MAX_TASKS.
  */
 
+#ifdef CONFIG_SCHED_GROWPIDHASH
+static struct pidhash_s g_pidtable[CONFIG_MAX_TASKS];
+FAR struct pidhash_s *g_pidhash = g_pidtable;
+volatile int g_npidhash = CONFIG_MAX_TASKS;
+#else
 struct pidhash_s g_pidhash[CONFIG_MAX_TASKS];
+#endif
 
 /* This is a table of task lists.  This table is indexed by the task stat
  * enumeration type (tstate_t) and provides a pointer to the associated
@@ -378,6 +390,7 @@ void os_start(void)
   /* Boot up is complete */
 
   g_os_initstate = OSINIT_BOOT;
+  os_bootmark("os_start");
 
   /* Initialize RTOS Data ***************************************************/
   /* Initialize all task lists */
@@ -396,13 +409,20 @@ void os_start(void)
   dq_init(&g_waitingforfill);
 #endif
   dq_init(&g_inactivetasks);
+
+  for (i = 0; i < SCHED_NGARBAGE; i++)
+    {
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
      defined(CONFIG_MM_KERNEL_HEAP)
-  sq_init(&g_delayed_kfree);
+      sq_init(&g_delayed_kfree[i]);
 #endif
 #ifndef CONFIG_BUILD_KERNEL
-  sq_init(&g_delayed_kufree);
+      sq_init(&g_delayed_kufree[i]);
+#endif
+#ifdef CONFIG_SMP
+      spin_initialize(&g_delayed_lock[i]);
 #endif
+    }
 
 #ifdef CONFIG_SMP
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
@@ -414,7 +434,7 @@ void os_start(void)
   /* Initialize the logic that determine unique process IDs. */
 
   g_lastpid = 0;
-  for (i = 0; i < CONFIG_MAX_TASKS; i++)
+  for (i = 0; i < g_npidhash; i++)
     {
       g_pidhash[i].tcb = NULL;
       g_pidhash[i].pid = INVALID_PROCESS_ID;
@@ -582,6 +602,22 @@ void os_start(void)
   /* The memory manager is available */
 
   g_os_initstate = OSINIT_MEMORY;
+  os_bootmark("memory");
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+  /* Now that there is a heap, give each IDLE task its own TLS block and
+   * point this CPU at the one of the CPU0 IDLE task.
+   */
+
+#ifdef CONFIG_SMP
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+#endif
+    {
+      DEBUGVERIFY(sched_threadlocal_alloc(&g_idletcb[cpu].cmn));
+    }
+
+  up_tls_setpointer(g_idletcb[0].cmn.tls_pointer);
+#endif
 
 #if defined(CONFIG_SCHED_HAVE_PARENT) && defined(CONFIG_SCHED_CHILD_STATUS)
   /* Initialize tasking data structures */
@@ -692,6 +728,15 @@ void os_start(void)
   /* Hardware resources are available */
 
   g_os_initstate = OSINIT_HARDWARE;
+  os_bootmark("up_initialize");
+
+#ifdef CONFIG_CLOCK_CLOCKSOURCE
+  /* Switch the time-of-day to the cycle counter now that up_initialize()
+   * has started it.
+   */
+
+  clock_clocksource_initialize();
+#endif
 
 #ifdef CONFIG_NET
   /* Complete initialization the networking system now that interrupts
@@ -791,6 +836,7 @@ void os_start(void)
   /* The OS is fully initialized and we are beginning multi-tasking */
 
   g_os_initstate = OSINIT_OSREADY;
+  os_bootmark("os ready");
 
   /* Create initial tasks and bring-up the system */
 
@@ -835,6 +881,12 @@ void os_start(void)
         }
 #endif
 
+#ifdef CONFIG_SMP_IDLE_BALANCE
+      /* Pull any waiting, unassigned task that could run on this CPU */
+
+      sched_idle_balance();
+#endif
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
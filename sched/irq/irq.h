@@ -44,11 +44,29 @@
 #include <nuttx/compiler.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
 #include <nuttx/spinlock.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+/* This structure holds the statistics of one IRQ.  Times are in units of
+ * up_perf_gettime().
+ */
+
+struct irq_info_s
+{
+  uint32_t count;         /* Number of times the handler ran */
+  uint32_t maxtime;       /* Longest time spent in the handler */
+  uint64_t time;          /* Total time spent in the handler */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -60,6 +78,12 @@
 
 extern FAR xcpt_t g_irqvector[NR_IRQS+1];
 
+#ifdef CONFIG_SCHED_IRQMONITOR
+/* The statistics of each IRQ, updated by irq_dispatch() */
+
+extern struct irq_info_s g_irqinfo[NR_IRQS+1];
+#endif
+
 #ifdef CONFIG_SMP
 /* This is the spinlock that enforces critical sections when interrupts are
  * disabled.
@@ -69,7 +93,7 @@ extern volatile spinlock_t g_cpu_irqlock;
 
 /* Used to keep track of which CPU(s) hold the IRQ lock. */
 
-extern volatile spinlock_t g_cpu_irqsetlock;
+extern volatile spinlock_set_t g_cpu_irqsetlock;
 extern volatile cpu_set_t g_cpu_irqset;
 #endif
 
@@ -116,6 +116,14 @@ int irq_attach(int irq, xcpt_t isr)
       /* Save the new ISR in the table. */
 
       g_irqvector[irq] = isr;
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+      /* The statistics belong to the old handler */
+
+      g_irqinfo[irq].count   = 0;
+      g_irqinfo[irq].maxtime = 0;
+      g_irqinfo[irq].time    = 0;
+#endif
       leave_critical_section(flags);
       ret = OK;
     }
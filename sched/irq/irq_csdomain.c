@@ -0,0 +1,168 @@
+/****************************************************************************
+ * sched/irq/irq_csdomain.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <arch/irq.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP_CSECTION_DOMAINS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the state of one critical section domain */
+
+struct csdomain_s
+{
+  volatile spinlock_t lock;     /* Enforces mutual exclusion between CPUs */
+  volatile uint8_t owner;       /* CPU that holds the lock plus one, or zero */
+  volatile uint16_t count;      /* Nesting count of the owning CPU */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* NOTE: This relies on SP_UNLOCKED being zero so that all domains are
+ * initially unlocked and unowned.
+ */
+
+static struct csdomain_s g_csdomain[CSDOMAIN_NDOMAINS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: enter_critical_domain
+ *
+ * Description:
+ *   Disable interrupts on this CPU and take the spinlock associated with
+ *   'domain'.  Nested calls from the same CPU only increment a counter.
+ *
+ *   Interrupts remain disabled while the domain is held so the holder
+ *   cannot be suspended or migrated to a different CPU.  The same logic
+ *   is used in interrupt and in task context.
+ *
+ * Input Parameters:
+ *   domain - The critical section domain to enter
+ *
+ * Returned Value:
+ *   The previous interrupt state to be passed to leave_critical_domain().
+ *
+ ****************************************************************************/
+
+irqstate_t enter_critical_domain(enum csdomain_e domain)
+{
+  FAR struct csdomain_s *csd;
+  irqstate_t flags;
+  uint8_t cpu;
+
+  DEBUGASSERT((unsigned)domain < CSDOMAIN_NDOMAINS);
+  csd = &g_csdomain[domain];
+
+  /* Disable interrupts first so that we cannot be moved to another CPU
+   * between checking the owner and taking the spinlock.
+   */
+
+  flags = up_irq_save();
+  cpu   = this_cpu() + 1;
+
+  if (csd->owner == cpu)
+    {
+      /* We already hold the domain.  Just increment the nesting count */
+
+      DEBUGASSERT(csd->lock == SP_LOCKED && csd->count < UINT16_MAX);
+      csd->count++;
+    }
+  else
+    {
+      /* Wait for the domain to become available */
+
+      spin_lock(&csd->lock);
+      csd->owner = cpu;
+      csd->count = 1;
+    }
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: leave_critical_domain
+ *
+ * Description:
+ *   Decrement the nesting count for 'domain' and, if it decrements to zero,
+ *   release the domain spinlock.  Then restore the interrupt state.
+ *
+ * Input Parameters:
+ *   domain - The critical section domain to leave
+ *   flags  - The interrupt state returned by enter_critical_domain()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void leave_critical_domain(enum csdomain_e domain, irqstate_t flags)
+{
+  FAR struct csdomain_s *csd;
+
+  DEBUGASSERT((unsigned)domain < CSDOMAIN_NDOMAINS);
+  csd = &g_csdomain[domain];
+
+  DEBUGASSERT(csd->owner == this_cpu() + 1 && csd->count > 0);
+
+  if (--csd->count == 0)
+    {
+      csd->owner = 0;
+      spin_unlock(&csd->lock);
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SMP_CSECTION_DOMAINS */
@@ -49,7 +49,8 @@
 #include "sched/sched.h"
 #include "irq/irq.h"
 
-#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION)
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) || \
+    defined(CONFIG_SCHED_CRITMONITOR)
 
 /****************************************************************************
  * Public Data
@@ -64,7 +65,7 @@ volatile spinlock_t g_cpu_irqlock = SP_UNLOCKED;
 
 /* Used to keep track of which CPU(s) hold the IRQ lock. */
 
-volatile spinlock_t g_cpu_irqsetlock;
+volatile spinlock_set_t g_cpu_irqsetlock;
 volatile cpu_set_t g_cpu_irqset;
 #endif
 
@@ -125,6 +126,12 @@ irqstate_t enter_critical_section(void)
                       &g_cpu_irqlock);
           rtcb->irqcount = 1;
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+          /* Start the interrupts disabled time measurement */
+
+          sched_critmon_csection(rtcb, true, sched_critmon_caller());
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
           /* Note that we have entered the critical section */
 
@@ -139,9 +146,15 @@ irqstate_t enter_critical_section(void)
 
   return up_irq_save();
 }
-#else /* defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) */
+#else /* CONFIG_SCHED_INSTRUMENTATION_CSECTION || CONFIG_SCHED_CRITMONITOR */
 irqstate_t enter_critical_section(void)
 {
+  irqstate_t flags;
+
+  /* Disable interrupts */
+
+  flags = up_irq_save();
+
   /* Check if we were called from an interrupt handler and that the tasks
    * lists have been initialized.
    */
@@ -151,14 +164,25 @@ irqstate_t enter_critical_section(void)
       FAR struct tcb_s *rtcb = this_task();
       DEBUGASSERT(rtcb != NULL);
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Start the interrupts disabled time measurement if this is the
+       * outermost critical section.
+       */
+
+      if (rtcb->irqcount++ == 0)
+        {
+          sched_critmon_csection(rtcb, true, sched_critmon_caller());
+        }
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
       /* No.. note that we have entered the critical section */
 
       sched_note_csection(rtcb, true);
+#endif
     }
 
-  /* And disable interrupts */
-
-  return up_irq_save();
+  return flags;
 }
 #endif
 
@@ -200,6 +224,11 @@ void leave_critical_section(irqstate_t flags)
           /* No.. Note that we have entered the critical section */
 
           sched_note_csection(rtcb, false);
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+          /* Record how long interrupts were disabled */
+
+          sched_critmon_csection(rtcb, false, NULL);
 #endif
           /* Decrement our count on the lock.  If all CPUs have released,
            * then unlock the spinlock.
@@ -238,7 +267,7 @@ void leave_critical_section(irqstate_t flags)
 
   up_irq_restore(flags);
 }
-#else /* defined(CONFIG_SCHED_INSTRUMENTATION_CSECTION) */
+#else /* CONFIG_SCHED_INSTRUMENTATION_CSECTION || CONFIG_SCHED_CRITMONITOR */
 void leave_critical_section(irqstate_t flags)
 {
   /* Check if we were called from an interrupt handler and that the tasks
@@ -250,9 +279,23 @@ void leave_critical_section(irqstate_t flags)
       FAR struct tcb_s *rtcb = this_task();
       DEBUGASSERT(rtcb != NULL);
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
       /* Note that we have left the critical section */
 
       sched_note_csection(rtcb, false);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Record how long interrupts were disabled when the outermost
+       * critical section is left.
+       */
+
+      DEBUGASSERT(rtcb->irqcount > 0);
+      if (--rtcb->irqcount == 0)
+        {
+          sched_critmon_csection(rtcb, false, NULL);
+        }
+#endif
     }
 
   /* Restore the previous interrupt state. */
@@ -261,4 +304,4 @@ void leave_critical_section(irqstate_t flags)
 }
 #endif
 
-#endif /* CONFIG_SMP || CONFIG_SCHED_INSTRUMENTATION_CSECTION*/
+#endif /* CONFIG_SMP || CONFIG_SCHED_INSTRUMENTATION_CSECTION || CONFIG_SCHED_CRITMONITOR */
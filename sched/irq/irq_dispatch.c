@@ -42,6 +42,7 @@
 #include <debug.h>
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
+#include <nuttx/sched_note.h>
 
 #include "irq/irq.h"
 
@@ -62,6 +63,11 @@
 void irq_dispatch(int irq, FAR void *context)
 {
   xcpt_t vector;
+#ifdef CONFIG_SCHED_IRQMONITOR
+  FAR struct irq_info_s *info;
+  uint32_t start;
+  uint32_t elapsed;
+#endif
 
   /* Perform some sanity checks */
 
@@ -80,5 +86,31 @@ void irq_dispatch(int irq, FAR void *context)
 
   /* Then dispatch to the interrupt handler */
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+  sched_note_irqhandler(irq, vector, true);
+#endif
+#ifdef CONFIG_SCHED_IRQMONITOR
+  start = up_perf_gettime();
+#endif
+
   vector(irq, context);
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+  /* Account for the time spent in the handler.  Unexpected IRQs out of
+   * range are collected in the extra entry at the end of the table.
+   */
+
+  elapsed = up_perf_gettime() - start;
+  info    = &g_irqinfo[(unsigned)irq < NR_IRQS ? irq : NR_IRQS];
+
+  info->count++;
+  info->time += elapsed;
+  if (elapsed > info->maxtime)
+    {
+      info->maxtime = elapsed;
+    }
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+  sched_note_irqhandler(irq, vector, false);
+#endif
 }
@@ -49,6 +49,10 @@
 
 FAR xcpt_t g_irqvector[NR_IRQS+1];
 
+#ifdef CONFIG_SCHED_IRQMONITOR
+struct irq_info_s g_irqinfo[NR_IRQS+1];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,385 @@
+/****************************************************************************
+ * sched/irq/irq_procfs.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "irq/irq.h"
+
+#if defined(CONFIG_SCHED_IRQMONITOR) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_IRQ)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define IRQ_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct irq_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  unsigned int linesize;            /* Number of valid characters in line[] */
+  char line[IRQ_LINELEN];           /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     irq_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     irq_close(FAR struct file *filep);
+static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     irq_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     irq_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations irq_procfsoperations =
+{
+  irq_open,          /* open */
+  irq_close,         /* close */
+  irq_read,          /* read */
+  NULL,              /* write */
+
+  irq_dup,           /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  irq_stat           /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_usec
+ *
+ * Description:
+ *   Convert a time in units of up_perf_gettime() to microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long irq_usec(uint64_t time, uint32_t freq)
+{
+  return (unsigned long)((time * 1000000) / freq);
+}
+
+/****************************************************************************
+ * Name: irq_callback
+ *
+ * Description:
+ *   Format the line for one IRQ and transfer it to the user buffer.
+ *
+ ****************************************************************************/
+
+static ssize_t irq_callback(FAR struct irq_file_s *irqfile, int irq,
+                            FAR char *buffer, size_t buflen,
+                            FAR off_t *offset)
+{
+  struct irq_info_s copy;
+  irqstate_t flags;
+  xcpt_t handler;
+  uint32_t freq;
+
+  /* Take a consistent snapshot of the statistics */
+
+  flags   = enter_critical_section();
+  handler = g_irqvector[irq];
+  memcpy(&copy, &g_irqinfo[irq], sizeof(struct irq_info_s));
+  leave_critical_section(flags);
+
+  freq = up_perf_getfreq();
+
+  /* The last entry collects the interrupts with no valid IRQ number */
+
+  if (irq < NR_IRQS)
+    {
+      irqfile->linesize =
+        snprintf(irqfile->line, IRQ_LINELEN, "%4d %p %10lu %12lu %8lu\n",
+                 irq, handler, (unsigned long)copy.count,
+                 irq_usec(copy.time, freq), irq_usec(copy.maxtime, freq));
+    }
+  else
+    {
+      irqfile->linesize =
+        snprintf(irqfile->line, IRQ_LINELEN, " ??? %*s %10lu %12lu %8lu\n",
+                 (int)(2 * sizeof(FAR void *) + 2), "",
+                 (unsigned long)copy.count,
+                 irq_usec(copy.time, freq), irq_usec(copy.maxtime, freq));
+    }
+
+  return procfs_memcpy(irqfile->line, irqfile->linesize, buffer, buflen,
+                       offset);
+}
+
+/****************************************************************************
+ * Name: irq_open
+ ****************************************************************************/
+
+static int irq_open(FAR struct file *filep, FAR const char *relpath,
+                    int oflags, mode_t mode)
+{
+  FAR struct irq_file_s *irqfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "irqs" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "irqs") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  irqfile = (FAR struct irq_file_s *)kmm_zalloc(sizeof(struct irq_file_s));
+  if (!irqfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)irqfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_close
+ ****************************************************************************/
+
+static int irq_close(FAR struct file *filep)
+{
+  FAR struct irq_file_s *irqfile;
+
+  /* Recover our private data from the struct file instance */
+
+  irqfile = (FAR struct irq_file_s *)filep->f_priv;
+  DEBUGASSERT(irqfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(irqfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_read
+ *
+ * Description:
+ *   Return one line per IRQ that has been attached or has occurred:  The
+ *   IRQ number, the handler, the number of interrupts, and the total and
+ *   the longest time spent in the handler in microseconds.
+ *
+ ****************************************************************************/
+
+static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
+{
+  FAR struct irq_file_s *irqfile;
+  off_t offset;
+  ssize_t nread;
+  ssize_t ret;
+  int irq;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  irqfile = (FAR struct irq_file_s *)filep->f_priv;
+  DEBUGASSERT(irqfile);
+
+  /* The header line */
+
+  offset = filep->f_pos;
+  irqfile->linesize =
+    snprintf(irqfile->line, IRQ_LINELEN, "%4s %-*s %10s %12s %8s\n",
+             "IRQ", (int)(2 * sizeof(FAR void *) + 2), "HANDLER",
+             "COUNT", "TIME(us)", "MAX(us)");
+
+  nread = procfs_memcpy(irqfile->line, irqfile->linesize, buffer, buflen,
+                        &offset);
+
+  /* Then one line for each IRQ of interest */
+
+  for (irq = 0; irq <= NR_IRQS && nread < buflen; irq++)
+    {
+      if (g_irqinfo[irq].count == 0 &&
+          (irq == NR_IRQS || g_irqvector[irq] == NULL ||
+           g_irqvector[irq] == irq_unexpected_isr))
+        {
+          continue;
+        }
+
+      ret = irq_callback(irqfile, irq, &buffer[nread], buflen - nread,
+                         &offset);
+      nread += ret;
+    }
+
+  /* Update the file offset */
+
+  if (nread > 0)
+    {
+      filep->f_pos += nread;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: irq_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int irq_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct irq_file_s *oldfile;
+  FAR struct irq_file_s *newfile;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldfile = (FAR struct irq_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldfile);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newfile = (FAR struct irq_file_s *)kmm_malloc(sizeof(struct irq_file_s));
+  if (!newfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newfile, oldfile, sizeof(struct irq_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int irq_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "irqs" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "irqs") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "irqs" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_IRQMONITOR && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_IRQ */
@@ -46,44 +46,60 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/module.h>
 #include <nuttx/binfmt/symtab.h>
 
 #include "module.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Relocation entries are read this many at a time */
+
+#define MOD_RELBATCH 16
+
+#ifndef MIN
+#  define MIN(x,y) ((x) < (y) ? (x) : (y))
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: mod_readrel
+ * Name: mod_readrels
  *
  * Description:
- *   Read the ELF32_Rel structure into memory.
+ *   Read up to MOD_RELBATCH ELF32_Rel structures into memory with a single
+ *   read.
  *
  ****************************************************************************/
 
-static inline int mod_readrel(FAR struct mod_loadinfo_s *loadinfo,
-                              FAR const Elf32_Shdr *relsec,
-                              int index, FAR Elf32_Rel *rel)
+static inline int mod_readrels(FAR struct mod_loadinfo_s *loadinfo,
+                               FAR const Elf32_Shdr *relsec,
+                               int index, int nrels, FAR Elf32_Rel *rels)
 {
   off_t offset;
 
-  /* Verify that the symbol table index lies within symbol table */
+  /* Verify that the relocation entries lie within the relocation section */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  if (index < 0 || nrels <= 0 ||
+      index + nrels > (relsec->sh_size / sizeof(Elf32_Rel)))
     {
-      serr("ERROR: Bad relocation symbol index: %d\n", index);
+      serr("ERROR: Bad relocation index: %d\n", index);
       return -EINVAL;
     }
 
-  /* Get the file offset to the symbol table entry */
+  /* Get the file offset to the first relocation entry */
 
   offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
 
-  /* And, finally, read the symbol table entry into memory */
+  /* And, finally, read the relocation entries into memory */
 
-  return mod_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel), offset);
+  return mod_read(loadinfo, (FAR uint8_t *)rels,
+                  sizeof(Elf32_Rel) * nrels, offset);
 }
 
 /****************************************************************************
@@ -103,11 +119,13 @@ static int mod_relocate(FAR struct mod_loadinfo_s *loadinfo, int relidx)
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
+  Elf32_Rel       rels[MOD_RELBATCH];
+  FAR Elf32_Rel  *rel;
   Elf32_Sym       sym;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
   int             symidx;
+  int             nrels;
   int             ret;
   int             i;
 
@@ -116,25 +134,32 @@ static int mod_relocate(FAR struct mod_loadinfo_s *loadinfo, int relidx)
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  for (i = 0; i < nrels; i++)
     {
       psym = &sym;
 
-      /* Read the relocation entry into memory */
+      /* Read the next batch of relocation entries into memory */
 
-      ret = mod_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      if ((i % MOD_RELBATCH) == 0)
         {
-          serr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          ret = mod_readrels(loadinfo, relsec, i,
+                             MIN(MOD_RELBATCH, nrels - i), rels);
+          if (ret < 0)
+            {
+              serr("ERROR: Section %d reloc %d: Failed to read relocation entries: %d\n",
+                   relidx, i, ret);
+              return ret;
+            }
         }
 
+      rel = &rels[i % MOD_RELBATCH];
+
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
+      symidx = ELF32_R_SYM(rel->r_info);
 
       /* Read the symbol table entry into memory */
 
@@ -146,9 +171,29 @@ static int mod_relocate(FAR struct mod_loadinfo_s *loadinfo, int relidx)
           return ret;
         }
 
-      /* Get the value of the symbol (in sym.st_value) */
+      /* Get the value of the symbol (in sym.st_value).  The exported value
+       * of an undefined symbol is cached by symbol index since many
+       * relocations typically refer to the same symbol.
+       */
+
+      if (sym.st_shndx == SHN_UNDEF && symidx < loadinfo->nsymcache &&
+          loadinfo->symcache[symidx] != 0)
+        {
+          sym.st_value += (Elf32_Word)loadinfo->symcache[symidx];
+          ret = OK;
+        }
+      else
+        {
+          Elf32_Addr value = sym.st_value;
+
+          ret = mod_symvalue(loadinfo, &sym);
+          if (ret >= 0 && sym.st_shndx == SHN_UNDEF &&
+              symidx < loadinfo->nsymcache)
+            {
+              loadinfo->symcache[symidx] = sym.st_value - value;
+            }
+        }
 
-      ret = mod_symvalue(loadinfo, &sym);
       if (ret < 0)
         {
           /* The special error -ESRCH is returned only in one condition:  The
@@ -177,18 +222,18 @@ static int mod_relocate(FAR struct mod_loadinfo_s *loadinfo, int relidx)
 
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           serr("ERROR: Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
+               relidx, i, rel->r_offset, dstsec->sh_size);
           return -EINVAL;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           serr("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
@@ -246,6 +291,25 @@ int mod_bind(FAR struct mod_loadinfo_s *loadinfo)
       return -ENOMEM;
     }
 
+  /* Bring the symbol and string tables into memory if possible */
+
+  mod_loadsymtab(loadinfo);
+
+  /* Allocate the cache of resolved undefined symbols.  This is only an
+   * optimization; the symbols are simply looked up for each relocation if
+   * there is not enough memory.
+   */
+
+  loadinfo->nsymcache = loadinfo->shdr[loadinfo->symtabidx].sh_size /
+                        sizeof(Elf32_Sym);
+  loadinfo->symcache  = (FAR uintptr_t *)
+    kmm_zalloc(loadinfo->nsymcache * sizeof(uintptr_t));
+
+  if (loadinfo->symcache == NULL)
+    {
+      loadinfo->nsymcache = 0;
+    }
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -284,6 +348,17 @@ int mod_bind(FAR struct mod_loadinfo_s *loadinfo)
         }
     }
 
+  /* The symbol tables and the symbol cache are no longer needed */
+
+  mod_freesymtab(loadinfo);
+
+  if (loadinfo->symcache != NULL)
+    {
+      kmm_free(loadinfo->symcache);
+      loadinfo->symcache  = NULL;
+      loadinfo->nsymcache = 0;
+    }
+
 #if defined(CONFIG_ARCH_HAVE_COHERENT_DCACHE)
   /* Ensure that the I and D caches are coherent before starting the newly
    * loaded module by cleaning the D cache (i.e., flushing the D cache
@@ -45,6 +45,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/module.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -66,7 +67,9 @@
  * Name: mod_symname
  *
  * Description:
- *   Get the symbol name in loadinfo->iobuffer[].
+ *   Get the symbol name.  The name is returned from the string table in
+ *   memory if mod_loadsymtab() provided one.  Otherwise, it is read into
+ *   loadinfo->iobuffer[].
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -79,7 +82,7 @@
  ****************************************************************************/
 
 static int mod_symname(FAR struct mod_loadinfo_s *loadinfo,
-                       FAR const Elf32_Sym *sym)
+                       FAR const Elf32_Sym *sym, FAR const char **name)
 {
   FAR uint8_t *buffer;
   off_t  offset;
@@ -97,6 +100,21 @@ static int mod_symname(FAR struct mod_loadinfo_s *loadinfo,
       return -ESRCH;
     }
 
+  /* Is the string table in memory? */
+
+  if (loadinfo->strings != NULL)
+    {
+      if (sym->st_name >= loadinfo->shdr[loadinfo->strtabidx].sh_size)
+        {
+          serr("ERROR: Bad symbol name offset: %lu\n",
+               (unsigned long)sym->st_name);
+          return -EINVAL;
+        }
+
+      *name = &loadinfo->strings[sym->st_name];
+      return OK;
+    }
+
   offset = loadinfo->shdr[loadinfo->strtabidx].sh_offset + sym->st_name;
 
   /* Loop until we get the entire symbol name into memory */
@@ -137,6 +155,7 @@ static int mod_symname(FAR struct mod_loadinfo_s *loadinfo,
         {
           /* Yes, the buffer contains a NUL terminator. */
 
+          *name = (FAR const char *)loadinfo->iobuffer;
           return OK;
         }
 
@@ -198,6 +217,86 @@ int mod_findsymtab(FAR struct mod_loadinfo_s *loadinfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: mod_loadsymtab
+ *
+ * Description:
+ *   Bring the whole symbol table and its string table into memory so that
+ *   mod_readsym() and mod_symvalue() do not need to read the file for each
+ *   symbol.  This is only an optimization:  Nothing is done if there is not
+ *   enough memory.
+ *
+ ****************************************************************************/
+
+void mod_loadsymtab(FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf32_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  FAR uint8_t *buffer;
+  int ret;
+
+  if (loadinfo->strtabidx == 0 || loadinfo->strtabidx >= loadinfo->ehdr.e_shnum ||
+      strtab->sh_size == 0)
+    {
+      return;
+    }
+
+  /* Read both tables with one read each into a single allocation */
+
+  buffer = (FAR uint8_t *)kmm_malloc(symtab->sh_size + strtab->sh_size);
+  if (buffer == NULL)
+    {
+      sinfo("Not enough memory to hold the symbol table\n");
+      return;
+    }
+
+  ret = mod_read(loadinfo, buffer, symtab->sh_size, symtab->sh_offset);
+  if (ret >= 0)
+    {
+      ret = mod_read(loadinfo, buffer + symtab->sh_size,
+                     strtab->sh_size, strtab->sh_offset);
+    }
+
+  if (ret < 0)
+    {
+      kmm_free(buffer);
+      return;
+    }
+
+  loadinfo->taballoc = buffer;
+  loadinfo->symbols  = (FAR const Elf32_Sym *)buffer;
+  loadinfo->strings  = (FAR const char *)(buffer + symtab->sh_size);
+
+  /* The names are only usable in place if the string table is properly
+   * terminated.
+   */
+
+  if (loadinfo->strings[strtab->sh_size - 1] != '\0')
+    {
+      loadinfo->strings = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: mod_freesymtab
+ *
+ * Description:
+ *   Release the memory allocated by mod_loadsymtab().
+ *
+ ****************************************************************************/
+
+void mod_freesymtab(FAR struct mod_loadinfo_s *loadinfo)
+{
+  if (loadinfo->taballoc != NULL)
+    {
+      kmm_free(loadinfo->taballoc);
+      loadinfo->taballoc = NULL;
+    }
+
+  loadinfo->symbols = NULL;
+  loadinfo->strings = NULL;
+}
+
 /****************************************************************************
  * Name: mod_readsym
  *
@@ -223,12 +322,20 @@ int mod_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (symtab->sh_size / sizeof(Elf32_Sym)))
+  if (index < 0 || index >= (symtab->sh_size / sizeof(Elf32_Sym)))
     {
       serr("ERROR: Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
+  /* Is the symbol table in memory? */
+
+  if (loadinfo->symbols != NULL)
+    {
+      memcpy(sym, &loadinfo->symbols[index], sizeof(Elf32_Sym));
+      return OK;
+    }
+
   /* Get the file offset to the symbol table entry */
 
   offset = symtab->sh_offset + sizeof(Elf32_Sym) * index;
@@ -264,6 +371,7 @@ int mod_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
 int mod_symvalue(FAR struct mod_loadinfo_s *loadinfo, FAR Elf32_Sym *sym)
 {
   FAR const struct symtab_s *symbol;
+  FAR const char *name;
   uintptr_t secbase;
   int ret;
 
@@ -289,7 +397,7 @@ int mod_symvalue(FAR struct mod_loadinfo_s *loadinfo, FAR Elf32_Sym *sym)
       {
         /* Get the name of the undefined symbol */
 
-        ret = mod_symname(loadinfo, sym);
+        ret = mod_symname(loadinfo, sym, &name);
         if (ret < 0)
           {
             /* There are a few relocations for a few architectures that do
@@ -304,26 +412,26 @@ int mod_symvalue(FAR struct mod_loadinfo_s *loadinfo, FAR Elf32_Sym *sym)
 
         /* Check if the base code exports a symbol of this name */
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-        symbol = symtab_findorderedbyname(g_mod_symtab,
-                                          (FAR char *)loadinfo->iobuffer,
+#if defined(CONFIG_SYMTAB_ORDEREDBYNAME)
+        symbol = symtab_findorderedbyname(g_mod_symtab, name,
                                           g_mod_nsymbols);
+#elif defined(CONFIG_SYMTAB_HASHED)
+        symbol = symtab_findhashedbyname(g_mod_symtab, name,
+                                         g_mod_nsymbols);
 #else
-        symbol = symtab_findbyname(g_mod_symtab,
-                                   (FAR char *)loadinfo->iobuffer,
-                                   g_mod_nsymbols);
+        symbol = symtab_findbyname(g_mod_symtab, name, g_mod_nsymbols);
 #endif
         if (!symbol)
           {
             serr("ERROR: SHN_UNDEF: Exported symbol \"%s\" not found\n",
-                 loadinfo->iobuffer);
+                 name);
             return -ENOENT;
           }
 
         /* Yes... add the exported symbol value to the ELF symbol table entry */
 
         sinfo("SHN_ABS: name=%s %08x+%08x=%08x\n",
-              loadinfo->iobuffer, sym->st_value, symbol->sym_value,
+              name, sym->st_value, symbol->sym_value,
               sym->st_value + symbol->sym_value);
 
         sym->st_value += (Elf32_Word)((uintptr_t)symbol->sym_value);
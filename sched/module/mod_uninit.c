@@ -110,5 +110,14 @@ int mod_freebuffers(struct mod_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+  if (loadinfo->symcache)
+    {
+      kmm_free((FAR void *)loadinfo->symcache);
+      loadinfo->symcache  = NULL;
+      loadinfo->nsymcache = 0;
+    }
+
+  mod_freesymtab(loadinfo);
+
   return OK;
 }
@@ -92,6 +92,12 @@ struct mod_loadinfo_s
   Elf32_Ehdr        ehdr;        /* Buffered module file header */
   FAR Elf32_Shdr   *shdr;        /* Buffered module section headers */
   uint8_t          *iobuffer;    /* File I/O buffer */
+  FAR uintptr_t    *symcache;    /* Exported values of undefined symbols
+                                  * (by symbol index) while binding */
+  int               nsymcache;   /* Number of entries in symcache[] */
+  FAR const Elf32_Sym *symbols;  /* Symbol table in memory (or NULL) */
+  FAR const char   *strings;     /* Symbol string table in memory (or NULL) */
+  FAR void         *taballoc;    /* Memory holding symbols[] and strings[] */
 
   uint16_t          symtabidx;   /* Symbol table section index */
   uint16_t          strtabidx;   /* String table section index */
@@ -265,6 +271,29 @@ int mod_findsection(FAR struct mod_loadinfo_s *loadinfo,
 
 int mod_findsymtab(FAR struct mod_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: mod_loadsymtab
+ *
+ * Description:
+ *   Bring the whole symbol table and its string table into memory so that
+ *   mod_readsym() and mod_symvalue() do not need to read the file for each
+ *   symbol.  This is only an optimization:  Nothing is done if there is not
+ *   enough memory.
+ *
+ ****************************************************************************/
+
+void mod_loadsymtab(FAR struct mod_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: mod_freesymtab
+ *
+ * Description:
+ *   Release the memory allocated by mod_loadsymtab().
+ *
+ ****************************************************************************/
+
+void mod_freesymtab(FAR struct mod_loadinfo_s *loadinfo);
+
 /****************************************************************************
  * Name: mod_readsym
  *
@@ -54,6 +54,55 @@
 #include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_msgremfirst
+ *
+ * Description:
+ *   Remove the first (highest priority) message from the message list.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_PRIOBUCKETS
+static FAR struct mqueue_msg_s *
+mq_msgremfirst(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  int bucket;
+
+  mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist);
+  if (mqmsg)
+    {
+      /* The message was the first in its bucket */
+
+      bucket = MQ_BUCKET(mqmsg->priority);
+      DEBUGASSERT(msgq->buckethead[bucket] == mqmsg);
+
+      if (msgq->buckettail[bucket] == mqmsg)
+        {
+          msgq->buckethead[bucket] = NULL;
+          msgq->buckettail[bucket] = NULL;
+          msgq->bucketset &= ~((uint32_t)1 << bucket);
+        }
+      else
+        {
+          msgq->buckethead[bucket] = mqmsg->next;
+        }
+    }
+
+  return mqmsg;
+}
+#else
+#  define mq_msgremfirst(msgq) \
+     ((FAR struct mqueue_msg_s *)sq_remfirst(&(msgq)->msglist))
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -126,6 +175,10 @@ int mq_verifyreceive(mqd_t mqdes, FAR char *msg, size_t msglen)
  *   interrupted by a signal or a timeout, then the errno will be set
  *   appropriately and NULL will be returned.
  *
+ *   With CONFIG_MQ_DIRECTHANDOFF, NULL is also returned if a sender copied
+ *   the message directly into the buffer at this_task()->msgbuffer.  Then
+ *   this_task()->msglen is not negative.
+ *
  * Assumptions:
  * - The caller has provided all validity checking of the input parameters
  *   using mq_verifyreceive.
@@ -147,7 +200,7 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
 
   /* Get the message from the head of the queue */
 
-  while ((rcvmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist)) == NULL)
+  while ((rcvmsg = mq_msgremfirst(msgq)) == NULL)
     {
       /* The queue is empty!  Should we block until there the above condition
        * has been satisfied?
@@ -160,6 +213,9 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
           rtcb = this_task();
           rtcb->msgwaitq = msgq;
           msgq->nwaitnotempty++;
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+          rtcb->msglen   = -1;
+#endif
 
           set_errno(OK);
           up_block_task(rtcb, TSTATE_WAIT_MQNOTEMPTY);
@@ -174,6 +230,17 @@ FAR struct mqueue_msg_s *mq_waitreceive(mqd_t mqdes)
             {
               break;
             }
+
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+          /* Or (3) the sender has already copied the message into the
+           * caller's buffer.  NULL is returned with the errno value OK.
+           */
+
+          if (rtcb->msglen >= 0)
+            {
+              break;
+            }
+#endif
         }
       else
         {
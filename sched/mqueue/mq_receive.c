@@ -48,6 +48,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 
+#include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
 /****************************************************************************
@@ -97,6 +98,9 @@
 ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
                    FAR int *prio)
 {
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  FAR struct tcb_s *rtcb = this_task();
+#endif
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
   ssize_t ret = ERROR;
@@ -127,9 +131,22 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  /* If we have to wait, a sender may copy the message directly into the
+   * caller's buffer.
+   */
+
+  rtcb->msgbuffer = msg;
+  rtcb->msglen    = -1;
+#endif
+
   /* Get the message from the message queue */
 
   mqmsg = mq_waitreceive(mqdes);
+
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  rtcb->msgbuffer = NULL;
+#endif
   leave_critical_section(flags);
 
   /* Check if we got a message from the message queue.  We might
@@ -143,6 +160,19 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
     {
       ret = mq_doreceive(mqdes, mqmsg, msg, prio);
     }
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  else if (rtcb->msglen >= 0)
+    {
+      /* The message was copied directly into the caller's buffer */
+
+      if (prio)
+        {
+          *prio = rtcb->msgprio;
+        }
+
+      ret = rtcb->msglen;
+    }
+#endif
 
   sched_unlock();
   return ret;
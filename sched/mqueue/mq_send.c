@@ -125,6 +125,18 @@ int mq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
    */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  /* If a receiver is waiting on the empty queue, just give it the message */
+
+  if (mq_handoff(msgq, msg, msglen, prio))
+    {
+      leave_critical_section(flags);
+      sched_unlock();
+      return OK;
+    }
+#endif
+
   if (up_interrupt_context()      || /* In an interrupt handler */
       msgq->nmsgs < msgq->maxmsgs || /* OR Message queue not full */
       mq_waitsend(mqdes) == OK)      /* OR Successfully waited for mq not full */
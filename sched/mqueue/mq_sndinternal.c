@@ -60,6 +60,97 @@
 #endif
 #include "mqueue/mqueue.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mq_msginsert
+ *
+ * Description:
+ *   Insert a message in the prioritized message list using the priority
+ *   buckets:  The message normally goes right after the last message in
+ *   its bucket or, if its bucket is empty, after the last message in the
+ *   nearest higher priority bucket.  Only if the bucket holds messages of
+ *   a lower priority is the bucket searched.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_PRIOBUCKETS
+static void mq_msginsert(FAR struct mqueue_inode_s *msgq,
+                         FAR struct mqueue_msg_s *mqmsg)
+{
+  FAR struct mqueue_msg_s *prev = NULL;
+  FAR struct mqueue_msg_s *next;
+  uint32_t higher;
+  int bucket = MQ_BUCKET(mqmsg->priority);
+  int i;
+
+  if ((msgq->bucketset & ((uint32_t)1 << bucket)) != 0)
+    {
+      prev = msgq->buckettail[bucket];
+      if (prev->priority < mqmsg->priority)
+        {
+          /* Search the bucket for the first message of lower priority */
+
+          for (prev = NULL, next = msgq->buckethead[bucket];
+               mqmsg->priority <= next->priority;
+               prev = next, next = next->next);
+
+          if (prev == NULL)
+            {
+              /* The message becomes the first in its bucket */
+
+              msgq->buckethead[bucket] = mqmsg;
+              for (i = bucket + 1; i < MQ_NBUCKETS; i++)
+                {
+                  if ((msgq->bucketset & ((uint32_t)1 << i)) != 0)
+                    {
+                      prev = msgq->buckettail[i];
+                      break;
+                    }
+                }
+            }
+        }
+      else
+        {
+          msgq->buckettail[bucket] = mqmsg;
+        }
+    }
+  else
+    {
+      /* Start a new bucket after the nearest higher priority bucket */
+
+      msgq->buckethead[bucket] = mqmsg;
+      msgq->buckettail[bucket] = mqmsg;
+      msgq->bucketset |= (uint32_t)1 << bucket;
+
+      higher = bucket + 1 < MQ_NBUCKETS ? msgq->bucketset >> (bucket + 1) : 0;
+      for (i = bucket + 1; higher != 0; i++, higher >>= 1)
+        {
+          if ((higher & 1) != 0)
+            {
+              prev = msgq->buckettail[i];
+              break;
+            }
+        }
+    }
+
+  if (prev)
+    {
+      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
+                  &msgq->msglist);
+    }
+  else
+    {
+      sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -285,6 +376,69 @@ int mq_waitsend(mqd_t mqdes)
   return OK;
 }
 
+/****************************************************************************
+ * Name: mq_handoff
+ *
+ * Description:
+ *   This is internal, common logic shared by both mq_send and mq_timesend.
+ *   If a receiver is blocked waiting for a message on the empty message
+ *   queue, copy the message directly into the receiver's buffer and wake
+ *   the receiver.  The message is then neither allocated nor queued.
+ *
+ * Parameters:
+ *   msgq - The message queue
+ *   msg - Message to send
+ *   msglen - The length of the message in bytes
+ *   prio - The priority of the message
+ *
+ * Return Value:
+ *   True if the message was handed off; false if it must be queued.
+ *
+ * Assumptions/restrictions:
+ * - The caller has verified the input parameters using mq_verifysend().
+ * - Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+bool mq_handoff(FAR struct mqueue_inode_s *msgq, FAR const char *msg,
+                size_t msglen, int prio)
+{
+  FAR struct tcb_s *btcb;
+
+  /* Messages already queued must be received first */
+
+  if (msgq->nwaitnotempty <= 0 || msgq->msglist.head != NULL)
+    {
+      return false;
+    }
+
+  /* Find the highest priority task that is waiting for this queue to be
+   * non-empty.
+   */
+
+  for (btcb = (FAR struct tcb_s *)g_waitingformqnotempty.head;
+       btcb && btcb->msgwaitq != msgq;
+       btcb = btcb->flink);
+
+  if (btcb == NULL || btcb->msgbuffer == NULL)
+    {
+      return false;
+    }
+
+  /* Deliver the message and wake the receiver */
+
+  memcpy(btcb->msgbuffer, msg, msglen);
+  btcb->msglen   = msglen;
+  btcb->msgprio  = prio;
+  btcb->msgwaitq = NULL;
+  msgq->nwaitnotempty--;
+
+  up_unblock_task(btcb);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: mq_dosend
  *
@@ -313,8 +467,10 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 {
   FAR struct tcb_s *btcb;
   FAR struct mqueue_inode_s *msgq;
+#ifndef CONFIG_MQ_PRIOBUCKETS
   FAR struct mqueue_msg_s *next;
   FAR struct mqueue_msg_s *prev;
+#endif
   irqstate_t flags;
 
   /* Get a pointer to the message queue */
@@ -335,6 +491,11 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
 
   flags = enter_critical_section();
 
+#ifdef CONFIG_MQ_PRIOBUCKETS
+  /* Insert the message using the priority buckets */
+
+  mq_msginsert(msgq, mqmsg);
+#else
   /* Search the message list to find the location to insert the new
    * message. Each is list is maintained in ascending priority order.
    */
@@ -354,6 +515,7 @@ int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg, FAR const char *msg,
     {
       sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
     }
+#endif
 
   /* Increment the count of messages in the queue */
 
@@ -258,10 +258,23 @@ ssize_t mq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
       wd_start(rtcb->waitdog, ticks, (wdentry_t)mq_rcvtimeout, 1, getpid());
     }
 
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  /* If we have to wait, a sender may copy the message directly into the
+   * caller's buffer.
+   */
+
+  rtcb->msgbuffer = msg;
+  rtcb->msglen    = -1;
+#endif
+
   /* Get the message from the message queue */
 
   mqmsg = mq_waitreceive(mqdes);
 
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  rtcb->msgbuffer = NULL;
+#endif
+
   /* Stop the watchdog timer (this is not harmful in the case where
    * it was never started)
    */
@@ -284,6 +297,19 @@ ssize_t mq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
     {
       ret = mq_doreceive(mqdes, mqmsg, msg, prio);
     }
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  else if (rtcb->msglen >= 0)
+    {
+      /* The message was copied directly into the caller's buffer */
+
+      if (prio)
+        {
+          *prio = rtcb->msgprio;
+        }
+
+      ret = rtcb->msglen;
+    }
+#endif
 
   sched_unlock();
   wd_delete(rtcb->waitdog);
@@ -189,6 +189,24 @@ int mq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio,
       return ERROR;
     }
 
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+  /* If a receiver is waiting on the empty queue, just give it the message.
+   * There is then no need to allocate a message structure.
+   */
+
+  sched_lock();
+  flags = enter_critical_section();
+  if (mq_handoff(mqdes->msgq, msg, msglen, prio))
+    {
+      leave_critical_section(flags);
+      sched_unlock();
+      return OK;
+    }
+
+  leave_critical_section(flags);
+  sched_unlock();
+#endif
+
   /* Pre-allocate a message structure */
 
   mqmsg = mq_msgalloc();
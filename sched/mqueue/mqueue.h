@@ -163,6 +163,10 @@ ssize_t mq_doreceive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio);
 FAR struct mqueue_msg_s *mq_msgalloc(void);
 int mq_waitsend(mqd_t mqdes);
+#ifdef CONFIG_MQ_DIRECTHANDOFF
+bool mq_handoff(FAR struct mqueue_inode_s *msgq, FAR const char *msg,
+                size_t msglen, int prio);
+#endif
 int mq_dosend(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
               FAR const char *msg, size_t msglen, int prio);
 
@@ -69,6 +69,9 @@
  *        is resolved and all logic associated with the page fill worker
  *        must be "locked" and always present in memory.
  *      - ASSERT if an interrupt was executing at the time of the exception.
+ *      - Call up_checkmapping() to see if the mapping is already in place
+ *        (or can be restored without a fill).  If so, just return so that
+ *        the faulting instruction is retried.
  *   2) Block the currently executing task.
  *      - Call up_block_task() to block the task at the head of the ready-
  *        to-run list.  This should cause an interrupt level context switch
@@ -132,9 +135,22 @@ void pg_miss(void)
    * always present in memory.
    */
 
-  pginfo("Blocking TCB: %p PID: %d\n", ftcb, ftcb->pid);
   DEBUGASSERT(g_pgworker != ftcb->pid);
 
+  /* The page may already be mapped if another task faulted on it and the
+   * fill completed in the meantime.  Or the page may still be resident but
+   * its mapping temporarily removed by the page replacement logic in order
+   * to detect references to it.  In either case, no fill is needed.
+   */
+
+  if (up_checkmapping(ftcb))
+    {
+      pginfo("Mapped TCB: %p PID: %d\n", ftcb, ftcb->pid);
+      return;
+    }
+
+  pginfo("Blocking TCB: %p PID: %d\n", ftcb, ftcb->pid);
+
   /* Block the currently executing task
    * - Call up_block_task() to block the task at the head of the ready-
    *   to-run list.  This should cause an interrupt level context switch
@@ -110,6 +110,16 @@ static systime_t g_starttime;
 #endif
 #endif
 
+#ifdef CONFIG_PAGING_PREFETCH
+/* The virtual address of the last page that was filled (or prefetched) and
+ * an indication that the last page fill was for the page immediately
+ * following it, i.e., that the faulting task is executing sequentially.
+ */
+
+static uintptr_t g_pglast;
+static bool g_pgstream;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -369,6 +379,15 @@ static inline bool pg_startfill(void)
       result = up_allocpage(g_pftcb, &vpage);
       DEBUGASSERT(result == OK);
 
+#ifdef CONFIG_PAGING_PREFETCH
+      /* Detect sequential page faults.  These will be followed by a
+       * prefetch of the next pages when there is nothing else to do.
+       */
+
+      g_pgstream = ((uintptr_t)vpage == g_pglast + PAGESIZE);
+      g_pglast   = (uintptr_t)vpage;
+#endif
+
       /* Start the fill.  The exact way that the fill is started depends upon
        * the nature of the architecture-specific up_fillpage() function -- Is it
        * a blocking or a non-blocking call?
@@ -459,6 +478,87 @@ static inline void pg_alldone(void)
   sched_setpriority(wtcb, CONFIG_PAGING_DEFPRIO);
 }
 
+/****************************************************************************
+ * Name: pg_prefetch
+ *
+ * Description:
+ *   Called by the page fill worker thread after all pending page fills
+ *   have been completed.  If the last page fill followed the page filled
+ *   before it, then the next CONFIG_PAGING_PREFETCH_NPAGES pages are filled
+ *   as well so that a task executing sequentially does not take a page
+ *   fault on each page.
+ *
+ *   The page fill worker thread is running at its default (minimum)
+ *   priority at this point so that prefetching will not delay any higher
+ *   priority task.  Prefetching is abandoned as soon as a new page fault
+ *   is queued.
+ *
+ * Input parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PAGING_PREFETCH
+static inline void pg_prefetch(void)
+{
+  FAR void *vpage;
+  int result;
+  int i;
+
+  if (!g_pgstream)
+    {
+      return;
+    }
+
+  g_pgstream = false;
+  for (i = 0; i < CONFIG_PAGING_PREFETCH_NPAGES; i++)
+    {
+      /* Stop if a page fault must be serviced */
+
+      if (g_waitingforfill.head != NULL)
+        {
+          break;
+        }
+
+      /* Allocate the next page.  Skip over pages that are already in
+       * memory and stop at the end of the paged text region.
+       */
+
+      result = up_prefetchpage(g_pglast + PAGESIZE, &vpage);
+      if (result == -EEXIST)
+        {
+          g_pglast += PAGESIZE;
+          continue;
+        }
+      else if (result < 0)
+        {
+          break;
+        }
+
+      /* Fill the page.  The page is filled with the same blocking
+       * up_fillpage() call as for a page fault, but with no TCB.
+       */
+
+      pginfo("Call up_fillpage(%p)\n", vpage);
+      result = up_fillpage(NULL, vpage);
+      DEBUGASSERT(result == OK);
+
+      /* Remember the last page so that a fault on the page after it will
+       * be recognized as sequential.
+       */
+
+      g_pglast = (uintptr_t)vpage;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: pg_fillcomplete
  *
@@ -630,40 +730,58 @@ int pg_worker(int argc, char *argv[])
            (void)pg_startfill();
         }
 #else
-      /* Are there tasks blocked and waiting for a fill?  Loop until all
-       * pending fills have been processed.
-       */
-
-      for (; ; )
+      do
         {
-          /* Yes .. Start the fill and block until the fill completes.
-           * Check the return value to see a fill was actually performed.
-           * (false means that no fill was perforemd).
+          /* Are there tasks blocked and waiting for a fill?  Loop until all
+           * pending fills have been processed.
            */
 
-          pginfo("Calling pg_startfill\n");
-          if (!pg_startfill())
+          for (; ; )
             {
-              /* Break out of the loop -- there is nothing more to do */
+              /* Yes .. Start the fill and block until the fill completes.
+               * Check the return value to see a fill was actually performed.
+               * (false means that no fill was perforemd).
+               */
 
-              break;
+              pginfo("Calling pg_startfill\n");
+              if (!pg_startfill())
+                {
+                  /* Break out of the loop -- there is nothing more to do */
+
+                  break;
+                }
+
+              /* Handle the page fill complete event by restarting the
+               * task that was blocked waiting for this page fill. In the
+               * non-blocking fill case, the page fill worker thread will
+               * know that the page fill is  complete when pg_startfill()
+               * returns true.
+               */
+
+              pginfo("Restarting TCB: %p\n", g_pftcb);
+              up_unblock_task(g_pftcb);
             }
 
-          /* Handle the page fill complete event by restarting the
-           * task that was blocked waiting for this page fill. In the
-           * non-blocking fill case, the page fill worker thread will
-           * know that the page fill is  complete when pg_startfill()
-           * returns true.
-           */
+          /* All queued fills have been processed */
 
-          pginfo("Restarting TCB: %p\n", g_pftcb);
-          up_unblock_task(g_pftcb);
-        }
+          pginfo("Call pg_alldone()\n");
+          pg_alldone();
 
-      /* All queued fills have been processed */
+#ifdef CONFIG_PAGING_PREFETCH
+          /* Now that the worker is back at its default priority, prefetch the
+           * pages following a sequential fault.
+           */
 
-      pginfo("Call pg_alldone()\n");
-      pg_alldone();
+          pg_prefetch();
+#endif
+
+          /* The tasks just restarted may have faulted again after the
+           * priority of the worker thread was lowered.  pg_miss() would then
+           * have signaled us while we were not waiting so check again
+           * before returning to the usleep() above.
+           */
+        }
+      while (g_waitingforfill.head != NULL);
 #endif
     }
 
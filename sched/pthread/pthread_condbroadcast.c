@@ -44,6 +44,10 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -56,6 +60,12 @@
  * Description:
  *    A thread broadcast on a condition variable.
  *
+ *    Rather than making every waiting thread ready-to-run, only to have all
+ *    but one of them block again on the mutex, the waits are "morphed":
+ *    Each waiting thread is moved directly from the condition semaphore onto
+ *    the semaphore of the mutex that it released in pthread_cond_wait().
+ *    The threads then run one at a time as the mutex is passed along.
+ *
  * Parameters:
  *   None
  *
@@ -68,6 +78,9 @@
 
 int pthread_cond_broadcast(FAR pthread_cond_t *cond)
 {
+  FAR struct tcb_s *wtcb;
+  FAR struct tcb_s *next;
+  irqstate_t flags;
   int ret = OK;
   int sval;
 
@@ -79,12 +92,13 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
     }
   else
     {
-      /* Disable pre-emption until all of the waiting threads have been
-       * restarted. This is necessary to assure that the sval behaves as
-       * expected in the following while loop
+      /* Disable pre-emption and interrupts until all of the waiting threads
+       * have been requeued or restarted.  This is necessary to assure that
+       * the sval and the list of waiting threads do not change under us.
        */
 
       sched_lock();
+      flags = enter_critical_section();
 
       /* Get the current value of the semaphore */
 
@@ -94,20 +108,39 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
         }
       else
         {
-          /* Loop until all of the waiting threads have been restarted. */
-
-          while (sval < 0)
+          /* Visit each thread waiting on the condition.  The list of
+           * threads waiting on semaphores is prioritized, so the highest
+           * priority thread is the first to get the mutex.
+           */
+
+          for (wtcb = (FAR struct tcb_s *)g_waitingforsemaphore.head;
+               wtcb != NULL && sval < 0;
+               wtcb = next)
             {
-              /* If the value is less than zero (meaning that one or more
-               * thread is waiting), then post the condition semaphore.
-               * Only the highest priority waiting thread will get to execute
-               */
-
-              ret = pthread_givesemaphore((FAR sem_t *)&cond->sem);
-
-              /* Increment the semaphore count (as was done by the
-               * above post).
-               */
+              next = wtcb->flink;
+
+              if (wtcb->waitsem != (FAR sem_t *)&cond->sem)
+                {
+                  continue;
+                }
+
+              if (wtcb->condmutex != NULL)
+                {
+                  /* Move the wait onto the mutex */
+
+                  sem_requeue(wtcb, wtcb->condmutex);
+                }
+              else
+                {
+                  /* We don't know the mutex.  Just post the condition
+                   * semaphore to wake the highest priority waiter.  That
+                   * may not be this thread, so start over from the head of
+                   * the list.
+                   */
+
+                  ret  = pthread_givesemaphore((FAR sem_t *)&cond->sem);
+                  next = (FAR struct tcb_s *)g_waitingforsemaphore.head;
+                }
 
               sval++;
             }
@@ -115,11 +148,10 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
 
       /* Now we can let the restarted threads run */
 
+      leave_critical_section(flags);
       sched_unlock();
     }
 
   sinfo("Returning %d\n", ret);
   return ret;
 }
-
-
@@ -85,6 +85,17 @@ int pthread_cond_init(FAR pthread_cond_t *cond, FAR const pthread_condattr_t *at
       ret = EINVAL;
     }
 
+#ifdef CONFIG_PTHREAD_FUTEX
+  /* Initialize the user-space condition state */
+
+  else
+    {
+      cond->seq      = 0;
+      cond->nwaiters = 0;
+      cond->mutex    = NULL;
+    }
+#endif
+
   sinfo("Returning %d\n", ret);
   return ret;
 }
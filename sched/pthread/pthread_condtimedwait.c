@@ -41,6 +41,7 @@
 #include <nuttx/compiler.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <signal.h>
@@ -171,6 +172,7 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
   int ticks;
   int mypid = (int)getpid();
   irqstate_t flags;
+  bool requeued = false;
   int ret = OK;
   int status;
 
@@ -276,14 +278,23 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
                       /* Take the condition semaphore.  Do not restore interrupts
                        * until we return from the wait.  This is necessary to
                        * make sure that the watchdog timer and the condition wait
-                       * are started atomically.
+                       * are started atomically.  Record the mutex so that
+                       * pthread_cond_broadcast() can move the wait onto it.
                        */
 
+                      rtcb->condmutex = (FAR sem_t *)&mutex->sem;
                       status = sem_wait((FAR sem_t *)&cond->sem);
 
-                      /* Did we get the condition semaphore. */
+                      requeued         = (rtcb->flags & TCB_FLAG_SEM_REQUEUED) != 0;
+                      rtcb->flags     &= ~TCB_FLAG_SEM_REQUEUED;
+                      rtcb->condmutex  = NULL;
 
-                      if (status != OK)
+                      /* Did we get the condition semaphore?  If the wait was
+                       * requeued onto the mutex, then the condition was
+                       * signaled even if the wait for the mutex timed out.
+                       */
+
+                      if (status != OK && !requeued)
                         {
                           /* NO.. Handle the special case where the semaphore wait was
                            * awakened by the receipt of a signal -- presumably the
@@ -310,17 +321,26 @@ int pthread_cond_timedwait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex,
                       leave_critical_section(flags);
                     }
 
-                  /* Reacquire the mutex (retaining the ret). */
+                  /* Reacquire the mutex (retaining the ret), unless the
+                   * wait was requeued onto the mutex and we already hold it.
+                   */
 
-                  sinfo("Re-locking...\n");
-                  status = pthread_takesemaphore((FAR sem_t *)&mutex->sem);
-                  if (!status)
+                  if (requeued && status == OK)
                     {
                       mutex->pid = mypid;
                     }
-                  else if (!ret)
+                  else
                     {
-                      ret = status;
+                      sinfo("Re-locking...\n");
+                      status = pthread_takesemaphore((FAR sem_t *)&mutex->sem);
+                      if (!status)
+                        {
+                          mutex->pid = mypid;
+                        }
+                      else if (!ret)
+                        {
+                          ret = status;
+                        }
                     }
                 }
 
@@ -39,12 +39,14 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <sched.h>
 #include <errno.h>
 #include <debug.h>
 
+#include "sched/sched.h"
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -69,6 +71,9 @@
 
 int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
 {
+  FAR struct tcb_s *rtcb = this_task();
+  bool requeued;
+  int status;
   int ret;
 
   sinfo("cond=0x%p mutex=0x%p\n", cond, mutex);
@@ -96,22 +101,51 @@ int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
       mutex->pid = -1;
       ret = pthread_givesemaphore((FAR sem_t *)&mutex->sem);
 
-      /* Take the semaphore */
+      /* Take the semaphore.  Record the mutex so that
+       * pthread_cond_broadcast() can move this wait directly onto the
+       * mutex rather than waking us up only to contend for it.
+       */
+
+      rtcb->condmutex = (FAR sem_t *)&mutex->sem;
+
+      do
+        {
+          status = sem_wait((FAR sem_t *)&cond->sem);
+        }
+      while (status != OK && get_errno() == EINTR &&
+             (rtcb->flags & TCB_FLAG_SEM_REQUEUED) == 0);
+
+      requeued         = (rtcb->flags & TCB_FLAG_SEM_REQUEUED) != 0;
+      rtcb->flags     &= ~TCB_FLAG_SEM_REQUEUED;
+      rtcb->condmutex  = NULL;
+
+      if (status != OK && !requeued)
+        {
+          ret = status;
+        }
 
-      ret |= pthread_takesemaphore((FAR sem_t *)&cond->sem);
       sched_unlock();
 
-      /* Reacquire the mutex */
+      /* If the wait was requeued onto the mutex, then we already hold the
+       * mutex (unless the wait for it was interrupted by a signal).
+       * Otherwise, reacquire the mutex.
+       */
 
-      sinfo("Reacquire mutex...\n");
-      ret |= pthread_takesemaphore((FAR sem_t *)&mutex->sem);
-      if (!ret)
+      if (requeued && status == OK)
         {
           mutex->pid = getpid();
         }
+      else
+        {
+          sinfo("Reacquire mutex...\n");
+          ret |= pthread_takesemaphore((FAR sem_t *)&mutex->sem);
+          if (!ret)
+            {
+              mutex->pid = getpid();
+            }
+        }
     }
 
   sinfo("Returning %d\n", ret);
   return ret;
 }
-
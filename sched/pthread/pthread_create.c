@@ -246,7 +246,12 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
 
   /* Allocate a TCB for the new task. */
 
+#ifdef CONFIG_SCHED_TCBPOOL
+  ptcb = (FAR struct pthread_tcb_s *)
+    sched_tcballoc(TCB_FLAG_TTYPE_PTHREAD, attr->stacksize);
+#else
   ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+#endif
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -287,10 +292,17 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
       goto errout_with_tcb;
     }
 
-  /* Allocate the stack for the TCB */
+  /* Allocate the stack for the TCB (unless a pooled TCB still has one) */
+
+#ifdef CONFIG_SCHED_TCBPOOL
+  ret = OK;
+  if (ptcb->cmn.stack_alloc_ptr == NULL)
+#endif
+    {
+      ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
+                            TCB_FLAG_TTYPE_PTHREAD);
+    }
 
-  ret = up_create_stack((FAR struct tcb_s *)ptcb, attr->stacksize,
-                        TCB_FLAG_TTYPE_PTHREAD);
   if (ret != OK)
     {
       errcode = ENOMEM;
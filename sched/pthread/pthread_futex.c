@@ -0,0 +1,340 @@
+/****************************************************************************
+ * sched/pthread/pthread_futex.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/pthread.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_PTHREAD_FUTEX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One thread blocked in futex_wait().  The structure lives on the stack of
+ * the waiting thread.
+ */
+
+struct futex_waiter_s
+{
+  FAR struct futex_waiter_s *flink;  /* Supports a singly linked list */
+  FAR volatile int *uaddr;           /* The futex word waited on */
+#ifdef CONFIG_ARCH_ADDRENV
+  FAR struct task_group_s *group;    /* The address space of uaddr */
+#endif
+  sem_t sem;                         /* The waiting thread blocks here */
+  bool woken;                        /* Set by futex_wake() */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All threads blocked in futex_wait(), in the order that they blocked.
+ * Protected by a critical section.
+ */
+
+static sq_queue_t g_futexq;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex_match
+ *
+ * Description:
+ *   Return true if the waiter is waiting on the futex word 'uaddr' of the
+ *   calling thread.  With separate address spaces, the same user address
+ *   in different task groups refers to different futex words.
+ *
+ ****************************************************************************/
+
+static inline bool futex_match(FAR struct futex_waiter_s *waiter,
+                               FAR volatile int *uaddr)
+{
+#ifdef CONFIG_ARCH_ADDRENV
+  return waiter->uaddr == uaddr && waiter->group == this_task()->group;
+#else
+  return waiter->uaddr == uaddr;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Block the calling thread if, and only if, the word at 'uaddr' still
+ *   holds the value 'val'.
+ *
+ * Input Parameters:
+ *   uaddr   - The address of the futex word
+ *   val     - The value that the caller last saw in the word
+ *   abstime - If non-NULL, the CLOCK_REALTIME time at which to give up
+ *
+ * Returned Value:
+ *   Zero (OK) if awakened by futex_wake().  Otherwise -1 (ERROR) with errno
+ *   set to EAGAIN (the word no longer holds 'val'), EINTR or ETIMEDOUT.
+ *
+ ****************************************************************************/
+
+int futex_wait(FAR volatile int *uaddr, int val,
+               FAR const struct timespec *abstime)
+{
+  struct futex_waiter_s waiter;
+  irqstate_t flags;
+  int errcode;
+  int ret;
+
+  if (uaddr == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  waiter.uaddr = uaddr;
+#ifdef CONFIG_ARCH_ADDRENV
+  waiter.group = this_task()->group;
+#endif
+  waiter.woken = false;
+  (void)sem_init(&waiter.sem, 0, 0);
+
+  /* Compare the word and queue the waiter atomically with respect to
+   * futex_wake().  If the word has already changed, then the wake-up that
+   * changed it may already have happened.
+   */
+
+  flags = enter_critical_section();
+  if (*uaddr != val)
+    {
+      leave_critical_section(flags);
+      sem_destroy(&waiter.sem);
+      set_errno(EAGAIN);
+      return ERROR;
+    }
+
+  sq_addlast((FAR sq_entry_t *)&waiter, &g_futexq);
+  leave_critical_section(flags);
+
+  /* Wait to be awakened.  The semaphore counts, so a futex_wake() before
+   * we get here is not lost.
+   */
+
+#ifndef CONFIG_DISABLE_SIGNALS
+  if (abstime != NULL)
+    {
+      ret = sem_timedwait(&waiter.sem, abstime);
+    }
+  else
+#endif
+    {
+      ret = sem_wait(&waiter.sem);
+    }
+
+  errcode = get_errno();
+
+  /* If a signal or the timeout ended the wait, we may still be queued.
+   * But if futex_wake() dequeued us in the meantime, then report the
+   * wake-up so that it is not lost.
+   */
+
+  flags = enter_critical_section();
+  if (!waiter.woken)
+    {
+      sq_rem((FAR sq_entry_t *)&waiter, &g_futexq);
+    }
+  else
+    {
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  sem_destroy(&waiter.sem);
+
+  if (ret < 0)
+    {
+      set_errno(errcode);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake up to 'nwake' threads blocked in futex_wait() on 'uaddr'.
+ *
+ * Returned Value:
+ *   The number of threads awakened.
+ *
+ ****************************************************************************/
+
+int futex_wake(FAR volatile int *uaddr, int nwake)
+{
+  FAR struct futex_waiter_s *waiter;
+  FAR struct futex_waiter_s *next;
+  FAR struct futex_waiter_s *prev = NULL;
+  irqstate_t flags;
+  int nwoken = 0;
+
+  flags = enter_critical_section();
+
+  for (waiter = (FAR struct futex_waiter_s *)g_futexq.head;
+       waiter != NULL && nwoken < nwake;
+       waiter = next)
+    {
+      next = waiter->flink;
+
+      if (futex_match(waiter, uaddr))
+        {
+          /* Dequeue the waiter before waking it; it is then free to
+           * return and release the structure.
+           */
+
+          if (prev == NULL)
+            {
+              (void)sq_remfirst(&g_futexq);
+            }
+          else
+            {
+              (void)sq_remafter((FAR sq_entry_t *)prev, &g_futexq);
+            }
+
+          waiter->woken = true;
+          sem_post(&waiter->sem);
+          nwoken++;
+        }
+      else
+        {
+          prev = waiter;
+        }
+    }
+
+  leave_critical_section(flags);
+  return nwoken;
+}
+
+/****************************************************************************
+ * Name: futex_requeue
+ *
+ * Description:
+ *   Wake up to 'nwake' threads blocked in futex_wait() on 'uaddr' and move
+ *   up to 'nrequeue' of the remaining ones so that they wait on 'uaddr2'
+ *   instead, without waking them.  This lets pthread_cond_broadcast() move
+ *   the waiters onto the mutex so that they do not all wake up only to
+ *   contend for it.
+ *
+ * Returned Value:
+ *   The number of threads awakened or requeued.
+ *
+ ****************************************************************************/
+
+int futex_requeue(FAR volatile int *uaddr, int nwake,
+                  FAR volatile int *uaddr2, int nrequeue)
+{
+  FAR struct futex_waiter_s *waiter;
+  FAR struct futex_waiter_s *next;
+  FAR struct futex_waiter_s *prev = NULL;
+  irqstate_t flags;
+  int nwoken = 0;
+  int nmoved = 0;
+
+  if (uaddr2 == NULL)
+    {
+      return futex_wake(uaddr, nwake);
+    }
+
+  flags = enter_critical_section();
+
+  for (waiter = (FAR struct futex_waiter_s *)g_futexq.head;
+       waiter != NULL && (nwoken < nwake || nmoved < nrequeue);
+       waiter = next)
+    {
+      next = waiter->flink;
+
+      if (!futex_match(waiter, uaddr))
+        {
+          prev = waiter;
+        }
+      else if (nwoken < nwake)
+        {
+          if (prev == NULL)
+            {
+              (void)sq_remfirst(&g_futexq);
+            }
+          else
+            {
+              (void)sq_remafter((FAR sq_entry_t *)prev, &g_futexq);
+            }
+
+          waiter->woken = true;
+          sem_post(&waiter->sem);
+          nwoken++;
+        }
+      else
+        {
+          /* The waiter stays queued in order; it just waits on the other
+           * futex word now.
+           */
+
+          waiter->uaddr = uaddr2;
+          prev          = waiter;
+          nmoved++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return nwoken + nmoved;
+}
+
+#endif /* CONFIG_PTHREAD_FUTEX */
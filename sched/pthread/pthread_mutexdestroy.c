@@ -88,7 +88,11 @@ int pthread_mutex_destroy(FAR pthread_mutex_t *mutex)
 
       /* Is the semaphore available? */
 
+#ifdef CONFIG_PTHREAD_FUTEX
+      if (mutex->pid != -1 || mutex->futex != 0)
+#else
       if (mutex->pid != -1)
+#endif
         {
           ret = EBUSY;
         }
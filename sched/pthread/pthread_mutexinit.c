@@ -96,6 +96,9 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex, FAR const pthread_mutexattr_t
       /* Indicate that the semaphore is not held by any thread. */
 
       mutex->pid = -1;
+#ifdef CONFIG_PTHREAD_FUTEX
+      mutex->futex = 0;
+#endif
 
       /* Initialize the mutex like a semaphore with initial count = 1 */
 
@@ -64,7 +64,17 @@
  */
 
 #define MAX_TASKS_MASK           (CONFIG_MAX_TASKS-1)
-#define PIDHASH(pid)             ((pid) & MAX_TASKS_MASK)
+
+/* If the PID table can grow, then its size is variable (but always a power
+ * of two).
+ */
+
+#ifdef CONFIG_SCHED_GROWPIDHASH
+#  define PIDHASH(pid)           ((pid) & (g_npidhash - 1))
+#else
+#  define g_npidhash             CONFIG_MAX_TASKS
+#  define PIDHASH(pid)           ((pid) & MAX_TASKS_MASK)
+#endif
 
 /* These are macros to access the current CPU and the current task on a CPU.
  * These macros are intended to support a future SMP implementation.
@@ -79,6 +89,24 @@
 #endif
 #define this_task()              (current_task(this_cpu()))
 
+/* Deferred de-allocations are kept in one list per CPU so that frees from
+ * interrupt handlers on different CPUs do not contend for the same list.
+ */
+
+#ifdef CONFIG_SMP
+#  define SCHED_NGARBAGE         CONFIG_SMP_NCPUS
+#else
+#  define SCHED_NGARBAGE         1
+#endif
+
+/* The maximum number of deferred de-allocations performed by one call to
+ * sched_garbage_collection().
+ */
+
+#ifndef CONFIG_SCHED_GARBAGE_BATCH
+#  define CONFIG_SCHED_GARBAGE_BATCH 16
+#endif
+
 /* List attribute flags */
 
 #define TLIST_ATTR_PRIORITIZED   (1 << 0) /* Bit 0: List is prioritized */
@@ -126,6 +154,54 @@ struct pidhash_s
 #endif
 };
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+/* This structure describes one call site recorded by the critical section
+ * monitor:  The code that disabled interrupts (enter_critical_section()) or
+ * pre-emption (sched_lock()) and the longest time that it kept them
+ * disabled, in units of up_perf_gettime().
+ */
+
+enum critmon_type_e
+{
+  CRITMON_CSECTION = 0,        /* enter_critical_section() */
+  CRITMON_PREEMPTION           /* sched_lock() */
+};
+
+struct critmon_site_s
+{
+  FAR void *caller;            /* Return address of the call (NULL=unused) */
+  uint32_t maxtime;            /* Longest time disabled */
+  uint32_t count;              /* Number of times recorded */
+  uint8_t type;                /* See enum critmon_type_e */
+};
+#endif
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+/* This structure holds the wake-up latencies of the threads of one
+ * priority.
+ */
+
+struct wakelat_prio_s
+{
+  bool inuse;                  /* True: This entry is assigned */
+  uint8_t priority;            /* The priority of the threads */
+  struct wakelat_hist_s hist;  /* Their wake-up latencies */
+};
+
+/* This structure describes the longest wake-up latency seen:  The thread
+ * that waited and the thread that was running when it was made ready.
+ */
+
+struct wakelat_worst_s
+{
+  uint32_t latency;            /* The latency, in units of up_perf_gettime() */
+  pid_t pid;                   /* The thread that waited */
+  pid_t runner;                /* The thread running when it was woken */
+  uint8_t priority;            /* Priority of the thread that waited */
+  bool locked;                 /* The runner had pre-emption disabled */
+};
+#endif
+
 /* This structure defines an element of the g_tasklisttable[].  This table
  * is used to map a task_state enumeration to the corresponding task list.
  */
@@ -242,12 +318,13 @@ extern volatile dq_queue_t g_inactivetasks;
 /* These are lists of dayed memory deallocations that need to be handled
  * within the IDLE loop or worker thread.  These deallocations get queued
  * by sched_kufree and sched_kfree() if the OS needs to deallocate memory
- * while it is within an interrupt handler.
+ * while it is within an interrupt handler.  There is one list per CPU,
+ * indexed by the CPU that queued the deallocation.
  */
 
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
      defined(CONFIG_MM_KERNEL_HEAP)
-extern volatile sq_queue_t g_delayed_kfree;
+extern volatile sq_queue_t g_delayed_kfree[SCHED_NGARBAGE];
 #endif
 
 #ifndef CONFIG_BUILD_KERNEL
@@ -259,7 +336,13 @@ extern volatile sq_queue_t g_delayed_kfree;
  * a group-by-group basis.
  */
 
-extern volatile sq_queue_t g_delayed_kufree;
+extern volatile sq_queue_t g_delayed_kufree[SCHED_NGARBAGE];
+#endif
+
+#ifdef CONFIG_SMP
+/* This spinlock protects the delayed deallocation lists of each CPU */
+
+extern volatile spinlock_t g_delayed_lock[CONFIG_SMP_NCPUS];
 #endif
 
 /* This is the value of the last process ID assigned to a task */
@@ -273,10 +356,17 @@ extern volatile pid_t g_lastpid;
  * 2. Is used to quickly map a process ID into a TCB.
  *
  * It has the side effects of using more memory and limiting the number
- * of tasks to CONFIG_MAX_TASKS.
+ * of tasks to CONFIG_MAX_TASKS (unless CONFIG_SCHED_GROWPIDHASH is selected;
+ * then g_pidhash points to a table of g_npidhash entries that is replaced
+ * with a larger one as needed).
  */
 
+#ifdef CONFIG_SCHED_GROWPIDHASH
+extern FAR struct pidhash_s *g_pidhash;
+extern volatile int g_npidhash;
+#else
 extern struct pidhash_s g_pidhash[CONFIG_MAX_TASKS];
+#endif
 
 /* This is a table of task lists.  This table is indexed by the task stat
  * enumeration type (tstate_t) and provides a pointer to the associated
@@ -295,6 +385,23 @@ extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
 extern volatile uint32_t g_cpuload_total;
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+/* The worst offenders seen by the critical section monitor.  Declared in
+ * sched_critmonitor.c.
+ */
+
+extern struct critmon_site_s g_critmon_sites[CONFIG_SCHED_CRITMONITOR_NSITES];
+#endif
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+/* The wake-up latencies per priority, in the order that the priorities
+ * were first seen, and the worst case.  Declared in sched_wakelat.c.
+ */
+
+extern struct wakelat_prio_s g_wakelat_prio[CONFIG_SCHED_WAKEUPLAT_NPRIO];
+extern struct wakelat_worst_s g_wakelat_worst;
+#endif
+
 /* Declared in sched_lock.c *************************************************/
 /* Pre-emption is disabled via the interface sched_lock(). sched_lock()
  * works by preventing context switches from the currently executing tasks.
@@ -357,9 +464,18 @@ extern volatile spinlock_t g_cpu_schedlock;
 
 /* Used to keep track of which CPU(s) hold the IRQ lock. */
 
-extern volatile spinlock_t g_cpu_locksetlock;
+extern volatile spinlock_set_t g_cpu_locksetlock;
 extern volatile cpu_set_t g_cpu_lockset;
 
+#ifdef CONFIG_SMP_RESCHED_IPI
+/* The need-resched flag of each CPU.  This is set by another CPU just before
+ * it sends the reschedule interrupt and is cleared only by the CPU that it
+ * belongs to.
+ */
+
+extern volatile bool g_cpu_resched[CONFIG_SMP_NCPUS];
+#endif
+
 #endif /* CONFIG_SMP */
 
 /****************************************************************************
@@ -393,6 +509,9 @@ int  sched_reprioritize(FAR struct tcb_s *tcb, int sched_priority);
 unsigned int sched_timer_cancel(void);
 void sched_timer_resume(void);
 void sched_timer_reassess(void);
+#ifdef CONFIG_HRTIMER
+void sched_alarm_reload(void);
+#endif
 #else
 #  define sched_timer_cancel() (0)
 #  define sched_timer_resume()
@@ -418,8 +537,26 @@ uint32_t sched_sporadic_process(FAR struct tcb_s *tcb, uint32_t ticks,
 void sched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  sched_deadline_start(FAR struct tcb_s *tcb,
+                          FAR const struct sched_param *param);
+int  sched_deadline_reset(FAR struct tcb_s *tcb);
+int  sched_deadline_stop(FAR struct tcb_s *tcb);
+int  sched_deadline_yield(FAR struct tcb_s *tcb);
+uint32_t sched_deadline_process(FAR struct tcb_s *tcb, uint32_t ticks,
+                                bool noswitches);
+void sched_deadline_throttle(FAR struct tcb_s *tcb);
+bool sched_deadline_before(FAR struct tcb_s *tcb1, FAR struct tcb_s *tcb2);
+#endif
+
 #ifdef CONFIG_SMP
 int sched_cpu_select(cpu_set_t affinity);
+#ifdef CONFIG_SMP_IDLE_BALANCE
+void sched_idle_balance(void);
+#endif
+#ifdef CONFIG_SMP_RESCHED_IPI
+void sched_resched_request(int cpu);
+#endif
 #  define sched_islocked(tcb) spin_islocked(&g_cpu_schedlock)
 #else
 #  define sched_islocked(tcb) ((tcb)->lockcount > 0)
@@ -429,13 +566,57 @@ int sched_cpu_select(cpu_set_t affinity);
 
 /* CPU load measurement support */
 
-#if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_SCHED_CPULOAD_EXTCLK)
+#if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_SCHED_CPULOAD_EXTCLK) && \
+    !defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
 void weak_function sched_process_cpuload(void);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+void sched_cpuload_suspend(FAR struct tcb_s *tcb);
+void sched_cpuload_resume(FAR struct tcb_s *tcb);
+#endif
+
+/* Critical section monitor */
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+#  ifdef __GNUC__
+#    define sched_critmon_caller() __builtin_return_address(0)
+#  else
+#    define sched_critmon_caller() NULL
+#  endif
+
+void sched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
+                              FAR void *caller);
+void sched_critmon_csection(FAR struct tcb_s *tcb, bool state,
+                            FAR void *caller);
+void sched_critmon_resume(FAR struct tcb_s *tcb);
+void sched_critmon_suspend(FAR struct tcb_s *tcb);
+#endif
+
+/* Wake-up latency tracer */
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+void sched_wakelat_ready(FAR struct tcb_s *tcb);
+void sched_wakelat_resume(FAR struct tcb_s *tcb);
+#endif
+
+/* Deferred de-allocations */
+
+void sched_garbage_add(FAR volatile sq_queue_t *lists, FAR void *address);
+
 /* TCB operations */
 
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int  sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+#ifdef CONFIG_SCHED_TCBPOOL
+FAR struct tcb_s *sched_tcballoc(uint8_t ttype, size_t stack_size);
+bool sched_tcbpool(FAR struct tcb_s *tcb, uint8_t ttype);
+#endif
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+int  sched_threadlocal_alloc(FAR struct tcb_s *tcb);
+void sched_threadlocal_free(FAR struct tcb_s *tcb);
+#endif
+
 #endif /* __SCHED_SCHED_SCHED_H */
@@ -93,7 +93,20 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   for (next = (FAR struct tcb_s *)list->head;
       (next && sched_priority <= next->sched_priority);
-      next = next->flink);
+      next = next->flink)
+    {
+#ifdef CONFIG_SCHED_DEADLINE
+      /* Deadline threads of the same priority are kept in the order of
+       * their absolute deadlines (earliest deadline first).
+       */
+
+      if (sched_priority == next->sched_priority &&
+          sched_deadline_before(tcb, next))
+        {
+          break;
+        }
+#endif
+    }
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
@@ -253,15 +253,36 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
        btcb->task_state = TSTATE_TASK_READYTORUN;
        doswitch         = false;
     }
+#ifdef CONFIG_SMP_RESCHED_IPI
+  else if (task_state == TSTATE_TASK_RUNNING && cpu != this_cpu() &&
+           (btcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+    {
+      /* The new task should pre-empt the task running on some other CPU.
+       * Rather than stopping that CPU to modify its assigned task list, add
+       * the task to the g_readytorun list and ask the other CPU to pull the
+       * task onto its own list when it next returns from an interrupt.
+       */
+
+      (void)sched_addprioritized(btcb, (FAR dq_queue_t *)&g_readytorun);
+
+      btcb->task_state = TSTATE_TASK_READYTORUN;
+      doswitch         = false;
+
+      sched_resched_request(cpu);
+    }
+#endif
   else /* (task_state == TSTATE_TASK_ASSIGNED || task_state == TSTATE_TASK_RUNNING) */
     {
       int me = this_cpu();
 
-      /* If we are modifying some assigned task list other than our own, we will
-       * need to stop that CPU.
+      /* If we are modifying the head of some assigned task list other than
+       * our own, we will need to stop that CPU.  A task in the assigned
+       * state never goes at the head of the list so, in that case, the
+       * other CPU is not affected and we have the critical section; there
+       * is no need to stop it.
        */
 
-      if (cpu != me)
+      if (cpu != me && task_state == TSTATE_TASK_RUNNING)
         {
           DEBUGVERIFY(up_cpu_pause(cpu));
         }
@@ -373,11 +394,12 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
           btcb->cpu        = cpu;
           btcb->task_state = TSTATE_TASK_ASSIGNED;
+          doswitch         = false;
         }
 
       /* All done, restart the other CPU (if it was paused). */
 
-      if (cpu != me)
+      if (cpu != me && task_state == TSTATE_TASK_RUNNING)
         {
           DEBUGVERIFY(up_cpu_resume(cpu));
           doswitch = false;
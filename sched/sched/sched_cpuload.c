@@ -39,11 +39,14 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
 
 #include "sched/sched.h"
 
@@ -56,7 +59,10 @@
  * of the sampling in ticks per second for the selected timer.
  */
 
-#ifdef CONFIG_SCHED_CPULOAD_EXTCLK
+#if defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
+  /* The rate is that of up_perf_gettime(), known only at run time */
+
+#elif defined(CONFIG_SCHED_CPULOAD_EXTCLK)
 #  ifndef CONFIG_SCHED_CPULOAD_TICKSPERSEC
 #    error CONFIG_SCHED_CPULOAD_TICKSPERSEC is not defined
 #  endif
@@ -65,6 +71,14 @@
 #  define CPULOAD_TICKSPERSEC CLOCKS_PER_SEC
 #endif
 
+/* The number of CPUs whose running threads are charged */
+
+#ifdef CONFIG_SMP
+#  define CPULOAD_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define CPULOAD_NCPUS 1
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -83,14 +97,171 @@
 
 volatile uint32_t g_cpuload_total;
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+/* The time when the running thread on each CPU was last charged */
+
+static uint32_t g_cpuload_start[CPULOAD_NCPUS];
+
+/* The accumulated counts are halved when g_cpuload_total exceeds this
+ * limit.  Zero means that it has not been computed yet.
+ */
+
+static uint32_t g_cpuload_limit;
+
+#ifdef CONFIG_SMP
+/* Several CPUs may charge their threads at the same time */
+
+static volatile spinlock_t g_cpuload_lock = SP_UNLOCKED;
+#endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cpuload_halve
+ *
+ * Description:
+ *   Divide the count for every thread by two and recalculate the total so
+ *   that older activity fades out with the configured time constant.
+ *
+ ****************************************************************************/
+
+static void cpuload_halve(void)
+{
+  uint32_t total = 0;
+  int i;
+
+  for (i = 0; i < g_npidhash; i++)
+    {
+      g_pidhash[i].ticks >>= 1;
+      total += g_pidhash[i].ticks;
+    }
+
+  /* Save the new total. */
+
+  g_cpuload_total = total;
+}
+
+/****************************************************************************
+ * Name: cpuload_charge
+ *
+ * Description:
+ *   Charge the time since the CPU's running thread was last charged to
+ *   that thread.
+ *
+ * Assumptions:
+ *   Interrupts are disabled and, in SMP, g_cpuload_lock is held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+static void cpuload_charge(FAR struct tcb_s *tcb, int cpu, uint32_t now)
+{
+  uint32_t elapsed = now - g_cpuload_start[cpu];
+
+  g_cpuload_start[cpu] = now;
+  if (tcb == NULL)
+    {
+      return;
+    }
+
+  /* The limit is the time constant of all CPUs together.  It is capped so
+   * that the 32-bit counts never wrap, even with a fast counter.
+   */
+
+  if (g_cpuload_limit == 0)
+    {
+      uint64_t limit = (uint64_t)CONFIG_SCHED_CPULOAD_TIMECONSTANT *
+                       up_perf_getfreq() * CPULOAD_NCPUS;
+
+      g_cpuload_limit = limit > (UINT32_MAX >> 1) ?
+                        (UINT32_MAX >> 1) : (uint32_t)limit;
+    }
+
+  /* A thread cannot run longer than the limit between two charges without
+   * overflowing the counts, so clip the (unlikely) excess.
+   */
+
+  if (elapsed > g_cpuload_limit)
+    {
+      elapsed = g_cpuload_limit;
+    }
+
+  g_pidhash[PIDHASH(tcb->pid)].ticks += elapsed;
+  g_cpuload_total += elapsed;
+
+  if (g_cpuload_total > g_cpuload_limit)
+    {
+      cpuload_halve();
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sched_cpuload_suspend and sched_cpuload_resume
+ *
+ * Description:
+ *   With CONFIG_SCHED_CPULOAD_PERFCOUNT, the CPU load is not sampled but
+ *   accounted exactly, in units of up_perf_gettime(), at each context
+ *   switch.  sched_cpuload_suspend() charges the time since the thread
+ *   was resumed (or last charged) to the thread that is being suspended;
+ *   sched_cpuload_resume() starts the measurement for the thread that is
+ *   being resumed.  The time of the IDLE thread of each CPU is the idle
+ *   time of that CPU.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being suspended or resumed.
+ *
+ * Assumptions:
+ *   Called from sched_suspend_scheduler() and sched_resume_scheduler()
+ *   with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+void sched_cpuload_suspend(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags = up_irq_save();
+
+#ifdef CONFIG_SMP
+  spin_lock(&g_cpuload_lock);
+#endif
+
+  cpuload_charge(tcb, this_cpu(), up_perf_gettime());
+
+#ifdef CONFIG_SMP
+  spin_unlock(&g_cpuload_lock);
+#endif
+  up_irq_restore(flags);
+}
+
+void sched_cpuload_resume(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags = up_irq_save();
+
+#ifdef CONFIG_SMP
+  spin_lock(&g_cpuload_lock);
+#endif
+
+  /* Anything since the last charge belongs to no thread (for example, the
+   * remainder of a thread that exited).
+   */
+
+  cpuload_charge(NULL, this_cpu(), up_perf_gettime());
+
+#ifdef CONFIG_SMP
+  spin_unlock(&g_cpuload_lock);
+#endif
+  up_irq_restore(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: sched_process_cpuload
  *
@@ -109,11 +280,11 @@ volatile uint32_t g_cpuload_total;
  *
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_CPULOAD_PERFCOUNT
 void weak_function sched_process_cpuload(void)
 {
   FAR struct tcb_s *rtcb  = this_task();
   int hash_index;
-  int i;
 
   /* Increment the count on the currently executing thread
    *
@@ -133,23 +304,10 @@ void weak_function sched_process_cpuload(void)
 
   if (++g_cpuload_total > (CONFIG_SCHED_CPULOAD_TIMECONSTANT * CPULOAD_TICKSPERSEC))
     {
-      uint32_t total = 0;
-
-      /* Divide the tick count for every task by two and recalculate the
-       * total.
-       */
-
-      for (i = 0; i < CONFIG_MAX_TASKS; i++)
-        {
-          g_pidhash[i].ticks >>= 1;
-          total += g_pidhash[i].ticks;
-        }
-
-      /* Save the new total. */
-
-      g_cpuload_total = total;
+      cpuload_halve();
     }
 }
+#endif
 
 /****************************************************************************
  * Function:  clock_cpuload
@@ -173,17 +331,43 @@ void weak_function sched_process_cpuload(void)
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
 {
   irqstate_t flags;
-  int hash_index = PIDHASH(pid);
+  int hash_index;
   int ret = -ESRCH;
 
   DEBUGASSERT(cpuload);
 
   /* Momentarily disable interrupts.  We need (1) the task to stay valid
    * while we are doing these operations and (2) the tick counts to be
-   * synchronized when read.
+   * synchronized when read.  This also keeps the PID table from being
+   * replaced while we use it.
    */
 
   flags = enter_critical_section();
+  hash_index = PIDHASH(pid);
+
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+  /* Bring the counts up to date:  Charge the time that the running thread
+   * of each CPU has run so far.
+   */
+
+    {
+      uint32_t now = up_perf_gettime();
+      int cpu;
+
+#ifdef CONFIG_SMP
+      spin_lock(&g_cpuload_lock);
+#endif
+
+      for (cpu = 0; cpu < CPULOAD_NCPUS; cpu++)
+        {
+          cpuload_charge(current_task(cpu), cpu, now);
+        }
+
+#ifdef CONFIG_SMP
+      spin_unlock(&g_cpuload_lock);
+#endif
+    }
+#endif
 
   /* Make sure that the entry is valid (TCB field is not NULL) and matches
    * the requested PID.  The first check is needed if the thread has exited.
@@ -78,7 +78,7 @@
 
 int sched_cpu_select(cpu_set_t affinity)
 {
-  uint8_t minprio;
+  int minprio;
   int cpu;
   int i;
 
@@ -86,7 +86,7 @@ int sched_cpu_select(cpu_set_t affinity)
    * (possibly its IDLE task).
    */
 
-  minprio = SCHED_PRIORITY_MAX;
+  minprio = SCHED_PRIORITY_MAX + 1;
   cpu     = IMPOSSIBLE_CPU;
 
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
@@ -113,7 +113,8 @@ int sched_cpu_select(cpu_set_t affinity)
           else if (rtcb->sched_priority < minprio)
             {
               DEBUGASSERT(rtcb->sched_priority > 0);
-              cpu = i;
+              minprio = rtcb->sched_priority;
+              cpu     = i;
             }
         }
     }
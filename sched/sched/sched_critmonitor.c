@@ -0,0 +1,276 @@
+/****************************************************************************
+ * sched/sched/sched_critmonitor.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The worst offenders seen so far, in no particular order */
+
+struct critmon_site_s g_critmon_sites[CONFIG_SCHED_CRITMONITOR_NSITES];
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+/* Several CPUs may record at the same time from context switches */
+
+static volatile spinlock_t g_critmon_lock = SP_UNLOCKED;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: critmon_record
+ *
+ * Description:
+ *   Record the time that 'caller' kept interrupts or pre-emption disabled.
+ *   If the call site is not yet in the table, it replaces an unused entry
+ *   or, if the table is full, the entry with the shortest maximum time
+ *   (provided that this time is longer).
+ *
+ ****************************************************************************/
+
+static void critmon_record(FAR void *caller, uint8_t type, uint32_t elapsed)
+{
+  FAR struct critmon_site_s *site;
+  FAR struct critmon_site_s *victim = NULL;
+  irqstate_t flags;
+  int i;
+
+  if (caller == NULL)
+    {
+      return;
+    }
+
+  /* This is called from enter/leave_critical_section(), so only local
+   * interrupts may be used for mutual exclusion here.
+   */
+
+  flags = up_irq_save();
+#ifdef CONFIG_SMP
+  spin_lock(&g_critmon_lock);
+#endif
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_NSITES; i++)
+    {
+      site = &g_critmon_sites[i];
+      if (site->caller == caller && site->type == type)
+        {
+          break;
+        }
+
+      /* Remember an unused entry or, failing that, the least offender */
+
+      if (victim == NULL ||
+          (victim->caller != NULL &&
+           (site->caller == NULL || site->maxtime < victim->maxtime)))
+        {
+          victim = site;
+        }
+    }
+
+  if (i >= CONFIG_SCHED_CRITMONITOR_NSITES)
+    {
+      /* A new call site.  Is it worse than the least offender? */
+
+      site = victim;
+      if (site->caller != NULL && elapsed <= site->maxtime)
+        {
+          goto errout_with_lock;
+        }
+
+      site->caller  = caller;
+      site->type    = type;
+      site->maxtime = 0;
+      site->count   = 0;
+    }
+
+  site->count++;
+  if (elapsed > site->maxtime)
+    {
+      site->maxtime = elapsed;
+    }
+
+errout_with_lock:
+#ifdef CONFIG_SMP
+  spin_unlock(&g_critmon_lock);
+#endif
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_critmon_preemption
+ *
+ * Description:
+ *   Called when there is any change in pre-emptible state of a thread.
+ *
+ * Input Parameters:
+ *   tcb    - The thread whose lockcount changed to or from zero
+ *   state  - True: Pre-emption was disabled; false:  Re-enabled
+ *   caller - The caller of the outermost sched_lock() (ignored when state
+ *            is false)
+ *
+ ****************************************************************************/
+
+void sched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
+                              FAR void *caller)
+{
+  if (state)
+    {
+      tcb->premp_start  = up_perf_gettime();
+      tcb->premp_caller = caller;
+    }
+  else
+    {
+      /* The caller is cleared so that an unbalanced sched_unlock() is not
+       * recorded.
+       */
+
+      critmon_record(tcb->premp_caller, CRITMON_PREEMPTION,
+                     up_perf_gettime() - tcb->premp_start);
+      tcb->premp_caller = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_csection
+ *
+ * Description:
+ *   Called when a thread enters or leaves the outermost critical section.
+ *
+ * Input Parameters:
+ *   tcb    - The thread whose irqcount changed to or from zero
+ *   state  - True: Critical section entered; false:  Left
+ *   caller - The caller of the outermost enter_critical_section() (ignored
+ *            when state is false)
+ *
+ ****************************************************************************/
+
+void sched_critmon_csection(FAR struct tcb_s *tcb, bool state,
+                            FAR void *caller)
+{
+  if (state)
+    {
+      tcb->crit_start  = up_perf_gettime();
+      tcb->crit_caller = caller;
+    }
+  else
+    {
+      critmon_record(tcb->crit_caller, CRITMON_CSECTION,
+                     up_perf_gettime() - tcb->crit_start);
+      tcb->crit_caller = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_resume
+ *
+ * Description:
+ *   Called when a thread resumes execution.  If the thread still holds the
+ *   scheduler lock or a critical section, its measurement restarts now:
+ *   The time that it was suspended does not count.
+ *
+ ****************************************************************************/
+
+void sched_critmon_resume(FAR struct tcb_s *tcb)
+{
+  uint32_t now = up_perf_gettime();
+
+  if (tcb->lockcount > 0)
+    {
+      tcb->premp_start = now;
+    }
+
+  if (tcb->irqcount > 0)
+    {
+      tcb->crit_start = now;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_critmon_suspend
+ *
+ * Description:
+ *   Called when a thread is suspended.  If the thread holds the scheduler
+ *   lock or a critical section, the time that it ran since it (re)acquired
+ *   them is recorded now.
+ *
+ ****************************************************************************/
+
+void sched_critmon_suspend(FAR struct tcb_s *tcb)
+{
+  uint32_t now = up_perf_gettime();
+
+  if (tcb->lockcount > 0)
+    {
+      critmon_record(tcb->premp_caller, CRITMON_PREEMPTION,
+                     now - tcb->premp_start);
+    }
+
+  if (tcb->irqcount > 0)
+    {
+      critmon_record(tcb->crit_caller, CRITMON_CSECTION,
+                     now - tcb->crit_start);
+    }
+}
+
+#endif /* CONFIG_SCHED_CRITMONITOR */
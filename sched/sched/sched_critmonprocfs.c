@@ -0,0 +1,381 @@
+/****************************************************************************
+ * sched/sched/sched_critmonprocfs.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+#if defined(CONFIG_SCHED_CRITMONITOR) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_CRITMON)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define CRITMON_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct critmon_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  unsigned int linesize;            /* Number of valid characters in line[] */
+  char line[CRITMON_LINELEN];       /* Pre-allocated buffer for formatted lines */
+
+  /* A sorted snapshot of the call sites, taken when the file is read from
+   * the beginning so that the output is stable across read() calls.
+   */
+
+  struct critmon_site_s sites[CONFIG_SCHED_CRITMONITOR_NSITES];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     critmon_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     critmon_close(FAR struct file *filep);
+static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     critmon_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations critmon_procfsoperations =
+{
+  critmon_open,      /* open */
+  critmon_close,     /* close */
+  critmon_read,      /* read */
+  NULL,              /* write */
+
+  critmon_dup,       /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  critmon_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: critmon_snapshot
+ *
+ * Description:
+ *   Copy the call sites and sort them by decreasing maximum time.
+ *
+ ****************************************************************************/
+
+static void critmon_snapshot(FAR struct critmon_file_s *critfile)
+{
+  FAR struct critmon_site_s *sites = critfile->sites;
+  struct critmon_site_s tmp;
+  irqstate_t flags;
+  int i;
+  int j;
+
+  flags = enter_critical_section();
+  memcpy(sites, g_critmon_sites, sizeof(g_critmon_sites));
+  leave_critical_section(flags);
+
+  /* The table is small; a simple insertion sort is sufficient */
+
+  for (i = 1; i < CONFIG_SCHED_CRITMONITOR_NSITES; i++)
+    {
+      tmp = sites[i];
+      for (j = i; j > 0 && sites[j - 1].maxtime < tmp.maxtime; j--)
+        {
+          sites[j] = sites[j - 1];
+        }
+
+      sites[j] = tmp;
+    }
+}
+
+/****************************************************************************
+ * Name: critmon_open
+ ****************************************************************************/
+
+static int critmon_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct critmon_file_s *critfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "critmon" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "critmon") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  critfile = (FAR struct critmon_file_s *)
+    kmm_zalloc(sizeof(struct critmon_file_s));
+
+  if (!critfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)critfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critmon_close
+ ****************************************************************************/
+
+static int critmon_close(FAR struct file *filep)
+{
+  FAR struct critmon_file_s *critfile;
+
+  /* Recover our private data from the struct file instance */
+
+  critfile = (FAR struct critmon_file_s *)filep->f_priv;
+  DEBUGASSERT(critfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(critfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critmon_read
+ *
+ * Description:
+ *   Return one line per recorded call site, worst offender first:  Whether
+ *   the site disabled interrupts (csection) or pre-emption (preempt), its
+ *   return address, the number of times it was recorded, and the longest
+ *   time in microseconds.
+ *
+ ****************************************************************************/
+
+static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct critmon_file_s *critfile;
+  FAR struct critmon_site_s *site;
+  off_t offset;
+  ssize_t nread;
+  uint32_t freq;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  critfile = (FAR struct critmon_file_s *)filep->f_priv;
+  DEBUGASSERT(critfile);
+
+  if (filep->f_pos == 0)
+    {
+      critmon_snapshot(critfile);
+    }
+
+  /* The header line */
+
+  offset = filep->f_pos;
+  critfile->linesize =
+    snprintf(critfile->line, CRITMON_LINELEN, "%-8s %-*s %10s %10s\n",
+             "TYPE", (int)(2 * sizeof(FAR void *) + 2), "CALLER",
+             "COUNT", "MAX(us)");
+
+  nread = procfs_memcpy(critfile->line, critfile->linesize, buffer, buflen,
+                        &offset);
+
+  /* Then one line for each call site */
+
+  freq = up_perf_getfreq();
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_NSITES && nread < buflen; i++)
+    {
+      site = &critfile->sites[i];
+      if (site->caller == NULL)
+        {
+          continue;
+        }
+
+      critfile->linesize =
+        snprintf(critfile->line, CRITMON_LINELEN, "%-8s %p %10lu %10lu\n",
+                 site->type == CRITMON_CSECTION ? "csection" : "preempt",
+                 site->caller, (unsigned long)site->count,
+                 (unsigned long)(((uint64_t)site->maxtime * 1000000) /
+                                 freq));
+
+      nread += procfs_memcpy(critfile->line, critfile->linesize,
+                             &buffer[nread], buflen - nread, &offset);
+    }
+
+  /* Update the file offset */
+
+  if (nread > 0)
+    {
+      filep->f_pos += nread;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: critmon_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int critmon_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct critmon_file_s *oldfile;
+  FAR struct critmon_file_s *newfile;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldfile = (FAR struct critmon_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldfile);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newfile = (FAR struct critmon_file_s *)
+    kmm_malloc(sizeof(struct critmon_file_s));
+
+  if (!newfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newfile, oldfile, sizeof(struct critmon_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: critmon_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int critmon_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "critmon" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "critmon") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "critmon" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_CRITMONITOR && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_CRITMON */
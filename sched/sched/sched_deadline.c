@@ -0,0 +1,691 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/wdog.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched_note.h>
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Utilization is accounted in units of 1/1000 of the CPU */
+
+#define DEADLINE_MAXUTIL (10 * CONFIG_SCHED_DEADLINE_MAXUTIL)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void deadline_set_priority(FAR struct tcb_s *tcb, int priority);
+static void deadline_miss(FAR struct tcb_s *tcb, systime_t now);
+static void deadline_timer_start(FAR struct tcb_s *tcb, systime_t when);
+static void deadline_expire(int argc, wdparm_t arg1, ...);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This is the sum of the utilization (runtime / period) of all admitted
+ * deadline threads.
+ */
+
+static uint32_t g_deadline_util;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Change the priority of a deadline thread, preserving any priority
+ *   inheritance boost above the new priority.
+ *
+ * Input Parameters:
+ *   tcb      - TCB of the thread whose priority will be modified
+ *   priority - The new priority
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* If the priority was boosted above the new priority, than just reset
+   * the base priority.
+   */
+
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority > priority)
+    {
+      tcb->base_priority = priority;
+      return;
+    }
+#endif
+
+  /* Otherwise change the priority of thread, possible causing a context
+   * switch.
+   */
+
+  DEBUGVERIFY(sched_reprioritize(tcb, priority));
+}
+
+/****************************************************************************
+ * Name: deadline_miss
+ *
+ * Description:
+ *   Report that the current job has missed its deadline.  Only the first
+ *   miss of each job is reported.
+ *
+ * Input Parameters:
+ *   tcb - TCB of the thread that missed its deadline
+ *   now - The current time
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_miss(FAR struct tcb_s *tcb, systime_t now)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+
+  if ((deadline->flags & DEADLINE_FLAG_MISSED) == 0)
+    {
+      deadline->flags |= DEADLINE_FLAG_MISSED;
+      sched_note_deadline(tcb, (uint32_t)(now - deadline->abstime));
+    }
+}
+
+/****************************************************************************
+ * Name: deadline_timer_start
+ *
+ * Description:
+ *   Start the deadline timer so that expires at an absolute time.
+ *
+ * Input Parameters:
+ *   tcb  - TCB of the deadline thread
+ *   when - The absolute time of the expiration
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void deadline_timer_start(FAR struct tcb_s *tcb, systime_t when)
+{
+  int32_t delay = (int32_t)(when - clock_systimer());
+
+  if (delay < 1)
+    {
+      delay = 1;
+    }
+
+  DEBUGVERIFY(wd_start(&tcb->deadline->timer, delay, deadline_expire, 1,
+                       (wdparm_t)tcb));
+}
+
+/****************************************************************************
+ * Name: deadline_expire
+ *
+ * Description:
+ *   Handles the expiration of the deadline timer.  If the deadline is
+ *   shorter than the period, then the timer first expires at the deadline
+ *   of the current job in order to detect misses.  It then expires at the
+ *   release time of next job.
+ *
+ * Input Parameters:
+ *   argc - The number of arguments (should be 1)
+ *   arg1 - The TCB of the deadline thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled
+ *
+ ****************************************************************************/
+
+static void deadline_expire(int argc, wdparm_t arg1, ...)
+{
+  FAR struct tcb_s *tcb = (FAR struct tcb_s *)arg1;
+  FAR struct deadline_s *deadline;
+  systime_t now;
+  uint8_t flags;
+
+  DEBUGASSERT(argc == 1 && tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+  now      = clock_systimer();
+
+  /* Has the current job completed before its deadline? */
+
+  if ((deadline->flags & DEADLINE_FLAG_DONE) == 0)
+    {
+      deadline_miss(tcb, now);
+    }
+
+  /* Was this the deadline of the current job?  If so, wait for the release
+   * of the next job.
+   */
+
+  if (deadline->deadline < deadline->period &&
+      (deadline->flags & DEADLINE_FLAG_RELEASE) == 0)
+    {
+      deadline->flags |= DEADLINE_FLAG_RELEASE;
+      deadline_timer_start(tcb, deadline->release + deadline->period);
+      return;
+    }
+
+  /* Release the next job.  An uncompleted job just continues as the next
+   * job.
+   */
+
+  flags              = deadline->flags;
+  deadline->flags    = 0;
+  deadline->release += deadline->period;
+  deadline->abstime  = deadline->release + deadline->deadline;
+  deadline->budget   = deadline->runtime;
+
+  deadline_timer_start(tcb, deadline->deadline < deadline->period ?
+                       deadline->abstime :
+                       deadline->release + deadline->period);
+
+  if ((flags & DEADLINE_FLAG_THROTTLED) != 0)
+    {
+      /* Restore the priority of the throttled thread */
+
+      deadline_set_priority(tcb, deadline->priority);
+    }
+
+  if ((flags & DEADLINE_FLAG_DONE) != 0)
+    {
+      /* The thread is waiting for this release.  It will be placed in the
+       * ready-to-run list according to the the new deadline.
+       */
+
+      sem_post(&deadline->waitsem);
+    }
+  else if ((flags & DEADLINE_FLAG_THROTTLED) == 0 &&
+           (tcb->task_state == TSTATE_TASK_RUNNING ||
+            tcb->task_state == TSTATE_TASK_READYTORUN))
+    {
+      /* The deadline has moved.  Re-sort the thread in the ready-to-run
+       * list.  (If it was throttled, that was done when its priority was
+       * restored).
+       */
+
+      DEBUGVERIFY(sched_setpriority(tcb, tcb->sched_priority));
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_deadline_start
+ *
+ * Description:
+ *   Called to start deadline scheduling on a given thread or to change its
+ *   deadline scheduling parameters.  The first job is released now.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread that is beginning deadline scheduling.
+ *   param - The new deadline scheduling parameters
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL - The parameters are not consistent (runtime <= deadline <=
+ *            period is required)
+ *   EBUSY  - Admitting the thread would exceed the utilization limit
+ *   ENOMEM - The deadline data structure could not be allocated
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+int sched_deadline_start(FAR struct tcb_s *tcb,
+                         FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *deadline;
+  uint32_t total;
+  uint32_t util;
+  int runtime;
+  int reldeadline;
+  int period;
+
+  DEBUGASSERT(tcb != NULL && param != NULL);
+
+  /* Convert timespec values to system clock ticks */
+
+  (void)clock_time2ticks(&param->sched_dl_runtime, &runtime);
+  (void)clock_time2ticks(&param->sched_dl_deadline, &reldeadline);
+  (void)clock_time2ticks(&param->sched_dl_period, &period);
+
+  /* Avoid zero/negative times.  A zero deadline defaults to the period. */
+
+  if (runtime < 1)
+    {
+      runtime = 1;
+    }
+
+  if (period < 1)
+    {
+      period = 1;
+    }
+
+  if (reldeadline < 1)
+    {
+      reldeadline = period;
+    }
+
+  if (runtime > reldeadline || reldeadline > period)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control:  The utilization of all deadline threads must not
+   * exceed the configured limit.
+   */
+
+  util  = ((uint32_t)runtime * 1000 + period - 1) / period;
+  total = g_deadline_util + util;
+
+  deadline = tcb->deadline;
+  if (deadline != NULL)
+    {
+      total -= deadline->util;
+    }
+
+  if (total > DEADLINE_MAXUTIL)
+    {
+      serr("ERROR: Utilization %lu exceeds limit\n", (unsigned long)total);
+      return -EBUSY;
+    }
+
+  if (deadline == NULL)
+    {
+      /* Allocate the deadline add-on data structure that will hold the
+       * deadline scheduling parameters and state data.  It is retained
+       * until the thread exits.
+       */
+
+      deadline = (FAR struct deadline_s *)
+        kmm_zalloc(sizeof(struct deadline_s));
+      if (deadline == NULL)
+        {
+          serr("ERROR: Failed to allocate deadline data structure\n");
+          return -ENOMEM;
+        }
+
+      deadline->tcb = tcb;
+      sem_init(&deadline->waitsem, 0, 0);
+      tcb->deadline = deadline;
+    }
+  else
+    {
+      /* Stop the previous deadline scheduling */
+
+      (void)sched_deadline_reset(tcb);
+    }
+
+  /* Save the deadline scheduling parameters */
+
+  deadline->priority = param->sched_priority;
+  deadline->util     = util;
+  deadline->runtime  = runtime;
+  deadline->deadline = reldeadline;
+  deadline->period   = period;
+  g_deadline_util    = total;
+
+  /* And release the first job now */
+
+  deadline->release  = clock_systimer();
+  deadline->abstime  = deadline->release + reldeadline;
+  deadline->budget   = runtime;
+  deadline->flags    = 0;
+
+  deadline_timer_start(tcb, reldeadline < period ? deadline->abstime :
+                       deadline->release + period);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_reset
+ *
+ * Description:
+ *   Called to stop deadline scheduling on a given thread.  This function
+ *   is called in the following circumstances:
+ *
+ *     - When the thread is changed to use some other scheduling policy via
+ *       sched_setscheduler()
+ *     - When the deadline scheduling parameters are changed
+ *     - From sched_deadline_stop when under those conditions.
+ *
+ *   The deadline data structure is retained.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is ending deadline scheduling.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+int sched_deadline_reset(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  /* Cancel the timer and return the utilization of the thread */
+
+  wd_cancel(&deadline->timer);
+  g_deadline_util -= deadline->util;
+  deadline->util   = 0;
+
+  /* Release the thread if it is waiting for the next job */
+
+  if ((deadline->flags & DEADLINE_FLAG_DONE) != 0)
+    {
+      sem_post(&deadline->waitsem);
+    }
+
+  deadline->flags  = 0;
+  deadline->budget = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_stop
+ *
+ * Description:
+ *   Called when a thread that has used the deadline scheduling policy
+ *   exits.  Terminates deadline scheduling and frees all resources
+ *   associated with the policy.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the exiting thread.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+int sched_deadline_stop(FAR struct tcb_s *tcb)
+{
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+
+  /* Stop the timer, reset scheduling */
+
+  if (tcb->deadline->util > 0)
+    {
+      (void)sched_deadline_reset(tcb);
+    }
+
+  /* The free the container holder the deadline scheduling parameters */
+
+  sem_destroy(&tcb->deadline->waitsem);
+  sched_kfree(tcb->deadline);
+  tcb->deadline = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_yield
+ *
+ * Description:
+ *   Called from sched_yield() when the current job of the deadline thread
+ *   completes.  The thread waits for the release of its next job.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the currently running deadline thread.
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int sched_deadline_yield(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline;
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  flags = enter_critical_section();
+
+  /* Was the job completed after its deadline? */
+
+  if ((int32_t)(clock_systimer() - deadline->abstime) > 0)
+    {
+      deadline_miss(tcb, clock_systimer());
+    }
+
+  /* Wait for the next release.  The timer will wake us up.  Any budget
+   * remaining in this job is lost.
+   */
+
+  deadline->flags |= DEADLINE_FLAG_DONE;
+  while (sem_wait(&deadline->waitsem) < 0)
+    {
+      ret = -get_errno();
+      if (ret != -EINTR)
+        {
+          break;
+        }
+
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_process
+ *
+ * Description:
+ *   Process the elapsed time interval. Called from this context:
+ *
+ *   - From the timer interrupt handler while the thread with deadline
+ *     scheduling is running.
+ *
+ * Input Parameters:
+ *   tcb        - The TCB of the running deadline thread.
+ *   ticks      - The number of elapsed ticks since the last time this
+ *                function was called.
+ *   noswitches - We are running in a context where context switching is
+ *                not permitted.
+ *
+ * Returned Value:
+ *   The number if ticks remaining until the budget of the job is exhausted.
+ *   Zero is returned if the budget is already exhausted.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+uint32_t sched_deadline_process(FAR struct tcb_s *tcb, uint32_t ticks,
+                                bool noswitches)
+{
+  FAR struct deadline_s *deadline;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  /* Nothing to do if the budget is already exhausted */
+
+  if (deadline->budget <= 0)
+    {
+      return 0;
+    }
+
+  /* Is there budget remaining? */
+
+  if (ticks < (uint32_t)deadline->budget)
+    {
+      deadline->budget -= ticks;
+      return (uint32_t)deadline->budget;
+    }
+
+  /* No.. the budget is exhausted.  If the thread has the scheduler locked,
+   * then we cannot drop its priority now.  sched_unlock() will do that
+   * when the lock is released.
+   */
+
+  deadline->budget = 0;
+  if (sched_islocked(tcb))
+    {
+      return 0;
+    }
+
+  /* We will also suppress context switches if we were called via one of
+   * the unusual cases handled by sched_timer_reasses().  Return a value of
+   * one so that the timer will expire as soon as possible.
+   */
+
+  if (noswitches)
+    {
+      deadline->budget = 1;
+      return 1;
+    }
+
+  sched_deadline_throttle(tcb);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: sched_deadline_throttle
+ *
+ * Description:
+ *   Drop the thread whose budget has been exhausted to the lowest priority
+ *   until the release of its next job.  Called from:
+ *
+ *   - sched_deadline_process() when the budget is exhausted.
+ *   - sched_unlock() when the budget was exhausted while the thread had
+ *     the scheduler locked.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread whose budget has been exhausted.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+void sched_deadline_throttle(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+  deadline = tcb->deadline;
+
+  if ((deadline->flags & DEADLINE_FLAG_THROTTLED) == 0)
+    {
+      deadline->flags |= DEADLINE_FLAG_THROTTLED;
+      deadline_set_priority(tcb, SCHED_PRIORITY_MIN);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_deadline_before
+ *
+ * Description:
+ *   Determine the order of two threads with the same priority in a
+ *   prioritized list.  Deadline threads are ordered by their absolute
+ *   deadlines.
+ *
+ * Input Parameters:
+ *   tcb1 - The TCB of the thread being inserted
+ *   tcb2 - The TCB of a thread already in the list
+ *
+ * Returned Value:
+ *   True if both are deadline threads and the deadline of tcb1 is earlier
+ *   than the deadline of tcb2.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *
+ ****************************************************************************/
+
+bool sched_deadline_before(FAR struct tcb_s *tcb1, FAR struct tcb_s *tcb2)
+{
+  return (tcb1->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+         (tcb2->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+         (int32_t)(tcb1->deadline->abstime - tcb2->deadline->abstime) < 0;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
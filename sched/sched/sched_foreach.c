@@ -73,7 +73,7 @@ void sched_foreach(sched_foreach_t handler, FAR void *arg)
 
   /* Vist each active task */
 
-  for (ndx = 0; ndx < CONFIG_MAX_TASKS; ndx++)
+  for (ndx = 0; ndx < g_npidhash; ndx++)
     {
       if (g_pidhash[ndx].tcb)
         {
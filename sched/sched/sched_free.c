@@ -86,29 +86,26 @@ void sched_ufree(FAR void *address)
 
   if (up_interrupt_context() || kumm_trysemaphore() != 0)
     {
-      irqstate_t flags;
-
       /* Yes.. Make sure that this is not a attempt to free kernel memory
        * using the user deallocator.
        */
 
-      flags = enter_critical_section();
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
      defined(CONFIG_MM_KERNEL_HEAP)
       DEBUGASSERT(!kmm_heapmember(address));
 #endif
 
-      /* Delay the deallocation until a more appropriate time. */
+      /* Delay the deallocation until a more appropriate time.  It is
+       * added to the list of this CPU.
+       */
 
-      sq_addlast((FAR sq_entry_t *)address,
-                 (FAR sq_queue_t *)&g_delayed_kufree);
+      sched_garbage_add(g_delayed_kufree, address);
 
       /* Signal the worker thread that is has some clean up to do */
 
 #ifdef CONFIG_SCHED_WORKQUEUE
       work_signal(LPWORK);
 #endif
-      leave_critical_section(flags);
     }
   else
     {
@@ -123,8 +120,6 @@ void sched_ufree(FAR void *address)
 #ifdef CONFIG_MM_KERNEL_HEAP
 void sched_kfree(FAR void *address)
 {
-  irqstate_t flags;
-
   /* Check if this is an attempt to deallocate memory from an exception
    * handler.  If this function is called from the IDLE task, then we
    * must have exclusive access to the memory manager to do this.
@@ -136,20 +131,19 @@ void sched_kfree(FAR void *address)
        * using the kernel deallocator.
        */
 
-      flags = enter_critical_section();
       DEBUGASSERT(kmm_heapmember(address));
 
-      /* Delay the deallocation until a more appropriate time. */
+      /* Delay the deallocation until a more appropriate time.  It is
+       * added to the list of this CPU.
+       */
 
-      sq_addlast((FAR sq_entry_t *)address,
-                 (FAR sq_queue_t *)&g_delayed_kfree);
+      sched_garbage_add(g_delayed_kfree, address);
 
       /* Signal the worker thread that is has some clean up to do */
 
 #ifdef CONFIG_SCHED_WORKQUEUE
       work_signal(LPWORK);
 #endif
-      leave_critical_section(flags);
     }
   else
     {
@@ -38,8 +38,12 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <queue.h>
+
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 
 #include "sched/sched.h"
 
@@ -47,21 +51,102 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sched_garbage_lock and sched_garbage_unlock
+ *
+ * Description:
+ *   Get exclusive access to the delayed deallocation lists of one CPU.  In
+ *   the SMP case, this disables local interrupts and takes the spinlock of
+ *   that CPU only, so CPUs queuing and collecting garbage do not contend
+ *   with each other or with the global critical section.
+ *
+ ****************************************************************************/
+
+static inline irqstate_t sched_garbage_lock(int cpu)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags = up_irq_save();
+  spin_lock(&g_delayed_lock[cpu]);
+  return flags;
+#else
+  return enter_critical_section();
+#endif
+}
+
+static inline void sched_garbage_unlock(int cpu, irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  spin_unlock(&g_delayed_lock[cpu]);
+  up_irq_restore(flags);
+#else
+  leave_critical_section(flags);
+#endif
+}
+
+/****************************************************************************
+ * Name: sched_garbage_batch
+ *
+ * Description:
+ *   Remove up to 'max' delayed deallocations from the list of one CPU.
+ *   They are removed together, with one lock operation.
+ *
+ * Input parameters:
+ *   lists - The per-CPU delayed deallocation lists
+ *   cpu   - The CPU whose list is drained
+ *   batch - Receives the removed deallocations
+ *   max   - The maximum number to remove
+ *
+ * Returned Value:
+ *   The number of deallocations removed.
+ *
+ ****************************************************************************/
+
+static int sched_garbage_batch(FAR volatile sq_queue_t *lists, int cpu,
+                               FAR sq_queue_t *batch, int max)
+{
+  FAR sq_entry_t *entry;
+  irqstate_t flags;
+  int count = 0;
+
+  sq_init(batch);
+
+  /* Test if the delayed deallocation queue is empty.  No special protection
+   * is needed because this is an atomic test.
+   */
+
+  if (lists[cpu].head == NULL)
+    {
+      return 0;
+    }
+
+  flags = sched_garbage_lock(cpu);
+  while (count < max &&
+         (entry = sq_remfirst((FAR sq_queue_t *)&lists[cpu])) != NULL)
+    {
+      sq_addlast(entry, batch);
+      count++;
+    }
+
+  sched_garbage_unlock(cpu, flags);
+  return count;
+}
+
 /****************************************************************************
  * Name: sched_kucleanup
  *
  * Description:
- *   Clean-up deferred de-allocations of user memory
+ *   Clean-up deferred de-allocations of user memory queued by one CPU
  *
  * Input parameters:
- *   None
+ *   cpu   - The CPU whose list is drained
+ *   nfree - The maximum number of deallocations to perform
  *
  * Returned Value:
- *   None
+ *   The remaining number of deallocations that may be performed.
  *
  ****************************************************************************/
 
-static inline void sched_kucleanup(void)
+static inline int sched_kucleanup(int cpu, int nfree)
 {
 #ifdef CONFIG_BUILD_KERNEL
   /* REVISIT:  It is not safe to defer user allocation in the kernel mode
@@ -72,35 +157,21 @@ static inline void sched_kucleanup(void)
    * collect garbage on a group-by-group basis.
    */
 
-#else
-   irqstate_t flags;
-   FAR void *address;
+  return nfree;
 
-  /* Test if the delayed deallocation queue is empty.  No special protection
-   * is needed because this is an atomic test.
-   */
+#else
+  sq_queue_t batch;
+  FAR void *address;
 
-  while (g_delayed_kufree.head)
+  nfree -= sched_garbage_batch(g_delayed_kufree, cpu, &batch, nfree);
+  while ((address = (FAR void *)sq_remfirst(&batch)) != NULL)
     {
-      /* Remove the first delayed deallocation.  This is not atomic and so
-       * we must disable interrupts around the queue operation.
-       */
-
-      flags = enter_critical_section();
-      address = (FAR void *)sq_remfirst((FAR sq_queue_t *)&g_delayed_kufree);
-      leave_critical_section(flags);
-
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
-       */
+      /* Return the memory to the user heap */
 
-      if (address)
-        {
-          /* Return the memory to the user heap */
-
-          kumm_free(address);
-        }
+      kumm_free(address);
     }
+
+  return nfree;
 #endif
 }
 
@@ -121,7 +192,17 @@ static inline void sched_kucleanup(void)
 #ifndef CONFIG_BUILD_KERNEL
 static inline bool sched_have_kugarbage(void)
 {
-  return (g_delayed_kufree.head != NULL);
+  int cpu;
+
+  for (cpu = 0; cpu < SCHED_NGARBAGE; cpu++)
+    {
+      if (g_delayed_kufree[cpu].head != NULL)
+        {
+          return true;
+        }
+    }
+
+  return false;
 }
 #else
 #  define sched_have_kugarbage() false
@@ -131,51 +212,36 @@ static inline bool sched_have_kugarbage(void)
  * Name: sched_kcleanup
  *
  * Description:
- *   Clean-up deferred de-allocations of kernel memory
+ *   Clean-up deferred de-allocations of kernel memory queued by one CPU
  *
  * Input parameters:
- *   None
+ *   cpu   - The CPU whose list is drained
+ *   nfree - The maximum number of deallocations to perform
  *
  * Returned Value:
- *   None
+ *   The remaining number of deallocations that may be performed.
  *
  ****************************************************************************/
 
 #if (defined(CONFIG_BUILD_PROTECTED) || defined(CONFIG_BUILD_KERNEL)) && \
      defined(CONFIG_MM_KERNEL_HEAP)
-static inline void sched_kcleanup(void)
+static inline int sched_kcleanup(int cpu, int nfree)
 {
-  irqstate_t flags;
+  sq_queue_t batch;
   FAR void *address;
 
-  /* Test if the delayed deallocation queue is empty.  No special protection
-   * is needed because this is an atomic test.
-   */
-
-  while (g_delayed_kfree.head)
+  nfree -= sched_garbage_batch(g_delayed_kfree, cpu, &batch, nfree);
+  while ((address = (FAR void *)sq_remfirst(&batch)) != NULL)
     {
-      /* Remove the first delayed deallocation.  This is not atomic and so
-       * we must disable interrupts around the queue operation.
-       */
+      /* Return the memory to the kernel heap */
 
-      flags = enter_critical_section();
-      address = (FAR void *)sq_remfirst((FAR sq_queue_t *)&g_delayed_kfree);
-      leave_critical_section(flags);
-
-      /* The address should always be non-NULL since that was checked in the
-       * 'while' condition above.
-       */
-
-      if (address)
-        {
-          /* Return the memory to the kernel heap */
-
-          kmm_free(address);
-        }
+      kmm_free(address);
     }
+
+  return nfree;
 }
 #else
-#  define sched_kcleanup()
+#  define sched_kcleanup(cpu,nfree) (nfree)
 #endif
 
 /****************************************************************************
@@ -196,7 +262,17 @@ static inline void sched_kcleanup(void)
      defined(CONFIG_MM_KERNEL_HEAP)
 static inline bool sched_have_kgarbage(void)
 {
-  return (g_delayed_kfree.head != NULL);
+  int cpu;
+
+  for (cpu = 0; cpu < SCHED_NGARBAGE; cpu++)
+    {
+      if (g_delayed_kfree[cpu].head != NULL)
+        {
+          return true;
+        }
+    }
+
+  return false;
 }
 #else
 #  define sched_have_kgarbage() false
@@ -206,6 +282,48 @@ static inline bool sched_have_kgarbage(void)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sched_garbage_add
+ *
+ * Description:
+ *   Queue a deferred de-allocation on the list of the current CPU.  This
+ *   may be called from interrupt handlers.
+ *
+ * Input parameters:
+ *   lists   - The per-CPU delayed deallocation lists (g_delayed_kfree or
+ *             g_delayed_kufree)
+ *   address - The memory to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_garbage_add(FAR volatile sq_queue_t *lists, FAR void *address)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags;
+  int cpu;
+
+  /* Disable local interrupts first so that we cannot move to another CPU */
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  spin_lock(&g_delayed_lock[cpu]);
+  sq_addlast((FAR sq_entry_t *)address, (FAR sq_queue_t *)&lists[cpu]);
+  spin_unlock(&g_delayed_lock[cpu]);
+
+  up_irq_restore(flags);
+#else
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)address, (FAR sq_queue_t *)&lists[0]);
+  leave_critical_section(flags);
+#endif
+}
+
 /****************************************************************************
  * Name: sched_garbage_collection
  *
@@ -220,6 +338,12 @@ static inline bool sched_have_kgarbage(void)
  *   collection to be called from the IDLE thread because it runs at a very
  *   low priority and could cause false memory out conditions.
  *
+ *   At most CONFIG_SCHED_GARBAGE_BATCH deallocations are performed per
+ *   call so that a large backlog does not hold the heap for long.  The list
+ *   of the calling CPU is drained first.  Any remaining garbage is collected
+ *   on the next call (the IDLE loops check sched_have_garbage() on every
+ *   pass).
+ *
  * Input parameters:
  *   None
  *
@@ -230,13 +354,27 @@ static inline bool sched_have_kgarbage(void)
 
 void sched_garbage_collection(void)
 {
-  /* Handle deferred deallocations for the kernel heap */
+  int nfree = CONFIG_SCHED_GARBAGE_BATCH;
+  int first = this_cpu();
+  int cpu;
+  int i;
 
-  sched_kcleanup();
+  for (i = 0; i < SCHED_NGARBAGE && nfree > 0; i++)
+    {
+      cpu = first + i;
+      if (cpu >= SCHED_NGARBAGE)
+        {
+          cpu -= SCHED_NGARBAGE;
+        }
 
-  /* Handle deferred deallocations for the user heap */
+      /* Handle deferred deallocations for the kernel heap */
 
-  sched_kucleanup();
+      nfree = sched_kcleanup(cpu, nfree);
+
+      /* Handle deferred deallocations for the user heap */
+
+      nfree = sched_kucleanup(cpu, nfree);
+    }
 }
 
 /****************************************************************************
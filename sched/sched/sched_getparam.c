@@ -140,6 +140,33 @@ int sched_getparam (pid_t pid, FAR struct sched_param *param)
               param->sched_ss_init_budget.tv_nsec = 0;
             }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+            {
+              FAR struct deadline_s *deadline = tcb->deadline;
+              DEBUGASSERT(deadline != NULL);
+
+              /* Return parameters associated with SCHED_DEADLINE.  The
+               * priority is not lowered while the budget is exhausted.
+               */
+
+              param->sched_priority = (int)deadline->priority;
+
+              clock_ticks2time((int)deadline->runtime, &param->sched_dl_runtime);
+              clock_ticks2time((int)deadline->deadline, &param->sched_dl_deadline);
+              clock_ticks2time((int)deadline->period, &param->sched_dl_period);
+            }
+          else
+            {
+              param->sched_dl_runtime.tv_sec   = 0;
+              param->sched_dl_runtime.tv_nsec  = 0;
+              param->sched_dl_deadline.tv_sec  = 0;
+              param->sched_dl_deadline.tv_nsec = 0;
+              param->sched_dl_period.tv_sec    = 0;
+              param->sched_dl_period.tv_nsec   = 0;
+            }
+#endif
         }
 
       sched_unlock();
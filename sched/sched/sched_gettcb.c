@@ -60,12 +60,21 @@
 FAR struct tcb_s *sched_gettcb(pid_t pid)
 {
   FAR struct tcb_s *ret = NULL;
+#ifdef CONFIG_SCHED_GROWPIDHASH
+  irqstate_t flags;
+#endif
   int hash_ndx;
 
   /* Verify that the PID is within range */
 
   if (pid >= 0)
     {
+#ifdef CONFIG_SCHED_GROWPIDHASH
+      /* Keep the PID table from being replaced while we use it */
+
+      flags = enter_critical_section();
+#endif
+
       /* Get the hash_ndx associated with the pid */
 
       hash_ndx = PIDHASH(pid);
@@ -78,6 +87,10 @@ FAR struct tcb_s *sched_gettcb(pid_t pid)
 
           ret = g_pidhash[hash_ndx].tcb;
         }
+
+#ifdef CONFIG_SCHED_GROWPIDHASH
+      leave_critical_section(flags);
+#endif
     }
 
   /* Return the TCB. */
@@ -0,0 +1,129 @@
+/****************************************************************************
+ * sched/sched/sched_idlebalance.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SMP_IDLE_BALANCE)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_idle_balance
+ *
+ * Description:
+ *   Called from the IDLE loop of each CPU.  If there is a task in the
+ *   g_readytorun list that is permitted to run on this CPU, then re-schedule
+ *   the highest priority such task.  Since this CPU is running its IDLE
+ *   task, sched_cpu_select() will select an IDLE CPU and the task will
+ *   start running there, normally on this CPU.
+ *
+ * Inputs:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called only from the IDLE task of the current CPU.
+ *
+ ****************************************************************************/
+
+void sched_idle_balance(void)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  cpu_set_t cpuset;
+
+  /* Make a quick check without the critical section.  In the usual case,
+   * there are no unassigned, ready-to-run tasks and there is nothing to be
+   * done.  We also cannot do anything if pre-emption is disabled.
+   */
+
+  if (g_readytorun.head == NULL || spin_islocked(&g_cpu_schedlock))
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  DEBUGASSERT(sched_idletask());
+
+  /* The g_readytorun list is prioritized, so the first task that may run
+   * on this CPU is the one that we want.
+   */
+
+  cpuset = (cpu_set_t)1 << this_cpu();
+  tcb    = (FAR struct tcb_s *)g_readytorun.head;
+
+  while (tcb != NULL && (tcb->affinity & cpuset) == 0)
+    {
+      tcb = tcb->flink;
+    }
+
+  /* Re-check the scheduler lock; it may have changed before we entered the
+   * critical section.
+   */
+
+  if (tcb != NULL && !spin_islocked(&g_cpu_schedlock))
+    {
+      DEBUGASSERT(tcb->task_state == TSTATE_TASK_READYTORUN);
+
+      /* Re-prioritizing the task at its current priority will remove it
+       * from the g_readytorun list and then add it back using the normal
+       * CPU selection logic, performing the context switch as needed.
+       */
+
+      up_reprioritize_rtr(tcb, tcb->sched_priority);
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SMP && CONFIG_SMP_IDLE_BALANCE */
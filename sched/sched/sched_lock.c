@@ -113,7 +113,7 @@ volatile spinlock_t g_cpu_schedlock = SP_UNLOCKED;
 
 /* Used to keep track of which CPU(s) hold the IRQ lock. */
 
-volatile spinlock_t g_cpu_locksetlock;
+volatile spinlock_set_t g_cpu_locksetlock;
 volatile cpu_set_t g_cpu_lockset;
 
 #endif /* CONFIG_SMP */
@@ -192,6 +192,14 @@ int sched_lock(void)
 
       rtcb->lockcount++;
 
+#ifdef CONFIG_SCHED_CRITMONITOR
+      /* Start the pre-emption disabled time measurement */
+
+      if (rtcb->lockcount == 1)
+        {
+          sched_critmon_preemption(rtcb, true, sched_critmon_caller());
+        }
+#endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
       /* Check if we just acquired the lock */
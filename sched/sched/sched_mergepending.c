@@ -216,7 +216,7 @@ bool sched_mergepending(void)
           return ret;
         }
 
-      cpu  = sched_cpu_select(ALL_CPUS /* ptcb->affinity */);
+      cpu  = sched_cpu_select(ptcb->affinity);
       rtcb = current_task(cpu);
 
       /* Loop while there is a higher priority task in the pending task list
@@ -271,7 +271,7 @@ bool sched_mergepending(void)
               return ret;
             }
 
-          cpu = sched_cpu_select(ALL_CPUS /* ptcb->affinity */);
+          cpu = sched_cpu_select(ptcb->affinity);
           rtcb = current_task(cpu);
         }
 
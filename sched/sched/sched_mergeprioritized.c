@@ -146,7 +146,12 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
 
       /* Which TCB has higher priority? */
 
-      else if (tcb1->sched_priority > tcb2->sched_priority)
+      else if (tcb1->sched_priority > tcb2->sched_priority
+#ifdef CONFIG_SCHED_DEADLINE
+               || (tcb1->sched_priority == tcb2->sched_priority &&
+                   sched_deadline_before(tcb1, tcb2))
+#endif
+              )
         {
           /* The TCB from list1 has higher priority than the TCB from list2.
            * Remove the TCB from list1 and insert it before the TCB from
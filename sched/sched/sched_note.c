@@ -39,29 +39,57 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
+#include <nuttx/circbuf.h>
 #include <nuttx/sched_note.h>
 
+#include "sched/sched.h"
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_BUFFER
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* There is one circular buffer per CPU.  Each buffer has a single producer
+ * (the CPU that owns it, with local interrupts disabled) and a single
+ * consumer (the caller of sched_note_get()), so no spinlock is needed.
+ */
+
+#ifdef CONFIG_SMP
+#  define NOTE_NCPUS    CONFIG_SMP_NCPUS
+#else
+#  define NOTE_NCPUS    1
+#endif
+
+/* Notes are time stamped with the high resolution counter if the
+ * architecture provides one; otherwise with the system timer.
+ */
+
+#ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
+#  define note_gettime() up_perf_gettime()
+#else
+#  define note_gettime() ((uint32_t)clock_systimer())
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
 struct note_info_s
 {
-  unsigned int ni_head;
-  unsigned int ni_tail;
+  volatile unsigned int ni_head;  /* Written only by the producer */
+  volatile unsigned int ni_tail;  /* Written only by the consumer */
+  uint32_t ni_overrun;            /* Number of notes dropped */
   uint8_t ni_buffer[CONFIG_SCHED_NOTE_BUFSIZE];
 };
 
@@ -83,7 +111,7 @@ struct note_startalloc_s
  * Private Data
  ****************************************************************************/
 
-static struct note_info_s g_note_info;
+static struct note_info_s g_note_info[NOTE_NCPUS];
 
 /****************************************************************************
  * Private Functions
@@ -119,7 +147,8 @@ static inline unsigned int note_next(unsigned int ndx, unsigned int offset)
  * Name: note_common
  *
  * Description:
- *   Fill in some of the common fields in the note structure.
+ *   Fill in some of the common fields in the note structure.  The time
+ *   stamp is added later by note_add().
  *
  * Input Parameters:
  *   tcb  - The TCB containing the information
@@ -133,8 +162,6 @@ static inline unsigned int note_next(unsigned int ndx, unsigned int offset)
 static void note_common(FAR struct tcb_s *tcb, FAR struct note_common_s *note,
                         uint8_t length, uint8_t type)
 {
-  uint32_t systime    = (uint32_t)clock_systimer();
-
   /* Save all of the common fields */
 
   note->nc_length     = length;
@@ -145,13 +172,6 @@ static void note_common(FAR struct tcb_s *tcb, FAR struct note_common_s *note,
 #endif
   note->nc_pid[0]     = (uint8_t)(tcb->pid & 0xff);
   note->nc_pid[1]     = (uint8_t)((tcb->pid >> 8) & 0xff);
-
-  /* Save the LS 32-bits of the system timer in little endian order */
-
-  note->nc_systime[0] = (uint8_t)( systime        & 0xff);
-  note->nc_systime[1] = (uint8_t)((systime >> 8)  & 0xff);
-  note->nc_systime[2] = (uint8_t)((systime >> 16) & 0xff);
-  note->nc_systime[3] = (uint8_t)((systime >> 24) & 0xff);
 }
 
 /****************************************************************************
@@ -161,17 +181,17 @@ static void note_common(FAR struct tcb_s *tcb, FAR struct note_common_s *note,
  *   Length of data currently in circular buffer.
  *
  * Input Parameters:
- *   None
+ *   info - The circular buffer
  *
  * Returned Value:
  *   Length of data currently in circular buffer.
  *
  ****************************************************************************/
 
-static unsigned int note_length(void)
+static unsigned int note_length(FAR struct note_info_s *info)
 {
-  unsigned int head = g_note_info.ni_head;
-  unsigned int tail = g_note_info.ni_tail;
+  unsigned int head = info->ni_head;
+  unsigned int tail = info->ni_tail;
 
   if (tail > head)
     {
@@ -181,6 +201,90 @@ static unsigned int note_length(void)
   return head - tail;
 }
 
+/****************************************************************************
+ * Name: note_systime
+ *
+ * Description:
+ *   Return the time stamp of the note at the tail of a non-empty circular
+ *   buffer.  The note may wrap around the end of the buffer.
+ *
+ ****************************************************************************/
+
+static uint32_t note_systime(FAR struct note_info_s *info)
+{
+  unsigned int ndx;
+  uint32_t systime = 0;
+  int i;
+
+  ndx = note_next(info->ni_tail,
+                  offsetof(struct note_common_s, nc_systime) + 3);
+
+  for (i = 0; i < 4; i++)
+    {
+      systime = (systime << 8) | info->ni_buffer[ndx];
+      ndx     = ndx > 0 ? ndx - 1 : CONFIG_SCHED_NOTE_BUFSIZE - 1;
+    }
+
+  return systime;
+}
+
+/****************************************************************************
+ * Name: note_oldest
+ *
+ * Description:
+ *   Select the circular buffer holding the oldest note so that the notes
+ *   of all CPUs are returned in time order.
+ *
+ * Returned Value:
+ *   The selected circular buffer or NULL if all are empty.
+ *
+ * Assumptions:
+ *   Called only by the (single) consumer.
+ *
+ ****************************************************************************/
+
+static FAR struct note_info_s *note_oldest(void)
+{
+  FAR struct note_info_s *oldest = NULL;
+#if NOTE_NCPUS > 1
+  uint32_t oldtime = 0;
+  uint32_t systime;
+#endif
+  int cpu;
+
+  for (cpu = 0; cpu < NOTE_NCPUS; cpu++)
+    {
+      FAR struct note_info_s *info = &g_note_info[cpu];
+
+      if (note_length(info) == 0)
+        {
+          continue;
+        }
+
+#if NOTE_NCPUS > 1
+      /* Don't read the note before the head index that published it */
+
+      CIRCBUF_BARRIER();
+
+      /* Compare relative to the oldest so far so that the comparison still
+       * works after the counter wraps.
+       */
+
+      systime = note_systime(info);
+      if (oldest == NULL || (int32_t)(systime - oldtime) < 0)
+        {
+          oldest  = info;
+          oldtime = systime;
+        }
+#else
+      oldest = info;
+#endif
+    }
+
+  CIRCBUF_BARRIER();
+  return oldest;
+}
+
 /****************************************************************************
  * Name: note_remove
  *
@@ -188,17 +292,17 @@ static unsigned int note_length(void)
  *   Remove the variable length note from the tail of the circular buffer
  *
  * Input Parameters:
- *   None
+ *   info - The circular buffer
  *
  * Returned Value:
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   Called only by the (single) consumer.
  *
  ****************************************************************************/
 
-static void note_remove(void)
+static void note_remove(FAR struct note_info_s *info)
 {
   FAR struct note_common_s *note;
   unsigned int tail;
@@ -206,74 +310,94 @@ static void note_remove(void)
 
   /* Get the tail index of the circular buffer */
 
-  tail = g_note_info.ni_tail;
+  tail = info->ni_tail;
   DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  note   = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
+  note   = (FAR struct note_common_s *)&info->ni_buffer[tail];
   length = note->nc_length;
-  DEBUGASSERT(length <= note_length());
+  DEBUGASSERT(length <= note_length(info));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  g_note_info.ni_tail = note_next(tail, length);
+  info->ni_tail = note_next(tail, length);
 }
 
 /****************************************************************************
  * Name: note_add
  *
  * Description:
- *   Add the variable length note to the head of the circular buffer
+ *   Time stamp the variable length note and add it to the head of the
+ *   circular buffer of the current CPU.  If there is no space for the
+ *   note, it is dropped and counted as an overrun:  The tail belongs to
+ *   the consumer and is never moved by the producer.
  *
  * Input Parameters:
- *   None
+ *   note    - The note to add
+ *   notelen - The length of the note
  *
  * Returned Value:
  *   None
  *
- * Assumptions:
- *   We are within a critical section.
- *
  ****************************************************************************/
 
-static void note_add(FAR const uint8_t *note, uint8_t notelen)
+static void note_add(FAR uint8_t *note, uint8_t notelen)
 {
+  FAR struct note_common_s *cmn = (FAR struct note_common_s *)note;
+  FAR struct note_info_s *info;
+  irqstate_t flags;
   unsigned int head;
-  unsigned int next;
-
-  /* Get the index to the head of the circular buffer */
+  uint32_t systime;
 
   DEBUGASSERT(note != NULL && notelen < CONFIG_SCHED_NOTE_BUFSIZE);
-  head = g_note_info.ni_head;
 
-  /* Loop until all bytes have been transferred to the circular buffer */
+  /* Only local interrupts need to be disabled; no other CPU produces into
+   * this buffer.
+   */
 
-  while (notelen > 0)
-    {
-      /* Get the next head index.  Would it collide with the current tail
-       * index?
-       */
+  flags = up_irq_save();
+  info  = &g_note_info[up_cpu_index()];
 
-      next = note_next(head, 1);
-      if (next == g_note_info.ni_tail)
-        {
-          /* Yes, then remove the note at the tail index */
+  /* One byte is always left unused so that a full buffer can be
+   * distinguished from an empty one.
+   */
 
-          note_remove();
-        }
+  if (notelen > CONFIG_SCHED_NOTE_BUFSIZE - 1 - note_length(info))
+    {
+      info->ni_overrun++;
+      up_irq_restore(flags);
+      return;
+    }
+
+  /* Save the LS 32-bits of the time stamp in little endian order.  This is
+   * done here, with interrupts disabled, so that the notes in each buffer
+   * are in time order.
+   */
 
-      /* Save the next byte at the head index */
+  systime             = note_gettime();
+  cmn->nc_systime[0]  = (uint8_t)( systime        & 0xff);
+  cmn->nc_systime[1]  = (uint8_t)((systime >> 8)  & 0xff);
+  cmn->nc_systime[2]  = (uint8_t)((systime >> 16) & 0xff);
+  cmn->nc_systime[3]  = (uint8_t)((systime >> 24) & 0xff);
 
-      g_note_info.ni_buffer[head] = *note++;
+  /* Copy the note to the head of the circular buffer */
 
-      head = next;
+  head = info->ni_head;
+  while (notelen > 0)
+    {
+      info->ni_buffer[head] = *note++;
+      head = note_next(head, 1);
       notelen--;
     }
 
-  g_note_info.ni_head = head;
+  /* Make the note visible to the consumer only after it is complete */
+
+  CIRCBUF_BARRIER();
+  info->ni_head = head;
+  up_irq_restore(flags);
 }
 
 /****************************************************************************
@@ -326,7 +450,7 @@ void sched_note_start(FAR struct tcb_s *tcb)
 
   /* Add the note to circular buffer */
 
-  note_add((FAR const uint8_t *)&note, length);
+  note_add((FAR uint8_t *)&note, length);
 }
 
 void sched_note_stop(FAR struct tcb_s *tcb)
@@ -339,7 +463,7 @@ void sched_note_stop(FAR struct tcb_s *tcb)
 
   /* Add the note to circular buffer */
 
-  note_add((FAR const uint8_t *)&note, sizeof(struct note_stop_s));
+  note_add((FAR uint8_t *)&note, sizeof(struct note_stop_s));
 }
 
 void sched_note_suspend(FAR struct tcb_s *tcb)
@@ -353,7 +477,7 @@ void sched_note_suspend(FAR struct tcb_s *tcb)
 
   /* Add the note to circular buffer */
 
-  note_add((FAR const uint8_t *)&note, sizeof(struct note_suspend_s));
+  note_add((FAR uint8_t *)&note, sizeof(struct note_suspend_s));
 }
 
 void sched_note_resume(FAR struct tcb_s *tcb)
@@ -366,7 +490,7 @@ void sched_note_resume(FAR struct tcb_s *tcb)
 
   /* Add the note to circular buffer */
 
-  note_add((FAR const uint8_t *)&note, sizeof(struct note_resume_s));
+  note_add((FAR uint8_t *)&note, sizeof(struct note_resume_s));
 }
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
@@ -383,7 +507,7 @@ void sched_note_premption(FAR struct tcb_s *tcb, bool locked)
 
   /* Add the note to circular buffer */
 
-  note_add((FAR const uint8_t *)&note, sizeof(struct note_preempt_s));
+  note_add((FAR uint8_t *)&note, sizeof(struct note_preempt_s));
 }
 #endif
 
@@ -403,7 +527,65 @@ void sched_note_csection(FAR struct tcb_s *tcb, bool enter)
 
   /* Add the note to circular buffer */
 
-  note_add((FAR const uint8_t *)&note, sizeof(struct note_csection_s));
+  note_add((FAR uint8_t *)&note, sizeof(struct note_csection_s));
+}
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+void sched_note_deadline(FAR struct tcb_s *tcb, uint32_t lateness)
+{
+  struct note_deadline_s note;
+
+  /* Format the note */
+
+  note_common(tcb, &note.ndl_cmn, sizeof(struct note_deadline_s),
+              NOTE_DEADLINE_MISS);
+  note.ndl_lateness[0] = (uint8_t)(lateness & 0xff);
+  note.ndl_lateness[1] = (uint8_t)((lateness >> 8) & 0xff);
+  note.ndl_lateness[2] = (uint8_t)((lateness >> 16) & 0xff);
+  note.ndl_lateness[3] = (uint8_t)((lateness >> 24) & 0xff);
+
+  /* Add the note to circular buffer */
+
+  note_add((FAR uint8_t *)&note, sizeof(struct note_deadline_s));
+}
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+void sched_note_irqhandler(int irq, FAR void *handler, bool enter)
+{
+  struct note_irqhandler_s note;
+
+  /* Format the note */
+
+  note_common(this_task(), &note.nih_cmn, sizeof(struct note_irqhandler_s),
+              enter ? NOTE_IRQ_ENTER : NOTE_IRQ_LEAVE);
+  note.nih_irq[0] = (uint8_t)(irq & 0xff);
+  note.nih_irq[1] = (uint8_t)((irq >> 8) & 0xff);
+
+  /* Add the note to circular buffer */
+
+  note_add((FAR uint8_t *)&note, sizeof(struct note_irqhandler_s));
+}
+#endif
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+void sched_note_wakeup(FAR struct tcb_s *tcb, uint32_t latency)
+{
+  struct note_wakeup_s note;
+
+  /* Format the note */
+
+  note_common(tcb, &note.nwu_cmn, sizeof(struct note_wakeup_s),
+              NOTE_WAKEUP_LATENCY);
+  note.nwu_latency[0] = (uint8_t)(latency & 0xff);
+  note.nwu_latency[1] = (uint8_t)((latency >> 8) & 0xff);
+  note.nwu_latency[2] = (uint8_t)((latency >> 16) & 0xff);
+  note.nwu_latency[3] = (uint8_t)((latency >> 24) & 0xff);
+
+  /* Add the note to circular buffer */
+
+  note_add((FAR uint8_t *)&note, sizeof(struct note_wakeup_s));
 }
 #endif
 
@@ -413,6 +595,7 @@ void sched_note_csection(FAR struct tcb_s *tcb, bool enter)
  * Description:
  *   Remove the next note from the tail of the circular buffer.  The note
  *   is also removed from the circular buffer to make room for futher notes.
+ *   In SMP, the oldest note of all CPUs is returned.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -423,39 +606,42 @@ void sched_note_csection(FAR struct tcb_s *tcb, bool enter)
  *   provided.  Zero is returned only if ther circular buffer is empty.  A
  *   negated errno value is returned in the event of any failure.
  *
+ * Assumptions:
+ *   There is only one consumer at a time.  The caller must serialize
+ *   calls to sched_note_get(), sched_note_size() and sched_note_read().
+ *
  ****************************************************************************/
 
 ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
 {
   FAR struct note_common_s *note;
-  irqstate_t flags;
+  FAR struct note_info_s *info;
   unsigned int remaining;
   unsigned int tail;
   ssize_t notelen;
-  size_t circlen;
 
   DEBUGASSERT(buffer != NULL);
-  flags = enter_critical_section();
 
-  /* Verify that the circular buffer is not empty */
+  /* Select the buffer with the oldest note.  NULL means that all of the
+   * buffers are empty.
+   */
 
-  circlen = note_length();
-  if (circlen <= 0)
+  info = note_oldest();
+  if (info == NULL)
     {
-      notelen = 0;
-      goto errout_with_csection;
+      return 0;
     }
 
   /* Get the index to the tail of the circular buffer */
 
-  tail    = g_note_info.ni_tail;
+  tail    = info->ni_tail;
   DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
 
   /* Get the length of the note at the tail index */
 
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
+  note    = (FAR struct note_common_s *)&info->ni_buffer[tail];
   notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  DEBUGASSERT(notelen <= note_length(info));
 
   /* Is the user buffer large enough to hold the note? */
 
@@ -463,12 +649,11 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Remove the large note so that we do not get constipated. */
 
-      note_remove();
+      note_remove(info);
 
       /* and return an error */
 
-      notelen = -EFBIG;
-      goto errout_with_csection;
+      return -EFBIG;
     }
 
   /* Loop until the note has been transferred to the user buffer */
@@ -478,7 +663,7 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
     {
       /* Copy the next byte at the tail index */
 
-      *buffer++ = g_note_info.ni_buffer[tail];
+      *buffer++ = info->ni_buffer[tail];
 
       /* Adjust indices and counts */
 
@@ -486,10 +671,10 @@ ssize_t sched_note_get(FAR uint8_t *buffer, size_t buflen)
       remaining--;
     }
 
-  g_note_info.ni_tail = tail;
+  /* Release the space to the producer only after the copy is complete */
 
-errout_with_csection:
-  leave_critical_section(flags);
+  CIRCBUF_BARRIER();
+  info->ni_tail = tail;
   return notelen;
 }
 
@@ -511,36 +696,88 @@ errout_with_csection:
 ssize_t sched_note_size(void)
 {
   FAR struct note_common_s *note;
-  irqstate_t flags;
-  unsigned int tail;
+  FAR struct note_info_s *info;
+
+  info = note_oldest();
+  if (info == NULL)
+    {
+      return 0;
+    }
+
+  note = (FAR struct note_common_s *)&info->ni_buffer[info->ni_tail];
+  return note->nc_length;
+}
+
+/****************************************************************************
+ * Name: sched_note_read
+ *
+ * Description:
+ *   Remove as many complete notes as will fit into the user buffer.  This
+ *   is the bulk form of sched_note_get().
+ *
+ * Input Parameters:
+ *   buffer - Location to return the notes
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   The number of bytes returned (zero if the circular buffers are empty).
+ *   -EFBIG is returned (and the note dropped) only if the very first note
+ *   does not fit into the user buffer.
+ *
+ ****************************************************************************/
+
+ssize_t sched_note_read(FAR uint8_t *buffer, size_t buflen)
+{
   ssize_t notelen;
-  size_t circlen;
+  ssize_t retlen = 0;
 
-  flags = enter_critical_section();
+  DEBUGASSERT(buffer != NULL);
 
-  /* Verify that the circular buffer is not empty */
+  /* There is only one consumer, so the next note cannot change between
+   * sched_note_size() and sched_note_get().
+   */
 
-  circlen = note_length();
-  if (circlen <= 0)
+  while ((notelen = sched_note_size()) > 0)
     {
-      notelen = 0;
-      goto errout_with_csection;
+      if (notelen > buflen && retlen > 0)
+        {
+          break;
+        }
+
+      notelen = sched_note_get(buffer, buflen);
+      if (notelen <= 0)
+        {
+          return retlen > 0 ? retlen : notelen;
+        }
+
+      retlen += notelen;
+      buffer += notelen;
+      buflen -= notelen;
     }
 
-  /* Get the index to the tail of the circular buffer */
+  return retlen;
+}
 
-  tail = g_note_info.ni_tail;
-  DEBUGASSERT(tail < CONFIG_SCHED_NOTE_BUFSIZE);
+/****************************************************************************
+ * Name: sched_note_overrun
+ *
+ * Description:
+ *   Return the total number of notes that were dropped because a circular
+ *   buffer was full.
+ *
+ ****************************************************************************/
 
-  /* Get the length of the note at the tail index */
+uint32_t sched_note_overrun(void)
+{
+  uint32_t overrun = 0;
+  int cpu;
 
-  note    = (FAR struct note_common_s *)&g_note_info.ni_buffer[tail];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+  for (cpu = 0; cpu < NOTE_NCPUS; cpu++)
+    {
+      overrun += g_note_info[cpu].ni_overrun;
+    }
 
-errout_with_csection:
-  leave_critical_section(flags);
-  return notelen;
+  return overrun;
 }
 
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
@@ -77,7 +77,8 @@
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void sched_process_scheduler(void)
 {
   FAR struct tcb_s *rtcb  = this_task();
@@ -107,6 +108,19 @@ static inline void sched_process_scheduler(void)
       (void)sched_sporadic_process(rtcb, 1, false);
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, check if the currently executing task has exhausted the
+       * budget of its job.
+       */
+
+      (void)sched_deadline_process(rtcb, 1, false);
+    }
+#endif
 }
 #else
 #  define sched_process_scheduler()
@@ -153,7 +167,8 @@ void sched_process_timer(void)
       clock_timer();
     }
 
-#if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_SCHED_CPULOAD_EXTCLK)
+#if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_SCHED_CPULOAD_EXTCLK) && \
+    !defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
   /* Perform CPU load measurements (before any timer-initiated context
    * switches can occur)
    */
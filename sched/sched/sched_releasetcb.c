@@ -63,6 +63,11 @@
 
 static void sched_releasepid(pid_t pid)
 {
+#ifdef CONFIG_SCHED_GROWPIDHASH
+  /* Keep the PID table from being replaced while we use it */
+
+  irqstate_t flags = enter_critical_section();
+#endif
   int hash_ndx = PIDHASH(pid);
 
   /* Make any pid associated with this hash available.  Note:
@@ -82,6 +87,10 @@ static void sched_releasepid(pid_t pid)
   g_cpuload_total          -= g_pidhash[hash_ndx].ticks;
   g_pidhash[hash_ndx].ticks = 0;
 #endif
+
+#ifdef CONFIG_SCHED_GROWPIDHASH
+  leave_critical_section(flags);
+#endif
 }
 
 /****************************************************************************
@@ -142,6 +151,7 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
           sched_releasepid(tcb->pid);
         }
 
+#ifndef CONFIG_SCHED_TCBPOOL
       /* Delete the thread's stack if one has been allocated */
 
       if (tcb->stack_alloc_ptr)
@@ -163,6 +173,13 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
               up_release_stack(tcb, ttype);
             }
         }
+#endif
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+      /* Release the thread's compiler TLS block */
+
+      sched_threadlocal_free(tcb);
+#endif
 
 #ifdef CONFIG_PIC
       /* Delete the task's allocated DSpace region (external modules only) */
@@ -198,6 +215,17 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
       group_leave(tcb);
 #endif
 
+#ifdef CONFIG_SCHED_TCBPOOL
+      /* Keep the TCB and its stack for re-use if there is room in the pool.
+       * Otherwise, the stack is released and the TCB is freed below.
+       */
+
+      if (sched_tcbpool(tcb, ttype))
+        {
+          return ret;
+        }
+#endif
+
       /* And, finally, release the TCB itself */
 
       sched_kfree(tcb);
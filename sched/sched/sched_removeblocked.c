@@ -87,4 +87,12 @@ void sched_removeblocked(FAR struct tcb_s *btcb)
    */
 
   btcb->task_state = TSTATE_TASK_INVALID;
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+  /* The task is about to be made ready-to-run.  Start measuring how long
+   * it waits to run.
+   */
+
+  sched_wakelat_ready(btcb);
+#endif
 }
@@ -0,0 +1,191 @@
+/****************************************************************************
+ * sched/sched/sched_resched.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SMP_RESCHED_IPI)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The need-resched flag of each CPU */
+
+volatile bool g_cpu_resched[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_resched_request
+ *
+ * Description:
+ *   Ask another CPU to reschedule.  The need-resched flag of the CPU is set
+ *   and the CPU is interrupted, but this CPU does not wait for it.  This is
+ *   used instead of up_cpu_pause()/up_cpu_resume() when a task that has
+ *   been left in the g_readytorun list should pre-empt the task running on
+ *   the other CPU.
+ *
+ * Inputs:
+ *   cpu - The index of the CPU that should reschedule.
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the critical section.
+ *
+ ****************************************************************************/
+
+void sched_resched_request(int cpu)
+{
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS && cpu != this_cpu());
+
+  /* If the flag is already set, then an interrupt is already on its way and
+   * the other CPU has not yet acted upon it.  It will see the new task too.
+   */
+
+  if (!g_cpu_resched[cpu])
+    {
+      g_cpu_resched[cpu] = true;
+
+      /* The flag must be visible before the interrupt is taken */
+
+      SP_DMB();
+      DEBUGVERIFY(up_cpu_resched(cpu));
+    }
+}
+
+/****************************************************************************
+ * Name: sched_resched_process
+ *
+ * Description:
+ *   Called by architecture specific interrupt handling logic just before
+ *   returning from each interrupt.  If another CPU has requested that this
+ *   CPU reschedule, then pull the highest priority task that may run on
+ *   this CPU from the g_readytorun list if it has a higher priority than
+ *   the task that is currently running, performing an interrupt level
+ *   context switch if necessary.
+ *
+ * Inputs:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from interrupt handling logic with CURRENT_REGS valid.
+ *
+ ****************************************************************************/
+
+void sched_resched_process(void)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  int cpu;
+
+  /* In the usual case, there is no request and nothing to be done */
+
+  cpu = this_cpu();
+  if (!g_cpu_resched[cpu])
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  g_cpu_resched[cpu] = false;
+
+  /* The g_readytorun list is prioritized, so the first task that may run
+   * on this CPU is the one that we want.  Some other CPU may already have
+   * taken the task that caused the request;  that is fine.
+   */
+
+  rtcb = current_task(cpu);
+  for (tcb = (FAR struct tcb_s *)g_readytorun.head;
+       tcb != NULL && !CPU_ISSET(cpu, &tcb->affinity);
+       tcb = tcb->flink);
+
+  if (tcb != NULL && tcb->sched_priority > rtcb->sched_priority)
+    {
+      DEBUGASSERT(tcb->task_state == TSTATE_TASK_READYTORUN);
+
+      if (spin_islocked(&g_cpu_schedlock))
+        {
+          /* Pre-emption has been disabled (by some CPU) since the request
+           * was made.  Move the task to the g_pendingtasks list so that it
+           * will be restarted when the scheduler is unlocked.
+           */
+
+          dq_rem((FAR dq_entry_t *)tcb, (FAR dq_queue_t *)&g_readytorun);
+          (void)sched_addprioritized(tcb, (FAR dq_queue_t *)&g_pendingtasks);
+          tcb->task_state = TSTATE_TASK_PENDING;
+        }
+      else
+        {
+          /* Re-prioritizing the task at its current priority will remove
+           * it from the g_readytorun list and then add it back using the
+           * normal CPU selection logic.  This CPU is running a lower
+           * priority task, so the task will normally start running here;
+           * if some CPU is now running an even lower priority task, that
+           * CPU will be asked to reschedule instead.
+           */
+
+          up_reprioritize_rtr(tcb, tcb->sched_priority);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SMP && CONFIG_SMP_RESCHED_IPI */
@@ -41,14 +41,18 @@
 
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/vdso.h>
 
 #include "sched/sched.h"
 
 #if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
-    defined(CONFIG_SCHED_INSTRUMENTATION)
+    defined(CONFIG_SCHED_INSTRUMENTATION) || defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_CPULOAD_PERFCOUNT) || defined(CONFIG_LIB_SYSCALL_VDSO) || \
+    defined(CONFIG_SCHED_THREAD_LOCAL) || defined(CONFIG_SCHED_WAKEUPLAT)
 
 /****************************************************************************
  * Public Functions
@@ -95,12 +99,46 @@ void sched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+  /* Start charging the time that the task runs */
+
+  sched_cpuload_resume(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  /* Restart the measurement of any pre-emption or interrupts disabled
+   * time.
+   */
+
+  sched_critmon_resume(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+  /* Record the wake-up latency if the task was made ready-to-run */
+
+  sched_wakelat_resume(tcb);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   /* Inidicate the the task has been resumed */
 
   sched_note_resume(tcb);
 #endif
 
+#ifdef CONFIG_LIB_SYSCALL_VDSO
+  /* Publish the PID of the resumed task for user space */
+
+  sched_vdso_resume(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+  /* Point the thread pointer register at the TLS block of the task */
+
+  up_tls_setpointer(tcb->tls_pointer);
+#endif
 }
 
-#endif /* CONFIG_RR_INTERVAL > 0 || CONFIG_SCHED_SPORADIC || CONFIG_SCHED_INSTRUMENTATION */
+#endif /* CONFIG_RR_INTERVAL > 0 || CONFIG_SCHED_SPORADIC || CONFIG_SCHED_INSTRUMENTATION ||
+        * CONFIG_SCHED_CRITMONITOR || CONFIG_SCHED_CPULOAD_PERFCOUNT ||
+        * CONFIG_LIB_SYSCALL_VDSO || CONFIG_SCHED_THREAD_LOCAL ||
+        * CONFIG_SCHED_WAKEUPLAT */
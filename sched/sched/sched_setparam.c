@@ -215,6 +215,27 @@ int sched_setparam(pid_t pid, FAR const struct sched_param *param)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Update parameters associated with SCHED_DEADLINE.  This restarts
+   * deadline scheduling with a new job.
+   */
+
+  if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      ret = sched_deadline_start(tcb, param);
+      leave_critical_section(flags);
+
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_lock;
+        }
+    }
+#endif
+
   /* Then perform the reprioritization */
 
   ret = sched_reprioritize(tcb, param->sched_priority);
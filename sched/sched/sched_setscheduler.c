@@ -67,7 +67,8 @@
  * Inputs:
  *   pid - the task ID of the task to modify.  If pid is zero, the calling
  *      task is modified.
- *   policy - Scheduling policy requested (either SCHED_FIFO or SCHED_RR)
+ *   policy - Scheduling policy requested (SCHED_FIFO, SCHED_RR,
+ *      SCHED_SPORADIC, or SCHED_DEADLINE)
  *   param - A structure whose member sched_priority is the new priority.
  *      The range of valid priority numbers is from SCHED_PRIORITY_MIN
  *      through SCHED_PRIORITY_MAX.
@@ -78,6 +79,8 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  SCHED_DEADLINE was requested but the thread cannot be admitted
+ *          without exceeding the deadline utilization limit.
  *
  * Assumptions:
  *
@@ -88,7 +91,7 @@ int sched_setscheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
   int errcode;
 #endif
   int ret;
@@ -101,6 +104,9 @@ int sched_setscheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
     )
     {
@@ -133,6 +139,17 @@ int sched_setscheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Cancel any on-going deadline scheduling */
+
+  if (policy != SCHED_DEADLINE &&
+      (tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      DEBUGVERIFY(sched_deadline_reset(tcb));
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -267,6 +284,44 @@ int sched_setscheduler(pid_t pid, int policy,
         break;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* Admit the thread and release its first job */
+
+          ret = sched_deadline_start(tcb, param);
+          if (ret < 0)
+            {
+              /* Any previous deadline parameters remain in effect */
+
+              if (tcb->deadline != NULL && tcb->deadline->util > 0)
+                {
+                  tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+                }
+
+              errcode = -ret;
+              goto errout_with_irq;
+            }
+
+#ifdef CONFIG_SCHED_SPORADIC
+          /* Cancel any on-going sporadic scheduling */
+
+          if (tcb->sporadic != NULL)
+            {
+              DEBUGVERIFY(sched_sporadic_stop(tcb));
+            }
+#endif
+
+          /* Save the deadline scheduling parameters */
+
+          tcb->flags       |= TCB_FLAG_SCHED_DEADLINE;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+          tcb->timeslice    = 0;
+#endif
+        }
+        break;
+#endif
+
 #if 0 /* Not supported */
       case SCHED_OTHER:
         tcb->flags    |= TCB_FLAG_SCHED_OTHER;
@@ -282,7 +337,7 @@ int sched_setscheduler(pid_t pid, int policy,
   sched_unlock();
   return (ret >= 0) ? OK : ERROR;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   set_errno(errcode);
   leave_critical_section(flags);
@@ -50,7 +50,8 @@
 #include "clock/clock.h"
 #include "sched/sched.h"
 
-#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION)
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_INSTRUMENTATION) || \
+    defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_CPULOAD_PERFCOUNT)
 
 /****************************************************************************
  * Public Functions
@@ -83,6 +84,20 @@ void sched_suspend_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_PERFCOUNT
+  /* Charge the time that the task has run to the task */
+
+  sched_cpuload_suspend(tcb);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR
+  /* Record the time that the task ran with pre-emption or interrupts
+   * disabled.
+   */
+
+  sched_critmon_suspend(tcb);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   /* Inidicate the the task has been suspended */
 
@@ -90,4 +105,5 @@ void sched_suspend_scheduler(FAR struct tcb_s *tcb)
 #endif
 }
 
-#endif /* CONFIG_SCHED_SPORADIC || CONFIG_SCHED_INSTRUMENTATION */
+#endif /* CONFIG_SCHED_SPORADIC || CONFIG_SCHED_INSTRUMENTATION || CONFIG_SCHED_CRITMONITOR ||
+        * CONFIG_SCHED_CPULOAD_PERFCOUNT */
@@ -0,0 +1,267 @@
+/****************************************************************************
+ * sched/sched/sched_tcbpool.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/tls.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_TCBPOOL
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A list of retained TCBs, linked through the TCB flink field.  Each
+ * pooled TCB still owns the stack that was allocated for it.
+ */
+
+struct tcbpool_s
+{
+  FAR struct tcb_s *head;     /* First retained TCB */
+  uint8_t npooled;            /* Number of TCBs in the list */
+  uint8_t maxpooled;          /* Maximum number of TCBs in the list */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Task and kernel thread TCBs (struct task_tcb_s) */
+
+static struct tcbpool_s g_taskpool =
+{
+  NULL, 0, CONFIG_SCHED_TCBPOOL_NTASKS
+};
+
+/* Pthread TCBs (struct pthread_tcb_s) */
+
+#ifndef CONFIG_DISABLE_PTHREAD
+static struct tcbpool_s g_pthreadpool =
+{
+  NULL, 0, CONFIG_SCHED_TCBPOOL_NPTHREADS
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_tcbpool_select
+ *
+ * Description:
+ *   Return the pool and the TCB size for the thread type.
+ *
+ ****************************************************************************/
+
+static FAR struct tcbpool_s *sched_tcbpool_select(uint8_t ttype,
+                                                  FAR size_t *tcbsize)
+{
+#ifndef CONFIG_DISABLE_PTHREAD
+  if (ttype == TCB_FLAG_TTYPE_PTHREAD)
+    {
+      *tcbsize = sizeof(struct pthread_tcb_s);
+      return &g_pthreadpool;
+    }
+#endif
+
+  *tcbsize = sizeof(struct task_tcb_s);
+  return &g_taskpool;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_tcballoc
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a new thread.  If the pool holds a TCB of the
+ *   same thread type whose stack was created with the same requested size,
+ *   then that TCB is re-used and it is returned with its stack still
+ *   attached (stack_alloc_ptr is non-NULL).  Otherwise, a new TCB is
+ *   allocated and the caller must create its stack with up_create_stack().
+ *
+ * Input Parameters:
+ *   ttype      - The thread type (TCB_FLAG_TTYPE_TASK, _PTHREAD or _KERNEL)
+ *   stack_size - The stack size that will be requested for the thread
+ *
+ * Returned Value:
+ *   The new TCB or NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *sched_tcballoc(uint8_t ttype, size_t stack_size)
+{
+  FAR struct tcbpool_s *pool;
+  FAR struct tcb_s *prev = NULL;
+  FAR struct tcb_s *tcb;
+  FAR void *stack_alloc_ptr;
+  FAR void *adj_stack_ptr;
+  size_t adj_stack_size;
+  size_t tcbsize;
+  irqstate_t flags;
+
+  pool = sched_tcbpool_select(ttype, &tcbsize);
+
+  /* Look for a pooled TCB with a matching stack */
+
+  flags = enter_critical_section();
+  for (tcb = pool->head; tcb != NULL; prev = tcb, tcb = tcb->flink)
+    {
+      if (tcb->flags == ttype && tcb->pool_stacksize == stack_size)
+        {
+          if (prev != NULL)
+            {
+              prev->flink = tcb->flink;
+            }
+          else
+            {
+              pool->head = tcb->flink;
+            }
+
+          pool->npooled--;
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (tcb == NULL)
+    {
+      /* No.. allocate a new TCB.  The stack will be created by the caller */
+
+      tcb = (FAR struct tcb_s *)kmm_zalloc(tcbsize);
+      if (tcb != NULL)
+        {
+          tcb->pool_stacksize = stack_size;
+        }
+
+      return tcb;
+    }
+
+  /* Re-initialize the TCB, keeping only its stack */
+
+  stack_alloc_ptr = tcb->stack_alloc_ptr;
+  adj_stack_ptr   = tcb->adj_stack_ptr;
+  adj_stack_size  = tcb->adj_stack_size;
+
+  memset(tcb, 0, tcbsize);
+
+  tcb->stack_alloc_ptr = stack_alloc_ptr;
+  tcb->adj_stack_ptr   = adj_stack_ptr;
+  tcb->adj_stack_size  = adj_stack_size;
+  tcb->pool_stacksize  = stack_size;
+
+#ifdef CONFIG_TLS
+  /* Re-initialize the TLS data structure at the bottom of the stack */
+
+  memset(stack_alloc_ptr, 0, sizeof(struct tls_info_s));
+#endif
+
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: sched_tcbpool
+ *
+ * Description:
+ *   Called by sched_releasetcb() after everything else held by the TCB has
+ *   been released.  Retain the TCB and its stack in the pool if it was
+ *   allocated by sched_tcballoc() and there is room.  Otherwise, release
+ *   the stack; the caller must then free the TCB.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB being released
+ *   ttype - The thread type of the TCB
+ *
+ * Returned Value:
+ *   true if the TCB was retained in the pool.
+ *
+ ****************************************************************************/
+
+bool sched_tcbpool(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+  FAR struct tcbpool_s *pool;
+  size_t tcbsize;
+  irqstate_t flags;
+  bool pooled = false;
+
+  pool = sched_tcbpool_select(ttype, &tcbsize);
+
+  if (tcb->stack_alloc_ptr != NULL && tcb->pool_stacksize > 0)
+    {
+      flags = enter_critical_section();
+      if (pool->npooled < pool->maxpooled)
+        {
+          /* The flags field now only records the thread type for
+           * sched_tcballoc().
+           */
+
+          tcb->flags = ttype;
+          tcb->flink = pool->head;
+          pool->head = tcb;
+          pool->npooled++;
+          pooled     = true;
+        }
+
+      leave_critical_section(flags);
+    }
+
+  if (!pooled && tcb->stack_alloc_ptr != NULL)
+    {
+      up_release_stack(tcb, ttype);
+    }
+
+  return pooled;
+}
+
+#endif /* CONFIG_SCHED_TCBPOOL */
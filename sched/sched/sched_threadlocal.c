@@ -0,0 +1,156 @@
+/****************************************************************************
+ * sched/sched/sched_threadlocal.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The thread pointer addresses a two word thread control block that is
+ * followed by the TLS block itself (the ELF "variant I" layout used by
+ * ARM).  The compiler adds this offset to the offset of each variable
+ * within the .tdata/.tbss image.
+ */
+
+#define TLS_TCB_SIZE   (2 * sizeof(uintptr_t))
+#define TLS_ALIGN      8
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The initial image of the thread local data, provided by the linker
+ * script.
+ */
+
+extern uint8_t _stdata[];
+extern uint8_t _etdata[];
+extern uint8_t _stbss[];
+extern uint8_t _etbss[];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_threadlocal_alloc
+ *
+ * Description:
+ *   Allocate the compiler TLS block of a new thread and initialize it from
+ *   the .tdata image, with the .tbss portion zeroed.  If the program has
+ *   no thread local data, then no block is allocated.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the new thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the block could not be allocated.
+ *
+ ****************************************************************************/
+
+int sched_threadlocal_alloc(FAR struct tcb_s *tcb)
+{
+  size_t datasize = (size_t)(_etdata - _stdata);
+  size_t tlssize  = (size_t)(_etbss - _stdata);
+  FAR uint8_t *block;
+
+  DEBUGASSERT(((uintptr_t)_stdata & (TLS_ALIGN - 1)) == 0 &&
+              _stbss >= _etdata);
+
+  tcb->tls_pointer = NULL;
+  if (tlssize == 0)
+    {
+      return OK;
+    }
+
+  /* The TLS block lies in user memory so that threads can access it in
+   * user mode.
+   */
+
+  block = (FAR uint8_t *)kumm_memalign(TLS_ALIGN, TLS_TCB_SIZE + tlssize);
+  if (block == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(block, 0, TLS_TCB_SIZE);
+  memcpy(block + TLS_TCB_SIZE, _stdata, datasize);
+  memset(block + TLS_TCB_SIZE + datasize, 0, tlssize - datasize);
+
+  tcb->tls_pointer = block;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sched_threadlocal_free
+ *
+ * Description:
+ *   Free the compiler TLS block of a thread that is being destroyed.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sched_threadlocal_free(FAR struct tcb_s *tcb)
+{
+  if (tcb->tls_pointer != NULL)
+    {
+      sched_ufree(tcb->tls_pointer);
+      tcb->tls_pointer = NULL;
+    }
+}
+
+#endif /* CONFIG_SCHED_THREAD_LOCAL */
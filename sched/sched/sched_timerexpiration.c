@@ -52,6 +52,7 @@
 #include "sched/sched.h"
 #include "wdog/wdog.h"
 #include "clock/clock.h"
+#include "hrtimer/hrtimer.h"
 
 #ifdef CONFIG_SCHED_TICKLESS
 
@@ -118,6 +119,21 @@ uint32_t g_oneshot_maxticks = UINT32_MAX;
 
 static unsigned int g_timer_interval;
 
+/* This is the system time when the currently active timer interval was
+ * started.  It is valid only if g_timer_interval is non-zero.
+ */
+
+static systime_t g_timer_start;
+
+#ifdef CONFIG_HRTIMER
+/* This is the time of the alarm for the currently active timer interval.
+ * It is valid only if g_timer_interval is non-zero.  The alarm itself may
+ * be set to an earlier time if a high resolution timer expires first.
+ */
+
+static struct timespec g_interval_alarm;
+#endif
+
 #ifdef CONFIG_SCHED_SPORADIC
 /* This is the time of the last scheduler assessment */
 
@@ -161,7 +177,8 @@ static struct timespec g_stop_time;
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline uint32_t sched_process_scheduler(uint32_t ticks, bool noswitches)
 {
   FAR struct tcb_s *rtcb  = this_task();
@@ -208,6 +225,19 @@ static inline uint32_t sched_process_scheduler(uint32_t ticks, bool noswitches)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, check if the currently executing task has exhausted the
+       * budget of its job.
+       */
+
+      ret = sched_deadline_process(rtcb, ticks, noswitches);
+    }
+#endif
+
   /* If a context switch occurred, then need to return delay remaining for
    * the new task at the head of the ready to run list.
    */
@@ -327,6 +357,7 @@ static void sched_timer_start(unsigned int ticks)
       /* Save new timer interval */
 
       g_timer_interval = ticks;
+      g_timer_start    = clock_systimer();
 
       /* Convert ticks to a struct timespec that up_timer_start() can
        * understand.
@@ -352,7 +383,13 @@ static void sched_timer_start(unsigned int ticks)
        */
 
       clock_timespec_add(&g_stop_time, &ts, &ts);
+#ifdef CONFIG_HRTIMER
+      g_interval_alarm.tv_sec  = ts.tv_sec;
+      g_interval_alarm.tv_nsec = ts.tv_nsec;
+      ret = OK;
+#else
       ret = up_alarm_start(&ts);
+#endif
 
 #else
       /* [Re-]start the interval timer */
@@ -366,6 +403,14 @@ static void sched_timer_start(unsigned int ticks)
           UNUSED(ret);
         }
     }
+
+#ifdef CONFIG_HRTIMER
+  /* Set the alarm for the interval or for the next high resolution timer,
+   * whichever comes first.
+   */
+
+  sched_alarm_reload();
+#endif
 }
 
 /****************************************************************************
@@ -400,27 +445,46 @@ void sched_alarm_expiration(FAR const struct timespec *ts)
 
   DEBUGASSERT(ts);
 
-  /* Save the time that the alarm occurred */
+#ifdef CONFIG_HRTIMER
+  /* The alarm may have been set early for a high resolution timer.  In that
+   * case, the timer interval has not yet expired and the system timer
+   * state must not be changed.
+   */
+
+  if (g_timer_interval > 0 && !HRTIMER_BEFORE(ts, &g_interval_alarm))
+#endif
+    {
+      /* Save the time that the alarm occurred */
 
-  g_stop_time.tv_sec  = ts->tv_sec;
-  g_stop_time.tv_nsec = ts->tv_nsec;
+      g_stop_time.tv_sec  = ts->tv_sec;
+      g_stop_time.tv_nsec = ts->tv_nsec;
 
 #ifdef CONFIG_SCHED_SPORADIC
-  /* Save the last time that the scheduler ran */
+      /* Save the last time that the scheduler ran */
 
-  g_sched_time.tv_sec  = ts->tv_sec;
-  g_sched_time.tv_nsec = ts->tv_nsec;
+      g_sched_time.tv_sec  = ts->tv_sec;
+      g_sched_time.tv_nsec = ts->tv_nsec;
 #endif
 
-  /* Get the interval associated with last expiration */
+      /* Get the interval associated with last expiration */
 
-  elapsed          = g_timer_interval;
-  g_timer_interval = 0;
+      elapsed          = g_timer_interval;
+      g_timer_interval = 0;
 
-  /* Process the timer ticks and set up the next interval (or not) */
+      /* Process the timer ticks and set up the next interval (or not) */
 
-  nexttime = sched_timer_process(elapsed, false);
-  sched_timer_start(nexttime);
+      nexttime = sched_timer_process(elapsed, false);
+      sched_timer_start(nexttime);
+    }
+
+#ifdef CONFIG_HRTIMER
+  /* Process expired high resolution timers and set the alarm for whatever
+   * comes next.
+   */
+
+  hrtimer_process(ts);
+  sched_alarm_reload();
+#endif
 }
 #endif
 
@@ -646,4 +710,119 @@ void sched_timer_reassess(void)
   nexttime = sched_timer_cancel();
   sched_timer_start(nexttime);
 }
+/****************************************************************************
+ * Name:  sched_timer_remaining
+ *
+ * Description:
+ *   Return the number of ticks until the next timer event:  The end of the
+ *   active timer interval or, if CONFIG_HRTIMER is enabled, the expiration
+ *   of the next high resolution timer.  This lets the IDLE loop know how
+ *   long the CPU may sleep before it must be awake again.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The number of ticks until the next timer event (at least one if an
+ *   event is pending) or zero if no timer event is pending.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+unsigned int sched_timer_remaining(void)
+{
+  unsigned int remaining = 0;
+  systime_t elapsed;
+#ifdef CONFIG_HRTIMER
+  FAR const struct timespec *next;
+  struct timespec now;
+  uint64_t ticks;
+#endif
+
+  if (g_timer_interval > 0)
+    {
+      elapsed   = clock_systimer() - g_timer_start;
+      remaining = elapsed < g_timer_interval ?
+                  g_timer_interval - (unsigned int)elapsed : 1;
+    }
+
+#ifdef CONFIG_HRTIMER
+  next = hrtimer_next();
+  if (next != NULL)
+    {
+      (void)up_timer_gettime(&now);
+      if (HRTIMER_BEFORE(&now, next))
+        {
+          ticks = ((uint64_t)(next->tv_sec - now.tv_sec) * USEC_PER_SEC +
+                   (next->tv_nsec - now.tv_nsec) / NSEC_PER_USEC) /
+                  USEC_PER_TICK;
+          ticks = MAX(ticks, 1);
+        }
+      else
+        {
+          ticks = 1;
+        }
+
+      if (remaining == 0 || ticks < remaining)
+        {
+          remaining = (unsigned int)ticks;
+        }
+    }
+#endif
+
+  return remaining;
+}
+
+/****************************************************************************
+ * Name:  sched_alarm_reload
+ *
+ * Description:
+ *   Set the alarm for the end of the active timer interval or for the
+ *   expiration of the next high resolution timer, whichever is earlier.
+ *   This is called when the timer interval is started and whenever the
+ *   head of the list of high resolution timers changes.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+void sched_alarm_reload(void)
+{
+  FAR const struct timespec *alarm = NULL;
+  FAR const struct timespec *next;
+  int ret;
+
+  if (g_timer_interval > 0)
+    {
+      alarm = &g_interval_alarm;
+    }
+
+  next = hrtimer_next();
+  if (next != NULL && (alarm == NULL || HRTIMER_BEFORE(next, alarm)))
+    {
+      alarm = next;
+    }
+
+  if (alarm != NULL)
+    {
+      ret = up_alarm_start(alarm);
+      if (ret < 0)
+        {
+          serr("ERROR: up_alarm_start failed: %d\n", ret);
+          UNUSED(ret);
+        }
+    }
+}
+#endif
+
 #endif /* CONFIG_SCHED_TICKLESS */
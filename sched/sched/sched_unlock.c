@@ -95,6 +95,11 @@ int sched_unlock(void)
           /* Note that we no longer have pre-emption */
 
           sched_note_premption(rtcb, false);
+#endif
+#ifdef CONFIG_SCHED_CRITMONITOR
+          /* Record how long pre-emption was disabled */
+
+          sched_critmon_preemption(rtcb, false, NULL);
 #endif
           /* Set the lock count to zero */
 
@@ -180,6 +185,31 @@ int sched_unlock(void)
 
               sched_sporadic_lowpriority(rtcb);
 
+#ifdef CONFIG_SCHED_TICKLESS
+              /* Make sure that the call to up_release_pending() did not
+               * change the currently active task.
+               */
+
+              if (rtcb == this_task())
+                {
+                  sched_timer_reassess();
+                }
+#endif
+            }
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          /* If (1) the task that was running uses deadline scheduling and
+           * (2) the budget of its job was exhausted, but (3) it could not
+           * be throttled because pre-emption was disabled, then we need to
+           * throttle the task now.
+           */
+
+          if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+              rtcb->deadline->budget <= 0)
+            {
+              sched_deadline_throttle(rtcb);
+
 #ifdef CONFIG_SCHED_TICKLESS
               /* Make sure that the call to up_release_pending() did not
                * change the currently active task.
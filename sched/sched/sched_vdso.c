@@ -0,0 +1,110 @@
+/****************************************************************************
+ * sched/sched/sched_vdso.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+#include <nuttx/userspace.h>
+#include <nuttx/vdso.h>
+
+#include "clock/clock.h"
+
+#ifdef CONFIG_LIB_SYSCALL_VDSO
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_vdso_clock
+ *
+ * Description:
+ *   Publish the current system timer and time-of-day base time.  Called on
+ *   every timer tick and whenever the base time changes.
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler or with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_vdso_clock(void)
+{
+  FAR struct vdso_s *vdso = USERSPACE->us_vdso;
+
+  if (vdso != NULL)
+    {
+      vdso->seq++;
+      VDSO_BARRIER();
+
+      vdso->systimer = g_system_timer;
+      vdso->basesec  = g_basetime.tv_sec;
+      vdso->basensec = g_basetime.tv_nsec;
+
+      VDSO_BARRIER();
+
+      /* Skip zero when the count wraps; it means "not yet published" */
+
+      if (++vdso->seq == 0)
+        {
+          vdso->seq = 2;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sched_vdso_resume
+ *
+ * Description:
+ *   Publish the PID of the task that is about to run.  Called from
+ *   sched_resume_scheduler().
+ *
+ ****************************************************************************/
+
+void sched_vdso_resume(FAR struct tcb_s *tcb)
+{
+  FAR struct vdso_s *vdso = USERSPACE->us_vdso;
+
+  if (vdso != NULL)
+    {
+      vdso->pid = tcb->pid;
+    }
+}
+
+#endif /* CONFIG_LIB_SYSCALL_VDSO */
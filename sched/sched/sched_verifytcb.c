@@ -59,8 +59,22 @@
 
 bool sched_verifytcb(FAR struct tcb_s *tcb)
 {
+#ifdef CONFIG_SCHED_GROWPIDHASH
+  irqstate_t flags;
+  bool valid;
+
+  /* Return true if the PID hashes to this TCB.  Keep the PID table from
+   * being replaced while we use it.
+   */
+
+  flags = enter_critical_section();
+  valid = (tcb == g_pidhash[PIDHASH(tcb->pid)].tcb);
+  leave_critical_section(flags);
+  return valid;
+#else
   /* Return true if the PID hashes to this TCB. */
 
   return tcb == g_pidhash[PIDHASH(tcb->pid)].tcb;
+#endif
 }
 
@@ -0,0 +1,259 @@
+/****************************************************************************
+ * sched/sched/sched_wakelat.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_WAKEUPLAT
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The upper bound of each histogram bucket (but the last) in units of
+ * up_perf_gettime().  Bucket n holds the latencies below 2^n microseconds.
+ */
+
+static uint32_t g_wakelat_bound[CONFIG_SCHED_WAKEUPLAT_NBUCKETS - 1];
+static bool g_wakelat_bounded;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The wake-up latencies per priority and the worst case */
+
+struct wakelat_prio_s g_wakelat_prio[CONFIG_SCHED_WAKEUPLAT_NPRIO];
+struct wakelat_worst_s g_wakelat_worst;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_wakelat_bucket
+ *
+ * Description:
+ *   Return the histogram bucket of a latency.  The bucket bounds are
+ *   converted to units of up_perf_gettime() on first use so that no
+ *   division is needed in the context switch.
+ *
+ ****************************************************************************/
+
+static int sched_wakelat_bucket(uint32_t elapsed)
+{
+  uint64_t bound;
+  uint32_t freq;
+  int i;
+
+  if (!g_wakelat_bounded)
+    {
+      freq = up_perf_getfreq();
+      for (i = 0; i < CONFIG_SCHED_WAKEUPLAT_NBUCKETS - 1; i++)
+        {
+          bound = ((uint64_t)freq << i) / 1000000;
+          g_wakelat_bound[i] = bound > UINT32_MAX ? UINT32_MAX :
+                               (uint32_t)bound;
+        }
+
+      g_wakelat_bounded = true;
+    }
+
+  for (i = 0; i < CONFIG_SCHED_WAKEUPLAT_NBUCKETS - 1; i++)
+    {
+      if (elapsed < g_wakelat_bound[i])
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: sched_wakelat_add
+ *
+ * Description:
+ *   Add one latency to a histogram.
+ *
+ ****************************************************************************/
+
+static void sched_wakelat_add(FAR struct wakelat_hist_s *hist,
+                              uint32_t elapsed, int bucket)
+{
+  hist->count++;
+  hist->total += elapsed;
+  hist->bucket[bucket]++;
+
+  if (elapsed > hist->maxtime)
+    {
+      hist->maxtime = elapsed;
+    }
+}
+
+/****************************************************************************
+ * Name: sched_wakelat_prio
+ *
+ * Description:
+ *   Return the histogram of a priority, assigning a free entry if the
+ *   priority has not been seen before.  Returns NULL if the table is full.
+ *
+ ****************************************************************************/
+
+static FAR struct wakelat_hist_s *sched_wakelat_prio(uint8_t priority)
+{
+  FAR struct wakelat_prio_s *prio;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_WAKEUPLAT_NPRIO; i++)
+    {
+      prio = &g_wakelat_prio[i];
+      if (!prio->inuse)
+        {
+          prio->inuse    = true;
+          prio->priority = priority;
+          return &prio->hist;
+        }
+      else if (prio->priority == priority)
+        {
+          return &prio->hist;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_wakelat_ready
+ *
+ * Description:
+ *   Called when a blocked thread is about to be made ready-to-run.  Note
+ *   the time and the thread that is running now.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being woken up
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void sched_wakelat_ready(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  tcb->wake_start   = up_perf_gettime();
+  tcb->wake_runner  = rtcb->pid;
+  tcb->wake_locked  = rtcb->lockcount > 0;
+  tcb->wake_pending = true;
+}
+
+/****************************************************************************
+ * Name: sched_wakelat_resume
+ *
+ * Description:
+ *   Called when a thread is resumed.  If the thread was woken up, account
+ *   for the time since then in the histograms of the thread and of its
+ *   priority, and capture the worst case.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is about to run
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void sched_wakelat_resume(FAR struct tcb_s *tcb)
+{
+  FAR struct wakelat_hist_s *hist;
+  uint32_t elapsed;
+  int bucket;
+
+  if (!tcb->wake_pending)
+    {
+      return;
+    }
+
+  tcb->wake_pending = false;
+  elapsed = up_perf_gettime() - tcb->wake_start;
+  bucket  = sched_wakelat_bucket(elapsed);
+
+  sched_wakelat_add(&tcb->wake_hist, elapsed, bucket);
+
+  hist = sched_wakelat_prio(tcb->sched_priority);
+  if (hist != NULL)
+    {
+      sched_wakelat_add(hist, elapsed, bucket);
+    }
+
+  if (elapsed > g_wakelat_worst.latency)
+    {
+      g_wakelat_worst.latency  = elapsed;
+      g_wakelat_worst.pid      = tcb->pid;
+      g_wakelat_worst.runner   = tcb->wake_runner;
+      g_wakelat_worst.priority = tcb->sched_priority;
+      g_wakelat_worst.locked   = tcb->wake_locked;
+    }
+
+  /* Report the latency to the instrumentation */
+
+  sched_note_wakeup(tcb, elapsed);
+}
+
+#endif /* CONFIG_SCHED_WAKEUPLAT */
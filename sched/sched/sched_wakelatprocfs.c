@@ -0,0 +1,496 @@
+/****************************************************************************
+ * sched/sched/sched_wakelatprocfs.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+#if defined(CONFIG_SCHED_WAKEUPLAT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WAKEUPLAT)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define WAKELAT_LINELEN (48 + 11 * CONFIG_SCHED_WAKEUPLAT_NBUCKETS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct wakelat_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  unsigned int linesize;            /* Number of valid characters in line[] */
+  char line[WAKELAT_LINELEN];       /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure carries the state of wakelat_read() through the
+ * sched_foreach() callback.
+ */
+
+struct wakelat_read_s
+{
+  FAR struct wakelat_file_s *wakefile;
+  FAR char *buffer;                 /* User buffer */
+  size_t buflen;                    /* Size of the user buffer */
+  ssize_t nread;                    /* Number of bytes transferred so far */
+  FAR off_t *offset;                /* Offset of the read in the file */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     wakelat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     wakelat_close(FAR struct file *filep);
+static ssize_t wakelat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     wakelat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     wakelat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations wakelat_procfsoperations =
+{
+  wakelat_open,      /* open */
+  wakelat_close,     /* close */
+  wakelat_read,      /* read */
+  NULL,              /* write */
+
+  wakelat_dup,       /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  wakelat_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wakelat_usec
+ *
+ * Description:
+ *   Convert a time in units of up_perf_gettime() to microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long wakelat_usec(uint64_t time, uint32_t freq)
+{
+  return (unsigned long)((time * 1000000) / freq);
+}
+
+/****************************************************************************
+ * Name: wakelat_transfer
+ *
+ * Description:
+ *   Transfer the formatted line to the user buffer.
+ *
+ ****************************************************************************/
+
+static void wakelat_transfer(FAR struct wakelat_read_s *rd)
+{
+  FAR struct wakelat_file_s *wakefile = rd->wakefile;
+
+  if (wakefile->linesize > WAKELAT_LINELEN - 1)
+    {
+      wakefile->linesize = WAKELAT_LINELEN - 1;
+    }
+
+  rd->nread += procfs_memcpy(wakefile->line, wakefile->linesize,
+                             &rd->buffer[rd->nread], rd->buflen - rd->nread,
+                             rd->offset);
+}
+
+/****************************************************************************
+ * Name: wakelat_format
+ *
+ * Description:
+ *   Format one histogram line:  The label, the number of wake-ups, the
+ *   average and longest latency in microseconds, and the bucket counts.
+ *
+ ****************************************************************************/
+
+static void wakelat_format(FAR struct wakelat_file_s *wakefile,
+                           FAR const char *label,
+                           FAR const struct wakelat_hist_s *hist)
+{
+  uint32_t freq = up_perf_getfreq();
+  size_t len;
+  int i;
+
+  len = snprintf(wakefile->line, WAKELAT_LINELEN, "%-10s %8lu %8lu %8lu",
+                 label, (unsigned long)hist->count,
+                 wakelat_usec(hist->total / hist->count, freq),
+                 wakelat_usec(hist->maxtime, freq));
+
+  for (i = 0; i < CONFIG_SCHED_WAKEUPLAT_NBUCKETS && len < WAKELAT_LINELEN;
+       i++)
+    {
+      len += snprintf(&wakefile->line[len], WAKELAT_LINELEN - len, " %7lu",
+                      (unsigned long)hist->bucket[i]);
+    }
+
+  if (len < WAKELAT_LINELEN)
+    {
+      len += snprintf(&wakefile->line[len], WAKELAT_LINELEN - len, "\n");
+    }
+
+  wakefile->linesize = len;
+}
+
+/****************************************************************************
+ * Name: wakelat_task
+ *
+ * Description:
+ *   sched_foreach() callback.  Transfer the histogram line of one thread
+ *   that has been woken up.  This runs in a critical section, so the
+ *   histogram cannot change while it is formatted.
+ *
+ ****************************************************************************/
+
+static void wakelat_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct wakelat_read_s *rd = (FAR struct wakelat_read_s *)arg;
+  char label[12];
+
+  if (tcb->wake_hist.count == 0 || rd->nread >= rd->buflen)
+    {
+      return;
+    }
+
+  snprintf(label, sizeof(label), "pid %d", (int)tcb->pid);
+  wakelat_format(rd->wakefile, label, &tcb->wake_hist);
+  wakelat_transfer(rd);
+}
+
+/****************************************************************************
+ * Name: wakelat_open
+ ****************************************************************************/
+
+static int wakelat_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct wakelat_file_s *wakefile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "wakelat" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "wakelat") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  wakefile = (FAR struct wakelat_file_s *)
+    kmm_zalloc(sizeof(struct wakelat_file_s));
+
+  if (!wakefile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)wakefile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wakelat_close
+ ****************************************************************************/
+
+static int wakelat_close(FAR struct file *filep)
+{
+  FAR struct wakelat_file_s *wakefile;
+
+  /* Recover our private data from the struct file instance */
+
+  wakefile = (FAR struct wakelat_file_s *)filep->f_priv;
+  DEBUGASSERT(wakefile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(wakefile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wakelat_read
+ *
+ * Description:
+ *   Return a header line with the bucket bounds in microseconds, one
+ *   histogram line for each priority and for each thread that has been
+ *   woken up, and finally the worst case:  The thread that waited and the
+ *   thread that was running when it was woken up.
+ *
+ ****************************************************************************/
+
+static ssize_t wakelat_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct wakelat_file_s *wakefile;
+  struct wakelat_read_s rd;
+  struct wakelat_prio_s prio;
+  struct wakelat_worst_s worst;
+  irqstate_t flags;
+  off_t offset;
+  size_t len;
+  char label[12];
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  wakefile = (FAR struct wakelat_file_s *)filep->f_priv;
+  DEBUGASSERT(wakefile);
+
+  offset      = filep->f_pos;
+  rd.wakefile = wakefile;
+  rd.buffer   = buffer;
+  rd.buflen   = buflen;
+  rd.nread    = 0;
+  rd.offset   = &offset;
+
+  /* The header line */
+
+  len = snprintf(wakefile->line, WAKELAT_LINELEN, "%-10s %8s %8s %8s",
+                 "LAT(us)", "COUNT", "AVG", "MAX");
+
+  for (i = 0; i < CONFIG_SCHED_WAKEUPLAT_NBUCKETS && len < WAKELAT_LINELEN;
+       i++)
+    {
+      if (i < CONFIG_SCHED_WAKEUPLAT_NBUCKETS - 1)
+        {
+          snprintf(label, sizeof(label), "<%lu", 1ul << i);
+        }
+      else
+        {
+          snprintf(label, sizeof(label), ">=%lu", 1ul << (i - 1));
+        }
+
+      len += snprintf(&wakefile->line[len], WAKELAT_LINELEN - len, " %7s",
+                      label);
+    }
+
+  if (len < WAKELAT_LINELEN)
+    {
+      len += snprintf(&wakefile->line[len], WAKELAT_LINELEN - len, "\n");
+    }
+
+  wakefile->linesize = len;
+  wakelat_transfer(&rd);
+
+  /* One line for each priority */
+
+  for (i = 0; i < CONFIG_SCHED_WAKEUPLAT_NPRIO && rd.nread < buflen; i++)
+    {
+      flags = enter_critical_section();
+      memcpy(&prio, &g_wakelat_prio[i], sizeof(struct wakelat_prio_s));
+      leave_critical_section(flags);
+
+      if (!prio.inuse || prio.hist.count == 0)
+        {
+          continue;
+        }
+
+      snprintf(label, sizeof(label), "prio %d", prio.priority);
+      wakelat_format(wakefile, label, &prio.hist);
+      wakelat_transfer(&rd);
+    }
+
+  /* One line for each thread */
+
+  if (rd.nread < buflen)
+    {
+      sched_foreach(wakelat_task, &rd);
+    }
+
+  /* And the worst case */
+
+  if (rd.nread < buflen)
+    {
+      flags = enter_critical_section();
+      memcpy(&worst, &g_wakelat_worst, sizeof(struct wakelat_worst_s));
+      leave_critical_section(flags);
+
+      wakefile->linesize =
+        snprintf(wakefile->line, WAKELAT_LINELEN,
+                 "worst %lu us: pid %d prio %d, woken while pid %d ran%s\n",
+                 wakelat_usec(worst.latency, up_perf_getfreq()),
+                 (int)worst.pid, worst.priority, (int)worst.runner,
+                 worst.locked ? " with pre-emption disabled" : "");
+
+      wakelat_transfer(&rd);
+    }
+
+  /* Update the file offset */
+
+  if (rd.nread > 0)
+    {
+      filep->f_pos += rd.nread;
+    }
+
+  return rd.nread;
+}
+
+/****************************************************************************
+ * Name: wakelat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int wakelat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct wakelat_file_s *oldfile;
+  FAR struct wakelat_file_s *newfile;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldfile = (FAR struct wakelat_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldfile);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newfile = (FAR struct wakelat_file_s *)
+    kmm_malloc(sizeof(struct wakelat_file_s));
+
+  if (!newfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newfile, oldfile, sizeof(struct wakelat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wakelat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int wakelat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "wakelat" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "wakelat") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "wakelat" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_WAKEUPLAT && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_WAKEUPLAT */
@@ -68,6 +68,17 @@ int sched_yield(void)
 {
   FAR struct tcb_s *rtcb = this_task();
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* For a deadline thread, yielding completes the current job.  The thread
+   * waits for the release of its next job.
+   */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      return sched_deadline_yield(rtcb) < 0 ? ERROR : OK;
+    }
+#endif
+
   /* This equivalent to just resetting the task priority to its current value
    * since this will cause the task to be rescheduled behind any other tasks
    * at the same priority.
@@ -96,6 +96,10 @@ int sem_destroy (FAR sem_t *sem)
       /* Release holders of the semaphore */
 
       sem_destroyholder(sem);
+
+      /* Release the contention statistics of a named semaphore */
+
+      sem_lockstat_release(sem);
       return OK;
     }
   else
@@ -67,6 +67,14 @@
 typedef int (*holderhandler_t)(FAR struct semholder_s *pholder,
                                FAR sem_t *sem, FAR void *arg);
 
+/* The argument passed to sem_restoreholderprioA() */
+
+struct sem_restore_s
+{
+  FAR struct tcb_s *stcb;              /* TCB that received the count */
+  FAR struct semholder_s *rholder;     /* Holder of the running task */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -82,7 +90,8 @@ static FAR struct semholder_s *g_freeholders;
  * Name: sem_allocholder
  ****************************************************************************/
 
-static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
+static inline FAR struct semholder_s *sem_allocholder(sem_t *sem,
+                                                      FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder;
 
@@ -117,9 +126,15 @@ static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
   else
     {
       serr("ERROR: Insufficient pre-allocated holders\n");
-      pholder = NULL;
+      return NULL;
     }
 
+  /* Add the semaphore to the list of semaphores held by the thread */
+
+  pholder->sem     = sem;
+  pholder->htcb    = htcb;
+  pholder->tlink   = htcb->holdsem;
+  htcb->holdsem    = pholder;
   return pholder;
 }
 
@@ -165,7 +180,7 @@ sem_findorallocateholder(sem_t *sem, FAR struct tcb_s *htcb)
   FAR struct semholder_s *pholder = sem_findholder(sem, htcb);
   if (!pholder)
     {
-      pholder = sem_allocholder(sem);
+      pholder = sem_allocholder(sem, htcb);
     }
 
   return pholder;
@@ -177,13 +192,31 @@ sem_findorallocateholder(sem_t *sem, FAR struct tcb_s *htcb)
 
 static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
 {
+  FAR struct semholder_s **link;
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *curr;
   FAR struct semholder_s *prev;
 #endif
 
+  /* Remove the semaphore from the list of semaphores held by the thread.
+   * The holder TCB is cleared before getting here when it is stale.
+   */
+
+  if (pholder->htcb)
+    {
+      for (link = &pholder->htcb->holdsem;
+           *link && *link != pholder;
+           link = &(*link)->tlink);
+
+      if (*link)
+        {
+          *link = pholder->tlink;
+        }
+    }
+
   /* Release the holder and counts */
 
+  pholder->tlink  = NULL;
   pholder->htcb   = NULL;
   pholder->counts = 0;
 
@@ -284,6 +317,7 @@ static int sem_boostholderprio(FAR struct semholder_s *pholder,
   if (!sched_verifytcb(htcb))
     {
       serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
+      pholder->htcb = NULL;
       sem_freeholder(sem, pholder);
     }
 
@@ -435,6 +469,7 @@ static int sem_restoreholderprio(FAR struct semholder_s *pholder,
   if (!sched_verifytcb(htcb))
     {
       serr("ERROR: TCB 0x%08x is a stale handle, counts lost\n", htcb);
+      pholder->htcb = NULL;
       sem_freeholder(sem, pholder);
     }
 
@@ -558,40 +593,23 @@ static int sem_restoreholderprio(FAR struct semholder_s *pholder,
  * Name: sem_restoreholderprioA
  *
  * Description:
- *   Reprioritize all holders except the currently executing task
+ *   Reprioritize all holders except the currently executing task.  The
+ *   holder of the currently executing task is returned so that it can be
+ *   reprioritized last without a second pass over the holders.
  *
  ****************************************************************************/
 
 static int sem_restoreholderprioA(FAR struct semholder_s *pholder,
                                   FAR sem_t *sem, FAR void *arg)
 {
-  FAR struct tcb_s *rtcb = this_task();
-  if (pholder->htcb != rtcb)
-    {
-      return sem_restoreholderprio(pholder, sem, arg);
-    }
-
-  return 0;
-}
-
-/****************************************************************************
- * Name: sem_restoreholderprioB
- *
- * Description:
- *   Reprioritize only the currently executing task
- *
- ****************************************************************************/
+  FAR struct sem_restore_s *restore = (FAR struct sem_restore_s *)arg;
 
-static int sem_restoreholderprioB(FAR struct semholder_s *pholder,
-                                  FAR sem_t *sem, FAR void *arg)
-{
-  FAR struct tcb_s *rtcb = this_task();
-  if (pholder->htcb == rtcb)
+  if (pholder->htcb != this_task())
     {
-      (void)sem_restoreholderprio(pholder, sem, arg);
-      return 1;
+      return sem_restoreholderprio(pholder, sem, restore->stcb);
     }
 
+  restore->rholder = pholder;
   return 0;
 }
 
@@ -693,6 +711,7 @@ static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb,
 {
   FAR struct tcb_s *rtcb = this_task();
   FAR struct semholder_s *pholder;
+  struct sem_restore_s restore;
 
   /* Perform the following actions only if a new thread was given a count.
    * The thread that received the count should be the highest priority
@@ -708,34 +727,40 @@ static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb,
        * However, we cannot drop the priority of the currently running
        * thread -- because that will cause it to be suspended.
        *
-       * So, do this in two passes.  First, reprioritizing all holders
-       * except for the running thread.
+       * So, first reprioritize all holders except for the running thread,
+       * remembering the holder of the running thread as we go.
        */
 
-      (void)sem_foreachholder(sem, sem_restoreholderprioA, stcb);
+      restore.stcb    = stcb;
+      restore.rholder = NULL;
+      (void)sem_foreachholder(sem, sem_restoreholderprioA, &restore);
 
-      /* Now, find an reprioritize only the ready to run task */
+      /* Now reprioritize only the running task */
 
-      (void)sem_foreachholder(sem, sem_restoreholderprioB, stcb);
+      pholder = restore.rholder;
+      if (pholder)
+        {
+          (void)sem_restoreholderprio(pholder, sem, stcb);
+        }
     }
 
   /* If there are no tasks waiting for available counts, then all holders
    * should be at their base priority.
    */
 
-#ifdef CONFIG_DEBUG_ASSERTIONS
   else
     {
+#ifdef CONFIG_DEBUG_ASSERTIONS
       (void)sem_foreachholder(sem, sem_verifyholder, NULL);
-    }
 #endif
+      pholder = sem_findholder(sem, rtcb);
+    }
 
   /* In any case, the currently executing task should have an entry in the
    * list.  Its counts were previously decremented; if it now holds no
    * counts, then we need to remove it from the list of holders.
    */
 
-  pholder = sem_findholder(sem, rtcb);
   if (pholder)
     {
       /* When no more counts are held, remove the holder from the list.  The
@@ -826,9 +851,8 @@ void sem_destroyholder(FAR sem_t *sem)
   if (sem->holder.htcb)
     {
       serr("ERROR: Semaphore destroyed with holder\n");
+      sem_freeholder(sem, &sem->holder);
     }
-
-  sem->holder.htcb = NULL;
 #endif
 }
 
@@ -850,19 +874,39 @@ void sem_destroyholder(FAR sem_t *sem)
 
 void sem_addholder(FAR sem_t *sem)
 {
-  FAR struct tcb_s *rtcb = this_task();
+  sem_addholder_tcb(this_task(), sem);
+}
+
+/****************************************************************************
+ * Name: sem_addholder_tcb
+ *
+ * Description:
+ *   Like sem_addholder(), but for a thread other than the caller.  Used
+ *   when a thread whose wait was requeued by sem_requeue() is given a count
+ *   on the semaphore that it did not originally wait on.
+ *
+ * Parameters:
+ *   htcb - The TCB of the thread that obtained the semaphore
+ *   sem  - A reference to the incremented semaphore
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sem_addholder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem)
+{
   FAR struct semholder_s *pholder;
 
   /* Find or allocate a container for this new holder */
 
-  pholder = sem_findorallocateholder(sem, rtcb);
+  pholder = sem_findorallocateholder(sem, htcb);
   if (pholder)
     {
       /* Then set the holder and increment the number of counts held by this
        * holder
        */
 
-      pholder->htcb = rtcb;
       pholder->counts++;
     }
 }
@@ -895,6 +939,28 @@ void sem_boostpriority(FAR sem_t *sem)
    (void)sem_foreachholder(sem, sem_boostholderprio, rtcb);
 }
 
+/****************************************************************************
+ * Name: sem_boostpriority_tcb
+ *
+ * Description:
+ *   Like sem_boostpriority(), but on behalf of a waiting thread other than
+ *   the caller.  Used by sem_requeue() when it moves a blocked thread onto
+ *   a semaphore.
+ *
+ * Parameters:
+ *   wtcb - The TCB of the thread now waiting on the semaphore
+ *   sem  - A reference to the semaphore
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void sem_boostpriority_tcb(FAR struct tcb_s *wtcb, FAR sem_t *sem)
+{
+  (void)sem_foreachholder(sem, sem_boostholderprio, wtcb);
+}
+
 /****************************************************************************
  * Name: sem_releaseholder
  *
@@ -988,6 +1054,38 @@ void sem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: sem_releaseholders
+ *
+ * Description:
+ *   Called from sem_recover() when a thread exits or is deleted.  Remove the
+ *   thread from the list of holders of every semaphore that it still holds
+ *   counts on so that the holder containers are recovered now rather than
+ *   when the stale holder is eventually discovered.  The counts themselves
+ *   are not released.
+ *
+ * Parameters:
+ *   htcb - The TCB of the terminated task or thread
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void sem_releaseholders(FAR struct tcb_s *htcb)
+{
+  FAR struct semholder_s *pholder;
+
+  while ((pholder = htcb->holdsem) != NULL)
+    {
+      sinfo("Thread %d exited with counts on %p\n", htcb->pid, pholder->sem);
+      sem_freeholder(pholder->sem, pholder);
+    }
+}
+
 /****************************************************************************
  * Name: sem_canceled
  *
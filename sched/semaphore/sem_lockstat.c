@@ -0,0 +1,217 @@
+/****************************************************************************
+ * sched/semaphore/sem_lockstat.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The statistics of the named semaphores */
+
+struct sem_lockstat_s g_lockstat[CONFIG_SCHED_LOCKSTAT_NLOCKS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_setname
+ *
+ * Description:
+ *   Give a name to a semaphore and start collecting its contention
+ *   statistics.  See include/nuttx/semaphore.h.
+ *
+ ****************************************************************************/
+
+int sem_setname(FAR sem_t *sem, FAR const char *name)
+{
+  FAR struct sem_lockstat_s *stat;
+  FAR struct sem_lockstat_s *freestat = NULL;
+  irqstate_t flags;
+  int i;
+
+  DEBUGASSERT(sem != NULL && name != NULL);
+
+  /* Find the entry of the semaphore, which may be left over from before
+   * sem_init() was called again, or a free entry.
+   */
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_SCHED_LOCKSTAT_NLOCKS; i++)
+    {
+      stat = &g_lockstat[i];
+      if (stat->sem == sem)
+        {
+          freestat = stat;
+          break;
+        }
+      else if (stat->sem == NULL && freestat == NULL)
+        {
+          freestat = stat;
+        }
+    }
+
+  if (freestat == NULL)
+    {
+      leave_critical_section(flags);
+      return -ENOMEM;
+    }
+
+  memset(freestat, 0, sizeof(struct sem_lockstat_s));
+  freestat->sem       = sem;
+  freestat->name      = name;
+  freestat->holder    = -1;
+  freestat->maxowner  = -1;
+  freestat->maxwaiter = -1;
+  sem->lockstat       = freestat;
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sem_lockstat_take
+ *
+ * Description:
+ *   Count an acquisition of a semaphore that did not have to wait.
+ *
+ * Parameters:
+ *   sem - The semaphore that was taken
+ *   tcb - The TCB of the task that took it
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void sem_lockstat_take(FAR sem_t *sem, FAR struct tcb_s *tcb)
+{
+  FAR struct sem_lockstat_s *stat = sem->lockstat;
+
+  if (stat != NULL)
+    {
+      stat->acquired++;
+      stat->holder = tcb->pid;
+    }
+}
+
+/****************************************************************************
+ * Name: sem_lockstat_wait
+ *
+ * Description:
+ *   Count an acquisition of a semaphore that had to wait and account for
+ *   the time waited.
+ *
+ * Parameters:
+ *   sem   - The semaphore that was taken
+ *   tcb   - The TCB of the task that took it
+ *   owner - The task that held the semaphore when the wait began
+ *   start - The value of up_perf_gettime() when the wait began
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void sem_lockstat_wait(FAR sem_t *sem, FAR struct tcb_s *tcb, pid_t owner,
+                       uint32_t start)
+{
+  FAR struct sem_lockstat_s *stat = sem->lockstat;
+  uint32_t elapsed;
+
+  if (stat != NULL)
+    {
+      elapsed = up_perf_gettime() - start;
+
+      stat->acquired++;
+      stat->contended++;
+      stat->waittime += elapsed;
+      stat->holder    = tcb->pid;
+
+      if (elapsed > stat->maxwait)
+        {
+          stat->maxwait   = elapsed;
+          stat->maxowner  = owner;
+          stat->maxwaiter = tcb->pid;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sem_lockstat_release
+ *
+ * Description:
+ *   Release the statistics of a named semaphore when it is destroyed.
+ *
+ * Parameters:
+ *   sem - The semaphore being destroyed
+ *
+ ****************************************************************************/
+
+void sem_lockstat_release(FAR sem_t *sem)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (sem->lockstat != NULL)
+    {
+      sem->lockstat->sem = NULL;
+      sem->lockstat      = NULL;
+    }
+
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_LOCKSTAT */
@@ -91,6 +91,13 @@ int sem_post(FAR sem_t *sem)
 
   if (sem)
     {
+      /* If no task is waiting, just give the count back */
+
+      if (sem_fastgive(sem))
+        {
+          return OK;
+        }
+
       /* The following operations must be performed with interrupts
        * disabled because sem_post() may be called from an interrupt
        * handler.
@@ -133,9 +140,18 @@ int sem_post(FAR sem_t *sem)
 
           if (stcb)
             {
-              /* It is, let the task take the semaphore */
+              /* It is, let the task take the semaphore.  If the task was
+               * requeued onto this semaphore by sem_requeue(), then its
+               * sem_wait() call was on a different semaphore and cannot
+               * record the new holder (or the acquisition) itself.
+               */
 
               stcb->waitsem = NULL;
+              if ((stcb->flags & TCB_FLAG_SEM_REQUEUED) != 0)
+                {
+                  sem_addholder_tcb(stcb, sem);
+                  sem_lockstat_take(sem, stcb);
+                }
 
               /* Restart the waiting task. */
 
@@ -0,0 +1,379 @@
+/****************************************************************************
+ * sched/semaphore/sem_procfs.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "semaphore/semaphore.h"
+
+#if defined(CONFIG_SCHED_LOCKSTAT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LOCKSTAT_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct lockstat_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  unsigned int linesize;            /* Number of valid characters in line[] */
+  char line[LOCKSTAT_LINELEN];      /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     lockstat_close(FAR struct file *filep);
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     lockstat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     lockstat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations lockstat_procfsoperations =
+{
+  lockstat_open,     /* open */
+  lockstat_close,    /* close */
+  lockstat_read,     /* read */
+  NULL,              /* write */
+
+  lockstat_dup,      /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  lockstat_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_usec
+ *
+ * Description:
+ *   Convert a time in units of up_perf_gettime() to microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long lockstat_usec(uint64_t time, uint32_t freq)
+{
+  return (unsigned long)((time * 1000000) / freq);
+}
+
+/****************************************************************************
+ * Name: lockstat_callback
+ *
+ * Description:
+ *   Format the line for one named semaphore and transfer it to the user
+ *   buffer.  Returns zero if the entry is not in use.
+ *
+ ****************************************************************************/
+
+static ssize_t lockstat_callback(FAR struct lockstat_file_s *lockfile,
+                                 int index, FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset)
+{
+  struct sem_lockstat_s copy;
+  irqstate_t flags;
+  uint32_t freq;
+
+  /* Take a consistent snapshot of the statistics */
+
+  flags = enter_critical_section();
+  memcpy(&copy, &g_lockstat[index], sizeof(struct sem_lockstat_s));
+  leave_critical_section(flags);
+
+  if (copy.sem == NULL)
+    {
+      return 0;
+    }
+
+  freq = up_perf_getfreq();
+
+  lockfile->linesize =
+    snprintf(lockfile->line, LOCKSTAT_LINELEN,
+             "%-16s %10lu %10lu %12lu %8lu %5d %6d\n",
+             copy.name, (unsigned long)copy.acquired,
+             (unsigned long)copy.contended,
+             lockstat_usec(copy.waittime, freq),
+             lockstat_usec(copy.maxwait, freq),
+             (int)copy.maxowner, (int)copy.maxwaiter);
+
+  return procfs_memcpy(lockfile->line, lockfile->linesize, buffer, buflen,
+                       offset);
+}
+
+/****************************************************************************
+ * Name: lockstat_open
+ ****************************************************************************/
+
+static int lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct lockstat_file_s *lockfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "locks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "locks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  lockfile = (FAR struct lockstat_file_s *)
+    kmm_zalloc(sizeof(struct lockstat_file_s));
+
+  if (!lockfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)lockfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_close
+ ****************************************************************************/
+
+static int lockstat_close(FAR struct file *filep)
+{
+  FAR struct lockstat_file_s *lockfile;
+
+  /* Recover our private data from the struct file instance */
+
+  lockfile = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(lockfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(lockfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_read
+ *
+ * Description:
+ *   Return one line per named semaphore:  The name, the number of
+ *   acquisitions and of acquisitions that had to wait, the total and the
+ *   longest wait in microseconds, the task that held the semaphore when
+ *   the longest wait began and the task that waited.
+ *
+ ****************************************************************************/
+
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct lockstat_file_s *lockfile;
+  off_t offset;
+  ssize_t nread;
+  ssize_t ret;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  lockfile = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(lockfile);
+
+  /* The header line */
+
+  offset = filep->f_pos;
+  lockfile->linesize =
+    snprintf(lockfile->line, LOCKSTAT_LINELEN,
+             "%-16s %10s %10s %12s %8s %5s %6s\n",
+             "NAME", "ACQUIRED", "CONTENDED", "WAIT(us)", "MAX(us)",
+             "OWNER", "WAITER");
+
+  nread = procfs_memcpy(lockfile->line, lockfile->linesize, buffer, buflen,
+                        &offset);
+
+  /* Then one line for each named semaphore */
+
+  for (i = 0; i < CONFIG_SCHED_LOCKSTAT_NLOCKS && nread < buflen; i++)
+    {
+      ret = lockstat_callback(lockfile, i, &buffer[nread], buflen - nread,
+                              &offset);
+      nread += ret;
+    }
+
+  /* Update the file offset */
+
+  if (nread > 0)
+    {
+      filep->f_pos += nread;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: lockstat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int lockstat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct lockstat_file_s *oldfile;
+  FAR struct lockstat_file_s *newfile;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldfile = (FAR struct lockstat_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldfile);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newfile = (FAR struct lockstat_file_s *)
+    kmm_malloc(sizeof(struct lockstat_file_s));
+
+  if (!newfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newfile, oldfile, sizeof(struct lockstat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int lockstat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "locks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "locks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "locks" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_LOCKSTAT && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_LOCKS */
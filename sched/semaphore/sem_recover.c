@@ -58,11 +58,13 @@
  *   case where a task is waiting for semaphore at the time that is was
  *   killed.
  *
+ *   If priority inheritance is enabled, the thread is also removed from the
+ *   holder lists of all semaphores that it holds counts on.
+ *
  *   REVISIT:  A more complete implementation would release counts on all
- *   semaphores held by the thread.  That would, however, require some
- *   significant extension to the semaphore data structures because given
- *   only the task, there is not mechanism to traverse all of the semaphores
- *   with counts held by the task.
+ *   semaphores held by the thread.  With priority inheritance, the held
+ *   semaphores can now be traversed from the TCB, but the counts are still
+ *   not released.
  *
  * Inputs:
  *   tcb - The TCB of the terminated task or thread
@@ -121,5 +123,10 @@ void sem_recover(FAR struct tcb_s *tcb)
       tcb->waitsem = NULL;
     }
 
+  /* Recover the holder containers of any semaphores that the thread still
+   * holds counts on.
+   */
+
+  sem_releaseholders(tcb);
   leave_critical_section(flags);
 }
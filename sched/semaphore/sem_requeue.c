@@ -0,0 +1,124 @@
+/****************************************************************************
+ * sched/semaphore/sem_requeue.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_requeue
+ *
+ * Description:
+ *   Move a thread that is blocked on one semaphore so that it waits on
+ *   another semaphore instead, without ever making it ready-to-run.  This
+ *   supports "wait morphing" in pthread_cond_broadcast():  Threads waiting
+ *   on the condition are moved directly onto the mutex and then awakened
+ *   one at a time as the mutex is released.
+ *
+ *   The count that the thread took on its original semaphore is given
+ *   back.  If the target semaphore has a count available, then the thread
+ *   takes it and is restarted immediately;  otherwise it blocks on the
+ *   target semaphore just as if it had called sem_wait() on it.  In either
+ *   case, TCB_FLAG_SEM_REQUEUED is set in the thread's TCB so that the
+ *   caller of sem_wait() can tell which semaphore it obtained.
+ *
+ * Parameters:
+ *   wtcb   - The TCB of the thread blocked on a semaphore
+ *   target - The semaphore that the thread is to wait on instead
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from a critical section with pre-emption disabled.  wtcb is in
+ *   the TSTATE_WAIT_SEM state.
+ *
+ ****************************************************************************/
+
+void sem_requeue(FAR struct tcb_s *wtcb, FAR sem_t *target)
+{
+  FAR sem_t *sem = wtcb->waitsem;
+
+  DEBUGASSERT(wtcb->task_state == TSTATE_WAIT_SEM && sem != NULL &&
+              sem->semcount < 0 && target != NULL);
+
+  /* Release the count on the original semaphore and restore the priority
+   * of any of its holders that were boosted on behalf of this thread.
+   */
+
+  sem_canceled(wtcb, sem);
+  sem->semcount++;
+
+  wtcb->flags |= TCB_FLAG_SEM_REQUEUED;
+
+  if (target->semcount > 0)
+    {
+      /* The target semaphore is available.  Give it to the thread and let
+       * the thread run.
+       */
+
+      target->semcount--;
+      sem_addholder_tcb(wtcb, target);
+      wtcb->waitsem = NULL;
+
+      up_unblock_task(wtcb);
+    }
+  else
+    {
+      /* Otherwise, the thread now waits on the target semaphore.  The
+       * prioritized list of waiting threads is shared by all semaphores
+       * so the thread stays where it is.
+       */
+
+      target->semcount--;
+      wtcb->waitsem = target;
+
+      sem_boostpriority_tcb(wtcb, target);
+    }
+}
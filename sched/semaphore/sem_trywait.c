@@ -92,6 +92,13 @@ int sem_trywait(FAR sem_t *sem)
 
   if (sem)
     {
+      /* Try to take an available count without blocking interrupts */
+
+      if (sem_fasttake(sem))
+        {
+          return OK;
+        }
+
       /* The following operations must be performed with interrupts disabled
        * because sem_post() may be called from an interrupt handler.
        */
@@ -111,6 +118,7 @@ int sem_trywait(FAR sem_t *sem)
           /* It is, let the task take the semaphore */
 
           sem->semcount--;
+          sem_lockstat_take(sem, rtcb);
           rtcb->waitsem = NULL;
           ret = OK;
         }
@@ -80,6 +80,10 @@ int sem_wait(FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
+#ifdef CONFIG_SCHED_LOCKSTAT
+  uint32_t start;
+  pid_t owner;
+#endif
   int ret  = ERROR;
 
   /* This API should not be called from interrupt handlers */
@@ -90,6 +94,13 @@ int sem_wait(FAR sem_t *sem)
 
   if (sem)
     {
+      /* Try to take an available count without blocking interrupts */
+
+      if (sem_fasttake(sem))
+        {
+          return OK;
+        }
+
       /* The following operations must be performed with interrupts
        * disabled because sem_post() may be called from an interrupt
        * handler.
@@ -105,6 +116,7 @@ int sem_wait(FAR sem_t *sem)
 
           sem->semcount--;
           sem_addholder(sem);
+          sem_lockstat_take(sem, rtcb);
           rtcb->waitsem = NULL;
           ret = OK;
         }
@@ -145,6 +157,12 @@ int sem_wait(FAR sem_t *sem)
            */
 
           sem_boostpriority(sem);
+#endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+          /* Note when the wait began and which task held the semaphore */
+
+          start = up_perf_gettime();
+          owner = sem->lockstat != NULL ? sem->lockstat->holder : -1;
 #endif
           /* Add the TCB to the prioritized semaphore wait queue */
 
@@ -173,9 +191,18 @@ int sem_wait(FAR sem_t *sem)
 
           if (get_errno() != EINTR && get_errno() != ETIMEDOUT)
             {
-              /* Not awakened by a signal or a timeout... We hold the semaphore */
+              /* Not awakened by a signal or a timeout... We hold the
+               * semaphore.  Or, if our wait was moved by sem_requeue(), we
+               * hold the semaphore that it was moved to and the holder has
+               * already been recorded.
+               */
+
+              if ((rtcb->flags & TCB_FLAG_SEM_REQUEUED) == 0)
+                {
+                  sem_addholder(sem);
+                  sem_lockstat_wait(sem, rtcb, owner, start);
+                }
 
-              sem_addholder(sem);
               ret = OK;
             }
 
@@ -45,10 +45,111 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <semaphore.h>
 #include <sched.h>
 #include <queue.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+/* This structure holds the contention statistics of one named semaphore.
+ * Times are in units of up_perf_gettime().
+ */
+
+struct sem_lockstat_s
+{
+  FAR sem_t *sem;         /* The named semaphore (NULL if the entry is free) */
+  FAR const char *name;   /* Name given with sem_setname() */
+  uint32_t acquired;      /* Number of times the semaphore was taken */
+  uint32_t contended;     /* Number of those that had to wait */
+  uint32_t maxwait;       /* Longest wait */
+  uint64_t waittime;      /* Total time spent waiting */
+  pid_t holder;           /* Task that took the semaphore last */
+  pid_t maxowner;         /* Holder when the longest wait began */
+  pid_t maxwaiter;        /* Task that waited longest */
+};
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+/* The statistics of the named semaphores */
+
+extern struct sem_lockstat_s g_lockstat[CONFIG_SCHED_LOCKSTAT_NLOCKS];
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sem_fasttake and sem_fastgive
+ *
+ * Description:
+ *   The lock-free fast paths of sem_wait() and sem_post().  sem_fasttake()
+ *   takes a count only if one is available, and sem_fastgive() gives a
+ *   count only if no task is waiting.  Each returns false if the caller
+ *   must fall back to the slow path in a critical section.
+ *
+ *   This is safe only on a single CPU:  There, the slow paths, even when
+ *   run from interrupt handlers, complete with interrupts disabled and so
+ *   can never be seen half-done by the compare-and-swap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+static inline bool sem_fasttake(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+  /* Acquisitions of a named semaphore are counted in the slow path */
+
+  if (sem->lockstat != NULL)
+    {
+      return false;
+    }
+
+#endif
+  while (count > 0)
+    {
+      if (__sync_bool_compare_and_swap(&sem->semcount, count, count - 1))
+        {
+          return true;
+        }
+
+      count = sem->semcount;
+    }
+
+  return false;
+}
+
+static inline bool sem_fastgive(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (__sync_bool_compare_and_swap(&sem->semcount, count, count + 1))
+        {
+          return true;
+        }
+
+      count = sem->semcount;
+    }
+
+  return false;
+}
+#else
+#  define sem_fasttake(sem) false
+#  define sem_fastgive(sem) false
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -81,6 +182,10 @@ void sem_timeout(int argc, wdparm_t pid);
 
 void sem_recover(FAR struct tcb_s *tcb);
 
+/* Move a blocked thread from one semaphore wait onto another */
+
+void sem_requeue(FAR struct tcb_s *wtcb, FAR sem_t *target);
+
 /* Special logic needed only by priority inheritance to manage collections of
  * holders of semaphores.
  */
@@ -89,9 +194,12 @@ void sem_recover(FAR struct tcb_s *tcb);
 void sem_initholders(void);
 void sem_destroyholder(FAR sem_t *sem);
 void sem_addholder(FAR sem_t *sem);
+void sem_addholder_tcb(FAR struct tcb_s *htcb, FAR sem_t *sem);
 void sem_boostpriority(FAR sem_t *sem);
+void sem_boostpriority_tcb(FAR struct tcb_s *wtcb, FAR sem_t *sem);
 void sem_releaseholder(FAR sem_t *sem);
 void sem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem);
+void sem_releaseholders(FAR struct tcb_s *htcb);
 #  ifndef CONFIG_DISABLE_SIGNALS
 void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #  else
@@ -101,12 +209,28 @@ void sem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem);
 #  define sem_initholders()
 #  define sem_destroyholder(sem)
 #  define sem_addholder(sem)
+#  define sem_addholder_tcb(htcb, sem)
 #  define sem_boostpriority(sem)
+#  define sem_boostpriority_tcb(wtcb, sem)
 #  define sem_releaseholder(sem)
 #  define sem_restorebaseprio(stcb,sem)
+#  define sem_releaseholders(htcb)
 #  define sem_canceled(stcb, sem)
 #endif
 
+/* Contention statistics of named semaphores */
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+void sem_lockstat_take(FAR sem_t *sem, FAR struct tcb_s *tcb);
+void sem_lockstat_wait(FAR sem_t *sem, FAR struct tcb_s *tcb, pid_t owner,
+                       uint32_t start);
+void sem_lockstat_release(FAR sem_t *sem);
+#else
+#  define sem_lockstat_take(sem, tcb)
+#  define sem_lockstat_wait(sem, tcb, owner, start)
+#  define sem_lockstat_release(sem)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <sched.h>
 #include <assert.h>
 
@@ -65,6 +66,61 @@
 
 #undef CONFIG_SPINLOCK_LOCKDOWN /* Feature not yet available */
 
+/* The upper limit of the exponential backoff (in delay loops) after a
+ * failed attempt to take a contended lock.  Zero disables the backoff.
+ */
+
+#ifndef CONFIG_SPINLOCK_BACKOFF
+#  define CONFIG_SPINLOCK_BACKOFF 0
+#endif
+
+/* The ticket and MCS locks need atomic operations other than the
+ * test-and-set provided by the architecture.
+ */
+
+#if defined(CONFIG_SPINLOCK_TICKET) || defined(CONFIG_SPINLOCK_MCS)
+#  ifndef __GNUC__
+#    error CONFIG_SPINLOCK_TICKET and CONFIG_SPINLOCK_MCS require GCC atomics
+#  endif
+
+#  define spin_fetchadd(p,v)  __sync_fetch_and_add(p, v)
+#  define spin_cmpxchg(p,o,n) __sync_bool_compare_and_swap(p, o, n)
+#  define spin_xchg(p,v)      __sync_lock_test_and_set(p, v)
+#endif
+
+/* The locks that protect CPU sets */
+
+#ifdef CONFIG_SPINLOCK_TICKET
+#  define spin_lockset(l)     spin_lock_ticket(l)
+#  define spin_unlockset(l)   spin_unlock_ticket(l)
+#else
+#  define spin_lockset(l)     spin_lock(l)
+#  define spin_unlockset(l)   spin_unlock(l)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_delay
+ *
+ * Description:
+ *   Busy wait for 'count' loops without accessing the lock.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SPINLOCK_BACKOFF > 0
+static void spin_delay(unsigned int count)
+{
+  volatile unsigned int i;
+
+  for (i = 0; i < count; i++)
+    {
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -119,11 +175,37 @@ void spin_initializer(FAR struct spinlock_s *lock)
 
 void spin_lock(FAR volatile spinlock_t *lock)
 {
+#if CONFIG_SPINLOCK_BACKOFF > 0
+  unsigned int backoff = 1;
+#endif
+
   while (up_testset(lock) == SP_LOCKED)
     {
 #if 0 /* Would recurse */
       sched_yield();
 #endif
+
+#if CONFIG_SPINLOCK_BACKOFF > 0
+      /* Back off exponentially so that the waiting CPUs do not all retry
+       * at the same moment.
+       */
+
+      spin_delay(backoff);
+      if (backoff < CONFIG_SPINLOCK_BACKOFF)
+        {
+          backoff <<= 1;
+        }
+#endif
+
+      /* Then wait until the lock appears to be free before trying again.
+       * Unlike the test-and-set, reading the lock does not take the cache
+       * line away from the other CPUs.
+       */
+
+      while (*lock == SP_LOCKED)
+        {
+          SP_WFE();
+        }
     }
 }
 
@@ -277,6 +359,7 @@ void spin_unlockr(FAR struct spinlock_s *lock)
 
           lock->sp_count = 0;
           lock->sp_cpu   = IMPOSSIBLE_CPU;
+          SP_DMB();
           lock->sp_lock  = SP_UNLOCKED;
         }
       else
@@ -296,6 +379,188 @@ void spin_unlockr(FAR struct spinlock_s *lock)
 #endif /* CONFIG_SMP */
 }
 
+/****************************************************************************
+ * Name: spin_lock_ticket
+ *
+ * Description:
+ *   Take a ticket and loop until the ticket holds the lock.  CPUs get the
+ *   lock in the order that they called spin_lock_ticket().
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock object to lock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_TICKET
+void spin_lock_ticket(FAR volatile struct spinlock_ticket_s *lock)
+{
+  uint16_t ticket;
+  uint16_t ahead;
+
+  ticket = spin_fetchadd(&lock->sp_next, 1);
+  while ((ahead = (uint16_t)(ticket - lock->sp_owner)) != 0)
+    {
+#if CONFIG_SPINLOCK_BACKOFF > 0
+      /* The lock cannot be ours before the CPUs ahead of us have had it, so
+       * back off in proportion to their number.
+       */
+
+      spin_delay((ahead - 1) * CONFIG_SPINLOCK_BACKOFF);
+#else
+      UNUSED(ahead);
+#endif
+
+      SP_WFE();
+    }
+
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: spin_trylock_ticket
+ *
+ * Description:
+ *   Take the ticket lock only if that is possible without waiting.
+ *
+ * Returned Value:
+ *   true if the lock was taken.
+ *
+ ****************************************************************************/
+
+bool spin_trylock_ticket(FAR volatile struct spinlock_ticket_s *lock)
+{
+  uint16_t next = lock->sp_next;
+
+  /* The owner can only catch up with the next ticket, so the lock is free
+   * if the next ticket is still unchanged when we take it.
+   */
+
+  if (next != lock->sp_owner ||
+      !spin_cmpxchg(&lock->sp_next, next, (uint16_t)(next + 1)))
+    {
+      return false;
+    }
+
+  SP_DMB();
+  return true;
+}
+
+/****************************************************************************
+ * Name: spin_unlock_ticket
+ *
+ * Description:
+ *   Release a ticket lock, passing it to the next waiting ticket.
+ *
+ ****************************************************************************/
+
+void spin_unlock_ticket(FAR volatile struct spinlock_ticket_s *lock)
+{
+  DEBUGASSERT(lock->sp_next != lock->sp_owner);
+
+  /* Only the holder of the lock modifies sp_owner */
+
+  SP_DMB();
+  lock->sp_owner = lock->sp_owner + 1;
+  SP_DSB();
+  SP_SEV();
+}
+#endif /* CONFIG_SPINLOCK_TICKET */
+
+/****************************************************************************
+ * Name: spin_lock_mcs
+ *
+ * Description:
+ *   Queue the caller's node on the MCS lock and loop until the lock is
+ *   passed to it.  The node must remain valid (and must not be used for
+ *   any other lock) until spin_unlock_mcs() is called with it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of the caller.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_MCS
+void spin_lock_mcs(FAR volatile struct spinlock_mcs_s *lock,
+                   FAR struct spinlock_mcsnode_s *node)
+{
+  FAR struct spinlock_mcsnode_s *prev;
+
+  node->sp_next = NULL;
+  node->sp_wait = 1;
+
+  /* Append our node to the queue.  If the queue was empty, the lock is
+   * ours.
+   */
+
+  SP_DMB();
+  prev = spin_xchg(&lock->sp_tail, node);
+  if (prev != NULL)
+    {
+      /* Otherwise, link behind the previous node and wait until its owner
+       * passes the lock to us.  Only our own node is polled.
+       */
+
+      prev->sp_next = node;
+      while (node->sp_wait != 0)
+        {
+          SP_WFE();
+        }
+    }
+
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: spin_unlock_mcs
+ *
+ * Description:
+ *   Release an MCS lock, passing it to the next queued node (if any).
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to unlock.
+ *   node - The same queue node that was passed to spin_lock_mcs().
+ *
+ ****************************************************************************/
+
+void spin_unlock_mcs(FAR volatile struct spinlock_mcs_s *lock,
+                     FAR struct spinlock_mcsnode_s *node)
+{
+  FAR struct spinlock_mcsnode_s *next;
+
+  SP_DMB();
+
+  next = node->sp_next;
+  if (next == NULL)
+    {
+      /* No CPU is queued behind us, unless one has just replaced the tail
+       * and is about to link its node.
+       */
+
+      if (spin_cmpxchg(&lock->sp_tail, node, NULL))
+        {
+          return;
+        }
+
+      while ((next = node->sp_next) == NULL)
+        {
+        }
+    }
+
+  /* Pass the lock to the next node */
+
+  next->sp_wait = 0;
+  SP_DSB();
+  SP_SEV();
+}
+#endif /* CONFIG_SPINLOCK_MCS */
+
 /****************************************************************************
  * Name: spin_setbit
  *
@@ -314,12 +579,12 @@ void spin_unlockr(FAR struct spinlock_s *lock)
  ****************************************************************************/
 
 void spin_setbit(FAR volatile cpu_set_t *set, unsigned int cpu,
-                 FAR volatile spinlock_t *setlock,
+                 FAR volatile spinlock_set_t *setlock,
                  FAR volatile spinlock_t *orlock)
 {
   /* First, get the 'setlock' spinlock */
 
-  spin_lock(setlock);
+  spin_lockset(setlock);
 
   /* Then set the bit and mark the 'orlock' as locked */
 
@@ -328,7 +593,7 @@ void spin_setbit(FAR volatile cpu_set_t *set, unsigned int cpu,
 
   /* Release the 'setlock' */
 
-  spin_unlock(setlock);
+  spin_unlockset(setlock);
 }
 
 /****************************************************************************
@@ -349,12 +614,12 @@ void spin_setbit(FAR volatile cpu_set_t *set, unsigned int cpu,
  ****************************************************************************/
 
 void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
-                 FAR volatile spinlock_t *setlock,
+                 FAR volatile spinlock_set_t *setlock,
                  FAR volatile spinlock_t *orlock)
 {
   /* First, get the 'setlock' spinlock */
 
-  spin_lock(setlock);
+  spin_lockset(setlock);
 
   /* Then clear the bit in the CPU set.  Set/clear the 'orlock' depending
    * upon the resulting state of the CPU set.
@@ -365,7 +630,7 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
 
   /* Release the 'setlock' */
 
-  spin_unlock(setlock);
+  spin_unlockset(setlock);
 }
 
 #endif /* CONFIG_SPINLOCK */
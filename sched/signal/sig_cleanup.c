@@ -38,6 +38,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <string.h>
+
 #include <nuttx/arch.h>
 
 #include "signal/signal.h"
@@ -109,5 +112,10 @@ void sig_release(FAR struct task_group_s *group)
     {
       sig_releasependingsignal(sigpend);
     }
+
+  group->tg_sigpendset = NULL_SIGNAL_SET;
+#ifdef CONFIG_SIG_ACTIONTABLE
+  memset(group->tg_sigaction, 0, sizeof(group->tg_sigaction));
+#endif
 }
 
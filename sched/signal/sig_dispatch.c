@@ -205,11 +205,16 @@ static FAR sigpendq_t *sig_findpendingsignal(FAR struct task_group_s *group,
 
   flags = enter_critical_section();
 
-  /* Seach the list for a sigpendion on this signal */
+  /* Seach the list for a sigpendion on this signal (unless the pending set
+   * says that there is none).
+   */
 
-  for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
-       (sigpend && sigpend->info.si_signo != signo);
-       sigpend = sigpend->flink);
+  if (sigismember(&group->tg_sigpendset, signo) == 1)
+    {
+      for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
+           (sigpend && sigpend->info.si_signo != signo);
+           sigpend = sigpend->flink);
+    }
 
   leave_critical_section(flags);
   return sigpend;
@@ -263,6 +268,7 @@ static FAR sigpendq_t *sig_addpendingsignal(FAR struct tcb_s *stcb,
 
           flags = enter_critical_section();
           sq_addlast((FAR sq_entry_t *)sigpend, &group->tg_sigpendingq);
+          sigaddset(&group->tg_sigpendset, info->si_signo);
           leave_critical_section(flags);
         }
     }
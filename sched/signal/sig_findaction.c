@@ -56,6 +56,15 @@ FAR sigactq_t *sig_findaction(FAR struct task_group_s *group, int signo)
 {
   FAR sigactq_t *sigact = NULL;
 
+#ifdef CONFIG_SIG_ACTIONTABLE
+  /* The action is simply looked up by signal number */
+
+  if (group && GOOD_SIGNO(signo))
+    {
+      sigact = group->tg_sigaction[signo];
+    }
+
+#else
   /* Verify the caller's sanity */
 
   if (group)
@@ -75,6 +84,7 @@ FAR sigactq_t *sig_findaction(FAR struct task_group_s *group, int signo)
 
       sched_unlock();
     }
+#endif
 
   return sigact;
 }
@@ -95,20 +95,16 @@ sigset_t sig_pendingset(FAR struct tcb_s *stcb)
 {
   FAR struct task_group_s *group = stcb->group;
   sigset_t sigpendset;
-  FAR sigpendq_t *sigpend;
   irqstate_t flags;
 
   DEBUGASSERT(group);
 
-  sigpendset = NULL_SIGNAL_SET;
+  /* The set of signals in the pending signal list is maintained as the
+   * list is modified.
+   */
 
   flags = enter_critical_section();
-  for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
-       (sigpend); sigpend = sigpend->flink)
-    {
-      sigaddset(&sigpendset, sigpend->info.si_signo);
-    }
-
+  sigpendset = group->tg_sigpendset;
   leave_critical_section(flags);
 
   return sigpendset;
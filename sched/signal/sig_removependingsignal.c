@@ -76,6 +76,14 @@ FAR sigpendq_t *sig_removependingsignal(FAR struct tcb_s *stcb, int signo)
 
   flags = enter_critical_section();
 
+  /* There is nothing to search for if the signal is not in the pending set */
+
+  if (sigismember(&group->tg_sigpendset, signo) != 1)
+    {
+      leave_critical_section(flags);
+      return NULL;
+    }
+
   for (prevsig = NULL, currsig = (FAR sigpendq_t *)group->tg_sigpendingq.head;
        (currsig && currsig->info.si_signo != signo);
        prevsig = currsig, currsig = currsig->flink);
@@ -92,6 +100,10 @@ FAR sigpendq_t *sig_removependingsignal(FAR struct tcb_s *stcb, int signo)
         }
     }
 
+  /* Only one entry is ever queued for each signal number */
+
+  sigdelset(&group->tg_sigpendset, signo);
+
   leave_critical_section(flags);
 
   return currsig;
@@ -52,6 +52,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 
 #include "sched/sched.h"
 #include "signal/signal.h"
@@ -71,6 +72,26 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sig_settimeout
+ *
+ * Description:
+ *  Record that the wait of 'wtcb' ended because of a timeout.
+ *
+ ****************************************************************************/
+
+static void sig_settimeout(FAR struct tcb_s *wtcb)
+{
+  wtcb->sigunbinfo.si_signo           = SIG_WAIT_TIMEOUT;
+  wtcb->sigunbinfo.si_code            = SI_TIMER;
+  wtcb->sigunbinfo.si_errno           = ETIMEDOUT;
+  wtcb->sigunbinfo.si_value.sival_int = 0;
+#ifdef CONFIG_SCHED_HAVE_PARENT
+  wtcb->sigunbinfo.si_pid             = 0;  /* Not applicable */
+  wtcb->sigunbinfo.si_status          = OK;
+#endif
+}
+
 /****************************************************************************
  * Name: sig_timeout
  *
@@ -79,6 +100,7 @@
  *
  ****************************************************************************/
 
+#ifndef CONFIG_HRTIMER
 static void sig_timeout(int argc, wdparm_t itcb)
 {
   /* On many small machines, pointers are encoded and cannot be simply cast
@@ -102,18 +124,39 @@ static void sig_timeout(int argc, wdparm_t itcb)
 
   if (u.wtcb->task_state == TSTATE_WAIT_SIG)
     {
-      u.wtcb->sigunbinfo.si_signo           = SIG_WAIT_TIMEOUT;
-      u.wtcb->sigunbinfo.si_code            = SI_TIMER;
-      u.wtcb->sigunbinfo.si_errno           = ETIMEDOUT;
-      u.wtcb->sigunbinfo.si_value.sival_int = 0;
-#ifdef CONFIG_SCHED_HAVE_PARENT
-      u.wtcb->sigunbinfo.si_pid             = 0;  /* Not applicable */
-      u.wtcb->sigunbinfo.si_status          = OK;
-#endif
+      sig_settimeout(u.wtcb);
       up_unblock_task(u.wtcb);
     }
 }
 
+/****************************************************************************
+ * Name: sig_hrtimeout
+ *
+ * Description:
+ *  A high resolution timeout elapsed while waiting for signals to be
+ *  queued.
+ *
+ ****************************************************************************/
+
+#else
+static void sig_hrtimeout(FAR struct hrtimer_s *hrtimer, FAR void *arg)
+{
+  FAR struct tcb_s *wtcb = (FAR struct tcb_s *)arg;
+
+  ASSERT(wtcb);
+
+  /* There may be a race condition -- make sure the task is
+   * still waiting for a signal
+   */
+
+  if (wtcb->task_state == TSTATE_WAIT_SIG)
+    {
+      sig_settimeout(wtcb);
+      up_unblock_task(wtcb);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -168,7 +211,9 @@ int sigtimedwait(FAR const sigset_t *set, FAR struct siginfo *info,
   sigset_t intersection;
   FAR sigpendq_t *sigpend;
   irqstate_t flags;
+#ifndef CONFIG_HRTIMER
   int32_t waitticks;
+#endif
   int ret = ERROR;
 
   DEBUGASSERT(rtcb->waitdog == NULL);
@@ -227,6 +272,51 @@ int sigtimedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
       if (timeout)
         {
+#ifdef CONFIG_HRTIMER
+          struct hrtimer_s hrtimer;
+          struct timespec delay;
+
+          /* A high resolution timer requires a non-zero delay.  A zero
+           * timeout is treated as the smallest possible delay.
+           */
+
+          delay.tv_sec  = timeout->tv_sec;
+          delay.tv_nsec = timeout->tv_nsec;
+
+          if (delay.tv_sec == 0 && delay.tv_nsec == 0)
+            {
+              delay.tv_nsec = 1;
+            }
+
+          /* Start the timer.  The timer lives on this stack so it is
+           * registered in the TCB in case that this task is deleted while
+           * waiting.
+           */
+
+          hrtimer.active    = false;
+          rtcb->waithrtimer = &hrtimer;
+
+          if (hrtimer_start(&hrtimer, &delay, sig_hrtimeout, rtcb) == OK)
+            {
+              /* Now wait for either the signal or the timer */
+
+              up_block_task(rtcb, TSTATE_WAIT_SIG);
+
+              /* We no longer need the timer */
+
+              (void)hrtimer_cancel(&hrtimer);
+            }
+          else
+            {
+              /* The timeout is not valid.  Report it as expired without
+               * waiting.
+               */
+
+              sig_settimeout(rtcb);
+            }
+
+          rtcb->waithrtimer = NULL;
+#else
           /* Convert the timespec to system clock ticks, making sure that
            * the resulting delay is greater than or equal to the requested
            * time in nanoseconds.
@@ -280,6 +370,7 @@ int sigtimedwait(FAR const sigset_t *set, FAR struct siginfo *info,
           /* REVISIT: And do what if there are no watchdog timers?  The wait
            * will fail and we will return something bogus.
            */
+#endif
         }
 
       /* No timeout, just wait */
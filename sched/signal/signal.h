@@ -56,11 +56,27 @@
  * allocate in a block
  */
 
+#ifndef CONFIG_SIG_PREALLOC_ACTIONS
+#  define CONFIG_SIG_PREALLOC_ACTIONS 16
+#endif
+
+#ifndef CONFIG_SIG_PREALLOC_IRQ_ACTIONS
+#  define CONFIG_SIG_PREALLOC_IRQ_ACTIONS 8
+#endif
+
+#ifndef CONFIG_SIG_PREALLOC_PENDING
+#  define CONFIG_SIG_PREALLOC_PENDING 16
+#endif
+
+#ifndef CONFIG_SIG_PREALLOC_IRQ_PENDING
+#  define CONFIG_SIG_PREALLOC_IRQ_PENDING 8
+#endif
+
 #define NUM_SIGNAL_ACTIONS      16
-#define NUM_PENDING_ACTIONS     16
-#define NUM_PENDING_INT_ACTIONS  8
-#define NUM_SIGNALS_PENDING     16
-#define NUM_INT_SIGNALS_PENDING  8
+#define NUM_PENDING_ACTIONS     CONFIG_SIG_PREALLOC_ACTIONS
+#define NUM_PENDING_INT_ACTIONS CONFIG_SIG_PREALLOC_IRQ_ACTIONS
+#define NUM_SIGNALS_PENDING     CONFIG_SIG_PREALLOC_PENDING
+#define NUM_INT_SIGNALS_PENDING CONFIG_SIG_PREALLOC_IRQ_PENDING
 
 /****************************************************************************
  * Public Type Definitions
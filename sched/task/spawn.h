@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/sched.h>
 #include <spawn.h>
 
 /****************************************************************************
@@ -65,6 +66,13 @@ struct spawn_parms_s
   FAR const posix_spawnattr_t *attr;
   FAR char * const *argv;
 
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  /* The start hook displaced by the posix_spawn() start hook */
+
+  starthook_t hook;
+  FAR void *hookarg;
+#endif
+
   /* Parameters that differ for posix_spawn[p] and task_spawn */
 
   union
@@ -86,7 +94,7 @@ struct spawn_parms_s
  ****************************************************************************/
 
 extern sem_t g_spawn_parmsem;
-#ifndef CONFIG_SCHED_WAITPID
+#if !defined(CONFIG_SCHED_WAITPID) || defined(CONFIG_TASK_SPAWN_DIRECT)
 extern sem_t g_spawn_execsem;
 #endif
 extern struct spawn_parms_s g_spawn_parms;
@@ -72,6 +72,11 @@ int  task_schedsetup(FAR struct task_tcb_s *tcb, int priority,
        start_t start, main_t main, uint8_t ttype);
 int  task_argsetup(FAR struct task_tcb_s *tcb, FAR const char *name,
        FAR char * const argv[]);
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+int  task_hookcreate(FAR const char *name, int priority, int stack_size,
+       main_t entry, FAR char * const argv[], starthook_t starthook,
+       FAR void *hookarg);
+#endif
 
 /* Task exit */
 
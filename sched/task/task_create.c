@@ -76,6 +76,9 @@
  *                than CONFIG_MAX_TASK_ARG parameters are passed, the list
  *                should be terminated with a NULL argv[] value. If no
  *                parameters are required, argv may be NULL.
+ *   starthook  - An optional start hook to register before the task is
+ *                activated (CONFIG_TASK_SPAWN_DIRECT only)
+ *   hookarg    - The argument to pass to the start hook
  *
  * Return Value:
  *   Returns the non-zero process ID of the new task or ERROR if memory is
@@ -84,9 +87,16 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+static int thread_create(FAR const char *name, uint8_t ttype, int priority,
+                         int stack_size, main_t entry,
+                         FAR char * const argv[], starthook_t starthook,
+                         FAR void *hookarg)
+#else
 static int thread_create(FAR const char *name, uint8_t ttype, int priority,
                          int stack_size, main_t entry,
                          FAR char * const argv[])
+#endif
 {
   FAR struct task_tcb_s *tcb;
   pid_t pid;
@@ -95,7 +105,11 @@ static int thread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Allocate a TCB for the new task. */
 
+#ifdef CONFIG_SCHED_TCBPOOL
+  tcb = (FAR struct task_tcb_s *)sched_tcballoc(ttype, stack_size);
+#else
   tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+#endif
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -135,9 +149,16 @@ static int thread_create(FAR const char *name, uint8_t ttype, int priority,
     }
 #endif
 
-  /* Allocate the stack for the TCB */
+  /* Allocate the stack for the TCB (unless a pooled TCB still has one) */
+
+#ifdef CONFIG_SCHED_TCBPOOL
+  ret = OK;
+  if (tcb->cmn.stack_alloc_ptr == NULL)
+#endif
+    {
+      ret = up_create_stack((FAR struct tcb_s *)tcb, stack_size, ttype);
+    }
 
-  ret = up_create_stack((FAR struct tcb_s *)tcb, stack_size, ttype);
   if (ret < OK)
     {
       errcode = -ret;
@@ -168,6 +189,15 @@ static int thread_create(FAR const char *name, uint8_t ttype, int priority,
     }
 #endif
 
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  /* The start hook must be in place before the task can run */
+
+  if (starthook != NULL)
+    {
+      task_starthook(tcb, starthook, hookarg);
+    }
+#endif
+
   /* Get the assigned pid before we start the task */
 
   pid = (int)tcb->cmn.pid;
@@ -237,8 +267,42 @@ errout:
 int task_create(FAR const char *name, int priority,
                 int stack_size, main_t entry, FAR char * const argv[])
 {
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  return thread_create(name, TCB_FLAG_TTYPE_TASK, priority, stack_size,
+                       entry, argv, NULL, NULL);
+#else
   return thread_create(name, TCB_FLAG_TTYPE_TASK, priority, stack_size,
                        entry, argv);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: task_hookcreate
+ *
+ * Description:
+ *   This function is identical to task_create() except that the start hook
+ *   is registered before the new task is activated.  The start hook runs on
+ *   the new task before its entry point is called.  This is an internal OS
+ *   interface used by task_spawn().
+ *
+ * Input Parameters:
+ *   (same as task_create()), plus:
+ *   starthook  - The start hook function
+ *   hookarg    - The argument to pass to the start hook
+ *
+ * Return Value:
+ *   (same as task_create())
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+int task_hookcreate(FAR const char *name, int priority, int stack_size,
+                    main_t entry, FAR char * const argv[],
+                    starthook_t starthook, FAR void *hookarg)
+{
+  return thread_create(name, TCB_FLAG_TTYPE_TASK, priority, stack_size,
+                       entry, argv, starthook, hookarg);
 }
 #endif
 
@@ -261,6 +325,11 @@ int task_create(FAR const char *name, int priority,
 int kernel_thread(FAR const char *name, int priority,
                   int stack_size, main_t entry, FAR char * const argv[])
 {
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  return thread_create(name, TCB_FLAG_TTYPE_KERNEL, priority, stack_size,
+                       entry, argv, NULL, NULL);
+#else
   return thread_create(name, TCB_FLAG_TTYPE_KERNEL, priority, stack_size,
                        entry, argv);
+#endif
 }
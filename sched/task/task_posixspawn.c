@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 
 #include <sys/wait.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include <spawn.h>
 #include <debug.h>
 
@@ -99,6 +101,9 @@
  *     array of pointers to null-terminated strings. The list is terminated
  *     with a null pointer.
  *
+ *   hook - True: Insert posix_spawn_hook() as the start hook of the new
+ *     task (CONFIG_TASK_SPAWN_DIRECT only).
+ *
  * Returned Value:
  *   This function will return zero on success. Otherwise, an error number
  *   will be returned as the function return value to indicate the error.
@@ -107,9 +112,13 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+static void posix_spawn_hook(FAR void *arg);
+#endif
+
 static int posix_spawn_exec(FAR pid_t *pidp, FAR const char *path,
                             FAR const posix_spawnattr_t *attr,
-                            FAR char * const argv[])
+                            FAR char * const argv[], bool hook)
 {
   FAR const struct symtab_s *symtab;
   int nsymbols;
@@ -146,6 +155,23 @@ static int posix_spawn_exec(FAR pid_t *pidp, FAR const char *path,
       *pidp = pid;
     }
 
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  /* The new task has been activated but cannot run until pre-emption is
+   * re-enabled.  Insert our start hook in front of the one that the binary
+   * loader may have registered (to run C++ static constructors).
+   */
+
+  if (hook)
+    {
+      FAR struct task_tcb_s *tcb = (FAR struct task_tcb_s *)sched_gettcb(pid);
+
+      DEBUGASSERT(tcb != NULL);
+      g_spawn_parms.hook    = tcb->starthook;
+      g_spawn_parms.hookarg = tcb->starthookarg;
+      task_starthook(tcb, posix_spawn_hook, NULL);
+    }
+#endif
+
   /* Now set the attributes.  Note that we ignore all of the return values
    * here because we have already successfully started the task.  If we
    * return an error value, then we would also have to stop the task.
@@ -163,6 +189,63 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: posix_spawn_hook
+ *
+ * Description:
+ *   Perform file_actions and set the signal mask on the thread of the newly
+ *   exec'ed task itself, before its entry point is called.  This replaces
+ *   the proxy task when CONFIG_TASK_SPAWN_DIRECT is selected.
+ *
+ *   The start hook of the binary loader is put back first so that only it
+ *   runs again if the task is restarted with task_restart(), and it is then
+ *   called from here.  If the file actions fail, the new task exits without
+ *   ever running its entry point and posix_spawn() reaps it.
+ *
+ * Input Parameters:
+ *   arg - Not used
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+static void posix_spawn_hook(FAR void *arg)
+{
+  FAR struct task_tcb_s *tcb = (FAR struct task_tcb_s *)this_task();
+  int ret;
+
+  tcb->starthook    = g_spawn_parms.hook;
+  tcb->starthookarg = g_spawn_parms.hookarg;
+
+  /* Set the attributes and perform the file actions as appropriate.  The
+   * parent task is waiting and still holds g_spawn_parmsem.
+   */
+
+  ret = spawn_proxyattrs(g_spawn_parms.attr, g_spawn_parms.file_actions);
+
+  /* Inform the parent task that we have completed what we need to do.  The
+   * parameter structure must not be accessed after this point.
+   */
+
+  g_spawn_parms.result = ret;
+  spawn_semgive(&g_spawn_execsem);
+
+  if (ret != OK)
+    {
+      exit(EXIT_FAILURE);
+    }
+
+  /* Now run the start hook of the binary loader, if any */
+
+  if (tcb->starthook != NULL)
+    {
+      tcb->starthook(tcb->starthookarg);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: posix_spawn_proxy
  *
@@ -187,6 +270,7 @@ errout:
  *
  ****************************************************************************/
 
+#ifndef CONFIG_TASK_SPAWN_DIRECT
 static int posix_spawn_proxy(int argc, FAR char *argv[])
 {
   int ret;
@@ -212,7 +296,7 @@ static int posix_spawn_proxy(int argc, FAR char *argv[])
       /* Start the task */
 
       ret = posix_spawn_exec(g_spawn_parms.pid, g_spawn_parms.u.posix.path,
-                             g_spawn_parms.attr, g_spawn_parms.argv);
+                             g_spawn_parms.attr, g_spawn_parms.argv, false);
 
 #ifdef CONFIG_SCHED_HAVE_PARENT
       if (ret == OK)
@@ -240,6 +324,7 @@ static int posix_spawn_proxy(int argc, FAR char *argv[])
 #endif
   return OK;
 }
+#endif /* !CONFIG_TASK_SPAWN_DIRECT */
 
 /****************************************************************************
  * Public Functions
@@ -350,10 +435,17 @@ int posix_spawn(FAR pid_t *pid, FAR const char *path,
                 FAR char *const argv[], FAR char *const envp[])
 #endif
 {
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  pid_t child;
+#ifdef CONFIG_SCHED_WAITPID
+  int status;
+#endif
+#else
   struct sched_param param;
   pid_t proxy;
 #ifdef CONFIG_SCHED_WAITPID
   int status;
+#endif
 #endif
   int ret;
 
@@ -373,9 +465,56 @@ int posix_spawn(FAR pid_t *pid, FAR const char *path,
   if (file_actions ==  NULL || *file_actions == NULL)
 #endif
     {
-      return posix_spawn_exec(pid, path, attr, argv);
+      return posix_spawn_exec(pid, path, attr, argv, false);
     }
 
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  /* Exec the program directly.  The start hook of the new task performs the
+   * file actions on its own file descriptors and sets its signal mask, then
+   * posts g_spawn_execsem.  The parameters are passed through the same
+   * semaphore-protected global structure that the proxy task uses.
+   */
+
+  spawn_semtake(&g_spawn_parmsem);
+
+  g_spawn_parms.result       = ENOSYS;
+  g_spawn_parms.pid          = &child;
+  g_spawn_parms.file_actions = file_actions ? *file_actions : NULL;
+  g_spawn_parms.attr         = attr;
+  g_spawn_parms.argv         = argv;
+  g_spawn_parms.u.posix.path = path;
+
+  ret = posix_spawn_exec(&child, path, attr, argv, true);
+  if (ret == OK)
+    {
+      /* Wait for the start hook to complete */
+
+      spawn_semtake(&g_spawn_execsem);
+      ret = g_spawn_parms.result;
+      if (ret == OK)
+        {
+          if (pid != NULL)
+            {
+              *pid = child;
+            }
+        }
+#ifdef CONFIG_SCHED_WAITPID
+      else
+        {
+          /* The file actions failed and the new task is exiting.  The
+           * caller never learns its pid, so reap it here rather than
+           * leave an exit status that nobody will ever collect.
+           */
+
+          (void)waitpid(child, &status, 0);
+        }
+#endif
+    }
+
+  spawn_semgive(&g_spawn_parmsem);
+  return ret;
+#else
+
   /* Otherwise, we will have to go through an intermediary/proxy task in order
    * to perform the I/O redirection.  This would be a natural place to fork().
    * However, true fork() behavior requires an MMU and most implementations
@@ -461,4 +600,5 @@ errout_with_lock:
 #endif
   spawn_semgive(&g_spawn_parmsem);
   return ret;
+#endif /* CONFIG_TASK_SPAWN_DIRECT */
 }
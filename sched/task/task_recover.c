@@ -43,6 +43,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/sched.h>
 
 #include "semaphore/semaphore.h"
@@ -80,6 +81,16 @@ void task_recover(FAR struct tcb_s *tcb)
 
   wd_recover(tcb);
 
+#ifdef CONFIG_HRTIMER
+  /* Cancel any high resolution timer used by sigtimedwait() */
+
+  if (tcb->waithrtimer)
+    {
+      (void)hrtimer_cancel(tcb->waithrtimer);
+      tcb->waithrtimer = NULL;
+    }
+#endif
+
   /* If the thread holds semaphore counts or is waiting for a semaphore count,
    * then release the counts.
    */
@@ -100,4 +111,13 @@ void task_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(sched_sporadic_stop(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (tcb->deadline != NULL)
+    {
+      /* Stop deadline scheduling and free its resources */
+
+      DEBUGVERIFY(sched_deadline_stop(tcb));
+    }
+#endif
 }
@@ -47,6 +47,8 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
 
 #include "sched/sched.h"
 #include "pthread/pthread.h"
@@ -62,6 +64,14 @@
 
 #define MAX_STACK_ARGS 256
 
+/* If the PID table can grow, it is doubled in size when assigning a PID
+ * needs this many probes (or more).
+ */
+
+#ifdef CONFIG_SCHED_GROWPIDHASH
+#  define PIDHASH_MAXPROBES 8
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -75,34 +85,105 @@ static const char g_noname[] = "<noname>";
  ****************************************************************************/
 
 /****************************************************************************
- * Name: task_assignpid
+ * Name: task_growpidhash
  *
  * Description:
- *   This function assigns the next unique task ID to a task.
+ *   Replace the PID table with one of twice the size.  Because the new size
+ *   is also a power of two, entries that were distinct in the old table
+ *   cannot collide in the new table.
+ *
+ * Return:
+ *   OK on success; a negated errno value if the table cannot grow.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_GROWPIDHASH
+static int task_growpidhash(void)
+{
+  FAR struct pidhash_s *newtable;
+  FAR struct pidhash_s *oldtable;
+  irqstate_t flags;
+  int newsize;
+  int ndx;
+  int i;
+
+  newsize = g_npidhash << 1;
+  if (newsize > CONFIG_SCHED_MAXPIDHASH)
+    {
+      return -ENOSPC;
+    }
+
+  newtable = (FAR struct pidhash_s *)
+    kmm_zalloc(newsize * sizeof(struct pidhash_s));
+
+  if (newtable == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < newsize; i++)
+    {
+      newtable[i].pid = INVALID_PROCESS_ID;
+    }
+
+  /* Move the active entries and switch to the new table.  Interrupts are
+   * disabled so that no lookup can see a partially updated table.
+   */
+
+  flags = enter_critical_section();
+
+  for (i = 0; i < g_npidhash; i++)
+    {
+      if (g_pidhash[i].tcb != NULL)
+        {
+          ndx           = g_pidhash[i].pid & (newsize - 1);
+          newtable[ndx] = g_pidhash[i];
+        }
+    }
+
+  oldtable   = g_pidhash;
+  g_pidhash  = newtable;
+  g_npidhash = newsize;
+
+  leave_critical_section(flags);
+
+  /* The initial table is statically allocated */
+
+  if (newsize > (CONFIG_MAX_TASKS << 1))
+    {
+      kmm_free(oldtable);
+    }
+
+  sinfo("PID table grown to %d entries\n", newsize);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: task_probepid
+ *
+ * Description:
+ *   Search the PID table for the next unique task ID that maps to a free
+ *   entry and assign it to the task.
  *
  * Inputs:
  *   tcb - TCB of task
  *
  * Return:
- *   OK on success; ERROR on failure (errno is not set)
+ *   The number of entries that were probed before the free entry was found
+ *   or ERROR if the table is full.
  *
  ****************************************************************************/
 
-static int task_assignpid(FAR struct tcb_s *tcb)
+static int task_probepid(FAR struct tcb_s *tcb)
 {
   pid_t next_pid;
   int   hash_ndx;
   int   tries;
 
-  /* Disable pre-emption.  This should provide sufficient protection
-   * for the following operation.
-   */
-
-  (void)sched_lock();
-
   /* We'll try every allowable pid */
 
-  for (tries = 0; tries < CONFIG_MAX_TASKS; tries++)
+  for (tries = 0; tries < g_npidhash; tries++)
     {
       /* Get the next process ID candidate */
 
@@ -132,18 +213,68 @@ static int task_assignpid(FAR struct tcb_s *tcb)
           g_pidhash[hash_ndx].ticks = 0;
 #endif
           tcb->pid = next_pid;
+          return tries;
+        }
+    }
+
+  /* If we get here, then the g_pidhash[] table is completely full. */
+
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: task_assignpid
+ *
+ * Description:
+ *   This function assigns the next unique task ID to a task.
+ *
+ * Inputs:
+ *   tcb - TCB of task
+ *
+ * Return:
+ *   OK on success; ERROR on failure (errno is not set)
+ *
+ ****************************************************************************/
+
+static int task_assignpid(FAR struct tcb_s *tcb)
+{
+  int tries;
 
-          (void)sched_unlock();
-          return OK;
+  /* Disable pre-emption.  This should provide sufficient protection
+   * for the following operation.
+   */
+
+  (void)sched_lock();
+
+  tries = task_probepid(tcb);
+
+#ifdef CONFIG_SCHED_GROWPIDHASH
+  if (tries < 0)
+    {
+      /* The table is full.  Grow it and try again. */
+
+      if (task_growpidhash() == OK)
+        {
+          tries = task_probepid(tcb);
         }
     }
+  else if (tries >= PIDHASH_MAXPROBES)
+    {
+      /* The table is getting crowded.  Grow it now so that later searches
+       * (and lookups) stay short.  The new PID is already in the table and
+       * will be moved with the others.
+       */
+
+      (void)task_growpidhash();
+    }
+#endif
 
-  /* If we get here, then the g_pidhash[] table is completely full.
-   * We cannot allow another task to be started.
+  /* If the table is still full, we cannot allow another task to be
+   * started.
    */
 
   (void)sched_unlock();
-  return ERROR;
+  return tries < 0 ? ERROR : OK;
 }
 
 /****************************************************************************
@@ -355,6 +486,16 @@ static int thread_schedsetup(FAR struct tcb_s *tcb, int priority,
   /* Assign a unique task ID to the task. */
 
   ret = task_assignpid(tcb);
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+  /* Allocate and initialize the thread's compiler TLS block */
+
+  if (ret == OK)
+    {
+      ret = sched_threadlocal_alloc(tcb);
+    }
+#endif
+
   if (ret == OK)
     {
       /* Save task priority and entry point in the TCB */
@@ -40,6 +40,8 @@
 #include <nuttx/config.h>
 
 #include <sys/wait.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include <sched.h>
 #include <spawn.h>
 #include <debug.h>
@@ -102,6 +104,9 @@
  *     array of pointers to null-terminated strings. The list is terminated
  *     with a null pointer.
  *
+ *   hook - True: Register task_spawn_hook() as the start hook of the new
+ *     task (CONFIG_TASK_SPAWN_DIRECT only).
+ *
  * Returned Value:
  *   This function will return zero on success. Otherwise, an error number
  *   will be returned as the function return value to indicate the error.
@@ -110,9 +115,13 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+static void task_spawn_hook(FAR void *arg);
+#endif
+
 static int task_spawn_exec(FAR pid_t *pidp, FAR const char *name,
                            main_t entry, FAR const posix_spawnattr_t *attr,
-                           FAR char * const *argv)
+                           FAR char * const *argv, bool hook)
 {
   size_t stacksize;
   int priority;
@@ -151,7 +160,17 @@ static int task_spawn_exec(FAR pid_t *pidp, FAR const char *name,
 
   /* Start the task */
 
-  pid = task_create(name, priority, stacksize, entry, argv);
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  if (hook)
+    {
+      pid = task_hookcreate(name, priority, stacksize, entry, argv,
+                            task_spawn_hook, NULL);
+    }
+  else
+#endif
+    {
+      pid = task_create(name, priority, stacksize, entry, argv);
+    }
   if (pid < 0)
     {
       ret = get_errno();
@@ -183,6 +202,55 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: task_spawn_hook
+ *
+ * Description:
+ *   Perform file_actions and set the signal mask on the thread of the new
+ *   child task itself, before its entry point is called.  This replaces the
+ *   proxy task when CONFIG_TASK_SPAWN_DIRECT is selected.
+ *
+ *   The start hook is removed first so that it does not run again if the
+ *   task is restarted with task_restart().  If the file actions fail, the
+ *   child task exits without ever running its entry point and task_spawn()
+ *   reaps it.
+ *
+ * Input Parameters:
+ *   arg - Not used
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+static void task_spawn_hook(FAR void *arg)
+{
+  FAR struct task_tcb_s *tcb = (FAR struct task_tcb_s *)this_task();
+  int ret;
+
+  tcb->starthook = NULL;
+
+  /* Set the attributes and perform the file actions as appropriate.  The
+   * parent task is waiting and still holds g_spawn_parmsem.
+   */
+
+  ret = spawn_proxyattrs(g_spawn_parms.attr, g_spawn_parms.file_actions);
+
+  /* Inform the parent task that we have completed what we need to do.  The
+   * parameter structure must not be accessed after this point.
+   */
+
+  g_spawn_parms.result = ret;
+  spawn_semgive(&g_spawn_execsem);
+
+  if (ret != OK)
+    {
+      exit(EXIT_FAILURE);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: task_spawn_proxy
  *
@@ -214,6 +282,7 @@ errout:
  *
  ****************************************************************************/
 
+#ifndef CONFIG_TASK_SPAWN_DIRECT
 static int task_spawn_proxy(int argc, FAR char *argv[])
 {
   int ret;
@@ -240,7 +309,7 @@ static int task_spawn_proxy(int argc, FAR char *argv[])
 
       ret = task_spawn_exec(g_spawn_parms.pid, g_spawn_parms.u.task.name,
                             g_spawn_parms.u.task.entry, g_spawn_parms.attr,
-                            g_spawn_parms.argv);
+                            g_spawn_parms.argv, false);
 
 #ifdef CONFIG_SCHED_HAVE_PARENT
       if (ret == OK)
@@ -268,6 +337,7 @@ static int task_spawn_proxy(int argc, FAR char *argv[])
 #endif
   return OK;
 }
+#endif /* !CONFIG_TASK_SPAWN_DIRECT */
 
 /****************************************************************************
  * Public Functions
@@ -343,10 +413,17 @@ int task_spawn(FAR pid_t *pid, FAR const char *name, main_t entry,
       FAR const posix_spawnattr_t *attr,
       FAR char *const argv[], FAR char *const envp[])
 {
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  pid_t child;
+#ifdef CONFIG_SCHED_WAITPID
+  int status;
+#endif
+#else
   struct sched_param param;
   pid_t proxy;
 #ifdef CONFIG_SCHED_WAITPID
   int status;
+#endif
 #endif
   int ret;
 
@@ -364,9 +441,55 @@ int task_spawn(FAR pid_t *pid, FAR const char *name, main_t entry,
   if (file_actions ==  NULL || *file_actions == NULL)
 #endif
     {
-      return task_spawn_exec(pid, name, entry, attr, argv);
+      return task_spawn_exec(pid, name, entry, attr, argv, false);
+    }
+
+#ifdef CONFIG_TASK_SPAWN_DIRECT
+  /* Create the child task directly.  Its start hook performs the file
+   * actions on the child's own file descriptors and sets its signal mask,
+   * then posts g_spawn_execsem.  The parameters are passed through the
+   * same semaphore-protected global structure that the proxy task uses.
+   */
+
+  spawn_semtake(&g_spawn_parmsem);
+
+  g_spawn_parms.result       = ENOSYS;
+  g_spawn_parms.pid          = &child;
+  g_spawn_parms.file_actions = file_actions ? *file_actions : NULL;
+  g_spawn_parms.attr         = attr;
+  g_spawn_parms.argv         = argv;
+
+  ret = task_spawn_exec(&child, name, entry, attr, argv, true);
+  if (ret == OK)
+    {
+      /* Wait for the start hook to complete */
+
+      spawn_semtake(&g_spawn_execsem);
+      ret = g_spawn_parms.result;
+      if (ret == OK)
+        {
+          if (pid != NULL)
+            {
+              *pid = child;
+            }
+        }
+#ifdef CONFIG_SCHED_WAITPID
+      else
+        {
+          /* The file actions failed and the child task is exiting.  The
+           * caller never learns its pid, so reap it here rather than
+           * leave an exit status that nobody will ever collect.
+           */
+
+          (void)waitpid(child, &status, 0);
+        }
+#endif
     }
 
+  spawn_semgive(&g_spawn_parmsem);
+  return ret;
+#else
+
   /* Otherwise, we will have to go through an intermediary/proxy task in order
    * to perform the I/O redirection.  This would be a natural place to fork().
    * However, true fork() behavior requires an MMU and most implementations
@@ -453,6 +576,7 @@ errout_with_lock:
 #endif
   spawn_semgive(&g_spawn_parmsem);
   return ret;
+#endif /* CONFIG_TASK_SPAWN_DIRECT */
 }
 
 #endif /* CONFIG_BUILD_KERNEL */
@@ -54,7 +54,7 @@
  ****************************************************************************/
 
 sem_t g_spawn_parmsem = SEM_INITIALIZER(1);
-#ifndef CONFIG_SCHED_WAITPID
+#if !defined(CONFIG_SCHED_WAITPID) || defined(CONFIG_TASK_SPAWN_DIRECT)
 sem_t g_spawn_execsem = SEM_INITIALIZER(0);
 #endif
 struct spawn_parms_s g_spawn_parms;
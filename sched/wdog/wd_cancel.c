@@ -72,8 +72,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = ERROR;
 
@@ -81,7 +83,7 @@ int wd_cancel(WDOG_ID wdog)
    * cancellation is complete
    */
 
-  flags = enter_critical_section();
+  flags = enter_critical_domain(CSDOMAIN_WDOG);
 
   /* Make sure that the watchdog is initialized (non-NULL) and is still
    * active.
@@ -89,6 +91,14 @@ int wd_cancel(WDOG_ID wdog)
 
   if (wdog && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* Remove the watchdog from its timer wheel slot and reassess the
+       * interval timer that will generate the next interval event.
+       */
+
+      wd_wheel_remove(wdog);
+      sched_timer_reassess();
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -138,6 +148,7 @@ int wd_cancel(WDOG_ID wdog)
 
           sched_timer_reassess();
         }
+#endif
 
       /* Mark the watchdog inactive */
 
@@ -149,6 +160,6 @@ int wd_cancel(WDOG_ID wdog)
       ret = OK;
     }
 
-  leave_critical_section(flags);
+  leave_critical_domain(CSDOMAIN_WDOG, flags);
   return ret;
 }
@@ -72,9 +72,17 @@ int wd_gettime(WDOG_ID wdog)
 
   /* Verify the wdog */
 
-  flags = enter_critical_section();
+  flags = enter_critical_domain(CSDOMAIN_WDOG);
   if (wdog && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMERWHEEL
+      /* The timer wheel knows the expiration time of the watchdog */
+
+      int delay = wd_wheel_remaining(wdog);
+
+      leave_critical_domain(CSDOMAIN_WDOG, flags);
+      return delay;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the wdog
        * that we are looking for
        */
@@ -87,12 +95,13 @@ int wd_gettime(WDOG_ID wdog)
           delay += curr->lag;
           if (curr == wdog)
             {
-              leave_critical_section(flags);
+              leave_critical_domain(CSDOMAIN_WDOG, flags);
               return delay;
             }
         }
+#endif
     }
 
-  leave_critical_section(flags);
+  leave_critical_domain(CSDOMAIN_WDOG, flags);
   return 0;
 }
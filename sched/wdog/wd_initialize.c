@@ -47,35 +47,30 @@
  * Public Data
  ****************************************************************************/
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* The g_wdpool is the pool of watchdogs available to the system for
+ * delayed function use.
  */
 
-sq_queue_t g_wdfreelist;
+struct mempool_s g_wdpool;
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
-
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
-
-uint16_t g_wdnfree;
+#endif
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* g_wdpool is a list of pre-allocated watchdogs. The number of watchdogs
+/* g_wdprealloc holds the pre-allocated watchdogs. The number of watchdogs
  * in the pool is a configuration item.
  */
 
-static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
+static struct wdog_s g_wdprealloc[CONFIG_PREALLOC_WDOGS];
 
 /****************************************************************************
  * Public Functions
@@ -102,24 +97,23 @@ static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
 
 void wd_initialize(void)
 {
-  FAR struct wdog_s *wdog = g_wdpool;
-  int i;
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Initialize the timer wheel of active watchdogs */
 
-  /* Initialize watchdog lists */
+  wd_wheel_initialize();
+#else
+  /* Initialize the active watchdog list */
 
-  sq_init(&g_wdfreelist);
   sq_init(&g_wdactivelist);
+#endif
 
-  /* The g_wdfreelist must be loaded at initialization time to hold the
-   * configured number of watchdogs.
+  /* The pool of free watchdogs must be loaded at initialization time to
+   * hold the configured number of watchdogs.  CONFIG_WDOG_INTRESERVE of
+   * these are reserved for use by interrupt handlers;  normal tasks will
+   * expand the pool instead of using the reserve.
    */
 
-  for (i = 0; i < CONFIG_PREALLOC_WDOGS; i++)
-    {
-      sq_addlast((FAR sq_entry_t *)wdog++, &g_wdfreelist);
-    }
-
-  /* All watchdogs are free */
-
-  g_wdnfree = CONFIG_PREALLOC_WDOGS;
+  (void)mempool_initialize(&g_wdpool, sizeof(struct wdog_s), g_wdprealloc,
+                           CONFIG_PREALLOC_WDOGS, CONFIG_WDOG_INTRESERVE,
+                           CONFIG_WDOG_EXPAND);
 }
@@ -90,15 +90,80 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Execute the function of an expired watchdog.
+ *
+ * Parameters:
+ *   wdog - The expired watchdog
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_dispatch(FAR struct wdog_s *wdog)
+{
+  /* Execute the watchdog function */
+
+  up_setpicbase(wdog->picbase);
+  switch (wdog->argc)
+    {
+      default:
+        DEBUGPANIC();
+        break;
+
+      case 0:
+        (*((wdentry0_t)(wdog->func)))(0);
+        break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+      case 1:
+        (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+      case 2:
+        (*((wdentry2_t)(wdog->func)))(2,
+                        wdog->parm[0], wdog->parm[1]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+      case 3:
+        (*((wdentry3_t)(wdog->func)))(3,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+      case 4:
+        (*((wdentry4_t)(wdog->func)))(4,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2], wdog->parm[3]);
+        break;
+#endif
+    }
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
  * Description:
  *   Check if the timer for the watchdog at the head of list is ready to
- *   run.  If so, remove the watchdog from the list and execute it.
+ *   run.  If so, remove the watchdog from the list and execute it.  With
+ *   CONFIG_WDOG_TIMERWHEEL, all watchdogs that expire at the current time
+ *   of the timer wheel are removed and executed.
+ *
+ *   The watchdog critical section domain is released while each watchdog
+ *   function executes:  The watchdog function may need to enter the global
+ *   critical section or may restart the watchdog.
  *
  * Parameters:
- *   None
+ *   flags - Location of the interrupt state returned when the watchdog
+ *     domain was entered.  This is updated each time the domain is
+ *     re-entered.
  *
  * Return Value:
  *   None
@@ -107,7 +172,32 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  *
  ****************************************************************************/
 
-static inline void wd_expiration(void)
+#ifdef CONFIG_WDOG_TIMERWHEEL
+static inline void wd_expiration(FAR irqstate_t *flags)
+{
+  FAR struct wdog_s *wdog;
+
+  /* Process each watchdog that expires at the current time of the timer
+   * wheel.
+   */
+
+  while ((wdog = wd_wheel_expired()) != NULL)
+    {
+      /* Indicate that the watchdog is no longer active. */
+
+      WDOG_CLRACTIVE(wdog);
+
+      /* Execute the watchdog function outside of the critical section
+       * domain.
+       */
+
+      leave_critical_domain(CSDOMAIN_WDOG, *flags);
+      wd_dispatch(wdog);
+      *flags = enter_critical_domain(CSDOMAIN_WDOG);
+    }
+}
+#else
+static inline void wd_expiration(FAR irqstate_t *flags)
 {
   FAR struct wdog_s *wdog;
 
@@ -139,48 +229,17 @@ static inline void wd_expiration(void)
 
           WDOG_CLRACTIVE(wdog);
 
-          /* Execute the watchdog function */
-
-          up_setpicbase(wdog->picbase);
-          switch (wdog->argc)
-            {
-              default:
-                DEBUGPANIC();
-                break;
-
-              case 0:
-                (*((wdentry0_t)(wdog->func)))(0);
-                break;
+          /* Execute the watchdog function outside of the critical section
+           * domain.
+           */
 
-#if CONFIG_MAX_WDOGPARMS > 0
-              case 1:
-                (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-              case 2:
-                (*((wdentry2_t)(wdog->func)))(2,
-                                wdog->parm[0], wdog->parm[1]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-              case 3:
-                (*((wdentry3_t)(wdog->func)))(3,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-              case 4:
-                (*((wdentry4_t)(wdog->func)))(4,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2], wdog->parm[3]);
-                break;
-#endif
-            }
+          leave_critical_domain(CSDOMAIN_WDOG, *flags);
+          wd_dispatch(wdog);
+          *flags = enter_critical_domain(CSDOMAIN_WDOG);
         }
     }
 }
+#endif /* CONFIG_WDOG_TIMERWHEEL */
 
 /****************************************************************************
  * Public Functions
@@ -222,10 +281,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list ap;
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
   irqstate_t flags;
   int i;
 
@@ -243,7 +304,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
    * the critical section is established.
    */
 
-  flags = enter_critical_section();
+  flags = enter_critical_domain(CSDOMAIN_WDOG);
   if (WDOG_ISACTIVE(wdog))
     {
       wd_cancel(wdog);
@@ -289,6 +350,12 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   (void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Add the watchdog to the timer wheel */
+
+  wd_wheel_insert(wdog, delay);
+
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -374,9 +441,13 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure. */
 
   wdog->lag = delay;
+#endif
+
+  /* Mark the watchdog as active */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -388,7 +459,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   sched_timer_resume();
 #endif
 
-  leave_critical_section(flags);
+  leave_critical_domain(CSDOMAIN_WDOG, flags);
   return OK;
 }
 
@@ -420,9 +491,29 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
+#ifndef CONFIG_WDOG_TIMERWHEEL
   FAR struct wdog_s *wdog;
   int decr;
+#endif
+  irqstate_t flags;
+  unsigned int ret;
+
+  flags = enter_critical_domain(CSDOMAIN_WDOG);
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Advance the timer wheel, processing expired watchdogs along the way */
+
+  while (ticks > 0)
+    {
+      ticks -= wd_wheel_advance(ticks);
+      wd_expiration(&flags);
+    }
+
+  /* Return the delay for the next watchdog to expire */
 
+  ret = wd_wheel_next();
+
+#else
   /* Check if there are any active watchdogs to process */
 
   while (g_wdactivelist.head && ticks > 0)
@@ -450,18 +541,33 @@ unsigned int wd_timer(int ticks)
 
       /* Check if the watchdog at the head of the list is ready to run */
 
-      wd_expiration();
+      wd_expiration(&flags);
     }
 
   /* Return the delay for the next watchdog to expire */
 
-  return g_wdactivelist.head ?
-         ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+  ret = g_wdactivelist.head ?
+        ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+#endif
+
+  leave_critical_domain(CSDOMAIN_WDOG, flags);
+  return ret;
 }
 
 #else
 void wd_timer(void)
 {
+  irqstate_t flags;
+
+  flags = enter_critical_domain(CSDOMAIN_WDOG);
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+  /* Advance the timer wheel by one tick and process expired watchdogs */
+
+  (void)wd_wheel_advance(1);
+  wd_expiration(&flags);
+
+#else
   /* Check if there are any active watchdogs to process */
 
   if (g_wdactivelist.head)
@@ -472,7 +578,10 @@ void wd_timer(void)
 
       /* Check if the watchdog at the head of the list is ready to run */
 
-      wd_expiration();
+      wd_expiration(&flags);
     }
+#endif
+
+  leave_critical_domain(CSDOMAIN_WDOG, flags);
 }
 #endif /* CONFIG_SCHED_TICKLESS */
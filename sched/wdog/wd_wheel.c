@@ -0,0 +1,397 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMERWHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The timer wheel consists of WHEEL_NLEVELS levels of WHEEL_NSLOTS slots.
+ * Level 0 has a resolution of one tick;  each slot of level n holds the
+ * watchdogs that expire within one 2^(n*WHEEL_BITS) tick period.
+ */
+
+#define WHEEL_BITS     CONFIG_WDOG_TIMERWHEEL_BITS
+#define WHEEL_NLEVELS  4
+#define WHEEL_NSLOTS   (1 << WHEEL_BITS)
+#define WHEEL_MASK     (WHEEL_NSLOTS - 1)
+#define WHEEL_TOTAL    (WHEEL_NLEVELS * WHEEL_NSLOTS)
+
+/* The longest delay that can be held in the wheel without re-insertion */
+
+#define WHEEL_MAXDELTA ((1ul << (WHEEL_NLEVELS * WHEEL_BITS)) - 1)
+
+/* Slot index of the slot in 'level' that holds time 't' */
+
+#define WHEEL_SLOT(level, t) \
+  (((level) << WHEEL_BITS) + (((t) >> ((level) * WHEEL_BITS)) & WHEEL_MASK))
+
+#if WHEEL_TOTAL > 256
+#  error The timer wheel slot index does not fit in struct wdog_s
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slots of all levels of the timer wheel */
+
+static dq_queue_t g_wdwheel[WHEEL_TOTAL];
+
+/* The current time of the timer wheel in ticks.  This is the time of the
+ * last tick processed by wd_wheel_advance().
+ */
+
+static uint32_t g_wdtick;
+
+/* The number of watchdogs in the timer wheel */
+
+static unsigned int g_wdnactive;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the slot of the timer wheel that corresponds to its
+ *   expiration time (held in the 'lag' field).
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  uint32_t expire = (uint32_t)wdog->lag;
+  uint32_t delta  = expire - g_wdtick;
+  int level;
+
+  if (delta > WHEEL_MAXDELTA)
+    {
+      /* Too far in the future.  Place the watchdog in the last slot of the
+       * outermost level.  It will be re-inserted when that slot cascades.
+       */
+
+      wdog->slot = WHEEL_SLOT(WHEEL_NLEVELS - 1, g_wdtick + WHEEL_MAXDELTA);
+    }
+  else
+    {
+      /* Find the innermost level whose range includes the delay */
+
+      for (level = 0;
+           level < WHEEL_NLEVELS - 1 &&
+           delta >= (1ul << ((level + 1) * WHEEL_BITS));
+           level++);
+
+      wdog->slot = WHEEL_SLOT(level, expire);
+    }
+
+  dq_addlast((FAR dq_entry_t *)wdog, &g_wdwheel[wdog->slot]);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Move all watchdogs in one slot of the timer wheel to their proper slots
+ *   in the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(FAR dq_queue_t *queue)
+{
+  FAR struct wdog_s *wdog;
+  dq_queue_t tmp;
+
+  /* Detach the slot first:  A watchdog may be re-inserted into this same
+   * slot if it is beyond the range of the wheel.
+   */
+
+  tmp = *queue;
+  dq_init(queue);
+
+  while ((wdog = (FAR struct wdog_s *)dq_remfirst(&tmp)) != NULL)
+    {
+      wd_wheel_add(wdog);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timer wheel.
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < WHEEL_TOTAL; i++)
+    {
+      dq_init(&g_wdwheel[i]);
+    }
+
+  g_wdtick    = 0;
+  g_wdnactive = 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel so that it expires after 'delay'
+ *   ticks.  The watchdog must not already be in the timer wheel.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int delay)
+{
+  DEBUGASSERT(delay > 0);
+
+  wdog->lag = (int)(g_wdtick + (uint32_t)delay);
+  wd_wheel_add(wdog);
+  g_wdnactive++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  DEBUGASSERT(wdog->slot < WHEEL_TOTAL && g_wdnactive > 0);
+
+  dq_rem((FAR dq_entry_t *)wdog, &g_wdwheel[wdog->slot]);
+  g_wdnactive--;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks remaining before an active watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog)
+{
+  return (int)((uint32_t)wdog->lag - g_wdtick);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the time of the timer wheel by up to 'ticks' ticks, cascading
+ *   watchdogs to lower levels of the wheel as needed.  The advance stops
+ *   early at the first tick on which some watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_advance(int ticks)
+{
+  int elapsed;
+  int level;
+
+  /* Nothing needs to be cascaded or expired if the wheel is empty */
+
+  if (g_wdnactive == 0)
+    {
+      g_wdtick += ticks;
+      return ticks;
+    }
+
+  for (elapsed = 0; elapsed < ticks; )
+    {
+      g_wdtick++;
+      elapsed++;
+
+      /* When the index into a level wraps to zero, it is time to cascade
+       * the next slot of the level above it.
+       */
+
+      for (level = 1;
+           level < WHEEL_NLEVELS &&
+           (g_wdtick & ((1ul << (level * WHEEL_BITS)) - 1)) == 0;
+           level++)
+        {
+          wd_wheel_cascade(&g_wdwheel[WHEEL_SLOT(level, g_wdtick)]);
+        }
+
+      /* Stop if there are watchdogs to expire on this tick */
+
+      if (g_wdwheel[WHEEL_SLOT(0, g_wdtick)].head != NULL)
+        {
+          break;
+        }
+    }
+
+  return elapsed;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove and return the next watchdog that expires at the current time
+ *   of the timer wheel.  NULL is returned if there are none.
+ *
+ *   All watchdogs in the level 0 slot for the current time expire now:
+ *   Watchdogs started while expired watchdogs are being processed always
+ *   expire in a later tick and so are placed in different slots.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+  FAR struct wdog_s *wdog;
+
+  wdog = (FAR struct wdog_s *)
+    dq_remfirst(&g_wdwheel[WHEEL_SLOT(0, g_wdtick)]);
+
+  if (wdog != NULL)
+    {
+      DEBUGASSERT((uint32_t)wdog->lag == g_wdtick && g_wdnactive > 0);
+      g_wdnactive--;
+    }
+
+  return wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks until the next watchdog in the timer wheel
+ *   expires, or zero if the timer wheel is empty.
+ *
+ *   Within each level, the first non-empty slot following the current time
+ *   holds the earliest watchdogs of that level, so only that slot needs to
+ *   be examined.  The returned delay may be shorter than the actual delay
+ *   if there are watchdogs beyond the range of the wheel.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_wheel_next(void)
+{
+  FAR struct wdog_s *wdog;
+  FAR dq_queue_t *queue;
+  uint32_t mindelta = UINT32_MAX;
+  uint32_t start;
+  uint32_t delta;
+  int level;
+  int i;
+
+  if (g_wdnactive == 0)
+    {
+      return 0;
+    }
+
+  for (level = 0; level < WHEEL_NLEVELS; level++)
+    {
+      for (i = 1; i <= WHEEL_NSLOTS; i++)
+        {
+          /* Get the start time of the period of the next slot */
+
+          start = ((g_wdtick >> (level * WHEEL_BITS)) + i) <<
+                  (level * WHEEL_BITS);
+          queue = &g_wdwheel[WHEEL_SLOT(level, start)];
+
+          if (queue->head != NULL)
+            {
+              for (wdog = (FAR struct wdog_s *)queue->head;
+                   wdog != NULL;
+                   wdog = wdog->next)
+                {
+                  /* A watchdog that was beyond the range of the wheel
+                   * when it was inserted may not expire within the period
+                   * of its slot.  Report the time when its slot cascades
+                   * instead.
+                   */
+
+                  if ((((uint32_t)wdog->lag ^ start) >>
+                       (level * WHEEL_BITS)) != 0)
+                    {
+                      delta = start - g_wdtick;
+                    }
+                  else
+                    {
+                      delta = (uint32_t)wdog->lag - g_wdtick;
+                    }
+
+                  if (delta < mindelta)
+                    {
+                      mindelta = delta;
+                    }
+                }
+
+              break;
+            }
+        }
+    }
+
+  DEBUGASSERT(mindelta > 0 && mindelta <= INT32_MAX);
+  return (unsigned int)mindelta;
+}
+#endif
+
+#endif /* CONFIG_WDOG_TIMERWHEEL */
@@ -47,6 +47,15 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/wdog.h>
+#include <nuttx/mm/mempool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_WDOG_EXPAND
+#  define CONFIG_WDOG_EXPAND 4
+#endif
 
 /****************************************************************************
  * Public Data
@@ -60,25 +69,20 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* The g_wdpool is the pool of watchdogs available to the system for
+ * delayed function use.
  */
 
-extern sq_queue_t g_wdfreelist;
+extern struct mempool_s g_wdpool;
 
+#ifndef CONFIG_WDOG_TIMERWHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
-
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
-
-extern uint16_t g_wdnfree;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -136,6 +140,103 @@ unsigned int wd_timer(int ticks);
 void wd_timer(void);
 #endif
 
+#ifdef CONFIG_WDOG_TIMERWHEEL
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timer wheel.
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void);
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the timer wheel so that it expires after 'delay'
+ *   ticks.  The watchdog must not already be in the timer wheel.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog critical section domain.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int delay);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog critical section domain.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_remaining
+ *
+ * Description:
+ *   Return the number of ticks remaining before an active watchdog expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_remaining(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Advance the time of the timer wheel by up to 'ticks' ticks, cascading
+ *   watchdogs to lower levels of the wheel as needed.  The advance stops
+ *   early at the first tick on which some watchdog expires.
+ *
+ * Returned Value:
+ *   The number of ticks actually advanced.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog critical section domain.
+ *
+ ****************************************************************************/
+
+int wd_wheel_advance(int ticks);
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Remove and return the next watchdog that expires at the current time
+ *   of the timer wheel.  NULL is returned if there are none.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog critical section domain.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks until the next watchdog in the timer wheel
+ *   expires, or zero if the timer wheel is empty.
+ *
+ * Assumptions:
+ *   The caller holds the watchdog critical section domain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_wheel_next(void);
+#endif
+#endif /* CONFIG_WDOG_TIMERWHEEL */
+
 /****************************************************************************
  * Name: wd_recover
  *
@@ -39,6 +39,9 @@
 
 #include <nuttx/config.h>
 
+#include <unistd.h>
+#include <sched.h>
+#include <string.h>
 #include <errno.h>
 #include <queue.h>
 #include <debug.h>
@@ -56,9 +59,9 @@
  * Public Data
  ****************************************************************************/
 
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s). */
 
-struct hp_wqueue_s g_hpwork;
+struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 
 /****************************************************************************
  * Private Functions
@@ -78,6 +81,10 @@ struct hp_wqueue_s g_hpwork;
  *   That will be the higher priority worker thread only if a lower priority
  *   worker thread is available.
  *
+ *   If there are multiple high priority work queues (one per CPU), then
+ *   worker thread 0 of each queue polls that queue.  If there are multiple
+ *   worker threads for a queue, then the others wait to be signalled.
+ *
  *   All kernel mode worker threads are started by the OS during normal
  *   bring up.  This entry point is referenced by OS internally and should
  *   not be accessed by application logic.
@@ -92,10 +99,56 @@ struct hp_wqueue_s g_hpwork;
 
 static int work_hpthread(int argc, char *argv[])
 {
+  FAR struct hp_wqueue_s *wqueue = &g_hpwork[0];
+  int wndx = 0;
+#if HPWORK_NQUEUES > 1 || HPWORK_NTHREADS > 1
+  pid_t me = getpid();
+  int qndx;
+  int i;
+
+  /* Find our queue and thread index by searching the workers in g_hpwork */
+
+  for (qndx = 0; qndx < HPWORK_NQUEUES; qndx++)
+    {
+      for (i = 0; i < HPWORK_NTHREADS; i++)
+        {
+          if (g_hpwork[qndx].worker[i].pid == me)
+            {
+              wqueue = &g_hpwork[qndx];
+              wndx   = i;
+              goto found;
+            }
+        }
+    }
+
+  DEBUGPANIC();
+
+found:
+#endif
+
+  UNUSED(wndx);
+
   /* Loop forever */
 
   for (; ; )
     {
+#if HPWORK_NTHREADS > 1
+      /* Only thread 0 of each queue polls the queue */
+
+      if (wndx > 0)
+        {
+          /* The other threads will perform work, waiting indefinitely until
+           * signalled for the next work availability.
+           *
+           * The special value of zero for the poll period instructs
+           * work_process to wait indefinitely until a signal is received.
+           */
+
+          work_process((FAR struct kwork_wqueue_s *)wqueue, 0, wndx);
+          continue;
+        }
+#endif
+
 #ifndef CONFIG_SCHED_LPWORK
       /* First, perform garbage collection.  This cleans-up memory
        * de-allocations that were queued because they could not be freed in
@@ -105,18 +158,21 @@ static int work_hpthread(int argc, char *argv[])
        * NOTE: If the work thread is disabled, this clean-up is performed by
        * the IDLE thread (at a very, very low priority).  If the low-priority
        * work thread is enabled, then the garbage collection is done on that
-       * thread instead.
+       * thread instead.  Only the worker of the first queue does this.
        */
 
-      sched_garbage_collection();
+      if (wqueue == &g_hpwork[0])
+        {
+          sched_garbage_collection();
+        }
 #endif
 
       /* Then process queued work.  work_process will not return until: (1)
        * there is no further work in the work queue, and (2) the polling
-       * period provided by g_hpwork.delay expires.
+       * period provided by wqueue->delay expires.
        */
 
-      work_process((FAR struct kwork_wqueue_s *)&g_hpwork, g_hpwork.delay, 0);
+      work_process((FAR struct kwork_wqueue_s *)wqueue, wqueue->delay, 0);
     }
 
   return OK; /* To keep some compilers happy */
@@ -143,35 +199,68 @@ static int work_hpthread(int argc, char *argv[])
 
 int work_hpstart(void)
 {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  cpu_set_t cpuset;
+#endif
   pid_t pid;
+  int qndx;
+  int wndx;
 
   /* Initialize work queue data structures */
 
-  g_hpwork.delay          = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
-  dq_init(&g_hpwork.q);
+  memset(g_hpwork, 0, sizeof(g_hpwork));
+
+  for (qndx = 0; qndx < HPWORK_NQUEUES; qndx++)
+    {
+      g_hpwork[qndx].delay = CONFIG_SCHED_HPWORKPERIOD / USEC_PER_TICK;
+      dq_init(&g_hpwork[qndx].q);
+    }
+
+  /* Don't permit any of the threads to run until we have fully initialized
+   * g_hpwork.
+   */
 
-  /* Start the high-priority, kernel mode worker thread */
+  sched_lock();
 
-  sinfo("Starting high-priority kernel worker thread\n");
+  /* Start the high-priority, kernel mode worker thread(s) */
 
-  pid = kernel_thread(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
-                      CONFIG_SCHED_HPWORKSTACKSIZE,
-                      (main_t)work_hpthread,
-                      (FAR char * const *)NULL);
+  sinfo("Starting high-priority kernel worker thread(s)\n");
 
-  DEBUGASSERT(pid > 0);
-  if (pid < 0)
+  for (qndx = 0; qndx < HPWORK_NQUEUES; qndx++)
     {
-      int errcode = errno;
-      DEBUGASSERT(errcode > 0);
+      for (wndx = 0; wndx < HPWORK_NTHREADS; wndx++)
+        {
+          pid = kernel_thread(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                              CONFIG_SCHED_HPWORKSTACKSIZE,
+                              (main_t)work_hpthread,
+                              (FAR char * const *)NULL);
+
+          DEBUGASSERT(pid > 0);
+          if (pid < 0)
+            {
+              int errcode = errno;
+              DEBUGASSERT(errcode > 0);
+
+              serr("ERROR: kernel_thread %d failed: %d\n", wndx, errcode);
+              sched_unlock();
+              return -errcode;
+            }
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+          /* Lock the worker thread to the CPU of its queue */
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(qndx, &cpuset);
+          DEBUGVERIFY(sched_setaffinity(pid, sizeof(cpu_set_t), &cpuset));
+#endif
 
-      serr("ERROR: kernel_thread failed: %d\n", errcode);
-      return -errcode;
+          g_hpwork[qndx].worker[wndx].pid  = pid;
+          g_hpwork[qndx].worker[wndx].busy = true;
+        }
     }
 
-  g_hpwork.worker[0].pid  = pid;
-  g_hpwork.worker[0].busy = true;
-  return pid;
+  sched_unlock();
+  return g_hpwork[0].worker[0].pid;
 }
 
 #endif /* CONFIG_SCHED_HPWORK */
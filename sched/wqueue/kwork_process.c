@@ -183,41 +183,42 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, systime_t period, int wndx)
         }
       else /* elapsed < work->delay */
         {
-          /* This one is not ready.
-           *
-           * NOTE that elapsed is relative to the the current time,
-           * not the time of beginning of this queue processing pass.
-           * So it may need an adjustment.
+          /* This one is not ready.  The list is sorted by due time so none
+           * of the work that follows is ready either.  Decide when to wake
+           * up next:  Any pending work may be deferred by its slack, so
+           * wake up at the earliest time that some work must be performed.
+           * That will perform all of the work that is due by then with a
+           * single wake-up.  The search can stop at the first work that is
+           * not due until after that time.
            */
 
-          elapsed += (ctick - stick);
-          if (elapsed > work->delay)
+          do
             {
-              /* The delay has expired while we are processing */
+              elapsed = ctick - work->qtime;
+              remaining = elapsed >= work->delay ? 0 : work->delay - elapsed;
+              if (remaining >= next)
+                {
+                  break;
+                }
+
+              if (work->worker != NULL && work->slack < next - remaining)
+                {
+                  next = remaining + work->slack;
+                }
 
-              elapsed = work->delay;
-            }
-
-          /* Will it be ready before the next scheduled wakeup interval? */
-
-          remaining = work->delay - elapsed;
-          if (remaining < next)
-            {
-              /* Yes.. Then schedule to wake up when the work is ready */
-
-              next = remaining;
+              work = (FAR struct work_s *)work->dq.flink;
             }
+          while (work != NULL);
 
-          /* Then try the next in the list. */
-
-          work = (FAR struct work_s *)work->dq.flink;
+          break;
         }
     }
 
-#if defined(CONFIG_SCHED_LPWORK) && CONFIG_SCHED_LPNTHREADS > 0
+#if (defined(CONFIG_SCHED_LPWORK) && CONFIG_SCHED_LPNTHREADS > 0) || \
+    (defined(CONFIG_SCHED_HPWORK) && HPWORK_NTHREADS > 1)
   /* Value of zero for period means that we should wait indefinitely until
    * signalled.  This option is used only for the case where there are
-   * multiple, low-priority worker threads.  In that case, only one of
+   * multiple worker threads on one work queue.  In that case, only one of
    * the threads does the poll... the others simple.  In all other cases
    * period will be non-zero and equal to wqueue->delay.
    */
@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <signal.h>
 #include <queue.h>
 #include <assert.h>
 #include <errno.h>
@@ -57,6 +58,49 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_insert
+ *
+ * Description:
+ *   Insert work into the work queue list.  The list is kept sorted by the
+ *   time remaining until each entry is due so that the worker thread only
+ *   has to look at the head of the list.  Entries with the same due time
+ *   stay in the order that they were queued.
+ *
+ *   The search starts at the tail of the list because newly queued work is
+ *   most commonly due after all of the work that is already queued.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void work_insert(FAR dq_queue_t *q, FAR struct work_s *work)
+{
+  FAR struct work_s *prev;
+  systime_t elapsed;
+
+  for (prev = (FAR struct work_s *)q->tail;
+       prev != NULL;
+       prev = (FAR struct work_s *)prev->dq.blink)
+    {
+      elapsed = work->qtime - prev->qtime;
+      if (elapsed >= prev->delay || prev->delay - elapsed <= work->delay)
+        {
+          break;
+        }
+    }
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)work, q);
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)work, q);
+    }
+}
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -80,6 +124,8 @@
  *            int is invoked.
  *   delay  - Delay (in clock ticks) from the time queue until the worker
  *            is invoked. Zero means to perform the work immediately.
+ *   slack  - Additional ticks that the work may be deferred so that it can
+ *            be performed together with other work.
  *
  * Returned Value:
  *   None
@@ -88,7 +134,7 @@
 
 static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
                         FAR struct work_s *work, worker_t worker,
-                        FAR void *arg, systime_t delay)
+                        FAR void *arg, systime_t delay, systime_t slack)
 {
   irqstate_t flags;
 
@@ -103,12 +149,13 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
   work->worker = worker;           /* Work callback. non-NULL means queued */
   work->arg    = arg;              /* Callback argument */
   work->delay  = delay;            /* Delay until work performed */
+  work->slack  = slack;            /* Permitted additional delay */
 
   /* Now, time-tag that entry and put it in the work queue */
 
   work->qtime  = clock_systimer(); /* Time work queued */
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  work_insert(&wqueue->q, work);
 
   leave_critical_section(flags);
 }
@@ -148,14 +195,61 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, systime_t delay)
+{
+  return work_queue_slack(qid, work, worker, arg, delay, 0);
+}
+
+/****************************************************************************
+ * Name: work_queue_slack
+ *
+ * Description:
+ *   Queue kernel-mode work to be performed at a later time, permitting the
+ *   work to be deferred by up to 'slack' ticks beyond its delay.  The worker
+ *   thread uses the slack to perform several pieces of delayed work after
+ *   a single wake-up rather than waking up once for each.
+ *
+ * Input parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   slack  - Additional ticks that the work may be deferred.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_slack(int qid, FAR struct work_s *work, worker_t worker,
+                     FAR void *arg, systime_t delay, systime_t slack)
 {
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      /* Cancel high priority work */
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+      irqstate_t flags;
+      int ret;
+
+      /* Queue high priority work on the queue of this CPU.  The critical
+       * section keeps us on this CPU until the worker has been signalled.
+       */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
+      flags     = enter_critical_section();
+      work->cpu = up_cpu_index();
+      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork[work->cpu], work,
+                  worker, arg, delay, slack);
+      ret       = work_signal(HPWORK);
+      leave_critical_section(flags);
+      return ret;
+#else
+      /* Queue high priority work */
+
+      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork[0], work, worker,
+                  arg, delay, slack);
       return work_signal(HPWORK);
+#endif
     }
   else
 #endif
@@ -164,7 +258,8 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     {
       /* Cancel low priority work */
 
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
+      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg,
+                  delay, slack);
       return work_signal(LPWORK);
     }
   else
@@ -174,4 +269,49 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
     }
 }
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue high priority work to be performed by the worker thread of a
+ *   specific CPU.  This is otherwise the same as work_queue(HPWORK, ...).
+ *
+ * Input parameters:
+ *   cpu    - The CPU whose high priority work queue will perform the work
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+int work_queue_cpu(int cpu, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, systime_t delay)
+{
+  irqstate_t flags;
+  int ret;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags     = enter_critical_section();
+  work->cpu = cpu;
+  work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork[cpu], work, worker,
+              arg, delay, 0);
+
+  /* Wake up the worker thread of that CPU */
+
+  ret = kill(g_hpwork[cpu].worker[0].pid, SIGWORK);
+  leave_critical_section(flags);
+  return ret < 0 ? -EINVAL : OK;
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
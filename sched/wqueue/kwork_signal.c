@@ -78,7 +78,32 @@ int work_signal(int qid)
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      pid = g_hpwork.worker[0].pid;
+      FAR struct hp_wqueue_s *wqueue = work_hpqueue();
+      int wndx = 0;
+#if HPWORK_NTHREADS > 1
+      int i;
+
+      /* Find an IDLE worker thread */
+
+      for (i = 0; i < HPWORK_NTHREADS; i++)
+        {
+          /* Is this worker thread busy? */
+
+          if (!wqueue->worker[i].busy)
+            {
+              /* No.. select this thread */
+
+              wndx = i;
+              break;
+            }
+        }
+#endif
+
+      /* Use the process ID of the IDLE worker thread (or the ID of worker
+       * thread 0 if all of the worker threads are busy).
+       */
+
+      pid = wqueue->worker[wndx].pid;
     }
   else
 #endif
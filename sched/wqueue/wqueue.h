@@ -47,6 +47,8 @@
 #include <queue.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/arch.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -59,6 +61,20 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* The number of high priority work queues and of worker threads per high
+ * priority work queue.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK
+#  ifdef CONFIG_SCHED_HPWORK_PERCPU
+#    define HPWORK_NQUEUES  CONFIG_SMP_NCPUS
+#    define HPWORK_NTHREADS 1
+#  else
+#    define HPWORK_NQUEUES  1
+#    define HPWORK_NTHREADS CONFIG_SCHED_HPNTHREADS
+#  endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -88,7 +104,10 @@ struct hp_wqueue_s
 {
   systime_t         delay;     /* Delay between polling cycles (ticks) */
   struct dq_queue_s q;         /* The queue of pending work */
-  struct kworker_s  worker[1]; /* Describes the single high priority worker */
+
+  /* Describes each thread in the high priority queue's thread pool */
+
+  struct kworker_s  worker[HPWORK_NTHREADS];
 };
 #endif
 
@@ -113,9 +132,11 @@ struct lp_wqueue_s
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_HPWORK
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s).  There is one
+ * queue per CPU if CONFIG_SCHED_HPWORK_PERCPU is selected.
+ */
 
-extern struct hp_wqueue_s g_hpwork;
+extern struct hp_wqueue_s g_hpwork[HPWORK_NQUEUES];
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
@@ -128,6 +149,21 @@ extern struct lp_wqueue_s g_lpwork;
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_hpqueue
+ *
+ * Description:
+ *   Return the high priority work queue that should receive work queued
+ *   from the current CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+#  define work_hpqueue() (&g_hpwork[up_cpu_index()])
+#elif defined(CONFIG_SCHED_HPWORK)
+#  define work_hpqueue() (&g_hpwork[0])
+#endif
+
 /****************************************************************************
  * Name: work_hpstart
  *
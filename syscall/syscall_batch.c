@@ -0,0 +1,123 @@
+/****************************************************************************
+ * syscall/syscall_batch.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <errno.h>
+#include <syscall.h>
+
+/* The content of this file is only meaningful during the kernel phase of
+ * a kernel build.
+ */
+
+#if defined(CONFIG_LIB_SYSCALL_BATCH) && defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The stub functions take between zero and six parameters after the system
+ * call number.  As in the architecture-specific system call dispatch logic,
+ * each stub is called with all six; the unused ones are ignored.
+ */
+
+typedef uintptr_t (*syscall_stub_t)(int nbr, uintptr_t parm1,
+                                    uintptr_t parm2, uintptr_t parm3,
+                                    uintptr_t parm4, uintptr_t parm5,
+                                    uintptr_t parm6);
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Execute an array of system calls in one trap into the kernel.  See
+ *   include/sys/syscall.h.
+ *
+ ****************************************************************************/
+
+int syscall_batch(FAR struct syscall_batch_s *calls, int ncalls)
+{
+  FAR struct syscall_batch_s *call;
+  syscall_stub_t stub;
+  int i;
+
+  if (calls == NULL || ncalls < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  for (i = 0; i < ncalls; i++)
+    {
+      call = &calls[i];
+
+      /* Stop at an invalid system call number.  Nested batches are not
+       * supported.
+       */
+
+      if (call->nbr < CONFIG_SYS_RESERVED || call->nbr >= SYS_maxsyscall ||
+          call->nbr == SYS_syscall_batch)
+        {
+          if (i == 0)
+            {
+              set_errno(EINVAL);
+              return ERROR;
+            }
+
+          break;
+        }
+
+      /* Call the stub, just as the system call dispatcher would have */
+
+      stub = (syscall_stub_t)g_stublookup[call->nbr - CONFIG_SYS_RESERVED];
+      call->result = stub((int)call->nbr, call->parm[0], call->parm[1],
+                          call->parm[2], call->parm[3], call->parm[4],
+                          call->parm[5]);
+    }
+
+  return i;
+}
+
+#endif /* CONFIG_LIB_SYSCALL_BATCH && __KERNEL__ */
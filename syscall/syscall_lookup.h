@@ -152,6 +152,9 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(clock_getres,            2, STUB_clock_getres)
   SYSCALL_LOOKUP(clock_gettime,           2, STUB_clock_gettime)
   SYSCALL_LOOKUP(clock_settime,           2, STUB_clock_settime)
+#ifdef CONFIG_CLOCK_ADJTIME
+  SYSCALL_LOOKUP(clock_adjtime,           2, STUB_clock_adjtime)
+#endif
 
 /* The following are defined only if POSIX timers are supported */
 
@@ -182,6 +185,10 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(write,                   3, STUB_write)
   SYSCALL_LOOKUP(pread,                   4, STUB_pread)
   SYSCALL_LOOKUP(pwrite,                  4, STUB_pwrite)
+  SYSCALL_LOOKUP(readv,                   3, STUB_readv)
+  SYSCALL_LOOKUP(writev,                  3, STUB_writev)
+  SYSCALL_LOOKUP(preadv,                  4, STUB_preadv)
+  SYSCALL_LOOKUP(pwritev,                 4, STUB_pwritev)
 #  ifdef CONFIG_FS_AIO
   SYSCALL_LOOKUP(aio_read,                1, STUB_aio_read)
   SYSCALL_LOOKUP(aio_write,               1, STUB_aio_write)
@@ -255,6 +262,8 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(shmat,                   3, STUB_shmat)
   SYSCALL_LOOKUP(shmctl,                  3, STUB_shmctl)
   SYSCALL_LOOKUP(shmdt,                   1, STUB_shmdt)
+  SYSCALL_LOOKUP(shmwait,                 3, STUB_shmwait)
+  SYSCALL_LOOKUP(shmwake,                 2, STUB_shmwake)
 #endif
 
 /* The following are defined if pthreads are enabled */
@@ -264,11 +273,8 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(pthread_barrier_init,    3, STUB_pthread_barrier_init)
   SYSCALL_LOOKUP(pthread_barrier_wait,    1, STUB_pthread_barrier_wait)
   SYSCALL_LOOKUP(pthread_cancel,          1, STUB_pthread_cancel)
-  SYSCALL_LOOKUP(pthread_cond_broadcast,  1, STUB_pthread_cond_broadcast)
   SYSCALL_LOOKUP(pthread_cond_destroy,    1, STUB_pthread_cond_destroy)
   SYSCALL_LOOKUP(pthread_cond_init,       2, STUB_pthread_cond_init)
-  SYSCALL_LOOKUP(pthread_cond_signal,     1, STUB_pthread_cond_signal)
-  SYSCALL_LOOKUP(pthread_cond_wait,       2, STUB_pthread_cond_wait)
   SYSCALL_LOOKUP(pthread_create,          4, STUB_pthread_create)
   SYSCALL_LOOKUP(pthread_detach,          1, STUB_pthread_detach)
   SYSCALL_LOOKUP(pthread_exit,            1, STUB_pthread_exit)
@@ -279,23 +285,34 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(pthread_key_delete,      1, STUB_pthread_key_delete)
   SYSCALL_LOOKUP(pthread_mutex_destroy,   1, STUB_pthread_mutex_destroy)
   SYSCALL_LOOKUP(pthread_mutex_init,      2, STUB_pthread_mutex_init)
-  SYSCALL_LOOKUP(pthread_mutex_lock,      1, STUB_pthread_mutex_lock)
-  SYSCALL_LOOKUP(pthread_mutex_trylock,   1, STUB_pthread_mutex_trylock)
-  SYSCALL_LOOKUP(pthread_mutex_unlock,    1, STUB_pthread_mutex_unlock)
   SYSCALL_LOOKUP(pthread_once,            2, STUB_pthread_once)
   SYSCALL_LOOKUP(pthread_setcancelstate,  2, STUB_pthread_setcancelstate)
   SYSCALL_LOOKUP(pthread_setschedparam,   3, STUB_pthread_setschedparam)
   SYSCALL_LOOKUP(pthread_setschedprio,    2, STUB_pthread_setschedprio)
   SYSCALL_LOOKUP(pthread_setspecific,     2, STUB_pthread_setspecific)
   SYSCALL_LOOKUP(pthread_yield,           0, STUB_pthread_yield)
+#  ifdef CONFIG_PTHREAD_FUTEX
+  SYSCALL_LOOKUP(futex_wait,              3, STUB_futex_wait)
+  SYSCALL_LOOKUP(futex_wake,              2, STUB_futex_wake)
+  SYSCALL_LOOKUP(futex_requeue,           4, STUB_futex_requeue)
+#  else
+  SYSCALL_LOOKUP(pthread_cond_broadcast,  1, STUB_pthread_cond_broadcast)
+  SYSCALL_LOOKUP(pthread_cond_signal,     1, STUB_pthread_cond_signal)
+  SYSCALL_LOOKUP(pthread_cond_wait,       2, STUB_pthread_cond_wait)
+  SYSCALL_LOOKUP(pthread_mutex_lock,      1, STUB_pthread_mutex_lock)
+  SYSCALL_LOOKUP(pthread_mutex_trylock,   1, STUB_pthread_mutex_trylock)
+  SYSCALL_LOOKUP(pthread_mutex_unlock,    1, STUB_pthread_mutex_unlock)
+#  endif
 #  ifdef CONFIG_SMP
   SYSCALL_LOOKUP(pthread_setaffinity,     3, STUB_pthread_setaffinity)
   SYSCALL_LOOKUP(pthread_getaffinity,     3, STUB_pthread_getaffinity)
 #  endif
 #  ifndef CONFIG_DISABLE_SIGNALS
-  SYSCALL_LOOKUP(pthread_cond_timedwait,  3, STUB_pthread_cond_timedwait)
   SYSCALL_LOOKUP(pthread_kill,            2, STUB_pthread_kill)
   SYSCALL_LOOKUP(pthread_sigmask,         3, STUB_pthread_sigmask)
+#    ifndef CONFIG_PTHREAD_FUTEX
+  SYSCALL_LOOKUP(pthread_cond_timedwait,  3, STUB_pthread_cond_timedwait)
+#    endif
 #  endif
 #endif
 
@@ -344,6 +361,9 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(sendto,                  6, STUB_sendto)
   SYSCALL_LOOKUP(setsockopt,              5, STUB_setsockopt)
   SYSCALL_LOOKUP(socket,                  3, STUB_socket)
+  SYSCALL_LOOKUP(recvmmsg,                5, STUB_recvmmsg)
+  SYSCALL_LOOKUP(sendmmsg,                4, STUB_sendmmsg)
+  SYSCALL_LOOKUP(recvmsg,                 3, STUB_recvmsg)
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
@@ -352,6 +372,12 @@ SYSCALL_LOOKUP(up_assert,                 2, STUB_up_assert)
   SYSCALL_LOOKUP(prctl,                   5, STUB_prctl)
 #endif
 
+/* The following is defined only if CONFIG_LIB_SYSCALL_BATCH is selected */
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+  SYSCALL_LOOKUP(syscall_batch,           2, STUB_syscall_batch)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -256,6 +256,9 @@ uintptr_t STUB_shmat(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_shmctl(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
 uintptr_t STUB_shmdt(int nbr, uintptr_t parm1);
+uintptr_t STUB_shmwait(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3);
+uintptr_t STUB_shmwake(int nbr, uintptr_t parm1, uintptr_t parm2);
 
 /* The following are defined if pthreads are enabled */
 
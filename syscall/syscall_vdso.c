@@ -0,0 +1,158 @@
+/****************************************************************************
+ * syscall/syscall_vdso.c
+ *
+ *   Copyright (C) 2016 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <syscall.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/vdso.h>
+
+/* These replace the getpid() and clock_gettime() proxies in the user phase
+ * of the protected build.
+ */
+
+#if defined(CONFIG_LIB_SYSCALL_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The user-readable kernel data.  The board passes its address to the
+ * kernel in struct userspace_s.
+ */
+
+struct vdso_s g_vdso;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getpid
+ *
+ * Description:
+ *   Get the task ID of the currently executing task from the kernel data
+ *   without a system call.
+ *
+ ****************************************************************************/
+
+pid_t getpid(void)
+{
+  /* Trap into the kernel if the data has not been published (for example,
+   * if the board does not provide us_vdso).
+   */
+
+  if (g_vdso.seq == 0)
+    {
+      return (pid_t)sys_call0(SYS_getpid);
+    }
+
+  return g_vdso.pid;
+}
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Get CLOCK_REALTIME or CLOCK_MONOTONIC from the kernel data without a
+ *   system call.  Other clocks are passed to the kernel.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, struct timespec *tp)
+{
+  systime_t ticks;
+  time_t basesec;
+  long basensec;
+  uint32_t seq;
+
+#ifdef CONFIG_CLOCK_MONOTONIC
+  if ((clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC) ||
+      g_vdso.seq == 0)
+#else
+  if (clock_id != CLOCK_REALTIME || g_vdso.seq == 0)
+#endif
+    {
+      return (int)sys_call2(SYS_clock_gettime, (uintptr_t)clock_id,
+                            (uintptr_t)tp);
+    }
+
+  /* Take a consistent snapshot of the time fields */
+
+  do
+    {
+      seq = g_vdso.seq;
+      VDSO_BARRIER();
+
+      ticks    = g_vdso.systimer;
+      basesec  = g_vdso.basesec;
+      basensec = g_vdso.basensec;
+
+      VDSO_BARRIER();
+    }
+  while ((seq & 1) != 0 || seq != g_vdso.seq);
+
+  /* Convert the system timer to the time since power up */
+
+  tp->tv_sec  = ticks / TICK_PER_SEC;
+  tp->tv_nsec = (ticks % TICK_PER_SEC) * NSEC_PER_TICK;
+
+  /* Add the base time for CLOCK_REALTIME */
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      tp->tv_sec  += basesec;
+      tp->tv_nsec += basensec;
+
+      if (tp->tv_nsec >= NSEC_PER_SEC)
+        {
+          tp->tv_sec++;
+          tp->tv_nsec -= NSEC_PER_SEC;
+        }
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_LIB_SYSCALL_VDSO && !__KERNEL__ */
@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -57,6 +58,14 @@
  * Private Types
  ****************************************************************************/
 
+/* One symbol read from the CSV file (used for hashed symbol tables) */
+
+struct symbol_s
+{
+  char *name;                  /* Symbol name */
+  char *cond;                  /* Conditional compilation (or NULL) */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -64,17 +73,22 @@
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
 
+static struct symbol_s *g_symbols;
+static int g_nsymbols;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 static void show_usage(const char *progname)
 {
-  fprintf(stderr, "USAGE: %s <cvs-file> <symtab-file>\n\n", progname);
+  fprintf(stderr, "USAGE: %s [-d] [-H] <cvs-file> <symtab-file>\n\n", progname);
   fprintf(stderr, "Where:\n\n");
   fprintf(stderr, "  <cvs-file>   : The path to the input CSV file\n");
   fprintf(stderr, "  <symtab-file>: The path to the output symbol table file\n");
   fprintf(stderr, "  -d           : Enable debug output\n");
+  fprintf(stderr, "  -H           : Generate a hashed symbol table (for\n");
+  fprintf(stderr, "                 symtab_findhashedbyname())\n");
   exit(EXIT_FAILURE);
 }
 
@@ -111,6 +125,99 @@ static void add_hdrfile(const char *hdrfile)
     }
 }
 
+/* Must match symtab_hash() in libc/symtab/symtab_findhashedbyname.c */
+
+static uint32_t symtab_hash(const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+
+  return hash;
+}
+
+static void add_symbol(const char *name, const char *cond)
+{
+  g_symbols = realloc(g_symbols, (g_nsymbols + 1) * sizeof(struct symbol_s));
+  if (!g_symbols)
+    {
+      fprintf(stderr, "ERROR:  Out of memory\n");
+      exit(EXIT_FAILURE);
+    }
+
+  g_symbols[g_nsymbols].name = strdup(name);
+  g_symbols[g_nsymbols].cond = (cond && strlen(cond) > 0) ? strdup(cond) : NULL;
+  g_nsymbols++;
+}
+
+/* Output a symbol table in which each symbol is placed at the index given
+ * by the hash of its name modulo the table size or, if that entry is
+ * already taken, at the next free entry.  The table is made at least twice
+ * as large as the number of symbols so that the searches stay short.
+ * Symbols that are conditionally compiled keep their entry; if they are
+ * excluded, the entry gets an empty name so that the searches for other
+ * symbols still continue past it.
+ */
+
+static void output_hashed(FILE *outstream)
+{
+  struct symbol_s **slots;
+  int nslots;
+  int ndx;
+  int i;
+
+  nslots = 2 * g_nsymbols + 1;
+  slots  = calloc(nslots, sizeof(struct symbol_s *));
+  if (!slots)
+    {
+      fprintf(stderr, "ERROR:  Out of memory\n");
+      exit(EXIT_FAILURE);
+    }
+
+  for (i = 0; i < g_nsymbols; i++)
+    {
+      ndx = symtab_hash(g_symbols[i].name) % (uint32_t)nslots;
+      while (slots[ndx] != NULL)
+        {
+          if (++ndx >= nslots)
+            {
+              ndx = 0;
+            }
+        }
+
+      slots[ndx] = &g_symbols[i];
+    }
+
+  for (i = 0; i < nslots; i++)
+    {
+      struct symbol_s *sym = slots[i];
+
+      if (sym == NULL)
+        {
+          fprintf(outstream, "  { NULL, NULL },\n");
+        }
+      else if (sym->cond != NULL)
+        {
+          fprintf(outstream, "#if %s\n", sym->cond);
+          fprintf(outstream, "  { \"%s\", (FAR const void *)%s },\n",
+                  sym->name, sym->name);
+          fprintf(outstream, "#else\n");
+          fprintf(outstream, "  { \"\", NULL },\n");
+          fprintf(outstream, "#endif\n");
+        }
+      else
+        {
+          fprintf(outstream, "  { \"%s\", (FAR const void *)%s },\n",
+                  sym->name, sym->name);
+        }
+    }
+
+  free(slots);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -123,6 +230,7 @@ int main(int argc, char **argv, char **envp)
   char *finalterm;
   char *ptr;
   bool cond;
+  bool hashed;
   FILE *instream;
   FILE *outstream;
   int ch;
@@ -131,8 +239,9 @@ int main(int argc, char **argv, char **envp)
   /* Parse command line options */
 
   g_debug = false;
+  hashed  = false;
 
-  while ((ch = getopt(argc, argv, ":d")) > 0)
+  while ((ch = getopt(argc, argv, ":dH")) > 0)
     {
       switch (ch)
         {
@@ -140,6 +249,10 @@ int main(int argc, char **argv, char **envp)
             g_debug = true;
             break;
 
+          case 'H' :
+            hashed = true;
+            break;
+
           case '?' :
             fprintf(stderr, "Unrecognized option: %c\n", optopt);
             show_usage(argv[0]);
@@ -253,6 +366,14 @@ int main(int argc, char **argv, char **envp)
           exit(EXIT_FAILURE);
         }
 
+      /* Hashed symbol tables are output after all symbols are known */
+
+      if (hashed)
+        {
+          add_symbol(g_parm[NAME_INDEX], g_parm[COND_INDEX]);
+          continue;
+        }
+
       /* Output any conditional compilation */
 
       cond = (g_parm[COND_INDEX] && strlen(g_parm[COND_INDEX]) > 0);
@@ -279,6 +400,11 @@ int main(int argc, char **argv, char **envp)
         }
     }
 
+  if (hashed)
+    {
+      output_hashed(outstream);
+    }
+
   fprintf(outstream, "%s};\n\n", finalterm);
   fprintf(outstream, "#define NSYMBOLS (sizeof(%s) / sizeof (struct symtab_s))\n", SYMTAB_NAME);
 